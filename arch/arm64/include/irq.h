@@ -204,6 +204,11 @@
 #define REG_FPSR            (0)
 #define REG_FPCR            (1)
 
+/* 64 bit register: the FPEN bits of CPACR_EL1 for the context, 0 when its
+ * accesses to the FPU are trapped (see CONFIG_ARM64_LAZY_FPU)
+ */
+#define REG_FPU_TRAP        (65)
+
 /* FPU registers(Q0~Q31, 128bit): 32x2 = 64
  * FPU FPSR/SPSR(32 bit) : 1
  * FPU TRAP: 1
@@ -69,22 +69,26 @@ set(CMAKE_ASM_ARCHIVE_FINISH ${CMAKE_RANLIB_COMMAND})
 
 set(NO_LTO "-fno-lto")
 
-if(CONFIG_ARCH_ARMV8A)
-  add_compile_options(-march=armv8-a)
-endif()
-
-if(CONFIG_ARCH_ARMV8R)
-  add_compile_options(-march=armv8-r)
-endif()
-
 if(CONFIG_ARCH_CORTEX_A53)
   add_compile_options(-mcpu=cortex-a53)
+elseif(CONFIG_ARCH_CORTEX_A55)
+  add_compile_options(-mcpu=cortex-a55)
 elseif(CONFIG_ARCH_CORTEX_A57)
   add_compile_options(-mcpu=cortex-a57)
 elseif(CONFIG_ARCH_CORTEX_A72)
   add_compile_options(-mcpu=cortex-a72)
 elseif(CONFIG_ARCH_CORTEX_R82)
   add_compile_options(-mcpu=cortex-r82)
+elseif(CONFIG_ARCH_ARMV8A)
+  add_compile_options(-march=armv8-a)
+elseif(CONFIG_ARCH_ARMV8R)
+  add_compile_options(-march=armv8-r)
+endif()
+
+# Inline the atomics, see Toolchain.defs
+
+if(NOT CONFIG_ARCH_TOOLCHAIN_CLANG)
+  add_compile_options(-mno-outline-atomics)
 endif()
 
 if(CONFIG_DEBUG_CUSTOMOPT)
@@ -145,6 +145,17 @@
 #define MODE_EL1            (0x1)
 #define MODE_EL0            (0x0)
 
+/* CPTR_EL2, Architectural Feature Trap Register (EL2) */
+
+#define CPTR_EZ_BIT                 BIT(8)
+#define CPTR_TFP_BIT                BIT(10)
+#define CPTR_TTA_BIT                BIT(20)
+#define CPTR_TCPAC_BIT              BIT(31)
+#define CPTR_EL2_RES1               BIT(13) | BIT(12) | BIT(9) | (0xff)
+
+/* CPACR_EL1, Architectural Feature Access Control Register */
+#define CPACR_EL1_FPEN_NOTRAP       (0x3 << 20)
+
 #ifndef __ASSEMBLY__
 
 /****************************************************************************
@@ -215,17 +226,6 @@
    (((_aff1) & SGIR_AFF_MASK) << SGIR_AFF1_SHIFT) |               \
    ((_tgt) & SGIR_TGT_MASK))
 
-/* CPTR_EL2, Architectural Feature Trap Register (EL2) */
-
-#define CPTR_EZ_BIT                 BIT(8)
-#define CPTR_TFP_BIT                BIT(10)
-#define CPTR_TTA_BIT                BIT(20)
-#define CPTR_TCPAC_BIT              BIT(31)
-#define CPTR_EL2_RES1               BIT(13) | BIT(12) | BIT(9) | (0xff)
-
-/* CPACR_EL1, Architectural Feature Access Control Register */
-#define CPACR_EL1_FPEN_NOTRAP       (0x3 << 20)
-
 /* SCR_EL3, Secure Configuration Register */
 #define SCR_NS_BIT                  BIT(0)
 #define SCR_IRQ_BIT                 BIT(1)
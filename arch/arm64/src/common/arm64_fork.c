@@ -182,6 +182,11 @@ pid_t arm64_fork(const struct fork_s *context)
 #ifdef CONFIG_ARCH_FPU
   child->cmn.xcp.fpu_regs = (void *)(newsp - FPU_CONTEXT_SIZE);
   memcpy(child->cmn.xcp.fpu_regs, context->fpu, FPU_CONTEXT_SIZE);
+#ifdef CONFIG_ARM64_LAZY_FPU
+  /* The child has the FPU registers of the parent, so it uses the FPU */
+
+  child->cmn.xcp.fpu_regs[REG_FPU_TRAP] = CPACR_EL1_FPEN_NOTRAP;
+#endif
 #endif
 
   child->cmn.xcp.regs             = (void *)(newsp - XCPTCONTEXT_SIZE);
@@ -277,6 +277,30 @@ void arm64_fpu_disable(void)
   up_irq_restore(flags);
 }
 
+/***************************************************************************
+ * Name: arm64_fpu_trap
+ *
+ * Description:
+ *   Handle the first access to the FPU of a context, trapped because the
+ *   context did not use the FPU.  The FPU is given to the context with
+ *   cleared registers, and the access is executed again on the return
+ *   from the exception.
+ *
+ * Input Parameters:
+ *   regs - The context saved by the exception.
+ *
+ ***************************************************************************/
+
+#ifdef CONFIG_ARM64_LAZY_FPU
+void arm64_fpu_trap(uint64_t *regs)
+{
+  uint64_t *fpu = regs + ARM64_CONTEXT_REGS;
+
+  memset(fpu, 0, FPU_CONTEXT_SIZE);
+  fpu[REG_FPU_TRAP] = CPACR_EL1_FPEN_NOTRAP;
+}
+#endif
+
 /***************************************************************************
  * Name: up_fpucmp
  *
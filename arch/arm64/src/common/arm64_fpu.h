@@ -73,6 +73,10 @@ void arm64_fpu_enable(void);
 void arm64_fpu_save(uint64_t *context);
 void arm64_fpu_restore(uint64_t *context);
 
+#ifdef CONFIG_ARM64_LAZY_FPU
+void arm64_fpu_trap(uint64_t *regs);
+#endif
+
 #endif /* __ASSEMBLY__ */
 
 #endif /* __ARCH_ARM64_SRC_COMMON_ARM64_FPU_H */
@@ -206,6 +206,10 @@ void up_initialize(void)
   arm64_usbinitialize();
 #endif
 
+  /* Register the PMU counters with perf_event_open() */
+
+  arm64_pmu_initialize();
+
 #ifdef CONFIG_ARCH_FPU
   g_fpu_panic_block.notifier_call = arm64_panic_disable_fpu;
   g_fpu_panic_block.priority = INT_MAX;
@@ -384,6 +384,14 @@ void arm64_usbuninitialize(void);
 #  define arm64_usbuninitialize()
 #endif
 
+/* Performance monitoring unit */
+
+#ifdef CONFIG_PERF_EVENTS
+void arm64_pmu_initialize(void);
+#else
+#  define arm64_pmu_initialize()
+#endif
+
 /* Debug */
 
 #ifdef CONFIG_STACK_COLORATION
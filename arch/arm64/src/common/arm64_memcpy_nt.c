@@ -0,0 +1,76 @@
+/****************************************************************************
+ * arch/arm64/src/common/arm64_memcpy_nt.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+
+#include <nuttx/arch.h>
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_memcpy_nt
+ *
+ * Description:
+ *   Copy a buffer with non-temporal stores.  The bulk is stored 16 bytes
+ *   at a time by stnp to the aligned destination, which hints the core to
+ *   not allocate the lines in the data cache.
+ *
+ ****************************************************************************/
+
+void up_memcpy_nt(FAR void *dst, FAR const void *src, size_t len)
+{
+  FAR uint8_t *d = dst;
+  FAR const uint8_t *s = src;
+  uint64_t lo;
+  uint64_t hi;
+
+  while (len > 0 && ((uintptr_t)d & 15) != 0)
+    {
+      *d++ = *s++;
+      len--;
+    }
+
+  while (len >= 16)
+    {
+      memcpy(&lo, s, 8);
+      memcpy(&hi, s + 8, 8);
+      __asm__ __volatile__("stnp %1, %2, [%0]"
+                           : : "r"(d), "r"(lo), "r"(hi) : "memory");
+      d   += 16;
+      s   += 16;
+      len -= 16;
+    }
+
+  while (len-- > 0)
+    {
+      *d++ = *s++;
+    }
+}
@@ -0,0 +1,231 @@
+/****************************************************************************
+ * arch/arm64/src/common/arm64_perf_event.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/perf_event.h>
+
+#include "arm64_arch.h"
+#include "arm64_internal.h"
+#include "arm64_pmu.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define PMCR_EL0_N_SHIFT         11           /* Number of event counters */
+#define PMCR_EL0_N_MASK          (0x1ful << PMCR_EL0_N_SHIFT)
+
+#define PMXEVTYPER_EL0_P         (1ul << 31)  /* Do not count at EL1 */
+#define PMXEVTYPER_EL0_U         (1ul << 30)  /* Do not count at EL0 */
+#define PMXEVTYPER_EL0_EVT_MASK  0xfffful
+
+/* The counters, except the cycle counter (bit 31) used by up_perf_*() */
+
+#define PMU_EVCNTR_MASK          0x7ffffffful
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int arm64_pmu_event_init(FAR struct pmu_s *pmu,
+                                FAR const struct perf_event_attr_s *attr,
+                                FAR uint64_t *hwevent);
+static void arm64_pmu_start(FAR struct pmu_s *pmu, int idx,
+                            uint64_t hwevent, uint64_t value, bool irq);
+static void arm64_pmu_stop(FAR struct pmu_s *pmu, int idx);
+static uint64_t arm64_pmu_read(FAR struct pmu_s *pmu, int idx);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The common architectural events, by PERF_COUNT_HW_* */
+
+static const uint16_t g_arm64_pmu_events[PERF_COUNT_HW_MAX] =
+{
+  0x11, /* CPU_CYCLES */
+  0x08, /* INST_RETIRED */
+  0x04, /* L1D_CACHE */
+  0x03, /* L1D_CACHE_REFILL */
+  0x21, /* BR_RETIRED */
+  0x10, /* BR_MIS_PRED */
+};
+
+static const struct pmu_ops_s g_arm64_pmu_ops =
+{
+  arm64_pmu_event_init, /* event_init */
+  arm64_pmu_start,      /* start */
+  arm64_pmu_stop,       /* stop */
+  arm64_pmu_read,       /* read */
+};
+
+static struct pmu_s g_arm64_pmu =
+{
+  &g_arm64_pmu_ops,          /* ops */
+  0,                         /* ncounters */
+  32,                        /* width */
+  CONFIG_ARM64_PMU_IRQ > 0,  /* irq */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static int arm64_pmu_event_init(FAR struct pmu_s *pmu,
+                                FAR const struct perf_event_attr_s *attr,
+                                FAR uint64_t *hwevent)
+{
+  uint64_t event;
+
+  if (attr->type == PERF_TYPE_HARDWARE)
+    {
+      event = g_arm64_pmu_events[attr->config];
+    }
+  else if ((attr->config & ~PMXEVTYPER_EL0_EVT_MASK) == 0)
+    {
+      event = attr->config;
+    }
+  else
+    {
+      return -EINVAL;
+    }
+
+  if ((attr->flags & PERF_ATTR_EXCLUDE_KERNEL) != 0)
+    {
+      event |= PMXEVTYPER_EL0_P;
+    }
+
+  if ((attr->flags & PERF_ATTR_EXCLUDE_USER) != 0)
+    {
+      event |= PMXEVTYPER_EL0_U;
+    }
+
+  *hwevent = event;
+  return OK;
+}
+
+static void arm64_pmu_start(FAR struct pmu_s *pmu, int idx,
+                            uint64_t hwevent, uint64_t value, bool irq)
+{
+  uint64_t bit = 1ul << idx;
+
+  write_sysreg(bit, pmcntenclr_el0);
+  write_sysreg(idx, pmselr_el0);
+  ARM64_ISB();
+  write_sysreg(hwevent, pmxevtyper_el0);
+  write_sysreg(value, pmxevcntr_el0);
+  write_sysreg(bit, pmovsclr_el0);
+
+  if (irq)
+    {
+      write_sysreg(bit, pmintenset_el1);
+#if CONFIG_ARM64_PMU_IRQ > 0
+      up_enable_irq(CONFIG_ARM64_PMU_IRQ);
+#endif
+    }
+  else
+    {
+      write_sysreg(bit, pmintenclr_el1);
+    }
+
+  write_sysreg(read_sysreg(pmcr_el0) | PMCR_EL0_E, pmcr_el0);
+  write_sysreg(bit, pmcntenset_el0);
+  ARM64_ISB();
+}
+
+static void arm64_pmu_stop(FAR struct pmu_s *pmu, int idx)
+{
+  uint64_t bit = 1ul << idx;
+
+  write_sysreg(bit, pmcntenclr_el0);
+  write_sysreg(bit, pmintenclr_el1);
+  write_sysreg(bit, pmovsclr_el0);
+  ARM64_ISB();
+}
+
+static uint64_t arm64_pmu_read(FAR struct pmu_s *pmu, int idx)
+{
+  write_sysreg(idx, pmselr_el0);
+  ARM64_ISB();
+  return read_sysreg(pmxevcntr_el0) & UINT32_MAX;
+}
+
+#if CONFIG_ARM64_PMU_IRQ > 0
+static int arm64_pmu_interrupt(int irq, FAR void *context, FAR void *arg)
+{
+  uint64_t status;
+  int idx;
+
+  status = read_sysreg(pmovsclr_el0) & PMU_EVCNTR_MASK;
+  write_sysreg(status, pmovsclr_el0);
+  ARM64_ISB();
+
+  for (idx = 0; status != 0; idx++, status >>= 1)
+    {
+      if ((status & 1) != 0)
+        {
+          perf_event_overflow(idx, up_getusrpc(context));
+        }
+    }
+
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: arm64_pmu_initialize
+ *
+ * Description:
+ *   Register the event counters of the PMU with perf_event_open().  Their
+ *   number is read from PMCR_EL0, which is the same on all the CPUs.
+ *
+ ****************************************************************************/
+
+void arm64_pmu_initialize(void)
+{
+  g_arm64_pmu.ncounters = (read_sysreg(pmcr_el0) & PMCR_EL0_N_MASK) >>
+                          PMCR_EL0_N_SHIFT;
+  if (g_arm64_pmu.ncounters == 0)
+    {
+      return;
+    }
+
+#if CONFIG_ARM64_PMU_IRQ > 0
+  irq_attach(CONFIG_ARM64_PMU_IRQ, arm64_pmu_interrupt, NULL);
+#endif
+
+  pmu_register(&g_arm64_pmu);
+}
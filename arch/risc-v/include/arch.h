@@ -106,6 +106,37 @@ typedef struct arch_addrenv_s arch_addrenv_t;
 #endif /* __ASSEMBLY__ */
 #endif /* CONFIG_ARCH_ADDRENV */
 
+/****************************************************************************
+ * Inline functions
+ ****************************************************************************/
+
+#ifndef __ASSEMBLY__
+
+/* With thread local storage the thread pointer (tp) of every thread is set
+ * right past its tls_info_s at the bottom of the stack, so the TLS info is
+ * found from tp without a look up of the TCB.  The system call handler
+ * loads tp with the kernel TCB, that is why the kernel side can not rely on
+ * it when the system calls are trapped.
+ */
+
+#if defined(CONFIG_SCHED_THREAD_LOCAL) && \
+    (!defined(__KERNEL__) || !defined(CONFIG_LIB_SYSCALL))
+static inline uintptr_t up_gettp(void)
+{
+  register uintptr_t tp;
+  __asm__
+  (
+    "\tmv  %0, tp\n"
+    : "=r"(tp)
+  );
+  return tp;
+}
+
+#  define up_tls_info() ((FAR struct tls_info_s *)up_gettp() - 1)
+#endif
+
+#endif /* __ASSEMBLY__ */
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -34,6 +34,7 @@
 #include <nuttx/arch.h>
 #include <nuttx/spinlock.h>
 #include <nuttx/sched_note.h>
+#include <nuttx/tls.h>
 
 #include "sched/sched.h"
 #include "init/init.h"
@@ -89,6 +90,12 @@ void riscv_cpu_boot(int cpu)
   riscv_percpu_add_hart(riscv_cpuid_to_hartid(cpu));
 #endif
 
+  /* The boot code left tp at zero, point it at the TLS of the IDLE thread
+   * before anything uses TLS.
+   */
+
+  riscv_set_idletls(this_task());
+
 #ifdef CONFIG_BUILD_KERNEL
   /* Enable MMU */
 
@@ -128,5 +128,9 @@ void up_initialize(void)
 
   riscv_netinitialize();
 
+  /* Register the HPM counters with perf_event_open() */
+
+  riscv_pmu_initialize();
+
   board_autoled_on(LED_IRQSENABLED);
 }
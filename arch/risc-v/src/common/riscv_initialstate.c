@@ -113,6 +113,10 @@ void up_initial_state(struct tcb_s *tcb)
       /* Set idle process' initial interrupt context */
 
       riscv_set_idleintctx();
+
+      /* This runs on CPU0 in its IDLE thread, point tp at its TLS */
+
+      riscv_set_idletls(tcb);
       return;
     }
 
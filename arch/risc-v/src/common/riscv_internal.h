@@ -264,6 +264,20 @@ void riscv_sigdeliver(void);
 int riscv_swint(int irq, void *context, void *arg);
 uintptr_t riscv_get_newintctx(void);
 void riscv_set_idleintctx(void);
+
+/* The IDLE threads are entered from the boot code, not restored from the
+ * context set up by up_initial_state(), so their thread pointer has to be
+ * pointed at their TLS by hand before any use of TLS (errno for one).
+ */
+
+#ifdef CONFIG_SCHED_THREAD_LOCAL
+#  define riscv_set_idletls(tcb) \
+     __asm__ __volatile__("mv tp, %0" : : \
+                          "r"((uintptr_t)(tcb)->stack_alloc_ptr + \
+                              sizeof(struct tls_info_s)))
+#else
+#  define riscv_set_idletls(tcb)
+#endif
 void riscv_exception_attach(void);
 
 #ifdef CONFIG_ARCH_FPU
@@ -355,6 +369,14 @@ int riscv_check_pmp_access(uintptr_t attr, uintptr_t base, uintptr_t size);
 int riscv_configured_pmp_regions(void);
 int riscv_next_free_pmp_region(void);
 
+/* Performance monitoring unit **********************************************/
+
+#ifdef CONFIG_PERF_EVENTS
+void riscv_pmu_initialize(void);
+#else
+#  define riscv_pmu_initialize()
+#endif
+
 /* Power management *********************************************************/
 
 #ifdef CONFIG_PM
@@ -0,0 +1,242 @@
+/****************************************************************************
+ * arch/risc-v/src/common/riscv_perf_event.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <stdint.h>
+
+#include <nuttx/perf_event.h>
+
+#include "riscv_internal.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define CSR_MCOUNTINHIBIT   0x320
+
+#define CSR_MHPMEVENT3      0x323
+#define CSR_MHPMEVENT4      0x324
+#define CSR_MHPMEVENT5      0x325
+#define CSR_MHPMEVENT6      0x326
+#define CSR_MHPMEVENT7      0x327
+#define CSR_MHPMEVENT8      0x328
+#define CSR_MHPMEVENT9      0x329
+#define CSR_MHPMEVENT10     0x32a
+
+/* The counters mhpmcounter3 to mhpmcounter10 are used.  The CSR number has
+ * to be an immediate, so they are reached with a switch.
+ */
+
+#define RISCV_HPM_FIRST     3
+#define RISCV_HPM_MAX       8
+
+#define RISCV_HPM_SWITCH(idx, op) \
+  switch (idx) \
+    { \
+      case 0: op(3); break; \
+      case 1: op(4); break; \
+      case 2: op(5); break; \
+      case 3: op(6); break; \
+      case 4: op(7); break; \
+      case 5: op(8); break; \
+      case 6: op(9); break; \
+      case 7: op(10); break; \
+      default: break; \
+    }
+
+#define RISCV_HPM_SET_EVENT(n) \
+  WRITE_CSR(CSR_MHPMEVENT##n, event)
+
+#ifdef CONFIG_ARCH_RV32
+#  define RISCV_HPM_SET_COUNTER(n) \
+  do \
+    { \
+      WRITE_CSR(CSR_MHPMCOUNTER##n, 0); \
+      WRITE_CSR(CSR_MHPMCOUNTER##n##H, (uint32_t)(value >> 32)); \
+      WRITE_CSR(CSR_MHPMCOUNTER##n, (uint32_t)value); \
+    } \
+  while (0)
+
+#  define RISCV_HPM_GET_COUNTER(n) \
+  do \
+    { \
+      uint32_t hi; \
+      do \
+        { \
+          hi    = READ_CSR(CSR_MHPMCOUNTER##n##H); \
+          value = ((uint64_t)hi << 32) | READ_CSR(CSR_MHPMCOUNTER##n); \
+        } \
+      while (hi != READ_CSR(CSR_MHPMCOUNTER##n##H)); \
+    } \
+  while (0)
+#else
+#  define RISCV_HPM_SET_COUNTER(n) \
+  WRITE_CSR(CSR_MHPMCOUNTER##n, value)
+
+#  define RISCV_HPM_GET_COUNTER(n) \
+  value = READ_CSR(CSR_MHPMCOUNTER##n)
+#endif
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int riscv_pmu_event_init(FAR struct pmu_s *pmu,
+                                FAR const struct perf_event_attr_s *attr,
+                                FAR uint64_t *hwevent);
+static void riscv_pmu_start(FAR struct pmu_s *pmu, int idx,
+                            uint64_t hwevent, uint64_t value, bool irq);
+static void riscv_pmu_stop(FAR struct pmu_s *pmu, int idx);
+static uint64_t riscv_pmu_read(FAR struct pmu_s *pmu, int idx);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct pmu_ops_s g_riscv_pmu_ops =
+{
+  riscv_pmu_event_init, /* event_init */
+  riscv_pmu_start,      /* start */
+  riscv_pmu_stop,       /* stop */
+  riscv_pmu_read,       /* read */
+};
+
+static struct pmu_s g_riscv_pmu =
+{
+  &g_riscv_pmu_ops, /* ops */
+  0,                /* ncounters */
+  64,               /* width */
+  false,            /* irq */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void riscv_hpm_set_event(int idx, uintreg_t event)
+{
+  RISCV_HPM_SWITCH(idx, RISCV_HPM_SET_EVENT);
+}
+
+static void riscv_hpm_set_counter(int idx, uint64_t value)
+{
+  RISCV_HPM_SWITCH(idx, RISCV_HPM_SET_COUNTER);
+}
+
+static uint64_t riscv_hpm_get_counter(int idx)
+{
+  uint64_t value = 0;
+
+  RISCV_HPM_SWITCH(idx, RISCV_HPM_GET_COUNTER);
+  return value;
+}
+
+/* The events of mhpmevent are implementation defined, only the raw ones
+ * can be counted.  The base ISA has no mode filtering either.
+ */
+
+static int riscv_pmu_event_init(FAR struct pmu_s *pmu,
+                                FAR const struct perf_event_attr_s *attr,
+                                FAR uint64_t *hwevent)
+{
+  if (attr->type != PERF_TYPE_RAW || attr->config == 0)
+    {
+      return -ENOENT;
+    }
+
+  if ((attr->flags & (PERF_ATTR_EXCLUDE_USER |
+                      PERF_ATTR_EXCLUDE_KERNEL)) != 0 ||
+      attr->config != (uintreg_t)attr->config)
+    {
+      return -EOPNOTSUPP;
+    }
+
+  *hwevent = attr->config;
+  return OK;
+}
+
+static void riscv_pmu_start(FAR struct pmu_s *pmu, int idx,
+                            uint64_t hwevent, uint64_t value, bool irq)
+{
+  uintreg_t bit = (uintreg_t)1 << (RISCV_HPM_FIRST + idx);
+
+  SET_CSR(CSR_MCOUNTINHIBIT, bit);
+  riscv_hpm_set_event(idx, hwevent);
+  riscv_hpm_set_counter(idx, value);
+  CLEAR_CSR(CSR_MCOUNTINHIBIT, bit);
+}
+
+static void riscv_pmu_stop(FAR struct pmu_s *pmu, int idx)
+{
+  SET_CSR(CSR_MCOUNTINHIBIT, (uintreg_t)1 << (RISCV_HPM_FIRST + idx));
+  riscv_hpm_set_event(idx, 0);
+}
+
+static uint64_t riscv_pmu_read(FAR struct pmu_s *pmu, int idx)
+{
+  return riscv_hpm_get_counter(idx);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: riscv_pmu_initialize
+ *
+ * Description:
+ *   Register the hardware performance monitor counters with
+ *   perf_event_open().  The counters that are not implemented are hardwired
+ *   to zero, so the implemented ones are those keeping a value written.
+ *
+ ****************************************************************************/
+
+void riscv_pmu_initialize(void)
+{
+  int idx;
+
+  for (idx = 0; idx < RISCV_HPM_MAX; idx++)
+    {
+      uint64_t value;
+
+      riscv_pmu_start(&g_riscv_pmu, idx, 0, UINT32_MAX, false);
+      value = riscv_hpm_get_counter(idx);
+      riscv_pmu_stop(&g_riscv_pmu, idx);
+
+      if (value == 0)
+        {
+          break;
+        }
+    }
+
+  g_riscv_pmu.ncounters = idx;
+  if (idx > 0)
+    {
+      pmu_register(&g_riscv_pmu);
+    }
+}
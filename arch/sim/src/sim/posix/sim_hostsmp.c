@@ -48,9 +48,22 @@ struct sim_cpuinfo_s
  * Private Data
  ****************************************************************************/
 
-static pthread_key_t g_cpu_key;
+/* The CPU number of the host thread.  up_cpu_index() is on the path of
+ * every spinlock and this_task(), a TLS variable is much cheaper there
+ * than pthread_getspecific().
+ */
+
+static __thread int g_cpu_index;
 
 #ifdef CONFIG_SMP
+/* The host threads that simulate the CPUs.  Only the IPIs are sent to one
+ * of them (SIGUSR1 and SIGUSR2).  There is no per-CPU interrupt controller
+ * or timer: the host_settimer() SIGALRM and the device signals go to the
+ * whole process, and the sim interrupt state is the thread signal mask.
+ * The TAP and usrsock devices are polled from the loop_task kernel thread,
+ * hostfs calls block the calling CPU in the host.
+ */
+
 static pthread_t     g_cpu_thread[CONFIG_SMP_NCPUS];
 
 /****************************************************************************
@@ -81,16 +94,10 @@ static void *sim_idle_trampoline(void *arg)
 {
   struct sim_cpuinfo_s *cpuinfo = (struct sim_cpuinfo_s *)arg;
   uint64_t now = 0;
-  int ret;
 
   /* Set the CPU number for the CPU thread */
 
-  ret = pthread_setspecific(g_cpu_key,
-                           (const void *)((uintptr_t)cpuinfo->cpu));
-  if (ret != 0)
-    {
-      return NULL;
-    }
+  g_cpu_index = cpuinfo->cpu;
 
   /* Let up_cpu_start() continue */
 
@@ -131,8 +138,7 @@ static void *sim_idle_trampoline(void *arg)
  * Name: host_cpu0_start
  *
  * Description:
- *   Create the pthread-specific data key and set the indication of CPU0
- *   the main thread.
+ *   Set the indication of CPU0 the main thread.
  *
  * Input Parameters:
  *   None
@@ -144,25 +150,11 @@ static void *sim_idle_trampoline(void *arg)
 
 void host_cpu0_start(void)
 {
-  int ret;
-
   g_cpu_thread[0] = pthread_self();
 
-  /* Create the pthread key */
-
-  ret = pthread_key_create(&g_cpu_key, NULL);
-  if (ret != 0)
-    {
-      return;
-    }
-
   /* Set the CPU number zero for the CPU thread */
 
-  ret = pthread_setspecific(g_cpu_key, (const void *)0);
-  if (ret != 0)
-    {
-      return;
-    }
+  g_cpu_index = 0;
 }
 
 /****************************************************************************
@@ -267,7 +259,6 @@ void host_send_func_call_ipi(int cpu)
 #ifdef CONFIG_ARCH_HAVE_MULTICPU
 int up_cpu_index(void)
 {
-  void *value = pthread_getspecific(g_cpu_key);
-  return (int)((uintptr_t)value);
+  return g_cpu_index;
 }
 #endif
\ No newline at end of file
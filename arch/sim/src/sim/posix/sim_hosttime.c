@@ -104,10 +104,16 @@ int host_settimer(uint64_t nsec)
 {
   struct itimerval it;
 
+  /* Round up to the next microsecond, a zero it_value would disarm the
+   * timer.  tv_usec must stay below one second.
+   */
+
+  nsec += 1000;
+
   it.it_interval.tv_sec  = 0;
   it.it_interval.tv_usec = 0;
   it.it_value.tv_sec     = nsec / 1000000000;
-  it.it_value.tv_usec    = (nsec + 1000) / 1000;
+  it.it_value.tv_usec    = nsec % 1000000000 / 1000;
 
   return setitimer(ITIMER_REAL, &it, NULL);
 }
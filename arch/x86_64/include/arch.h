@@ -62,6 +62,32 @@
  * Inline functions
  ****************************************************************************/
 
+#ifndef __ASSEMBLY__
+
+/* With thread local storage FS of every thread points right past the
+ * tdata/tbss copy that follows its tls_info_s at the bottom of the stack,
+ * and the first word there points to itself.  The TLS info is then found
+ * from FS without a look up of the TCB.  The TLS layout is the one of the
+ * kernel image, so this is only for the flat build.
+ */
+
+#if defined(CONFIG_SCHED_THREAD_LOCAL) && defined(CONFIG_BUILD_FLAT)
+extern uint8_t _stdata[];          /* Start of .tdata */
+extern uint8_t _etbss[];           /* End+1 of .tbss */
+
+static inline uintptr_t up_getfs(void)
+{
+  uintptr_t fs;
+  __asm__ volatile ("mov %%fs:0, %0" : "=r"(fs));
+  return fs;
+}
+
+#  define up_tls_info() \
+     ((FAR struct tls_info_s *)(up_getfs() - (_etbss - _stdata)) - 1)
+#endif
+
+#endif /* __ASSEMBLY__ */
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -0,0 +1,119 @@
+/****************************************************************************
+ * arch/x86_64/src/common/x86_64_chksum.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+
+#include <nuttx/arch.h>
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* 128-bit SSE2 vector of four 32-bit lanes */
+
+typedef uint32_t v4u32_t __attribute__((vector_size(16)));
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_chksum
+ *
+ * Description:
+ *   Add the 16-bit big endian words of a buffer to a ones complement sum.
+ *   A trailing odd byte is handled as the upper half of a word.
+ *
+ *   The bulk of the buffer is added 16 bytes at a time into four 32-bit
+ *   lanes with the carries counted in four more lanes.  A buffer can hold
+ *   at most 4095 such blocks, so neither can overflow.
+ *
+ ****************************************************************************/
+
+uint16_t up_chksum(uint16_t sum, FAR const uint8_t *data, uint16_t len)
+{
+  v4u32_t vsum;
+  v4u32_t vcarry;
+  uint64_t acc = 0;
+  uint32_t w;
+  int i;
+
+  memset(&vsum, 0, sizeof(vsum));
+  memset(&vcarry, 0, sizeof(vcarry));
+
+  while (len >= 16)
+    {
+      v4u32_t v;
+
+      memcpy(&v, data, 16);
+      vsum   += v;
+      vcarry -= (v4u32_t)(vsum < v);
+      data   += 16;
+      len    -= 16;
+    }
+
+  for (i = 0; i < 4; i++)
+    {
+      acc += vsum[i] + ((uint64_t)vcarry[i] << 32);
+    }
+
+  while (len >= 4)
+    {
+      memcpy(&w, data, 4);
+      acc  += w;
+      data += 4;
+      len  -= 4;
+    }
+
+  /* Fold to 16 bits and swap to network order words */
+
+  acc = (acc >> 32) + (acc & 0xffffffff);
+  acc = (acc >> 32) + (acc & 0xffffffff);
+  acc = (acc >> 16) + (acc & 0xffff);
+  acc = (acc >> 16) + (acc & 0xffff);
+  acc = (acc >> 16) + (acc & 0xffff);
+  acc = ((acc & 0xff) << 8) | (acc >> 8);
+
+  if (len >= 2)
+    {
+      acc  += ((uint16_t)data[0] << 8) + data[1];
+      data += 2;
+      len  -= 2;
+    }
+
+  if (len > 0)
+    {
+      acc += (uint16_t)data[0] << 8;
+    }
+
+  acc += sum;
+  acc  = (acc >> 16) + (acc & 0xffff);
+  acc  = (acc >> 16) + (acc & 0xffff);
+  return (uint16_t)acc;
+}
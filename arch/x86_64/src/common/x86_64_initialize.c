@@ -155,6 +155,10 @@ void up_initialize(void)
 
   x86_64_usbinitialize();
 
+  /* Register the PMU counters with perf_event_open() */
+
+  x86_64_pmu_initialize();
+
 #ifdef CONFIG_ARCH_X86_64_ACPI_DUMP
   /* Dump ACPI tables */
 
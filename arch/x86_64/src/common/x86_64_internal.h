@@ -279,6 +279,14 @@ void x86_64_usbuninitialize(void);
 void x86_64_pci_init(void);
 #endif
 
+/* Defined in intel64_perf_event.c */
+
+#ifdef CONFIG_PERF_EVENTS
+void x86_64_pmu_initialize(void);
+#else
+#  define x86_64_pmu_initialize()
+#endif
+
 /* Defined in intel64_checkstack.c */
 
 #ifdef CONFIG_STACK_COLORATION
@@ -0,0 +1,76 @@
+/****************************************************************************
+ * arch/x86_64/src/common/x86_64_memcpy_nt.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+
+#include <nuttx/arch.h>
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_memcpy_nt
+ *
+ * Description:
+ *   Copy a buffer with non-temporal stores.  The bulk is stored 8 bytes at
+ *   a time by movnti to the aligned destination, then fenced because the
+ *   write combining stores are weakly ordered.
+ *
+ ****************************************************************************/
+
+void up_memcpy_nt(FAR void *dst, FAR const void *src, size_t len)
+{
+  FAR uint8_t *d = dst;
+  FAR const uint8_t *s = src;
+  uint64_t v;
+
+  while (len > 0 && ((uintptr_t)d & 7) != 0)
+    {
+      *d++ = *s++;
+      len--;
+    }
+
+  while (len >= 8)
+    {
+      memcpy(&v, s, 8);
+      __asm__ __volatile__("movnti %1, %0"
+                           : "=m"(*(FAR uint64_t *)d) : "r"(v));
+      d   += 8;
+      s   += 8;
+      len -= 8;
+    }
+
+  __asm__ __volatile__("sfence" : : : "memory");
+
+  while (len-- > 0)
+    {
+      *d++ = *s++;
+    }
+}
@@ -153,6 +153,10 @@ void x86_64_ap_boot(void)
 
   up_irqinitialize();
 
+  /* Enable the PMU counters of this CPU */
+
+  x86_64_pmu_initialize();
+
 #ifdef CONFIG_SCHED_INSTRUMENTATION
   /* Notify that this CPU has started */
 
@@ -0,0 +1,217 @@
+/****************************************************************************
+ * arch/x86_64/src/intel64/intel64_perf_event.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <stdint.h>
+
+#include <nuttx/perf_event.h>
+
+#include "x86_64_internal.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define X86_64_CPUID_PMU          0x0a
+#  define X86_64_CPUID_0A_VERSION(eax)  ((eax) & 0xff)
+#  define X86_64_CPUID_0A_NCNTR(eax)    (((eax) >> 8) & 0xff)
+#  define X86_64_CPUID_0A_WIDTH(eax)    (((eax) >> 16) & 0xff)
+#  define X86_64_CPUID_0A_EVLEN(eax)    (((eax) >> 24) & 0xff)
+
+#define MSR_IA32_PMC0             0xc1
+#define MSR_IA32_PERFEVTSEL0      0x186
+#  define PERFEVTSEL_USR          (1 << 16)  /* Count at CPL > 0 */
+#  define PERFEVTSEL_OS           (1 << 17)  /* Count at CPL 0 */
+#  define PERFEVTSEL_EN           (1 << 22)  /* Enable the counter */
+#  define PERFEVTSEL_EVENT_MASK   0xffff     /* Event select and unit mask */
+#define MSR_IA32_PERF_GLOBAL_CTRL 0x38f
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int intel64_pmu_event_init(FAR struct pmu_s *pmu,
+                                  FAR const struct perf_event_attr_s *attr,
+                                  FAR uint64_t *hwevent);
+static void intel64_pmu_start(FAR struct pmu_s *pmu, int idx,
+                              uint64_t hwevent, uint64_t value, bool irq);
+static void intel64_pmu_stop(FAR struct pmu_s *pmu, int idx);
+static uint64_t intel64_pmu_read(FAR struct pmu_s *pmu, int idx);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The architectural events, by PERF_COUNT_HW_* */
+
+static const uint16_t g_intel64_pmu_events[PERF_COUNT_HW_MAX] =
+{
+  0x003c, /* UnHalted Core Cycles */
+  0x00c0, /* Instruction Retired */
+  0x4f2e, /* LLC Reference */
+  0x412e, /* LLC Misses */
+  0x00c4, /* Branch Instruction Retired */
+  0x00c5, /* Branch Misses Retired */
+};
+
+/* Their bits in CPUID.0AH:EBX, telling that they are not available */
+
+static const uint8_t g_intel64_pmu_bits[PERF_COUNT_HW_MAX] =
+{
+  0, 1, 3, 4, 5, 6
+};
+
+static uint32_t g_intel64_pmu_unavail;
+
+static const struct pmu_ops_s g_intel64_pmu_ops =
+{
+  intel64_pmu_event_init, /* event_init */
+  intel64_pmu_start,      /* start */
+  intel64_pmu_stop,       /* stop */
+  intel64_pmu_read,       /* read */
+};
+
+static struct pmu_s g_intel64_pmu =
+{
+  &g_intel64_pmu_ops, /* ops */
+  0,                  /* ncounters */
+  0,                  /* width */
+  false,              /* irq */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static int intel64_pmu_event_init(FAR struct pmu_s *pmu,
+                                  FAR const struct perf_event_attr_s *attr,
+                                  FAR uint64_t *hwevent)
+{
+  uint64_t event;
+
+  if (attr->type == PERF_TYPE_HARDWARE)
+    {
+      if ((g_intel64_pmu_unavail &
+           (1u << g_intel64_pmu_bits[attr->config])) != 0)
+        {
+          return -ENOENT;
+        }
+
+      event = g_intel64_pmu_events[attr->config];
+    }
+  else if ((attr->config & ~PERFEVTSEL_EVENT_MASK) == 0)
+    {
+      event = attr->config;
+    }
+  else
+    {
+      return -EINVAL;
+    }
+
+  if ((attr->flags & PERF_ATTR_EXCLUDE_USER) == 0)
+    {
+      event |= PERFEVTSEL_USR;
+    }
+
+  if ((attr->flags & PERF_ATTR_EXCLUDE_KERNEL) == 0)
+    {
+      event |= PERFEVTSEL_OS;
+    }
+
+  *hwevent = event;
+  return OK;
+}
+
+static void intel64_pmu_start(FAR struct pmu_s *pmu, int idx,
+                              uint64_t hwevent, uint64_t value, bool irq)
+{
+  write_msr(MSR_IA32_PERFEVTSEL0 + idx, 0);
+  write_msr(MSR_IA32_PMC0 + idx, value);
+  write_msr(MSR_IA32_PERFEVTSEL0 + idx, hwevent | PERFEVTSEL_EN);
+}
+
+static void intel64_pmu_stop(FAR struct pmu_s *pmu, int idx)
+{
+  write_msr(MSR_IA32_PERFEVTSEL0 + idx, 0);
+}
+
+static uint64_t intel64_pmu_read(FAR struct pmu_s *pmu, int idx)
+{
+  return read_msr(MSR_IA32_PMC0 + idx);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: x86_64_pmu_initialize
+ *
+ * Description:
+ *   Register the general purpose counters of the architectural performance
+ *   monitoring with perf_event_open(), as told by CPUID.0AH.  The counters
+ *   are enabled in IA32_PERF_GLOBAL_CTRL of the CPU, each CPU calls it.
+ *
+ ****************************************************************************/
+
+void x86_64_pmu_initialize(void)
+{
+  uint32_t eax;
+  uint32_t ebx;
+
+  __asm__ volatile("cpuid"
+                   : "=a" (eax), "=b" (ebx)
+                   : "a" (X86_64_CPUID_PMU), "c" (0)
+                   : "rdx", "memory");
+
+  if (X86_64_CPUID_0A_VERSION(eax) == 0 || X86_64_CPUID_0A_NCNTR(eax) == 0)
+    {
+      return;
+    }
+
+  /* The bits of EBX beyond the length of the vector are not valid */
+
+  if (X86_64_CPUID_0A_EVLEN(eax) < 32)
+    {
+      ebx &= (1u << X86_64_CPUID_0A_EVLEN(eax)) - 1;
+    }
+
+  if (X86_64_CPUID_0A_VERSION(eax) >= 2)
+    {
+      write_msr(MSR_IA32_PERF_GLOBAL_CTRL,
+                (1ul << X86_64_CPUID_0A_NCNTR(eax)) - 1);
+    }
+
+  if (g_intel64_pmu.ncounters == 0)
+    {
+      g_intel64_pmu_unavail   = ebx;
+      g_intel64_pmu.ncounters = X86_64_CPUID_0A_NCNTR(eax);
+      g_intel64_pmu.width     = X86_64_CPUID_0A_WIDTH(eax);
+      pmu_register(&g_intel64_pmu);
+    }
+}
@@ -34,6 +34,7 @@
 #include <unistd.h>
 #include <string.h>
 #include <fcntl.h>
+#include <poll.h>
 #include <assert.h>
 #include <errno.h>
 #include <debug.h>
@@ -44,6 +45,8 @@
 #include <nuttx/fs/fs.h>
 #include <nuttx/audio/audio.h>
 #include <nuttx/mutex.h>
+#include <nuttx/mm/map.h>
+#include <nuttx/wqueue.h>
 
 #include <arch/irq.h>
 
@@ -78,6 +81,19 @@ struct audio_upperhalf_s
   mutex_t           lock;             /* Supports mutual exclusion */
   FAR struct audio_lowerhalf_s *dev;  /* lower-half state */
   struct file      *usermq;           /* User mode app's message queue */
+#ifdef CONFIG_AUDIO_RING
+  FAR uint8_t      *ring;             /* The period ring, NULL if none */
+  FAR struct ap_buffer_s *periods;    /* The buffers of the periods */
+  uint16_t          nperiods;         /* Number of periods in the ring */
+  apb_samp_t        period;           /* Size of a period */
+  uint8_t           ringtype;         /* AUDIO_TYPE_OUTPUT or _INPUT */
+  volatile uint32_t hwptr;            /* Position of the device */
+  volatile uint32_t applptr;          /* Position of the application */
+  volatile uint32_t xruns;            /* Periods done before the app */
+  dq_queue_t        pending;          /* Periods to hand back to lower */
+  struct work_s     work;             /* Hands them back out of interrupt */
+  FAR struct pollfd *fds[CONFIG_AUDIO_RING_NPOLLWAITERS];
+#endif
 };
 
 /****************************************************************************
@@ -95,6 +111,13 @@ static ssize_t  audio_write(FAR struct file *filep,
 static int      audio_ioctl(FAR struct file *filep,
                             int cmd,
                             unsigned long arg);
+#ifdef CONFIG_AUDIO_RING
+static int      audio_mmap(FAR struct file *filep,
+                           FAR struct mm_map_entry_s *map);
+static int      audio_poll(FAR struct file *filep,
+                           FAR struct pollfd *fds,
+                           bool setup);
+#endif
 #ifdef CONFIG_AUDIO_MULTI_SESSION
 static int      audio_start(FAR struct audio_upperhalf_s *upper,
                             FAR void *session);
@@ -123,12 +146,388 @@ static const struct file_operations g_audioops =
   audio_write, /* write */
   NULL,        /* seek */
   audio_ioctl, /* ioctl */
+#ifdef CONFIG_AUDIO_RING
+  audio_mmap,  /* mmap */
+  NULL,        /* truncate */
+  audio_poll,  /* poll */
+#endif
 };
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_AUDIO_RING
+/****************************************************************************
+ * Name: audio_ring_avail
+ *
+ * Description:
+ *   Bytes the application may write (playback) or read (capture) in the
+ *   ring.
+ *
+ ****************************************************************************/
+
+static uint32_t audio_ring_avail(FAR struct audio_upperhalf_s *upper)
+{
+  uint32_t used = upper->applptr - upper->hwptr;
+
+  if (upper->ringtype == AUDIO_TYPE_OUTPUT)
+    {
+      /* The written bytes not yet played take room in the ring */
+
+      return (uint32_t)upper->nperiods * upper->period - used;
+    }
+
+  return (uint32_t)-used;
+}
+
+/****************************************************************************
+ * Name: audio_ring_owns
+ ****************************************************************************/
+
+static bool audio_ring_owns(FAR struct audio_upperhalf_s *upper,
+                            FAR struct ap_buffer_s *apb)
+{
+  return upper->ring != NULL && apb >= upper->periods &&
+         apb < upper->periods + upper->nperiods;
+}
+
+/****************************************************************************
+ * Name: audio_ring_enqueue
+ *
+ * Description:
+ *   Hand a period of the ring to the lower half.
+ *
+ ****************************************************************************/
+
+static int audio_ring_enqueue(FAR struct audio_upperhalf_s *upper,
+                              FAR struct ap_buffer_s *apb)
+{
+  FAR struct audio_lowerhalf_s *lower = upper->dev;
+
+  apb->nbytes  = upper->ringtype == AUDIO_TYPE_OUTPUT ? upper->period : 0;
+  apb->curbyte = 0;
+  apb->flags   = 0;
+
+  return lower->ops->enqueuebuffer(lower, apb);
+}
+
+/****************************************************************************
+ * Name: audio_ring_worker
+ *
+ * Description:
+ *   Hand back the periods that were done in interrupt context.
+ *
+ ****************************************************************************/
+
+static void audio_ring_worker(FAR void *arg)
+{
+  FAR struct audio_upperhalf_s *upper = arg;
+  FAR struct ap_buffer_s *apb;
+  irqstate_t flags;
+
+  for (; ; )
+    {
+      flags = enter_critical_section();
+      apb   = (FAR struct ap_buffer_s *)dq_remfirst(&upper->pending);
+      leave_critical_section(flags);
+
+      if (apb == NULL)
+        {
+          break;
+        }
+
+      if (upper->started)
+        {
+          audio_ring_enqueue(upper, apb);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: audio_ring_dequeue
+ *
+ * Description:
+ *   A period of the ring is done: move the device position past it, hand
+ *   it back to the lower half at once, and wake up the application.
+ *
+ * Assumptions:
+ *   This function may be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+static void audio_ring_dequeue(FAR struct audio_upperhalf_s *upper,
+                               FAR struct ap_buffer_s *apb)
+{
+  uint32_t avail;
+
+  upper->hwptr += upper->period;
+
+  /* Count the periods that the device reached before the application,
+   * played without being written or overwritten without being read.
+   */
+
+  avail = audio_ring_avail(upper);
+  if (avail > (uint32_t)upper->nperiods * upper->period)
+    {
+      upper->xruns++;
+    }
+
+  if (upper->started)
+    {
+      if (up_interrupt_context())
+        {
+          dq_addlast(&apb->dq_entry, &upper->pending);
+          work_queue(HPWORK, &upper->work, audio_ring_worker, upper, 0);
+        }
+      else
+        {
+          audio_ring_enqueue(upper, apb);
+        }
+    }
+
+  if (avail >= upper->period)
+    {
+      poll_notify(upper->fds, CONFIG_AUDIO_RING_NPOLLWAITERS,
+                  upper->ringtype == AUDIO_TYPE_OUTPUT ? POLLOUT : POLLIN);
+    }
+}
+
+/****************************************************************************
+ * Name: audio_ring_free
+ ****************************************************************************/
+
+static void audio_ring_free(FAR struct audio_upperhalf_s *upper)
+{
+  int i;
+
+  work_cancel_sync(HPWORK, &upper->work);
+  dq_init(&upper->pending);
+
+  for (i = 0; i < upper->nperiods; i++)
+    {
+      nxmutex_destroy(&upper->periods[i].lock);
+    }
+
+  kumm_free(upper->ring);
+  kmm_free(upper->periods);
+  upper->ring     = NULL;
+  upper->periods  = NULL;
+  upper->nperiods = 0;
+}
+
+/****************************************************************************
+ * Name: audio_ring_setup
+ *
+ * Description:
+ *   Handle the AUDIOIOC_SETRING ioctl command: replace the ring by one of
+ *   the given periods.  Each period has its own audio pipeline buffer
+ *   whose samples are in the ring, so that the lower half moves them from
+ *   or into the memory that the application maps.
+ *
+ ****************************************************************************/
+
+static int audio_ring_setup(FAR struct audio_upperhalf_s *upper,
+                            FAR const struct audio_ring_s *ring)
+{
+  FAR struct ap_buffer_s *apb;
+  int i;
+
+  if (upper->started)
+    {
+      return -EBUSY;
+    }
+
+  if (upper->ring != NULL)
+    {
+      audio_ring_free(upper);
+    }
+
+  if (ring->nperiods == 0)
+    {
+      return OK;
+    }
+
+  if (ring->nperiods < 2 || ring->period_bytes == 0 ||
+      (ring->type != AUDIO_TYPE_OUTPUT && ring->type != AUDIO_TYPE_INPUT))
+    {
+      return -EINVAL;
+    }
+
+  upper->periods = kmm_zalloc(ring->nperiods * sizeof(struct ap_buffer_s));
+  if (upper->periods == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  /* Zeroed so that a period played before it is written is silent */
+
+  upper->ring = kumm_zalloc((size_t)ring->nperiods * ring->period_bytes);
+  if (upper->ring == NULL)
+    {
+      kmm_free(upper->periods);
+      upper->periods = NULL;
+      return -ENOMEM;
+    }
+
+  for (i = 0; i < ring->nperiods; i++)
+    {
+      apb             = &upper->periods[i];
+      apb->i.channels = 1;
+      apb->crefs      = 1;
+      apb->nmaxbytes  = ring->period_bytes;
+      apb->samp       = upper->ring + i * ring->period_bytes;
+      nxmutex_init(&apb->lock);
+    }
+
+  upper->nperiods = ring->nperiods;
+  upper->period   = ring->period_bytes;
+  upper->ringtype = ring->type;
+  upper->hwptr    = 0;
+  upper->applptr  = 0;
+  upper->xruns    = 0;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_ring_start
+ *
+ * Description:
+ *   Give all of the periods of the ring to the lower half before starting
+ *   it.  For playback the application has written the first of them.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_ring_start(FAR struct audio_upperhalf_s *upper,
+                            FAR void *session)
+#else
+static int audio_ring_start(FAR struct audio_upperhalf_s *upper)
+#endif
+{
+  int ret;
+  int i;
+
+  upper->hwptr = 0;
+  upper->xruns = 0;
+
+  for (i = 0; i < upper->nperiods; i++)
+    {
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+      upper->periods[i].session = session;
+#endif
+      ret = audio_ring_enqueue(upper, &upper->periods[i]);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_mmap
+ *
+ * Description:
+ *   Map the period ring.
+ *
+ ****************************************************************************/
+
+static int audio_mmap(FAR struct file *filep,
+                      FAR struct mm_map_entry_s *map)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct audio_upperhalf_s *upper = inode->i_private;
+  size_t len;
+  int ret;
+
+  ret = nxmutex_lock(&upper->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  len = (size_t)upper->nperiods * upper->period;
+  if (upper->ring == NULL)
+    {
+      ret = -ENODEV;
+    }
+  else if (map->offset < 0 || map->offset >= len ||
+           map->length == 0 || map->offset + map->length > len)
+    {
+      ret = -EINVAL;
+    }
+  else
+    {
+      map->vaddr = upper->ring + map->offset;
+      ret = OK;
+    }
+
+  nxmutex_unlock(&upper->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: audio_poll
+ *
+ * Description:
+ *   Wait for a period of the ring to be writable (playback) or readable
+ *   (capture).
+ *
+ ****************************************************************************/
+
+static int audio_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                      bool setup)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct audio_upperhalf_s *upper = inode->i_private;
+  FAR struct pollfd **slot;
+  irqstate_t flags;
+  int ret = OK;
+  int i;
+
+  flags = enter_critical_section();
+
+  if (setup)
+    {
+      for (i = 0; i < CONFIG_AUDIO_RING_NPOLLWAITERS; i++)
+        {
+          if (upper->fds[i] == NULL)
+            {
+              break;
+            }
+        }
+
+      if (i >= CONFIG_AUDIO_RING_NPOLLWAITERS)
+        {
+          ret = -EBUSY;
+        }
+      else
+        {
+          upper->fds[i] = fds;
+          fds->priv     = &upper->fds[i];
+
+          if (upper->ring != NULL &&
+              audio_ring_avail(upper) >= upper->period)
+            {
+              poll_notify(&fds, 1, upper->ringtype == AUDIO_TYPE_OUTPUT ?
+                                   POLLOUT : POLLIN);
+            }
+        }
+    }
+  else if (fds->priv != NULL)
+    {
+      slot      = (FAR struct pollfd **)fds->priv;
+      *slot     = NULL;
+      fds->priv = NULL;
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+#endif /* CONFIG_AUDIO_RING */
+
 /****************************************************************************
  * Name: audio_open
  *
@@ -227,6 +626,14 @@ static int audio_close(FAR struct file *filep)
 
       lower->ops->shutdown(lower);
       upper->usermq = NULL;
+
+#ifdef CONFIG_AUDIO_RING
+      if (upper->ring != NULL)
+        {
+          upper->started = false;
+          audio_ring_free(upper);
+        }
+#endif
     }
 
   ret = OK;
@@ -316,6 +723,21 @@ static int audio_start(FAR struct audio_upperhalf_s *upper)
 
   if (!upper->started)
     {
+#ifdef CONFIG_AUDIO_RING
+      if (upper->ring != NULL)
+        {
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+          ret = audio_ring_start(upper, session);
+#else
+          ret = audio_ring_start(upper);
+#endif
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+#endif
+
       /* Invoke the bottom half method to start the audio stream */
 
 #ifdef CONFIG_AUDIO_MULTI_SESSION
@@ -464,6 +886,15 @@ static int audio_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
               ret = lower->ops->stop(lower);
 #endif
               upper->started = false;
+
+#ifdef CONFIG_AUDIO_RING
+              if (upper->ring != NULL)
+                {
+                  work_cancel_sync(HPWORK, &upper->work);
+                  dq_init(&upper->pending);
+                  upper->applptr = 0;
+                }
+#endif
             }
         }
         break;
@@ -649,6 +1080,72 @@ static int audio_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
+#ifdef CONFIG_AUDIO_RING
+      /* AUDIOIOC_SETRING - Set up the period ring
+       *
+       *   ioctl argument - pointer to the audio_ring_s structure
+       */
+
+      case AUDIOIOC_SETRING:
+        {
+          audinfo("AUDIOIOC_SETRING\n");
+
+          ret = audio_ring_setup(upper,
+                                 (FAR const struct audio_ring_s *)arg);
+        }
+        break;
+
+      /* AUDIOIOC_GETRINGPTR - Get the positions in the ring
+       *
+       *   ioctl argument - pointer to the audio_ringptr_s structure
+       */
+
+      case AUDIOIOC_GETRINGPTR:
+        {
+          FAR struct audio_ringptr_s *ptr =
+            (FAR struct audio_ringptr_s *)arg;
+
+          ptr->hwptr   = upper->hwptr;
+          ptr->applptr = upper->applptr;
+          ptr->xruns   = upper->xruns;
+          ret = upper->ring != NULL ? OK : -ENODEV;
+        }
+        break;
+
+      /* AUDIOIOC_SETRINGPTR - Set the application position in the ring
+       *
+       *   ioctl argument - the new position
+       */
+
+      case AUDIOIOC_SETRINGPTR:
+        {
+          uint32_t applptr = (uint32_t)arg;
+          uint32_t ahead;
+
+          /* The application may not go past what the device has done for
+           * capture, nor more than a ring ahead of it for playback.
+           */
+
+          ahead = upper->ringtype == AUDIO_TYPE_OUTPUT ?
+                  applptr - upper->hwptr : upper->hwptr - applptr;
+
+          if (upper->ring == NULL)
+            {
+              ret = -ENODEV;
+            }
+          else if (ahead > (uint32_t)upper->nperiods * upper->period)
+            {
+              ret = -EINVAL;
+            }
+          else
+            {
+              upper->applptr = applptr;
+              ret = OK;
+            }
+        }
+        break;
+#endif
+
       /* Any unrecognized IOCTL commands might be
        * platform-specific ioctl commands
        */
@@ -911,6 +1408,16 @@ static void audio_callback(FAR void *handle, uint16_t reason,
     {
       case AUDIO_CALLBACK_DEQUEUE:
         {
+#ifdef CONFIG_AUDIO_RING
+          /* The periods of the ring go straight back to the lower half */
+
+          if (audio_ring_owns(upper, apb))
+            {
+              audio_ring_dequeue(upper, apb);
+              break;
+            }
+#endif
+
           /* Call the dequeue routine */
 
 #ifdef CONFIG_AUDIO_MULTI_SESSION
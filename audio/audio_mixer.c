@@ -0,0 +1,1195 @@
+/****************************************************************************
+ * audio/audio_mixer.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/audio/audio.h>
+#include <nuttx/audio/audio_mixer.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The mix is 16 bits stereo */
+
+#define MIXER_NCHANNELS    2
+#define MIXER_FRAMEBYTES   (MIXER_NCHANNELS * sizeof(int16_t))
+
+/* The streams are resampled and mixed by chunks of MIXER_CHUNK frames of
+ * the output, for which a stream may need MIXER_MAXRATIO times more frames
+ * of its own, plus one on each side for the interpolation.
+ */
+
+#define MIXER_CHUNK        64
+#define MIXER_MAXRATIO     8
+#define MIXER_STAGE        (MIXER_CHUNK * MIXER_MAXRATIO + 4)
+
+/* The position in a stream is in 16.16 fixed point input frames, the
+ * volume in Q15.
+ */
+
+#define MIXER_UNITY        32768
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct audio_mixer_s;
+
+/* This structure describes a stream of the mixer */
+
+struct audio_mixer_stream_s
+{
+  /* This is is our appearance to the outside world. This *MUST* be the
+   * first element of the structure so that we can freely cast between
+   * types struct audio_lowerhalf and struct audio_mixer_stream_s.
+   */
+
+  struct audio_lowerhalf_s export;
+
+  FAR struct audio_mixer_s *mixer;  /* The mixer of the stream */
+  dq_queue_t queue;                 /* Buffers to play, the first one next */
+  uint32_t   step;                  /* Input frames per output frame */
+  uint32_t   phase;                 /* Position after the frame in last */
+  int32_t    volume;                /* Q15 gain */
+  uint8_t    nchannels;             /* Channels of the input */
+  uint8_t    bpsamp;                /* Bytes per sample of the input */
+  bool       isfloat;               /* The samples are float */
+  bool       reserved;              /* The stream is reserved */
+  bool       started;               /* The stream is started */
+  bool       paused;                /* The stream is paused */
+  int16_t    last[MIXER_NCHANNELS]; /* Last frame taken from the input */
+};
+
+/* This structure describes the internal state of the mixer */
+
+struct audio_mixer_s
+{
+  FAR struct audio_lowerhalf_s *lower;         /* The output device */
+  FAR struct audio_mixer_stream_s *streams;    /* The streams */
+  int        nstreams;                         /* Number of streams */
+  int        nstarted;                         /* Started streams */
+  bool       started;                          /* The output is running */
+  bool       reserved;                         /* The output is reserved */
+  rmutex_t   lock;                             /* Protects the mixer */
+  dq_queue_t done;                             /* Output buffers to fill */
+  struct work_s work;                          /* Fills the buffers */
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  FAR void  *session;                          /* Session of the output */
+#endif
+  FAR struct ap_buffer_s *bufs[CONFIG_AUDIO_MIXER_NBUFFERS];
+
+  /* Work areas of the mixing, used under the lock */
+
+  int32_t    mix[MIXER_CHUNK * MIXER_NCHANNELS];
+  int16_t    stage[MIXER_STAGE * MIXER_NCHANNELS];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int audio_mixer_getcaps(FAR struct audio_lowerhalf_s *dev, int type,
+                               FAR struct audio_caps_s *caps);
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_configure(FAR struct audio_lowerhalf_s *dev,
+                                 FAR void *session,
+                                 FAR const struct audio_caps_s *caps);
+#else
+static int audio_mixer_configure(FAR struct audio_lowerhalf_s *dev,
+                                 FAR const struct audio_caps_s *caps);
+#endif
+static int audio_mixer_shutdown(FAR struct audio_lowerhalf_s *dev);
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_start(FAR struct audio_lowerhalf_s *dev,
+                             FAR void *session);
+#else
+static int audio_mixer_start(FAR struct audio_lowerhalf_s *dev);
+#endif
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_stop(FAR struct audio_lowerhalf_s *dev,
+                            FAR void *session);
+#else
+static int audio_mixer_stop(FAR struct audio_lowerhalf_s *dev);
+#endif
+#endif
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_pause(FAR struct audio_lowerhalf_s *dev,
+                             FAR void *session);
+static int audio_mixer_resume(FAR struct audio_lowerhalf_s *dev,
+                              FAR void *session);
+#else
+static int audio_mixer_pause(FAR struct audio_lowerhalf_s *dev);
+static int audio_mixer_resume(FAR struct audio_lowerhalf_s *dev);
+#endif
+#endif
+static int audio_mixer_enqueuebuffer(FAR struct audio_lowerhalf_s *dev,
+                                     FAR struct ap_buffer_s *apb);
+static int audio_mixer_ioctl(FAR struct audio_lowerhalf_s *dev, int cmd,
+                             unsigned long arg);
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_reserve(FAR struct audio_lowerhalf_s *dev,
+                               FAR void **session);
+static int audio_mixer_release(FAR struct audio_lowerhalf_s *dev,
+                               FAR void *session);
+static void audio_mixer_callback(FAR void *arg, uint16_t reason,
+                                 FAR struct ap_buffer_s *apb,
+                                 uint16_t status,
+                                 FAR void *session);
+#else
+static int audio_mixer_reserve(FAR struct audio_lowerhalf_s *dev);
+static int audio_mixer_release(FAR struct audio_lowerhalf_s *dev);
+static void audio_mixer_callback(FAR void *arg, uint16_t reason,
+                                 FAR struct ap_buffer_s *apb,
+                                 uint16_t status);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct audio_ops_s g_audio_mixer_ops =
+{
+  audio_mixer_getcaps,       /* getcaps        */
+  audio_mixer_configure,     /* configure      */
+  audio_mixer_shutdown,      /* shutdown       */
+  audio_mixer_start,         /* start          */
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+  audio_mixer_stop,          /* stop           */
+#endif
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+  audio_mixer_pause,         /* pause          */
+  audio_mixer_resume,        /* resume         */
+#endif
+  NULL,                      /* allocbuffer    */
+  NULL,                      /* freebuffer     */
+  audio_mixer_enqueuebuffer, /* enqueue_buffer */
+  NULL,                      /* cancel_buffer  */
+  audio_mixer_ioctl,         /* ioctl          */
+  NULL,                      /* read           */
+  NULL,                      /* write          */
+  audio_mixer_reserve,       /* reserve        */
+  audio_mixer_release        /* release        */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: audio_mixer_upper
+ *
+ * Description:
+ *   Call back the upper half of a stream.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_upper(FAR struct audio_mixer_stream_s *stream,
+                              uint16_t reason, FAR struct ap_buffer_s *apb)
+{
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  stream->export.upper(stream->export.priv, reason, apb, OK, stream);
+#else
+  stream->export.upper(stream->export.priv, reason, apb, OK);
+#endif
+}
+
+/****************************************************************************
+ * Name: audio_mixer_convert
+ *
+ * Description:
+ *   Convert nframes frames of the input of a stream to 16 bits stereo.
+ *   A mono stream goes to both channels, the channels after the second
+ *   one are dropped.  There is one loop per format so that the compiler
+ *   can vectorize them.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_convert(FAR struct audio_mixer_stream_s *stream,
+                                FAR int16_t *dst, FAR const uint8_t *src,
+                                int nframes)
+{
+  int stride = stream->nchannels * stream->bpsamp;
+  int right  = stream->nchannels > 1 ? stream->bpsamp : 0;
+  int i;
+
+  if (stream->isfloat)
+    {
+      for (i = 0; i < nframes; i++)
+        {
+          float l;
+          float r;
+
+          memcpy(&l, src + i * stride, sizeof(float));
+          memcpy(&r, src + i * stride + right, sizeof(float));
+
+          l = l * 32768.0f;
+          r = r * 32768.0f;
+          l = l < 32767.0f ? l : 32767.0f;
+          r = r < 32767.0f ? r : 32767.0f;
+          dst[2 * i]     = (int16_t)(l > -32768.0f ? l : -32768.0f);
+          dst[2 * i + 1] = (int16_t)(r > -32768.0f ? r : -32768.0f);
+        }
+    }
+  else
+    {
+      /* The integer samples are little endian: keep their 16 upper bits */
+
+      src += stream->bpsamp - 2;
+
+      for (i = 0; i < nframes; i++)
+        {
+          FAR const uint8_t *l = src + i * stride;
+          FAR const uint8_t *r = l + right;
+
+          dst[2 * i]     = (int16_t)(l[0] | (l[1] << 8));
+          dst[2 * i + 1] = (int16_t)(r[0] | (r[1] << 8));
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: audio_mixer_peek
+ *
+ * Description:
+ *   Convert the next nframes frames of a stream into dst, without taking
+ *   them from its buffers.  What the buffers lack is silence.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_peek(FAR struct audio_mixer_stream_s *stream,
+                             FAR int16_t *dst, int nframes)
+{
+  FAR struct ap_buffer_s *apb;
+  int framebytes = stream->nchannels * stream->bpsamp;
+  int n;
+
+  for (apb = (FAR struct ap_buffer_s *)dq_peek(&stream->queue);
+       apb != NULL && nframes > 0;
+       apb = (FAR struct ap_buffer_s *)dq_next(&apb->dq_entry))
+    {
+      n = (apb->nbytes - apb->curbyte) / framebytes;
+      n = n < nframes ? n : nframes;
+
+      audio_mixer_convert(stream, dst, apb->samp + apb->curbyte, n);
+      dst     += n * MIXER_NCHANNELS;
+      nframes -= n;
+    }
+
+  memset(dst, 0, nframes * MIXER_FRAMEBYTES);
+}
+
+/****************************************************************************
+ * Name: audio_mixer_take
+ *
+ * Description:
+ *   Take nframes frames from the buffers of a stream, and give the
+ *   buffers that are done back to its upper half.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_take(FAR struct audio_mixer_stream_s *stream,
+                             int nframes)
+{
+  FAR struct ap_buffer_s *apb;
+  int framebytes = stream->nchannels * stream->bpsamp;
+  bool final;
+  int n;
+
+  while ((apb = (FAR struct ap_buffer_s *)dq_peek(&stream->queue)) != NULL)
+    {
+      n = (apb->nbytes - apb->curbyte) / framebytes;
+      if (n > nframes)
+        {
+          apb->curbyte += nframes * framebytes;
+          break;
+        }
+
+      nframes -= n;
+      final    = (apb->flags & AUDIO_APB_FINAL) != 0;
+
+      dq_remfirst(&stream->queue);
+      apb->curbyte = apb->nbytes;
+      apb_free(apb);
+      audio_mixer_upper(stream, AUDIO_CALLBACK_DEQUEUE, apb);
+
+      if (final)
+        {
+          /* The stream has played its last buffer */
+
+          stream->started = false;
+          stream->mixer->nstarted--;
+          audio_mixer_upper(stream, AUDIO_CALLBACK_COMPLETE, NULL);
+          break;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: audio_mixer_add
+ *
+ * Description:
+ *   Resample nframes frames of a stream to the rate of the mixer and add
+ *   them to the mix.  The stage holds the last frame taken from the
+ *   stream followed by the ones that the interpolation needs, and the
+ *   stream is moved past the frames that it went beyond.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_add(FAR struct audio_mixer_s *mixer,
+                            FAR struct audio_mixer_stream_s *stream,
+                            int nframes)
+{
+  FAR int16_t *stage = mixer->stage;
+  FAR int32_t *mix = mixer->mix;
+  uint32_t phase = stream->phase;
+  uint32_t step = stream->step;
+  int32_t volume = stream->volume;
+  uint32_t end;
+  int i;
+
+  end = phase + nframes * step;
+
+  stage[0] = stream->last[0];
+  stage[1] = stream->last[1];
+  audio_mixer_peek(stream, stage + MIXER_NCHANNELS, (end >> 16) + 1);
+
+  /* Linear interpolation between the two input frames around each output
+   * frame, without a branch so that it vectorizes.
+   */
+
+  for (i = 0; i < nframes; i++)
+    {
+      uint32_t pos = phase + i * step;
+      FAR const int16_t *s = stage + (pos >> 16) * MIXER_NCHANNELS;
+      int32_t frac = (pos & 0xffff) >> 1;
+      int32_t l;
+      int32_t r;
+
+      l = s[0] + (((s[2] - s[0]) * frac) >> 15);
+      r = s[1] + (((s[3] - s[1]) * frac) >> 15);
+      mix[2 * i]     += (l * volume) >> 15;
+      mix[2 * i + 1] += (r * volume) >> 15;
+    }
+
+  stream->last[0] = stage[(end >> 16) * MIXER_NCHANNELS];
+  stream->last[1] = stage[(end >> 16) * MIXER_NCHANNELS + 1];
+  stream->phase   = end & 0xffff;
+
+  audio_mixer_take(stream, end >> 16);
+}
+
+/****************************************************************************
+ * Name: audio_mixer_fill
+ *
+ * Description:
+ *   Mix a period of the started streams into an output buffer.  The
+ *   streams that are paused or without data are silent.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_fill(FAR struct audio_mixer_s *mixer,
+                             FAR struct ap_buffer_s *apb)
+{
+  FAR struct audio_mixer_stream_s *stream;
+  FAR int16_t *out = (FAR int16_t *)apb->samp;
+  FAR int32_t *mix = mixer->mix;
+  int nframes;
+  int n;
+  int i;
+
+  for (nframes = CONFIG_AUDIO_MIXER_PERIOD; nframes > 0; nframes -= n)
+    {
+      n = nframes < MIXER_CHUNK ? nframes : MIXER_CHUNK;
+      memset(mix, 0, sizeof(mixer->mix));
+
+      for (i = 0; i < mixer->nstreams; i++)
+        {
+          stream = &mixer->streams[i];
+          if (stream->started && !stream->paused)
+            {
+              audio_mixer_add(mixer, stream, n);
+            }
+        }
+
+      for (i = 0; i < n * MIXER_NCHANNELS; i++)
+        {
+          int32_t v = mix[i];
+
+          v      = v < INT16_MAX ? v : INT16_MAX;
+          out[i] = (int16_t)(v > INT16_MIN ? v : INT16_MIN);
+        }
+
+      out += n * MIXER_NCHANNELS;
+    }
+
+  apb->nbytes  = CONFIG_AUDIO_MIXER_PERIOD * MIXER_FRAMEBYTES;
+  apb->curbyte = 0;
+  apb->flags   = 0;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_worker
+ *
+ * Description:
+ *   Refill the output buffers that the lower half gave back, and give
+ *   them to it again.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_worker(FAR void *arg)
+{
+  FAR struct audio_mixer_s *mixer = arg;
+  FAR struct audio_lowerhalf_s *lower = mixer->lower;
+  FAR struct ap_buffer_s *apb;
+  irqstate_t flags;
+
+  nxrmutex_lock(&mixer->lock);
+
+  while (mixer->started)
+    {
+      flags = enter_critical_section();
+      apb   = (FAR struct ap_buffer_s *)dq_remfirst(&mixer->done);
+      leave_critical_section(flags);
+
+      if (apb == NULL)
+        {
+          break;
+        }
+
+      audio_mixer_fill(mixer, apb);
+      lower->ops->enqueuebuffer(lower, apb);
+    }
+
+  nxrmutex_unlock(&mixer->lock);
+}
+
+/****************************************************************************
+ * Name: audio_mixer_startlower
+ *
+ * Description:
+ *   Start the output when the first stream starts.
+ *
+ ****************************************************************************/
+
+static int audio_mixer_startlower(FAR struct audio_mixer_s *mixer)
+{
+  FAR struct audio_lowerhalf_s *lower = mixer->lower;
+  struct audio_buf_desc_s desc;
+  struct audio_caps_s caps;
+  int ret;
+  int i;
+
+  if (!mixer->reserved && lower->ops->reserve != NULL)
+    {
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+      ret = lower->ops->reserve(lower, &mixer->session);
+#else
+      ret = lower->ops->reserve(lower);
+#endif
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      mixer->reserved = true;
+    }
+
+  memset(&caps, 0, sizeof(caps));
+  caps.ac_len            = sizeof(caps);
+  caps.ac_type           = AUDIO_TYPE_OUTPUT;
+  caps.ac_channels       = MIXER_NCHANNELS;
+  caps.ac_controls.hw[0] = CONFIG_AUDIO_MIXER_SAMPLERATE & 0xffff;
+  caps.ac_controls.b[2]  = 16;
+  caps.ac_controls.b[3]  = CONFIG_AUDIO_MIXER_SAMPLERATE >> 16;
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  ret = lower->ops->configure(lower, mixer->session, &caps);
+#else
+  ret = lower->ops->configure(lower, &caps);
+#endif
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* The output buffers are allocated once, and are all to be filled */
+
+  for (i = 0; i < CONFIG_AUDIO_MIXER_NBUFFERS; i++)
+    {
+      if (mixer->bufs[i] != NULL)
+        {
+          break;
+        }
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+      desc.session   = mixer->session;
+#endif
+      desc.numbytes  = CONFIG_AUDIO_MIXER_PERIOD * MIXER_FRAMEBYTES;
+      desc.u.pbuffer = &mixer->bufs[i];
+
+      ret = lower->ops->allocbuffer != NULL ?
+            lower->ops->allocbuffer(lower, &desc) : apb_alloc(&desc);
+      if (ret < 0)
+        {
+          while (--i >= 0)
+            {
+              desc.u.buffer = mixer->bufs[i];
+              if (lower->ops->freebuffer != NULL)
+                {
+                  lower->ops->freebuffer(lower, &desc);
+                }
+              else
+                {
+                  apb_free(mixer->bufs[i]);
+                }
+
+              mixer->bufs[i] = NULL;
+            }
+
+          return ret;
+        }
+
+      dq_addlast(&mixer->bufs[i]->dq_entry, &mixer->done);
+    }
+
+  mixer->started = true;
+  audio_mixer_worker(mixer);
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  ret = lower->ops->start(lower, mixer->session);
+#else
+  ret = lower->ops->start(lower);
+#endif
+  if (ret < 0)
+    {
+      mixer->started = false;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_stoplower
+ *
+ * Description:
+ *   Stop the output when the last stream stops.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_stoplower(FAR struct audio_mixer_s *mixer)
+{
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+  FAR struct audio_lowerhalf_s *lower = mixer->lower;
+
+  /* The lower half gives the buffers back to the done queue, where they
+   * wait for the next start.
+   */
+
+  mixer->started = false;
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  lower->ops->stop(lower, mixer->session);
+#else
+  lower->ops->stop(lower);
+#endif
+#endif
+}
+
+/****************************************************************************
+ * Name: audio_mixer_flush
+ *
+ * Description:
+ *   Give all of the buffers of a stream back to its upper half.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_flush(FAR struct audio_mixer_stream_s *stream)
+{
+  FAR struct ap_buffer_s *apb;
+
+  while ((apb = (FAR struct ap_buffer_s *)dq_remfirst(&stream->queue)) !=
+         NULL)
+    {
+      apb_free(apb);
+      audio_mixer_upper(stream, AUDIO_CALLBACK_DEQUEUE, apb);
+    }
+
+  stream->phase   = 0;
+  stream->last[0] = 0;
+  stream->last[1] = 0;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_getcaps
+ *
+ * Description: Get the audio device capabilities
+ *
+ ****************************************************************************/
+
+static int audio_mixer_getcaps(FAR struct audio_lowerhalf_s *dev, int type,
+                               FAR struct audio_caps_s *caps)
+{
+  caps->ac_format.hw  = 0;
+  caps->ac_controls.w = 0;
+
+  switch (caps->ac_type)
+    {
+      case AUDIO_TYPE_QUERY:
+        if (caps->ac_subtype == AUDIO_TYPE_QUERY)
+          {
+            caps->ac_controls.b[0] = AUDIO_TYPE_OUTPUT | AUDIO_TYPE_FEATURE;
+            caps->ac_format.hw     = 1 << (AUDIO_FMT_PCM - 1);
+          }
+        else
+          {
+            caps->ac_controls.b[0] = AUDIO_SUBFMT_END;
+          }
+        break;
+
+      case AUDIO_TYPE_OUTPUT:
+        if (caps->ac_subtype == AUDIO_TYPE_QUERY)
+          {
+            caps->ac_controls.hw[0] = AUDIO_SAMP_RATE_DEF_ALL;
+            caps->ac_channels       = 0x10 | MIXER_NCHANNELS;
+          }
+        break;
+
+      case AUDIO_TYPE_FEATURE:
+        if (caps->ac_subtype == AUDIO_FU_UNDEF)
+          {
+            caps->ac_controls.b[0] = AUDIO_FU_VOLUME;
+          }
+        break;
+
+      default:
+        break;
+    }
+
+  return caps->ac_len;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_configure
+ *
+ * Description:
+ *   Set the format or the volume of a stream.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_configure(FAR struct audio_lowerhalf_s *dev,
+                                 FAR void *session,
+                                 FAR const struct audio_caps_s *caps)
+#else
+static int audio_mixer_configure(FAR struct audio_lowerhalf_s *dev,
+                                 FAR const struct audio_caps_s *caps)
+#endif
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+  FAR struct audio_mixer_s *mixer = stream->mixer;
+  uint32_t samprate;
+  uint32_t step;
+  int bpsamp;
+  int ret = OK;
+
+  nxrmutex_lock(&mixer->lock);
+
+  switch (caps->ac_type)
+    {
+      case AUDIO_TYPE_OUTPUT:
+        samprate = caps->ac_controls.hw[0] |
+                   ((uint32_t)caps->ac_controls.b[3] << 16);
+        bpsamp   = caps->ac_controls.b[2] / 8;
+        step     = ((uint64_t)samprate << 16) /
+                   CONFIG_AUDIO_MIXER_SAMPLERATE;
+
+        if (stream->started)
+          {
+            ret = -EBUSY;
+          }
+        else if (caps->ac_channels == 0 || step == 0 ||
+                 step > (MIXER_MAXRATIO << 16) || bpsamp < 2 ||
+                 bpsamp > 4 || (caps->ac_subtype ==
+                                AUDIO_SUBFMT_PCM_F32_LE && bpsamp != 4))
+          {
+            ret = -EINVAL;
+          }
+        else
+          {
+            stream->nchannels = caps->ac_channels;
+            stream->bpsamp    = bpsamp;
+            stream->isfloat   = caps->ac_subtype == AUDIO_SUBFMT_PCM_F32_LE;
+            stream->step      = step;
+          }
+        break;
+
+#ifndef CONFIG_AUDIO_EXCLUDE_VOLUME
+      case AUDIO_TYPE_FEATURE:
+        if (caps->ac_format.hw != AUDIO_FU_VOLUME)
+          {
+            ret = -ENOTTY;
+          }
+        else if (caps->ac_controls.hw[0] > 1000)
+          {
+            ret = -EDOM;
+          }
+        else
+          {
+            stream->volume = caps->ac_controls.hw[0] * MIXER_UNITY / 1000;
+          }
+        break;
+#endif
+
+      default:
+        ret = -ENOTTY;
+        break;
+    }
+
+  nxrmutex_unlock(&mixer->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_shutdown
+ *
+ * Description:
+ *   Stop the stream.
+ *
+ ****************************************************************************/
+
+static int audio_mixer_shutdown(FAR struct audio_lowerhalf_s *dev)
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+  if (stream->started)
+    {
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+      audio_mixer_stop(dev, stream);
+#else
+      audio_mixer_stop(dev);
+#endif
+    }
+#endif
+
+  stream->volume = MIXER_UNITY;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_start
+ *
+ * Description:
+ *   Start mixing the stream, and the output with the first stream.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_start(FAR struct audio_lowerhalf_s *dev,
+                             FAR void *session)
+#else
+static int audio_mixer_start(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+  FAR struct audio_mixer_s *mixer = stream->mixer;
+  int ret = OK;
+
+  if (stream->step == 0)
+    {
+      return -EINVAL;
+    }
+
+  nxrmutex_lock(&mixer->lock);
+
+  if (!stream->started)
+    {
+      stream->started = true;
+      stream->paused  = false;
+      mixer->nstarted++;
+
+      if (!mixer->started)
+        {
+          ret = audio_mixer_startlower(mixer);
+          if (ret < 0)
+            {
+              stream->started = false;
+              mixer->nstarted--;
+            }
+        }
+    }
+
+  nxrmutex_unlock(&mixer->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_stop
+ *
+ * Description:
+ *   Stop mixing the stream, and the output with the last stream.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_stop(FAR struct audio_lowerhalf_s *dev,
+                            FAR void *session)
+#else
+static int audio_mixer_stop(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+  FAR struct audio_mixer_s *mixer = stream->mixer;
+  bool started;
+
+  nxrmutex_lock(&mixer->lock);
+
+  started = stream->started;
+  if (started)
+    {
+      stream->started = false;
+      mixer->nstarted--;
+    }
+
+  audio_mixer_flush(stream);
+
+  if (started)
+    {
+      audio_mixer_upper(stream, AUDIO_CALLBACK_COMPLETE, NULL);
+    }
+
+  if (mixer->nstarted == 0 && mixer->started)
+    {
+      audio_mixer_stoplower(mixer);
+    }
+
+  nxrmutex_unlock(&mixer->lock);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: audio_mixer_pause
+ *
+ * Description: Pauses the stream, which is silent meanwhile.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_pause(FAR struct audio_lowerhalf_s *dev,
+                             FAR void *session)
+#else
+static int audio_mixer_pause(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+
+  nxrmutex_lock(&stream->mixer->lock);
+  stream->paused = true;
+  nxrmutex_unlock(&stream->mixer->lock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_resume
+ *
+ * Description: Resumes the stream.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_resume(FAR struct audio_lowerhalf_s *dev,
+                              FAR void *session)
+#else
+static int audio_mixer_resume(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+
+  nxrmutex_lock(&stream->mixer->lock);
+  stream->paused = false;
+  nxrmutex_unlock(&stream->mixer->lock);
+  return OK;
+}
+#endif /* CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME */
+
+/****************************************************************************
+ * Name: audio_mixer_enqueuebuffer
+ *
+ * Description: Queue a buffer of the stream for mixing.
+ *
+ ****************************************************************************/
+
+static int audio_mixer_enqueuebuffer(FAR struct audio_lowerhalf_s *dev,
+                                     FAR struct ap_buffer_s *apb)
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+
+  if (stream->step == 0)
+    {
+      return -EINVAL;
+    }
+
+  /* The lock is recursive because the upper half may enqueue again from
+   * the dequeue callbacks of the mixing.
+   */
+
+  nxrmutex_lock(&stream->mixer->lock);
+
+  apb_reference(apb);
+  apb->flags |= AUDIO_APB_OUTPUT_ENQUEUED;
+  dq_addlast(&apb->dq_entry, &stream->queue);
+
+  nxrmutex_unlock(&stream->mixer->lock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_ioctl
+ *
+ * Description: Perform a device ioctl
+ *
+ ****************************************************************************/
+
+static int audio_mixer_ioctl(FAR struct audio_lowerhalf_s *dev, int cmd,
+                             unsigned long arg)
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+  int ret = -ENOTTY;
+
+  if (cmd == AUDIOIOC_GETBUFFERINFO)
+    {
+      FAR struct ap_buffer_info_s *info =
+        (FAR struct ap_buffer_info_s *)arg;
+
+      /* A period of the mix in the format of the stream */
+
+      info->nbuffers    = CONFIG_AUDIO_MIXER_NBUFFERS;
+      info->buffer_size = CONFIG_AUDIO_MIXER_PERIOD *
+                          (stream->nchannels ? stream->nchannels : 2) *
+                          (stream->bpsamp ? stream->bpsamp : 2);
+      ret = OK;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_reserve
+ *
+ * Description: Reserves the stream.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_reserve(FAR struct audio_lowerhalf_s *dev,
+                               FAR void **session)
+#else
+static int audio_mixer_reserve(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+  int ret = OK;
+
+  nxrmutex_lock(&stream->mixer->lock);
+
+  if (stream->reserved)
+    {
+      ret = -EBUSY;
+    }
+  else
+    {
+      stream->reserved = true;
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+      *session = stream;
+#endif
+    }
+
+  nxrmutex_unlock(&stream->mixer->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_release
+ *
+ * Description: Releases the stream.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_release(FAR struct audio_lowerhalf_s *dev,
+                               FAR void *session)
+#else
+static int audio_mixer_release(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+
+  stream->reserved = false;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_callback
+ *
+ * Description:
+ *   Lower-to-upper level callback of the output: queue the buffers that
+ *   are played for the worker to refill them.
+ *
+ * Assumptions:
+ *   This function may be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static void audio_mixer_callback(FAR void *arg, uint16_t reason,
+                                 FAR struct ap_buffer_s *apb,
+                                 uint16_t status,
+                                 FAR void *session)
+#else
+static void audio_mixer_callback(FAR void *arg, uint16_t reason,
+                                 FAR struct ap_buffer_s *apb,
+                                 uint16_t status)
+#endif
+{
+  FAR struct audio_mixer_s *mixer = arg;
+  irqstate_t flags;
+
+  if (reason == AUDIO_CALLBACK_DEQUEUE)
+    {
+      flags = enter_critical_section();
+      dq_addlast(&apb->dq_entry, &mixer->done);
+      leave_critical_section(flags);
+
+      work_queue(HPWORK, &mixer->work, audio_mixer_worker, mixer, 0);
+    }
+  else if (reason == AUDIO_CALLBACK_IOERR)
+    {
+      auderr("ERROR: output I/O error %d\n", status);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: audio_mixer_initialize
+ *
+ * Description:
+ *   Register nstreams playback devices, named name0, name1, ..., whose
+ *   streams are mixed into the output of the lower half audio driver.
+ *
+ * Input Parameters:
+ *   name     - The prefix of the names of the audio devices.
+ *   nstreams - The number of streams.
+ *   lower    - The lower half audio driver that plays the mix.
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int audio_mixer_initialize(FAR const char *name, int nstreams,
+                           FAR struct audio_lowerhalf_s *lower)
+{
+  FAR struct audio_mixer_stream_s *stream;
+  FAR struct audio_mixer_s *mixer;
+  char devname[32];
+  int ret;
+  int i;
+
+  DEBUGASSERT(name != NULL && nstreams > 0 && lower != NULL);
+
+  mixer = kmm_zalloc(sizeof(struct audio_mixer_s));
+  if (mixer == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  mixer->streams = kmm_calloc(nstreams,
+                              sizeof(struct audio_mixer_stream_s));
+  if (mixer->streams == NULL)
+    {
+      kmm_free(mixer);
+      return -ENOMEM;
+    }
+
+  nxrmutex_init(&mixer->lock);
+  mixer->nstreams = nstreams;
+  mixer->lower    = lower;
+  lower->upper    = audio_mixer_callback;
+  lower->priv     = mixer;
+
+  for (i = 0; i < nstreams; i++)
+    {
+      stream             = &mixer->streams[i];
+      stream->export.ops = &g_audio_mixer_ops;
+      stream->mixer      = mixer;
+      stream->volume     = MIXER_UNITY;
+
+      snprintf(devname, sizeof(devname), "%s%d", name, i);
+      ret = audio_register(devname, &stream->export);
+      if (ret < 0)
+        {
+          if (i == 0)
+            {
+              nxrmutex_destroy(&mixer->lock);
+              kmm_free(mixer->streams);
+              kmm_free(mixer);
+            }
+
+          return ret;
+        }
+    }
+
+  return OK;
+}
@@ -133,6 +133,11 @@ static int elf_loadbinary(FAR struct binary_s *binp,
     }
   else if (loadinfo.ehdr.e_type == ET_EXEC)
     {
+      /* A prelinked executable was bound to the symbols of the firmware
+       * when it was linked, the exported symbols are of no use to it.
+       */
+
+#ifndef CONFIG_MODLIB_PRELINK
       if (nexports > 0)
         {
           berr("Cannot bind exported symbols to a "
@@ -140,6 +145,7 @@ static int elf_loadbinary(FAR struct binary_s *binp,
           ret = -ENOEXEC;
           goto errout_with_load;
         }
+#endif
 
       /* The entrypoint for a fully linked executable can be found directly */
 
@@ -183,6 +189,7 @@ static int elf_loadbinary(FAR struct binary_s *binp,
 
   binp->mod.textalloc = (FAR void *)loadinfo.textalloc;
   binp->mod.dataalloc = (FAR void *)loadinfo.datastart;
+  binp->mod.xipbase   = loadinfo.xipbase;
 #  ifdef CONFIG_BINFMT_CONSTRUCTORS
   binp->mod.initarr = loadinfo.initarr;
   binp->mod.finiarr = loadinfo.finiarr;
@@ -28,6 +28,7 @@
 
 #include <nuttx/userspace.h>
 #include <nuttx/wqueue.h>
+#include <nuttx/clock.h>
 #include <nuttx/mm/mm.h>
 
 #if defined(CONFIG_BUILD_PROTECTED) && !defined(__KERNEL__)
@@ -93,6 +94,12 @@ const struct userspace_s userspace locate_data(".userspace") =
 #ifdef CONFIG_LIBC_USRWORK
   .work_usrstart    = work_usrstart,
 #endif
+
+  /* Clock state published by the kernel (include/nuttx/clock.h) */
+
+#ifdef CONFIG_CLOCK_USERSPACE
+  .us_clock         = &g_clock_user,
+#endif
 };
 
 /****************************************************************************
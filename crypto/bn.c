@@ -49,6 +49,7 @@
 
 #include <stdio.h>
 #include <stdbool.h>
+#include <string.h>
 #include <assert.h>
 #include <crypto/bn.h>
 
@@ -60,6 +61,30 @@
 
 #define require(p, msg) ASSERT(p && msg)
 
+/* The word of the Montgomery arithmetic is the widest one with a product
+ * of twice its width, the 64-bit targets multiply 64-bit words.
+ */
+
+#ifdef __SIZEOF_INT128__
+#  define BN_WORD_BITS        64
+#else
+#  define BN_WORD_BITS        32
+#endif
+
+#define BN_MONT_WORDS         (BN_ARRAY_SIZE * WORD_SIZE / sizeof(bn_word_t))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef __SIZEOF_INT128__
+typedef uint64_t bn_word_t;
+typedef unsigned __int128 bn_dword_t;
+#else
+typedef uint32_t bn_word_t;
+typedef uint64_t bn_dword_t;
+#endif
+
 /****************************************************************************
  * Private Functions Prototype
  ****************************************************************************/
@@ -159,6 +184,240 @@ static void rshift_one_bit(FAR struct bn *a)
   a->array[BN_ARRAY_SIZE - 1] >>= 1;
 }
 
+/* Montgomery arithmetic on words, with the modulus n of k words.  The
+ * products are reduced by n0 = -1 / n mod 2^BN_WORD_BITS, the results are
+ * below n, and the running time only depends on k.
+ */
+
+static void bn_to_words(FAR bn_word_t *w, FAR const struct bn *a, int k)
+{
+  FAR const uint8_t *p = (FAR const uint8_t *)a->array;
+  int i;
+  int j;
+
+  for (i = 0; i < k; i++)
+    {
+      w[i] = 0;
+      for (j = sizeof(bn_word_t) - 1; j >= 0; j--)
+        {
+          w[i] = (w[i] << 8) | p[i * sizeof(bn_word_t) + j];
+        }
+    }
+}
+
+static void bn_from_words(FAR struct bn *a, FAR const bn_word_t *w, int k)
+{
+  FAR uint8_t *p = (FAR uint8_t *)a->array;
+  int i;
+  int j;
+
+  bignum_init(a);
+  for (i = 0; i < k; i++)
+    {
+      for (j = 0; j < sizeof(bn_word_t); j++)
+        {
+          p[i * sizeof(bn_word_t) + j] = w[i] >> (8 * j);
+        }
+    }
+}
+
+/* r = t - n if t >= n, where t has k + 1 words and t < 2n */
+
+static void bn_mont_reduce(FAR bn_word_t *r, FAR const bn_word_t *t,
+                           FAR const bn_word_t *n, int k)
+{
+  bn_word_t u[BN_MONT_WORDS];
+  bn_word_t borrow = 0;
+  bn_word_t mask;
+  bn_dword_t d;
+  int j;
+
+  for (j = 0; j < k; j++)
+    {
+      d      = (bn_dword_t)t[j] - n[j] - borrow;
+      u[j]   = (bn_word_t)d;
+      borrow = (bn_word_t)(d >> BN_WORD_BITS) & 1;
+    }
+
+  /* Keep t if the subtraction borrows out of the top word */
+
+  borrow = (bn_word_t)(((bn_dword_t)t[k] - borrow) >> BN_WORD_BITS) & 1;
+  mask   = borrow - 1;
+
+  for (j = 0; j < k; j++)
+    {
+      r[j] = (u[j] & mask) | (t[j] & ~mask);
+    }
+}
+
+/* r = a * b / 2^(k * BN_WORD_BITS) mod n, r may be a or b */
+
+static void bn_mont_mul(FAR bn_word_t *r, FAR const bn_word_t *a,
+                        FAR const bn_word_t *b, FAR const bn_word_t *n,
+                        bn_word_t n0, int k)
+{
+  bn_word_t t[BN_MONT_WORDS + 2];
+  bn_dword_t c;
+  bn_word_t m;
+  int i;
+  int j;
+
+  memset(t, 0, (k + 2) * sizeof(bn_word_t));
+
+  for (i = 0; i < k; i++)
+    {
+      /* t += a * b[i] */
+
+      c = 0;
+      for (j = 0; j < k; j++)
+        {
+          c    = (bn_dword_t)a[j] * b[i] + t[j] + (c >> BN_WORD_BITS);
+          t[j] = (bn_word_t)c;
+        }
+
+      c        = (bn_dword_t)t[k] + (c >> BN_WORD_BITS);
+      t[k]     = (bn_word_t)c;
+      t[k + 1] = (bn_word_t)(c >> BN_WORD_BITS);
+
+      /* t = (t + m * n) / 2^BN_WORD_BITS, with m making the low word 0 */
+
+      m = t[0] * n0;
+      c = (bn_dword_t)m * n[0] + t[0];
+      for (j = 1; j < k; j++)
+        {
+          c        = (bn_dword_t)m * n[j] + t[j] + (c >> BN_WORD_BITS);
+          t[j - 1] = (bn_word_t)c;
+        }
+
+      c        = (bn_dword_t)t[k] + (c >> BN_WORD_BITS);
+      t[k - 1] = (bn_word_t)c;
+      t[k]     = t[k + 1] + (bn_word_t)(c >> BN_WORD_BITS);
+    }
+
+  bn_mont_reduce(r, t, n, k);
+}
+
+/* Swap a and b if bit is 1, in constant time */
+
+static void bn_mont_cswap(FAR bn_word_t *a, FAR bn_word_t *b,
+                          bn_word_t bit, int k)
+{
+  bn_word_t mask = 0 - bit;
+  bn_word_t x;
+  int j;
+
+  for (j = 0; j < k; j++)
+    {
+      x     = (a[j] ^ b[j]) & mask;
+      a[j] ^= x;
+      b[j] ^= x;
+    }
+}
+
+/* res = a ^ b mod n, n odd.  The Montgomery ladder does one product and
+ * one square for every bit of b, whatever its value.
+ */
+
+static void bn_mont_pow_mod(FAR struct bn *a, FAR struct bn *b,
+                            FAR struct bn *n, FAR struct bn *res)
+{
+  bn_word_t nw[BN_MONT_WORDS];
+  bn_word_t r2[BN_MONT_WORDS];
+  bn_word_t x0[BN_MONT_WORDS + 1];
+  bn_word_t x1[BN_MONT_WORDS];
+  bn_word_t one[BN_MONT_WORDS];
+  FAR const uint8_t *e = (FAR const uint8_t *)b->array;
+  struct bn tmp;
+  bn_dword_t c;
+  bn_word_t n0;
+  bn_word_t bit;
+  int nbits;
+  int i;
+  int j;
+  int k;
+
+  /* The number of words of n, and of bits of b */
+
+  i = sizeof(nw) - 1;
+  while (i > 0 && ((FAR const uint8_t *)n->array)[i] == 0)
+    {
+      i--;
+    }
+
+  k = i / sizeof(bn_word_t) + 1;
+
+  nbits = sizeof(nw) * 8;
+  while (nbits > 0 && (e[(nbits - 1) / 8] & (1 << ((nbits - 1) % 8))) == 0)
+    {
+      nbits--;
+    }
+
+  bn_to_words(nw, n, k);
+
+  /* n0 = -1 / n, each Newton step doubles the bits right of x */
+
+  n0 = nw[0];
+  for (i = 0; i < 5; i++)
+    {
+      n0 *= 2 - nw[0] * n0;
+    }
+
+  n0 = 0 - n0;
+
+  /* r2 = 2^(2 * k * BN_WORD_BITS) mod n, by doubling 1 */
+
+  memset(x0, 0, sizeof(x0));
+  x0[0] = 1;
+  for (i = 0; i < 2 * k * BN_WORD_BITS; i++)
+    {
+      c = 0;
+      for (j = 0; j <= k; j++)
+        {
+          c     = ((bn_dword_t)x0[j] << 1) + (c >> BN_WORD_BITS);
+          x0[j] = (bn_word_t)c;
+        }
+
+      bn_mont_reduce(x0, x0, nw, k);
+      x0[k] = 0;
+    }
+
+  memcpy(r2, x0, k * sizeof(bn_word_t));
+
+  /* x1 = a * R, x0 = 1 * R */
+
+  if (bignum_cmp(a, n) != SMALLER)
+    {
+      bignum_mod(a, n, &tmp);
+      bn_to_words(x1, &tmp, k);
+    }
+  else
+    {
+      bn_to_words(x1, a, k);
+    }
+
+  memset(one, 0, sizeof(one));
+  one[0] = 1;
+
+  bn_mont_mul(x1, x1, r2, nw, n0, k);
+  bn_mont_mul(x0, one, r2, nw, n0, k);
+
+  while (nbits-- > 0)
+    {
+      bit = (e[nbits / 8] >> (nbits % 8)) & 1;
+      bn_mont_cswap(x0, x1, bit, k);
+      bn_mont_mul(x1, x0, x1, nw, n0, k);
+      bn_mont_mul(x0, x0, x0, nw, n0, k);
+      bn_mont_cswap(x0, x1, bit, k);
+    }
+
+  bn_mont_mul(x0, x0, one, nw, n0, k);
+  bn_from_words(res, x0, k);
+
+  explicit_bzero(x0, sizeof(x0));
+  explicit_bzero(x1, sizeof(x1));
+  explicit_bzero(&tmp, sizeof(tmp));
+}
+
 static
 void bignum_add_sub(struct bn *a, struct bn *b, struct bn *c, int flip)
 {
@@ -867,6 +1126,15 @@ void pow_mod_faster(FAR struct bn *a, FAR struct bn *b,
   struct bn tmpa;
   struct bn tmpb;
   struct bn tmp;
+
+  /* The odd moduli of RSA and DH take the Montgomery way */
+
+  if ((n->array[0] & 1) != 0)
+    {
+      bn_mont_pow_mod(a, b, n, res);
+      return;
+    }
+
   bignum_assign(&tmpa, a);
   bignum_assign(&tmpb, b);
 
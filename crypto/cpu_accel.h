@@ -0,0 +1,85 @@
+/****************************************************************************
+ * crypto/cpu_accel.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __CRYPTO_CPU_ACCEL_H
+#define __CRYPTO_CPU_ACCEL_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef CONFIG_CRYPTO_CPU_ACCEL
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The features found by the probe of the backends */
+
+#define CRYPTO_ACCEL_AES    (1 << 0)
+#define CRYPTO_ACCEL_SHA256 (1 << 1)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The primitives of the software crypto done with the crypto instructions
+ * of the CPU.  An operation is NULL if the CPU lacks its instructions.
+ */
+
+struct crypto_accel_s
+{
+  /* Encrypt or decrypt one block with the schedule of rijndael.c, each
+   * round key stored as its 16 bytes (see rijndael_set_key()).
+   */
+
+  CODE void (*aes_encrypt)(FAR const uint8_t *rk, int nr,
+                           FAR const uint8_t *src, FAR uint8_t *dst);
+  CODE void (*aes_decrypt)(FAR const uint8_t *rk, int nr,
+                           FAR const uint8_t *src, FAR uint8_t *dst);
+
+  /* Hash nblocks blocks of 64 bytes into the SHA-256 state */
+
+  CODE void (*sha256)(FAR uint32_t *state, FAR const uint8_t *data,
+                      size_t nblocks);
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: crypto_accel
+ *
+ * Description:
+ *   Return the operations the CPU accelerates.  The CPU features are
+ *   probed on the first call, the result never changes afterwards.
+ *
+ ****************************************************************************/
+
+FAR const struct crypto_accel_s *crypto_accel(void);
+
+#endif /* CONFIG_CRYPTO_CPU_ACCEL */
+#endif /* __CRYPTO_CPU_ACCEL_H */
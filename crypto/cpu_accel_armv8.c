@@ -0,0 +1,246 @@
+/****************************************************************************
+ * crypto/cpu_accel_armv8.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __CRYPTO_CPU_ACCEL_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <arm_neon.h>
+
+#include "cpu_accel.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define CE_TARGET           __attribute__((target("+crypto")))
+
+/* The fields of ID_AA64ISAR0_EL1 */
+
+#define ID_AA64ISAR0_AES(r)  (((r) >> 4) & 0xf)
+#define ID_AA64ISAR0_SHA2(r) (((r) >> 12) & 0xf)
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static CE_TARGET void armv8_aes_encrypt(FAR const uint8_t *rk, int nr,
+                                        FAR const uint8_t *src,
+                                        FAR uint8_t *dst);
+static CE_TARGET void armv8_aes_decrypt(FAR const uint8_t *rk, int nr,
+                                        FAR const uint8_t *src,
+                                        FAR uint8_t *dst);
+static CE_TARGET void armv8_sha256(FAR uint32_t *state,
+                                   FAR const uint8_t *data,
+                                   size_t nblocks);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const uint32_t g_sha256_k[64] =
+{
+  0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+  0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+  0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+  0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+  0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+  0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+  0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+  0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+  0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+  0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+  0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+  0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+  0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+  0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+  0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+  0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+/* The operations by the features found, the tables are constant so that
+ * publishing the pointer is enough for the other CPUs.
+ */
+
+static const struct crypto_accel_s g_crypto_accels[] =
+{
+  { NULL, NULL, NULL },
+  { armv8_aes_encrypt, armv8_aes_decrypt, NULL },
+  { NULL, NULL, armv8_sha256 },
+  { armv8_aes_encrypt, armv8_aes_decrypt, armv8_sha256 },
+};
+
+static FAR const struct crypto_accel_s *g_crypto_accel;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: armv8_aes_encrypt
+ *
+ * Description:
+ *   AESE adds the round key before the substitution, so the last round key
+ *   is added alone.
+ *
+ ****************************************************************************/
+
+static CE_TARGET void armv8_aes_encrypt(FAR const uint8_t *rk, int nr,
+                                        FAR const uint8_t *src,
+                                        FAR uint8_t *dst)
+{
+  uint8x16_t s = vld1q_u8(src);
+  int i;
+
+  for (i = 0; i < nr - 1; i++)
+    {
+      s = vaesmcq_u8(vaeseq_u8(s, vld1q_u8(rk + 16 * i)));
+    }
+
+  s = vaeseq_u8(s, vld1q_u8(rk + 16 * (nr - 1)));
+  s = veorq_u8(s, vld1q_u8(rk + 16 * nr));
+  vst1q_u8(dst, s);
+}
+
+/****************************************************************************
+ * Name: armv8_aes_decrypt
+ *
+ * Description:
+ *   The decryption schedule of rijndael.c is the one of the equivalent
+ *   inverse cipher, that AESD and AESIMC expect.
+ *
+ ****************************************************************************/
+
+static CE_TARGET void armv8_aes_decrypt(FAR const uint8_t *rk, int nr,
+                                        FAR const uint8_t *src,
+                                        FAR uint8_t *dst)
+{
+  uint8x16_t s = vld1q_u8(src);
+  int i;
+
+  for (i = 0; i < nr - 1; i++)
+    {
+      s = vaesimcq_u8(vaesdq_u8(s, vld1q_u8(rk + 16 * i)));
+    }
+
+  s = vaesdq_u8(s, vld1q_u8(rk + 16 * (nr - 1)));
+  s = veorq_u8(s, vld1q_u8(rk + 16 * nr));
+  vst1q_u8(dst, s);
+}
+
+/****************************************************************************
+ * Name: armv8_sha256
+ *
+ * Description:
+ *   SHA-256 with the SHA2 instructions.  SHA256H and SHA256H2 do four
+ *   rounds on the state split in ABCD and EFGH, the message schedule is
+ *   done four words at a time.
+ *
+ ****************************************************************************/
+
+static CE_TARGET void armv8_sha256(FAR uint32_t *state,
+                                   FAR const uint8_t *data,
+                                   size_t nblocks)
+{
+  uint32x4_t abcdsave;
+  uint32x4_t efghsave;
+  uint32x4_t state0;
+  uint32x4_t state1;
+  uint32x4_t msg[4];
+  uint32x4_t abcd;
+  uint32x4_t tmp;
+  int i;
+
+  state0 = vld1q_u32(&state[0]);
+  state1 = vld1q_u32(&state[4]);
+
+  while (nblocks-- > 0)
+    {
+      abcdsave = state0;
+      efghsave = state1;
+
+      for (i = 0; i < 4; i++)
+        {
+          msg[i] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + 16 * i)));
+        }
+
+      for (i = 0; i < 16; i++)
+        {
+          tmp    = vaddq_u32(msg[i & 3], vld1q_u32(&g_sha256_k[4 * i]));
+          abcd   = state0;
+          state0 = vsha256hq_u32(state0, state1, tmp);
+          state1 = vsha256h2q_u32(state1, abcd, tmp);
+
+          /* The words of the rounds 4 groups ahead */
+
+          if (i < 12)
+            {
+              msg[i & 3] = vsha256su1q_u32(
+                vsha256su0q_u32(msg[i & 3], msg[(i + 1) & 3]),
+                msg[(i + 2) & 3], msg[(i + 3) & 3]);
+            }
+        }
+
+      state0 = vaddq_u32(state0, abcdsave);
+      state1 = vaddq_u32(state1, efghsave);
+      data  += 64;
+    }
+
+  vst1q_u32(&state[0], state0);
+  vst1q_u32(&state[4], state1);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: crypto_accel
+ ****************************************************************************/
+
+FAR const struct crypto_accel_s *crypto_accel(void)
+{
+  unsigned int features = 0;
+  uint64_t isar0;
+
+  if (g_crypto_accel != NULL)
+    {
+      return g_crypto_accel;
+    }
+
+  __asm__ __volatile__("mrs %0, id_aa64isar0_el1" : "=r"(isar0));
+
+  if (ID_AA64ISAR0_AES(isar0) != 0)
+    {
+      features |= CRYPTO_ACCEL_AES;
+    }
+
+  if (ID_AA64ISAR0_SHA2(isar0) != 0)
+    {
+      features |= CRYPTO_ACCEL_SHA256;
+    }
+
+  g_crypto_accel = &g_crypto_accels[features];
+  return g_crypto_accel;
+}
@@ -0,0 +1,271 @@
+/****************************************************************************
+ * crypto/cpu_accel_x86.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <cpuid.h>
+#include <immintrin.h>
+
+#include "cpu_accel.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define AESNI_TARGET     __attribute__((target("aes,sse2")))
+#define SHANI_TARGET     __attribute__((target("sha,sse4.1,ssse3")))
+
+/* The CPUID feature bits */
+
+#define CPUID1_ECX_SSSE3 (1 << 9)
+#define CPUID1_ECX_SSE41 (1 << 19)
+#define CPUID1_ECX_AES   (1 << 25)
+#define CPUID1_EDX_SSE2  (1 << 26)
+#define CPUID7_EBX_SHA   (1 << 29)
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static AESNI_TARGET void aesni_encrypt(FAR const uint8_t *rk, int nr,
+                                       FAR const uint8_t *src,
+                                       FAR uint8_t *dst);
+static AESNI_TARGET void aesni_decrypt(FAR const uint8_t *rk, int nr,
+                                       FAR const uint8_t *src,
+                                       FAR uint8_t *dst);
+static SHANI_TARGET void shani_sha256(FAR uint32_t *state,
+                                      FAR const uint8_t *data,
+                                      size_t nblocks);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const uint32_t g_sha256_k[64] =
+{
+  0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+  0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+  0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+  0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+  0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+  0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+  0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+  0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+  0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+  0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+  0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+  0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+  0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+  0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+  0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+  0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+/* The operations by the features found, the tables are constant so that
+ * publishing the pointer is enough for the other CPUs.
+ */
+
+static const struct crypto_accel_s g_crypto_accels[] =
+{
+  { NULL, NULL, NULL },
+  { aesni_encrypt, aesni_decrypt, NULL },
+  { NULL, NULL, shani_sha256 },
+  { aesni_encrypt, aesni_decrypt, shani_sha256 },
+};
+
+static FAR const struct crypto_accel_s *g_crypto_accel;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: aesni_encrypt
+ ****************************************************************************/
+
+static AESNI_TARGET void aesni_encrypt(FAR const uint8_t *rk, int nr,
+                                       FAR const uint8_t *src,
+                                       FAR uint8_t *dst)
+{
+  FAR const __m128i *key = (FAR const __m128i *)rk;
+  __m128i s;
+  int i;
+
+  s = _mm_xor_si128(_mm_loadu_si128((FAR const __m128i *)src),
+                    _mm_loadu_si128(&key[0]));
+  for (i = 1; i < nr; i++)
+    {
+      s = _mm_aesenc_si128(s, _mm_loadu_si128(&key[i]));
+    }
+
+  s = _mm_aesenclast_si128(s, _mm_loadu_si128(&key[nr]));
+  _mm_storeu_si128((FAR __m128i *)dst, s);
+}
+
+/****************************************************************************
+ * Name: aesni_decrypt
+ *
+ * Description:
+ *   The decryption schedule of rijndael.c is the one of the equivalent
+ *   inverse cipher, that AESDEC expects.
+ *
+ ****************************************************************************/
+
+static AESNI_TARGET void aesni_decrypt(FAR const uint8_t *rk, int nr,
+                                       FAR const uint8_t *src,
+                                       FAR uint8_t *dst)
+{
+  FAR const __m128i *key = (FAR const __m128i *)rk;
+  __m128i s;
+  int i;
+
+  s = _mm_xor_si128(_mm_loadu_si128((FAR const __m128i *)src),
+                    _mm_loadu_si128(&key[0]));
+  for (i = 1; i < nr; i++)
+    {
+      s = _mm_aesdec_si128(s, _mm_loadu_si128(&key[i]));
+    }
+
+  s = _mm_aesdeclast_si128(s, _mm_loadu_si128(&key[nr]));
+  _mm_storeu_si128((FAR __m128i *)dst, s);
+}
+
+/****************************************************************************
+ * Name: shani_sha256
+ *
+ * Description:
+ *   SHA-256 with SHA-NI.  SHA256RNDS2 does two rounds on the state split
+ *   in ABEF and CDGH, the message schedule is done four words at a time.
+ *
+ ****************************************************************************/
+
+static SHANI_TARGET void shani_sha256(FAR uint32_t *state,
+                                      FAR const uint8_t *data,
+                                      size_t nblocks)
+{
+  const __m128i mask = _mm_set_epi64x(0x0c0d0e0f08090a0bull,
+                                      0x0405060700010203ull);
+  __m128i abefsave;
+  __m128i cdghsave;
+  __m128i state0;
+  __m128i state1;
+  __m128i msg[4];
+  __m128i tmp;
+  int i;
+
+  /* Rearrange the state from ABCD EFGH to ABEF CDGH */
+
+  tmp    = _mm_loadu_si128((FAR const __m128i *)&state[0]);
+  state1 = _mm_loadu_si128((FAR const __m128i *)&state[4]);
+  tmp    = _mm_shuffle_epi32(tmp, 0xb1);
+  state1 = _mm_shuffle_epi32(state1, 0x1b);
+  state0 = _mm_alignr_epi8(tmp, state1, 8);
+  state1 = _mm_blend_epi16(state1, tmp, 0xf0);
+
+  while (nblocks-- > 0)
+    {
+      abefsave = state0;
+      cdghsave = state1;
+
+      for (i = 0; i < 4; i++)
+        {
+          msg[i] = _mm_shuffle_epi8(
+            _mm_loadu_si128((FAR const __m128i *)(data + 16 * i)), mask);
+        }
+
+      for (i = 0; i < 16; i++)
+        {
+          tmp = _mm_add_epi32(msg[i & 3],
+            _mm_loadu_si128((FAR const __m128i *)&g_sha256_k[4 * i]));
+          state1 = _mm_sha256rnds2_epu32(state1, state0, tmp);
+          tmp = _mm_shuffle_epi32(tmp, 0x0e);
+          state0 = _mm_sha256rnds2_epu32(state0, state1, tmp);
+
+          /* The words of the rounds 4 groups ahead */
+
+          if (i < 12)
+            {
+              tmp = _mm_sha256msg1_epu32(msg[i & 3], msg[(i + 1) & 3]);
+              tmp = _mm_add_epi32(tmp, _mm_alignr_epi8(msg[(i + 3) & 3],
+                                                       msg[(i + 2) & 3],
+                                                       4));
+              msg[i & 3] = _mm_sha256msg2_epu32(tmp, msg[(i + 3) & 3]);
+            }
+        }
+
+      state0 = _mm_add_epi32(state0, abefsave);
+      state1 = _mm_add_epi32(state1, cdghsave);
+      data  += 64;
+    }
+
+  /* Back from ABEF CDGH to ABCD EFGH */
+
+  tmp    = _mm_shuffle_epi32(state0, 0x1b);
+  state1 = _mm_shuffle_epi32(state1, 0xb1);
+  state0 = _mm_blend_epi16(tmp, state1, 0xf0);
+  state1 = _mm_alignr_epi8(state1, tmp, 8);
+
+  _mm_storeu_si128((FAR __m128i *)&state[0], state0);
+  _mm_storeu_si128((FAR __m128i *)&state[4], state1);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: crypto_accel
+ ****************************************************************************/
+
+FAR const struct crypto_accel_s *crypto_accel(void)
+{
+  unsigned int features = 0;
+  unsigned int eax;
+  unsigned int ebx;
+  unsigned int ecx;
+  unsigned int edx;
+
+  if (g_crypto_accel != NULL)
+    {
+      return g_crypto_accel;
+    }
+
+  if (__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+    {
+      if ((ecx & CPUID1_ECX_AES) != 0 && (edx & CPUID1_EDX_SSE2) != 0)
+        {
+          features |= CRYPTO_ACCEL_AES;
+        }
+
+      if ((ecx & CPUID1_ECX_SSE41) != 0 && (ecx & CPUID1_ECX_SSSE3) != 0 &&
+          __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) &&
+          (ebx & CPUID7_EBX_SHA) != 0)
+        {
+          features |= CRYPTO_ACCEL_SHA256;
+        }
+    }
+
+  g_crypto_accel = &g_crypto_accels[features];
+  return g_crypto_accel;
+}
@@ -36,7 +36,8 @@
 #include <errno.h>
 #include <crypto/cryptodev.h>
 #include <nuttx/fs/fs.h>
-#include <nuttx/mutex.h>
+#include <nuttx/rwsem.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/crypto/crypto.h>
 
@@ -51,7 +52,13 @@ int crypto_drivers_num = 0;
  * Private Data
  ****************************************************************************/
 
-static mutex_t g_crypto_lock = NXMUTEX_INITIALIZER;
+/* The requests are processed with the lock held for reading, so that the
+ * sessions run in parallel, the drivers and the sessions are changed with
+ * it held for writing.
+ */
+
+static rw_semaphore_t g_crypto_lock = RWSEM_INITIALIZER;
+static spinlock_t g_crypto_stat_lock = SP_UNLOCKED;
 
 /****************************************************************************
  * Public Functions
@@ -76,7 +83,7 @@ int crypto_newsession(FAR uint64_t *sid,
       return -EINVAL;
     }
 
-  nxmutex_lock(&g_crypto_lock);
+  down_write(&g_crypto_lock);
 
   /* The algorithm we use here is pretty stupid; just use the
    * first driver that supports all the algorithms we need. Do
@@ -200,7 +207,7 @@ int crypto_newsession(FAR uint64_t *sid,
 
   if (hid == -1)
     {
-      nxmutex_unlock(&g_crypto_lock);
+      up_write(&g_crypto_lock);
       return -EINVAL;
     }
 
@@ -216,7 +223,7 @@ int crypto_newsession(FAR uint64_t *sid,
       crypto_drivers[hid].cc_sessions++;
     }
 
-  nxmutex_unlock(&g_crypto_lock);
+  up_write(&g_crypto_lock);
   return err;
 }
 
@@ -243,7 +250,7 @@ int crypto_freesession(uint64_t sid)
       return -ENOENT;
     }
 
-  nxmutex_lock(&g_crypto_lock);
+  down_write(&g_crypto_lock);
 
   if (crypto_drivers[hid].cc_sessions)
     {
@@ -267,7 +274,7 @@ int crypto_freesession(uint64_t sid)
       explicit_bzero(&crypto_drivers[hid], sizeof(struct cryptocap));
     }
 
-  nxmutex_unlock(&g_crypto_lock);
+  up_write(&g_crypto_lock);
   return err;
 }
 
@@ -278,7 +285,7 @@ int crypto_get_driverid(uint8_t flags)
   FAR struct cryptocap *newdrv;
   int i;
 
-  nxmutex_lock(&g_crypto_lock);
+  down_write(&g_crypto_lock);
 
   if (crypto_drivers_num == 0)
     {
@@ -288,7 +295,7 @@ int crypto_get_driverid(uint8_t flags)
       if (crypto_drivers == NULL)
         {
           crypto_drivers_num = 0;
-          nxmutex_unlock(&g_crypto_lock);
+          up_write(&g_crypto_lock);
           return -1;
         }
 
@@ -304,7 +311,7 @@ int crypto_get_driverid(uint8_t flags)
         {
           crypto_drivers[i].cc_sessions = 1; /* Mark */
           crypto_drivers[i].cc_flags = flags;
-          nxmutex_unlock(&g_crypto_lock);
+          up_write(&g_crypto_lock);
           return i;
         }
     }
@@ -315,7 +322,7 @@ int crypto_get_driverid(uint8_t flags)
     {
       if (crypto_drivers_num >= CRYPTO_DRIVERS_MAX)
         {
-          nxmutex_unlock(&g_crypto_lock);
+          up_write(&g_crypto_lock);
           return -1;
         }
 
@@ -323,7 +330,7 @@ int crypto_get_driverid(uint8_t flags)
                           sizeof(struct cryptocap));
       if (newdrv == NULL)
         {
-          nxmutex_unlock(&g_crypto_lock);
+          up_write(&g_crypto_lock);
           return -1;
         }
 
@@ -338,13 +345,13 @@ int crypto_get_driverid(uint8_t flags)
 
       kmm_free(crypto_drivers);
       crypto_drivers = newdrv;
-      nxmutex_unlock(&g_crypto_lock);
+      up_write(&g_crypto_lock);
       return i;
     }
 
   /* Shouldn't really get here... */
 
-  nxmutex_unlock(&g_crypto_lock);
+  up_write(&g_crypto_lock);
   return -1;
 }
 
@@ -363,7 +370,7 @@ int crypto_kregister(uint32_t driverid, FAR int *kalg,
       return -EINVAL;
     }
 
-  nxmutex_lock(&g_crypto_lock);
+  down_write(&g_crypto_lock);
 
   for (i = 0; i <= CRK_ALGORITHM_MAX; i++)
     {
@@ -377,7 +384,7 @@ int crypto_kregister(uint32_t driverid, FAR int *kalg,
 
   crypto_drivers[driverid].cc_kprocess = kprocess;
 
-  nxmutex_unlock(&g_crypto_lock);
+  up_write(&g_crypto_lock);
   return 0;
 }
 
@@ -397,7 +404,7 @@ int crypto_register(uint32_t driverid, FAR int *alg,
       return -EINVAL;
     }
 
-  nxmutex_lock(&g_crypto_lock);
+  down_write(&g_crypto_lock);
 
   for (i = 0; i <= CRYPTO_ALGORITHM_MAX; i++)
     {
@@ -414,7 +421,7 @@ int crypto_register(uint32_t driverid, FAR int *alg,
   crypto_drivers[driverid].cc_freesession = freeses;
   crypto_drivers[driverid].cc_sessions = 0; /* Unmark */
 
-  nxmutex_unlock(&g_crypto_lock);
+  up_write(&g_crypto_lock);
 
   return 0;
 }
@@ -430,14 +437,14 @@ int crypto_unregister(uint32_t driverid, int alg)
   int i = CRYPTO_ALGORITHM_MAX + 1;
   uint32_t ses;
 
-  nxmutex_lock(&g_crypto_lock);
+  down_write(&g_crypto_lock);
 
   /* Sanity checks. */
 
   if (driverid >= crypto_drivers_num || crypto_drivers == NULL ||
       alg <= 0 || alg > (CRYPTO_ALGORITHM_MAX + 1))
     {
-      nxmutex_unlock(&g_crypto_lock);
+      up_write(&g_crypto_lock);
       return -EINVAL;
     }
 
@@ -445,7 +452,7 @@ int crypto_unregister(uint32_t driverid, int alg)
     {
       if (crypto_drivers[driverid].cc_alg[alg] == 0)
         {
-          nxmutex_unlock(&g_crypto_lock);
+          up_write(&g_crypto_lock);
           return -EINVAL;
         }
 
@@ -479,7 +486,7 @@ int crypto_unregister(uint32_t driverid, int alg)
         }
     }
 
-  nxmutex_unlock(&g_crypto_lock);
+  up_write(&g_crypto_lock);
   return 0;
 }
 
@@ -498,7 +505,7 @@ int crypto_kinvoke(FAR struct cryptkop *krp)
       return -EINVAL;
     }
 
-  nxmutex_lock(&g_crypto_lock);
+  down_write(&g_crypto_lock);
   for (hid = 0; hid < crypto_drivers_num; hid++)
     {
       if ((crypto_drivers[hid].cc_flags & CRYPTOCAP_F_SOFTWARE) &&
@@ -524,7 +531,7 @@ int crypto_kinvoke(FAR struct cryptkop *krp)
   if (hid == crypto_drivers_num)
     {
       krp->krp_status = -ENODEV;
-      nxmutex_unlock(&g_crypto_lock);
+      up_write(&g_crypto_lock);
       return 0;
     }
 
@@ -538,7 +545,7 @@ int crypto_kinvoke(FAR struct cryptkop *krp)
       krp->krp_status = error;
     }
 
-  nxmutex_unlock(&g_crypto_lock);
+  up_write(&g_crypto_lock);
   return 0;
 }
 
@@ -547,6 +554,7 @@ int crypto_kinvoke(FAR struct cryptkop *krp)
 int crypto_invoke(FAR struct cryptop *crp)
 {
   FAR struct cryptodesc *crd;
+  irqstate_t flags;
   uint64_t nid;
   uint32_t hid;
   int error;
@@ -558,35 +566,36 @@ int crypto_invoke(FAR struct cryptop *crp)
       return -EINVAL;
     }
 
-  nxmutex_lock(&g_crypto_lock);
+  down_read(&g_crypto_lock);
   if (crp->crp_desc == NULL || crypto_drivers == NULL)
     {
       crp->crp_etype = -EINVAL;
-      nxmutex_unlock(&g_crypto_lock);
+      up_read(&g_crypto_lock);
       return 0;
     }
 
   hid = (crp->crp_sid >> 32) & 0xffffffff;
-  if (hid >= crypto_drivers_num)
+  if (hid >= crypto_drivers_num ||
+      crypto_drivers[hid].cc_process == NULL)
     {
+      up_read(&g_crypto_lock);
       goto migrate;
     }
 
   if (crypto_drivers[hid].cc_flags & CRYPTOCAP_F_CLEANUP)
     {
+      up_read(&g_crypto_lock);
       crypto_freesession(crp->crp_sid);
       goto migrate;
     }
 
-  if (crypto_drivers[hid].cc_process == NULL)
-    {
-      goto migrate;
-    }
-
+  flags = spin_lock_irqsave(&g_crypto_stat_lock);
   crypto_drivers[hid].cc_operations++;
   crypto_drivers[hid].cc_bytes += crp->crp_ilen;
+  spin_unlock_irqrestore(&g_crypto_stat_lock, flags);
 
   error = crypto_drivers[hid].cc_process(crp);
+  up_read(&g_crypto_lock);
   if (error)
     {
       if (error == -ERESTART)
@@ -602,12 +611,11 @@ int crypto_invoke(FAR struct cryptop *crp)
         }
     }
 
-  nxmutex_unlock(&g_crypto_lock);
   return 0;
 
 migrate:
 
-  /* Migrate session. */
+  /* Migrate session, the lock is taken for writing by the calls. */
 
   for (crd = crp->crp_desc; crd->crd_next; crd = crd->crd_next)
     {
@@ -620,7 +628,6 @@ migrate:
     }
 
   crp->crp_etype = -EAGAIN;
-  nxmutex_unlock(&g_crypto_lock);
   return 0;
 }
 
@@ -635,8 +642,6 @@ void crypto_freereq(FAR struct cryptop *crp)
       return;
     }
 
-  nxmutex_lock(&g_crypto_lock);
-
   while ((crd = crp->crp_desc) != NULL)
     {
       crp->crp_desc = crd->crd_next;
@@ -644,7 +649,6 @@ void crypto_freereq(FAR struct cryptop *crp)
     }
 
   kmm_free(crp);
-  nxmutex_unlock(&g_crypto_lock);
 }
 
 /* Acquire a set of crypto descriptors. */
@@ -654,12 +658,9 @@ FAR struct cryptop *crypto_getreq(int num)
   FAR struct cryptodesc *crd;
   FAR struct cryptop *crp;
 
-  nxmutex_lock(&g_crypto_lock);
-
   crp = kmm_malloc(sizeof(struct cryptop));
   if (crp == NULL)
     {
-      nxmutex_unlock(&g_crypto_lock);
       return NULL;
     }
 
@@ -670,7 +671,6 @@ FAR struct cryptop *crypto_getreq(int num)
       crd = kmm_calloc(1, sizeof(struct cryptodesc));
       if (crd == NULL)
         {
-          nxmutex_unlock(&g_crypto_lock);
           crypto_freereq(crp);
           return NULL;
         }
@@ -679,7 +679,6 @@ FAR struct cryptop *crypto_getreq(int num)
       crp->crp_desc = crd;
     }
 
-  nxmutex_unlock(&g_crypto_lock);
   return crp;
 }
 
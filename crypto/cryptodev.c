@@ -42,6 +42,8 @@
 #include <errno.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/crypto/crypto.h>
 #include <nuttx/drivers/drivers.h>
@@ -50,6 +52,15 @@
 #include <crypto/cryptodev.h>
 #include <crypto/cryptosoft.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if defined(CONFIG_CRYPTO_CRYPTODEV_WORKERS) && \
+    CONFIG_CRYPTO_CRYPTODEV_WORKERS > 0
+#  define CRYPTODEV_HAVE_WORKERS
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -70,6 +81,17 @@ int cryptodevallowsoft = 0;
  * Private Types
  ****************************************************************************/
 
+/* An operation submitted by CIOCNCRYPTM */
+
+struct cryptodev_job
+{
+  TAILQ_ENTRY(cryptodev_job) next;
+  struct crypt_op cop;
+  FAR void *opaque;
+  uint32_t reqid;
+  int status;
+};
+
 struct csession
 {
   TAILQ_ENTRY(csession) next;
@@ -88,6 +110,16 @@ struct csession
   caddr_t mackey;
   int mackeylen;
   int error;
+
+  /* The operations submitted and not run yet, the first one is running.
+   * The operations of a session are run in order, one at a time.
+   */
+
+  FAR struct fcrypt *fcr;
+  TAILQ_HEAD(cryptojobs, cryptodev_job) jobs;
+#ifdef CRYPTODEV_HAVE_WORKERS
+  struct work_s work;
+#endif
 };
 
 struct fcrypt
@@ -96,6 +128,11 @@ struct fcrypt
   TAILQ_HEAD(cryptkoplist, cryptkop) crpk_ret;
   int sesn;
   FAR struct pollfd *fds;
+
+  mutex_t lock;               /* Protects the operations and fds */
+  struct cryptojobs crp_ret;  /* The operations done */
+  int njobs;                  /* The operations not got back */
+  uint32_t reqid;             /* The id of the next operation */
 };
 
 /****************************************************************************
@@ -136,6 +173,12 @@ static int csefree(FAR struct csession *);
 static int cryptodev_op(FAR struct csession *,
                         FAR struct crypt_op *);
 static int cryptodev_key(FAR struct fcrypt *, FAR struct crypt_kop *);
+static void cryptodev_run(FAR void *arg);
+static int cryptodev_submit(FAR struct fcrypt *, FAR struct crypt_mop *);
+static int cryptodev_getresults(FAR struct fcrypt *,
+                                FAR struct crypt_ret *);
+static void cryptodev_flush(FAR struct csession *);
+static void fcrinit(FAR struct fcrypt *);
 static int cryptodevkey_cb(FAR struct cryptkop *);
 static int cryptodev_getkeystatus(FAR struct fcrypt *,
                                   FAR struct crypt_kop *);
@@ -177,6 +220,10 @@ static struct inode g_cryptoinode =
   .u.i_ops = &g_cryptofops
 };
 
+#ifdef CRYPTODEV_HAVE_WORKERS
+static FAR struct kwork_wqueue_s *g_cryptodev_wq;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -353,7 +400,13 @@ bail:
             return -EINVAL;
           }
 
+        if (!TAILQ_EMPTY(&cse->jobs))
+          {
+            return -EBUSY;
+          }
+
         csedelete(fcr, cse);
+        cryptodev_flush(cse);
         error = csefree(cse);
         break;
       case CIOCCRYPT:
@@ -364,8 +417,21 @@ bail:
             return -EINVAL;
           }
 
+        /* Don't run beside the submitted operations of the session */
+
+        if (!TAILQ_EMPTY(&cse->jobs))
+          {
+            return -EBUSY;
+          }
+
         error = cryptodev_op(cse, cop);
         break;
+      case CIOCNCRYPTM:
+        error = cryptodev_submit(fcr, (FAR struct crypt_mop *)arg);
+        break;
+      case CIOCNCRYPTRETM:
+        error = cryptodev_getresults(fcr, (FAR struct crypt_ret *)arg);
+        break;
       case CIOCKEY:
         error = cryptodev_key(fcr, (FAR struct crypt_kop *)arg);
         break;
@@ -554,6 +620,170 @@ bail:
   return error;
 }
 
+/* Run the submitted operations of a session, on a worker thread or in
+ * the submitter.
+ */
+
+static void cryptodev_run(FAR void *arg)
+{
+  FAR struct csession *cse = arg;
+  FAR struct fcrypt *fcr = cse->fcr;
+  FAR struct cryptodev_job *job;
+
+  nxmutex_lock(&fcr->lock);
+  while ((job = TAILQ_FIRST(&cse->jobs)) != NULL)
+    {
+      /* The operation stays queued while it runs, so that the next ones
+       * of the session wait for it.
+       */
+
+      nxmutex_unlock(&fcr->lock);
+      job->status = cryptodev_op(cse, &job->cop);
+      nxmutex_lock(&fcr->lock);
+
+      TAILQ_REMOVE(&cse->jobs, job, next);
+      TAILQ_INSERT_TAIL(&fcr->crp_ret, job, next);
+      if (fcr->fds != NULL)
+        {
+          poll_notify(&fcr->fds, 1, POLLIN);
+        }
+    }
+
+  nxmutex_unlock(&fcr->lock);
+}
+
+/* Queue a batch of operations, each one gets its own status */
+
+static int cryptodev_submit(FAR struct fcrypt *fcr,
+                            FAR struct crypt_mop *mop)
+{
+  FAR struct cryptodev_job *job;
+  FAR struct crypt_n_op *req;
+  FAR struct csession *cse;
+  bool start;
+  size_t i;
+
+  if (mop->count > 0 && mop->reqs == NULL)
+    {
+      return -EINVAL;
+    }
+
+  for (i = 0; i < mop->count; i++)
+    {
+      req = &mop->reqs[i];
+      cse = csefind(fcr, req->cop.ses);
+      if (cse == NULL)
+        {
+          req->status = -EINVAL;
+          continue;
+        }
+
+      job = kmm_malloc(sizeof(struct cryptodev_job));
+      if (job == NULL)
+        {
+          req->status = -ENOMEM;
+          continue;
+        }
+
+      job->cop    = req->cop;
+      job->opaque = req->opaque;
+      job->status = 0;
+
+      nxmutex_lock(&fcr->lock);
+      if (fcr->njobs >= CONFIG_CRYPTO_CRYPTODEV_MAXJOBS)
+        {
+          nxmutex_unlock(&fcr->lock);
+          kmm_free(job);
+          req->status = -EAGAIN;
+          continue;
+        }
+
+      job->reqid = fcr->reqid++;
+      fcr->njobs++;
+      start = TAILQ_EMPTY(&cse->jobs);
+      TAILQ_INSERT_TAIL(&cse->jobs, job, next);
+      nxmutex_unlock(&fcr->lock);
+
+      req->reqid  = job->reqid;
+      req->status = OK;
+
+      /* Nothing runs the session yet, start it */
+
+      if (start)
+        {
+#ifdef CRYPTODEV_HAVE_WORKERS
+          if (g_cryptodev_wq != NULL)
+            {
+              work_queue_wq(g_cryptodev_wq, &cse->work, cryptodev_run,
+                            cse, 0);
+              continue;
+            }
+#endif
+
+          cryptodev_run(cse);
+        }
+    }
+
+  return OK;
+}
+
+/* Get the results of the operations done, in the order they are done */
+
+static int cryptodev_getresults(FAR struct fcrypt *fcr,
+                                FAR struct crypt_ret *ret)
+{
+  FAR struct cryptodev_job *job;
+  size_t i;
+
+  if (ret->count > 0 && ret->results == NULL)
+    {
+      return -EINVAL;
+    }
+
+  nxmutex_lock(&fcr->lock);
+  for (i = 0; i < ret->count; i++)
+    {
+      job = TAILQ_FIRST(&fcr->crp_ret);
+      if (job == NULL)
+        {
+          break;
+        }
+
+      TAILQ_REMOVE(&fcr->crp_ret, job, next);
+      fcr->njobs--;
+
+      ret->results[i].reqid  = job->reqid;
+      ret->results[i].status = job->status;
+      ret->results[i].opaque = job->opaque;
+      kmm_free(job);
+    }
+
+  nxmutex_unlock(&fcr->lock);
+
+  ret->count = i;
+  return i > 0 ? OK : -EAGAIN;
+}
+
+/* Wait for the worker of a session and drop the operations not run */
+
+static void cryptodev_flush(FAR struct csession *cse)
+{
+  FAR struct cryptodev_job *job;
+
+#ifdef CRYPTODEV_HAVE_WORKERS
+  if (g_cryptodev_wq != NULL)
+    {
+      work_cancel_sync_wq(g_cryptodev_wq, &cse->work);
+    }
+#endif
+
+  while ((job = TAILQ_FIRST(&cse->jobs)) != NULL)
+    {
+      TAILQ_REMOVE(&cse->jobs, job, next);
+      kmm_free(job);
+    }
+}
+
 static int cryptodev_key(FAR struct fcrypt *fcr, FAR struct crypt_kop *kop)
 {
   FAR struct cryptkop *krp = NULL;
@@ -806,16 +1036,19 @@ static int cryptof_poll(FAR struct file *filep,
       return -EINVAL;
     }
 
+  nxmutex_lock(&fcr->lock);
   if (setup)
     {
-      if (!TAILQ_EMPTY(&fcr->crpk_ret))
+      if (!TAILQ_EMPTY(&fcr->crpk_ret) || !TAILQ_EMPTY(&fcr->crp_ret))
         {
           poll_notify(&fds, 1, POLLIN);
+          nxmutex_unlock(&fcr->lock);
           return OK;
         }
 
       if (fcr->fds)
         {
+          nxmutex_unlock(&fcr->lock);
           return -EBUSY;
         }
 
@@ -826,6 +1059,7 @@ static int cryptof_poll(FAR struct file *filep,
       fcr->fds = NULL;
     }
 
+  nxmutex_unlock(&fcr->lock);
   return OK;
 }
 
@@ -834,6 +1068,7 @@ static int cryptof_poll(FAR struct file *filep,
 static int cryptof_close(FAR struct file *filep)
 {
   FAR struct fcrypt *fcr = filep->f_priv;
+  FAR struct cryptodev_job *job;
   FAR struct csession *cse;
   FAR struct cryptkop *krp;
   int i;
@@ -841,9 +1076,16 @@ static int cryptof_close(FAR struct file *filep)
   while ((cse = TAILQ_FIRST(&fcr->csessions)))
     {
       TAILQ_REMOVE(&fcr->csessions, cse, next);
+      cryptodev_flush(cse);
       (void)csefree(cse);
     }
 
+  while ((job = TAILQ_FIRST(&fcr->crp_ret)))
+    {
+      TAILQ_REMOVE(&fcr->crp_ret, job, next);
+      kmm_free(job);
+    }
+
   while ((krp = TAILQ_FIRST(&fcr->crpk_ret)))
     {
       TAILQ_REMOVE(&fcr->crpk_ret, krp, krp_next);
@@ -860,6 +1102,7 @@ static int cryptof_close(FAR struct file *filep)
       kmm_free(krp);
     }
 
+  nxmutex_destroy(&fcr->lock);
   kmm_free(fcr);
   filep->f_priv = NULL;
   return 0;
@@ -898,7 +1141,7 @@ static int cryptof_open(FAR struct file *filep)
       return -ENOMEM;
     }
 
-  TAILQ_INIT(&fcrd->csessions);
+  fcrinit(fcrd);
   TAILQ_FOREACH(cse, &fcr->csessions, next)
     {
       bzero(&crie, sizeof(crie));
@@ -1023,13 +1266,13 @@ static int cryptoioctl(FAR struct file *filep, int cmd, unsigned long arg)
             return -ENOMEM;
           }
 
-        TAILQ_INIT(&fcr->csessions);
-        TAILQ_INIT(&fcr->crpk_ret);
+        fcrinit(fcr);
 
         fd = file_allocate(&g_cryptoinode, 0,
                            0, fcr, 0, true);
         if (fd < 0)
           {
+            nxmutex_destroy(&fcr->lock);
             kmm_free(fcr);
             return fd;
           }
@@ -1090,9 +1333,11 @@ static FAR struct csession *csecreate(FAR struct fcrypt *fcr, uint64_t sid,
 {
   FAR struct csession *cse;
 
-  cse = kmm_malloc(sizeof(struct csession));
+  cse = kmm_zalloc(sizeof(struct csession));
   if (cse != NULL)
     {
+      cse->fcr = fcr;
+      TAILQ_INIT(&cse->jobs);
       cse->key = key;
       cse->keylen = keylen / 8;
       cse->mackey = mackey;
@@ -1128,6 +1373,14 @@ static int csefree(FAR struct csession *cse)
   return error;
 }
 
+static void fcrinit(FAR struct fcrypt *fcr)
+{
+  TAILQ_INIT(&fcr->csessions);
+  TAILQ_INIT(&fcr->crpk_ret);
+  TAILQ_INIT(&fcr->crp_ret);
+  nxmutex_init(&fcr->lock);
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -1136,6 +1389,13 @@ void devcrypto_register(void)
 {
   register_driver("/dev/crypto", &g_cryptoops, 0666, NULL);
 
+#ifdef CRYPTODEV_HAVE_WORKERS
+  g_cryptodev_wq =
+    work_queue_create("cryptodev", CONFIG_CRYPTO_CRYPTODEV_WORKER_PRIORITY,
+                      CONFIG_CRYPTO_CRYPTODEV_WORKER_STACKSIZE,
+                      CONFIG_CRYPTO_CRYPTODEV_WORKERS);
+#endif
+
 #ifdef CONFIG_CRYPTO_CRYPTODEV_SOFTWARE
   swcr_init();
 #endif
@@ -23,7 +23,8 @@
  * <https://github.com/mit-plv/fiat-crypto>. Though originally machine
  * generated, it has been tweaked to be suitable for use in the kernel.
  * It is optimized for 32-bit machines and machines that cannot work
- * efficiently with 128-bit integer types.
+ * efficiently with 128-bit integer types.  The 64-bit machines with a
+ * 128-bit product use field elements of five 51-bit limbs instead.
  ****************************************************************************/
 
 /****************************************************************************
@@ -35,10 +36,36 @@
 #include <string.h>
 #include <crypto/curve25519.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef __SIZEOF_INT128__
+#  define CURVE25519_FE51
+#endif
+
+#ifdef CURVE25519_FE51
+#  define FE51_MASK       UINT64_C(0x7ffffffffffff)
+#  define FE51_2P0        UINT64_C(0xfffffffffffda)   /* 2 * (2^51 - 19) */
+#  define FE51_2P         UINT64_C(0xffffffffffffe)   /* 2 * (2^51 - 1) */
+#endif
+
 /****************************************************************************
  * Private Type Definitions
  ****************************************************************************/
 
+#ifdef CURVE25519_FE51
+typedef unsigned __int128 uint128_t;
+
+/* fe51 means field element of 5 limbs, t[0]+2^51 t[1]+...+2^204 t[4].
+ * The limbs are reduced below 2^51 + 2^17 by the multiplications.
+ */
+
+typedef struct fe51
+{
+  uint64_t v[5];
+} fe51;
+#else
 /* fe means field element. Here the field is \Z/(2^255-19). An element t,
  * entries t[0]...t[9], represents the integer t[0]+2^26 t[1]+2^51 t[2]+2^77
  * t[3]+2^102 t[4]+...+2^230 t[9].
@@ -60,6 +87,7 @@ typedef struct fe_loose
 {
   uint32_t v[10];
 } fe_loose;
+#endif
 
 /****************************************************************************
  * Private Data
@@ -75,6 +103,345 @@ static const uint8_t g_base_point[CURVE25519_KEY_SIZE] =
  * Private Functions
  ****************************************************************************/
 
+#ifdef CURVE25519_FE51
+static uint64_t fe51_load64(FAR const uint8_t *a)
+{
+  uint64_t l;
+
+  memcpy(&l, a, sizeof(l));
+  return letoh64(l);
+}
+
+static void fe51_frombytes(FAR fe51 *h, FAR const uint8_t *s)
+{
+  /* Ignores top bit of s. */
+
+  h->v[0] = fe51_load64(s) & FE51_MASK;
+  h->v[1] = (fe51_load64(s + 6) >> 3) & FE51_MASK;
+  h->v[2] = (fe51_load64(s + 12) >> 6) & FE51_MASK;
+  h->v[3] = (fe51_load64(s + 19) >> 1) & FE51_MASK;
+  h->v[4] = (fe51_load64(s + 24) >> 12) & FE51_MASK;
+}
+
+/* Reduce the limbs of a product below 2^51, with 2^255 = 19 */
+
+static void fe51_carry(FAR fe51 *h, FAR const uint128_t r[5])
+{
+  uint128_t t = r[0];
+  uint128_t c;
+  int i;
+
+  for (i = 0; i < 4; i++)
+    {
+      h->v[i] = (uint64_t)t & FE51_MASK;
+      t = r[i + 1] + (t >> 51);
+    }
+
+  h->v[4] = (uint64_t)t & FE51_MASK;
+  c = (t >> 51) * 19 + h->v[0];
+  h->v[0] = (uint64_t)c & FE51_MASK;
+  h->v[1] += (uint64_t)(c >> 51);
+}
+
+static void fe51_tobytes(uint8_t s[32], FAR const fe51 *f)
+{
+  uint64_t h[5];
+  uint64_t q;
+  int i;
+
+  memcpy(h, f->v, sizeof(h));
+
+  /* Two passes bring the limbs within 2^51, the value within 2^255 + 19 */
+
+  for (i = 0; i < 2; i++)
+    {
+      h[1] += h[0] >> 51;
+      h[0] &= FE51_MASK;
+      h[2] += h[1] >> 51;
+      h[1] &= FE51_MASK;
+      h[3] += h[2] >> 51;
+      h[2] &= FE51_MASK;
+      h[4] += h[3] >> 51;
+      h[3] &= FE51_MASK;
+      h[0] += (h[4] >> 51) * 19;
+      h[4] &= FE51_MASK;
+    }
+
+  /* Subtract p if h >= p, that is if h + 19 carries out of 2^255 */
+
+  q = (h[0] + 19) >> 51;
+  q = (h[1] + q) >> 51;
+  q = (h[2] + q) >> 51;
+  q = (h[3] + q) >> 51;
+  q = (h[4] + q) >> 51;
+
+  h[0] += 19 * q;
+  h[1] += h[0] >> 51;
+  h[0] &= FE51_MASK;
+  h[2] += h[1] >> 51;
+  h[1] &= FE51_MASK;
+  h[3] += h[2] >> 51;
+  h[2] &= FE51_MASK;
+  h[4] += h[3] >> 51;
+  h[3] &= FE51_MASK;
+  h[4] &= FE51_MASK;
+
+  h[0] = htole64(h[0] | (h[1] << 51));
+  h[1] = htole64((h[1] >> 13) | (h[2] << 38));
+  h[2] = htole64((h[2] >> 26) | (h[3] << 25));
+  h[3] = htole64((h[3] >> 39) | (h[4] << 12));
+  memcpy(s, h, 32);
+}
+
+/* h = f + g, the limbs of f and g are below 2^52 */
+
+static void fe51_add(FAR fe51 *h, FAR const fe51 *f, FAR const fe51 *g)
+{
+  int i;
+
+  for (i = 0; i < 5; i++)
+    {
+      h->v[i] = f->v[i] + g->v[i];
+    }
+}
+
+/* h = f - g + 2p, the limbs of g are below 2^52 */
+
+static void fe51_sub(FAR fe51 *h, FAR const fe51 *f, FAR const fe51 *g)
+{
+  h->v[0] = f->v[0] + FE51_2P0 - g->v[0];
+  h->v[1] = f->v[1] + FE51_2P - g->v[1];
+  h->v[2] = f->v[2] + FE51_2P - g->v[2];
+  h->v[3] = f->v[3] + FE51_2P - g->v[3];
+  h->v[4] = f->v[4] + FE51_2P - g->v[4];
+}
+
+/* h = f * g, the limbs of f and g are below 2^54 */
+
+static void fe51_mul(FAR fe51 *h, FAR const fe51 *f, FAR const fe51 *g)
+{
+  uint64_t f0 = f->v[0];
+  uint64_t f1 = f->v[1];
+  uint64_t f2 = f->v[2];
+  uint64_t f3 = f->v[3];
+  uint64_t f4 = f->v[4];
+  uint64_t g0 = g->v[0];
+  uint64_t g1 = g->v[1];
+  uint64_t g2 = g->v[2];
+  uint64_t g3 = g->v[3];
+  uint64_t g4 = g->v[4];
+  uint64_t g1_19 = g1 * 19;
+  uint64_t g2_19 = g2 * 19;
+  uint64_t g3_19 = g3 * 19;
+  uint64_t g4_19 = g4 * 19;
+  uint128_t r[5];
+
+  r[0] = (uint128_t)f0 * g0 + (uint128_t)f1 * g4_19 +
+         (uint128_t)f2 * g3_19 + (uint128_t)f3 * g2_19 +
+         (uint128_t)f4 * g1_19;
+  r[1] = (uint128_t)f0 * g1 + (uint128_t)f1 * g0 +
+         (uint128_t)f2 * g4_19 + (uint128_t)f3 * g3_19 +
+         (uint128_t)f4 * g2_19;
+  r[2] = (uint128_t)f0 * g2 + (uint128_t)f1 * g1 +
+         (uint128_t)f2 * g0 + (uint128_t)f3 * g4_19 +
+         (uint128_t)f4 * g3_19;
+  r[3] = (uint128_t)f0 * g3 + (uint128_t)f1 * g2 +
+         (uint128_t)f2 * g1 + (uint128_t)f3 * g0 +
+         (uint128_t)f4 * g4_19;
+  r[4] = (uint128_t)f0 * g4 + (uint128_t)f1 * g3 +
+         (uint128_t)f2 * g2 + (uint128_t)f3 * g1 +
+         (uint128_t)f4 * g0;
+
+  fe51_carry(h, r);
+}
+
+/* h = f * f, the limbs of f are below 2^54 */
+
+static void fe51_sq(FAR fe51 *h, FAR const fe51 *f)
+{
+  uint64_t f0 = f->v[0];
+  uint64_t f1 = f->v[1];
+  uint64_t f2 = f->v[2];
+  uint64_t f3 = f->v[3];
+  uint64_t f4 = f->v[4];
+  uint64_t f0_2 = f0 * 2;
+  uint64_t f1_2 = f1 * 2;
+  uint64_t f1_38 = f1 * 38;
+  uint64_t f2_38 = f2 * 38;
+  uint64_t f3_19 = f3 * 19;
+  uint64_t f3_38 = f3 * 38;
+  uint64_t f4_19 = f4 * 19;
+  uint128_t r[5];
+
+  r[0] = (uint128_t)f0 * f0 + (uint128_t)f1_38 * f4 +
+         (uint128_t)f2_38 * f3;
+  r[1] = (uint128_t)f0_2 * f1 + (uint128_t)f2_38 * f4 +
+         (uint128_t)f3_19 * f3;
+  r[2] = (uint128_t)f0_2 * f2 + (uint128_t)f1 * f1 +
+         (uint128_t)f3_38 * f4;
+  r[3] = (uint128_t)f0_2 * f3 + (uint128_t)f1_2 * f2 +
+         (uint128_t)f4_19 * f4;
+  r[4] = (uint128_t)f0_2 * f4 + (uint128_t)f1_2 * f3 +
+         (uint128_t)f2 * f2;
+
+  fe51_carry(h, r);
+}
+
+/* h = f * 121666 */
+
+static void fe51_mul121666(FAR fe51 *h, FAR const fe51 *f)
+{
+  uint128_t r[5];
+  int i;
+
+  for (i = 0; i < 5; i++)
+    {
+      r[i] = (uint128_t)f->v[i] * 121666;
+    }
+
+  fe51_carry(h, r);
+}
+
+/* h = f^(2^n) */
+
+static void fe51_sq_n(FAR fe51 *h, FAR const fe51 *f, int n)
+{
+  fe51_sq(h, f);
+  while (--n > 0)
+    {
+      fe51_sq(h, h);
+    }
+}
+
+/* h = z^(p - 2) = 1 / z */
+
+static void fe51_invert(FAR fe51 *out, FAR const fe51 *z)
+{
+  fe51 t0;
+  fe51 t1;
+  fe51 t2;
+  fe51 t3;
+
+  fe51_sq(&t0, z);
+  fe51_sq_n(&t1, &t0, 2);
+  fe51_mul(&t1, z, &t1);
+  fe51_mul(&t0, &t0, &t1);
+  fe51_sq(&t2, &t0);
+  fe51_mul(&t1, &t1, &t2);
+  fe51_sq_n(&t2, &t1, 5);
+  fe51_mul(&t1, &t2, &t1);
+  fe51_sq_n(&t2, &t1, 10);
+  fe51_mul(&t2, &t2, &t1);
+  fe51_sq_n(&t3, &t2, 20);
+  fe51_mul(&t2, &t3, &t2);
+  fe51_sq_n(&t2, &t2, 10);
+  fe51_mul(&t1, &t2, &t1);
+  fe51_sq_n(&t2, &t1, 50);
+  fe51_mul(&t2, &t2, &t1);
+  fe51_sq_n(&t3, &t2, 100);
+  fe51_mul(&t2, &t3, &t2);
+  fe51_sq_n(&t2, &t2, 50);
+  fe51_mul(&t1, &t2, &t1);
+  fe51_sq_n(&t1, &t1, 5);
+  fe51_mul(out, &t1, &t0);
+}
+
+/* Swap f and g if b == 1, in constant time */
+
+static void fe51_cswap(FAR fe51 *f, FAR fe51 *g, unsigned int b)
+{
+  uint64_t mask = 0 - (uint64_t)b;
+  uint64_t x;
+  int i;
+
+  for (i = 0; i < 5; i++)
+    {
+      x        = (f->v[i] ^ g->v[i]) & mask;
+      f->v[i] ^= x;
+      g->v[i] ^= x;
+    }
+}
+
+/* The Montgomery ladder of RFC 7748.  The sums and the differences are
+ * only taken of reduced elements, so their limbs stay below 2^53.
+ */
+
+static void curve25519_ladder(uint8_t out[CURVE25519_KEY_SIZE],
+                              const uint8_t e[CURVE25519_KEY_SIZE],
+                              const uint8_t point[CURVE25519_KEY_SIZE])
+{
+  fe51     x1;
+  fe51     x2;
+  fe51     z2;
+  fe51     x3;
+  fe51     z3;
+  fe51     a;
+  fe51     b;
+  fe51     c;
+  fe51     d;
+  fe51     aa;
+  fe51     bb;
+  unsigned swap = 0;
+  unsigned bit;
+  int      pos;
+
+  fe51_frombytes(&x1, point);
+  memset(&x2, 0, sizeof(x2));
+  memset(&z2, 0, sizeof(z2));
+  x2.v[0] = 1;
+  x3 = x1;
+  memset(&z3, 0, sizeof(z3));
+  z3.v[0] = 1;
+
+  for (pos = 254; pos >= 0; --pos)
+    {
+      bit = 1 & (e[pos / 8] >> (pos & 7));
+      swap ^= bit;
+      fe51_cswap(&x2, &x3, swap);
+      fe51_cswap(&z2, &z3, swap);
+      swap = bit;
+
+      fe51_add(&a, &x2, &z2);           /* A = x2 + z2 */
+      fe51_sub(&b, &x2, &z2);           /* B = x2 - z2 */
+      fe51_add(&c, &x3, &z3);           /* C = x3 + z3 */
+      fe51_sub(&d, &x3, &z3);           /* D = x3 - z3 */
+      fe51_sq(&aa, &a);                 /* AA = A^2 */
+      fe51_sq(&bb, &b);                 /* BB = B^2 */
+      fe51_mul(&d, &d, &a);             /* DA = D * A */
+      fe51_mul(&c, &c, &b);             /* CB = C * B */
+      fe51_add(&a, &d, &c);
+      fe51_sq(&x3, &a);                 /* x3 = (DA + CB)^2 */
+      fe51_sub(&b, &d, &c);
+      fe51_sq(&b, &b);
+      fe51_mul(&z3, &x1, &b);           /* z3 = x1 * (DA - CB)^2 */
+      fe51_mul(&x2, &aa, &bb);          /* x2 = AA * BB */
+      fe51_sub(&c, &aa, &bb);           /* E = AA - BB */
+      fe51_mul121666(&d, &c);
+      fe51_add(&a, &bb, &d);
+      fe51_mul(&z2, &c, &a);            /* z2 = E * (BB + 121666 * E) */
+    }
+
+  fe51_cswap(&x2, &x3, swap);
+  fe51_cswap(&z2, &z3, swap);
+
+  fe51_invert(&z2, &z2);
+  fe51_mul(&x2, &x2, &z2);
+  fe51_tobytes(out, &x2);
+
+  explicit_bzero(&x1, sizeof(x1));
+  explicit_bzero(&x2, sizeof(x2));
+  explicit_bzero(&z2, sizeof(z2));
+  explicit_bzero(&x3, sizeof(x3));
+  explicit_bzero(&z3, sizeof(z3));
+  explicit_bzero(&a, sizeof(a));
+  explicit_bzero(&b, sizeof(b));
+  explicit_bzero(&c, sizeof(c));
+  explicit_bzero(&d, sizeof(d));
+  explicit_bzero(&aa, sizeof(aa));
+  explicit_bzero(&bb, sizeof(bb));
+}
+
+#else
 static uint32_t get_unaligned_le32(FAR const uint8_t *a)
 {
   uint32_t l;
@@ -1063,22 +1430,14 @@ static void fe_mul121666(FAR fe *h, FAR const fe_loose *f)
   fe_mul_121666_impl(h->v, f->v);
 }
 
-/****************************************************************************
- * Public Functions
- ****************************************************************************/
-
-int curve25519(uint8_t out[CURVE25519_KEY_SIZE],
-               const uint8_t scalar[CURVE25519_KEY_SIZE],
-               const uint8_t point[CURVE25519_KEY_SIZE])
+static void curve25519_ladder(uint8_t out[CURVE25519_KEY_SIZE],
+                              const uint8_t e[CURVE25519_KEY_SIZE],
+                              const uint8_t point[CURVE25519_KEY_SIZE])
 {
   fe        x1, x2, z2, x3, z3;
   fe_loose  x2l, z2l, x3l;
   unsigned  swap = 0;
   int       pos;
-  uint8_t   e[32];
-
-  memcpy(e, scalar, 32);
-  curve25519_clamp_secret(e);
 
   /* The following implementation was transcribed to Coq and proven to
    * correspond to unary scalar multiplication in affine coordinates given
@@ -1200,6 +1559,23 @@ int curve25519(uint8_t out[CURVE25519_KEY_SIZE],
   explicit_bzero(&x2l, sizeof(x2l));
   explicit_bzero(&z2l, sizeof(z2l));
   explicit_bzero(&x3l, sizeof(x3l));
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int curve25519(uint8_t out[CURVE25519_KEY_SIZE],
+               const uint8_t scalar[CURVE25519_KEY_SIZE],
+               const uint8_t point[CURVE25519_KEY_SIZE])
+{
+  uint8_t e[32];
+
+  memcpy(e, scalar, 32);
+  curve25519_clamp_secret(e);
+  curve25519_ladder(out, e, point);
+
   explicit_bzero(&e, sizeof(e));
   return timingsafe_bcmp(out, g_null_point, CURVE25519_KEY_SIZE);
 }
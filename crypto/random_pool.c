@@ -35,9 +35,16 @@
 #include <nuttx/random.h>
 #include <nuttx/board.h>
 #include <nuttx/clock.h>
+#include <nuttx/irq.h>
 #include <nuttx/mutex.h>
+#include <nuttx/sched.h>
 #include <nuttx/crypto/blake2s.h>
 
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_PERCPU
+#  define KEYSTREAM_ONLY
+#  include "chacha_private.h"
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -45,6 +52,15 @@
 #define ROTL_32(x,n) (((x) << (n)) | ((x) >> (32 - (n))))
 #define ROTR_32(x,n) (((x) >> (n)) | ((x) << (32 - (n))))
 
+/* The per-CPU generators are the ChaCha20 ones of OpenBSD arc4random(),
+ * with a smaller keystream buffer.
+ */
+
+#define RNG_KEYSZ     32
+#define RNG_IVSZ      8
+#define RNG_SEEDSZ    (RNG_KEYSZ + RNG_IVSZ)
+#define RNG_BUFSZ     (8 * 64)
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -69,10 +85,23 @@ struct rng_s
   volatile uint8_t rd_rotate;
   volatile uint8_t rd_prev_time;
   volatile uint16_t rd_prev_irq;
+  volatile uint32_t rd_generation; /* Incremented by every reseed */
   bool output_initialized;
   struct blake2xs_rng_s blake2xs;
 };
 
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_PERCPU
+struct rng_percpu_s
+{
+  chacha_ctx ctx;
+  uint8_t buf[RNG_BUFSZ];   /* Keystream, the last 'have' bytes unused */
+  size_t have;
+  size_t count;             /* Bytes left before the rekey from the pool */
+  uint32_t generation;      /* rd_generation of the pool when keyed */
+  bool seeded;
+};
+#endif
+
 enum
 {
   POOL_SIZE = ENTROPY_POOL_SIZE,
@@ -102,6 +131,10 @@ static struct rng_s g_rng =
 static struct entropy_pool_s entropy_pool;
 #endif
 
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_PERCPU
+static struct rng_percpu_s g_rng_percpu[CONFIG_SMP_NCPUS];
+#endif
+
 /* Polynomial from paper "The Linux Pseudorandom Number Generator Revisited"
  * x^POOL_SIZE + x^104 + x^76 + x^51 + x^25 + x + 1
  */
@@ -295,6 +328,12 @@ static void rng_reseed(void)
 
   explicit_bzero(&g_rng.blake2xs.ctx, sizeof(g_rng.blake2xs.ctx));
 
+  /* The per-CPU generators are rekeyed from the new root on their next
+   * use.
+   */
+
+  g_rng.rd_generation++;
+
   /* Setup parameters for output phase. */
 
   g_rng.blake2xs.param.key_length = 0;
@@ -357,6 +396,115 @@ static void rng_buf_internal(FAR uint8_t *bytes, size_t nbytes)
     }
 }
 
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_PERCPU
+
+/****************************************************************************
+ * Name: rng_percpu_rekey
+ *
+ * Description:
+ *   Refill the keystream buffer and take the new key from its head, so
+ *   that the keystream already handed out can't be recomputed from the
+ *   state later (fast key erasure).  The seed, if any, is mixed into the
+ *   new key.
+ *
+ ****************************************************************************/
+
+static void rng_percpu_rekey(FAR struct rng_percpu_s *rs,
+                             FAR const uint8_t *seed)
+{
+  int i;
+
+  chacha_encrypt_bytes(&rs->ctx, rs->buf, rs->buf, sizeof(rs->buf));
+  if (seed != NULL)
+    {
+      for (i = 0; i < RNG_SEEDSZ; i++)
+        {
+          rs->buf[i] ^= seed[i];
+        }
+    }
+
+  chacha_keysetup(&rs->ctx, rs->buf, RNG_KEYSZ * 8);
+  chacha_ivsetup(&rs->ctx, rs->buf + RNG_KEYSZ, NULL);
+  memset(rs->buf, 0, RNG_SEEDSZ);
+  rs->have = sizeof(rs->buf) - RNG_SEEDSZ;
+}
+
+/****************************************************************************
+ * Name: rng_percpu_buf
+ *
+ * Description:
+ *   Fill the buffer from the generator of this CPU.  The interrupts of
+ *   this CPU are disabled meanwhile, which keeps the thread on it, so the
+ *   pool lock is only taken to rekey the generator.
+ *
+ ****************************************************************************/
+
+static void rng_percpu_buf(FAR uint8_t *bytes, size_t nbytes)
+{
+  FAR struct rng_percpu_s *rs;
+  uint8_t seed[RNG_SEEDSZ];
+  uint32_t generation;
+  irqstate_t flags;
+  size_t len;
+
+  flags = up_irq_save();
+  rs = &g_rng_percpu[this_cpu()];
+
+  while (!rs->seeded || rs->count <= nbytes ||
+         rs->generation != g_rng.rd_generation)
+    {
+      up_irq_restore(flags);
+
+      nxmutex_lock(&g_rng.rd_lock);
+      rng_buf_internal(seed, sizeof(seed));
+      generation = g_rng.rd_generation;
+      nxmutex_unlock(&g_rng.rd_lock);
+
+      /* The thread may have moved to another CPU meanwhile, whose
+       * generator takes the seed.
+       */
+
+      flags = up_irq_save();
+      rs = &g_rng_percpu[this_cpu()];
+      if (!rs->seeded)
+        {
+          chacha_keysetup(&rs->ctx, seed, RNG_KEYSZ * 8);
+          chacha_ivsetup(&rs->ctx, seed + RNG_KEYSZ, NULL);
+          rs->seeded = true;
+        }
+      else
+        {
+          rng_percpu_rekey(rs, seed);
+        }
+
+      explicit_bzero(seed, sizeof(seed));
+      memset(rs->buf, 0, sizeof(rs->buf));
+      rs->have       = 0;
+      rs->count      = CONFIG_CRYPTO_RANDOM_POOL_PERCPU_RESEED;
+      rs->generation = generation;
+    }
+
+  rs->count -= nbytes;
+  while (nbytes > 0)
+    {
+      if (rs->have == 0)
+        {
+          rng_percpu_rekey(rs, NULL);
+        }
+
+      len = MIN(nbytes, rs->have);
+      memcpy(bytes, rs->buf + sizeof(rs->buf) - rs->have, len);
+      memset(rs->buf + sizeof(rs->buf) - rs->have, 0, len);
+      bytes    += len;
+      nbytes   -= len;
+      rs->have -= len;
+    }
+
+  up_irq_restore(flags);
+}
+
+#endif /* CONFIG_CRYPTO_RANDOM_POOL_PERCPU */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -529,6 +677,18 @@ void up_randompool_initialize(void)
 
 void arc4random_buf(FAR void *bytes, size_t nbytes)
 {
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_PERCPU
+  /* The small requests, like the TCP sequence numbers and the ports, are
+   * served by the generator of this CPU without the pool lock.
+   */
+
+  if (nbytes <= CONFIG_CRYPTO_RANDOM_POOL_PERCPU_MAXREQ)
+    {
+      rng_percpu_buf(bytes, nbytes);
+      return;
+    }
+#endif
+
   nxmutex_lock(&g_rng.rd_lock);
   rng_buf_internal(bytes, nbytes);
   nxmutex_unlock(&g_rng.rd_lock);
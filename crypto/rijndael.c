@@ -35,6 +35,8 @@
 
 #include <crypto/rijndael.h>
 
+#include "cpu_accel.h"
+
 #undef FULL_UNROLL
 
 /* TE0[x] = S [x].[02, 01, 01, 03];
@@ -638,6 +640,28 @@ static const uint32_t rcon[] =
                           (ct)[2] = (uint8_t)((st) >>  8);\
                           (ct)[3] = (uint8_t)(st); }
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_CRYPTO_CPU_ACCEL
+/* The crypto instructions take each round key as its 16 bytes, store the
+ * words of the schedule in the byte order once for all.
+ */
+
+static void rijndael_accel_schedule(FAR uint32_t *rk, int nr)
+{
+  uint32_t word;
+  int i;
+
+  for (i = 0; i < 4 * (nr + 1); i++)
+    {
+      word = rk[i];
+      PUTU32((FAR uint8_t *)&rk[i], word);
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -1373,6 +1397,13 @@ int rijndael_set_key_enc_only(FAR rijndael_ctx *ctx,
   ctx->nr = rounds;
   ctx->enc_only = 1;
 
+#ifdef CONFIG_CRYPTO_CPU_ACCEL
+  if (crypto_accel()->aes_encrypt != NULL)
+    {
+      rijndael_accel_schedule(ctx->ek, rounds);
+    }
+#endif
+
   return 0;
 }
 
@@ -1396,6 +1427,14 @@ int rijndael_set_key(FAR rijndael_ctx *ctx, FAR const u_char *key, int bits)
   ctx->nr = rounds;
   ctx->enc_only = 0;
 
+#ifdef CONFIG_CRYPTO_CPU_ACCEL
+  if (crypto_accel()->aes_encrypt != NULL)
+    {
+      rijndael_accel_schedule(ctx->ek, rounds);
+      rijndael_accel_schedule(ctx->dk, rounds);
+    }
+#endif
+
   return 0;
 }
 
@@ -1403,6 +1442,16 @@ void rijndael_decrypt(FAR rijndael_ctx *ctx,
                       FAR const u_char *src,
                       FAR u_char *dst)
 {
+#ifdef CONFIG_CRYPTO_CPU_ACCEL
+  FAR const struct crypto_accel_s *accel = crypto_accel();
+
+  if (accel->aes_decrypt != NULL)
+    {
+      accel->aes_decrypt((FAR const uint8_t *)ctx->dk, ctx->nr, src, dst);
+      return;
+    }
+#endif
+
   rijndaeldecrypt(ctx->dk, ctx->nr, src, dst);
 }
 
@@ -1410,5 +1459,15 @@ void rijndael_encrypt(FAR rijndael_ctx *ctx,
                       FAR const u_char *src,
                       FAR u_char *dst)
 {
+#ifdef CONFIG_CRYPTO_CPU_ACCEL
+  FAR const struct crypto_accel_s *accel = crypto_accel();
+
+  if (accel->aes_encrypt != NULL)
+    {
+      accel->aes_encrypt((FAR const uint8_t *)ctx->ek, ctx->nr, src, dst);
+      return;
+    }
+#endif
+
   rijndaelencrypt(ctx->ek, ctx->nr, src, dst);
 }
@@ -43,6 +43,8 @@
 #include <sys/time.h>
 #include <crypto/sha2.h>
 
+#include "cpu_accel.h"
+
 /* UNROLLED TRANSFORM LOOP NOTE:
  * You can define SHA2_UNROLL_TRANSFORM to use the unrolled transform
  * loop version for the hash transform rounds (defined using macros
@@ -348,7 +350,8 @@ void sha256init(FAR SHA2_CTX *context)
     }                                                              \
 while(0)
 
-void sha256transform(FAR uint32_t *state, FAR const uint8_t *data)
+static void sha256transform_c(FAR uint32_t *state,
+                              FAR const uint8_t *data)
 {
   uint32_t a;
   uint32_t b;
@@ -424,7 +427,8 @@ void sha256transform(FAR uint32_t *state, FAR const uint8_t *data)
 
 #else /* SHA2_UNROLL_TRANSFORM */
 
-void sha256transform(FAR uint32_t *state, FAR const uint8_t *data)
+static void sha256transform_c(FAR uint32_t *state,
+                              FAR const uint8_t *data)
 {
   uint32_t a;
   uint32_t b;
@@ -521,12 +525,40 @@ void sha256transform(FAR uint32_t *state, FAR const uint8_t *data)
 
 #endif /* SHA2_UNROLL_TRANSFORM */
 
+/* Hash whole blocks, with the crypto instructions if the CPU has them */
+
+static void sha256blocks(FAR uint32_t *state, FAR const uint8_t *data,
+                         size_t nblocks)
+{
+#ifdef CONFIG_CRYPTO_CPU_ACCEL
+  FAR const struct crypto_accel_s *accel = crypto_accel();
+
+  if (accel->sha256 != NULL)
+    {
+      accel->sha256(state, data, nblocks);
+      return;
+    }
+#endif
+
+  while (nblocks-- > 0)
+    {
+      sha256transform_c(state, data);
+      data += SHA256_BLOCK_LENGTH;
+    }
+}
+
+void sha256transform(FAR uint32_t *state, FAR const uint8_t *data)
+{
+  sha256blocks(state, data, 1);
+}
+
 void sha256update(FAR SHA2_CTX *context,
                   FAR const void *dataptr,
                   size_t len)
 {
   FAR const uint8_t *data = dataptr;
   size_t freespace;
+  size_t nblocks;
   size_t usedspace;
 
   /* Calling with no data is valid (we do nothing) */
@@ -567,14 +599,15 @@ void sha256update(FAR SHA2_CTX *context,
         }
     }
 
-  while (len >= SHA256_BLOCK_LENGTH)
+  if (len >= SHA256_BLOCK_LENGTH)
     {
       /* Process as many complete blocks as we can */
 
-      sha256transform(context->state.st32, data);
-      context->bitcount[0] += SHA256_BLOCK_LENGTH << 3;
-      len -= SHA256_BLOCK_LENGTH;
-      data += SHA256_BLOCK_LENGTH;
+      nblocks = len / SHA256_BLOCK_LENGTH;
+      sha256blocks(context->state.st32, data, nblocks);
+      context->bitcount[0] += (uint64_t)nblocks * SHA256_BLOCK_LENGTH << 3;
+      len -= nblocks * SHA256_BLOCK_LENGTH;
+      data += nblocks * SHA256_BLOCK_LENGTH;
     }
 
   if (len > 0)
@@ -33,10 +33,14 @@
 
 #include <sys/param.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/crypto/crypto.h>
 
+#include <crypto/bn.h>
+#include <crypto/curve25519.h>
+
 #ifdef CONFIG_CRYPTO_ALGTEST
 
 #include "testmngr.h"
@@ -106,6 +110,65 @@ static int test_aes(void)
 }
 #endif
 
+/* The Mersenne number 2^bits - 1 is a prime, so 3^(n - 1) mod n is 1.
+ * The time taken is that of a private exponent of the size of n.
+ */
+
+static int test_modexp(int bits)
+{
+  struct bn a;
+  struct bn e;
+  struct bn n;
+  struct bn r;
+  clock_t start;
+  int i;
+
+  bignum_init(&n);
+  for (i = 0; i < bits; i++)
+    {
+      n.array[i / 8] |= 1 << (i % 8);
+    }
+
+  bignum_assign(&e, &n);
+  e.array[0] &= ~1;
+  bignum_from_int(&a, 3);
+
+  start = clock_systime_ticks();
+  pow_mod_faster(&a, &e, &n, &r);
+  cryptinfo("modexp %d bits: %lu ms\n", bits,
+            (unsigned long)TICK2MSEC(clock_systime_ticks() - start));
+
+  bignum_from_int(&a, 1);
+  if (bignum_cmp(&r, &a) != EQUAL)
+    {
+      crypterr("ERROR: Failed modexp %d bits test\n", bits);
+      return -1;
+    }
+
+  return OK;
+}
+
+#ifdef CONFIG_CRYPTO_RANDOM_POOL
+static int test_x25519(void)
+{
+  uint8_t out[CURVE25519_KEY_SIZE];
+  clock_t start;
+
+  start = clock_systime_ticks();
+  curve25519(out, x25519_scalar, x25519_point);
+  cryptinfo("x25519: %lu ms\n",
+            (unsigned long)TICK2MSEC(clock_systime_ticks() - start));
+
+  if (memcmp(out, x25519_result, CURVE25519_KEY_SIZE) != 0)
+    {
+      crypterr("ERROR: Failed x25519 test\n");
+      return -1;
+    }
+
+  return OK;
+}
+#endif
+
 int crypto_test(void)
 {
 #if defined(CONFIG_CRYPTO_AES)
@@ -115,6 +178,18 @@ int crypto_test(void)
     }
 #endif
 
+  if (test_modexp(521) || test_modexp(1279))
+    {
+      return -1;
+    }
+
+#ifdef CONFIG_CRYPTO_RANDOM_POOL
+  if (test_x25519())
+    {
+      return -1;
+    }
+#endif
+
   return OK;
 }
 
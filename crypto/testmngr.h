@@ -510,4 +510,22 @@ static struct cipher_testvec aes_ctr_dec_tv_template[] =
 };
 
 #endif /* CONFIG_CRYPTO_AES */
+
+#ifdef CONFIG_CRYPTO_RANDOM_POOL
+
+/* The first X25519 test vector of RFC 7748 section 5.2 */
+
+static const uint8_t x25519_scalar[] =
+  "\xa5\x46\xe3\x6b\xf0\x52\x7c\x9d\x3b\x16\x15\x4b\x82\x46\x5e\xdd"
+  "\x62\x14\x4c\x0a\xc1\xfc\x5a\x18\x50\x6a\x22\x44\xba\x44\x9a\xc4";
+
+static const uint8_t x25519_point[] =
+  "\xe6\xdb\x68\x67\x58\x30\x30\xdb\x35\x94\xc1\xa4\x24\xb1\x5f\x7c"
+  "\x72\x66\x24\xec\x26\xb3\x35\x3b\x10\xa9\x03\xa6\xd0\xab\x1c\x4c";
+
+static const uint8_t x25519_result[] =
+  "\xc3\xda\x55\x37\x9d\xe9\xc6\x90\x8e\x94\xea\x4d\xf2\x8d\x08\x4f"
+  "\x32\xec\xcf\x03\x49\x1c\x71\xf7\x54\xb4\x07\x55\x77\xa2\x85\x52";
+
+#endif /* CONFIG_CRYPTO_RANDOM_POOL */
 #endif /* __CRYPTO_TESTMNGR_H */
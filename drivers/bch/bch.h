@@ -40,22 +40,38 @@
 
 #define MAX_OPENCNT       (255)                  /* Limit of uint8_t */
 
+/* The number of sectors in the cache, and the buffer of one of them */
+
+#define BCH_NSLOTS        CONFIG_BCH_CACHE_SECTORS
+#define BCH_SLOTBUFFER(bch, i) \
+  (&(bch)->buffer[(size_t)(i) * (bch)->sectsize])
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
+/* One sector of the cache */
+
+struct bch_slot_s
+{
+  size_t sector;           /* The sector in the slot, -1 if none */
+  uint32_t age;            /* Time of the last access, for the LRU */
+  bool dirty;              /* true: Data has been written to the slot */
+};
+
 struct bchlib_s
 {
   FAR struct inode *inode; /* I-node of the block driver */
   uint32_t sectsize;       /* The size of one sector on the device */
   size_t nsectors;         /* Number of sectors supported by the device */
-  size_t sector;           /* The current sector in the buffer */
+  size_t nextsector;       /* The sector that continues the last access */
+  uint32_t age;            /* Clock of the LRU replacement */
   mutex_t lock;            /* For atomic accesses to this structure */
   uint8_t refs;            /* Number of references */
-  bool dirty;              /* true: Data has been written to the buffer */
   bool readonly;           /* true: Only read operations are supported */
   bool unlinked;           /* true: The driver has been unlinked */
-  FAR uint8_t *buffer;     /* One sector buffer */
+  FAR uint8_t *buffer;     /* The sectors of the cache, BCH_NSLOTS */
+  struct bch_slot_s slot[BCH_NSLOTS];
 
 #if defined(CONFIG_BCH_ENCRYPTION)
   uint8_t key[CONFIG_BCH_ENCRYPTION_KEY_SIZE];  /* Encryption key */
@@ -81,8 +97,11 @@ EXTERN const struct file_operations g_bch_fops;
  * Public Function Prototypes
  ****************************************************************************/
 
+EXTERN int  bchlib_flushrange(FAR struct bchlib_s *bch, size_t sector,
+                              size_t nsectors, bool discard);
 EXTERN int  bchlib_flushsector(FAR struct bchlib_s *bch, bool discard);
-EXTERN int  bchlib_readsector(FAR struct bchlib_s *bch, size_t sector);
+EXTERN int  bchlib_readsector(FAR struct bchlib_s *bch, size_t sector,
+                              bool whole);
 
 #undef EXTERN
 #if defined(__cplusplus)
@@ -25,8 +25,10 @@
 #include <nuttx/config.h>
 #include <nuttx/kmalloc.h>
 
+#include <sys/param.h>
 #include <sys/types.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
@@ -60,10 +62,10 @@ static void bch_xor(uint32_t *R, uint32_t *A, uint32_t *B)
  ****************************************************************************/
 
 #if defined(CONFIG_BCH_ENCRYPTION)
-static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
+static int bch_cypher(FAR struct bchlib_s *bch, int slot, int encrypt)
 {
   int blocks = bch->sectsize / 16;
-  FAR uint32_t *buffer = (FAR uint32_t *)bch->buffer;
+  FAR uint32_t *buffer = (FAR uint32_t *)BCH_SLOTBUFFER(bch, slot);
   int i;
 
   for (i = 0; i < blocks; i++, buffer += 16 / sizeof(uint32_t) )
@@ -71,7 +73,7 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
       uint32_t T[4];
       uint32_t X[4] =
       {
-        bch->sector, 0, 0, i
+        bch->slot[slot].sector, 0, 0, i
       };
 
       aes_cypher(X, X, 16, NULL, bch->key, CONFIG_BCH_ENCRYPTION_KEY_SIZE,
@@ -90,91 +92,200 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
 #endif
 
 /****************************************************************************
- * Public Functions
+ * Name: bch_inrange
  ****************************************************************************/
 
+static bool bch_inrange(FAR const struct bch_slot_s *slot, size_t sector,
+                        size_t nsectors)
+{
+  return slot->sector != (size_t)-1 && slot->sector >= sector &&
+         slot->sector - sector < nsectors;
+}
+
 /****************************************************************************
- * Name: bchlib_flushsector
+ * Name: bch_writeslots
  *
  * Description:
- *   Flush the current contents of the sector buffer (if dirty)
- *
- * Assumptions:
- *   Caller must assume mutual exclusion
+ *   Write count slots, that hold sectors following each other, to the
+ *   media with one transfer.
  *
  ****************************************************************************/
 
-int bchlib_flushsector(FAR struct bchlib_s *bch, bool discard)
+static int bch_writeslots(FAR struct bchlib_s *bch, int first, int count)
 {
-  FAR struct inode *inode;
-  ssize_t ret = OK;
+  FAR struct inode *inode = bch->inode;
+  ssize_t ret;
+  int i;
 
-  /* Check if the sector has been modified and is out of synch with the
-   * media.
-   */
+#if defined(CONFIG_BCH_ENCRYPTION)
+  /* Encrypt data as necessary */
 
-  if (bch->dirty && bch->buffer != NULL)
+  for (i = first; i < first + count; i++)
     {
-      inode = bch->inode;
+      bch_cypher(bch, i, CYPHER_ENCRYPT);
+    }
+#endif
+
+  /* Write the sectors to the media */
+
+  ret = inode->u.i_bops->write(inode, BCH_SLOTBUFFER(bch, first),
+                               bch->slot[first].sector, count);
 
 #if defined(CONFIG_BCH_ENCRYPTION)
-      /* Encrypt data as necessary */
+  /* Computation overhead to save memory for extra sector buffer
+   * TODO: Add configuration switch for extra sector buffer
+   */
 
-      bch_cypher(bch, CYPHER_ENCRYPT);
+  for (i = first; i < first + count; i++)
+    {
+      bch_cypher(bch, i, CYPHER_DECRYPT);
+    }
 #endif
 
-      /* Write the sector to the media */
+  if (ret < 0)
+    {
+      ferr("Write failed: %zd\n", ret);
+      return (int)ret;
+    }
 
-      ret = inode->u.i_bops->write(inode, bch->buffer, bch->sector, 1);
-      if (ret < 0)
-        {
-          ferr("Write failed: %zd\n", ret);
-          return (int)ret;
-        }
+  /* The sectors are now in sync with the media */
 
-#if defined(CONFIG_BCH_ENCRYPTION)
-      /* Computation overhead to save memory for extra sector buffer
-       * TODO: Add configuration switch for extra sector buffer
-       */
+  for (i = first; i < first + count; i++)
+    {
+      bch->slot[i].dirty = false;
+    }
 
-      bch_cypher(bch, CYPHER_DECRYPT);
-#endif
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
 
-      /* The sector is now in sync with the media */
+/****************************************************************************
+ * Name: bchlib_flushrange
+ *
+ * Description:
+ *   Flush the cached sectors of a range that are dirty.  Dirty sectors that
+ *   follow each other in the cache are written with one transfer.
+ *
+ * Input Parameters:
+ *   bch      - The BCH state
+ *   sector   - The first sector of the range
+ *   nsectors - The number of sectors of the range
+ *   discard  - true: Drop the sectors of the range from the cache
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
 
-      bch->dirty = false;
+int bchlib_flushrange(FAR struct bchlib_s *bch, size_t sector,
+                      size_t nsectors, bool discard)
+{
+  FAR struct bch_slot_s *slot = bch->slot;
+  int ret;
+  int i;
+  int n;
+
+  if (bch->buffer == NULL)
+    {
+      return OK;
     }
 
-  if (discard)
+  for (i = 0; i < BCH_NSLOTS; i += n)
     {
-      bch->sector = (size_t)-1;
+      n = 1;
+      if (!bch_inrange(&slot[i], sector, nsectors))
+        {
+          continue;
+        }
+
+      if (slot[i].dirty)
+        {
+          while (i + n < BCH_NSLOTS && slot[i + n].dirty &&
+                 slot[i + n].sector == slot[i].sector + n &&
+                 bch_inrange(&slot[i + n], sector, nsectors))
+            {
+              n++;
+            }
+
+          ret = bch_writeslots(bch, i, n);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+
+      if (discard)
+        {
+          int j;
+
+          for (j = i; j < i + n; j++)
+            {
+              slot[j].sector = (size_t)-1;
+            }
+        }
     }
 
-  return (int)ret;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bchlib_flushsector
+ *
+ * Description:
+ *   Flush all the dirty sectors of the cache
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+int bchlib_flushsector(FAR struct bchlib_s *bch, bool discard)
+{
+  return bchlib_flushrange(bch, 0, SIZE_MAX, discard);
 }
 
 /****************************************************************************
  * Name: bchlib_readsector
  *
  * Description:
- *   Read the current sector contents into buffer
+ *   Get a sector into the cache.  A sector missing from the cache replaces
+ *   the least recently used one, unless it continues the previous access:
+ *   Then the whole cache is refilled from that sector with one read.
+ *
+ * Input Parameters:
+ *   bch    - The BCH state
+ *   sector - The sector to get
+ *   whole  - true: The caller overwrites the whole sector, so that it
+ *            doesn't have to be read from the media
+ *
+ * Returned Value:
+ *   The slot of the sector, BCH_SLOTBUFFER() gives its data; a negated
+ *   errno value on failure.
  *
  * Assumptions:
  *   Caller must assume mutual exclusion
  *
  ****************************************************************************/
 
-int bchlib_readsector(FAR struct bchlib_s *bch, size_t sector)
+int bchlib_readsector(FAR struct bchlib_s *bch, size_t sector, bool whole)
 {
-  FAR struct inode *inode;
-  ssize_t ret = OK;
+  FAR struct inode *inode = bch->inode;
+  FAR struct bch_slot_s *slot = bch->slot;
+  ssize_t ret;
+  size_t count;
+  int i;
+  int j;
 
   if (bch->buffer == NULL)
     {
 #if CONFIG_BCH_BUFFER_ALIGNMENT != 0
-      bch->buffer = kmm_memalign(CONFIG_BCH_BUFFER_ALIGNMENT, bch->sectsize);
+      bch->buffer = kmm_memalign(CONFIG_BCH_BUFFER_ALIGNMENT,
+                                 BCH_NSLOTS * bch->sectsize);
 #else
-      bch->buffer = kmm_malloc(bch->sectsize);
+      bch->buffer = kmm_malloc(BCH_NSLOTS * bch->sectsize);
 #endif
       if (bch->buffer == NULL)
         {
@@ -183,9 +294,19 @@ int bchlib_readsector(FAR struct bchlib_s *bch, size_t sector)
         }
     }
 
-  if (bch->sector != sector)
+  bch->age++;
+
+  for (i = 0; i < BCH_NSLOTS; i++)
+    {
+      if (slot[i].sector == sector)
+        {
+          goto out;
+        }
+    }
+
+  if (!whole && sector == bch->nextsector)
     {
-      inode = bch->inode;
+      /* Sequential access, read ahead */
 
       ret = bchlib_flushsector(bch, true);
       if (ret < 0)
@@ -194,18 +315,74 @@ int bchlib_readsector(FAR struct bchlib_s *bch, size_t sector)
           return (int)ret;
         }
 
-      ret = inode->u.i_bops->read(inode, bch->buffer, sector, 1);
+      count = MIN(BCH_NSLOTS, bch->nsectors - sector);
+      ret = inode->u.i_bops->read(inode, bch->buffer, sector, count);
       if (ret < 0)
         {
           ferr("Read failed: %zd\n", ret);
           return (int)ret;
         }
 
-      bch->sector = sector;
+      for (i = 0; i < count; i++)
+        {
+          slot[i].sector = sector + i;
+          slot[i].age    = bch->age;
 #if defined(CONFIG_BCH_ENCRYPTION)
-      bch_cypher(bch, CYPHER_DECRYPT);
+          bch_cypher(bch, i, CYPHER_DECRYPT);
 #endif
+        }
+
+      i = 0;
+      goto out;
     }
 
-  return (int)ret;
+  /* Replace a free slot, or else the least recently used one */
+
+  for (i = 0, j = 0; j < BCH_NSLOTS; j++)
+    {
+      if (slot[j].sector == (size_t)-1)
+        {
+          i = j;
+          break;
+        }
+
+      if (bch->age - slot[j].age > bch->age - slot[i].age)
+        {
+          i = j;
+        }
+    }
+
+  if (slot[i].dirty)
+    {
+      ret = bch_writeslots(bch, i, 1);
+      if (ret < 0)
+        {
+          ferr("Flush failed: %zd\n", ret);
+          return (int)ret;
+        }
+    }
+
+  slot[i].sector = (size_t)-1;
+  if (!whole)
+    {
+      ret = inode->u.i_bops->read(inode, BCH_SLOTBUFFER(bch, i), sector, 1);
+      if (ret < 0)
+        {
+          ferr("Read failed: %zd\n", ret);
+          return (int)ret;
+        }
+    }
+
+  slot[i].sector = sector;
+#if defined(CONFIG_BCH_ENCRYPTION)
+  if (!whole)
+    {
+      bch_cypher(bch, i, CYPHER_DECRYPT);
+    }
+#endif
+
+out:
+  slot[i].age     = bch->age;
+  bch->nextsector = sector + 1;
+  return i;
 }
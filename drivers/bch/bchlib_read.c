@@ -24,6 +24,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <sys/types.h>
 #include <stdint.h>
 #include <string.h>
@@ -87,107 +88,68 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, off_t offset,
   sector     = offset / bch->sectsize;
   sectoffset = offset - sector * bch->sectsize;
 
-  if (sector >= bch->nsectors)
-    {
-      /* Return end-of-file */
-
-      return 0;
-    }
-
-  /* Read the initial partial sector */
+  /* Read until the end of the request or of the device */
 
   bytesread = 0;
-  if (sectoffset > 0)
+  while (len > 0 && sector < bch->nsectors)
     {
-      /* Read the sector into the sector buffer */
-
-      ret = bchlib_readsector(bch, sector);
-      if (ret < 0)
-        {
-          return ret;
-        }
-
-      /* Copy the tail end of the sector to the user buffer */
-
-      if (sectoffset + len > bch->sectsize)
+      nsectors = len / bch->sectsize;
+      if (sectoffset == 0 && nsectors >= BCH_NSLOTS)
         {
-          nbytes = bch->sectsize - sectoffset;
+          /* Read full sectors directly into the user buffer, if there are
+           * at least as many as the cache holds.
+           */
+
+          if (sector + nsectors > bch->nsectors)
+            {
+              nsectors = bch->nsectors - sector;
+            }
+
+          /* The media must have the data of the cached sectors */
+
+          ret = bchlib_flushrange(bch, sector, nsectors, false);
+          if (ret < 0)
+            {
+              ferr("ERROR: Flush failed: %d\n", ret);
+              return ret;
+            }
+
+          ret = bch->inode->u.i_bops->read(bch->inode, (FAR uint8_t *)buffer,
+                                           sector, nsectors);
+          if (ret < 0)
+            {
+              ferr("ERROR: Read failed: %d\n", ret);
+              return ret;
+            }
+
+          nbytes = nsectors * bch->sectsize;
+          bch->nextsector = sector + nsectors;
         }
       else
         {
-          nbytes = len;
-        }
-
-      memcpy(buffer, &bch->buffer[sectoffset], nbytes);
-
-      /* Adjust pointers and counts */
-
-      sector++;
-
-      if (sector >= bch->nsectors)
-        {
-          return nbytes;
-        }
+          /* Read the sector into the cache */
 
-      bytesread  = nbytes;
-      buffer    += nbytes;
-      len       -= nbytes;
-    }
+          ret = bchlib_readsector(bch, sector, false);
+          if (ret < 0)
+            {
+              return ret;
+            }
 
-  /* Then read all of the full sectors following the partial sector directly
-   * into the user buffer.
-   */
+          /* Copy the part of the sector wanted to the user buffer */
 
-  if (len >= bch->sectsize)
-    {
-      nsectors = len / bch->sectsize;
-      if (sector + nsectors > bch->nsectors)
-        {
-          nsectors = bch->nsectors - sector;
-        }
+          nbytes   = MIN(bch->sectsize - sectoffset, len);
+          nsectors = 1;
 
-      ret = bch->inode->u.i_bops->read(bch->inode, (FAR uint8_t *)buffer,
-                                       sector, nsectors);
-      if (ret < 0)
-        {
-          ferr("ERROR: Read failed: %d\n", ret);
-          return ret;
+          memcpy(buffer, BCH_SLOTBUFFER(bch, ret) + sectoffset, nbytes);
         }
 
       /* Adjust pointers and counts */
 
-      sector    += nsectors;
-      nbytes     = nsectors * bch->sectsize;
-      bytesread += nbytes;
-
-      if (sector >= bch->nsectors)
-        {
-          return bytesread;
-        }
-
-      buffer    += nbytes;
-      len       -= nbytes;
-    }
-
-  /* Then read any partial final sector */
-
-  if (len > 0)
-    {
-      /* Read the sector into the sector buffer */
-
-      ret = bchlib_readsector(bch, sector);
-      if (ret < 0)
-        {
-          return ret;
-        }
-
-      /* Copy the head end of the sector to the user buffer */
-
-      memcpy(buffer, bch->buffer, len);
-
-      /* Adjust counts */
-
-      bytesread += len;
+      sector     += nsectors;
+      sectoffset  = 0;
+      bytesread  += nbytes;
+      buffer     += nbytes;
+      len        -= nbytes;
     }
 
   return bytesread;
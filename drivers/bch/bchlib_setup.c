@@ -58,6 +58,7 @@ int bchlib_setup(FAR const char *blkdev, bool readonly, FAR void **handle)
   FAR struct bchlib_s *bch;
   struct geometry geo;
   int ret;
+  int i;
 
   DEBUGASSERT(blkdev);
 
@@ -108,8 +109,13 @@ int bchlib_setup(FAR const char *blkdev, bool readonly, FAR void **handle)
   nxmutex_init(&bch->lock);
   bch->nsectors = geo.geo_nsectors;
   bch->sectsize = geo.geo_sectorsize;
-  bch->sector   = (size_t)-1;
   bch->readonly = readonly;
+
+  for (i = 0; i < BCH_NSLOTS; i++)
+    {
+      bch->slot[i].sector = (size_t)-1;
+    }
+
   *handle = bch;
   return OK;
 
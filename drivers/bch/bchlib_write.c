@@ -24,6 +24,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <sys/types.h>
 #include <stdint.h>
 #include <stdbool.h>
@@ -78,114 +79,81 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, off_t offset,
       return -EFBIG;
     }
 
-  /* Write the initial partial sector */
+  /* Write until the end of the request or of the device */
 
   byteswritten = 0;
-  if (sectoffset > 0)
+  while (len > 0 && sector < bch->nsectors)
     {
-      /* Read the full sector into the sector buffer */
-
-      ret = bchlib_readsector(bch, sector);
-      if (ret < 0)
-        {
-          return ret;
-        }
-
-      /* Copy the tail end of the sector from the user buffer */
-
-      if (sectoffset + len > bch->sectsize)
+      nsectors = len / bch->sectsize;
+      if (sectoffset == 0 && nsectors >= BCH_NSLOTS)
         {
-          nbytes = bch->sectsize - sectoffset;
+          /* Write full sectors directly from the user buffer, if there are
+           * at least as many as the cache holds.
+           */
+
+          if (sector + nsectors > bch->nsectors)
+            {
+              nsectors = bch->nsectors - sector;
+            }
+
+          /* Flush the dirty sectors to keep the sector sequence, and drop
+           * the cached copies of the sectors overwritten.
+           */
+
+          ret = bchlib_flushsector(bch, false);
+          if (ret >= 0)
+            {
+              ret = bchlib_flushrange(bch, sector, nsectors, true);
+            }
+
+          if (ret < 0)
+            {
+              ferr("ERROR: Flush failed: %d\n", ret);
+              return ret;
+            }
+
+          /* Write the contiguous sectors */
+
+          ret = bch->inode->u.i_bops->write(bch->inode,
+                                            (FAR uint8_t *)buffer,
+                                            sector, nsectors);
+          if (ret < 0)
+            {
+              ferr("ERROR: Write failed: %d\n", ret);
+              return ret;
+            }
+
+          nbytes = nsectors * bch->sectsize;
+          bch->nextsector = sector + nsectors;
         }
       else
         {
-          nbytes = len;
-        }
-
-      memcpy(&bch->buffer[sectoffset], buffer, nbytes);
-      bch->dirty = true;
-
-      /* Adjust pointers and counts */
-
-      sector++;
-
-      if (sector >= bch->nsectors)
-        {
-          return nbytes;
-        }
-
-      byteswritten  = nbytes;
-      buffer       += nbytes;
-      len          -= nbytes;
-    }
-
-  /* Then write all of the full sectors following the partial sector
-   * directly from the user buffer.
-   */
-
-  if (len >= bch->sectsize)
-    {
-      nsectors = len / bch->sectsize;
-      if (sector + nsectors > bch->nsectors)
-        {
-          nsectors = bch->nsectors - sector;
-        }
+          /* Get the sector into the cache.  It is read first unless it is
+           * overwritten whole.
+           */
 
-      /* Flush the dirty sector to keep the sector sequence */
+          nbytes   = MIN(bch->sectsize - sectoffset, len);
+          nsectors = 1;
 
-      ret = bchlib_flushsector(bch, sector <= bch->sector &&
-                               bch->sector < (sector + nsectors));
-      if (ret < 0)
-        {
-          ferr("ERROR: Flush failed: %d\n", ret);
-          return ret;
-        }
+          ret = bchlib_readsector(bch, sector, nbytes == bch->sectsize);
+          if (ret < 0)
+            {
+              return ret;
+            }
 
-      /* Write the contiguous sectors */
+          /* Copy the part of the sector written from the user buffer */
 
-      ret = bch->inode->u.i_bops->write(bch->inode, (FAR uint8_t *)buffer,
-                                        sector, nsectors);
-      if (ret < 0)
-        {
-          ferr("ERROR: Write failed: %d\n", ret);
-          return ret;
+          memcpy(BCH_SLOTBUFFER(bch, ret) + sectoffset, buffer, nbytes);
+          bch->slot[ret].dirty = true;
         }
 
       /* Adjust pointers and counts */
 
       sector       += nsectors;
-      nbytes        = nsectors * bch->sectsize;
+      sectoffset    = 0;
       byteswritten += nbytes;
-
-      if (sector >= bch->nsectors)
-        {
-          return byteswritten;
-        }
-
-      buffer    += nbytes;
-      len       -= nbytes;
-    }
-
-  /* Then write any partial final sector */
-
-  if (len > 0)
-    {
-      /* Read the sector into the sector buffer */
-
-      ret = bchlib_readsector(bch, sector);
-      if (ret < 0)
-        {
-          return ret;
-        }
-
-      /* Copy the head end of the sector from the user buffer */
-
-      memcpy(bch->buffer, buffer, len);
-      bch->dirty = true;
-
-      /* Adjust counts */
-
-      byteswritten += len;
+      buffer       += nbytes;
+      len          -= nbytes;
     }
 
   return byteswritten;
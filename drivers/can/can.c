@@ -81,6 +81,14 @@
 #  endif
 #endif
 
+/* Most messages handed to co_sendbatch() at once */
+
+#if CONFIG_CAN_TXFIFOSIZE < 8
+#  define CAN_TXBATCH CONFIG_CAN_TXFIFOSIZE
+#else
+#  define CAN_TXBATCH 8
+#endif
+
 /* Timing Definitions *******************************************************/
 
 #define HALF_SECOND_MSEC 500
@@ -100,6 +108,7 @@ static int            can_open(FAR struct file *filep);
 static int            can_close(FAR struct file *filep);
 static ssize_t        can_read(FAR struct file *filep, FAR char *buffer,
                                size_t buflen);
+static int            can_xmitbatch(FAR struct can_dev_s *dev);
 static int            can_xmit(FAR struct can_dev_s *dev);
 static ssize_t        can_write(FAR struct file *filep,
                                 FAR const char *buffer, size_t buflen);
@@ -187,15 +196,38 @@ static void can_txready_work(FAR void *arg)
 
 static FAR struct can_reader_s *init_can_reader(FAR struct file *filep)
 {
+  FAR struct can_dev_s *dev = filep->f_inode->i_private;
   FAR struct can_reader_s *reader = kmm_zalloc(sizeof(struct can_reader_s));
   DEBUGASSERT(reader != NULL);
 
-  nxsem_init(&reader->fifo.rx_sem, 0, 0);
+  /* The reader starts with the next message to be received */
+
+  nxsem_init(&reader->rx_sem, 0, 0);
+  reader->rx_head = dev->cd_recv.rx_tail;
   filep->f_priv = reader;
 
   return reader;
 }
 
+/****************************************************************************
+ * Name: can_reader_flush
+ *
+ * Description:
+ *   Discard the messages received but not read yet by a reader.
+ *
+ ****************************************************************************/
+
+static void can_reader_flush(FAR struct can_dev_s *dev,
+                             FAR struct can_reader_s *reader)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  reader->rx_head  = dev->cd_recv.rx_tail;
+  reader->rx_count = 0;
+  leave_critical_section(flags);
+}
+
 /****************************************************************************
  * Name: can_open
  *
@@ -361,8 +393,10 @@ errout:
 static ssize_t can_read(FAR struct file *filep, FAR char *buffer,
                         size_t buflen)
 {
+  FAR struct inode        *inode = filep->f_inode;
+  FAR struct can_dev_s    *dev   = inode->i_private;
+  FAR struct can_rxfifo_s *fifo  = &dev->cd_recv;
   FAR struct can_reader_s *reader;
-  FAR struct can_rxfifo_s *fifo;
   irqstate_t               flags;
   int                      ret = 0;
 
@@ -377,7 +411,6 @@ static ssize_t can_read(FAR struct file *filep, FAR char *buffer,
     {
       DEBUGASSERT(filep->f_priv != NULL);
       reader = (FAR struct can_reader_s *)filep->f_priv;
-      fifo = &reader->fifo;
 
       /* Interrupts must be disabled while accessing the cd_recv FIFO */
 
@@ -386,7 +419,7 @@ static ssize_t can_read(FAR struct file *filep, FAR char *buffer,
 #ifdef CONFIG_CAN_ERRORS
       /* Check for internal errors */
 
-      if (fifo->rx_error != 0)
+      if (reader->rx_error != 0)
         {
           FAR struct can_msg_s *msg;
 
@@ -409,11 +442,11 @@ static ssize_t can_read(FAR struct file *filep, FAR char *buffer,
 #endif
           msg->cm_hdr.ch_tcf    = 0;
           memset(&(msg->cm_data), 0, CAN_ERROR_DLC);
-          msg->cm_data[5]       = fifo->rx_error;
+          msg->cm_data[5]       = reader->rx_error;
 
           /* Reset the error flag */
 
-          fifo->rx_error        = 0;
+          reader->rx_error      = 0;
 
           ret = CAN_MSGLEN(CAN_ERROR_DLC);
           goto return_with_irqdisabled;
@@ -422,11 +455,11 @@ static ssize_t can_read(FAR struct file *filep, FAR char *buffer,
 
       if ((filep->f_oflags & O_NONBLOCK) != 0)
         {
-          ret = nxsem_trywait(&fifo->rx_sem);
+          ret = nxsem_trywait(&reader->rx_sem);
         }
       else
         {
-          ret = nxsem_wait(&fifo->rx_sem);
+          ret = nxsem_wait(&reader->rx_sem);
         }
 
       if (ret < 0)
@@ -434,21 +467,21 @@ static ssize_t can_read(FAR struct file *filep, FAR char *buffer,
           goto return_with_irqdisabled;
         }
 
-      if (fifo->rx_head == fifo->rx_tail)
+      if (reader->rx_count == 0)
         {
           canerr("RX FIFO sem posted but FIFO is empty.\n");
           goto return_with_irqdisabled;
         }
 
-      /* The cd_recv FIFO is not empty.  Copy all buffered data that will fit
-       * in the user buffer.
+      /* The reader has messages in the cd_recv FIFO.  Copy all of them that
+       * will fit in the user buffer.
        */
 
       do
         {
           /* Will the next message in the FIFO fit into the user buffer? */
 
-          FAR struct can_msg_s *msg = &fifo->rx_buffer[fifo->rx_head];
+          FAR struct can_msg_s *msg = &fifo->rx_buffer[reader->rx_head];
           int nbytes = can_dlc2bytes(msg->cm_hdr.ch_dlc);
           int msglen = CAN_MSGLEN(nbytes);
 
@@ -462,23 +495,23 @@ static ssize_t can_read(FAR struct file *filep, FAR char *buffer,
           memcpy(&buffer[ret], msg, msglen);
           ret += msglen;
 
-          /* Increment the head of the circular message buffer */
+          /* Increment the head of the reader in the circular buffer */
 
-          if (++fifo->rx_head >= CONFIG_CAN_RXFIFOSIZE)
+          if (++reader->rx_head >= CONFIG_CAN_RXFIFOSIZE)
             {
-              fifo->rx_head = 0;
+              reader->rx_head = 0;
             }
         }
-      while (fifo->rx_head != fifo->rx_tail);
+      while (--reader->rx_count > 0);
 
-      if (fifo->rx_head != fifo->rx_tail)
+      if (reader->rx_count > 0)
         {
           /* The user's buffer was too small, so some messages remain in the
            * FIFO. Post the semaphore so future calls to poll() or read()
            * don't block.
            */
 
-          nxsem_post(&fifo->rx_sem);
+          nxsem_post(&reader->rx_sem);
         }
 
 return_with_irqdisabled:
@@ -488,6 +521,72 @@ return_with_irqdisabled:
   return ret;
 }
 
+/****************************************************************************
+ * Name: can_xmitbatch
+ *
+ * Description:
+ *   Send the pending messages of the sender to a lower half that can take
+ *   several of them at once, CAN_TXBATCH at most per call.
+ *
+ * Assumptions:
+ *   Called with interrupts disabled
+ *
+ ****************************************************************************/
+
+static int can_xmitbatch(FAR struct can_dev_s *dev)
+{
+  FAR struct can_msg_s *msgs[CAN_TXBATCH];
+  int nmsgs;
+  int nsent;
+  int ret = -EBUSY;
+
+  while (TX_PENDING(&dev->cd_sender) && dev_txready(dev))
+    {
+      for (nmsgs = 0; nmsgs < CAN_TXBATCH &&
+                      TX_PENDING(&dev->cd_sender); nmsgs++)
+        {
+          msgs[nmsgs] = can_get_msg(&dev->cd_sender);
+          if (msgs[nmsgs] == NULL)
+            {
+              break;
+            }
+        }
+
+      if (nmsgs == 0)
+        {
+          break;
+        }
+
+      ret   = dev_sendbatch(dev, msgs, nmsgs);
+      nsent = ret < 0 ? 0 : ret;
+
+      /* Give back the messages that the lower half did not take, the last
+       * one first so that the order of the sender is kept.
+       */
+
+      while (nmsgs > nsent)
+        {
+          can_revert_msg(&dev->cd_sender, msgs[--nmsgs]);
+        }
+
+      if (ret < 0)
+        {
+          canerr("dev_sendbatch failed: %d\n", ret);
+          break;
+        }
+
+      ret = OK;
+      if (nsent < CAN_TXBATCH && TX_PENDING(&dev->cd_sender))
+        {
+          /* The hardware is full */
+
+          break;
+        }
+    }
+
+  return ret;
+}
+
 /****************************************************************************
  * Name: can_xmit
  *
@@ -538,27 +637,34 @@ static int can_xmit(FAR struct can_dev_s *dev)
    * we are still waiting for transmissions to complete.
    */
 
-  while (TX_PENDING(&dev->cd_sender) && dev_txready(dev))
+  if (dev->cd_ops->co_sendbatch != NULL)
+    {
+      ret = can_xmitbatch(dev);
+    }
+  else
     {
-      /* No.. The sender should not be empty in this case */
+      while (TX_PENDING(&dev->cd_sender) && dev_txready(dev))
+        {
+          /* No.. The sender should not be empty in this case */
 
-      DEBUGASSERT(!TX_EMPTY(&dev->cd_sender));
+          DEBUGASSERT(!TX_EMPTY(&dev->cd_sender));
 
-      msg = can_get_msg(&dev->cd_sender);
+          msg = can_get_msg(&dev->cd_sender);
 
-      if (msg == NULL)
-        {
-          break;
-        }
+          if (msg == NULL)
+            {
+              break;
+            }
 
-      /* Send the next message at the sender */
+          /* Send the next message at the sender */
 
-      ret = dev_send(dev, msg);
-      if (ret < 0)
-        {
-          canerr("dev_send failed: %d\n", ret);
-          can_revert_msg(&dev->cd_sender, msg);
-          break;
+          ret = dev_send(dev, msg);
+          if (ret < 0)
+            {
+              canerr("dev_send failed: %d\n", ret);
+              can_revert_msg(&dev->cd_sender, msg);
+              break;
+            }
         }
     }
 
@@ -823,8 +929,7 @@ static int can_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
       case CANIOC_IFLUSH:
         {
-          reader->fifo.rx_head = 0;
-          reader->fifo.rx_tail = 0;
+          can_reader_flush(dev, reader);
 
           /* invoke lower half ioctl */
 
@@ -851,9 +956,7 @@ static int can_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
       case CANIOC_IOFLUSH:
         {
           can_sender_init(&dev->cd_sender);
-
-          reader->fifo.rx_head = 0;
-          reader->fifo.rx_tail = 0;
+          can_reader_flush(dev, reader);
 
           /* invoke lower half ioctl */
 
@@ -876,9 +979,9 @@ static int can_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         {
           *(FAR uint8_t *)arg =
 #ifdef CONFIG_CAN_ERRORS
-                            (reader->fifo.rx_error != 0) +
+                            (reader->rx_error != 0) +
 #endif
-                            reader->fifo.rx_tail - reader->fifo.rx_head;
+                            reader->rx_count;
         }
         break;
 
@@ -1029,9 +1132,9 @@ static int can_poll(FAR struct file *filep, FAR struct pollfd *fds,
 
       /* Check whether there are messages in the RX FIFO. */
 
-      if (reader->fifo.rx_head != reader->fifo.rx_tail
+      if (reader->rx_count != 0
 #ifdef CONFIG_CAN_ERRORS
-          || reader->fifo.rx_error != 0
+          || reader->rx_error != 0
 #endif
          )
         {
@@ -1091,6 +1194,7 @@ int can_register(FAR const char *path, FAR struct can_dev_s *dev)
   dev->cd_npendrtr   = 0;
   dev->cd_ntxwaiters = 0;
   list_initialize(&dev->cd_readers);
+  dev->cd_recv.rx_tail = 0;
 
   /* Initialize semaphores */
 
@@ -1206,10 +1310,33 @@ int can_receive(FAR struct can_dev_s *dev, FAR struct can_hdr_s *hdr,
         }
     }
 
-  list_for_every(&dev->cd_readers, node)
+  /* Add the new, decoded CAN message once at the tail of the FIFO shared
+   * by all of the readers.
+   *
+   * REVISIT:  In the CAN FD format, the coding of the DLC differs
+   * from the standard CAN format. The DLC codes 0 to 8 have the
+   * same coding as in standard CAN, the codes 9 to 15, which in
+   * standard CAN all code a data field of 8 bytes, are encoded:
+   *
+   *   9->12, 10->16, 11->20, 12->24, 13->32, 14->48, 15->64
+   */
+
+  if (!list_is_empty(&dev->cd_readers))
     {
-      FAR struct can_reader_s *reader = (FAR struct can_reader_s *)node;
-      fifo = &reader->fifo;
+      int nbytes;
+
+      fifo = &dev->cd_recv;
+
+      memcpy(&fifo->rx_buffer[fifo->rx_tail].cm_hdr, hdr,
+             sizeof(struct can_hdr_s));
+
+      nbytes = can_dlc2bytes(hdr->ch_dlc);
+      if (nbytes)
+        {
+          memcpy(fifo->rx_buffer[fifo->rx_tail].cm_data, data, nbytes);
+        }
+
+      /* Increment the tail of the circular buffer */
 
       nexttail = fifo->rx_tail + 1;
       if (nexttail >= CONFIG_CAN_RXFIFOSIZE)
@@ -1217,65 +1344,55 @@ int can_receive(FAR struct can_dev_s *dev, FAR struct can_hdr_s *hdr,
           nexttail = 0;
         }
 
-      /* Refuse the new data if the FIFO is full */
+      fifo->rx_tail = nexttail;
+      ret = OK;
+    }
+
+  list_for_every(&dev->cd_readers, node)
+    {
+      FAR struct can_reader_s *reader = (FAR struct can_reader_s *)node;
 
-      if (nexttail != fifo->rx_head)
+      if (reader->rx_count < CONFIG_CAN_RXFIFOSIZE)
+        {
+          reader->rx_count++;
+        }
+      else
         {
-          int nbytes;
-
-          /* Add the new, decoded CAN message at the tail of the FIFO.
-           *
-           * REVISIT:  In the CAN FD format, the coding of the DLC differs
-           * from the standard CAN format. The DLC codes 0 to 8 have the
-           * same coding as in standard CAN, the codes 9 to 15, which in
-           * standard CAN all code a data field of 8 bytes, are encoded:
-           *
-           *   9->12, 10->16, 11->20, 12->24, 13->32, 14->48, 15->64
+          /* The reader was full, so its oldest message has just been
+           * overwritten.  Skip it.
            */
 
-          memcpy(&fifo->rx_buffer[fifo->rx_tail].cm_hdr, hdr,
-                 sizeof(struct can_hdr_s));
-
-          nbytes = can_dlc2bytes(hdr->ch_dlc);
-          if (nbytes)
+          if (++reader->rx_head >= CONFIG_CAN_RXFIFOSIZE)
             {
-              memcpy(fifo->rx_buffer[fifo->rx_tail].cm_data, data, nbytes);
+              reader->rx_head = 0;
             }
 
-          /* Increment the tail of the circular buffer */
+#ifdef CONFIG_CAN_ERRORS
+          /* Report rx overflow error */
 
-          fifo->rx_tail = nexttail;
+          reader->rx_error |= CAN_ERROR5_RXOVERFLOW;
+#endif
+        }
 
-          if (nxsem_get_value(&fifo->rx_sem, &sval) < 0)
-            {
+      if (nxsem_get_value(&reader->rx_sem, &sval) < 0)
+        {
 #ifdef CONFIG_CAN_ERRORS
-              /* Report unspecified error */
+          /* Report unspecified error */
 
-              fifo->rx_error |= CAN_ERROR5_UNSPEC;
+          reader->rx_error |= CAN_ERROR5_UNSPEC;
 #endif
-              continue;
-            }
-
-          /* Unlock the binary semaphore, waking up can_read if it is
-           * blocked. If can_read were not blocked, we would not be
-           * executing this because interrupts would be disabled.
-           */
+          continue;
+        }
 
-          if (sval <= 0)
-            {
-              nxsem_post(&fifo->rx_sem);
-            }
+      /* Unlock the binary semaphore, waking up can_read if it is
+       * blocked. If can_read were not blocked, we would not be
+       * executing this because interrupts would be disabled.
+       */
 
-          ret = OK;
-        }
-#ifdef CONFIG_CAN_ERRORS
-      else
+      if (sval <= 0)
         {
-          /* Report rx overflow error */
-
-          fifo->rx_error |= CAN_ERROR5_RXOVERFLOW;
+          nxsem_post(&reader->rx_sem);
         }
-#endif
     }
 
   /* Notify all poll/select waiters that they can read from the
@@ -0,0 +1,232 @@
+/****************************************************************************
+ * drivers/dma/dma.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/dma/dma.h>
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR struct dma_dev_s *g_dma_devs[CONFIG_DMA_NDEVICES];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dma_sg_callback
+ *
+ * Description:
+ *   Start the next segment when the controller can't chain them.
+ *
+ ****************************************************************************/
+
+static void dma_sg_callback(FAR struct dma_chan_s *chan, FAR void *arg,
+                            ssize_t len)
+{
+  FAR struct dma_sglist_s *list = arg;
+  FAR const struct dma_sg_s *sg;
+  int ret;
+
+  if (len < 0)
+    {
+      list->callback(chan, list->arg, len);
+      return;
+    }
+
+  list->len += len;
+  if (list->next >= list->nsg)
+    {
+      list->callback(chan, list->arg, list->len);
+      return;
+    }
+
+  sg  = &list->sg[list->next++];
+  ret = DMA_START(chan, dma_sg_callback, list, sg->dst, sg->src, sg->len);
+  if (ret < 0)
+    {
+      list->callback(chan, list->arg, ret);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dma_register
+ *
+ * Description:
+ *   Register a DMA controller, so that the clients find its channels by
+ *   DMA_IDENT(devno, chan) without knowing the controller.
+ *
+ * Input Parameters:
+ *   devno - The number of the controller, less than CONFIG_DMA_NDEVICES
+ *   dev   - The controller
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int dma_register(unsigned int devno, FAR struct dma_dev_s *dev)
+{
+  if (devno >= CONFIG_DMA_NDEVICES || dev == NULL)
+    {
+      return -EINVAL;
+    }
+
+  if (g_dma_devs[devno] != NULL)
+    {
+      return -EBUSY;
+    }
+
+  g_dma_devs[devno] = dev;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: dma_unregister
+ *
+ * Description:
+ *   Unregister a DMA controller.
+ *
+ ****************************************************************************/
+
+int dma_unregister(unsigned int devno)
+{
+  if (devno >= CONFIG_DMA_NDEVICES || g_dma_devs[devno] == NULL)
+    {
+      return -ENODEV;
+    }
+
+  g_dma_devs[devno] = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: dma_get_chan
+ *
+ * Description:
+ *   Get a channel of a registered controller by DMA_GET_CHAN().
+ *
+ * Input Parameters:
+ *   ident - DMA_IDENT(devno, chan)
+ *
+ * Returned Value:
+ *   The channel, NULL if the controller isn't registered.
+ *
+ ****************************************************************************/
+
+FAR struct dma_chan_s *dma_get_chan(unsigned int ident)
+{
+  unsigned int devno = DMA_IDENT_DEVNO(ident);
+  FAR struct dma_dev_s *dev;
+
+  if (devno >= CONFIG_DMA_NDEVICES)
+    {
+      return NULL;
+    }
+
+  dev = g_dma_devs[devno];
+  if (dev == NULL)
+    {
+      return NULL;
+    }
+
+  return DMA_GET_CHAN(dev, DMA_IDENT_CHAN(ident));
+}
+
+/****************************************************************************
+ * Name: dma_put_chan
+ *
+ * Description:
+ *   Release a channel got by dma_get_chan().
+ *
+ ****************************************************************************/
+
+void dma_put_chan(unsigned int ident, FAR struct dma_chan_s *chan)
+{
+  unsigned int devno = DMA_IDENT_DEVNO(ident);
+
+  DEBUGASSERT(devno < CONFIG_DMA_NDEVICES && g_dma_devs[devno] != NULL);
+  DMA_PUT_CHAN(g_dma_devs[devno], chan);
+}
+
+/****************************************************************************
+ * Name: dma_start_sg
+ *
+ * Description:
+ *   Start a scatter-gather transfer.  The controller does it in one go if
+ *   it has start_sg(), otherwise the segments are started one by one
+ *   from the completion of the previous one.
+ *
+ * Input Parameters:
+ *   chan     - The channel to start
+ *   callback - The callback when the last segment finish
+ *   arg      - The argument will pass to callback
+ *   list     - The segments
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int dma_start_sg(FAR struct dma_chan_s *chan, dma_callback_t callback,
+                 FAR void *arg, FAR struct dma_sglist_s *list)
+{
+  int ret;
+
+  if (list->nsg == 0)
+    {
+      return -EINVAL;
+    }
+
+  if (chan->ops->start_sg != NULL)
+    {
+      return DMA_START_SG(chan, callback, arg, list->sg, list->nsg);
+    }
+
+  if (list->nsg == 1)
+    {
+      return DMA_START(chan, callback, arg, list->sg->dst, list->sg->src,
+                       list->sg->len);
+    }
+
+  list->callback = callback;
+  list->arg      = arg;
+  list->next     = 1;
+  list->len      = 0;
+
+  ret = DMA_START(chan, dma_sg_callback, list, list->sg->dst,
+                  list->sg->src, list->sg->len);
+  return ret;
+}
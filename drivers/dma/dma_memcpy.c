@@ -0,0 +1,298 @@
+/****************************************************************************
+ * drivers/dma/dma_memcpy.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <string.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/cache.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/dma/dma.h>
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct dma_memcpy_s
+{
+  sem_t                  busy;     /* Held by the copy owning the channel */
+  sem_t                  done;     /* Completion of the synchronous copy */
+  FAR struct dma_chan_s *chan;     /* The channel, once found */
+  uintptr_t              dst;      /* Body of the copy, to invalidate */
+  size_t                 len;
+  size_t                 total;    /* Length of the whole copy */
+  ssize_t                result;   /* Result of the synchronous copy */
+  dma_callback_t         callback; /* Callback of the asynchronous copy */
+  FAR void              *arg;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct dma_memcpy_s g_dma_memcpy =
+{
+  SEM_INITIALIZER(1),
+  SEM_INITIALIZER(0),
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dma_memcpy_cpu
+ *
+ * Description:
+ *   Copy by the CPU, with non-temporal stores when the architecture has
+ *   them.
+ *
+ ****************************************************************************/
+
+static void dma_memcpy_cpu(FAR void *dst, FAR const void *src, size_t len)
+{
+#ifdef CONFIG_ARCH_HAVE_MEMCPY_NT
+  up_memcpy_nt(dst, src, len);
+#else
+  memcpy(dst, src, len);
+#endif
+}
+
+/****************************************************************************
+ * Name: dma_memcpy_callback
+ ****************************************************************************/
+
+static void dma_memcpy_callback(FAR struct dma_chan_s *chan, FAR void *arg,
+                                ssize_t len)
+{
+  FAR struct dma_memcpy_s *priv = arg;
+  dma_callback_t callback = priv->callback;
+  FAR void *cbarg = priv->arg;
+
+  /* Drop the lines the CPU may have prefetched during the transfer */
+
+  up_invalidate_dcache(priv->dst, priv->dst + priv->len);
+
+  if (callback == NULL)
+    {
+      priv->result = len;
+      nxsem_post(&priv->done);
+      return;
+    }
+
+  len = len < 0 ? len : priv->total;
+  nxsem_post(&priv->busy);
+  callback(chan, cbarg, len);
+}
+
+/****************************************************************************
+ * Name: dma_memcpy_start
+ *
+ * Description:
+ *   Take the channel, start the DMA transfer of the cache line aligned
+ *   body of the destination and copy the ends.  The ends share their
+ *   lines with other data, so they can't be invalidated and are copied by
+ *   the CPU while the controller moves the body.  The call back is NULL
+ *   for the synchronous copy, which waits for priv->done.
+ *
+ * Returned Value:
+ *   Zero (OK) if the body is moving; a negated errno value if nothing was
+ *   copied.
+ *
+ ****************************************************************************/
+
+static int dma_memcpy_start(FAR struct dma_memcpy_s *priv,
+                            FAR uint8_t *dst, FAR const uint8_t *src,
+                            size_t len, dma_callback_t callback,
+                            FAR void *arg)
+{
+  struct dma_config_s cfg;
+  size_t linesize;
+  size_t head;
+  size_t body;
+  int ret;
+
+  if (up_interrupt_context() || nxsem_trywait(&priv->busy) < 0)
+    {
+      return -EBUSY;
+    }
+
+  /* The controller may be registered after the first copies */
+
+  if (priv->chan == NULL)
+    {
+      priv->chan = dma_get_chan(CONFIG_DMA_MEMCPY_IDENT);
+      if (priv->chan == NULL)
+        {
+          ret = -ENODEV;
+          goto errout;
+        }
+
+      memset(&cfg, 0, sizeof(cfg));
+      cfg.direction = DMA_MEM_TO_MEM;
+      ret = DMA_CONFIG(priv->chan, &cfg);
+      if (ret < 0)
+        {
+          dma_put_chan(CONFIG_DMA_MEMCPY_IDENT, priv->chan);
+          priv->chan = NULL;
+          goto errout;
+        }
+    }
+
+  linesize = up_get_dcache_linesize();
+  if (linesize == 0)
+    {
+      linesize = 1;
+    }
+
+  head = (linesize - ((uintptr_t)dst & (linesize - 1))) & (linesize - 1);
+  if (head >= len)
+    {
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  body = (len - head) & ~(linesize - 1);
+  if (body == 0)
+    {
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  priv->dst      = (uintptr_t)dst + head;
+  priv->len      = body;
+  priv->total    = len;
+  priv->callback = callback;
+  priv->arg      = arg;
+
+  up_clean_dcache((uintptr_t)src + head, (uintptr_t)src + head + body);
+  up_invalidate_dcache(priv->dst, priv->dst + body);
+
+  ret = DMA_START(priv->chan, dma_memcpy_callback, priv, priv->dst,
+                  (uintptr_t)src + head, body);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  memcpy(dst, src, head);
+  memcpy(dst + head + body, src + head + body, len - head - body);
+  return OK;
+
+errout:
+  nxsem_post(&priv->busy);
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dma_memcpy
+ *
+ * Description:
+ *   Copy a large buffer without going through the data cache: by the DMA
+ *   channel CONFIG_DMA_MEMCPY_IDENT when it is registered and free, else
+ *   by the CPU with non-temporal stores.  The copies smaller than
+ *   CONFIG_DMA_MEMCPY_THRESHOLD are done by memcpy().  The buffers must
+ *   not overlap.  It can be called from the interrupt handlers, which
+ *   don't use the channel.
+ *
+ * Input Parameters:
+ *   dst - The destination
+ *   src - The source
+ *   len - The length of the copy in bytes
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int dma_memcpy(FAR void *dst, FAR const void *src, size_t len)
+{
+  FAR struct dma_memcpy_s *priv = &g_dma_memcpy;
+  int ret;
+
+  if (len < CONFIG_DMA_MEMCPY_THRESHOLD)
+    {
+      memcpy(dst, src, len);
+      return OK;
+    }
+
+  if (dma_memcpy_start(priv, dst, src, len, NULL, NULL) < 0)
+    {
+      dma_memcpy_cpu(dst, src, len);
+      return OK;
+    }
+
+  ret = nxsem_wait_uninterruptible(&priv->done);
+  if (ret >= 0 && priv->result < 0)
+    {
+      /* The controller failed, the CPU copies the body again */
+
+      dma_memcpy_cpu((FAR void *)priv->dst,
+                     (FAR const uint8_t *)src +
+                     (priv->dst - (uintptr_t)dst), priv->len);
+    }
+
+  nxsem_post(&priv->busy);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: dma_memcpy_async
+ *
+ * Description:
+ *   Start the copy of a buffer by the DMA channel CONFIG_DMA_MEMCPY_IDENT
+ *   and return at once.  The ends of the destination that don't fill a
+ *   cache line are copied by the CPU before the return.  The buffers must
+ *   stay valid until the callback.
+ *
+ * Input Parameters:
+ *   dst      - The destination
+ *   src      - The source
+ *   len      - The length of the copy in bytes
+ *   callback - Called from the DMA interrupt with the length copied or a
+ *              negated errno value
+ *   arg      - The argument of the callback
+ *
+ * Returned Value:
+ *   Zero (OK) if the copy is started; -EBUSY if the channel is in use,
+ *   -ENODEV if it isn't registered, or -EINVAL if the buffer is too small
+ *   to be moved by the DMA.  Nothing is copied then.
+ *
+ ****************************************************************************/
+
+int dma_memcpy_async(FAR void *dst, FAR const void *src, size_t len,
+                     dma_callback_t callback, FAR void *arg)
+{
+  DEBUGASSERT(callback != NULL);
+  return dma_memcpy_start(&g_dma_memcpy, dst, src, len, callback, arg);
+}
@@ -33,6 +33,7 @@
 #include <nuttx/input/uinput.h>
 #include <nuttx/mtd/mtd.h>
 #include <nuttx/net/loopback.h>
+#include <nuttx/net/pktgen.h>
 #include <nuttx/net/tun.h>
 #include <nuttx/net/telnet.h>
 #include <nuttx/note/note_driver.h>
@@ -220,6 +221,12 @@ void drivers_initialize(void)
   localhost_initialize();
 #endif
 
+#ifdef CONFIG_NET_PKTGEN
+  /* Initialize the packet generator device */
+
+  pktgen_initialize();
+#endif
+
 #ifdef CONFIG_NET_TUN
   /* Initialize the TUN device */
 
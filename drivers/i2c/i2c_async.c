@@ -0,0 +1,174 @@
+/****************************************************************************
+ * drivers/i2c/i2c_async.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/spinlock.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/i2c/i2c_master.h>
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The queue of one I2C bus */
+
+struct i2c_async_bus_s
+{
+  FAR struct i2c_master_s *dev;  /* The bus, NULL if the entry is free */
+  sq_queue_t queue;              /* Messages waiting for the bus */
+  struct work_s work;            /* Serves the queue */
+  bool busy;                     /* The work is queued or running */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct i2c_async_bus_s g_i2c_async[CONFIG_I2C_ASYNC_NBUSES];
+static spinlock_t g_i2c_async_lock = SP_UNLOCKED;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: i2c_async_worker
+ *
+ * Description:
+ *   Perform the messages of the queue of a bus in order until it is empty.
+ *
+ ****************************************************************************/
+
+static void i2c_async_worker(FAR void *arg)
+{
+  FAR struct i2c_async_bus_s *bus = arg;
+  FAR struct i2c_async_s *msg;
+  irqstate_t flags;
+  int ret;
+
+  for (; ; )
+    {
+      flags = spin_lock_irqsave(&g_i2c_async_lock);
+      msg = (FAR struct i2c_async_s *)sq_remfirst(&bus->queue);
+      if (msg == NULL)
+        {
+          bus->busy = false;
+        }
+
+      spin_unlock_irqrestore(&g_i2c_async_lock, flags);
+
+      if (msg == NULL)
+        {
+          break;
+        }
+
+      ret = I2C_TRANSFER(bus->dev, msg->msgv, msg->msgc);
+      if (ret < 0)
+        {
+          i2cerr("ERROR: I2C_TRANSFER failed: %d\n", ret);
+        }
+
+      msg->callback(msg, ret);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: i2c_transfer_async
+ *
+ * Description:
+ *   Queue an I2C transfer on the queue of the I2C bus, and return without
+ *   waiting.  The callback of the message is called from the low priority
+ *   work queue when it is done.
+ *
+ * Input Parameters:
+ *   dev - Device-specific state data
+ *   msg - The messages and the callback.
+ *
+ * Returned Value:
+ *   Zero (OK) if the message is queued; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int i2c_transfer_async(FAR struct i2c_master_s *dev,
+                       FAR struct i2c_async_s *msg)
+{
+  FAR struct i2c_async_bus_s *bus = NULL;
+  irqstate_t flags;
+  bool start;
+  int i;
+
+  DEBUGASSERT(dev != NULL && msg != NULL && msg->msgv != NULL &&
+              msg->callback != NULL);
+
+  flags = spin_lock_irqsave(&g_i2c_async_lock);
+
+  /* Find the queue of the bus, or give it a free one */
+
+  for (i = 0; i < CONFIG_I2C_ASYNC_NBUSES; i++)
+    {
+      if (g_i2c_async[i].dev == dev)
+        {
+          bus = &g_i2c_async[i];
+          break;
+        }
+      else if (g_i2c_async[i].dev == NULL && bus == NULL)
+        {
+          bus = &g_i2c_async[i];
+        }
+    }
+
+  if (bus == NULL)
+    {
+      spin_unlock_irqrestore(&g_i2c_async_lock, flags);
+      return -ENOSPC;
+    }
+
+  bus->dev = dev;
+  sq_addlast(&msg->node, &bus->queue);
+
+  /* Start the work if it is not already serving the queue */
+
+  start     = !bus->busy;
+  bus->busy = true;
+
+  spin_unlock_irqrestore(&g_i2c_async_lock, flags);
+
+  if (start)
+    {
+      work_queue(LPWORK, &bus->work, i2c_async_worker, bus, 0);
+    }
+
+  return OK;
+}
@@ -58,6 +58,10 @@
 #define IS_SDV2(t)  (((t) & MMCSD_CARDTYPE_SDV2) != 0)
 #define IS_BLOCK(t) (((t) & MMCSD_CARDTYPE_BLOCK) != 0)
 
+/* The block count of ACMD23 (SET_WR_BLK_ERASE_COUNT) has 23 bits */
+
+#define MMCSD_ACMD23_MAXCOUNT 0x007fffff
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -65,7 +69,9 @@
 struct mmcsd_part_s
 {
   FAR struct mmcsd_state_s *priv;
-  blkcnt_t nblocks; /* Number of blocks */
+  blkcnt_t nblocks;    /* Number of blocks */
+  blkcnt_t erasestart; /* First block of the pre-erase hint */
+  blkcnt_t erasecount; /* Blocks of the pre-erase hint, zero if none */
 };
 
 /* This structure is contains the unique state of the MMC/SD block driver */
@@ -30,6 +30,7 @@
 
 #include <sys/types.h>
 #include <sys/ioctl.h>
+#include <sys/param.h>
 
 #include <inttypes.h>
 #include <stdint.h>
@@ -186,6 +187,8 @@ static ssize_t mmcsd_writesingle(FAR struct mmcsd_part_s *part,
                                  FAR const uint8_t *buffer,
                                  off_t startblock);
 #if MMCSD_MULTIBLOCK_LIMIT != 1
+static uint32_t mmcsd_preerasecount(FAR struct mmcsd_part_s *part,
+                                    off_t startblock, size_t nblocks);
 static ssize_t mmcsd_writemultiple(FAR struct mmcsd_part_s *part,
                                    FAR const uint8_t *buffer,
                                    off_t startblock,
@@ -1976,6 +1979,33 @@ static ssize_t mmcsd_writesingle(FAR struct mmcsd_part_s *part,
   return 1;
 }
 
+/****************************************************************************
+ * Name: mmcsd_preerasecount
+ *
+ * Description:
+ *   Return the number of blocks to be pre-erased by ACMD23 for a multiple
+ *   block write.  That is the rest of the pre-erase hint if the write
+ *   starts inside it, the blocks written otherwise.  The hint is used once.
+ *
+ ****************************************************************************/
+
+#if MMCSD_MULTIBLOCK_LIMIT != 1
+static uint32_t mmcsd_preerasecount(FAR struct mmcsd_part_s *part,
+                                    off_t startblock, size_t nblocks)
+{
+  blkcnt_t count = nblocks;
+
+  if (part->erasecount > 0 && startblock >= part->erasestart &&
+      startblock < part->erasestart + part->erasecount)
+    {
+      count = MAX(count, part->erasestart + part->erasecount - startblock);
+      part->erasecount = 0;
+    }
+
+  return MIN(count, MMCSD_ACMD23_MAXCOUNT);
+}
+#endif
+
 /****************************************************************************
  * Name: mmcsd_writemultiple
  *
@@ -2099,10 +2129,12 @@ static ssize_t mmcsd_writemultiple(FAR struct mmcsd_part_s *part,
         }
 
       /* Send CMD23, SET_WR_BLK_ERASE_COUNT, and verify that good R1 status
-       * is returned.
+       * is returned.  If the write starts a run that the block layer said
+       * will be overwritten, have the whole run pre-erased.
        */
 
-      mmcsd_sendcmdpoll(priv, SD_ACMD23, nblocks);
+      mmcsd_sendcmdpoll(priv, SD_ACMD23,
+                        mmcsd_preerasecount(part, startblock, nblocks));
       ret = mmcsd_recv_r1(priv, SD_ACMD23);
       if (ret != OK)
         {
@@ -2474,6 +2506,16 @@ static ssize_t mmcsd_write(FAR struct inode *inode,
           buffer += nwrite * priv->blocksize;
         }
 
+      /* A pre-erase hint that was not used must not survive a write into
+       * it, or a later ACMD23 could erase the data just written.
+       */
+
+      if (part->erasecount > 0 && startsector < part->erasestart +
+          part->erasecount && endsector > part->erasestart)
+        {
+          part->erasecount = 0;
+        }
+
       mmcsd_unlock(priv);
     }
 
@@ -2607,6 +2649,32 @@ static int mmcsd_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
       }
       break;
 
+    case BIOC_PREERASE: /* Sectors that will be overwritten soon */
+      {
+        FAR const struct blk_preerase_s *hint =
+          (FAR const struct blk_preerase_s *)((uintptr_t)arg);
+
+        finfo("BIOC_PREERASE\n");
+
+        /* Only SD cards pre-erase ahead of a write, by ACMD23 */
+
+        if (hint == NULL || hint->startsector < 0 || hint->nsectors < 0 ||
+            hint->startsector + hint->nsectors > part->nblocks)
+          {
+            ret = -EINVAL;
+          }
+        else if (!IS_SD(priv->type))
+          {
+            ret = -ENOTTY;
+          }
+        else
+          {
+            part->erasestart = hint->startsector;
+            part->erasecount = hint->nsectors;
+          }
+      }
+      break;
+
 #ifdef CONFIG_MMCSD_IOCSUPPORT
     case MMC_IOC_CMD: /* MMCSD device ioctl commands */
       {
@@ -4393,6 +4461,7 @@ static int mmcsd_removed(FAR struct mmcsd_state_s *priv)
       snprintf(devname, sizeof(devname), "/dev/mmcsd%d%s",
                priv->minor, g_partname[i]);
       unregister_blockdriver(devname);
+      priv->part[i].erasecount = 0;
     }
 
   /* Forget the card geometry, pretend the slot is empty (it might not
@@ -30,7 +30,9 @@
 
 #include <nuttx/nuttx.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/mtd/mtd.h>
+#include <nuttx/drivers/rwbuffer.h>
 
 #include <dhara/map.h>
 #include <dhara/nand.h>
@@ -60,6 +62,9 @@ struct dhara_dev_s
 
   FAR struct mtd_dev_s *mtd;      /* Contained MTD interface */
   struct mtd_geometry_s geo;      /* Device geometry */
+#ifdef CONFIG_DHARA_WRITEBUFFER
+  struct rwbuffer_s     rwb;      /* Write buffer support */
+#endif
   uint16_t              blkper;   /* R/W blocks per erase block */
   uint16_t              refs;     /* Number of references */
   bool                  unlinked; /* The driver has been unlinked */
@@ -84,10 +89,14 @@ typedef struct dhara_dev_s dhara_dev_t;
 
 static int     dhara_open(FAR struct inode *inode);
 static int     dhara_close(FAR struct inode *inode);
+static ssize_t dhara_reload(FAR void *priv, FAR uint8_t *buffer,
+                            off_t startblock, size_t nblocks);
 static ssize_t dhara_read(FAR struct inode *inode,
                           FAR unsigned char *buffer,
                           blkcnt_t start_sector,
                           unsigned int nsectors);
+static ssize_t dhara_flush(FAR void *priv, FAR const uint8_t *buffer,
+                           off_t startblock, size_t nblocks);
 static ssize_t dhara_write(FAR struct inode *inode,
                            FAR const unsigned char *buffer,
                            blkcnt_t start_sector,
@@ -285,6 +294,28 @@ static void dhara_update_readcache(FAR dhara_dev_t *dev,
     }
 }
 
+/****************************************************************************
+ * Name: dhara_sync
+ *
+ * Description:
+ *   Commit the map to the journal, so that the sectors written are found
+ *   after a power loss.
+ *
+ ****************************************************************************/
+
+static int dhara_sync(FAR dhara_dev_t *dev)
+{
+  dhara_error_t err;
+
+  if (dhara_map_sync(&dev->map, &err) < 0)
+    {
+      ferr("Sync failed err: %s\n", dhara_strerror(err));
+      return dhara_convert_result(err);
+    }
+
+  return 0;
+}
+
 /****************************************************************************
  * Name: dhara_open
  *
@@ -318,12 +349,24 @@ static int dhara_close(FAR struct inode *inode)
 
   DEBUGASSERT(inode->i_private);
   dev = inode->i_private;
+
+#ifdef CONFIG_DHARA_WRITEBUFFER
+  rwb_flush(&dev->rwb);
+#endif
+
   nxmutex_lock(&dev->lock);
-  dev->refs--;
+  if (--dev->refs == 0)
+    {
+      dhara_sync(dev);
+    }
+
   nxmutex_unlock(&dev->lock);
 
   if (dev->refs == 0 && dev->unlinked)
     {
+#ifdef CONFIG_DHARA_WRITEBUFFER
+      rwb_uninitialize(&dev->rwb);
+#endif
       nxmutex_destroy(&dev->lock);
       dhara_deinit_readcache(dev);
       kmm_free(dev->pagebuf);
@@ -334,24 +377,19 @@ static int dhara_close(FAR struct inode *inode)
 }
 
 /****************************************************************************
- * Name: dhara_read
+ * Name: dhara_reload
  *
- * Description:  Read the specified number of sectors
+ * Description:  Read the specified number of sectors from the map
  *
  ****************************************************************************/
 
-static ssize_t dhara_read(FAR struct inode *inode,
-                          FAR unsigned char *buffer,
-                          blkcnt_t start_sector,
-                          unsigned int nsectors)
+static ssize_t dhara_reload(FAR void *priv, FAR uint8_t *buffer,
+                            off_t start_sector, size_t nsectors)
 {
-  FAR dhara_dev_t *dev;
+  FAR dhara_dev_t *dev = priv;
   size_t nread = 0;
   int ret = 0;
 
-  DEBUGASSERT(inode->i_private);
-  dev = inode->i_private;
-
   nxmutex_lock(&dev->lock);
   while (nsectors-- > 0)
     {
@@ -378,24 +416,43 @@ static ssize_t dhara_read(FAR struct inode *inode,
 }
 
 /****************************************************************************
- * Name: dhara_write
+ * Name: dhara_read
  *
- * Description: Write (or buffer) the specified number of sectors
+ * Description:  Read the specified number of sectors
  *
  ****************************************************************************/
 
-static ssize_t dhara_write(FAR struct inode *inode,
-                           FAR const unsigned char *buffer,
-                           blkcnt_t start_sector,
-                           unsigned int nsectors)
+static ssize_t dhara_read(FAR struct inode *inode,
+                          FAR unsigned char *buffer,
+                          blkcnt_t start_sector,
+                          unsigned int nsectors)
 {
   FAR dhara_dev_t *dev;
-  size_t nwrite = 0;
-  int ret = 0;
 
   DEBUGASSERT(inode->i_private);
   dev = inode->i_private;
 
+#ifdef CONFIG_DHARA_WRITEBUFFER
+  return rwb_read(&dev->rwb, start_sector, nsectors, buffer);
+#else
+  return dhara_reload(dev, buffer, start_sector, nsectors);
+#endif
+}
+
+/****************************************************************************
+ * Name: dhara_flush
+ *
+ * Description: Write the specified number of sectors to the map
+ *
+ ****************************************************************************/
+
+static ssize_t dhara_flush(FAR void *priv, FAR const uint8_t *buffer,
+                           off_t start_sector, size_t nsectors)
+{
+  FAR dhara_dev_t *dev = priv;
+  size_t nwrite = 0;
+  int ret = 0;
+
   nxmutex_lock(&dev->lock);
   while (nsectors-- > 0)
     {
@@ -421,6 +478,30 @@ static ssize_t dhara_write(FAR struct inode *inode,
   return nwrite ? nwrite : ret;
 }
 
+/****************************************************************************
+ * Name: dhara_write
+ *
+ * Description: Write (or buffer) the specified number of sectors
+ *
+ ****************************************************************************/
+
+static ssize_t dhara_write(FAR struct inode *inode,
+                           FAR const unsigned char *buffer,
+                           blkcnt_t start_sector,
+                           unsigned int nsectors)
+{
+  FAR dhara_dev_t *dev;
+
+  DEBUGASSERT(inode->i_private);
+  dev = inode->i_private;
+
+#ifdef CONFIG_DHARA_WRITEBUFFER
+  return rwb_write(&dev->rwb, start_sector, nsectors, buffer);
+#else
+  return dhara_flush(dev, buffer, start_sector, nsectors);
+#endif
+}
+
 /****************************************************************************
  * Name: dhara_geometry
  *
@@ -441,11 +522,10 @@ static int dhara_geometry(FAR struct inode *inode,
       geometry->geo_available    = true;
       geometry->geo_mediachanged = false;
       geometry->geo_writeenabled = true;
-      geometry->geo_nsectors     = dev->geo.neraseblocks * dev->blkper;
+      geometry->geo_nsectors     = dhara_map_capacity(&dev->map);
       geometry->geo_sectorsize   = dev->geo.blocksize;
 
       strcpy(geometry->geo_model, dev->geo.model);
-      nxmutex_unlock(&dev->lock);
       return 0;
     }
 
@@ -469,6 +549,21 @@ static int dhara_ioctl(FAR struct inode *inode,
   DEBUGASSERT(inode->i_private);
   dev = inode->i_private;
 
+  if (cmd == BIOC_FLUSH)
+    {
+#ifdef CONFIG_DHARA_WRITEBUFFER
+      rwb_flush(&dev->rwb);
+#endif
+
+      nxmutex_lock(&dev->lock);
+      ret = dhara_sync(dev);
+      nxmutex_unlock(&dev->lock);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
   /* No other block driver ioctl commands are not recognized by this
    * driver.  Other possible MTD driver ioctl commands are passed through
    * to the MTD driver (unchanged).
@@ -503,6 +598,9 @@ static int dhara_unlink(FAR struct inode *inode)
 
   if (dev->refs == 0)
     {
+#ifdef CONFIG_DHARA_WRITEBUFFER
+      rwb_uninitialize(&dev->rwb);
+#endif
       nxmutex_destroy(&dev->lock);
       dhara_deinit_readcache(dev);
       kmm_free(dev->pagebuf);
@@ -523,7 +621,12 @@ int dhara_nand_is_bad(FAR const struct dhara_nand *n,
                       dhara_block_t bno)
 {
   FAR dhara_dev_t *dev = (FAR dhara_dev_t *)n;
-  return MTD_ISBAD(dev->mtd, bno);
+  int ret;
+
+  /* NOR flash has no bad block management, none of its blocks is bad */
+
+  ret = MTD_ISBAD(dev->mtd, bno);
+  return ret != -ENOSYS && ret != 0;
 }
 
 void dhara_nand_mark_bad(FAR const struct dhara_nand *n,
@@ -747,6 +850,26 @@ int dhara_initialize_by_path(FAR const char *path,
 
   dhara_map_resume(&dev->map, NULL);
 
+#ifdef CONFIG_DHARA_WRITEBUFFER
+  /* Rewrites of the same sectors, like those of a FAT table, are merged
+   * in memory instead of each taking a page of the journal.
+   */
+
+  dev->rwb.blocksize   = dev->geo.blocksize;
+  dev->rwb.nblocks     = dhara_map_capacity(&dev->map);
+  dev->rwb.dev         = dev;
+  dev->rwb.wrflush     = dhara_flush;
+  dev->rwb.rhreload    = dhara_reload;
+  dev->rwb.wrmaxblocks = dev->blkper;
+
+  ret = rwb_initialize(&dev->rwb);
+  if (ret < 0)
+    {
+      ferr("rwb_initialize failed: %d\n", ret);
+      goto err;
+    }
+#endif
+
   /* Inode private data is a reference to the
    * DHARA_MTDBLOCK device structure
    */
@@ -755,6 +878,9 @@ int dhara_initialize_by_path(FAR const char *path,
   if (ret < 0)
     {
       ferr("register_blockdriver failed: %d\n", ret);
+#ifdef CONFIG_DHARA_WRITEBUFFER
+      rwb_uninitialize(&dev->rwb);
+#endif
       goto err;
     }
 
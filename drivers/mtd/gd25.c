@@ -35,6 +35,7 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/signal.h>
 #include <nuttx/fs/ioctl.h>
@@ -76,6 +77,8 @@
 #define GD25_RDMFID                 0x90    /* Read Manufacturer / Device */
 #define GD25_JEDEC_ID               0x9f    /* JEDEC ID read              */
 #define GD25_4BEN                   0xb7    /* Enable 4-byte Mode         */
+#define GD25_PES                    0x75    /* Program/erase suspend      */
+#define GD25_PER                    0x7a    /* Program/erase resume       */
 
 /***************************************************************************
  * GD25 Registers
@@ -108,6 +111,7 @@
 #define GD25_SR_WEL                 (1 << 1)  /* Bit 1: Write Enable Latch */
 #define GD25_SR1_EN4B               (1 << 3)  /* Bit 3: Enable 4byte address */
 #define GD25Q_SR1_EN4B              (1 << 0)  /* Bit 0: Enable 4byte address GD25Q memories */
+#define GD25_SR1_SUS1               (1 << 7)  /* Bit 7: Erase suspended */
 
 #define GD25_DUMMY                  0x00
 
@@ -142,6 +146,10 @@ struct gd25_dev_s
   uint8_t               prev_instr;  /* Previous instruction given to GD25 device */
   bool                  addr_4byte;  /* True: Use Four-byte address */
   uint8_t               memory;      /* memory type read from device */
+#ifdef CONFIG_GD25_ERASE_SUSPEND
+  off_t                 eaddress;    /* Address of the sector being erased */
+  clock_t               resumed;     /* Time of the last erase resume */
+#endif
 };
 
 /***************************************************************************
@@ -159,6 +167,11 @@ static inline int gd25_readid(FAR struct gd25_dev_s *priv);
 static void gd25_unprotect(FAR struct gd25_dev_s *priv);
 #endif
 static uint8_t gd25_waitwritecomplete(FAR struct gd25_dev_s *priv);
+#ifdef CONFIG_GD25_ERASE_SUSPEND
+static bool gd25_erasesuspend(FAR struct gd25_dev_s *priv, off_t address,
+                              size_t nbytes);
+static void gd25_eraseresume(FAR struct gd25_dev_s *priv);
+#endif
 static inline void gd25_wren(FAR struct gd25_dev_s *priv);
 static inline void gd25_wrdi(FAR struct gd25_dev_s *priv);
 static bool gd25_is_erased(FAR struct gd25_dev_s *priv, off_t address,
@@ -409,6 +422,64 @@ static uint8_t gd25_waitwritecomplete(FAR struct gd25_dev_s *priv)
   return status;
 }
 
+/***************************************************************************
+ * Name: gd25_erasesuspend
+ *
+ * Description:
+ *   Suspend the sector erase in progress, so that a read outside of that
+ *   sector doesn't wait for the end of the erase.  The erase is suspended
+ *   once per clock tick at most, so that it still completes under a
+ *   stream of reads.
+ *
+ * Returned Value:
+ *   true if the erase is suspended and must be resumed after the read.
+ *
+ ***************************************************************************/
+
+#ifdef CONFIG_GD25_ERASE_SUSPEND
+static bool gd25_erasesuspend(FAR struct gd25_dev_s *priv, off_t address,
+                              size_t nbytes)
+{
+  clock_t now = clock_systime_ticks();
+
+  if (priv->prev_instr != GD25_SE || priv->resumed == now ||
+      (address < priv->eaddress + GD25_SECTOR_SIZE &&
+       address + nbytes > priv->eaddress) ||
+      (gd25_rdsr(priv, 0) & GD25_SR_WIP) == 0)
+    {
+      return false;
+    }
+
+  SPI_SELECT(priv->spi, SPIDEV_FLASH(priv->spi_devid), true);
+  SPI_SEND(priv->spi, GD25_PES);
+  SPI_SELECT(priv->spi, SPIDEV_FLASH(priv->spi_devid), false);
+
+  /* WIP clears within tens of us, which is not worth a sleep */
+
+  while ((gd25_rdsr(priv, 0) & GD25_SR_WIP) != 0)
+    {
+    }
+
+  /* The erase may have completed before the suspend was seen */
+
+  return (gd25_rdsr(priv, 1) & GD25_SR1_SUS1) != 0;
+}
+
+/***************************************************************************
+ * Name: gd25_eraseresume
+ ***************************************************************************/
+
+static void gd25_eraseresume(FAR struct gd25_dev_s *priv)
+{
+  SPI_SELECT(priv->spi, SPIDEV_FLASH(priv->spi_devid), true);
+  SPI_SEND(priv->spi, GD25_PER);
+  SPI_SELECT(priv->spi, SPIDEV_FLASH(priv->spi_devid), false);
+
+  priv->prev_instr = GD25_SE;
+  priv->resumed    = clock_systime_ticks();
+}
+#endif
+
 /***************************************************************************
  * Name:  gd25_rdsr
  ***************************************************************************/
@@ -549,6 +620,9 @@ static void gd25_sectorerase(FAR struct gd25_dev_s *priv, off_t sector)
 
   SPI_SEND(priv->spi, GD25_SE);
   priv->prev_instr = GD25_SE;
+#ifdef CONFIG_GD25_ERASE_SUSPEND
+  priv->eaddress   = address;
+#endif
 
   /* Send the sector address high byte first.  Only the most significant
    * bits (those corresponding to the sector) have any meaning.
@@ -598,15 +672,27 @@ static inline int gd25_chiperase(FAR struct gd25_dev_s *priv)
 static void gd25_byteread(FAR struct gd25_dev_s *priv, FAR uint8_t *buffer,
                           off_t address, size_t nbytes)
 {
+#ifdef CONFIG_GD25_ERASE_SUSPEND
+  bool suspended;
+#endif
+
   finfo("address: %08lx nbytes: %d\n", (long)address, (int)nbytes);
 
-  /* Wait for any preceding write or erase operation to complete. */
+#ifdef CONFIG_GD25_ERASE_SUSPEND
+  /* Read around a sector erase in progress rather than waiting for it */
 
-  gd25_waitwritecomplete(priv);
+  suspended = gd25_erasesuspend(priv, address, nbytes);
+  if (!suspended)
+#endif
+    {
+      /* Wait for any preceding write or erase operation to complete. */
+
+      gd25_waitwritecomplete(priv);
 
-  /* Make sure that writing is disabled */
+      /* Make sure that writing is disabled */
 
-  gd25_wrdi(priv);
+      gd25_wrdi(priv);
+    }
 
   SPI_SELECT(priv->spi, SPIDEV_FLASH(priv->spi_devid), true);
 
@@ -642,6 +728,13 @@ static void gd25_byteread(FAR struct gd25_dev_s *priv, FAR uint8_t *buffer,
   SPI_RECVBLOCK(priv->spi, buffer, nbytes);
 
   SPI_SELECT(priv->spi, SPIDEV_FLASH(priv->spi_devid), false);
+
+#ifdef CONFIG_GD25_ERASE_SUSPEND
+  if (suspended)
+    {
+      gd25_eraseresume(priv);
+    }
+#endif
 }
 
 /***************************************************************************
@@ -32,6 +32,7 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/arch.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/signal.h>
 #include <nuttx/fs/ioctl.h>
@@ -137,6 +138,14 @@
 #define GD5F_FEATURE_ECC_OFFSET     4
 #define GD5F_ECC_STATUS_MASK        0x0f
 
+/* Page reads (tRD, up to 80us) and programs (tPROG, up to 700us) are
+ * polled without sleeping for about GD5F_POLL_SPINS * GD5F_POLL_USEC,
+ * only longer operations like erases sleep a tick between polls.
+ */
+
+#define GD5F_POLL_USEC              10
+#define GD5F_POLL_SPINS             100
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -154,6 +163,7 @@ struct gd5f_dev_s
   uint16_t             nsectors;        /* 1024 or 2048 */
   uint8_t              sectorshift;     /* 17 */
   uint8_t              pageshift;       /* 11 */
+  uint8_t              status;          /* Status of the last poll */
   uint8_t              eccstatus;       /* Internal ECC status */
 };
 
@@ -188,7 +198,6 @@ static void gd5f_write_to_cache(FAR struct gd5f_dev_s *priv,
 static bool gd5f_execute_write(FAR struct gd5f_dev_s *priv,
                                uint32_t position);
 
-static inline void gd5f_eccstatusread(FAR struct gd5f_dev_s *priv);
 static inline void gd5f_enable_ecc(FAR struct gd5f_dev_s *priv);
 static inline void gd5f_unlockblocks(FAR struct gd5f_dev_s *priv);
 
@@ -315,6 +324,7 @@ static bool gd5f_waitstatus(FAR struct gd5f_dev_s *priv,
                             uint8_t mask,
                             bool successif)
 {
+  unsigned int spins = 0;
   uint8_t status;
 
   /* Loop as long as the memory is busy with a write cycle */
@@ -334,10 +344,23 @@ static bool gd5f_waitstatus(FAR struct gd5f_dev_s *priv,
       /* Deselect the FLASH */
 
       SPI_SELECT(priv->dev, SPIDEV_FLASH(priv->spi_devid), false);
-      nxsig_usleep(1000);
+      if ((status & GD5F_SR_OIP) == 0)
+        {
+          break;
+        }
+
+      if (spins++ < GD5F_POLL_SPINS)
+        {
+          up_udelay(GD5F_POLL_USEC);
+        }
+      else
+        {
+          nxsig_usleep(1000);
+        }
     }
-  while ((status & GD5F_SR_OIP) != 0);
+  while (true);
 
+  priv->status = status;
   finfo("Complete %02x\n", status);
 
   return successif ? ((status & mask) != 0) : ((status & mask) == 0);
@@ -512,13 +535,12 @@ static bool gd5f_read_page(FAR struct gd5f_dev_s *priv, uint32_t pageaddress)
 
   SPI_SELECT(priv->dev, SPIDEV_FLASH(priv->spi_devid), false);
 
-  /* Wait Page Read Complete */
+  /* Wait Page Read Complete, then check HardWare ECC result.  The status
+   * register polled holds it, no need to read it again.
+   */
 
   gd5f_waitstatus(priv, GD5F_SR_OIP, false);
-
-  /* Check HardWare ECC result */
-
-  gd5f_eccstatusread(priv);
+  priv->eccstatus = priv->status;
   if ((priv->eccstatus & GD5F_FEATURE_ECC_MASK) == GD5F_FEATURE_ECC_ERROR)
     {
       /* ECC report uncorrectable, discard data */
@@ -811,19 +833,6 @@ static int gd5f_ioctl(FAR struct mtd_dev_s *dev, int cmd, unsigned long arg)
   return ret;
 }
 
-/****************************************************************************
- * Name:  gd5f_eccstatusread
- ****************************************************************************/
-
-static inline void gd5f_eccstatusread(FAR struct gd5f_dev_s *priv)
-{
-  SPI_SELECT(priv->dev, SPIDEV_FLASH(priv->spi_devid), true);
-  SPI_SEND(priv->dev, GD5F_GET_FEATURE);
-  SPI_SEND(priv->dev, GD5F_STATUS);
-  priv->eccstatus = SPI_SEND(priv->dev, GD5F_DUMMY);
-  SPI_SELECT(priv->dev, SPIDEV_FLASH(priv->spi_devid), false);
-}
-
 /****************************************************************************
  * Name:  gd5f_enable_ecc
  ****************************************************************************/
@@ -88,6 +88,16 @@
  * Private Types
  ****************************************************************************/
 
+/* RAM index entry: address of the newest ate with the id */
+
+#if CONFIG_MTD_CONFIG_INDEX_SIZE > 0
+struct nvs_index_s
+{
+  uint32_t              id;            /* Data id, 0 if the entry is free */
+  uint32_t              addr;          /* Address of the ate */
+};
+#endif
+
 /* Non-volatile Storage File system structure */
 
 struct nvs_fs
@@ -102,6 +112,10 @@ struct nvs_fs
   uint32_t              data_wra;      /* Next data write address */
   uint32_t              step_addr;     /* For traverse */
   mutex_t               nvs_lock;
+#if CONFIG_MTD_CONFIG_INDEX_SIZE > 0
+  bool                  index_complete; /* Every valid id is in the index */
+  struct nvs_index_s    index[CONFIG_MTD_CONFIG_INDEX_SIZE];
+#endif
 };
 
 /* Allocation Table Entry */
@@ -637,6 +651,111 @@ int nvs_flash_write_multi_blk(FAR struct nvs_fs *fs, const uint8_t *addr,
   return left;
 }
 
+/****************************************************************************
+ * Name: nvs_index_slot
+ *
+ * Description:
+ *   Find the index entry of the id, or the free entry where it would be
+ *   added.  Returns NULL if the id is not there and the index is full.
+ *
+ ****************************************************************************/
+
+#if CONFIG_MTD_CONFIG_INDEX_SIZE > 0
+static FAR struct nvs_index_s *nvs_index_slot(FAR struct nvs_fs *fs,
+                                              uint32_t id)
+{
+  FAR struct nvs_index_s *entry;
+  uint32_t slot = id % CONFIG_MTD_CONFIG_INDEX_SIZE;
+  uint32_t i;
+
+  for (i = 0; i < CONFIG_MTD_CONFIG_INDEX_SIZE; i++)
+    {
+      entry = &fs->index[slot];
+      if (entry->id == id || entry->id == 0)
+        {
+          return entry;
+        }
+
+      if (++slot == CONFIG_MTD_CONFIG_INDEX_SIZE)
+        {
+          slot = 0;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: nvs_index_update
+ *
+ * Description:
+ *   Record addr as the location of the newest ate with the id.
+ *
+ ****************************************************************************/
+
+static void nvs_index_update(FAR struct nvs_fs *fs, uint32_t id,
+                             uint32_t addr)
+{
+  FAR struct nvs_index_s *entry;
+
+  entry = nvs_index_slot(fs, id);
+  if (entry == NULL)
+    {
+      /* No room, the absence of an id no longer means anything */
+
+      fs->index_complete = false;
+      return;
+    }
+
+  entry->id   = id;
+  entry->addr = addr;
+}
+
+/****************************************************************************
+ * Name: nvs_index_find
+ *
+ * Description:
+ *   Look the key up in the index.  Returns 0 with the ate and its address
+ *   if found, -ENOENT if the key is surely not stored, and -EAGAIN if the
+ *   ates have to be walked to know.
+ *
+ ****************************************************************************/
+
+static int nvs_index_find(FAR struct nvs_fs *fs, uint32_t id,
+                          FAR const uint8_t *key, size_t key_size,
+                          FAR struct nvs_ate *ate, FAR uint32_t *ate_addr)
+{
+  FAR struct nvs_index_s *entry;
+  int rc;
+
+  entry = nvs_index_slot(fs, id);
+  if (entry == NULL || entry->id == 0)
+    {
+      return fs->index_complete ? -ENOENT : -EAGAIN;
+    }
+
+  /* The entry may be stale after a gc, or belong to another key of the
+   * same id, so check the ate it points to.
+   */
+
+  rc = nvs_flash_ate_rd(fs, entry->addr, ate);
+  if (rc)
+    {
+      return rc;
+    }
+
+  if (ate->id == id && nvs_ate_valid(fs, ate) && ate->key_len == key_size &&
+      !nvs_flash_block_cmp(fs, (entry->addr & ADDR_BLOCK_MASK) +
+                           ate->offset, key, key_size))
+    {
+      *ate_addr = entry->addr;
+      return 0;
+    }
+
+  return -EAGAIN;
+}
+#endif
+
 /****************************************************************************
  * Name: nvs_flash_wrt_entry
  *
@@ -715,6 +834,9 @@ static int nvs_flash_wrt_entry(FAR struct nvs_fs *fs, uint32_t id,
 
   /* Last, let's save entry to flash */
 
+#if CONFIG_MTD_CONFIG_INDEX_SIZE > 0
+  nvs_index_update(fs, id, fs->ate_wra);
+#endif
   rc = nvs_flash_ate_wrt(fs, &entry);
   if (rc)
     {
@@ -1044,6 +1166,9 @@ static int nvs_gc(FAR struct nvs_fs *fs)
               return rc;
             }
 
+#if CONFIG_MTD_CONFIG_INDEX_SIZE > 0
+          nvs_index_update(fs, gc_ate.id, fs->ate_wra);
+#endif
           rc = nvs_flash_ate_wrt(fs, &gc_ate);
           if (rc)
             {
@@ -1071,6 +1196,60 @@ gc_done:
   return 0;
 }
 
+/****************************************************************************
+ * Name: nvs_index_build
+ *
+ * Description:
+ *   Build the index by walking all the ates from the newest to the oldest,
+ *   so that the first one found for an id is the newest.
+ *
+ ****************************************************************************/
+
+#if CONFIG_MTD_CONFIG_INDEX_SIZE > 0
+static int nvs_index_build(FAR struct nvs_fs *fs)
+{
+  FAR struct nvs_index_s *entry;
+  struct nvs_ate ate;
+  uint32_t wlk_addr;
+  uint32_t rd_addr;
+  int rc;
+
+  memset(fs->index, 0, sizeof(fs->index));
+  fs->index_complete = true;
+
+  wlk_addr = fs->ate_wra;
+  do
+    {
+      rd_addr = wlk_addr;
+      rc = nvs_prev_ate(fs, &wlk_addr, &ate);
+      if (rc)
+        {
+          fs->index_complete = false;
+          return rc;
+        }
+
+      if (ate.id != NVS_SPECIAL_ATE_ID && nvs_ate_valid(fs, &ate))
+        {
+          entry = nvs_index_slot(fs, ate.id);
+          if (entry == NULL)
+            {
+              fs->index_complete = false;
+              break;
+            }
+
+          if (entry->id == 0)
+            {
+              entry->id   = ate.id;
+              entry->addr = rd_addr;
+            }
+        }
+    }
+  while (wlk_addr != fs->ate_wra);
+
+  return 0;
+}
+#endif
+
 /****************************************************************************
  * Name: nvs_startup
  ****************************************************************************/
@@ -1436,6 +1615,13 @@ end:
       rc = nvs_add_gc_done_ate(fs);
     }
 
+#if CONFIG_MTD_CONFIG_INDEX_SIZE > 0
+  if (!rc)
+    {
+      rc = nvs_index_build(fs);
+    }
+#endif
+
   finfo("%" PRIu32 " Eraseblocks of %" PRIu32 " bytes\n",
         fs->nblocks, fs->blocksize);
   finfo("alloc wra: %" PRIu32 ", 0x%" PRIx32 "\n",
@@ -1447,84 +1633,125 @@ end:
 }
 
 /****************************************************************************
- * Name: nvs_read_entry
+ * Name: nvs_find_ate
  *
  * Description:
- *   Read An entry from the file system. But expired ones will return
- *   -ENOENT.
+ *   Find the newest valid ate of the key, expired or not.
  *
  * Input Parameters:
  *   fs       - Pointer to file system.
- *   key      - Key of the entry to be read.
+ *   hash_id  - Id of the key.
+ *   key      - Key of the entry to be found.
  *   key_size - Size of key.
- *   data     - Pointer to data buffer.
- *   len      - Number of bytes to be read.
- *   ate_addr - The addr of found ate.
+ *   ate      - Location to return the ate.
+ *   ate_addr - Location to return the address of the ate.
  *
  * Returned Value:
- *   Number of bytes read. On success, it will be equal to the number
- *   of bytes requested to be read. When the return value is larger than the
- *   number of bytes requested to read this indicates not all bytes were
- *   read, and more data is available. On error returns -ERRNO code.
+ *   0 if found, -ENOENT if not, other -ERRNO code on error.
  *
  ****************************************************************************/
 
-static ssize_t nvs_read_entry(FAR struct nvs_fs *fs, FAR const uint8_t *key,
-                size_t key_size, FAR void *data, size_t len,
-                FAR uint32_t *ate_addr)
+static int nvs_find_ate(FAR struct nvs_fs *fs, uint32_t hash_id,
+                        FAR const uint8_t *key, size_t key_size,
+                        FAR struct nvs_ate *ate, FAR uint32_t *ate_addr)
 {
-  int rc;
   uint32_t wlk_addr;
   uint32_t rd_addr;
-  uint32_t hist_addr;
-  struct nvs_ate wlk_ate;
-  uint32_t hash_id;
+  int rc;
+
+#if CONFIG_MTD_CONFIG_INDEX_SIZE > 0
+  rc = nvs_index_find(fs, hash_id, key, key_size, ate, ate_addr);
+  if (rc != -EAGAIN)
+    {
+      return rc;
+    }
+#endif
 
-  hash_id = nvs_fnv_hash(key, key_size) % 0xfffffffd + 1;
   wlk_addr = fs->ate_wra;
-  rd_addr = wlk_addr;
 
   do
     {
       rd_addr = wlk_addr;
-      hist_addr = wlk_addr;
-      rc = nvs_prev_ate(fs, &wlk_addr, &wlk_ate);
+      rc = nvs_prev_ate(fs, &wlk_addr, ate);
       if (rc)
         {
           ferr("Walk to previous ate failed, rc=%d\n", rc);
           return rc;
         }
 
-      if ((wlk_ate.id == hash_id) && (nvs_ate_valid(fs, &wlk_ate)))
+      if ((ate->id == hash_id) && (nvs_ate_valid(fs, ate)))
         {
-          if ((wlk_ate.key_len == key_size)
+          if ((ate->key_len == key_size)
               && (!nvs_flash_block_cmp(fs,
-              (rd_addr & ADDR_BLOCK_MASK) + wlk_ate.offset, key, key_size)))
+              (rd_addr & ADDR_BLOCK_MASK) + ate->offset, key, key_size)))
             {
-              /* It is old or deleted, return -ENOENT */
-
-              if (wlk_ate.expired[0] != fs->erasestate)
-                {
-                  return -ENOENT;
-                }
-              break;
+#if CONFIG_MTD_CONFIG_INDEX_SIZE > 0
+              nvs_index_update(fs, hash_id, rd_addr);
+#endif
+              *ate_addr = rd_addr;
+              return 0;
             }
           else
             {
               fwarn("hash conflict\n");
             }
         }
+    }
+  while (wlk_addr != fs->ate_wra);
 
-      if (wlk_addr == fs->ate_wra)
-        {
-          return -ENOENT;
-        }
+  return -ENOENT;
+}
+
+/****************************************************************************
+ * Name: nvs_read_entry
+ *
+ * Description:
+ *   Read An entry from the file system. But expired ones will return
+ *   -ENOENT.
+ *
+ * Input Parameters:
+ *   fs       - Pointer to file system.
+ *   key      - Key of the entry to be read.
+ *   key_size - Size of key.
+ *   data     - Pointer to data buffer.
+ *   len      - Number of bytes to be read.
+ *   ate_addr - The addr of found ate.
+ *
+ * Returned Value:
+ *   Number of bytes read. On success, it will be equal to the number
+ *   of bytes requested to be read. When the return value is larger than the
+ *   number of bytes requested to read this indicates not all bytes were
+ *   read, and more data is available. On error returns -ERRNO code.
+ *
+ ****************************************************************************/
+
+static ssize_t nvs_read_entry(FAR struct nvs_fs *fs, FAR const uint8_t *key,
+                size_t key_size, FAR void *data, size_t len,
+                FAR uint32_t *ate_addr)
+{
+  int rc;
+  uint32_t rd_addr;
+  uint32_t hist_addr;
+  struct nvs_ate wlk_ate;
+  uint32_t hash_id;
+
+  hash_id = nvs_fnv_hash(key, key_size) % 0xfffffffd + 1;
+  rc = nvs_find_ate(fs, hash_id, key, key_size, &wlk_ate, &hist_addr);
+  if (rc)
+    {
+      return rc;
+    }
+
+  /* It is old or deleted, return -ENOENT */
+
+  if (wlk_ate.expired[0] != fs->erasestate)
+    {
+      return -ENOENT;
     }
-  while (true);
 
   if (data && len)
     {
-      rd_addr &= ADDR_BLOCK_MASK;
+      rd_addr = hist_addr & ADDR_BLOCK_MASK;
       rd_addr += wlk_ate.offset + wlk_ate.key_len;
       rc = nvs_flash_rd(fs, rd_addr, data,
                         MIN(len, wlk_ate.len));
@@ -1567,7 +1794,6 @@ static ssize_t nvs_write(FAR struct nvs_fs *fs,
   size_t data_size;
   size_t key_size;
   struct nvs_ate wlk_ate;
-  uint32_t wlk_addr;
   uint32_t rd_addr;
   uint32_t hist_addr;
   uint16_t required_space = 0;
@@ -1613,38 +1839,15 @@ static ssize_t nvs_write(FAR struct nvs_fs *fs,
 
   /* Find latest entry with same id. */
 
-  wlk_addr = fs->ate_wra;
-
-  while (1)
+  rc = nvs_find_ate(fs, hash_id, key, key_size, &wlk_ate, &hist_addr);
+  if (rc == 0)
     {
-      rd_addr = wlk_addr;
-      hist_addr = wlk_addr;
-      rc = nvs_prev_ate(fs, &wlk_addr, &wlk_ate);
-      if (rc)
-        {
-          return rc;
-        }
-
-      if ((wlk_ate.id == hash_id) && (nvs_ate_valid(fs, &wlk_ate)))
-        {
-          if ((wlk_ate.key_len == key_size)
-              && !nvs_flash_block_cmp(fs,
-                                      (rd_addr & ADDR_BLOCK_MASK) +
-                                      wlk_ate.offset, key, key_size))
-            {
-              prev_found = true;
-              break;
-            }
-          else
-            {
-              fwarn("hash conflict\n");
-            }
-        }
-
-      if (wlk_addr == fs->ate_wra)
-        {
-          break;
-        }
+      prev_found = true;
+      rd_addr = hist_addr;
+    }
+  else if (rc != -ENOENT)
+    {
+      return rc;
     }
 
   if (prev_found)
@@ -1458,6 +1458,35 @@ errout:
   return ret;
 }
 
+/****************************************************************************
+ * Name: smart_cache_touch
+ *
+ * Description: Mark a cache entry as the most recently used one.  When the
+ *              birthdays are about to wrap, they are all halved, which
+ *              keeps their order.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+static void smart_cache_touch(FAR struct smart_struct_s *dev,
+                              uint16_t index)
+{
+  uint16_t x;
+
+  if (dev->cache_nextbirth == 0xffff)
+    {
+      for (x = 0; x < dev->cache_entries; x++)
+        {
+          dev->scache[x].birth >>= 1;
+        }
+
+      dev->cache_nextbirth = 0x8000;
+    }
+
+  dev->scache[index].birth = dev->cache_nextbirth++;
+}
+#endif
+
 /****************************************************************************
  * Name: smart_add_sector_to_cache
  *
@@ -1518,7 +1547,7 @@ static int smart_add_sector_to_cache(FAR struct smart_struct_s *dev,
 
   dev->scache[index].logical = logical;
   dev->scache[index].physical = physical;
-  dev->scache[index].birth = dev->cache_nextbirth++;
+  smart_cache_touch(dev, index);
   dev->cache_lastlog = logical;
   dev->cache_lastphys = physical;
 
@@ -1528,18 +1557,6 @@ static int smart_add_sector_to_cache(FAR struct smart_struct_s *dev,
            logical, physical, index, line);
     }
 
-  /* Test if the birthdays need to be adjusted */
-
-  if (oldest >= CONFIG_MTD_SMART_SECTOR_CACHE_SIZE + 1024)
-    {
-      for (x = 0; x < dev->cache_entries; x++)
-        {
-          dev->scache[x].birth -= 1024;
-        }
-
-      dev->cache_nextbirth -= 1024;
-    }
-
   return index;
 }
 #endif
@@ -1584,9 +1601,12 @@ static uint16_t smart_cache_lookup(FAR struct smart_struct_s *dev,
     {
       if (dev->scache[x].logical == logical)
         {
-          /* Entry found in the cache.  Grab the physical mapping. */
+          /* Entry found in the cache.  Grab the physical mapping and keep
+           * the entry from being the next one replaced.
+           */
 
           physical = dev->scache[x].physical;
+          smart_cache_touch(dev, x);
           break;
         }
     }
@@ -1672,6 +1692,30 @@ static uint16_t smart_cache_lookup(FAR struct smart_struct_s *dev,
                                             __LINE__);
                   break;
                 }
+
+              /* While the cache is not full, keep the other sectors found
+               * on the way too, so that they need no scan later.
+               */
+
+              if (dev->cache_entries < CONFIG_MTD_SMART_SECTOR_CACHE_SIZE)
+                {
+                  for (x = 0; x < dev->cache_entries; x++)
+                    {
+                      if (dev->scache[x].logical == logicalsector)
+                        {
+                          break;
+                        }
+                    }
+
+                  if (x == dev->cache_entries)
+                    {
+                      x = dev->cache_entries++;
+                      dev->scache[x].logical  = logicalsector;
+                      dev->scache[x].physical = block * dev->sectorsperblk +
+                                                sector;
+                      smart_cache_touch(dev, x);
+                    }
+                }
             }
         }
     }
@@ -39,6 +39,7 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/signal.h>
 #include <nuttx/fs/ioctl.h>
@@ -98,6 +99,9 @@
 #define W25_PURDID                 0xab    /* Release PD, Device ID          */
 #define W25_RDMFID                 0x90    /* Read Manufacturer / Device     */
 #define W25_JEDEC_ID               0x9f    /* JEDEC ID read                  */
+#define W25_RDSR2                  0x35    /* Read status register 2         */
+#define W25_EPS                    0x75    /* Erase/program suspend          */
+#define W25_EPR                    0x7a    /* Erase/program resume           */
 
 /* W25 Registers ************************************************************/
 
@@ -185,6 +189,10 @@
                                              /* Bit 6: Reserved */
 #define W25_SR_SRP                 (1 << 7)  /* Bit 7: Status register write protect */
 
+/* Status register 2 bit definitions */
+
+#define W25_SR2_SUS                (1 << 7)  /* Bit 7: Erase/program suspended */
+
 #define W25_DUMMY                  0xa5
 
 /* Chip Geometries **********************************************************/
@@ -239,6 +247,10 @@ struct w25_dev_s
   FAR struct spi_dev_s *spi;         /* Saved SPI interface instance */
   uint16_t              nsectors;    /* Number of erase sectors */
   uint8_t               prev_instr;  /* Previous instruction given to W25 device */
+#ifdef CONFIG_W25_ERASE_SUSPEND
+  off_t                 eaddress;    /* Address of the sector being erased */
+  clock_t               resumed;     /* Time of the last erase resume */
+#endif
 
 #if defined(CONFIG_W25_SECTOR512) && !defined(CONFIG_W25_READONLY)
   uint8_t               flags;       /* Buffered sector flags */
@@ -259,7 +271,13 @@ static inline int w25_readid(FAR struct w25_dev_s *priv);
 #ifndef CONFIG_W25_READONLY
 static void w25_unprotect(FAR struct w25_dev_s *priv);
 #endif
+static uint8_t w25_readstatus(FAR struct w25_dev_s *priv, uint8_t instr);
 static uint8_t w25_waitwritecomplete(FAR struct w25_dev_s *priv);
+#ifdef CONFIG_W25_ERASE_SUSPEND
+static bool w25_erasesuspend(FAR struct w25_dev_s *priv, off_t address,
+                             size_t nbytes);
+static void w25_eraseresume(FAR struct w25_dev_s *priv);
+#endif
 static inline void w25_wren(FAR struct w25_dev_s *priv);
 static inline void w25_wrdi(FAR struct w25_dev_s *priv);
 static bool w25_is_erased(struct w25_dev_s *priv,
@@ -532,6 +550,34 @@ static void w25_unprotect(FAR struct w25_dev_s *priv)
 }
 #endif
 
+/****************************************************************************
+ * Name: w25_readstatus
+ ****************************************************************************/
+
+static uint8_t w25_readstatus(FAR struct w25_dev_s *priv, uint8_t instr)
+{
+  uint8_t status;
+
+  /* Select this FLASH part */
+
+  SPI_SELECT(priv->spi, SPIDEV_FLASH(0), true);
+
+  /* Send the "Read Status Register" command */
+
+  SPI_SEND(priv->spi, instr);
+
+  /* Send a dummy byte to generate the clock needed to shift out the
+   * status
+   */
+
+  status = SPI_SEND(priv->spi, W25_DUMMY);
+
+  /* Deselect the FLASH */
+
+  SPI_SELECT(priv->spi, SPIDEV_FLASH(0), false);
+  return status;
+}
+
 /****************************************************************************
  * Name: w25_waitwritecomplete
  ****************************************************************************/
@@ -549,23 +595,7 @@ static uint8_t w25_waitwritecomplete(struct w25_dev_s *priv)
 
   do
     {
-      /* Select this FLASH part */
-
-      SPI_SELECT(priv->spi, SPIDEV_FLASH(0), true);
-
-      /* Send "Read Status Register (RDSR)" command */
-
-      SPI_SEND(priv->spi, W25_RDSR);
-
-      /* Send a dummy byte to generate the clock needed to shift out the
-       * status
-       */
-
-      status = SPI_SEND(priv->spi, W25_DUMMY);
-
-      /* Deselect the FLASH */
-
-      SPI_SELECT(priv->spi, SPIDEV_FLASH(0), false);
+      status = w25_readstatus(priv, W25_RDSR);
 
       /* Given that writing could take up to few tens of milliseconds, and
        * erasing could take more.  The following short delay in the "busy"
@@ -586,6 +616,87 @@ static uint8_t w25_waitwritecomplete(struct w25_dev_s *priv)
   return status;
 }
 
+/****************************************************************************
+ * Name: w25_erasesuspend
+ *
+ * Description:
+ *   Suspend the sector erase in progress, so that a read outside of that
+ *   sector doesn't wait for the end of the erase.  The suspend takes about
+ *   20us against up to 400ms for the erase.
+ *
+ *   The erase is suspended once per clock tick at most, so that a stream
+ *   of reads can't keep it from completing.
+ *
+ * Returned Value:
+ *   true if the erase is suspended and must be resumed after the read.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_W25_ERASE_SUSPEND
+static bool w25_erasesuspend(FAR struct w25_dev_s *priv, off_t address,
+                             size_t nbytes)
+{
+  clock_t now = clock_systime_ticks();
+  uint8_t status;
+
+  if (priv->prev_instr != W25_SE || priv->resumed == now ||
+      (address < priv->eaddress + W25_SECTOR_SIZE &&
+       address + nbytes > priv->eaddress))
+    {
+      return false;
+    }
+
+  status = w25_readstatus(priv, W25_RDSR);
+  if ((status & W25_SR_BUSY) == 0)
+    {
+      return false;
+    }
+
+  /* Send the "Erase/Program Suspend" instruction */
+
+  SPI_SELECT(priv->spi, SPIDEV_FLASH(0), true);
+  SPI_SEND(priv->spi, W25_EPS);
+  SPI_SELECT(priv->spi, SPIDEV_FLASH(0), false);
+
+  /* BUSY clears once the erase is suspended, which is not worth a sleep */
+
+  do
+    {
+      status = w25_readstatus(priv, W25_RDSR);
+    }
+  while ((status & W25_SR_BUSY) != 0);
+
+  /* The erase may have completed before the suspend was seen */
+
+  status = w25_readstatus(priv, W25_RDSR2);
+  if ((status & W25_SR2_SUS) == 0)
+    {
+      return false;
+    }
+
+  w25_finfo("suspended erase at %08lx\n", (long)priv->eaddress);
+  return true;
+}
+
+/****************************************************************************
+ * Name: w25_eraseresume
+ ****************************************************************************/
+
+static void w25_eraseresume(FAR struct w25_dev_s *priv)
+{
+  /* Send the "Erase/Program Resume" instruction */
+
+  SPI_SELECT(priv->spi, SPIDEV_FLASH(0), true);
+  SPI_SEND(priv->spi, W25_EPR);
+  SPI_SELECT(priv->spi, SPIDEV_FLASH(0), false);
+
+  /* The erase is in progress again */
+
+  priv->prev_instr = W25_SE;
+  priv->resumed    = clock_systime_ticks();
+}
+#endif
+
 /****************************************************************************
  * Name:  w25_wren
  ****************************************************************************/
@@ -708,6 +819,9 @@ static void w25_sectorerase(struct w25_dev_s *priv, off_t sector)
 
   SPI_SEND(priv->spi, W25_SE);
   priv->prev_instr = W25_SE;
+#ifdef CONFIG_W25_ERASE_SUSPEND
+  priv->eaddress   = address;
+#endif
 
   /* Send the sector address high byte first. Only the most significant bits
    * (those corresponding to the sector) have any meaning.
@@ -762,17 +876,28 @@ static void w25_byteread(FAR struct w25_dev_s *priv, FAR uint8_t *buffer,
                            off_t address, size_t nbytes)
 {
   uint8_t status;
+#ifdef CONFIG_W25_ERASE_SUSPEND
+  bool suspended;
+#endif
 
   w25_finfo("address: %08lx nbytes: %d\n", (long)address, (int)nbytes);
 
-  /* Wait for any preceding write or erase operation to complete. */
+#ifdef CONFIG_W25_ERASE_SUSPEND
+  /* Read around a sector erase in progress rather than waiting for it */
 
-  status = w25_waitwritecomplete(priv);
-  DEBUGASSERT((status & (W25_SR_WEL | W25_SR_BP_MASK)) == 0);
+  suspended = w25_erasesuspend(priv, address, nbytes);
+  if (!suspended)
+#endif
+    {
+      /* Wait for any preceding write or erase operation to complete. */
 
-  /* Make sure that writing is disabled */
+      status = w25_waitwritecomplete(priv);
+      DEBUGASSERT((status & (W25_SR_WEL | W25_SR_BP_MASK)) == 0);
 
-  w25_wrdi(priv);
+      /* Make sure that writing is disabled */
+
+      w25_wrdi(priv);
+    }
 
   /* Select this FLASH part */
 
@@ -807,6 +932,13 @@ static void w25_byteread(FAR struct w25_dev_s *priv, FAR uint8_t *buffer,
   /* Deselect the FLASH */
 
   SPI_SELECT(priv->spi, SPIDEV_FLASH(0), false);
+
+#ifdef CONFIG_W25_ERASE_SUSPEND
+  if (suspended)
+    {
+      w25_eraseresume(priv);
+    }
+#endif
 }
 
 /****************************************************************************
@@ -104,6 +104,11 @@
                                  E1000_IVAR_OTHER_EN)
 #endif
 
+/* The RX interrupts masked while the upper half polls the device */
+
+#define E1000_RX_INTERRUPTS     (E1000_IC_RXO    | E1000_IC_RXT0 |  \
+                                 E1000_IC_RXDMT0 | E1000_IC_RXQ0)
+
 /* NIC specific Flags */
 
 #define E1000_RESET_BROKEN      (1 << 0)
@@ -190,6 +195,9 @@ static int e1000_transmit(FAR struct netdev_lowerhalf_s *dev,
 
 static FAR netpkt_t *e1000_receive(FAR struct netdev_lowerhalf_s *dev);
 static void e1000_txdone(FAR struct netdev_lowerhalf_s *dev);
+#ifdef CONFIG_NETDEV_NAPI
+static void e1000_rxirq(FAR struct netdev_lowerhalf_s *dev, bool enable);
+#endif
 
 static void e1000_msi_interrupt(FAR struct e1000_driver_s *priv);
 #ifdef CONFIG_PCI_MSIX
@@ -297,6 +305,9 @@ static const struct netdev_ops_s g_e1000_ops =
 #if CONFIG_NETDEV_WORK_THREAD_POLLING_PERIOD > 0
   .reclaim  = e1000_txdone,
 #endif
+#ifdef CONFIG_NETDEV_NAPI
+  .rxirq    = e1000_rxirq,
+#endif
 };
 
 /*****************************************************************************
@@ -494,6 +505,10 @@ static int e1000_transmit(FAR struct netdev_lowerhalf_s *dev,
   uint64_t                   pa   = 0;
   int                        desc = priv->tx_now;
   size_t                     len  = netpkt_getdatalen(dev, pkt);
+#ifdef CONFIG_NETDEV_CHKSUM_OFFLOAD
+  unsigned int               start;
+  unsigned int               offset;
+#endif
 
   ninfo("transmit\n");
 
@@ -524,6 +539,17 @@ static int e1000_transmit(FAR struct netdev_lowerhalf_s *dev,
   priv->tx[desc].cso    = 0;
   priv->tx[desc].status = 0;
 
+#ifdef CONFIG_NETDEV_CHKSUM_OFFLOAD
+  /* Let the hardware insert the TCP/UDP checksum */
+
+  if (netpkt_chksum_prepare(dev, pkt, &start, &offset) == OK)
+    {
+      priv->tx[desc].css  = start;
+      priv->tx[desc].cso  = start + offset;
+      priv->tx[desc].cmd |= E1000_TDESC_CMD_IC;
+    }
+#endif
+
   SP_DSB();
 
   /* Update TX tail */
@@ -588,6 +614,17 @@ static FAR netpkt_t *e1000_receive(FAR struct netdev_lowerhalf_s *dev)
 
   netpkt_setdatalen(dev, pkt, rx->len);
 
+#ifdef CONFIG_NETDEV_CHKSUM_OFFLOAD
+  /* TCPCS only says that the checksum was calculated, the result is in
+   * the error bits.  A packet with a bad checksum is left to the stack to
+   * check again and drop.
+   */
+
+  dev->netdev.d_rxcsum = (rx->status & E1000_RDESC_STATUS_TCPCS) != 0 &&
+                         (rx->errors & (E1000_RDESC_ERRORS_TCPE |
+                                        E1000_RDESC_ERRORS_IPE)) == 0;
+#endif
+
   /* Store new packet in RX descriptor ring */
 
   rx->addr   = up_addrenv_va_to_pa(
@@ -658,6 +695,31 @@ static void e1000_txdone(FAR struct netdev_lowerhalf_s *dev)
   netdev_lower_txdone(dev);
 }
 
+/*****************************************************************************
+ * Name: e1000_rxirq
+ *
+ * Description:
+ *   Mask or unmask the RX interrupts while the upper half polls the device
+ *
+ * Input Parameters:
+ *   dev    - Reference to the NuttX driver state structure
+ *   enable - true: unmask the RX interrupts, false: mask them
+ *
+ * Returned Value:
+ *   None
+ *
+ *****************************************************************************/
+
+#ifdef CONFIG_NETDEV_NAPI
+static void e1000_rxirq(FAR struct netdev_lowerhalf_s *dev, bool enable)
+{
+  FAR struct e1000_driver_s *priv = (FAR struct e1000_driver_s *)dev;
+
+  e1000_putreg_mem(priv, enable ? E1000_IMS : E1000_IMC,
+                   priv->irqs & E1000_RX_INTERRUPTS);
+}
+#endif
+
 /*****************************************************************************
  * Name: e1000_msi_interupt
  *
@@ -1217,6 +1279,14 @@ static void e1000_enable(FAR struct e1000_driver_s *priv)
 #endif
   e1000_putreg_mem(priv, E1000_RCTL, regval);
 
+#ifdef CONFIG_NETDEV_CHKSUM_OFFLOAD
+  /* Enable RX checksum offload */
+
+  regval = e1000_getreg_mem(priv, E1000_RXCSUM);
+  regval |= E1000_RXCSUM_IPOFL | E1000_RXCSUM_TUOFL;
+  e1000_putreg_mem(priv, E1000_RXCSUM, regval);
+#endif
+
   /* REVISIT: Set granuality to Descriptors */
 
   regval = e1000_getreg_mem(priv, E1000_RXDCTL);
@@ -1424,6 +1494,10 @@ static int e1000_probe(FAR struct pci_device_s *dev)
   netdev->quota[NETPKT_RX] = E1000_RX_QUOTA;
   netdev->ops = &g_e1000_ops;
 
+#ifdef CONFIG_NETDEV_CHKSUM_OFFLOAD
+  netdev->netdev.d_features = NETDEV_F_RXCSUM | NETDEV_F_TXCSUM;
+#endif
+
   return netdev_lower_register(netdev, NET_LL_ETHERNET);
 
 errout:
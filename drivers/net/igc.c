@@ -434,6 +434,10 @@ static int igc_transmit(FAR struct netdev_lowerhalf_s *dev,
   uint64_t                 pa   = 0;
   int                      desc = priv->tx_now;
   size_t                   len  = netpkt_getdatalen(dev, pkt);
+#ifdef CONFIG_NETDEV_CHKSUM_OFFLOAD
+  unsigned int             start;
+  unsigned int             offset;
+#endif
 
   ninfo("transmit\n");
 
@@ -464,6 +468,17 @@ static int igc_transmit(FAR struct netdev_lowerhalf_s *dev,
   priv->tx[desc].cso    = 0;
   priv->tx[desc].status = 0;
 
+#ifdef CONFIG_NETDEV_CHKSUM_OFFLOAD
+  /* Let the hardware insert the TCP/UDP checksum */
+
+  if (netpkt_chksum_prepare(dev, pkt, &start, &offset) == OK)
+    {
+      priv->tx[desc].css  = start;
+      priv->tx[desc].cso  = start + offset;
+      priv->tx[desc].cmd |= IGC_TDESC_CMD_IC;
+    }
+#endif
+
   SP_DSB();
 
   /* Update TX tail */
@@ -530,6 +545,12 @@ static FAR netpkt_t * igc_receive(FAR struct netdev_lowerhalf_s *dev)
 
   netpkt_setdatalen(dev, pkt, rx->len);
 
+#ifdef CONFIG_NETDEV_CHKSUM_OFFLOAD
+  /* Packets with a bad checksum are dropped below as RX errors */
+
+  dev->netdev.d_rxcsum = (rx->status & IGC_RDESC_STATUS_L4CS) != 0;
+#endif
+
   /* Store new packet in RX descriptor ring */
 
   rx->addr   = up_addrenv_va_to_pa(
@@ -1085,6 +1106,14 @@ static void igc_enable(FAR struct igc_driver_s *priv)
 #endif
   igc_putreg_mem(priv, IGC_RCTL, regval);
 
+#ifdef CONFIG_NETDEV_CHKSUM_OFFLOAD
+  /* Enable RX checksum offload */
+
+  regval = igc_getreg_mem(priv, IGC_RXCSUM);
+  regval |= IGC_RXCSUM_IPOFL | IGC_RXCSUM_TUOFL;
+  igc_putreg_mem(priv, IGC_RXCSUM, regval);
+#endif
+
   /* Enable TX queeu */
 
   regval = igc_getreg_mem(priv, IGC_TXDCTL0);
@@ -1306,6 +1335,10 @@ static int igc_probe(FAR struct pci_device_s *dev)
   netdev->quota[NETPKT_RX] = IGC_RX_QUOTA;
   netdev->ops = &g_igc_ops;
 
+#ifdef CONFIG_NETDEV_CHKSUM_OFFLOAD
+  netdev->netdev.d_features = NETDEV_F_RXCSUM | NETDEV_F_TXCSUM;
+#endif
+
   return netdev_lower_register(netdev, NET_LL_ETHERNET);
 
 errout:
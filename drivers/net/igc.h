@@ -357,6 +357,11 @@
 #define IGC_RCTL_SECRC            (1 << 26)  /* Bit 26: Strip Ethernet CRC from incoming packet */
                                              /* Bits 27-31: Reserved */
 
+/* Receive Checksum Control */
+
+#define IGC_RXCSUM_IPOFL          (1 << 8)  /* Bit 8: IP Checksum Off-load Enable */
+#define IGC_RXCSUM_TUOFL          (1 << 9)  /* Bit 9: TCP/UDP Checksum Off-load Enable */
+
 /* Receive Descriptor Control */
 
 #define IGC_RXDCTL_PTHRESH_SHIFT  (0)       /* Bits 0-4: Prefetch Threshold */
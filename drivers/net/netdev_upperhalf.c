@@ -26,6 +26,7 @@
 
 #include <debug.h>
 #include <errno.h>
+#include <limits.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <string.h>
@@ -34,9 +35,12 @@
 #include <nuttx/kthread.h>
 #include <nuttx/mm/iob.h>
 #include <nuttx/net/can.h>
+#include <nuttx/net/ip.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev_lowerhalf.h>
 #include <nuttx/net/pkt.h>
+#include <nuttx/net/tcp.h>
+#include <nuttx/net/udp.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/spinlock.h>
 
@@ -48,6 +52,14 @@
 
 #define NETDEV_THREAD_NAME_FMT "netdev-%s"
 
+/* The maximum number of packets received in one poll of a device */
+
+#ifdef CONFIG_NETDEV_NAPI
+#  define NETDEV_RX_BUDGET CONFIG_NETDEV_NAPI_BUDGET
+#else
+#  define NETDEV_RX_BUDGET INT_MAX
+#endif
+
 #ifdef CONFIG_NETDEV_HPWORK_THREAD
 #  define NETDEV_WORK HPWORK
 #else
@@ -85,8 +97,37 @@ struct netdev_upperhalf_s
 #if CONFIG_IOB_NCHAINS > 0
   struct iob_queue_s txq;
 #endif
+
+  /* The received TCP packet that the following in-order segments of the
+   * same connection are merged into.  Only held during one RX poll.
+   */
+
+#ifdef CONFIG_NETDEV_GRO
+  FAR netpkt_t *gro_pkt;
+  uint16_t gro_mss;             /* Payload length of the first segment */
+  uint8_t gro_hdrlen;           /* Length of the IPv4 and TCP headers */
+  uint8_t gro_segs;             /* Number of segments merged so far */
+#endif
+
+  /* The hook which sees the received packets first */
+
+#ifdef CONFIG_NETDEV_RXHOOK
+  netdev_rxhook_t rxhook;
+  FAR void *rxhook_arg;
+#endif
 };
 
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static inline void netdev_upper_queue_work(FAR struct net_driver_s *dev);
+static int netdev_upper_txavail(FAR struct net_driver_s *dev);
+#ifdef CONFIG_NETDEV_WORK_THREAD
+static void netdev_upper_queue_cpu(FAR struct netdev_upperhalf_s *upper,
+                                   int cpu);
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -247,17 +288,115 @@ static inline bool netdev_upper_can_tx(FAR struct netdev_upperhalf_s *upper)
 }
 
 /****************************************************************************
- * Name: netdev_upper_txpoll
+ * Name: netdev_upper_txqueue
  *
  * Description:
- *   The transmitter is available, check if the network has any outgoing
- *   packets ready to send.  This is a callback from devif_poll().
- *   devif_poll() may be called:
+ *   Select the TX queue of the packet in the device buffer by the hash of
+ *   its addresses, protocol and ports, so that the packets of one flow are
+ *   not reordered between the queues.  Packets which are not IP go to
+ *   queue 0, IP fragments are hashed by their addresses only.
  *
- *   1. When the preceding TX packet send is complete
- *   2. When the preceding TX packet send times out and the interface is
- *      reset
- *   3. During normal TX polling
+ * Input Parameters:
+ *   dev     - Reference to the NuttX driver state structure
+ *   nqueues - The number of TX queues of the device
+ *
+ * Returned Value:
+ *   The TX queue, from 0 to nqueues - 1.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+static int netdev_upper_txqueue(FAR struct net_driver_s *dev, int nqueues)
+{
+  FAR uint8_t *ip = IPBUF(0);
+  unsigned int iphdrlen;
+  uint32_t hash = 0;
+  uint8_t proto;
+
+#ifdef CONFIG_NET_ETHERNET
+  if (dev->d_lltype == NET_LL_ETHERNET)
+    {
+      FAR struct eth_hdr_s *eth = (FAR struct eth_hdr_s *)NETLLBUF;
+
+      if (eth->type != HTONS(ETHTYPE_IP) && eth->type != HTONS(ETHTYPE_IP6))
+        {
+          return 0;
+        }
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv4
+  if ((ip[0] & IP_VERSION_MASK) == IPv4_VERSION)
+    {
+      FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)ip;
+
+      hash     = net_ip4addr_conv32(ipv4->srcipaddr) ^
+                 net_ip4addr_conv32(ipv4->destipaddr);
+      iphdrlen = (ipv4->vhl & IPv4_HLMASK) << 2;
+      proto    = ipv4->proto;
+
+      /* Only the first fragment has the ports, leave them out of the hash
+       * of all the fragments.
+       */
+
+      if ((ipv4->ipoffset[0] & 0x3f) != 0 || ipv4->ipoffset[1] != 0)
+        {
+          proto = 0;
+        }
+    }
+  else
+#endif
+#ifdef CONFIG_NET_IPv6
+  if ((ip[0] & IP_VERSION_MASK) == IPv6_VERSION)
+    {
+      FAR struct ipv6_hdr_s *ipv6 = (FAR struct ipv6_hdr_s *)ip;
+      int i;
+
+      for (i = 0; i < 8; i += 2)
+        {
+          hash ^= ((uint32_t)ipv6->srcipaddr[i] << 16 |
+                   ipv6->srcipaddr[i + 1]) ^
+                  ((uint32_t)ipv6->destipaddr[i] << 16 |
+                   ipv6->destipaddr[i + 1]);
+        }
+
+      iphdrlen = IPv6_HDRLEN;
+      proto    = ipv6->proto;
+    }
+  else
+#endif
+    {
+      return 0;
+    }
+
+  hash ^= proto;
+  if (proto == IP_PROTO_TCP || proto == IP_PROTO_UDP)
+    {
+      /* The source and destination ports are the first 4 bytes of both */
+
+      hash ^= (uint32_t)ip[iphdrlen] << 24 |
+              (uint32_t)ip[iphdrlen + 1] << 16 |
+              (uint32_t)ip[iphdrlen + 2] << 8 | ip[iphdrlen + 3];
+    }
+
+  /* Mix the bits so that the low ones depend on all of them */
+
+  hash ^= hash >> 16;
+  hash *= 0x45d9f3bu;
+  hash ^= hash >> 16;
+
+  return hash % nqueues;
+}
+#endif
+
+/****************************************************************************
+ * Name: netdev_upper_xmit
+ *
+ * Description:
+ *   Hand the packet in the device buffer to the lower half.
  *
  * Input Parameters:
  *   dev - Reference to the NuttX driver state structure
@@ -271,17 +410,29 @@ static inline bool netdev_upper_can_tx(FAR struct netdev_upperhalf_s *upper)
  *
  ****************************************************************************/
 
-static int netdev_upper_txpoll(FAR struct net_driver_s *dev)
+static int netdev_upper_xmit(FAR struct net_driver_s *dev)
 {
   FAR struct netdev_upperhalf_s *upper = dev->d_private;
   FAR struct netdev_lowerhalf_s *lower = upper->lower;
   FAR netpkt_t                  *pkt;
   int                            ret;
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  int                            queue = 0;
+#endif
 
   DEBUGASSERT(dev->d_len > 0);
 
   NETDEV_TXPACKETS(dev);
 
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  /* Pick the queue while the headers are still in the device buffer */
+
+  if (lower->txqueues > 1)
+    {
+      queue = netdev_upper_txqueue(dev, lower->txqueues);
+    }
+#endif
+
 #ifdef CONFIG_NET_PKT
   /* When packet sockets are enabled, feed the tx frame into it */
 
@@ -290,11 +441,18 @@ static int netdev_upper_txpoll(FAR struct net_driver_s *dev)
 
   pkt = netpkt_get(dev, NETPKT_TX);
 
-  if (netpkt_getdatalen(lower, pkt) > NETDEV_PKTSIZE(dev))
+  if (netpkt_getdatalen(lower, pkt) > NETDEV_PKTSIZE(dev) &&
+      NETDEV_GSO_SIZE(dev) == 0)
     {
       nerr("ERROR: Packet too long to send!\n");
       ret = -EMSGSIZE;
     }
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  else if (lower->txqueues > 1)
+    {
+      ret = lower->ops->transmitq(lower, pkt, queue);
+    }
+#endif
   else
     {
       ret = lower->ops->transmit(lower, pkt);
@@ -314,6 +472,218 @@ static int netdev_upper_txpoll(FAR struct net_driver_s *dev)
   return NETDEV_TX_CONTINUE;
 }
 
+/****************************************************************************
+ * Name: netdev_upper_gso
+ *
+ * Description:
+ *   Cut the TCP packet in the device buffer into segments of at most 'mss'
+ *   bytes of data and hand them to the lower half one by one.  Each
+ *   segment gets a copy of the headers with the length, IP ID, sequence
+ *   number, flags and checksums fixed up.
+ *
+ * Input Parameters:
+ *   dev - Reference to the NuttX driver state structure
+ *   mss - The segment size
+ *
+ * Returned Value:
+ *   Negated errno value - Error number that occurs.
+ *   NETDEV_TX_CONTINUE  - Driver can send more, continue the poll.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_GSO
+static int netdev_upper_gso(FAR struct net_driver_s *dev, uint16_t mss)
+{
+  FAR netpkt_t *gso = dev->d_iob;
+  FAR uint8_t *hdr = IOB_DATA(gso);
+  FAR struct tcp_hdr_s *tcp;
+  unsigned int llhdrlen = NET_LL_HDRLEN(dev);
+  unsigned int iphdrlen;
+  unsigned int hdrlen;
+  unsigned int offset;
+  unsigned int total;
+  uint32_t seqno;
+  uint16_t ipid = 0;
+  uint8_t flags;
+  bool ipv4 = false;
+  int ret = NETDEV_TX_CONTINUE;
+
+#ifdef CONFIG_NET_IPv4
+  if ((hdr[0] & IP_VERSION_MASK) == IPv4_VERSION)
+    {
+      FAR struct ipv4_hdr_s *ip = (FAR struct ipv4_hdr_s *)hdr;
+
+      ipv4     = true;
+      iphdrlen = (ip->vhl & IPv4_HLMASK) << 2;
+      ipid     = (ip->ipid[0] << 8) | ip->ipid[1];
+    }
+  else
+#endif
+    {
+      iphdrlen = IPv6_HDRLEN;
+    }
+
+  tcp    = (FAR struct tcp_hdr_s *)(hdr + iphdrlen);
+  hdrlen = iphdrlen + ((tcp->tcpoffset >> 4) << 2);
+  total  = gso->io_pktlen;
+  flags  = tcp->flags;
+  seqno  = ((uint32_t)tcp->seqno[0] << 24) |
+           ((uint32_t)tcp->seqno[1] << 16) |
+           ((uint32_t)tcp->seqno[2] << 8) | tcp->seqno[3];
+
+  /* The stack builds all headers in the first buffer */
+
+  DEBUGASSERT(gso->io_len >= hdrlen);
+  netdev_iob_clear(dev);
+
+  for (offset = hdrlen; offset < total; offset += mss)
+    {
+      unsigned int seglen = total - offset < mss ? total - offset : mss;
+      FAR netpkt_t *seg;
+
+      /* Copy the link layer, IP and TCP headers, then the data */
+
+      seg = iob_tryalloc(false);
+      if (seg != NULL)
+        {
+          iob_reserve(seg, CONFIG_NET_LL_GUARDSIZE);
+          if (iob_trycopyin(seg, hdr - llhdrlen, llhdrlen + hdrlen,
+                            -(int)llhdrlen, false) < 0 ||
+              iob_clone_partial(gso, seglen, offset, seg, hdrlen,
+                                false, false) < 0)
+            {
+              iob_free_chain(seg);
+              seg = NULL;
+            }
+        }
+
+      if (seg == NULL)
+        {
+          /* TCP will retransmit what is missing */
+
+          nwarn("WARNING: No IOB for GSO segment, dropping the rest\n");
+          NETDEV_TXERRORS(dev);
+          ret = -ENOMEM;
+          break;
+        }
+
+      dev->d_iob = seg;
+      dev->d_len = llhdrlen + hdrlen + seglen;
+
+      /* Only the last segment keeps FIN and PSH */
+
+      tcp = (FAR struct tcp_hdr_s *)IPBUF(iphdrlen);
+      if (offset + seglen < total)
+        {
+          tcp->flags = flags & ~(TCP_FIN | TCP_PSH);
+        }
+
+      tcp->seqno[0]  = seqno >> 24;
+      tcp->seqno[1]  = seqno >> 16;
+      tcp->seqno[2]  = seqno >> 8;
+      tcp->seqno[3]  = seqno;
+      tcp->tcpchksum = 0;
+      seqno         += seglen;
+
+#ifdef CONFIG_NET_IPv4
+      if (ipv4)
+        {
+          FAR struct ipv4_hdr_s *ip = IPv4BUF;
+
+          ip->len[0]   = (hdrlen + seglen) >> 8;
+          ip->len[1]   = (hdrlen + seglen) & 0xff;
+          ip->ipid[0]  = ipid >> 8;
+          ip->ipid[1]  = ipid & 0xff;
+          ip->ipchksum = 0;
+          ip->ipchksum = ~ipv4_chksum(ip);
+          ipid++;
+
+          if (!NETDEV_TXCSUM(dev))
+            {
+              tcp->tcpchksum = ~ipv4_upperlayer_chksum(dev, IP_PROTO_TCP);
+            }
+        }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+      if (!ipv4)
+        {
+          FAR struct ipv6_hdr_s *ip = IPv6BUF;
+
+          ip->len[0] = (hdrlen - IPv6_HDRLEN + seglen) >> 8;
+          ip->len[1] = (hdrlen - IPv6_HDRLEN + seglen) & 0xff;
+
+          if (!NETDEV_TXCSUM(dev))
+            {
+              tcp->tcpchksum = ~ipv6_upperlayer_chksum(dev, IP_PROTO_TCP,
+                                                       IPv6_HDRLEN);
+            }
+        }
+#endif
+
+      ret = netdev_upper_xmit(dev);
+      if (ret != NETDEV_TX_CONTINUE)
+        {
+          netdev_iob_release(dev);
+          break;
+        }
+    }
+
+  iob_free_chain(gso);
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: netdev_upper_txpoll
+ *
+ * Description:
+ *   The transmitter is available, check if the network has any outgoing
+ *   packets ready to send.  This is a callback from devif_poll().
+ *   devif_poll() may be called:
+ *
+ *   1. When the preceding TX packet send is complete
+ *   2. When the preceding TX packet send times out and the interface is
+ *      reset
+ *   3. During normal TX polling
+ *
+ * Input Parameters:
+ *   dev - Reference to the NuttX driver state structure
+ *
+ * Returned Value:
+ *   Negated errno value - Error number that occurs.
+ *   NETDEV_TX_CONTINUE  - Driver can send more, continue the poll.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static int netdev_upper_txpoll(FAR struct net_driver_s *dev)
+{
+#ifdef CONFIG_NETDEV_GSO
+  uint16_t mss = dev->d_gso_size;
+  int ret;
+
+  /* Segment the super packets of TCP ourselves, unless the hardware can */
+
+  if (mss > 0 && !NETDEV_TSO(dev))
+    {
+      dev->d_gso_size = 0;
+      return netdev_upper_gso(dev, mss);
+    }
+
+  ret = netdev_upper_xmit(dev);
+  dev->d_gso_size = 0;
+  return ret;
+#else
+  return netdev_upper_xmit(dev);
+#endif
+}
+
 /****************************************************************************
  * Name: netdev_upper_tx
  *
@@ -335,9 +705,14 @@ static int netdev_upper_txpoll(FAR struct net_driver_s *dev)
 
 static int netdev_upper_tx(FAR struct net_driver_s *dev)
 {
-#if CONFIG_IOB_NCHAINS > 0
+#if CONFIG_IOB_NCHAINS > 0 || defined(CONFIG_NETDEV_GSO)
   FAR struct netdev_upperhalf_s *upper = dev->d_private;
+#endif
+#ifdef CONFIG_NETDEV_GSO
+  int ret;
+#endif
 
+#if CONFIG_IOB_NCHAINS > 0
   if (!IOB_QEMPTY(&upper->txq))
     {
       /* Put the packet back to the device */
@@ -349,7 +724,27 @@ static int netdev_upper_tx(FAR struct net_driver_s *dev)
 
   /* No more TX packets in queue, poll the net stack to get more packets */
 
+#ifdef CONFIG_NETDEV_GSO
+  /* Let TCP send as many segments at once as the lower half has room
+   * for.
+   */
+
+  if (dev->d_lltype == NET_LL_ETHERNET)
+    {
+      int quota = netdev_lower_quota_load(upper->lower, NETPKT_TX);
+
+      dev->d_gso_maxsegs = quota < CONFIG_NETDEV_GSO_MAXSEGS ?
+                           quota : CONFIG_NETDEV_GSO_MAXSEGS;
+    }
+
+  ret = devif_poll(dev, netdev_upper_txpoll);
+
+  dev->d_gso_maxsegs = 0;
+  dev->d_gso_size    = 0;
+  return ret;
+#else
   return devif_poll(dev, netdev_upper_txpoll);
+#endif
 }
 
 /****************************************************************************
@@ -377,6 +772,15 @@ static void netdev_upper_txavail_work(FAR struct netdev_upperhalf_s *upper)
       DEBUGASSERT(dev->d_buf == NULL); /* Make sure: IOB only. */
       while (netdev_upper_can_tx(upper) &&
              netdev_upper_tx(dev) == NETDEV_TX_CONTINUE);
+
+      /* The packets queued directly from the RX path are sent before
+       * this, so this ends the TX batch of the poll.
+       */
+
+      if (upper->lower->ops->txflush != NULL)
+        {
+          upper->lower->ops->txflush(upper->lower);
+        }
     }
 }
 
@@ -570,14 +974,391 @@ static void ip_input(FAR struct net_driver_s *dev)
    * the field d_len will set to a value > 0.
    */
 
-  if (dev->d_len > 0)
+  if (dev->d_len > 0)
+    {
+      /* And queue the packet for sending later.
+       * Note: RX is tried before TX, so we don't need to call txavail here.
+       */
+
+      netdev_upper_queue_tx(dev);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: netdev_upper_input
+ *
+ * Description:
+ *   Pass the packet in dev->d_iob to the network stack.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static void netdev_upper_input(FAR struct net_driver_s *dev)
+{
+#ifdef CONFIG_NET_PKT
+  /* When packet sockets are enabled, feed the frame into the tap */
+
+  pkt_input(dev);
+#endif
+
+  switch (dev->d_lltype)
+    {
+#ifdef CONFIG_NET_LOOPBACK
+    case NET_LL_LOOPBACK:
+#endif
+#ifdef CONFIG_NET_ETHERNET
+    case NET_LL_ETHERNET:
+#endif
+#ifdef CONFIG_DRIVERS_IEEE80211
+    case NET_LL_IEEE80211:
+#endif
+#if defined(CONFIG_NET_LOOPBACK) || defined(CONFIG_NET_ETHERNET) || \
+    defined(CONFIG_DRIVERS_IEEE80211)
+      eth_input(dev);
+      break;
+#endif
+#ifdef CONFIG_NET_MBIM
+    case NET_LL_MBIM:
+      ip_input(dev);
+      break;
+#endif
+#ifdef CONFIG_NET_CAN
+    case NET_LL_CAN:
+      ninfo("CAN frame");
+      can_input(dev);
+      break;
+#endif
+    default:
+      nerr("Unknown link type %d\n", dev->d_lltype);
+      break;
+    }
+}
+
+#ifdef CONFIG_NETDEV_GRO
+/****************************************************************************
+ * Name: netdev_upper_gro_parse
+ *
+ * Description:
+ *   Check if the packet in dev->d_iob is an in-order data segment of an
+ *   IPv4 TCP stream for this host, which is all that GRO will merge.  The
+ *   checksums are verified here because they cannot be checked any more
+ *   once the segments are merged.
+ *
+ * Input Parameters:
+ *   dev    - Reference to the NuttX network driver state structure
+ *   paylen - Location to return the TCP payload length
+ *
+ * Returned Value:
+ *   The length of the IPv4 and TCP headers, zero if the packet cannot be
+ *   merged.
+ *
+ ****************************************************************************/
+
+static unsigned int netdev_upper_gro_parse(FAR struct net_driver_s *dev,
+                                           FAR unsigned int *paylen)
+{
+  FAR struct eth_hdr_s *eth = (FAR struct eth_hdr_s *)NETLLBUF;
+  FAR struct ipv4_hdr_s *ip = IPv4BUF;
+  FAR struct tcp_hdr_s *tcp;
+  unsigned int hdrlen;
+  unsigned int iplen;
+
+  if (dev->d_lltype != NET_LL_ETHERNET ||
+      eth->type != HTONS(ETHTYPE_IP) ||
+      dev->d_iob->io_len < IPv4_HDRLEN + TCP_HDRLEN ||
+      ip->vhl != 0x45 || ip->proto != IP_PROTO_TCP ||
+      (ip->ipoffset[0] & 0x3f) != 0 || ip->ipoffset[1] != 0 ||
+      !net_ipv4addr_cmp(net_ip4addr_conv32(ip->destipaddr),
+                        dev->d_ipaddr))
+    {
+      return 0;
+    }
+
+  tcp    = (FAR struct tcp_hdr_s *)IPBUF(IPv4_HDRLEN);
+  hdrlen = IPv4_HDRLEN + ((tcp->tcpoffset >> 4) << 2);
+  iplen  = (ip->len[0] << 8) | ip->len[1];
+
+  if (hdrlen < IPv4_HDRLEN + TCP_HDRLEN || hdrlen > dev->d_iob->io_len ||
+      iplen != dev->d_iob->io_pktlen || iplen <= hdrlen ||
+      (tcp->flags & ~TCP_PSH) != TCP_ACK)
+    {
+      return 0;
+    }
+
+  if (ipv4_chksum(ip) != 0xffff ||
+      (!NETDEV_RXCSUM_VALID(dev) &&
+       ipv4_upperlayer_chksum(dev, IP_PROTO_TCP) != 0xffff))
+    {
+      /* Let the stack count and drop it */
+
+      return 0;
+    }
+
+  *paylen = iplen - hdrlen;
+  return hdrlen;
+}
+
+/****************************************************************************
+ * Name: netdev_upper_gro_match
+ *
+ * Description:
+ *   Check if the segment 'pkt' directly follows the held packet on the
+ *   same connection.
+ *
+ ****************************************************************************/
+
+static bool netdev_upper_gro_match(FAR struct netdev_upperhalf_s *upper,
+                                   FAR netpkt_t *pkt, unsigned int hdrlen,
+                                   unsigned int paylen)
+{
+  FAR netpkt_t *held = upper->gro_pkt;
+  FAR struct ipv4_hdr_s *hip = (FAR struct ipv4_hdr_s *)IOB_DATA(held);
+  FAR struct ipv4_hdr_s *ip = (FAR struct ipv4_hdr_s *)IOB_DATA(pkt);
+  FAR struct tcp_hdr_s *htcp;
+  FAR struct tcp_hdr_s *tcp;
+  uint32_t hseq;
+  uint32_t seq;
+
+  if (hdrlen != upper->gro_hdrlen || paylen > upper->gro_mss ||
+      held->io_pktlen + paylen > UINT16_MAX ||
+      memcmp(hip->srcipaddr, ip->srcipaddr, sizeof(ip->srcipaddr)) != 0 ||
+      memcmp(hip->destipaddr, ip->destipaddr, sizeof(ip->destipaddr)) != 0)
+    {
+      return false;
+    }
+
+  htcp = (FAR struct tcp_hdr_s *)((FAR uint8_t *)hip + IPv4_HDRLEN);
+  tcp  = (FAR struct tcp_hdr_s *)((FAR uint8_t *)ip + IPv4_HDRLEN);
+
+  /* Ports, acknowledgment number and options must all be the same */
+
+  if (htcp->srcport != tcp->srcport || htcp->destport != tcp->destport ||
+      memcmp(htcp->ackno, tcp->ackno, sizeof(tcp->ackno)) != 0 ||
+      memcmp(htcp->optdata, tcp->optdata,
+             hdrlen - IPv4_HDRLEN - TCP_HDRLEN) != 0)
+    {
+      return false;
+    }
+
+  hseq = ((uint32_t)htcp->seqno[0] << 24) |
+         ((uint32_t)htcp->seqno[1] << 16) |
+         ((uint32_t)htcp->seqno[2] << 8) | htcp->seqno[3];
+  seq  = ((uint32_t)tcp->seqno[0] << 24) |
+         ((uint32_t)tcp->seqno[1] << 16) |
+         ((uint32_t)tcp->seqno[2] << 8) | tcp->seqno[3];
+
+  return seq == hseq + held->io_pktlen - hdrlen;
+}
+
+/****************************************************************************
+ * Name: netdev_upper_gro_flush
+ *
+ * Description:
+ *   Pass the held packet (if any) to the network stack.  The packet that
+ *   is currently in dev->d_iob is preserved.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static void netdev_upper_gro_flush(FAR struct netdev_upperhalf_s *upper)
+{
+  FAR struct net_driver_s *dev = &upper->lower->netdev;
+  FAR netpkt_t *held = upper->gro_pkt;
+  FAR struct ipv4_hdr_s *ip;
+  FAR netpkt_t *pkt;
+  uint16_t len;
+  bool rxcsum;
+
+  if (held == NULL)
+    {
+      return;
+    }
+
+  upper->gro_pkt = NULL;
+
+  if (upper->gro_segs > 1)
+    {
+      ip           = (FAR struct ipv4_hdr_s *)IOB_DATA(held);
+      ip->len[0]   = held->io_pktlen >> 8;
+      ip->len[1]   = held->io_pktlen & 0xff;
+      ip->ipchksum = 0;
+      ip->ipchksum = ~ipv4_chksum(ip);
+    }
+
+  /* All segments were verified when they were merged, and the TCP
+   * checksum does not cover the merged packet.
+   */
+
+  pkt           = dev->d_iob;
+  len           = dev->d_len;
+  rxcsum        = dev->d_rxcsum;
+
+  dev->d_iob    = held;
+  dev->d_len    = netpkt_getdatalen(upper->lower, held);
+  dev->d_rxcsum = true;
+
+  netdev_upper_input(dev);
+
+  netdev_iob_release(dev);
+  dev->d_iob    = pkt;
+  dev->d_len    = len;
+  dev->d_rxcsum = rxcsum;
+}
+
+/****************************************************************************
+ * Name: netdev_upper_gro
+ *
+ * Description:
+ *   Try to merge the packet in dev->d_iob with the segments received
+ *   before it.
+ *
+ * Returned Value:
+ *   True if the packet was taken over by GRO, false if it should be passed
+ *   to the network stack as it is.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static bool netdev_upper_gro(FAR struct netdev_upperhalf_s *upper)
+{
+  FAR struct net_driver_s *dev = &upper->lower->netdev;
+  FAR netpkt_t *pkt = dev->d_iob;
+  FAR struct tcp_hdr_s *tcp;
+  unsigned int hdrlen;
+  unsigned int paylen;
+  uint8_t flags;
+
+  hdrlen = netdev_upper_gro_parse(dev, &paylen);
+  if (hdrlen == 0)
+    {
+      /* Keep the order of the packets */
+
+      netdev_upper_gro_flush(upper);
+      return false;
+    }
+
+  tcp   = (FAR struct tcp_hdr_s *)IPBUF(IPv4_HDRLEN);
+  flags = tcp->flags;
+
+  netdev_iob_clear(dev);
+
+  if (upper->gro_pkt != NULL &&
+      netdev_upper_gro_match(upper, pkt, hdrlen, paylen))
+    {
+      FAR struct tcp_hdr_s *htcp = (FAR struct tcp_hdr_s *)
+        (IOB_DATA(upper->gro_pkt) + IPv4_HDRLEN);
+
+      htcp->flags |= flags;
+      memcpy(htcp->wnd, tcp->wnd, sizeof(tcp->wnd));
+
+      iob_concat(upper->gro_pkt, iob_trimhead(pkt, hdrlen));
+      upper->gro_segs++;
+    }
+  else
+    {
+      netdev_upper_gro_flush(upper);
+
+      upper->gro_pkt    = pkt;
+      upper->gro_mss    = paylen;
+      upper->gro_hdrlen = hdrlen;
+      upper->gro_segs   = 1;
+    }
+
+  /* A pushed or short segment ends the burst */
+
+  if ((flags & TCP_PSH) != 0 || paylen < upper->gro_mss ||
+      upper->gro_segs >= CONFIG_NETDEV_GRO_MAXSEGS)
+    {
+      netdev_upper_gro_flush(upper);
+    }
+
+  return true;
+}
+#endif /* CONFIG_NETDEV_GRO */
+
+/****************************************************************************
+ * Name: netdev_upper_rxhook
+ *
+ * Description:
+ *   Run the RX hook of the device on a received packet and carry out its
+ *   verdict.
+ *
+ * Input Parameters:
+ *   upper - Reference to the upper half driver structure
+ *   pkt   - The received packet
+ *
+ * Returned Value:
+ *   True if the hook took the packet, false if it goes on to the stack.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_RXHOOK
+static bool netdev_upper_rxhook(FAR struct netdev_upperhalf_s *upper,
+                                FAR netpkt_t *pkt)
+{
+  FAR struct netdev_lowerhalf_s *lower  = upper->lower;
+  FAR struct net_driver_s       *dev    = &lower->netdev;
+  FAR struct netdev_lowerhalf_s *target = NULL;
+
+  switch (upper->rxhook(lower, pkt, upper->rxhook_arg, &target))
     {
-      /* And queue the packet for sending later.
-       * Note: RX is tried before TX, so we don't need to call txavail here.
+    case NETDEV_RXHOOK_PASS:
+      return false;
+
+#if CONFIG_IOB_NCHAINS > 0
+    case NETDEV_RXHOOK_REDIRECT:
+
+      /* Only to another upper half device with the same link layer,
+       * through its queue of replies, so that it is sent by its own
+       * poll.
        */
 
-      netdev_upper_queue_tx(dev);
+      if (target != NULL && target != lower &&
+          target->netdev.d_txavail == netdev_upper_txavail &&
+          IFF_IS_UP(target->netdev.d_flags) &&
+          NET_LL_HDRLEN(&target->netdev) == NET_LL_HDRLEN(dev))
+        {
+          FAR struct netdev_upperhalf_s *tupper =
+            target->netdev.d_private;
+
+          if (iob_tryadd_queue(pkt, &tupper->txq) >= 0)
+            {
+              atomic_fetch_add(&lower->quota[NETPKT_RX], 1);
+              netdev_upper_queue_work(&target->netdev);
+              return true;
+            }
+        }
+
+      nwarn("WARNING: Failed to redirect packet of %s, dropping\n",
+            dev->d_ifname);
+      break;
+#endif
+
+#ifdef CONFIG_NET_PKT
+    case NETDEV_RXHOOK_PKT:
+      netpkt_put(dev, pkt, NETPKT_RX);
+      pkt_input(dev);
+      netdev_iob_release(dev);
+      return true;
+#endif
+
+    default:
+      break;
     }
+
+  NETDEV_RXDROPPED(dev);
+  netpkt_free(lower, pkt, NETPKT_RX);
+  return true;
 }
 #endif
 
@@ -590,22 +1371,49 @@ static void ip_input(FAR struct net_driver_s *dev)
  *
  * Input Parameters:
  *   upper - Reference to the upper half driver structure
+ *   queue - The RX queue to poll, 0 for a single queue device
+ *
+ * Returned Value:
+ *   True if the RX budget was used up and the device may have more
+ *   packets, false if it was drained.
  *
  * Assumptions:
  *   Called with the network locked.
  *
  ****************************************************************************/
 
-static void netdev_upper_rxpoll_work(FAR struct netdev_upperhalf_s *upper)
+static bool netdev_upper_rxpoll_work(FAR struct netdev_upperhalf_s *upper,
+                                     int queue)
 {
-  FAR struct netdev_lowerhalf_s *lower = upper->lower;
-  FAR struct net_driver_s       *dev   = &lower->netdev;
+  FAR struct netdev_lowerhalf_s *lower  = upper->lower;
+  FAR struct net_driver_s       *dev    = &lower->netdev;
   FAR netpkt_t                  *pkt;
+  int                            budget = NETDEV_RX_BUDGET;
+
+  NETDEV_RXPOLLS(dev);
 
   /* Loop while receive() successfully retrieves valid Ethernet frames. */
 
-  while ((pkt = lower->ops->receive(lower)) != NULL)
+  while (budget > 0)
     {
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+      if (lower->rxqueues > 1)
+        {
+          pkt = lower->ops->receiveq(lower, queue);
+        }
+      else
+#endif
+        {
+          pkt = lower->ops->receive(lower);
+        }
+
+      if (pkt == NULL)
+        {
+          break;
+        }
+
+      budget--;
+
       if (!IFF_IS_UP(dev->d_flags))
         {
           /* Interface down, drop frame */
@@ -615,71 +1423,129 @@ static void netdev_upper_rxpoll_work(FAR struct netdev_upperhalf_s *upper)
           continue;
         }
 
+#ifdef CONFIG_NETDEV_RXHOOK
+      if (upper->rxhook != NULL && netdev_upper_rxhook(upper, pkt))
+        {
+          continue;
+        }
+#endif
+
       netpkt_put(dev, pkt, NETPKT_RX);
       NETDEV_RXPACKETS(dev);
 
-#ifdef CONFIG_NET_PKT
-      /* When packet sockets are enabled, feed the frame into the tap */
-
-      pkt_input(dev);
+#ifdef CONFIG_NETDEV_GRO
+      if (!netdev_upper_gro(upper))
 #endif
-
-      switch (dev->d_lltype)
         {
-#ifdef CONFIG_NET_LOOPBACK
-        case NET_LL_LOOPBACK:
+          netdev_upper_input(dev);
+        }
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+      /* The checksum state set by receive() is only valid for this
+       * packet.
+       */
+
+      dev->d_rxcsum = false;
 #endif
-#ifdef CONFIG_NET_ETHERNET
-        case NET_LL_ETHERNET:
+    }
+
+#ifdef CONFIG_NETDEV_GRO
+  /* Do not hold on to data beyond the end of the burst */
+
+  netdev_upper_gro_flush(upper);
 #endif
-#ifdef CONFIG_DRIVERS_IEEE80211
-        case NET_LL_IEEE80211:
+
+  return budget == 0;
+}
+
+/****************************************************************************
+ * Name: netdev_upper_poll
+ *
+ * Description:
+ *   Perform an out-of-cycle poll of the RX queues which belong to one work
+ *   thread, then of TX.  RX queue N of a multi-queue device belongs to the
+ *   thread of CPU (N % NETDEV_THREAD_COUNT), a single queue to all of
+ *   them.
+ *
+ * Input Parameters:
+ *   upper - Reference to the upper half driver structure
+ *   cpu   - The work thread doing the poll
+ *
+ ****************************************************************************/
+
+static void netdev_upper_poll(FAR struct netdev_upperhalf_s *upper, int cpu)
+{
+#if defined(CONFIG_NETDEV_NAPI) || defined(CONFIG_NETDEV_MULTIQUEUE)
+  FAR struct netdev_lowerhalf_s *lower = upper->lower;
 #endif
-#if defined(CONFIG_NET_LOOPBACK) || defined(CONFIG_NET_ETHERNET) || \
-    defined(CONFIG_DRIVERS_IEEE80211)
-          eth_input(dev);
-          break;
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  int queue;
 #endif
-#ifdef CONFIG_NET_MBIM
-        case NET_LL_MBIM:
-          ip_input(dev);
-          break;
+  bool more = false;
+
+  /* RX may release quota and driver buffer, so do RX first. */
+
+  net_lock();
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (lower->rxqueues > 1)
+    {
+      for (queue = cpu; queue < lower->rxqueues;
+           queue += NETDEV_THREAD_COUNT)
+        {
+          if (netdev_upper_rxpoll_work(upper, queue))
+            {
+              more = true;
+            }
+        }
+    }
+  else
 #endif
-#ifdef CONFIG_NET_CAN
-        case NET_LL_CAN:
-          ninfo("CAN frame");
-          can_input(dev);
-          break;
+    {
+      more = netdev_upper_rxpoll_work(upper, 0);
+    }
+
+  netdev_upper_txavail_work(upper);
+  net_unlock();
+
+  if (more)
+    {
+      /* Out of budget, let the other devices and threads run before
+       * polling again.
+       */
+
+#ifdef CONFIG_NETDEV_WORK_THREAD
+      netdev_upper_queue_cpu(upper, cpu);
+#else
+      netdev_upper_queue_work(&upper->lower->netdev);
 #endif
-        default:
-          nerr("Unknown link type %d\n", dev->d_lltype);
-          break;
-        }
     }
+#ifdef CONFIG_NETDEV_NAPI
+  else if (lower->ops->rxirq != NULL)
+    {
+      /* Drained, back to interrupt mode */
+
+      lower->ops->rxirq(lower, true);
+    }
+#endif
 }
 
 /****************************************************************************
  * Name: netdev_upper_work
  *
  * Description:
- *   Perform an out-of-cycle poll on a dedicated thread or the worker thread.
+ *   Perform an out-of-cycle poll on the worker thread.
  *
  * Input Parameters:
  *   arg - Reference to the upper half driver structure (cast to void *)
  *
  ****************************************************************************/
 
+#ifndef CONFIG_NETDEV_WORK_THREAD
 static void netdev_upper_work(FAR void *arg)
 {
-  FAR struct netdev_upperhalf_s *upper = arg;
-
-  /* RX may release quota and driver buffer, so do RX first. */
-
-  net_lock();
-  netdev_upper_rxpoll_work(upper);
-  netdev_upper_txavail_work(upper);
-  net_unlock();
+  netdev_upper_poll(arg, 0);
 }
+#endif
 
 /****************************************************************************
  * Name: netdev_upper_wait
@@ -727,7 +1593,7 @@ static int netdev_upper_loop(int argc, FAR char *argv[])
   while (netdev_upper_wait(&upper->sem[cpu]) == OK &&
          upper->tid[cpu] != INVALID_PROCESS_ID)
     {
-      netdev_upper_work(upper);
+      netdev_upper_poll(upper, cpu);
     }
 
   nwarn("WARNING: Netdev work thread quitting.");
@@ -747,12 +1613,22 @@ static int netdev_upper_loop(int argc, FAR char *argv[])
  *
  ****************************************************************************/
 
-static inline void netdev_upper_queue_work(FAR struct net_driver_s *dev)
-{
-  FAR struct netdev_upperhalf_s *upper = dev->d_private;
+/****************************************************************************
+ * Name: netdev_upper_queue_cpu
+ *
+ * Description:
+ *   Wake up the work thread of one CPU.
+ *
+ * Input Parameters:
+ *   upper - Reference to the upper half driver structure
+ *   cpu   - The work thread to wake up
+ *
+ ****************************************************************************/
 
 #ifdef CONFIG_NETDEV_WORK_THREAD
-  int cpu = this_cpu();
+static void netdev_upper_queue_cpu(FAR struct netdev_upperhalf_s *upper,
+                                   int cpu)
+{
   int semcount;
 
   if (nxsem_get_value(&upper->sem[cpu], &semcount) == OK &&
@@ -760,6 +1636,15 @@ static inline void netdev_upper_queue_work(FAR struct net_driver_s *dev)
     {
       nxsem_post(&upper->sem[cpu]);
     }
+}
+#endif
+
+static inline void netdev_upper_queue_work(FAR struct net_driver_s *dev)
+{
+  FAR struct netdev_upperhalf_s *upper = dev->d_private;
+
+#ifdef CONFIG_NETDEV_WORK_THREAD
+  netdev_upper_queue_cpu(upper, this_cpu());
 #else
   if (work_available(&upper->work))
     {
@@ -1195,6 +2080,14 @@ int netdev_lower_register(FAR struct netdev_lowerhalf_s *dev,
       return -EINVAL;
     }
 
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if ((dev->txqueues > 1 && dev->ops->transmitq == NULL) ||
+      (dev->rxqueues > 1 && dev->ops->receiveq == NULL))
+    {
+      return -EINVAL;
+    }
+#endif
+
   if ((upper = netdev_upper_alloc(dev)) == NULL)
     {
       return -ENOMEM;
@@ -1339,11 +2232,57 @@ void netdev_lower_carrier_off(FAR struct netdev_lowerhalf_s *dev)
 
 void netdev_lower_rxready(FAR struct netdev_lowerhalf_s *dev)
 {
+  NETDEV_RXINTERRUPTS(&dev->netdev);
+
 #if CONFIG_NETDEV_WORK_THREAD_POLLING_PERIOD == 0
+#ifdef CONFIG_NETDEV_NAPI
+  /* Poll until the device is drained, netdev_upper_poll() unmasks the
+   * interrupt again.
+   */
+
+  if (dev->ops->rxirq != NULL)
+    {
+      dev->ops->rxirq(dev, false);
+    }
+#endif
+
   netdev_upper_queue_work(&dev->netdev);
 #endif
 }
 
+/****************************************************************************
+ * Name: netdev_lower_rxready_queue
+ *
+ * Description:
+ *   Notifies the networking layer about an RX packet is ready to read on
+ *   one queue of a multi-queue device.
+ *
+ * Input Parameters:
+ *   dev   - The lower half device driver structure
+ *   queue - The RX queue
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+void netdev_lower_rxready_queue(FAR struct netdev_lowerhalf_s *dev,
+                                int queue)
+{
+  NETDEV_RXINTERRUPTS(&dev->netdev);
+
+#if CONFIG_NETDEV_WORK_THREAD_POLLING_PERIOD == 0
+#ifdef CONFIG_NETDEV_NAPI
+  if (dev->ops->rxirq != NULL)
+    {
+      dev->ops->rxirq(dev, false);
+    }
+#endif
+
+  netdev_upper_queue_cpu(dev->netdev.d_private,
+                         queue % NETDEV_THREAD_COUNT);
+#endif
+}
+#endif
+
 /****************************************************************************
  * Name: netdev_lower_txdone
  *
@@ -1381,6 +2320,54 @@ int netdev_lower_quota_load(FAR struct netdev_lowerhalf_s *dev,
   return atomic_load(&dev->quota[type]);
 }
 
+/****************************************************************************
+ * Name: netdev_lower_rxhook
+ *
+ * Description:
+ *   Install or remove the RX hook of a device.
+ *
+ * Input Parameters:
+ *   dev  - The lower half device driver structure
+ *   hook - The hook to install, NULL to remove the current one
+ *   arg  - The argument passed to the hook
+ *
+ * Returned Value:
+ *   0:Success; negated errno on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_RXHOOK
+int netdev_lower_rxhook(FAR struct netdev_lowerhalf_s *dev,
+                        netdev_rxhook_t hook, FAR void *arg)
+{
+  FAR struct netdev_upperhalf_s *upper;
+  int ret = OK;
+
+  if (dev == NULL || dev->netdev.d_private == NULL)
+    {
+      return -EINVAL;
+    }
+
+  upper = dev->netdev.d_private;
+
+  /* The RX poll runs the hook with the network locked */
+
+  net_lock();
+  if (hook != NULL && upper->rxhook != NULL)
+    {
+      ret = -EBUSY;
+    }
+  else
+    {
+      upper->rxhook     = hook;
+      upper->rxhook_arg = arg;
+    }
+
+  net_unlock();
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: netpkt_alloc
  *
@@ -1637,3 +2624,105 @@ int netpkt_to_iov(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt,
 
   return i;
 }
+
+/****************************************************************************
+ * Name: netpkt_chksum_prepare
+ *
+ * Description:
+ *   Check if the TCP/UDP checksum of an outgoing packet is to be filled in
+ *   by the hardware (see NETDEV_F_TXCSUM).  If so, the pseudo-header sum is
+ *   stored in the checksum field and the location of the L4 data and of
+ *   the checksum field are returned.  The hardware is then expected to add
+ *   everything from 'start' to the end of the packet to the checksum field
+ *   and to store the complement there.
+ *
+ * Input Parameters:
+ *   dev    - The lower half device driver structure
+ *   pkt    - The net packet
+ *   start  - Returns the offset of the L4 header from netpkt_getdata()
+ *   offset - Returns the offset of the checksum field from 'start'
+ *
+ * Returned Value:
+ *   Zero (OK) if the hardware must complete the checksum; a negated errno
+ *   value if the packet is to be sent as is.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_CHKSUM_OFFLOAD
+int netpkt_chksum_prepare(FAR struct netdev_lowerhalf_s *dev,
+                          FAR netpkt_t *pkt, FAR unsigned int *start,
+                          FAR unsigned int *offset)
+{
+  FAR uint8_t *ip = IOB_DATA(pkt);
+  FAR uint16_t *field;
+  unsigned int iphdrlen;
+  unsigned int l4len;
+  uint16_t sum;
+  uint8_t proto;
+
+#ifdef CONFIG_NET_IPv4
+  if ((ip[0] & IP_VERSION_MASK) == IPv4_VERSION)
+    {
+      FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)ip;
+
+      /* The stack does not leave the checksum of fragments to the
+       * hardware.
+       */
+
+      if (((ipv4->ipoffset[0] << 8) | ipv4->ipoffset[1]) &
+          ~IP_FLAG_DONTFRAG)
+        {
+          return -EINVAL;
+        }
+
+      iphdrlen = (ipv4->vhl & IPv4_HLMASK) << 2;
+      l4len    = ((ipv4->len[0] << 8) | ipv4->len[1]) - iphdrlen;
+      proto    = ipv4->proto;
+      sum      = chksum(l4len + proto, (FAR uint8_t *)ipv4->srcipaddr,
+                        2 * sizeof(in_addr_t));
+    }
+  else
+#endif
+#ifdef CONFIG_NET_IPv6
+  if ((ip[0] & IP_VERSION_MASK) == IPv6_VERSION)
+    {
+      FAR struct ipv6_hdr_s *ipv6 = (FAR struct ipv6_hdr_s *)ip;
+
+      iphdrlen = IPv6_HDRLEN;
+      l4len    = (ipv6->len[0] << 8) | ipv6->len[1];
+      proto    = ipv6->proto;
+      sum      = chksum(l4len + proto, (FAR uint8_t *)ipv6->srcipaddr,
+                        2 * sizeof(net_ipv6addr_t));
+    }
+  else
+#endif
+    {
+      return -EINVAL;
+    }
+
+  if (proto == IP_PROTO_TCP)
+    {
+      *offset = offsetof(struct tcp_hdr_s, tcpchksum);
+    }
+  else if (proto == IP_PROTO_UDP)
+    {
+      *offset = offsetof(struct udp_hdr_s, udpchksum);
+    }
+  else
+    {
+      return -EINVAL;
+    }
+
+  /* A non-zero checksum is already complete (e.g. a forwarded packet) */
+
+  field = (FAR uint16_t *)(ip + iphdrlen + *offset);
+  if (*field != 0)
+    {
+      return -EEXIST;
+    }
+
+  *field  = HTONS(sum);
+  *start  = NET_LL_HDRLEN(&dev->netdev) + iphdrlen;
+  return OK;
+}
+#endif
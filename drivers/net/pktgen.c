@@ -0,0 +1,538 @@
+/****************************************************************************
+ * drivers/net/pktgen.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+#include <sched.h>
+#include <string.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/kthread.h>
+#include <nuttx/sched_note.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/net/ethernet.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/netdev_lowerhalf.h>
+#include <nuttx/net/pktgen.h>
+#include <nuttx/net/udp.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define PKTGEN_MAGIC      0x7067656e   /* "pgen" */
+
+#define PKTGEN_ETHTYPE_ARP 0x0806
+#define PKTGEN_ARP_REQUEST 1
+#define PKTGEN_ARP_REPLY   2
+
+/* Offsets in the generated frame */
+
+#define PKTGEN_IPOFFSET   ETH_HDRLEN
+#define PKTGEN_UDPOFFSET  (PKTGEN_IPOFFSET + IPv4_HDRLEN)
+#define PKTGEN_PLOFFSET   (PKTGEN_UDPOFFSET + UDP_HDRLEN)
+#define PKTGEN_FRAMELEN   CONFIG_NET_ETH_PKTSIZE
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The start of the payload of the generated packets */
+
+begin_packed_struct struct pktgen_payload_s
+{
+  uint32_t magic;
+  uint32_t seq;
+  uint64_t stamp;
+} end_packed_struct;
+
+/* An Ethernet ARP packet, for the replies of the peer */
+
+begin_packed_struct struct pktgen_arp_s
+{
+  struct eth_hdr_s eth;
+  uint16_t hwtype;
+  uint16_t protocol;
+  uint8_t  hwlen;
+  uint8_t  protolen;
+  uint16_t opcode;
+  uint8_t  shwaddr[6];
+  uint16_t sipaddr[2];
+  uint8_t  dhwaddr[6];
+  uint16_t dipaddr[2];
+} end_packed_struct;
+
+struct pktgen_dev_s
+{
+  struct netdev_lowerhalf_s dev;  /* Must be the first */
+  sem_t kick;                     /* Wakes the generator thread up */
+  bool running;                   /* Generating now */
+  unsigned int burst;             /* Packets of the current poll */
+  clock_t start;                  /* perf_gettime() of the start */
+  struct pktgen_config_s config;
+  struct pktgen_stats_s stats;
+  uint16_t framelen;              /* Length of the generated frame */
+  uint16_t arplen;                /* Length of a pending ARP reply */
+  uint8_t frame[PKTGEN_FRAMELEN]; /* The generated frame */
+  struct pktgen_arp_s arp;        /* The pending ARP reply */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int pktgen_ifup(FAR struct netdev_lowerhalf_s *dev);
+static int pktgen_ifdown(FAR struct netdev_lowerhalf_s *dev);
+static int pktgen_transmit(FAR struct netdev_lowerhalf_s *dev,
+                           FAR netpkt_t *pkt);
+static FAR netpkt_t *pktgen_receive(FAR struct netdev_lowerhalf_s *dev);
+
+static int pktgen_ioctl(FAR struct file *filep, int cmd, unsigned long arg);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct pktgen_dev_s g_pktgen;
+
+/* The MAC address of the peer the packets come from */
+
+static const uint8_t g_pktgen_peer[6] =
+{
+  0x02, 0x70, 0x67, 0x00, 0x00, 0x01
+};
+
+static const uint8_t g_pktgen_mac[6] =
+{
+  0x02, 0x70, 0x67, 0x00, 0x00, 0x00
+};
+
+static const struct netdev_ops_s g_pktgen_ops =
+{
+  pktgen_ifup,      /* ifup */
+  pktgen_ifdown,    /* ifdown */
+  pktgen_transmit,  /* transmit */
+  pktgen_receive    /* receive */
+};
+
+static const struct file_operations g_pktgen_fops =
+{
+  NULL,             /* open */
+  NULL,             /* close */
+  NULL,             /* read */
+  NULL,             /* write */
+  NULL,             /* seek */
+  pktgen_ioctl,     /* ioctl */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pktgen_arp
+ *
+ * Description:
+ *   Answer an ARP request of the stack as the peer would, so that the
+ *   addresses behind the device are reachable without a static entry.
+ *
+ ****************************************************************************/
+
+static void pktgen_arp(FAR struct pktgen_dev_s *priv,
+                       FAR const struct pktgen_arp_s *req)
+{
+  FAR struct pktgen_arp_s *arp = &priv->arp;
+
+  if (req->opcode != HTONS(PKTGEN_ARP_REQUEST) || priv->arplen != 0)
+    {
+      return;
+    }
+
+  memcpy(arp, req, sizeof(*arp));
+  memcpy(arp->eth.dest, req->eth.src, sizeof(arp->eth.dest));
+  memcpy(arp->eth.src, g_pktgen_peer, sizeof(arp->eth.src));
+  arp->opcode = HTONS(PKTGEN_ARP_REPLY);
+  memcpy(arp->dhwaddr, req->shwaddr, sizeof(arp->dhwaddr));
+  memcpy(arp->dipaddr, req->sipaddr, sizeof(arp->dipaddr));
+  memcpy(arp->shwaddr, g_pktgen_peer, sizeof(arp->shwaddr));
+  memcpy(arp->sipaddr, req->dipaddr, sizeof(arp->sipaddr));
+
+  priv->arplen = sizeof(*arp);
+  netdev_lower_rxready(&priv->dev);
+}
+
+/****************************************************************************
+ * Name: pktgen_transmit
+ *
+ * Description:
+ *   The sink: count the packet, take the latency of a generated one and
+ *   drop it.
+ *
+ ****************************************************************************/
+
+static int pktgen_transmit(FAR struct netdev_lowerhalf_s *dev,
+                           FAR netpkt_t *pkt)
+{
+  FAR struct pktgen_dev_s *priv = (FAR struct pktgen_dev_s *)dev;
+  FAR struct pktgen_stats_s *stats = &priv->stats;
+  uint8_t hdr[PKTGEN_PLOFFSET + sizeof(struct pktgen_payload_s)];
+  FAR struct eth_hdr_s *eth = (FAR struct eth_hdr_s *)hdr;
+  FAR struct ipv4_hdr_s *ip =
+    (FAR struct ipv4_hdr_s *)(hdr + PKTGEN_IPOFFSET);
+  struct pktgen_payload_s payload;
+  unsigned int len = netpkt_getdatalen(dev, pkt);
+  uint32_t lat;
+
+  sched_note_mark(NOTE_TAG_NET, "pktgen tx");
+
+  stats->txpackets++;
+  stats->txbytes += len;
+
+  if (len >= sizeof(struct pktgen_arp_s) &&
+      netpkt_copyout(dev, hdr, pkt, sizeof(struct pktgen_arp_s), 0) >= 0 &&
+      eth->type == HTONS(PKTGEN_ETHTYPE_ARP))
+    {
+      pktgen_arp(priv, (FAR struct pktgen_arp_s *)hdr);
+    }
+  else if (len >= sizeof(hdr) &&
+           netpkt_copyout(dev, hdr, pkt, sizeof(hdr), 0) >= 0 &&
+           eth->type == HTONS(ETHTYPE_IP) && ip->proto == IP_PROTO_UDP)
+    {
+      memcpy(&payload, hdr + PKTGEN_PLOFFSET, sizeof(payload));
+      if (payload.magic == PKTGEN_MAGIC)
+        {
+          lat = (uint32_t)(perf_gettime() - (clock_t)payload.stamp);
+          if (stats->nlatency == 0 || lat < stats->latmin)
+            {
+              stats->latmin = lat;
+            }
+
+          if (lat > stats->latmax)
+            {
+              stats->latmax = lat;
+            }
+
+          stats->latsum += lat;
+          stats->nlatency++;
+        }
+    }
+
+  netpkt_free(dev, pkt, NETPKT_TX);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pktgen_receive
+ *
+ * Description:
+ *   The generator: hand up to CONFIG_NET_PKTGEN_BURST packets to the stack
+ *   per RX poll, then wake the generator thread up for the next poll.
+ *
+ ****************************************************************************/
+
+static FAR netpkt_t *pktgen_receive(FAR struct netdev_lowerhalf_s *dev)
+{
+  FAR struct pktgen_dev_s *priv = (FAR struct pktgen_dev_s *)dev;
+  struct pktgen_payload_s payload;
+  FAR netpkt_t *pkt;
+
+  if (priv->arplen != 0)
+    {
+      pkt = netpkt_alloc(dev, NETPKT_RX);
+      if (pkt != NULL &&
+          netpkt_copyin(dev, pkt, (FAR const uint8_t *)&priv->arp,
+                        priv->arplen, 0) < 0)
+        {
+          netpkt_free(dev, pkt, NETPKT_RX);
+          pkt = NULL;
+        }
+
+      priv->arplen = 0;
+      if (pkt != NULL)
+        {
+          return pkt;
+        }
+    }
+
+  if (!priv->running || priv->burst >= CONFIG_NET_PKTGEN_BURST)
+    {
+      goto done;
+    }
+
+  if (priv->config.count != 0 &&
+      priv->stats.rxpackets >= priv->config.count)
+    {
+      priv->stats.elapsed = perf_gettime() - priv->start;
+      priv->running       = false;
+      goto done;
+    }
+
+  pkt = netpkt_alloc(dev, NETPKT_RX);
+  if (pkt == NULL)
+    {
+      goto done;
+    }
+
+  if (priv->burst == 0)
+    {
+      sched_note_beginex(NOTE_TAG_NET, "pktgen rx");
+    }
+
+  payload.magic = PKTGEN_MAGIC;
+  payload.seq   = (uint32_t)priv->stats.rxpackets;
+  payload.stamp = perf_gettime();
+  memcpy(priv->frame + PKTGEN_PLOFFSET, &payload, sizeof(payload));
+
+  if (netpkt_copyin(dev, pkt, priv->frame, priv->framelen, 0) < 0)
+    {
+      netpkt_free(dev, pkt, NETPKT_RX);
+      goto done;
+    }
+
+  priv->burst++;
+  priv->stats.rxpackets++;
+  priv->stats.rxbytes += priv->framelen;
+  return pkt;
+
+done:
+  if (priv->burst > 0)
+    {
+      sched_note_endex(NOTE_TAG_NET, "pktgen rx");
+      priv->burst = 0;
+    }
+
+  if (priv->running)
+    {
+      nxsem_post(&priv->kick);
+    }
+
+  return NULL;
+}
+
+static int pktgen_ifup(FAR struct netdev_lowerhalf_s *dev)
+{
+  netdev_lower_carrier_on(dev);
+  return OK;
+}
+
+static int pktgen_ifdown(FAR struct netdev_lowerhalf_s *dev)
+{
+  FAR struct pktgen_dev_s *priv = (FAR struct pktgen_dev_s *)dev;
+
+  priv->running = false;
+  netdev_lower_carrier_off(dev);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pktgen_thread
+ *
+ * Description:
+ *   Start the next RX poll of the device whenever the previous one is
+ *   done, so that the stack is kept busy as long as the generator runs.
+ *
+ ****************************************************************************/
+
+static int pktgen_thread(int argc, FAR char *argv[])
+{
+  FAR struct pktgen_dev_s *priv = &g_pktgen;
+
+  for (; ; )
+    {
+      nxsem_wait_uninterruptible(&priv->kick);
+      if (priv->running)
+        {
+          netdev_lower_rxready(&priv->dev);
+          sched_yield();
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pktgen_start
+ *
+ * Description:
+ *   Build the frame to generate and start the generator.
+ *
+ ****************************************************************************/
+
+static int pktgen_start(FAR struct pktgen_dev_s *priv,
+                        FAR const struct pktgen_config_s *config)
+{
+  FAR struct eth_hdr_s *eth = (FAR struct eth_hdr_s *)priv->frame;
+  FAR struct ipv4_hdr_s *ip =
+    (FAR struct ipv4_hdr_s *)(priv->frame + PKTGEN_IPOFFSET);
+  FAR struct udp_hdr_s *udp =
+    (FAR struct udp_hdr_s *)(priv->frame + PKTGEN_UDPOFFSET);
+  uint16_t iplen;
+
+  if (config == NULL || config->len < PKTGEN_MINLEN ||
+      config->len > PKTGEN_FRAMELEN - PKTGEN_PLOFFSET)
+    {
+      return -EINVAL;
+    }
+
+  iplen = IPv4_HDRLEN + UDP_HDRLEN + config->len;
+  memset(priv->frame, 0, sizeof(priv->frame));
+
+  memcpy(eth->dest, priv->dev.netdev.d_mac.ether.ether_addr_octet,
+         sizeof(eth->dest));
+  memcpy(eth->src, g_pktgen_peer, sizeof(eth->src));
+  eth->type        = HTONS(ETHTYPE_IP);
+
+  ip->vhl          = 0x45;
+  ip->len[0]       = iplen >> 8;
+  ip->len[1]       = iplen & 0xff;
+  ip->ttl          = IP_TTL_DEFAULT;
+  ip->proto        = IP_PROTO_UDP;
+  net_ipv4addr_hdrcopy(ip->srcipaddr, &config->srcaddr);
+  net_ipv4addr_hdrcopy(ip->destipaddr, &config->dstaddr);
+  ip->ipchksum     = ~ipv4_chksum(ip);
+
+  /* No UDP checksum, it would change with each time stamp */
+
+  udp->srcport     = config->srcport;
+  udp->destport    = config->dstport;
+  udp->udplen      = HTONS(UDP_HDRLEN + config->len);
+
+  net_lock();
+  priv->config     = *config;
+  priv->framelen   = PKTGEN_PLOFFSET + config->len;
+  memset(&priv->stats, 0, sizeof(priv->stats));
+  priv->stats.freq = perf_getfreq();
+  priv->start      = perf_gettime();
+  priv->running    = true;
+  net_unlock();
+
+  nxsem_post(&priv->kick);
+  return OK;
+}
+
+static int pktgen_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
+{
+  FAR struct pktgen_dev_s *priv = filep->f_inode->i_private;
+  FAR struct pktgen_stats_s *stats;
+
+  switch (cmd)
+    {
+      case PKTGENIOC_START:
+        return pktgen_start(priv,
+                            (FAR const struct pktgen_config_s *)arg);
+
+      case PKTGENIOC_STOP:
+        net_lock();
+        if (priv->running)
+          {
+            priv->stats.elapsed = perf_gettime() - priv->start;
+            priv->running       = false;
+          }
+
+        net_unlock();
+        return OK;
+
+      case PKTGENIOC_GETSTATS:
+        stats = (FAR struct pktgen_stats_s *)arg;
+        if (stats == NULL)
+          {
+            return -EINVAL;
+          }
+
+        net_lock();
+        *stats = priv->stats;
+        if (priv->running)
+          {
+            stats->elapsed = perf_gettime() - priv->start;
+          }
+
+        net_unlock();
+        return OK;
+
+      default:
+        return -ENOTTY;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pktgen_initialize
+ *
+ * Description:
+ *   Register the pktgen network device (pg0) and its control device
+ *   /dev/pktgen.
+ *
+ ****************************************************************************/
+
+int pktgen_initialize(void)
+{
+  FAR struct pktgen_dev_s *priv = &g_pktgen;
+  FAR struct netdev_lowerhalf_s *dev = &priv->dev;
+  int ret;
+
+  nxsem_init(&priv->kick, 0, 0);
+
+  dev->ops              = &g_pktgen_ops;
+  dev->quota[NETPKT_TX] = CONFIG_NET_PKTGEN_BURST;
+  dev->quota[NETPKT_RX] = CONFIG_NET_PKTGEN_BURST;
+
+  strlcpy(dev->netdev.d_ifname, "pg%d", IFNAMSIZ);
+  memcpy(dev->netdev.d_mac.ether.ether_addr_octet, g_pktgen_mac,
+         sizeof(g_pktgen_mac));
+
+  ret = netdev_lower_register(dev, NET_LL_ETHERNET);
+  if (ret < 0)
+    {
+      nerr("ERROR: netdev_lower_register failed: %d\n", ret);
+      return ret;
+    }
+
+  ret = kthread_create("pktgen", CONFIG_NET_PKTGEN_PRIORITY,
+                       CONFIG_NET_PKTGEN_STACKSIZE, pktgen_thread, NULL);
+  if (ret < 0)
+    {
+      nerr("ERROR: kthread_create failed: %d\n", ret);
+      netdev_lower_unregister(dev);
+      return ret;
+    }
+
+  ret = register_driver("/dev/pktgen", &g_pktgen_fops, 0666, priv);
+  if (ret < 0)
+    {
+      nerr("ERROR: register_driver failed: %d\n", ret);
+    }
+
+  return ret;
+}
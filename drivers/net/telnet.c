@@ -24,8 +24,10 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <assert.h>
 #include <stdio.h>
+#include <string.h>
 #include <fcntl.h>
 #include <poll.h>
 #include <errno.h>
@@ -149,8 +151,8 @@ static void    telnet_getchar(FAR struct telnet_dev_s *priv, uint8_t ch,
 static ssize_t telnet_receive(FAR struct telnet_dev_s *priv,
                  FAR const char *src, size_t srclen, FAR char *dest,
                  size_t destlen);
-static bool    telnet_putchar(FAR struct telnet_dev_s *priv, uint8_t ch,
-                 int *nwritten);
+static void    telnet_putchar(FAR struct telnet_dev_s *priv, uint8_t ch,
+                 FAR int *ncopied);
 static void    telnet_sendopt(FAR struct telnet_dev_s *priv, uint8_t option,
                  uint8_t value);
 
@@ -332,14 +334,38 @@ static ssize_t telnet_receive(FAR struct telnet_dev_s *priv,
                               FAR const char *src, size_t srclen,
                               FAR char *dest, size_t destlen)
 {
-  int nread;
+  FAR const char *iac;
+  size_t ncopy;
+  int nread = 0;
   uint8_t ch;
 
   ninfo("srclen: %zd destlen: %zd\n", srclen, destlen);
 
-  for (nread = 0; srclen > 0 && nread < destlen; srclen--)
+  while (srclen > 0 && nread < destlen)
     {
+      /* Copy the plain data up to the next IAC at once */
+
+      if (priv->td_state == STATE_NORMAL)
+        {
+          ncopy = MIN(srclen, destlen - nread);
+          iac   = memchr(src, TELNET_IAC, ncopy);
+          if (iac != NULL)
+            {
+              ncopy = iac - src;
+            }
+
+          if (ncopy > 0)
+            {
+              memcpy(&dest[nread], src, ncopy);
+              nread  += ncopy;
+              src    += ncopy;
+              srclen -= ncopy;
+              continue;
+            }
+        }
+
       ch = *src++;
+      srclen--;
       ninfo("ch=%02x state=%d\n", ch, priv->td_state);
 
       switch (priv->td_state)
@@ -538,15 +564,15 @@ static ssize_t telnet_receive(FAR struct telnet_dev_s *priv,
  * Name: telnet_putchar
  *
  * Description:
- *   Put another character from the user buffer to the TX buffer.
+ *   Put another character from the user buffer to the TX buffer.  This adds
+ *   at most two bytes.
  *
  ****************************************************************************/
 
-static bool telnet_putchar(FAR struct telnet_dev_s *priv, uint8_t ch,
-                           int *nread)
+static void telnet_putchar(FAR struct telnet_dev_s *priv, uint8_t ch,
+                           FAR int *ncopied)
 {
   register int index;
-  bool ret = false;
 
   /* Ignore carriage returns (we will put these in automatically as
    * necessary).
@@ -556,26 +582,24 @@ static bool telnet_putchar(FAR struct telnet_dev_s *priv, uint8_t ch,
     {
       /* Add all other characters to the destination buffer */
 
-      index = *nread;
+      index = *ncopied;
       priv->td_txbuffer[index++] = ch;
 
-      /* Check for line feeds */
+      /* Line feeds get a carriage return, and a data byte of 255 must be
+       * doubled so that it is not taken for a command.
+       */
 
       if (ch == TELNET_NL)
         {
-          /* Now add the carriage return */
-
           priv->td_txbuffer[index++] = TELNET_CR;
-
-          /* End of line */
-
-          ret = true;
+        }
+      else if (ch == TELNET_IAC)
+        {
+          priv->td_txbuffer[index++] = TELNET_IAC;
         }
 
-      *nread = index;
+      *ncopied = index;
     }
-
-  return ret;
 }
 
 /****************************************************************************
@@ -816,43 +840,67 @@ static ssize_t telnet_write(FAR struct file *filep, FAR const char *buffer,
   FAR struct telnet_dev_s *priv = inode->i_private;
   FAR const char *src = buffer;
   ssize_t ret = 0;
-  ssize_t nsent;
-  int ncopied;
+  size_t nsent = 0;
+  size_t nused = 0;
+  size_t nrun;
+  int ncopied = 0;
+  size_t room;
   char ch;
-  bool eol;
 
   ninfo("len: %zd\n", len);
 
-  /* Process each character from the user buffer */
+  /* Fill the TX buffer from the user buffer and send it when it is full,
+   * so that bulk output goes out in as few packets as possible.
+   */
 
-  for (nsent = 0, ncopied = 0; nsent < len; nsent++)
+  while (nused < len)
     {
-      /* Get the next character from the user buffer */
+      /* Copy the run of characters that need no translation at once,
+       * leaving room for the largest character sequence ("\r\n")
+       */
 
-      ch = *src++;
+      room = CONFIG_TELNET_TXBUFFER_SIZE - 2 - ncopied;
+      for (nrun = 0; nused + nrun < len && nrun < room; nrun++)
+        {
+          ch = src[nrun];
+          if (ch == TELNET_CR || ch == TELNET_NL ||
+              (uint8_t)ch == TELNET_IAC)
+            {
+              break;
+            }
+        }
 
-      /* Add the character to the TX buffer */
+      memcpy(&priv->td_txbuffer[ncopied], src, nrun);
+      ncopied += nrun;
+      src     += nrun;
+      nused   += nrun;
 
-      eol = telnet_putchar(priv, ch, &ncopied);
+      /* Then the character that ended the run */
 
-      /* Was that the end of a line? Or is the buffer too full to hold the
-       * next largest character sequence ("\r\n")?
+      if (nused < len)
+        {
+          telnet_putchar(priv, *src++, &ncopied);
+          nused++;
+        }
+
+      /* Is the buffer too full to hold the next largest character
+       * sequence?
        */
 
-      if (eol || ncopied > CONFIG_TELNET_TXBUFFER_SIZE - 2)
+      if (ncopied > CONFIG_TELNET_TXBUFFER_SIZE - 2)
         {
           /* Yes... send the data now */
 
           ret = psock_send(&priv->td_psock, priv->td_txbuffer, ncopied, 0);
           if (ret < 0)
             {
-              nerr("ERROR: psock_send failed '%s': %zd\n",
-                   priv->td_txbuffer, ret);
+              nerr("ERROR: psock_send failed: %zd\n", ret);
               goto out;
             }
 
           /* Reset the index to the beginning of the TX buffer. */
 
+          nsent   = nused;
           ncopied = 0;
         }
     }
@@ -864,12 +912,13 @@ static ssize_t telnet_write(FAR struct file *filep, FAR const char *buffer,
       ret = psock_send(&priv->td_psock, priv->td_txbuffer, ncopied, 0);
       if (ret < 0)
         {
-          nerr("ERROR: psock_send failed '%s': %zd\n",
-               priv->td_txbuffer, ret);
+          nerr("ERROR: psock_send failed: %zd\n", ret);
           goto out;
         }
     }
 
+  nsent = nused;
+
   /* Notice that we don't actually return the number of bytes sent, but
    * rather, the number of bytes that the caller asked us to send.  We may
    * have sent more bytes (because of CR-LF expansion). But it confuses
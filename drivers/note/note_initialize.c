@@ -28,6 +28,7 @@
 #include <nuttx/note/note_driver.h>
 #include <nuttx/note/noteram_driver.h>
 #include <nuttx/note/notectl_driver.h>
+#include <nuttx/note/notepack_driver.h>
 #include <nuttx/note/notesnap_driver.h>
 #include <nuttx/note/notestream_driver.h>
 #include <nuttx/segger/note_rtt.h>
@@ -165,6 +166,15 @@ int note_initialize(void)
     }
 #endif
 
+#ifdef CONFIG_DRIVERS_NOTEPACK
+  ret = notepack_register(CONFIG_DRIVERS_NOTEPACK_PATH);
+  if (ret < 0)
+    {
+      serr("notepack_register failed %d\n", ret);
+      return ret;
+    }
+#endif
+
 #ifdef CONFIG_NOTE_RTT
   ret = notertt_register();
   if (ret < 0)
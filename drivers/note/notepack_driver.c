@@ -0,0 +1,437 @@
+/****************************************************************************
+ * drivers/note/notepack_driver.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/sched_note.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/streams.h>
+#include <nuttx/note/note_driver.h>
+#include <nuttx/note/notepack_driver.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Worst case size of a record: the header, the largest fixed fields (the
+ * syscall arguments) and the data of a note of up to 255 bytes.
+ */
+
+#define NOTEPACK_BUFSIZE  320
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct notepack_driver_s
+{
+  struct note_driver_s driver;
+  struct lib_fileoutstream_s filestream;
+  struct file file;
+  spinlock_t lock;
+  clock_t systime;                   /* Time stamp of the previous record */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void notepack_add(FAR struct note_driver_s *drv,
+                         FAR const void *note, size_t len);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct note_driver_ops_s g_notepack_ops =
+{
+  notepack_add
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: notepack_uint
+ *
+ * Description:
+ *   Append an unsigned LEB128 number.
+ *
+ ****************************************************************************/
+
+static FAR uint8_t *notepack_uint(FAR uint8_t *p, uintmax_t value)
+{
+  while (value >= 0x80)
+    {
+      *p++ = (uint8_t)value | 0x80;
+      value >>= 7;
+    }
+
+  *p++ = (uint8_t)value;
+  return p;
+}
+
+/****************************************************************************
+ * Name: notepack_sint
+ *
+ * Description:
+ *   Append a zigzag encoded signed LEB128 number.
+ *
+ ****************************************************************************/
+
+static FAR uint8_t *notepack_sint(FAR uint8_t *p, intmax_t value)
+{
+  return notepack_uint(p, ((uintmax_t)value << 1) ^
+                          (uintmax_t)(value >> (sizeof(value) * 8 - 1)));
+}
+
+/****************************************************************************
+ * Name: notepack_data
+ *
+ * Description:
+ *   Append the length and the bytes of a string or data field.
+ *
+ ****************************************************************************/
+
+static FAR uint8_t *notepack_data(FAR uint8_t *p, FAR const void *data,
+                                  size_t len)
+{
+  p = notepack_uint(p, len);
+  memcpy(p, data, len);
+  return p + len;
+}
+
+/****************************************************************************
+ * Name: notepack_fields
+ *
+ * Description:
+ *   Append the fields that follow the common header of a note.
+ *
+ ****************************************************************************/
+
+static FAR uint8_t *notepack_fields(FAR uint8_t *p,
+                                    FAR const struct note_common_s *note)
+{
+  size_t len = note->nc_length;
+  int i;
+
+  switch (note->nc_type)
+    {
+      case NOTE_START:
+        {
+          FAR const struct note_start_s *nst = (FAR const void *)note;
+
+          p = notepack_uint(p, note->nc_priority);
+#if CONFIG_TASK_NAME_SIZE > 0
+          p = notepack_data(p, nst->nst_name,
+                            strnlen(nst->nst_name, len -
+                                    offsetof(struct note_start_s,
+                                             nst_name)));
+#else
+          UNUSED(nst);
+          p = notepack_uint(p, 0);
+#endif
+        }
+        break;
+
+      case NOTE_STOP:
+      case NOTE_CPU_STARTED:
+      case NOTE_CPU_PAUSED:
+      case NOTE_CPU_RESUMED:
+        break;
+
+      case NOTE_SUSPEND:
+        p = notepack_uint(p,
+                          ((FAR const struct note_suspend_s *)note)->
+                          nsu_state);
+        break;
+
+      case NOTE_RESUME:
+        p = notepack_uint(p, note->nc_priority);
+        break;
+
+      case NOTE_CPU_START:
+      case NOTE_CPU_PAUSE:
+      case NOTE_CPU_RESUME:
+
+        /* The target CPU is the first field of all three */
+
+        p = notepack_uint(p,
+                          ((FAR const struct note_cpu_start_s *)note)->
+                          ncs_target);
+        break;
+
+      case NOTE_PREEMPT_LOCK:
+      case NOTE_PREEMPT_UNLOCK:
+        p = notepack_uint(p,
+                          ((FAR const struct note_preempt_s *)note)->
+                          npr_count);
+        break;
+
+      case NOTE_CSECTION_ENTER:
+      case NOTE_CSECTION_LEAVE:
+#ifdef CONFIG_SMP
+        p = notepack_uint(p,
+                          ((FAR const struct note_csection_s *)note)->
+                          ncs_count);
+#else
+        p = notepack_uint(p, 0);
+#endif
+        break;
+
+      case NOTE_SPINLOCK_LOCK:
+      case NOTE_SPINLOCK_LOCKED:
+      case NOTE_SPINLOCK_UNLOCK:
+      case NOTE_SPINLOCK_ABORT:
+        {
+          FAR const struct note_spinlock_s *nsp = (FAR const void *)note;
+
+          p = notepack_uint(p, nsp->nsp_spinlock);
+          p = notepack_uint(p, nsp->nsp_value);
+        }
+        break;
+
+      case NOTE_SYSCALL_ENTER:
+        {
+          FAR const struct note_syscall_enter_s *nsc =
+            (FAR const void *)note;
+
+          p = notepack_uint(p, nsc->nsc_nr);
+          p = notepack_uint(p, nsc->nsc_argc);
+          for (i = 0; i < nsc->nsc_argc && i < MAX_SYSCALL_ARGS; i++)
+            {
+              p = notepack_uint(p, nsc->nsc_args[i]);
+            }
+        }
+        break;
+
+      case NOTE_SYSCALL_LEAVE:
+        {
+          FAR const struct note_syscall_leave_s *nsc =
+            (FAR const void *)note;
+
+          p = notepack_uint(p, nsc->nsc_nr);
+          p = notepack_uint(p, nsc->nsc_result);
+        }
+        break;
+
+      case NOTE_IRQ_ENTER:
+      case NOTE_IRQ_LEAVE:
+        {
+          FAR const struct note_irqhandler_s *nih = (FAR const void *)note;
+
+          p = notepack_uint(p, nih->nih_irq);
+          p = notepack_uint(p, nih->nih_handler);
+        }
+        break;
+
+      case NOTE_WDOG_START:
+      case NOTE_WDOG_CANCEL:
+      case NOTE_WDOG_ENTER:
+      case NOTE_WDOG_LEAVE:
+        {
+          FAR const struct note_wdog_s *nwd = (FAR const void *)note;
+
+          p = notepack_uint(p, nwd->handler);
+          p = notepack_uint(p, nwd->arg);
+        }
+        break;
+
+      case NOTE_HEAP_ADD:
+      case NOTE_HEAP_REMOVE:
+      case NOTE_HEAP_ALLOC:
+      case NOTE_HEAP_FREE:
+        {
+          FAR const struct note_heap_s *nhp = (FAR const void *)note;
+
+          p = notepack_uint(p, (uintptr_t)nhp->heap);
+          p = notepack_uint(p, (uintptr_t)nhp->mem);
+          p = notepack_uint(p, nhp->size);
+          p = notepack_uint(p, nhp->used);
+        }
+        break;
+
+      case NOTE_DUMP_PRINTF:
+        {
+          FAR const struct note_printf_s *npt = (FAR const void *)note;
+
+          p = notepack_uint(p, npt->npt_ip);
+          p = notepack_uint(p, (uintptr_t)npt->npt_fmt);
+          p = notepack_uint(p, npt->npt_type);
+          p = notepack_data(p, npt->npt_data,
+                            len - offsetof(struct note_printf_s,
+                                           npt_data));
+        }
+        break;
+
+      case NOTE_DUMP_COUNTER:
+        {
+          FAR const struct note_event_s *nev = (FAR const void *)note;
+          FAR const struct note_counter_s *counter =
+            (FAR const void *)nev->nev_data;
+
+          p = notepack_uint(p, nev->nev_ip);
+          p = notepack_sint(p, counter->value);
+          p = notepack_data(p, counter->name,
+                            strnlen(counter->name, sizeof(counter->name)));
+        }
+        break;
+
+      case NOTE_DUMP_BEGIN:
+      case NOTE_DUMP_END:
+      case NOTE_DUMP_MARK:
+        {
+          FAR const struct note_event_s *nev = (FAR const void *)note;
+
+          p = notepack_uint(p, nev->nev_ip);
+          p = notepack_data(p, nev->nev_data,
+                            len - offsetof(struct note_event_s, nev_data));
+        }
+        break;
+
+      default:
+        p = notepack_data(p, note + 1, len - sizeof(*note));
+        break;
+    }
+
+  return p;
+}
+
+/****************************************************************************
+ * Name: notepack_add
+ *
+ * Description:
+ *   Encode a note and write the record to the stream.
+ *
+ ****************************************************************************/
+
+static void notepack_add(FAR struct note_driver_s *drv,
+                         FAR const void *note, size_t len)
+{
+  FAR struct notepack_driver_s *pack = (FAR struct notepack_driver_s *)drv;
+  FAR const struct note_common_s *cmn = note;
+  uint8_t buf[NOTEPACK_BUFSIZE];
+  FAR uint8_t *p = buf;
+  irqstate_t flags;
+
+  DEBUGASSERT(len >= sizeof(*cmn) && len == cmn->nc_length);
+
+  /* The time stamp is relative to the previous record, so the records
+   * have to be encoded and written in the same order.
+   */
+
+  flags = spin_lock_irqsave_wo_note(&pack->lock);
+
+  *p++ = cmn->nc_type;
+  *p++ = cmn->nc_cpu;
+  p = notepack_sint(p, (sclock_t)(cmn->nc_systime - pack->systime));
+  p = notepack_uint(p, (uintmax_t)cmn->nc_pid);
+  p = notepack_fields(p, cmn);
+  DEBUGASSERT(p - buf <= sizeof(buf));
+
+  pack->systime = cmn->nc_systime;
+  lib_stream_puts(&pack->filestream.common, buf, p - buf);
+
+  spin_unlock_irqrestore_wo_note(&pack->lock, flags);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: notepack_register
+ *
+ * Description:
+ *   Register a note driver that writes the packed note stream to a file.
+ *
+ * Input Parameters:
+ *   filename - The file to write to, typically a serial port
+ *
+ * Returned Value:
+ *   Zero on success. A negated errno value is returned on a failure.
+ *
+ ****************************************************************************/
+
+int notepack_register(FAR const char *filename)
+{
+  FAR struct notepack_driver_s *pack;
+  uint8_t header[sizeof(NOTEPACK_MAGIC) + 16];
+  FAR uint8_t *p = header;
+#ifdef CONFIG_SCHED_INSTRUMENTATION_FILTER
+  size_t len = strlen(filename) + 1;
+#else
+  size_t len = 0;
+#endif
+  int ret;
+
+  pack = kmm_zalloc(sizeof(struct notepack_driver_s) + len);
+  if (pack == NULL)
+    {
+      return -ENOMEM;
+    }
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_FILTER
+  memcpy(pack + 1, filename, len);
+  pack->driver.name = (FAR const char *)(pack + 1);
+  pack->driver.filter.mode.flag =
+                      CONFIG_SCHED_INSTRUMENTATION_FILTER_DEFAULT_MODE;
+
+#  ifdef CONFIG_SMP
+  pack->driver.filter.mode.cpuset =
+                      CONFIG_SCHED_INSTRUMENTATION_CPUSET;
+#  endif
+#endif
+
+  ret = file_open(&pack->file, filename, O_WRONLY);
+  if (ret < 0)
+    {
+      kmm_free(pack);
+      return ret;
+    }
+
+  pack->driver.ops = &g_notepack_ops;
+  spin_lock_init(&pack->lock);
+  lib_fileoutstream(&pack->filestream, &pack->file);
+
+  /* Write the stream header before the first record */
+
+  memcpy(p, NOTEPACK_MAGIC, sizeof(NOTEPACK_MAGIC) - 1);
+  p += sizeof(NOTEPACK_MAGIC) - 1;
+  *p++ = NOTEPACK_VERSION;
+  p = notepack_uint(p, perf_getfreq());
+  lib_stream_puts(&pack->filestream.common, header, p - header);
+
+  return note_driver_register(&pack->driver);
+}
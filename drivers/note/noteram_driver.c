@@ -70,19 +70,41 @@
 #define get_task_state(s)                                                    \
   ((s) == 0 ? 'X' : ((s) <= LAST_READY_TO_RUN_STATE ? 'R' : 'S'))
 
+/* With per-CPU buffers, the buffer is split into one ring per CPU.  Each
+ * CPU only adds to its own ring, so the CPUs never contend for a lock or
+ * a cache line, and the reader merges the rings by time stamp.
+ */
+
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+#  define NOTERAM_NRINGS NCPUS
+#  define noteram_this_ring(drv) (&(drv)->ni_ring[this_cpu()])
+#else
+#  define NOTERAM_NRINGS 1
+#  define noteram_this_ring(drv) (&(drv)->ni_ring[0])
+#endif
+
+#define noteram_ring_buffer(drv, ring) \
+  ((drv)->ni_buffer + ((ring) - (drv)->ni_ring) * (drv)->ni_bufsize)
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+struct noteram_ring_s
+{
+  volatile unsigned int ni_head;
+  volatile unsigned int ni_tail;
+  volatile unsigned int ni_read;
+  spinlock_t lock;
+};
+
 struct noteram_driver_s
 {
   struct note_driver_s driver;
   FAR uint8_t *ni_buffer;
-  size_t ni_bufsize;
+  size_t ni_bufsize;                 /* Size of each ring */
   unsigned int ni_overwrite;
-  volatile unsigned int ni_head;
-  volatile unsigned int ni_tail;
-  volatile unsigned int ni_read;
+  struct noteram_ring_s ni_ring[NOTERAM_NRINGS];
   spinlock_t lock;
   FAR struct pollfd *pfd;
 };
@@ -173,7 +195,7 @@ struct noteram_driver_s g_noteram_driver =
     &g_noteram_ops
   },
   g_ramnote_buffer,
-  CONFIG_DRIVERS_NOTERAM_BUFSIZE,
+  CONFIG_DRIVERS_NOTERAM_BUFSIZE / NOTERAM_NRINGS,
 #ifdef CONFIG_DRIVERS_NOTERAM_DEFAULT_NOOVERWRITE
   NOTERAM_MODE_OVERWRITE_DISABLE
 #else
@@ -201,8 +223,16 @@ struct noteram_driver_s g_noteram_driver =
 
 static void noteram_buffer_clear(FAR struct noteram_driver_s *drv)
 {
-  drv->ni_tail = drv->ni_head;
-  drv->ni_read = drv->ni_head;
+  FAR struct noteram_ring_s *ring;
+  irqstate_t flags;
+
+  for (ring = drv->ni_ring; ring < &drv->ni_ring[NOTERAM_NRINGS]; ring++)
+    {
+      flags = spin_lock_irqsave_wo_note(&ring->lock);
+      ring->ni_tail = ring->ni_head;
+      ring->ni_read = ring->ni_head;
+      spin_unlock_irqrestore_wo_note(&ring->lock, flags);
+    }
 
   if (drv->ni_overwrite == NOTERAM_MODE_OVERWRITE_OVERFLOW)
     {
@@ -252,10 +282,11 @@ static inline unsigned int noteram_next(FAR struct noteram_driver_s *drv,
  *
  ****************************************************************************/
 
-static unsigned int noteram_length(FAR struct noteram_driver_s *drv)
+static unsigned int noteram_length(FAR struct noteram_driver_s *drv,
+                                   FAR struct noteram_ring_s *ring)
 {
-  unsigned int head = drv->ni_head;
-  unsigned int tail = drv->ni_tail;
+  unsigned int head = ring->ni_head;
+  unsigned int tail = ring->ni_tail;
 
   if (tail > head)
     {
@@ -279,10 +310,11 @@ static unsigned int noteram_length(FAR struct noteram_driver_s *drv)
  *
  ****************************************************************************/
 
-static unsigned int noteram_unread_length(FAR struct noteram_driver_s *drv)
+static unsigned int noteram_unread_length(FAR struct noteram_driver_s *drv,
+                                          FAR struct noteram_ring_s *ring)
 {
-  unsigned int head = drv->ni_head;
-  unsigned int read = drv->ni_read;
+  unsigned int head = ring->ni_head;
+  unsigned int read = ring->ni_read;
 
   if (read > head)
     {
@@ -309,33 +341,34 @@ static unsigned int noteram_unread_length(FAR struct noteram_driver_s *drv)
  *
  ****************************************************************************/
 
-static void noteram_remove(FAR struct noteram_driver_s *drv)
+static void noteram_remove(FAR struct noteram_driver_s *drv,
+                           FAR struct noteram_ring_s *ring)
 {
   unsigned int tail;
   unsigned int length;
 
   /* Get the tail index of the circular buffer */
 
-  tail = drv->ni_tail;
+  tail = ring->ni_tail;
   DEBUGASSERT(tail < drv->ni_bufsize);
 
   /* Get the length of the note at the tail index */
 
-  length = NOTE_ALIGN(drv->ni_buffer[tail]);
-  DEBUGASSERT(length <= noteram_length(drv));
+  length = NOTE_ALIGN(noteram_ring_buffer(drv, ring)[tail]);
+  DEBUGASSERT(length <= noteram_length(drv, ring));
 
   /* Increment the tail index to remove the entire note from the circular
    * buffer.
    */
 
-  if (drv->ni_read == drv->ni_tail)
+  if (ring->ni_read == ring->ni_tail)
     {
       /* The read index also needs increment. */
 
-      drv->ni_read = noteram_next(drv, tail, length);
+      ring->ni_read = noteram_next(drv, tail, length);
     }
 
-  drv->ni_tail = noteram_next(drv, tail, length);
+  ring->ni_tail = noteram_next(drv, tail, length);
 }
 
 /****************************************************************************
@@ -355,10 +388,11 @@ static void noteram_remove(FAR struct noteram_driver_s *drv)
  *
  ****************************************************************************/
 
-static ssize_t noteram_get(FAR struct noteram_driver_s *drv,
-                           FAR uint8_t *buffer, size_t buflen)
+static ssize_t noteram_get_ring(FAR struct noteram_driver_s *drv,
+                                FAR struct noteram_ring_s *ring,
+                                FAR uint8_t *buffer, size_t buflen)
 {
-  FAR struct note_common_s *note;
+  FAR uint8_t *ni_buffer = noteram_ring_buffer(drv, ring);
   unsigned int remaining;
   unsigned int read;
   ssize_t notelen;
@@ -368,7 +402,7 @@ static ssize_t noteram_get(FAR struct noteram_driver_s *drv,
 
   /* Verify that the circular buffer is not empty */
 
-  circlen = noteram_unread_length(drv);
+  circlen = noteram_unread_length(drv, ring);
   if (circlen <= 0)
     {
       return 0;
@@ -376,13 +410,14 @@ static ssize_t noteram_get(FAR struct noteram_driver_s *drv,
 
   /* Get the read index of the circular buffer */
 
-  read = drv->ni_read;
+  read = ring->ni_read;
   DEBUGASSERT(read < drv->ni_bufsize);
 
-  /* Get the length of the note at the read index */
+  /* Get the length of the note at the read index, nc_length is the first
+   * byte of the note.
+   */
 
-  note = (FAR struct note_common_s *)&drv->ni_buffer[read];
-  notelen = note->nc_length;
+  notelen = ni_buffer[read];
   DEBUGASSERT(notelen <= circlen);
 
   /* Is the user buffer large enough to hold the note? */
@@ -391,7 +426,7 @@ static ssize_t noteram_get(FAR struct noteram_driver_s *drv,
     {
       /* Skip the large note so that we do not get constipated. */
 
-      drv->ni_read = noteram_next(drv, read, NOTE_ALIGN(notelen));
+      ring->ni_read = noteram_next(drv, read, NOTE_ALIGN(notelen));
 
       /* and return an error */
 
@@ -405,7 +440,7 @@ static ssize_t noteram_get(FAR struct noteram_driver_s *drv,
     {
       /* Copy the next byte at the read index */
 
-      *buffer++ = drv->ni_buffer[read];
+      *buffer++ = ni_buffer[read];
 
       /* Adjust indices and counts */
 
@@ -413,11 +448,128 @@ static ssize_t noteram_get(FAR struct noteram_driver_s *drv,
       remaining--;
     }
 
-  drv->ni_read = noteram_next(drv, drv->ni_read, NOTE_ALIGN(notelen));
+  ring->ni_read = noteram_next(drv, ring->ni_read, NOTE_ALIGN(notelen));
 
   return notelen;
 }
 
+/****************************************************************************
+ * Name: noteram_peek_time
+ *
+ * Description:
+ *   Get the time stamp of the next unread note of a ring.
+ *
+ * Returned Value:
+ *   True if the ring has an unread note.
+ *
+ * Assumptions:
+ *   The ring is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+static bool noteram_peek_time(FAR struct noteram_driver_s *drv,
+                              FAR struct noteram_ring_s *ring,
+                              FAR clock_t *systime)
+{
+  FAR uint8_t *ni_buffer = noteram_ring_buffer(drv, ring);
+  struct note_common_s note;
+  FAR uint8_t *dest = (FAR uint8_t *)&note;
+  unsigned int read;
+  size_t i;
+
+  if (noteram_unread_length(drv, ring) == 0)
+    {
+      return false;
+    }
+
+  /* The note header may wrap around the end of the ring */
+
+  read = ring->ni_read;
+  for (i = 0; i < sizeof(note); i++)
+    {
+      dest[i] = ni_buffer[read];
+      read = noteram_next(drv, read, 1);
+    }
+
+  *systime = note.nc_systime;
+  return true;
+}
+#endif
+
+/****************************************************************************
+ * Name: noteram_get
+ *
+ * Description:
+ *   Get the next note in time order.  With per-CPU buffers, this is the
+ *   oldest of the next unread notes of all rings.
+ *
+ * Input Parameters:
+ *   buffer - Location to return the next note
+ *   buflen - The length of the user provided buffer.
+ *
+ * Returned Value:
+ *   Same as noteram_get_ring().
+ *
+ ****************************************************************************/
+
+static ssize_t noteram_get(FAR struct noteram_driver_s *drv,
+                           FAR uint8_t *buffer, size_t buflen)
+{
+  FAR struct noteram_ring_s *ring = &drv->ni_ring[0];
+  irqstate_t flags;
+  ssize_t ret;
+
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+  FAR struct noteram_ring_s *curr;
+  clock_t oldest = 0;
+  clock_t systime;
+  bool found = false;
+
+  for (curr = drv->ni_ring; curr < &drv->ni_ring[NOTERAM_NRINGS]; curr++)
+    {
+      flags = spin_lock_irqsave_wo_note(&curr->lock);
+      if (noteram_peek_time(drv, curr, &systime) &&
+          (!found || (sclock_t)(systime - oldest) < 0))
+        {
+          oldest = systime;
+          ring   = curr;
+          found  = true;
+        }
+
+      spin_unlock_irqrestore_wo_note(&curr->lock, flags);
+    }
+#endif
+
+  flags = spin_lock_irqsave_wo_note(&ring->lock);
+  ret = noteram_get_ring(drv, ring, buffer, buflen);
+  spin_unlock_irqrestore_wo_note(&ring->lock, flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: noteram_unread
+ *
+ * Description:
+ *   Check whether there are unread notes in any ring.
+ *
+ ****************************************************************************/
+
+static bool noteram_unread(FAR struct noteram_driver_s *drv)
+{
+  int i;
+
+  for (i = 0; i < NOTERAM_NRINGS; i++)
+    {
+      if (noteram_unread_length(drv, &drv->ni_ring[i]) > 0)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
 /****************************************************************************
  * Name: noteram_open
  ****************************************************************************/
@@ -427,10 +579,15 @@ static int noteram_open(FAR struct file *filep)
   FAR struct noteram_dump_context_s *ctx;
   FAR struct noteram_driver_s *drv = (FAR struct noteram_driver_s *)
                                      filep->f_inode->i_private;
+  int i;
 
   /* Reset the read index of the circular buffer */
 
-  drv->ni_read = drv->ni_tail;
+  for (i = 0; i < NOTERAM_NRINGS; i++)
+    {
+      drv->ni_ring[i].ni_read = drv->ni_ring[i].ni_tail;
+    }
+
   ctx = kmm_zalloc(sizeof(*ctx));
   if (ctx == NULL)
     {
@@ -461,13 +618,10 @@ static ssize_t noteram_read(FAR struct file *filep, FAR char *buffer,
   FAR struct noteram_driver_s *drv = filep->f_inode->i_private;
   FAR struct lib_memoutstream_s stream;
   ssize_t ret;
-  irqstate_t flags;
 
   if (ctx->mode == NOTERAM_MODE_READ_BINARY)
     {
-      flags = spin_lock_irqsave_wo_note(&drv->lock);
       ret = noteram_get(drv, (FAR uint8_t *)buffer, buflen);
-      spin_unlock_irqrestore_wo_note(&drv->lock, flags);
     }
   else
     {
@@ -479,9 +633,7 @@ static ssize_t noteram_read(FAR struct file *filep, FAR char *buffer,
 
           /* Get the next note (removing it from the buffer) */
 
-          flags = spin_lock_irqsave_wo_note(&drv->lock);
           ret = noteram_get(drv, note, sizeof(note));
-          spin_unlock_irqrestore_wo_note(&drv->lock, flags);
           if (ret <= 0)
             {
               return ret;
@@ -651,7 +803,7 @@ static int noteram_poll(FAR struct file *filep, FAR struct pollfd *fds,
        * don't wait for RX.
        */
 
-      if (noteram_unread_length(drv) > 0)
+      if (noteram_unread(drv))
         {
           spin_unlock_irqrestore_wo_note(&drv->lock, flags);
           poll_notify(&drv->pfd, 1, POLLIN);
@@ -691,21 +843,36 @@ static void noteram_add(FAR struct note_driver_s *driver,
 {
   FAR const char *buf = note;
   FAR struct noteram_driver_s *drv = (FAR struct noteram_driver_s *)driver;
+  FAR struct noteram_ring_s *ring;
+  FAR uint8_t *ni_buffer;
   unsigned int head;
   unsigned int remain;
   unsigned int space;
   irqstate_t flags;
 
-  flags = spin_lock_irqsave_wo_note(&drv->lock);
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+  /* Stay on this CPU while adding to its ring, only the reader may contend
+   * for the lock of the ring.
+   */
+
+  flags = up_irq_save();
+  ring  = noteram_this_ring(drv);
+  spin_lock_wo_note(&ring->lock);
+#else
+  ring  = noteram_this_ring(drv);
+  flags = spin_lock_irqsave_wo_note(&ring->lock);
+#endif
+
+  ni_buffer = noteram_ring_buffer(drv, ring);
 
   if (drv->ni_overwrite == NOTERAM_MODE_OVERWRITE_OVERFLOW)
     {
-      spin_unlock_irqrestore_wo_note(&drv->lock, flags);
+      spin_unlock_irqrestore_wo_note(&ring->lock, flags);
       return;
     }
 
   DEBUGASSERT(note != NULL && notelen < drv->ni_bufsize);
-  remain = drv->ni_bufsize - noteram_length(drv);
+  remain = drv->ni_bufsize - noteram_length(drv, ring);
 
   if (remain <= NOTE_ALIGN(notelen))
     {
@@ -714,7 +881,7 @@ static void noteram_add(FAR struct note_driver_s *driver,
           /* Stop recording if not in overwrite mode */
 
           drv->ni_overwrite = NOTERAM_MODE_OVERWRITE_OVERFLOW;
-          spin_unlock_irqrestore_wo_note(&drv->lock, flags);
+          spin_unlock_irqrestore_wo_note(&ring->lock, flags);
           return;
         }
 
@@ -723,19 +890,19 @@ static void noteram_add(FAR struct note_driver_s *driver,
 
       do
         {
-          noteram_remove(drv);
-          remain = drv->ni_bufsize - noteram_length(drv);
+          noteram_remove(drv, ring);
+          remain = drv->ni_bufsize - noteram_length(drv, ring);
         }
       while (remain <= NOTE_ALIGN(notelen));
     }
 
-  head = drv->ni_head;
+  head = ring->ni_head;
   space = drv->ni_bufsize - head;
   space = space < notelen ? space : notelen;
-  memcpy(drv->ni_buffer + head, note, space);
-  memcpy(drv->ni_buffer, buf + space, notelen - space);
-  drv->ni_head = noteram_next(drv, head, NOTE_ALIGN(notelen));
-  spin_unlock_irqrestore_wo_note(&drv->lock, flags);
+  memcpy(ni_buffer + head, note, space);
+  memcpy(ni_buffer, buf + space, notelen - space);
+  ring->ni_head = noteram_next(drv, head, NOTE_ALIGN(notelen));
+  spin_unlock_irqrestore_wo_note(&ring->lock, flags);
   poll_notify(&drv->pfd, 1, POLLIN);
 }
 
@@ -1366,12 +1533,11 @@ noteram_initialize(FAR const char *devpath, size_t bufsize, bool overwrite)
 #endif
 
   drv->driver.ops = &g_noteram_ops;
-  drv->ni_bufsize = bufsize;
+  drv->ni_bufsize = bufsize / NOTERAM_NRINGS;
   drv->ni_buffer = (FAR uint8_t *)(drv + 1) + len;
   drv->ni_overwrite = overwrite;
-  drv->ni_head = 0;
-  drv->ni_tail = 0;
-  drv->ni_read = 0;
+  memset(drv->ni_ring, 0, sizeof(drv->ni_ring));
+  spin_lock_init(&drv->lock);
   drv->pfd = NULL;
 
   ret = note_driver_register(&drv->driver);
@@ -0,0 +1,732 @@
+/****************************************************************************
+ * drivers/perf/perf_event.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/perf_event.h>
+#include <nuttx/queue.h>
+#include <nuttx/sched.h>
+#include <nuttx/sched_callgraph.h>
+#include <nuttx/sched_note.h>
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* An opened event.  Its fields are protected by the critical section, and
+ * its counter is only touched on the CPU it is loaded on.
+ */
+
+struct perf_event_s
+{
+  sq_entry_t               node;       /* In the list of its thread or CPU */
+  struct perf_event_attr_s attr;       /* What was opened */
+  uint64_t                 hwevent;    /* The event encoded for the PMU */
+  FAR struct tcb_s        *tcb;        /* The thread counted, or NULL */
+  int                      cpu;        /* The CPU counted, or -1 */
+  int                      hwcpu;      /* The CPU of the counter, or -1 */
+  int                      idx;        /* The counter on hwcpu */
+  int                      crefs;      /* Open file descriptors */
+  bool                     enabled;    /* Enabled by the user */
+  uint64_t                 count;      /* The count at the last update */
+  uint64_t                 prev;       /* The counter at the last update */
+  clock_t                  tenabled;   /* Time enabled until tenable */
+  clock_t                  tenable;    /* Time it was last enabled */
+  clock_t                  trunning;   /* Time counted until trun */
+  clock_t                  trun;       /* Time of the last update */
+#ifdef CONFIG_PERF_EVENTS_SAMPLE
+  char                     name[NAME_MAX]; /* Name of the sample notes */
+#endif
+};
+
+/* The counters of a CPU */
+
+struct perf_cpu_s
+{
+  FAR struct perf_event_s *counters[CONFIG_PERF_EVENTS_NCOUNTERS];
+  sq_queue_t               events;     /* The events counting the CPU */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int perf_file_open(FAR struct file *filep);
+static int perf_file_close(FAR struct file *filep);
+static ssize_t perf_file_read(FAR struct file *filep, FAR char *buffer,
+                              size_t len);
+static int perf_file_ioctl(FAR struct file *filep, int cmd,
+                           unsigned long arg);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_perf_event_fops =
+{
+  perf_file_open,  /* open */
+  perf_file_close, /* close */
+  perf_file_read,  /* read */
+  NULL,            /* write */
+  NULL,            /* seek */
+  perf_file_ioctl, /* ioctl */
+};
+
+static struct inode g_perf_event_inode =
+{
+  NULL,                   /* i_parent */
+  NULL,                   /* i_peer */
+  NULL,                   /* i_child */
+  1,                      /* i_crefs */
+  FSNODEFLAG_TYPE_DRIVER, /* i_flags */
+  {
+    &g_perf_event_fops    /* u */
+  }
+};
+
+static FAR struct pmu_s *g_pmu;
+static struct perf_cpu_s g_perf_cpu[CONFIG_SMP_NCPUS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static inline uint64_t perf_event_mask(void)
+{
+  return g_pmu->width >= 64 ? UINT64_MAX :
+                              ((uint64_t)1 << g_pmu->width) - 1;
+}
+
+/* The value a counter starts from, so that it overflows after the sample
+ * period.
+ */
+
+static uint64_t perf_event_startvalue(FAR struct perf_event_s *event)
+{
+  uint64_t period = event->attr.sample_period;
+
+  if (period == 0 || period > perf_event_mask())
+    {
+      return 0;
+    }
+
+  return (0 - period) & perf_event_mask();
+}
+
+/* Add what the counter counted since the last update, on its CPU */
+
+static void perf_event_update(FAR struct perf_event_s *event)
+{
+  uint64_t value;
+  clock_t now;
+
+  if (event->hwcpu != this_cpu())
+    {
+      return;
+    }
+
+  value           = g_pmu->ops->read(g_pmu, event->idx);
+  event->count   += (value - event->prev) & perf_event_mask();
+  event->prev     = value;
+
+  now             = perf_gettime();
+  event->trunning += now - event->trun;
+  event->trun     = now;
+}
+
+/* Give a free counter of the CPU to the event, if there is one */
+
+static void perf_event_load(FAR struct perf_event_s *event)
+{
+  FAR struct perf_cpu_s *pcpu = &g_perf_cpu[this_cpu()];
+  int ncounters = MIN(g_pmu->ncounters, CONFIG_PERF_EVENTS_NCOUNTERS);
+  int idx;
+
+  for (idx = 0; idx < ncounters && pcpu->counters[idx] != NULL; idx++)
+    {
+    }
+
+  if (idx >= ncounters)
+    {
+      return;
+    }
+
+  event->prev  = perf_event_startvalue(event);
+  event->trun  = perf_gettime();
+  event->idx   = idx;
+  event->hwcpu = this_cpu();
+  pcpu->counters[idx] = event;
+
+  g_pmu->ops->start(g_pmu, idx, event->hwevent, event->prev, g_pmu->irq);
+}
+
+/* Save the count of the event and free its counter, on its CPU */
+
+static void perf_event_unload(FAR struct perf_event_s *event)
+{
+  if (event->hwcpu != this_cpu())
+    {
+      return;
+    }
+
+  perf_event_update(event);
+  g_pmu->ops->stop(g_pmu, event->idx);
+
+  g_perf_cpu[event->hwcpu].counters[event->idx] = NULL;
+  event->hwcpu = -1;
+}
+
+/* Bring the counter of the event in line with its state.  Run on the CPU
+ * that counts it or that runs its thread, with nxsched_smp_call_single().
+ */
+
+static int perf_event_sync(FAR void *arg)
+{
+  FAR struct perf_event_s *event = arg;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  if (event->hwcpu == this_cpu())
+    {
+      if (event->enabled)
+        {
+          perf_event_update(event);
+        }
+      else
+        {
+          perf_event_unload(event);
+        }
+    }
+  else if (event->hwcpu < 0 && event->enabled &&
+           (event->tcb != NULL ? event->tcb == nxsched_self() :
+                                 event->cpu == this_cpu()))
+    {
+      perf_event_load(event);
+    }
+
+  leave_critical_section(flags);
+  return OK;
+}
+
+static void perf_event_call(FAR struct perf_event_s *event)
+{
+#ifdef CONFIG_SMP
+  FAR struct tcb_s *tcb = event->tcb;
+  int cpu = this_cpu();
+
+  /* The event may move in the meantime, perf_event_sync() then leaves it
+   * to the scheduler.
+   */
+
+  if (event->hwcpu >= 0)
+    {
+      cpu = event->hwcpu;
+    }
+  else if (event->cpu >= 0)
+    {
+      cpu = event->cpu;
+    }
+  else if (tcb != NULL && tcb->task_state == TSTATE_TASK_RUNNING)
+    {
+      cpu = tcb->cpu;
+    }
+
+  nxsched_smp_call_single(cpu, perf_event_sync, event, true);
+#else
+  perf_event_sync(event);
+#endif
+}
+
+static uint64_t perf_event_nsec(clock_t elapsed)
+{
+  struct timespec ts;
+
+  perf_convert(elapsed, &ts);
+  return (uint64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+static int perf_file_open(FAR struct file *filep)
+{
+  FAR struct perf_event_s *event = filep->f_priv;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  event->crefs++;
+  leave_critical_section(flags);
+  return OK;
+}
+
+static int perf_file_close(FAR struct file *filep)
+{
+  FAR struct perf_event_s *event = filep->f_priv;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  if (--event->crefs > 0)
+    {
+      leave_critical_section(flags);
+      return OK;
+    }
+
+  event->enabled = false;
+  leave_critical_section(flags);
+
+  /* Free the counter, the scheduler no longer loads a disabled event */
+
+  while (event->hwcpu >= 0)
+    {
+      perf_event_call(event);
+    }
+
+  flags = enter_critical_section();
+  if (event->tcb != NULL)
+    {
+      sq_rem(&event->node, &event->tcb->perf_events);
+    }
+  else if (event->cpu >= 0)
+    {
+      sq_rem(&event->node, &g_perf_cpu[event->cpu].events);
+    }
+
+  leave_critical_section(flags);
+
+  kmm_free(event);
+  return OK;
+}
+
+static ssize_t perf_file_read(FAR struct file *filep, FAR char *buffer,
+                              size_t len)
+{
+  FAR struct perf_event_s *event = filep->f_priv;
+  struct perf_event_value_s value;
+  irqstate_t flags;
+  clock_t tenabled;
+  clock_t trunning;
+
+  if (buffer == NULL || len < sizeof(value.value))
+    {
+      return -EINVAL;
+    }
+
+  perf_event_call(event);
+
+  flags       = enter_critical_section();
+  value.value = event->count;
+  tenabled    = event->tenabled;
+  trunning    = event->trunning;
+  if (event->enabled)
+    {
+      tenabled += perf_gettime() - event->tenable;
+    }
+
+  leave_critical_section(flags);
+
+  value.enabled = perf_event_nsec(tenabled);
+  value.running = perf_event_nsec(trunning);
+
+  len = len < sizeof(value) ? sizeof(value.value) : sizeof(value);
+  memcpy(buffer, &value, len);
+  return len;
+}
+
+static int perf_file_ioctl(FAR struct file *filep, int cmd,
+                           unsigned long arg)
+{
+  FAR struct perf_event_s *event = filep->f_priv;
+  FAR uint64_t *period;
+  irqstate_t flags;
+  int ret = OK;
+
+  switch (cmd)
+    {
+      case PERF_EVENT_IOC_ENABLE:
+      case PERF_EVENT_IOC_DISABLE:
+        flags = enter_critical_section();
+        if (event->enabled != (cmd == PERF_EVENT_IOC_ENABLE))
+          {
+            event->enabled = !event->enabled;
+            if (event->enabled)
+              {
+                event->tenable = perf_gettime();
+              }
+            else
+              {
+                event->tenabled += perf_gettime() - event->tenable;
+              }
+          }
+
+        leave_critical_section(flags);
+        perf_event_call(event);
+        break;
+
+      case PERF_EVENT_IOC_RESET:
+        perf_event_call(event);
+        flags = enter_critical_section();
+        event->count = 0;
+        leave_critical_section(flags);
+        break;
+
+      case PERF_EVENT_IOC_PERIOD:
+        period = (FAR uint64_t *)(uintptr_t)arg;
+        if (period == NULL)
+          {
+            ret = -EINVAL;
+          }
+        else if (*period != 0 && !g_pmu->irq)
+          {
+            ret = -EOPNOTSUPP;
+          }
+        else
+          {
+            /* Taken into account from the next overflow or switch */
+
+            event->attr.sample_period = *period;
+          }
+        break;
+
+      default:
+        ret = -ENOTTY;
+        break;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: perf_event_open
+ *
+ * Description:
+ *   Open a file descriptor counting the event of attr.  It counts the
+ *   thread pid (0 for the caller) on any CPU if cpu is -1, or every thread
+ *   on the CPU cpu if pid is -1.
+ *
+ * Input Parameters:
+ *   attr  - The event to count
+ *   pid   - The thread to count, 0 or -1
+ *   cpu   - The CPU to count, or -1
+ *   flags - PERF_FLAG_FD_CLOEXEC or zero
+ *
+ * Returned Value:
+ *   The file descriptor on success; -1 (ERROR) with errno set on failure.
+ *
+ ****************************************************************************/
+
+int perf_event_open(FAR const struct perf_event_attr_s *attr, pid_t pid,
+                    int cpu, unsigned long flags)
+{
+  FAR struct perf_event_s *event;
+  FAR struct tcb_s *tcb = NULL;
+  irqstate_t irqflags;
+  uint64_t hwevent;
+  int ret;
+  int fd;
+
+  if (g_pmu == NULL)
+    {
+      ret = -ENODEV;
+      goto errout;
+    }
+
+  if (attr == NULL || (flags & ~PERF_FLAG_FD_CLOEXEC) != 0 ||
+      (attr->type != PERF_TYPE_HARDWARE && attr->type != PERF_TYPE_RAW) ||
+      (attr->type == PERF_TYPE_HARDWARE &&
+       attr->config >= PERF_COUNT_HW_MAX))
+    {
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  if (attr->sample_period != 0 && !g_pmu->irq)
+    {
+      ret = -EOPNOTSUPP;
+      goto errout;
+    }
+
+  if (pid < 0 ? cpu < 0 || cpu >= CONFIG_SMP_NCPUS : cpu != -1)
+    {
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  ret = g_pmu->ops->event_init(g_pmu, attr, &hwevent);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  event = kmm_zalloc(sizeof(*event));
+  if (event == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  event->attr    = *attr;
+  event->hwevent = hwevent;
+  event->cpu     = pid < 0 ? cpu : -1;
+  event->hwcpu   = -1;
+  event->idx     = -1;
+  event->crefs   = 1;
+  event->enabled = (attr->flags & PERF_ATTR_DISABLED) == 0;
+  event->tenable = perf_gettime();
+#ifdef CONFIG_PERF_EVENTS_SAMPLE
+  snprintf(event->name, sizeof(event->name), "perf%" PRIu32 ":%" PRIx64,
+           attr->type, attr->config);
+#endif
+
+  /* Attach it to the thread, unless the thread is going away */
+
+  irqflags = enter_critical_section();
+  if (pid >= 0)
+    {
+      tcb = nxsched_get_tcb(pid == 0 ? nxsched_gettid() : pid);
+      if (tcb == NULL || (tcb->flags & TCB_FLAG_EXIT_PROCESSING) != 0)
+        {
+          leave_critical_section(irqflags);
+          kmm_free(event);
+          ret = -ESRCH;
+          goto errout;
+        }
+
+      event->tcb = tcb;
+      sq_addlast(&event->node, &tcb->perf_events);
+    }
+  else
+    {
+      sq_addlast(&event->node, &g_perf_cpu[cpu].events);
+    }
+
+  leave_critical_section(irqflags);
+
+  fd = file_allocate(&g_perf_event_inode, O_RDONLY |
+                     ((flags & PERF_FLAG_FD_CLOEXEC) != 0 ? O_CLOEXEC : 0),
+                     0, event, 0, true);
+  if (fd < 0)
+    {
+      irqflags = enter_critical_section();
+      if (event->tcb != NULL)
+        {
+          sq_rem(&event->node, &event->tcb->perf_events);
+        }
+      else if (event->cpu >= 0)
+        {
+          sq_rem(&event->node, &g_perf_cpu[cpu].events);
+        }
+
+      leave_critical_section(irqflags);
+      kmm_free(event);
+      ret = fd;
+      goto errout;
+    }
+
+  if (event->enabled)
+    {
+      perf_event_call(event);
+    }
+
+  return fd;
+
+errout:
+  set_errno(-ret);
+  return ERROR;
+}
+
+/****************************************************************************
+ * Name: pmu_register
+ *
+ * Description:
+ *   Register the PMU driver of the architecture, there is only one.
+ *
+ ****************************************************************************/
+
+int pmu_register(FAR struct pmu_s *pmu)
+{
+  if (g_pmu != NULL)
+    {
+      return -EBUSY;
+    }
+
+  g_pmu = pmu;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: perf_event_overflow
+ *
+ * Description:
+ *   Called by the PMU driver from its interrupt handler, when the counter
+ *   idx of the CPU overflowed.  The count is updated with the wrap of the
+ *   counter.  A sampling event restarts its period and records a note with
+ *   the interrupted PC.
+ *
+ ****************************************************************************/
+
+void perf_event_overflow(int idx, uintptr_t ip)
+{
+  FAR struct perf_event_s *event;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  event = g_perf_cpu[this_cpu()].counters[idx];
+  if (event == NULL)
+    {
+      leave_critical_section(flags);
+      return;
+    }
+
+  perf_event_update(event);
+
+  if (event->attr.sample_period != 0)
+    {
+#ifdef CONFIG_PERF_EVENTS_SAMPLE
+      struct note_counter_s note;
+
+      note.value = (long)event->count;
+      strlcpy(note.name, event->name, sizeof(note.name));
+      sched_note_event_ip(NOTE_TAG_DRIVERS, ip, NOTE_DUMP_COUNTER,
+                          &note, sizeof(note));
+#endif
+#ifdef CONFIG_SCHED_CALLGRAPH
+      sched_callgraph_sample();
+#endif
+
+      event->prev = perf_event_startvalue(event);
+      g_pmu->ops->start(g_pmu, idx, event->hwevent, event->prev, true);
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: perf_event_sched_in
+ *
+ * Description:
+ *   Load the enabled events of the thread switched in on the counters left
+ *   free.
+ *
+ ****************************************************************************/
+
+void perf_event_sched_in(FAR struct tcb_s *tcb)
+{
+  FAR sq_entry_t *node;
+  irqstate_t flags;
+
+  if (g_pmu == NULL || sq_empty(&tcb->perf_events))
+    {
+      return;
+    }
+
+  flags = enter_critical_section();
+  sq_for_every(&tcb->perf_events, node)
+    {
+      FAR struct perf_event_s *event =
+        container_of(node, struct perf_event_s, node);
+
+      if (event->enabled && event->hwcpu < 0)
+        {
+          perf_event_load(event);
+        }
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: perf_event_sched_out
+ *
+ * Description:
+ *   Save the counts of the thread switched out and free its counters.
+ *
+ ****************************************************************************/
+
+void perf_event_sched_out(FAR struct tcb_s *tcb)
+{
+  FAR sq_entry_t *node;
+  irqstate_t flags;
+
+  if (g_pmu == NULL || sq_empty(&tcb->perf_events))
+    {
+      return;
+    }
+
+  flags = enter_critical_section();
+  sq_for_every(&tcb->perf_events, node)
+    {
+      perf_event_unload(container_of(node, struct perf_event_s, node));
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: perf_event_exit
+ *
+ * Description:
+ *   Detach the events of an exiting thread.  They keep their count until
+ *   they are closed.
+ *
+ ****************************************************************************/
+
+void perf_event_exit(FAR struct tcb_s *tcb)
+{
+  FAR struct perf_event_s *event;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  while ((event = (FAR struct perf_event_s *)
+                  sq_remfirst(&tcb->perf_events)) != NULL)
+    {
+      perf_event_unload(event);
+      if (event->enabled)
+        {
+          event->tenabled += perf_gettime() - event->tenable;
+          event->enabled   = false;
+        }
+
+      event->tcb = NULL;
+    }
+
+  leave_critical_section(flags);
+}
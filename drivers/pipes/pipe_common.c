@@ -31,6 +31,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdlib.h>
+#include <limits.h>
 #include <string.h>
 #include <sched.h>
 #include <fcntl.h>
@@ -40,6 +41,7 @@
 
 #include <nuttx/kmalloc.h>
 #include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
 
@@ -79,6 +81,561 @@ static void pipecommon_wakeup(FAR sem_t *sem)
     }
 }
 
+/****************************************************************************
+ * Name: pipecommon_waitdata
+ *
+ * Description:
+ *   Wait until there is data in the pipe.  Called and returns with the
+ *   d_bflock held on success.
+ *
+ * Returned Value:
+ *   One (1) if there is data, zero at the end of file, or a negated errno
+ *   value on failure, the d_bflock is released in these two cases.
+ *
+ ****************************************************************************/
+
+static int pipecommon_waitdata(FAR struct pipe_dev_s *dev, bool nonblock)
+{
+  int ret;
+
+  while (circbuf_is_empty(&dev->d_buffer))
+    {
+      if (dev->d_nwriters <= 0 && PIPE_IS_POLICY_0(dev->d_flags))
+        {
+          nxrmutex_unlock(&dev->d_bflock);
+          return 0;
+        }
+
+      nxrmutex_unlock(&dev->d_bflock);
+      if (nonblock)
+        {
+          return -EAGAIN;
+        }
+
+#ifdef CONFIG_DEV_PIPE_SPSC
+      /* A lock-free writer only wakes readers that say they wait */
+
+      dev->d_rdwaiting = true;
+      SP_DMB();
+      if (!circbuf_is_empty(&dev->d_buffer))
+        {
+          ret = nxrmutex_lock(&dev->d_bflock);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          continue;
+        }
+#endif
+
+      ret = nxsem_wait(&dev->d_rdsem);
+      if (ret < 0 || (ret = nxrmutex_lock(&dev->d_bflock)) < 0)
+        {
+          return ret;
+        }
+    }
+
+  return 1;
+}
+
+/****************************************************************************
+ * Name: pipecommon_waitspace
+ *
+ * Description:
+ *   Wait until there is space in the pipe.  Called and returns with the
+ *   d_bflock held on success.
+ *
+ * Returned Value:
+ *   Zero (OK) if there is space, or a negated errno value on failure, the
+ *   d_bflock is released in that case.
+ *
+ ****************************************************************************/
+
+static int pipecommon_waitspace(FAR struct pipe_dev_s *dev, bool nonblock)
+{
+  int ret;
+
+  while (circbuf_is_full(&dev->d_buffer))
+    {
+      nxrmutex_unlock(&dev->d_bflock);
+      if (nonblock)
+        {
+          return -EAGAIN;
+        }
+
+#ifdef CONFIG_DEV_PIPE_SPSC
+      /* A lock-free reader only wakes writers that say they wait */
+
+      dev->d_wrwaiting = true;
+      SP_DMB();
+      if (!circbuf_is_full(&dev->d_buffer))
+        {
+          ret = nxrmutex_lock(&dev->d_bflock);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          continue;
+        }
+#endif
+
+      ret = nxsem_wait(&dev->d_wrsem);
+      if (ret < 0 || (ret = nxrmutex_lock(&dev->d_bflock)) < 0)
+        {
+          return ret;
+        }
+    }
+
+  if (dev->d_nreaders <= 0 && PIPE_IS_POLICY_0(dev->d_flags))
+    {
+      nxrmutex_unlock(&dev->d_bflock);
+      return -EPIPE;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pipecommon_readdone
+ *
+ * Description:
+ *   Notify the writers after data was removed from the pipe.
+ *
+ ****************************************************************************/
+
+static void pipecommon_readdone(FAR struct pipe_dev_s *dev)
+{
+  if (circbuf_used(&dev->d_buffer) <= (dev->d_bufsize - dev->d_polloutthrd))
+    {
+      poll_notify(dev->d_fds, CONFIG_DEV_PIPE_NPOLLWAITERS, POLLOUT);
+    }
+
+  pipecommon_wakeup(&dev->d_wrsem);
+}
+
+/****************************************************************************
+ * Name: pipecommon_writedone
+ *
+ * Description:
+ *   Notify the readers after data was added to the pipe.
+ *
+ ****************************************************************************/
+
+static void pipecommon_writedone(FAR struct pipe_dev_s *dev)
+{
+  if (circbuf_used(&dev->d_buffer) > dev->d_pollinthrd)
+    {
+      poll_notify(dev->d_fds, CONFIG_DEV_PIPE_NPOLLWAITERS, POLLIN);
+    }
+
+  pipecommon_wakeup(&dev->d_rdsem);
+}
+
+/****************************************************************************
+ * Name: pipecommon_splice
+ *
+ * Description:
+ *   Write the other file straight from the pipe buffer, or read the other
+ *   file straight into the pipe buffer, so that the data does not go
+ *   through a user buffer.  At most one contiguous part of the pipe buffer
+ *   is transferred per call.
+ *
+ ****************************************************************************/
+
+static ssize_t pipecommon_splice(FAR struct file *filep,
+                                 FAR struct pipe_splice_s *splice)
+{
+  FAR struct pipe_dev_s *dev = filep->f_inode->i_private;
+  FAR void *buf;
+  bool nonblock;
+  size_t size;
+  ssize_t ret;
+
+  if (splice->len == 0)
+    {
+      return 0;
+    }
+
+  nonblock = (filep->f_oflags & O_NONBLOCK) != 0 ||
+             (splice->flags & SPLICE_F_NONBLOCK) != 0;
+
+  ret = nxrmutex_lock(&dev->d_bflock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (splice->out)
+    {
+      ret = pipecommon_waitdata(dev, nonblock);
+      if (ret <= 0)
+        {
+          return ret;
+        }
+
+      buf = circbuf_get_readptr(&dev->d_buffer, &size);
+      size = MIN(size, splice->len);
+      if (splice->offset != NULL)
+        {
+          ret = file_pwrite(splice->filep, buf, size, *splice->offset);
+        }
+      else
+        {
+          ret = file_write(splice->filep, buf, size);
+        }
+
+      if (ret > 0)
+        {
+          pipe_dumpbuffer("From PIPE:", (FAR uint8_t *)buf, ret);
+          SP_DMB();
+          circbuf_readcommit(&dev->d_buffer, ret);
+          pipecommon_readdone(dev);
+        }
+    }
+  else
+    {
+      ret = pipecommon_waitspace(dev, nonblock);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      buf = circbuf_get_writeptr(&dev->d_buffer, &size);
+      size = MIN(size, splice->len);
+      if (splice->offset != NULL)
+        {
+          ret = file_pread(splice->filep, buf, size, *splice->offset);
+        }
+      else
+        {
+          ret = file_read(splice->filep, buf, size);
+        }
+
+      if (ret > 0)
+        {
+          pipe_dumpbuffer("To PIPE:", (FAR uint8_t *)buf, ret);
+          SP_DMB();
+          circbuf_writecommit(&dev->d_buffer, ret);
+          pipecommon_writedone(dev);
+        }
+    }
+
+  if (ret > 0 && splice->offset != NULL)
+    {
+      *splice->offset += ret;
+    }
+
+  nxrmutex_unlock(&dev->d_bflock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pipecommon_tee
+ *
+ * Description:
+ *   Copy the data of the pipe to another pipe without consuming it.  The
+ *   two pipes are locked in address order, so that tee() in both
+ *   directions cannot deadlock.
+ *
+ ****************************************************************************/
+
+static ssize_t pipecommon_tee(FAR struct file *filep,
+                              FAR struct pipe_splice_s *splice)
+{
+  FAR struct pipe_dev_s *dev = filep->f_inode->i_private;
+  FAR struct pipe_dev_s *dst;
+  FAR struct pipe_dev_s *first;
+  FAR struct pipe_dev_s *second;
+  FAR void *buf;
+  bool nonblock;
+  size_t size;
+  ssize_t ret;
+
+  if (!INODE_IS_PIPE(splice->filep->f_inode))
+    {
+      return -EINVAL;
+    }
+
+  dst = splice->filep->f_inode->i_private;
+  if (dst == dev)
+    {
+      return -EINVAL;
+    }
+
+  if (splice->len == 0)
+    {
+      return 0;
+    }
+
+  nonblock = (filep->f_oflags & O_NONBLOCK) != 0 ||
+             (splice->flags & SPLICE_F_NONBLOCK) != 0;
+  first    = dev < dst ? dev : dst;
+  second   = dev < dst ? dst : dev;
+
+  for (; ; )
+    {
+      ret = nxrmutex_lock(&first->d_bflock);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      ret = nxrmutex_lock(&second->d_bflock);
+      if (ret < 0)
+        {
+          nxrmutex_unlock(&first->d_bflock);
+          return ret;
+        }
+
+      /* Wait for data in the source, then for space in the destination,
+       * with only the pipe waited on locked.
+       */
+
+      if (circbuf_is_empty(&dev->d_buffer))
+        {
+          nxrmutex_unlock(&dst->d_bflock);
+          ret = pipecommon_waitdata(dev, nonblock);
+          if (ret <= 0)
+            {
+              return ret;
+            }
+
+          nxrmutex_unlock(&dev->d_bflock);
+          continue;
+        }
+
+      if (circbuf_is_full(&dst->d_buffer) ||
+          (dst->d_nreaders <= 0 && PIPE_IS_POLICY_0(dst->d_flags)))
+        {
+          nxrmutex_unlock(&dev->d_bflock);
+          ret = pipecommon_waitspace(dst, nonblock);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          nxrmutex_unlock(&dst->d_bflock);
+          continue;
+        }
+
+      break;
+    }
+
+  buf  = circbuf_get_writeptr(&dst->d_buffer, &size);
+  size = MIN(size, splice->len);
+  ret  = circbuf_peekat(&dev->d_buffer, dev->d_buffer.tail, buf, size);
+  if (ret > 0)
+    {
+      SP_DMB();
+      circbuf_writecommit(&dst->d_buffer, ret);
+      pipecommon_writedone(dst);
+    }
+
+  nxrmutex_unlock(&second->d_bflock);
+  nxrmutex_unlock(&first->d_bflock);
+  return ret;
+}
+
+#ifdef CONFIG_DEV_PIPE_SPSC
+/****************************************************************************
+ * Name: pipecommon_spscwake
+ *
+ * Description:
+ *   Wake the other side of a lock-free pipe if it waits.  The update of
+ *   the buffer is ordered before the check of the flag, like the waiter
+ *   orders setting the flag before checking the buffer again, so one of
+ *   the two always sees the other.
+ *
+ ****************************************************************************/
+
+static void pipecommon_spscwake(FAR volatile bool *waiting, FAR sem_t *sem)
+{
+  SP_DMB();
+  if (*waiting)
+    {
+      *waiting = false;
+      nxsem_post(sem);
+    }
+}
+
+/****************************************************************************
+ * Name: pipecommon_spscnotify
+ *
+ * Description:
+ *   Notify the poll waiters of a lock-free pipe.  The lock is only taken if
+ *   somebody polls, since poll setup and teardown hold it.
+ *
+ ****************************************************************************/
+
+static void pipecommon_spscnotify(FAR struct pipe_dev_s *dev,
+                                  pollevent_t eventset)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_DEV_PIPE_NPOLLWAITERS; i++)
+    {
+      if (dev->d_fds[i] != NULL)
+        {
+          if (nxrmutex_lock(&dev->d_bflock) >= 0)
+            {
+              poll_notify(dev->d_fds, CONFIG_DEV_PIPE_NPOLLWAITERS,
+                          eventset);
+              nxrmutex_unlock(&dev->d_bflock);
+            }
+
+          break;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: pipecommon_spscread
+ *
+ * Description:
+ *   pipecommon_read() for a pipe with one reader and one writer: Only the
+ *   reader moves the tail and only the writer moves the head, so the
+ *   buffer is accessed without the lock.
+ *
+ ****************************************************************************/
+
+static ssize_t pipecommon_spscread(FAR struct file *filep,
+                                   FAR struct pipe_dev_s *dev,
+                                   FAR char *buffer, size_t len)
+{
+  ssize_t nread;
+  size_t used;
+  int ret;
+
+  while ((used = circbuf_used(&dev->d_buffer)) == 0)
+    {
+      if (dev->d_nwriters <= 0 && PIPE_IS_POLICY_0(dev->d_flags))
+        {
+          return 0;
+        }
+
+      if (filep->f_oflags & O_NONBLOCK)
+        {
+          return -EAGAIN;
+        }
+
+      dev->d_rdwaiting = true;
+      SP_DMB();
+      if (circbuf_is_empty(&dev->d_buffer) &&
+          (dev->d_nwriters > 0 || PIPE_IS_POLICY_1(dev->d_flags)))
+        {
+          ret = nxsem_wait(&dev->d_rdsem);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+    }
+
+  /* Read the data only after seeing the head, and release the space only
+   * after reading the data.
+   */
+
+  SP_DMB();
+  nread = circbuf_peek(&dev->d_buffer, buffer, MIN(len, used));
+  SP_DMB();
+  circbuf_readcommit(&dev->d_buffer, nread);
+
+  pipecommon_spscwake(&dev->d_wrwaiting, &dev->d_wrsem);
+  if (circbuf_used(&dev->d_buffer) <= (dev->d_bufsize - dev->d_polloutthrd))
+    {
+      pipecommon_spscnotify(dev, POLLOUT);
+    }
+
+  pipe_dumpbuffer("From PIPE:", buffer, nread);
+  return nread;
+}
+
+/****************************************************************************
+ * Name: pipecommon_spscwrite
+ *
+ * Description:
+ *   pipecommon_write() for a pipe with one reader and one writer.
+ *
+ ****************************************************************************/
+
+static ssize_t pipecommon_spscwrite(FAR struct file *filep,
+                                    FAR struct pipe_dev_s *dev,
+                                    FAR const char *buffer, size_t len)
+{
+  FAR void *buf;
+  ssize_t nwritten = 0;
+  size_t space;
+  size_t need;
+  size_t size;
+  int ret;
+
+  /* A write of up to PIPE_BUF bytes is all or nothing: wait until it fits
+   * as a whole instead of writing a part of it.
+   */
+
+  need = len <= MIN(PIPE_BUF, circbuf_size(&dev->d_buffer)) ? len : 1;
+
+  for (; ; )
+    {
+      if (dev->d_nreaders <= 0 && PIPE_IS_POLICY_0(dev->d_flags))
+        {
+          return nwritten == 0 ? -EPIPE : nwritten;
+        }
+
+      space = circbuf_space(&dev->d_buffer);
+      if (space >= need)
+        {
+          /* Overwrite the space only after seeing it released, and
+           * publish the data only after writing it.
+           */
+
+          SP_DMB();
+          space = MIN(space, len - nwritten);
+          buf   = circbuf_get_writeptr(&dev->d_buffer, &size);
+          size  = MIN(size, space);
+          memcpy(buf, buffer + nwritten, size);
+          memcpy(dev->d_buffer.base, buffer + nwritten + size,
+                 space - size);
+          SP_DMB();
+          circbuf_writecommit(&dev->d_buffer, space);
+          nwritten += space;
+
+          pipecommon_spscwake(&dev->d_rdwaiting, &dev->d_rdsem);
+          if (circbuf_used(&dev->d_buffer) > dev->d_pollinthrd)
+            {
+              pipecommon_spscnotify(dev, POLLIN);
+            }
+
+          if ((size_t)nwritten == len)
+            {
+              return len;
+            }
+
+          continue;
+        }
+
+      if (filep->f_oflags & O_NONBLOCK)
+        {
+          return nwritten == 0 ? -EAGAIN : nwritten;
+        }
+
+      dev->d_wrwaiting = true;
+      SP_DMB();
+      if (circbuf_space(&dev->d_buffer) < need &&
+          (dev->d_nreaders > 0 || PIPE_IS_POLICY_1(dev->d_flags)))
+        {
+          ret = nxsem_wait(&dev->d_wrsem);
+          if (ret < 0)
+            {
+              return nwritten == 0 ? (ssize_t)ret : nwritten;
+            }
+        }
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -420,6 +977,13 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
       return 0;
     }
 
+#ifdef CONFIG_DEV_PIPE_SPSC
+  if (PIPE_IS_SPSC(dev->d_flags))
+    {
+      return pipecommon_spscread(filep, dev, buffer, len);
+    }
+#endif
+
   /* Make sure that we have exclusive access to the device structure */
 
   ret = nxrmutex_lock(&dev->d_bflock);
@@ -531,6 +1095,13 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
 
   DEBUGASSERT(up_interrupt_context() == false);
 
+#ifdef CONFIG_DEV_PIPE_SPSC
+  if (PIPE_IS_SPSC(dev->d_flags))
+    {
+      return pipecommon_spscwrite(filep, dev, buffer, len);
+    }
+#endif
+
   /* Make sure that we have exclusive access to the device structure */
 
   ret = nxrmutex_lock(&dev->d_bflock);
@@ -787,6 +1358,19 @@ int pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
     }
 #endif
 
+  /* Splice and tee block on the pipe like read and write, so they must not
+   * hold the lock while waiting.
+   */
+
+  if (cmd == PIPEIOC_SPLICE)
+    {
+      return pipecommon_splice(filep, (FAR struct pipe_splice_s *)arg);
+    }
+  else if (cmd == PIPEIOC_TEE)
+    {
+      return pipecommon_tee(filep, (FAR struct pipe_splice_s *)arg);
+    }
+
   ret = nxrmutex_lock(&dev->d_bflock);
   if (ret < 0)
     {
@@ -810,6 +1394,23 @@ int pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
+#ifdef CONFIG_DEV_PIPE_SPSC
+      case PIPEIOC_SPSC:
+        {
+          if (arg != 0)
+            {
+              dev->d_flags |= PIPE_FLAG_SPSC;
+            }
+          else
+            {
+              dev->d_flags &= ~PIPE_FLAG_SPSC;
+            }
+
+          ret = OK;
+        }
+        break;
+#endif
+
       case PIPEIOC_POLLINTHRD:
         {
           pipe_ndx_t threshold = (pipe_ndx_t)arg;
@@ -859,6 +1460,16 @@ int pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
               break;
             }
 
+          /* The lock-free reader and writer do not expect the buffer to
+           * move.
+           */
+
+          if (PIPE_IS_SPSC(dev->d_flags))
+            {
+              ret = -EBUSY;
+              break;
+            }
+
           size = MIN(size, CONFIG_DEV_PIPE_MAXSIZE);
           ret = circbuf_resize(&dev->d_buffer, size);
           if (ret != 0)
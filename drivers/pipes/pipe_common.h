@@ -85,6 +85,7 @@
 
 #define PIPE_FLAG_POLICY    (1 << 0) /* Bit 0: Policy=Free buffer when empty */
 #define PIPE_FLAG_UNLINKED  (1 << 1) /* Bit 1: The driver has been unlinked */
+#define PIPE_FLAG_SPSC      (1 << 2) /* Bit 2: Single reader/single writer */
 
 #define PIPE_POLICY_0(f)    do { (f) &= ~PIPE_FLAG_POLICY; } while (0)
 #define PIPE_POLICY_1(f)    do { (f) |= PIPE_FLAG_POLICY; } while (0)
@@ -94,6 +95,12 @@
 #define PIPE_UNLINK(f)      do { (f) |= PIPE_FLAG_UNLINKED; } while (0)
 #define PIPE_IS_UNLINKED(f) (((f) & PIPE_FLAG_UNLINKED) != 0)
 
+#ifdef CONFIG_DEV_PIPE_SPSC
+#  define PIPE_IS_SPSC(f)   (((f) & PIPE_FLAG_SPSC) != 0)
+#else
+#  define PIPE_IS_SPSC(f)   false
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -128,6 +135,10 @@ struct pipe_dev_s
   uint8_t          d_flags;       /* See PIPE_FLAG_* definitions */
   int16_t          d_crefs;       /* References to dev */
   struct circbuf_s d_buffer;      /* Buffer allocated when device opened */
+#ifdef CONFIG_DEV_PIPE_SPSC
+  volatile bool    d_rdwaiting;   /* A reader waits on d_rdsem */
+  volatile bool    d_wrwaiting;   /* A writer waits on d_wrsem */
+#endif
 
   /* The following is a list if poll structures of threads waiting for
    * driver events. The 'struct pollfd' reference for each open is also
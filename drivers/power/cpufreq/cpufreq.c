@@ -0,0 +1,442 @@
+/****************************************************************************
+ * drivers/power/cpufreq/cpufreq.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <stdint.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/wdog.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/power/cpufreq.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_HPWORK
+#  define CPUFREQ_WORK          HPWORK
+#else
+#  define CPUFREQ_WORK          LPWORK
+#endif
+
+#define CPUFREQ_PERIOD          MSEC2TICK(CONFIG_CPUFREQ_SAMPLING_PERIOD)
+
+/* The frequency is chosen to bring the busiest CPU to 80% of the load,
+ * i.e. 1.25 times the frequency needed to do the work of the last period,
+ * as the schedutil governor of Linux does.
+ */
+
+#define CPUFREQ_UTIL_SCALE      1024
+#define CPUFREQ_HEADROOM(f)     ((f) + ((f) >> 2))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct cpufreq_s
+{
+  FAR struct cpufreq_lowerhalf_s *lower;
+  spinlock_t lock;                       /* Protects the fields below */
+  struct wdog_s wdog;                    /* Sampling period timer */
+  struct work_s work;                    /* Switches the OPP */
+  clock_t busy[CONFIG_SMP_NCPUS];        /* Busy ticks of the period */
+  clock_t total[CONFIG_SMP_NCPUS];       /* All ticks of the period */
+  size_t cur;                            /* Index of the current OPP */
+  size_t target;                         /* Index the work switches to */
+  size_t min;                            /* Lowest allowed index */
+  size_t max;                            /* Highest allowed index */
+#ifdef CONFIG_CPUFREQ_BOOST
+  unsigned int boost;                    /* Boosted periods remaining */
+#endif
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct cpufreq_s g_cpufreq;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cpufreq_worker
+ *
+ * Description:
+ *   Switch to the target OPP, again if it has changed meanwhile.
+ *
+ ****************************************************************************/
+
+static void cpufreq_worker(FAR void *arg)
+{
+  FAR struct cpufreq_s *cpufreq = arg;
+  FAR struct cpufreq_lowerhalf_s *lower = cpufreq->lower;
+  irqstate_t flags;
+  size_t index;
+  int ret;
+
+  for (; ; )
+    {
+      flags = spin_lock_irqsave(&cpufreq->lock);
+      index = cpufreq->target;
+      if (index == cpufreq->cur)
+        {
+          spin_unlock_irqrestore(&cpufreq->lock, flags);
+          break;
+        }
+
+      spin_unlock_irqrestore(&cpufreq->lock, flags);
+
+      ret = lower->ops->set_opp(lower, &lower->opps[index]);
+      if (ret < 0)
+        {
+          pwrerr("ERROR: set_opp %" PRIu32 " kHz failed: %d\n",
+                 lower->opps[index].frequency, ret);
+          break;
+        }
+
+      flags = spin_lock_irqsave(&cpufreq->lock);
+      cpufreq->cur = index;
+      spin_unlock_irqrestore(&cpufreq->lock, flags);
+    }
+}
+
+/****************************************************************************
+ * Name: cpufreq_request
+ *
+ * Description:
+ *   Set the target OPP and queue the work if it is not the current one.
+ *   Called with the lock held.
+ *
+ ****************************************************************************/
+
+static void cpufreq_request(FAR struct cpufreq_s *cpufreq, size_t index)
+{
+  cpufreq->target = index;
+
+  if (index != cpufreq->cur && work_available(&cpufreq->work))
+    {
+      work_queue(CPUFREQ_WORK, &cpufreq->work, cpufreq_worker, cpufreq, 0);
+    }
+}
+
+/****************************************************************************
+ * Name: cpufreq_select
+ *
+ * Description:
+ *   Return the index of the lowest allowed OPP that can do the work of the
+ *   last period, with the headroom, util being the load of the busiest CPU
+ *   scaled to CPUFREQ_UTIL_SCALE.
+ *
+ ****************************************************************************/
+
+static size_t cpufreq_select(FAR struct cpufreq_s *cpufreq, uint32_t util)
+{
+  FAR const struct cpufreq_opp_s *opps = cpufreq->lower->opps;
+  uint64_t freq;
+  size_t index;
+
+  freq = (uint64_t)opps[cpufreq->cur].frequency * util /
+         CPUFREQ_UTIL_SCALE;
+  freq = CPUFREQ_HEADROOM(freq);
+
+  for (index = cpufreq->min; index < cpufreq->max; index++)
+    {
+      if (opps[index].frequency >= freq)
+        {
+          break;
+        }
+    }
+
+  return index;
+}
+
+/****************************************************************************
+ * Name: cpufreq_sample
+ *
+ * Description:
+ *   The sampling period timer: evaluate the load of the period and pick
+ *   the OPP for the next one.
+ *
+ ****************************************************************************/
+
+static void cpufreq_sample(wdparm_t arg)
+{
+  FAR struct cpufreq_s *cpufreq = (FAR struct cpufreq_s *)arg;
+  irqstate_t flags;
+  uint32_t util = 0;
+  size_t index;
+  int cpu;
+
+  flags = spin_lock_irqsave(&cpufreq->lock);
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      if (cpufreq->total[cpu] > 0)
+        {
+          uint32_t load = (uint64_t)cpufreq->busy[cpu] *
+                          CPUFREQ_UTIL_SCALE / cpufreq->total[cpu];
+
+          if (load > util)
+            {
+              util = load;
+            }
+        }
+
+      cpufreq->busy[cpu]  = 0;
+      cpufreq->total[cpu] = 0;
+    }
+
+#ifdef CONFIG_CPUFREQ_BOOST
+  if (cpufreq->boost > 0)
+    {
+      cpufreq->boost--;
+      index = cpufreq->max;
+    }
+  else
+#endif
+    {
+      index = cpufreq_select(cpufreq, util);
+    }
+
+  cpufreq_request(cpufreq, index);
+  spin_unlock_irqrestore(&cpufreq->lock, flags);
+
+  wd_start(&cpufreq->wdog, CPUFREQ_PERIOD, cpufreq_sample, arg);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cpufreq_register
+ *
+ * Description:
+ *   Register the lower half which scales the frequency of all of the CPUs
+ *   and start the governor.
+ *
+ * Input Parameters:
+ *   lower - The lower half with its OPP table
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int cpufreq_register(FAR struct cpufreq_lowerhalf_s *lower)
+{
+  FAR struct cpufreq_s *cpufreq = &g_cpufreq;
+
+  if (lower == NULL || lower->ops == NULL || lower->ops->set_opp == NULL ||
+      lower->opps == NULL || lower->nopps == 0 ||
+      lower->initial >= lower->nopps)
+    {
+      return -EINVAL;
+    }
+
+  if (cpufreq->lower != NULL)
+    {
+      return -EBUSY;
+    }
+
+  spin_lock_init(&cpufreq->lock);
+  cpufreq->cur    = lower->initial;
+  cpufreq->target = lower->initial;
+  cpufreq->min    = 0;
+  cpufreq->max    = lower->nopps - 1;
+  cpufreq->lower  = lower;
+
+  return wd_start(&cpufreq->wdog, CPUFREQ_PERIOD, cpufreq_sample,
+                  (wdparm_t)cpufreq);
+}
+
+/****************************************************************************
+ * Name: cpufreq_set_limits
+ *
+ * Description:
+ *   Restrict the governor to the OPPs from min_khz to max_khz.
+ *
+ * Input Parameters:
+ *   min_khz - The lowest frequency allowed, 0 for no limit
+ *   max_khz - The highest frequency allowed, UINT32_MAX for no limit
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int cpufreq_set_limits(uint32_t min_khz, uint32_t max_khz)
+{
+  FAR struct cpufreq_s *cpufreq = &g_cpufreq;
+  FAR struct cpufreq_lowerhalf_s *lower = cpufreq->lower;
+  irqstate_t flags;
+  size_t index;
+  size_t min;
+  size_t max;
+
+  if (lower == NULL)
+    {
+      return -ENODEV;
+    }
+
+  for (min = 0; min < lower->nopps - 1; min++)
+    {
+      if (lower->opps[min].frequency >= min_khz)
+        {
+          break;
+        }
+    }
+
+  for (max = lower->nopps - 1; max > 0; max--)
+    {
+      if (lower->opps[max].frequency <= max_khz)
+        {
+          break;
+        }
+    }
+
+  if (min > max)
+    {
+      return -EINVAL;
+    }
+
+  flags = spin_lock_irqsave(&cpufreq->lock);
+
+  cpufreq->min = min;
+  cpufreq->max = max;
+
+  index = cpufreq->target;
+  if (index < min)
+    {
+      index = min;
+    }
+  else if (index > max)
+    {
+      index = max;
+    }
+
+  cpufreq_request(cpufreq, index);
+  spin_unlock_irqrestore(&cpufreq->lock, flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cpufreq_get_frequency
+ *
+ * Description:
+ *   Return the current CPU frequency in kHz, 0 when nothing is registered.
+ *
+ ****************************************************************************/
+
+uint32_t cpufreq_get_frequency(void)
+{
+  FAR struct cpufreq_lowerhalf_s *lower = g_cpufreq.lower;
+
+  return lower != NULL ? lower->opps[g_cpufreq.cur].frequency : 0;
+}
+
+/****************************************************************************
+ * Name: cpufreq_update_load
+ *
+ * Description:
+ *   Account ticks of CPU time to the load of cpu.
+ *
+ * Input Parameters:
+ *   cpu   - The CPU the ticks were spent on
+ *   ticks - The CPU load ticks, in the unit of the CPU load measurement
+ *   idle  - True if the ticks were spent in the IDLE thread
+ *
+ * Assumptions:
+ *   Called by the scheduler with the interrupts disabled.
+ *
+ ****************************************************************************/
+
+void cpufreq_update_load(int cpu, clock_t ticks, bool idle)
+{
+  FAR struct cpufreq_s *cpufreq = &g_cpufreq;
+
+  if (cpufreq->lower == NULL)
+    {
+      return;
+    }
+
+  spin_lock(&cpufreq->lock);
+
+  cpufreq->total[cpu] += ticks;
+  if (!idle)
+    {
+      cpufreq->busy[cpu] += ticks;
+    }
+
+  spin_unlock(&cpufreq->lock);
+}
+
+/****************************************************************************
+ * Name: cpufreq_boost
+ *
+ * Description:
+ *   Go to the highest allowed OPP and stay there for
+ *   CONFIG_CPUFREQ_BOOST_PERIODS sampling periods.
+ *
+ *   The work can not be queued from here, because this runs inside of the
+ *   ready-to-run list update of the scheduler.  The sampling timer is
+ *   restarted to expire on the next tick instead.
+ *
+ * Assumptions:
+ *   Called by the scheduler with the interrupts disabled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_CPUFREQ_BOOST
+void cpufreq_boost(void)
+{
+  FAR struct cpufreq_s *cpufreq = &g_cpufreq;
+  bool restart;
+
+  if (cpufreq->lower == NULL)
+    {
+      return;
+    }
+
+  spin_lock(&cpufreq->lock);
+  cpufreq->boost = CONFIG_CPUFREQ_BOOST_PERIODS;
+  restart = cpufreq->target != cpufreq->max;
+  spin_unlock(&cpufreq->lock);
+
+  if (restart)
+    {
+      wd_start(&cpufreq->wdog, 0, cpufreq_sample, (wdparm_t)cpufreq);
+    }
+}
+#endif
@@ -28,10 +28,17 @@
 #include <nuttx/regmap/regmap.h>
 #include <nuttx/mutex.h>
 
+#include <sys/tree.h>
+#include <stdint.h>
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Number of registers of a cache block, the bits of its bitmaps */
+
+#define REGCACHE_BLOCK_SIZE 32
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -39,6 +46,40 @@
 typedef CODE void (*regmap_lock_t)(FAR void *);
 typedef CODE void (*regmap_unlock_t)(FAR void *);
 
+#ifdef CONFIG_REGMAP_CACHE
+/* A block of the register cache, the registers of index base to
+ * base + REGCACHE_BLOCK_SIZE - 1, the index being the register address
+ * divided by the stride.
+ */
+
+struct regcache_block_s
+{
+  RB_ENTRY(regcache_block_s) link; /* Node of the REGCACHE_RBTREE tree */
+  unsigned int base;               /* Index of the first register */
+  uint32_t valid;                  /* Bitmap of the cached registers */
+  uint32_t dirty;                  /* Bitmap of the registers to sync */
+  unsigned int val[REGCACHE_BLOCK_SIZE];
+};
+
+RB_HEAD(regcache_tree_s, regcache_block_s);
+
+/* Storage of a cache type. lookup() returns the block of a register index,
+ * allocating it if create is true, and next() returns the blocks in the
+ * order of their index, the first one for NULL.
+ */
+
+struct regcache_ops_s
+{
+  CODE int (*init)(FAR struct regmap_s *map);
+  CODE void (*exit)(FAR struct regmap_s *map);
+  CODE FAR struct regcache_block_s *(*lookup)(FAR struct regmap_s *map,
+                                              unsigned int index,
+                                              bool create);
+  CODE FAR struct regcache_block_s *
+    (*next)(FAR struct regmap_s *map, FAR struct regcache_block_s *blk);
+};
+#endif
+
 /* Configuration for the register map of a device.
  * This structure is only used inside regmap.
  */
@@ -79,9 +120,48 @@ struct regmap_s
 
   int reg_stride;
 
+#ifdef CONFIG_REGMAP_CACHE
+  /* Register cache, from regmap_config_s.  In cache only mode the writes
+   * only mark the cached registers dirty.
+   */
+
+  FAR const struct regcache_ops_s *cache_ops;
+  CODE bool (*volatile_reg)(unsigned int reg);
+  unsigned int max_register;
+  bool cache_only;
+
+  /* Blocks of REGCACHE_FLAT, tree of REGCACHE_RBTREE */
+
+  FAR struct regcache_block_s *cache_flat;
+  unsigned int cache_nflat;
+  struct regcache_tree_s cache_tree;
+#endif
+
   /* Prevent fragmentation */
 
   mutex_t mutex[0];
 };
 
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef CONFIG_REGMAP_CACHE
+
+/* Register cache of regmap.c, called with the regmap locked.
+ * regcache_read() returns -ENOENT for a register not cached, and
+ * regcache_write() does nothing for a volatile register.
+ */
+
+int regcache_init(FAR struct regmap_s *map,
+                  FAR const struct regmap_config_s *config);
+void regcache_exit(FAR struct regmap_s *map);
+bool regcache_volatile(FAR struct regmap_s *map, unsigned int reg);
+int regcache_read(FAR struct regmap_s *map, unsigned int reg,
+                  FAR unsigned int *val);
+int regcache_write(FAR struct regmap_s *map, unsigned int reg,
+                   unsigned int val, bool dirty);
+
+#endif /* CONFIG_REGMAP_CACHE */
+
 #endif /* __DRIVERS_REGMAP_INTERNAL_H */
@@ -0,0 +1,571 @@
+/****************************************************************************
+ * drivers/regmap/regcache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/regmap/regmap.h>
+#include <nuttx/kmalloc.h>
+
+#include <debug.h>
+#include <errno.h>
+#include <string.h>
+#include <strings.h>
+
+#include "internal.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define REGCACHE_INDEX(map, reg)  ((reg) / (map)->reg_stride)
+#define REGCACHE_BASE(index)      ((index) & ~(REGCACHE_BLOCK_SIZE - 1))
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int regcache_flat_init(FAR struct regmap_s *map);
+static void regcache_flat_exit(FAR struct regmap_s *map);
+static FAR struct regcache_block_s *
+regcache_flat_lookup(FAR struct regmap_s *map, unsigned int index,
+                     bool create);
+static FAR struct regcache_block_s *
+regcache_flat_next(FAR struct regmap_s *map,
+                   FAR struct regcache_block_s *blk);
+
+static int regcache_rbtree_init(FAR struct regmap_s *map);
+static void regcache_rbtree_exit(FAR struct regmap_s *map);
+static FAR struct regcache_block_s *
+regcache_rbtree_lookup(FAR struct regmap_s *map, unsigned int index,
+                       bool create);
+static FAR struct regcache_block_s *
+regcache_rbtree_next(FAR struct regmap_s *map,
+                     FAR struct regcache_block_s *blk);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct regcache_ops_s g_regcache_flat_ops =
+{
+  regcache_flat_init,
+  regcache_flat_exit,
+  regcache_flat_lookup,
+  regcache_flat_next
+};
+
+static const struct regcache_ops_s g_regcache_rbtree_ops =
+{
+  regcache_rbtree_init,
+  regcache_rbtree_exit,
+  regcache_rbtree_lookup,
+  regcache_rbtree_next
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static int regcache_compare(FAR struct regcache_block_s *a,
+                            FAR struct regcache_block_s *b)
+{
+  if (a->base < b->base)
+    {
+      return -1;
+    }
+
+  return a->base > b->base;
+}
+
+RB_GENERATE_STATIC(regcache_tree_s, regcache_block_s, link,
+                   regcache_compare)
+
+/****************************************************************************
+ * Name: regcache_flat_*
+ *
+ * Description:
+ *   REGCACHE_FLAT, the blocks of all the registers up to max_register
+ *   allocated at once.
+ *
+ ****************************************************************************/
+
+static int regcache_flat_init(FAR struct regmap_s *map)
+{
+  unsigned int i;
+
+  map->cache_nflat = REGCACHE_INDEX(map, map->max_register) /
+                     REGCACHE_BLOCK_SIZE + 1;
+  map->cache_flat  = kmm_zalloc(map->cache_nflat *
+                                sizeof(struct regcache_block_s));
+  if (map->cache_flat == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  for (i = 0; i < map->cache_nflat; i++)
+    {
+      map->cache_flat[i].base = i * REGCACHE_BLOCK_SIZE;
+    }
+
+  return 0;
+}
+
+static void regcache_flat_exit(FAR struct regmap_s *map)
+{
+  kmm_free(map->cache_flat);
+}
+
+static FAR struct regcache_block_s *
+regcache_flat_lookup(FAR struct regmap_s *map, unsigned int index,
+                     bool create)
+{
+  index /= REGCACHE_BLOCK_SIZE;
+  return index < map->cache_nflat ? &map->cache_flat[index] : NULL;
+}
+
+static FAR struct regcache_block_s *
+regcache_flat_next(FAR struct regmap_s *map,
+                   FAR struct regcache_block_s *blk)
+{
+  blk = blk != NULL ? blk + 1 : map->cache_flat;
+  return blk < map->cache_flat + map->cache_nflat ? blk : NULL;
+}
+
+/****************************************************************************
+ * Name: regcache_rbtree_*
+ *
+ * Description:
+ *   REGCACHE_RBTREE, a tree of the blocks allocated on the first access of
+ *   one of their registers, for the devices with few registers spread over
+ *   a large address space.
+ *
+ ****************************************************************************/
+
+static int regcache_rbtree_init(FAR struct regmap_s *map)
+{
+  RB_INIT(&map->cache_tree);
+  return 0;
+}
+
+static void regcache_rbtree_exit(FAR struct regmap_s *map)
+{
+  FAR struct regcache_block_s *blk;
+  FAR struct regcache_block_s *tmp;
+
+  RB_FOREACH_SAFE(blk, regcache_tree_s, &map->cache_tree, tmp)
+    {
+      RB_REMOVE(regcache_tree_s, &map->cache_tree, blk);
+      kmm_free(blk);
+    }
+}
+
+static FAR struct regcache_block_s *
+regcache_rbtree_lookup(FAR struct regmap_s *map, unsigned int index,
+                       bool create)
+{
+  FAR struct regcache_block_s *blk;
+  struct regcache_block_s search;
+
+  search.base = REGCACHE_BASE(index);
+  blk = RB_FIND(regcache_tree_s, &map->cache_tree, &search);
+  if (blk == NULL && create)
+    {
+      blk = kmm_zalloc(sizeof(struct regcache_block_s));
+      if (blk != NULL)
+        {
+          blk->base = search.base;
+          RB_INSERT(regcache_tree_s, &map->cache_tree, blk);
+        }
+    }
+
+  return blk;
+}
+
+static FAR struct regcache_block_s *
+regcache_rbtree_next(FAR struct regmap_s *map,
+                     FAR struct regcache_block_s *blk)
+{
+  if (blk == NULL)
+    {
+      return RB_MIN(regcache_tree_s, &map->cache_tree);
+    }
+
+  return RB_NEXT(regcache_tree_s, &map->cache_tree, blk);
+}
+
+/****************************************************************************
+ * Name: regcache_flush
+ *
+ * Description:
+ *   Write the n registers of index first to the device, by a single bulk
+ *   transfer if there are several of them, and mark them clean.  The bulk
+ *   data is the register address then the values, each in big endian
+ *   order, the format of the write of the i2c and spi buses.
+ *
+ ****************************************************************************/
+
+static int regcache_flush(FAR struct regmap_s *map, unsigned int first,
+                          FAR const unsigned int *val, unsigned int n)
+{
+  uint8_t buf[CONFIG_REGMAP_CACHE_BULK_SIZE];
+  unsigned int reg = first * map->reg_stride;
+  unsigned int pos = 0;
+  unsigned int i;
+  int shift;
+  int ret;
+
+  if (n == 1 || map->write == NULL)
+    {
+      for (i = 0; i < n; i++)
+        {
+          ret = map->reg_write(map->bus, reg + i * map->reg_stride,
+                               val[i]);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+
+      goto clean;
+    }
+
+  for (shift = (map->reg_bytes - 1) * 8; shift >= 0; shift -= 8)
+    {
+      buf[pos++] = reg >> shift;
+    }
+
+  for (i = 0; i < n; i++)
+    {
+      for (shift = (map->val_bytes - 1) * 8; shift >= 0; shift -= 8)
+        {
+          buf[pos++] = val[i] >> shift;
+        }
+    }
+
+  ret = map->write(map->bus, buf, pos);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* The registers written are no longer dirty */
+
+clean:
+  for (i = 0; i < n; i++)
+    {
+      FAR struct regcache_block_s *blk;
+
+      blk = map->cache_ops->lookup(map, first + i, false);
+      blk->dirty &= ~(1u << ((first + i) % REGCACHE_BLOCK_SIZE));
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: regcache_sync_locked
+ *
+ * Description:
+ *   Write the dirty registers, grouping the consecutive ones into bulk
+ *   transfers of CONFIG_REGMAP_CACHE_BULK_SIZE bytes at most.  The bus
+ *   increments the address by one in a bulk transfer, so the registers are
+ *   only grouped with a stride of 1.
+ *
+ ****************************************************************************/
+
+static int regcache_sync_locked(FAR struct regmap_s *map)
+{
+  unsigned int val[CONFIG_REGMAP_CACHE_BULK_SIZE];
+  FAR struct regcache_block_s *blk = NULL;
+  unsigned int first = 0;
+  unsigned int max;
+  unsigned int n = 0;
+  int ret;
+
+  max = 1;
+  if (map->reg_stride == 1 && map->write != NULL &&
+      CONFIG_REGMAP_CACHE_BULK_SIZE > map->reg_bytes)
+    {
+      max = (CONFIG_REGMAP_CACHE_BULK_SIZE - map->reg_bytes) /
+            map->val_bytes;
+      max = max > 0 ? max : 1;
+    }
+
+  while ((blk = map->cache_ops->next(map, blk)) != NULL)
+    {
+      uint32_t dirty = blk->dirty;
+
+      while (dirty != 0)
+        {
+          unsigned int bit = ffs(dirty) - 1;
+          unsigned int index = blk->base + bit;
+
+          dirty &= ~(1u << bit);
+
+          /* Flush the run if this register does not extend it */
+
+          if (n > 0 && (index != first + n || n == max))
+            {
+              ret = regcache_flush(map, first, val, n);
+              if (ret < 0)
+                {
+                  return ret;
+                }
+
+              n = 0;
+            }
+
+          if (n == 0)
+            {
+              first = index;
+            }
+
+          val[n++] = blk->val[bit];
+        }
+    }
+
+  return n > 0 ? regcache_flush(map, first, val, n) : 0;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: regcache_init
+ *
+ * Description:
+ *   Initialize the register cache of the regmap from its configuration.
+ *
+ ****************************************************************************/
+
+int regcache_init(FAR struct regmap_s *map,
+                  FAR const struct regmap_config_s *config)
+{
+  map->volatile_reg = config->volatile_reg;
+  map->max_register = config->max_register;
+
+  switch (config->cache_type)
+    {
+      case REGCACHE_NONE:
+        return 0;
+
+      case REGCACHE_FLAT:
+        if (config->max_register == 0)
+          {
+            return -EINVAL;
+          }
+
+        map->cache_ops = &g_regcache_flat_ops;
+        break;
+
+      case REGCACHE_RBTREE:
+        map->cache_ops = &g_regcache_rbtree_ops;
+        break;
+
+      default:
+        return -EINVAL;
+    }
+
+  return map->cache_ops->init(map);
+}
+
+/****************************************************************************
+ * Name: regcache_exit
+ *
+ * Description:
+ *   Free the register cache of the regmap.
+ *
+ ****************************************************************************/
+
+void regcache_exit(FAR struct regmap_s *map)
+{
+  if (map->cache_ops != NULL)
+    {
+      map->cache_ops->exit(map);
+      map->cache_ops = NULL;
+    }
+}
+
+/****************************************************************************
+ * Name: regcache_volatile
+ *
+ * Description:
+ *   Return true if the register is not cached.
+ *
+ ****************************************************************************/
+
+bool regcache_volatile(FAR struct regmap_s *map, unsigned int reg)
+{
+  if (map->cache_ops == NULL)
+    {
+      return true;
+    }
+
+  if (map->max_register != 0 && reg > map->max_register)
+    {
+      return true;
+    }
+
+  return map->volatile_reg != NULL && map->volatile_reg(reg);
+}
+
+/****************************************************************************
+ * Name: regcache_read
+ *
+ * Description:
+ *   Read a register from the cache.  -ENOENT is returned if the register
+ *   is volatile or has not been read or written yet.
+ *
+ ****************************************************************************/
+
+int regcache_read(FAR struct regmap_s *map, unsigned int reg,
+                  FAR unsigned int *val)
+{
+  FAR struct regcache_block_s *blk;
+  unsigned int index;
+  unsigned int bit;
+
+  if (regcache_volatile(map, reg))
+    {
+      return -ENOENT;
+    }
+
+  index = REGCACHE_INDEX(map, reg);
+  bit   = index % REGCACHE_BLOCK_SIZE;
+  blk   = map->cache_ops->lookup(map, index, false);
+  if (blk == NULL || (blk->valid & (1u << bit)) == 0)
+    {
+      return -ENOENT;
+    }
+
+  *val = blk->val[bit];
+  return 0;
+}
+
+/****************************************************************************
+ * Name: regcache_write
+ *
+ * Description:
+ *   Store the value of a register in the cache, dirty if it has not been
+ *   written to the device.  A volatile register is ignored.
+ *
+ ****************************************************************************/
+
+int regcache_write(FAR struct regmap_s *map, unsigned int reg,
+                   unsigned int val, bool dirty)
+{
+  FAR struct regcache_block_s *blk;
+  unsigned int index;
+  unsigned int bit;
+
+  if (regcache_volatile(map, reg))
+    {
+      return 0;
+    }
+
+  index = REGCACHE_INDEX(map, reg);
+  bit   = index % REGCACHE_BLOCK_SIZE;
+  blk   = map->cache_ops->lookup(map, index, true);
+  if (blk == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  blk->val[bit] = val;
+  blk->valid   |= 1u << bit;
+  if (dirty)
+    {
+      blk->dirty |= 1u << bit;
+    }
+  else
+    {
+      blk->dirty &= ~(1u << bit);
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: regcache_cache_only
+ *
+ * Description:
+ *   Enable or disable the cache only mode.
+ *
+ ****************************************************************************/
+
+void regcache_cache_only(FAR struct regmap_s *map, bool enable)
+{
+  map->lock(map);
+  map->cache_only = enable;
+  map->unlock(map);
+}
+
+/****************************************************************************
+ * Name: regcache_mark_dirty
+ *
+ * Description:
+ *   Mark all the cached registers dirty.
+ *
+ ****************************************************************************/
+
+void regcache_mark_dirty(FAR struct regmap_s *map)
+{
+  FAR struct regcache_block_s *blk = NULL;
+
+  map->lock(map);
+
+  if (map->cache_ops != NULL)
+    {
+      while ((blk = map->cache_ops->next(map, blk)) != NULL)
+        {
+          blk->dirty = blk->valid;
+        }
+    }
+
+  map->unlock(map);
+}
+
+/****************************************************************************
+ * Name: regcache_sync
+ *
+ * Description:
+ *   Write the dirty registers of the cache to the device.
+ *
+ ****************************************************************************/
+
+int regcache_sync(FAR struct regmap_s *map)
+{
+  int ret = 0;
+
+  map->lock(map);
+
+  if (map->cache_ops != NULL)
+    {
+      ret = regcache_sync_locked(map);
+    }
+
+  map->unlock(map);
+  return ret;
+}
@@ -47,6 +47,116 @@ static void regmap_lock_unlock_none(FAR void *context)
 {
 }
 
+/* Values of the val_bytes size of the regmap in a buffer */
+
+static unsigned int regmap_get_val(FAR struct regmap_s *map,
+                                   FAR const void *ptr)
+{
+  switch (map->val_bytes)
+    {
+      case 2:
+        return *(FAR const uint16_t *)ptr;
+      case 4:
+        return *(FAR const uint32_t *)ptr;
+      default:
+        return *(FAR const uint8_t *)ptr;
+    }
+}
+
+#ifdef CONFIG_REGMAP_CACHE
+static void regmap_put_val(FAR struct regmap_s *map, FAR void *ptr,
+                           unsigned int val)
+{
+  switch (map->val_bytes)
+    {
+      case 2:
+        *(FAR uint16_t *)ptr = val;
+        break;
+      case 4:
+        *(FAR uint32_t *)ptr = val;
+        break;
+      default:
+        *(FAR uint8_t *)ptr = val;
+        break;
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: regmap_read_locked
+ *
+ * Description:
+ *   Read a register, from the cache if it is cached, into the buffer val
+ *   of val_bytes bytes.
+ *
+ ****************************************************************************/
+
+static int regmap_read_locked(FAR struct regmap_s *map, unsigned int reg,
+                              FAR void *val)
+{
+  int ret;
+
+#ifdef CONFIG_REGMAP_CACHE
+  unsigned int ival;
+
+  if (regcache_read(map, reg, &ival) >= 0)
+    {
+      regmap_put_val(map, val, ival);
+      return 0;
+    }
+
+  if (map->cache_only)
+    {
+      return -EBUSY;
+    }
+#endif
+
+  ret = map->reg_read(map->bus, reg, val);
+
+#ifdef CONFIG_REGMAP_CACHE
+  if (ret >= 0)
+    {
+      regcache_write(map, reg, regmap_get_val(map, val), false);
+    }
+#endif
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: regmap_write_locked
+ *
+ * Description:
+ *   Write a register and update its cache.  In cache only mode the cache
+ *   is only marked dirty.
+ *
+ ****************************************************************************/
+
+static int regmap_write_locked(FAR struct regmap_s *map, unsigned int reg,
+                               unsigned int val)
+{
+  int ret;
+
+#ifdef CONFIG_REGMAP_CACHE
+  if (map->cache_only)
+    {
+      return regcache_volatile(map, reg) ? -EBUSY :
+             regcache_write(map, reg, val, true);
+    }
+#endif
+
+  ret = map->reg_write(map->bus, reg, val);
+
+#ifdef CONFIG_REGMAP_CACHE
+  if (ret >= 0)
+    {
+      regcache_write(map, reg, val, false);
+    }
+#endif
+
+  return ret;
+}
+
 static void regmap_lock_mutex(FAR void *context)
 {
   FAR struct regmap_s *map = context;
@@ -129,6 +239,7 @@ FAR struct regmap_s *regmap_init(FAR struct regmap_bus_s *bus,
       map->reg_stride = 1;
     }
 
+  map->disable_locking = config->disable_locking;
   map->reg_bytes = REGMAP_DIVUP(config->reg_bits, REGMAP_DEFAULT_BIT);
   map->val_bytes = REGMAP_DIVUP(config->val_bits, REGMAP_DEFAULT_BIT);
 
@@ -138,6 +249,19 @@ FAR struct regmap_s *regmap_init(FAR struct regmap_bus_s *bus,
   map->read  = bus->read;
   map->write = bus->write;
 
+#ifdef CONFIG_REGMAP_CACHE
+  if (regcache_init(map, config) < 0)
+    {
+      if (!config->disable_locking)
+        {
+          nxmutex_destroy(&map->mutex[0]);
+        }
+
+      kmm_free(map);
+      return NULL;
+    }
+#endif
+
   return map;
 }
 
@@ -171,7 +295,7 @@ int regmap_write(FAR struct regmap_s *map, unsigned int reg,
 
   map->lock(map);
 
-  ret = map->reg_write(map->bus, reg, val);
+  ret = regmap_write_locked(map, reg, val);
 
   map->unlock(map);
 
@@ -214,10 +338,34 @@ int regmap_bulk_write(FAR struct regmap_s *map, unsigned int reg,
   map->lock(map);
   if (map->write != NULL)
     {
+#ifdef CONFIG_REGMAP_CACHE
+      if (map->cache_only)
+        {
+          goto cache;
+        }
+#endif
+
       ret = map->write(map->bus, val, val_bytes * val_count);
+
+#ifdef CONFIG_REGMAP_CACHE
+      if (ret >= 0)
+        {
+          for (i = 0; i < val_count; i++)
+            {
+              ptr = (FAR uint8_t *)val + (i * val_bytes);
+              regcache_write(map, reg + (i * map->reg_stride),
+                             regmap_get_val(map, ptr), false);
+            }
+        }
+#endif
+
       goto out;
     }
 
+#ifdef CONFIG_REGMAP_CACHE
+cache:
+#endif
+
   for (i = 0; i < val_count; i++)
     {
       ptr = (FAR uint8_t *)val + (i * val_bytes);
@@ -237,7 +385,7 @@ int regmap_bulk_write(FAR struct regmap_s *map, unsigned int reg,
             goto out;
         }
 
-      ret = map->reg_write(map->bus, reg + (i * map->reg_stride), ival);
+      ret = regmap_write_locked(map, reg + (i * map->reg_stride), ival);
       if (ret < 0)
         {
           break;
@@ -278,7 +426,7 @@ int regmap_read(FAR struct regmap_s *map, unsigned int reg, FAR void *val)
 
   map->lock(map);
 
-  ret = map->reg_read(map->bus, reg, val);
+  ret = regmap_read_locked(map, reg, val);
 
   map->unlock(map);
   return ret;
@@ -320,15 +468,52 @@ int regmap_bulk_read(FAR struct regmap_s *map, unsigned int reg,
 
   map->lock(map);
 
+#ifdef CONFIG_REGMAP_CACHE
+  /* Read from the cache if all the registers are cached */
+
+  for (i = 0; i < val_count; i++)
+    {
+      if (regcache_read(map, reg + (i * map->reg_stride), &ival) < 0)
+        {
+          break;
+        }
+
+      regmap_put_val(map, u8 + (i * map->val_bytes), ival);
+    }
+
+  if (i == val_count)
+    {
+      map->unlock(map);
+      return 0;
+    }
+#endif
+
   if (map->read != NULL)
     {
+#ifdef CONFIG_REGMAP_CACHE
+      if (map->cache_only)
+        {
+          map->unlock(map);
+          return -EBUSY;
+        }
+#endif
+
       ret = map->read(map->bus, &reg, map->reg_bytes, val, val_count);
+
+#ifdef CONFIG_REGMAP_CACHE
+      for (i = 0; ret >= 0 && i < val_count; i++)
+        {
+          regcache_write(map, reg + (i * map->reg_stride),
+                         regmap_get_val(map, u8 + (i * map->val_bytes)),
+                         false);
+        }
+#endif
     }
   else
     {
       for (i = 0; i < val_count; i++)
         {
-          ret = map->reg_read(map->bus, reg + (i * map->reg_stride), &ival);
+          ret = regmap_read_locked(map, reg + (i * map->reg_stride), &ival);
           if (ret < 0)
             {
               break;
@@ -357,6 +542,53 @@ int regmap_bulk_read(FAR struct regmap_s *map, unsigned int reg,
   return ret;
 }
 
+/****************************************************************************
+ * Name: regmap_update_bits
+ *
+ * Description:
+ *   Read-modify-write of a register, written only if it changes.
+ *
+ * Input Parameters:
+ *   map  - regmap handler, from regmap bus init function return.
+ *   reg  - register address to be updated.
+ *   mask - bits to update.
+ *   val  - new value of the bits.
+ *
+ * Returned Value:
+ *   Zero or positive on success; a negated errno value on failure.
+ *
+ * Assumptions/Limitations:
+ *   None.
+ *
+ ****************************************************************************/
+
+int regmap_update_bits(FAR struct regmap_s *map, unsigned int reg,
+                       unsigned int mask, unsigned int val)
+{
+  uint32_t buf = 0;
+  unsigned int orig;
+  unsigned int tmp;
+  int ret;
+
+  DEBUGASSERT(REGMAP_ALIGNED(reg, map->reg_stride));
+
+  map->lock(map);
+
+  ret = regmap_read_locked(map, reg, &buf);
+  if (ret >= 0)
+    {
+      orig = regmap_get_val(map, &buf);
+      tmp  = (orig & ~mask) | (val & mask);
+      if (tmp != orig)
+        {
+          ret = regmap_write_locked(map, reg, tmp);
+        }
+    }
+
+  map->unlock(map);
+  return ret;
+}
+
 /****************************************************************************
  * Name: regmap_exit
  *
@@ -382,6 +614,10 @@ void regmap_exit(FAR struct regmap_s *map)
       map->bus->exit(map->bus);
     }
 
+#ifdef CONFIG_REGMAP_CACHE
+  regcache_exit(map);
+#endif
+
   kmm_free(map->bus);
   kmm_free(map);
 }
@@ -22,10 +22,14 @@
  * Included Files
  ****************************************************************************/
 
+#include <debug.h>
+#include <inttypes.h>
 #include <stdio.h>
+#include <string.h>
 
 #include <nuttx/irq.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/nuttx.h>
 
 #include <metal/mutex.h>
 #include <metal/sys.h>
@@ -99,6 +103,36 @@ static void rpmsg_port_add_node(FAR struct rpmsg_port_list_s *list,
   spin_unlock_irqrestore(&list->lock, flags);
 }
 
+/****************************************************************************
+ * Name: rpmsg_port_add_prio_node
+ *
+ * Description:
+ *   Add a node after the priority nodes at the head of the list.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_RPMSG_PORT_PRIO
+static void rpmsg_port_add_prio_node(FAR struct rpmsg_port_list_s *list,
+                                     FAR struct list_node *node)
+{
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&list->lock);
+  if (list->prio != NULL)
+    {
+      list_add_after(list->prio, node);
+    }
+  else
+    {
+      list_add_head(&list->head, node);
+    }
+
+  list->prio = node;
+  list->num++;
+  spin_unlock_irqrestore(&list->lock, flags);
+}
+#endif
+
 /****************************************************************************
  * Name: rpmsg_port_remove_node
  ****************************************************************************/
@@ -114,12 +148,90 @@ rpmsg_port_remove_node(FAR struct rpmsg_port_list_s *list)
   if (node != NULL)
     {
       list->num--;
+#ifdef CONFIG_RPMSG_PORT_PRIO
+      if (node == list->prio)
+        {
+          list->prio = NULL;
+        }
+#endif
     }
 
   spin_unlock_irqrestore(&list->lock, flags);
   return node;
 }
 
+/****************************************************************************
+ * Name: rpmsg_port_remove_fit_node
+ *
+ * Description:
+ *   Remove the head node of the list if its frame fits into room bytes.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_RPMSG_PORT_BATCH
+static FAR struct list_node *
+rpmsg_port_remove_fit_node(FAR struct rpmsg_port_queue_s *queue,
+                           uint16_t room)
+{
+  FAR struct rpmsg_port_list_s *list = &queue->ready;
+  FAR struct rpmsg_port_header_s *hdr;
+  FAR struct list_node *node;
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&list->lock);
+  node = list_peek_head(&list->head);
+  if (node != NULL)
+    {
+      hdr = RPMSG_PORT_NODE_TO_BUF(queue, node);
+      if (hdr->len - sizeof(*hdr) <= room)
+        {
+          list_delete(node);
+          list->num--;
+#ifdef CONFIG_RPMSG_PORT_PRIO
+          if (node == list->prio)
+            {
+              list->prio = NULL;
+            }
+#endif
+        }
+      else
+        {
+          node = NULL;
+        }
+    }
+
+  spin_unlock_irqrestore(&list->lock, flags);
+  return node;
+}
+#endif
+
+/****************************************************************************
+ * Name: rpmsg_port_queue_stats
+ *
+ * Description:
+ *   Account a buffer just taken from the ready list.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_RPMSG_PORT_STATS
+static void rpmsg_port_queue_stats(FAR struct rpmsg_port_queue_s *queue,
+                                   FAR struct list_node *node)
+{
+  FAR struct rpmsg_port_header_s *hdr = RPMSG_PORT_NODE_TO_BUF(queue, node);
+  clock_t latency = perf_gettime() - queue->stamp[node - queue->node];
+
+  queue->stats.frames++;
+  queue->stats.bytes += hdr->len;
+  queue->stats.latency += latency;
+  if (latency > queue->stats.maxlatency)
+    {
+      queue->stats.maxlatency = latency;
+    }
+}
+#else
+#  define rpmsg_port_queue_stats(queue, node)
+#endif
+
 /****************************************************************************
  * Name: rpmsg_port_destroy_queue
  *
@@ -136,6 +248,9 @@ static void rpmsg_port_destroy_queue(FAR struct rpmsg_port_queue_s *queue)
     }
 
   kmm_free(queue->node);
+#ifdef CONFIG_RPMSG_PORT_STATS
+  kmm_free(queue->stamp);
+#endif
   nxsem_destroy(&queue->free.sem);
   nxsem_destroy(&queue->ready.sem);
 }
@@ -158,6 +273,15 @@ static int rpmsg_port_create_queue(FAR struct rpmsg_port_queue_s *queue,
 
   queue->node = node;
 
+#ifdef CONFIG_RPMSG_PORT_STATS
+  queue->stamp = kmm_zalloc(count * sizeof(clock_t));
+  if (queue->stamp == NULL)
+    {
+      kmm_free(queue->node);
+      return -ENOMEM;
+    }
+#endif
+
   /* Check if buffer space needed to be malloced internal. */
 
   if (buf == NULL)
@@ -165,6 +289,9 @@ static int rpmsg_port_create_queue(FAR struct rpmsg_port_queue_s *queue,
       buf = kmm_malloc(count * len);
       if (buf == NULL)
         {
+#ifdef CONFIG_RPMSG_PORT_STATS
+          kmm_free(queue->stamp);
+#endif
           kmm_free(queue->node);
           return -ENOMEM;
         }
@@ -257,6 +384,66 @@ rpmsg_port_get_tx_payload_buffer(FAR struct rpmsg_device *rdev,
   return RPMSG_LOCATE_DATA(hdr->buf);
 }
 
+/****************************************************************************
+ * Name: rpmsg_port_is_prio
+ *
+ * Description:
+ *   Check if a frame goes ahead of the queued ones.  The name service
+ *   messages do, they also tell the local address of the endpoints, which
+ *   is recorded for the priority ones.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_RPMSG_PORT_PRIO
+static bool rpmsg_port_is_prio(FAR struct rpmsg_port_s *port,
+                               uint32_t src, uint32_t dst,
+                               FAR const void *data, int len)
+{
+  FAR const struct rpmsg_ns_msg *msg = data;
+  FAR const char *epts = CONFIG_RPMSG_PORT_PRIO_EPTS;
+  uint32_t addr;
+  size_t n;
+
+  if (dst != RPMSG_NS_EPT_ADDR)
+    {
+      addr = src - RPMSG_RESERVED_ADDRESSES;
+      return addr < RPMSG_ADDR_BMP_SIZE &&
+             (port->prio[addr / 32] & (1u << (addr % 32))) != 0;
+    }
+
+  if (len != sizeof(*msg))
+    {
+      return true;
+    }
+
+  addr = msg->addr - RPMSG_RESERVED_ADDRESSES;
+  if (addr >= RPMSG_ADDR_BMP_SIZE)
+    {
+      return true;
+    }
+
+  port->prio[addr / 32] &= ~(1u << (addr % 32));
+  if (msg->flags == RPMSG_NS_DESTROY)
+    {
+      return true;
+    }
+
+  while (*epts != '\0')
+    {
+      n = strcspn(epts, ";");
+      if (n > 0 && strncmp(msg->name, epts, n) == 0)
+        {
+          port->prio[addr / 32] |= 1u << (addr % 32);
+          break;
+        }
+
+      epts += n + (epts[n] == ';');
+    }
+
+  return true;
+}
+#endif
+
 /****************************************************************************
  * Name: rpmsg_port_send_offchannel_nocopy
  ****************************************************************************/
@@ -281,7 +468,23 @@ static int rpmsg_port_send_offchannel_nocopy(FAR struct rpmsg_device *rdev,
   hdr->len = sizeof(struct rpmsg_port_header_s) +
              sizeof(struct rpmsg_hdr) + len;
 
-  rpmsg_port_queue_add_buffer(&port->txq, hdr);
+#ifdef CONFIG_RPMSG_PORT_PRIO
+  if (rpmsg_port_is_prio(port, src, dst, data, len))
+    {
+      FAR struct list_node *node = RPMSG_PORT_BUF_TO_NODE(&port->txq, hdr);
+
+#  ifdef CONFIG_RPMSG_PORT_STATS
+      port->txq.stamp[node - port->txq.node] = perf_gettime();
+#  endif
+      rpmsg_port_add_prio_node(&port->txq.ready, node);
+      rpmsg_port_post(&port->txq.ready.sem);
+    }
+  else
+#endif
+    {
+      rpmsg_port_queue_add_buffer(&port->txq, hdr);
+    }
+
   if (port->ops->notify_tx_ready)
     {
       port->ops->notify_tx_ready(port);
@@ -699,6 +902,7 @@ rpmsg_port_queue_get_buffer(FAR struct rpmsg_port_queue_s *queue, bool wait)
       node = rpmsg_port_remove_node(&queue->ready);
       if (node)
         {
+          rpmsg_port_queue_stats(queue, node);
           return RPMSG_PORT_NODE_TO_BUF(queue, node);
         }
       else if (!wait)
@@ -719,10 +923,147 @@ void rpmsg_port_queue_add_buffer(FAR struct rpmsg_port_queue_s *queue,
 {
   FAR struct list_node *node = RPMSG_PORT_BUF_TO_NODE(queue, hdr);
 
+#ifdef CONFIG_RPMSG_PORT_STATS
+  queue->stamp[node - queue->node] = perf_gettime();
+#endif
+
   rpmsg_port_add_node(&queue->ready, node);
   rpmsg_port_post(&queue->ready.sem);
 }
 
+#ifdef CONFIG_RPMSG_PORT_BATCH
+
+/****************************************************************************
+ * Name: rpmsg_port_queue_pack
+ ****************************************************************************/
+
+uint16_t rpmsg_port_queue_pack(FAR struct rpmsg_port_queue_s *queue,
+                               FAR struct rpmsg_port_header_s *hdr,
+                               uint16_t max)
+{
+  FAR struct rpmsg_port_header_s *next;
+  FAR struct list_node *node;
+  uint16_t count = 1;
+  uint16_t offset;
+  uint16_t len;
+
+  while (count < max)
+    {
+      offset = ALIGN_UP(hdr->len, RPMSG_PORT_BATCH_ALIGN);
+      if (offset >= queue->len)
+        {
+          break;
+        }
+
+      node = rpmsg_port_remove_fit_node(queue, queue->len - offset);
+      if (node == NULL)
+        {
+          break;
+        }
+
+      rpmsg_port_queue_stats(queue, node);
+
+      next = RPMSG_PORT_NODE_TO_BUF(queue, node);
+      len = next->len - sizeof(*next);
+      memcpy((FAR uint8_t *)hdr + offset, next->buf, len);
+      hdr->len = offset + len;
+
+      rpmsg_port_queue_return_buffer(queue, next);
+      count++;
+    }
+
+#ifdef CONFIG_RPMSG_PORT_STATS
+  if (count > 1)
+    {
+      queue->stats.batches++;
+    }
+#endif
+
+  return count;
+}
+
+/****************************************************************************
+ * Name: rpmsg_port_queue_unpack
+ ****************************************************************************/
+
+int rpmsg_port_queue_unpack(FAR struct rpmsg_port_queue_s *queue,
+                            FAR struct rpmsg_port_header_s *hdr)
+{
+  FAR struct rpmsg_port_header_s *next;
+  FAR struct rpmsg_hdr *rphdr;
+  FAR struct list_node *node;
+  struct list_node frames;
+  uint16_t offset = sizeof(*hdr);
+  uint16_t first = 0;
+  uint16_t len;
+  int count = 0;
+
+  list_initialize(&frames);
+  if (hdr->len > queue->len)
+    {
+      hdr->len = queue->len;
+    }
+
+  while (offset + sizeof(*rphdr) <= hdr->len)
+    {
+      rphdr = (FAR struct rpmsg_hdr *)((FAR uint8_t *)hdr + offset);
+      len = sizeof(*rphdr) + rphdr->len;
+      if (offset + len > hdr->len)
+        {
+          rpmsgerr("malformed batch, frames dropped\n");
+          break;
+        }
+
+      if (count == 0)
+        {
+          first = len;
+        }
+      else
+        {
+          next = rpmsg_port_queue_get_available_buffer(queue, false);
+          if (next == NULL)
+            {
+              rpmsgerr("no rx buffer for batch, frames dropped\n");
+              break;
+            }
+
+          next->crc   = hdr->crc;
+          next->cmd   = hdr->cmd;
+          next->avail = hdr->avail;
+          next->len   = sizeof(*next) + len;
+          memcpy(next->buf, rphdr, len);
+          list_add_tail(&frames, RPMSG_PORT_BUF_TO_NODE(queue, next));
+        }
+
+      count++;
+      offset = ALIGN_UP(offset + len, RPMSG_PORT_BATCH_ALIGN);
+    }
+
+  if (count == 0)
+    {
+      return 0;
+    }
+
+  hdr->len = sizeof(*hdr) + first;
+  rpmsg_port_queue_add_buffer(queue, hdr);
+  while ((node = list_remove_head(&frames)) != NULL)
+    {
+      rpmsg_port_queue_add_buffer(queue,
+                                  RPMSG_PORT_NODE_TO_BUF(queue, node));
+    }
+
+#ifdef CONFIG_RPMSG_PORT_STATS
+  if (count > 1)
+    {
+      queue->stats.batches++;
+    }
+#endif
+
+  return count;
+}
+
+#endif /* CONFIG_RPMSG_PORT_BATCH */
+
 /****************************************************************************
  * Name: rpmsg_port_register
  ****************************************************************************/
@@ -763,6 +1104,31 @@ void rpmsg_port_unregister(FAR struct rpmsg_port_s *port)
   rpmsg_device_destory(&port->rpmsg);
 }
 
+/****************************************************************************
+ * Name: rpmsg_port_dump_stats
+ ****************************************************************************/
+
+#ifdef CONFIG_RPMSG_PORT_STATS
+static void rpmsg_port_dump_stats(FAR struct rpmsg_port_queue_s *queue)
+{
+  FAR struct rpmsg_port_stats_s *stats = &queue->stats;
+  struct timespec latency;
+  struct timespec maxlatency;
+
+  perf_convert(stats->frames ? stats->latency / stats->frames : 0,
+               &latency);
+  perf_convert(stats->maxlatency, &maxlatency);
+
+  metal_log(METAL_LOG_EMERGENCY,
+            "rpmsg_port stats: {frames: %" PRIu32 ", bytes: %" PRIu64
+            ", batches: %" PRIu32 ", latency: %ld us, max: %ld us}\n",
+            stats->frames, stats->bytes, stats->batches,
+            (long)(latency.tv_sec * 1000000 + latency.tv_nsec / 1000),
+            (long)(maxlatency.tv_sec * 1000000 +
+                   maxlatency.tv_nsec / 1000));
+}
+#endif
+
 /****************************************************************************
  * Name: rpmsg_port_dump_buffer
  ****************************************************************************/
@@ -779,6 +1145,9 @@ static void rpmsg_port_dump_buffer(FAR struct rpmsg_device *rdev,
             rx ? "RX" : "TX",
             rpmsg_port_queue_nused(queue),
             rpmsg_port_queue_navail(queue));
+#ifdef CONFIG_RPMSG_PORT_STATS
+  rpmsg_port_dump_stats(queue);
+#endif
   metal_log(METAL_LOG_EMERGENCY, "rpmsg buffer list:\n");
   list_for_every(&queue->ready.head, node)
     {
@@ -29,12 +29,21 @@
 
 #include <metal/atomic.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/list.h>
 #include <nuttx/spinlock.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/rpmsg/rpmsg.h>
 #include <nuttx/rpmsg/rpmsg_port.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Alignment of the frames packed into one buffer */
+
+#define RPMSG_PORT_BATCH_ALIGN 8
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -56,8 +65,22 @@ struct rpmsg_port_list_s
   sem_t            sem;           /* Used to wait for buffer */
   spinlock_t       lock;          /* List lock */
   struct list_node head;          /* List head */
+#ifdef CONFIG_RPMSG_PORT_PRIO
+  FAR struct list_node *prio;     /* Last priority buffer at the head */
+#endif
 };
 
+#ifdef CONFIG_RPMSG_PORT_STATS
+struct rpmsg_port_stats_s
+{
+  uint32_t frames;                /* Frames taken from the ready list */
+  uint32_t batches;               /* Batches packed or unpacked */
+  uint64_t bytes;                 /* Bytes of the frames */
+  clock_t  latency;               /* Total time spent in the ready list */
+  clock_t  maxlatency;            /* Longest time spent in the ready list */
+};
+#endif
+
 struct rpmsg_port_queue_s
 {
   /* Indicate buffers current queue managed is dynamic alloced */
@@ -83,6 +106,14 @@ struct rpmsg_port_queue_s
   /* Ready list of buffers which have been occupied data already */
 
   struct rpmsg_port_list_s ready;
+
+#ifdef CONFIG_RPMSG_PORT_STATS
+  /* Time each buffer was added to the ready list */
+
+  FAR clock_t              *stamp;
+
+  struct rpmsg_port_stats_s stats;
+#endif
 };
 
 struct rpmsg_port_s;
@@ -124,6 +155,14 @@ struct rpmsg_port_s
   /* Ops need implemented by drivers under port layer */
 
   const FAR struct rpmsg_port_ops_s *ops;
+
+#ifdef CONFIG_RPMSG_PORT_PRIO
+  /* Local addresses of the priority endpoints, from the name service
+   * messages sent for them.
+   */
+
+  uint32_t                          prio[RPMSG_ADDR_BMP_SIZE / 32];
+#endif
 };
 
 #ifndef __ASSEMBLY__
@@ -218,6 +257,51 @@ rpmsg_port_queue_get_buffer(FAR struct rpmsg_port_queue_s *queue,
 void rpmsg_port_queue_add_buffer(FAR struct rpmsg_port_queue_s *queue,
                                  FAR struct rpmsg_port_header_s *hdr);
 
+/****************************************************************************
+ * Name: rpmsg_port_queue_pack
+ *
+ * Description:
+ *   Move the frames at the head of the ready list of the queue that fit
+ *   into the buffer just taken from it, and return their buffers to the
+ *   free list.  The frames are aligned to RPMSG_PORT_BATCH_ALIGN and the
+ *   len of the buffer is updated.
+ *
+ * Input Parameters:
+ *   queue - The queue the buffer was taken from.
+ *   hdr   - The buffer taken by rpmsg_port_queue_get_buffer.
+ *   max   - The maximum number of frames in the buffer.
+ *
+ * Returned Value:
+ *   The number of frames in the buffer, one if nothing was packed.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_RPMSG_PORT_BATCH
+uint16_t rpmsg_port_queue_pack(FAR struct rpmsg_port_queue_s *queue,
+                               FAR struct rpmsg_port_header_s *hdr,
+                               uint16_t max);
+
+/****************************************************************************
+ * Name: rpmsg_port_queue_unpack
+ *
+ * Description:
+ *   Split a buffer packed by rpmsg_port_queue_pack and add its frames to
+ *   the ready list of the queue.  The first frame stays in the buffer,
+ *   the others are copied to buffers of the free list.
+ *
+ * Input Parameters:
+ *   queue - The queue to be added to.
+ *   hdr   - The packed buffer.
+ *
+ * Returned Value:
+ *   The number of frames added, the buffer isn't added if it is zero.
+ *
+ ****************************************************************************/
+
+int rpmsg_port_queue_unpack(FAR struct rpmsg_port_queue_s *queue,
+                            FAR struct rpmsg_port_header_s *hdr);
+#endif
+
 /****************************************************************************
  * Name: rpmsg_port_queue_navail
  *
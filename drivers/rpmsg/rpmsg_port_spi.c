@@ -57,6 +57,7 @@ enum rpmsg_port_spi_cmd_e
   RPMSG_PORT_SPI_CMD_CONNECT = 0x01,
   RPMSG_PORT_SPI_CMD_AVAIL,
   RPMSG_PORT_SPI_CMD_DATA,
+  RPMSG_PORT_SPI_CMD_BATCH,
 };
 
 struct rpmsg_port_spi_s
@@ -213,6 +214,14 @@ static void rpmsg_port_spi_exchange(FAR struct rpmsg_port_spi_s *rpspi)
       DEBUGASSERT(txhdr != NULL);
 
       txhdr->cmd = RPMSG_PORT_SPI_CMD_DATA;
+#ifdef CONFIG_RPMSG_PORT_SPI_BATCH
+      if (rpmsg_port_queue_pack(&rpspi->port.txq, txhdr,
+                                rpspi->txavail) > 1)
+        {
+          txhdr->cmd = RPMSG_PORT_SPI_CMD_BATCH;
+        }
+#endif
+
       rpspi->txhdr = txhdr;
     }
   else
@@ -289,6 +298,23 @@ static void rpmsg_port_spi_complete_handler(FAR void *arg)
         }
     }
 
+#ifdef CONFIG_RPMSG_PORT_SPI_BATCH
+  /* Split the batch now, so that the rx buffers left are right in the
+   * next transfer.
+   */
+
+  if (rpspi->rxhdr->cmd == RPMSG_PORT_SPI_CMD_BATCH)
+    {
+      rpspi->rxhdr->cmd = RPMSG_PORT_SPI_CMD_DATA;
+      if (rpmsg_port_queue_unpack(&rpspi->port.rxq, rpspi->rxhdr) > 0)
+        {
+          rpspi->rxhdr = rpmsg_port_queue_get_available_buffer(
+            &rpspi->port.rxq, false);
+          DEBUGASSERT(rpspi->rxhdr != NULL);
+        }
+    }
+  else
+#endif
   if (rpspi->rxhdr->cmd != RPMSG_PORT_SPI_CMD_AVAIL)
     {
       rpmsg_port_queue_add_buffer(&rpspi->port.rxq, rpspi->rxhdr);
@@ -58,6 +58,10 @@ struct rpmsg_virtio_priv_s
   sem_t                         semtx;
   sem_t                         semrx;
   pid_t                         tid;
+#ifdef CONFIG_RPMSG_VIRTIO_BATCH_KICK
+  bool                          batch;
+  bool                          kick;
+#endif
 };
 
 /****************************************************************************
@@ -196,18 +200,44 @@ static void rpmsg_virtio_set_features(FAR struct virtio_device *vdev,
   priv->rsc->rpmsg_vdev.gfeatures = features;
 }
 
+static bool rpmsg_virtio_is_recursive(FAR struct rpmsg_virtio_priv_s *priv)
+{
+  return nxsched_gettid() == priv->tid;
+}
+
 static void rpmsg_virtio_notify(FAR struct virtqueue *vq)
 {
   FAR struct virtio_device *vdev = vq->vq_dev;
   FAR struct rpmsg_virtio_priv_s *priv = rpmsg_virtio_get_priv(vdev);
 
+#ifdef CONFIG_RPMSG_VIRTIO_BATCH_KICK
+  /* The kicks made by the rx thread while it dispatches the received
+   * buffers (the returned rx buffers and the replies of the endpoint
+   * callbacks) are coalesced into one, rung once the batch is done.
+   */
+
+  if (priv->batch && rpmsg_virtio_is_recursive(priv))
+    {
+      priv->kick = true;
+      return;
+    }
+#endif
+
   RPMSG_VIRTIO_NOTIFY(priv->dev, vdev->vrings_info->notifyid);
 }
 
-static bool rpmsg_virtio_is_recursive(FAR struct rpmsg_virtio_priv_s *priv)
+#ifdef CONFIG_RPMSG_VIRTIO_BATCH_KICK
+static void rpmsg_virtio_kick(FAR struct rpmsg_virtio_priv_s *priv)
 {
-  return nxsched_gettid() == priv->tid;
+  if (priv->kick)
+    {
+      priv->kick = false;
+      RPMSG_VIRTIO_NOTIFY(priv->dev, priv->vdev.vrings_info->notifyid);
+    }
 }
+#else
+#  define rpmsg_virtio_kick(priv)
+#endif
 
 static int rpmsg_virtio_wait(FAR struct rpmsg_s *rpmsg, FAR sem_t *sem)
 {
@@ -228,6 +258,7 @@ static int rpmsg_virtio_wait(FAR struct rpmsg_s *rpmsg, FAR sem_t *sem)
           break;
         }
 
+      rpmsg_virtio_kick(priv);
       nxsem_wait(&priv->semtx);
       virtqueue_notification(priv->rvdev.rvq);
     }
@@ -279,7 +310,7 @@ static void rpmsg_virtio_panic(FAR struct rpmsg_s *rpmsg)
       cmd->cmd_slave = RPMSG_VIRTIO_CMD(RPMSG_VIRTIO_CMD_PANIC, 0);
     }
 
-  rpmsg_virtio_notify(priv->vdev.vrings_info->vq);
+  RPMSG_VIRTIO_NOTIFY(priv->dev, priv->vdev.vrings_info->notifyid);
 }
 
 #ifdef CONFIG_OPENAMP_DEBUG
@@ -492,8 +523,11 @@ static int rpmsg_virtio_notify_wait(FAR struct rpmsg_device *rdev,
       return -EAGAIN;
     }
 
-  /* Wait to wakeup */
+  /* Ring the pending kick, the remote may be waiting for it to return
+   * the tx buffers, then wait to wakeup
+   */
 
+  rpmsg_virtio_kick(priv);
   nxsem_tickwait(&priv->semtx, MSEC2TICK(RPMSG_VIRTIO_TIMEOUT_MS));
   virtqueue_notification(priv->rvdev.rvq);
 
@@ -525,6 +559,17 @@ static int rpmsg_virtio_start(FAR struct rpmsg_virtio_priv_s *priv)
 
   priv->rsc = rsc;
 
+#ifdef CONFIG_RPMSG_VIRTIO_EVENT_IDX
+  /* The master owns the features, the slave reads them from the resource
+   * table once the master is ready.
+   */
+
+  if (RPMSG_VIRTIO_IS_MASTER(priv->dev))
+    {
+      rsc->rpmsg_vdev.dfeatures |= VIRTIO_RING_F_EVENT_IDX;
+    }
+#endif
+
   vdev->notifyid = RPMSG_VIRTIO_NOTIFYID;
   vdev->vrings_num = rsc->rpmsg_vdev.num_of_vrings;
   vdev->role = RPMSG_VIRTIO_IS_MASTER(priv->dev) ? RPMSG_HOST : RPMSG_REMOTE;
@@ -619,7 +664,14 @@ static int rpmsg_virtio_thread(int argc, FAR char *argv[])
   while (1)
     {
       nxsem_wait_uninterruptible(&priv->semrx);
+#ifdef CONFIG_RPMSG_VIRTIO_BATCH_KICK
+      priv->batch = true;
       virtqueue_notification(priv->rvdev.rvq);
+      priv->batch = false;
+      rpmsg_virtio_kick(priv);
+#else
+      virtqueue_notification(priv->rvdev.rvq);
+#endif
     }
 
   return 0;
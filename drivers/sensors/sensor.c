@@ -24,6 +24,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/mman.h>
 #include <sys/types.h>
 #include <stdbool.h>
 #include <stdio.h>
@@ -38,6 +39,7 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/circbuf.h>
 #include <nuttx/mutex.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/sensors/sensor.h>
 
 /****************************************************************************
@@ -50,6 +52,7 @@
 #define DEVNAME_FMT         "/dev/uorb/sensor_%s%s%d"
 #define DEVNAME_UNCAL       "_uncal"
 #define TIMING_BUF_ESIZE    (sizeof(uint32_t))
+#define LATEST_MAX_TOPICS   16
 
 /****************************************************************************
  * Private Types
@@ -119,6 +122,9 @@ struct sensor_upperhalf_s
   struct circbuf_s   buffer;             /* The circular buffer of data */
   rmutex_t           lock;               /* Manages exclusive access to file operations */
   struct list_node   userlist;           /* List of users */
+#ifdef CONFIG_SENSORS_MMAP
+  FAR struct sensor_mmap_s *map;         /* The buffers mapped by subscribers */
+#endif
 };
 
 /****************************************************************************
@@ -135,6 +141,10 @@ static ssize_t sensor_write(FAR struct file *filep, FAR const char *buffer,
                             size_t buflen);
 static int     sensor_ioctl(FAR struct file *filep, int cmd,
                             unsigned long arg);
+#ifdef CONFIG_SENSORS_MMAP
+static int     sensor_mmap(FAR struct file *filep,
+                           FAR struct mm_map_entry_s *map);
+#endif
 static int     sensor_poll(FAR struct file *filep, FAR struct pollfd *fds,
                            bool setup);
 static ssize_t sensor_push_event(FAR void *priv, FAR const void *data,
@@ -221,7 +231,11 @@ static const struct file_operations g_sensor_fops =
   sensor_write,   /* write */
   NULL,           /* seek  */
   sensor_ioctl,   /* ioctl */
+#ifdef CONFIG_SENSORS_MMAP
+  sensor_mmap,    /* mmap */
+#else
   NULL,           /* mmap */
+#endif
   NULL,           /* truncate */
   sensor_poll     /* poll  */
 };
@@ -396,6 +410,92 @@ static void sensor_generate_timing(FAR struct sensor_upperhalf_s *upper,
     }
 }
 
+#ifdef CONFIG_SENSORS_MMAP
+static void sensor_publish_mmap(FAR struct sensor_upperhalf_s *upper,
+                                FAR const void *data, unsigned long nums)
+{
+  FAR struct sensor_mmap_s *map = upper->map;
+  FAR uint32_t *timing = SENSOR_MMAP_TIMING(map);
+  uint32_t interval = upper->state.min_interval != UINT32_MAX ?
+                      upper->state.min_interval : 1;
+  uint32_t slot;
+
+  /* The slot of the timing buffer is the generation counter of the
+   * sample, cleared while the sample is rewritten.
+   */
+
+  while (nums-- > 0)
+    {
+      slot = map->count % map->nbuffer;
+      timing[slot] = 0;
+      SP_DMB();
+
+      circbuf_overwrite(&upper->buffer, data, upper->state.esize);
+      upper->state.generation += interval;
+      SP_DMB();
+
+      circbuf_overwrite(&upper->timing, &upper->state.generation,
+                        TIMING_BUF_ESIZE);
+      SP_DMB();
+
+      map->generation = upper->state.generation;
+      map->count++;
+      data = (FAR const uint8_t *)data + upper->state.esize;
+    }
+}
+#endif
+
+static int sensor_init_buffer(FAR struct sensor_upperhalf_s *upper)
+{
+  FAR struct sensor_lowerhalf_s *lower = upper->lower;
+  FAR void *timing = NULL;
+  FAR void *buffer = NULL;
+  int ret;
+
+  if (circbuf_is_init(&upper->buffer))
+    {
+      return 0;
+    }
+
+#ifdef CONFIG_SENSORS_MMAP
+  upper->map = kmm_zalloc(SENSOR_MMAP_SIZE(lower->nbuffer,
+                                           upper->state.esize));
+  if (upper->map == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  upper->map->esize   = upper->state.esize;
+  upper->map->nbuffer = lower->nbuffer;
+  timing = SENSOR_MMAP_TIMING(upper->map);
+  buffer = SENSOR_MMAP_DATA(upper->map);
+#endif
+
+  ret = circbuf_init(&upper->buffer, buffer, lower->nbuffer *
+                     upper->state.esize);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  ret = circbuf_init(&upper->timing, timing, lower->nbuffer *
+                     TIMING_BUF_ESIZE);
+  if (ret < 0)
+    {
+      circbuf_uninit(&upper->buffer);
+      goto errout;
+    }
+
+  return 0;
+
+errout:
+#ifdef CONFIG_SENSORS_MMAP
+  kmm_free(upper->map);
+  upper->map = NULL;
+#endif
+  return ret;
+}
+
 static bool sensor_is_updated(FAR struct sensor_upperhalf_s *upper,
                               FAR struct sensor_user_s *user)
 {
@@ -590,6 +690,128 @@ static void sensor_pollnotify(FAR struct sensor_upperhalf_s *upper,
     }
 }
 
+static void sensor_lock_latest(FAR struct sensor_upperhalf_s **uppers,
+                               uint32_t ntopics, bool lock)
+{
+  FAR struct sensor_upperhalf_s *upper;
+  uintptr_t prev = 0;
+  uint32_t i;
+
+  /* Take the locks in the order of the addresses, so that two callers
+   * can't dead lock, and each of them only once.
+   */
+
+  for (; ; )
+    {
+      upper = NULL;
+      for (i = 0; i < ntopics; i++)
+        {
+          if ((uintptr_t)uppers[i] > prev &&
+              (upper == NULL || uppers[i] < upper))
+            {
+              upper = uppers[i];
+            }
+        }
+
+      if (upper == NULL)
+        {
+          break;
+        }
+
+      if (lock)
+        {
+          nxrmutex_lock(&upper->lock);
+        }
+      else
+        {
+          nxrmutex_unlock(&upper->lock);
+        }
+
+      prev = (uintptr_t)upper;
+    }
+}
+
+static int sensor_get_latest(FAR struct sensor_latest_s *latest)
+{
+  FAR struct sensor_upperhalf_s *uppers[LATEST_MAX_TOPICS];
+  FAR struct file *files[LATEST_MAX_TOPICS];
+  FAR struct sensor_upperhalf_s *upper;
+  FAR struct sensor_topic_s *topic;
+  uint32_t i;
+
+  if (latest == NULL || latest->ntopics > LATEST_MAX_TOPICS)
+    {
+      return -EINVAL;
+    }
+
+  for (i = 0; i < latest->ntopics; i++)
+    {
+      topic = &latest->topics[i];
+      uppers[i] = NULL;
+      if (fs_getfilep(topic->fd, &files[i]) < 0)
+        {
+          files[i] = NULL;
+          topic->result = -EBADF;
+        }
+      else if (files[i]->f_inode->u.i_ops != &g_sensor_fops)
+        {
+          topic->result = -ENOTTY;
+        }
+      else
+        {
+          uppers[i] = files[i]->f_inode->i_private;
+        }
+    }
+
+  /* All the topics are locked together, so the samples are consistent */
+
+  sensor_lock_latest(uppers, latest->ntopics, true);
+
+  for (i = 0; i < latest->ntopics; i++)
+    {
+      topic = &latest->topics[i];
+      upper = uppers[i];
+      if (upper == NULL)
+        {
+          continue;
+        }
+
+      if (upper->lower->ops->fetch)
+        {
+          topic->result = -ENOTSUP;
+        }
+      else if (circbuf_is_empty(&upper->buffer))
+        {
+          topic->result = -ENODATA;
+        }
+      else if (topic->len < upper->state.esize)
+        {
+          topic->result = -EINVAL;
+        }
+      else
+        {
+          topic->result = circbuf_peekat(&upper->buffer,
+                                         upper->buffer.head -
+                                         upper->state.esize,
+                                         topic->buffer,
+                                         upper->state.esize);
+          topic->generation = upper->state.generation;
+        }
+    }
+
+  sensor_lock_latest(uppers, latest->ntopics, false);
+
+  for (i = 0; i < latest->ntopics; i++)
+    {
+      if (files[i] != NULL)
+        {
+          fs_putfilep(files[i]);
+        }
+    }
+
+  return OK;
+}
+
 static int sensor_open(FAR struct file *filep)
 {
   FAR struct inode *inode = filep->f_inode;
@@ -843,6 +1065,13 @@ static int sensor_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
+      case SNIOC_GET_LATEST:
+        {
+          ret = sensor_get_latest((FAR struct sensor_latest_s *)
+                                  (uintptr_t)arg);
+        }
+        break;
+
       case SNIOC_SET_INTERVAL:
         {
           nxrmutex_lock(&upper->lock);
@@ -1079,11 +1308,54 @@ errout:
   return ret;
 }
 
+#ifdef CONFIG_SENSORS_MMAP
+static int sensor_mmap(FAR struct file *filep,
+                       FAR struct mm_map_entry_s *map)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct sensor_upperhalf_s *upper = inode->i_private;
+  FAR struct sensor_lowerhalf_s *lower = upper->lower;
+  int ret;
+
+  /* The samples fetched from the driver directly aren't buffered, and the
+   * buffer is only written by the publishers.
+   */
+
+  if (lower->ops->fetch)
+    {
+      return -ENOTSUP;
+    }
+
+  if (map->prot & PROT_WRITE)
+    {
+      return -EACCES;
+    }
+
+  nxrmutex_lock(&upper->lock);
+  ret = sensor_init_buffer(upper);
+  if (ret >= 0)
+    {
+      if (map->offset == 0 && map->length > 0 &&
+          map->length <= SENSOR_MMAP_SIZE(upper->map->nbuffer,
+                                          upper->map->esize))
+        {
+          map->vaddr = upper->map;
+        }
+      else
+        {
+          ret = -EINVAL;
+        }
+    }
+
+  nxrmutex_unlock(&upper->lock);
+  return ret;
+}
+#endif
+
 static ssize_t sensor_push_event(FAR void *priv, FAR const void *data,
                                  size_t bytes)
 {
   FAR struct sensor_upperhalf_s *upper = priv;
-  FAR struct sensor_lowerhalf_s *lower = upper->lower;
   FAR struct sensor_user_s *user;
   unsigned long envcount;
   int semcount;
@@ -1114,30 +1386,21 @@ static ssize_t sensor_push_event(FAR void *priv, FAR const void *data,
       return -EINVAL;
     }
 
-  if (!circbuf_is_init(&upper->buffer))
-    {
-      /* Initialize sensor buffer when data is first generated */
-
-      ret = circbuf_init(&upper->buffer, NULL, lower->nbuffer *
-                         upper->state.esize);
-      if (ret < 0)
-        {
-          nxrmutex_unlock(&upper->lock);
-          return ret;
-        }
+  /* Initialize sensor buffer when data is first generated */
 
-      ret = circbuf_init(&upper->timing, NULL, lower->nbuffer *
-                         TIMING_BUF_ESIZE);
-      if (ret < 0)
-        {
-          circbuf_uninit(&upper->buffer);
-          nxrmutex_unlock(&upper->lock);
-          return ret;
-        }
+  ret = sensor_init_buffer(upper);
+  if (ret < 0)
+    {
+      nxrmutex_unlock(&upper->lock);
+      return ret;
     }
 
+#ifdef CONFIG_SENSORS_MMAP
+  sensor_publish_mmap(upper, data, envcount);
+#else
   circbuf_overwrite(&upper->buffer, data, bytes);
   sensor_generate_timing(upper, envcount);
+#endif
   list_for_every_entry(&upper->userlist, user, struct sensor_user_s, node)
     {
       if (sensor_is_updated(upper, user))
@@ -1426,5 +1689,8 @@ void sensor_custom_unregister(FAR struct sensor_lowerhalf_s *lower,
       circbuf_uninit(&upper->timing);
     }
 
+#ifdef CONFIG_SENSORS_MMAP
+  kmm_free(upper->map);
+#endif
   kmm_free(upper);
 }
@@ -0,0 +1,346 @@
+/****************************************************************************
+ * drivers/sensors/sensor_fifo.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <string.h>
+#include <sys/param.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/sensors/sensor_fifo.h>
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/* The period is measured between the reference time stamps of two
+ * batches, then filtered, and kept within a factor of two of the nominal
+ * one, so that a late interrupt doesn't skew the time stamps.
+ */
+
+static void sensor_fifo_update(FAR struct sensor_fifo_s *fifo,
+                               uint64_t reftime, uint32_t refindex)
+{
+  uint32_t frames = refindex - fifo->refindex;
+  uint64_t period;
+
+  if (fifo->reftime != 0 && (int32_t)frames > 0 &&
+      reftime > fifo->reftime)
+    {
+      period = (reftime - fifo->reftime) * NSEC_PER_USEC / frames;
+      period = MAX(period, (uint64_t)fifo->interval * NSEC_PER_USEC / 2);
+      period = MIN(period, (uint64_t)fifo->interval * NSEC_PER_USEC * 2);
+      fifo->period = (fifo->period * 7 + period) / 8;
+    }
+
+  fifo->reftime  = reftime;
+  fifo->refindex = refindex;
+}
+
+static int sensor_fifo_harvest(FAR struct sensor_fifo_s *fifo)
+{
+  FAR struct sensor_lowerhalf_s *lower = fifo->lower;
+  uint64_t timestamp;
+  uint64_t irqtime;
+  uint64_t reftime;
+  uint32_t refindex;
+  irqstate_t flags;
+  size_t size;
+  int level;
+  int ret;
+  int i;
+
+  flags = enter_critical_section();
+  irqtime = fifo->irqtime;
+  fifo->irqtime = 0;
+  leave_critical_section(flags);
+
+  reftime = irqtime != 0 ? irqtime : sensor_get_timestamp();
+  level = fifo->ops->level(fifo);
+  if (level <= 0)
+    {
+      return level;
+    }
+
+  /* The interrupt time stamps the frame that reached the watermark, the
+   * poll time the newest frame.
+   */
+
+  if (irqtime != 0)
+    {
+      refindex = fifo->index + MIN(level, fifo->watermark) - 1;
+    }
+  else
+    {
+      refindex = fifo->index + level - 1;
+    }
+
+  sensor_fifo_update(fifo, reftime, refindex);
+
+  while (level > 0)
+    {
+      ret = fifo->ops->read(fifo, fifo->frames, MIN(level, fifo->nframes));
+      if (ret <= 0)
+        {
+          return ret;
+        }
+
+      size = 0;
+      for (i = 0; i < ret; i++)
+        {
+          timestamp = reftime + (int64_t)(int32_t)(fifo->index - refindex) *
+                      (int64_t)fifo->period / NSEC_PER_USEC;
+          if (timestamp <= fifo->last)
+            {
+              timestamp = fifo->last + 1;
+            }
+
+          size += fifo->ops->convert(fifo, fifo->frames +
+                                     i * fifo->framesize, timestamp,
+                                     fifo->events + size);
+          fifo->last = timestamp;
+          fifo->index++;
+        }
+
+      if (size > 0)
+        {
+          lower->push_event(lower->priv, fifo->events, size);
+        }
+
+      level -= ret;
+    }
+
+  return OK;
+}
+
+static void sensor_fifo_worker(FAR void *arg)
+{
+  FAR struct sensor_fifo_s *fifo = arg;
+
+  nxmutex_lock(&fifo->lock);
+  if (fifo->interval != 0)
+    {
+      sensor_fifo_harvest(fifo);
+      if (fifo->poll)
+        {
+          work_queue(HPWORK, &fifo->work, sensor_fifo_worker, fifo,
+                     USEC2TICK((uint64_t)fifo->interval * fifo->watermark));
+        }
+    }
+
+  nxmutex_unlock(&fifo->lock);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sensor_fifo_init
+ *
+ * Description:
+ *   Initialize the FIFO helper and allocate the buffers of one batch.
+ *
+ * Input Parameters:
+ *   fifo      - The FIFO to initialize
+ *   ops       - The operations of the hardware FIFO
+ *   lower     - The lower half the events are pushed to
+ *   framesize - The size of one hardware frame
+ *   esize     - The size of one sensor event
+ *   nframes   - The frames read at most by one transfer
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int sensor_fifo_init(FAR struct sensor_fifo_s *fifo,
+                     FAR const struct sensor_fifo_ops_s *ops,
+                     FAR struct sensor_lowerhalf_s *lower,
+                     size_t framesize, size_t esize, unsigned int nframes)
+{
+  DEBUGASSERT(fifo != NULL && ops != NULL && lower != NULL);
+  DEBUGASSERT(framesize > 0 && esize > 0 && nframes > 0);
+
+  memset(fifo, 0, sizeof(*fifo));
+
+  /* The frames are read in one block, so that one transfer moves all */
+
+  fifo->frames = kmm_malloc(nframes * (framesize + esize));
+  if (fifo->frames == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  fifo->events    = fifo->frames + nframes * framesize;
+  fifo->ops       = ops;
+  fifo->lower     = lower;
+  fifo->framesize = framesize;
+  fifo->esize     = esize;
+  fifo->nframes   = nframes;
+  nxmutex_init(&fifo->lock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: sensor_fifo_uninit
+ *
+ * Description:
+ *   Stop the harvesting and free the buffers.
+ *
+ ****************************************************************************/
+
+void sensor_fifo_uninit(FAR struct sensor_fifo_s *fifo)
+{
+  sensor_fifo_stop(fifo);
+  nxmutex_destroy(&fifo->lock);
+  kmm_free(fifo->frames);
+  fifo->frames = NULL;
+}
+
+/****************************************************************************
+ * Name: sensor_fifo_start
+ *
+ * Description:
+ *   Start the harvesting, or restart it after the output data rate or the
+ *   watermark change.
+ *
+ * Input Parameters:
+ *   fifo      - The FIFO
+ *   interval  - The output data period, in us
+ *   watermark - The frames that raise the interrupt, or trigger the poll
+ *   poll      - Poll the FIFO every watermark frames
+ *
+ ****************************************************************************/
+
+void sensor_fifo_start(FAR struct sensor_fifo_s *fifo, uint32_t interval,
+                       unsigned int watermark, bool poll)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(interval > 0 && watermark > 0);
+
+  nxmutex_lock(&fifo->lock);
+
+  flags = enter_critical_section();
+  fifo->irqtime = 0;
+  leave_critical_section(flags);
+
+  /* Restart the measure of the period from the nominal one */
+
+  fifo->interval  = interval;
+  fifo->watermark = watermark;
+  fifo->period    = (uint64_t)interval * NSEC_PER_USEC;
+  fifo->reftime   = 0;
+  fifo->poll      = poll;
+
+  if (poll)
+    {
+      work_queue(HPWORK, &fifo->work, sensor_fifo_worker, fifo,
+                 USEC2TICK((uint64_t)interval * watermark));
+    }
+
+  nxmutex_unlock(&fifo->lock);
+}
+
+/****************************************************************************
+ * Name: sensor_fifo_stop
+ *
+ * Description:
+ *   Stop the harvesting.  The frames left in the hardware FIFO are lost.
+ *
+ ****************************************************************************/
+
+void sensor_fifo_stop(FAR struct sensor_fifo_s *fifo)
+{
+  nxmutex_lock(&fifo->lock);
+  fifo->interval = 0;
+  nxmutex_unlock(&fifo->lock);
+
+  work_cancel_sync(HPWORK, &fifo->work);
+}
+
+/****************************************************************************
+ * Name: sensor_fifo_interrupt
+ *
+ * Description:
+ *   Tell that the FIFO reached the watermark.  It is called from the
+ *   interrupt handler, which time stamps the batch.
+ *
+ ****************************************************************************/
+
+void sensor_fifo_interrupt(FAR struct sensor_fifo_s *fifo)
+{
+  irqstate_t flags;
+
+  /* Keep the time stamp of the first interrupt if the worker is late */
+
+  flags = enter_critical_section();
+  if (fifo->irqtime == 0)
+    {
+      fifo->irqtime = sensor_get_timestamp();
+    }
+
+  leave_critical_section(flags);
+
+  work_queue(HPWORK, &fifo->work, sensor_fifo_worker, fifo, 0);
+}
+
+/****************************************************************************
+ * Name: sensor_fifo_flush
+ *
+ * Description:
+ *   Harvest the FIFO now and push the flush complete event.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int sensor_fifo_flush(FAR struct sensor_fifo_s *fifo)
+{
+  FAR struct sensor_lowerhalf_s *lower = fifo->lower;
+  int ret;
+
+  nxmutex_lock(&fifo->lock);
+  if (fifo->interval == 0)
+    {
+      nxmutex_unlock(&fifo->lock);
+      return -EINVAL;
+    }
+
+  ret = sensor_fifo_harvest(fifo);
+  nxmutex_unlock(&fifo->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  lower->push_event(lower->priv, NULL, 0);
+  return OK;
+}
@@ -25,6 +25,7 @@
 #include <nuttx/config.h>
 
 #include <fcntl.h>
+#include <sys/param.h>
 #include <debug.h>
 
 #include <nuttx/nuttx.h>
@@ -832,6 +833,7 @@ static void sensor_rpmsg_push_event_one(FAR struct sensor_rpmsg_dev_s *dev,
   FAR struct sensor_rpmsg_ept_s *sre;
   FAR struct sensor_rpmsg_data_s *msg;
   struct sensor_ustate_s state;
+  uint32_t delay;
   uint64_t now;
   bool updated;
   int ret;
@@ -849,6 +851,18 @@ static void sensor_rpmsg_push_event_one(FAR struct sensor_rpmsg_dev_s *dev,
       state.interval = 0;
     }
 
+  /* The samples wait up to half of the interval, or up to the batch
+   * latency of the subscriber if it is longer, so that the samples of a
+   * batching subscriber go to the remote core in one message.
+   */
+
+  if (state.latency == UINT32_MAX)
+    {
+      state.latency = 0;
+    }
+
+  delay = MAX(state.interval / 2, state.latency);
+
   sre = container_of(stub->ept, struct sensor_rpmsg_ept_s, ept);
   nxrmutex_lock(&sre->lock);
 
@@ -937,10 +951,9 @@ static void sensor_rpmsg_push_event_one(FAR struct sensor_rpmsg_dev_s *dev,
     }
   else
     {
-      if (sre->expire == UINT64_MAX ||
-          sre->expire - now > state.interval / 2)
+      if (sre->expire == UINT64_MAX || sre->expire - now > delay)
         {
-          sre->expire = now + state.interval / 2;
+          sre->expire = now + delay;
         }
 
       work_queue(HPWORK, &sre->work, sensor_rpmsg_data_worker, sre,
@@ -566,8 +566,9 @@ static ssize_t pty_write(FAR struct file *filep,
 
   if ((dev->pd_oflag & OPOST) != 0)
     {
-      /* We will transfer one byte at a time, making the appropriae
-       * translations.  Specifically not handled:
+      /* Runs of characters that need no translation are transferred with
+       * a single write, the others one byte at a time, making the
+       * appropriate translations.  Specifically not handled:
        *
        *   OXTABS - primarily a full-screen terminal optimisation
        *   ONOEOT - Unix interoperability hack
@@ -576,9 +577,66 @@ static ssize_t pty_write(FAR struct file *filep,
        */
 
       ntotal = 0;
-      for (i = 0; i < len; i++)
+      while (len > 0)
         {
+          /* Find the end of the run of ordinary characters */
+
+          for (i = 0; i < len; i++)
+            {
+              ch = buffer[i];
+              if ((ch == '\r' && (dev->pd_oflag & OCRNL) != 0) ||
+                  (ch == '\n' && (dev->pd_oflag & (ONLCR | ONLRET)) != 0))
+                {
+                  break;
+                }
+
+#ifdef CONFIG_TTY_SIGINT
+              if (pid > 0 && ch == CONFIG_TTY_SIGINT_CHAR)
+                {
+                  break;
+                }
+#endif
+
+#ifdef CONFIG_TTY_SIGTSTP
+              if (pid > 0 && ch == CONFIG_TTY_SIGTSTP_CHAR)
+                {
+                  break;
+                }
+#endif
+            }
+
+          if (i > 0)
+            {
+              /* Transfer the run.  This will block if the sink pipe is
+               * full.
+               *
+               * REVISIT: Should not block if the oflags include O_NONBLOCK.
+               * How would we ripple the O_NONBLOCK characteristic to the
+               * contained sink pipe?  file_fcntl()?  Or FIONSPACE?  See the
+               * TODO comment at the top of this file.
+               */
+
+              nwritten = file_write(&dev->pd_sink, buffer, i);
+              if (nwritten < 0)
+                {
+                  ntotal = nwritten;
+                  break;
+                }
+
+              ntotal += nwritten;
+              buffer += nwritten;
+              len    -= nwritten;
+
+              if ((size_t)nwritten < i)
+                {
+                  break;
+                }
+
+              continue;
+            }
+
           ch = *buffer++;
+          len--;
 
           /* Mapping CR to NL? */
 
@@ -593,13 +651,7 @@ static ssize_t pty_write(FAR struct file *filep,
             {
               char cr = '\r';
 
-              /* Transfer the carriage return.  This will block if the
-               * sink pipe is full.
-               *
-               * REVISIT: Should not block if the oflags include O_NONBLOCK.
-               * How would we ripple the O_NONBLOCK characteristic to the
-               * contained sink pipe?  file_fcntl()?  Or FIONSPACE?  See the
-               * TODO comment at the top of this file.
+              /* Transfer the carriage return.
                *
                * NOTE: The newline is not included in total number of bytes
                * written.  Otherwise, we would return more than the
@@ -630,14 +682,7 @@ static ssize_t pty_write(FAR struct file *filep,
             }
 #endif
 
-          /* Transfer the (possibly translated) character..  This will block
-           * if the sink pipe is full
-           *
-           * REVISIT: Should not block if the oflags include O_NONBLOCK.
-           * How would we ripple the O_NONBLOCK characteristic to the
-           * contained sink pipe?  file_fcntl()?  Or FIONSPACe?  See the
-           * TODO comment at the top of this file.
-           */
+          /* Transfer the (possibly translated) character */
 
           nwritten = file_write(&dev->pd_sink, &ch, 1);
           if (nwritten < 0)
@@ -855,6 +855,9 @@ static ssize_t uart_read(FAR struct file *filep,
   irqstate_t flags;
   ssize_t recvd = 0;
   bool echoed = false;
+#ifdef CONFIG_SERIAL_RXDMA_DIRECT
+  bool direct;
+#endif
   int16_t tail;
   char ch;
   int ret;
@@ -1126,6 +1129,25 @@ static ssize_t uart_read(FAR struct file *filep,
                * additional data to be received.
                */
 
+#ifdef CONFIG_SERIAL_RXDMA_DIRECT
+              /* Nothing to process?  Then the lower half can receive into
+               * the buffer of the caller directly.
+               */
+
+              direct = recvd == 0 && dev->ops->dmarxstop != NULL &&
+                       (dev->tc_iflag & (INLCR | IGNCR | ICRNL)) == 0 &&
+                       (dev->tc_lflag & (ICANON | ECHO)) == 0;
+#  ifdef CONFIG_SERIAL_TERMIOS
+              direct = direct && dev->minread <= 1;
+#  endif
+              if (direct)
+                {
+                  dev->rxdirectrecv = 0;
+                  dev->rxdirectlen   = buflen;
+                  dev->rxdirect      = buffer;
+                }
+#endif
+
 #ifdef CONFIG_SERIAL_RXDMA
               /* Notify DMA that there is free space in the RX buffer */
 
@@ -1150,7 +1172,23 @@ static ssize_t uart_read(FAR struct file *filep,
 
               if (rxbuf->head != rxbuf->tail)
                 {
+#ifdef CONFIG_SERIAL_RXDMA_DIRECT
+                  if (direct && dev->rxdirect != NULL)
+                    {
+                      dev->ops->dmarxstop(dev);
+                      dev->rxdirect = NULL;
+                    }
+#endif
+
                   leave_critical_section(flags);
+#ifdef CONFIG_SERIAL_RXDMA_DIRECT
+                  if (direct && dev->rxdirectrecv > 0)
+                    {
+                      recvd = dev->rxdirectrecv;
+                      break;
+                    }
+#endif
+
                   continue;
                 }
 
@@ -1207,8 +1245,28 @@ static ssize_t uart_read(FAR struct file *filep,
                     }
                 }
 
+#ifdef CONFIG_SERIAL_RXDMA_DIRECT
+              /* Woken up before the direct receive finished, stop it so
+               * that the buffer isn't written after the return.
+               */
+
+              if (direct && dev->rxdirect != NULL)
+                {
+                  dev->ops->dmarxstop(dev);
+                  dev->rxdirect = NULL;
+                }
+#endif
+
               leave_critical_section(flags);
 
+#ifdef CONFIG_SERIAL_RXDMA_DIRECT
+              if (direct && dev->rxdirectrecv > 0)
+                {
+                  recvd = dev->rxdirectrecv;
+                  break;
+                }
+#endif
+
               /* Was a signal received while waiting for data to be
                * received?  Was a removable device disconnected while
                * we were waiting?
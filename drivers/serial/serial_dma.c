@@ -188,6 +188,21 @@ void uart_recvchars_dma(FAR uart_dev_t *dev)
   bool is_full;
   int nexthead;
 
+#ifdef CONFIG_SERIAL_RXDMA_DIRECT
+  /* A read() is waiting on the empty buffer, receive into its buffer */
+
+  if (dev->rxdirect != NULL && rxbuf->head == rxbuf->tail)
+    {
+      xfer->buffer  = dev->rxdirect;
+      xfer->length  = dev->rxdirectlen;
+      xfer->nbuffer = NULL;
+      xfer->nlength = 0;
+
+      uart_dmareceive(dev);
+      return;
+    }
+#endif
+
   /* Get the next head index and check if there is room to adding another
    * byte to the buffer.
    */
@@ -318,6 +333,33 @@ void uart_recvchars_done(FAR uart_dev_t *dev)
   signo = uart_recvchars_check_special(dev);
 #endif
 
+#ifdef CONFIG_SERIAL_RXDMA_DIRECT
+  if (dev->rxdirect != NULL && xfer->buffer == dev->rxdirect)
+    {
+      /* The bytes are in the buffer of read() already, wake it up */
+
+      dev->rxdirectrecv = nbytes;
+      dev->rxdirect      = NULL;
+      xfer->nbytes       = 0;
+      xfer->length       = xfer->nlength = 0;
+
+      if (nbytes)
+        {
+          uart_datareceived(dev);
+        }
+
+#  if defined(CONFIG_TTY_SIGINT) || defined(CONFIG_TTY_SIGTSTP) || \
+      defined(CONFIG_TTY_FORCE_PANIC) || defined(CONFIG_TTY_LAUNCH)
+      if (signo != 0)
+        {
+          nxsig_tgkill(-1, dev->pid, signo);
+        }
+#  endif
+
+      return;
+    }
+#endif
+
   /* Move head for nbytes. */
 
   rxbuf->head  = (rxbuf->head + nbytes) % rxbuf->size;
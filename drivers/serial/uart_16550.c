@@ -103,6 +103,9 @@ static void u16550_dmatxconfig(FAR struct uart_dev_s *dev);
 static void u16550_dmareceive(FAR struct uart_dev_s *dev);
 static void u16550_dmarxfree(FAR struct uart_dev_s *dev);
 static void u16550_dmarxconfig(FAR struct uart_dev_s *dev);
+#  ifdef CONFIG_SERIAL_RXDMA_DIRECT
+static void u16550_dmarxstop(FAR struct uart_dev_s *dev);
+#  endif
 #endif
 static void u16550_send(FAR struct uart_dev_s *dev, int ch);
 static void u16550_txint(FAR struct uart_dev_s *dev, bool enable);
@@ -151,6 +154,9 @@ static const struct uart_ops_s g_uart_ops =
   .txint          = u16550_txint,
   .txready        = u16550_txready,
   .txempty        = u16550_txempty,
+#if defined(HAVE_16550_UART_DMA) && defined(CONFIG_SERIAL_RXDMA_DIRECT)
+  .dmarxstop      = u16550_dmarxstop,
+#endif
 };
 
 /* I/O buffers */
@@ -1362,13 +1368,31 @@ static void u16550_dmasend_done(FAR struct dma_chan_s *chan,
 static void u16550_dmasend(FAR struct uart_dev_s *dev)
 {
   FAR struct u16550_s *priv = dev->priv;
-  FAR void *buffer = dev->dmatx.buffer;
-  size_t length = dev->dmatx.length;
+  FAR struct uart_dmaxfer_s *xfer = &dev->dmatx;
+  uintptr_t uartbase = up_addrenv_va_to_pa((FAR void *)priv->uartbase);
+
+  /* Send both parts of a wrapped buffer as one transfer */
 
-  up_clean_dcache((uintptr_t)buffer, (uintptr_t)buffer + length);
-  DMA_START(priv->chantx, u16550_dmasend_done, dev,
-            up_addrenv_va_to_pa((FAR void *)priv->uartbase),
-            up_addrenv_va_to_pa(buffer), length);
+  priv->dmatxsg[0].dst = uartbase;
+  priv->dmatxsg[0].src = up_addrenv_va_to_pa(xfer->buffer);
+  priv->dmatxsg[0].len = xfer->length;
+  priv->dmatxlist.sg   = priv->dmatxsg;
+  priv->dmatxlist.nsg  = 1;
+
+  up_clean_dcache((uintptr_t)xfer->buffer,
+                  (uintptr_t)xfer->buffer + xfer->length);
+  if (xfer->nlength > 0)
+    {
+      priv->dmatxsg[1].dst = uartbase;
+      priv->dmatxsg[1].src = up_addrenv_va_to_pa(xfer->nbuffer);
+      priv->dmatxsg[1].len = xfer->nlength;
+      priv->dmatxlist.nsg  = 2;
+
+      up_clean_dcache((uintptr_t)xfer->nbuffer,
+                      (uintptr_t)xfer->nbuffer + xfer->nlength);
+    }
+
+  dma_start_sg(priv->chantx, u16550_dmasend_done, dev, &priv->dmatxlist);
 }
 
 static void u16550_dmareceive_done(FAR struct dma_chan_s *chan,
@@ -1451,6 +1475,31 @@ static void u16550_dmareceive(FAR struct uart_dev_s *dev)
     }
 }
 
+#ifdef CONFIG_SERIAL_RXDMA_DIRECT
+static void u16550_dmarxstop(FAR struct uart_dev_s *dev)
+{
+  FAR struct u16550_s *priv = dev->priv;
+
+  /* The bytes are copied from the cyclic buffer as soon as the RX timeout
+   * reports them, so a pending receive has nothing in flight: complete it
+   * with what is there.
+   */
+
+  if (dev->dmarx.length != 0)
+    {
+      if (priv->dmarxhead != priv->dmarxtail)
+        {
+          u16550_dmareceive(dev);
+        }
+      else
+        {
+          dev->dmarx.nbytes = 0;
+          uart_recvchars_done(dev);
+        }
+    }
+}
+#endif
+
 static void u16550_dmarxconfig(FAR struct uart_dev_s *dev)
 {
   FAR struct u16550_s *priv = dev->priv;
@@ -1480,7 +1529,7 @@ static void u16550_dmarxfree(FAR struct uart_dev_s *dev)
 
   if (priv->chanrx == NULL)
     {
-      priv->chanrx = priv->ops->dmachan(priv, priv->dmarx)
+      priv->chanrx = priv->ops->dmachan(priv, priv->dmarx);
       if (priv->chanrx == NULL)
         {
           return; /* Fail to get DMA channel */
@@ -1851,4 +1900,22 @@ void u16550_putc(FAR struct u16550_s *priv, int ch)
   u16550_serialout(priv, UART_THR_OFFSET, (uart_datawidth_t)ch);
 }
 
+/****************************************************************************
+ * Name: uart_dmachan
+ *
+ * Description:
+ *   Get the DMA channel of the identity from the DMA controllers
+ *   registered by dma_register(), the identity is DMA_IDENT(devno, chan).
+ *   The architecture overrides it if its controller isn't registered.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_16550_UART_DMA
+FAR struct dma_chan_s *weak_function uart_dmachan(FAR struct u16550_s *priv,
+                                                  unsigned int ident)
+{
+  return dma_get_chan(ident);
+}
+#endif
+
 #endif /* CONFIG_16550_UART */
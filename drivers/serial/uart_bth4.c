@@ -270,6 +270,7 @@ static ssize_t uart_bth4_write(FAR struct file *filep,
   uint8_t *data;
   size_t pktlen;
   size_t hdrlen;
+  size_t offset;
   int ret;
 
   ret = nxmutex_lock(&dev->sendlock);
@@ -299,11 +300,19 @@ static ssize_t uart_bth4_write(FAR struct file *filep,
          buffer, buflen);
   dev->sendlen += buflen;
 
-  hdr = (FAR union bt_hdr_u *)data;
+  /* Send all of the complete packets where they are, then move what is
+   * left of an incomplete one to the front only once.  The reserved head
+   * room of a packet after the first one overlaps the packet before it,
+   * which has been sent already.
+   */
 
-  for (; ; )
+  offset = 0;
+
+  while (dev->sendlen > 0)
     {
-      switch (*(data - H4_HEADER_SIZE))
+      hdr = (FAR union bt_hdr_u *)(data + offset);
+
+      switch (*(data + offset - H4_HEADER_SIZE))
         {
           case H4_CMD:
             hdrlen = sizeof(struct bt_hci_cmd_hdr_s);
@@ -331,34 +340,36 @@ static ssize_t uart_bth4_write(FAR struct file *filep,
 
       if (dev->sendlen < hdrlen)
         {
-          goto out;
+          break;
         }
 
       pktlen += hdrlen;
       if (dev->sendlen < pktlen)
         {
-          goto out;
+          break;
         }
 
       /* Got the full packet, send out */
 
       ret = dev->drv->send(dev->drv, type,
-                           data, pktlen - H4_HEADER_SIZE);
+                           data + offset, pktlen - H4_HEADER_SIZE);
       if (ret < 0)
         {
           goto err;
         }
 
       dev->sendlen -= pktlen;
-      if (dev->sendlen == 0)
-        {
-          goto out;
-        }
+      offset       += pktlen;
+    }
 
-      memmove(data - H4_HEADER_SIZE,
-              dev->sendbuf + pktlen, dev->sendlen);
+  if (dev->sendlen > 0 && offset > 0)
+    {
+      memmove(data - H4_HEADER_SIZE, data + offset - H4_HEADER_SIZE,
+              dev->sendlen);
     }
 
+  goto out;
+
 err:
   dev->sendlen = 0;
 out:
@@ -27,7 +27,25 @@
 
 #include <nuttx/config.h>
 
+#include <sys/types.h>
+#include <stdarg.h>
 #include <stdbool.h>
+#include <time.h>
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The information put in front of a message */
+
+struct syslog_context_s
+{
+  int priority;                 /* Priority of the message */
+  int cpu;                      /* CPU that logged the message */
+  pid_t pid;                    /* Thread that logged the message */
+  FAR const char *name;         /* Name of that thread */
+  struct timespec ts;           /* Time stamp of the message */
+};
 
 /****************************************************************************
  * Public Data
@@ -228,6 +246,77 @@ int syslog_add_intbuffer(int ch);
 #ifdef CONFIG_SYSLOG_INTBUFFER
 int syslog_flush_intbuffer(bool force);
 #endif
+
+/****************************************************************************
+ * Name: syslog_format
+ *
+ * Description:
+ *   Format and write to the SYSLOG channels a message whose arguments were
+ *   packed in the layout of lib_bsprintf().
+ *
+ * Input Parameters:
+ *   ctx  - The prefix information, collected when the message was logged
+ *   fmt  - The format of the message
+ *   args - The packed arguments
+ *
+ * Returned Value:
+ *   The number of characters written.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+int syslog_format(FAR const struct syslog_context_s *ctx,
+                  FAR const IPTR char *fmt, FAR const void *args);
+#endif
+
+/****************************************************************************
+ * Name: syslog_deferred_add
+ *
+ * Description:
+ *   Queue a message in the ring of this CPU, to be formatted later by the
+ *   work queue.  Only the arguments are copied, so this is cheap and does
+ *   not block.  If the ring is full, the message is dropped and counted.
+ *
+ * Input Parameters:
+ *   ctx - The prefix information
+ *   fmt - The format of the message, which must stay valid
+ *   ap  - The arguments of the message
+ *
+ * Returned Value:
+ *   Zero (OK) if the message was queued or dropped.  A negated errno value
+ *   is returned if the message must be formatted right away, because it is
+ *   too late or too early to defer it, because it is too long or because
+ *   the format uses a conversion that cannot be packed.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+int syslog_deferred_add(FAR const struct syslog_context_s *ctx,
+                        FAR const IPTR char *fmt, FAR va_list *ap);
+#endif
+
+/****************************************************************************
+ * Name: syslog_deferred_flush
+ *
+ * Description:
+ *   Format and write all of the queued messages.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   May be called with interrupts disabled by the crash-handling logic.
+ *   Otherwise, nothing is done in interrupt context, the work queue will
+ *   write the messages.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+void syslog_deferred_flush(void);
+#endif
 #endif /* CONFIG_SYSLOG */
 
 #undef EXTERN
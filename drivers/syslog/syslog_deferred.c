@@ -0,0 +1,695 @@
+/****************************************************************************
+ * drivers/syslog/syslog_deferred.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <syslog.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/init.h>
+#include <nuttx/irq.h>
+#include <nuttx/mutex.h>
+#include <nuttx/sched.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/syslog/syslog.h>
+#include <nuttx/wqueue.h>
+
+#include "syslog.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+#  define SYSLOG_DEFERRED_NRINGS CONFIG_SMP_NCPUS
+#else
+#  define SYSLOG_DEFERRED_NRINGS 1
+#endif
+
+#ifdef CONFIG_SCHED_LPWORK
+#  define SYSLOG_DEFERRED_WORK   LPWORK
+#else
+#  define SYSLOG_DEFERRED_WORK   HPWORK
+#endif
+
+#define SYSLOG_DEFERRED_DELAY    MSEC2TICK(CONFIG_SYSLOG_DEFERRED_DELAY)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A queued message: this header followed by the arguments packed in the
+ * layout of lib_bsprintf().
+ */
+
+struct syslog_deferred_hdr_s
+{
+  uint16_t length;                  /* Header and arguments */
+  uint8_t priority;                 /* Priority of the message */
+  uint8_t cpu;                      /* CPU that logged the message */
+  pid_t pid;                        /* Thread that logged the message */
+  FAR const IPTR char *fmt;         /* Format of the message */
+  struct timespec ts;               /* Time stamp of the message */
+#ifdef CONFIG_SYSLOG_PROCESS_NAME
+  char name[CONFIG_TASK_NAME_SIZE + 1];
+#endif
+};
+
+union syslog_deferred_msg_u
+{
+  struct syslog_deferred_hdr_s hdr;
+  uint8_t data[CONFIG_SYSLOG_DEFERRED_MSGSIZE];
+};
+
+/* The ring of one CPU.  The CPU is the only producer and always adds its
+ * messages with interrupts disabled, the work queue (or the crash handler)
+ * is the only consumer.  So neither side takes a lock: the producer only
+ * moves 'head' and the consumer only moves 'tail'.
+ */
+
+struct syslog_deferred_s
+{
+  volatile size_t head;             /* Next byte to write */
+  volatile size_t tail;             /* Next byte to read */
+  volatile size_t dropped;          /* Messages dropped, ring full */
+  size_t reported;                  /* Dropped messages already reported */
+  uint8_t buffer[CONFIG_SYSLOG_DEFERRED_BUFSIZE];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct syslog_deferred_s g_syslog_deferred[SYSLOG_DEFERRED_NRINGS];
+static struct work_s g_syslog_deferred_work;
+
+/* Serializes the consumers: the work queue and syslog_flush() */
+
+static mutex_t g_syslog_deferred_lock = NXMUTEX_INITIALIZER;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syslog_deferred_put
+ ****************************************************************************/
+
+static bool syslog_deferred_put(FAR uint8_t *args, FAR size_t *next,
+                                size_t size, FAR const void *value,
+                                size_t len)
+{
+  if (*next + len > size)
+    {
+      return false;
+    }
+
+  memcpy(args + *next, value, len);
+  *next += len;
+  return true;
+}
+
+/****************************************************************************
+ * Name: syslog_deferred_pack
+ *
+ * Description:
+ *   Pack the arguments of the format as lib_bsprintf() expects them.
+ *
+ * Returned Value:
+ *   The size of the packed arguments.  -E2BIG is returned if they do not
+ *   fit in 'size' bytes and -ENOTSUP if the format uses a conversion that
+ *   lib_bsprintf() cannot reproduce.
+ *
+ ****************************************************************************/
+
+static ssize_t syslog_deferred_pack(FAR uint8_t *args, size_t size,
+                                    FAR const IPTR char *fmt, va_list ap)
+{
+  bool infmt = false;
+  size_t next = 0;
+  int prec = -1;
+  bool ok = true;
+  char c;
+
+  while (ok && (c = *fmt++) != '\0')
+    {
+      if (!infmt)
+        {
+          infmt = c == '%';
+          prec = -1;
+          continue;
+        }
+
+      if (c == 'c' || c == 'd' || c == 'i' || c == 'u' ||
+          c == 'o' || c == 'x' || c == 'X')
+        {
+          if (*(fmt - 2) == 'j')
+            {
+              intmax_t value = va_arg(ap, intmax_t);
+              ok = syslog_deferred_put(args, &next, size,
+                                       &value, sizeof(value));
+            }
+#ifdef CONFIG_HAVE_LONG_LONG
+          else if (*(fmt - 2) == 'l' && *(fmt - 3) == 'l')
+            {
+              long long value = va_arg(ap, long long);
+              ok = syslog_deferred_put(args, &next, size,
+                                       &value, sizeof(value));
+            }
+#endif
+          else if (*(fmt - 2) == 'l')
+            {
+              long value = va_arg(ap, long);
+              ok = syslog_deferred_put(args, &next, size,
+                                       &value, sizeof(value));
+            }
+          else if (*(fmt - 2) == 'z')
+            {
+              size_t value = va_arg(ap, size_t);
+              ok = syslog_deferred_put(args, &next, size,
+                                       &value, sizeof(value));
+            }
+          else if (*(fmt - 2) == 't')
+            {
+              ptrdiff_t value = va_arg(ap, ptrdiff_t);
+              ok = syslog_deferred_put(args, &next, size,
+                                       &value, sizeof(value));
+            }
+          else if (*(fmt - 2) == 'h' && *(fmt - 3) == 'h')
+            {
+              char value = va_arg(ap, int);
+              ok = syslog_deferred_put(args, &next, size,
+                                       &value, sizeof(value));
+            }
+          else if (*(fmt - 2) == 'h')
+            {
+              short int value = va_arg(ap, int);
+              ok = syslog_deferred_put(args, &next, size,
+                                       &value, sizeof(value));
+            }
+          else
+            {
+              int value = va_arg(ap, int);
+              ok = syslog_deferred_put(args, &next, size,
+                                       &value, sizeof(value));
+            }
+
+          infmt = false;
+        }
+      else if (c == 'e' || c == 'f' || c == 'g' || c == 'a' ||
+               c == 'A' || c == 'E' || c == 'F' || c == 'G')
+        {
+#ifdef CONFIG_HAVE_DOUBLE
+          if (*(fmt - 2) == 'h')
+            {
+              float value = va_arg(ap, double);
+              ok = syslog_deferred_put(args, &next, size,
+                                       &value, sizeof(value));
+            }
+#  ifdef CONFIG_HAVE_LONG_DOUBLE
+          else if (*(fmt - 2) == 'L')
+            {
+              long double value = va_arg(ap, long double);
+              ok = syslog_deferred_put(args, &next, size,
+                                       &value, sizeof(value));
+            }
+#  endif
+          else
+            {
+              double value = va_arg(ap, double);
+              ok = syslog_deferred_put(args, &next, size,
+                                       &value, sizeof(value));
+            }
+
+          infmt = false;
+#else
+          return -ENOTSUP;
+#endif
+        }
+      else if (c == '*')
+        {
+          int value = va_arg(ap, int);
+
+          if (*(fmt - 2) == '.')
+            {
+              prec = value;
+            }
+
+          ok = syslog_deferred_put(args, &next, size,
+                                   &value, sizeof(value));
+        }
+      else if (c == '.')
+        {
+          if (*fmt >= '0' && *fmt <= '9')
+            {
+              prec = strtol(fmt, NULL, 10);
+            }
+        }
+      else if (c == 's')
+        {
+          FAR const char *value = va_arg(ap, FAR const char *);
+          size_t len;
+
+          if (value == NULL)
+            {
+              value = "(null)";
+            }
+
+          /* lib_bsprintf() skips 'prec' bytes when the precision is
+           * given, so pad the string to that length.
+           */
+
+          if (prec >= 0)
+            {
+              len = strnlen(value, prec);
+              ok = syslog_deferred_put(args, &next, size, value, len) &&
+                   next + prec - len <= size;
+              if (ok)
+                {
+                  memset(args + next, 0, prec - len);
+                  next += prec - len;
+                }
+            }
+          else
+            {
+              ok = syslog_deferred_put(args, &next, size, value,
+                                       strlen(value) + 1);
+            }
+
+          infmt = false;
+        }
+      else if (c == 'p')
+        {
+          uintptr_t value;
+
+#ifdef CONFIG_LIBC_PRINT_EXTENSION
+          /* %pB, %pV and %pS refer to memory of the caller or need the
+           * symbol table, format them right away.
+           */
+
+          if (*fmt == 'B' || *fmt == 'V' || *fmt == 'S' || *fmt == 's')
+            {
+              return -ENOTSUP;
+            }
+#endif
+
+          value = (uintptr_t)va_arg(ap, FAR void *);
+          ok = syslog_deferred_put(args, &next, size,
+                                   &value, sizeof(value));
+          infmt = false;
+        }
+      else if (c == '%')
+        {
+          infmt = false;
+        }
+      else if (c == 'n' || c == '$')
+        {
+          return -ENOTSUP;
+        }
+    }
+
+  return ok ? next : -E2BIG;
+}
+
+/****************************************************************************
+ * Name: syslog_deferred_used
+ ****************************************************************************/
+
+static size_t syslog_deferred_used(size_t head, size_t tail)
+{
+  return head >= tail ? head - tail :
+         CONFIG_SYSLOG_DEFERRED_BUFSIZE - tail + head;
+}
+
+/****************************************************************************
+ * Name: syslog_deferred_copyin
+ ****************************************************************************/
+
+static size_t syslog_deferred_copyin(FAR struct syslog_deferred_s *ring,
+                                     size_t pos, FAR const uint8_t *src,
+                                     size_t len)
+{
+  size_t n = CONFIG_SYSLOG_DEFERRED_BUFSIZE - pos;
+
+  if (n > len)
+    {
+      n = len;
+    }
+
+  memcpy(ring->buffer + pos, src, n);
+  memcpy(ring->buffer, src + n, len - n);
+
+  pos += len;
+  if (pos >= CONFIG_SYSLOG_DEFERRED_BUFSIZE)
+    {
+      pos -= CONFIG_SYSLOG_DEFERRED_BUFSIZE;
+    }
+
+  return pos;
+}
+
+/****************************************************************************
+ * Name: syslog_deferred_copyout
+ ****************************************************************************/
+
+static void syslog_deferred_copyout(FAR struct syslog_deferred_s *ring,
+                                    size_t pos, FAR uint8_t *dest,
+                                    size_t len)
+{
+  size_t n = CONFIG_SYSLOG_DEFERRED_BUFSIZE - pos;
+
+  if (n > len)
+    {
+      n = len;
+    }
+
+  memcpy(dest, ring->buffer + pos, n);
+  memcpy(dest + n, ring->buffer, len - n);
+}
+
+/****************************************************************************
+ * Name: syslog_deferred_peek
+ *
+ * Description:
+ *   Read the header of the oldest message in the ring, if any.
+ *
+ ****************************************************************************/
+
+static bool syslog_deferred_peek(FAR struct syslog_deferred_s *ring,
+                                 FAR struct syslog_deferred_hdr_s *hdr)
+{
+  size_t tail = ring->tail;
+
+  if (ring->head == tail)
+    {
+      return false;
+    }
+
+  /* Read the message only after seeing the head that covers it */
+
+  SP_DMB();
+  syslog_deferred_copyout(ring, tail, (FAR uint8_t *)hdr, sizeof(*hdr));
+  return true;
+}
+
+/****************************************************************************
+ * Name: syslog_deferred_next
+ *
+ * Description:
+ *   Select the ring holding the oldest message.  The time stamps, if there
+ *   are any, merge the rings; otherwise they are drained one after the
+ *   other.
+ *
+ ****************************************************************************/
+
+static FAR struct syslog_deferred_s *
+syslog_deferred_next(FAR struct syslog_deferred_hdr_s *hdr)
+{
+  FAR struct syslog_deferred_s *next = NULL;
+  struct syslog_deferred_hdr_s tmp;
+  int i;
+
+  for (i = 0; i < SYSLOG_DEFERRED_NRINGS; i++)
+    {
+      FAR struct syslog_deferred_s *ring = &g_syslog_deferred[i];
+
+      if (!syslog_deferred_peek(ring, next != NULL ? &tmp : hdr))
+        {
+          continue;
+        }
+
+      if (next == NULL)
+        {
+          next = ring;
+#ifndef CONFIG_SYSLOG_TIMESTAMP
+          break;
+#endif
+        }
+#ifdef CONFIG_SYSLOG_TIMESTAMP
+      else if (clock_timespec_compare(&tmp.ts, &hdr->ts) < 0)
+        {
+          *hdr = tmp;
+          next = ring;
+        }
+#endif
+    }
+
+  return next;
+}
+
+/****************************************************************************
+ * Name: syslog_deferred_report
+ *
+ * Description:
+ *   Report the messages dropped since the last report.
+ *
+ ****************************************************************************/
+
+static void syslog_deferred_report(void)
+{
+  struct syslog_context_s ctx;
+  int i;
+
+  for (i = 0; i < SYSLOG_DEFERRED_NRINGS; i++)
+    {
+      FAR struct syslog_deferred_s *ring = &g_syslog_deferred[i];
+      size_t dropped = ring->dropped - ring->reported;
+
+      if (dropped == 0)
+        {
+          continue;
+        }
+
+      memset(&ctx, 0, sizeof(ctx));
+      ctx.priority = LOG_WARNING;
+      ctx.cpu = i;
+      ctx.name = "";
+      syslog_format(&ctx, "[%zu messages dropped]\n", &dropped);
+      ring->reported += dropped;
+    }
+}
+
+/****************************************************************************
+ * Name: syslog_deferred_drain
+ ****************************************************************************/
+
+static void syslog_deferred_drain(void)
+{
+  FAR struct syslog_deferred_s *ring;
+  union syslog_deferred_msg_u msg;
+  struct syslog_context_s ctx;
+
+  while ((ring = syslog_deferred_next(&msg.hdr)) != NULL)
+    {
+      size_t tail = ring->tail;
+
+      syslog_deferred_copyout(ring, tail, msg.data, msg.hdr.length);
+
+      /* Release the space only once the message is copied out */
+
+      SP_DMB();
+      tail += msg.hdr.length;
+      if (tail >= CONFIG_SYSLOG_DEFERRED_BUFSIZE)
+        {
+          tail -= CONFIG_SYSLOG_DEFERRED_BUFSIZE;
+        }
+
+      ring->tail = tail;
+
+      ctx.priority = msg.hdr.priority;
+      ctx.cpu      = msg.hdr.cpu;
+      ctx.pid      = msg.hdr.pid;
+      ctx.ts       = msg.hdr.ts;
+#ifdef CONFIG_SYSLOG_PROCESS_NAME
+      ctx.name     = msg.hdr.name;
+#else
+      ctx.name     = "";
+#endif
+
+      syslog_format(&ctx, msg.hdr.fmt, msg.data + sizeof(msg.hdr));
+    }
+
+  syslog_deferred_report();
+}
+
+/****************************************************************************
+ * Name: syslog_deferred_worker
+ ****************************************************************************/
+
+static void syslog_deferred_worker(FAR void *arg)
+{
+  nxmutex_lock(&g_syslog_deferred_lock);
+  syslog_deferred_drain();
+  nxmutex_unlock(&g_syslog_deferred_lock);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syslog_deferred_add
+ *
+ * Description:
+ *   Queue a message in the ring of this CPU, to be formatted later by the
+ *   work queue.  Only the arguments are copied, so this is cheap and does
+ *   not block.  If the ring is full, the message is dropped and counted.
+ *
+ * Input Parameters:
+ *   ctx - The prefix information
+ *   fmt - The format of the message, which must stay valid
+ *   ap  - The arguments of the message
+ *
+ * Returned Value:
+ *   Zero (OK) if the message was queued or dropped.  A negated errno value
+ *   is returned if the message must be formatted right away, because it is
+ *   too late or too early to defer it, because it is too long or because
+ *   the format uses a conversion that cannot be packed.
+ *
+ ****************************************************************************/
+
+int syslog_deferred_add(FAR const struct syslog_context_s *ctx,
+                        FAR const IPTR char *fmt, FAR va_list *ap)
+{
+  FAR struct syslog_deferred_s *ring;
+  union syslog_deferred_msg_u msg;
+  irqstate_t flags;
+  ssize_t len;
+  size_t head;
+  va_list copy;
+
+  /* Nobody would format the message before the work queues run or after
+   * a crash.
+   */
+
+  if (!OSINIT_OS_READY() || g_nx_initstate == OSINIT_PANIC)
+    {
+      return -EAGAIN;
+    }
+
+  /* Pack the message in the stack first, the ring is touched only once
+   * the size is known.  The caller still needs the arguments if this
+   * fails.
+   */
+
+  va_copy(copy, *ap);
+  len = syslog_deferred_pack(msg.data + sizeof(msg.hdr),
+                             sizeof(msg) - sizeof(msg.hdr), fmt, copy);
+  va_end(copy);
+
+  if (len < 0)
+    {
+      return len;
+    }
+
+  msg.hdr.length   = sizeof(msg.hdr) + len;
+  msg.hdr.priority = ctx->priority;
+  msg.hdr.pid      = ctx->pid;
+  msg.hdr.fmt      = fmt;
+  msg.hdr.ts       = ctx->ts;
+#ifdef CONFIG_SYSLOG_PROCESS_NAME
+  strlcpy(msg.hdr.name, ctx->name, sizeof(msg.hdr.name));
+#endif
+
+  /* Disabling the interrupts makes this CPU the only producer of its
+   * ring.
+   */
+
+  flags = up_irq_save();
+  msg.hdr.cpu = this_cpu();
+  ring = &g_syslog_deferred[msg.hdr.cpu];
+  head = ring->head;
+
+  /* One byte stays free, so a full ring differs from an empty one */
+
+  if (syslog_deferred_used(head, ring->tail) + msg.hdr.length >=
+      CONFIG_SYSLOG_DEFERRED_BUFSIZE)
+    {
+      ring->dropped++;
+    }
+  else
+    {
+      head = syslog_deferred_copyin(ring, head, msg.data, msg.hdr.length);
+
+      /* Publish the head only once the message is visible */
+
+      SP_DMB();
+      ring->head = head;
+    }
+
+  up_irq_restore(flags);
+
+  if (work_available(&g_syslog_deferred_work))
+    {
+      work_queue(SYSLOG_DEFERRED_WORK, &g_syslog_deferred_work,
+                 syslog_deferred_worker, NULL, SYSLOG_DEFERRED_DELAY);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: syslog_deferred_flush
+ *
+ * Description:
+ *   Format and write all of the queued messages.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   May be called with interrupts disabled by the crash-handling logic.
+ *   Otherwise, nothing is done in interrupt context, the work queue will
+ *   write the messages.
+ *
+ ****************************************************************************/
+
+void syslog_deferred_flush(void)
+{
+  /* The crash handler cannot wait for the work queue, which may never
+   * run again.  The other CPUs are stopped by then, so the rings can be
+   * drained without the lock.
+   */
+
+  if (g_nx_initstate == OSINIT_PANIC)
+    {
+      syslog_deferred_drain();
+    }
+  else if (!up_interrupt_context())
+    {
+      syslog_deferred_worker(NULL);
+    }
+}
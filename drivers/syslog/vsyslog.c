@@ -27,6 +27,7 @@
 #include <stdio.h>
 #include <syslog.h>
 #include <errno.h>
+#include <string.h>
 
 #include <nuttx/arch.h>
 #include <nuttx/init.h>
@@ -63,51 +64,25 @@ static FAR const char * const g_priority_str[] =
 #endif
 
 /****************************************************************************
- * Public Functions
+ * Private Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: nx_vsyslog
+ * Name: syslog_getcontext
  *
  * Description:
- *   nx_vsyslog() handles the system logging system calls. It is functionally
- *   equivalent to vsyslog() except that (1) the per-process priority
- *   filtering has already been performed and the va_list parameter is
- *   passed by reference.  That is because the va_list is a structure in
- *   some compilers and passing of structures in the NuttX sycalls does
- *   not work.
+ *   Collect the information put in front of the message.  Only what the
+ *   configured prefix uses is collected.
  *
  ****************************************************************************/
 
-int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
+static void syslog_getcontext(FAR struct syslog_context_s *ctx,
+                              int priority)
 {
-  struct lib_syslograwstream_s stream;
-  int ret = 0;
-#ifdef CONFIG_SYSLOG_PROCESS_NAME
-  FAR struct tcb_s *tcb = nxsched_get_tcb(nxsched_gettid());
-#endif
-#ifdef CONFIG_SYSLOG_TIMESTAMP
-  struct timespec ts;
-#  if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
-  struct tm tm;
-  char date_buf[CONFIG_SYSLOG_TIMESTAMP_BUFFER];
-#  endif
-#endif
-
-  /* Wrap the low-level output in a stream object and let lib_vsprintf
-   * do the work.
-   */
-
-  lib_syslograwstream_open(&stream);
+  memset(ctx, 0, sizeof(*ctx));
+  ctx->priority = priority;
 
 #ifdef CONFIG_SYSLOG_TIMESTAMP
-  ts.tv_sec = 0;
-  ts.tv_nsec = 0;
-
-#  if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
-  memset(&tm, 0, sizeof(tm));
-#  endif
-
   /* Get the current time.  Since debug output may be generated very early
    * in the start-up sequence, hardware timer support may not yet be
    * available.
@@ -118,27 +93,75 @@ int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
 #  if defined(CONFIG_SYSLOG_TIMESTAMP_REALTIME)
       /* Use CLOCK_REALTIME if so configured */
 
-      clock_gettime(CLOCK_REALTIME, &ts);
+      clock_gettime(CLOCK_REALTIME, &ctx->ts);
 #  else
       /* Prefer monotonic when enabled, as it can be synchronized to
        * RTC with clock_resynchronize.
        */
 
-      clock_gettime(CLOCK_MONOTONIC, &ts);
+      clock_gettime(CLOCK_MONOTONIC, &ctx->ts);
+#  endif
+    }
+#endif
+
+#if defined(CONFIG_SMP)
+  ctx->cpu = this_cpu();
+#endif
+
+#if defined(CONFIG_SYSLOG_PROCESSID)
+  ctx->pid = nxsched_gettid();
+#endif
+
+#ifdef CONFIG_SYSLOG_PROCESS_NAME
+  ctx->name = get_task_name(nxsched_get_tcb(nxsched_gettid()));
+#endif
+}
+
+/****************************************************************************
+ * Name: syslog_output
+ *
+ * Description:
+ *   Format the prefix described by 'ctx' and the message, and write them
+ *   to the SYSLOG channels.  The arguments of the message are either the
+ *   va_list 'ap' or, if 'ap' is NULL, the packed arguments 'args' as
+ *   formatted by lib_bsprintf().
+ *
+ ****************************************************************************/
+
+static int syslog_output(FAR const struct syslog_context_s *ctx,
+                         FAR const IPTR char *fmt, FAR va_list *ap,
+                         FAR const void *args)
+{
+  struct lib_syslograwstream_s stream;
+  int ret = 0;
+#ifdef CONFIG_SYSLOG_TIMESTAMP
+#  if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
+  struct tm tm;
+  char date_buf[CONFIG_SYSLOG_TIMESTAMP_BUFFER];
 #  endif
+#endif
+
+  /* Wrap the low-level output in a stream object and let lib_vsprintf
+   * do the work.
+   */
 
-      /* Prepend the message with the current time, if available */
+  lib_syslograwstream_open(&stream);
 
+#ifdef CONFIG_SYSLOG_TIMESTAMP
 #  if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
+  memset(&tm, 0, sizeof(tm));
+
+  /* Prepend the message with the current time, if available */
+
+  if (ctx->ts.tv_sec != 0 || ctx->ts.tv_nsec != 0)
+    {
 #    if defined(CONFIG_SYSLOG_TIMESTAMP_LOCALTIME)
-      localtime_r(&ts.tv_sec, &tm);
+      localtime_r(&ctx->ts.tv_sec, &tm);
 #    else
-      gmtime_r(&ts.tv_sec, &tm);
+      gmtime_r(&ctx->ts.tv_sec, &tm);
 #    endif
-#  endif
     }
 
-#  if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
   date_buf[0] = '\0';
   strftime(date_buf, CONFIG_SYSLOG_TIMESTAMP_BUFFER,
            CONFIG_SYSLOG_TIMESTAMP_FORMAT, &tm);
@@ -204,36 +227,36 @@ int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
 #ifdef CONFIG_SYSLOG_TIMESTAMP
 #  if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
 #    if defined(CONFIG_SYSLOG_TIMESTAMP_FORMAT_MICROSECOND)
-                             , date_buf, ts.tv_nsec / NSEC_PER_USEC
+                             , date_buf, ctx->ts.tv_nsec / NSEC_PER_USEC
 #    else
                              , date_buf
 #    endif
 #  else
-                             , (uintmax_t)ts.tv_sec
-                             , ts.tv_nsec / NSEC_PER_USEC
+                             , (uintmax_t)ctx->ts.tv_sec
+                             , ctx->ts.tv_nsec / NSEC_PER_USEC
 #  endif
 #endif
 
 #if defined(CONFIG_SMP)
-                             , this_cpu()
+                             , ctx->cpu
 #endif
 
 #if defined(CONFIG_SYSLOG_PROCESSID)
   /* Prepend the Thread ID */
 
-                             , nxsched_gettid()
+                             , ctx->pid
 #endif
 
 #if defined(CONFIG_SYSLOG_COLOR_OUTPUT)
   /* Set the terminal style according to message priority. */
 
-                             , g_priority_color[priority]
+                             , g_priority_color[ctx->priority]
 #endif
 
 #if defined(CONFIG_SYSLOG_PRIORITY)
   /* Prepend the message priority. */
 
-                             , g_priority_str[priority]
+                             , g_priority_str[ctx->priority]
 #endif
 
 #if defined(CONFIG_SYSLOG_PREFIX)
@@ -245,7 +268,7 @@ int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
 #ifdef CONFIG_SYSLOG_PROCESS_NAME
   /* Prepend the thread name */
 
-                             , get_task_name(tcb)
+                             , ctx->name
 #endif
                     );
 
@@ -253,7 +276,14 @@ int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
 
   /* Generate the output */
 
-  ret += lib_vsprintf_internal(&stream.common, fmt, *ap);
+  if (ap != NULL)
+    {
+      ret += lib_vsprintf_internal(&stream.common, fmt, *ap);
+    }
+  else
+    {
+      ret += lib_bsprintf(&stream.common, fmt, args);
+    }
 
   if (stream.last_ch != '\n')
     {
@@ -272,3 +302,64 @@ int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
   lib_syslograwstream_close(&stream);
   return ret;
 }
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nx_vsyslog
+ *
+ * Description:
+ *   nx_vsyslog() handles the system logging system calls. It is functionally
+ *   equivalent to vsyslog() except that (1) the per-process priority
+ *   filtering has already been performed and the va_list parameter is
+ *   passed by reference.  That is because the va_list is a structure in
+ *   some compilers and passing of structures in the NuttX sycalls does
+ *   not work.
+ *
+ *   With CONFIG_SYSLOG_DEFERRED, the message is queued and formatted later
+ *   by syslog_deferred_flush().  Zero is returned in that case.
+ *
+ ****************************************************************************/
+
+int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
+{
+  struct syslog_context_s ctx;
+
+  syslog_getcontext(&ctx, priority);
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+  if (syslog_deferred_add(&ctx, fmt, ap) >= 0)
+    {
+      return 0;
+    }
+#endif
+
+  return syslog_output(&ctx, fmt, ap, NULL);
+}
+
+/****************************************************************************
+ * Name: syslog_format
+ *
+ * Description:
+ *   Format and write a message whose arguments were packed in the layout
+ *   of lib_bsprintf().
+ *
+ * Input Parameters:
+ *   ctx  - The prefix information, collected when the message was logged
+ *   fmt  - The format of the message
+ *   args - The packed arguments
+ *
+ * Returned Value:
+ *   The number of characters written.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+int syslog_format(FAR const struct syslog_context_s *ctx,
+                  FAR const IPTR char *fmt, FAR const void *args)
+{
+  return syslog_output(ctx, fmt, NULL, args);
+}
+#endif
@@ -288,6 +288,14 @@ begin_packed_struct struct usb_cdc_ncm_ntb_parameters_s
   uint16_t ntboutmaxdatagrams;
 } end_packed_struct;
 
+/* Container of a bulk request, to keep it in a list */
+
+struct cdcncm_req_s
+{
+  FAR struct cdcncm_req_s    *flink;       /* Implements a singly linked list */
+  FAR struct usbdev_req_s    *req;         /* The contained request */
+};
+
 /* The cdcncm_driver_s encapsulates all state information for a single
  * hardware interface
  */
@@ -305,11 +313,13 @@ struct cdcncm_driver_s
   FAR struct usbdev_ep_s     *epbulkout;   /* Bulk OUT endpoint */
   uint8_t                     config;      /* Selected configuration number */
 
-  FAR struct usbdev_req_s    *rdreq;       /* Single read request */
-  bool                        rxpending;   /* Packet available in rdreq */
+  struct cdcncm_req_s         rdreqs[CONFIG_CDCNCM_NRDREQS];
+  sq_queue_t                  rxpending;   /* Read requests with an NTB */
 
-  FAR struct usbdev_req_s    *wrreq;       /* Single write request */
-  sem_t                       wrreq_idle;  /* Is the wrreq available? */
+  struct cdcncm_req_s         wrreqs[CONFIG_CDCNCM_NWRREQS];
+  sq_queue_t                  wrfree;      /* Idle write requests */
+  FAR struct usbdev_req_s    *wrreq;       /* Write request being filled */
+  sem_t                       wrreq_idle;  /* Count of the idle requests */
   bool                        txdone;      /* Did a write request complete? */
   enum ncm_notify_state_e     notify;      /* State of notify */
   FAR const struct ndp_parser_opts_s
@@ -369,7 +379,8 @@ static int     cdcmbim_poll(FAR struct file *filep, FAR struct pollfd *fds,
 
 /* Interrupt handling */
 
-static void cdcncm_receive(FAR struct cdcncm_driver_s *priv);
+static void cdcncm_receive(FAR struct cdcncm_driver_s *priv,
+                           FAR struct usbdev_req_s *rdreq);
 static void cdcncm_txdone(FAR struct cdcncm_driver_s *priv);
 
 static void cdcncm_interrupt_work(FAR void *arg);
@@ -853,6 +864,24 @@ static void cdcncm_transmit_format(FAR struct cdcncm_driver_s *self,
 
   if (self->dgramcount == 0)
     {
+      FAR struct cdcncm_req_s *wrcontainer;
+      irqstate_t flags;
+
+      /* Start the NTB in an idle write request, waiting for the one that
+       * the host takes first if all of them are in flight.
+       */
+
+      while (nxsem_wait(&self->wrreq_idle) != OK)
+        {
+        }
+
+      flags       = enter_critical_section();
+      wrcontainer = (FAR struct cdcncm_req_s *)sq_remfirst(&self->wrfree);
+      leave_critical_section(flags);
+
+      DEBUGASSERT(wrcontainer != NULL);
+      self->wrreq = wrcontainer->req;
+
       /* Fill NCB */
 
       tmp = self->wrreq->buf;
@@ -916,12 +945,11 @@ static void cdcncm_transmit_work(FAR void *arg)
   int ndpindex;
   int totallen;
 
-  /* Wait until the USB device request for Ethernet frame transmissions
-   * becomes available.
-   */
+  /* Nothing to send if the NTB was sent when it got full */
 
-  while (nxsem_wait(&self->wrreq_idle) != OK)
+  if (self->dgramcount == 0)
     {
+      return;
     }
 
   ncblen   = opts->nthsize;
@@ -948,6 +976,7 @@ static void cdcncm_transmit_work(FAR void *arg)
   self->wrreq->len = totallen;
 
   EP_SUBMIT(self->epbulkin, self->wrreq);
+  self->wrreq = NULL;
 }
 
 /****************************************************************************
@@ -1005,10 +1034,11 @@ static int cdcncm_packet_handler(FAR struct cdcncm_driver_s *self,
  *
  ****************************************************************************/
 
-static void cdcncm_receive(FAR struct cdcncm_driver_s *self)
+static void cdcncm_receive(FAR struct cdcncm_driver_s *self,
+                           FAR struct usbdev_req_s *rdreq)
 {
   FAR const struct ndp_parser_opts_s *opts = self->parseropts;
-  FAR uint8_t *tmp = self->rdreq->buf;
+  FAR uint8_t *tmp = rdreq->buf;
   uint32_t ntbmax = g_ntbparameters.ntboutmaxsize;
   uint32_t blocklen;
   uint32_t ndplen;
@@ -1019,7 +1049,7 @@ static void cdcncm_receive(FAR struct cdcncm_driver_s *self)
 
   if (GETUINT32(tmp) != opts->nthsign)
     {
-      uerr("Wrong NTH SIGN, skblen %zu\n", self->rdreq->xfrd);
+      uerr("Wrong NTH SIGN, skblen %zu\n", rdreq->xfrd);
       return;
     }
 
@@ -1059,7 +1089,7 @@ static void cdcncm_receive(FAR struct cdcncm_driver_s *self)
           return;
         }
 
-      tmp = self->rdreq->buf + ndpindex;
+      tmp = rdreq->buf + ndpindex;
 
       if (GETUINT32(tmp) != self->ndpsign)
         {
@@ -1103,7 +1133,7 @@ static void cdcncm_receive(FAR struct cdcncm_driver_s *self)
 
           /* Copy the data from the hardware to self->rx_queue. */
 
-          cdcncm_packet_handler(self, self->rdreq->buf + index, dglen);
+          cdcncm_packet_handler(self, rdreq->buf + index, dglen);
 
           ndplen -= 2 * (opts->dgramitemlen);
         }
@@ -1153,18 +1183,29 @@ static void cdcncm_txdone(FAR struct cdcncm_driver_s *priv)
 static void cdcncm_interrupt_work(FAR void *arg)
 {
   FAR struct cdcncm_driver_s *self = (FAR struct cdcncm_driver_s *)arg;
+  FAR struct cdcncm_req_s *rdcontainer;
   irqstate_t flags;
 
-  /* Check if we received an incoming packet, if so, call cdcncm_receive() */
+  /* Pass the datagrams of each NTB received to the network, then give the
+   * request back to the bulk OUT endpoint.
+   */
 
-  if (self->rxpending)
+  for (; ; )
     {
-      cdcncm_receive(self);
+      flags       = enter_critical_section();
+      rdcontainer = (FAR struct cdcncm_req_s *)sq_remfirst(&self->rxpending);
+      leave_critical_section(flags);
+
+      if (rdcontainer == NULL)
+        {
+          break;
+        }
+
+      cdcncm_receive(self, rdcontainer->req);
       netdev_lower_rxready(&self->dev);
 
       flags = enter_critical_section();
-      self->rxpending = false;
-      EP_SUBMIT(self->epbulkout, self->rdreq);
+      EP_SUBMIT(self->epbulkout, rdcontainer->req);
       leave_critical_section(flags);
     }
 
@@ -1480,8 +1521,7 @@ static void cdcncm_rdcomplete(FAR struct usbdev_ep_s *ep,
     {
       case 0:  /* Normal completion */
         {
-          DEBUGASSERT(!self->rxpending);
-          self->rxpending = true;
+          sq_addlast((FAR sq_entry_t *)req->priv, &self->rxpending);
           work_queue(ETHWORK, &self->irqwork,
                      cdcncm_interrupt_work, self, 0);
         }
@@ -1493,7 +1533,7 @@ static void cdcncm_rdcomplete(FAR struct usbdev_ep_s *ep,
       default: /* Some other error occurred */
         {
           uerr("req->result: %hd\n", req->result);
-          EP_SUBMIT(self->epbulkout, self->rdreq);
+          EP_SUBMIT(self->epbulkout, req);
         }
         break;
     }
@@ -1512,14 +1552,17 @@ static void cdcncm_wrcomplete(FAR struct usbdev_ep_s *ep,
                               FAR struct usbdev_req_s *req)
 {
   FAR struct cdcncm_driver_s *self = (FAR struct cdcncm_driver_s *)ep->priv;
+  irqstate_t flags;
   int rc;
 
   uinfo("buf: %p, flags 0x%hhx, len %zu, xfrd %zu, result %hd\n",
         req->buf, req->flags, req->len, req->xfrd, req->result);
 
-  /* The single USB device write request is available for upcoming
-   * transmissions again.
-   */
+  /* The write request is available for upcoming transmissions again */
+
+  flags = enter_critical_section();
+  sq_addlast((FAR sq_entry_t *)req->priv, &self->wrfree);
+  leave_critical_section(flags);
 
   rc = nxsem_post(&self->wrreq_idle);
 
@@ -1583,6 +1626,7 @@ static int cdcncm_setconfig(FAR struct cdcncm_driver_s *self, uint8_t config)
 {
   struct usb_ss_epdesc_s epdesc;
   int ret;
+  int i;
 
   if (config == self->config)
     {
@@ -1635,14 +1679,16 @@ static int cdcncm_setconfig(FAR struct cdcncm_driver_s *self, uint8_t config)
 
   /* Queue read requests in the bulk OUT endpoint */
 
-  DEBUGASSERT(!self->rxpending);
+  sq_init(&self->rxpending);
 
-  self->rdreq->callback = cdcncm_rdcomplete,
-  ret = EP_SUBMIT(self->epbulkout, self->rdreq);
-  if (ret != OK)
+  for (i = 0; i < CONFIG_CDCNCM_NRDREQS; i++)
     {
-      uerr("EP_SUBMIT failed. ret %d\n", ret);
-      goto error;
+      ret = EP_SUBMIT(self->epbulkout, self->rdreqs[i].req);
+      if (ret != OK)
+        {
+          uerr("EP_SUBMIT failed. ret %d\n", ret);
+          goto error;
+        }
     }
 
   /* We are successfully configured */
@@ -2477,7 +2523,9 @@ static int cdcncm_bind(FAR struct usbdevclass_driver_s *driver,
                        FAR struct usbdev_s *dev)
 {
   FAR struct cdcncm_driver_s *self = (FAR struct cdcncm_driver_s *)driver;
+  FAR struct usbdev_req_s *req;
   int ret = OK;
+  int i;
 
   uinfo("\n");
 
@@ -2535,31 +2583,45 @@ static int cdcncm_bind(FAR struct usbdevclass_driver_s *driver,
 
   /* Pre-allocate read requests. The buffer size is NTB_DEFAULT_IN_SIZE. */
 
-  self->rdreq = usbdev_allocreq(self->epbulkout, NTB_DEFAULT_IN_SIZE);
-  if (self->rdreq == NULL)
+  for (i = 0; i < CONFIG_CDCNCM_NRDREQS; i++)
     {
-      uerr("Out of memory\n");
-      ret = -ENOMEM;
-      goto error;
+      req = usbdev_allocreq(self->epbulkout, NTB_DEFAULT_IN_SIZE);
+      if (req == NULL)
+        {
+          uerr("Out of memory\n");
+          ret = -ENOMEM;
+          goto error;
+        }
+
+      req->callback       = cdcncm_rdcomplete;
+      req->priv           = &self->rdreqs[i];
+      self->rdreqs[i].req = req;
     }
 
-  self->rdreq->callback = cdcncm_rdcomplete;
+  /* Pre-allocate write requests. Buffer size is NTB_OUT_SIZE */
 
-  /* Pre-allocate a single write request. Buffer size is NTB_OUT_SIZE */
+  sq_init(&self->wrfree);
+  self->wrreq = NULL;
 
-  self->wrreq = usbdev_allocreq(self->epbulkin, NTB_OUT_SIZE);
-  if (self->wrreq == NULL)
+  for (i = 0; i < CONFIG_CDCNCM_NWRREQS; i++)
     {
-      uerr("Out of memory\n");
-      ret = -ENOMEM;
-      goto error;
-    }
+      req = usbdev_allocreq(self->epbulkin, NTB_OUT_SIZE);
+      if (req == NULL)
+        {
+          uerr("Out of memory\n");
+          ret = -ENOMEM;
+          goto error;
+        }
 
-  self->wrreq->callback = cdcncm_wrcomplete;
+      req->callback       = cdcncm_wrcomplete;
+      req->priv           = &self->wrreqs[i];
+      self->wrreqs[i].req = req;
+      sq_addlast((FAR sq_entry_t *)&self->wrreqs[i], &self->wrfree);
+    }
 
-  /* The single write request just allocated is available now. */
+  /* The write requests just allocated are available now. */
 
-  ret = nxsem_init(&self->wrreq_idle, 0, 1);
+  ret = nxsem_init(&self->wrreq_idle, 0, CONFIG_CDCNCM_NWRREQS);
 
   if (ret != OK)
     {
@@ -2592,6 +2654,7 @@ static void cdcncm_unbind(FAR struct usbdevclass_driver_s *driver,
                           FAR struct usbdev_s *dev)
 {
   FAR struct cdcncm_driver_s *self = (FAR struct cdcncm_driver_s *)driver;
+  int i;
 
 #ifdef CONFIG_DEBUG_FEATURES
   if (!driver || !dev)
@@ -2631,10 +2694,13 @@ static void cdcncm_unbind(FAR struct usbdevclass_driver_s *driver,
    * been returned to the free list at this time -- we don't check)
    */
 
-  if (self->rdreq != NULL)
+  for (i = 0; i < CONFIG_CDCNCM_NRDREQS; i++)
     {
-      usbdev_freereq(self->epbulkout, self->rdreq);
-      self->rdreq = NULL;
+      if (self->rdreqs[i].req != NULL)
+        {
+          usbdev_freereq(self->epbulkout, self->rdreqs[i].req);
+          self->rdreqs[i].req = NULL;
+        }
     }
 
   /* Free the bulk OUT endpoint */
@@ -2649,12 +2715,18 @@ static void cdcncm_unbind(FAR struct usbdevclass_driver_s *driver,
    * of them)
    */
 
-  if (self->wrreq != NULL)
+  for (i = 0; i < CONFIG_CDCNCM_NWRREQS; i++)
     {
-      usbdev_freereq(self->epbulkin, self->wrreq);
-      self->wrreq = NULL;
+      if (self->wrreqs[i].req != NULL)
+        {
+          usbdev_freereq(self->epbulkin, self->wrreqs[i].req);
+          self->wrreqs[i].req = NULL;
+        }
     }
 
+  self->wrreq      = NULL;
+  self->dgramcount = 0;
+
   /* Free the bulk IN endpoint */
 
   if (self->epbulkin)
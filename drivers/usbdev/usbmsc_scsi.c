@@ -2255,6 +2255,62 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
     {
       usbtrace(TRACE_CLASSSTATE(USBMSC_CLASSSTATE_CMDREAD), priv->u.xfrlen);
 
+      /* If nothing is buffered and a whole sector fits in a write request,
+       * read as many sectors as fit straight into the request and submit
+       * it as one transfer, skipping the copy through the I/O buffer.
+       */
+
+      if (priv->nsectbytes <= 0 && priv->nreqbytes == 0 &&
+          priv->u.xfrlen > 0 &&
+          CONFIG_USBMSC_BULKINREQLEN >= lun->sectorsize)
+        {
+          privreq = (FAR struct usbmsc_req_s *)sq_peek(&priv->wrreqlist);
+          if (!privreq)
+            {
+              usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDREADWRRQEMPTY), 0);
+              return -ENOMEM;
+            }
+
+          req   = privreq->req;
+          nread = MIN(priv->u.xfrlen,
+                      CONFIG_USBMSC_BULKINREQLEN / lun->sectorsize);
+          nread = USBMSC_DRVR_READ(lun, req->buf, priv->sector, nread);
+          if (nread <= 0)
+            {
+              usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDREADREADFAIL),
+                       -nread);
+              lun->sd     = SCSI_KCQME_UNRRE1;
+              lun->sdinfo = priv->sector;
+              break;
+            }
+
+          flags = enter_critical_section();
+          sq_remfirst(&priv->wrreqlist);
+          leave_critical_section(flags);
+
+          nbytes          = nread * lun->sectorsize;
+          priv->u.xfrlen -= nread;
+          priv->sector   += nread;
+
+          req->len      = nbytes;
+          req->priv     = privreq;
+          req->callback = usbmsc_wrcomplete;
+          req->flags    = 0;
+
+          ret           = EP_SUBMIT(priv->epbulkin, req);
+          if (ret != OK)
+            {
+              usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDREADSUBMIT),
+                       (uint16_t)-ret);
+              lun->sd     = SCSI_KCQME_UNRRE1;
+              lun->sdinfo = priv->sector;
+              break;
+            }
+
+          priv->residue -= nbytes;
+          continue;
+        }
+
       /* Is the I/O buffer empty? */
 
       if (priv->nsectbytes <= 0)
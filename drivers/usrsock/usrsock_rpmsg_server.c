@@ -456,16 +456,24 @@ static int usrsock_rpmsg_sendto_handler(FAR struct rpmsg_endpoint *ept,
 
       if (uept->remain > 0)
         {
-          /* We've used the last I/O vector, cannot continue. */
+          if (i < CONFIG_NET_USRSOCK_RPMSG_SERVER_NIOVEC - 1)
+            {
+              return 0;
+            }
 
-          if (i == CONFIG_NET_USRSOCK_RPMSG_SERVER_NIOVEC - 1)
+          /* We've used the last I/O vector, cannot continue.  A stream
+           * socket may still send what has been reassembled and report a
+           * short write, the client then sends the rest again.  The
+           * remaining fragments are skipped as they arrive.
+           */
+
+          if ((priv->socks[req->usockid].s_type & SOCK_TYPE_MASK) !=
+              SOCK_STREAM)
             {
               nerr("ERROR: Request %d too large!\n", req->usockid);
               ret = -ENOMEM;
               goto out;
             }
-
-          return 0;
         }
       else if (uept->remain < 0)
         {
@@ -0,0 +1,425 @@
+/****************************************************************************
+ * drivers/video/dmabuf.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/mm/map.h>
+#include <nuttx/video/dmabuf.h>
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int dmabuf_close(FAR struct file *filep);
+static int dmabuf_mmap(FAR struct file *filep,
+                       FAR struct mm_map_entry_s *map);
+static int dmabuf_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                       bool setup);
+static void dmabuf_pool_put(FAR void *arg);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_dmabuf_fops =
+{
+  NULL,          /* open */
+  dmabuf_close,  /* close */
+  NULL,          /* read */
+  NULL,          /* write */
+  NULL,          /* seek */
+  NULL,          /* ioctl */
+  dmabuf_mmap,   /* mmap */
+  NULL,          /* truncate */
+  dmabuf_poll    /* poll */
+};
+
+static struct inode g_dmabuf_inode =
+{
+  NULL,                   /* i_parent */
+  NULL,                   /* i_peer */
+  NULL,                   /* i_child */
+  1,                      /* i_crefs */
+  FSNODEFLAG_TYPE_DRIVER, /* i_flags */
+  {
+    &g_dmabuf_fops        /* u */
+  }
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dmabuf_close
+ ****************************************************************************/
+
+static int dmabuf_close(FAR struct file *filep)
+{
+  dmabuf_release(filep->f_priv);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: dmabuf_munmap
+ ****************************************************************************/
+
+static int dmabuf_munmap(FAR struct task_group_s *group,
+                         FAR struct mm_map_entry_s *entry,
+                         FAR void *start, size_t length)
+{
+  return mm_map_remove(get_group_mm(group), entry);
+}
+
+/****************************************************************************
+ * Name: dmabuf_mmap
+ ****************************************************************************/
+
+static int dmabuf_mmap(FAR struct file *filep,
+                       FAR struct mm_map_entry_s *map)
+{
+  FAR struct dmabuf_s *dmabuf = filep->f_priv;
+
+  if (map->offset < 0 || map->offset >= dmabuf->len ||
+      map->length == 0 || map->offset + map->length > dmabuf->len)
+    {
+      return -EINVAL;
+    }
+
+  map->vaddr  = (FAR char *)dmabuf->addr + map->offset;
+  map->munmap = dmabuf_munmap;
+  return mm_map_add(get_current_mm(), map);
+}
+
+/****************************************************************************
+ * Name: dmabuf_poll
+ *
+ * Description:
+ *   Wait for the dmabuf to be used by no device.
+ *
+ ****************************************************************************/
+
+static int dmabuf_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                       bool setup)
+{
+  FAR struct dmabuf_s *dmabuf = filep->f_priv;
+  FAR struct pollfd **slot;
+  irqstate_t flags;
+  int ret = OK;
+  int i;
+
+  flags = enter_critical_section();
+
+  if (setup)
+    {
+      for (i = 0; i < CONFIG_VIDEO_DMABUF_NPOLLWAITERS; i++)
+        {
+          if (dmabuf->fds[i] == NULL)
+            {
+              break;
+            }
+        }
+
+      if (i >= CONFIG_VIDEO_DMABUF_NPOLLWAITERS)
+        {
+          ret = -EBUSY;
+        }
+      else
+        {
+          dmabuf->fds[i] = fds;
+          fds->priv      = &dmabuf->fds[i];
+
+          if (dmabuf->users == 0)
+            {
+              poll_notify(&fds, 1, POLLIN | POLLOUT);
+            }
+        }
+    }
+  else if (fds->priv != NULL)
+    {
+      slot      = (FAR struct pollfd **)fds->priv;
+      *slot     = NULL;
+      fds->priv = NULL;
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: dmabuf_pool_put
+ *
+ * Description:
+ *   release() of the dmabufs exported from a pool.
+ *
+ ****************************************************************************/
+
+static void dmabuf_pool_put(FAR void *arg)
+{
+  dmabuf_pool_release(arg);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dmabuf_export
+ *
+ * Description:
+ *   Create a dmabuf for the memory at addr and return a new file
+ *   descriptor of it.
+ *
+ ****************************************************************************/
+
+int dmabuf_export(FAR void *addr, size_t len, int oflags,
+                  CODE void (*release)(FAR void *arg), FAR void *arg)
+{
+  FAR struct dmabuf_s *dmabuf;
+  int fd;
+
+  if (addr == NULL || len == 0 || (oflags & ~(O_CLOEXEC | O_ACCMODE)) != 0)
+    {
+      return -EINVAL;
+    }
+
+  dmabuf = kmm_zalloc(sizeof(struct dmabuf_s));
+  if (dmabuf == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  dmabuf->addr    = addr;
+  dmabuf->len     = len;
+  dmabuf->crefs   = 1;
+  dmabuf->release = release;
+  dmabuf->arg     = arg;
+
+  fd = file_allocate(&g_dmabuf_inode, O_RDWR | (oflags & O_CLOEXEC), 0,
+                     dmabuf, 0, true);
+  if (fd < 0)
+    {
+      verr("ERROR: file_allocate() failed: %d\n", fd);
+      kmm_free(dmabuf);
+    }
+
+  return fd;
+}
+
+/****************************************************************************
+ * Name: dmabuf_import
+ *
+ * Description:
+ *   Take a reference of the dmabuf of a file descriptor.
+ *
+ ****************************************************************************/
+
+int dmabuf_import(int fd, FAR struct dmabuf_s **dmabuf)
+{
+  FAR struct file *filep;
+  irqstate_t flags;
+  int ret;
+
+  ret = fs_getfilep(fd, &filep);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (filep->f_inode != &g_dmabuf_inode)
+    {
+      fs_putfilep(filep);
+      return -EINVAL;
+    }
+
+  *dmabuf = filep->f_priv;
+
+  flags = enter_critical_section();
+  (*dmabuf)->crefs++;
+  leave_critical_section(flags);
+
+  fs_putfilep(filep);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: dmabuf_release
+ *
+ * Description:
+ *   Drop a reference of the dmabuf, and destroy it with the last one.
+ *
+ ****************************************************************************/
+
+void dmabuf_release(FAR struct dmabuf_s *dmabuf)
+{
+  irqstate_t flags;
+  int crefs;
+
+  flags = enter_critical_section();
+  crefs = --dmabuf->crefs;
+  leave_critical_section(flags);
+
+  if (crefs == 0)
+    {
+      if (dmabuf->release != NULL)
+        {
+          dmabuf->release(dmabuf->arg);
+        }
+
+      kmm_free(dmabuf);
+    }
+}
+
+/****************************************************************************
+ * Name: dmabuf_begin
+ *
+ * Description:
+ *   Mark the dmabuf in use by one more device.
+ *
+ ****************************************************************************/
+
+void dmabuf_begin(FAR struct dmabuf_s *dmabuf)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  dmabuf->users++;
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: dmabuf_end
+ *
+ * Description:
+ *   Mark the dmabuf in use by one device less, and signal its fence when
+ *   no device uses it anymore.
+ *
+ ****************************************************************************/
+
+void dmabuf_end(FAR struct dmabuf_s *dmabuf)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  DEBUGASSERT(dmabuf->users > 0);
+  if (--dmabuf->users == 0)
+    {
+      poll_notify(dmabuf->fds, CONFIG_VIDEO_DMABUF_NPOLLWAITERS,
+                  POLLIN | POLLOUT);
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: dmabuf_pool_create
+ *
+ * Description:
+ *   Make a pool of the memory block at base, owned by the caller.
+ *
+ ****************************************************************************/
+
+FAR struct dmabuf_pool_s *
+dmabuf_pool_create(FAR void *base,
+                   CODE void (*free)(FAR void *arg, FAR void *base),
+                   FAR void *arg)
+{
+  FAR struct dmabuf_pool_s *pool;
+
+  pool = kmm_zalloc(sizeof(struct dmabuf_pool_s));
+  if (pool != NULL)
+    {
+      pool->base  = base;
+      pool->crefs = 1;
+      pool->free  = free;
+      pool->arg   = arg;
+    }
+
+  return pool;
+}
+
+/****************************************************************************
+ * Name: dmabuf_pool_export
+ *
+ * Description:
+ *   Export the len bytes at offset of the pool.
+ *
+ ****************************************************************************/
+
+int dmabuf_pool_export(FAR struct dmabuf_pool_s *pool, size_t offset,
+                       size_t len, int oflags)
+{
+  irqstate_t flags;
+  int fd;
+
+  flags = enter_critical_section();
+  pool->crefs++;
+  leave_critical_section(flags);
+
+  fd = dmabuf_export((FAR char *)pool->base + offset, len, oflags,
+                     dmabuf_pool_put, pool);
+  if (fd < 0)
+    {
+      dmabuf_pool_release(pool);
+    }
+
+  return fd;
+}
+
+/****************************************************************************
+ * Name: dmabuf_pool_release
+ *
+ * Description:
+ *   Drop a reference of the pool, and free the memory block with the last
+ *   one.
+ *
+ ****************************************************************************/
+
+void dmabuf_pool_release(FAR struct dmabuf_pool_s *pool)
+{
+  irqstate_t flags;
+  int crefs;
+
+  flags = enter_critical_section();
+  crefs = --pool->crefs;
+  leave_critical_section(flags);
+
+  if (crefs == 0)
+    {
+      pool->free(pool->arg, pool->base);
+      kmm_free(pool);
+    }
+}
@@ -26,6 +26,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <sys/types.h>
 #include <stdbool.h>
 #include <stdio.h>
@@ -33,11 +34,15 @@
 #include <assert.h>
 #include <debug.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <poll.h>
+#include <strings.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/dma/dma.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
+#include <nuttx/video/dmabuf.h>
 #include <nuttx/video/fb.h>
 #include <nuttx/clock.h>
 #include <nuttx/wdog.h>
@@ -66,6 +71,11 @@ struct fb_priv_s
 #ifdef CONFIG_FB_SYNC
   sem_t wait;
 #endif
+
+#ifdef CONFIG_FB_SWAPCHAIN
+  uint32_t swapbufs;              /* Buffers acquired through this open */
+  bool swapchain;                 /* POLLOUT tells of a free buffer */
+#endif
 };
 
 struct fb_paninfo_s
@@ -75,6 +85,18 @@ struct fb_paninfo_s
   struct wdog_s wdog;             /* VSync offset timer */
 
   FAR struct fb_chardev_s *dev;
+
+#ifdef CONFIG_FB_SWAPCHAIN
+  /* Swap chain state, the buffers being bits of the masks */
+
+  uint32_t yres;                  /* Rows of one buffer */
+  uint8_t count;                  /* Number of buffers */
+  uint8_t front;                  /* Buffer being displayed */
+  uint32_t acquired;              /* Buffers held by the applications */
+  uint32_t queued;                /* Buffers in the pan queue */
+  uint32_t submitted;             /* Frames added to the pan queue */
+  uint32_t retired;               /* Frames that reached the display */
+#endif
 };
 
 /* This structure defines one framebuffer device.  Note that which is
@@ -99,6 +121,7 @@ struct fb_panelinfo_s
   size_t fblen;                   /* Size of the framebuffer */
   uint8_t fbcount;                /* Count of frame buffer */
   uint8_t bpp;                    /* Bits per pixel */
+  uint32_t yres;                  /* Rows of one frame buffer */
 };
 
 /****************************************************************************
@@ -136,6 +159,23 @@ static int     fb_sem_wait(FAR struct fb_chardev_s *fb,
                            int overlay);
 static void    fb_sem_post(FAR struct fb_chardev_s *fb, int overlay);
 #endif
+#ifdef CONFIG_FB_SWAPCHAIN
+static uint32_t fb_swapbuf_free(FAR struct fb_paninfo_s *paninfo);
+static void    fb_swapbuf_retire(FAR struct fb_chardev_s *fb, int overlay);
+static int     fb_swapbuf_index(FAR struct fb_paninfo_s *paninfo,
+                                FAR const union fb_paninfo_u *info,
+                                int overlay);
+static int     fb_swapbuf_acquire(FAR struct fb_chardev_s *fb,
+                                  FAR struct fb_priv_s *priv,
+                                  FAR struct fb_swapbuf_s *buf);
+static int     fb_swapbuf_queue(FAR struct fb_chardev_s *fb,
+                                FAR struct fb_priv_s *priv,
+                                FAR struct fb_swapbuf_s *buf);
+static int     fb_swapbuf_release(FAR struct fb_chardev_s *fb,
+                                  FAR struct fb_priv_s *priv, int index);
+static int     fb_swapbuf_wait(FAR struct fb_chardev_s *fb,
+                               FAR struct file *filep);
+#endif
 
 #ifdef CONFIG_BUILD_KERNEL
 static int     fb_munmap(FAR struct task_group_s *group,
@@ -212,6 +252,20 @@ static int fb_add_paninfo(FAR struct fb_chardev_s *fb,
     {
       gwarn("WARNING: circbuf_write(panbuf) failed\n");
     }
+#ifdef CONFIG_FB_SWAPCHAIN
+  else
+    {
+      FAR struct fb_paninfo_s *paninfo = &fb->paninfo[overlay + 1];
+      int index = fb_swapbuf_index(paninfo, info, overlay);
+
+      if (index >= 0)
+        {
+          paninfo->queued |= 1u << index;
+        }
+
+      paninfo->submitted++;
+    }
+#endif
 
   /* Re-enable interrupts */
 
@@ -246,6 +300,13 @@ static int fb_clear_paninfo(FAR struct fb_chardev_s *fb,
 
   circbuf_reset(panbuf);
 
+#ifdef CONFIG_FB_SWAPCHAIN
+  /* The dropped frames never reach the display, complete their fences */
+
+  fb->paninfo[overlay + 1].queued  = 0;
+  fb->paninfo[overlay + 1].retired = fb->paninfo[overlay + 1].submitted;
+#endif
+
   /* Re-enable interrupts */
 
   leave_critical_section(flags);
@@ -353,6 +414,12 @@ static int fb_close(FAR struct file *filep)
 
   DEBUGASSERT(curr);
 
+#ifdef CONFIG_FB_SWAPCHAIN
+  /* Give back the buffers still acquired through this open */
+
+  fb->paninfo[priv->overlay + 1].acquired &= ~priv->swapbufs;
+#endif
+
   /* Remove the structure from the device */
 
   if (prev)
@@ -426,7 +493,7 @@ static ssize_t fb_read(FAR struct file *filep, FAR char *buffer, size_t len)
 
   /* And transfer the data from the frame buffer */
 
-  memcpy(buffer, panelinfo.fbmem + start, size);
+  dma_memcpy(buffer, panelinfo.fbmem + start, size);
   filep->f_pos += size;
   return size;
 }
@@ -484,7 +551,7 @@ static ssize_t fb_write(FAR struct file *filep, FAR const char *buffer,
 
   /* And transfer the data into the frame buffer */
 
-  memcpy(panelinfo.fbmem + start, buffer, size);
+  dma_memcpy(panelinfo.fbmem + start, buffer, size);
   filep->f_pos += size;
   return size;
 }
@@ -740,6 +807,14 @@ static int fb_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
               break;
             }
 
+#ifdef CONFIG_FB_SWAPCHAIN
+          if (priv->swapbufs != 0)
+            {
+              ret = -EBUSY;
+              break;
+            }
+#endif
+
           if (arg != FB_NO_OVERLAY)
             {
               memset(&oinfo, 0, sizeof(oinfo));
@@ -1003,6 +1078,104 @@ static int fb_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
+#ifdef CONFIG_VIDEO_DMABUF
+      case FBIO_EXPBUF:
+        {
+          FAR struct fb_expbuf_s *expbuf =
+            (FAR struct fb_expbuf_s *)((uintptr_t)arg);
+          FAR struct fb_priv_s *priv = filep->f_priv;
+          struct fb_panelinfo_s panelinfo;
+          size_t len;
+
+          DEBUGASSERT(expbuf != NULL);
+          ret = fb_get_panelinfo(fb, &panelinfo, priv->overlay);
+          if (ret < 0)
+            {
+              break;
+            }
+
+          if (expbuf->index >= panelinfo.fbcount)
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+          /* The framebuffer memory outlives the file descriptors */
+
+          len = panelinfo.fblen / panelinfo.fbcount;
+          ret = dmabuf_export((FAR uint8_t *)panelinfo.fbmem +
+                              len * expbuf->index, len, expbuf->flags,
+                              NULL, NULL);
+          if (ret >= 0)
+            {
+              expbuf->fd = ret;
+              ret = OK;
+            }
+        }
+        break;
+#endif
+
+#ifdef CONFIG_FB_SWAPCHAIN
+      case FBIOGET_SWAPBUF:
+        {
+          FAR struct fb_swapbuf_s *buf =
+            (FAR struct fb_swapbuf_s *)((uintptr_t)arg);
+
+          DEBUGASSERT(buf != NULL);
+          while ((ret = fb_swapbuf_acquire(fb, filep->f_priv,
+                                           buf)) == -EAGAIN)
+            {
+              ret = fb_swapbuf_wait(fb, filep);
+              if (ret < 0)
+                {
+                  break;
+                }
+            }
+        }
+        break;
+
+      case FBIOPUT_SWAPBUF:
+        {
+          FAR struct fb_swapbuf_s *buf =
+            (FAR struct fb_swapbuf_s *)((uintptr_t)arg);
+
+          DEBUGASSERT(buf != NULL);
+          ret = fb_swapbuf_queue(fb, filep->f_priv, buf);
+        }
+        break;
+
+      case FBIO_RELEASEBUF:
+        {
+          ret = fb_swapbuf_release(fb, filep->f_priv, (int)arg);
+        }
+        break;
+
+      case FBIO_WAITFENCE:
+        {
+          FAR struct fb_priv_s *priv = filep->f_priv;
+          FAR struct fb_paninfo_s *paninfo =
+            &fb->paninfo[priv->overlay + 1];
+
+          /* The fence is reached once retired has gone past it */
+
+          if ((int32_t)(paninfo->submitted - (uint32_t)arg) < 0)
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+          while ((int32_t)(paninfo->retired - (uint32_t)arg) < 0)
+            {
+              ret = fb_swapbuf_wait(fb, filep);
+              if (ret < 0)
+                {
+                  break;
+                }
+            }
+        }
+        break;
+#endif
+
       case FBIOGET_VSCREENINFO:
         {
           struct fb_videoinfo_s vinfo;
@@ -1269,6 +1442,16 @@ static int fb_poll(FAR struct file *filep, struct pollfd *fds, bool setup)
       fds->priv = pollfds;
 
       panbuf = fb_get_panbuf(fb, priv->overlay);
+#ifdef CONFIG_FB_SWAPCHAIN
+      if (priv->swapchain)
+        {
+          if (fb_swapbuf_free(&fb->paninfo[priv->overlay + 1]) != 0)
+            {
+              poll_notify(&fds, 1, POLLOUT);
+            }
+        }
+      else
+#endif
       if (!circbuf_is_full(panbuf))
         {
           poll_notify(&fds, 1, POLLOUT);
@@ -1319,6 +1502,7 @@ static int fb_get_panelinfo(FAR struct fb_chardev_s *fb,
       panelinfo->fbcount = oinfo.yres_virtual == 0 ?
                            1 : (oinfo.yres_virtual / oinfo.yres);
       panelinfo->bpp     = oinfo.bpp;
+      panelinfo->yres    = oinfo.yres;
       return OK;
     }
 #endif
@@ -1341,6 +1525,7 @@ static int fb_get_panelinfo(FAR struct fb_chardev_s *fb,
   panelinfo->fbcount = pinfo.yres_virtual == 0 ?
                        1 : (pinfo.yres_virtual / vinfo.yres);
   panelinfo->bpp     = pinfo.bpp;
+  panelinfo->yres    = vinfo.yres;
 
   return OK;
 }
@@ -1501,6 +1686,281 @@ static void fb_pollnotify(FAR struct fb_chardev_s *fb, int overlay)
     }
 }
 
+#ifdef CONFIG_FB_SWAPCHAIN
+/****************************************************************************
+ * Name: fb_swapbuf_free
+ *
+ * Description:
+ *   Return the mask of the buffers that are neither displayed, queued nor
+ *   acquired.  Called in a critical section.
+ *
+ ****************************************************************************/
+
+static uint32_t fb_swapbuf_free(FAR struct fb_paninfo_s *paninfo)
+{
+  uint32_t all;
+
+  if (paninfo->count < 2)
+    {
+      return 0;
+    }
+
+  all = paninfo->count >= 32 ? UINT32_MAX : (1u << paninfo->count) - 1;
+  return all & ~(paninfo->acquired | paninfo->queued |
+                 (1u << paninfo->front));
+}
+
+/****************************************************************************
+ * Name: fb_swapbuf_index
+ *
+ * Description:
+ *   Return the buffer of a pan info entry, or -1 if its offset isn't the
+ *   start of a buffer.
+ *
+ ****************************************************************************/
+
+static int fb_swapbuf_index(FAR struct fb_paninfo_s *paninfo,
+                            FAR const union fb_paninfo_u *info,
+                            int overlay)
+{
+  uint32_t yoffset;
+
+#ifdef CONFIG_FB_OVERLAY
+  if (overlay != FB_NO_OVERLAY)
+    {
+      yoffset = info->overlayinfo.yoffset;
+    }
+  else
+#endif
+    {
+      yoffset = info->planeinfo.yoffset;
+    }
+
+  if (paninfo->yres == 0 || yoffset % paninfo->yres != 0 ||
+      yoffset / paninfo->yres >= paninfo->count)
+    {
+      return -1;
+    }
+
+  return yoffset / paninfo->yres;
+}
+
+/****************************************************************************
+ * Name: fb_swapbuf_retire
+ *
+ * Description:
+ *   The frame at the head of the pan queue reaches the display: its buffer
+ *   replaces the front buffer, that is free again.  Called in a critical
+ *   section.
+ *
+ ****************************************************************************/
+
+static void fb_swapbuf_retire(FAR struct fb_chardev_s *fb, int overlay)
+{
+  FAR struct fb_paninfo_s *paninfo = &fb->paninfo[overlay + 1];
+  union fb_paninfo_u info;
+  int index;
+
+  if (circbuf_peek(&paninfo->buf, &info, sizeof(info)) == sizeof(info))
+    {
+      index = fb_swapbuf_index(paninfo, &info, overlay);
+      if (index >= 0)
+        {
+          paninfo->queued &= ~(1u << index);
+          paninfo->front   = index;
+        }
+
+      paninfo->retired++;
+    }
+}
+
+/****************************************************************************
+ * Name: fb_swapbuf_acquire
+ *
+ * Description:
+ *   Acquire a free buffer of the selected plane or overlay, -EAGAIN if
+ *   there is none.
+ *
+ ****************************************************************************/
+
+static int fb_swapbuf_acquire(FAR struct fb_chardev_s *fb,
+                              FAR struct fb_priv_s *priv,
+                              FAR struct fb_swapbuf_s *buf)
+{
+  FAR struct fb_paninfo_s *paninfo = &fb->paninfo[priv->overlay + 1];
+  irqstate_t flags;
+  uint32_t mask;
+  int index;
+
+  if (paninfo->count < 2)
+    {
+      return -EINVAL;
+    }
+
+  flags = enter_critical_section();
+
+  priv->swapchain = true;
+
+  mask = fb_swapbuf_free(paninfo);
+  if (mask == 0)
+    {
+      leave_critical_section(flags);
+      return -EAGAIN;
+    }
+
+  index = ffs(mask) - 1;
+  paninfo->acquired |= 1u << index;
+  priv->swapbufs    |= 1u << index;
+
+  leave_critical_section(flags);
+
+  buf->index   = index;
+  buf->yoffset = index * paninfo->yres;
+  buf->fence   = 0;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fb_swapbuf_queue
+ *
+ * Description:
+ *   Queue an acquired buffer for display at the next vertical sync, and
+ *   return the fence of the frame in buf.
+ *
+ ****************************************************************************/
+
+static int fb_swapbuf_queue(FAR struct fb_chardev_s *fb,
+                            FAR struct fb_priv_s *priv,
+                            FAR struct fb_swapbuf_s *buf)
+{
+  FAR struct fb_paninfo_s *paninfo = &fb->paninfo[priv->overlay + 1];
+  union fb_paninfo_u info;
+  irqstate_t flags;
+  uint32_t bit;
+  int ret;
+
+  if (buf->index >= paninfo->count ||
+      (priv->swapbufs & (1u << buf->index)) == 0)
+    {
+      return -EINVAL;
+    }
+
+  bit = 1u << buf->index;
+  memset(&info, 0, sizeof(info));
+
+#ifdef CONFIG_FB_OVERLAY
+  if (priv->overlay != FB_NO_OVERLAY)
+    {
+      ret = fb->vtable->getoverlayinfo(fb->vtable, priv->overlay,
+                                       &info.overlayinfo);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      info.overlayinfo.xoffset = 0;
+      info.overlayinfo.yoffset = buf->index * paninfo->yres;
+      if (fb->vtable->panoverlay != NULL)
+        {
+          fb->vtable->panoverlay(fb->vtable, &info.overlayinfo);
+        }
+    }
+  else
+#endif
+    {
+      ret = fb_get_planeinfo(fb, &info.planeinfo, 0);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      info.planeinfo.xoffset = 0;
+      info.planeinfo.yoffset = buf->index * paninfo->yres;
+      if (fb->vtable->pandisplay != NULL)
+        {
+          fb->vtable->pandisplay(fb->vtable, &info.planeinfo);
+        }
+    }
+
+  /* The buffer passes from the application to the pan queue */
+
+  flags = enter_critical_section();
+
+  ret = fb_add_paninfo(fb, &info, priv->overlay);
+  if (ret >= 0)
+    {
+      paninfo->acquired &= ~bit;
+      priv->swapbufs    &= ~bit;
+      buf->fence         = paninfo->submitted;
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: fb_swapbuf_release
+ *
+ * Description:
+ *   Give back an acquired buffer without displaying it.
+ *
+ ****************************************************************************/
+
+static int fb_swapbuf_release(FAR struct fb_chardev_s *fb,
+                              FAR struct fb_priv_s *priv, int index)
+{
+  FAR struct fb_paninfo_s *paninfo = &fb->paninfo[priv->overlay + 1];
+  irqstate_t flags;
+  uint32_t bit;
+
+  if (index < 0 || index >= paninfo->count ||
+      (priv->swapbufs & (1u << index)) == 0)
+    {
+      return -EINVAL;
+    }
+
+  bit   = 1u << index;
+  flags = enter_critical_section();
+
+  paninfo->acquired &= ~bit;
+  priv->swapbufs    &= ~bit;
+
+  leave_critical_section(flags);
+
+  fb_pollnotify(fb, priv->overlay);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fb_swapbuf_wait
+ *
+ * Description:
+ *   Wait for the next vertical sync before checking the swap chain again.
+ *   -EAGAIN is returned to the non-blocking opens, and to all of them when
+ *   the hardware doesn't signal vertical sync; they poll() for POLLOUT or
+ *   POLLPRI instead.
+ *
+ ****************************************************************************/
+
+static int fb_swapbuf_wait(FAR struct fb_chardev_s *fb,
+                           FAR struct file *filep)
+{
+  if ((filep->f_oflags & O_NONBLOCK) != 0)
+    {
+      return -EAGAIN;
+    }
+
+#ifdef CONFIG_FB_SYNC
+  if (fb->vtable->waitforvsync != NULL)
+    {
+      return fb->vtable->waitforvsync(fb->vtable);
+    }
+#endif
+
+  return -EAGAIN;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -1625,6 +2085,10 @@ int fb_remove_paninfo(FAR struct fb_vtable_s *vtable, int overlay)
 
   full = (circbuf_space(panbuf) == 0);
 
+#ifdef CONFIG_FB_SWAPCHAIN
+  fb_swapbuf_retire(fb, overlay);
+#endif
+
   /* Attempt to take a frame from the pan info. */
 
   ret = circbuf_skip(panbuf, sizeof(union fb_paninfo_u));
@@ -1782,6 +2246,10 @@ int fb_register_device(int display, int plane,
       DEBUGASSERT(ret == 0);
 
       fb->paninfo[i].dev = fb;
+#ifdef CONFIG_FB_SWAPCHAIN
+      fb->paninfo[i].yres  = panelinfo.yres;
+      fb->paninfo[i].count = MIN(panelinfo.fbcount, 32);
+#endif
 
       /* Clear the framebuffer memory */
 
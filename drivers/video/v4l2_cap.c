@@ -107,6 +107,9 @@ struct capture_type_inf_s
   struct v4l2_fract      frame_interval;
   video_framebuff_t      bufinf;
   FAR uint8_t            *bufheap;   /* for V4L2_MEMORY_MMAP buffers */
+#ifdef CONFIG_VIDEO_DMABUF
+  FAR struct dmabuf_pool_s *pool;    /* bufheap once a buffer is exported */
+#endif
   FAR struct pollfd      *fds;
   uint32_t               seqnum;
 };
@@ -215,6 +218,8 @@ static int validate_frame_setting(FAR capture_mng_t *cmng,
                                   FAR struct v4l2_rect *clip,
                                   FAR struct v4l2_fract *interval);
 static size_t get_bufsize(FAR video_format_t *vf);
+static void release_bufheap(FAR capture_mng_t *cmng,
+                            FAR capture_type_inf_t *type_inf);
 
 /* ioctl function for each cmds of ioctl */
 
@@ -227,6 +232,10 @@ static int capture_reqbufs(FAR struct file *filep,
                            FAR struct v4l2_requestbuffers *reqbufs);
 static int capture_querybuf(FAR struct file *filep,
                             FAR struct v4l2_buffer *buf);
+#ifdef CONFIG_VIDEO_DMABUF
+static int capture_expbuf(FAR struct file *filep,
+                          FAR struct v4l2_exportbuffer *expbuf);
+#endif
 static int capture_qbuf(FAR struct file *filep,
                         FAR struct v4l2_buffer *buf);
 static int capture_dqbuf(FAR struct file *filep,
@@ -337,7 +346,15 @@ static const struct v4l2_ops_s g_capture_vops =
   capture_s_ext_ctrls_scene,          /* s_ext_ctrls_scene */
   capture_enum_fmt,                   /* enum_fmt */
   capture_enum_frminterval,           /* enum_frminterval */
-  capture_enum_frmsize                /* enum_frmsize */
+  capture_enum_frmsize,               /* enum_frmsize */
+  NULL,                               /* cropcap */
+  NULL,                               /* dqevent */
+  NULL,                               /* subscribe_event */
+  NULL,                               /* decoder_cmd */
+  NULL,                               /* encoder_cmd */
+#ifdef CONFIG_VIDEO_DMABUF
+  capture_expbuf,                     /* expbuf */
+#endif
 };
 
 static const struct file_operations g_capture_fops =
@@ -1181,19 +1198,7 @@ static void cleanup_streamresources(FAR capture_type_inf_t *type_inf,
   video_framebuff_uninit(&type_inf->bufinf);
   nxsem_destroy(&type_inf->wait_capture.dqbuf_wait_flg);
   nxmutex_destroy(&type_inf->lock_state);
-  if (type_inf->bufheap != NULL)
-    {
-      if (cmng->imgdata->ops->free)
-        {
-          cmng->imgdata->ops->free(cmng->imgdata, type_inf->bufheap);
-        }
-      else
-        {
-          kumm_free(type_inf->bufheap);
-        }
-
-      type_inf->bufheap = NULL;
-    }
+  release_bufheap(cmng, type_inf);
 }
 
 static void cleanup_scene_parameter(FAR capture_scene_params_t **vsp)
@@ -1313,6 +1318,52 @@ static size_t get_bufsize(FAR video_format_t *vf)
     }
 }
 
+#ifdef CONFIG_VIDEO_DMABUF
+static void free_pooledheap(FAR void *arg, FAR void *base)
+{
+  FAR struct imgdata_s *imgdata = arg;
+
+  if (imgdata->ops->free)
+    {
+      imgdata->ops->free(imgdata, base);
+    }
+  else
+    {
+      kumm_free(base);
+    }
+}
+#endif
+
+static void release_bufheap(FAR capture_mng_t *cmng,
+                            FAR capture_type_inf_t *type_inf)
+{
+  if (type_inf->bufheap == NULL)
+    {
+      return;
+    }
+
+#ifdef CONFIG_VIDEO_DMABUF
+  /* The exported buffers keep the heap until they are all closed */
+
+  if (type_inf->pool != NULL)
+    {
+      dmabuf_pool_release(type_inf->pool);
+      type_inf->pool = NULL;
+    }
+  else
+#endif
+  if (cmng->imgdata->ops->free)
+    {
+      cmng->imgdata->ops->free(cmng->imgdata, type_inf->bufheap);
+    }
+  else
+    {
+      kumm_free(type_inf->bufheap);
+    }
+
+  type_inf->bufheap = NULL;
+}
+
 static size_t get_heapsize(FAR capture_type_inf_t *type_inf)
 {
   return type_inf->bufinf.container_size *
@@ -2170,17 +2221,7 @@ static int capture_reqbufs(FAR struct file *filep,
                                               reqbufs->count);
       if (ret == OK && reqbufs->memory == V4L2_MEMORY_MMAP)
         {
-          if (type_inf->bufheap != NULL)
-            {
-              if (imgdata->ops->free)
-                {
-                    imgdata->ops->free(imgdata, type_inf->bufheap);
-                }
-              else
-                {
-                  kumm_free(type_inf->bufheap);
-                }
-            }
+          release_bufheap(cmng, type_inf);
 
           if (imgdata->ops->alloc)
             {
@@ -2234,6 +2275,58 @@ static int capture_querybuf(FAR struct file *filep,
   return OK;
 }
 
+#ifdef CONFIG_VIDEO_DMABUF
+static int capture_expbuf(FAR struct file *filep,
+                          FAR struct v4l2_exportbuffer *expbuf)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR capture_mng_t *cmng = inode->i_private;
+  FAR capture_type_inf_t *type_inf;
+  irqstate_t flags;
+  size_t bufsize;
+  int fd;
+
+  if (cmng == NULL || expbuf == NULL || expbuf->plane != 0)
+    {
+      return -EINVAL;
+    }
+
+  type_inf = get_capture_type_inf(cmng, expbuf->type);
+  if (type_inf == NULL || type_inf->bufheap == NULL ||
+      expbuf->index >= type_inf->bufinf.container_size)
+    {
+      return -EINVAL;
+    }
+
+  /* The heap of the MMAP buffers passes to a pool at the first export */
+
+  flags = enter_critical_section();
+  if (type_inf->pool == NULL)
+    {
+      type_inf->pool = dmabuf_pool_create(type_inf->bufheap,
+                                          free_pooledheap, cmng->imgdata);
+    }
+
+  leave_critical_section(flags);
+
+  if (type_inf->pool == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  bufsize = get_bufsize(&type_inf->fmt[CAPTURE_FMT_MAIN]);
+  fd = dmabuf_pool_export(type_inf->pool, bufsize * expbuf->index,
+                          bufsize, expbuf->flags);
+  if (fd < 0)
+    {
+      return fd;
+    }
+
+  expbuf->fd = fd;
+  return OK;
+}
+#endif
+
 static int capture_qbuf(FAR struct file *filep,
                         FAR struct v4l2_buffer *buf)
 {
@@ -2275,6 +2368,18 @@ static int capture_qbuf(FAR struct file *filep,
       container->buf.m.userptr = (unsigned long)(type_inf->bufheap +
                                  container->buf.length * buf->index);
     }
+#ifdef CONFIG_VIDEO_DMABUF
+  else if (buf->memory == V4L2_MEMORY_DMABUF)
+    {
+      int ret = video_framebuff_import_dmabuf(container,
+                  get_bufsize(&type_inf->fmt[CAPTURE_FMT_MAIN]));
+      if (ret < 0)
+        {
+          video_framebuff_free_container(&type_inf->bufinf, container);
+          return ret;
+        }
+    }
+#endif
 
   video_framebuff_queue_container(&type_inf->bufinf, container);
 
@@ -2390,6 +2495,13 @@ static int capture_dqbuf(FAR struct file *filep,
     }
 
   memcpy(buf, &container->buf, sizeof(struct v4l2_buffer));
+#ifdef CONFIG_VIDEO_DMABUF
+  if (container->dmabuf != NULL)
+    {
+      buf->m.fd = container->fd;
+    }
+#endif
+
   video_framebuff_free_container(&type_inf->bufinf, container);
 
   return OK;
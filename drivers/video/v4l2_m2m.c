@@ -60,6 +60,9 @@ struct codec_type_inf_s
 {
   video_framebuff_t bufinf;
   FAR uint8_t       *bufheap;   /* for V4L2_MEMORY_MMAP buffers */
+#ifdef CONFIG_VIDEO_DMABUF
+  FAR struct dmabuf_pool_s *pool; /* bufheap once a buffer is exported */
+#endif
   bool              buflast;
 };
 
@@ -103,6 +106,7 @@ static int codec_poll(FAR struct file *filep,
 
 static FAR codec_type_inf_t *
 codec_get_type_inf(FAR struct codec_file_s *cfile, int type);
+static void codec_release_bufheap(FAR codec_type_inf_t *type_inf);
 
 /* ioctl function for each cmds of ioctl */
 
@@ -114,6 +118,10 @@ static int codec_querybuf(FAR struct file *filep,
                           FAR struct v4l2_buffer *buf);
 static int codec_qbuf(FAR struct file *filep,
                       FAR struct v4l2_buffer *buf);
+#ifdef CONFIG_VIDEO_DMABUF
+static int codec_expbuf(FAR struct file *filep,
+                        FAR struct v4l2_exportbuffer *expbuf);
+#endif
 static int codec_dqbuf(FAR struct file *filep,
                        FAR struct v4l2_buffer *buf);
 static int codec_g_fmt(FAR struct file *filep,
@@ -195,7 +203,10 @@ static const struct v4l2_ops_s g_codec_vops =
   codec_dqevent,         /* dqevent */
   codec_subscribe_event, /* subscribe_event */
   codec_decoder_cmd,     /* decoder_cmd */
-  codec_encoder_cmd      /* encoder_cmd */
+  codec_encoder_cmd,     /* encoder_cmd */
+#ifdef CONFIG_VIDEO_DMABUF
+  codec_expbuf,          /* expbuf */
+#endif
 };
 
 static const struct file_operations g_codec_fops =
@@ -228,6 +239,32 @@ codec_get_type_inf(FAR struct codec_file_s *cfile, int type)
     }
 }
 
+#ifdef CONFIG_VIDEO_DMABUF
+static void codec_free_pooledheap(FAR void *arg, FAR void *base)
+{
+  kumm_free(base);
+}
+#endif
+
+static void codec_release_bufheap(FAR codec_type_inf_t *type_inf)
+{
+#ifdef CONFIG_VIDEO_DMABUF
+  /* The exported buffers keep the heap until they are all closed */
+
+  if (type_inf->pool != NULL)
+    {
+      dmabuf_pool_release(type_inf->pool);
+      type_inf->pool = NULL;
+    }
+  else
+#endif
+    {
+      kumm_free(type_inf->bufheap);
+    }
+
+  type_inf->bufheap = NULL;
+}
+
 static int codec_querycap(FAR struct file *filep,
                           FAR struct v4l2_capability *cap)
 {
@@ -304,7 +341,7 @@ static int codec_reqbufs(FAR struct file *filep,
                                           reqbufs->count);
   if (ret == 0 && reqbufs->memory == V4L2_MEMORY_MMAP)
     {
-      kumm_free(type_inf->bufheap);
+      codec_release_bufheap(type_inf);
       type_inf->bufheap = kumm_memalign(32, reqbufs->count * buf_size);
       if (type_inf->bufheap == NULL)
         {
@@ -359,6 +396,72 @@ static int codec_querybuf(FAR struct file *filep,
   return OK;
 }
 
+#ifdef CONFIG_VIDEO_DMABUF
+static int codec_expbuf(FAR struct file *filep,
+                        FAR struct v4l2_exportbuffer *expbuf)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR codec_mng_t *cmng = inode->i_private;
+  FAR codec_file_t *cfile = filep->f_priv;
+  FAR codec_type_inf_t *type_inf;
+  irqstate_t flags;
+  size_t buf_size;
+  int fd;
+
+  if (expbuf == NULL || expbuf->plane != 0)
+    {
+      return -EINVAL;
+    }
+
+  type_inf = codec_get_type_inf(cfile, expbuf->type);
+  if (type_inf == NULL || type_inf->bufheap == NULL ||
+      expbuf->index >= type_inf->bufinf.container_size)
+    {
+      return -EINVAL;
+    }
+
+  if (V4L2_TYPE_IS_OUTPUT(expbuf->type))
+    {
+      buf_size = CODEC_OUTPUT_G_BUFSIZE(cmng->codec, cfile->priv);
+    }
+  else
+    {
+      buf_size = CODEC_CAPTURE_G_BUFSIZE(cmng->codec, cfile->priv);
+    }
+
+  if (buf_size == 0)
+    {
+      return -EINVAL;
+    }
+
+  /* The heap of the MMAP buffers passes to a pool at the first export */
+
+  flags = enter_critical_section();
+  if (type_inf->pool == NULL)
+    {
+      type_inf->pool = dmabuf_pool_create(type_inf->bufheap,
+                                          codec_free_pooledheap, NULL);
+    }
+
+  leave_critical_section(flags);
+
+  if (type_inf->pool == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  fd = dmabuf_pool_export(type_inf->pool, buf_size * expbuf->index,
+                          buf_size, expbuf->flags);
+  if (fd < 0)
+    {
+      return fd;
+    }
+
+  expbuf->fd = fd;
+  return OK;
+}
+#endif
+
 static int codec_qbuf(FAR struct file *filep,
                       FAR struct v4l2_buffer *buf)
 {
@@ -410,6 +513,28 @@ static int codec_qbuf(FAR struct file *filep,
       container->buf.m.userptr = (unsigned long)(type_inf->bufheap +
                                  container->buf.length * buf->index);
     }
+#ifdef CONFIG_VIDEO_DMABUF
+  else if (buf->memory == V4L2_MEMORY_DMABUF)
+    {
+      int ret;
+
+      if (V4L2_TYPE_IS_OUTPUT(buf->type))
+        {
+          buf_size = CODEC_OUTPUT_G_BUFSIZE(cmng->codec, cfile->priv);
+        }
+      else
+        {
+          buf_size = CODEC_CAPTURE_G_BUFSIZE(cmng->codec, cfile->priv);
+        }
+
+      ret = video_framebuff_import_dmabuf(container, buf_size);
+      if (ret < 0)
+        {
+          video_framebuff_free_container(&type_inf->bufinf, container);
+          return ret;
+        }
+    }
+#endif
 
   video_framebuff_queue_container(&type_inf->bufinf, container);
 
@@ -458,6 +583,13 @@ static int codec_dqbuf(FAR struct file *filep,
     }
 
   memcpy(buf, &container->buf, sizeof(struct v4l2_buffer));
+#ifdef CONFIG_VIDEO_DMABUF
+  if (container->dmabuf != NULL)
+    {
+      buf->m.fd = container->fd;
+    }
+#endif
+
   video_framebuff_free_container(&type_inf->bufinf, container);
 
   vinfo("%s dequeue done\n", V4L2_TYPE_IS_OUTPUT(buf->type) ?
@@ -856,8 +988,8 @@ static int codec_close(FAR struct file *filep)
 
   video_framebuff_uninit(&cfile->capture_inf.bufinf);
   video_framebuff_uninit(&cfile->output_inf.bufinf);
-  kumm_free(cfile->capture_inf.bufheap);
-  kumm_free(cfile->output_inf.bufheap);
+  codec_release_bufheap(&cfile->capture_inf);
+  codec_release_bufheap(&cfile->output_inf);
   kmm_free(cfile);
 
   return OK;
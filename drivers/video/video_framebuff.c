@@ -52,6 +52,18 @@ static void init_buf_chain(video_framebuff_t *fbuf)
     }
 }
 
+#ifdef CONFIG_VIDEO_DMABUF
+static void release_dmabuf(vbuf_container_t *cnt)
+{
+  if (cnt->dmabuf != NULL)
+    {
+      dmabuf_end(cnt->dmabuf);
+      dmabuf_release(cnt->dmabuf);
+      cnt->dmabuf = NULL;
+    }
+}
+#endif
+
 static inline bool is_last_one(video_framebuff_t *fbuf)
 {
   return fbuf->vbuf_top == fbuf->vbuf_tail;
@@ -101,6 +113,9 @@ void video_framebuff_uninit(video_framebuff_t *fbuf)
 int video_framebuff_realloc_container(video_framebuff_t *fbuf, int sz)
 {
   vbuf_container_t *vbuf;
+#ifdef CONFIG_VIDEO_DMABUF
+  int i;
+#endif
 
   nxmutex_lock(&fbuf->lock_empty);
   if (fbuf->container_size == sz)
@@ -109,6 +124,15 @@ int video_framebuff_realloc_container(video_framebuff_t *fbuf, int sz)
       return OK;
     }
 
+#ifdef CONFIG_VIDEO_DMABUF
+  /* The queued buffers are dropped with the containers */
+
+  for (i = 0; i < fbuf->container_size; i++)
+    {
+      release_dmabuf(&fbuf->vbuf_alloced[i]);
+    }
+#endif
+
   if (sz > 0)
     {
       vbuf = kmm_realloc(fbuf->vbuf_alloced, sizeof(vbuf_container_t) * sz);
@@ -161,6 +185,10 @@ vbuf_container_t *video_framebuff_get_container(video_framebuff_t *fbuf)
 void video_framebuff_free_container(video_framebuff_t *fbuf,
                                     vbuf_container_t  *cnt)
 {
+#ifdef CONFIG_VIDEO_DMABUF
+  release_dmabuf(cnt);
+#endif
+
   nxmutex_lock(&fbuf->lock_empty);
   cnt->next = fbuf->vbuf_empty;
   fbuf->vbuf_empty = cnt;
@@ -287,3 +315,33 @@ vbuf_container_t *video_framebuff_pop_curr_container(video_framebuff_t *fbuf)
   spin_unlock_irqrestore(&fbuf->lock_queue, flags);
   return ret;
 }
+
+#ifdef CONFIG_VIDEO_DMABUF
+int video_framebuff_import_dmabuf(vbuf_container_t *cnt, size_t minlen)
+{
+  FAR struct dmabuf_s *dmabuf;
+  int ret;
+
+  /* The device uses the shared buffer in place, like a USERPTR one */
+
+  ret = dmabuf_import(cnt->buf.m.fd, &dmabuf);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (dmabuf->len < minlen)
+    {
+      dmabuf_release(dmabuf);
+      return -EINVAL;
+    }
+
+  dmabuf_begin(dmabuf);
+
+  cnt->fd            = cnt->buf.m.fd;
+  cnt->dmabuf        = dmabuf;
+  cnt->buf.m.userptr = (unsigned long)dmabuf->addr;
+  cnt->buf.length    = dmabuf->len;
+  return OK;
+}
+#endif
@@ -0,0 +1,440 @@
+/****************************************************************************
+ * drivers/video/vnc/vnc_hextile.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <assert.h>
+#include <errno.h>
+
+#if defined(CONFIG_VNCSERVER_DEBUG) && !defined(CONFIG_DEBUG_GRAPHICS)
+#  undef  CONFIG_DEBUG_ERROR
+#  undef  CONFIG_DEBUG_WARN
+#  undef  CONFIG_DEBUG_INFO
+#  undef  CONFIG_DEBUG_GRAPHICS_ERROR
+#  undef  CONFIG_DEBUG_GRAPHICS_WARN
+#  undef  CONFIG_DEBUG_GRAPHICS_INFO
+#  define CONFIG_DEBUG_ERROR          1
+#  define CONFIG_DEBUG_WARN           1
+#  define CONFIG_DEBUG_INFO           1
+#  define CONFIG_DEBUG_GRAPHICS       1
+#  define CONFIG_DEBUG_GRAPHICS_ERROR 1
+#  define CONFIG_DEBUG_GRAPHICS_WARN  1
+#  define CONFIG_DEBUG_GRAPHICS_INFO  1
+#endif
+#include <debug.h>
+
+#include "vnc_server.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define HEXTILE_SIZE   16
+#define HEXTILE_HDRLEN \
+  SIZEOF_RFB_FRAMEBUFFERUPDATE_S(SIZEOF_RFB_RECTANGE_S(0))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The state of the encoding of one Hextile rectangle */
+
+struct hextile_s
+{
+  FAR struct vnc_session_s *session;
+  FAR uint8_t *buf;            /* The update buffer, session->outbuf */
+  size_t pos;                  /* The bytes in buf not sent yet */
+  size_t maxtile;              /* The size of a raw tile */
+  uint8_t colorfmt;            /* Remote color format, fixed for the rect */
+  uint8_t bytesperpixel;       /* Remote bytes per pixel */
+  bool bigendian;              /* Remote byte order */
+  bool bgvalid;                /* The background of the previous tile */
+  lfb_color_t bg;              /* carries over */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vnc_hextile_pixel
+ *
+ * Description:
+ *   Append a local pixel in the remote pixel format to the update buffer.
+ *
+ ****************************************************************************/
+
+static void vnc_hextile_pixel(FAR struct hextile_s *ht, lfb_color_t rgb)
+{
+  FAR uint8_t *dest = ht->buf + ht->pos;
+  uint32_t pixel;
+
+  switch (ht->colorfmt)
+    {
+      case FB_FMT_RGB8_222:
+        *dest = vnc_convert_rgb8_222(rgb);
+        ht->pos++;
+        return;
+
+      case FB_FMT_RGB8_332:
+        *dest = vnc_convert_rgb8_332(rgb);
+        ht->pos++;
+        return;
+
+      case FB_FMT_RGB16_555:
+        pixel = vnc_convert_rgb16_555(rgb);
+        break;
+
+      case FB_FMT_RGB16_565:
+        pixel = vnc_convert_rgb16_565(rgb);
+        break;
+
+      default:
+        pixel = vnc_convert_rgb32_888(rgb);
+        break;
+    }
+
+  if (ht->bytesperpixel == 2)
+    {
+      if (ht->bigendian)
+        {
+          rfb_putbe16(dest, pixel);
+        }
+      else
+        {
+          rfb_putle16(dest, pixel);
+        }
+    }
+  else
+    {
+      if (ht->bigendian)
+        {
+          rfb_putbe32(dest, pixel);
+        }
+      else
+        {
+          rfb_putle32(dest, pixel);
+        }
+    }
+
+  ht->pos += ht->bytesperpixel;
+}
+
+/****************************************************************************
+ * Name: vnc_hextile_flush
+ *
+ * Description:
+ *   Send the content of the update buffer.  A Hextile rectangle is longer
+ *   than the buffer, so it is sent in several parts of the TCP stream.
+ *
+ ****************************************************************************/
+
+static int vnc_hextile_flush(FAR struct hextile_s *ht)
+{
+  FAR const uint8_t *src = ht->buf;
+  ssize_t nsent;
+
+  while (ht->pos > 0)
+    {
+      nsent = psock_send(&ht->session->connect, src, ht->pos, 0);
+      if (nsent < 0)
+        {
+          gerr("ERROR: Send Hextile FrameBufferUpdate failed: %d\n",
+               (int)nsent);
+          return (int)nsent;
+        }
+
+      DEBUGASSERT(nsent <= ht->pos);
+      src     += nsent;
+      ht->pos -= nsent;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: vnc_hextile_tile
+ *
+ * Description:
+ *   Encode one tile.  A tile of one color is only its background, sent
+ *   only if it differs from the one of the previous tile.  A tile of two
+ *   colors is the most frequent one as background and the runs of the
+ *   other one in each row as subrectangles.  Other tiles, and the ones for
+ *   which the subrectangles would be larger, are sent raw.
+ *
+ ****************************************************************************/
+
+static void vnc_hextile_tile(FAR struct hextile_s *ht,
+                             fb_coord_t x, fb_coord_t y,
+                             fb_coord_t w, fb_coord_t h)
+{
+  FAR const lfb_color_t *row;
+  FAR const lfb_color_t *src;
+  FAR uint8_t *subenc;
+  FAR uint8_t *nsubrects;
+  lfb_color_t colors[2];
+  unsigned int count[2];
+  unsigned int ncolors = 1;
+  unsigned int nsub;
+  size_t rawsize = 1 + w * h * ht->bytesperpixel;
+  bool raw = false;
+  fb_coord_t i;
+  fb_coord_t j;
+  fb_coord_t k;
+
+  row = (FAR const lfb_color_t *)
+    (ht->session->fb + RFB_STRIDE * y + RFB_BYTESPERPIXEL * x);
+
+  /* Find the colors of the tile, stopping at the third one */
+
+  colors[0] = row[0];
+  count[0]  = 0;
+  count[1]  = 0;
+
+  for (j = 0, src = row; j < h && !raw; j++)
+    {
+      for (i = 0; i < w; i++)
+        {
+          if (src[i] == colors[0])
+            {
+              count[0]++;
+            }
+          else if (ncolors == 1)
+            {
+              colors[1] = src[i];
+              count[1]++;
+              ncolors   = 2;
+            }
+          else if (src[i] == colors[1])
+            {
+              count[1]++;
+            }
+          else
+            {
+              raw = true;
+              break;
+            }
+        }
+
+      src = (FAR const lfb_color_t *)((uintptr_t)src + RFB_STRIDE);
+    }
+
+  /* The background is the most frequent color */
+
+  if (ncolors == 2 && count[1] > count[0])
+    {
+      colors[0] = colors[1];
+      colors[1] = row[0];
+    }
+
+  if (!raw)
+    {
+      subenc  = ht->buf + ht->pos++;
+      *subenc = 0;
+
+      if (!ht->bgvalid || ht->bg != colors[0])
+        {
+          *subenc    |= RFB_SUBENCODING_BACK;
+          vnc_hextile_pixel(ht, colors[0]);
+          ht->bg      = colors[0];
+          ht->bgvalid = true;
+        }
+
+      if (ncolors == 1)
+        {
+          return;
+        }
+
+      /* The runs of the foreground color in each row */
+
+      *subenc   |= RFB_SUBENCODING_FORE | RFB_SUBENCODING_ANY;
+      vnc_hextile_pixel(ht, colors[1]);
+      nsubrects  = ht->buf + ht->pos++;
+      nsub       = 0;
+
+      for (j = 0, src = row; j < h && !raw; j++)
+        {
+          for (i = 0; i < w; i = k)
+            {
+              if (src[i] != colors[1])
+                {
+                  k = i + 1;
+                  continue;
+                }
+
+              for (k = i + 1; k < w && src[k] == colors[1]; k++)
+                {
+                }
+
+              /* Stop if the subrectangles are larger than a raw tile */
+
+              if (ht->pos + 2 > (subenc - ht->buf) + rawsize)
+                {
+                  raw = true;
+                  break;
+                }
+
+              ht->buf[ht->pos++] = (i << 4) | j;
+              ht->buf[ht->pos++] = ((k - i - 1) << 4);
+              nsub++;
+            }
+
+          src = (FAR const lfb_color_t *)((uintptr_t)src + RFB_STRIDE);
+        }
+
+      if (!raw)
+        {
+          *nsubrects = nsub;
+          return;
+        }
+
+      /* Restart at the subencoding byte */
+
+      ht->pos = subenc - ht->buf;
+    }
+
+  /* Raw tile, after which the background is not carried over */
+
+  ht->buf[ht->pos++] = RFB_SUBENCODING_RAW;
+  ht->bgvalid = false;
+
+  for (j = 0, src = row; j < h; j++)
+    {
+      for (i = 0; i < w; i++)
+        {
+          vnc_hextile_pixel(ht, src[i]);
+        }
+
+      src = (FAR const lfb_color_t *)((uintptr_t)src + RFB_STRIDE);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vnc_hextile
+ *
+ * Description:
+ *  Send the update rectangle with the Hextile encoding, if the client
+ *  supports it.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *   rect  - Describes the rectangle in the local framebuffer.
+ *
+ * Returned Value:
+ *   Zero is returned if Hextile coding was not performed (but no error was
+ *   encountered).  Otherwise, the size of the framebuffer update message
+ *   is returned on success or a negated errno value is returned on failure
+ *   that indicates the nature of the failure.  A failure is only
+ *   returned in cases of a network failure and unexpected internal failures.
+ *
+ ****************************************************************************/
+
+int vnc_hextile(FAR struct vnc_session_s *session,
+                FAR struct fb_area_s *rect)
+{
+  FAR struct rfb_framebufferupdate_s *update;
+  struct hextile_s ht;
+  fb_coord_t x;
+  fb_coord_t y;
+  size_t total = 0;
+  int ret;
+
+  if (!session->hextile)
+    {
+      return 0;
+    }
+
+  ht.session       = session;
+  ht.buf           = session->outbuf;
+  ht.colorfmt      = session->colorfmt;
+  ht.bytesperpixel = (session->bpp + 7) >> 3;
+  ht.bigendian     = session->bigendian;
+  ht.bgvalid       = false;
+  ht.maxtile       = 1 + HEXTILE_SIZE * HEXTILE_SIZE * ht.bytesperpixel;
+
+  /* Each tile must fit in the update buffer */
+
+  if (ht.maxtile > VNCSERVER_UPDATE_BUFSIZE)
+    {
+      return 0;
+    }
+
+  /* The FrameBufferUpdate with a single Hextile rectangle */
+
+  update = (FAR struct rfb_framebufferupdate_s *)session->outbuf;
+
+  update->msgtype = RFB_FBUPDATE_MSG;
+  update->padding = 0;
+  rfb_putbe16(update->nrect, 1);
+
+  rfb_putbe16(update->rect[0].xpos, rect->x);
+  rfb_putbe16(update->rect[0].ypos, rect->y);
+  rfb_putbe16(update->rect[0].width, rect->w);
+  rfb_putbe16(update->rect[0].height, rect->h);
+  rfb_putbe32(update->rect[0].encoding, RFB_ENCODING_HEXTILE);
+
+  ht.pos = HEXTILE_HDRLEN;
+
+  /* The tiles, left to right and top to bottom.  Once the header is out
+   * the rectangle must be completed in the color format it started with.
+   */
+
+  for (y = rect->y; y < rect->y + rect->h; y += HEXTILE_SIZE)
+    {
+      for (x = rect->x; x < rect->x + rect->w; x += HEXTILE_SIZE)
+        {
+          if (ht.pos + ht.maxtile > VNCSERVER_UPDATE_BUFSIZE)
+            {
+              total += ht.pos;
+              ret    = vnc_hextile_flush(&ht);
+              if (ret < 0)
+                {
+                  return ret;
+                }
+            }
+
+          vnc_hextile_tile(&ht, x, y,
+                           MIN(HEXTILE_SIZE, rect->x + rect->w - x),
+                           MIN(HEXTILE_SIZE, rect->y + rect->h - y));
+        }
+    }
+
+  total += ht.pos;
+  ret    = vnc_hextile_flush(&ht);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  updinfo("Sent {(%d, %d),(%d, %d)}\n",
+          rect->x, rect->y, rect->w, rect->h);
+  return total;
+}
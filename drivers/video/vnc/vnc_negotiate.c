@@ -517,5 +517,8 @@ int vnc_client_pixelformat(FAR struct vnc_session_s *session,
     }
 
   session->change = true;
+#ifdef CONFIG_VNCSERVER_TILEHASH
+  session->tilereset = true;
+#endif
   return OK;
 }
@@ -25,6 +25,7 @@
 #include <nuttx/config.h>
 
 #include <stdint.h>
+#include <string.h>
 #include <assert.h>
 #include <errno.h>
 
@@ -253,6 +254,48 @@ static size_t vnc_copy32(FAR struct vnc_session_s *session,
   return (size_t)((uintptr_t)dest - (uintptr_t)update->rect[0].data);
 }
 
+/****************************************************************************
+ * Name: vnc_copynative
+ *
+ * Description:
+ *   Copy the pixels from the source rectangle to a destination rectangle
+ *   of the same pixel format and byte order, row by row with memcpy()
+ *   instead of converting each pixel.
+ *
+ * Input Parameters:
+ *   session      - A reference to the VNC session structure.
+ *   row,col      - The upper left X/Y (pixel/row) position of the rectangle
+ *   width,height - The width (pixels) and height (rows of the rectangle)
+ *
+ * Returned Value:
+ *   The size of the transfer in bytes.
+ *
+ ****************************************************************************/
+
+static size_t vnc_copynative(FAR struct vnc_session_s *session,
+                             fb_coord_t row, fb_coord_t col,
+                             fb_coord_t height, fb_coord_t width)
+{
+  FAR struct rfb_framebufferupdate_s *update;
+  FAR const uint8_t *src;
+  FAR uint8_t *dest;
+  size_t rowsize = width * RFB_BYTESPERPIXEL;
+  fb_coord_t y;
+
+  update = (FAR struct rfb_framebufferupdate_s *)session->outbuf;
+  dest   = (FAR uint8_t *)update->rect[0].data;
+  src    = session->fb + RFB_STRIDE * row + RFB_BYTESPERPIXEL * col;
+
+  for (y = 0; y < height; y++)
+    {
+      memcpy(dest, src, rowsize);
+      dest += rowsize;
+      src  += RFB_STRIDE;
+    }
+
+  return rowsize * height;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -294,6 +337,7 @@ int vnc_raw(FAR struct vnc_session_s *session, FAR struct fb_area_s *rect)
   size_t size;
   ssize_t nsent;
   uint8_t colorfmt;
+  bool native;
 
   union
   {
@@ -340,6 +384,16 @@ int vnc_raw(FAR struct vnc_session_s *session, FAR struct fb_area_s *rect)
         return -EINVAL;
     }
 
+  /* No conversion is needed if the client uses the local pixel format */
+
+#ifdef CONFIG_ENDIAN_BIG
+  native = colorfmt == RFB_COLORFMT &&
+           (bytesperpixel == 1 || session->bigendian);
+#else
+  native = colorfmt == RFB_COLORFMT &&
+           (bytesperpixel == 1 || !session->bigendian);
+#endif
+
   /* Get with width and height of the source and destination rectangles.
    * The source rectangle many be larger than the destination rectangle.
    * In that case, we will have to emit multiple rectangles.
@@ -426,7 +480,11 @@ int vnc_raw(FAR struct vnc_session_s *session, FAR struct fb_area_s *rect)
            * performing the necessary color conversions.
            */
 
-          if (bytesperpixel == 1)
+          if (native)
+            {
+              size = vnc_copynative(session, y, x, updheight, updwidth);
+            }
+          else if (bytesperpixel == 1)
             {
               size = vnc_copy8(session, y, x, updheight, updwidth,
                                convert.bpp8);
@@ -291,6 +291,17 @@ int vnc_receiver(FAR struct vnc_session_s *session)
                   rect.w = rfb_getbe16(update->width);
                   rect.h = rfb_getbe16(update->height);
 
+#ifdef CONFIG_VNCSERVER_TILEHASH
+                  /* The client asks for all of the content of the
+                   * rectangle, not only the changes.
+                   */
+
+                  if (update->incremental == 0)
+                    {
+                      session->tilereset = true;
+                    }
+#endif
+
                   ret = vnc_update_rectangle(session, &rect, false);
                   if (ret < 0)
                     {
@@ -469,6 +480,7 @@ int vnc_client_encodings(FAR struct vnc_session_s *session,
   /* Assume that there are no common encodings (other than RAW) */
 
   session->rre = false;
+  session->hextile = false;
 
   /* Loop for each client supported encoding */
 
@@ -485,8 +497,15 @@ int vnc_client_encodings(FAR struct vnc_session_s *session,
         {
           session->rre = true;
         }
+      else if (encoding == RFB_ENCODING_HEXTILE)
+        {
+          session->hextile = true;
+        }
     }
 
   session->change = true;
+#ifdef CONFIG_VNCSERVER_TILEHASH
+  session->tilereset = true;
+#endif
   return OK;
 }
@@ -125,6 +125,10 @@ static void vnc_reset_session(FAR struct vnc_session_s *session,
   session->nwhupd  = 0;
   session->change  = true;
 
+#ifdef CONFIG_VNCSERVER_TILEHASH
+  session->tilereset = true;
+#endif
+
 #ifdef CONFIG_VNCSERVER_TOUCH
   session->touch.maxpoint = 1;
 #endif
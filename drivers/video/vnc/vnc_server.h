@@ -144,6 +144,16 @@
 #define RFB_STRIDE          (RFB_BYTESPERPIXEL * CONFIG_VNCSERVER_SCREENWIDTH)
 #define RFB_SIZE            (RFB_STRIDE * CONFIG_VNCSERVER_SCREENHEIGHT)
 
+/* Tiles of the framebuffer whose content is hashed to skip the unchanged
+ * ones, see CONFIG_VNCSERVER_TILEHASH.
+ */
+
+#define RFB_TILESIZE        16
+#define RFB_NXTILES \
+  ((CONFIG_VNCSERVER_SCREENWIDTH + RFB_TILESIZE - 1) / RFB_TILESIZE)
+#define RFB_NYTILES \
+  ((CONFIG_VNCSERVER_SCREENHEIGHT + RFB_TILESIZE - 1) / RFB_TILESIZE)
+
 /* RFB Port Number */
 
 #define RFB_PORT_BASE       5900
@@ -207,6 +217,7 @@ struct vnc_session_s
   volatile uint8_t bpp;        /* Remote bits per pixel */
   volatile bool bigendian;     /* True: Remote expect data in big-endian format */
   volatile bool rre;           /* True: Remote supports RRE encoding */
+  volatile bool hextile;       /* True: Remote supports Hextile encoding */
   FAR uint8_t *fb;             /* Allocated local frame buffer */
 
   /* VNC client input support */
@@ -238,6 +249,15 @@ struct vnc_session_s
   sem_t vsyncsem;
 #endif
 
+#ifdef CONFIG_VNCSERVER_TILEHASH
+  /* Hash of the content of each tile last sent to the client, 0 if it is
+   * not known.  tilereset asks the updater to forget them all.
+   */
+
+  volatile bool tilereset;
+  uint32_t tilehash[RFB_NXTILES * RFB_NYTILES];
+#endif
+
   /* I/O buffers for misc network send/receive */
 
   uint8_t inbuf[CONFIG_VNCSERVER_INBUFFER_SIZE];
@@ -464,6 +484,29 @@ int vnc_receiver(FAR struct vnc_session_s *session);
 
 int vnc_rre(FAR struct vnc_session_s *session, FAR struct fb_area_s *rect);
 
+/****************************************************************************
+ * Name: vnc_hextile
+ *
+ * Description:
+ *  Send the update rectangle with the Hextile encoding, if the client
+ *  supports it.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *   rect  - Describes the rectangle in the local framebuffer.
+ *
+ * Returned Value:
+ *   Zero is returned if Hextile coding was not performed (but no error was
+ *   encountered).  Otherwise, the size of the framebuffer update message
+ *   is returned on success or a negated errno value is returned on failure
+ *   that indicates the nature of the failure.  A failure is only
+ *   returned in cases of a network failure and unexpected internal failures.
+ *
+ ****************************************************************************/
+
+int vnc_hextile(FAR struct vnc_session_s *session,
+                FAR struct fb_area_s *rect);
+
 /****************************************************************************
  * Name: vnc_raw
  *
@@ -343,6 +343,181 @@ static void vnc_add_queue(FAR struct vnc_session_s *session,
   DEBUGASSERT(session->queuesem.semcount <= CONFIG_VNCSERVER_NUPDATES);
 }
 
+/****************************************************************************
+ * Name: vnc_encode
+ *
+ * Description:
+ *   Send a rectangle with the best encoding the client supports: RRE for
+ *   one color, else Hextile, else RAW.
+ *
+ * Input Parameters:
+ *   session - A reference to the VNC session structure.
+ *   rect    - The rectangle in the local framebuffer.
+ *
+ * Returned Value:
+ *   Zero or positive on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static int vnc_encode(FAR struct vnc_session_s *session,
+                      FAR struct fb_area_s *rect)
+{
+  int ret;
+
+  /* Attempt to use RRE encoding, then Hextile encoding */
+
+  ret = vnc_rre(session, rect);
+  if (ret == 0)
+    {
+      ret = vnc_hextile(session, rect);
+    }
+
+  if (ret == 0)
+    {
+      /* Perform the framebuffer update using the default RAW encoding */
+
+      ret = vnc_raw(session, rect);
+    }
+
+  return ret;
+}
+
+#ifdef CONFIG_VNCSERVER_TILEHASH
+
+/****************************************************************************
+ * Name: vnc_tile_hash
+ *
+ * Description:
+ *   Hash the pixels of a tile of the local framebuffer (FNV-1a on the
+ *   pixel values).  0 is reserved for a tile not known.
+ *
+ ****************************************************************************/
+
+static uint32_t vnc_tile_hash(FAR struct vnc_session_s *session,
+                              fb_coord_t x, fb_coord_t y,
+                              fb_coord_t w, fb_coord_t h)
+{
+  FAR const lfb_color_t *row;
+  uint32_t hash = 2166136261u;
+  fb_coord_t i;
+  fb_coord_t j;
+
+  row = (FAR const lfb_color_t *)
+    (session->fb + RFB_STRIDE * y + RFB_BYTESPERPIXEL * x);
+
+  for (j = 0; j < h; j++)
+    {
+      for (i = 0; i < w; i++)
+        {
+          hash = (hash ^ row[i]) * 16777619u;
+        }
+
+      row = (FAR const lfb_color_t *)((uintptr_t)row + RFB_STRIDE);
+    }
+
+  return hash != 0 ? hash : 1;
+}
+
+/****************************************************************************
+ * Name: vnc_encode_changed
+ *
+ * Description:
+ *   Send only the part of a rectangle whose tiles changed since they were
+ *   last sent.  The framebuffer damage reported by the graphics and the
+ *   client update requests are often larger than, or redraws of, what
+ *   really changed.  For each row of tiles the span from the first to the
+ *   last changed tile is sent.  A tile partly inside the rectangle is
+ *   always sent, and its hash forgotten, since only a part of it reaches
+ *   the client.
+ *
+ * Input Parameters:
+ *   session - A reference to the VNC session structure.
+ *   rect    - The rectangle in the local framebuffer.
+ *
+ * Returned Value:
+ *   Zero or positive on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static int vnc_encode_changed(FAR struct vnc_session_s *session,
+                              FAR struct fb_area_s *rect)
+{
+  struct fb_area_s span;
+  fb_coord_t right  = MIN(rect->x + rect->w, CONFIG_VNCSERVER_SCREENWIDTH);
+  fb_coord_t bottom = MIN(rect->y + rect->h, CONFIG_VNCSERVER_SCREENHEIGHT);
+  fb_coord_t tx;
+  fb_coord_t ty;
+  fb_coord_t x;
+  fb_coord_t y;
+  fb_coord_t w;
+  fb_coord_t h;
+  int first;
+  int last;
+  int ret;
+
+  if (session->tilereset)
+    {
+      session->tilereset = false;
+      memset(session->tilehash, 0, sizeof(session->tilehash));
+    }
+
+  for (ty = rect->y / RFB_TILESIZE; ty * RFB_TILESIZE < bottom; ty++)
+    {
+      y     = ty * RFB_TILESIZE;
+      h     = MIN(RFB_TILESIZE, CONFIG_VNCSERVER_SCREENHEIGHT - y);
+      first = -1;
+      last  = -1;
+
+      for (tx = rect->x / RFB_TILESIZE; tx * RFB_TILESIZE < right; tx++)
+        {
+          FAR uint32_t *stored = &session->tilehash[ty * RFB_NXTILES + tx];
+          uint32_t hash = 0;
+
+          x = tx * RFB_TILESIZE;
+          w = MIN(RFB_TILESIZE, CONFIG_VNCSERVER_SCREENWIDTH - x);
+
+          if (x >= rect->x && x + w <= right &&
+              y >= rect->y && y + h <= bottom)
+            {
+              hash = vnc_tile_hash(session, x, y, w, h);
+              if (hash == *stored)
+                {
+                  continue;
+                }
+            }
+
+          *stored = hash;
+          if (first < 0)
+            {
+              first = tx;
+            }
+
+          last = tx;
+        }
+
+      if (first < 0)
+        {
+          continue;
+        }
+
+      /* The changed span of this row of tiles, within the rectangle */
+
+      span.x = MAX(rect->x, first * RFB_TILESIZE);
+      span.y = MAX(rect->y, y);
+      span.w = MIN(right, (last + 1) * RFB_TILESIZE) - span.x;
+      span.h = MIN(bottom, y + RFB_TILESIZE) - span.y;
+
+      ret = vnc_encode(session, &span);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: vnc_updater
  *
@@ -400,15 +575,11 @@ static FAR void *vnc_updater(FAR void *arg)
               srcrect->rect.x, srcrect->rect.y,
               srcrect->rect.w, srcrect->rect.h);
 
-      /* Attempt to use RRE encoding */
-
-      ret = vnc_rre(session, &srcrect->rect);
-      if (ret == 0)
-        {
-          /* Perform the framebuffer update using the default RAW encoding */
-
-          ret = vnc_raw(session, &srcrect->rect);
-        }
+#ifdef CONFIG_VNCSERVER_TILEHASH
+      ret = vnc_encode_changed(session, &srcrect->rect);
+#else
+      ret = vnc_encode(session, &srcrect->rect);
+#endif
 
       /* Release the update structure */
 
@@ -25,9 +25,12 @@
 #include <debug.h>
 #include <errno.h>
 #include <stdio.h>
+#include <sys/param.h>
 
+#include <nuttx/arch.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
+#include <nuttx/queue.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/spinlock.h>
 #include <nuttx/virtio/virtio.h>
@@ -43,15 +46,22 @@
 
 /* Block feature bits */
 
+#define VIRTIO_BLK_F_SIZE_MAX       1  /* Max size of a segment */
+#define VIRTIO_BLK_F_SEG_MAX        2  /* Max segments of a request */
 #define VIRTIO_BLK_F_RO             5  /* Disk is read-only */
 #define VIRTIO_BLK_F_BLK_SIZE       6  /* Block size of disk is available */
 #define VIRTIO_BLK_F_FLUSH          9  /* Cache flush command support */
+#define VIRTIO_BLK_F_MQ             12 /* Support more than one vq */
+#define VIRTIO_BLK_F_DISCARD        13 /* Discard command support */
+#define VIRTIO_BLK_F_WRITE_ZEROES   14 /* Write zeroes command support */
 
 /* Block request type */
 
 #define VIRTIO_BLK_T_IN             0  /* READ */
 #define VIRTIO_BLK_T_OUT            1  /* WRITE */
 #define VIRTIO_BLK_T_FLUSH          4  /* FLUSH */
+#define VIRTIO_BLK_T_DISCARD        11 /* DISCARD */
+#define VIRTIO_BLK_T_WRITE_ZEROES   13 /* WRITE ZEROES */
 
 /* Block request return status */
 
@@ -59,11 +69,30 @@
 #define VIRTIO_BLK_S_IOERR          1
 #define VIRTIO_BLK_S_UNSUPP         2
 
+/* Flags of struct virtio_blk_discard_s */
+
+#define VIRTIO_BLK_WRITE_ZEROES_FLAG_UNMAP 1
+
 /* Block device sector size */
 
 #define VIRTIO_BLK_SECTOR_BITS      9
 #define VIRTIO_BLK_SECTOR_SIZE      (1UL << VIRTIO_BLK_SECTOR_BITS)
 
+/* The most virtqueues, data segments of a request (two more descriptors
+ * take the headers), requests of a read or write in flight at once, and
+ * the segment size if the device sets no limit.
+ */
+
+#ifdef CONFIG_DRIVERS_VIRTIO_BLK_MAXQUEUES
+#  define VIRTIO_BLK_MAXQUEUES      CONFIG_DRIVERS_VIRTIO_BLK_MAXQUEUES
+#else
+#  define VIRTIO_BLK_MAXQUEUES      1
+#endif
+
+#define VIRTIO_BLK_MAXSEGS          16
+#define VIRTIO_BLK_MAXINFLIGHT      4
+#define VIRTIO_BLK_SEGSIZE          (1024 * 1024)
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -84,6 +113,15 @@ begin_packed_struct struct virtio_blk_resp_s
   uint8_t status;
 } end_packed_struct;
 
+/* Data of the discard and write zeroes requests */
+
+begin_packed_struct struct virtio_blk_discard_s
+{
+  uint64_t sector;
+  uint32_t num_sectors;
+  uint32_t flags;
+} end_packed_struct;
+
 begin_packed_struct struct virtio_blk_config_s
 {
   uint64_t capacity;
@@ -112,12 +150,41 @@ begin_packed_struct struct virtio_blk_config_s
   uint32_t secure_erase_sector_alignment;
 } end_packed_struct;
 
+/* A block request, on the stack of its caller.  The requests for the
+ * sectors following a request still waiting for free descriptors are
+ * merged into it and go to the device as one.
+ */
+
+struct virtio_blk_io_s
+{
+  sq_entry_t                    node;     /* Entry of the pending list */
+  FAR struct virtio_blk_io_s   *merged;   /* The next merged request */
+  struct virtio_blk_req_s       req;      /* The block out header */
+  struct virtio_blk_resp_s      resp;     /* The block in header */
+  FAR void                     *buffer;   /* The data */
+  size_t                        len;      /* The data length */
+  sem_t                         sem;      /* Posted on completion */
+  volatile bool                 done;     /* Completed */
+};
+
+struct virtio_blk_queue_s
+{
+  spinlock_t                    lock;     /* Lock of the virtqueue */
+  sq_queue_t                    pending;  /* Requests waiting descriptors */
+};
+
 struct virtio_blk_priv_s
 {
   FAR struct virtio_device     *vdev;           /* Virtio deivce */
-  spinlock_t                    lock;           /* Lock */
+  struct virtio_blk_queue_s     queues[VIRTIO_BLK_MAXQUEUES];
   uint64_t                      nsectors;       /* Sectore numbers */
   uint32_t                      block_size;     /* Block size */
+  uint32_t                      sizemax;        /* Max segment size */
+  uint32_t                      maxlen;         /* Max data of a request */
+  uint32_t                      maxdiscard;     /* Max discard sectors */
+  uint32_t                      maxzeroes;      /* Max zeroes sectors */
+  uint16_t                      segmax;         /* Max segments / request */
+  uint8_t                       nqueues;        /* Number of virtqueues */
   char                          name[NAME_MAX]; /* Device name */
 };
 
@@ -143,6 +210,8 @@ static int     virtio_blk_geometry(FAR struct inode *inode,
 static int     virtio_blk_ioctl(FAR struct inode *inode, int cmd,
                                 unsigned long arg);
 static int     virtio_blk_flush(FAR struct virtio_blk_priv_s *priv);
+static int     virtio_blk_discard(FAR struct virtio_blk_priv_s *priv,
+                                  FAR const struct blk_preerase_s *range);
 
 /* Other functions */
 
@@ -182,119 +251,331 @@ static int g_virtio_blk_idx = 0;
  ****************************************************************************/
 
 /****************************************************************************
- * Name: virtio_blk_wait_complete
+ * Name: virtio_blk_io_init
+ ****************************************************************************/
+
+static void virtio_blk_io_init(FAR struct virtio_blk_io_s *io,
+                               uint32_t type, uint64_t sector,
+                               FAR void *buffer, size_t len)
+{
+  io->merged       = NULL;
+  io->req.type     = type;
+  io->req.reserved = 0;
+  io->req.sector   = sector;
+  io->resp.status  = VIRTIO_BLK_S_IOERR;
+  io->buffer       = buffer;
+  io->len          = len;
+  io->done         = false;
+  nxsem_init(&io->sem, 0, 0);
+}
+
+/****************************************************************************
+ * Name: virtio_blk_nsegs
+ ****************************************************************************/
+
+static unsigned int virtio_blk_nsegs(FAR struct virtio_blk_priv_s *priv,
+                                     FAR struct virtio_blk_io_s *io)
+{
+  return (io->len + priv->sizemax - 1) / priv->sizemax;
+}
+
+/****************************************************************************
+ * Name: virtio_blk_submit
  *
  * Description:
- *   Wait the virtio block request complete
+ *   Add a request and the ones merged into it to the virtqueue, with the
+ *   lock of the queue held.
  *
  ****************************************************************************/
 
-static void virtio_blk_wait_complete(FAR struct virtqueue *vq,
-                                     FAR sem_t *respsem)
+static int virtio_blk_submit(FAR struct virtio_blk_priv_s *priv,
+                             FAR struct virtqueue *vq,
+                             FAR struct virtio_blk_io_s *io)
 {
-  FAR struct virtio_blk_priv_s *priv = vq->vq_dev->priv;
-  FAR sem_t *sem;
+  struct virtqueue_buf vb[VIRTIO_BLK_MAXSEGS + 2];
+  FAR struct virtio_blk_io_s *m;
+  size_t offset;
+  int readnum;
+  int n = 0;
 
-  if (up_interrupt_context())
+  /* Fill the virtqueue buffer:
+   * Buffer 0: the block out header;
+   * Buffer 1 to n - 2: the data of all the merged requests;
+   * Buffer n - 1: the block in header, return the status.
+   */
+
+  vb[n].buf   = &io->req;
+  vb[n++].len = VIRTIO_BLK_REQ_HEADER_SIZE;
+
+  for (m = io; m != NULL; m = m->merged)
     {
-      for (; ; )
+      for (offset = 0; offset < m->len; offset += vb[n++].len)
         {
-          sem = virtqueue_get_buffer_lock(vq, NULL, NULL, &priv->lock);
-          if (sem == respsem)
-            {
-              break;
-            }
-          else if (sem != NULL)
-            {
-              nxsem_post(sem);
-            }
+          vb[n].buf = (FAR uint8_t *)m->buffer + offset;
+          vb[n].len = MIN(m->len - offset, priv->sizemax);
         }
     }
-  else
+
+  vb[n].buf   = &io->resp;
+  vb[n++].len = VIRTIO_BLK_RESP_HEADER_SIZE;
+
+  /* Only the data to read is written by the device */
+
+  readnum = io->req.type == VIRTIO_BLK_T_IN ? 1 : n - 1;
+  return virtqueue_add_buffer(vq, vb, readnum, n - readnum, io);
+}
+
+/****************************************************************************
+ * Name: virtio_blk_merge
+ *
+ * Description:
+ *   Try to merge a request into the last pending one, if it goes on with
+ *   the following sectors in the same direction.  Only the last one may
+ *   take it, so that the requests still reach the device in order.
+ *
+ ****************************************************************************/
+
+static bool virtio_blk_merge(FAR struct virtio_blk_priv_s *priv,
+                             FAR struct virtio_blk_io_s *last,
+                             FAR struct virtio_blk_io_s *io)
+{
+  FAR struct virtio_blk_io_s *m = last;
+  unsigned int nsegs = virtio_blk_nsegs(priv, io);
+  uint64_t len = 0;
+
+  if (io->req.type != last->req.type ||
+      (io->req.type != VIRTIO_BLK_T_IN && io->req.type != VIRTIO_BLK_T_OUT))
     {
-      nxsem_wait_uninterruptible(respsem);
+      return false;
     }
+
+  for (; ; )
+    {
+      nsegs += virtio_blk_nsegs(priv, m);
+      len   += m->len;
+      if (m->merged == NULL)
+        {
+          break;
+        }
+
+      m = m->merged;
+    }
+
+  if (nsegs > priv->segmax ||
+      last->req.sector + (len >> VIRTIO_BLK_SECTOR_BITS) != io->req.sector)
+    {
+      return false;
+    }
+
+  m->merged = io;
+  return true;
 }
 
 /****************************************************************************
- * Name: virtio_blk_rdwr
+ * Name: virtio_blk_queue
  *
  * Description:
- *   Common function for read and write
+ *   Queue a request, with the lock of the queue held.  It goes to the
+ *   virtqueue if no request is waiting before it and there are free
+ *   descriptors, otherwise it waits in the pending list.
  *
  ****************************************************************************/
 
-static ssize_t virtio_blk_rdwr(FAR struct virtio_blk_priv_s *priv,
-                               FAR void *buffer, blkcnt_t startsector,
-                               unsigned int nsectors, bool write)
+static void virtio_blk_queue(FAR struct virtio_blk_priv_s *priv, int qid,
+                             FAR struct virtio_blk_io_s *io)
 {
-  FAR struct virtio_device *vdev = priv->vdev;
-  FAR struct virtqueue *vq = vdev->vrings_info[0].vq;
-  FAR struct virtqueue_buf vb[3];
-  struct virtio_blk_resp_s resp;
-  struct virtio_blk_req_s req;
+  FAR struct virtio_blk_queue_s *queue = &priv->queues[qid];
+  FAR struct virtio_blk_io_s *last;
+
+  last = (FAR struct virtio_blk_io_s *)sq_tail(&queue->pending);
+  if (last == NULL)
+    {
+      if (virtio_blk_submit(priv, priv->vdev->vrings_info[qid].vq, io) >= 0)
+        {
+          return;
+        }
+    }
+  else if (virtio_blk_merge(priv, last, io))
+    {
+      return;
+    }
+
+  sq_addlast(&io->node, &queue->pending);
+}
+
+/****************************************************************************
+ * Name: virtio_blk_reap
+ *
+ * Description:
+ *   Complete the requests done by the device, then submit the pending ones
+ *   the freed descriptors can take.
+ *
+ ****************************************************************************/
+
+static void virtio_blk_reap(FAR struct virtio_blk_priv_s *priv, int qid)
+{
+  FAR struct virtio_blk_queue_s *queue = &priv->queues[qid];
+  FAR struct virtqueue *vq = priv->vdev->vrings_info[qid].vq;
+  FAR struct virtio_blk_io_s *io;
+  FAR struct virtio_blk_io_s *next;
+  sq_queue_t done;
   irqstate_t flags;
-  sem_t respsem;
-  ssize_t ret;
-  int readnum;
+  bool kick = false;
+  uint8_t status;
 
-  nxsem_init(&respsem, 0, 0);
+  sq_init(&done);
+
+  flags = spin_lock_irqsave(&queue->lock);
+  while ((io = virtqueue_get_buffer(vq, NULL, NULL)) != NULL)
+    {
+      sq_addlast(&io->node, &done);
+    }
 
-  /* Build the block request */
+  while ((io = (FAR struct virtio_blk_io_s *)sq_peek(&queue->pending)) !=
+         NULL && virtio_blk_submit(priv, vq, io) >= 0)
+    {
+      sq_remfirst(&queue->pending);
+      kick = true;
+    }
 
-  req.type     = write ? VIRTIO_BLK_T_OUT : VIRTIO_BLK_T_IN;
-  req.reserved = 0;
-  req.sector   = startsector * priv->block_size >> VIRTIO_BLK_SECTOR_BITS;
-  resp.status  = VIRTIO_BLK_S_IOERR;
+  if (kick)
+    {
+      virtqueue_kick(vq);
+    }
 
-  /* Fill the virtqueue buffer:
-   * Buffer 0: the block out header;
-   * Buffer 1: the read/write buffer;
-   * Buffer 2: the block in header, return the status.
-   */
+  spin_unlock_irqrestore(&queue->lock, flags);
 
-  vb[0].buf = &req;
-  vb[0].len = VIRTIO_BLK_REQ_HEADER_SIZE;
-  vb[1].buf = buffer;
-  vb[1].len = nsectors * priv->block_size;
-  vb[2].buf = &resp;
-  vb[2].len = VIRTIO_BLK_RESP_HEADER_SIZE;
-  readnum = write ? 2 : 1;
+  /* Wake up the callers, the requests are gone once posted */
 
-  if (up_interrupt_context())
+  while ((io = (FAR struct virtio_blk_io_s *)sq_remfirst(&done)) != NULL)
     {
-      virtqueue_disable_cb_lock(vq, &priv->lock);
+      status = io->resp.status;
+      for (; io != NULL; io = next)
+        {
+          next            = io->merged;
+          io->resp.status = status;
+          io->done        = true;
+          nxsem_post(&io->sem);
+        }
     }
+}
 
-  flags = spin_lock_irqsave(&priv->lock);
-  ret = virtqueue_add_buffer(vq, vb, readnum, 3 - readnum, &respsem);
-  if (ret < 0)
+/****************************************************************************
+ * Name: virtio_blk_exec
+ *
+ * Description:
+ *   Queue the requests to the virtqueue of this CPU, notify the device
+ *   once and wait for all of them.
+ *
+ ****************************************************************************/
+
+static int virtio_blk_exec(FAR struct virtio_blk_priv_s *priv,
+                           FAR struct virtio_blk_io_s *io, int nio)
+{
+  int qid = this_cpu() % priv->nqueues;
+  FAR struct virtio_blk_queue_s *queue = &priv->queues[qid];
+  FAR struct virtqueue *vq = priv->vdev->vrings_info[qid].vq;
+  bool polling = up_interrupt_context();
+  irqstate_t flags;
+  int ret = OK;
+  int i;
+
+  if (polling)
     {
-      spin_unlock_irqrestore(&priv->lock, flags);
-      vrterr("virtqueue_add_buffer failed, ret=%zd\n", ret);
-      goto err;
+      virtqueue_disable_cb_lock(vq, &queue->lock);
+    }
+
+  flags = spin_lock_irqsave(&queue->lock);
+  for (i = 0; i < nio; i++)
+    {
+      virtio_blk_queue(priv, qid, &io[i]);
     }
 
   virtqueue_kick(vq);
-  spin_unlock_irqrestore(&priv->lock, flags);
+  spin_unlock_irqrestore(&queue->lock, flags);
 
   /* Wait for the request completion */
 
-  virtio_blk_wait_complete(vq, &respsem);
+  for (i = 0; i < nio; i++)
+    {
+      if (polling)
+        {
+          while (!io[i].done)
+            {
+              virtio_blk_reap(priv, qid);
+            }
+        }
+      else
+        {
+          nxsem_wait_uninterruptible(&io[i].sem);
+        }
+
+      if (io[i].resp.status == VIRTIO_BLK_S_UNSUPP)
+        {
+          ret = -ENOTSUP;
+        }
+      else if (io[i].resp.status != VIRTIO_BLK_S_OK)
+        {
+          vrterr("Request %" PRIu32 " Error\n", io[i].req.type);
+          ret = -EIO;
+        }
+
+      nxsem_destroy(&io[i].sem);
+    }
 
-  if (resp.status != VIRTIO_BLK_S_OK)
+  if (polling)
     {
-      vrterr("%s Error\n", write ? "Write" : "Read");
-      ret = -EIO;
+      virtqueue_enable_cb_lock(vq, &queue->lock);
     }
 
-err:
-  if (up_interrupt_context())
+  return ret;
+}
+
+/****************************************************************************
+ * Name: virtio_blk_rdwr
+ *
+ * Description:
+ *   Common function for read and write, which cuts the transfer into
+ *   requests the device takes and keeps several of them in flight.
+ *
+ ****************************************************************************/
+
+static ssize_t virtio_blk_rdwr(FAR struct virtio_blk_priv_s *priv,
+                               FAR void *buffer, blkcnt_t startsector,
+                               unsigned int nsectors, bool write)
+{
+  struct virtio_blk_io_s io[VIRTIO_BLK_MAXINFLIGHT];
+  FAR uint8_t *data = buffer;
+  uint64_t sector;
+  size_t len;
+  size_t n;
+  int ret;
+  int i;
+
+  sector = startsector * priv->block_size >> VIRTIO_BLK_SECTOR_BITS;
+  len    = (size_t)nsectors * priv->block_size;
+
+  while (len > 0)
     {
-      virtqueue_enable_cb_lock(vq, &priv->lock);
+      for (i = 0; i < VIRTIO_BLK_MAXINFLIGHT && len > 0; i++)
+        {
+          n = MIN(len, priv->maxlen);
+          virtio_blk_io_init(&io[i], write ? VIRTIO_BLK_T_OUT :
+                             VIRTIO_BLK_T_IN, sector, data, n);
+          sector += n >> VIRTIO_BLK_SECTOR_BITS;
+          data   += n;
+          len    -= n;
+        }
+
+      ret = virtio_blk_exec(priv, io, i);
+      if (ret < 0)
+        {
+          vrterr("%s Error\n", write ? "Write" : "Read");
+          return ret;
+        }
     }
 
-  return ret >= 0 ? nsectors : ret;
+  return nsectors;
 }
 
 /****************************************************************************
@@ -399,52 +680,70 @@ static int virtio_blk_geometry(FAR struct inode *inode,
 }
 
 /****************************************************************************
- * Name: virtio_blk_ioctl
+ * Name: virtio_blk_flush
  ****************************************************************************/
 
 static int virtio_blk_flush(FAR struct virtio_blk_priv_s *priv)
 {
-  FAR struct virtio_device *vdev = priv->vdev;
-  FAR struct virtqueue *vq = vdev->vrings_info[0].vq;
-  FAR struct virtqueue_buf vb[2];
-  struct virtio_blk_resp_s resp;
-  struct virtio_blk_req_s req;
-  irqstate_t flags;
-  sem_t respsem;
+  struct virtio_blk_io_s io;
   int ret;
 
-  nxsem_init(&respsem, 0, 0);
+  virtio_blk_io_init(&io, VIRTIO_BLK_T_FLUSH, 0, NULL, 0);
+  ret = virtio_blk_exec(priv, &io, 1);
+  if (ret < 0)
+    {
+      vrterr("Flush Error\n");
+    }
 
-  /* Build the block request */
+  return ret;
+}
 
-  req.type     = VIRTIO_BLK_T_FLUSH;
-  req.reserved = 0;
-  req.sector   = 0;
-  resp.status  = VIRTIO_BLK_S_IOERR;
+/****************************************************************************
+ * Name: virtio_blk_discard
+ *
+ * Description:
+ *   Discard a run of sectors, or write zeroes over it, allowing the device
+ *   to unmap it, if the device cannot discard.
+ *
+ ****************************************************************************/
 
-  vb[0].buf = &req;
-  vb[0].len = VIRTIO_BLK_REQ_HEADER_SIZE;
-  vb[1].buf = &resp;
-  vb[1].len = VIRTIO_BLK_RESP_HEADER_SIZE;
+static int virtio_blk_discard(FAR struct virtio_blk_priv_s *priv,
+                              FAR const struct blk_preerase_s *range)
+{
+  struct virtio_blk_discard_s seg;
+  struct virtio_blk_io_s io;
+  uint64_t sector;
+  uint64_t count;
+  uint32_t type;
+  uint32_t max;
+  int ret = OK;
 
-  flags = spin_lock_irqsave(&priv->lock);
-  ret = virtqueue_add_buffer(vq, vb, 1, 1, &respsem);
-  if (ret < 0)
+  if (virtio_has_feature(priv->vdev, VIRTIO_BLK_F_DISCARD))
     {
-      spin_unlock_irqrestore(&priv->lock, flags);
-      return ret;
+      type = VIRTIO_BLK_T_DISCARD;
+      max  = priv->maxdiscard;
+    }
+  else
+    {
+      type = VIRTIO_BLK_T_WRITE_ZEROES;
+      max  = priv->maxzeroes;
     }
 
-  virtqueue_kick(vq);
-  spin_unlock_irqrestore(&priv->lock, flags);
-
-  /* Wait for the request completion */
+  sector = range->startsector * priv->block_size >> VIRTIO_BLK_SECTOR_BITS;
+  count  = range->nsectors * priv->block_size >> VIRTIO_BLK_SECTOR_BITS;
 
-  nxsem_wait_uninterruptible(&respsem);
-  if (resp.status != VIRTIO_BLK_S_OK)
+  while (count > 0 && ret >= 0)
     {
-      vrterr("Flush Error\n");
-      ret = -EIO;
+      seg.sector      = sector;
+      seg.num_sectors = MIN(count, max);
+      seg.flags       = type == VIRTIO_BLK_T_WRITE_ZEROES ?
+                        VIRTIO_BLK_WRITE_ZEROES_FLAG_UNMAP : 0;
+
+      virtio_blk_io_init(&io, type, 0, &seg, sizeof(seg));
+      ret = virtio_blk_exec(priv, &io, 1);
+
+      sector += seg.num_sectors;
+      count  -= seg.num_sectors;
     }
 
   return ret;
@@ -471,6 +770,19 @@ static int virtio_blk_ioctl(FAR struct inode *inode, int cmd,
             ret = virtio_blk_flush(priv);
           }
         break;
+
+      case BIOC_PREERASE:
+        if (virtio_has_feature(priv->vdev, VIRTIO_BLK_F_RO))
+          {
+            ret = -EPERM;
+          }
+        else if (virtio_has_feature(priv->vdev, VIRTIO_BLK_F_DISCARD) ||
+                 virtio_has_feature(priv->vdev, VIRTIO_BLK_F_WRITE_ZEROES))
+          {
+            ret = virtio_blk_discard(priv,
+                    (FAR const struct blk_preerase_s *)(uintptr_t)arg);
+          }
+        break;
     }
 
   return ret;
@@ -482,19 +794,7 @@ static int virtio_blk_ioctl(FAR struct inode *inode, int cmd,
 
 static void virtio_blk_done(FAR struct virtqueue *vq)
 {
-  FAR struct virtio_blk_priv_s *priv = vq->vq_dev->priv;
-  FAR sem_t *respsem;
-
-  for (; ; )
-    {
-      respsem = virtqueue_get_buffer_lock(vq, NULL, NULL, &priv->lock);
-      if (respsem == NULL)
-        {
-          break;
-        }
-
-      nxsem_post(respsem);
-    }
+  virtio_blk_reap(vq->vq_dev->priv, vq->vq_queue_index);
 }
 
 /****************************************************************************
@@ -504,33 +804,103 @@ static void virtio_blk_done(FAR struct virtqueue *vq)
 static int virtio_blk_init(FAR struct virtio_blk_priv_s *priv,
                            FAR struct virtio_device *vdev)
 {
-  FAR const char *vqname[1];
-  vq_callback callback[1];
+  FAR const char *vqname[VIRTIO_BLK_MAXQUEUES];
+  vq_callback callback[VIRTIO_BLK_MAXQUEUES];
+  uint16_t nqueues = 1;
+  uint32_t segmax = VIRTIO_BLK_MAXSEGS;
   int ret;
+  int i;
 
   priv->vdev = vdev;
   vdev->priv = priv;
-  spin_lock_init(&priv->lock);
 
   /* Initialize the virtio device */
 
   virtio_set_status(vdev, VIRTIO_CONFIG_STATUS_DRIVER);
-  virtio_negotiate_features(vdev, (1UL << VIRTIO_BLK_F_RO) |
+  virtio_negotiate_features(vdev, (1UL << VIRTIO_BLK_F_SIZE_MAX) |
+                                  (1UL << VIRTIO_BLK_F_SEG_MAX) |
+                                  (1UL << VIRTIO_BLK_F_RO) |
                                   (1UL << VIRTIO_BLK_F_BLK_SIZE) |
-                                  (1UL << VIRTIO_BLK_F_FLUSH), NULL);
+                                  (1UL << VIRTIO_BLK_F_FLUSH) |
+#if VIRTIO_BLK_MAXQUEUES > 1
+                                  (1UL << VIRTIO_BLK_F_MQ) |
+#endif
+                                  (1UL << VIRTIO_BLK_F_DISCARD) |
+                                  (1UL << VIRTIO_BLK_F_WRITE_ZEROES), NULL);
   virtio_set_status(vdev, VIRTIO_CONFIG_FEATURES_OK);
 
-  vqname[0]   = "virtio_blk_vq";
-  callback[0] = virtio_blk_done;
-  ret = virtio_create_virtqueues(vdev, 0, 1, vqname, callback, NULL);
+  /* One virtqueue for each CPU, up to the number the device has */
+
+  if (virtio_has_feature(vdev, VIRTIO_BLK_F_MQ))
+    {
+      virtio_read_config_member(vdev, struct virtio_blk_config_s,
+                                num_queues, &nqueues);
+      nqueues = MAX(MIN(nqueues, VIRTIO_BLK_MAXQUEUES), 1);
+    }
+
+  for (i = 0; i < nqueues; i++)
+    {
+      spin_lock_init(&priv->queues[i].lock);
+      sq_init(&priv->queues[i].pending);
+      vqname[i]   = "virtio_blk_vq";
+      callback[i] = virtio_blk_done;
+    }
+
+  priv->nqueues = nqueues;
+  ret = virtio_create_virtqueues(vdev, 0, nqueues, vqname, callback, NULL);
   if (ret < 0)
     {
       vrterr("virtio_device_create_virtqueue failed, ret=%d\n", ret);
       return ret;
     }
 
+  /* The size and number of the data segments of a request */
+
+  priv->sizemax = VIRTIO_BLK_SEGSIZE;
+  if (virtio_has_feature(vdev, VIRTIO_BLK_F_SIZE_MAX))
+    {
+      virtio_read_config_member(vdev, struct virtio_blk_config_s,
+                                size_max, &priv->sizemax);
+    }
+
+  if (virtio_has_feature(vdev, VIRTIO_BLK_F_SEG_MAX))
+    {
+      virtio_read_config_member(vdev, struct virtio_blk_config_s,
+                                seg_max, &segmax);
+    }
+
+  for (i = 0; i < nqueues; i++)
+    {
+      segmax = MIN(vdev->vrings_info[i].info.num_descs - 2, segmax);
+    }
+
+  priv->segmax = MAX(MIN(segmax, VIRTIO_BLK_MAXSEGS), 1);
+
+  /* The most sectors of a discard or write zeroes request */
+
+  priv->maxdiscard = UINT32_MAX;
+  priv->maxzeroes  = UINT32_MAX;
+  if (virtio_has_feature(vdev, VIRTIO_BLK_F_DISCARD))
+    {
+      virtio_read_config_member(vdev, struct virtio_blk_config_s,
+                                max_discard_sectors, &priv->maxdiscard);
+    }
+
+  if (virtio_has_feature(vdev, VIRTIO_BLK_F_WRITE_ZEROES))
+    {
+      virtio_read_config_member(vdev, struct virtio_blk_config_s,
+                                max_write_zeroes_sectors, &priv->maxzeroes);
+    }
+
+  priv->maxdiscard = MAX(priv->maxdiscard, 1);
+  priv->maxzeroes  = MAX(priv->maxzeroes, 1);
+
   virtio_set_status(vdev, VIRTIO_CONFIG_STATUS_DRIVER_OK);
-  virtqueue_enable_cb(vdev->vrings_info[0].vq);
+  for (i = 0; i < nqueues; i++)
+    {
+      virtqueue_enable_cb(vdev->vrings_info[i].vq);
+    }
+
   return ret;
 }
 
@@ -590,6 +960,12 @@ static int virtio_blk_probe(FAR struct virtio_device *vdev)
       priv->block_size = VIRTIO_BLK_SECTOR_SIZE;
     }
 
+  /* The most data of a read or write request, in whole blocks */
+
+  priv->maxlen = MIN((uint64_t)priv->segmax * priv->sizemax, UINT32_MAX) /
+                 priv->block_size * priv->block_size;
+  priv->maxlen = MAX(priv->maxlen, priv->block_size);
+
   /* Register block driver */
 
   snprintf(priv->name, NAME_MAX, "/dev/virtblk%d", g_virtio_blk_idx);
@@ -31,6 +31,7 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/net/ip.h>
 #include <nuttx/net/netdev_lowerhalf.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/virtio/virtio.h>
 #include <nuttx/net/wifi_sim.h>
 
@@ -42,20 +43,56 @@
 
 /* Virtio net feature bits */
 
-#define VIRTIO_NET_F_MAC      5
+#define VIRTIO_NET_F_CSUM       0
+#define VIRTIO_NET_F_GUEST_CSUM 1
+#define VIRTIO_NET_F_MAC        5
+#define VIRTIO_NET_F_MRG_RXBUF  15
+#define VIRTIO_NET_F_CTRL_VQ    17
+#define VIRTIO_NET_F_MQ         22
 
-/* Virtio net header size and packet buffer size */
+/* Virtio net header flags */
 
-#define VIRTIO_NET_HDRSIZE    (sizeof(struct virtio_net_hdr_s))
-#define VIRTIO_NET_LLHDRSIZE  (sizeof(struct virtio_net_llhdr_s))
-#define VIRTIO_NET_BUFSIZE    (CONFIG_NET_ETH_PKTSIZE + CONFIG_NET_GUARDSIZE)
+#define VIRTIO_NET_HDR_F_NEEDS_CSUM  1
+#define VIRTIO_NET_HDR_F_DATA_VALID  2
 
-/* Virtio net virtqueue index and number */
+/* Virtio net control command to set the number of queue pairs */
+
+#define VIRTIO_NET_CTRL_MQ              4
+#define VIRTIO_NET_CTRL_MQ_VQ_PAIRS_SET 0
+#define VIRTIO_NET_OK                   0
+
+/* Virtio net header size, with num_buffers if VIRTIO_NET_F_MRG_RXBUF is
+ * negotiated, and packet buffer size
+ */
+
+#define VIRTIO_NET_HDRSIZE     offsetof(struct virtio_net_hdr_s, num_buffers)
+#define VIRTIO_NET_MRG_HDRSIZE (sizeof(struct virtio_net_hdr_s))
+#define VIRTIO_NET_BUFSIZE     (CONFIG_NET_ETH_PKTSIZE + CONFIG_NET_GUARDSIZE)
+
+/* A mergeable RX buffer is the first IOB of a netpkt from the ethernet
+ * header on, a packet longer than that takes several of them.
+ */
+
+#define VIRTIO_NET_MRG_BUFSIZE \
+    (CONFIG_IOB_BUFSIZE - CONFIG_NET_LL_GUARDSIZE + ETH_HDRLEN)
+
+/* Virtio net virtqueue index and number of a queue pair, queue pair N uses
+ * the virtqueues N * VIRTIO_NET_NUM + VIRTIO_NET_RX / VIRTIO_NET_TX and
+ * the control virtqueue comes after the last pair.
+ */
 
 #define VIRTIO_NET_RX         0
 #define VIRTIO_NET_TX         1
 #define VIRTIO_NET_NUM        2
 
+#define VIRTIO_NET_VQ(pair, dir) ((pair) * VIRTIO_NET_NUM + (dir))
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+#  define VIRTIO_NET_MAXPAIRS CONFIG_DRIVERS_VIRTIO_NET_MAXPAIRS
+#else
+#  define VIRTIO_NET_MAXPAIRS 1
+#endif
+
 #define VIRTIO_NET_MAX_PKT_SIZE \
     ((CONFIG_NET_LL_GUARDSIZE - ETH_HDRLEN) + VIRTIO_NET_BUFSIZE)
 #define VIRTIO_NET_MAX_NIOB \
@@ -65,8 +102,8 @@
  * Private Types
  ****************************************************************************/
 
-/* Virtio net header, just define it here for further, now only use it
- * to calculate the virto net header size, see marco VIRTIO_NET_HDRSIZE
+/* Virtio net header, num_buffers is only part of it with
+ * VIRTIO_NET_F_MRG_RXBUF, see VIRTIO_NET_HDRSIZE and VIRTIO_NET_MRG_HDRSIZE
  */
 
 begin_packed_struct struct virtio_net_hdr_s
@@ -77,6 +114,7 @@ begin_packed_struct struct virtio_net_hdr_s
   uint16_t gso_size;
   uint16_t csum_start;
   uint16_t csum_offset;
+  uint16_t num_buffers;
 } end_packed_struct;
 
 /* The definition of the struct virtio_net_config refers to the link
@@ -97,6 +135,19 @@ begin_packed_struct struct virtio_net_config_s
   uint32_t supported_hash_types;
 } end_packed_struct;
 
+/* Virtio net control command setting the number of queue pairs, the
+ * device reads the class, command and pairs and writes the ack.
+ */
+
+struct virtio_net_ctrl_mq_s
+{
+  uint8_t  ctrl_class;
+  uint8_t  cmd;
+  uint16_t pairs;
+  uint8_t  ack;
+  sem_t    sem;
+};
+
 struct virtio_net_priv_s
 {
 #ifdef CONFIG_DRIVERS_WIFI_SIM
@@ -110,38 +161,45 @@ struct virtio_net_priv_s
   struct netdev_lowerhalf_s lower;     /* The netdev lowerhalf */
 #endif
 
-  spinlock_t                lock[VIRTIO_NET_NUM];
+  spinlock_t                lock[VIRTIO_NET_MAXPAIRS * VIRTIO_NET_NUM];
 
   /* Virtio device information */
 
   FAR struct virtio_device *vdev;      /* Virtio device pointer */
   int                       bufnum;    /* TX and RX Buffer number */
+  int                       rxbufnum;  /* Buffer number in each RX queue */
+  uint16_t                  rxbufsize; /* Size of a RX buffer */
+  uint8_t                   hdrsize;   /* Size of the virtio net header */
+  uint8_t                   npairs;    /* Number of queue pairs in use */
+
+  /* Buffers added to each RX queue, and TX queues to notify */
+
+  int                       rxbufs[VIRTIO_NET_MAXPAIRS];
+  bool                      txkick[VIRTIO_NET_MAXPAIRS];
 };
 
-/* Virtio Link Layer Header, follow shows the iob buffer layout:
+/* Virtio net header position, follow shows the iob buffer layout:
  *
  * |<-- CONFIG_NET_LL_GUARDSIZE -->|
- * +---------------+---------------+------------+------+     +-------------+
- * | Virtio Header |  ETH Header   |    data    | free | --> | next netpkt |
- * +---------------+---------------+------------+------+     +-------------+
- * |               |<--------- datalen -------->|
+ * +------+--------+---------------+------------+------+     +-------------+
+ * | free | Virtio |  ETH Header   |    data    | free | --> | next netpkt |
+ * |      | Header |               |            |      |     |             |
+ * +------+--------+---------------+------------+------+     +-------------+
+ *                 |<--------- datalen -------->|
  * ^base           ^data
  *
- * CONFIG_NET_LL_GUARDSIZE >= VIRTIO_NET_LLHDRSIZE + ETH_HDR_SIZE
- *                          = sizeof(uintptr) + 10 + 14
- *                          = 32 (64-Bit)
- *                          = 28 (32-Bit)
+ * CONFIG_NET_LL_GUARDSIZE >= VIRTIO_NET_MRG_HDRSIZE + ETH_HDRLEN
+ *                          = 12 + 14
+ *                          = 26
+ *
+ * The netpkt itself is the cookie of its virtqueue buffer.  With mergeable
+ * RX buffers, the device writes the data of the second and following
+ * buffers of a packet from where the header is in the first one.
  */
 
-begin_packed_struct struct virtio_net_llhdr_s
-{
-  FAR netpkt_t           *pkt;         /* Netpaket pointer */
-  struct virtio_net_hdr_s vhdr;        /* Virtio net header */
-} end_packed_struct;
-
-static_assert(CONFIG_NET_LL_GUARDSIZE >= VIRTIO_NET_LLHDRSIZE + ETH_HDRLEN,
+static_assert(CONFIG_NET_LL_GUARDSIZE >= VIRTIO_NET_MRG_HDRSIZE + ETH_HDRLEN,
               "CONFIG_NET_LL_GUARDSIZE cannot be less than ETH_HDRLEN"
-              " + VIRTIO_NET_LLHDRSIZE");
+              " + VIRTIO_NET_MRG_HDRSIZE");
 
 /****************************************************************************
  * Private Function Prototypes
@@ -163,6 +221,17 @@ static int virtio_net_ioctl(FAR struct netdev_lowerhalf_s *dev,
                             int cmd, unsigned long arg);
 #endif
 static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev);
+#ifdef CONFIG_NETDEV_NAPI
+static void virtio_net_rxirq(FAR struct netdev_lowerhalf_s *dev,
+                             bool enable);
+#endif
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+static int virtio_net_sendq(FAR struct netdev_lowerhalf_s *dev,
+                            FAR netpkt_t *pkt, int queue);
+static netpkt_t *virtio_net_recvq(FAR struct netdev_lowerhalf_s *dev,
+                                  int queue);
+#endif
+static void virtio_net_txflush(FAR struct netdev_lowerhalf_s *dev);
 
 static int  virtio_net_probe(FAR struct virtio_device *vdev);
 static void virtio_net_remove(FAR struct virtio_device *vdev);
@@ -192,7 +261,15 @@ static const struct netdev_ops_s g_virtio_net_ops =
 #ifdef CONFIG_NETDEV_IOCTL
   virtio_net_ioctl,
 #endif
-  virtio_net_txfree
+  virtio_net_txfree,
+#ifdef CONFIG_NETDEV_NAPI
+  virtio_net_rxirq,
+#endif
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  virtio_net_sendq,
+  virtio_net_recvq,
+#endif
+  virtio_net_txflush
 };
 
 #ifdef CONFIG_DRIVERS_WIFI_SIM
@@ -203,6 +280,19 @@ static uint8_t g_netdev_num = 0;
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: virtio_net_hdr
+ ****************************************************************************/
+
+static inline FAR struct virtio_net_hdr_s *
+virtio_net_hdr(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt)
+{
+  FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
+
+  return (FAR struct virtio_net_hdr_s *)
+           (netpkt_getdata(dev, pkt) - priv->hdrsize);
+}
+
 /****************************************************************************
  * Name: virtio_net_addbuffer
  ****************************************************************************/
@@ -212,7 +302,7 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
                                 unsigned int vq_id)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtio_net_llhdr_s *hdr;
+  FAR struct virtio_net_hdr_s *hdr;
   struct virtqueue_buf vb[VIRTIO_NET_MAX_NIOB + 1];
   struct iovec iov[VIRTIO_NET_MAX_NIOB];
   int iov_cnt;
@@ -222,13 +312,29 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
 
   iov_cnt = netpkt_to_iov(dev, pkt, iov, VIRTIO_NET_MAX_NIOB);
 
-  /* Alloc cookie and net header from transport layer */
+  /* Prepare the net header in front of the data */
 
-  hdr = (FAR struct virtio_net_llhdr_s *)
-          ((FAR uint8_t *)iov[0].iov_base - VIRTIO_NET_LLHDRSIZE);
+  hdr = virtio_net_hdr(dev, pkt);
   DEBUGASSERT((FAR uint8_t *)hdr >= netpkt_getbase(pkt));
-  memset(&hdr->vhdr, 0, sizeof(hdr->vhdr));
-  hdr->pkt = pkt;
+  memset(hdr, 0, priv->hdrsize);
+
+#ifdef CONFIG_NETDEV_CHKSUM_OFFLOAD
+  /* Let the device fill in the TCP/UDP checksum */
+
+  if (vq_id % VIRTIO_NET_NUM == VIRTIO_NET_TX &&
+      NETDEV_TXCSUM(&dev->netdev))
+    {
+      unsigned int start;
+      unsigned int offset;
+
+      if (netpkt_chksum_prepare(dev, pkt, &start, &offset) == OK)
+        {
+          hdr->flags       = VIRTIO_NET_HDR_F_NEEDS_CSUM;
+          hdr->csum_start  = start;
+          hdr->csum_offset = offset;
+        }
+    }
+#endif
 
   /* Prepare buffers depends on the feature VIRTIO_F_ANY_LAYOUT */
 
@@ -236,8 +342,8 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
     {
       /* Append the virtio net header to the first buffer */
 
-      vb[0].buf = &hdr->vhdr;
-      vb[0].len = iov[0].iov_len + VIRTIO_NET_HDRSIZE;
+      vb[0].buf = hdr;
+      vb[0].len = iov[0].iov_len + priv->hdrsize;
 
 #if VIRTIO_NET_MAX_NIOB > 1
       for (i = 1; i < iov_cnt; i++)
@@ -251,8 +357,8 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
     {
       /* Buffer 0 is only for virtio net header */
 
-      vb[0].buf = &hdr->vhdr;
-      vb[0].len = VIRTIO_NET_HDRSIZE;
+      vb[0].buf = hdr;
+      vb[0].len = priv->hdrsize;
 
       for (i = 0; i < iov_cnt; i++)
         {
@@ -263,15 +369,15 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
       iov_cnt++;
     }
 
-  vrtinfo("Fill vq=%u, hdr=%p, count=%d\n", vq_id, hdr, iov_cnt);
-  if (vq_id == VIRTIO_NET_RX)
+  vrtinfo("Fill vq=%u, pkt=%p, count=%d\n", vq_id, pkt, iov_cnt);
+  if (vq_id % VIRTIO_NET_NUM == VIRTIO_NET_RX)
     {
-      return virtqueue_add_buffer_lock(vq, vb, 0, iov_cnt, hdr,
+      return virtqueue_add_buffer_lock(vq, vb, 0, iov_cnt, pkt,
                                        &priv->lock[vq_id]);
     }
   else
     {
-      return virtqueue_add_buffer_lock(vq, vb, iov_cnt, 0, hdr,
+      return virtqueue_add_buffer_lock(vq, vb, iov_cnt, 0, pkt,
                                        &priv->lock[vq_id]);
     }
 }
@@ -280,14 +386,15 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
  * Name: virtio_net_rxfill
  ****************************************************************************/
 
-static void virtio_net_rxfill(FAR struct netdev_lowerhalf_s *dev)
+static void virtio_net_rxfill(FAR struct netdev_lowerhalf_s *dev, int pair)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_RX].vq;
+  unsigned int vq_id = VIRTIO_NET_VQ(pair, VIRTIO_NET_RX);
+  FAR struct virtqueue *vq = priv->vdev->vrings_info[vq_id].vq;
   FAR netpkt_t *pkt;
   int i;
 
-  for (i = 0; i < priv->bufnum; i++)
+  for (i = 0; priv->rxbufs[pair] < priv->rxbufnum; i++)
     {
       /* IOB Offload, Alloc buffer from RX netpkt */
 
@@ -300,8 +407,7 @@ static void virtio_net_rxfill(FAR struct netdev_lowerhalf_s *dev)
 
       /* Preserve data length */
 
-      if (netpkt_setdatalen(dev, pkt, VIRTIO_NET_BUFSIZE) <
-          VIRTIO_NET_BUFSIZE)
+      if (netpkt_setdatalen(dev, pkt, priv->rxbufsize) < priv->rxbufsize)
         {
           vrtwarn("No enough buffer to prepare RX buffer, i=%d\n", i);
           netpkt_free(dev, pkt, NETPKT_RX);
@@ -310,40 +416,101 @@ static void virtio_net_rxfill(FAR struct netdev_lowerhalf_s *dev)
 
       /* Add buffer to RX virtqueue */
 
-      virtio_net_addbuffer(dev, vq, pkt, VIRTIO_NET_RX);
+      if (virtio_net_addbuffer(dev, vq, pkt, vq_id) < 0)
+        {
+          netpkt_free(dev, pkt, NETPKT_RX);
+          break;
+        }
+
+      priv->rxbufs[pair]++;
     }
 
   if (i > 0)
     {
-      virtqueue_kick_lock(vq, &priv->lock[VIRTIO_NET_RX]);
+      virtqueue_kick_lock(vq, &priv->lock[vq_id]);
     }
 }
 
 /****************************************************************************
- * Name: virtio_net_txfree
+ * Name: virtio_net_txfreeq
  ****************************************************************************/
 
-static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev)
+static void virtio_net_txfreeq(FAR struct netdev_lowerhalf_s *dev, int pair)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_TX].vq;
-  FAR struct virtio_net_llhdr_s *hdr;
+  unsigned int vq_id = VIRTIO_NET_VQ(pair, VIRTIO_NET_TX);
+  FAR struct virtqueue *vq = priv->vdev->vrings_info[vq_id].vq;
+  FAR netpkt_t *pkt;
 
   while (1)
     {
       /* Get buffer from tx virtqueue */
 
-      hdr = virtqueue_get_buffer_lock(vq, NULL, NULL,
-                                      &priv->lock[VIRTIO_NET_TX]);
-      if (hdr == NULL)
+      pkt = virtqueue_get_buffer_lock(vq, NULL, NULL, &priv->lock[vq_id]);
+      if (pkt == NULL)
         {
           break;
         }
 
-      netpkt_free(dev, hdr->pkt, NETPKT_TX);
-      vrtinfo("Free, hdr: %p, pkt: %p\n", hdr, hdr->pkt);
+      netpkt_free(dev, pkt, NETPKT_TX);
+      vrtinfo("Free, pkt: %p\n", pkt);
+    }
+}
+
+/****************************************************************************
+ * Name: virtio_net_txfree
+ ****************************************************************************/
+
+static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev)
+{
+  FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
+  int i;
+
+  for (i = 0; i < priv->npairs; i++)
+    {
+      virtio_net_txfreeq(dev, i);
+    }
+}
+
+/****************************************************************************
+ * Name: virtio_net_rxirq
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_NAPI
+static void virtio_net_rxirq(FAR struct netdev_lowerhalf_s *dev,
+                             bool enable)
+{
+  FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
+  FAR struct virtqueue *vq;
+  unsigned int vq_id;
+  bool pending = false;
+  int i;
+
+  for (i = 0; i < priv->npairs; i++)
+    {
+      vq_id = VIRTIO_NET_VQ(i, VIRTIO_NET_RX);
+      vq    = priv->vdev->vrings_info[vq_id].vq;
+
+      if (!enable)
+        {
+          virtqueue_disable_cb_lock(vq, &priv->lock[vq_id]);
+        }
+      else if (virtqueue_enable_cb_lock(vq, &priv->lock[vq_id]) != 0)
+        {
+          pending = true;
+        }
+    }
+
+  /* Buffers used before the callback was re-enabled raise no callback
+   * with the event index, poll again for them.
+   */
+
+  if (pending)
+    {
+      netdev_lower_rxready(dev);
     }
 }
+#endif
 
 /****************************************************************************
  * Name: virtio_net_ifup
@@ -352,6 +519,8 @@ static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev)
 static int virtio_net_ifup(FAR struct netdev_lowerhalf_s *dev)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
+  unsigned int vq_id;
+  int i;
 
 #ifdef CONFIG_NET_IPv4
   vrtinfo("Bringing up: %u.%u.%u.%u\n",
@@ -368,9 +537,13 @@ static int virtio_net_ifup(FAR struct netdev_lowerhalf_s *dev)
 
   /* Prepare interrupt and packets for receiving */
 
-  virtqueue_enable_cb_lock(priv->vdev->vrings_info[VIRTIO_NET_RX].vq,
-                           &priv->lock[VIRTIO_NET_RX]);
-  virtio_net_rxfill(dev);
+  for (i = 0; i < priv->npairs; i++)
+    {
+      vq_id = VIRTIO_NET_VQ(i, VIRTIO_NET_RX);
+      virtqueue_enable_cb_lock(priv->vdev->vrings_info[vq_id].vq,
+                               &priv->lock[vq_id]);
+      virtio_net_rxfill(dev, i);
+    }
 
 #ifdef CONFIG_DRIVERS_WIFI_SIM
   if (priv->lower.wifi == NULL)
@@ -393,7 +566,7 @@ static int virtio_net_ifdown(FAR struct netdev_lowerhalf_s *dev)
 
   /* Disable the Ethernet interrupt */
 
-  for (i = 0; i < VIRTIO_NET_NUM; i++)
+  for (i = 0; i < priv->npairs * VIRTIO_NET_NUM; i++)
     {
       virtqueue_disable_cb_lock(priv->vdev->vrings_info[i].vq,
                                 &priv->lock[i]);
@@ -413,14 +586,16 @@ static int virtio_net_ifdown(FAR struct netdev_lowerhalf_s *dev)
 }
 
 /****************************************************************************
- * Name: virtio_net_send
+ * Name: virtio_net_sendq
  ****************************************************************************/
 
-static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
-                           FAR netpkt_t *pkt)
+static int virtio_net_sendq(FAR struct netdev_lowerhalf_s *dev,
+                            FAR netpkt_t *pkt, int queue)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_TX].vq;
+  unsigned int vq_id = VIRTIO_NET_VQ(queue, VIRTIO_NET_TX);
+  FAR struct virtqueue *vq = priv->vdev->vrings_info[vq_id].vq;
+  int ret;
 
   /* Check the send length */
 
@@ -430,65 +605,194 @@ static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
       return -EINVAL;
     }
 
-  /* Add buffer to vq and notify the other side */
+  /* Add buffer to vq, the other side is notified once for the whole batch
+   * by virtio_net_txflush().
+   */
+
+  ret = virtio_net_addbuffer(dev, vq, pkt, vq_id);
+  if (ret < 0)
+    {
+      return ret;
+    }
 
-  virtio_net_addbuffer(dev, vq, pkt, VIRTIO_NET_TX);
-  virtqueue_kick_lock(vq, &priv->lock[VIRTIO_NET_TX]);
+  priv->txkick[queue] = true;
 
   /* Try return Netpkt TX buffer to upper-half. */
 
-  virtio_net_txfree(dev);
+  virtio_net_txfreeq(dev, queue);
 
-  /* If we have no buffer left, enable TX done callback. */
+  /* If we have no buffer left, enable TX done callback.  With the event
+   * index, the buffers used before this do not raise it, take them now.
+   */
 
-  if (netdev_lower_quota_load(dev, NETPKT_TX) <= 0)
+  if (netdev_lower_quota_load(dev, NETPKT_TX) <= 0 &&
+      virtqueue_enable_cb_lock(vq, &priv->lock[vq_id]) != 0)
     {
-      virtqueue_enable_cb_lock(vq, &priv->lock[VIRTIO_NET_TX]);
+      virtio_net_txfreeq(dev, queue);
     }
 
   return OK;
 }
 
 /****************************************************************************
- * Name: virtio_net_recv
+ * Name: virtio_net_send
  ****************************************************************************/
 
-static netpkt_t *virtio_net_recv(FAR struct netdev_lowerhalf_s *dev)
+static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
+                           FAR netpkt_t *pkt)
+{
+  return virtio_net_sendq(dev, pkt, 0);
+}
+
+/****************************************************************************
+ * Name: virtio_net_txflush
+ ****************************************************************************/
+
+static void virtio_net_txflush(FAR struct netdev_lowerhalf_s *dev)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_RX].vq;
-  FAR struct virtio_net_llhdr_s *hdr;
-  irqstate_t flags;
-  uint32_t len;
+  unsigned int vq_id;
+  int i;
 
-  /* Fill the free Netpkt RX buffer to the RX virtqueue */
+  /* Notify the other side once of the buffers added since the last flush,
+   * which the event index may suppress too if it is still busy with them.
+   */
+
+  for (i = 0; i < priv->npairs; i++)
+    {
+      if (priv->txkick[i])
+        {
+          priv->txkick[i] = false;
+          vq_id = VIRTIO_NET_VQ(i, VIRTIO_NET_TX);
+          virtqueue_kick_lock(priv->vdev->vrings_info[vq_id].vq,
+                              &priv->lock[vq_id]);
+        }
+    }
+}
 
-  virtio_net_rxfill(dev);
+/****************************************************************************
+ * Name: virtio_net_rxmerge
+ *
+ * Description:
+ *   Append the other buffers of a packet received in several mergeable RX
+ *   buffers to its first one.
+ *
+ ****************************************************************************/
 
-  /* Get received buffer form RX virtqueue */
+static int virtio_net_rxmerge(FAR struct netdev_lowerhalf_s *dev,
+                              int queue, FAR netpkt_t *pkt, uint16_t num)
+{
+  FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
+  unsigned int vq_id = VIRTIO_NET_VQ(queue, VIRTIO_NET_RX);
+  FAR struct virtqueue *vq = priv->vdev->vrings_info[vq_id].vq;
+  FAR netpkt_t *next;
+  uint32_t len;
 
-  flags = spin_lock_irqsave(&priv->lock[VIRTIO_NET_RX]);
-  hdr = virtqueue_get_buffer(vq, &len, NULL);
-  if (hdr == NULL)
+  while (--num > 0)
     {
-      /* If we have no buffer left, enable RX callback. */
+      /* The device makes all the buffers of a packet used at once */
+
+      next = virtqueue_get_buffer_lock(vq, &len, NULL, &priv->lock[vq_id]);
+      if (next == NULL)
+        {
+          vrterr("Missing %u buffers of a merged packet\n", num);
+          return -EIO;
+        }
 
-      virtqueue_enable_cb(vq);
-      spin_unlock_irqrestore(&priv->lock[VIRTIO_NET_RX], flags);
+      priv->rxbufs[queue]--;
 
-      vrtinfo("get NULL buffer\n");
-      return NULL;
+      /* The data starts where the header is in the first buffer, and the
+       * netpkts merged into one count as one for the RX quota from now on.
+       */
+
+      next->io_offset -= NET_LL_HDRLEN(&dev->netdev) + priv->hdrsize;
+      next->io_len     = len;
+      next->io_pktlen  = len;
+      iob_concat(pkt, next);
+      atomic_fetch_add(&dev->quota[NETPKT_RX], 1);
     }
-  else
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: virtio_net_recvq
+ ****************************************************************************/
+
+static netpkt_t *virtio_net_recvq(FAR struct netdev_lowerhalf_s *dev,
+                                  int queue)
+{
+  FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
+  unsigned int vq_id = VIRTIO_NET_VQ(queue, VIRTIO_NET_RX);
+  FAR struct virtqueue *vq = priv->vdev->vrings_info[vq_id].vq;
+  FAR struct virtio_net_hdr_s *hdr;
+  FAR netpkt_t *pkt;
+  irqstate_t flags;
+  uint32_t len;
+
+  /* Fill the free Netpkt RX buffer to the RX virtqueue */
+
+  virtio_net_rxfill(dev, queue);
+
+  do
     {
-      spin_unlock_irqrestore(&priv->lock[VIRTIO_NET_RX], flags);
+      /* Get received buffer form RX virtqueue */
+
+      flags = spin_lock_irqsave(&priv->lock[vq_id]);
+      pkt = virtqueue_get_buffer(vq, &len, NULL);
+      if (pkt == NULL && virtqueue_enable_cb(vq) != 0)
+        {
+          /* We have no buffer left but enabling the RX callback found
+           * more, with the event index they would not raise it.
+           */
+
+          pkt = virtqueue_get_buffer(vq, &len, NULL);
+        }
+
+      spin_unlock_irqrestore(&priv->lock[vq_id], flags);
+
+      if (pkt == NULL)
+        {
+          vrtinfo("get NULL buffer\n");
+          return NULL;
+        }
+
+      priv->rxbufs[queue]--;
+
+      /* Set the received pkt length, then add the other buffers of it */
+
+      hdr = virtio_net_hdr(dev, pkt);
+      netpkt_setdatalen(dev, pkt, len - priv->hdrsize);
+
+      if (virtio_has_feature(priv->vdev, VIRTIO_NET_F_MRG_RXBUF) &&
+          hdr->num_buffers > 1 &&
+          virtio_net_rxmerge(dev, queue, pkt, hdr->num_buffers) < 0)
+        {
+          netpkt_free(dev, pkt, NETPKT_RX);
+          pkt = NULL;
+        }
     }
+  while (pkt == NULL);
 
-  /* Set the received pkt length */
+#ifdef CONFIG_NETDEV_CHKSUM_OFFLOAD
+  /* Only DATA_VALID says the device verified the checksum.  NEEDS_CSUM
+   * means the checksum field has not been filled in at all, so such a
+   * packet still goes through the software check.
+   */
 
-  netpkt_setdatalen(dev, hdr->pkt, len - VIRTIO_NET_HDRSIZE);
-  vrtinfo("Recv, hdr=%p, pkt=%p, len=%" PRIu32 "\n", hdr, hdr->pkt, len);
-  return hdr->pkt;
+  dev->netdev.d_rxcsum = (hdr->flags & VIRTIO_NET_HDR_F_DATA_VALID) != 0;
+#endif
+  vrtinfo("Recv, hdr=%p, pkt=%p, len=%" PRIu32 "\n", hdr, pkt, len);
+  return pkt;
+}
+
+/****************************************************************************
+ * Name: virtio_net_recv
+ ****************************************************************************/
+
+static netpkt_t *virtio_net_recv(FAR struct netdev_lowerhalf_s *dev)
+{
+  return virtio_net_recvq(dev, 0);
 }
 
 #ifdef CONFIG_NET_MCASTGROUP
@@ -533,7 +837,17 @@ static void virtio_net_rxready(FAR struct virtqueue *vq)
 {
   FAR struct virtio_net_priv_s *priv = vq->vq_dev->priv;
 
-  virtqueue_disable_cb_lock(vq, &priv->lock[VIRTIO_NET_RX]);
+  virtqueue_disable_cb_lock(vq, &priv->lock[vq->vq_queue_index]);
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (priv->npairs > 1)
+    {
+      netdev_lower_rxready_queue((FAR struct netdev_lowerhalf_s *)priv,
+                                 vq->vq_queue_index / VIRTIO_NET_NUM);
+      return;
+    }
+#endif
+
   netdev_lower_rxready((FAR struct netdev_lowerhalf_s *)priv);
 }
 
@@ -545,10 +859,74 @@ static void virtio_net_txdone(FAR struct virtqueue *vq)
 {
   FAR struct virtio_net_priv_s *priv = vq->vq_dev->priv;
 
-  virtqueue_disable_cb_lock(vq, &priv->lock[VIRTIO_NET_TX]);
+  virtqueue_disable_cb_lock(vq, &priv->lock[vq->vq_queue_index]);
   netdev_lower_txdone((FAR struct netdev_lowerhalf_s *)priv);
 }
 
+#if VIRTIO_NET_MAXPAIRS > 1
+/****************************************************************************
+ * Name: virtio_net_ctrldone
+ ****************************************************************************/
+
+static void virtio_net_ctrldone(FAR struct virtqueue *vq)
+{
+  FAR struct virtio_net_ctrl_mq_s *ctrl;
+
+  /* Only one command is sent at a time, when probing */
+
+  ctrl = virtqueue_get_buffer(vq, NULL, NULL);
+  if (ctrl != NULL)
+    {
+      nxsem_post(&ctrl->sem);
+    }
+}
+
+/****************************************************************************
+ * Name: virtio_net_setpairs
+ *
+ * Description:
+ *   Ask the device to use npairs queue pairs, with the control virtqueue
+ *   after the last of them.
+ *
+ ****************************************************************************/
+
+static int virtio_net_setpairs(FAR struct virtio_net_priv_s *priv,
+                               uint16_t npairs)
+{
+  FAR struct virtqueue *vq =
+    priv->vdev->vrings_info[npairs * VIRTIO_NET_NUM].vq;
+  struct virtio_net_ctrl_mq_s ctrl;
+  struct virtqueue_buf vb[3];
+  int ret;
+
+  ctrl.ctrl_class = VIRTIO_NET_CTRL_MQ;
+  ctrl.cmd        = VIRTIO_NET_CTRL_MQ_VQ_PAIRS_SET;
+  ctrl.pairs      = npairs;
+  ctrl.ack        = ~VIRTIO_NET_OK;
+  nxsem_init(&ctrl.sem, 0, 0);
+
+  /* The class and command, the data, then the ack from the device */
+
+  vb[0].buf = &ctrl.ctrl_class;
+  vb[0].len = 2;
+  vb[1].buf = &ctrl.pairs;
+  vb[1].len = sizeof(ctrl.pairs);
+  vb[2].buf = &ctrl.ack;
+  vb[2].len = sizeof(ctrl.ack);
+
+  ret = virtqueue_add_buffer(vq, vb, 2, 1, &ctrl);
+  if (ret >= 0)
+    {
+      virtqueue_kick(vq);
+      nxsem_wait_uninterruptible(&ctrl.sem);
+      ret = ctrl.ack == VIRTIO_NET_OK ? OK : -EIO;
+    }
+
+  nxsem_destroy(&ctrl.sem);
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: virtio_net_init
  ****************************************************************************/
@@ -556,12 +934,21 @@ static void virtio_net_txdone(FAR struct virtqueue *vq)
 static int virtio_net_init(FAR struct virtio_net_priv_s *priv,
                            FAR struct virtio_device *vdev)
 {
-  FAR const char *vqnames[VIRTIO_NET_NUM];
-  vq_callback callbacks[VIRTIO_NET_NUM];
+  FAR const char *vqnames[VIRTIO_NET_MAXPAIRS * VIRTIO_NET_NUM + 1];
+  vq_callback callbacks[VIRTIO_NET_MAXPAIRS * VIRTIO_NET_NUM + 1];
+  FAR struct virtio_vring_info *rx;
+  FAR struct virtio_vring_info *tx;
+  uint16_t npairs = 1;
+  int rxniob;
+  int nvqs;
   int ret;
+  int i;
+
+  for (i = 0; i < VIRTIO_NET_MAXPAIRS * VIRTIO_NET_NUM; i++)
+    {
+      spin_lock_init(&priv->lock[i]);
+    }
 
-  spin_lock_init(&priv->lock[VIRTIO_NET_RX]);
-  spin_lock_init(&priv->lock[VIRTIO_NET_TX]);
   priv->vdev = vdev;
   vdev->priv = priv;
 
@@ -569,15 +956,57 @@ static int virtio_net_init(FAR struct virtio_net_priv_s *priv,
 
   virtio_set_status(vdev, VIRTIO_CONFIG_STATUS_DRIVER);
   virtio_negotiate_features(vdev, (1UL << VIRTIO_NET_F_MAC) |
-                                  (1UL << VIRTIO_F_ANY_LAYOUT), NULL);
+#ifdef CONFIG_NETDEV_CHKSUM_OFFLOAD
+                                  (1UL << VIRTIO_NET_F_CSUM) |
+                                  (1UL << VIRTIO_NET_F_GUEST_CSUM) |
+#endif
+#if VIRTIO_NET_MAXPAIRS > 1
+                                  (1UL << VIRTIO_NET_F_CTRL_VQ) |
+                                  (1UL << VIRTIO_NET_F_MQ) |
+#endif
+                                  (1UL << VIRTIO_NET_F_MRG_RXBUF) |
+                                  (1UL << VIRTIO_F_ANY_LAYOUT) |
+                                  VIRTIO_RING_F_EVENT_IDX, NULL);
   virtio_set_status(vdev, VIRTIO_CONFIG_FEATURES_OK);
 
-  vqnames[VIRTIO_NET_RX]   = "virtio_net_rx";
-  vqnames[VIRTIO_NET_TX]   = "virtio_net_tx";
-  callbacks[VIRTIO_NET_RX] = virtio_net_rxready;
-  callbacks[VIRTIO_NET_TX] = virtio_net_txdone;
-  ret = virtio_create_virtqueues(vdev, 0, VIRTIO_NET_NUM, vqnames,
-                                 callbacks, NULL);
+#if VIRTIO_NET_MAXPAIRS > 1
+  /* Use all the queue pairs of the device if it has no more than we do,
+   * they all have to be created as the control virtqueue is behind them.
+   * Otherwise the device keeps using only the first one.
+   */
+
+  if (virtio_has_feature(vdev, VIRTIO_NET_F_MQ) &&
+      virtio_has_feature(vdev, VIRTIO_NET_F_CTRL_VQ))
+    {
+      virtio_read_config_member(vdev, struct virtio_net_config_s,
+                                max_virtqueue_pairs, &npairs);
+      if (npairs < 1 || npairs > VIRTIO_NET_MAXPAIRS)
+        {
+          vrtwarn("Use 1 of %u queue pairs\n", npairs);
+          npairs = 1;
+        }
+    }
+#endif
+
+  for (i = 0; i < npairs; i++)
+    {
+      vqnames[VIRTIO_NET_VQ(i, VIRTIO_NET_RX)]   = "virtio_net_rx";
+      vqnames[VIRTIO_NET_VQ(i, VIRTIO_NET_TX)]   = "virtio_net_tx";
+      callbacks[VIRTIO_NET_VQ(i, VIRTIO_NET_RX)] = virtio_net_rxready;
+      callbacks[VIRTIO_NET_VQ(i, VIRTIO_NET_TX)] = virtio_net_txdone;
+    }
+
+  nvqs = npairs * VIRTIO_NET_NUM;
+#if VIRTIO_NET_MAXPAIRS > 1
+  if (npairs > 1)
+    {
+      vqnames[nvqs]   = "virtio_net_ctrl";
+      callbacks[nvqs] = virtio_net_ctrldone;
+      nvqs++;
+    }
+#endif
+
+  ret = virtio_create_virtqueues(vdev, 0, nvqs, vqnames, callbacks, NULL);
   if (ret < 0)
     {
       vrterr("virtio_device_create_virtqueue failed, ret=%d\n", ret);
@@ -586,6 +1015,37 @@ static int virtio_net_init(FAR struct virtio_net_priv_s *priv,
 
   virtio_set_status(vdev, VIRTIO_CONFIG_STATUS_DRIVER_OK);
 
+#if VIRTIO_NET_MAXPAIRS > 1
+  if (npairs > 1)
+    {
+      ret = virtio_net_setpairs(priv, npairs);
+      if (ret < 0)
+        {
+          vrtwarn("Set %u queue pairs failed, ret=%d\n", npairs, ret);
+          npairs = 1;
+        }
+    }
+#endif
+
+  priv->npairs = npairs;
+
+  /* The header has num_buffers with mergeable RX buffers, which are one
+   * IOB each instead of a whole packet.
+   */
+
+  if (virtio_has_feature(vdev, VIRTIO_NET_F_MRG_RXBUF))
+    {
+      priv->hdrsize   = VIRTIO_NET_MRG_HDRSIZE;
+      priv->rxbufsize = VIRTIO_NET_MRG_BUFSIZE;
+      rxniob          = 1;
+    }
+  else
+    {
+      priv->hdrsize   = VIRTIO_NET_HDRSIZE;
+      priv->rxbufsize = VIRTIO_NET_BUFSIZE;
+      rxniob          = VIRTIO_NET_MAX_NIOB;
+    }
+
 #if CONFIG_DRIVERS_VIRTIO_NET_BUFNUM > 0
   priv->bufnum = CONFIG_DRIVERS_VIRTIO_NET_BUFNUM;
 #else
@@ -595,10 +1055,23 @@ static int virtio_net_init(FAR struct virtio_net_priv_s *priv,
 
   priv->bufnum = CONFIG_IOB_NBUFFERS / VIRTIO_NET_MAX_NIOB / 4;
 #endif
-  priv->bufnum = MIN(vdev->vrings_info[VIRTIO_NET_RX].info.num_descs /
-                     (VIRTIO_NET_MAX_NIOB + 1), priv->bufnum);
-  priv->bufnum = MIN(vdev->vrings_info[VIRTIO_NET_TX].info.num_descs /
-                     (VIRTIO_NET_MAX_NIOB + 1), priv->bufnum);
+
+  /* The RX buffers take the same IOBs whatever their size, and are shared
+   * by the RX queues.  Every TX queue may get all the TX buffers.
+   */
+
+  priv->rxbufnum = MAX(priv->bufnum * VIRTIO_NET_MAX_NIOB / rxniob /
+                       npairs, 1);
+  for (i = 0; i < npairs; i++)
+    {
+      rx = &vdev->vrings_info[VIRTIO_NET_VQ(i, VIRTIO_NET_RX)];
+      tx = &vdev->vrings_info[VIRTIO_NET_VQ(i, VIRTIO_NET_TX)];
+      priv->rxbufnum = MIN(rx->info.num_descs / (rxniob + 1),
+                           priv->rxbufnum);
+      priv->bufnum   = MIN(tx->info.num_descs / (VIRTIO_NET_MAX_NIOB + 1),
+                           priv->bufnum);
+    }
+
   return OK;
 }
 
@@ -666,10 +1139,27 @@ static int virtio_net_probe(FAR struct virtio_device *vdev)
   /* Initialize the netdev lower half */
 
   netdev = (FAR struct netdev_lowerhalf_s *)priv;
-  netdev->quota[NETPKT_RX] = priv->bufnum;
+  netdev->quota[NETPKT_RX] = priv->rxbufnum * priv->npairs;
   netdev->quota[NETPKT_TX] = priv->bufnum;
   netdev->ops = &g_virtio_net_ops;
 
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  netdev->rxqueues = priv->npairs;
+  netdev->txqueues = priv->npairs;
+#endif
+
+#ifdef CONFIG_NETDEV_CHKSUM_OFFLOAD
+  if (virtio_has_feature(vdev, VIRTIO_NET_F_CSUM))
+    {
+      netdev->netdev.d_features |= NETDEV_F_TXCSUM;
+    }
+
+  if (virtio_has_feature(vdev, VIRTIO_NET_F_GUEST_CSUM))
+    {
+      netdev->netdev.d_features |= NETDEV_F_RXCSUM;
+    }
+#endif
+
 #ifdef CONFIG_DRIVERS_WIFI_SIM
   /* If the WiFi interfaces has reached the setting value,
    * no more WiFi interfaces will be created.
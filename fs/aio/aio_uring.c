@@ -0,0 +1,946 @@
+/****************************************************************************
+ * fs/aio/aio_uring.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/socket.h>
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <string.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/uring.h>
+#include <nuttx/mutex.h>
+#include <nuttx/net/net.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
+
+#include "fs_heap.h"
+
+#ifdef CONFIG_FS_AIO_URING
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The state of a request taken from the SQ */
+
+enum uring_state_e
+{
+  URING_FREE = 0,             /* In the free list */
+  URING_BUSY,                 /* Being executed */
+  URING_ARMED                 /* Waiting for poll events of its file */
+};
+
+struct uring_s;
+struct uring_op_s
+{
+  FAR struct uring_op_s *flink; /* Free list or ready list */
+  FAR struct uring_s *ring;     /* The ring of the request */
+  FAR struct file *filep;       /* The file of the request, if any */
+  struct uring_sqe_s sqe;       /* Copy of the submission entry */
+  struct pollfd fds;            /* Used while URING_ARMED */
+  uint8_t state;                /* See enum uring_state_e */
+  bool fixed;                   /* filep is a registered file */
+  bool queued;                  /* In the ready list */
+};
+
+struct uring_s
+{
+  mutex_t lock;                 /* Serializes URINGIOC_* */
+  sem_t waitsem;                /* Posted when a request becomes ready */
+  spinlock_t readylock;         /* Protects the ready list */
+  FAR struct uring_op_s *readyhead;
+  FAR struct uring_op_s *readytail;
+
+  /* The application's rings.  The kernel keeps its own SQ head and CQ
+   * tail, the application only writes the SQ tail and the CQ head.
+   */
+
+  FAR struct uring_ring_s *sq;
+  FAR struct uring_sqe_s *sqes;
+  FAR struct uring_ring_s *cq;
+  FAR struct uring_cqe_s *cqes;
+  uint32_t sqmask;
+  uint32_t cqmask;
+  uint32_t sqhead;
+  uint32_t cqtail;
+
+  /* One request per CQ entry, so that a completion always has room */
+
+  FAR struct uring_op_s *ops;
+  FAR struct uring_op_s *freelist;
+  uint32_t inflight;
+
+  /* Registered files and buffers */
+
+  FAR struct file **files;
+  unsigned int nfiles;
+  FAR struct iovec *bufs;
+  unsigned int nbufs;
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int uring_open(FAR struct file *filep);
+static int uring_close(FAR struct file *filep);
+static int uring_ioctl(FAR struct file *filep, int cmd, unsigned long arg);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_uring_fops =
+{
+  uring_open,   /* open */
+  uring_close,  /* close */
+  NULL,         /* read */
+  NULL,         /* write */
+  NULL,         /* seek */
+  uring_ioctl,  /* ioctl */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: uring_pollcb
+ *
+ * Description:
+ *   Poll callback of a URING_ARMED request, may run in interrupt context.
+ *   The request is only queued here and handled by URINGIOC_ENTER.
+ *
+ ****************************************************************************/
+
+static void uring_pollcb(FAR struct pollfd *fds)
+{
+  FAR struct uring_op_s *op = fds->arg;
+  FAR struct uring_s *ring = op->ring;
+  irqstate_t flags;
+  bool post = false;
+
+  flags = spin_lock_irqsave(&ring->readylock);
+  if (!op->queued)
+    {
+      op->queued = true;
+      op->flink  = NULL;
+      if (ring->readytail != NULL)
+        {
+          ring->readytail->flink = op;
+        }
+      else
+        {
+          ring->readyhead = op;
+        }
+
+      ring->readytail = op;
+      post = true;
+    }
+
+  spin_unlock_irqrestore(&ring->readylock, flags);
+
+  if (post)
+    {
+      nxsem_post(&ring->waitsem);
+    }
+}
+
+/****************************************************************************
+ * Name: uring_unqueue
+ *
+ * Description:
+ *   Remove a request from the ready list, if a late poll callback put it
+ *   there.
+ *
+ ****************************************************************************/
+
+static void uring_unqueue(FAR struct uring_s *ring,
+                          FAR struct uring_op_s *op)
+{
+  FAR struct uring_op_s *prev = NULL;
+  FAR struct uring_op_s *curr;
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&ring->readylock);
+  if (op->queued)
+    {
+      for (curr = ring->readyhead; curr != op; curr = curr->flink)
+        {
+          prev = curr;
+        }
+
+      if (prev != NULL)
+        {
+          prev->flink = op->flink;
+        }
+      else
+        {
+          ring->readyhead = op->flink;
+        }
+
+      if (ring->readytail == op)
+        {
+          ring->readytail = prev;
+        }
+
+      op->queued = false;
+    }
+
+  spin_unlock_irqrestore(&ring->readylock, flags);
+}
+
+/****************************************************************************
+ * Name: uring_complete
+ *
+ * Description:
+ *   Post the result of a request to the CQ and free the request.
+ *
+ ****************************************************************************/
+
+static void uring_complete(FAR struct uring_s *ring,
+                           FAR struct uring_op_s *op, int res)
+{
+  FAR struct uring_cqe_s *cqe = &ring->cqes[ring->cqtail & ring->cqmask];
+
+  cqe->userdata = op->sqe.userdata;
+  cqe->res      = res;
+  cqe->flags    = 0;
+
+  /* The entry must be visible before the new tail */
+
+  SP_DMB();
+  ring->cq->tail = ++ring->cqtail;
+
+  if (op->filep != NULL && !op->fixed)
+    {
+      fs_putfilep(op->filep);
+    }
+
+  uring_unqueue(ring, op);
+
+  op->filep      = NULL;
+  op->state      = URING_FREE;
+  op->flink      = ring->freelist;
+  ring->freelist = op;
+  ring->inflight--;
+}
+
+/****************************************************************************
+ * Name: uring_arm
+ *
+ * Description:
+ *   Let the request wait for 'events' on its file.  Returns -ENOSYS if the
+ *   file cannot be polled.
+ *
+ ****************************************************************************/
+
+static int uring_arm(FAR struct uring_op_s *op, pollevent_t events)
+{
+  int ret;
+
+  op->fds.fd      = -1;
+  op->fds.events  = events;
+  op->fds.revents = 0;
+  op->fds.arg     = op;
+  op->fds.cb      = uring_pollcb;
+  op->fds.priv    = NULL;
+  op->state       = URING_ARMED;
+
+  ret = file_poll(op->filep, &op->fds, true);
+  if (ret < 0)
+    {
+      op->state = URING_BUSY;
+      uring_unqueue(op->ring, op);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: uring_rw
+ ****************************************************************************/
+
+static ssize_t uring_rw(FAR struct uring_op_s *op)
+{
+  FAR struct uring_sqe_s *sqe = &op->sqe;
+
+  if (sqe->opcode == URING_OP_READ)
+    {
+      return sqe->off < 0 ?
+             file_read(op->filep, sqe->addr, sqe->len) :
+             file_pread(op->filep, sqe->addr, sqe->len, sqe->off);
+    }
+
+  return sqe->off < 0 ?
+         file_write(op->filep, sqe->addr, sqe->len) :
+         file_pwrite(op->filep, sqe->addr, sqe->len, sqe->off);
+}
+
+/****************************************************************************
+ * Name: uring_accept
+ ****************************************************************************/
+
+#ifdef CONFIG_NET
+static int uring_accept(FAR struct uring_op_s *op)
+{
+  FAR struct uring_sqe_s *sqe = &op->sqe;
+  FAR struct socket *newsock;
+  int oflags = O_RDWR;
+  int ret;
+
+  if ((sqe->msgflags & ~(SOCK_NONBLOCK | SOCK_CLOEXEC)) != 0)
+    {
+      return -EINVAL;
+    }
+
+  newsock = fs_heap_zalloc(sizeof(*newsock));
+  if (newsock == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ret = psock_accept(file_socket(op->filep), sqe->addr, sqe->addrlen,
+                     newsock, sqe->msgflags);
+  if (ret < 0)
+    {
+      fs_heap_free(newsock);
+      return ret;
+    }
+
+  if ((sqe->msgflags & SOCK_CLOEXEC) != 0)
+    {
+      oflags |= O_CLOEXEC;
+    }
+
+  if ((sqe->msgflags & SOCK_NONBLOCK) != 0)
+    {
+      oflags |= O_NONBLOCK;
+    }
+
+  ret = sockfd_allocate(newsock, oflags);
+  if (ret < 0)
+    {
+      psock_close(newsock);
+      fs_heap_free(newsock);
+    }
+
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: uring_run
+ *
+ * Description:
+ *   Execute a request, either right after its submission or after its
+ *   file became ready.  The request is completed unless it has to wait for
+ *   its file.
+ *
+ ****************************************************************************/
+
+static void uring_run(FAR struct uring_s *ring, FAR struct uring_op_s *op,
+                      bool ready)
+{
+  FAR struct uring_sqe_s *sqe = &op->sqe;
+  pollevent_t events = POLLIN;
+  int ret;
+
+  switch (sqe->opcode)
+    {
+      case URING_OP_NOP:
+        ret = OK;
+        break;
+
+      case URING_OP_FSYNC:
+        ret = file_fsync(op->filep);
+        break;
+
+      case URING_OP_POLL:
+        if (ready)
+          {
+            ret = op->fds.revents;
+            break;
+          }
+
+        ret = uring_arm(op, sqe->len);
+        if (ret >= 0)
+          {
+            return;
+          }
+
+        break;
+
+      case URING_OP_WRITE:
+        events = POLLOUT;
+
+        /* Fall through */
+
+      case URING_OP_READ:
+        {
+          FAR struct inode *inode = op->filep->f_inode;
+
+          /* Regular files and block devices are always ready.  Anything
+           * else is only read or written once polled ready, unless it is
+           * nonblocking anyway.
+           */
+
+          if (!ready && !INODE_IS_MOUNTPT(inode) &&
+              !INODE_IS_BLOCK(inode) && !INODE_IS_MTD(inode) &&
+              (op->filep->f_oflags & O_NONBLOCK) == 0)
+            {
+              ret = uring_arm(op, events);
+              if (ret >= 0)
+                {
+                  return;
+                }
+            }
+
+          ret = uring_rw(op);
+          if (ret == -EAGAIN && uring_arm(op, events) >= 0)
+            {
+              return;
+            }
+        }
+        break;
+
+#ifdef CONFIG_NET
+      case URING_OP_SEND:
+        events = POLLOUT;
+
+        /* Fall through */
+
+      case URING_OP_RECV:
+        {
+          FAR struct socket *psock = file_socket(op->filep);
+
+          if (psock == NULL)
+            {
+              ret = -ENOTSOCK;
+              break;
+            }
+
+          ret = sqe->opcode == URING_OP_SEND ?
+                psock_send(psock, sqe->addr, sqe->len,
+                           sqe->msgflags | MSG_DONTWAIT) :
+                psock_recv(psock, sqe->addr, sqe->len,
+                           sqe->msgflags | MSG_DONTWAIT);
+          if (ret == -EAGAIN && uring_arm(op, events) >= 0)
+            {
+              return;
+            }
+        }
+        break;
+
+      case URING_OP_ACCEPT:
+        if (file_socket(op->filep) == NULL)
+          {
+            ret = -ENOTSOCK;
+            break;
+          }
+
+        /* Wait for a pending connection first, so that accept does not
+         * block.
+         */
+
+        if (!ready && uring_arm(op, POLLIN) >= 0)
+          {
+            return;
+          }
+
+        ret = uring_accept(op);
+        if (ret == -EAGAIN && uring_arm(op, POLLIN) >= 0)
+          {
+            return;
+          }
+
+        break;
+#endif
+
+      default:
+        ret = -EINVAL;
+        break;
+    }
+
+  uring_complete(ring, op, ret);
+}
+
+/****************************************************************************
+ * Name: uring_process
+ *
+ * Description:
+ *   Run the requests whose files became ready.
+ *
+ ****************************************************************************/
+
+static void uring_process(FAR struct uring_s *ring)
+{
+  for (; ; )
+    {
+      FAR struct uring_op_s *op;
+      irqstate_t flags;
+
+      flags = spin_lock_irqsave(&ring->readylock);
+      op = ring->readyhead;
+      if (op != NULL)
+        {
+          ring->readyhead = op->flink;
+          if (ring->readyhead == NULL)
+            {
+              ring->readytail = NULL;
+            }
+
+          op->queued = false;
+        }
+
+      spin_unlock_irqrestore(&ring->readylock, flags);
+
+      if (op == NULL)
+        {
+          break;
+        }
+
+      if (op->state == URING_ARMED)
+        {
+          file_poll(op->filep, &op->fds, false);
+          op->state = URING_BUSY;
+          uring_unqueue(ring, op);
+          uring_run(ring, op, true);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: uring_submit
+ *
+ * Description:
+ *   Take one entry from the SQ and start it.
+ *
+ ****************************************************************************/
+
+static void uring_submit(FAR struct uring_s *ring)
+{
+  FAR struct uring_op_s *op = ring->freelist;
+  FAR struct uring_sqe_s *sqe;
+  int ret = OK;
+
+  DEBUGASSERT(op != NULL);
+  ring->freelist = op->flink;
+  ring->inflight++;
+
+  sqe = &op->sqe;
+  memcpy(sqe, &ring->sqes[ring->sqhead & ring->sqmask], sizeof(*sqe));
+  ring->sq->head = ++ring->sqhead;
+
+  op->state = URING_BUSY;
+  op->fixed = (sqe->flags & URING_SQE_FIXED_FILE) != 0;
+
+  if ((sqe->flags & URING_SQE_FIXED_BUF) != 0)
+    {
+      FAR uint8_t *addr = sqe->addr;
+      FAR uint8_t *base;
+
+      if (sqe->bufindex >= ring->nbufs)
+        {
+          ret = -EFAULT;
+        }
+      else
+        {
+          base = ring->bufs[sqe->bufindex].iov_base;
+          if (addr < base ||
+              addr + sqe->len > base + ring->bufs[sqe->bufindex].iov_len)
+            {
+              ret = -EFAULT;
+            }
+        }
+    }
+
+  if (ret >= 0 && sqe->opcode != URING_OP_NOP)
+    {
+      if (op->fixed)
+        {
+          if (sqe->fd < 0 || (unsigned int)sqe->fd >= ring->nfiles)
+            {
+              ret = -EBADF;
+            }
+          else
+            {
+              op->filep = ring->files[sqe->fd];
+            }
+        }
+      else
+        {
+          ret = fs_getfilep(sqe->fd, &op->filep);
+          if (ret < 0)
+            {
+              op->filep = NULL;
+            }
+        }
+    }
+
+  if (ret < 0)
+    {
+      uring_complete(ring, op, ret);
+    }
+  else
+    {
+      uring_run(ring, op, false);
+    }
+}
+
+/****************************************************************************
+ * Name: uring_enter
+ ****************************************************************************/
+
+static int uring_enter(FAR struct uring_s *ring,
+                       FAR const struct uring_enter_s *enter)
+{
+  uint32_t submitted = 0;
+  int ret;
+
+  if (ring->ops == NULL)
+    {
+      return -EINVAL;
+    }
+
+  uring_process(ring);
+
+  /* Submit what there is in the SQ, as long as the completions will fit
+   * in the CQ.
+   */
+
+  while (submitted < enter->to_submit && ring->sq->tail != ring->sqhead)
+    {
+      uint32_t used = ring->cqtail - ring->cq->head;
+
+      if (used > ring->cqmask + 1 ||
+          ring->sq->tail - ring->sqhead > ring->sqmask + 1)
+        {
+          return -EINVAL;
+        }
+
+      if (used + ring->inflight > ring->cqmask)
+        {
+          break;
+        }
+
+      SP_DMB();
+      uring_submit(ring);
+      submitted++;
+    }
+
+  /* Pick up the requests whose files were ready right away */
+
+  uring_process(ring);
+
+  while (ring->cqtail - ring->cq->head < enter->min_complete &&
+         ring->inflight > 0)
+    {
+      nxmutex_unlock(&ring->lock);
+      ret = nxsem_wait(&ring->waitsem);
+      nxmutex_lock(&ring->lock);
+      if (ret < 0)
+        {
+          return submitted > 0 ? submitted : ret;
+        }
+
+      uring_process(ring);
+    }
+
+  return submitted;
+}
+
+/****************************************************************************
+ * Name: uring_setup
+ ****************************************************************************/
+
+static int uring_setup(FAR struct uring_s *ring,
+                       FAR const struct uring_params_s *params)
+{
+  uint32_t i;
+
+  if (ring->ops != NULL)
+    {
+      return -EBUSY;
+    }
+
+  if (params->sq_entries == 0 || params->cq_entries == 0 ||
+      (params->sq_entries & (params->sq_entries - 1)) != 0 ||
+      (params->cq_entries & (params->cq_entries - 1)) != 0 ||
+      params->sq == NULL || params->sqes == NULL ||
+      params->cq == NULL || params->cqes == NULL)
+    {
+      return -EINVAL;
+    }
+
+  ring->ops = fs_heap_zalloc(params->cq_entries * sizeof(*ring->ops));
+  if (ring->ops == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  for (i = 0; i < params->cq_entries; i++)
+    {
+      ring->ops[i].ring  = ring;
+      ring->ops[i].flink = ring->freelist;
+      ring->freelist     = &ring->ops[i];
+    }
+
+  ring->sq     = params->sq;
+  ring->sqes   = params->sqes;
+  ring->cq     = params->cq;
+  ring->cqes   = params->cqes;
+  ring->sqmask = params->sq_entries - 1;
+  ring->cqmask = params->cq_entries - 1;
+  ring->sqhead = ring->sq->tail;
+  ring->cqtail = ring->cq->head;
+
+  ring->sq->head = ring->sqhead;
+  ring->cq->tail = ring->cqtail;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: uring_unregfiles
+ ****************************************************************************/
+
+static void uring_unregfiles(FAR struct uring_s *ring)
+{
+  while (ring->nfiles > 0)
+    {
+      fs_putfilep(ring->files[--ring->nfiles]);
+    }
+
+  fs_heap_free(ring->files);
+  ring->files = NULL;
+}
+
+/****************************************************************************
+ * Name: uring_regfiles
+ ****************************************************************************/
+
+static int uring_regfiles(FAR struct uring_s *ring,
+                          FAR const struct uring_files_s *files)
+{
+  FAR struct file **filep = NULL;
+  unsigned int i;
+  int ret;
+
+  /* The requests in flight may use the registered files */
+
+  if (ring->inflight > 0)
+    {
+      return -EBUSY;
+    }
+
+  if (files->nfds > 0)
+    {
+      if (files->fds == NULL)
+        {
+          return -EINVAL;
+        }
+
+      filep = fs_heap_malloc(files->nfds * sizeof(*filep));
+      if (filep == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      for (i = 0; i < files->nfds; i++)
+        {
+          ret = fs_getfilep(files->fds[i], &filep[i]);
+          if (ret < 0)
+            {
+              while (i > 0)
+                {
+                  fs_putfilep(filep[--i]);
+                }
+
+              fs_heap_free(filep);
+              return ret;
+            }
+        }
+    }
+
+  uring_unregfiles(ring);
+  ring->files  = filep;
+  ring->nfiles = files->nfds;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: uring_regbufs
+ ****************************************************************************/
+
+static int uring_regbufs(FAR struct uring_s *ring,
+                         FAR const struct uring_bufs_s *bufs)
+{
+  FAR struct iovec *iov = NULL;
+
+  if (bufs->nbufs > 0)
+    {
+      if (bufs->iov == NULL || bufs->nbufs > UINT16_MAX + 1)
+        {
+          return -EINVAL;
+        }
+
+      iov = fs_heap_malloc(bufs->nbufs * sizeof(*iov));
+      if (iov == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      memcpy(iov, bufs->iov, bufs->nbufs * sizeof(*iov));
+    }
+
+  fs_heap_free(ring->bufs);
+  ring->bufs  = iov;
+  ring->nbufs = bufs->nbufs;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: uring_open
+ ****************************************************************************/
+
+static int uring_open(FAR struct file *filep)
+{
+  FAR struct uring_s *ring;
+
+  ring = fs_heap_zalloc(sizeof(*ring));
+  if (ring == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  nxmutex_init(&ring->lock);
+  nxsem_init(&ring->waitsem, 0, 0);
+  spin_lock_init(&ring->readylock);
+
+  filep->f_priv = ring;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: uring_close
+ ****************************************************************************/
+
+static int uring_close(FAR struct file *filep)
+{
+  FAR struct uring_s *ring = filep->f_priv;
+  uint32_t i;
+
+  /* Cancel the requests still waiting for their files */
+
+  for (i = 0; ring->ops != NULL && i <= ring->cqmask; i++)
+    {
+      FAR struct uring_op_s *op = &ring->ops[i];
+
+      if (op->state == URING_ARMED)
+        {
+          file_poll(op->filep, &op->fds, false);
+          op->state = URING_BUSY;
+          uring_complete(ring, op, -ECANCELED);
+        }
+    }
+
+  uring_unregfiles(ring);
+  fs_heap_free(ring->bufs);
+  fs_heap_free(ring->ops);
+
+  nxsem_destroy(&ring->waitsem);
+  nxmutex_destroy(&ring->lock);
+  fs_heap_free(ring);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: uring_ioctl
+ ****************************************************************************/
+
+static int uring_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
+{
+  FAR struct uring_s *ring = filep->f_priv;
+  int ret;
+
+  if (arg == 0)
+    {
+      return -EINVAL;
+    }
+
+  ret = nxmutex_lock(&ring->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  switch (cmd)
+    {
+      case URINGIOC_SETUP:
+        ret = uring_setup(ring, (FAR const struct uring_params_s *)arg);
+        break;
+
+      case URINGIOC_ENTER:
+        ret = uring_enter(ring, (FAR const struct uring_enter_s *)arg);
+        break;
+
+      case URINGIOC_REGFILES:
+        ret = uring_regfiles(ring, (FAR const struct uring_files_s *)arg);
+        break;
+
+      case URINGIOC_REGBUFS:
+        ret = uring_regbufs(ring, (FAR const struct uring_bufs_s *)arg);
+        break;
+
+      default:
+        ret = -ENOTTY;
+        break;
+    }
+
+  nxmutex_unlock(&ring->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: uring_register
+ *
+ * Description:
+ *   Register /dev/uring
+ *
+ ****************************************************************************/
+
+void uring_register(void)
+{
+  register_driver("/dev/uring", &g_uring_fops, 0666, NULL);
+}
+
+#endif /* CONFIG_FS_AIO_URING */
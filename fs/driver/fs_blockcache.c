@@ -0,0 +1,898 @@
+/****************************************************************************
+ * fs/driver/fs_blockcache.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include <debug.h>
+#include <sys/mount.h>
+#include <sys/param.h>
+#include <sys/stat.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
+#include <nuttx/list.h>
+#include <nuttx/mutex.h>
+#include <nuttx/wqueue.h>
+
+#include "driver/driver.h"
+#include "inode/inode.h"
+#include "fs_heap.h"
+
+#ifdef CONFIG_FS_BLOCKCACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if defined(CONFIG_FS_BLOCKCACHE_WRDELAY) && CONFIG_FS_BLOCKCACHE_WRDELAY > 0
+#  define BCACHE_WRDELAY MSEC2TICK(CONFIG_FS_BLOCKCACHE_WRDELAY)
+#endif
+
+/* The scratch buffer is used for read-ahead and to write back consecutive
+ * dirty sectors at once, so it holds at least this many sectors.
+ */
+
+#define BCACHE_MINSCRATCH 8
+
+/* The sector of an unused entry */
+
+#define BCACHE_NOSECTOR  ((blkcnt_t)-1)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One cached sector */
+
+struct bcache_entry_s
+{
+  struct list_node lru;                    /* In the LRU list, newest first */
+  FAR struct bcache_entry_s *hnext;        /* Next entry in the hash chain */
+  blkcnt_t sector;                         /* Or BCACHE_NOSECTOR */
+  bool dirty;                              /* Not written to the parent yet */
+  FAR uint8_t *data;
+};
+
+struct bcache_dev_s
+{
+  FAR struct inode *parent;                /* The cached block device */
+  mutex_t lock;
+  size_t sectorsize;
+  blkcnt_t nsectors;                       /* Sectors of the parent */
+  unsigned int nentries;                   /* Sectors that fit the cache */
+  unsigned int hashmask;
+  unsigned int ndirty;
+  unsigned int nscratch;                   /* Sectors in scratch */
+  FAR struct bcache_entry_s *entries;
+  FAR struct bcache_entry_s **hash;
+  FAR struct bcache_entry_s **sorted;      /* Dirty entries when flushing */
+  FAR uint8_t *data;                       /* The sectors of all entries */
+  FAR uint8_t *scratch;                    /* Read-ahead and flush buffer */
+  struct list_node lru;
+#ifdef BCACHE_WRDELAY
+  struct work_s work;                      /* Delayed write-back */
+#endif
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int     bcache_open(FAR struct inode *inode);
+static int     bcache_close(FAR struct inode *inode);
+static ssize_t bcache_read(FAR struct inode *inode,
+                           FAR unsigned char *buffer,
+                           blkcnt_t start_sector, unsigned int nsectors);
+static ssize_t bcache_write(FAR struct inode *inode,
+                            FAR const unsigned char *buffer,
+                            blkcnt_t start_sector, unsigned int nsectors);
+static int     bcache_geometry(FAR struct inode *inode,
+                               FAR struct geometry *geometry);
+static int     bcache_ioctl(FAR struct inode *inode, int cmd,
+                            unsigned long arg);
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+static int     bcache_unlink(FAR struct inode *inode);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct block_operations g_bcache_bops =
+{
+  bcache_open,     /* open     */
+  bcache_close,    /* close    */
+  bcache_read,     /* read     */
+  bcache_write,    /* write    */
+  bcache_geometry, /* geometry */
+  bcache_ioctl     /* ioctl    */
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  , bcache_unlink  /* unlink   */
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bcache_find
+ ****************************************************************************/
+
+static FAR struct bcache_entry_s *bcache_find(FAR struct bcache_dev_s *dev,
+                                              blkcnt_t sector)
+{
+  FAR struct bcache_entry_s *entry;
+
+  for (entry = dev->hash[sector & dev->hashmask]; entry != NULL;
+       entry = entry->hnext)
+    {
+      if (entry->sector == sector)
+        {
+          break;
+        }
+    }
+
+  return entry;
+}
+
+/****************************************************************************
+ * Name: bcache_touch
+ *
+ * Description:
+ *   Make an entry the most recently used one.
+ *
+ ****************************************************************************/
+
+static void bcache_touch(FAR struct bcache_dev_s *dev,
+                         FAR struct bcache_entry_s *entry)
+{
+  list_delete(&entry->lru);
+  list_add_head(&dev->lru, &entry->lru);
+}
+
+/****************************************************************************
+ * Name: bcache_remove
+ *
+ * Description:
+ *   Forget the sector held by an entry, which must not be dirty.
+ *
+ ****************************************************************************/
+
+static void bcache_remove(FAR struct bcache_dev_s *dev,
+                          FAR struct bcache_entry_s *entry)
+{
+  FAR struct bcache_entry_s **link;
+
+  DEBUGASSERT(!entry->dirty);
+
+  if (entry->sector == BCACHE_NOSECTOR)
+    {
+      return;
+    }
+
+  link = &dev->hash[entry->sector & dev->hashmask];
+  while (*link != entry)
+    {
+      link = &(*link)->hnext;
+    }
+
+  *link         = entry->hnext;
+  entry->hnext  = NULL;
+  entry->sector = BCACHE_NOSECTOR;
+}
+
+/****************************************************************************
+ * Name: bcache_compare
+ ****************************************************************************/
+
+static int bcache_compare(FAR const void *a, FAR const void *b)
+{
+  blkcnt_t sa = (*(FAR struct bcache_entry_s * const *)a)->sector;
+  blkcnt_t sb = (*(FAR struct bcache_entry_s * const *)b)->sector;
+
+  return sa < sb ? -1 : sa > sb;
+}
+
+/****************************************************************************
+ * Name: bcache_flush
+ *
+ * Description:
+ *   Write all dirty sectors back to the parent, in sector order and with
+ *   as many consecutive sectors per write as the scratch buffer holds.
+ *
+ * Assumptions:
+ *   The caller holds the lock.
+ *
+ ****************************************************************************/
+
+static int bcache_flush(FAR struct bcache_dev_s *dev)
+{
+  FAR struct inode *parent = dev->parent;
+  unsigned int ndirty = 0;
+  unsigned int i;
+  unsigned int n;
+  ssize_t nwritten;
+  int ret = OK;
+
+  if (dev->ndirty == 0)
+    {
+      return OK;
+    }
+
+  for (i = 0; i < dev->nentries; i++)
+    {
+      if (dev->entries[i].dirty)
+        {
+          dev->sorted[ndirty++] = &dev->entries[i];
+        }
+    }
+
+  DEBUGASSERT(ndirty == dev->ndirty);
+  qsort(dev->sorted, ndirty, sizeof(dev->sorted[0]), bcache_compare);
+
+  for (i = 0; i < ndirty; i += n)
+    {
+      FAR struct bcache_entry_s **run = &dev->sorted[i];
+      FAR const uint8_t *buffer = run[0]->data;
+      unsigned int j;
+
+      /* Find the consecutive sectors that fit in the scratch buffer */
+
+      n = 1;
+      while (i + n < ndirty && n < dev->nscratch &&
+             run[n]->sector == run[0]->sector + n)
+        {
+          n++;
+        }
+
+      if (n > 1)
+        {
+          for (j = 0; j < n; j++)
+            {
+              memcpy(dev->scratch + j * dev->sectorsize, run[j]->data,
+                     dev->sectorsize);
+            }
+
+          buffer = dev->scratch;
+        }
+
+      nwritten = parent->u.i_bops->write(parent, buffer, run[0]->sector, n);
+      if (nwritten != n)
+        {
+          /* Keep the sectors dirty and go on with the others */
+
+          ferr("ERROR: Write back of %u sectors at %" PRIuOFF " failed\n",
+               n, (off_t)run[0]->sector);
+          ret = nwritten < 0 ? nwritten : -EIO;
+          continue;
+        }
+
+      for (j = 0; j < n; j++)
+        {
+          run[j]->dirty = false;
+        }
+
+      dev->ndirty -= n;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: bcache_victim
+ *
+ * Description:
+ *   Get the least recently used entry for a new sector.  If it is dirty,
+ *   everything dirty is written back at once.
+ *
+ ****************************************************************************/
+
+static FAR struct bcache_entry_s *
+bcache_victim(FAR struct bcache_dev_s *dev, FAR int *ret)
+{
+  FAR struct bcache_entry_s *entry;
+
+  entry = list_last_entry(&dev->lru, struct bcache_entry_s, lru);
+  if (entry->dirty)
+    {
+      *ret = bcache_flush(dev);
+      if (entry->dirty)
+        {
+          return NULL;
+        }
+    }
+
+  bcache_remove(dev, entry);
+  return entry;
+}
+
+/****************************************************************************
+ * Name: bcache_insert
+ *
+ * Description:
+ *   Cache a copy of 'nsectors' sectors read from the parent, as long as
+ *   there are clean entries to reuse.
+ *
+ ****************************************************************************/
+
+static void bcache_insert(FAR struct bcache_dev_s *dev,
+                          FAR const uint8_t *buffer, blkcnt_t sector,
+                          unsigned int nsectors)
+{
+  FAR struct bcache_entry_s *entry;
+
+  for (; nsectors > 0; nsectors--, sector++, buffer += dev->sectorsize)
+    {
+      /* Reading never writes back, 'buffer' may be the scratch buffer */
+
+      entry = list_last_entry(&dev->lru, struct bcache_entry_s, lru);
+      if (entry->dirty)
+        {
+          return;
+        }
+
+      bcache_remove(dev, entry);
+      memcpy(entry->data, buffer, dev->sectorsize);
+      entry->sector = sector;
+      entry->hnext  = dev->hash[sector & dev->hashmask];
+      dev->hash[sector & dev->hashmask] = entry;
+      bcache_touch(dev, entry);
+    }
+}
+
+/****************************************************************************
+ * Name: bcache_readahead
+ *
+ * Description:
+ *   Read the sectors following a missed read into the cache, up to the
+ *   first one that is already cached.
+ *
+ ****************************************************************************/
+
+static void bcache_readahead(FAR struct bcache_dev_s *dev, blkcnt_t sector)
+{
+  FAR struct inode *parent = dev->parent;
+  unsigned int nsectors;
+  ssize_t nread;
+
+  nsectors = 0;
+  while (nsectors < CONFIG_FS_BLOCKCACHE_READAHEAD &&
+         sector + nsectors < dev->nsectors &&
+         bcache_find(dev, sector + nsectors) == NULL)
+    {
+      nsectors++;
+    }
+
+  if (nsectors > 0)
+    {
+      nread = parent->u.i_bops->read(parent, dev->scratch, sector,
+                                      nsectors);
+      if (nread > 0)
+        {
+          bcache_insert(dev, dev->scratch, sector, nread);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: bcache_invalidate
+ *
+ * Description:
+ *   Drop everything, including the dirty sectors.  Used when the media was
+ *   changed.
+ *
+ ****************************************************************************/
+
+static void bcache_invalidate(FAR struct bcache_dev_s *dev)
+{
+  unsigned int i;
+
+  for (i = 0; i < dev->nentries; i++)
+    {
+      dev->entries[i].dirty = false;
+      bcache_remove(dev, &dev->entries[i]);
+    }
+
+  dev->ndirty = 0;
+}
+
+#ifdef BCACHE_WRDELAY
+/****************************************************************************
+ * Name: bcache_wrtimeout
+ ****************************************************************************/
+
+static void bcache_wrtimeout(FAR void *arg)
+{
+  FAR struct bcache_dev_s *dev = arg;
+
+  if (nxmutex_lock(&dev->lock) >= 0)
+    {
+      bcache_flush(dev);
+      nxmutex_unlock(&dev->lock);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: bcache_free
+ ****************************************************************************/
+
+static void bcache_free(FAR struct bcache_dev_s *dev)
+{
+  nxmutex_destroy(&dev->lock);
+  fs_heap_free(dev->scratch);
+  fs_heap_free(dev->data);
+  fs_heap_free(dev->sorted);
+  fs_heap_free(dev->hash);
+  fs_heap_free(dev->entries);
+  fs_heap_free(dev);
+}
+
+/****************************************************************************
+ * Name: bcache_open
+ *
+ * Description: Open the block device
+ *
+ ****************************************************************************/
+
+static int bcache_open(FAR struct inode *inode)
+{
+  FAR struct bcache_dev_s *dev = inode->i_private;
+  FAR struct inode *parent = dev->parent;
+  int ret = OK;
+
+  if (parent->u.i_bops->open)
+    {
+      ret = parent->u.i_bops->open(parent);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: bcache_close
+ *
+ * Description: Write back the dirty sectors and close the block device
+ *
+ ****************************************************************************/
+
+static int bcache_close(FAR struct inode *inode)
+{
+  FAR struct bcache_dev_s *dev = inode->i_private;
+  FAR struct inode *parent = dev->parent;
+  int ret;
+
+  ret = nxmutex_lock(&dev->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = bcache_flush(dev);
+  nxmutex_unlock(&dev->lock);
+
+  if (parent->u.i_bops->close)
+    {
+      int ret2 = parent->u.i_bops->close(parent);
+      if (ret >= 0)
+        {
+          ret = ret2;
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: bcache_read
+ *
+ * Description:  Read the specified number of sectors
+ *
+ ****************************************************************************/
+
+static ssize_t bcache_read(FAR struct inode *inode,
+                           FAR unsigned char *buffer,
+                           blkcnt_t start_sector, unsigned int nsectors)
+{
+  FAR struct bcache_dev_s *dev = inode->i_private;
+  FAR struct inode *parent = dev->parent;
+  FAR struct bcache_entry_s *entry;
+  bool missed = false;
+  unsigned int i;
+  unsigned int n;
+  ssize_t ret;
+
+  ret = nxmutex_lock(&dev->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (i = 0; i < nsectors; i += n)
+    {
+      entry = bcache_find(dev, start_sector + i);
+      if (entry != NULL)
+        {
+          memcpy(buffer + i * dev->sectorsize, entry->data,
+                 dev->sectorsize);
+          bcache_touch(dev, entry);
+          missed = false;
+          n = 1;
+          continue;
+        }
+
+      /* Read all sectors up to the next cached one at once */
+
+      n = 1;
+      while (i + n < nsectors &&
+             bcache_find(dev, start_sector + i + n) == NULL)
+        {
+          n++;
+        }
+
+      ret = parent->u.i_bops->read(parent, buffer + i * dev->sectorsize,
+                                   start_sector + i, n);
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      /* Large transfers would only flush out the useful sectors */
+
+      n = ret;
+      if (n <= dev->nentries / 2)
+        {
+          bcache_insert(dev, buffer + i * dev->sectorsize,
+                        start_sector + i, n);
+        }
+
+      missed = true;
+    }
+
+  /* Read ahead only if the request ended with a miss, i.e. it looks like
+   * a sequential read.
+   */
+
+  if (i == nsectors && missed && CONFIG_FS_BLOCKCACHE_READAHEAD > 0)
+    {
+      bcache_readahead(dev, start_sector + nsectors);
+    }
+
+  nxmutex_unlock(&dev->lock);
+  return i > 0 ? i : ret;
+}
+
+/****************************************************************************
+ * Name: bcache_write
+ *
+ * Description: Write (or buffer) the specified number of sectors
+ *
+ ****************************************************************************/
+
+static ssize_t bcache_write(FAR struct inode *inode,
+                            FAR const unsigned char *buffer,
+                            blkcnt_t start_sector, unsigned int nsectors)
+{
+  FAR struct bcache_dev_s *dev = inode->i_private;
+  FAR struct inode *parent = dev->parent;
+  FAR struct bcache_entry_s *entry;
+  unsigned int i;
+  ssize_t ret;
+  int error;
+
+  ret = nxmutex_lock(&dev->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Large transfers are written through, updating the cached copies */
+
+  if (nsectors > dev->nentries / 2)
+    {
+      ret = parent->u.i_bops->write(parent, buffer, start_sector, nsectors);
+      for (i = 0; ret > 0 && i < (size_t)ret; i++)
+        {
+          entry = bcache_find(dev, start_sector + i);
+          if (entry != NULL)
+            {
+              memcpy(entry->data, buffer + i * dev->sectorsize,
+                     dev->sectorsize);
+              if (entry->dirty)
+                {
+                  entry->dirty = false;
+                  dev->ndirty--;
+                }
+            }
+        }
+
+      nxmutex_unlock(&dev->lock);
+      return ret;
+    }
+
+  for (i = 0; i < nsectors; i++)
+    {
+      entry = bcache_find(dev, start_sector + i);
+      if (entry == NULL)
+        {
+          error = -ENOMEM;
+          entry = bcache_victim(dev, &error);
+          if (entry == NULL)
+            {
+              ret = error;
+              break;
+            }
+
+          entry->sector = start_sector + i;
+          entry->hnext  = dev->hash[entry->sector & dev->hashmask];
+          dev->hash[entry->sector & dev->hashmask] = entry;
+        }
+
+      memcpy(entry->data, buffer + i * dev->sectorsize, dev->sectorsize);
+      bcache_touch(dev, entry);
+      if (!entry->dirty)
+        {
+          entry->dirty = true;
+          dev->ndirty++;
+        }
+    }
+
+#ifdef BCACHE_WRDELAY
+  if (dev->ndirty > 0 && work_available(&dev->work))
+    {
+      work_queue(LPWORK, &dev->work, bcache_wrtimeout, dev,
+                 BCACHE_WRDELAY);
+    }
+#endif
+
+  nxmutex_unlock(&dev->lock);
+  return i > 0 ? i : ret;
+}
+
+/****************************************************************************
+ * Name: bcache_geometry
+ *
+ * Description: Return device geometry
+ *
+ ****************************************************************************/
+
+static int bcache_geometry(FAR struct inode *inode,
+                           FAR struct geometry *geometry)
+{
+  FAR struct bcache_dev_s *dev = inode->i_private;
+  FAR struct inode *parent = dev->parent;
+  int ret;
+
+  ret = parent->u.i_bops->geometry(parent, geometry);
+  if (ret >= 0 && geometry->geo_mediachanged)
+    {
+      if (nxmutex_lock(&dev->lock) >= 0)
+        {
+          bcache_invalidate(dev);
+          nxmutex_unlock(&dev->lock);
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: bcache_ioctl
+ ****************************************************************************/
+
+static int bcache_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
+{
+  FAR struct bcache_dev_s *dev = inode->i_private;
+  FAR struct inode *parent = dev->parent;
+  int ret = -ENOTTY;
+
+  if (cmd == BIOC_FLUSH)
+    {
+      ret = nxmutex_lock(&dev->lock);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      ret = bcache_flush(dev);
+      nxmutex_unlock(&dev->lock);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  if (parent->u.i_bops->ioctl)
+    {
+      int ret2 = parent->u.i_bops->ioctl(parent, cmd, arg);
+
+      /* A parent without a write buffer may not know BIOC_FLUSH */
+
+      if (cmd != BIOC_FLUSH || ret2 != -ENOTTY)
+        {
+          ret = ret2;
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: bcache_unlink
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+static int bcache_unlink(FAR struct inode *inode)
+{
+  FAR struct bcache_dev_s *dev = inode->i_private;
+  FAR struct inode *parent = dev->parent;
+
+#ifdef BCACHE_WRDELAY
+  work_cancel_sync(LPWORK, &dev->work);
+#endif
+
+  bcache_flush(dev);
+  inode_release(parent);
+  bcache_free(dev);
+
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: register_blockcache
+ *
+ * Description:
+ *   Register a block driver at 'path' that caches the sectors of the block
+ *   driver at 'parent'.  Sectors are kept in LRU order, writes are held
+ *   back until the cache needs the space, BIOC_FLUSH, close() or
+ *   CONFIG_FS_BLOCKCACHE_WRDELAY, and missed reads are followed by
+ *   CONFIG_FS_BLOCKCACHE_READAHEAD sectors of read-ahead.  The file
+ *   system is then mounted on 'path' instead of 'parent'.
+ *
+ * Input Parameters:
+ *   path   - The path to the cached block driver inode
+ *   mode   - The access mode of the new inode
+ *   parent - The path to the block driver to be cached
+ *   size   - The memory budget for cached sectors in bytes, or zero for
+ *            CONFIG_FS_BLOCKCACHE_SIZE
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure:
+ *
+ *   EINVAL - The budget is less than two sectors
+ *   EEXIST - An inode already exists at 'path'
+ *   ENOMEM - Failed to allocate the cache
+ *
+ ****************************************************************************/
+
+int register_blockcache(FAR const char *path, mode_t mode,
+                        FAR const char *parent, size_t size)
+{
+  FAR struct bcache_dev_s *dev;
+  FAR struct inode *inode;
+  struct geometry geo;
+  unsigned int nhash;
+  unsigned int i;
+  int ret;
+
+  if ((mode & (S_IWOTH | S_IWGRP | S_IWUSR)) != 0)
+    {
+      ret = find_blockdriver(parent, 0, &inode);
+    }
+  else
+    {
+      ret = find_blockdriver(parent, MS_RDONLY, &inode);
+    }
+
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = inode->u.i_bops->geometry(inode, &geo);
+  if (ret < 0)
+    {
+      goto errout_with_inode;
+    }
+
+  if (size == 0)
+    {
+      size = CONFIG_FS_BLOCKCACHE_SIZE;
+    }
+
+  if (geo.geo_sectorsize == 0 || size / geo.geo_sectorsize < 2)
+    {
+      ret = -EINVAL;
+      goto errout_with_inode;
+    }
+
+  dev = fs_heap_zalloc(sizeof(*dev));
+  if (dev == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_inode;
+    }
+
+  nxmutex_init(&dev->lock);
+  list_initialize(&dev->lru);
+  dev->parent     = inode;
+  dev->sectorsize = geo.geo_sectorsize;
+  dev->nsectors   = geo.geo_nsectors;
+  dev->nentries   = size / geo.geo_sectorsize;
+  dev->nscratch   = MAX(CONFIG_FS_BLOCKCACHE_READAHEAD, BCACHE_MINSCRATCH);
+
+  nhash = 1;
+  while (nhash < dev->nentries)
+    {
+      nhash <<= 1;
+    }
+
+  dev->hashmask = nhash - 1;
+
+  dev->entries = fs_heap_zalloc(dev->nentries * sizeof(*dev->entries));
+  dev->hash    = fs_heap_zalloc(nhash * sizeof(*dev->hash));
+  dev->sorted  = fs_heap_malloc(dev->nentries * sizeof(*dev->sorted));
+  dev->data    = fs_heap_malloc(dev->nentries * dev->sectorsize);
+  dev->scratch = fs_heap_malloc(dev->nscratch * dev->sectorsize);
+  if (dev->entries == NULL || dev->hash == NULL || dev->sorted == NULL ||
+      dev->data == NULL || dev->scratch == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_dev;
+    }
+
+  for (i = 0; i < dev->nentries; i++)
+    {
+      dev->entries[i].sector = BCACHE_NOSECTOR;
+      dev->entries[i].data   = dev->data + i * dev->sectorsize;
+      list_add_tail(&dev->lru, &dev->entries[i].lru);
+    }
+
+  ret = register_blockdriver(path, &g_bcache_bops, mode, dev);
+  if (ret < 0)
+    {
+      goto errout_with_dev;
+    }
+
+  return OK;
+
+errout_with_dev:
+  bcache_free(dev);
+errout_with_inode:
+  inode_release(inode);
+  return ret;
+}
+
+#endif /* CONFIG_FS_BLOCKCACHE */
@@ -247,6 +247,13 @@ static int part_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 
                 prot->startblock += dev->firstsector;
               }
+            else if (cmd == BIOC_PREERASE)
+              {
+                FAR struct blk_preerase_s *hint =
+                  (FAR struct blk_preerase_s *)ptr_arg;
+
+                hint->startsector += dev->firstsector;
+              }
 
             ret = parent->u.i_bops->ioctl(parent, cmd, arg);
             if (ret >= 0)
@@ -121,8 +121,9 @@ static FAR char *unique_blkdev(void)
  * Name: mtd_proxy
  *
  * Description:
- *   Create a temporary block driver using drivers/mtd/ftl to mediate block
- *   oriented accessed to the mtd driver.
+ *   Create a temporary block driver using drivers/mtd/ftl, or dhara with
+ *   CONFIG_DHARA_MTD_PROXY, to mediate block oriented accessed to the mtd
+ *   driver.
  *
  * Input Parameters:
  *   mtddev  - The path to the mtd driver
@@ -163,12 +164,15 @@ int mtd_proxy(FAR const char *mtddev, int mountflags,
       goto out_with_blkdev;
     }
 
+#ifdef CONFIG_DHARA_MTD_PROXY
+  ret = dhara_initialize_by_path(blkdev, mtd->u.i_mtd);
+#else
   ret = ftl_initialize_by_path(blkdev, mtd->u.i_mtd);
+#endif
   inode_release(mtd);
   if (ret < 0)
     {
-      ferr("ERROR: ftl_initialize_by_path(%s, %s) failed: %d\n",
-           mtddev, blkdev, ret);
+      ferr("ERROR: Failed to wrap %s as %s: %d\n", mtddev, blkdev, ret);
       goto out_with_blkdev;
     }
 
@@ -24,6 +24,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/statfs.h>
@@ -83,9 +84,15 @@ static int     fat_opendir(FAR struct inode *mountpt,
                  FAR const char *relpath, FAR struct fs_dirent_s **dir);
 static int     fat_closedir(FAR struct inode *mountpt,
                  FAR struct fs_dirent_s *dir);
+static int     fat_readdir_common(FAR struct inode *mountpt,
+                 FAR struct fs_dirent_s *dir,
+                 FAR struct dirent *entry, FAR struct stat *buf);
 static int     fat_readdir(FAR struct inode *mountpt,
                  FAR struct fs_dirent_s *dir,
                  FAR struct dirent *entry);
+static int     fat_readdirplus(FAR struct inode *mountpt,
+                 FAR struct fs_dirent_s *dir,
+                 FAR struct dirent *entry, FAR struct stat *buf);
 static int     fat_rewinddir(FAR struct inode *mountpt,
                  FAR struct fs_dirent_s *dir);
 
@@ -151,7 +158,9 @@ const struct mountpt_operations g_fat_operations =
   fat_rmdir,         /* rmdir */
   fat_rename,        /* rename */
   fat_stat,          /* stat */
-  NULL               /* chstat */
+  NULL,              /* chstat */
+  NULL,              /* syncfs */
+  fat_readdirplus    /* readdirplus */
 };
 
 /****************************************************************************
@@ -467,6 +476,14 @@ static int fat_close(FAR struct file *filep)
       fat_io_free(ff->ff_buffer, fs->fs_hwsectorsize);
     }
 
+#if CONFIG_FAT_STREAMBUF_SECTORS > 0
+  if (ff->ff_sbuffer)
+    {
+      fat_io_free(ff->ff_sbuffer,
+                  CONFIG_FAT_STREAMBUF_SECTORS * fs->fs_hwsectorsize);
+    }
+#endif
+
   /* Then free the file structure itself. */
 
   fs_heap_free(ff);
@@ -548,6 +565,114 @@ out:
   return ret;
 }
 
+/****************************************************************************
+ * Name: fat_extentlookup
+ *
+ * Description:
+ *   Find the cluster with the given index in the chain of the file from
+ *   the cached cluster runs.  If the runs do not reach that far, return
+ *   the last cluster they cover instead, so that the walk along the chain
+ *   can continue from there.
+ *
+ * Returned Value:
+ *   The index of the cluster returned in 'cluster', or -1 if nothing is
+ *   cached.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FAT_EXTENTS > 0
+static int fat_extentlookup(FAR struct fat_file_s *ff, int index,
+                            FAR int *cluster)
+{
+  FAR struct fat_extent_s *ext = NULL;
+  uint32_t first = 0;
+  int i;
+
+  if (index < 0)
+    {
+      return -1;
+    }
+
+  for (i = 0; i < ff->ff_nextents; i++)
+    {
+      ext = &ff->ff_extents[i];
+      if ((uint32_t)index < first + ext->fe_count)
+        {
+          *cluster = ext->fe_cluster + (index - first);
+          return index;
+        }
+
+      first += ext->fe_count;
+    }
+
+  if (ext == NULL)
+    {
+      return -1;
+    }
+
+  *cluster = ext->fe_cluster + ext->fe_count - 1;
+  return first - 1;
+}
+
+/****************************************************************************
+ * Name: fat_extentadd
+ *
+ * Description:
+ *   Record the cluster with the given index in the chain of the file, if it
+ *   directly follows the clusters already recorded.  It extends the last
+ *   run if it is contiguous with it on the media, otherwise it starts a new
+ *   run while there is room for one.
+ *
+ ****************************************************************************/
+
+static void fat_extentadd(FAR struct fat_file_s *ff, int index, int cluster)
+{
+  FAR struct fat_extent_s *ext;
+
+  if ((uint32_t)index != ff->ff_extmapped)
+    {
+      return;
+    }
+
+  if (ff->ff_nextents > 0)
+    {
+      ext = &ff->ff_extents[ff->ff_nextents - 1];
+      if (ext->fe_cluster + ext->fe_count == cluster)
+        {
+          ext->fe_count++;
+          ff->ff_extmapped++;
+          return;
+        }
+    }
+
+  if (ff->ff_nextents < CONFIG_FAT_EXTENTS)
+    {
+      ext             = &ff->ff_extents[ff->ff_nextents++];
+      ext->fe_cluster = cluster;
+      ext->fe_count   = 1;
+      ff->ff_extmapped++;
+    }
+}
+
+/****************************************************************************
+ * Name: fat_extentreset
+ *
+ * Description:
+ *   Forget the cached cluster runs after the chain was changed other than
+ *   by appending to it.
+ *
+ ****************************************************************************/
+
+static void fat_extentreset(FAR struct fat_file_s *ff)
+{
+  ff->ff_nextents  = 0;
+  ff->ff_extmapped = 0;
+}
+#else
+#  define fat_extentadd(ff, index, cluster)
+#  define fat_extentreset(ff)
+#endif
+
 /****************************************************************************
  * Name: fat_get_sectors
  *
@@ -587,6 +712,9 @@ static int fat_get_sectors(FAR struct file *filep, bool read)
   int zero_start;
   int zero_end;
   int clu_size = fs->fs_fatsecperclus * fs->fs_hwsectorsize;
+#if CONFIG_FAT_EXTENTS > 0
+  int extcluster;
+#endif
 
   num_clu = DIV_ROUND_UP(ff->ff_size, clu_size);
   new_num_clu = DIV_ROUND_UP(filep->f_pos + 1, clu_size);
@@ -615,6 +743,22 @@ static int fat_get_sectors(FAR struct file *filep, bool read)
       num_traversed = 1;
     }
 
+#if CONFIG_FAT_EXTENTS > 0
+  /* Skip as much of the walk as the cached cluster runs allow */
+
+  if (ff->ff_startcluster != 0)
+    {
+      fat_extentadd(ff, 0, ff->ff_startcluster);
+
+      i = fat_extentlookup(ff, MIN(num_clu, new_num_clu) - 1, &extcluster);
+      if (i >= num_traversed)
+        {
+          cluster       = extcluster;
+          num_traversed = i + 1;
+        }
+    }
+#endif
+
   /* Traverse the existing chain */
 
   for (i = num_traversed; i < num_clu && i < new_num_clu; i++)
@@ -627,6 +771,8 @@ static int fat_get_sectors(FAR struct file *filep, bool read)
         {
           return -EIO;
         }
+
+      fat_extentadd(ff, i, cluster);
     }
 
   if (read)
@@ -661,6 +807,12 @@ static int fat_get_sectors(FAR struct file *filep, bool read)
 
       fat_ffcacheinvalidate(fs, ff);
 
+      ret = fat_ffstreaminvalidate(fs, ff);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
       ret = fat_zero_cluster(fs, cluster, zero_start, zero_end);
       if (ret)
         {
@@ -679,6 +831,8 @@ static int fat_get_sectors(FAR struct file *filep, bool read)
           return -EIO;
         }
 
+      fat_extentadd(ff, i, cluster);
+
       /* zero area (2) */
 
       ret = fat_zero_cluster(fs, cluster, 0, clu_size);
@@ -702,6 +856,8 @@ static int fat_get_sectors(FAR struct file *filep, bool read)
           return -EIO;
         }
 
+      fat_extentadd(ff, i, cluster);
+
       /* zero area (3) */
 
       zero_end = filep->f_pos & (clu_size -1);
@@ -714,6 +870,14 @@ static int fat_get_sectors(FAR struct file *filep, bool read)
             }
         }
 
+#ifdef CONFIG_FAT_PREERASE
+      /* The rest of the new cluster is about to be written */
+
+      zero_start = DIV_ROUND_UP(zero_end, fs->fs_hwsectorsize);
+      fat_hwpreerase(fs, fat_cluster2sector(fs, cluster) + zero_start,
+                     fs->fs_fatsecperclus - zero_start);
+#endif
+
       if (ff->ff_startcluster == 0)
         {
           ff->ff_startcluster = cluster;
@@ -739,6 +903,294 @@ out:
   return 0;
 }
 
+/****************************************************************************
+ * Name: fat_streamsync
+ *
+ * Description:
+ *   Make sure that the stream buffer does not hold any of the sectors that
+ *   are about to be transferred directly to or from the media.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FAT_STREAMBUF_SECTORS > 0
+static int fat_streamsync(FAR struct fat_mountpt_s *fs,
+                          FAR struct fat_file_s *ff, off_t sector,
+                          unsigned int nsectors)
+{
+  if (ff->ff_sbcount > 0 && sector < ff->ff_sbsector + ff->ff_sbcount &&
+      sector + nsectors > ff->ff_sbsector)
+    {
+      return fat_ffstreaminvalidate(fs, ff);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_streamalloc
+ *
+ * Description:
+ *   Allocate the stream buffer on first use.  Files that are never accessed
+ *   sequentially do not pay for it.
+ *
+ ****************************************************************************/
+
+static bool fat_streamalloc(FAR struct fat_mountpt_s *fs,
+                            FAR struct fat_file_s *ff)
+{
+  if (ff->ff_sbuffer == NULL)
+    {
+      ff->ff_sbuffer = (FAR uint8_t *)
+        fat_io_alloc(CONFIG_FAT_STREAMBUF_SECTORS * fs->fs_hwsectorsize);
+    }
+
+  return ff->ff_sbuffer != NULL;
+}
+
+/****************************************************************************
+ * Name: fat_streamread
+ *
+ * Description:
+ *   Copy file data from the stream buffer.  If the current sector is not
+ *   buffered but the file is being read sequentially, read ahead first:
+ *   The run of sectors starting at the current one is extended into the
+ *   following clusters for as long as they are contiguous on the media and
+ *   fetched with a single transfer.
+ *
+ * Input Parameters:
+ *   fs         - A reference to the fat volume object instance
+ *   ff         - The open file, positioned by fat_get_sectors()
+ *   buffer     - The user buffer to copy to
+ *   buflen     - The number of bytes wanted, not beyond the end of file
+ *   pos        - The current file position
+ *   sequential - True if this read continues where the previous one ended
+ *
+ * Returned Value:
+ *   The number of bytes copied, zero if the data has to be read without the
+ *   stream buffer, or a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static int fat_streamread(FAR struct fat_mountpt_s *fs,
+                          FAR struct fat_file_s *ff, FAR uint8_t *buffer,
+                          size_t buflen, off_t pos, bool sequential)
+{
+  off_t sector = ff->ff_currentsector;
+  unsigned int sectorindex = pos & SEC_NDXMASK(fs);
+  unsigned int maxsectors;
+  unsigned int nsectors;
+  unsigned int nbytes;
+  off_t cluster;
+  off_t next;
+  int ret;
+
+  if (ff->ff_sbcount == 0 || sector < ff->ff_sbsector ||
+      sector >= ff->ff_sbsector + ff->ff_sbcount)
+    {
+      if (!sequential)
+        {
+          return 0;
+        }
+
+#ifndef CONFIG_FAT_FORCE_INDIRECT
+      /* Large aligned reads go directly to the user buffer instead */
+
+      if (sectorindex == 0 &&
+          buflen >= CONFIG_FAT_STREAMBUF_SECTORS * fs->fs_hwsectorsize)
+        {
+          return 0;
+        }
+#endif
+
+      ret = fat_ffstreaminvalidate(fs, ff);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      /* The file buffer must not hold a copy of any sector read ahead */
+
+      ret = fat_ffcacheinvalidate(fs, ff);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      if (!fat_streamalloc(fs, ff))
+        {
+          return 0;
+        }
+
+      maxsectors = DIV_ROUND_UP(ff->ff_size - (pos - sectorindex),
+                                fs->fs_hwsectorsize);
+      maxsectors = MIN(maxsectors, CONFIG_FAT_STREAMBUF_SECTORS);
+      nsectors   = MIN(ff->ff_sectorsincluster, maxsectors);
+      cluster    = ff->ff_currentcluster;
+
+      while (nsectors < maxsectors)
+        {
+          next = fat_getcluster(fs, cluster);
+          if (next != cluster + 1)
+            {
+              break;
+            }
+
+          cluster  = next;
+          nsectors = MIN(nsectors + fs->fs_fatsecperclus, maxsectors);
+        }
+
+      ret = fat_hwread(fs, ff->ff_sbuffer, sector, nsectors);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      ff->ff_sbsector = sector;
+      ff->ff_sbcount  = nsectors;
+    }
+
+  /* Copy up to the end of the buffered run or of the current cluster */
+
+  nsectors = MIN(ff->ff_sbsector + ff->ff_sbcount - sector,
+                 ff->ff_sectorsincluster);
+  nbytes   = MIN(buflen, nsectors * fs->fs_hwsectorsize - sectorindex);
+
+  memcpy(buffer, &ff->ff_sbuffer[(sector - ff->ff_sbsector) *
+                                 fs->fs_hwsectorsize + sectorindex],
+         nbytes);
+
+  nsectors                 = (sectorindex + nbytes) / fs->fs_hwsectorsize;
+  ff->ff_sectorsincluster -= nsectors;
+  ff->ff_currentsector    += nsectors;
+  return nbytes;
+}
+
+/****************************************************************************
+ * Name: fat_streamwrite
+ *
+ * Description:
+ *   Collect file data in the stream buffer.  Data for sectors that are
+ *   already buffered is merged in.  Otherwise the data is appended if it
+ *   continues the buffered run and covers whole sectors, or the last
+ *   sector of the file, so that nothing has to be read first.  The run is
+ *   written back with a single transfer when a write does not continue it,
+ *   and on fsync() or close().
+ *
+ * Input Parameters:
+ *   fs     - A reference to the fat volume object instance
+ *   ff     - The open file, positioned by fat_get_sectors()
+ *   buffer - The user data to write
+ *   buflen - The number of bytes to write
+ *   pos    - The current file position
+ *
+ * Returned Value:
+ *   The number of bytes taken, zero if the data has to be written without
+ *   the stream buffer, or a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static int fat_streamwrite(FAR struct fat_mountpt_s *fs,
+                           FAR struct fat_file_s *ff,
+                           FAR const uint8_t *buffer, size_t buflen,
+                           off_t pos)
+{
+  off_t sector = ff->ff_currentsector;
+  unsigned int sectorindex = pos & SEC_NDXMASK(fs);
+  unsigned int nsectors;
+  unsigned int nbytes;
+  int ret;
+
+  if (ff->ff_sbcount > 0 && sector >= ff->ff_sbsector &&
+      sector < ff->ff_sbsector + ff->ff_sbcount)
+    {
+      /* Overwrite data that is already buffered */
+
+      nsectors = ff->ff_sbsector + ff->ff_sbcount - sector;
+    }
+  else
+    {
+      if (sectorindex != 0)
+        {
+          return 0;
+        }
+
+      nsectors = buflen / fs->fs_hwsectorsize;
+      if ((buflen & SEC_NDXMASK(fs)) != 0 && pos + buflen >= ff->ff_size)
+        {
+          nsectors++;
+        }
+
+      if (nsectors == 0)
+        {
+          return 0;
+        }
+
+      if (!ff->ff_sbdirty ||
+          ff->ff_sbcount >= CONFIG_FAT_STREAMBUF_SECTORS ||
+          sector != ff->ff_sbsector + ff->ff_sbcount)
+        {
+#ifndef CONFIG_FAT_FORCE_INDIRECT
+          /* Start a new run, unless the write is large enough to go
+           * directly to the media.
+           */
+
+          if (buflen >= CONFIG_FAT_STREAMBUF_SECTORS * fs->fs_hwsectorsize)
+            {
+              return 0;
+            }
+#endif
+
+          ret = fat_ffstreaminvalidate(fs, ff);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          if (!fat_streamalloc(fs, ff))
+            {
+              return 0;
+            }
+
+          ff->ff_sbsector = sector;
+        }
+
+      nsectors = MIN(nsectors,
+                     CONFIG_FAT_STREAMBUF_SECTORS - ff->ff_sbcount);
+      nsectors = MIN(nsectors, ff->ff_sectorsincluster);
+
+      /* The file buffer must not keep an older copy of these sectors */
+
+      if (ff->ff_cachesector >= sector &&
+          ff->ff_cachesector < sector + nsectors)
+        {
+          ret = fat_ffcacheinvalidate(fs, ff);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+
+      ff->ff_sbcount += nsectors;
+    }
+
+  nsectors = MIN(nsectors, ff->ff_sectorsincluster);
+  nbytes   = MIN(buflen, nsectors * fs->fs_hwsectorsize - sectorindex);
+
+  memcpy(&ff->ff_sbuffer[(sector - ff->ff_sbsector) * fs->fs_hwsectorsize +
+                         sectorindex],
+         buffer, nbytes);
+
+  nsectors                 = (sectorindex + nbytes) / fs->fs_hwsectorsize;
+  ff->ff_sectorsincluster -= nsectors;
+  ff->ff_currentsector    += nsectors;
+  ff->ff_sbdirty           = true;
+  ff->ff_bflags           |= FFBUFF_MODIFIED;
+  return nbytes;
+}
+#else
+#  define fat_streamsync(fs, ff, sector, nsectors) (OK)
+#endif
+
 /****************************************************************************
  * Name: fat_read
  ****************************************************************************/
@@ -760,6 +1212,9 @@ static ssize_t fat_read(FAR struct file *filep, FAR char *buffer,
   unsigned int nsectors;
   bool force_indirect = false;
 #endif
+#if CONFIG_FAT_STREAMBUF_SECTORS > 0
+  bool sequential;
+#endif
 
   /* Sanity checks */
 
@@ -835,6 +1290,9 @@ static ssize_t fat_read(FAR struct file *filep, FAR char *buffer,
 
   readsize    = 0;
   sectorindex = filep->f_pos & SEC_NDXMASK(fs);
+#if CONFIG_FAT_STREAMBUF_SECTORS > 0
+  sequential  = filep->f_pos == ff->ff_seqpos;
+#endif
 
   while (buflen > 0)
     {
@@ -846,6 +1304,24 @@ static ssize_t fat_read(FAR struct file *filep, FAR char *buffer,
           goto errout_with_lock;
         }
 
+#if CONFIG_FAT_STREAMBUF_SECTORS > 0
+      /* Take the data from the stream buffer if it is there, or if it is
+       * worth reading ahead.
+       */
+
+      ret = fat_streamread(fs, ff, userbuffer, buflen, filep->f_pos,
+                           sequential);
+      if (ret < 0)
+        {
+          goto errout_with_lock;
+        }
+      else if (ret > 0)
+        {
+          bytesread = ret;
+          goto fat_read_next;
+        }
+#endif
+
 #ifdef CONFIG_FAT_DIRECT_RETRY /* Warning avoidance */
 fat_read_restart:
 #endif
@@ -878,6 +1354,12 @@ fat_read_restart:
 
           fat_ffcacheinvalidate(fs, ff);
 
+          ret = fat_streamsync(fs, ff, ff->ff_currentsector, nsectors);
+          if (ret < 0)
+            {
+              goto errout_with_lock;
+            }
+
           /* Read all of the sectors directly into user memory */
 
           ret = fat_hwread(fs, userbuffer, ff->ff_currentsector, nsectors);
@@ -945,6 +1427,9 @@ fat_read_restart:
 
       /* Set up for the next sector read */
 
+#if CONFIG_FAT_STREAMBUF_SECTORS > 0
+fat_read_next:
+#endif
       userbuffer   += bytesread;
       filep->f_pos += bytesread;
       readsize     += bytesread;
@@ -952,6 +1437,10 @@ fat_read_restart:
       sectorindex   = filep->f_pos & SEC_NDXMASK(fs);
     }
 
+#if CONFIG_FAT_STREAMBUF_SECTORS > 0
+  ff->ff_seqpos = filep->f_pos;
+#endif
+
   nxmutex_unlock(&fs->fs_lock);
   return readsize;
 
@@ -1045,6 +1534,23 @@ static ssize_t fat_write(FAR struct file *filep, FAR const char *buffer,
           goto errout_with_lock;
         }
 
+#if CONFIG_FAT_STREAMBUF_SECTORS > 0
+      /* Collect the data in the stream buffer if it continues the run that
+       * is being written.
+       */
+
+      ret = fat_streamwrite(fs, ff, userbuffer, buflen, filep->f_pos);
+      if (ret < 0)
+        {
+          goto errout_with_lock;
+        }
+      else if (ret > 0)
+        {
+          writesize = ret;
+          goto fat_write_next;
+        }
+#endif
+
 #ifdef CONFIG_FAT_DIRECT_RETRY /* Warning avoidance */
 fat_write_restart:
 #endif
@@ -1077,6 +1583,12 @@ fat_write_restart:
 
           fat_ffcacheinvalidate(fs, ff);
 
+          ret = fat_streamsync(fs, ff, ff->ff_currentsector, nsectors);
+          if (ret < 0)
+            {
+              goto errout_with_lock;
+            }
+
           /* Write all of the sectors directly from user memory */
 
           ret = fat_hwwrite(fs, userbuffer, ff->ff_currentsector, nsectors);
@@ -1186,6 +1698,9 @@ fat_write_restart:
 
       /* Set up for the next write */
 
+#if CONFIG_FAT_STREAMBUF_SECTORS > 0
+fat_write_next:
+#endif
       userbuffer   += writesize;
       filep->f_pos += writesize;
       byteswritten += writesize;
@@ -1425,7 +1940,7 @@ static int fat_sync(FAR struct file *filep)
     {
       uint8_t dircopy[DIR_SIZE];
 
-      /* Flush any unwritten data in the file buffer */
+      /* Flush any unwritten data in the file and stream buffers */
 
       ret = fat_ffcacheflush(fs, ff);
       if (ret < 0)
@@ -1433,6 +1948,12 @@ static int fat_sync(FAR struct file *filep)
           goto errout_with_lock;
         }
 
+      ret = fat_ffstreamflush(fs, ff);
+      if (ret < 0)
+        {
+          goto errout_with_lock;
+        }
+
       /* Update the directory entry.  First read the directory
        * entry into the fs_buffer (preserving the ff_buffer)
        */
@@ -1595,6 +2116,20 @@ static int fat_dup(FAR const struct file *oldp, FAR struct file *newp)
   newff->ff_currentsector    = oldff->ff_currentsector;    /* Current sector */
   newff->ff_cachesector      = 0;                          /* Sector in file buffer */
 
+#if CONFIG_FAT_STREAMBUF_SECTORS > 0
+  /* The stream buffer is not shared, it is allocated on first use */
+
+  newff->ff_sbdirty          = false;
+  newff->ff_sbcount          = 0;
+  newff->ff_seqpos           = 0;
+  newff->ff_sbuffer          = NULL;
+#endif
+
+#if CONFIG_FAT_EXTENTS > 0
+  newff->ff_nextents         = 0;
+  newff->ff_extmapped        = 0;
+#endif
+
   /* Attach the private date to the struct file instance */
 
   newp->f_priv = newff;
@@ -1877,6 +2412,16 @@ static int fat_truncate(FAR struct file *filep, off_t length)
       goto errout_with_lock;
     }
 
+  /* Write back any buffered data before the clusters are changed */
+
+  ret = fat_ffstreaminvalidate(fs, ff);
+  if (ret < 0)
+    {
+      goto errout_with_lock;
+    }
+
+  fat_extentreset(ff);
+
   /* Are we shrinking the file?  Or extending it? */
 
   oldsize = ff->ff_size;
@@ -1961,15 +2506,17 @@ errout_with_lock:
 }
 
 /****************************************************************************
- * Name: fat_readdir
+ * Name: fat_readdir_common
  *
- * Description: Read the next directory entry
+ * Description:
+ *   Read the next directory entry, and its attributes if buf isn't NULL
  *
  ****************************************************************************/
 
-static int fat_readdir(FAR struct inode *mountpt,
-                       FAR struct fs_dirent_s *dir,
-                       FAR struct dirent *entry)
+static int fat_readdir_common(FAR struct inode *mountpt,
+                              FAR struct fs_dirent_s *dir,
+                              FAR struct dirent *entry,
+                              FAR struct stat *buf)
 {
   FAR struct fat_dirent_s *fdir;
   FAR struct fat_mountpt_s *fs;
@@ -2091,6 +2638,17 @@ static int fat_readdir(FAR struct inode *mountpt,
                   entry->d_type = DTYPE_DIRECTORY;
                 }
 
+              /* The short file name entry holds the attributes too */
+
+              if (buf != NULL)
+                {
+                  ret = fat_stat_file(fs, direntry, buf);
+                  if (ret < 0)
+                    {
+                      goto errout_with_lock;
+                    }
+                }
+
               /* Mark the entry found.  We will set up the next directory
                * index, and then exit with success.
                */
@@ -2116,6 +2674,36 @@ errout_with_lock:
   return ret;
 }
 
+/****************************************************************************
+ * Name: fat_readdir
+ *
+ * Description: Read the next directory entry
+ *
+ ****************************************************************************/
+
+static int fat_readdir(FAR struct inode *mountpt,
+                       FAR struct fs_dirent_s *dir,
+                       FAR struct dirent *entry)
+{
+  return fat_readdir_common(mountpt, dir, entry, NULL);
+}
+
+/****************************************************************************
+ * Name: fat_readdirplus
+ *
+ * Description:
+ *   Read the next directory entry and its attributes from the same
+ *   directory sector
+ *
+ ****************************************************************************/
+
+static int fat_readdirplus(FAR struct inode *mountpt,
+                           FAR struct fs_dirent_s *dir,
+                           FAR struct dirent *entry, FAR struct stat *buf)
+{
+  return fat_readdir_common(mountpt, dir, entry, buf);
+}
+
 /****************************************************************************
  * Name: fat_rewindir
  *
@@ -2353,6 +2941,7 @@ static int fat_unbind(FAR void *handle, FAR struct inode **blkdriver,
       fat_io_free(fs->fs_buffer, fs->fs_hwsectorsize);
     }
 
+  fat_freemapfree(fs);
   nxmutex_destroy(&fs->fs_lock);
   fs_heap_free(fs);
   return OK;
@@ -851,6 +851,18 @@
 #  define fat_io_free(m,s) fs_heap_free(m)
 #endif
 
+/* Size of the per-file read-ahead/write-behind buffer in sectors */
+
+#ifndef CONFIG_FAT_STREAMBUF_SECTORS
+#  define CONFIG_FAT_STREAMBUF_SECTORS 0
+#endif
+
+/* Number of cluster runs remembered per open file */
+
+#ifndef CONFIG_FAT_EXTENTS
+#  define CONFIG_FAT_EXTENTS 0
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -889,7 +901,21 @@ struct fat_mountpt_s
   uint8_t  fs_fatsecperclus;       /* MBR: Sectors per allocation unit: 2**n, n=0..7 */
   uint8_t *fs_buffer;              /* This is an allocated buffer to hold one
                                     * sector from the device */
+#ifdef CONFIG_FAT_FREEMAP
+  uint32_t *fs_freemap;            /* One bit per cluster, set if the cluster
+                                    * is free.  Built on first allocation */
+#endif
+};
+
+/* A run of clusters that are contiguous both in the file and on the media */
+
+#if CONFIG_FAT_EXTENTS > 0
+struct fat_extent_s
+{
+  uint32_t fe_cluster;             /* First cluster of the run */
+  uint32_t fe_count;               /* Number of clusters in the run */
 };
+#endif
 
 /* This structure represents on open file under the mountpoint.  An instance
  * of this structure is retained as struct file specific information on each
@@ -911,6 +937,21 @@ struct fat_file_s
   off_t    ff_cachesector;         /* Current sector in the file buffer */
   off_t    ff_pos;                 /* Current position in the file */
   uint8_t *ff_buffer;              /* File buffer (for partial sector accesses) */
+#if CONFIG_FAT_STREAMBUF_SECTORS > 0
+  bool     ff_sbdirty;             /* true: ff_sbuffer must be written back */
+  uint16_t ff_sbcount;             /* Number of sectors in ff_sbuffer */
+  off_t    ff_sbsector;            /* First sector in ff_sbuffer */
+  off_t    ff_seqpos;              /* Where the next sequential read starts */
+  uint8_t *ff_sbuffer;             /* Stream buffer (for sequential accesses) */
+#endif
+#if CONFIG_FAT_EXTENTS > 0
+  uint16_t ff_nextents;            /* Number of valid entries in ff_extents */
+  uint32_t ff_extmapped;           /* Clusters covered by ff_extents */
+
+  /* Cluster runs at the start of the chain */
+
+  struct fat_extent_s ff_extents[CONFIG_FAT_EXTENTS];
+#endif
 };
 
 /* This structure holds the sequence of directory entries used by one
@@ -1037,6 +1078,10 @@ EXTERN int    fat_hwread(FAR struct fat_mountpt_s *fs, FAR uint8_t *buffer,
                          off_t sector, unsigned int nsectors);
 EXTERN int    fat_hwwrite(FAR struct fat_mountpt_s *fs, FAR uint8_t *buffer,
                           off_t sector, unsigned int nsectors);
+#ifdef CONFIG_FAT_PREERASE
+EXTERN void   fat_hwpreerase(FAR struct fat_mountpt_s *fs, off_t sector,
+                             unsigned int nsectors);
+#endif
 
 /* Cluster / cluster chain access helpers */
 
@@ -1053,6 +1098,12 @@ EXTERN int32_t fat_extendchain(FAR struct fat_mountpt_s *fs,
 
 #define fat_createchain(fs) fat_extendchain(fs, 0)
 
+#ifdef CONFIG_FAT_FREEMAP
+EXTERN void   fat_freemapfree(FAR struct fat_mountpt_s *fs);
+#else
+#  define fat_freemapfree(fs)
+#endif
+
 /* Help for traversing directory trees and accessing directory entries */
 
 EXTERN int    fat_nextdirentry(FAR struct fat_mountpt_s *fs,
@@ -1098,6 +1149,18 @@ EXTERN int    fat_ffcacheread(FAR struct fat_mountpt_s *fs,
 EXTERN int    fat_ffcacheinvalidate(FAR struct fat_mountpt_s *fs,
                                     FAR struct fat_file_s *ff);
 
+/* File stream buffer (for sequential accesses) */
+
+#if CONFIG_FAT_STREAMBUF_SECTORS > 0
+EXTERN int    fat_ffstreamflush(FAR struct fat_mountpt_s *fs,
+                                FAR struct fat_file_s *ff);
+EXTERN int    fat_ffstreaminvalidate(FAR struct fat_mountpt_s *fs,
+                                     FAR struct fat_file_s *ff);
+#else
+#  define fat_ffstreamflush(fs, ff)      (OK)
+#  define fat_ffstreaminvalidate(fs, ff) (OK)
+#endif
+
 /* FSINFO sector support */
 
 EXTERN int    fat_updatefsinfo(FAR struct fat_mountpt_s *fs);
@@ -30,6 +30,7 @@
 #include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 #include <time.h>
 #include <assert.h>
 #include <errno.h>
@@ -37,6 +38,7 @@
 
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/fs/fat.h>
 
 #include "inode/inode.h"
@@ -263,6 +265,149 @@ static int fat_checkbootrecord(struct fat_mountpt_s *fs)
   return OK;
 }
 
+/****************************************************************************
+ * Name: fat_freemapset
+ *
+ * Description:
+ *   Keep the free cluster bitmap, if there is one, in sync with a FAT
+ *   entry that has just been written.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FAT_FREEMAP
+static void fat_freemapset(FAR struct fat_mountpt_s *fs, uint32_t clusterno,
+                           bool free)
+{
+  uint32_t bit = clusterno - 2;
+
+  if (fs->fs_freemap != NULL && clusterno >= 2)
+    {
+      if (free)
+        {
+          fs->fs_freemap[bit / 32] |= (uint32_t)1 << (bit % 32);
+        }
+      else
+        {
+          fs->fs_freemap[bit / 32] &= ~((uint32_t)1 << (bit % 32));
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: fat_freemapbuild
+ *
+ * Description:
+ *   Build the free cluster bitmap with one pass over the FAT.  The exact
+ *   free cluster count comes for free and replaces the FSINFO hint.
+ *
+ ****************************************************************************/
+
+static int fat_freemapbuild(FAR struct fat_mountpt_s *fs)
+{
+  uint32_t nfreeclusters = 0;
+  uint32_t cluster;
+  off_t next;
+
+  fs->fs_freemap = fs_heap_zalloc(((fs->fs_nclusters + 31) / 32) *
+                                  sizeof(uint32_t));
+  if (fs->fs_freemap == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  for (cluster = 2; cluster < fs->fs_nclusters + 2; cluster++)
+    {
+      next = fat_getcluster(fs, cluster);
+      if (next < 0)
+        {
+          fat_freemapfree(fs);
+          return next;
+        }
+      else if (next == 0)
+        {
+          fat_freemapset(fs, cluster, true);
+          nfreeclusters++;
+        }
+    }
+
+  fs->fs_fsifreecount = nfreeclusters;
+  if (fs->fs_type == FSTYPE_FAT32)
+    {
+      fs->fs_fsidirty = true;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_freemapscan
+ *
+ * Description:
+ *   Return the first free cluster in [first, last), or zero if there is
+ *   none.
+ *
+ ****************************************************************************/
+
+static uint32_t fat_freemapscan(FAR struct fat_mountpt_s *fs, uint32_t first,
+                                uint32_t last)
+{
+  uint32_t bit = first - 2;
+  uint32_t end = last - 2;
+  uint32_t word;
+
+  while (bit < end)
+    {
+      word = fs->fs_freemap[bit / 32] >> (bit % 32);
+      if (word != 0)
+        {
+          bit += ffs(word) - 1;
+          return bit < end ? bit + 2 : 0;
+        }
+
+      bit = (bit | 31) + 1;
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: fat_freemapfind
+ *
+ * Description:
+ *   Find the first free cluster after 'startcluster', wrapping around at
+ *   the end of the volume, building the bitmap first if necessary.
+ *
+ * Returned Value:
+ *   The free cluster, zero if there is none, or a negated errno value if
+ *   there is no bitmap and the FAT has to be searched instead.
+ *
+ ****************************************************************************/
+
+static int32_t fat_freemapfind(FAR struct fat_mountpt_s *fs,
+                               uint32_t startcluster)
+{
+  uint32_t cluster;
+  int ret;
+
+  if (fs->fs_freemap == NULL)
+    {
+      ret = fat_freemapbuild(fs);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  cluster = fat_freemapscan(fs, startcluster + 1, fs->fs_nclusters + 2);
+  if (cluster == 0)
+    {
+      cluster = fat_freemapscan(fs, 2, startcluster + 1);
+    }
+
+  return cluster;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -771,6 +916,32 @@ int fat_hwwrite(struct fat_mountpt_s *fs, uint8_t *buffer, off_t sector,
   return ret;
 }
 
+/****************************************************************************
+ * Name: fat_hwpreerase
+ *
+ * Description:
+ *   Tell the block driver that the sectors are about to be overwritten.
+ *   This is only a hint, the failure of the driver to use it is ignored.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FAT_PREERASE
+void fat_hwpreerase(FAR struct fat_mountpt_s *fs, off_t sector,
+                    unsigned int nsectors)
+{
+  FAR struct inode *inode = fs->fs_blkdriver;
+  struct blk_preerase_s hint;
+
+  if (nsectors > 0 && inode != NULL && inode->u.i_bops->ioctl != NULL)
+    {
+      hint.startsector = sector;
+      hint.nsectors    = nsectors;
+      inode->u.i_bops->ioctl(inode, BIOC_PREERASE,
+                             (unsigned long)(uintptr_t)&hint);
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: fat_cluster2sector
  *
@@ -1096,6 +1267,9 @@ int fat_putcluster(struct fat_mountpt_s *fs, uint32_t clusterno,
       /* Mark the modified sector as "dirty" and return success */
 
       fs->fs_dirty = true;
+#ifdef CONFIG_FAT_FREEMAP
+      fat_freemapset(fs, clusterno, nextcluster == 0);
+#endif
       return OK;
     }
 
@@ -1219,6 +1393,23 @@ int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster)
       startcluster = cluster;
     }
 
+#ifdef CONFIG_FAT_FREEMAP
+  /* Look the cluster up in the free cluster bitmap, unless it could not be
+   * built.
+   */
+
+  ret = fat_freemapfind(fs, startcluster);
+  if (ret == 0)
+    {
+      return 0;
+    }
+  else if (ret > 0)
+    {
+      newcluster = ret;
+      goto found;
+    }
+#endif
+
   /* Loop until (1) we discover that there are not free clusters
    * (return 0), an errors occurs (return -errno), or (3) we find
    * the next cluster (return the new cluster number).
@@ -1281,6 +1472,10 @@ int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster)
    * number in 'newcluster'  Now mark that cluster as in-use.
    */
 
+#ifdef CONFIG_FAT_FREEMAP
+found:
+#endif
+
   ret = fat_putcluster(fs, newcluster, 0x0fffffff);
   if (ret < 0)
     {
@@ -1316,6 +1511,23 @@ int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster)
   return newcluster;
 }
 
+/****************************************************************************
+ * Name: fat_freemapfree
+ *
+ * Description:
+ *   Release the free cluster bitmap.  It is rebuilt when it is needed
+ *   again.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FAT_FREEMAP
+void fat_freemapfree(FAR struct fat_mountpt_s *fs)
+{
+  fs_heap_free(fs->fs_freemap);
+  fs->fs_freemap = NULL;
+}
+#endif
+
 /****************************************************************************
  * Name: fat_nextdirentry
  *
@@ -1968,6 +2180,58 @@ int fat_ffcacheinvalidate(struct fat_mountpt_s *fs, struct fat_file_s *ff)
   return OK;
 }
 
+/****************************************************************************
+ * Name: fat_ffstreamflush
+ *
+ * Description:
+ *   Write back the sectors collected in the stream buffer with a single
+ *   transfer, if they have been modified.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FAT_STREAMBUF_SECTORS > 0
+int fat_ffstreamflush(struct fat_mountpt_s *fs, struct fat_file_s *ff)
+{
+  int ret;
+
+  if (ff->ff_sbdirty && ff->ff_sbcount > 0)
+    {
+      ret = fat_hwwrite(fs, ff->ff_sbuffer, ff->ff_sbsector,
+                        ff->ff_sbcount);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  ff->ff_sbdirty = false;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_ffstreaminvalidate
+ *
+ * Description:
+ *   Write back and then discard the stream buffer contents.  This must be
+ *   done before the sectors it holds are accessed by any other means.
+ *
+ ****************************************************************************/
+
+int fat_ffstreaminvalidate(struct fat_mountpt_s *fs, struct fat_file_s *ff)
+{
+  int ret;
+
+  ret = fat_ffstreamflush(fs, ff);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ff->ff_sbcount = 0;
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: fat_updatefsinfo
  *
@@ -23,6 +23,7 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+#include <nuttx/fs/uring.h>
 #include <nuttx/reboot_notifier.h>
 #include <nuttx/trace.h>
 
@@ -97,6 +98,10 @@ void fs_initialize(void)
 
 #endif
 
+#ifdef CONFIG_FS_AIO_URING
+  uring_register();
+#endif
+
 #ifdef CONFIG_FS_RPMSGFS_SERVER
   rpmsgfs_server_init();
 #endif
@@ -25,9 +25,11 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <sys/param.h>
 #include <sys/stat.h>
 #include <sys/statfs.h>
 
+#include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
 #include <string.h>
@@ -36,6 +38,7 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/lib/lib.h>
 #include <nuttx/mutex.h>
 #include <nuttx/fs/fs.h>
@@ -53,6 +56,10 @@
 
 #define HOSTFS_RETRY_DELAY_MS       10
 
+#if CONFIG_FS_HOSTFS_BUFFER_SIZE > 0 || CONFIG_FS_HOSTFS_STATCACHE > 0
+#  define HOSTFS_HAVE_CACHE
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -61,8 +68,20 @@ struct hostfs_dir_s
 {
   struct fs_dirent_s base;
   FAR void *dir;
+  FAR char *path;           /* The host path, for readdirplus */
 };
 
+#if CONFIG_FS_HOSTFS_STATCACHE > 0
+struct hostfs_stat_s
+{
+  char         path[HOSTFS_MAX_PATH]; /* The host path, empty if unused */
+  struct stat  buf;                   /* The attributes */
+  int          ret;                   /* The result of host_stat() */
+  unsigned int gen;                   /* Change count when looked up */
+  clock_t      time;                  /* Time when looked up */
+};
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -97,6 +116,10 @@ static int     hostfs_closedir(FAR struct inode *mountpt,
 static int     hostfs_readdir(FAR struct inode *mountpt,
                               FAR struct fs_dirent_s *dir,
                           FAR struct dirent *entry);
+static int     hostfs_readdirplus(FAR struct inode *mountpt,
+                                  FAR struct fs_dirent_s *dir,
+                                  FAR struct dirent *entry,
+                                  FAR struct stat *buf);
 static int     hostfs_rewinddir(FAR struct inode *mountpt,
                                 FAR struct fs_dirent_s *dir);
 
@@ -128,6 +151,27 @@ static int     hostfs_chstat(FAR struct inode *mountpt,
 
 static mutex_t g_lock = NXMUTEX_INITIALIZER;
 
+#ifdef HOSTFS_HAVE_CACHE
+/* Counts the changes made to the host file systems, the read-ahead data
+ * and the cached attributes of an older count are stale.
+ */
+
+static unsigned int g_hostfs_gen;
+#endif
+
+#if CONFIG_FS_HOSTFS_BUFFER_SIZE > 0
+/* The only file with written data not sent yet.  Any other operation
+ * sends it first, so that the host always looks as if the writes were not
+ * deferred.
+ */
+
+static FAR struct hostfs_ofile_s *g_hostfs_dirty;
+#endif
+
+#if CONFIG_FS_HOSTFS_STATCACHE > 0
+static struct hostfs_stat_s g_hostfs_statcache[CONFIG_FS_HOSTFS_STATCACHE];
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -169,6 +213,8 @@ const struct mountpt_operations g_hostfs_operations =
   hostfs_rename,        /* rename */
   hostfs_stat,          /* stat */
   hostfs_chstat,        /* chstat */
+  NULL,                 /* syncfs */
+  hostfs_readdirplus,   /* readdirplus */
 };
 
 /****************************************************************************
@@ -236,6 +282,426 @@ static void hostfs_mkpath(FAR struct hostfs_mountpt_s  *fs,
     }
 }
 
+#ifdef HOSTFS_HAVE_CACHE
+/****************************************************************************
+ * Name: hostfs_changed
+ *
+ * Description: Drop the read-ahead data and the cached attributes.
+ *
+ ****************************************************************************/
+
+static void hostfs_changed(void)
+{
+  g_hostfs_gen++;
+}
+#else
+#  define hostfs_changed()
+#endif
+
+#if CONFIG_FS_HOSTFS_BUFFER_SIZE > 0
+/****************************************************************************
+ * Name: hostfs_seekhost
+ *
+ * Description: Move the host file position to pos, if not there yet.
+ *
+ ****************************************************************************/
+
+static int hostfs_seekhost(FAR struct hostfs_ofile_s *hf, off_t pos)
+{
+  off_t ret;
+
+  if (hf->hpos == pos)
+    {
+      return OK;
+    }
+
+  ret = host_lseek(hf->fd, hf->hpos, pos, SEEK_SET);
+  if (ret < 0)
+    {
+      hf->hpos = -1;
+      return ret;
+    }
+
+  hf->hpos = ret;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: hostfs_send
+ *
+ * Description:
+ *   Send the written data of hf to the host.  A failure is kept until the
+ *   next operation on the file.
+ *
+ ****************************************************************************/
+
+static void hostfs_send(FAR struct hostfs_ofile_s *hf)
+{
+  size_t nsent = 0;
+  ssize_t ret = OK;
+
+  if ((hf->oflags & O_APPEND) == 0)
+    {
+      ret = hostfs_seekhost(hf, hf->bufpos);
+    }
+
+  while (ret >= 0 && nsent < hf->buflen)
+    {
+      ret = host_write(hf->fd, hf->buf + nsent, hf->buflen - nsent);
+      if (ret > 0)
+        {
+          nsent += ret;
+        }
+      else if (ret == 0)
+        {
+          ret = -EIO;
+        }
+    }
+
+  /* The host appends wherever its position is */
+
+  if ((hf->oflags & O_APPEND) != 0)
+    {
+      hf->hpos = -1;
+    }
+  else if (hf->hpos >= 0)
+    {
+      hf->hpos += nsent;
+    }
+
+  if (ret < 0)
+    {
+      hf->werr = ret;
+    }
+
+  hf->dirty  = false;
+  hf->buflen = 0;
+  g_hostfs_dirty = NULL;
+  hostfs_changed();
+}
+
+/****************************************************************************
+ * Name: hostfs_writeback
+ *
+ * Description: Send the written data not sent yet, of any file.
+ *
+ ****************************************************************************/
+
+static void hostfs_writeback(void)
+{
+  if (g_hostfs_dirty != NULL)
+    {
+      hostfs_send(g_hostfs_dirty);
+    }
+}
+
+/****************************************************************************
+ * Name: hostfs_flush
+ *
+ * Description:
+ *   Send the written data not sent yet, and return the error of the
+ *   deferred writes of hf.
+ *
+ ****************************************************************************/
+
+static int hostfs_flush(FAR struct hostfs_ofile_s *hf)
+{
+  int ret;
+
+  hostfs_writeback();
+
+  ret = hf->werr;
+  hf->werr = OK;
+  return ret;
+}
+
+/****************************************************************************
+ * Name: hostfs_getbuf
+ *
+ * Description:
+ *   Allocate the buffer of hf on its first use.  The file is read and
+ *   written directly if there is no memory for it.
+ *
+ ****************************************************************************/
+
+static bool hostfs_getbuf(FAR struct hostfs_ofile_s *hf)
+{
+  if (hf->buf == NULL)
+    {
+      hf->buf = fs_heap_malloc(CONFIG_FS_HOSTFS_BUFFER_SIZE);
+    }
+
+  return hf->buf != NULL;
+}
+
+/****************************************************************************
+ * Name: hostfs_readbuf
+ *
+ * Description:
+ *   Read from pos through the read-ahead buffer.  The reads smaller than
+ *   the buffer fill it, the larger ones go directly to the host.
+ *
+ ****************************************************************************/
+
+static ssize_t hostfs_readbuf(FAR struct hostfs_ofile_s *hf, off_t pos,
+                              FAR char *buffer, size_t buflen)
+{
+  ssize_t nread = 0;
+  ssize_t ret;
+  size_t copy;
+
+  ret = hostfs_flush(hf);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (!hostfs_getbuf(hf))
+    {
+      ret = hostfs_seekhost(hf, pos);
+      if (ret >= 0)
+        {
+          ret = host_read(hf->fd, buffer, buflen);
+          if (ret > 0)
+            {
+              hf->hpos += ret;
+            }
+        }
+
+      return ret;
+    }
+
+  while (buflen > 0)
+    {
+      if (hf->gen == g_hostfs_gen && pos >= hf->bufpos &&
+          pos < hf->bufpos + hf->buflen)
+        {
+          copy = MIN(buflen, hf->bufpos + hf->buflen - pos);
+          memcpy(buffer, hf->buf + (pos - hf->bufpos), copy);
+          buffer += copy;
+          buflen -= copy;
+          pos    += copy;
+          nread  += copy;
+
+          /* A short buffer was read at the end of the file, or from a
+           * stream that has nothing more for now.
+           */
+
+          if (hf->buflen < CONFIG_FS_HOSTFS_BUFFER_SIZE)
+            {
+              break;
+            }
+
+          continue;
+        }
+
+      ret = hostfs_seekhost(hf, pos);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      if (buflen >= CONFIG_FS_HOSTFS_BUFFER_SIZE)
+        {
+          ret = host_read(hf->fd, buffer, buflen);
+          if (ret > 0)
+            {
+              hf->hpos += ret;
+              nread    += ret;
+            }
+
+          break;
+        }
+
+      hf->buflen = 0;
+      ret = host_read(hf->fd, hf->buf, CONFIG_FS_HOSTFS_BUFFER_SIZE);
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      hf->hpos  += ret;
+      hf->bufpos = pos;
+      hf->buflen = ret;
+      hf->gen    = g_hostfs_gen;
+    }
+
+  return nread > 0 ? nread : ret;
+}
+
+/****************************************************************************
+ * Name: hostfs_writebuf
+ *
+ * Description:
+ *   Write at pos through the write-behind buffer.  The writes are gathered
+ *   as long as they follow each other, the ones larger than the buffer go
+ *   directly to the host.
+ *
+ ****************************************************************************/
+
+static ssize_t hostfs_writebuf(FAR struct hostfs_ofile_s *hf, off_t pos,
+                               FAR const char *buffer, size_t buflen)
+{
+  bool append = (hf->oflags & O_APPEND) != 0;
+  ssize_t nwritten = 0;
+  ssize_t ret;
+  size_t copy;
+
+  if (hf->dirty && !append && pos != hf->bufpos + hf->buflen)
+    {
+      hostfs_send(hf);
+    }
+
+  if (!hf->dirty)
+    {
+      ret = hostfs_flush(hf);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      /* The read-ahead data is replaced by the written one */
+
+      hf->buflen = 0;
+      hf->bufpos = pos;
+    }
+
+  if ((!hf->dirty && buflen >= CONFIG_FS_HOSTFS_BUFFER_SIZE) ||
+      !hostfs_getbuf(hf))
+    {
+      ret = append ? OK : hostfs_seekhost(hf, pos);
+      if (ret >= 0)
+        {
+          ret = host_write(hf->fd, buffer, buflen);
+          if (append)
+            {
+              hf->hpos = -1;
+            }
+          else if (ret > 0)
+            {
+              hf->hpos += ret;
+            }
+        }
+
+      hostfs_changed();
+      return ret;
+    }
+
+  while (nwritten < buflen)
+    {
+      copy = MIN(buflen - nwritten,
+                 CONFIG_FS_HOSTFS_BUFFER_SIZE - hf->buflen);
+      memcpy(hf->buf + hf->buflen, buffer + nwritten, copy);
+      hf->buflen += copy;
+      hf->dirty   = true;
+      nwritten   += copy;
+      g_hostfs_dirty = hf;
+
+      if (hf->buflen == CONFIG_FS_HOSTFS_BUFFER_SIZE)
+        {
+          hostfs_send(hf);
+          if (hf->werr < 0)
+            {
+              ret = hf->werr;
+              hf->werr = OK;
+              return ret;
+            }
+
+          hf->bufpos = pos + nwritten;
+        }
+    }
+
+  return nwritten;
+}
+#else
+#  define hostfs_writeback()
+#  define hostfs_flush(hf) OK
+#endif
+
+#if CONFIG_FS_HOSTFS_STATCACHE > 0
+/****************************************************************************
+ * Name: hostfs_statentry
+ *
+ * Description: Return the cache entry of the host path.
+ *
+ ****************************************************************************/
+
+static FAR struct hostfs_stat_s *hostfs_statentry(FAR const char *path)
+{
+  uint32_t hash = 5381;
+
+  while (*path != '\0')
+    {
+      hash = hash * 33 + (uint8_t)*path++;
+    }
+
+  return &g_hostfs_statcache[hash % CONFIG_FS_HOSTFS_STATCACHE];
+}
+
+/****************************************************************************
+ * Name: hostfs_statget
+ *
+ * Description:
+ *   Get the cached attributes of the host path.  Return false if they are
+ *   not cached or stale.
+ *
+ ****************************************************************************/
+
+static bool hostfs_statget(FAR const char *path, FAR struct stat *buf,
+                           FAR int *ret)
+{
+  FAR struct hostfs_stat_s *entry = hostfs_statentry(path);
+
+  if (entry->gen != g_hostfs_gen || entry->path[0] == '\0' ||
+      clock_systime_ticks() - entry->time >
+      MSEC2TICK(CONFIG_FS_HOSTFS_STATCACHE_TIMEOUT) ||
+      strcmp(entry->path, path) != 0)
+    {
+      return false;
+    }
+
+  if (entry->ret >= 0)
+    {
+      memcpy(buf, &entry->buf, sizeof(*buf));
+    }
+
+  *ret = entry->ret;
+  return true;
+}
+
+/****************************************************************************
+ * Name: hostfs_statput
+ *
+ * Description: Cache the result of host_stat() on the host path.
+ *
+ ****************************************************************************/
+
+static void hostfs_statput(FAR const char *path, FAR const struct stat *buf,
+                           int ret)
+{
+  FAR struct hostfs_stat_s *entry = hostfs_statentry(path);
+
+  if ((ret < 0 && ret != -ENOENT) ||
+      strlcpy(entry->path, path, sizeof(entry->path)) >=
+      sizeof(entry->path))
+    {
+      entry->path[0] = '\0';
+      return;
+    }
+
+  if (ret >= 0)
+    {
+      memcpy(&entry->buf, buf, sizeof(entry->buf));
+    }
+
+  entry->ret  = ret;
+  entry->gen  = g_hostfs_gen;
+  entry->time = clock_systime_ticks();
+}
+#else
+#  define hostfs_statput(path, buf, ret)
+#endif
+
 /****************************************************************************
  * Name: hostfs_open
  ****************************************************************************/
@@ -287,6 +753,7 @@ static int hostfs_open(FAR struct file *filep, FAR const char *relpath,
 
   /* Try to open the file in the host file system */
 
+  hostfs_writeback();
   hf->fd = host_open(path, oflags, mode);
   if (hf->fd < 0)
     {
@@ -296,6 +763,19 @@ static int hostfs_open(FAR struct file *filep, FAR const char *relpath,
       goto errout_with_buffer;
     }
 
+  if ((oflags & (O_CREAT | O_TRUNC)) != 0)
+    {
+      hostfs_changed();
+    }
+
+#if CONFIG_FS_HOSTFS_BUFFER_SIZE > 0
+  hf->buf    = NULL;
+  hf->buflen = 0;
+  hf->hpos   = 0;
+  hf->werr   = OK;
+  hf->dirty  = false;
+#endif
+
   /* In write/append mode, we need to set the file pointer to the end of the
    * file.
    */
@@ -306,6 +786,9 @@ static int hostfs_open(FAR struct file *filep, FAR const char *relpath,
       if (ret >= 0)
         {
           filep->f_pos = ret;
+#if CONFIG_FS_HOSTFS_BUFFER_SIZE > 0
+          hf->hpos = ret;
+#endif
         }
       else
         {
@@ -390,6 +873,10 @@ static int hostfs_close(FAR struct file *filep)
       goto okout;
     }
 
+  /* Send the written data, that is the last chance to report its error */
+
+  ret = hostfs_flush(hf);
+
   /* Remove ourselves from the linked list */
 
   nextfile = fs->fs_head;
@@ -427,11 +914,14 @@ static int hostfs_close(FAR struct file *filep)
   /* Now free the pointer */
 
   filep->f_priv = NULL;
+#if CONFIG_FS_HOSTFS_BUFFER_SIZE > 0
+  fs_heap_free(hf->buf);
+#endif
   fs_heap_free(hf);
 
 okout:
   nxmutex_unlock(&g_lock);
-  return OK;
+  return ret;
 }
 
 /****************************************************************************
@@ -468,7 +958,11 @@ static ssize_t hostfs_read(FAR struct file *filep, FAR char *buffer,
 
   /* Call the host to perform the read */
 
+#if CONFIG_FS_HOSTFS_BUFFER_SIZE > 0
+  ret = hostfs_readbuf(hf, filep->f_pos, buffer, buflen);
+#else
   ret = host_read(hf->fd, buffer, buflen);
+#endif
   if (ret > 0)
     {
       filep->f_pos += ret;
@@ -520,7 +1014,11 @@ static ssize_t hostfs_write(FAR struct file *filep, const char *buffer,
 
   /* Call the host to perform the write */
 
+#if CONFIG_FS_HOSTFS_BUFFER_SIZE > 0
+  ret = hostfs_writebuf(hf, filep->f_pos, buffer, buflen);
+#else
   ret = host_write(hf->fd, buffer, buflen);
+#endif
   if (ret > 0)
     {
       filep->f_pos += ret;
@@ -564,7 +1062,28 @@ static off_t hostfs_seek(FAR struct file *filep, off_t offset, int whence)
 
   /* Call our internal routine to perform the seek */
 
+#if CONFIG_FS_HOSTFS_BUFFER_SIZE > 0
+  /* Only the end of the file is asked to the host, the host position is
+   * moved by the next read or write.
+   */
+
+  if (whence == SEEK_SET || whence == SEEK_CUR)
+    {
+      ret = whence == SEEK_SET ? offset : filep->f_pos + offset;
+      if (ret < 0)
+        {
+          ret = -EINVAL;
+        }
+    }
+  else
+    {
+      hostfs_writeback();
+      ret = host_lseek(hf->fd, hf->hpos, offset, whence);
+      hf->hpos = ret >= 0 ? ret : -1;
+    }
+#else
   ret = host_lseek(hf->fd, filep->f_pos, offset, whence);
+#endif
   if (ret >= 0)
     {
       filep->f_pos = ret;
@@ -607,6 +1126,7 @@ static int hostfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
   /* Call our internal routine to perform the ioctl */
 
+  hostfs_writeback();
   ret = host_ioctl(hf->fd, cmd, arg);
   if (ret < 0)
     {
@@ -667,10 +1187,11 @@ static int hostfs_sync(FAR struct file *filep)
       return ret;
     }
 
+  ret = hostfs_flush(hf);
   host_sync(hf->fd);
 
   nxmutex_unlock(&g_lock);
-  return OK;
+  return ret;
 }
 
 /****************************************************************************
@@ -743,6 +1264,7 @@ static int hostfs_fstat(FAR const struct file *filep, FAR struct stat *buf)
 
   /* Call the host to perform the read */
 
+  hostfs_writeback();
   ret = host_fstat(hf->fd, buf);
 
   nxmutex_unlock(&g_lock);
@@ -789,7 +1311,9 @@ static int hostfs_fchstat(FAR const struct file *filep,
 
   /* Call the host to perform the change */
 
+  hostfs_writeback();
   ret = host_fchstat(hf->fd, buf, flags);
+  hostfs_changed();
 
   nxmutex_unlock(&g_lock);
   return ret;
@@ -830,7 +1354,12 @@ static int hostfs_ftruncate(FAR struct file *filep, off_t length)
 
   /* Call the host to perform the truncate */
 
-  ret = host_ftruncate(hf->fd, length);
+  ret = hostfs_flush(hf);
+  if (ret >= 0)
+    {
+      ret = host_ftruncate(hf->fd, length);
+      hostfs_changed();
+    }
 
   nxmutex_unlock(&g_lock);
   return ret;
@@ -878,6 +1407,13 @@ static int hostfs_opendir(FAR struct inode *mountpt, FAR const char *relpath,
 
   /* Call the host's opendir function */
 
+  hdir->path = fs_heap_strdup(path);
+  if (hdir->path == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_lock;
+    }
+
   hdir->dir = host_opendir(path);
   if (hdir->dir == NULL)
     {
@@ -893,6 +1429,7 @@ errout_with_lock:
   nxmutex_unlock(&g_lock);
 
 errout_with_hdir:
+  fs_heap_free(hdir->path);
   fs_heap_free(hdir);
   return ret;
 }
@@ -931,6 +1468,7 @@ static int hostfs_closedir(FAR struct inode *mountpt,
   host_closedir(hdir->dir);
 
   nxmutex_unlock(&g_lock);
+  fs_heap_free(hdir->path);
   fs_heap_free(hdir);
   return OK;
 }
@@ -973,6 +1511,53 @@ static int hostfs_readdir(FAR struct inode *mountpt,
   return ret;
 }
 
+/****************************************************************************
+ * Name: hostfs_readdirplus
+ *
+ * Description:
+ *   Read the next directory entry and stat it by the host path, without
+ *   looking up the path in the VFS again
+ *
+ ****************************************************************************/
+
+static int hostfs_readdirplus(FAR struct inode *mountpt,
+                              FAR struct fs_dirent_s *dir,
+                              FAR struct dirent *entry,
+                              FAR struct stat *buf)
+{
+  FAR struct hostfs_dir_s *hdir;
+  char path[HOSTFS_MAX_PATH];
+  int ret;
+
+  /* Sanity checks */
+
+  DEBUGASSERT(mountpt != NULL && mountpt->i_private != NULL);
+
+  /* Recover our private data from the inode instance */
+
+  hdir = (FAR struct hostfs_dir_s *)dir;
+
+  /* Take the lock */
+
+  ret = nxmutex_lock(&g_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  hostfs_writeback();
+  ret = host_readdir(hdir->dir, entry);
+  if (ret >= 0)
+    {
+      snprintf(path, sizeof(path), "%s/%s", hdir->path, entry->d_name);
+      ret = host_stat(path, buf);
+      hostfs_statput(path, buf, ret);
+    }
+
+  nxmutex_unlock(&g_lock);
+  return ret;
+}
+
 /****************************************************************************
  * Name: hostfs_rewindir
  *
@@ -1183,6 +1768,7 @@ static int hostfs_statfs(FAR struct inode *mountpt, FAR struct statfs *buf)
 
   /* Call the host fs to perform the statfs */
 
+  hostfs_writeback();
   ret = host_statfs(fs->fs_root, buf);
   buf->f_type = HOSTFS_MAGIC;
 
@@ -1223,7 +1809,9 @@ static int hostfs_unlink(FAR struct inode *mountpt, FAR const char *relpath)
 
   /* Call the host fs to perform the unlink */
 
+  hostfs_writeback();
   ret = host_unlink(path);
+  hostfs_changed();
 
   nxmutex_unlock(&g_lock);
   return ret;
@@ -1264,6 +1852,7 @@ static int hostfs_mkdir(FAR struct inode *mountpt, FAR const char *relpath,
   /* Call the host FS to do the mkdir */
 
   ret = host_mkdir(path, mode);
+  hostfs_changed();
 
   nxmutex_unlock(&g_lock);
   return ret;
@@ -1305,6 +1894,7 @@ int hostfs_rmdir(FAR struct inode *mountpt, FAR const char *relpath)
   /* Call the host FS to do the mkdir */
 
   ret = host_rmdir(path);
+  hostfs_changed();
 
   nxmutex_unlock(&g_lock);
   return ret;
@@ -1348,7 +1938,9 @@ int hostfs_rename(FAR struct inode *mountpt, FAR const char *oldrelpath,
 
   /* Call the host FS to do the mkdir */
 
+  hostfs_writeback();
   ret = host_rename(oldpath, newpath);
+  hostfs_changed();
 
   nxmutex_unlock(&g_lock);
   return ret;
@@ -1388,7 +1980,16 @@ static int hostfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
 
   /* Call the host FS to do the stat operation */
 
+  hostfs_writeback();
+#if CONFIG_FS_HOSTFS_STATCACHE > 0
+  if (!hostfs_statget(path, buf, &ret))
+    {
+      ret = host_stat(path, buf);
+      hostfs_statput(path, buf, ret);
+    }
+#else
   ret = host_stat(path, buf);
+#endif
 
   nxmutex_unlock(&g_lock);
   return ret;
@@ -1428,7 +2029,9 @@ static int hostfs_chstat(FAR struct inode *mountpt, FAR const char *relpath,
 
   /* Call the host FS to do the chstat operation */
 
+  hostfs_writeback();
   ret = host_chstat(path, buf, flags);
+  hostfs_changed();
 
   nxmutex_unlock(&g_lock);
   return ret;
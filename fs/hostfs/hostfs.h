@@ -51,6 +51,15 @@ struct hostfs_ofile_s
   int16_t                   crefs;   /* Reference count */
   mode_t                    oflags;  /* Open mode */
   int                       fd;
+#if CONFIG_FS_HOSTFS_BUFFER_SIZE > 0
+  FAR char                 *buf;     /* Read-ahead or write-behind data */
+  off_t                     bufpos;  /* File position of buf */
+  size_t                    buflen;  /* Valid bytes in buf */
+  off_t                     hpos;    /* Host file position, -1 if unknown */
+  unsigned int              gen;     /* Change count when buf was read */
+  int                       werr;    /* Error of a deferred write */
+  bool                      dirty;   /* buf holds data not sent */
+#endif
   char                      relpath[1];
 };
 
@@ -34,6 +34,7 @@
 #include <debug.h>
 #include <stdio.h>
 
+#include <nuttx/atomic.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/cancelpt.h>
@@ -61,44 +62,59 @@
 
 /****************************************************************************
  * Name: files_fget_by_index
+ *
+ * Description:
+ *   Get the file at the index and take a reference to it.  The lookup
+ *   takes no lock: the row arrays stay valid as long as the list, and a
+ *   reference is only taken from a nonzero count, so a file that is being
+ *   closed isn't revived.
+ *
  ****************************************************************************/
 
 static FAR struct file *files_fget_by_index(FAR struct filelist *list,
                                             int l1, int l2, FAR bool *new)
 {
   FAR struct file *filep;
-  irqstate_t flags;
+#ifdef CONFIG_FS_REFCOUNT
+  int refs;
+  int next;
+#endif
 
-  flags = spin_lock_irqsave(NULL);
+  /* Pairs with files_extend(), the row array is the one of the rows */
 
+  SP_DMB();
   filep = &list->fl_files[l1][l2];
+
 #ifdef CONFIG_FS_REFCOUNT
-  if (filep->f_inode != NULL)
+  refs = atomic_load(&filep->f_refs);
+  do
     {
-      /* When the reference count is zero but the inode has not yet been
-       * released, At this point we should return a null pointer
-       */
+      if (filep->f_inode != NULL)
+        {
+          /* When the reference count is zero but the inode has not yet
+           * been released, At this point we should return a null pointer
+           */
 
-      if (filep->f_refs == 0)
+          if (refs == 0)
+            {
+              return NULL;
+            }
+
+          next = refs + 1;
+        }
+      else if (new == NULL)
         {
-          filep = NULL;
+          return NULL;
         }
       else
         {
-          filep->f_refs++;
+          next = refs != 0 ? refs + 1 : 2;
         }
     }
-  else if (new == NULL)
-    {
-      filep = NULL;
-    }
-  else if (filep->f_refs)
-    {
-      filep->f_refs++;
-    }
-  else
+  while (!atomic_compare_exchange_weak(&filep->f_refs, &refs, next));
+
+  if (next == 2 && refs == 0)
     {
-      filep->f_refs = 2;
       *new = true;
     }
 #else
@@ -108,7 +124,6 @@ static FAR struct file *files_fget_by_index(FAR struct filelist *list,
     }
 #endif
 
-  spin_unlock_irqrestore(NULL, flags);
   return filep;
 }
 
@@ -125,6 +140,7 @@ static int files_extend(FAR struct filelist *list, size_t row)
   int i;
   int j;
 
+retry:
   orig_rows = list->fl_rows;
   if (row <= orig_rows)
     {
@@ -137,13 +153,17 @@ static int files_extend(FAR struct filelist *list, size_t row)
       return -EMFILE;
     }
 
-  files = fs_heap_malloc(sizeof(FAR struct file *) * row);
+  /* The array is preceded by the link of the retired arrays */
+
+  files = fs_heap_malloc(sizeof(FAR struct file *) * (row + 1));
   DEBUGASSERT(files);
   if (files == NULL)
     {
       return -ENFILE;
     }
 
+  *files++ = NULL;
+
   i = orig_rows;
   do
     {
@@ -156,7 +176,7 @@ static int files_extend(FAR struct filelist *list, size_t row)
               fs_heap_free(files[i]);
             }
 
-          fs_heap_free(files);
+          fs_heap_free(files - 1);
           return -ENFILE;
         }
     }
@@ -164,12 +184,11 @@ static int files_extend(FAR struct filelist *list, size_t row)
 
   flags = spin_lock_irqsave(NULL);
 
-  /* To avoid race condition, if the file list is updated by other threads
-   * and list rows is greater or equal than temp list,
-   * release the obsolete buffers
+  /* To avoid race condition, if the file list is updated by other threads,
+   * release the obsolete buffers and start over from the new list.
    */
 
-  if (orig_rows != list->fl_rows && list->fl_rows >= row)
+  if (orig_rows != list->fl_rows)
     {
       spin_unlock_irqrestore(NULL, flags);
 
@@ -178,9 +197,8 @@ static int files_extend(FAR struct filelist *list, size_t row)
           fs_heap_free(files[j]);
         }
 
-      fs_heap_free(files);
-
-      return OK;
+      fs_heap_free(files - 1);
+      goto retry;
     }
 
   if (list->fl_files != NULL)
@@ -190,16 +208,26 @@ static int files_extend(FAR struct filelist *list, size_t row)
     }
 
   tmp = list->fl_files;
+
+  /* A lookup that sees the new row count must see the new array */
+
+  SP_DMB();
   list->fl_files = files;
+  SP_DMB();
   list->fl_rows = row;
 
-  spin_unlock_irqrestore(NULL, flags);
+  /* The old array may still be read by a lookup, keep it until the list is
+   * released.
+   */
 
   if (tmp != NULL && tmp != &list->fl_prefile)
     {
-      fs_heap_free(tmp);
+      files = (FAR struct file **)tmp - 1;
+      *files = (FAR struct file *)list->fl_retired;
+      list->fl_retired = files;
     }
 
+  spin_unlock_irqrestore(NULL, flags);
   return OK;
 }
 
@@ -368,6 +396,7 @@ void files_initlist(FAR struct filelist *list)
   list->fl_crefs = 1;
   list->fl_files = &list->fl_prefile;
   list->fl_prefile = list->fl_prefiles;
+  list->fl_retired = NULL;
 }
 
 /****************************************************************************
@@ -504,7 +533,19 @@ void files_putlist(FAR struct filelist *list)
 
   if (list->fl_files != &list->fl_prefile)
     {
-      fs_heap_free(list->fl_files);
+      fs_heap_free(list->fl_files - 1);
+    }
+
+  /* Free the arrays replaced by files_extend(), each one is linked by the
+   * entry before its rows.
+   */
+
+  while (list->fl_retired != NULL)
+    {
+      FAR struct file **files = list->fl_retired;
+
+      list->fl_retired = (FAR struct file **)*files;
+      fs_heap_free(files);
     }
 }
 
@@ -604,15 +645,22 @@ int file_allocate_from_tcb(FAR struct tcb_s *tcb, FAR struct inode *inode,
               filep->f_pos         = pos;
               filep->f_inode       = inode;
               filep->f_priv        = priv;
-#ifdef CONFIG_FS_REFCOUNT
-              filep->f_refs        = 1;
-#endif
 #ifdef CONFIG_FDSAN
               filep->f_tag_fdsan   = 0;
 #endif
 #ifdef CONFIG_FDCHECK
               filep->f_tag_fdcheck = 0;
 #endif
+#ifdef CONFIG_FS_NOTIFY
+              filep->f_notify_gen  = 0;
+#endif
+#ifdef CONFIG_FS_REFCOUNT
+              /* The count is set last, so that a lockless lookup that
+               * takes a reference sees the file filled.
+               */
+
+              atomic_store(&filep->f_refs, 1);
+#endif
 
               goto found;
             }
@@ -835,12 +883,8 @@ void fs_reffilep(FAR struct file *filep)
 {
   /* This interface is used to increase the reference count of filep */
 
-  irqstate_t flags;
-
   DEBUGASSERT(filep);
-  flags = spin_lock_irqsave(NULL);
-  filep->f_refs++;
-  spin_unlock_irqrestore(NULL, flags);
+  atomic_fetch_add(&filep->f_refs, 1);
 }
 
 /****************************************************************************
@@ -857,16 +901,11 @@ void fs_reffilep(FAR struct file *filep)
 
 int fs_putfilep(FAR struct file *filep)
 {
-  irqstate_t flags;
   int ret = 0;
   int refs;
 
   DEBUGASSERT(filep);
-  flags = spin_lock_irqsave(NULL);
-
-  refs = --filep->f_refs;
-
-  spin_unlock_irqrestore(NULL, flags);
+  refs = atomic_fetch_sub(&filep->f_refs, 1) - 1;
 
   /* If refs is zero, the close() had called, closing it now. */
 
@@ -72,6 +72,8 @@ void inode_initialize(void)
 void inode_lock(void)
 {
   down_write(&g_inode_lock);
+  inode_cache_lock();
+  inode_rcu_lock();
 }
 
 /****************************************************************************
@@ -97,6 +99,8 @@ void inode_rlock(void)
 
 void inode_unlock(void)
 {
+  inode_rcu_unlock();
+  inode_cache_unlock();
   up_write(&g_inode_lock);
 }
 
@@ -0,0 +1,223 @@
+/****************************************************************************
+ * fs/inode/fs_inodecache.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <string.h>
+
+#include <nuttx/spinlock.h>
+
+#include "inode/inode.h"
+#include "fs_heap.h"
+
+#if CONFIG_FS_INODE_CACHE > 0
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One remembered search.  The pointers returned by the search into the
+ * path are kept as offsets, so that they can be applied to the path of a
+ * later search.  A negative 'reloff' stands for a NULL relpath.
+ */
+
+struct inode_cache_s
+{
+  FAR char *path;           /* The absolute path searched, NULL if unused */
+  uint32_t hash;            /* Hash of the path */
+  uint32_t gen;             /* Value of g_inode_cachegen when added */
+  FAR struct inode *node;   /* The found inode, NULL if none */
+  FAR struct inode *peer;   /* Node to the "left" of the found inode */
+  FAR struct inode *parent; /* Node "above" the found inode */
+  int16_t result;           /* OK or -ENOENT */
+  int16_t reloff;           /* Offset of relpath into path */
+  uint16_t pathoff;         /* Offset where the search stopped */
+  bool nofollow;            /* Terminal soft links were not followed */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct inode_cache_s g_inode_cache[CONFIG_FS_INODE_CACHE];
+static spinlock_t g_inode_cachelock = SP_UNLOCKED;
+
+/* Both are only changed with the inode tree write locked.  Searches that
+ * hold the read lock see stable values, lockless searches are validated
+ * after the fact and only add entries of the generation they started in.
+ */
+
+static uint32_t g_inode_cachegen = 1;
+static int g_inode_cachewriter;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_cache_hash
+ ****************************************************************************/
+
+static uint32_t inode_cache_hash(FAR const char *path)
+{
+  uint32_t hash = 2166136261u;
+
+  while (*path != '\0')
+    {
+      hash = (hash ^ (uint8_t)*path++) * 16777619u;
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_cache_lock
+ ****************************************************************************/
+
+void inode_cache_lock(void)
+{
+  g_inode_cachewriter++;
+  g_inode_cachegen++;
+  SP_DMB();
+}
+
+/****************************************************************************
+ * Name: inode_cache_unlock
+ ****************************************************************************/
+
+void inode_cache_unlock(void)
+{
+  SP_DMB();
+  g_inode_cachegen++;
+  g_inode_cachewriter--;
+}
+
+/****************************************************************************
+ * Name: inode_cache_lookup
+ ****************************************************************************/
+
+bool inode_cache_lookup(FAR const char *path,
+                        FAR struct inode_search_s *desc,
+                        FAR int *result, FAR uint32_t *gen)
+{
+  FAR struct inode_cache_s *entry;
+  irqstate_t flags;
+  uint32_t hash;
+  bool hit = false;
+
+  *gen = g_inode_cachegen;
+  if (g_inode_cachewriter > 0)
+    {
+      return false;
+    }
+
+  hash  = inode_cache_hash(path);
+  entry = &g_inode_cache[hash % CONFIG_FS_INODE_CACHE];
+
+  flags = spin_lock_irqsave(&g_inode_cachelock);
+  if (entry->path != NULL && entry->gen == *gen &&
+      entry->hash == hash && entry->nofollow == desc->nofollow &&
+      strcmp(entry->path, path) == 0)
+    {
+      desc->path    = path + entry->pathoff;
+      desc->node    = entry->node;
+      desc->peer    = entry->peer;
+      desc->parent  = entry->parent;
+      desc->relpath = entry->reloff < 0 ? NULL : path + entry->reloff;
+      *result       = entry->result;
+      hit           = true;
+    }
+
+  spin_unlock_irqrestore(&g_inode_cachelock, flags);
+  return hit;
+}
+
+/****************************************************************************
+ * Name: inode_cache_insert
+ ****************************************************************************/
+
+void inode_cache_insert(FAR const char *path,
+                        FAR const struct inode_search_s *desc, int result,
+                        uint32_t gen)
+{
+  FAR struct inode_cache_s *entry;
+  FAR char *oldpath;
+  FAR char *newpath;
+  irqstate_t flags;
+  size_t len;
+  uint32_t hash;
+
+  /* The result of a search through soft links depends on more than the
+   * path and may point into buffers that do not outlive the search.
+   */
+
+  if (g_inode_cachewriter > 0 || desc->linked ||
+      (result != OK && result != -ENOENT))
+    {
+      return;
+    }
+
+  len = strlen(path);
+  if (len > INT16_MAX || desc->path < path || desc->path > path + len ||
+      (desc->relpath != NULL &&
+       (desc->relpath < path || desc->relpath > path + len)))
+    {
+      return;
+    }
+
+  newpath = fs_heap_strdup(path);
+  if (newpath == NULL)
+    {
+      return;
+    }
+
+  hash  = inode_cache_hash(path);
+  entry = &g_inode_cache[hash % CONFIG_FS_INODE_CACHE];
+
+  flags           = spin_lock_irqsave(&g_inode_cachelock);
+  oldpath         = entry->path;
+  entry->path     = newpath;
+  entry->hash     = hash;
+  entry->gen      = gen;
+  entry->node     = desc->node;
+  entry->peer     = desc->peer;
+  entry->parent   = desc->parent;
+  entry->result   = result;
+  entry->reloff   = desc->relpath == NULL ? -1 : desc->relpath - path;
+  entry->pathoff  = desc->path - path;
+  entry->nofollow = desc->nofollow;
+  spin_unlock_irqrestore(&g_inode_cachelock, flags);
+
+  if (oldpath != NULL)
+    {
+      fs_heap_free(oldpath);
+    }
+}
+
+#endif /* CONFIG_FS_INODE_CACHE > 0 */
@@ -51,6 +51,16 @@ int inode_find(FAR struct inode_search_s *desc)
 {
   int ret;
 
+#ifdef CONFIG_FS_INODE_RCU
+  /* Most of the time the tree does not change during the search */
+
+  ret = inode_rcu_find(desc);
+  if (ret != -EAGAIN)
+    {
+      return ret;
+    }
+#endif
+
   /* Find the node matching the path.  If found, increment the count of
    * references on the node.
    */
@@ -29,23 +29,39 @@
 
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/wqueue.h>
 
 #include "inode/inode.h"
 #include "fs_heap.h"
 
 /****************************************************************************
- * Public Functions
+ * Private Data
  ****************************************************************************/
 
+#ifdef CONFIG_FS_INODE_RCU
+/* Unlinked inodes waiting for the lockless searches to be done with them,
+ * chained through i_peer.
+ */
+
+static FAR struct inode *g_inode_freelist;
+static spinlock_t g_inode_freelock = SP_UNLOCKED;
+static struct work_s g_inode_freework;
+#endif
+
 /****************************************************************************
- * Name: inode_free
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_freetree
  *
  * Description:
- *   Free resources used by an inode
+ *   Free an inode together with its peers and children
  *
  ****************************************************************************/
 
-void inode_free(FAR struct inode *inode)
+static void inode_freetree(FAR struct inode *inode)
 {
   /* Verify that we were passed valid pointer to an inode */
 
@@ -60,8 +76,8 @@ void inode_free(FAR struct inode *inode)
 
       /* Free all peers and children of this i_node */
 
-      inode_free(inode->i_peer);
-      inode_free(inode->i_child);
+      inode_freetree(inode->i_peer);
+      inode_freetree(inode->i_child);
 
 #ifdef CONFIG_PSEUDOFS_SOFTLINKS
       /* If the inode is a symbolic link, the free the path to the linked
@@ -77,3 +93,73 @@ void inode_free(FAR struct inode *inode)
       fs_heap_free(inode);
     }
 }
+
+/****************************************************************************
+ * Name: inode_freeworker
+ *
+ * Description:
+ *   Free the inodes queued by inode_free() once no lockless search can
+ *   see them anymore.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_INODE_RCU
+static void inode_freeworker(FAR void *arg)
+{
+  FAR struct inode *inode;
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&g_inode_freelock);
+  inode = g_inode_freelist;
+  g_inode_freelist = NULL;
+  spin_unlock_irqrestore(&g_inode_freelock, flags);
+
+  inode_rcu_synchronize();
+
+  while (inode != NULL)
+    {
+      FAR struct inode *next = inode->i_peer;
+
+      inode->i_peer = NULL;
+      inode_freetree(inode);
+      inode = next;
+    }
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_free
+ *
+ * Description:
+ *   Free resources used by an inode.  With CONFIG_FS_INODE_RCU, the memory
+ *   is only freed later, since a lockless search may still be looking at
+ *   the inode.
+ *
+ ****************************************************************************/
+
+void inode_free(FAR struct inode *inode)
+{
+#ifdef CONFIG_FS_INODE_RCU
+  irqstate_t flags;
+
+  if (inode == NULL)
+    {
+      return;
+    }
+
+  DEBUGASSERT(inode->i_peer == NULL);
+
+  flags = spin_lock_irqsave(&g_inode_freelock);
+  inode->i_peer = g_inode_freelist;
+  g_inode_freelist = inode;
+  spin_unlock_irqrestore(&g_inode_freelock, flags);
+
+  work_queue(LPWORK, &g_inode_freework, inode_freeworker, NULL, 0);
+#else
+  inode_freetree(inode);
+#endif
+}
@@ -0,0 +1,248 @@
+/****************************************************************************
+ * fs/inode/fs_inodercu.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/atomic.h>
+#include <nuttx/clock.h>
+#include <nuttx/signal.h>
+#include <nuttx/spinlock.h>
+
+#include "inode/inode.h"
+
+#ifdef CONFIG_FS_INODE_RCU
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The reader counts of each CPU get a cache line of their own */
+
+#define INODE_RCU_ALIGN 64
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A lockless search counts itself in the active phase on the CPU that it
+ * started on and uncounts itself there, even if it migrated meanwhile.  So
+ * only the sum over all CPUs is meaningful.
+ */
+
+struct inode_rcu_s
+{
+  atomic_int count[2] aligned_data(INODE_RCU_ALIGN); /* Searches per phase */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct inode_rcu_s g_inode_rcu[CONFIG_SMP_NCPUS];
+
+/* The phase new searches are counted in, flipped by the writer */
+
+static volatile unsigned int g_inode_rcuphase;
+
+/* Odd while the inode tree is write locked, so that searches that raced
+ * with a writer are detected and repeated with the lock held.  Only the
+ * outermost of the nested write locks counts.
+ */
+
+static volatile unsigned int g_inode_rcuseq;
+static int g_inode_rcuwriter;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_rcu_readers
+ *
+ * Description:
+ *   Return the number of lockless searches counted in 'phase'.
+ *
+ ****************************************************************************/
+
+static int inode_rcu_readers(unsigned int phase)
+{
+  int count = 0;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      count += atomic_load(&g_inode_rcu[cpu].count[phase]);
+    }
+
+  return count;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_rcu_lock
+ ****************************************************************************/
+
+void inode_rcu_lock(void)
+{
+  if (g_inode_rcuwriter++ == 0)
+    {
+      g_inode_rcuseq++;
+      SP_DMB();
+    }
+}
+
+/****************************************************************************
+ * Name: inode_rcu_unlock
+ ****************************************************************************/
+
+void inode_rcu_unlock(void)
+{
+  DEBUGASSERT(g_inode_rcuwriter > 0);
+
+  if (--g_inode_rcuwriter == 0)
+    {
+      SP_DMB();
+      g_inode_rcuseq++;
+    }
+}
+
+/****************************************************************************
+ * Name: inode_rcu_find
+ *
+ * Description:
+ *   Search for an inode and take a reference on it, like inode_find(), but
+ *   without taking the inode tree lock.  The search only writes to the
+ *   reader count of the current CPU and to the found inode.
+ *
+ * Returned Value:
+ *   The result of inode_search(), or -EAGAIN if the inode tree was changed
+ *   during the search.  In that case 'desc' is set up for the search again.
+ *
+ ****************************************************************************/
+
+int inode_rcu_find(FAR struct inode_search_s *desc)
+{
+  FAR const char *path = desc->path;
+  bool nofollow = desc->nofollow;
+  unsigned int phase;
+  unsigned int seq;
+  int cpu;
+  int ret;
+
+  seq = g_inode_rcuseq;
+  if ((seq & 1) != 0)
+    {
+      return -EAGAIN;
+    }
+
+  cpu   = this_cpu();
+  phase = g_inode_rcuphase & 1;
+  atomic_fetch_add(&g_inode_rcu[cpu].count[phase], 1);
+  SP_DMB();
+
+  ret = inode_search(desc);
+  if (ret >= 0)
+    {
+      FAR struct inode *inode = desc->node;
+      short crefs = atomic_load(&inode->i_crefs);
+
+      /* An inode without references is unlinked and waiting to be freed,
+       * so it must not be revived.
+       */
+
+      do
+        {
+          if (crefs <= 0)
+            {
+              ret = -EAGAIN;
+              break;
+            }
+        }
+      while (!atomic_compare_exchange_weak(&inode->i_crefs, &crefs,
+                                           crefs + 1));
+    }
+
+  SP_DMB();
+  if (ret != -EAGAIN && seq != g_inode_rcuseq)
+    {
+      if (ret >= 0)
+        {
+          inode_release(desc->node);
+        }
+
+      ret = -EAGAIN;
+    }
+
+  atomic_fetch_sub(&g_inode_rcu[cpu].count[phase], 1);
+
+  if (ret == -EAGAIN)
+    {
+      RELEASE_SEARCH(desc);
+      SETUP_SEARCH(desc, path, nofollow);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: inode_rcu_synchronize
+ *
+ * Description:
+ *   Wait until all lockless searches that may still see an inode unlinked
+ *   before the call are done.  The phase is flipped twice, since a search
+ *   may have read the phase right before a flip but not counted itself
+ *   yet.
+ *
+ ****************************************************************************/
+
+void inode_rcu_synchronize(void)
+{
+  int i;
+
+  SP_DMB();
+
+  for (i = 0; i < 2; i++)
+    {
+      unsigned int phase = g_inode_rcuphase & 1;
+
+      g_inode_rcuphase = phase ^ 1;
+      SP_DMB();
+
+      while (inode_rcu_readers(phase) > 0)
+        {
+          nxsig_usleep(USEC_PER_TICK);
+        }
+    }
+
+  SP_DMB();
+}
+
+#endif /* CONFIG_FS_INODE_RCU */
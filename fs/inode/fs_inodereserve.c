@@ -115,6 +115,7 @@ static void inode_insert(FAR struct inode *inode,
     {
       inode->i_peer   = peer->i_peer;
       inode->i_parent = parent;
+      INODE_RCU_PUBLISH();
       peer->i_peer    = inode;
     }
 
@@ -125,6 +126,7 @@ static void inode_insert(FAR struct inode *inode,
       DEBUGASSERT(parent != NULL);
       inode->i_peer   = parent->i_child;
       inode->i_parent = parent;
+      INODE_RCU_PUBLISH();
       parent->i_child = inode;
     }
 }
@@ -187,6 +187,7 @@ static int _inode_linktarget(FAR struct inode *inode,
     }
 
   desc->nofollow = save;
+  desc->linked   = true;
   return ret;
 }
 #endif
@@ -466,6 +467,10 @@ static FAR const char *_inode_getcwd(void)
 
 int inode_search(FAR struct inode_search_s *desc)
 {
+#if CONFIG_FS_INODE_CACHE > 0
+  FAR const char *path;
+  uint32_t gen;
+#endif
   int ret;
 
   /* Perform the common _inode_search() logic.  This does everything except
@@ -489,7 +494,18 @@ int inode_search(FAR struct inode_search_s *desc)
       desc->path = desc->buffer;
     }
 
+#if CONFIG_FS_INODE_CACHE > 0
+  path = desc->path;
+  if (inode_cache_lookup(path, desc, &ret, &gen))
+    {
+      return ret;
+    }
+
+  ret = _inode_search(desc);
+  inode_cache_insert(path, desc, ret, gen);
+#else
   ret = _inode_search(desc);
+#endif
 
 #ifdef CONFIG_PSEUDOFS_SOFTLINKS
   if (ret >= 0)
@@ -38,6 +38,7 @@
 #include <nuttx/sched.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/lib/lib.h>
+#include <nuttx/spinlock.h>
 
 #include "fs_heap.h"
 
@@ -55,9 +56,20 @@
       (d)->relpath  = NULL; \
       (d)->buffer   = NULL; \
       (d)->nofollow = (n); \
+      (d)->linked   = false; \
     } \
   while (0)
 
+/* Order the initialization of an inode before linking it into the tree,
+ * where lockless searches may find it right away.
+ */
+
+#ifdef CONFIG_FS_INODE_RCU
+#  define INODE_RCU_PUBLISH() SP_DMB()
+#else
+#  define INODE_RCU_PUBLISH()
+#endif
+
 #define RELEASE_SEARCH(d) \
   do \
     { \
@@ -129,6 +141,7 @@ struct inode_search_s
   FAR const char *relpath;   /* Relative path into the mountpoint */
   FAR char *buffer;          /* Path expansion buffer */
   bool nofollow;             /* true: Don't follow terminal soft link */
+  bool linked;               /* true: A soft link was followed */
 };
 
 /* Callback used by foreach_inode to traverse all inodes in the pseudo-
@@ -209,6 +222,108 @@ void inode_unlock(void);
 
 void inode_runlock(void);
 
+/****************************************************************************
+ * Name: inode_cache_lock and inode_cache_unlock
+ *
+ * Description:
+ *   Called by inode_lock() and inode_unlock().  Any entry of the path
+ *   lookup cache is stale once the inode tree was write locked, and the
+ *   cache is bypassed by the owner of the write lock since it may change
+ *   the tree between its searches.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FS_INODE_CACHE > 0
+void inode_cache_lock(void);
+void inode_cache_unlock(void);
+#else
+#  define inode_cache_lock()
+#  define inode_cache_unlock()
+#endif
+
+/****************************************************************************
+ * Name: inode_cache_lookup
+ *
+ * Description:
+ *   Look up the result of an earlier search of the absolute 'path'.  On a
+ *   hit, 'desc' is filled in as _inode_search() would have and the result
+ *   of that search is returned in 'result'.  On a miss, the generation of
+ *   the cache to pass to inode_cache_insert() is returned in 'gen'.
+ *
+ * Assumptions:
+ *   The caller holds the inode tree lock
+ *
+ ****************************************************************************/
+
+#if CONFIG_FS_INODE_CACHE > 0
+bool inode_cache_lookup(FAR const char *path,
+                        FAR struct inode_search_s *desc,
+                        FAR int *result, FAR uint32_t *gen);
+#endif
+
+/****************************************************************************
+ * Name: inode_cache_insert
+ *
+ * Description:
+ *   Remember the result of the search of the absolute 'path' in 'desc',
+ *   either an inode or the absence of one.  The entry is only valid if the
+ *   cache is still at generation 'gen', the one before the search began.
+ *
+ * Assumptions:
+ *   The caller holds the inode tree lock
+ *
+ ****************************************************************************/
+
+#if CONFIG_FS_INODE_CACHE > 0
+void inode_cache_insert(FAR const char *path,
+                        FAR const struct inode_search_s *desc, int result,
+                        uint32_t gen);
+#endif
+
+/****************************************************************************
+ * Name: inode_rcu_lock and inode_rcu_unlock
+ *
+ * Description:
+ *   Called by inode_lock() and inode_unlock() to make lockless searches
+ *   that overlap with a change of the inode tree fail.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_INODE_RCU
+void inode_rcu_lock(void);
+void inode_rcu_unlock(void);
+#else
+#  define inode_rcu_lock()
+#  define inode_rcu_unlock()
+#endif
+
+/****************************************************************************
+ * Name: inode_rcu_find
+ *
+ * Description:
+ *   Try inode_find() without taking the inode tree lock.  Returns -EAGAIN
+ *   if the tree changed meanwhile, to be retried with the lock held.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_INODE_RCU
+int inode_rcu_find(FAR struct inode_search_s *desc);
+#endif
+
+/****************************************************************************
+ * Name: inode_rcu_synchronize
+ *
+ * Description:
+ *   Wait for the lockless searches that may still reference an unlinked
+ *   inode.  Only used by the deferred freeing of inodes, which runs on one
+ *   work queue thread at a time.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_INODE_RCU
+void inode_rcu_synchronize(void);
+#endif
+
 /****************************************************************************
  * Name: inode_search
  *
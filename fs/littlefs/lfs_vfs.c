@@ -26,6 +26,8 @@
 
 #include <errno.h>
 #include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include <nuttx/fs/fs.h>
@@ -58,12 +60,17 @@ struct littlefs_dir_s
 {
   struct fs_dirent_s    base;
   struct lfs_dir        dir;
+  char                  relpath[1]; /* The path opened, for readdirplus */
 };
 
 struct littlefs_file_s
 {
   struct lfs_file       file;
   int                   refs;
+#if CONFIG_FS_LITTLEFS_OPEN_CACHE > 0
+  FAR char             *path;   /* Path of a read-only file, to cache it */
+  uint32_t              gen;    /* fs->gen when opened */
+#endif
 };
 
 /* This structure represents the overall mountpoint state. An instance of
@@ -78,6 +85,15 @@ struct littlefs_mountpt_s
   struct mtd_geometry_s geo;
   struct lfs_config     cfg;
   struct lfs            lfs;
+#if CONFIG_FS_LITTLEFS_OPEN_CACHE > 0
+
+  /* The read-only files closed lately, the most recent first.  They are
+   * kept open, so that opening them again doesn't look up the path.
+   */
+
+  FAR struct littlefs_file_s *ocache[CONFIG_FS_LITTLEFS_OPEN_CACHE];
+  uint32_t              gen;    /* Count of the changes to the files */
+#endif
 };
 
 struct littlefs_attr_s
@@ -125,6 +141,10 @@ static int     littlefs_closedir(FAR struct inode *mountpt,
 static int     littlefs_readdir(FAR struct inode *mountpt,
                                 FAR struct fs_dirent_s *dir,
                                 FAR struct dirent *entry);
+static int     littlefs_readdirplus(FAR struct inode *mountpt,
+                                    FAR struct fs_dirent_s *dir,
+                                    FAR struct dirent *entry,
+                                    FAR struct stat *buf);
 static int     littlefs_rewinddir(FAR struct inode *mountpt,
                                   FAR struct fs_dirent_s *dir);
 
@@ -144,6 +164,10 @@ static int     littlefs_rmdir(FAR struct inode *mountpt,
 static int     littlefs_rename(FAR struct inode *mountpt,
                                FAR const char *oldrelpath,
                                FAR const char *newrelpath);
+static int     littlefs_getstat(FAR struct littlefs_mountpt_s *fs,
+                                FAR const char *relpath,
+                                FAR const struct lfs_info *info,
+                                FAR struct stat *buf);
 static int     littlefs_stat(FAR struct inode *mountpt,
                              FAR const char *relpath, FAR struct stat *buf);
 static int     littlefs_chstat(FAR struct inode *mountpt,
@@ -190,7 +214,9 @@ const struct mountpt_operations g_littlefs_operations =
   littlefs_rmdir,         /* rmdir */
   littlefs_rename,        /* rename */
   littlefs_stat,          /* stat */
-  littlefs_chstat         /* chstat */
+  littlefs_chstat,        /* chstat */
+  NULL,                   /* syncfs */
+  littlefs_readdirplus    /* readdirplus */
 };
 
 /****************************************************************************
@@ -294,6 +320,131 @@ static int littlefs_convert_oflags(int oflags)
   return ret;
 }
 
+/****************************************************************************
+ * Name: littlefs_ocache_free
+ ****************************************************************************/
+
+#if CONFIG_FS_LITTLEFS_OPEN_CACHE > 0
+static void littlefs_ocache_free(FAR struct littlefs_mountpt_s *fs,
+                                 FAR struct littlefs_file_s *priv)
+{
+  lfs_file_close(&fs->lfs, &priv->file);
+  fs_heap_free(priv->path);
+  fs_heap_free(priv);
+}
+
+/****************************************************************************
+ * Name: littlefs_ocache_take
+ *
+ * Description:
+ *   Take the cached handle of relpath out of the cache, NULL if none.
+ *
+ ****************************************************************************/
+
+static FAR struct littlefs_file_s *
+littlefs_ocache_take(FAR struct littlefs_mountpt_s *fs,
+                     FAR const char *relpath)
+{
+  FAR struct littlefs_file_s *priv;
+  int i;
+
+  for (i = 0; i < CONFIG_FS_LITTLEFS_OPEN_CACHE; i++)
+    {
+      priv = fs->ocache[i];
+      if (priv != NULL && strcmp(priv->path, relpath) == 0)
+        {
+          for (; i < CONFIG_FS_LITTLEFS_OPEN_CACHE - 1; i++)
+            {
+              fs->ocache[i] = fs->ocache[i + 1];
+            }
+
+          fs->ocache[i] = NULL;
+          return priv;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: littlefs_ocache_put
+ *
+ * Description:
+ *   Keep the handle of a closed read-only file, and close the least
+ *   recently used one if the cache is full.  littlefs doesn't update the
+ *   open files with the changes done through other handles, so a handle
+ *   open while any file changed is closed instead.
+ *
+ ****************************************************************************/
+
+static void littlefs_ocache_put(FAR struct littlefs_mountpt_s *fs,
+                                FAR struct littlefs_file_s *priv)
+{
+  int i = CONFIG_FS_LITTLEFS_OPEN_CACHE - 1;
+
+  if (priv->gen != fs->gen)
+    {
+      littlefs_ocache_free(fs, priv);
+      return;
+    }
+
+  if (fs->ocache[i] != NULL)
+    {
+      littlefs_ocache_free(fs, fs->ocache[i]);
+    }
+
+  for (; i > 0; i--)
+    {
+      fs->ocache[i] = fs->ocache[i - 1];
+    }
+
+  fs->ocache[0] = priv;
+}
+
+/****************************************************************************
+ * Name: littlefs_ocache_drop
+ *
+ * Description:
+ *   Close the cached handles of the file, which is being changed, or all of
+ *   them if file is NULL.  The open files follow the moves of their entry
+ *   in the metadata pairs, so that the pair and the id identify the file.
+ *
+ ****************************************************************************/
+
+static void littlefs_ocache_drop(FAR struct littlefs_mountpt_s *fs,
+                                 FAR const struct lfs_file *file)
+{
+  FAR struct littlefs_file_s *priv;
+  int i;
+  int j;
+
+  fs->gen++;
+  for (i = j = 0; i < CONFIG_FS_LITTLEFS_OPEN_CACHE; i++)
+    {
+      priv = fs->ocache[i];
+      fs->ocache[i] = NULL;
+      if (priv == NULL)
+        {
+          continue;
+        }
+
+      if (file == NULL ||
+          (priv->file.id == file->id &&
+           priv->file.m.pair[0] == file->m.pair[0] &&
+           priv->file.m.pair[1] == file->m.pair[1]))
+        {
+          littlefs_ocache_free(fs, priv);
+        }
+      else
+        {
+          fs->ocache[j++] = priv;
+        }
+    }
+}
+#else
+#  define littlefs_ocache_drop(fs, file)
+#endif
+
 /****************************************************************************
  * Name: littlefs_open
  ****************************************************************************/
@@ -313,34 +464,68 @@ static int littlefs_open(FAR struct file *filep, FAR const char *relpath,
   inode = filep->f_inode;
   fs    = inode->i_private;
 
+  /* Lock */
+
+  ret = nxmutex_lock(&fs->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  oflags = littlefs_convert_oflags(oflags);
+
+#if CONFIG_FS_LITTLEFS_OPEN_CACHE > 0
+  /* Reuse the handle of a read-only file closed lately */
+
+  if (oflags == LFS_O_RDONLY)
+    {
+      priv = littlefs_ocache_take(fs, relpath);
+      if (priv != NULL)
+        {
+          priv->refs = 1;
+          priv->gen  = fs->gen;
+          nxmutex_unlock(&fs->lock);
+          filep->f_priv = priv;
+          return OK;
+        }
+    }
+#endif
+
   /* Allocate memory for the open file */
 
-  priv = fs_heap_malloc(sizeof(*priv));
+  priv = fs_heap_zalloc(sizeof(*priv));
   if (priv == NULL)
     {
-      return -ENOMEM;
+      ret = -ENOMEM;
+      goto errout;
     }
 
   priv->refs = 1;
 
-  /* Lock */
-
-  ret = nxmutex_lock(&fs->lock);
-  if (ret < 0)
+#if CONFIG_FS_LITTLEFS_OPEN_CACHE > 0
+  if (oflags == LFS_O_RDONLY)
     {
-      goto errlock;
+      priv->path = fs_heap_strdup(relpath);
+      priv->gen  = fs->gen;
     }
+#endif
 
   /* Try to open the file */
 
-  oflags = littlefs_convert_oflags(oflags);
   ret = littlefs_convert_result(lfs_file_open(&fs->lfs, &priv->file,
                                               relpath, oflags));
   if (ret < 0)
     {
       /* Error opening file */
 
-      goto errout;
+      goto errout_with_priv;
+    }
+
+  /* The cached handles of the file won't see what this one changes */
+
+  if ((oflags & LFS_O_WRONLY) != 0)
+    {
+      littlefs_ocache_drop(fs, &priv->file);
     }
 
   if (oflags & LFS_O_CREAT)
@@ -395,10 +580,13 @@ static int littlefs_open(FAR struct file *filep, FAR const char *relpath,
 
 errout_with_file:
   lfs_file_close(&fs->lfs, &priv->file);
+errout_with_priv:
+#if CONFIG_FS_LITTLEFS_OPEN_CACHE > 0
+  fs_heap_free(priv->path);
+#endif
+  fs_heap_free(priv);
 errout:
   nxmutex_unlock(&fs->lock);
-errlock:
-  fs_heap_free(priv);
   return ret;
 }
 
@@ -427,17 +615,35 @@ static int littlefs_close(FAR struct file *filep)
       return ret;
     }
 
-  if (--priv->refs <= 0)
+  if (--priv->refs > 0)
     {
-      ret = littlefs_convert_result(lfs_file_close(&fs->lfs, &priv->file));
+      nxmutex_unlock(&fs->lock);
+      return OK;
     }
 
-  nxmutex_unlock(&fs->lock);
-  if (priv->refs <= 0)
+#if CONFIG_FS_LITTLEFS_OPEN_CACHE > 0
+  /* Keep a read-only file open, in case it is opened again */
+
+  if (priv->path != NULL)
+    {
+      littlefs_ocache_put(fs, priv);
+      nxmutex_unlock(&fs->lock);
+      return OK;
+    }
+#endif
+
+  if ((priv->file.flags & LFS_O_WRONLY) != 0)
     {
-      fs_heap_free(priv);
+      littlefs_ocache_drop(fs, &priv->file);
     }
 
+  ret = littlefs_convert_result(lfs_file_close(&fs->lfs, &priv->file));
+  nxmutex_unlock(&fs->lock);
+
+#if CONFIG_FS_LITTLEFS_OPEN_CACHE > 0
+  fs_heap_free(priv->path);
+#endif
+  fs_heap_free(priv);
   return ret;
 }
 
@@ -674,6 +880,11 @@ static int littlefs_sync(FAR struct file *filep)
     }
 
   ret = littlefs_convert_result(lfs_file_sync(&fs->lfs, &priv->file));
+  if ((priv->file.flags & LFS_O_WRONLY) != 0)
+    {
+      littlefs_ocache_drop(fs, &priv->file);
+    }
+
   nxmutex_unlock(&fs->lock);
 
   return ret;
@@ -894,6 +1105,7 @@ static int littlefs_truncate(FAR struct file *filep, off_t length)
 
   ret = littlefs_convert_result(lfs_file_truncate(&fs->lfs, &priv->file,
                                                   length));
+  littlefs_ocache_drop(fs, &priv->file);
   nxmutex_unlock(&fs->lock);
 
   return ret;
@@ -920,12 +1132,14 @@ static int littlefs_opendir(FAR struct inode *mountpt,
 
   /* Allocate memory for the open directory */
 
-  ldir = fs_heap_malloc(sizeof(*ldir));
+  ldir = fs_heap_malloc(sizeof(*ldir) + strlen(relpath));
   if (ldir == NULL)
     {
       return -ENOMEM;
     }
 
+  strcpy(ldir->relpath, relpath);
+
   /* Take the lock */
 
   ret = nxmutex_lock(&fs->lock);
@@ -1039,6 +1253,66 @@ static int littlefs_readdir(FAR struct inode *mountpt,
   return ret;
 }
 
+/****************************************************************************
+ * Name: littlefs_readdirplus
+ *
+ * Description:
+ *   Read the next directory entry and its attributes.  The type and the
+ *   size come with the entry, only the attributes of NuttX are looked up
+ *   by the path.
+ *
+ ****************************************************************************/
+
+static int littlefs_readdirplus(FAR struct inode *mountpt,
+                                FAR struct fs_dirent_s *dir,
+                                FAR struct dirent *entry,
+                                FAR struct stat *buf)
+{
+  FAR struct littlefs_mountpt_s *fs;
+  FAR struct littlefs_dir_s *ldir;
+  struct lfs_info info;
+  FAR char *path;
+  int ret;
+
+  /* Recover our private data from the inode instance */
+
+  ldir = (FAR struct littlefs_dir_s *)dir;
+  fs   = mountpt->i_private;
+
+  path = lib_get_pathbuffer();
+  if (path == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ret = nxmutex_lock(&fs->lock);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  ret = littlefs_convert_result(lfs_dir_read(&fs->lfs, &ldir->dir, &info));
+  if (ret > 0)
+    {
+      entry->d_type = info.type == LFS_TYPE_REG ? DTYPE_FILE :
+                                                  DTYPE_DIRECTORY;
+      strlcpy(entry->d_name, info.name, sizeof(entry->d_name));
+
+      snprintf(path, PATH_MAX, "%s/%s", ldir->relpath, info.name);
+      ret = littlefs_getstat(fs, path, &info, buf);
+    }
+  else if (ret == 0)
+    {
+      ret = -ENOENT;
+    }
+
+  nxmutex_unlock(&fs->lock);
+
+errout:
+  lib_put_pathbuffer(path);
+  return ret;
+}
+
 /****************************************************************************
  * Name: littlefs_rewindir
  *
@@ -1187,6 +1461,89 @@ static int littlefs_sync_block(FAR const struct lfs_config *c)
   return ret == -ENOTTY ? OK : ret;
 }
 
+/****************************************************************************
+ * Name: littlefs_parse_options
+ *
+ * Description:
+ *   Apply the mount options to the configuration.  The options are comma
+ *   separated:
+ *
+ *     forceformat          - Format the device before mounting it
+ *     autoformat           - Format the device if it can't be mounted
+ *     cache_size=<bytes>   - The cache of the device and of each file
+ *     lookahead_size=<n>   - The bytes of the block allocation bitmap
+ *     block_cycles=<n>     - The erase cycles before moving the metadata,
+ *                            -1 to disable the wear leveling
+ *
+ ****************************************************************************/
+
+static int littlefs_parse_options(FAR struct littlefs_mountpt_s *fs,
+                                  FAR const char *data,
+                                  FAR bool *forceformat,
+                                  FAR bool *autoformat)
+{
+  FAR char *options;
+  FAR char *saveptr;
+  FAR char *ptr;
+
+  *forceformat = false;
+  *autoformat  = false;
+
+  if (data == NULL)
+    {
+      return OK;
+    }
+
+  options = fs_heap_strdup(data);
+  if (options == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ptr = strtok_r(options, ",", &saveptr);
+  while (ptr != NULL)
+    {
+      if (strcmp(ptr, "forceformat") == 0)
+        {
+          *forceformat = true;
+        }
+      else if (strcmp(ptr, "autoformat") == 0)
+        {
+          *autoformat = true;
+        }
+      else if (strncmp(ptr, "cache_size=", 11) == 0)
+        {
+          fs->cfg.cache_size = strtoul(&ptr[11], NULL, 0);
+        }
+      else if (strncmp(ptr, "lookahead_size=", 15) == 0)
+        {
+          fs->cfg.lookahead_size = strtoul(&ptr[15], NULL, 0);
+        }
+      else if (strncmp(ptr, "block_cycles=", 13) == 0)
+        {
+          fs->cfg.block_cycles = strtol(&ptr[13], NULL, 0);
+        }
+
+      ptr = strtok_r(NULL, ",", &saveptr);
+    }
+
+  fs_heap_free(options);
+
+  /* littlefs asserts on these, refuse them here instead */
+
+  if (fs->cfg.cache_size == 0 ||
+      fs->cfg.cache_size % fs->cfg.read_size != 0 ||
+      fs->cfg.cache_size % fs->cfg.prog_size != 0 ||
+      fs->cfg.block_size % fs->cfg.cache_size != 0 ||
+      fs->cfg.lookahead_size == 0 || fs->cfg.lookahead_size % 8 != 0 ||
+      fs->cfg.block_cycles == 0)
+    {
+      return -EINVAL;
+    }
+
+  return OK;
+}
+
 /****************************************************************************
  * Name: littlefs_bind
  ****************************************************************************/
@@ -1195,6 +1552,8 @@ static int littlefs_bind(FAR struct inode *driver, FAR const void *data,
                          FAR void **handle)
 {
   FAR struct littlefs_mountpt_s *fs;
+  bool forceformat;
+  bool autoformat;
   int ret;
 
   /* Open the block driver */
@@ -1295,13 +1654,21 @@ static int littlefs_bind(FAR struct inode *driver, FAR const void *data,
   fs->cfg.lookahead_size = CONFIG_FS_LITTLEFS_LOOKAHEAD_SIZE;
 #endif
 
+  /* The mount options override the defaults of Kconfig */
+
+  ret = littlefs_parse_options(fs, data, &forceformat, &autoformat);
+  if (ret < 0)
+    {
+      goto errout_with_fs;
+    }
+
   /* Then get information about the littlefs filesystem on the devices
    * managed by this driver.
    */
 
   /* Force format the device if -o forceformat */
 
-  if (data && strcmp(data, "forceformat") == 0)
+  if (forceformat)
     {
       ret = littlefs_convert_result(lfs_format(&fs->lfs, &fs->cfg));
       if (ret < 0)
@@ -1315,7 +1682,7 @@ static int littlefs_bind(FAR struct inode *driver, FAR const void *data,
     {
       /* Auto format the device if -o autoformat */
 
-      if (ret != -EFAULT || !data || strcmp(data, "autoformat"))
+      if (ret != -EFAULT || !autoformat)
         {
           goto errout_with_fs;
         }
@@ -1373,6 +1740,7 @@ static int littlefs_unbind(FAR void *handle, FAR struct inode **driver,
       return ret;
     }
 
+  littlefs_ocache_drop(fs, NULL);
   ret = littlefs_convert_result(lfs_unmount(&fs->lfs));
   nxmutex_unlock(&fs->lock);
 
@@ -1474,6 +1842,7 @@ static int littlefs_unlink(FAR struct inode *mountpt,
       return ret;
     }
 
+  littlefs_ocache_drop(fs, NULL);
   ret = littlefs_convert_result(lfs_remove(&fs->lfs, relpath));
   nxmutex_unlock(&fs->lock);
 
@@ -1611,6 +1980,7 @@ static int littlefs_rename(FAR struct inode *mountpt,
       return ret;
     }
 
+  littlefs_ocache_drop(fs, NULL);
   ret = littlefs_convert_result(lfs_rename(&fs->lfs, oldrelpath,
                                            newrelpath));
   nxmutex_unlock(&fs->lock);
@@ -1619,54 +1989,40 @@ static int littlefs_rename(FAR struct inode *mountpt,
 }
 
 /****************************************************************************
- * Name: littlefs_stat
+ * Name: littlefs_getstat
  *
- * Description: Return information about a file or directory
+ * Description:
+ *   Fill the stat buffer from the information given by lfs_stat() or
+ *   lfs_dir_read(), and from the attributes of the file.
+ *
+ * Assumptions:
+ *   The caller holds the lock of the mountpoint
  *
  ****************************************************************************/
 
-static int littlefs_stat(FAR struct inode *mountpt, FAR const char *relpath,
-                         FAR struct stat *buf)
+static int littlefs_getstat(FAR struct littlefs_mountpt_s *fs,
+                            FAR const char *relpath,
+                            FAR const struct lfs_info *info,
+                            FAR struct stat *buf)
 {
-  FAR struct littlefs_mountpt_s *fs;
-  struct lfs_info info;
   struct littlefs_attr_s attr;
   int ret;
 
   memset(buf, 0, sizeof(*buf));
 
-  /* Get the mountpoint private data from the inode structure */
-
-  fs = mountpt->i_private;
-
-  /* Call the LFS to do the stat operation */
-
-  ret = nxmutex_lock(&fs->lock);
-  if (ret < 0)
-    {
-      return ret;
-    }
-
-  ret = lfs_stat(&fs->lfs, relpath, &info);
-  if (ret < 0)
-    {
-      goto errout;
-    }
-
   ret = littlefs_convert_result(lfs_getattr(&fs->lfs, relpath, 0,
                                             &attr, sizeof(attr)));
   if (ret < 0)
     {
       if (ret != -ENODATA)
         {
-          goto errout;
+          return ret;
         }
 
       memset(&attr, 0, sizeof(attr));
       attr.at_mode = S_IRWXG | S_IRWXU | S_IRWXO;
     }
 
-  ret = 0;
   buf->st_mode         = attr.at_mode;
   buf->st_uid          = attr.at_uid;
   buf->st_gid          = attr.at_gid;
@@ -1677,13 +2033,11 @@ static int littlefs_stat(FAR struct inode *mountpt, FAR const char *relpath,
   buf->st_ctim.tv_sec  = attr.at_ctim / 1000000000ull;
   buf->st_ctim.tv_nsec = attr.at_ctim % 1000000000ull;
   buf->st_blksize      = fs->cfg.block_size;
-  buf->st_blocks       = (buf->st_size + buf->st_blksize - 1) /
-                         buf->st_blksize;
 
-  if (info.type == LFS_TYPE_REG)
+  if (info->type == LFS_TYPE_REG)
     {
       buf->st_mode |= S_IFREG;
-      buf->st_size = info.size;
+      buf->st_size = info->size;
     }
   else
     {
@@ -1691,7 +2045,45 @@ static int littlefs_stat(FAR struct inode *mountpt, FAR const char *relpath,
       buf->st_size = 0;
     }
 
-errout:
+  buf->st_blocks       = (buf->st_size + buf->st_blksize - 1) /
+                         buf->st_blksize;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: littlefs_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int littlefs_stat(FAR struct inode *mountpt, FAR const char *relpath,
+                         FAR struct stat *buf)
+{
+  FAR struct littlefs_mountpt_s *fs;
+  struct lfs_info info;
+  int ret;
+
+  memset(buf, 0, sizeof(*buf));
+
+  /* Get the mountpoint private data from the inode structure */
+
+  fs = mountpt->i_private;
+
+  /* Call the LFS to do the stat operation */
+
+  ret = nxmutex_lock(&fs->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = lfs_stat(&fs->lfs, relpath, &info);
+  if (ret >= 0)
+    {
+      ret = littlefs_getstat(fs, relpath, &info, buf);
+    }
+
   nxmutex_unlock(&fs->lock);
   return ret;
 }
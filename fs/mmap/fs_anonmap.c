@@ -23,19 +23,292 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+#include <nuttx/arch.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/pgalloc.h>
 #include <nuttx/sched.h>
 #include <assert.h>
 #include <debug.h>
+#include <string.h>
 
 #include "fs_anonmap.h"
 #include "sched/sched.h"
 #include "fs_heap.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if defined(CONFIG_FS_ANONMAP_PGTHRESHOLD) && \
+    CONFIG_FS_ANONMAP_PGTHRESHOLD > 0
+#  define ANONMAP_PAGES 1
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+#ifdef ANONMAP_PAGES
+
+/****************************************************************************
+ * Name: pages_free
+ ****************************************************************************/
+
+static void pages_free(FAR uintptr_t *pages, unsigned int npages)
+{
+  while (npages-- > 0)
+    {
+      mm_pgfree(pages[npages], 1);
+    }
+}
+
+/****************************************************************************
+ * Name: pages_alloc
+ *
+ * Description:
+ *   Allocate 'npages' zeroed physical pages, one at a time since they need
+ *   not be contiguous.
+ *
+ ****************************************************************************/
+
+static int pages_alloc(FAR uintptr_t *pages, unsigned int npages)
+{
+  unsigned int i;
+
+  for (i = 0; i < npages; i++)
+    {
+      pages[i] = mm_pgalloc(1);
+      if (pages[i] == 0)
+        {
+          ferr("ERROR: mm_pgalloc(1) failed\n");
+          pages_free(pages, i);
+          return -ENOMEM;
+        }
+
+      memset((FAR void *)pages[i], 0, MM_PGSIZE);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: unmap_pages
+ *
+ * Description:
+ *   The munmap() of a page backed mapping.  Like for the heap backed ones,
+ *   only the end of the mapping can be released.  Priv holds the array of
+ *   the physical pages.
+ *
+ ****************************************************************************/
+
+static int unmap_pages(FAR struct task_group_s *group,
+                       FAR struct mm_map_entry_s *entry,
+                       FAR void *start,
+                       size_t length)
+{
+  FAR uintptr_t *pages = entry->priv.p;
+  unsigned int npages = MM_NPAGES(entry->length);
+  unsigned int keep;
+  off_t offset;
+
+  offset = (uintptr_t)start - (uintptr_t)entry->vaddr;
+  if (offset + length < entry->length)
+    {
+      ferr("ERROR: Cannot umap without unmapping to the end\n");
+      return -ENOSYS;
+    }
+
+  /* A partially unmapped page stays mapped */
+
+  keep = MM_NPAGES(offset);
+  if (keep >= npages)
+    {
+      return OK;
+    }
+
+  /* The address environment is going away if there is no group */
+
+  if (group != NULL)
+    {
+      FAR char *vaddr = (FAR char *)entry->vaddr + (keep << MM_PGSHIFT);
+
+      up_shmdt((uintptr_t)vaddr, npages - keep);
+      vm_release_region(get_group_mm(group), vaddr,
+                        (npages - keep) << MM_PGSHIFT);
+    }
+
+  pages_free(pages + keep, npages - keep);
+
+  if (keep > 0)
+    {
+      mm_map_update(get_group_mm(group), entry, entry->vaddr,
+                    keep << MM_PGSHIFT);
+      return OK;
+    }
+
+  kmm_free(pages);
+  return group != NULL ? mm_map_remove(get_group_mm(group), entry) : OK;
+}
+
+/****************************************************************************
+ * Name: map_pages
+ *
+ * Description:
+ *   Back an anonymous user mapping with physical pages mapped into the
+ *   shared memory virtual area, rather than with heap memory.
+ *
+ ****************************************************************************/
+
+static int map_pages(FAR struct mm_map_entry_s *entry)
+{
+  FAR struct mm_map_s *mm = get_current_mm();
+  unsigned int npages = MM_NPAGES(entry->length);
+  FAR uintptr_t *pages;
+  int ret;
+
+  pages = kmm_malloc(npages * sizeof(uintptr_t));
+  if (pages == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ret = pages_alloc(pages, npages);
+  if (ret < 0)
+    {
+      goto errout_with_array;
+    }
+
+  entry->vaddr = vm_alloc_region(mm, NULL, npages << MM_PGSHIFT);
+  if (entry->vaddr == NULL)
+    {
+      ferr("ERROR: vm_alloc_region() failed\n");
+      ret = -ENOMEM;
+      goto errout_with_pages;
+    }
+
+  ret = up_shmat(pages, npages, (uintptr_t)entry->vaddr);
+  if (ret < 0)
+    {
+      ferr("ERROR: up_shmat() failed: %d\n", ret);
+      goto errout_with_region;
+    }
+
+  entry->length = npages << MM_PGSHIFT;
+  entry->munmap = unmap_pages;
+  entry->priv.p = pages;
+
+  ret = mm_map_add(mm, entry);
+  if (ret < 0)
+    {
+      up_shmdt((uintptr_t)entry->vaddr, npages);
+      goto errout_with_region;
+    }
+
+  return OK;
+
+errout_with_region:
+  vm_release_region(mm, entry->vaddr, npages << MM_PGSHIFT);
+  entry->vaddr = NULL;
+errout_with_pages:
+  pages_free(pages, npages);
+errout_with_array:
+  kmm_free(pages);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: remap_pages
+ *
+ * Description:
+ *   Resize a page backed mapping.  More pages are mapped right behind the
+ *   mapping if that part of the virtual area is free.  Otherwise, with
+ *   'maymove', all pages are mapped again at a new address.  Either way no
+ *   data is copied.
+ *
+ ****************************************************************************/
+
+static int remap_pages(FAR struct mm_map_entry_s *entry, size_t new_size,
+                       bool maymove)
+{
+  FAR struct mm_map_s *mm = get_current_mm();
+  unsigned int oldpages = MM_NPAGES(entry->length);
+  unsigned int newpages = MM_NPAGES(new_size);
+  FAR char *tail = (FAR char *)entry->vaddr + entry->length;
+  FAR uintptr_t *pages;
+  FAR void *vaddr;
+  int ret;
+
+  if (newpages <= oldpages)
+    {
+      return unmap_pages(nxsched_self()->group, entry,
+                         (FAR char *)entry->vaddr + (newpages << MM_PGSHIFT),
+                         (oldpages - newpages) << MM_PGSHIFT);
+    }
+
+  pages = kmm_realloc(entry->priv.p, newpages * sizeof(uintptr_t));
+  if (pages == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  entry->priv.p = pages;
+
+  ret = pages_alloc(pages + oldpages, newpages - oldpages);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Try to grow in place first */
+
+  if (vm_alloc_region(mm, tail, (newpages - oldpages) << MM_PGSHIFT) != NULL)
+    {
+      ret = up_shmat(pages + oldpages, newpages - oldpages, (uintptr_t)tail);
+      if (ret < 0)
+        {
+          vm_release_region(mm, tail, (newpages - oldpages) << MM_PGSHIFT);
+          goto errout_with_pages;
+        }
+
+      mm_map_update(mm, entry, entry->vaddr, newpages << MM_PGSHIFT);
+      return OK;
+    }
+
+  if (!maymove)
+    {
+      ret = -ENOMEM;
+      goto errout_with_pages;
+    }
+
+  /* Map the old and the new pages together at a new address */
+
+  vaddr = vm_alloc_region(mm, NULL, newpages << MM_PGSHIFT);
+  if (vaddr == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_pages;
+    }
+
+  up_shmdt((uintptr_t)entry->vaddr, oldpages);
+  ret = up_shmat(pages, newpages, (uintptr_t)vaddr);
+  if (ret < 0)
+    {
+      vm_release_region(mm, vaddr, newpages << MM_PGSHIFT);
+      up_shmat(pages, oldpages, (uintptr_t)entry->vaddr);
+      goto errout_with_pages;
+    }
+
+  vm_release_region(mm, entry->vaddr, oldpages << MM_PGSHIFT);
+  mm_map_update(mm, entry, vaddr, newpages << MM_PGSHIFT);
+  return OK;
+
+errout_with_pages:
+  pages_free(pages + oldpages, newpages - oldpages);
+  return ret;
+}
+
+#endif /* ANONMAP_PAGES */
+
 /****************************************************************************
  * Name: unmap_anonymous
  ****************************************************************************/
@@ -106,8 +379,7 @@ static int unmap_anonymous(FAR struct task_group_s *group,
         }
 
       DEBUGASSERT(newaddr == entry->vaddr);
-      entry->vaddr = newaddr;
-      entry->length = length;
+      mm_map_update(get_group_mm(group), entry, newaddr, length);
     }
 
   return ret;
@@ -121,6 +393,17 @@ int map_anonymous(FAR struct mm_map_entry_s *entry, bool kernel)
 {
   int ret;
 
+#ifdef ANONMAP_PAGES
+  /* Large user mappings get pages of their own, so that they can grow
+   * without copying.
+   */
+
+  if (!kernel && entry->length >= CONFIG_FS_ANONMAP_PGTHRESHOLD)
+    {
+      return map_pages(entry);
+    }
+#endif
+
   /* REVISIT:  Should reside outside of the heap.  That is really the
    * only purpose of MAP_ANONYMOUS:  To get non-heap memory.  In KERNEL
    * build, this could be accomplished using pgalloc(), provided that
@@ -155,3 +438,61 @@ int map_anonymous(FAR struct mm_map_entry_s *entry, bool kernel)
 
   return ret;
 }
+
+int remap_anonymous(FAR struct mm_map_entry_s *entry, size_t new_size,
+                    bool maymove)
+{
+  bool kernel = entry->priv.i;
+  FAR void *newaddr;
+  size_t usable;
+
+#ifdef ANONMAP_PAGES
+  if (entry->munmap == unmap_pages)
+    {
+      return remap_pages(entry, new_size, maymove);
+    }
+#endif
+
+  DEBUGASSERT(entry->munmap == unmap_anonymous);
+
+  /* Shrinking and growing within the allocated block are done in place */
+
+  usable = kernel ? fs_heap_malloc_size(entry->vaddr) :
+                    kumm_malloc_size(entry->vaddr);
+  if (new_size <= entry->length || new_size <= usable)
+    {
+      if (new_size < entry->length)
+        {
+          newaddr = kernel ? fs_heap_realloc(entry->vaddr, new_size) :
+                             kumm_realloc(entry->vaddr, new_size);
+          DEBUGASSERT(newaddr == entry->vaddr);
+          UNUSED(newaddr);
+        }
+      else
+        {
+          memset((FAR char *)entry->vaddr + entry->length, 0,
+                 new_size - entry->length);
+        }
+
+      mm_map_update(get_current_mm(), entry, entry->vaddr, new_size);
+      return OK;
+    }
+
+  if (!maymove)
+    {
+      return -ENOMEM;
+    }
+
+  /* realloc() still grows in place if the following chunk is free */
+
+  newaddr = kernel ? fs_heap_realloc(entry->vaddr, new_size) :
+                     kumm_realloc(entry->vaddr, new_size);
+  if (newaddr == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  memset((FAR char *)newaddr + entry->length, 0, new_size - entry->length);
+  mm_map_update(get_current_mm(), entry, newaddr, new_size);
+  return OK;
+}
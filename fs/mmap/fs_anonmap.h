@@ -58,4 +58,32 @@ int map_anonymous(FAR struct mm_map_entry_s *entry, bool kernel);
 #  define map_anonymous(entry, kernel) (-ENOSYS)
 #endif /* CONFIG_FS_ANONMAP */
 
+/****************************************************************************
+ * Name: remap_anonymous
+ *
+ * Description:
+ *   Resize a mapping created by map_anonymous().  Newly mapped memory is
+ *   zeroed.
+ *
+ * Input Parameters:
+ *   entry     The mapping, updated with the new address and length
+ *   new_size  The new length of the mapping, not zero
+ *   maymove   True if the mapping may be moved to a new address
+ *
+ * Returned Value:
+ *   On success returns 0. Otherwise negated errno is returned appropriately.
+ *
+ *     ENOMEM
+ *       The mapping cannot grow in place and 'maymove' is false, or there
+ *       is not enough memory to grow it at all
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_ANONMAP
+int remap_anonymous(FAR struct mm_map_entry_s *entry, size_t new_size,
+                    bool maymove);
+#else
+#  define remap_anonymous(entry, new_size, maymove) (-ENOSYS)
+#endif /* CONFIG_FS_ANONMAP */
+
 #endif /* __FS_MMAP_FS_ANONMAP_H */
@@ -0,0 +1,130 @@
+/****************************************************************************
+ * fs/mmap/fs_mremap.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <nuttx/mm/map.h>
+
+#include <sys/types.h>
+#include <sys/mman.h>
+
+#include <errno.h>
+#include <debug.h>
+
+#include "fs_anonmap.h"
+#include "sched/sched.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static int file_mremap_(FAR void *old_address, size_t old_size,
+                        size_t new_size, int flags,
+                        FAR void **new_address)
+{
+  FAR struct mm_map_entry_s *entry;
+  int ret;
+
+  if (new_size == 0 || (flags & ~MREMAP_MAYMOVE) != 0)
+    {
+      return -EINVAL;
+    }
+
+  ret = mm_map_lock();
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Only whole mappings can be remapped */
+
+  entry = mm_map_find(get_current_mm(), old_address, 1);
+  if (entry == NULL || entry->vaddr != old_address ||
+      old_size > entry->length)
+    {
+      ret = -EINVAL;
+      goto unlock;
+    }
+
+  if ((entry->flags & MAP_ANONYMOUS) == 0)
+    {
+      ferr("ERROR: Only anonymous mappings can be remapped\n");
+      ret = -ENOSYS;
+      goto unlock;
+    }
+
+  ret = remap_anonymous(entry, new_size, (flags & MREMAP_MAYMOVE) != 0);
+  if (ret == OK)
+    {
+      *new_address = entry->vaddr;
+    }
+
+unlock:
+  mm_map_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mremap
+ *
+ * Description:
+ *   Expand or shrink an existing memory mapping.  Only anonymous mappings
+ *   are supported.  A mapping is grown in place when the memory behind it
+ *   is free.  Otherwise it is moved if MREMAP_MAYMOVE is given.  Large
+ *   mappings that are backed by pages (CONFIG_FS_ANONMAP_PGTHRESHOLD) are
+ *   moved by mapping the same pages at the new address, smaller ones are
+ *   moved with realloc().
+ *
+ * Input Parameters:
+ *   old_address  The start address of the mapping, as returned by mmap()
+ *   old_size     The size of the mapping
+ *   new_size     The requested size of the mapping
+ *   flags        Zero or MREMAP_MAYMOVE
+ *
+ * Returned Value:
+ *   On success, mremap() returns the address of the resized mapping.  On
+ *   failure, it returns MAP_FAILED and sets errno (ENOMEM if the mapping
+ *   cannot be grown, EINVAL for a bad address or flags).  The original
+ *   mapping is left intact on failure.
+ *
+ ****************************************************************************/
+
+FAR void *mremap(FAR void *old_address, size_t old_size, size_t new_size,
+                 int flags)
+{
+  FAR void *new_address = MAP_FAILED;
+  int ret;
+
+  ret = file_mremap_(old_address, old_size, new_size, flags, &new_address);
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      return MAP_FAILED;
+    }
+
+  return new_address;
+}
@@ -196,8 +196,7 @@ static int unmap_rammap(FAR struct task_group_s *group,
         }
 
       DEBUGASSERT(newaddr == entry->vaddr);
-      entry->vaddr = newaddr;
-      entry->length = length;
+      mm_map_update(get_group_mm(group), entry, newaddr, length);
     }
 
   return ret;
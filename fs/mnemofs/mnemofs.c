@@ -1781,6 +1781,10 @@ static int mnemofs_unbind(FAR void *handle, FAR struct inode **driver,
                           unsigned int flags)
 {
   FAR struct mfs_sb_s *sb;
+#ifdef CONFIG_MNEMOFS_BA_CHECKPOINT
+  mfs_t                ckpt_blk;
+  uint32_t             ckpt_seq;
+#endif
 
   MFS_LOG("[mnemofs | UNBIND] Entry.");
 
@@ -1791,6 +1795,25 @@ static int mnemofs_unbind(FAR void *handle, FAR struct inode **driver,
   *driver = sb->drv;
   MFS_LOG("[mnemofs | UNBIND] Driver %p.", driver);
 
+#ifdef CONFIG_MNEMOFS_BA_CHECKPOINT
+  /* Save the block allocator, so that the next mount doesn't traverse the
+   * file system tree to rebuild it.
+   */
+
+  if (mfs_ba_ckpt(sb, &ckpt_blk, &ckpt_seq) == OK)
+    {
+      if (mfs_mn_ckpt(sb, ckpt_blk, ckpt_seq) == OK)
+        {
+          MFS_LOG("[mnemofs | UNBIND] Checkpoint in block %" PRIu32 ".",
+                  ckpt_blk);
+        }
+      else
+        {
+          mfs_erase_blk(sb, ckpt_blk);
+        }
+    }
+#endif
+
   mfs_jrnl_free(sb);
   mfs_ba_free(sb);
 
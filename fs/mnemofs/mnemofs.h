@@ -66,6 +66,7 @@
 
 #define MFS_JRNL_MAGIC  "-mfs!j!-"
 #define MFS_MN_MAGIC    "-mfs!m!-"
+#define MFS_CKPT_MAGIC  "-mfs!c!-"
 
 #define MFS_CEILDIVIDE(num, denom) (((num) + ((denom) - 1)) / (denom))
 #define MFS_UPPER8(num)            (((num) + 7) & (-8))
@@ -168,6 +169,10 @@ struct mfs_mn_s
   struct timespec  root_st_atim;
   struct timespec  root_st_ctim;
   struct timespec  root_st_mtim;
+#ifdef CONFIG_MNEMOFS_BA_CHECKPOINT
+  mfs_t            ckpt_blk;      /* Allocator checkpoint, 0 if none. */
+  uint32_t         ckpt_seq;      /* Sequence number of the checkpoint. */
+#endif
 };
 
 struct mfs_jrnl_state_s
@@ -666,6 +671,36 @@ int mfs_ba_fmt(FAR struct mfs_sb_s * const sb);
 
 int mfs_ba_init(FAR struct mfs_sb_s * const sb);
 
+/****************************************************************************
+ * Name: mfs_ba_ckpt
+ *
+ * Description:
+ *   Write the state of the block allocator to a free block, so that the
+ *   next mount loads it instead of traversing the file system tree.  The
+ *   checkpoint is only valid until the journal changes, and is erased by
+ *   the mount that loads it.
+ *
+ * Input Parameters:
+ *   sb  - Superblock instance of the device.
+ *   blk - Populated with the block of the checkpoint.
+ *   seq - Populated with the sequence number of the checkpoint.
+ *
+ * Returned Value:
+ *   0        - OK
+ *   -ENOSPC  - No free block, or the state doesn't fit in one block.
+ *   -ENOMEM  - No memory left.
+ *
+ * Assumptions/Limitations:
+ *   This is called while unmounting, the in-memory state of the allocator
+ *   is not usable afterwards.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MNEMOFS_BA_CHECKPOINT
+int mfs_ba_ckpt(FAR struct mfs_sb_s * const sb, FAR mfs_t *blk,
+                FAR uint32_t *seq);
+#endif
+
 /****************************************************************************
  * Name: mfs_ba_getpg
  *
@@ -1503,6 +1538,30 @@ int mfs_mn_fmt(FAR struct mfs_sb_s * const sb, const mfs_t blk1,
 int mfs_mn_move(FAR struct mfs_sb_s * const sb, struct mfs_ctz_s root,
                 const mfs_t root_sz);
 
+/****************************************************************************
+ * Name: mfs_mn_ckpt
+ *
+ * Description:
+ *   Add a master node entry pointing to the checkpoint of the block
+ *   allocator.  The entry is otherwise a copy of the current master node.
+ *
+ * Input Parameters:
+ *   sb  - Superblock instance of the device.
+ *   blk - Block of the checkpoint.
+ *   seq - Sequence number of the checkpoint.
+ *
+ * Returned Value:
+ *   0        - OK
+ *   -ENOSPC  - The master blocks are full.
+ *   < 0      - Error
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MNEMOFS_BA_CHECKPOINT
+int mfs_mn_ckpt(FAR struct mfs_sb_s * const sb, const mfs_t blk,
+                const uint32_t seq);
+#endif
+
 int mfs_mn_sync(FAR struct mfs_sb_s *sb,
                 FAR struct mfs_path_s * const new_loc,
                 const mfs_t blk1, const mfs_t blk2, const mfs_t jrnl_blk);
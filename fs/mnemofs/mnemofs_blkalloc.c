@@ -84,6 +84,7 @@
 #include <nuttx/kmalloc.h>
 #include <stdbool.h>
 #include <stdlib.h>
+#include <sys/param.h>
 
 #include "mnemofs.h"
 #include "fs_heap.h"
@@ -94,13 +95,31 @@
 
 #define BMAP_GET(bmap, idx, off) (((bmap)[(idx)] & (1 << (off))) != 0)
 #define BMAP_SET(bmap, idx, off) ((bmap)[(idx)] |= (1 << (off)))
+#define BMAP_CLR(bmap, idx, off) ((bmap)[(idx)] &= ~(1 << (off)))
 #define DEL_ARR_BLK(sb, blk)     (MFS_BA((sb)).k_del[(blk) * sizeof(size_t)])
 #define DEL_ARR_PG(sb, pg)       (DEL_ARR_BLK(sb, MFS_PG2BLK((sb), (pg))))
 
+/* The checkpoint takes one block.  The first page is the header, then
+ * the bitmap of used pages and the delete counters of the blocks follow as
+ * one stream, each page of it ending with its hash.
+ */
+
+#define CKPT_HDRSZ               (8 + 4 * 6)
+#define CKPT_PAYLOAD(sb)         (MFS_PGSZ(sb) - 2)
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+#ifdef CONFIG_MNEMOFS_BA_CHECKPOINT
+struct mfs_ckpt_s
+{
+  FAR char *buf;   /* One page */
+  mfs_t    pg;     /* Next page of the stream */
+  mfs_t    off;    /* Offset in buf */
+};
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -110,6 +129,15 @@ static int         is_pg_writeable(FAR struct mfs_sb_s * const sb, mfs_t pg,
                                    FAR mfs_t *idx, FAR uint8_t *off);
 static int         is_blk_writeable(FAR struct mfs_sb_s * const sb,
                                     const mfs_t blk);
+#ifdef CONFIG_MNEMOFS_BA_CHECKPOINT
+static int         ckpt_put(FAR struct mfs_sb_s * const sb,
+                            FAR struct mfs_ckpt_s *ck,
+                            FAR const char *data, mfs_t len);
+static int         ckpt_get(FAR struct mfs_sb_s * const sb,
+                            FAR struct mfs_ckpt_s *ck,
+                            FAR char *data, mfs_t len);
+static int         ckpt_load(FAR struct mfs_sb_s * const sb);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -276,6 +304,209 @@ static int is_blk_writeable(FAR struct mfs_sb_s * const sb, const mfs_t blk)
   return MFS_BLK_FREE;
 }
 
+/****************************************************************************
+ * Name: ckpt_put
+ *
+ * Description:
+ *   Append data to the stream of the checkpoint, writing the pages as they
+ *   fill.  A zero length writes the last, partial page.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MNEMOFS_BA_CHECKPOINT
+static int ckpt_put(FAR struct mfs_sb_s * const sb,
+                    FAR struct mfs_ckpt_s *ck,
+                    FAR const char *data, mfs_t len)
+{
+  ssize_t ret;
+  mfs_t   n;
+
+  do
+    {
+      n = MIN(len, CKPT_PAYLOAD(sb) - ck->off);
+      memcpy(ck->buf + ck->off, data, n);
+      ck->off += n;
+      data    += n;
+      len     -= n;
+
+      if (ck->off == CKPT_PAYLOAD(sb) || (n == 0 && ck->off > 0))
+        {
+          memset(ck->buf + ck->off, 0, CKPT_PAYLOAD(sb) - ck->off);
+          mfs_ser_16(mfs_hash(ck->buf, CKPT_PAYLOAD(sb)),
+                     ck->buf + CKPT_PAYLOAD(sb));
+
+          ret = mfs_write_page(sb, ck->buf, MFS_PGSZ(sb), ck->pg++, 0);
+          if (predict_false(ret < 0))
+            {
+              return ret;
+            }
+
+          ck->off = 0;
+        }
+    }
+  while (len > 0);
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ckpt_get
+ *
+ * Description:
+ *   Read data from the stream of the checkpoint, checking the hash of each
+ *   page as it is read.
+ *
+ ****************************************************************************/
+
+static int ckpt_get(FAR struct mfs_sb_s * const sb,
+                    FAR struct mfs_ckpt_s *ck,
+                    FAR char *data, mfs_t len)
+{
+  ssize_t  ret;
+  uint16_t hash;
+  mfs_t    n;
+
+  while (len > 0)
+    {
+      if (ck->off == CKPT_PAYLOAD(sb))
+        {
+          ret = mfs_read_page(sb, ck->buf, MFS_PGSZ(sb), ck->pg++, 0);
+          if (predict_false(ret < 0))
+            {
+              return ret;
+            }
+
+          mfs_deser_16(ck->buf + CKPT_PAYLOAD(sb), &hash);
+          if (hash != mfs_hash(ck->buf, CKPT_PAYLOAD(sb)))
+            {
+              return -EINVAL;
+            }
+
+          ck->off = 0;
+        }
+
+      n = MIN(len, CKPT_PAYLOAD(sb) - ck->off);
+      memcpy(data, ck->buf + ck->off, n);
+      ck->off += n;
+      data    += n;
+      len     -= n;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ckpt_load
+ *
+ * Description:
+ *   Load the state of the block allocator from the checkpoint the master
+ *   node points to, and erase the checkpoint.  It is accepted only if it
+ *   was written on the journal as it is now.
+ *
+ * Returned Value:
+ *   0   - OK
+ *   < 0 - No valid checkpoint, the allocator state is left cleared.
+ *
+ ****************************************************************************/
+
+static int ckpt_load(FAR struct mfs_sb_s * const sb)
+{
+  int               ret;
+  mfs_t             blk  = MFS_MN(sb).ckpt_blk;
+  mfs_t             i;
+  mfs_t             seq;
+  mfs_t             n_logs;
+  mfs_t             s_blk;
+  mfs_t             c_pg;
+  mfs_t             n_bmap;
+  mfs_t             n_blks;
+  uint16_t          hash;
+  FAR const char   *tmp;
+  char              kdel[4];
+  struct mfs_ckpt_s ck;
+
+  if (blk == 0 || blk >= MFS_NBLKS(sb))
+    {
+      return -ENOENT;
+    }
+
+  ck.buf = fs_heap_malloc(MFS_PGSZ(sb));
+  if (predict_false(ck.buf == NULL))
+    {
+      return -ENOMEM;
+    }
+
+  ck.pg  = MFS_BLK2PG(sb, blk);
+  ck.off = CKPT_PAYLOAD(sb);
+
+  ret = mfs_read_page(sb, ck.buf, CKPT_HDRSZ + 2, ck.pg++, 0);
+  if (predict_false(ret < 0))
+    {
+      goto errout;
+    }
+
+  if (MFS_STRLITCMP(ck.buf, MFS_CKPT_MAGIC))
+    {
+      ret = -ENOENT;
+      goto errout;
+    }
+
+  tmp = mfs_deser_mfs(ck.buf + 8, &seq);
+  tmp = mfs_deser_mfs(tmp, &n_logs);
+  tmp = mfs_deser_mfs(tmp, &s_blk);
+  tmp = mfs_deser_mfs(tmp, &c_pg);
+  tmp = mfs_deser_mfs(tmp, &n_bmap);
+  tmp = mfs_deser_mfs(tmp, &n_blks);
+  mfs_deser_16(tmp, &hash);
+
+  if (hash != mfs_hash(ck.buf, CKPT_HDRSZ) ||
+      seq != MFS_MN(sb).ckpt_seq || n_logs != MFS_JRNL(sb).n_logs ||
+      n_bmap != MFS_BA(sb).n_bmap_upgs || n_blks != MFS_NBLKS(sb) ||
+      s_blk >= MFS_NBLKS(sb) || c_pg >= MFS_NPGS(sb))
+    {
+      finfo("Stale block allocator checkpoint in block %" PRIu32, blk);
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  ret = ckpt_get(sb, &ck, (FAR char *)MFS_BA(sb).bmap_upgs, n_bmap);
+  for (i = 0; ret == OK && i < MFS_NBLKS(sb); i++)
+    {
+      ret = ckpt_get(sb, &ck, kdel, sizeof(kdel));
+      mfs_deser_mfs(kdel, &DEL_ARR_BLK(sb, i));
+    }
+
+  /* The checkpoint block is free in the checkpoint itself, erase it before
+   * the allocator reaches it.
+   */
+
+  if (ret == OK)
+    {
+      ret = mfs_erase_blk(sb, blk);
+    }
+
+  if (predict_false(ret < 0))
+    {
+      goto errout_with_state;
+    }
+
+  MFS_BA(sb).s_blk = s_blk;
+  MFS_BA(sb).c_pg  = c_pg;
+  fs_heap_free(ck.buf);
+
+  finfo("Block allocator loaded from block %" PRIu32, blk);
+  return OK;
+
+errout_with_state:
+  memset(MFS_BA(sb).bmap_upgs, 0, MFS_BA(sb).n_bmap_upgs);
+  memset(MFS_BA(sb).k_del, 0, sizeof(size_t) * MFS_NBLKS(sb));
+
+errout:
+  fs_heap_free(ck.buf);
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -349,6 +580,20 @@ int mfs_ba_init(FAR struct mfs_sb_s * const sb)
       goto errout;
     }
 
+#ifdef CONFIG_MNEMOFS_BA_CHECKPOINT
+  /* The checkpoint written by the last unmount saves the traversal. */
+
+  if (MFS_MN(sb).ckpt_blk != 0)
+    {
+      ret = ckpt_load(sb);
+      MFS_MN(sb).ckpt_blk = 0;
+      if (ret == OK)
+        {
+          return ret;
+        }
+    }
+#endif
+
   /* Traverse the FS tree. */
 
   ret = mfs_pitr_traversefs(sb, MFS_MN(sb).root_ctz, MFS_ISDIR);
@@ -366,6 +611,115 @@ errout:
   return ret;
 }
 
+#ifdef CONFIG_MNEMOFS_BA_CHECKPOINT
+int mfs_ba_ckpt(FAR struct mfs_sb_s * const sb, FAR mfs_t *blk,
+                FAR uint32_t *seq)
+{
+  int               ret;
+  mfs_t             b;
+  mfs_t             i;
+  mfs_t             idx;
+  mfs_t             c_pg  = MFS_BA(sb).c_pg;
+  mfs_t             npgs;
+  uint8_t           off;
+  FAR char         *tmp;
+  char              kdel[4];
+  struct mfs_ckpt_s ck;
+
+  npgs = 1 + MFS_CEILDIVIDE(MFS_BA(sb).n_bmap_upgs + 4 * MFS_NBLKS(sb),
+                            CKPT_PAYLOAD(sb));
+  if (npgs > MFS_PGINBLK(sb))
+    {
+      return -ENOSPC;
+    }
+
+  ck.buf = fs_heap_malloc(MFS_PGSZ(sb));
+  if (predict_false(ck.buf == NULL))
+    {
+      return -ENOMEM;
+    }
+
+  b = mfs_ba_getblk(sb);
+  if (predict_false(b == 0))
+    {
+      ret = -ENOSPC;
+      goto errout;
+    }
+
+  /* The checkpoint block is saved as free, and erased when loaded. */
+
+  for (i = 0; i < MFS_PGINBLK(sb); i++)
+    {
+      pg2bmap(MFS_BLK2PG(sb, b) + i, &idx, &off);
+      BMAP_CLR(MFS_BA(sb).bmap_upgs, idx, off);
+    }
+
+  DEL_ARR_BLK(sb, b) = 0;
+  MFS_BA(sb).c_pg    = c_pg;
+
+  ret = mfs_erase_blk(sb, b);
+  if (predict_false(ret < 0))
+    {
+      goto errout_with_blk;
+    }
+
+  *seq = rand();
+
+  memset(ck.buf, 0, MFS_PGSZ(sb));
+  memcpy(ck.buf, MFS_CKPT_MAGIC, 8);
+  tmp = mfs_ser_mfs(*seq, ck.buf + 8);
+  tmp = mfs_ser_mfs(MFS_JRNL(sb).n_logs, tmp);
+  tmp = mfs_ser_mfs(MFS_BA(sb).s_blk, tmp);
+  tmp = mfs_ser_mfs(MFS_BA(sb).c_pg, tmp);
+  tmp = mfs_ser_mfs(MFS_BA(sb).n_bmap_upgs, tmp);
+  tmp = mfs_ser_mfs(MFS_NBLKS(sb), tmp);
+  mfs_ser_16(mfs_hash(ck.buf, CKPT_HDRSZ), tmp);
+
+  ck.pg  = MFS_BLK2PG(sb, b);
+  ck.off = 0;
+
+  ret = mfs_write_page(sb, ck.buf, MFS_PGSZ(sb), ck.pg++, 0);
+  if (predict_false(ret < 0))
+    {
+      goto errout_with_blk;
+    }
+
+  ret = ckpt_put(sb, &ck, (FAR const char *)MFS_BA(sb).bmap_upgs,
+                 MFS_BA(sb).n_bmap_upgs);
+  for (i = 0; ret == OK && i < MFS_NBLKS(sb); i++)
+    {
+      mfs_ser_mfs(DEL_ARR_BLK(sb, i), kdel);
+      ret = ckpt_put(sb, &ck, kdel, sizeof(kdel));
+    }
+
+  if (ret == OK)
+    {
+      ret = ckpt_put(sb, &ck, NULL, 0);
+    }
+
+  if (predict_false(ret < 0))
+    {
+      goto errout_with_blk;
+    }
+
+  *blk = b;
+  fs_heap_free(ck.buf);
+
+  finfo("Block allocator checkpoint written to block %" PRIu32, b);
+  return OK;
+
+errout_with_blk:
+
+  /* Leave the block erased, as the allocator takes it for free. */
+
+  mfs_erase_blk(sb, b);
+
+errout:
+  fs_heap_free(ck.buf);
+  return ret;
+}
+#endif
+
 void mfs_ba_free(FAR struct mfs_sb_s * const sb)
 {
   fs_heap_free(MFS_BA(sb).k_del);
@@ -89,6 +89,13 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* A master node entry may point to a checkpoint of the block allocator.
+ * The pointer follows the master node in the same page, where older
+ * mounts don't look.
+ */
+
+#define MN_CKPTSZ (8 + 4 + 4 + 2)
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -249,6 +256,29 @@ int mfs_mn_init(FAR struct mfs_sb_s * const sb, const mfs_t jrnl_blk)
       goto errout;
     }
 
+  /* The entry holds its own index, the next entry goes after it. */
+
+  mn.mblk_idx = i;
+
+#ifdef CONFIG_MNEMOFS_BA_CHECKPOINT
+  mn.ckpt_blk = 0;
+  mn.ckpt_seq = 0;
+
+  if (sz + 1 + MN_CKPTSZ <= MFS_PGSZ(sb))
+    {
+      char ckpt[MN_CKPTSZ];
+
+      mfs_read_page(sb, ckpt, MN_CKPTSZ, mn.pg, sz + 1);
+      mfs_deser_16(ckpt + MN_CKPTSZ - 2, &hash);
+      if (!MFS_STRLITCMP(ckpt, MFS_CKPT_MAGIC) &&
+          hash == mfs_hash(ckpt, MN_CKPTSZ - 2))
+        {
+          mfs_deser_mfs(mfs_deser_mfs(ckpt + 8, &mn.ckpt_blk),
+                        &mn.ckpt_seq);
+        }
+    }
+#endif
+
   blkidx              = MFS_JRNL(sb).log_sblkidx;
   pg_in_blk           = MFS_JRNL(sb).log_spg % MFS_PGINBLK(sb);
 
@@ -399,6 +429,56 @@ errout:
   return ret;
 }
 
+#ifdef CONFIG_MNEMOFS_BA_CHECKPOINT
+int mfs_mn_ckpt(FAR struct mfs_sb_s * const sb, const mfs_t blk,
+                const uint32_t seq)
+{
+  int              ret         = OK;
+  FAR char        *tmp;
+  struct mfs_mn_s  mn;
+  const mfs_t      sz          = sizeof(struct mfs_mn_s) - sizeof(mn.pg);
+  char             buf[sz + 1 + MN_CKPTSZ];
+
+  mn = MFS_MN(sb);
+
+  /* The mount takes a full master block for an error, keep a page. */
+
+  if (mn.mblk_idx + 1 >= MFS_PGINBLK(sb) || sizeof(buf) > MFS_PGSZ(sb))
+    {
+      return -ENOSPC;
+    }
+
+  memset(buf, 0, sizeof(buf));
+  ser_mn(mn, buf);
+
+  tmp = buf + sz + 1;
+  memcpy(tmp, MFS_CKPT_MAGIC, 8);
+  tmp = mfs_ser_mfs(seq, mfs_ser_mfs(blk, tmp + 8));
+  mfs_ser_16(mfs_hash(buf + sz + 1, MN_CKPTSZ - 2), tmp);
+
+  ret = mfs_write_page(sb, buf, sizeof(buf),
+                       MFS_BLK2PG(sb, MFS_JRNL(sb).mblk1) + mn.mblk_idx, 0);
+  if (predict_false(ret < 0))
+    {
+      goto errout;
+    }
+
+  ret = mfs_write_page(sb, buf, sizeof(buf),
+                       MFS_BLK2PG(sb, MFS_JRNL(sb).mblk2) + mn.mblk_idx, 0);
+  if (predict_false(ret < 0))
+    {
+      goto errout;
+    }
+
+  mn.mblk_idx++;
+  MFS_MN(sb) = mn;
+  ret = OK;
+
+errout:
+  return ret;
+}
+#endif
+
 int mfs_mn_sync(FAR struct mfs_sb_s *sb,
                 FAR struct mfs_path_s * const new_loc,
                 const mfs_t blk1, const mfs_t blk2, const mfs_t jrnl_blk)
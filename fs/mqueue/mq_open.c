@@ -99,6 +99,7 @@ static int nxmq_file_poll(FAR struct file *filep,
   int i;
 
   flags = enter_critical_section();
+  spin_lock(&msgq->lock);
 
   if (setup)
     {
@@ -135,7 +136,10 @@ static int nxmq_file_poll(FAR struct file *filep,
           eventset |= POLLIN;
         }
 
+      spin_unlock(&msgq->lock);
       poll_notify(&fds, 1, eventset);
+      leave_critical_section(flags);
+      return OK;
     }
   else if (fds->priv != NULL)
     {
@@ -151,6 +155,7 @@ static int nxmq_file_poll(FAR struct file *filep,
     }
 
 errout:
+  spin_unlock(&msgq->lock);
   leave_critical_section(flags);
   return ret;
 }
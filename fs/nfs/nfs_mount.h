@@ -90,6 +90,7 @@ struct nfsmount
     struct rpc_call_create  create;
     struct rpc_call_lookup  lookup;
     struct rpc_call_read    read;
+    struct rpc_call_commit  commit;
     struct rpc_call_remove  removef;
     struct rpc_call_rename  renamef;
     struct rpc_call_mkdir   mkdir;
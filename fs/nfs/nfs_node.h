@@ -48,6 +48,8 @@
  * Included Files
  ****************************************************************************/
 
+#include <stdbool.h>
+
 #include "nfs_proto.h"
 
 /****************************************************************************
@@ -70,6 +72,20 @@ struct nfsnode
   struct timespec     n_ctime;      /* File creation time */
   nfsfh_t             n_fhandle;    /* NFS File Handle */
   uint64_t            n_size;       /* Current size of file */
+#ifdef CONFIG_NFS_READAHEAD
+  FAR uint8_t        *n_rabuf;      /* Data read ahead */
+  uint64_t            n_raoff;      /* File offset of the data read ahead */
+  uint32_t            n_ralen;      /* Size of the data read ahead */
+#endif
+
+#ifdef CONFIG_NFS_UNSTABLE_WRITES
+  bool                n_unstable;   /* Unstable writes to commit */
+  bool                n_verfbad;    /* Server restarted since written */
+
+  /* Write verifier of the unstable writes */
+
+  uint8_t             n_verf[NFSX_V3WRITEVERF];
+#endif
 };
 
 #endif /* __FS_NFS_NFS_NODE_H */
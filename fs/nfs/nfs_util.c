@@ -514,6 +514,11 @@ int nfs_finddir(FAR struct nfsmount *nmp, FAR const char *relpath,
 
 void nfs_attrupdate(FAR struct nfsnode *np, FAR struct nfs_fattr *attributes)
 {
+#ifdef CONFIG_NFS_READAHEAD
+  struct timespec mtime = np->n_mtime;
+  uint64_t size = np->n_size;
+#endif
+
   /* Save a few of the files attribute values in file structure (host
    * order).
    */
@@ -525,4 +530,14 @@ void nfs_attrupdate(FAR struct nfsnode *np, FAR struct nfs_fattr *attributes)
   fxdr_nfsv3time(&attributes->fa_atime, &np->n_atime);
   fxdr_nfsv3time(&attributes->fa_mtime, &np->n_mtime);
   fxdr_nfsv3time(&attributes->fa_ctime, &np->n_ctime);
+
+#ifdef CONFIG_NFS_READAHEAD
+  /* The data read ahead is stale if the file was modified since */
+
+  if (np->n_size != size || np->n_mtime.tv_sec != mtime.tv_sec ||
+      np->n_mtime.tv_nsec != mtime.tv_nsec)
+    {
+      np->n_ralen = 0;
+    }
+#endif
 }
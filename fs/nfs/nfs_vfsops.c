@@ -136,6 +136,14 @@ static int     nfs_fileopen(FAR struct nfsmount *nmp,
                    FAR struct nfsnode *np, FAR const char *relpath,
                    int oflags, mode_t mode);
 
+#ifdef CONFIG_NFS_READAHEAD
+static void    nfs_invalidate(FAR struct nfsmount *nmp,
+                              FAR struct nfsnode *np);
+#endif
+#ifdef CONFIG_NFS_UNSTABLE_WRITES
+static int     nfs_commit(FAR struct nfsmount *nmp, FAR struct nfsnode *np);
+#endif
+
 static int     nfs_open(FAR struct file *filep, FAR const char *relpath,
                    int oflags, mode_t mode);
 static int     nfs_close(FAR struct file *filep);
@@ -637,6 +645,134 @@ static int nfs_fileopen(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
   return OK;
 }
 
+/****************************************************************************
+ * Name: nfs_invalidate
+ *
+ * Description:
+ *   Drop the data read ahead by all the open file structures of the file
+ *   of 'np', before it is modified.
+ *
+ * Assumptions:
+ *   The caller has exclusive access to the NFS mount structure
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NFS_READAHEAD
+static void nfs_invalidate(FAR struct nfsmount *nmp, FAR struct nfsnode *np)
+{
+  FAR struct nfsnode *curr;
+
+  for (curr = nmp->nm_head; curr; curr = curr->n_next)
+    {
+      if (curr->n_fhsize == np->n_fhsize &&
+          memcmp(&curr->n_fhandle, &np->n_fhandle, np->n_fhsize) == 0)
+        {
+          curr->n_ralen = 0;
+        }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: nfs_commit
+ *
+ * Description:
+ *   Commit the unstable writes of the file to the stable storage of the
+ *   server.  One COMMIT RPC flushes all the writes done since the last one.
+ *
+ * Returned Value:
+ *   0 on success; a negated errno value on failure.  -EIO is returned if
+ *   the server restarted since the data was written, as the data is lost.
+ *
+ * Assumptions:
+ *   The caller has exclusive access to the NFS mount structure
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NFS_UNSTABLE_WRITES
+static int nfs_commit(FAR struct nfsmount *nmp, FAR struct nfsnode *np)
+{
+  FAR uint32_t *ptr;
+  uint32_t      tmp;
+  size_t        reqlen;
+  int           ret;
+
+  if (!np->n_unstable)
+    {
+      return OK;
+    }
+
+  /* Initialize the request */
+
+  ptr     = (FAR uint32_t *)&nmp->nm_msgbuffer.commit.commit;
+  reqlen  = 0;
+
+  /* Copy the variable length, file handle */
+
+  *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
+  reqlen += sizeof(uint32_t);
+
+  memcpy(ptr, &np->n_fhandle, np->n_fhsize);
+  reqlen += uint32_alignup(np->n_fhsize);
+  ptr    += uint32_increment(np->n_fhsize);
+
+  /* Commit the whole file: offset and count zero */
+
+  txdr_hyper((uint64_t)0, ptr);
+  ptr    += 2;
+  reqlen += 2*sizeof(uint32_t);
+
+  *ptr    = txdr_unsigned(0);
+  reqlen += sizeof(uint32_t);
+
+  nfs_statistics(NFSPROC_COMMIT);
+  ret = nfs_request(nmp, NFSPROC_COMMIT,
+                    &nmp->nm_msgbuffer.commit, reqlen,
+                    nmp->nm_iobuffer, nmp->nm_buflen);
+  if (ret)
+    {
+      ferr("ERROR: nfs_request failed: %d\n", ret);
+      return ret;
+    }
+
+  /* Parse file_wcc.  First, check if WCC attributes follow. */
+
+  ptr = (FAR uint32_t *)
+    &((FAR struct rpc_reply_commit *)nmp->nm_iobuffer)->commit;
+
+  tmp = *ptr++;
+  if (tmp != 0)
+    {
+      /* Yes.. WCC attributes follow.  But we just skip over them. */
+
+      ptr += uint32_increment(sizeof(struct wcc_attr));
+    }
+
+  /* Check if normal file attributes follow */
+
+  tmp = *ptr++;
+  if (tmp != 0)
+    {
+      /* Yes.. Update the cached file status in the file structure. */
+
+      nfs_attrupdate(np, (FAR struct nfs_fattr *)ptr);
+      ptr += uint32_increment(sizeof(struct nfs_fattr));
+    }
+
+  /* The verifier must be the one of the writes */
+
+  if (np->n_verfbad || memcmp(np->n_verf, ptr, NFSX_V3WRITEVERF) != 0)
+    {
+      ferr("ERROR: Unstable writes lost by the server\n");
+      ret = -EIO;
+    }
+
+  np->n_unstable = false;
+  np->n_verfbad  = false;
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: nfs_open
  *
@@ -810,6 +946,12 @@ static int nfs_close(FAR struct file *filep)
 
   else
     {
+#ifdef CONFIG_NFS_UNSTABLE_WRITES
+      /* Commit the unstable writes, so that close() reports their loss */
+
+      int cret = nfs_commit(nmp, np);
+#endif
+
       /* Assume file structure won't be found. This should never happen. */
 
       ret = -EINVAL;
@@ -839,11 +981,21 @@ static int nfs_close(FAR struct file *filep)
 
               /* Then deallocate the file structure and return success */
 
+#ifdef CONFIG_NFS_READAHEAD
+              fs_heap_free(np->n_rabuf);
+#endif
               fs_heap_free(np);
               ret = OK;
               break;
             }
         }
+
+#ifdef CONFIG_NFS_UNSTABLE_WRITES
+      if (ret >= 0)
+        {
+          ret = cret;
+        }
+#endif
     }
 
   filep->f_priv = NULL;
@@ -851,9 +1003,147 @@ static int nfs_close(FAR struct file *filep)
   return ret;
 }
 
+/****************************************************************************
+ * Name: nfs_readrpc
+ *
+ * Description:
+ *   Read up to 'size' bytes at 'offset' with one READ RPC.  The size must
+ *   not exceed the value returned by nfs_readmax().
+ *
+ * Returned Value:
+ *   The (non-negative) number of bytes read on success; a negated errno
+ *   value on failure.  'eof' is set if the server reported the end of the
+ *   file.
+ *
+ * Assumptions:
+ *   The caller has exclusive access to the NFS mount structure
+ *
+ ****************************************************************************/
+
+static ssize_t nfs_readrpc(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
+                           uint64_t offset, FAR char *buffer, size_t size,
+                           FAR bool *eof)
+{
+  FAR uint32_t *ptr;
+  size_t        reqlen;
+  uint32_t      readsize;
+  uint32_t      tmp;
+  int           ret;
+
+  /* Initialize the request */
+
+  ptr     = (FAR uint32_t *)&nmp->nm_msgbuffer.read.read;
+  reqlen  = 0;
+
+  /* Copy the variable length, file handle */
+
+  *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
+  reqlen += sizeof(uint32_t);
+
+  memcpy(ptr, &np->n_fhandle, np->n_fhsize);
+  reqlen += uint32_alignup(np->n_fhsize);
+  ptr    += uint32_increment(np->n_fhsize);
+
+  /* Copy the file offset */
+
+  txdr_hyper(offset, ptr);
+  ptr += 2;
+  reqlen += 2*sizeof(uint32_t);
+
+  /* Set the readsize */
+
+  *ptr = txdr_unsigned(size);
+  reqlen += sizeof(uint32_t);
+
+  /* Perform the read */
+
+  finfo("Reading %zu bytes\n", size);
+  nfs_statistics(NFSPROC_READ);
+  ret = nfs_request(nmp, NFSPROC_READ,
+                    &nmp->nm_msgbuffer.read, reqlen,
+                    nmp->nm_iobuffer, nmp->nm_buflen);
+  if (ret)
+    {
+      ferr("ERROR: nfs_request failed: %d\n", ret);
+      return ret;
+    }
+
+  /* The read was successful.  Get a pointer to the beginning of the NFS
+   * response data.
+   */
+
+  ptr = (FAR uint32_t *)
+    &((FAR struct rpc_reply_read *)nmp->nm_iobuffer)->read;
+
+  /* Check if attributes are included in the responses */
+
+  tmp = *ptr++;
+  if (tmp != 0)
+    {
+      /* Yes.. Update the cached file status in the file structure. */
+
+      nfs_attrupdate(np, (FAR struct nfs_fattr *)ptr);
+      ptr += uint32_increment(sizeof(struct nfs_fattr));
+    }
+
+  /* This is followed by the count of data read.  Isn't this
+   * the same as the length that is included in the read data?
+   *
+   * Just skip over if for now.
+   */
+
+  ptr++;
+
+  /* Next comes an EOF indication */
+
+  *eof = *ptr++ != 0;
+
+  /* Then the length of the read data followed by the read data itself.
+   * Never store more than asked, whatever the server says.
+   */
+
+  readsize = fxdr_unsigned(uint32_t, *ptr);
+  ptr++;
+
+  if (readsize > size)
+    {
+      readsize = size;
+    }
+
+  memcpy(buffer, ptr, readsize);
+  return readsize;
+}
+
+/****************************************************************************
+ * Name: nfs_readmax
+ *
+ * Description:
+ *   Return the largest read that fits one READ RPC and the I/O buffer.
+ *
+ ****************************************************************************/
+
+static size_t nfs_readmax(FAR struct nfsmount *nmp)
+{
+  size_t readsize = nmp->nm_rsize;
+  size_t tmp;
+
+  tmp = SIZEOF_rpc_reply_read(readsize);
+  if (tmp > nmp->nm_buflen)
+    {
+      readsize -= (tmp - nmp->nm_buflen);
+    }
+
+  return readsize;
+}
+
 /****************************************************************************
  * Name: nfs_read
  *
+ * Description:
+ *   Read from a file.  With CONFIG_NFS_READAHEAD, the reads smaller than
+ *   one READ RPC fetch the whole RPC worth of data, and the next small
+ *   reads are served from it.
+ *
  * Returned Value:
  *   The (non-negative) number of bytes read on success; a negated errno
  *   value on failure.
@@ -868,8 +1158,8 @@ static ssize_t nfs_read(FAR struct file *filep, FAR char *buffer,
   ssize_t                    readsize;
   ssize_t                    tmp;
   ssize_t                    bytesread;
-  size_t                     reqlen;
-  FAR uint32_t              *ptr;
+  size_t                     readmax;
+  bool                       eof = false;
   int                        ret = 0;
 
   finfo("Read %zu bytes from offset %jd\n",
@@ -903,116 +1193,84 @@ static ssize_t nfs_read(FAR struct file *filep, FAR char *buffer,
       finfo("Read size truncated to %zu\n", buflen);
     }
 
+  /* Make sure that the attempted read size does not exceed the RPC maximum
+   * nor the IO buffer size
+   */
+
+  readmax = nfs_readmax(nmp);
+
   /* Now loop until we fill the user buffer (or hit the end of the file) */
 
-  for (bytesread = 0; bytesread < buflen; )
+  for (bytesread = 0; bytesread < buflen && !eof; )
     {
-      /* Make sure that the attempted read size does not exceed the RPC
-       * maximum
-       */
-
       readsize = buflen - bytesread;
-      if (readsize > nmp->nm_rsize)
-        {
-          readsize = nmp->nm_rsize;
-        }
 
-      /* Make sure that the attempted read size does not exceed the IO buffer
-       * size
-       */
+#ifdef CONFIG_NFS_READAHEAD
+      /* Take what we can from the data read ahead */
 
-      tmp = SIZEOF_rpc_reply_read(readsize);
-      if (tmp > nmp->nm_buflen)
+      if (np->n_ralen > 0 && filep->f_pos >= np->n_raoff &&
+          filep->f_pos < np->n_raoff + np->n_ralen)
         {
-          readsize -= (tmp - nmp->nm_buflen);
-        }
-
-      /* Initialize the request */
-
-      ptr     = (FAR uint32_t *)&nmp->nm_msgbuffer.read.read;
-      reqlen  = 0;
-
-      /* Copy the variable length, file handle */
-
-      *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
-      reqlen += sizeof(uint32_t);
+          tmp = np->n_raoff + np->n_ralen - filep->f_pos;
+          if (readsize > tmp)
+            {
+              readsize = tmp;
+            }
 
-      memcpy(ptr, &np->n_fhandle, np->n_fhsize);
-      reqlen += uint32_alignup(np->n_fhsize);
-      ptr    += uint32_increment(np->n_fhsize);
+          memcpy(buffer, np->n_rabuf + (filep->f_pos - np->n_raoff),
+                 readsize);
 
-      /* Copy the file offset */
+          filep->f_pos += readsize;
+          bytesread    += readsize;
+          buffer       += readsize;
+          continue;
+        }
 
-      txdr_hyper((uint64_t)filep->f_pos, ptr);
-      ptr += 2;
-      reqlen += 2*sizeof(uint32_t);
+      /* Read ahead a whole RPC if less is asked */
 
-      /* Set the readsize */
+      if (readsize < readmax)
+        {
+          if (np->n_rabuf == NULL)
+            {
+              np->n_rabuf = fs_heap_malloc(readmax);
+            }
 
-      *ptr = txdr_unsigned(readsize);
-      reqlen += sizeof(uint32_t);
+          if (np->n_rabuf != NULL)
+            {
+              ret = nfs_readrpc(nmp, np, filep->f_pos,
+                                (FAR char *)np->n_rabuf, readmax, &eof);
+              if (ret <= 0)
+                {
+                  np->n_ralen = 0;
+                  goto errout_with_lock;
+                }
 
-      /* Perform the read */
+              np->n_raoff = filep->f_pos;
+              np->n_ralen = ret;
+              eof         = false;
+              continue;
+            }
+        }
+#endif
 
-      finfo("Reading %zu bytes\n", readsize);
-      nfs_statistics(NFSPROC_READ);
-      ret = nfs_request(nmp, NFSPROC_READ,
-                        &nmp->nm_msgbuffer.read, reqlen,
-                        nmp->nm_iobuffer, nmp->nm_buflen);
-      if (ret)
+      if (readsize > readmax)
         {
-          ferr("ERROR: nfs_request failed: %d\n", ret);
-          goto errout_with_lock;
+          readsize = readmax;
         }
 
-      /* The read was successful.  Get a pointer to the beginning of the NFS
-       * response data.
-       */
-
-      ptr = (FAR uint32_t *)
-        &((FAR struct rpc_reply_read *)nmp->nm_iobuffer)->read;
-
-      /* Check if attributes are included in the responses */
-
-      tmp = *ptr++;
-      if (tmp != 0)
+      ret = nfs_readrpc(nmp, np, filep->f_pos, buffer, readsize, &eof);
+      if (ret < 0)
         {
-          /* Yes.. Update the cached file status in the file structure. */
-
-          nfs_attrupdate(np, (FAR struct nfs_fattr *)ptr);
-          ptr += uint32_increment(sizeof(struct nfs_fattr));
+          goto errout_with_lock;
         }
 
-      /* This is followed by the count of data read.  Isn't this
-       * the same as the length that is included in the read data?
-       *
-       * Just skip over if for now.
-       */
-
-      ptr++;
-
-      /* Next comes an EOF indication.  Save that in tmp for now. */
-
-      tmp = *ptr++;
-
-      /* Then the length of the read data followed by the read data itself */
-
-      readsize = fxdr_unsigned(uint32_t, *ptr);
-      ptr++;
-
-      /* Copy the read data into the user buffer */
-
-      memcpy(buffer, ptr, readsize);
-
       /* Update the read state data */
 
-      filep->f_pos += readsize;
-      bytesread    += readsize;
-      buffer       += readsize;
+      filep->f_pos += ret;
+      bytesread    += ret;
+      buffer       += ret;
 
-      /* Check if we hit the end of file */
-
-      if (tmp != 0)
+      if (ret == 0)
         {
           break;
         }
@@ -1044,7 +1302,11 @@ static ssize_t nfs_write(FAR struct file *filep, FAR const char *buffer,
   FAR uint32_t        *ptr;
   uint32_t             tmp;
   int                  commit = 0;
+#ifdef CONFIG_NFS_UNSTABLE_WRITES
+  int                  committed = NFSV3WRITE_UNSTABLE;
+#else
   int                  committed = NFSV3WRITE_FILESYNC;
+#endif
   int                  ret;
 
   finfo("Write %zu bytes to offset %jd\n",
@@ -1075,6 +1337,12 @@ static ssize_t nfs_write(FAR struct file *filep, FAR const char *buffer,
       goto errout_with_lock;
     }
 
+#ifdef CONFIG_NFS_READAHEAD
+  /* Drop the data read ahead by all the opens of the file */
+
+  nfs_invalidate(nmp, np);
+#endif
+
   /* Now loop until we send the entire user buffer */
 
   for (byteswritten = 0; byteswritten < buflen; )
@@ -1189,7 +1457,29 @@ static ssize_t nfs_write(FAR struct file *filep, FAR const char *buffer,
 
       /* Determine the lowest commitment level obtained by any of the RPCs. */
 
-      commit = *ptr++;
+      commit = fxdr_unsigned(uint32_t, *ptr);
+      ptr++;
+
+#ifdef CONFIG_NFS_UNSTABLE_WRITES
+      /* The unstable data must be committed later with the same write
+       * verifier, a new one tells that the server lost it meanwhile.
+       */
+
+      if (commit == NFSV3WRITE_UNSTABLE)
+        {
+          if (!np->n_unstable)
+            {
+              np->n_unstable = true;
+            }
+          else if (memcmp(np->n_verf, ptr, NFSX_V3WRITEVERF) != 0)
+            {
+              np->n_verfbad = true;
+            }
+
+          memcpy(np->n_verf, ptr, NFSX_V3WRITEVERF);
+        }
+#endif
+
       if (committed == NFSV3WRITE_FILESYNC)
         {
           committed = commit;
@@ -1287,7 +1577,34 @@ static off_t nfs_seek(FAR struct file *filep, off_t offset, int whence)
 
 static int nfs_sync(FAR struct file *filep)
 {
+#ifdef CONFIG_NFS_UNSTABLE_WRITES
+  FAR struct nfsmount *nmp;
+  FAR struct nfsnode  *np;
+  int                  ret;
+
+  /* Sanity checks */
+
+  DEBUGASSERT(filep->f_priv != NULL);
+
+  /* Recover our private data from the struct file instance */
+
+  nmp = filep->f_inode->i_private;
+  np  = (FAR struct nfsnode *)filep->f_priv;
+
+  DEBUGASSERT(nmp != NULL);
+
+  ret = nxmutex_lock(&nmp->nm_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = nfs_commit(nmp, np);
+  nxmutex_unlock(&nmp->nm_lock);
+  return ret;
+#else
   return 0;
+#endif
 }
 
 /****************************************************************************
@@ -1458,6 +1775,10 @@ static int nfs_truncate(FAR struct file *filep, off_t length)
     {
       struct stat buf;
 
+#ifdef CONFIG_NFS_READAHEAD
+      nfs_invalidate(nmp, np);
+#endif
+
       /* Then perform the SETATTR RPC to set the new file size */
 
       buf.st_size = length;
@@ -94,6 +94,7 @@ struct inotify_global_s
   int      watch_cookie;       /* Watch cookie */
   uint32_t read_count;         /* Number of read events */
   uint32_t write_count;        /* Number of write events */
+  unsigned int generation;     /* Bumped when a path may become watched */
   struct   hsearch_data hash;  /* Hash table for watch lists */
 };
 
@@ -141,7 +142,8 @@ static struct inode g_inotify_inode =
 
 static struct inotify_global_s g_inotify =
 {
-  .lock = NXMUTEX_INITIALIZER,
+  .lock       = NXMUTEX_INITIALIZER,
+  .generation = 1,
 };
 
 /****************************************************************************
@@ -191,6 +193,24 @@ static int notify_check_mask(uint32_t mask)
           -EBADF : OK;
 }
 
+/****************************************************************************
+ * Name: notify_new_generation
+ *
+ * Description:
+ *   Start a new watch generation, so that no open file is taken as
+ *   unwatched any more.  0 is skipped, it is the generation of the files
+ *   never looked up.
+ *
+ ****************************************************************************/
+
+static void notify_new_generation(void)
+{
+  if (++g_inotify.generation == 0)
+    {
+      g_inotify.generation = 1;
+    }
+}
+
 /****************************************************************************
  * Name: inotify_alloc_event
  *
@@ -762,6 +782,9 @@ inotify_alloc_watch_list(FAR const char *path)
       return NULL;
     }
 
+  /* The open files found unwatched before must be looked up again */
+
+  notify_new_generation();
   return list;
 }
 
@@ -844,7 +867,7 @@ inotify_queue_watch_list_event(FAR struct inotify_watch_list_s *list,
  *
  ****************************************************************************/
 
-static void inotify_queue_parent_event(FAR char *path, uint32_t mask,
+static bool inotify_queue_parent_event(FAR char *path, uint32_t mask,
                                        uint32_t cookie)
 {
   FAR struct inotify_watch_list_s *list;
@@ -853,15 +876,18 @@ static void inotify_queue_parent_event(FAR char *path, uint32_t mask,
   name = basename(path);
   if (name == NULL || name == path)
     {
-      return;
+      return false;
     }
 
   *(name - 1) = '\0';
   list = inotify_get_watch_list(path);
-  if (list != NULL)
+  if (list == NULL)
     {
-      inotify_queue_watch_list_event(list, mask | IN_ISDIR, cookie, name);
+      return false;
     }
+
+  inotify_queue_watch_list_event(list, mask | IN_ISDIR, cookie, name);
+  return true;
 }
 
 /****************************************************************************
@@ -870,26 +896,30 @@ static void inotify_queue_parent_event(FAR char *path, uint32_t mask,
  * Description:
  *   Send the notification by the path.
  *
+ * Returned Value:
+ *   true if the path or its parent directory is watched.
+ *
  ****************************************************************************/
 
-static void notify_queue_path_event(FAR const char *path, uint32_t mask)
+static bool notify_queue_path_event(FAR const char *path, uint32_t mask)
 {
   FAR struct inotify_watch_list_s *list;
   FAR char *abspath;
   FAR char *pathbuffer;
   uint32_t cookie = 0;
+  bool watched;
 
   pathbuffer = lib_get_pathbuffer();
   if (pathbuffer == NULL)
     {
-      return;
+      return true;
     }
 
   abspath = lib_realpath(path, pathbuffer, true);
   if (abspath == NULL)
     {
       lib_put_pathbuffer(pathbuffer);
-      return;
+      return true;
     }
 
   if (mask & IN_MOVE)
@@ -903,11 +933,11 @@ static void notify_queue_path_event(FAR const char *path, uint32_t mask)
     }
 
   list = inotify_get_watch_list(abspath);
-  inotify_queue_parent_event(abspath, mask, cookie);
+  watched = inotify_queue_parent_event(abspath, mask, cookie);
   lib_put_pathbuffer(pathbuffer);
   if (list == NULL)
     {
-      return;
+      return watched;
     }
 
   if (mask & IN_MOVED_FROM)
@@ -931,6 +961,8 @@ static void notify_queue_path_event(FAR const char *path, uint32_t mask)
     {
       inotify_queue_watch_list_event(list, mask, cookie, NULL);
     }
+
+  return true;
 }
 
 /****************************************************************************
@@ -978,8 +1010,17 @@ static inline void notify_queue_filep_event(FAR struct file *filep,
       return;
     }
 
+  /* Skip the path lookup if the file was found unwatched since the last
+   * time a path may have become watched.
+   */
+
   nxmutex_lock(&g_inotify.lock);
   ret = notify_check_mask(mask);
+  if (ret >= 0 && filep->f_notify_gen == g_inotify.generation)
+    {
+      ret = -ENOENT;
+    }
+
   nxmutex_unlock(&g_inotify.lock);
   if (ret < 0)
     {
@@ -1005,7 +1046,11 @@ static inline void notify_queue_filep_event(FAR struct file *filep,
     }
 
   nxmutex_lock(&g_inotify.lock);
-  notify_queue_path_event(pathbuffer, mask);
+  if (!notify_queue_path_event(pathbuffer, mask))
+    {
+      filep->f_notify_gen = g_inotify.generation;
+    }
+
   lib_put_pathbuffer(pathbuffer);
   nxmutex_unlock(&g_inotify.lock);
 }
@@ -1505,7 +1550,10 @@ void notify_rename(FAR const char *oldpath, bool oldisdir,
       oldmask |= IN_ISDIR;
     }
 
+  /* The open files below the old path now have another path */
+
   nxmutex_lock(&g_inotify.lock);
+  notify_new_generation();
   notify_queue_path_event(oldpath, oldmask);
   notify_queue_path_event(newpath, newmask);
   nxmutex_unlock(&g_inotify.lock);
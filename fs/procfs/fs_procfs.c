@@ -54,13 +54,18 @@
  * External Definitions
  ****************************************************************************/
 
+extern const struct procfs_operations g_callgraph_operations;
 extern const struct procfs_operations g_clk_operations;
 extern const struct procfs_operations g_cpuinfo_operations;
 extern const struct procfs_operations g_cpuload_operations;
 extern const struct procfs_operations g_critmon_operations;
 extern const struct procfs_operations g_fdt_operations;
+extern const struct procfs_operations g_heapprof_operations;
+extern const struct procfs_operations g_heaptag_operations;
 extern const struct procfs_operations g_iobinfo_operations;
 extern const struct procfs_operations g_irq_operations;
+extern const struct procfs_operations g_latency_operations;
+extern const struct procfs_operations g_lockstat_operations;
 extern const struct procfs_operations g_meminfo_operations;
 extern const struct procfs_operations g_memdump_operations;
 extern const struct procfs_operations g_mempool_operations;
@@ -102,6 +107,10 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "[0-9]*",       &g_proc_operations,     PROCFS_DIR_TYPE    },
 #endif
 
+#ifdef CONFIG_SCHED_CALLGRAPH
+  { "callgraph",    &g_callgraph_operations, PROCFS_FILE_TYPE  },
+#endif
+
 #if defined(CONFIG_CLK) && !defined(CONFIG_FS_PROCFS_EXCLUDE_CLK)
   { "clk",          &g_clk_operations,      PROCFS_FILE_TYPE   },
 #endif
@@ -139,6 +148,14 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "fs/usage",     &g_mount_operations,    PROCFS_FILE_TYPE   },
 #endif
 
+#if defined(CONFIG_MM_HEAPPROF) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMINFO)
+  { "heapprof",     &g_heapprof_operations, PROCFS_FILE_TYPE   },
+#endif
+
+#if defined(CONFIG_MM_HEAPTAG) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMINFO)
+  { "heaptag",      &g_heaptag_operations,  PROCFS_FILE_TYPE   },
+#endif
+
 #if defined(CONFIG_MM_IOB) && !defined(CONFIG_FS_PROCFS_EXCLUDE_IOBINFO)
   { "iobinfo",      &g_iobinfo_operations,  PROCFS_FILE_TYPE   },
 #endif
@@ -147,6 +164,14 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "irqs",         &g_irq_operations,      PROCFS_FILE_TYPE   },
 #endif
 
+#ifdef CONFIG_SCHED_LATENCY
+  { "latency",      &g_latency_operations,  PROCFS_FILE_TYPE   },
+#endif
+
+#ifdef CONFIG_SCHED_LOCKSTAT
+  { "lockstat",     &g_lockstat_operations, PROCFS_FILE_TYPE   },
+#endif
+
 #ifndef CONFIG_FS_PROCFS_EXCLUDE_MEMINFO
 #  ifndef CONFIG_FS_PROCFS_EXCLUDE_MEMDUMP
   { "memdump",      &g_memdump_operations,  PROCFS_FILE_TYPE   },
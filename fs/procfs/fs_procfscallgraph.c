@@ -0,0 +1,347 @@
+/****************************************************************************
+ * fs/procfs/fs_procfscallgraph.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <inttypes.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/allsyms.h>
+#include <nuttx/sched_callgraph.h>
+#include <nuttx/symtab.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#include "fs_heap.h"
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    defined(CONFIG_SCHED_CALLGRAPH)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic: one call stack.
+ */
+
+#ifdef CONFIG_ALLSYMS
+#  define CALLGRAPH_FRAMELEN 48
+#else
+#  define CALLGRAPH_FRAMELEN 20
+#endif
+
+#define CALLGRAPH_LINELEN \
+  (CONFIG_SCHED_CALLGRAPH_DEPTH * CALLGRAPH_FRAMELEN + 24)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct callgraph_file_s
+{
+  struct procfs_file_s base;            /* Base open file structure */
+  char line[CALLGRAPH_LINELEN];         /* Pre-allocated buffer for lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     callgraph_open(FAR struct file *filep,
+                              FAR const char *relpath,
+                              int oflags, mode_t mode);
+static int     callgraph_close(FAR struct file *filep);
+static ssize_t callgraph_read(FAR struct file *filep, FAR char *buffer,
+                              size_t buflen);
+static ssize_t callgraph_write(FAR struct file *filep,
+                               FAR const char *buffer, size_t buflen);
+static int     callgraph_dup(FAR const struct file *oldp,
+                             FAR struct file *newp);
+static int     callgraph_stat(FAR const char *relpath,
+                              FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations g_callgraph_operations =
+{
+  callgraph_open,   /* open */
+  callgraph_close,  /* close */
+  callgraph_read,   /* read */
+  callgraph_write,  /* write */
+  NULL,             /* poll */
+  callgraph_dup,    /* dup */
+  NULL,             /* opendir */
+  NULL,             /* closedir */
+  NULL,             /* readdir */
+  NULL,             /* rewinddir */
+  callgraph_stat    /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: callgraph_frame
+ *
+ * Description:
+ *   Format one frame of a call stack, by its symbol name if the symbol
+ *   table is linked in, so that the samples of a function fold together.
+ *
+ ****************************************************************************/
+
+static size_t callgraph_frame(FAR char *buf, size_t size, FAR void *addr,
+                              bool first)
+{
+#ifdef CONFIG_ALLSYMS
+  FAR const struct symtab_s *symbol;
+
+  symbol = allsyms_findbyvalue(addr, NULL);
+  if (symbol != NULL)
+    {
+      return procfs_snprintf(buf, size, "%s%s", first ? "" : ";",
+                             symbol->sym_name);
+    }
+#endif
+
+  return procfs_snprintf(buf, size, "%s0x%" PRIxPTR, first ? "" : ";",
+                         (uintptr_t)addr);
+}
+
+/****************************************************************************
+ * Name: callgraph_open
+ ****************************************************************************/
+
+static int callgraph_open(FAR struct file *filep, FAR const char *relpath,
+                          int oflags, mode_t mode)
+{
+  FAR struct callgraph_file_s *attr;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* Allocate a container to hold the file attributes */
+
+  attr = fs_heap_zalloc(sizeof(struct callgraph_file_s));
+  if (!attr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)attr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: callgraph_close
+ ****************************************************************************/
+
+static int callgraph_close(FAR struct file *filep)
+{
+  FAR struct callgraph_file_s *attr;
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct callgraph_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  /* Release the file attributes structure */
+
+  fs_heap_free(attr);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: callgraph_read
+ *
+ * Description:
+ *   Show the sampled call stacks in the folded format of flamegraph.pl,
+ *   one line per stack: the frames from the outermost one separated by
+ *   semicolons, then the number of samples.
+ *
+ ****************************************************************************/
+
+static ssize_t callgraph_read(FAR struct file *filep, FAR char *buffer,
+                              size_t buflen)
+{
+  FAR struct callgraph_file_s *attr;
+  struct sched_callgraph_stack_s stack;
+  size_t linesize;
+  size_t copysize = 0;
+  size_t totalsize = 0;
+  off_t offset;
+  unsigned int i;
+  int depth;
+
+  DEBUGASSERT(buffer != NULL && buflen > 0);
+  offset = filep->f_pos;
+
+  attr = (FAR struct callgraph_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  for (i = 0; buflen > copysize && sched_callgraph_stack(i, &stack) >= 0;
+       i++)
+    {
+      buffer += copysize;
+      buflen -= copysize;
+
+      for (depth = 0; depth < CONFIG_SCHED_CALLGRAPH_DEPTH &&
+                      stack.backtrace[depth] != NULL; depth++)
+        {
+        }
+
+      linesize = 0;
+      while (depth-- > 0)
+        {
+          linesize += callgraph_frame(attr->line + linesize,
+                                      CALLGRAPH_LINELEN - linesize,
+                                      stack.backtrace[depth],
+                                      linesize == 0);
+        }
+
+      linesize += procfs_snprintf(attr->line + linesize,
+                                  CALLGRAPH_LINELEN - linesize,
+                                  " %lu\n", stack.count);
+      copysize   = procfs_memcpy(attr->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+    }
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: callgraph_write
+ *
+ * Description:
+ *   "start" and "stop" the sampling, "reset" drops the samples.
+ *
+ ****************************************************************************/
+
+static ssize_t callgraph_write(FAR struct file *filep,
+                               FAR const char *buffer, size_t buflen)
+{
+  DEBUGASSERT(buffer != NULL && buflen > 0);
+
+  if (strncmp(buffer, "start", 5) == 0)
+    {
+      sched_callgraph_start();
+    }
+  else if (strncmp(buffer, "stop", 4) == 0)
+    {
+      sched_callgraph_stop();
+    }
+  else if (strncmp(buffer, "reset", 5) == 0)
+    {
+      sched_callgraph_reset();
+    }
+  else
+    {
+      return -EINVAL;
+    }
+
+  return buflen;
+}
+
+/****************************************************************************
+ * Name: callgraph_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int callgraph_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct callgraph_file_s *oldattr;
+  FAR struct callgraph_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct callgraph_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = fs_heap_malloc(sizeof(struct callgraph_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct callgraph_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: callgraph_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int callgraph_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR | S_IWUSR;
+  return OK;
+}
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
+        * CONFIG_SCHED_CALLGRAPH */
@@ -0,0 +1,353 @@
+/****************************************************************************
+ * fs/procfs/fs_procfslatency.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <inttypes.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/sched_latency.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#include "fs_heap.h"
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    defined(CONFIG_SCHED_LATENCY)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define LATENCY_LINELEN    96
+
+#define LATENCY_BANDWIDTH \
+  ((256 + CONFIG_SCHED_LATENCY_NBANDS - 1) / CONFIG_SCHED_LATENCY_NBANDS)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct latency_file_s
+{
+  struct procfs_file_s base;            /* Base open file structure */
+  struct sched_latency_s latency;       /* Snapshot of one histogram */
+  char line[LATENCY_LINELEN];           /* Pre-allocated buffer for lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     latency_open(FAR struct file *filep, FAR const char *relpath,
+                            int oflags, mode_t mode);
+static int     latency_close(FAR struct file *filep);
+static ssize_t latency_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen);
+static ssize_t latency_write(FAR struct file *filep, FAR const char *buffer,
+                             size_t buflen);
+static int     latency_dup(FAR const struct file *oldp,
+                           FAR struct file *newp);
+static int     latency_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations g_latency_operations =
+{
+  latency_open,   /* open */
+  latency_close,  /* close */
+  latency_read,   /* read */
+  latency_write,  /* write */
+  NULL,           /* poll */
+  latency_dup,    /* dup */
+  NULL,           /* opendir */
+  NULL,           /* closedir */
+  NULL,           /* readdir */
+  NULL,           /* rewinddir */
+  latency_stat    /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: latency_open
+ ****************************************************************************/
+
+static int latency_open(FAR struct file *filep, FAR const char *relpath,
+                        int oflags, mode_t mode)
+{
+  FAR struct latency_file_s *attr;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* Allocate a container to hold the file attributes */
+
+  attr = fs_heap_zalloc(sizeof(struct latency_file_s));
+  if (!attr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)attr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: latency_close
+ ****************************************************************************/
+
+static int latency_close(FAR struct file *filep)
+{
+  FAR struct latency_file_s *attr;
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct latency_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  /* Release the file attributes structure */
+
+  fs_heap_free(attr);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: latency_read
+ *
+ * Description:
+ *   Show the histograms that have samples: a line with the number of
+ *   samples, of those above the threshold, the worst and the mean latency,
+ *   then one line per non-empty bucket with its lowest latency and its
+ *   number of samples, all in nanoseconds.
+ *
+ ****************************************************************************/
+
+static ssize_t latency_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen)
+{
+  FAR struct latency_file_s *attr;
+  FAR struct sched_latency_s *latency;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize = 0;
+  off_t offset;
+  int type;
+  int index;
+  int i;
+
+  DEBUGASSERT(buffer != NULL && buflen > 0);
+  offset = filep->f_pos;
+
+  attr = (FAR struct latency_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+  latency = &attr->latency;
+
+  for (type = SCHED_LATENCY_CPU; type <= SCHED_LATENCY_TEST; type++)
+    {
+      for (index = 0; buflen > 0 &&
+                      sched_latency_get(type, index, latency) >= 0; index++)
+        {
+          if (latency->count == 0)
+            {
+              continue;
+            }
+
+          if (type == SCHED_LATENCY_CPU)
+            {
+              linesize = procfs_snprintf(attr->line, LATENCY_LINELEN,
+                                         "cpu%d:", index);
+            }
+          else if (type == SCHED_LATENCY_PRIO)
+            {
+              linesize = procfs_snprintf(attr->line, LATENCY_LINELEN,
+                                         "prio%d-%d:",
+                                         index * LATENCY_BANDWIDTH,
+                                         (index + 1) *
+                                         LATENCY_BANDWIDTH - 1);
+            }
+          else
+            {
+              linesize = procfs_snprintf(attr->line, LATENCY_LINELEN,
+                                         "test:");
+            }
+
+          linesize += procfs_snprintf(attr->line + linesize,
+                                      LATENCY_LINELEN - linesize,
+                                      " count %lu over %lu max %" PRIu32
+                                      " avg %" PRIu64 "\n",
+                                      latency->count, latency->over,
+                                      latency->max,
+                                      latency->sum / latency->count);
+          copysize   = procfs_memcpy(attr->line, linesize, buffer, buflen,
+                                     &offset);
+          totalsize += copysize;
+          buffer    += copysize;
+          buflen    -= copysize;
+
+          for (i = 0; i < SCHED_LATENCY_NBUCKETS && buflen > 0; i++)
+            {
+              if (latency->bucket[i] == 0)
+                {
+                  continue;
+                }
+
+              linesize   = procfs_snprintf(attr->line, LATENCY_LINELEN,
+                                           "  %" PRIu32 " %" PRIu32 "\n",
+                                           sched_latency_bucket(i),
+                                           latency->bucket[i]);
+              copysize   = procfs_memcpy(attr->line, linesize, buffer,
+                                         buflen, &offset);
+              totalsize += copysize;
+              buffer    += copysize;
+              buflen    -= copysize;
+            }
+        }
+    }
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: latency_write
+ *
+ * Description:
+ *   "reset" clears the histograms, "test" starts the self-test.
+ *
+ ****************************************************************************/
+
+static ssize_t latency_write(FAR struct file *filep, FAR const char *buffer,
+                             size_t buflen)
+{
+  int ret;
+
+  DEBUGASSERT(buffer != NULL && buflen > 0);
+
+  if (strncmp(buffer, "reset", 5) == 0)
+    {
+      sched_latency_reset();
+    }
+  else if (strncmp(buffer, "test", 4) == 0)
+    {
+      ret = sched_latency_selftest(CONFIG_SCHED_LATENCY_TEST_LOOPS,
+                                   CONFIG_SCHED_LATENCY_TEST_INTERVAL_US);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+  else
+    {
+      return -EINVAL;
+    }
+
+  return buflen;
+}
+
+/****************************************************************************
+ * Name: latency_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int latency_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct latency_file_s *oldattr;
+  FAR struct latency_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct latency_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = fs_heap_malloc(sizeof(struct latency_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct latency_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: latency_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int latency_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR | S_IWUSR;
+  return OK;
+}
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
+        * CONFIG_SCHED_LATENCY */
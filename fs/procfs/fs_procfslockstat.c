@@ -0,0 +1,377 @@
+/****************************************************************************
+ * fs/procfs/fs_procfslockstat.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <inttypes.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/allsyms.h>
+#include <nuttx/clock.h>
+#include <nuttx/lockstat.h>
+#include <nuttx/symtab.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#include "fs_heap.h"
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    defined(CONFIG_SCHED_LOCKSTAT)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define LOCKSTAT_LINELEN 192
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct lockstat_file_s
+{
+  struct procfs_file_s base;            /* Base open file structure */
+  char line[LOCKSTAT_LINELEN];          /* Pre-allocated buffer for lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     lockstat_open(FAR struct file *filep,
+                             FAR const char *relpath,
+                             int oflags, mode_t mode);
+static int     lockstat_close(FAR struct file *filep);
+static ssize_t lockstat_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen);
+static ssize_t lockstat_write(FAR struct file *filep,
+                              FAR const char *buffer, size_t buflen);
+static int     lockstat_dup(FAR const struct file *oldp,
+                            FAR struct file *newp);
+static int     lockstat_stat(FAR const char *relpath,
+                             FAR struct stat *buf);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR const char * const g_lockstat_type[] =
+{
+  "mutex",
+  "sem",
+  "spin"
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations g_lockstat_operations =
+{
+  lockstat_open,   /* open */
+  lockstat_close,  /* close */
+  lockstat_read,   /* read */
+  lockstat_write,  /* write */
+  NULL,            /* poll */
+  lockstat_dup,    /* dup */
+  NULL,            /* opendir */
+  NULL,            /* closedir */
+  NULL,            /* readdir */
+  NULL,            /* rewinddir */
+  lockstat_stat    /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lockstat_nsec
+ *
+ * Description:
+ *   Convert a time in perf_gettime() units to nanoseconds.
+ *
+ ****************************************************************************/
+
+static uint64_t lockstat_nsec(uint64_t elapsed)
+{
+  uint64_t freq = perf_getfreq();
+
+  if (freq == 0)
+    {
+      return 0;
+    }
+
+  return elapsed / freq * NSEC_PER_SEC +
+         elapsed % freq * NSEC_PER_SEC / freq;
+}
+
+/****************************************************************************
+ * Name: lockstat_site
+ *
+ * Description:
+ *   Format the site of a lock class, by the symbol it is in if the symbol
+ *   table is linked in.
+ *
+ ****************************************************************************/
+
+static size_t lockstat_site(FAR char *buf, size_t size, FAR void *site)
+{
+#ifdef CONFIG_ALLSYMS
+  FAR const struct symtab_s *symbol;
+
+  symbol = allsyms_findbyvalue(site, NULL);
+  if (symbol != NULL)
+    {
+      return procfs_snprintf(buf, size, "%s+0x%" PRIxPTR,
+                             symbol->sym_name,
+                             (uintptr_t)site -
+                             (uintptr_t)symbol->sym_value);
+    }
+#endif
+
+  return procfs_snprintf(buf, size, "0x%" PRIxPTR, (uintptr_t)site);
+}
+
+/****************************************************************************
+ * Name: lockstat_open
+ ****************************************************************************/
+
+static int lockstat_open(FAR struct file *filep, FAR const char *relpath,
+                         int oflags, mode_t mode)
+{
+  FAR struct lockstat_file_s *attr;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* Allocate a container to hold the file attributes */
+
+  attr = fs_heap_zalloc(sizeof(struct lockstat_file_s));
+  if (!attr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)attr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: lockstat_close
+ ****************************************************************************/
+
+static int lockstat_close(FAR struct file *filep)
+{
+  FAR struct lockstat_file_s *attr;
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct lockstat_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  /* Release the file attributes structure */
+
+  fs_heap_free(attr);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: lockstat_read
+ *
+ * Description:
+ *   Show one line per lock class: the kind of lock, the site, the number
+ *   of acquisitions and of contended ones, the total and the worst wait,
+ *   the total and the worst hold, in nanoseconds.  The semaphores have no
+ *   holder, so no hold time.
+ *
+ ****************************************************************************/
+
+static ssize_t lockstat_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen)
+{
+  FAR struct lockstat_file_s *attr;
+  struct lockstat_s stat;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize = 0;
+  off_t offset;
+  int i;
+
+  DEBUGASSERT(buffer != NULL && buflen > 0);
+  offset = filep->f_pos;
+
+  attr = (FAR struct lockstat_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  linesize   = procfs_snprintf(attr->line, LOCKSTAT_LINELEN,
+                               "TYPE CLASS ACQUIRED CONTENDED "
+                               "WAIT WAITMAX HOLD HOLDMAX\n");
+  copysize   = procfs_memcpy(attr->line, linesize, buffer, buflen,
+                             &offset);
+  totalsize += copysize;
+
+  for (i = 0; buflen > copysize && lockstat_get(i, &stat) >= 0; i++)
+    {
+      buffer += copysize;
+      buflen -= copysize;
+
+      linesize  = procfs_snprintf(attr->line, LOCKSTAT_LINELEN, "%s ",
+                                  g_lockstat_type[stat.type]);
+      linesize += lockstat_site(attr->line + linesize,
+                                LOCKSTAT_LINELEN - linesize, stat.site);
+      linesize += procfs_snprintf(attr->line + linesize,
+                                  LOCKSTAT_LINELEN - linesize,
+                                  " %lu %lu %" PRIu64 " %" PRIu64
+                                  " %" PRIu64 " %" PRIu64 "\n",
+                                  stat.acquired, stat.contended,
+                                  lockstat_nsec(stat.waittime),
+                                  lockstat_nsec(stat.waitmax),
+                                  lockstat_nsec(stat.holdtime),
+                                  lockstat_nsec(stat.holdmax));
+
+      copysize   = procfs_memcpy(attr->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+    }
+
+  if (buflen > copysize && lockstat_dropped() > 0)
+    {
+      buffer += copysize;
+      buflen -= copysize;
+
+      linesize   = procfs_snprintf(attr->line, LOCKSTAT_LINELEN,
+                                   "dropped %lu\n", lockstat_dropped());
+      copysize   = procfs_memcpy(attr->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+    }
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: lockstat_write
+ *
+ * Description:
+ *   "reset" forgets the lock classes.
+ *
+ ****************************************************************************/
+
+static ssize_t lockstat_write(FAR struct file *filep,
+                              FAR const char *buffer, size_t buflen)
+{
+  DEBUGASSERT(buffer != NULL && buflen > 0);
+
+  if (strncmp(buffer, "reset", 5) != 0)
+    {
+      return -EINVAL;
+    }
+
+  lockstat_reset();
+  return buflen;
+}
+
+/****************************************************************************
+ * Name: lockstat_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int lockstat_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct lockstat_file_s *oldattr;
+  FAR struct lockstat_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct lockstat_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = fs_heap_malloc(sizeof(struct lockstat_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct lockstat_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: lockstat_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int lockstat_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR | S_IWUSR;
+  return OK;
+}
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
+        * CONFIG_SCHED_LOCKSTAT */
@@ -37,11 +37,15 @@
 #include <errno.h>
 #include <debug.h>
 #include <ctype.h>
+#include <inttypes.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/pgalloc.h>
 #include <nuttx/progmem.h>
 #include <nuttx/sched.h>
+#include <nuttx/mm/heapprof.h>
+#include <nuttx/mm/heaptag.h>
 #include <nuttx/mm/mm.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/procfs.h>
@@ -106,6 +110,14 @@ static ssize_t memdump_write(FAR struct file *filep, FAR const char *buffer,
 #endif
 static ssize_t meminfo_read(FAR struct file *filep, FAR char *buffer,
                  size_t buflen);
+#ifdef CONFIG_MM_HEAPPROF
+static ssize_t heapprof_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen);
+#endif
+#ifdef CONFIG_MM_HEAPTAG
+static ssize_t heaptag_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen);
+#endif
 static int     meminfo_dup(FAR const struct file *oldp,
                  FAR struct file *newp);
 static int     meminfo_stat(FAR const char *relpath, FAR struct stat *buf);
@@ -151,6 +163,40 @@ const struct procfs_operations g_memdump_operations =
 };
 #endif
 
+#ifdef CONFIG_MM_HEAPPROF
+const struct procfs_operations g_heapprof_operations =
+{
+  meminfo_open,   /* open */
+  meminfo_close,  /* close */
+  heapprof_read,  /* read */
+  NULL,           /* write */
+  NULL,           /* poll */
+  meminfo_dup,    /* dup */
+  NULL,           /* opendir */
+  NULL,           /* closedir */
+  NULL,           /* readdir */
+  NULL,           /* rewinddir */
+  meminfo_stat    /* stat */
+};
+#endif
+
+#ifdef CONFIG_MM_HEAPTAG
+const struct procfs_operations g_heaptag_operations =
+{
+  meminfo_open,   /* open */
+  meminfo_close,  /* close */
+  heaptag_read,   /* read */
+  NULL,           /* write */
+  NULL,           /* poll */
+  meminfo_dup,    /* dup */
+  NULL,           /* opendir */
+  NULL,           /* closedir */
+  NULL,           /* readdir */
+  NULL,           /* rewinddir */
+  meminfo_stat    /* stat */
+};
+#endif
+
 static FAR struct procfs_meminfo_entry_s *g_procfs_meminfo = NULL;
 
 /****************************************************************************
@@ -407,6 +453,211 @@ static ssize_t meminfo_read(FAR struct file *filep, FAR char *buffer,
   return totalsize;
 }
 
+/****************************************************************************
+ * Name: heapprof_read
+ *
+ * Description:
+ *   Show the sampled heap profile in the legacy pprof heap profile format.
+ *   Each line holds the live and the total sampled allocations of one call
+ *   site, the heap_v2 tag lets pprof scale them up by the sampling
+ *   interval.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_HEAPPROF
+static ssize_t heapprof_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen)
+{
+  FAR struct meminfo_file_s *procfile;
+  struct mm_heapprof_site_s site;
+  struct mm_heapprof_s info;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+  off_t offset;
+  unsigned int i;
+  int depth;
+
+  DEBUGASSERT(buffer != NULL && buflen > 0);
+  offset = filep->f_pos;
+
+  procfile = (FAR struct meminfo_file_s *)filep->f_priv;
+  DEBUGASSERT(procfile);
+
+  mm_heapprof_info(&info);
+  linesize  = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
+                              "heap profile: %lu: %zu [%lu: %" PRIu64 "] "
+                              "@ heap_v2/%lu\n",
+                              info.nlive, info.live, info.nalloc,
+                              info.alloc, info.interval);
+  copysize  = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                            &offset);
+  totalsize = copysize;
+
+  for (i = 0; buflen > copysize && mm_heapprof_site(i, &site) >= 0; i++)
+    {
+      buffer += copysize;
+      buflen -= copysize;
+
+      linesize = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
+                                 "%lu: %zu [%lu: %" PRIu64 "] @",
+                                 site.nlive, site.live, site.nalloc,
+                                 site.alloc);
+      for (depth = 0; depth < CONFIG_MM_HEAPPROF_DEPTH &&
+                      site.backtrace[depth] != NULL; depth++)
+        {
+          linesize += procfs_snprintf(procfile->line + linesize,
+                                      MEMINFO_LINELEN - linesize,
+                                      " 0x%" PRIxPTR,
+                                      (uintptr_t)site.backtrace[depth]);
+        }
+
+      linesize += procfs_snprintf(procfile->line + linesize,
+                                  MEMINFO_LINELEN - linesize, "\n");
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+    }
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+#endif
+
+/****************************************************************************
+ * Name: heaptag_read
+ *
+ * Description:
+ *   Show the heap accounting per tag, then per thread.  Alloc/s is the
+ *   rate of the allocated bytes since the previous read of the file.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_HEAPTAG
+static ssize_t heaptag_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen)
+{
+  static FAR const char *const names[] = MM_HEAPTAG_NAMES;
+  static uint64_t lastalloc[MM_HEAPTAG_NTAGS];
+  static uint64_t rate[MM_HEAPTAG_NTAGS];
+  static clock_t lasttime;
+  FAR struct meminfo_file_s *procfile;
+  struct mm_heaptag_s info;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+  off_t offset;
+  clock_t elapsed;
+  clock_t now;
+  unsigned int i;
+  int ret;
+
+  DEBUGASSERT(buffer != NULL && buflen > 0);
+  offset = filep->f_pos;
+
+  procfile = (FAR struct meminfo_file_s *)filep->f_priv;
+  DEBUGASSERT(procfile);
+
+  now     = clock_systime_ticks();
+  elapsed = now - lasttime;
+
+  linesize  = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
+                              "%-8s %10s %10s %10s %12s %10s\n",
+                              "Tag", "Live", "Peak", "Nalloc", "Alloc",
+                              "Alloc/s");
+  copysize  = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                            &offset);
+  totalsize = copysize;
+
+  for (i = 0; i < MM_HEAPTAG_NTAGS && buflen > copysize; i++)
+    {
+      buffer += copysize;
+      buflen -= copysize;
+
+      mm_heaptag_tag(i, &info);
+
+      /* Only the first read of the file starts a new interval, the
+       * following reads show the same rates.
+       */
+
+      if (filep->f_pos == 0 && elapsed > 0)
+        {
+          rate[i]      = (info.alloc - lastalloc[i]) * TICK_PER_SEC /
+                         elapsed;
+          lastalloc[i] = info.alloc;
+        }
+
+      linesize   = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
+                                   "%-8s %10zu %10zu %10lu %12" PRIu64
+                                   " %10" PRIu64 "\n",
+                                   names[i], info.live, info.peak,
+                                   info.nalloc, info.alloc, rate[i]);
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+    }
+
+  if (filep->f_pos == 0 && elapsed > 0)
+    {
+      lasttime = now;
+    }
+
+  if (buflen > copysize)
+    {
+      buffer += copysize;
+      buflen -= copysize;
+
+      linesize   = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
+                                   "\n%8s %10s %10s %10s %12s\n",
+                                   "PID", "Live", "Peak", "Nalloc",
+                                   "Alloc");
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+    }
+
+  for (i = 0; buflen > copysize; i++)
+    {
+      ret = mm_heaptag_task(i, &info);
+      if (ret == -ENOENT)
+        {
+          break;
+        }
+      else if (ret < 0)
+        {
+          continue;
+        }
+
+      buffer += copysize;
+      buflen -= copysize;
+
+      linesize   = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
+                                   "%8d %10zu %10zu %10lu %12" PRIu64 "\n",
+                                   (int)info.pid, info.live, info.peak,
+                                   info.nalloc, info.alloc);
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+    }
+
+  if (buflen > copysize)
+    {
+      buffer += copysize;
+      buflen -= copysize;
+
+      linesize   = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
+                                   "\nDropped: %lu\n",
+                                   mm_heaptag_dropped());
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+    }
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+#endif
+
 /****************************************************************************
  * Name: memdump_read
  ****************************************************************************/
@@ -87,9 +87,17 @@ static int     romfs_opendir(FAR struct inode *mountpt,
                              FAR struct fs_dirent_s **dir);
 static int     romfs_closedir(FAR struct inode *mountpt,
                               FAR struct fs_dirent_s *dir);
+static int     romfs_readdir_common(FAR struct inode *mountpt,
+                                    FAR struct fs_dirent_s *dir,
+                                    FAR struct dirent *entry,
+                                    FAR struct stat *buf);
 static int     romfs_readdir(FAR struct inode *mountpt,
                              FAR struct fs_dirent_s *dir,
                              FAR struct dirent *entry);
+static int     romfs_readdirplus(FAR struct inode *mountpt,
+                                 FAR struct fs_dirent_s *dir,
+                                 FAR struct dirent *entry,
+                                 FAR struct stat *buf);
 static int     romfs_rewinddir(FAR struct inode *mountpt,
                                FAR struct fs_dirent_s *dir);
 
@@ -116,36 +124,38 @@ static int     romfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
 
 const struct mountpt_operations g_romfs_operations =
 {
-  romfs_open,      /* open */
-  romfs_close,     /* close */
-  romfs_read,      /* read */
-  NULL,            /* write */
-  romfs_seek,      /* seek */
-  romfs_ioctl,     /* ioctl */
-  romfs_mmap,      /* mmap */
-  NULL,            /* truncate */
-  NULL,            /* poll */
-
-  NULL,            /* sync */
-  romfs_dup,       /* dup */
-  romfs_fstat,     /* fstat */
-  NULL,            /* fchstat */
-
-  romfs_opendir,   /* opendir */
-  romfs_closedir,  /* closedir */
-  romfs_readdir,   /* readdir */
-  romfs_rewinddir, /* rewinddir */
-
-  romfs_bind,      /* bind */
-  romfs_unbind,    /* unbind */
-  romfs_statfs,    /* statfs */
-
-  NULL,            /* unlink */
-  NULL,            /* mkdir */
-  NULL,            /* rmdir */
-  NULL,            /* rename */
-  romfs_stat,      /* stat */
-  NULL             /* chstat */
+  romfs_open,         /* open */
+  romfs_close,        /* close */
+  romfs_read,         /* read */
+  NULL,               /* write */
+  romfs_seek,         /* seek */
+  romfs_ioctl,        /* ioctl */
+  romfs_mmap,         /* mmap */
+  NULL,               /* truncate */
+  NULL,               /* poll */
+
+  NULL,               /* sync */
+  romfs_dup,          /* dup */
+  romfs_fstat,        /* fstat */
+  NULL,               /* fchstat */
+
+  romfs_opendir,      /* opendir */
+  romfs_closedir,     /* closedir */
+  romfs_readdir,      /* readdir */
+  romfs_rewinddir,    /* rewinddir */
+
+  romfs_bind,         /* bind */
+  romfs_unbind,       /* unbind */
+  romfs_statfs,       /* statfs */
+
+  NULL,               /* unlink */
+  NULL,               /* mkdir */
+  NULL,               /* rmdir */
+  NULL,               /* rename */
+  romfs_stat,         /* stat */
+  NULL,               /* chstat */
+  NULL,               /* syncfs */
+  romfs_readdirplus   /* readdirplus */
 };
 
 /****************************************************************************
@@ -936,24 +946,25 @@ static int romfs_closedir(FAR struct inode *mountpt,
 }
 
 /****************************************************************************
- * Name: romfs_readdir
+ * Name: romfs_readdir_common
  *
  * Description
- *   Read the next directory entry
+ *   Read the next directory entry, and its attributes if buf isn't NULL
  *
  ****************************************************************************/
 
-static int romfs_readdir(FAR struct inode *mountpt,
-                         FAR struct fs_dirent_s *dir,
-                         FAR struct dirent *entry)
+static int romfs_readdir_common(FAR struct inode *mountpt,
+                                FAR struct fs_dirent_s *dir,
+                                FAR struct dirent *entry,
+                                FAR struct stat *buf)
 {
   FAR struct romfs_mountpt_s *rm;
   FAR struct romfs_dir_s     *rdir;
 #ifndef CONFIG_FS_ROMFS_CACHE_NODE
   uint32_t                    linkoffset;
   uint32_t                    info;
-  uint32_t                    size;
 #endif
+  uint32_t                    size;
   uint32_t                    next;
   int                         ret;
 
@@ -1006,6 +1017,7 @@ static int romfs_readdir(FAR struct inode *mountpt,
 
 #ifdef CONFIG_FS_ROMFS_CACHE_NODE
       next = (*rdir->currnode)->rn_next;
+      size = (*rdir->currnode)->rn_size;
       strlcpy(entry->d_name, (*rdir->currnode)->rn_name,
               sizeof(entry->d_name));
       rdir->currnode++;
@@ -1054,11 +1066,49 @@ static int romfs_readdir(FAR struct inode *mountpt,
         }
     }
 
+  /* The directory entry holds the attributes too */
+
+  if (buf != NULL)
+    {
+      ret = romfs_stat_common((uint8_t)(next & RFNEXT_ALLMODEMASK), size,
+                              rm->rm_hwsectorsize, buf);
+    }
+
 errout_with_lock:
   nxrmutex_unlock(&rm->rm_lock);
   return ret;
 }
 
+/****************************************************************************
+ * Name: romfs_readdir
+ *
+ * Description
+ *   Read the next directory entry
+ *
+ ****************************************************************************/
+
+static int romfs_readdir(FAR struct inode *mountpt,
+                         FAR struct fs_dirent_s *dir,
+                         FAR struct dirent *entry)
+{
+  return romfs_readdir_common(mountpt, dir, entry, NULL);
+}
+
+/****************************************************************************
+ * Name: romfs_readdirplus
+ *
+ * Description
+ *   Read the next directory entry and its attributes
+ *
+ ****************************************************************************/
+
+static int romfs_readdirplus(FAR struct inode *mountpt,
+                             FAR struct fs_dirent_s *dir,
+                             FAR struct dirent *entry, FAR struct stat *buf)
+{
+  return romfs_readdir_common(mountpt, dir, entry, buf);
+}
+
 /****************************************************************************
  * Name: romfs_rewindir
  *
@@ -469,7 +469,8 @@ ssize_t rpmsgfs_client_read(FAR void *handle, int fd,
     };
 
   struct rpmsgfs_cookie_s cookie;
-  struct rpmsgfs_read_s msg;
+  FAR struct rpmsgfs_read_s *msg;
+  uint32_t space;
   int ret = 0;
 
   if (!buf || count <= 0)
@@ -482,15 +483,23 @@ ssize_t rpmsgfs_client_read(FAR void *handle, int fd,
   nxsem_init(&cookie.sem, 0, 0);
   cookie.data = &read;
 
-  msg.header.command = RPMSGFS_READ;
-  msg.header.result  = -ENXIO;
-  msg.header.cookie  = (uintptr_t)&cookie;
-  msg.fd             = fd;
-  msg.count          = count;
+  msg = rpmsgfs_get_tx_payload_buffer(priv, &space);
+  if (!msg)
+    {
+      ret = -ENOMEM;
+      goto out;
+    }
+
+  msg->header.command = RPMSGFS_READ;
+  msg->header.result  = -ENXIO;
+  msg->header.cookie  = (uintptr_t)&cookie;
+  msg->fd             = fd;
+  msg->count          = count;
 
-  ret = rpmsg_send(&priv->ept, &msg, sizeof(msg));
+  ret = rpmsg_send_nocopy(&priv->ept, msg, sizeof(*msg));
   if (ret < 0)
     {
+      rpmsg_release_tx_buffer(&priv->ept, msg);
       goto out;
     }
 
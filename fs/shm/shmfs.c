@@ -270,6 +270,7 @@ static int shmfs_unlink(FAR struct inode *inode)
  ****************************************************************************/
 
 static int shmfs_map_object(FAR struct shmfs_object_s *object,
+                            off_t offset, size_t length,
                             FAR void **vaddr)
 {
   int ret = OK;
@@ -283,10 +284,24 @@ static int shmfs_map_object(FAR struct shmfs_object_s *object,
   uintptr_t mapaddr;
   unsigned int npages;
 
+#ifdef CONFIG_FS_SHMFS_LAZY_ALLOC
+  /* Allocate the pages of the range on their first mapping.  There is no
+   * page fault handling for the user mappings, so the range is populated
+   * whole, but the pages never mapped are never allocated.
+   */
+
+  inode_lock();
+  ret = shmfs_populate_object(object, offset, length);
+  inode_unlock();
+  if (ret < 0)
+    {
+      return ret;
+    }
+#endif
+
   /* Find a free vaddr space that satisfies length */
 
-  mapaddr = (uintptr_t)vm_alloc_region(get_group_mm(group), 0,
-                                       object->length);
+  mapaddr = (uintptr_t)vm_alloc_region(get_group_mm(group), 0, length);
   if (mapaddr == 0)
     {
       return -ENOMEM;
@@ -294,15 +309,14 @@ static int shmfs_map_object(FAR struct shmfs_object_s *object,
 
   /* Convert the region size to pages */
 
-  npages = MM_NPAGES(object->length);
+  npages = MM_NPAGES(length);
 
   /* Map the memory to user virtual address space */
 
-  ret = up_shmat(pages, npages, mapaddr);
+  ret = up_shmat(&pages[offset / MM_PGSIZE], npages, mapaddr);
   if (ret < 0)
     {
-      vm_release_region(get_group_mm(group), (FAR void *)mapaddr,
-                        object->length);
+      vm_release_region(get_group_mm(group), (FAR void *)mapaddr, length);
     }
   else
     {
@@ -311,7 +325,7 @@ static int shmfs_map_object(FAR struct shmfs_object_s *object,
 #else
   /* Use the physical address directly */
 
-  *vaddr = object->paddr;
+  *vaddr = (FAR char *)object->paddr + offset;
 #endif
 
   return ret;
@@ -339,11 +353,15 @@ static int shmfs_mmap(FAR struct file *filep,
   FAR struct shmfs_object_s *object;
   int ret = -EINVAL;
 
-  /* We don't support offset at the moment, just mapping the whole object
-   * object is NULL if it hasn't been truncated yet
+  /* A part of the object may be mapped, from a page boundary in the
+   * KERNEL build.  object is NULL if it hasn't been truncated yet.
    */
 
-  if (entry->offset != 0)
+#ifdef CONFIG_BUILD_KERNEL
+  if (entry->offset < 0 || entry->offset % MM_PGSIZE != 0)
+#else
+  if (entry->offset < 0)
+#endif
     {
       return ret;
     }
@@ -352,9 +370,11 @@ static int shmfs_mmap(FAR struct file *filep,
 
   inode_addref(filep->f_inode);
   object = filep->f_inode->i_private;
-  if (object)
+  if (object && entry->length <= object->length &&
+      entry->offset <= object->length - entry->length)
     {
-      ret = shmfs_map_object(object, &entry->vaddr);
+      ret = shmfs_map_object(object, entry->offset, entry->length,
+                             &entry->vaddr);
     }
 
   if (ret < 0 ||
@@ -49,7 +49,8 @@ struct shmfs_object_s
    *   allocated memory.
    *
    * - In kernel build this is start of a malloc'd vector of void pointers
-   *   and the length of the vector is MM_NPAGES(length).
+   *   and the length of the vector is MM_NPAGES(length).  With
+   *   CONFIG_FS_SHMFS_LAZY_ALLOC the pages not mapped yet are NULL.
    */
 
   FAR void *paddr;
@@ -67,4 +68,9 @@ FAR struct shmfs_object_s *shmfs_alloc_object(size_t length);
 
 void shmfs_free_object(FAR struct shmfs_object_s *object);
 
+#ifdef CONFIG_FS_SHMFS_LAZY_ALLOC
+int shmfs_populate_object(FAR struct shmfs_object_s *object,
+                          off_t offset, size_t length);
+#endif
+
 #endif
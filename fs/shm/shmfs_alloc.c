@@ -24,6 +24,7 @@
 
 #include <nuttx/config.h>
 
+#include <errno.h>
 #include <stdbool.h>
 
 #include <nuttx/arch.h>
@@ -84,12 +85,24 @@ FAR struct shmfs_object_s *shmfs_alloc_object(size_t length)
    */
 
   size_t i = 0;
+#ifndef CONFIG_FS_SHMFS_LAZY_ALLOC
   FAR void **pages;
+#endif
   size_t n_pages = MM_NPAGES(length);
 
   object = fs_heap_zalloc(sizeof(struct shmfs_object_s) +
                       (n_pages - 1) * sizeof(object->paddr));
 
+#ifdef CONFIG_FS_SHMFS_LAZY_ALLOC
+  /* The pages are allocated when they are first mapped, see
+   * shmfs_populate_object().
+   */
+
+  if (object)
+    {
+      i = n_pages;
+    }
+#else
   if (object)
     {
       pages = &object->paddr;
@@ -108,6 +121,7 @@ FAR struct shmfs_object_s *shmfs_alloc_object(size_t length)
             }
         }
     }
+#endif
 
   if (i == n_pages)
     {
@@ -130,6 +144,37 @@ FAR struct shmfs_object_s *shmfs_alloc_object(size_t length)
   return object;
 }
 
+#ifdef CONFIG_FS_SHMFS_LAZY_ALLOC
+int shmfs_populate_object(FAR struct shmfs_object_s *object,
+                          off_t offset, size_t length)
+{
+  FAR void **pages = &object->paddr;
+  size_t first = offset / MM_PGSIZE;
+  size_t last = MM_NPAGES(offset + length);
+  size_t i;
+
+  DEBUGASSERT(offset + length <= object->length);
+
+  for (i = first; i < last; i++)
+    {
+      if (pages[i] == NULL)
+        {
+          pages[i] = (FAR void *)mm_pgalloc(1);
+          if (pages[i] == NULL)
+            {
+              return -ENOMEM;
+            }
+
+          /* Clear the page memory, the object reads as zeros */
+
+          up_addrenv_page_wipe((uintptr_t)pages[i]);
+        }
+    }
+
+  return OK;
+}
+#endif
+
 void shmfs_free_object(FAR struct shmfs_object_s *object)
 {
 #if defined(CONFIG_BUILD_KERNEL)
@@ -52,6 +52,8 @@ static int sock_file_ioctl(FAR struct file *filep, int cmd,
                            unsigned long arg);
 static int sock_file_poll(FAR struct file *filep, struct pollfd *fds,
                           bool setup);
+static int sock_file_mmap(FAR struct file *filep,
+                          FAR struct mm_map_entry_s *map);
 static int sock_file_truncate(FAR struct file *filep, off_t length);
 
 /****************************************************************************
@@ -66,7 +68,7 @@ static const struct file_operations g_sock_fileops =
   sock_file_write,    /* write */
   NULL,               /* seek */
   sock_file_ioctl,    /* ioctl */
-  NULL,               /* mmap */
+  sock_file_mmap,     /* mmap */
   sock_file_truncate, /* truncate */
   sock_file_poll      /* poll */
 };
@@ -136,6 +138,23 @@ static int sock_file_ioctl(FAR struct file *filep, int cmd,
   return psock_ioctl(filep->f_priv, cmd, arg);
 }
 
+static int sock_file_mmap(FAR struct file *filep,
+                          FAR struct mm_map_entry_s *map)
+{
+  FAR struct socket *psock = filep->f_priv;
+
+  /* Sockets have nothing to read into a private copy, so do not let
+   * mmap() fall back to that with -ENOTTY.
+   */
+
+  if (psock->s_sockif == NULL || psock->s_sockif->si_mmap == NULL)
+    {
+      return -ENODEV;
+    }
+
+  return psock->s_sockif->si_mmap(psock, map);
+}
+
 static int sock_file_poll(FAR struct file *filep, FAR struct pollfd *fds,
                           bool setup)
 {
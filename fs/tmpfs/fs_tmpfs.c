@@ -26,6 +26,7 @@
 
 #include <sys/stat.h>
 #include <sys/statfs.h>
+#include <sys/param.h>
 #include <stdint.h>
 #include <string.h>
 #include <fcntl.h>
@@ -34,6 +35,7 @@
 #include <debug.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/dma/dma.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
 
@@ -55,6 +57,15 @@
 #  warning CONFIG_FS_TMPFS_FILE_FREEGUARD needs to be > ALLOCGUARD
 #endif
 
+#if CONFIG_FS_TMPFS_CHUNKSIZE > 0
+#  define TMPFS_NCHUNKS(size) \
+     (((size) + CONFIG_FS_TMPFS_CHUNKSIZE - 1) / CONFIG_FS_TMPFS_CHUNKSIZE)
+
+/* The chunk table grows by this many entries at once */
+
+#  define TMPFS_CHUNKS_ALLOCGUARD 16
+#endif
+
 #define tmpfs_lock(fs) \
            nxrmutex_lock(&fs->tfs_lock)
 #define tmpfs_lock_object(to) \
@@ -93,6 +104,15 @@ static int  tmpfs_realloc_directory(FAR struct tmpfs_directory_s *tdo,
               unsigned int nentries);
 static int  tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
               size_t newsize);
+static void tmpfs_free_data(FAR struct tmpfs_file_s *tfo);
+#if CONFIG_FS_TMPFS_CHUNKSIZE > 0
+static FAR uint8_t *tmpfs_get_chunk(FAR struct tmpfs_file_s *tfo,
+              size_t index, bool alloc);
+static void tmpfs_read_chunks(FAR struct tmpfs_file_s *tfo,
+              FAR char *buffer, size_t pos, size_t len);
+static ssize_t tmpfs_write_chunks(FAR struct tmpfs_file_s *tfo,
+              FAR const char *buffer, size_t pos, size_t len);
+#endif
 static void tmpfs_release_lockedobject(FAR struct tmpfs_object_s *to);
 static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo);
 static int  tmpfs_release_file(FAR struct tmpfs_file_s *tfo);
@@ -151,9 +171,15 @@ static int  tmpfs_opendir(FAR struct inode *mountpt, FAR const char *relpath,
               FAR struct fs_dirent_s **dir);
 static int  tmpfs_closedir(FAR struct inode *mountpt,
               FAR struct fs_dirent_s *dir);
+static int  tmpfs_readdir_common(FAR struct inode *mountpt,
+              FAR struct fs_dirent_s *dir,
+              FAR struct dirent *entry, FAR struct stat *buf);
 static int  tmpfs_readdir(FAR struct inode *mountpt,
               FAR struct fs_dirent_s *dir,
               FAR struct dirent *entry);
+static int  tmpfs_readdirplus(FAR struct inode *mountpt,
+              FAR struct fs_dirent_s *dir,
+              FAR struct dirent *entry, FAR struct stat *buf);
 static int  tmpfs_rewinddir(FAR struct inode *mountpt,
               FAR struct fs_dirent_s *dir);
 static int  tmpfs_bind(FAR struct inode *blkdriver, FAR const void *data,
@@ -207,7 +233,9 @@ const struct mountpt_operations g_tmpfs_operations =
   tmpfs_rmdir,      /* rmdir */
   tmpfs_rename,     /* rename */
   tmpfs_stat,       /* stat */
-  NULL              /* chstat */
+  NULL,             /* chstat */
+  NULL,             /* syncfs */
+  tmpfs_readdirplus /* readdirplus */
 };
 
 /****************************************************************************
@@ -267,6 +295,85 @@ static int tmpfs_realloc_directory(FAR struct tmpfs_directory_s *tdo,
  * Name: tmpfs_realloc_file
  ****************************************************************************/
 
+#if CONFIG_FS_TMPFS_CHUNKSIZE > 0
+static int tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
+                              size_t newsize)
+{
+  FAR uint8_t **newchunks;
+  size_t oldchunks = TMPFS_NCHUNKS(tfo->tfo_size);
+  size_t nchunks = TMPFS_NCHUNKS(newsize);
+  size_t allocsize;
+  size_t offset;
+  size_t i;
+
+  /* Free the chunks beyond the new end of the file, and zero the end of
+   * the new last chunk, so that growing the file again reads zeros.
+   */
+
+  if (newsize < tfo->tfo_size)
+    {
+      for (i = nchunks; i < oldchunks; i++)
+        {
+          if (tfo->tfo_chunks[i] != NULL)
+            {
+              fs_heap_free(tfo->tfo_chunks[i]);
+              tfo->tfo_chunks[i] = NULL;
+              tfo->tfo_alloc -= CONFIG_FS_TMPFS_CHUNKSIZE;
+            }
+        }
+
+      offset = newsize % CONFIG_FS_TMPFS_CHUNKSIZE;
+      if (offset != 0 && tfo->tfo_chunks[nchunks - 1] != NULL)
+        {
+          memset(tfo->tfo_chunks[nchunks - 1] + offset, 0,
+                 CONFIG_FS_TMPFS_CHUNKSIZE - offset);
+        }
+    }
+
+  /* Then resize the chunk table.  Only the table is reallocated, the
+   * chunks are allocated as they are written.
+   */
+
+  if (nchunks == 0)
+    {
+      fs_heap_free(tfo->tfo_chunks);
+      tfo->tfo_chunks  = NULL;
+      tfo->tfo_nchunks = 0;
+    }
+  else if (nchunks > tfo->tfo_nchunks ||
+           tfo->tfo_nchunks - nchunks > 2 * TMPFS_CHUNKS_ALLOCGUARD)
+    {
+      allocsize = nchunks + TMPFS_CHUNKS_ALLOCGUARD;
+      if (allocsize < nchunks || allocsize > SIZE_MAX / sizeof(FAR void *))
+        {
+          /* There must have been an integer overflow */
+
+          return -ENOMEM;
+        }
+
+      newchunks = fs_heap_realloc(tfo->tfo_chunks,
+                                  allocsize * sizeof(FAR void *));
+      if (newchunks != NULL)
+        {
+          if (allocsize > tfo->tfo_nchunks)
+            {
+              memset(&newchunks[tfo->tfo_nchunks], 0,
+                     (allocsize - tfo->tfo_nchunks) * sizeof(FAR void *));
+            }
+
+          tfo->tfo_chunks  = newchunks;
+          tfo->tfo_nchunks = allocsize;
+        }
+      else if (nchunks > tfo->tfo_nchunks)
+        {
+          return -ENOMEM;
+        }
+    }
+
+  tfo->tfo_size = newsize;
+  return OK;
+}
+#else
 static int tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
                               size_t newsize)
 {
@@ -340,6 +447,120 @@ static int tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
   tfo->tfo_data  = newdata;
   return OK;
 }
+#endif
+
+/****************************************************************************
+ * Name: tmpfs_free_data
+ ****************************************************************************/
+
+static void tmpfs_free_data(FAR struct tmpfs_file_s *tfo)
+{
+#if CONFIG_FS_TMPFS_CHUNKSIZE > 0
+  tmpfs_realloc_file(tfo, 0);
+#else
+  fs_heap_free(tfo->tfo_data);
+#endif
+}
+
+#if CONFIG_FS_TMPFS_CHUNKSIZE > 0
+/****************************************************************************
+ * Name: tmpfs_get_chunk
+ *
+ * Description:
+ *   Return the chunk of the file at index, allocate it if it is a hole and
+ *   alloc is set.  NULL is returned for a hole, or if the allocation
+ *   failed.
+ *
+ ****************************************************************************/
+
+static FAR uint8_t *tmpfs_get_chunk(FAR struct tmpfs_file_s *tfo,
+                                    size_t index, bool alloc)
+{
+  FAR uint8_t *chunk;
+
+  DEBUGASSERT(index < tfo->tfo_nchunks);
+
+  chunk = tfo->tfo_chunks[index];
+  if (chunk == NULL && alloc)
+    {
+      chunk = fs_heap_zalloc(CONFIG_FS_TMPFS_CHUNKSIZE);
+      if (chunk != NULL)
+        {
+          tfo->tfo_chunks[index] = chunk;
+          tfo->tfo_alloc += CONFIG_FS_TMPFS_CHUNKSIZE;
+        }
+    }
+
+  return chunk;
+}
+
+/****************************************************************************
+ * Name: tmpfs_read_chunks
+ ****************************************************************************/
+
+static void tmpfs_read_chunks(FAR struct tmpfs_file_s *tfo,
+                              FAR char *buffer, size_t pos, size_t len)
+{
+  FAR uint8_t *chunk;
+  size_t offset;
+  size_t n;
+
+  while (len > 0)
+    {
+      offset = pos % CONFIG_FS_TMPFS_CHUNKSIZE;
+      n      = MIN(len, CONFIG_FS_TMPFS_CHUNKSIZE - offset);
+      chunk  = tmpfs_get_chunk(tfo, pos / CONFIG_FS_TMPFS_CHUNKSIZE, false);
+
+      /* The holes read as zeros */
+
+      if (chunk != NULL)
+        {
+          dma_memcpy(buffer, chunk + offset, n);
+        }
+      else
+        {
+          memset(buffer, 0, n);
+        }
+
+      buffer += n;
+      pos    += n;
+      len    -= n;
+    }
+}
+
+/****************************************************************************
+ * Name: tmpfs_write_chunks
+ ****************************************************************************/
+
+static ssize_t tmpfs_write_chunks(FAR struct tmpfs_file_s *tfo,
+                                  FAR const char *buffer, size_t pos,
+                                  size_t len)
+{
+  FAR uint8_t *chunk;
+  ssize_t nwritten = 0;
+  size_t offset;
+  size_t n;
+
+  while (len > 0)
+    {
+      offset = pos % CONFIG_FS_TMPFS_CHUNKSIZE;
+      n      = MIN(len, CONFIG_FS_TMPFS_CHUNKSIZE - offset);
+      chunk  = tmpfs_get_chunk(tfo, pos / CONFIG_FS_TMPFS_CHUNKSIZE, true);
+      if (chunk == NULL)
+        {
+          return nwritten > 0 ? nwritten : -ENOMEM;
+        }
+
+      dma_memcpy(chunk + offset, buffer, n);
+      buffer   += n;
+      pos      += n;
+      len      -= n;
+      nwritten += n;
+    }
+
+  return nwritten;
+}
+#endif
 
 /****************************************************************************
  * Name: tmpfs_release_lockedobject
@@ -378,7 +599,7 @@ static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo)
     {
       tmpfs_unlock_file(tfo);
       nxrmutex_destroy(&tfo->tfo_lock);
-      fs_heap_free(tfo->tfo_data);
+      tmpfs_free_data(tfo);
       fs_heap_free(tfo);
     }
 
@@ -577,7 +798,12 @@ tmpfs_alloc_file(FAR struct tmpfs_directory_s *parent)
   tfo->tfo_parent = parent;
   tfo->tfo_flags  = 0;
   tfo->tfo_size   = 0;
+#if CONFIG_FS_TMPFS_CHUNKSIZE > 0
+  tfo->tfo_nchunks = 0;
+  tfo->tfo_chunks  = NULL;
+#else
   tfo->tfo_data   = NULL;
+#endif
 
   nxrmutex_init(&tfo->tfo_lock);
   tmpfs_lock_file(tfo);
@@ -1176,7 +1402,11 @@ static int tmpfs_statfs_callout(FAR struct tmpfs_directory_s *tdo,
 
       tmptfo             = (FAR struct tmpfs_file_s *)to;
       tmpbuf->tsf_alloc += sizeof(struct tmpfs_file_s);
-      tmpbuf->tsf_avail += to->to_alloc - tmptfo->tfo_size;
+      if (to->to_alloc > tmptfo->tfo_size)
+        {
+          tmpbuf->tsf_avail += to->to_alloc - tmptfo->tfo_size;
+        }
+
       tmpbuf->tsf_files++;
     }
   else /* if (to->to_type == TMPFS_DIRECTORY) */
@@ -1252,7 +1482,7 @@ static int tmpfs_free_callout(FAR struct tmpfs_directory_s *tdo,
           return TMPFS_UNLINKED;
         }
 
-      fs_heap_free(tfo->tfo_data);
+      tmpfs_free_data(tfo);
     }
   else /* if (to->to_type == TMPFS_DIRECTORY) */
     {
@@ -1573,15 +1803,20 @@ static ssize_t tmpfs_read(FAR struct file *filep, FAR char *buffer,
 
   /* Copy data from the memory object to the user buffer */
 
+#if CONFIG_FS_TMPFS_CHUNKSIZE > 0
+  tmpfs_read_chunks(tfo, buffer, startpos, nread);
+  filep->f_pos += nread;
+#else
   if (tfo->tfo_data != NULL)
     {
-      memcpy(buffer, &tfo->tfo_data[startpos], nread);
+      dma_memcpy(buffer, &tfo->tfo_data[startpos], nread);
       filep->f_pos += nread;
     }
   else
     {
       DEBUGASSERT(tfo->tfo_size == 0 && nread == 0);
     }
+#endif
 
   /* Release the lock on the file */
 
@@ -1600,6 +1835,9 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
   ssize_t nwritten;
   off_t startpos;
   off_t endpos;
+#if CONFIG_FS_TMPFS_CHUNKSIZE > 0
+  size_t oldsize;
+#endif
   int ret;
 
   finfo("filep: %p buffer: %p buflen: %lu\n",
@@ -1631,6 +1869,9 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
 
   nwritten = buflen;
   endpos   = startpos + buflen;
+#if CONFIG_FS_TMPFS_CHUNKSIZE > 0
+  oldsize  = tfo->tfo_size;
+#endif
 
   if (endpos > tfo->tfo_size)
     {
@@ -1645,14 +1886,41 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
 
   /* Copy data from the memory object to the user buffer */
 
+#if CONFIG_FS_TMPFS_CHUNKSIZE > 0
+  nwritten = tmpfs_write_chunks(tfo, buffer, startpos, buflen);
+  if (nwritten < (ssize_t)buflen)
+    {
+      /* Out of memory.  The file now ends after the data written. */
+
+      endpos = startpos + (nwritten > 0 ? nwritten : 0);
+      if (endpos < oldsize)
+        {
+          endpos = oldsize;
+        }
+
+      if (endpos < tfo->tfo_size)
+        {
+          tmpfs_realloc_file(tfo, endpos);
+        }
+
+      if (nwritten < 0)
+        {
+          ret = nwritten;
+          goto errout_with_lock;
+        }
+
+      endpos = startpos + nwritten;
+    }
+#else
   if (tfo->tfo_data != NULL)
     {
-      memcpy(&tfo->tfo_data[startpos], buffer, nwritten);
+      dma_memcpy(&tfo->tfo_data[startpos], buffer, nwritten);
     }
   else
     {
       DEBUGASSERT(tfo->tfo_size == 0 && nwritten == 0);
     }
+#endif
 
   filep->f_pos = endpos;
 
@@ -1751,9 +2019,15 @@ static int tmpfs_unmap(FAR struct task_group_s *group,
   else
     {
       entry->length = offset;
+#if CONFIG_FS_TMPFS_CHUNKSIZE > 0
+      /* The mapping is only one chunk of the file, keep the file as is */
+
+      ret = OK;
+#else
       tmpfs_lock_file(tfo);
       ret = tmpfs_realloc_file(tfo, offset);
       tmpfs_unlock_file(tfo);
+#endif
     }
 
   return ret;
@@ -1762,6 +2036,10 @@ static int tmpfs_unmap(FAR struct task_group_s *group,
 static int tmpfs_mmap(FAR struct file *filep, FAR struct mm_map_entry_s *map)
 {
   FAR struct tmpfs_file_s *tfo;
+#if CONFIG_FS_TMPFS_CHUNKSIZE > 0
+  FAR uint8_t *chunk;
+  size_t index;
+#endif
   int ret = -EINVAL;
 
   DEBUGASSERT(filep->f_priv != NULL);
@@ -1775,7 +2053,30 @@ static int tmpfs_mmap(FAR struct file *filep, FAR struct mm_map_entry_s *map)
   if (map->offset >= 0 && map->offset < tfo->tfo_size &&
       map->length && map->offset + map->length <= tfo->tfo_size)
     {
+#if CONFIG_FS_TMPFS_CHUNKSIZE > 0
+      /* A range within one chunk is mapped in place, the others are
+       * copied into RAM by the caller.
+       */
+
+      index = map->offset / CONFIG_FS_TMPFS_CHUNKSIZE;
+      if ((map->offset + map->length - 1) / CONFIG_FS_TMPFS_CHUNKSIZE !=
+          index)
+        {
+          return -ENOTTY;
+        }
+
+      tmpfs_lock_file(tfo);
+      chunk = tmpfs_get_chunk(tfo, index, true);
+      tmpfs_unlock_file(tfo);
+      if (chunk == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      map->vaddr = chunk + map->offset % CONFIG_FS_TMPFS_CHUNKSIZE;
+#else
       map->vaddr = tfo->tfo_data + map->offset;
+#endif
       map->priv.p = tfo;
       map->munmap = tmpfs_unmap;
       ret = mm_map_add(get_current_mm(), map);
@@ -1829,7 +2130,19 @@ static int tmpfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
     {
       FAR uintptr_t *ptr = (FAR uintptr_t *)arg;
 
+#if CONFIG_FS_TMPFS_CHUNKSIZE > 0
+      /* Only a file held in one chunk is contiguous in memory */
+
+      if (tfo->tfo_size > CONFIG_FS_TMPFS_CHUNKSIZE ||
+          tfo->tfo_chunks == NULL || tfo->tfo_chunks[0] == NULL)
+        {
+          return -ENXIO;
+        }
+
+      *ptr = (uintptr_t)tfo->tfo_chunks[0];
+#else
       *ptr = (uintptr_t)tfo->tfo_data;
+#endif
       return OK;
     }
 
@@ -1963,6 +2276,7 @@ static int tmpfs_truncate(FAR struct file *filep, off_t length)
           goto errout_with_lock;
         }
 
+#if CONFIG_FS_TMPFS_CHUNKSIZE == 0
       /* If the size has increased, then we need to zero the newly added
        * memory.
        */
@@ -1971,6 +2285,7 @@ static int tmpfs_truncate(FAR struct file *filep, off_t length)
         {
           memset(&tfo->tfo_data[oldsize], 0, length - oldsize);
         }
+#endif
 
       ret = OK;
     }
@@ -2072,12 +2387,13 @@ static int tmpfs_closedir(FAR struct inode *mountpt,
 }
 
 /****************************************************************************
- * Name: tmpfs_readdir
+ * Name: tmpfs_readdir_common
  ****************************************************************************/
 
-static int tmpfs_readdir(FAR struct inode *mountpt,
-                         FAR struct fs_dirent_s *dir,
-                         FAR struct dirent *entry)
+static int tmpfs_readdir_common(FAR struct inode *mountpt,
+                                FAR struct fs_dirent_s *dir,
+                                FAR struct dirent *entry,
+                                FAR struct stat *buf)
 {
   FAR struct tmpfs_directory_s *tdo;
   FAR struct tmpfs_dir_s *tdir;
@@ -2135,16 +2451,53 @@ static int tmpfs_readdir(FAR struct inode *mountpt,
 
       strlcpy(entry->d_name, tde->tde_name, sizeof(entry->d_name));
 
-      /* Save the index for next time */
+      /* And the attributes of the object, the directory keeps it alive */
 
-      tdir->tf_index = index;
       ret = OK;
+      if (buf != NULL)
+        {
+          ret = tmpfs_lock_object(to);
+          if (ret >= 0)
+            {
+              tmpfs_stat_common(to, buf);
+              tmpfs_unlock_object(to);
+            }
+        }
+
+      /* Save the index for next time */
+
+      if (ret >= 0)
+        {
+          tdir->tf_index = index;
+        }
     }
 
   tmpfs_unlock_directory(tdo);
   return ret;
 }
 
+/****************************************************************************
+ * Name: tmpfs_readdir
+ ****************************************************************************/
+
+static int tmpfs_readdir(FAR struct inode *mountpt,
+                         FAR struct fs_dirent_s *dir,
+                         FAR struct dirent *entry)
+{
+  return tmpfs_readdir_common(mountpt, dir, entry, NULL);
+}
+
+/****************************************************************************
+ * Name: tmpfs_readdirplus
+ ****************************************************************************/
+
+static int tmpfs_readdirplus(FAR struct inode *mountpt,
+                             FAR struct fs_dirent_s *dir,
+                             FAR struct dirent *entry, FAR struct stat *buf)
+{
+  return tmpfs_readdir_common(mountpt, dir, entry, buf);
+}
+
 /****************************************************************************
  * Name: tmpfs_rewinddir
  ****************************************************************************/
@@ -2413,7 +2766,7 @@ static int tmpfs_unlink(FAR struct inode *mountpt, FAR const char *relpath)
   else
     {
       nxrmutex_destroy(&tfo->tfo_lock);
-      fs_heap_free(tfo->tfo_data);
+      tmpfs_free_data(tfo);
       fs_heap_free(tfo);
     }
 
@@ -109,6 +109,11 @@ struct tmpfs_directory_s
  * state.  The file memory object also serves as the open file object,
  * saving an allocation.  This has the negative side effect that no per-
  * open state can be retained (such as open flags).
+ *
+ * With CONFIG_FS_TMPFS_CHUNKSIZE > 0 the data is held in fixed size chunks
+ * allocated as they are written, so that growing a file never copies it
+ * and the ranges never written are holes.  The bytes of the chunks beyond
+ * the end of the file are always zero.
  */
 
 struct tmpfs_file_s
@@ -124,9 +129,14 @@ struct tmpfs_file_s
 
   /* Remaining fields are unique to a directory object */
 
-  uint8_t       tfo_flags; /* See TFO_FLAG_* definitions */
-  size_t        tfo_size;  /* Valid file size */
-  FAR uint8_t  *tfo_data;  /* File data starts here */
+  uint8_t       tfo_flags;   /* See TFO_FLAG_* definitions */
+  size_t        tfo_size;    /* Valid file size */
+#if CONFIG_FS_TMPFS_CHUNKSIZE > 0
+  size_t        tfo_nchunks; /* Entries of tfo_chunks */
+  FAR uint8_t **tfo_chunks;  /* File data chunks, NULL for holes */
+#else
+  FAR uint8_t  *tfo_data;    /* File data starts here */
+#endif
 };
 
 /* This structure represents one instance of a TMPFS file system */
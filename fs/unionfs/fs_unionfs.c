@@ -33,6 +33,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <fcntl.h>
 #include <assert.h>
@@ -50,6 +51,21 @@
 
 #if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_UNIONFS)
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_FS_UNIONFS_LOOKUP_CACHE
+#  define CONFIG_FS_UNIONFS_LOOKUP_CACHE 0
+#endif
+
+/* Layer of a lookup cache entry: the index of the file system, none of
+ * them, or not in the cache.
+ */
+
+#define UNIONFS_LOOKUP_NONE  -1
+#define UNIONFS_LOOKUP_MISS  -2
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -62,8 +78,25 @@ struct unionfs_dir_s
   bool fu_prefix[2];                   /* True: Fake directory in prefix */
   FAR char *fu_relpath;                /* Path being enumerated */
   FAR struct fs_dirent_s *fu_lower[2]; /* dirent struct used by contained file system */
+#ifdef CONFIG_FS_UNIONFS_READDIR_INDEX
+  FAR char **fu_names;                 /* Names enumerated on file system 1 */
+  size_t fu_nnames;                    /* Number of names in fu_names */
+  size_t fu_maxnames;                  /* Allocated size of fu_names */
+  bool fu_noindex;                     /* True: fu_names is incomplete */
+  bool fu_sorted;                      /* True: fu_names is sorted */
+#endif
 };
 
+/* One entry of the cache of the layer holding a path */
+
+#if CONFIG_FS_UNIONFS_LOOKUP_CACHE > 0
+struct unionfs_lookup_s
+{
+  FAR char *ul_path;                 /* Relative path, NULL if unused */
+  int ul_ndx;                        /* File system holding it, or NONE */
+};
+#endif
+
 /* This structure describes one contained file system mountpoint */
 
 struct unionfs_mountpt_s
@@ -80,6 +113,10 @@ struct unionfs_inode_s
   mutex_t ui_lock;                   /* Enforces mutually exclusive access */
   int16_t ui_nopen;                  /* Number of open references */
   bool ui_unmounted;                 /* File system has been unmounted */
+#if CONFIG_FS_UNIONFS_LOOKUP_CACHE > 0
+  unsigned int ui_lookup_gen;        /* Changed by every invalidation */
+  struct unionfs_lookup_s ui_lookup[CONFIG_FS_UNIONFS_LOOKUP_CACHE];
+#endif
 };
 
 /* This structure descries one opened file */
@@ -141,6 +178,24 @@ static FAR char *unionfs_relpath(FAR const char *path,
 
 static int     unionfs_unbind_child(FAR struct unionfs_mountpt_s *um);
 static void    unionfs_destroy(FAR struct unionfs_inode_s *ui);
+#if CONFIG_FS_UNIONFS_LOOKUP_CACHE > 0
+static int     unionfs_lookup_find(FAR struct unionfs_inode_s *ui,
+                                   FAR const char *relpath);
+static void    unionfs_lookup_add(FAR struct unionfs_inode_s *ui,
+                                  FAR const char *relpath, int ndx);
+static void    unionfs_lookup_flush(FAR struct unionfs_inode_s *ui);
+static void    unionfs_lookup_invalidate(FAR struct unionfs_inode_s *ui);
+#else
+#  define unionfs_lookup_flush(ui)
+#  define unionfs_lookup_invalidate(ui)
+#endif
+#ifdef CONFIG_FS_UNIONFS_READDIR_INDEX
+static void    unionfs_index_add(FAR struct unionfs_dir_s *udir,
+                                 FAR const char *name);
+static bool    unionfs_index_find(FAR struct unionfs_dir_s *udir,
+                                  FAR const char *name);
+static void    unionfs_index_free(FAR struct unionfs_dir_s *udir);
+#endif
 
 /* Operations on opened files (with struct file) */
 
@@ -822,6 +877,235 @@ static int unionfs_unbind_child(FAR struct unionfs_mountpt_s *um)
   return OK;
 }
 
+/****************************************************************************
+ * Name: unionfs_lookup_slot
+ *
+ * Description:
+ *   Return the entry of the lookup cache for relpath.  The cache is direct
+ *   mapped, a path only going to the entry of its hash.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FS_UNIONFS_LOOKUP_CACHE > 0
+static FAR struct unionfs_lookup_s *
+unionfs_lookup_slot(FAR struct unionfs_inode_s *ui, FAR const char *relpath)
+{
+  uint32_t hash = 5381;
+
+  while (*relpath != '\0')
+    {
+      hash = hash * 33 + (unsigned char)*relpath++;
+    }
+
+  return &ui->ui_lookup[hash % CONFIG_FS_UNIONFS_LOOKUP_CACHE];
+}
+
+/****************************************************************************
+ * Name: unionfs_lookup_find
+ *
+ * Description:
+ *   Return the index of the file system holding relpath, NONE if neither
+ *   does, or MISS if it is not known.  Called with ui_lock held.
+ *
+ ****************************************************************************/
+
+static int unionfs_lookup_find(FAR struct unionfs_inode_s *ui,
+                               FAR const char *relpath)
+{
+  FAR struct unionfs_lookup_s *ul = unionfs_lookup_slot(ui, relpath);
+
+  if (ul->ul_path != NULL && strcmp(ul->ul_path, relpath) == 0)
+    {
+      return ul->ul_ndx;
+    }
+
+  return UNIONFS_LOOKUP_MISS;
+}
+
+/****************************************************************************
+ * Name: unionfs_lookup_add
+ *
+ * Description:
+ *   Remember the file system holding relpath, replacing the other path the
+ *   entry may hold.  Called with ui_lock held.
+ *
+ ****************************************************************************/
+
+static void unionfs_lookup_add(FAR struct unionfs_inode_s *ui,
+                               FAR const char *relpath, int ndx)
+{
+  FAR struct unionfs_lookup_s *ul = unionfs_lookup_slot(ui, relpath);
+
+  if (ul->ul_path != NULL && strcmp(ul->ul_path, relpath) != 0)
+    {
+      fs_heap_free(ul->ul_path);
+      ul->ul_path = NULL;
+    }
+
+  if (ul->ul_path == NULL)
+    {
+      ul->ul_path = fs_heap_strdup(relpath);
+    }
+
+  ul->ul_ndx = ndx;
+}
+
+/****************************************************************************
+ * Name: unionfs_lookup_flush
+ *
+ * Description:
+ *   Forget every path after the name space of the union has changed.
+ *   Called with ui_lock held.  The generation tells the lookups that ran
+ *   meanwhile without the lock not to add what they found.
+ *
+ ****************************************************************************/
+
+static void unionfs_lookup_flush(FAR struct unionfs_inode_s *ui)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_FS_UNIONFS_LOOKUP_CACHE; i++)
+    {
+      if (ui->ui_lookup[i].ul_path != NULL)
+        {
+          fs_heap_free(ui->ui_lookup[i].ul_path);
+          ui->ui_lookup[i].ul_path = NULL;
+        }
+    }
+
+  ui->ui_lookup_gen++;
+}
+
+/****************************************************************************
+ * Name: unionfs_lookup_invalidate
+ *
+ * Description:
+ *   unionfs_lookup_flush() for the operations not holding ui_lock.  They
+ *   call it before and after changing the name space, so that no lookup
+ *   overlapping the change is cached.
+ *
+ ****************************************************************************/
+
+static void unionfs_lookup_invalidate(FAR struct unionfs_inode_s *ui)
+{
+  nxmutex_lock(&ui->ui_lock);
+  unionfs_lookup_flush(ui);
+  nxmutex_unlock(&ui->ui_lock);
+}
+#endif
+
+/****************************************************************************
+ * Name: unionfs_index_add
+ *
+ * Description:
+ *   Add a name enumerated on file system 1 to the merge index of the
+ *   directory.  If that fails, the merge falls back to stat'ing the names
+ *   of file system 2 on file system 1.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_UNIONFS_READDIR_INDEX
+static void unionfs_index_add(FAR struct unionfs_dir_s *udir,
+                              FAR const char *name)
+{
+  FAR char **names;
+  size_t maxnames;
+
+  if (udir->fu_noindex)
+    {
+      return;
+    }
+
+  if (udir->fu_nnames == udir->fu_maxnames)
+    {
+      maxnames = udir->fu_maxnames ? 2 * udir->fu_maxnames : 16;
+      names    = fs_heap_realloc(udir->fu_names,
+                                 maxnames * sizeof(FAR char *));
+      if (names == NULL)
+        {
+          udir->fu_noindex = true;
+          return;
+        }
+
+      udir->fu_names    = names;
+      udir->fu_maxnames = maxnames;
+    }
+
+  udir->fu_names[udir->fu_nnames] = fs_heap_strdup(name);
+  if (udir->fu_names[udir->fu_nnames] == NULL)
+    {
+      udir->fu_noindex = true;
+      return;
+    }
+
+  udir->fu_nnames++;
+}
+
+/****************************************************************************
+ * Name: unionfs_index_compare
+ ****************************************************************************/
+
+static int unionfs_index_compare(FAR const void *a, FAR const void *b)
+{
+  return strcmp(*(FAR char * const *)a, *(FAR char * const *)b);
+}
+
+/****************************************************************************
+ * Name: unionfs_index_find
+ *
+ * Description:
+ *   Return true if name was enumerated on file system 1.  The index is
+ *   sorted on the first search, when file system 1 is done.
+ *
+ ****************************************************************************/
+
+static bool unionfs_index_find(FAR struct unionfs_dir_s *udir,
+                               FAR const char *name)
+{
+  if (udir->fu_names == NULL)
+    {
+      return false;
+    }
+
+  /* No name is added after the switch to file system 2 */
+
+  if (!udir->fu_sorted)
+    {
+      qsort(udir->fu_names, udir->fu_nnames, sizeof(FAR char *),
+            unionfs_index_compare);
+      udir->fu_sorted = true;
+    }
+
+  return bsearch(&name, udir->fu_names, udir->fu_nnames,
+                 sizeof(FAR char *), unionfs_index_compare) != NULL;
+}
+
+/****************************************************************************
+ * Name: unionfs_index_free
+ ****************************************************************************/
+
+static void unionfs_index_free(FAR struct unionfs_dir_s *udir)
+{
+  size_t i;
+
+  for (i = 0; i < udir->fu_nnames; i++)
+    {
+      fs_heap_free(udir->fu_names[i]);
+    }
+
+  if (udir->fu_names != NULL)
+    {
+      fs_heap_free(udir->fu_names);
+    }
+
+  udir->fu_names    = NULL;
+  udir->fu_nnames   = 0;
+  udir->fu_maxnames = 0;
+  udir->fu_noindex  = false;
+  udir->fu_sorted   = false;
+}
+#endif
+
 /****************************************************************************
  * Name: unionfs_destroy
  ****************************************************************************/
@@ -848,6 +1132,10 @@ static void unionfs_destroy(FAR struct unionfs_inode_s *ui)
       fs_heap_free(ui->ui_fs[1].um_prefix);
     }
 
+  /* Forget the cached lookups */
+
+  unionfs_lookup_flush(ui);
+
   /* And finally free the allocated unionfs state structure as well */
 
   nxmutex_destroy(&ui->ui_lock);
@@ -890,6 +1178,39 @@ static int unionfs_open(FAR struct file *filep, FAR const char *relpath,
       goto errout_with_lock;
     }
 
+#if CONFIG_FS_UNIONFS_LOOKUP_CACHE > 0
+  /* Without O_CREAT, go straight to the file system known to hold the
+   * path, or fail if neither does.  A stale entry falls back to trying
+   * both of them.
+   */
+
+  if ((oflags & O_CREAT) == 0)
+    {
+      int ndx = unionfs_lookup_find(ui, relpath);
+
+      if (ndx == UNIONFS_LOOKUP_NONE)
+        {
+          ret = -ENOENT;
+          goto errout_with_uf;
+        }
+      else if (ndx >= 0)
+        {
+          um = &ui->ui_fs[ndx];
+
+          uf->uf_file.f_oflags = filep->f_oflags;
+          uf->uf_file.f_inode  = um->um_node;
+
+          ret = unionfs_tryopen(&uf->uf_file, relpath, um->um_prefix,
+                                oflags, mode);
+          if (ret >= 0)
+            {
+              uf->uf_ndx = ndx;
+              goto opened;
+            }
+        }
+    }
+#endif
+
   /* Try to open the file on file system 1 */
 
   um = &ui->ui_fs[0];
@@ -919,7 +1240,14 @@ static int unionfs_open(FAR struct file *filep, FAR const char *relpath,
                             mode);
       if (ret < 0)
         {
-          goto errout_with_lock;
+#if CONFIG_FS_UNIONFS_LOOKUP_CACHE > 0
+          if (ret == -ENOENT && (oflags & O_CREAT) == 0)
+            {
+              unionfs_lookup_add(ui, relpath, UNIONFS_LOOKUP_NONE);
+            }
+#endif
+
+          goto errout_with_uf;
         }
 
       /* Successfully opened on file system 1 */
@@ -927,6 +1255,21 @@ static int unionfs_open(FAR struct file *filep, FAR const char *relpath,
       uf->uf_ndx = 1;
     }
 
+#if CONFIG_FS_UNIONFS_LOOKUP_CACHE > 0
+  /* O_CREAT may have added the path */
+
+  if ((oflags & O_CREAT) != 0)
+    {
+      unionfs_lookup_flush(ui);
+    }
+  else
+    {
+      unionfs_lookup_add(ui, relpath, uf->uf_ndx);
+    }
+
+opened:
+#endif
+
   /* Increment the open reference count */
 
   ui->ui_nopen++;
@@ -935,7 +1278,11 @@ static int unionfs_open(FAR struct file *filep, FAR const char *relpath,
   /* Save our private data in the file structure */
 
   filep->f_priv = (FAR void *)uf;
-  ret = OK;
+  nxmutex_unlock(&ui->ui_lock);
+  return OK;
+
+errout_with_uf:
+  fs_heap_free(uf);
 
 errout_with_lock:
   nxmutex_unlock(&ui->ui_lock);
@@ -1595,6 +1942,10 @@ static int unionfs_closedir(FAR struct inode *mountpt,
       fs_heap_free(udir->fu_relpath);
     }
 
+#ifdef CONFIG_FS_UNIONFS_READDIR_INDEX
+  unionfs_index_free(udir);
+#endif
+
   fs_heap_free(udir);
 
   /* Decrement the count of open reference.  If that count would go to zero
@@ -1716,6 +2067,15 @@ static int unionfs_readdir(FAR struct inode *mountpt,
           ret = ops->readdir(um->um_node, udir->fu_lower[udir->fu_ndx],
                              entry);
 
+#ifdef CONFIG_FS_UNIONFS_READDIR_INDEX
+          /* Remember the names of file system 1 for the merge */
+
+          if (ret >= 0 && udir->fu_ndx == 0)
+            {
+              unionfs_index_add(udir, entry->d_name);
+            }
+#endif
+
           /* Did the read operation fail because we reached the end of the
            * directory?  In that case, the error would be -ENOENT.  If we
            * hit the end-of-directory on file system, we need to seamlessly
@@ -1834,6 +2194,16 @@ static int unionfs_readdir(FAR struct inode *mountpt,
            */
 
           duplicate = false;
+#ifdef CONFIG_FS_UNIONFS_READDIR_INDEX
+          if (ret >= 0 && udir->fu_ndx == 1 && udir->fu_lower[0] != NULL &&
+              !udir->fu_noindex)
+            {
+              /* Look the name up in the names of file system 1 */
+
+              duplicate = unionfs_index_find(udir, entry->d_name);
+            }
+          else
+#endif
           if (ret >= 0 && udir->fu_ndx == 1 && udir->fu_lower[0] != NULL)
             {
               /* Get the relative path to the same file on file system 1.
@@ -1908,6 +2278,12 @@ static int unionfs_rewinddir(FAR struct inode *mountpt,
       udir->fu_ndx = 0;
     }
 
+#ifdef CONFIG_FS_UNIONFS_READDIR_INDEX
+  /* File system 1 is enumerated again from the start */
+
+  unionfs_index_free(udir);
+#endif
+
   if (!udir->fu_prefix[udir->fu_ndx])
     {
       DEBUGASSERT(udir->fu_lower[udir->fu_ndx] != NULL);
@@ -2176,6 +2552,7 @@ static int unionfs_unlink(FAR struct inode *mountpt,
   DEBUGASSERT(mountpt != NULL && mountpt->i_private != NULL &&
               relpath != NULL);
   ui = mountpt->i_private;
+  unionfs_lookup_invalidate(ui);
 
   /* Check if some exists at this path on file system 1.  This might be
    * a file or a directory
@@ -2216,6 +2593,7 @@ static int unionfs_unlink(FAR struct inode *mountpt,
         }
     }
 
+  unionfs_lookup_invalidate(ui);
   return ret;
 }
 
@@ -2259,6 +2637,8 @@ static int unionfs_mkdir(FAR struct inode *mountpt, FAR const char *relpath,
 
   /* Try to create the directory on both file systems. */
 
+  unionfs_lookup_invalidate(ui);
+
   um  = &ui->ui_fs[0];
   ret1 = unionfs_trymkdir(um->um_node, relpath, um->um_prefix, mode);
 
@@ -2270,6 +2650,7 @@ static int unionfs_mkdir(FAR struct inode *mountpt, FAR const char *relpath,
    * read-only and the other is write-able?
    */
 
+  unionfs_lookup_invalidate(ui);
   return (ret1 >= 0 || ret2 >= 0) ? OK : ret1;
 }
 
@@ -2291,6 +2672,7 @@ static int unionfs_rmdir(FAR struct inode *mountpt, FAR const char *relpath)
   DEBUGASSERT(mountpt != NULL && mountpt->i_private != NULL &&
               relpath != NULL);
   ui = mountpt->i_private;
+  unionfs_lookup_invalidate(ui);
 
   /* We really don't know any better so we will try to remove the directory
    * from both file systems.
@@ -2332,6 +2714,7 @@ static int unionfs_rmdir(FAR struct inode *mountpt, FAR const char *relpath)
        */
     }
 
+  unionfs_lookup_invalidate(ui);
   return ret;
 }
 
@@ -2356,6 +2739,7 @@ static int unionfs_rename(FAR struct inode *mountpt,
   ui = mountpt->i_private;
 
   DEBUGASSERT(oldrelpath != NULL && oldrelpath != NULL);
+  unionfs_lookup_invalidate(ui);
 
   /* Is there a file with this name on file system 1 */
 
@@ -2377,6 +2761,7 @@ static int unionfs_rename(FAR struct inode *mountpt,
            * file of the same relative path will become visible.
            */
 
+          unionfs_lookup_invalidate(ui);
           return OK;
         }
     }
@@ -2398,6 +2783,7 @@ static int unionfs_rename(FAR struct inode *mountpt,
                               um->um_prefix);
     }
 
+  unionfs_lookup_invalidate(ui);
   return ret;
 }
 
@@ -2410,6 +2796,11 @@ static int unionfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
 {
   FAR struct unionfs_inode_s *ui;
   FAR struct unionfs_mountpt_s *um;
+#if CONFIG_FS_UNIONFS_LOOKUP_CACHE > 0
+  unsigned int gen = 0;
+  bool cache = false;
+  int ndx = UNIONFS_LOOKUP_MISS;
+#endif
   int ret;
 
   finfo("relpath: %s\n", relpath);
@@ -2420,6 +2811,37 @@ static int unionfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
               relpath != NULL);
   ui = mountpt->i_private;
 
+#if CONFIG_FS_UNIONFS_LOOKUP_CACHE > 0
+  /* Look the layer up in the cache.  The lower file systems are stat'ed
+   * without the lock, the generation tells if the name space changed
+   * meanwhile.
+   */
+
+  if (nxmutex_lock(&ui->ui_lock) >= 0)
+    {
+      ndx   = unionfs_lookup_find(ui, relpath);
+      gen   = ui->ui_lookup_gen;
+      cache = true;
+      nxmutex_unlock(&ui->ui_lock);
+    }
+
+  if (ndx >= 0)
+    {
+      um  = &ui->ui_fs[ndx];
+      ret = unionfs_trystat(um->um_node, relpath, um->um_prefix, buf);
+      if (ret >= 0)
+        {
+          return OK;
+        }
+    }
+
+  if (ndx == UNIONFS_LOOKUP_NONE)
+    {
+      ret = -ENOENT;
+      goto nolayer;
+    }
+#endif
+
   /* stat this path on file system 1 */
 
   um  = &ui->ui_fs[0];
@@ -2430,7 +2852,7 @@ static int unionfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
        * shadow the second anyway.
        */
 
-      return OK;
+      goto found;
     }
 
   /* stat failed on the file system 1.  Try again on file system 2. */
@@ -2443,9 +2865,23 @@ static int unionfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
        * shadow the second anyway.
        */
 
-      return OK;
+      goto found;
     }
 
+#if CONFIG_FS_UNIONFS_LOOKUP_CACHE > 0
+  if (ret == -ENOENT && cache && nxmutex_lock(&ui->ui_lock) >= 0)
+    {
+      if (gen == ui->ui_lookup_gen)
+        {
+          unionfs_lookup_add(ui, relpath, UNIONFS_LOOKUP_NONE);
+        }
+
+      nxmutex_unlock(&ui->ui_lock);
+    }
+
+nolayer:
+#endif
+
   /* Special case the unionfs root directory when both file systems are
    * offset.  In that case, both of the above trystat calls will fail.
    */
@@ -2476,6 +2912,21 @@ static int unionfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
     }
 
   return ret;
+
+found:
+#if CONFIG_FS_UNIONFS_LOOKUP_CACHE > 0
+  if (cache && nxmutex_lock(&ui->ui_lock) >= 0)
+    {
+      if (gen == ui->ui_lookup_gen)
+        {
+          unionfs_lookup_add(ui, relpath, um == &ui->ui_fs[0] ? 0 : 1);
+        }
+
+      nxmutex_unlock(&ui->ui_lock);
+    }
+#endif
+
+  return OK;
 }
 
 /****************************************************************************
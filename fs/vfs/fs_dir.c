@@ -458,22 +458,27 @@ static int dir_close(FAR struct file *filep)
   return ret;
 }
 
-static ssize_t dir_read(FAR struct file *filep, FAR char *buffer,
-                        size_t buflen)
+/****************************************************************************
+ * Name: dir_readentry
+ *
+ * Description:
+ *   Read the next entry of the directory, and the attributes of the file
+ *   if buf isn't NULL.  -ENOENT is returned at the end of the directory.
+ *   The attributes are left zero if they can't be read, so that the
+ *   entry isn't lost.
+ *
+ ****************************************************************************/
+
+static int dir_readentry(FAR struct file *filep, FAR struct dirent *entry,
+                         FAR struct stat *buf)
 {
   FAR struct fs_dirent_s *dir = filep->f_priv;
 #ifndef CONFIG_DISABLE_MOUNTPOINT
   FAR struct inode *inode = dir->fd_root;
 #endif
+  FAR char *path;
   int ret;
 
-  /* Verify that we were provided with a valid directory structure */
-
-  if (buffer == NULL || buflen < sizeof(struct dirent))
-    {
-      return -EINVAL;
-    }
-
   /* The way we handle the readdir depends on the type of inode
    * that we are dealing with.
    */
@@ -481,31 +486,90 @@ static ssize_t dir_read(FAR struct file *filep, FAR char *buffer,
 #ifndef CONFIG_DISABLE_MOUNTPOINT
   if (INODE_IS_MOUNTPT(inode))
     {
-      ret = inode->u.i_mops->readdir(inode, dir,
-                                     (FAR struct dirent *)buffer);
+      if (buf != NULL && inode->u.i_mops->readdirplus != NULL)
+        {
+          ret = inode->u.i_mops->readdirplus(inode, dir, entry, buf);
+          if (ret >= 0)
+            {
+              filep->f_pos++;
+            }
+
+          return ret;
+        }
+
+      ret = inode->u.i_mops->readdir(inode, dir, entry);
     }
   else
 #endif
     {
       /* The node is part of the root pseudo file system */
 
-      ret = read_pseudodir(dir, (FAR struct dirent *)buffer);
+      ret = read_pseudodir(dir, entry);
     }
 
-  /* ret < 0 is an error. Special case: ret = -ENOENT is end of file */
-
   if (ret < 0)
     {
-      if (ret == -ENOENT)
+      return ret;
+    }
+
+  filep->f_pos++;
+
+  /* Look up the attributes by the path of the entry otherwise */
+
+  if (buf != NULL)
+    {
+      ret = fs_heap_asprintf(&path, "%s%s", dir->fd_path, entry->d_name);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      if (nx_stat(path, buf, 0) < 0)
         {
-          ret = 0;
+          memset(buf, 0, sizeof(*buf));
         }
 
-      return ret;
+      fs_heap_free(path);
     }
 
-  filep->f_pos++;
-  return sizeof(struct dirent);
+  return OK;
+}
+
+static ssize_t dir_read(FAR struct file *filep, FAR char *buffer,
+                        size_t buflen)
+{
+  FAR struct dirent *entry = (FAR struct dirent *)buffer;
+  ssize_t nread = 0;
+  int ret = OK;
+
+  /* Verify that we were provided with a valid directory structure */
+
+  if (buffer == NULL || buflen < sizeof(struct dirent))
+    {
+      return -EINVAL;
+    }
+
+  /* Read as many entries as fit the buffer, like getdents() */
+
+  while (buflen - nread >= sizeof(struct dirent))
+    {
+      ret = dir_readentry(filep, entry++, NULL);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      nread += sizeof(struct dirent);
+    }
+
+  /* ret < 0 is an error. Special case: ret = -ENOENT is end of file */
+
+  if (nread > 0 || ret == -ENOENT)
+    {
+      return nread;
+    }
+
+  return ret;
 }
 
 static off_t dir_seek(FAR struct file *filep, off_t offset, int whence)
@@ -557,6 +621,18 @@ static int dir_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
     {
       strlcpy((FAR char *)(uintptr_t)arg, dir->fd_path, PATH_MAX);
     }
+  else if (cmd == FIOC_READDIRPLUS)
+    {
+      FAR struct direntplus *entry =
+        (FAR struct direntplus *)(uintptr_t)arg;
+
+      if (entry == NULL)
+        {
+          return -EINVAL;
+        }
+
+      ret = dir_readentry(filep, &entry->d_entry, &entry->d_stat);
+    }
   else if (cmd != BIOC_FLUSH)
     {
       ret = -ENOTTY;
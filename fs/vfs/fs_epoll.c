@@ -40,6 +40,7 @@
 #include <nuttx/list.h>
 #include <nuttx/mutex.h>
 #include <nuttx/signal.h>
+#include <nuttx/spinlock.h>
 
 #include "inode/inode.h"
 #include "fs_heap.h"
@@ -51,8 +52,10 @@
 struct epoll_node_s
 {
   struct list_node         node;
+  struct list_node         ready;    /* Link in the ready list */
   epoll_data_t             data;
-  bool                     notified;
+  bool                     notified; /* In the ready list */
+  pollevent_t              revents;  /* Events since the last epoll_wait */
   struct pollfd            pfd;
   FAR struct epoll_head_s *eph;
 };
@@ -86,6 +89,14 @@ struct epoll_head_s
                                    * first node, used to free the malloced
                                    * memory in epoll_do_close().
                                    */
+  struct list_node      ready;    /* The ready list, store the setuped epoll
+                                   * nodes notified by their fd, so that
+                                   * epoll_wait() does not have to look at
+                                   * the others.  Protected by readylock,
+                                   * since it is appended to by the poll
+                                   * callback.
+                                   */
+  spinlock_t            readylock;
 };
 
 typedef struct epoll_head_s epoll_head_t;
@@ -245,6 +256,8 @@ static int epoll_do_create(int size, int flags)
   list_initialize(&eph->oneshot);
   list_initialize(&eph->extend);
   list_initialize(&eph->free);
+  list_initialize(&eph->ready);
+  spin_lock_init(&eph->readylock);
   for (i = 0; i < size; i++)
     {
       list_add_tail(&eph->free, &epn[i].node);
@@ -298,7 +311,6 @@ static int epoll_setup(FAR epoll_head_t *eph)
        * cover the situation several poll event pending on one fd.
        */
 
-      epn->notified    = false;
       epn->pfd.revents = 0;
       ret = poll_fdsetup(epn->pfd.fd, &epn->pfd, true);
       if (ret < 0)
@@ -316,12 +328,41 @@ static int epoll_setup(FAR epoll_head_t *eph)
   return ret;
 }
 
+/****************************************************************************
+ * Name: epoll_unqueue
+ *
+ * Description:
+ *   Remove an epoll node from the ready list, after its poll was torn down.
+ *
+ * Input Parameters:
+ *   eph       - The epoll head pointer
+ *   epn       - The epoll node
+ *
+ ****************************************************************************/
+
+static void epoll_unqueue(FAR epoll_head_t *eph, FAR epoll_node_t *epn)
+{
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&eph->readylock);
+  if (epn->notified)
+    {
+      list_delete(&epn->ready);
+      epn->notified = false;
+    }
+
+  epn->revents = 0;
+  spin_unlock_irqrestore(&eph->readylock, flags);
+}
+
 /****************************************************************************
  * Name: epoll_teardown
  *
  * Description:
- *   Teardown all the notifed fd and check the notified fd's event with user
- *   expected event.
+ *   Take the notified fd from the ready list and check the notified fd's
+ *   event with user expected event.  Level triggered fd are torn down, to
+ *   be setup again by the next epoll_setup().  Edge triggered fd stay
+ *   setup and are only reported again on the next notification.
  *
  * Input Parameters:
  *   eph       - The epoll head pointer
@@ -337,31 +378,41 @@ static int epoll_setup(FAR epoll_head_t *eph)
 static int epoll_teardown(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
                           int maxevents)
 {
-  FAR epoll_node_t *tepn;
   FAR epoll_node_t *epn;
+  pollevent_t revents;
+  irqstate_t flags;
+  bool pending;
+  int semcount;
   int i = 0;
 
   nxmutex_lock(&eph->lock);
 
-  list_for_every_entry_safe(&eph->setup, epn, tepn, epoll_node_t, node)
+  while (i < maxevents)
     {
-      /* Only check the notifed fd */
-
-      if (!epn->notified)
+      flags = spin_lock_irqsave(&eph->readylock);
+      if (list_is_empty(&eph->ready))
         {
-          continue;
+          spin_unlock_irqrestore(&eph->readylock, flags);
+          break;
         }
 
-      /* Teradown all the notified fd */
-
-      poll_fdsetup(epn->pfd.fd, &epn->pfd, false);
-      list_delete(&epn->node);
+      epn = container_of(list_remove_head(&eph->ready), epoll_node_t,
+                         ready);
+      revents       = epn->revents;
+      epn->revents  = 0;
+      epn->notified = false;
+      spin_unlock_irqrestore(&eph->readylock, flags);
 
-      if (epn->pfd.revents != 0 && i < maxevents)
+      if ((epn->pfd.events & EPOLLET) == 0 ||
+          ((epn->pfd.events & EPOLLONESHOT) != 0 && revents != 0))
         {
-          evs[i].data     = epn->data;
-          evs[i++].events = epn->pfd.revents;
-          if ((epn->pfd.events & EPOLLONESHOT) != 0)
+          /* Teradown the notified fd */
+
+          poll_fdsetup(epn->pfd.fd, &epn->pfd, false);
+          epoll_unqueue(eph, epn);
+          list_delete(&epn->node);
+
+          if (revents != 0 && (epn->pfd.events & EPOLLONESHOT) != 0)
             {
               list_add_tail(&eph->oneshot, &epn->node);
             }
@@ -370,9 +421,29 @@ static int epoll_teardown(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
               list_add_tail(&eph->teardown, &epn->node);
             }
         }
-      else
+
+      if (revents != 0)
         {
-          list_add_tail(&eph->teardown, &epn->node);
+          evs[i].data     = epn->data;
+          evs[i++].events = revents;
+        }
+    }
+
+  /* The nodes left on the ready list when evs is full are not notified
+   * again, keep the semaphore posted so that the next wait returns them
+   * instead of blocking.
+   */
+
+  flags   = spin_lock_irqsave(&eph->readylock);
+  pending = !list_is_empty(&eph->ready);
+  spin_unlock_irqrestore(&eph->readylock, flags);
+
+  if (pending)
+    {
+      nxsem_get_value(&eph->sem, &semcount);
+      if (semcount < 1)
+        {
+          nxsem_post(&eph->sem);
         }
     }
 
@@ -385,7 +456,8 @@ static int epoll_teardown(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
  *
  * Description:
  *   The default epoll callback function, this function do the final step of
- *   poll notification.
+ *   poll notification: Collect the events and put the epoll node in the
+ *   ready list.  It may be called from interrupt context.
  *
  * Input Parameters:
  *   fds - The fds
@@ -398,15 +470,34 @@ static int epoll_teardown(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
 static void epoll_default_cb(FAR struct pollfd *fds)
 {
   FAR epoll_node_t *epn = fds->arg;
+  FAR epoll_head_t *eph = epn->eph;
+  irqstate_t flags;
+  pollevent_t revents;
   int semcount = 0;
 
-  epn->notified = true;
-  if (fds->revents != 0)
+  flags = spin_lock_irqsave(&eph->readylock);
+
+  /* Clear the reported events, so that an edge triggered fd only reports
+   * new events the next time.
+   */
+
+  epn->revents |= fds->revents;
+  fds->revents  = 0;
+  revents       = epn->revents;
+  if (!epn->notified)
+    {
+      epn->notified = true;
+      list_add_tail(&eph->ready, &epn->ready);
+    }
+
+  spin_unlock_irqrestore(&eph->readylock, flags);
+
+  if (revents != 0)
     {
-      nxsem_get_value(&epn->eph->sem, &semcount);
+      nxsem_get_value(&eph->sem, &semcount);
       if (semcount < 1)
         {
-          nxsem_post(&epn->eph->sem);
+          nxsem_post(&eph->sem);
         }
     }
 }
@@ -557,6 +648,7 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
         epn->eph         = eph;
         epn->data        = ev->data;
         epn->notified    = false;
+        epn->revents     = 0;
         epn->pfd.events  = ev->events | POLLALWAYS;
         epn->pfd.fd      = fd;
         epn->pfd.arg     = epn;
@@ -580,6 +672,7 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
             if (epn->pfd.fd == fd)
               {
                 poll_fdsetup(fd, &epn->pfd, false);
+                epoll_unqueue(eph, epn);
                 list_delete(&epn->node);
                 list_add_tail(&eph->free, &epn->node);
                 goto out;
@@ -617,8 +710,8 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
                 if (epn->pfd.events != (ev->events | POLLALWAYS))
                   {
                     poll_fdsetup(fd, &epn->pfd, false);
+                    epoll_unqueue(eph, epn);
 
-                    epn->notified    = false;
                     epn->data        = ev->data;
                     epn->pfd.events  = ev->events | POLLALWAYS;
                     epn->pfd.fd      = fd;
@@ -641,7 +734,6 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
               {
                 if (epn->pfd.events != (ev->events | POLLALWAYS))
                   {
-                    epn->notified    = false;
                     epn->data        = ev->data;
                     epn->pfd.events  = ev->events | POLLALWAYS;
                     epn->pfd.fd      = fd;
@@ -665,7 +757,6 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
           {
             if (epn->pfd.fd == fd)
               {
-                epn->notified    = false;
                 epn->data        = ev->data;
                 epn->pfd.events  = ev->events | POLLALWAYS;
                 epn->pfd.fd      = fd;
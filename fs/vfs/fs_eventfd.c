@@ -85,6 +85,7 @@ static int eventfd_do_poll(FAR struct file *filep, FAR struct pollfd *fds,
 static int eventfd_blocking_io(FAR struct eventfd_priv_s *dev,
                                FAR eventfd_waiter_sem_t  *sem,
                                FAR eventfd_waiter_sem_t **slist);
+static void eventfd_wakeup(FAR eventfd_waiter_sem_t **slist, eventfd_t n);
 
 static FAR struct eventfd_priv_s *eventfd_allocdev(void);
 static void eventfd_destroy(FAR struct eventfd_priv_s *dev);
@@ -253,6 +254,8 @@ static int eventfd_blocking_io(FAR struct eventfd_priv_s *dev,
                   cur_sem->next = sem->next;
                   break;
                 }
+
+              cur_sem = cur_sem->next;
             }
         }
 
@@ -263,12 +266,27 @@ static int eventfd_blocking_io(FAR struct eventfd_priv_s *dev,
   return nxmutex_lock(&dev->lock);
 }
 
+/* Wake up at most n of the waiters of the list, which take themselves out
+ * of it.
+ */
+
+static void eventfd_wakeup(FAR eventfd_waiter_sem_t **slist, eventfd_t n)
+{
+  FAR eventfd_waiter_sem_t *cur_sem;
+
+  while (n-- > 0 && (cur_sem = *slist) != NULL)
+    {
+      *slist = cur_sem->next;
+      nxsem_post(&cur_sem->sem);
+    }
+}
+
 static ssize_t eventfd_do_read(FAR struct file *filep, FAR char *buffer,
                                size_t len)
 {
   FAR struct eventfd_priv_s *dev = filep->f_priv;
-  FAR eventfd_waiter_sem_t *cur_sem;
   ssize_t ret;
+  bool full;
 
   if (len < sizeof(eventfd_t) || buffer == NULL)
     {
@@ -310,6 +328,7 @@ static ssize_t eventfd_do_read(FAR struct file *filep, FAR char *buffer,
 
   /* Device ready for read */
 
+  full = dev->counter == (eventfd_t)-1;
   if ((filep->f_oflags & EFD_SEMAPHORE) != 0)
     {
       *(FAR eventfd_t *)buffer = 1;
@@ -322,21 +341,21 @@ static ssize_t eventfd_do_read(FAR struct file *filep, FAR char *buffer,
     }
 
 #ifdef CONFIG_EVENT_FD_POLL
-  /* Notify all poll/select waiters */
-
-  poll_notify(dev->fds, CONFIG_EVENT_FD_NPOLLWAITERS, POLLOUT);
-#endif
-
-  /* Notify all waiting writers that counter have been decremented */
+  /* Notify the poll/select waiters only if the counter was full, as they
+   * were told of POLLOUT by the setup or by the last read otherwise.
+   */
 
-  cur_sem = dev->wrsems;
-  while (cur_sem != NULL)
+  if (full)
     {
-      nxsem_post(&cur_sem->sem);
-      cur_sem = cur_sem->next;
+      poll_notify(dev->fds, CONFIG_EVENT_FD_NPOLLWAITERS, POLLOUT);
     }
+#endif
 
-  dev->wrsems = NULL;
+  /* Notify all waiting writers that counter have been decremented, each
+   * of them waits for room for its own value.
+   */
+
+  eventfd_wakeup(&dev->wrsems, (eventfd_t)-1);
 
   nxmutex_unlock(&dev->lock);
   return sizeof(eventfd_t);
@@ -346,8 +365,8 @@ static ssize_t eventfd_do_write(FAR struct file *filep,
                                 FAR const char *buffer, size_t len)
 {
   FAR struct eventfd_priv_s *dev = filep->f_priv;
-  FAR eventfd_waiter_sem_t *cur_sem;
   eventfd_t new_counter;
+  eventfd_t old_counter;
   ssize_t ret;
 
   if (len < sizeof(eventfd_t) || buffer == NULL ||
@@ -395,25 +414,29 @@ static ssize_t eventfd_do_write(FAR struct file *filep,
 
   /* Ready to write, update counter */
 
+  old_counter  = dev->counter;
   dev->counter = new_counter;
 
+  /* A counter that was not zero has already woken up the poll/select
+   * waiters and the readers, none of them is blocked on it.
+   */
+
+  if (old_counter == 0)
+    {
 #ifdef CONFIG_EVENT_FD_POLL
-  /* Notify all poll/select waiters */
+      /* Notify all poll/select waiters */
 
-  poll_notify(dev->fds, CONFIG_EVENT_FD_NPOLLWAITERS, POLLIN);
+      poll_notify(dev->fds, CONFIG_EVENT_FD_NPOLLWAITERS, POLLIN);
 #endif
 
-  /* Notify all of the waiting readers */
+      /* Notify the waiting readers: the first one takes the whole count,
+       * but with EFD_SEMAPHORE each of them only takes one.
+       */
 
-  cur_sem = dev->rdsems;
-  while (cur_sem != NULL)
-    {
-      nxsem_post(&cur_sem->sem);
-      cur_sem = cur_sem->next;
+      eventfd_wakeup(&dev->rdsems, (filep->f_oflags & EFD_SEMAPHORE) != 0 ?
+                                   new_counter : 1);
     }
 
-  dev->rdsems = NULL;
-
   nxmutex_unlock(&dev->lock);
   return sizeof(eventfd_t);
 }
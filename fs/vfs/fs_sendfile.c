@@ -25,10 +25,12 @@
 #include <nuttx/config.h>
 
 #include <sys/sendfile.h>
+#include <sys/stat.h>
 #include <stdbool.h>
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/net/net.h>
 #include "fs_heap.h"
@@ -37,6 +39,88 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: copyxip
+ *
+ * Description:
+ *   Write the data of a file that is resident in memory (FIOC_XIPBASE)
+ *   directly to the outfile, without a bounce buffer.
+ *
+ * Returned Value:
+ *   The number of bytes transferred, a negated errno value on failure, or
+ *   -ENOSYS if the infile is not resident in memory.
+ *
+ ****************************************************************************/
+
+static ssize_t copyxip(FAR struct file *outfile, FAR struct file *infile,
+                       FAR off_t *offset, size_t count)
+{
+  FAR const uint8_t *data;
+  size_t ntransferred = 0;
+  uintptr_t xipbase;
+  struct stat buf;
+  ssize_t ret;
+  off_t pos;
+
+  if (file_ioctl(infile, FIOC_XIPBASE, (unsigned long)&xipbase) < 0 ||
+      file_fstat(infile, &buf) < 0)
+    {
+      return -ENOSYS;
+    }
+
+  pos = offset ? *offset : file_seek(infile, 0, SEEK_CUR);
+  if (pos < 0)
+    {
+      return pos;
+    }
+
+  if (pos >= buf.st_size)
+    {
+      return 0;
+    }
+
+  if (count > buf.st_size - pos)
+    {
+      count = buf.st_size - pos;
+    }
+
+  data = (FAR const uint8_t *)xipbase + pos;
+  while (ntransferred < count)
+    {
+      ret = file_write(outfile, data + ntransferred, count - ntransferred);
+      if (ret < 0)
+        {
+          /* Like copyfile(), report an error only if nothing was sent */
+
+          if (ntransferred == 0)
+            {
+              return ret;
+            }
+
+          break;
+        }
+
+      ntransferred += ret;
+    }
+
+  /* Nothing was read, so update the file position explicitly */
+
+  if (offset)
+    {
+      *offset = pos + ntransferred;
+    }
+  else
+    {
+      ret = file_seek(infile, pos + ntransferred, SEEK_SET);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  return ntransferred;
+}
+
 static ssize_t copyfile(FAR struct file *outfile, FAR struct file *infile,
                         FAR off_t *offset, size_t count)
 {
@@ -276,10 +360,17 @@ ssize_t file_sendfile(FAR struct file *outfile, FAR struct file *infile,
     }
 #endif
 
-  /* No... then this is probably a file-to-file transfer.  The generic
+  /* No... then this is probably a file-to-file transfer.  Write straight
+   * from the infile if it is resident in memory, or else the generic
    * copyfile() can handle that case.
    */
 
+  ssize_t nsent = copyxip(outfile, infile, offset, count);
+  if (nsent != -ENOSYS)
+    {
+      return nsent;
+    }
+
   return copyfile(outfile, infile, offset, count);
 }
 
@@ -0,0 +1,243 @@
+/****************************************************************************
+ * fs/vfs/fs_splice.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <fcntl.h>
+#include <errno.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: file_splice
+ *
+ * Description:
+ *   Equivalent to the standard splice function except that is accepts
+ *   struct file instances instead of file descriptors.
+ *
+ ****************************************************************************/
+
+ssize_t file_splice(FAR struct file *infile, FAR off_t *inoffset,
+                    FAR struct file *outfile, FAR off_t *outoffset,
+                    size_t len, unsigned int flags)
+{
+  struct pipe_splice_s splice;
+
+  splice.len   = len;
+  splice.flags = flags;
+
+  /* The pipe moves the data between its buffer and the other file, so it
+   * does not have to go through an intermediate buffer.
+   */
+
+  if (INODE_IS_PIPE(infile->f_inode))
+    {
+      if (inoffset != NULL)
+        {
+          return -ESPIPE;
+        }
+
+      splice.filep  = outfile;
+      splice.offset = outoffset;
+      splice.out    = true;
+      return file_ioctl(infile, PIPEIOC_SPLICE, &splice);
+    }
+  else if (INODE_IS_PIPE(outfile->f_inode))
+    {
+      if (outoffset != NULL)
+        {
+          return -ESPIPE;
+        }
+
+      splice.filep  = infile;
+      splice.offset = inoffset;
+      splice.out    = false;
+      return file_ioctl(outfile, PIPEIOC_SPLICE, &splice);
+    }
+
+  /* One of the files must be a pipe */
+
+  return -EINVAL;
+}
+
+/****************************************************************************
+ * Name: file_tee
+ *
+ * Description:
+ *   Equivalent to the standard tee function except that is accepts
+ *   struct file instances instead of file descriptors.
+ *
+ ****************************************************************************/
+
+ssize_t file_tee(FAR struct file *infile, FAR struct file *outfile,
+                 size_t len, unsigned int flags)
+{
+  struct pipe_splice_s splice;
+
+  if (!INODE_IS_PIPE(infile->f_inode) || !INODE_IS_PIPE(outfile->f_inode))
+    {
+      return -EINVAL;
+    }
+
+  splice.filep  = outfile;
+  splice.offset = NULL;
+  splice.len    = len;
+  splice.flags  = flags;
+  splice.out    = true;
+  return file_ioctl(infile, PIPEIOC_TEE, &splice);
+}
+
+/****************************************************************************
+ * Name: splice
+ *
+ * Description:
+ *   splice() moves up to 'len' bytes between two file descriptors, at
+ *   least one of which refers to a pipe.  The data is copied once, between
+ *   the pipe buffer and the other file, rather than read into and written
+ *   from a user buffer.
+ *
+ *   NOTE: This interface is not specified by POSIX.  It is similar to the
+ *   Linux splice() interface, the SPLICE_F_MOVE, SPLICE_F_MORE and
+ *   SPLICE_F_GIFT flags are accepted but ignored.
+ *
+ * Input Parameters:
+ *   fd_in   - The descriptor to read data from
+ *   off_in  - If not NULL, the offset in 'fd_in' to read from, that is
+ *             updated instead of the file offset.  Must be NULL for a pipe.
+ *   fd_out  - The descriptor to write data to
+ *   off_out - If not NULL, the offset in 'fd_out' to write to, that is
+ *             updated instead of the file offset.  Must be NULL for a pipe.
+ *   len     - The maximum number of bytes to move
+ *   flags   - SPLICE_F_NONBLOCK makes the operations on the pipe
+ *             non-blocking
+ *
+ * Returned Value:
+ *   The number of bytes moved, zero at the end of the input.  On error, -1
+ *   is returned, and errno is set appropriately:
+ *
+ *   EINVAL - Neither descriptor refers to a pipe
+ *   ESPIPE - An offset is given for a pipe
+ *   EAGAIN - SPLICE_F_NONBLOCK was given and the pipe is empty or full
+ *
+ ****************************************************************************/
+
+ssize_t splice(int fd_in, FAR off_t *off_in, int fd_out, FAR off_t *off_out,
+               size_t len, unsigned int flags)
+{
+  FAR struct file *infile;
+  FAR struct file *outfile;
+  ssize_t ret;
+
+  ret = fs_getfilep(fd_in, &infile);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  ret = fs_getfilep(fd_out, &outfile);
+  if (ret < 0)
+    {
+      fs_putfilep(infile);
+      goto errout;
+    }
+
+  ret = file_splice(infile, off_in, outfile, off_out, len, flags);
+  fs_putfilep(outfile);
+  fs_putfilep(infile);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  return ret;
+
+errout:
+  set_errno(-ret);
+  return ERROR;
+}
+
+/****************************************************************************
+ * Name: tee
+ *
+ * Description:
+ *   tee() copies up to 'len' bytes from the pipe 'fd_in' to the pipe
+ *   'fd_out', without consuming them from 'fd_in'.
+ *
+ *   NOTE: This interface is not specified by POSIX.  It is similar to the
+ *   Linux tee() interface.
+ *
+ * Input Parameters:
+ *   fd_in  - The pipe to copy data from
+ *   fd_out - The pipe to copy data to
+ *   len    - The maximum number of bytes to copy
+ *   flags  - SPLICE_F_NONBLOCK makes the operations non-blocking
+ *
+ * Returned Value:
+ *   The number of bytes copied, zero at the end of the input.  On error,
+ *   -1 is returned, and errno is set appropriately:
+ *
+ *   EINVAL - A descriptor does not refer to a pipe, or both refer to the
+ *            same pipe
+ *   EAGAIN - SPLICE_F_NONBLOCK was given and a pipe is empty or full
+ *
+ ****************************************************************************/
+
+ssize_t tee(int fd_in, int fd_out, size_t len, unsigned int flags)
+{
+  FAR struct file *infile;
+  FAR struct file *outfile;
+  ssize_t ret;
+
+  ret = fs_getfilep(fd_in, &infile);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  ret = fs_getfilep(fd_out, &outfile);
+  if (ret < 0)
+    {
+      fs_putfilep(infile);
+      goto errout;
+    }
+
+  ret = file_tee(infile, outfile, len, flags);
+  fs_putfilep(outfile);
+  fs_putfilep(infile);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  return ret;
+
+errout:
+  set_errno(-ret);
+  return ERROR;
+}
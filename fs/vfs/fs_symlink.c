@@ -144,18 +144,19 @@ int symlink(FAR const char *path1, FAR const char *path2)
 
       inode_lock();
       ret = inode_reserve(path2, 0777, &inode);
-      inode_unlock();
       if (ret < 0)
         {
+          inode_unlock();
           fs_heap_free(newpath2);
           errcode = -ret;
           goto errout_with_search;
         }
 
-      /* Initialize the inode */
+      /* Initialize the inode before any search can follow the link */
 
-      INODE_SET_SOFTLINK(inode);
       inode->u.i_link = newpath2;
+      INODE_SET_SOFTLINK(inode);
+      inode_unlock();
     }
 
   /* Symbolic link successfully created */
@@ -35,6 +35,7 @@
 #include <nuttx/mutex.h>
 
 #include <sys/ioctl.h>
+#include <sys/param.h>
 #include <sys/timerfd.h>
 
 #include "clock/clock.h"
@@ -65,6 +66,7 @@ struct timerfd_priv_s
   int                       delay;   /* If non-zero, used to reset repetitive
                                       * timers */
   struct wdog_s             wdog;    /* The watchdog that provides the timing */
+  clock_t                   expiry;  /* Tick of the next expiration */
   timerfd_t                 counter; /* timerfd counter */
   uint8_t                   crefs;   /* References counts on timerfd (max: 255) */
 
@@ -98,6 +100,9 @@ static int timerfd_blocking_io(FAR struct timerfd_priv_s *dev,
 static FAR struct timerfd_priv_s *timerfd_allocdev(void);
 static void timerfd_destroy(FAR struct timerfd_priv_s *dev);
 
+static void timerfd_catchup(FAR struct timerfd_priv_s *dev, clock_t now);
+static int timerfd_arm(FAR struct timerfd_priv_s *dev);
+static sclock_t timerfd_remaining(FAR struct timerfd_priv_s *dev);
 static void timerfd_timeout(wdparm_t arg);
 
 /****************************************************************************
@@ -256,6 +261,8 @@ static int timerfd_blocking_io(FAR struct timerfd_priv_s *dev,
                   cur_sem->next = sem->next;
                   break;
                 }
+
+              cur_sem = cur_sem->next;
             }
         }
     }
@@ -310,9 +317,20 @@ static ssize_t timerfd_read(FAR struct file *filep, FAR char *buffer,
       nxsem_destroy(&sem.sem);
     }
 
+  /* Count the expirations of a repetitive timer since the watchdog was
+   * left stopped, and start it again for the next one.
+   */
+
+  timerfd_catchup(dev, clock_systime_ticks());
+
   *(FAR timerfd_t *)buffer = dev->counter;
   dev->counter = 0;
 
+  if (dev->delay > 0)
+    {
+      timerfd_arm(dev);
+    }
+
   leave_critical_section(intflags);
 
   return sizeof(timerfd_t);
@@ -381,6 +399,62 @@ out:
 }
 #endif
 
+/* Add the expirations that went by until now to the counter of a
+ * repetitive timer, and move the next expiration after now.  The watchdog
+ * is not running while the counter is not zero.
+ */
+
+static void timerfd_catchup(FAR struct timerfd_priv_s *dev, clock_t now)
+{
+  clock_t n;
+
+  if (dev->delay > 0 && dev->counter > 0 &&
+      (sclock_t)(now - dev->expiry) >= 0)
+    {
+      n             = (now - dev->expiry) / dev->delay + 1;
+      dev->counter += n;
+      dev->expiry  += n * dev->delay;
+    }
+}
+
+/* Start the watchdog for the next expiration.  With a slack, it is
+ * deferred to the next multiple of the slack, so that the timers expiring
+ * close to each other are handled at the same tick.
+ */
+
+static int timerfd_arm(FAR struct timerfd_priv_s *dev)
+{
+  clock_t ticks = dev->expiry;
+
+#if CONFIG_TIMER_FD_SLACK > 1
+  ticks += CONFIG_TIMER_FD_SLACK - 1;
+  ticks -= ticks % CONFIG_TIMER_FD_SLACK;
+#endif
+
+  return wd_start_abstick(&dev->wdog, ticks, timerfd_timeout,
+                          (wdparm_t)dev);
+}
+
+/* The number of ticks before the next expiration, zero if the timer is
+ * disarmed.  Called with the interrupts disabled.
+ */
+
+static sclock_t timerfd_remaining(FAR struct timerfd_priv_s *dev)
+{
+  clock_t now = clock_systime_ticks();
+
+  if (dev->delay > 0 && dev->counter > 0)
+    {
+      timerfd_catchup(dev, now);
+    }
+  else if (!WDOG_ISACTIVE(&dev->wdog))
+    {
+      return 0;
+    }
+
+  return MAX((sclock_t)(dev->expiry - now), 0);
+}
+
 static void timerfd_timeout(wdparm_t arg)
 {
   FAR struct timerfd_priv_s *dev = (FAR struct timerfd_priv_s *)arg;
@@ -393,15 +467,17 @@ static void timerfd_timeout(wdparm_t arg)
 
   intflags = enter_critical_section();
 
-  /* Increment timer expiration counter */
-
-  dev->counter++;
-
-  /* If this is a repetitive timer, then restart the watchdog */
+  /* Increment timer expiration counter.  The expirations of a repetitive
+   * timer that went by with the slack are counted too.  The watchdog is not
+   * restarted: the following expirations are counted by the next read, so
+   * that the timer only wakes up its waiters when its counter leaves zero.
+   */
 
+  dev->counter = 1;
   if (dev->delay > 0)
     {
-      wd_start(&dev->wdog, dev->delay, timerfd_timeout, arg);
+      dev->expiry += dev->delay;
+      timerfd_catchup(dev, clock_systime_ticks());
     }
 
 #ifdef CONFIG_TIMER_FD_POLL
@@ -410,17 +486,15 @@ static void timerfd_timeout(wdparm_t arg)
   poll_notify(dev->fds, CONFIG_TIMER_FD_NPOLLWAITERS, POLLIN);
 #endif
 
-  /* Notify all of the waiting readers */
+  /* Notify the first waiting reader, it takes the whole counter */
 
   cur_sem = dev->rdsems;
-  while (cur_sem != NULL)
+  if (cur_sem != NULL)
     {
+      dev->rdsems = cur_sem->next;
       nxsem_post(&cur_sem->sem);
-      cur_sem = cur_sem->next;
     }
 
-  dev->rdsems = NULL;
-
   leave_critical_section(intflags);
 }
 
@@ -527,9 +601,9 @@ int timerfd_settime(int fd, int flags,
 
   if (old_value)
     {
-      /* Get the number of ticks before the underlying watchdog expires */
+      /* Get the number of ticks before the next expiration */
 
-      delay = wd_gettime(&dev->wdog);
+      delay = timerfd_remaining(dev);
 
       /* Convert that to a struct timespec and return it */
 
@@ -596,7 +670,8 @@ int timerfd_settime(int fd, int flags,
 
   /* Then start the watchdog */
 
-  ret = wd_start(&dev->wdog, delay, timerfd_timeout, (wdparm_t)dev);
+  dev->expiry = clock_systime_ticks() + delay;
+  ret = timerfd_arm(dev);
   if (ret < 0)
     {
       leave_critical_section(intflags);
@@ -618,6 +693,7 @@ int timerfd_gettime(int fd, FAR struct itimerspec *curr_value)
 {
   FAR struct timerfd_priv_s *dev;
   FAR struct file *filep;
+  irqstate_t intflags;
   sclock_t ticks;
   int ret;
 
@@ -645,9 +721,11 @@ int timerfd_gettime(int fd, FAR struct itimerspec *curr_value)
 
   dev = (FAR struct timerfd_priv_s *)filep->f_priv;
 
-  /* Get the number of ticks before the underlying watchdog expires */
+  /* Get the number of ticks before the next expiration */
 
-  ticks = wd_gettime(&dev->wdog);
+  intflags = enter_critical_section();
+  ticks = timerfd_remaining(dev);
+  leave_critical_section(intflags);
 
   /* Convert that to a struct timespec and return it */
 
@@ -26,17 +26,27 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <string.h>
+#include <sys/param.h>
 #include <sys/stat.h>
 #include <sys/statfs.h>
 #include <nuttx/mutex.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
+#include <nuttx/mm/map.h>
 
 #include <unzip.h>
 
 #include "fs_heap.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The window of an inflate restart point */
+
+#define ZIPFS_WINDOW_SIZE    32768
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -54,11 +64,41 @@ struct zipfs_mountpt_s
   char abspath[1];
 };
 
+#if CONFIG_ZIPFS_SEEK_INDEX > 0
+/* A point of the deflated data where the inflation can restart */
+
+struct zipfs_point_s
+{
+  off_t out;                   /* Offset in the uncompressed data */
+  off_t in;                    /* Offset in the compressed data */
+  int bits;                    /* Bits of the byte before in still unused */
+  uInt wsize;                  /* Size of the window */
+  FAR Bytef *window;           /* Uncompressed data before the point */
+};
+#endif
+
 struct zipfs_file_s
 {
   unzFile uf;
   mutex_t lock;
   FAR char *seekbuf;
+  ZPOS64_T dataoff;            /* Offset of the data in the archive */
+#if CONFIG_ZIPFS_SEEK_INDEX > 0
+  bool direct;                 /* Read by zipfs instead of minizip */
+  int method;                  /* 0 (stored) or Z_DEFLATED */
+  struct file zfile;           /* The archive */
+  ZPOS64_T csize;              /* Size of the compressed data */
+  ZPOS64_T usize;              /* Size of the uncompressed data */
+  uLong crc;                   /* CRC of the uncompressed data */
+  uLong crcsum;                /* CRC of the data read from the start */
+  off_t crcpos;                /* End of the data in crcsum */
+  off_t in;                    /* Compressed data read into inbuf */
+  off_t out;                   /* Uncompressed data inflated */
+  z_stream strm;
+  FAR Bytef *inbuf;
+  unsigned int npoints;
+  struct zipfs_point_s points[CONFIG_ZIPFS_SEEK_INDEX_POINTS];
+#endif
   char relpath[1];
 };
 
@@ -83,6 +123,10 @@ static ssize_t zipfs_read(FAR struct file *filep, FAR char *buffer,
                           size_t buflen);
 static off_t   zipfs_seek(FAR struct file *filep, off_t offset,
                           int whence);
+static int     zipfs_ioctl(FAR struct file *filep, int cmd,
+                           unsigned long arg);
+static int     zipfs_mmap(FAR struct file *filep,
+                          FAR struct mm_map_entry_s *map);
 static int     zipfs_dup(FAR const struct file *oldp,
                          FAR struct file *newp);
 static int     zipfs_fstat(FAR const struct file *filep,
@@ -133,8 +177,8 @@ const struct mountpt_operations g_zipfs_operations =
   zipfs_read,          /* read */
   NULL,                /* write */
   zipfs_seek,          /* seek */
-  NULL,                /* ioctl */
-  NULL,                /* mmap */
+  zipfs_ioctl,         /* ioctl */
+  zipfs_mmap,          /* mmap */
   NULL,                /* truncate */
   NULL,                /* poll */
 
@@ -239,6 +283,326 @@ static int zipfs_convert_result(int ziperr)
     }
 }
 
+#if CONFIG_ZIPFS_SEEK_INDEX > 0
+/* The stored and deflated entries are read directly from the archive by
+ * zipfs, so that seeking in a stored entry is free, and seeking back in a
+ * deflated entry restarts the inflation from the nearest point saved
+ * while reading it, instead of from the start of the entry.
+ */
+
+static int zipfs_direct_open(FAR struct zipfs_mountpt_s *fs,
+                             FAR struct zipfs_file_s *fp)
+{
+  unz_file_info64 file_info;
+  int ret;
+
+  ret = unzGetCurrentFileInfo64(fp->uf, &file_info, NULL, 0,
+                                NULL, 0, NULL, 0);
+  ret = zipfs_convert_result(ret);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* The other methods and the encrypted entries are left to minizip */
+
+  if ((file_info.compression_method != 0 &&
+       file_info.compression_method != Z_DEFLATED) ||
+      (file_info.flag & 1) != 0)
+    {
+      return OK;
+    }
+
+  ret = file_open(&fp->zfile, fs->abspath, O_RDONLY);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (file_info.compression_method == Z_DEFLATED)
+    {
+      fp->inbuf = fs_heap_malloc(CONFIG_ZIPFS_SEEK_BUFSIZE);
+      if (fp->inbuf == NULL)
+        {
+          file_close(&fp->zfile);
+          return -ENOMEM;
+        }
+
+      if (inflateInit2(&fp->strm, -MAX_WBITS) != Z_OK)
+        {
+          fs_heap_free(fp->inbuf);
+          file_close(&fp->zfile);
+          return -ENOMEM;
+        }
+    }
+
+  fp->method = file_info.compression_method;
+  fp->csize  = file_info.compressed_size;
+  fp->usize  = file_info.uncompressed_size;
+  fp->crc    = file_info.crc;
+  fp->crcsum = crc32(0, Z_NULL, 0);
+  fp->direct = true;
+
+  /* The inflate state of minizip isn't needed any more */
+
+  unzCloseCurrentFile(fp->uf);
+  return OK;
+}
+
+static void zipfs_direct_close(FAR struct zipfs_file_s *fp)
+{
+  unsigned int i;
+
+  if (!fp->direct)
+    {
+      return;
+    }
+
+  if (fp->method == Z_DEFLATED)
+    {
+      inflateEnd(&fp->strm);
+      fs_heap_free(fp->inbuf);
+    }
+
+  for (i = 0; i < fp->npoints; i++)
+    {
+      fs_heap_free(fp->points[i].window);
+    }
+
+  file_close(&fp->zfile);
+}
+
+static void zipfs_add_point(FAR struct zipfs_file_s *fp, off_t out)
+{
+  FAR struct zipfs_point_s *point;
+  off_t last = 0;
+
+  if (fp->npoints > 0)
+    {
+      last = fp->points[fp->npoints - 1].out;
+    }
+
+  /* The points are saved in order, as the data is first inflated */
+
+  if (fp->npoints >= CONFIG_ZIPFS_SEEK_INDEX_POINTS ||
+      out - last < CONFIG_ZIPFS_SEEK_INDEX)
+    {
+      return;
+    }
+
+  point = &fp->points[fp->npoints];
+  point->window = fs_heap_malloc(ZIPFS_WINDOW_SIZE);
+  if (point->window == NULL)
+    {
+      return;
+    }
+
+  point->wsize = ZIPFS_WINDOW_SIZE;
+  inflateGetDictionary(&fp->strm, point->window, &point->wsize);
+  point->out  = out;
+  point->in   = fp->in - fp->strm.avail_in;
+  point->bits = fp->strm.data_type & 7;
+  fp->npoints++;
+}
+
+static int zipfs_inflate_reset(FAR struct zipfs_file_s *fp,
+                               FAR struct zipfs_point_s *point)
+{
+  uint8_t byte;
+  ssize_t ret;
+
+  inflateReset(&fp->strm);
+  fp->strm.avail_in = 0;
+
+  if (point == NULL)
+    {
+      fp->in  = 0;
+      fp->out = 0;
+      return OK;
+    }
+
+  /* The point may be in the middle of a byte, feed its remaining bits */
+
+  if (point->bits != 0)
+    {
+      ret = file_pread(&fp->zfile, &byte, 1,
+                       fp->dataoff + point->in - 1);
+      if (ret != 1)
+        {
+          return ret < 0 ? ret : -EIO;
+        }
+
+      inflatePrime(&fp->strm, point->bits, byte >> (8 - point->bits));
+    }
+
+  inflateSetDictionary(&fp->strm, point->window, point->wsize);
+  fp->in  = point->in;
+  fp->out = point->out;
+  return OK;
+}
+
+static ssize_t zipfs_inflate(FAR struct zipfs_file_s *fp,
+                             FAR char *buffer, size_t buflen)
+{
+  ssize_t nread;
+  ssize_t ret;
+
+  fp->strm.next_out  = (FAR Bytef *)buffer;
+  fp->strm.avail_out = buflen;
+
+  while (fp->strm.avail_out > 0)
+    {
+      if (fp->strm.avail_in == 0)
+        {
+          ret = MIN(CONFIG_ZIPFS_SEEK_BUFSIZE, fp->csize - fp->in);
+          if (ret > 0)
+            {
+              ret = file_pread(&fp->zfile, fp->inbuf, ret,
+                               fp->dataoff + fp->in);
+            }
+
+          if (ret <= 0)
+            {
+              ret = ret < 0 ? ret : -EIO;
+              break;
+            }
+
+          fp->in            += ret;
+          fp->strm.next_in   = fp->inbuf;
+          fp->strm.avail_in  = ret;
+        }
+
+      /* Stop at the end of each block, where a point can be saved */
+
+      ret = inflate(&fp->strm, Z_BLOCK);
+      if (ret == Z_STREAM_END)
+        {
+          break;
+        }
+      else if (ret != Z_OK && ret != Z_BUF_ERROR)
+        {
+          ret = -EIO;
+          break;
+        }
+
+      if ((fp->strm.data_type & 128) != 0 &&
+          (fp->strm.data_type & 64) == 0)
+        {
+          zipfs_add_point(fp, fp->out + buflen - fp->strm.avail_out);
+        }
+    }
+
+  nread    = buflen - fp->strm.avail_out;
+  fp->out += nread;
+  if (nread == 0 && ret < 0)
+    {
+      return ret;
+    }
+
+  return nread;
+}
+
+static ssize_t zipfs_direct_read(FAR struct zipfs_file_s *fp,
+                                 FAR char *buffer, size_t buflen,
+                                 off_t pos)
+{
+  ssize_t ret;
+
+  if (pos >= fp->usize)
+    {
+      return 0;
+    }
+
+  buflen = MIN(buflen, fp->usize - pos);
+  if (fp->method == Z_DEFLATED)
+    {
+      DEBUGASSERT(pos == fp->out);
+      ret = zipfs_inflate(fp, buffer, buflen);
+    }
+  else
+    {
+      ret = file_pread(&fp->zfile, buffer, buflen, fp->dataoff + pos);
+    }
+
+  /* Check the CRC once the data has been read from the start to the end */
+
+  if (ret > 0 && pos == fp->crcpos)
+    {
+      fp->crcsum  = crc32(fp->crcsum, (FAR const Bytef *)buffer, ret);
+      fp->crcpos += ret;
+      if (fp->crcpos == fp->usize && fp->crcsum != fp->crc)
+        {
+          return -ESTALE;
+        }
+    }
+
+  return ret;
+}
+
+static off_t zipfs_direct_seek(FAR struct zipfs_file_s *fp, off_t offset)
+{
+  FAR struct zipfs_point_s *point = NULL;
+  unsigned int i;
+  ssize_t ret;
+
+  if (offset < 0)
+    {
+      return -EINVAL;
+    }
+
+  offset = MIN(offset, fp->usize);
+  if (fp->method != Z_DEFLATED)
+    {
+      return offset;
+    }
+
+  /* Restart from the nearest point before the offset, unless the stream
+   * is already closer to it.
+   */
+
+  for (i = 0; i < fp->npoints && fp->points[i].out <= offset; i++)
+    {
+      point = &fp->points[i];
+    }
+
+  if (offset < fp->out || (point != NULL && point->out > fp->out))
+    {
+      ret = zipfs_inflate_reset(fp, point);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  if (fp->out < offset && fp->seekbuf == NULL)
+    {
+      fp->seekbuf = fs_heap_malloc(CONFIG_ZIPFS_SEEK_BUFSIZE);
+      if (fp->seekbuf == NULL)
+        {
+          return -ENOMEM;
+        }
+    }
+
+  while (fp->out < offset)
+    {
+      ret = zipfs_direct_read(fp, fp->seekbuf,
+                              MIN(CONFIG_ZIPFS_SEEK_BUFSIZE,
+                                  offset - fp->out), fp->out);
+      if (ret <= 0)
+        {
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          break;
+        }
+    }
+
+  return fp->out;
+}
+#endif
+
 static int zipfs_open(FAR struct file *filep, FAR const char *relpath,
                       int oflags, mode_t mode)
 {
@@ -248,7 +612,7 @@ static int zipfs_open(FAR struct file *filep, FAR const char *relpath,
 
   DEBUGASSERT(fs != NULL);
 
-  fp = fs_heap_malloc(sizeof(*fp) + strlen(relpath));
+  fp = fs_heap_zalloc(sizeof(*fp) + strlen(relpath));
   if (fp == NULL)
     {
       return -ENOMEM;
@@ -279,6 +643,15 @@ static int zipfs_open(FAR struct file *filep, FAR const char *relpath,
       goto err_with_zip;
     }
 
+  fp->dataoff = unzGetCurrentFileZStreamPos64(fp->uf);
+#if CONFIG_ZIPFS_SEEK_INDEX > 0
+  ret = zipfs_direct_open(fs, fp);
+  if (ret < 0)
+    {
+      goto err_with_zip;
+    }
+#endif
+
   if (ret == OK)
     {
       fp->seekbuf = NULL;
@@ -303,6 +676,9 @@ static int zipfs_close(FAR struct file *filep)
   FAR struct zipfs_file_s *fp = filep->f_priv;
   int ret;
 
+#if CONFIG_ZIPFS_SEEK_INDEX > 0
+  zipfs_direct_close(fp);
+#endif
   ret = zipfs_convert_result(unzClose(fp->uf));
   nxmutex_destroy(&fp->lock);
   fs_heap_free(fp->seekbuf);
@@ -317,7 +693,18 @@ static ssize_t zipfs_read(FAR struct file *filep, FAR char *buffer,
   ssize_t ret;
 
   nxmutex_lock(&fp->lock);
-  ret = zipfs_convert_result(unzReadCurrentFile(fp->uf, buffer, buflen));
+#if CONFIG_ZIPFS_SEEK_INDEX > 0
+  if (fp->direct)
+    {
+      ret = zipfs_direct_read(fp, buffer, buflen, filep->f_pos);
+    }
+  else
+#endif
+    {
+      ret = unzReadCurrentFile(fp->uf, buffer, buflen);
+      ret = zipfs_convert_result(ret);
+    }
+
   if (ret > 0)
     {
       filep->f_pos += ret;
@@ -365,7 +752,6 @@ static off_t zipfs_skip(FAR struct zipfs_file_s *fp, off_t amount)
 static off_t zipfs_seek(FAR struct file *filep, off_t offset,
                         int whence)
 {
-  FAR struct zipfs_mountpt_s *fs = filep->f_inode->i_private;
   FAR struct zipfs_file_s *fp = filep->f_priv;
   unz_file_info64 file_info;
   off_t ret = 0;
@@ -394,26 +780,28 @@ static off_t zipfs_seek(FAR struct file *filep, off_t offset,
         goto err_with_lock;
     }
 
+#if CONFIG_ZIPFS_SEEK_INDEX > 0
+  if (fp->direct)
+    {
+      ret = zipfs_direct_seek(fp, offset);
+      if (ret >= 0)
+        {
+          filep->f_pos = ret;
+        }
+
+      goto err_with_lock;
+    }
+#endif
+
   if (filep->f_pos == offset)
     {
       goto err_with_lock;
     }
   else if (filep->f_pos > offset)
     {
-      ret = zipfs_convert_result(unzClose(fp->uf));
-      if (ret < 0)
-        {
-          goto err_with_lock;
-        }
-
-      fp->uf = unzOpen2_64(fs->abspath, &zipfs_real_ops);
-      if (fp->uf == NULL)
-        {
-          ret = -EINVAL;
-          goto err_with_lock;
-        }
+      /* Restart the entry, the archive stays on it */
 
-      ret = zipfs_convert_result(unzLocateFile(fp->uf, fp->relpath, 0));
+      ret = zipfs_convert_result(unzCloseCurrentFile(fp->uf));
       if (ret < 0)
         {
           goto err_with_lock;
@@ -444,6 +832,88 @@ err_with_lock:
   return ret < 0 ? ret : filep->f_pos;
 }
 
+static int zipfs_xipbase(FAR struct file *filep, FAR uintptr_t *xipbase,
+                         FAR ZPOS64_T *size)
+{
+  FAR struct zipfs_mountpt_s *fs = filep->f_inode->i_private;
+  FAR struct zipfs_file_s *fp = filep->f_priv;
+  unz_file_info64 file_info;
+  struct file zipfile;
+  int ret;
+
+  /* Only the entries stored without compression nor encryption are laid
+   * out as is in the archive.
+   */
+
+  nxmutex_lock(&fp->lock);
+  ret = zipfs_convert_result(unzGetCurrentFileInfo64(fp->uf, &file_info,
+                                                     NULL, 0, NULL, 0,
+                                                     NULL, 0));
+  nxmutex_unlock(&fp->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (file_info.compression_method != 0 || (file_info.flag & 1) != 0)
+    {
+      return -ENXIO;
+    }
+
+  /* And they are resident in memory only if the archive itself is, e.g.
+   * it lives on a ROMFS image in NOR flash.
+   */
+
+  ret = file_open(&zipfile, fs->abspath, O_RDONLY);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = file_ioctl(&zipfile, FIOC_XIPBASE, (unsigned long)xipbase);
+  file_close(&zipfile);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  *xipbase += fp->dataoff;
+  *size     = file_info.uncompressed_size;
+  return OK;
+}
+
+static int zipfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
+{
+  ZPOS64_T size;
+
+  if (cmd == FIOC_XIPBASE)
+    {
+      return zipfs_xipbase(filep, (FAR uintptr_t *)arg, &size);
+    }
+
+  return -ENOTTY;
+}
+
+static int zipfs_mmap(FAR struct file *filep,
+                      FAR struct mm_map_entry_s *map)
+{
+  uintptr_t xipbase;
+  ZPOS64_T size;
+
+  /* Map the stored entries in place, let the caller copy the others into
+   * RAM.
+   */
+
+  if (zipfs_xipbase(filep, &xipbase, &size) >= 0 && map->offset >= 0 &&
+      map->length != 0 && map->offset + map->length <= size)
+    {
+      map->vaddr = (FAR void *)(xipbase + map->offset);
+      return OK;
+    }
+
+  return -ENOTTY;
+}
+
 static int zipfs_dup(FAR const struct file *oldp, FAR struct file *newp)
 {
   FAR struct zipfs_file_s *fp;
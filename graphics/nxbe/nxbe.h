@@ -31,6 +31,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <time.h>
 
 #include <nuttx/nx/nx.h>
 #include <nuttx/nx/nxglib.h>
@@ -49,6 +50,14 @@
 #define NX_CLIPORDER_BRLT    (3)   /* Bottom-right-left-top */
 #define NX_CLIPORDER_DEFAULT NX_CLIPORDER_TLRB
 
+/* The framebuffer driver may do the fills and bitmaps with a 2D
+ * accelerator.
+ */
+
+#if defined(CONFIG_FB_ACCEL) && !defined(CONFIG_NX_LCDDRIVER)
+#  define NXBE_HAVE_ACCEL 1
+#endif
+
 /* Server flags and helper macros:
  *
  * NXBE_STATE_MODAL  - One window is in a focused, modal state
@@ -177,6 +186,14 @@ struct nxbe_plane_s
 
   NX_DRIVERTYPE *driver;
   NX_PLANEINFOTYPE pinfo;
+
+#ifdef CONFIG_NX_UPDATE_COALESCE
+  /* The updated rectangles not flushed yet, and the time to flush them */
+
+  struct nxgl_rect_s update[CONFIG_NX_UPDATE_NRECTS];
+  uint8_t nupdate;
+  struct timespec flushtime;
+#endif
 };
 
 /* Clipping *****************************************************************/
@@ -307,13 +324,43 @@ int nxbe_colormap(FAR NX_DRIVERTYPE *dev);
  *   interface.  This is the function that will handle the notification.  It
  *   receives the rectangular region that was updated on the provided plane.
  *
+ *   With CONFIG_NX_UPDATE_COALESCE, the rectangle is only collected, and
+ *   the notification is done by nxbe_update_flush().
+ *
  ****************************************************************************/
 
 #ifdef CONFIG_NX_UPDATE
-void nxbe_notify_rectangle(FAR NX_DRIVERTYPE *dev,
+void nxbe_notify_rectangle(FAR struct nxbe_plane_s *plane,
                            FAR const struct nxgl_rect_s *rect);
 #endif
 
+/****************************************************************************
+ * Name: nxbe_update_pending
+ *
+ * Description:
+ *   Check if there are updated rectangles not flushed yet, and return the
+ *   time when they are to be flushed.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_UPDATE_COALESCE
+bool nxbe_update_pending(FAR struct nxbe_state_s *be,
+                         FAR struct timespec *flushtime);
+#endif
+
+/****************************************************************************
+ * Name: nxbe_update_flush
+ *
+ * Description:
+ *   Notify the updated rectangles collected by nxbe_notify_rectangle()
+ *   to the driver.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_UPDATE_COALESCE
+void nxbe_update_flush(FAR struct nxbe_state_s *be);
+#endif
+
 /****************************************************************************
  * Name: nx_configure
  *
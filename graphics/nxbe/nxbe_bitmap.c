@@ -63,16 +63,34 @@ static void bitmap_clipcopy(FAR struct nxbe_clipops_s *cops,
                             FAR const struct nxgl_rect_s *rect)
 {
   struct nx_bitmap_s *bminfo = (struct nx_bitmap_s *)cops;
+#ifdef NXBE_HAVE_ACCEL
+  FAR const uint8_t *src;
+  struct fb_area_s area;
 
-  /* Copy the rectangular region to the graphics device. */
+  /* Let the 2D accelerator of the device copy the rectangle, if any.  The
+   * source of the pixels of less than a byte may not start on a byte.
+   */
+
+  nxgl_rect2area(&area, rect);
+  src = (FAR const uint8_t *)bminfo->src +
+        (rect->pt1.y - bminfo->origin.y) * bminfo->stride +
+        (rect->pt1.x - bminfo->origin.x) * (plane->pinfo.bpp >> 3);
+
+  if (plane->pinfo.bpp < 8 || plane->driver->copyarea == NULL ||
+      plane->driver->copyarea(plane->driver, &plane->pinfo, &area, src,
+                              bminfo->stride) < 0)
+#endif
+    {
+      /* Copy the rectangular region to the graphics device. */
 
-  plane->dev.copyrectangle(&plane->pinfo, rect, bminfo->src,
-                           &bminfo->origin, bminfo->stride);
+      plane->dev.copyrectangle(&plane->pinfo, rect, bminfo->src,
+                               &bminfo->origin, bminfo->stride);
+    }
 
 #ifdef CONFIG_NX_UPDATE
   /* Notify external logic that the display has been updated */
 
-  nxbe_notify_rectangle(plane->driver, rect);
+  nxbe_notify_rectangle(plane, rect);
 #endif
 }
 
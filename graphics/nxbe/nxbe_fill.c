@@ -61,15 +61,26 @@ static void nxbe_clipfill(FAR struct nxbe_clipops_s *cops,
                           FAR const struct nxgl_rect_s *rect)
 {
   struct nxbe_fill_s *fillinfo = (struct nxbe_fill_s *)cops;
+#ifdef NXBE_HAVE_ACCEL
+  struct fb_area_s area;
 
-  /* Draw the rectangle to the graphics device. */
+  /* Let the 2D accelerator of the device fill the rectangle, if any */
 
-  plane->dev.fillrectangle(&plane->pinfo, rect, fillinfo->color);
+  nxgl_rect2area(&area, rect);
+  if (plane->driver->fillarea == NULL ||
+      plane->driver->fillarea(plane->driver, &plane->pinfo, &area,
+                              fillinfo->color) < 0)
+#endif
+    {
+      /* Draw the rectangle to the graphics device. */
+
+      plane->dev.fillrectangle(&plane->pinfo, rect, fillinfo->color);
+    }
 
 #ifdef CONFIG_NX_UPDATE
   /* Notify external logic that the display has been updated */
 
-  nxbe_notify_rectangle(plane->driver, rect);
+  nxbe_notify_rectangle(plane, rect);
 #endif
 }
 
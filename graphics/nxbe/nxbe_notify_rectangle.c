@@ -26,10 +26,34 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
+#include <time.h>
+
+#include <nuttx/clock.h>
 #include <nuttx/nx/nxglib.h>
 
 #include "nxbe.h"
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxbe_update_size
+ *
+ * Description:
+ *   Return the number of pixels in the rectangle.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_UPDATE_COALESCE
+static uint32_t nxbe_update_size(FAR const struct nxgl_rect_s *rect)
+{
+  return (uint32_t)(rect->pt2.x - rect->pt1.x + 1) *
+         (uint32_t)(rect->pt2.y - rect->pt1.y + 1);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -53,15 +77,152 @@
  *   interface.  This is the function that will handle the notification.  It
  *   receives the rectangular region that was updated on the provided plane.
  *
+ *   With CONFIG_NX_UPDATE_COALESCE, the rectangle is merged with each of
+ *   the collected rectangles whose union has no more pixels than the two
+ *   of them, or else added to them.  If there is no room left, it is
+ *   merged with the rectangle that grows the least.
+ *
  ****************************************************************************/
 
-#ifdef CONFIG_NX_UPDATE
-void nxbe_notify_rectangle(FAR NX_DRIVERTYPE *dev,
+void nxbe_notify_rectangle(FAR struct nxbe_plane_s *plane,
                            FAR const struct nxgl_rect_s *rect)
 {
+#ifdef CONFIG_NX_UPDATE_COALESCE
+  struct nxgl_rect_s merged;
+  struct nxgl_rect_s rectunion;
+  struct timespec period;
+  uint32_t growth;
+  uint32_t least;
+  int best;
+  int i;
+
+  if (nxgl_nullrect(rect))
+    {
+      return;
+    }
+
+  /* The first update of a frame sets the time to flush the frame */
+
+  if (plane->nupdate == 0)
+    {
+      clock_gettime(CLOCK_REALTIME, &plane->flushtime);
+      clock_ticks2time(&period, MSEC2TICK(CONFIG_NX_UPDATE_PERIOD));
+      clock_timespec_add(&plane->flushtime, &period, &plane->flushtime);
+    }
+
+  /* Absorb the collected rectangles that are cheaper to send merged.  The
+   * search starts over each time, as the merged rectangle has grown.
+   */
+
+  nxgl_rectcopy(&merged, rect);
+
+  i = 0;
+  while (i < plane->nupdate)
+    {
+      nxgl_rectunion(&rectunion, &plane->update[i], &merged);
+      if (nxbe_update_size(&rectunion) <=
+          nxbe_update_size(&plane->update[i]) + nxbe_update_size(&merged))
+        {
+          nxgl_rectcopy(&merged, &rectunion);
+          plane->nupdate--;
+          nxgl_rectcopy(&plane->update[i], &plane->update[plane->nupdate]);
+          i = 0;
+        }
+      else
+        {
+          i++;
+        }
+    }
+
+  if (plane->nupdate < CONFIG_NX_UPDATE_NRECTS)
+    {
+      nxgl_rectcopy(&plane->update[plane->nupdate], &merged);
+      plane->nupdate++;
+      return;
+    }
+
+  /* No room left, merge with the rectangle that grows the least */
+
+  best  = 0;
+  least = UINT32_MAX;
+
+  for (i = 0; i < plane->nupdate; i++)
+    {
+      nxgl_rectunion(&rectunion, &plane->update[i], &merged);
+      growth = nxbe_update_size(&rectunion) -
+               nxbe_update_size(&plane->update[i]);
+      if (growth < least)
+        {
+          least = growth;
+          best  = i;
+        }
+    }
+
+  nxgl_rectunion(&plane->update[best], &plane->update[best], &merged);
+#else
   struct fb_area_s area;
 
   nxgl_rect2area(&area, rect);
-  dev->updatearea(dev, &area);
+  plane->driver->updatearea(plane->driver, &area);
+#endif
+}
+
+/****************************************************************************
+ * Name: nxbe_update_pending
+ *
+ * Description:
+ *   Check if there are updated rectangles not flushed yet, and return the
+ *   time when they are to be flushed.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_UPDATE_COALESCE
+bool nxbe_update_pending(FAR struct nxbe_state_s *be,
+                         FAR struct timespec *flushtime)
+{
+  bool pending = false;
+  int i;
+
+  for (i = 0; i < be->vinfo.nplanes; i++)
+    {
+      if (be->plane[i].nupdate > 0 &&
+          (!pending ||
+           clock_timespec_compare(&be->plane[i].flushtime, flushtime) < 0))
+        {
+          *flushtime = be->plane[i].flushtime;
+          pending    = true;
+        }
+    }
+
+  return pending;
+}
+
+/****************************************************************************
+ * Name: nxbe_update_flush
+ *
+ * Description:
+ *   Notify the updated rectangles collected by nxbe_notify_rectangle()
+ *   to the driver.
+ *
+ ****************************************************************************/
+
+void nxbe_update_flush(FAR struct nxbe_state_s *be)
+{
+  FAR struct nxbe_plane_s *plane;
+  struct fb_area_s area;
+  int i;
+  int j;
+
+  for (i = 0; i < be->vinfo.nplanes; i++)
+    {
+      plane = &be->plane[i];
+      for (j = 0; j < plane->nupdate; j++)
+        {
+          nxgl_rect2area(&area, &plane->update[j]);
+          plane->driver->updatearea(plane->driver, &area);
+        }
+
+      plane->nupdate = 0;
+    }
 }
 #endif
@@ -69,7 +69,7 @@ static void nxbe_clipfill(FAR struct nxbe_clipops_s *cops,
 #ifdef CONFIG_NX_UPDATE
   /* Notify external logic that the display has been updated */
 
-  nxbe_notify_rectangle(plane->driver, rect);
+  nxbe_notify_rectangle(plane, rect);
 #endif
 }
 
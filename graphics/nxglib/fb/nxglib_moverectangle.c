@@ -82,7 +82,7 @@ static inline void nxgl_lowresmemcpy(FAR uint8_t *dline,
 
   if (lnlen > 0)
     {
-      NXGL_MEMCPY(dptr, sptr, lnlen);
+      NXGL_MEMMOVE(dptr, sptr, lnlen);
     }
 }
 #endif
@@ -182,7 +182,7 @@ void NXGL_FUNCNAME(nxgl_moverectangle, NXGLIB_SUFFIX)
 #if NXGLIB_BITSPERPIXEL < 8
           nxgl_lowresmemcpy(dline, sline, width, leadmask, tailmask);
 #else
-          NXGL_MEMCPY(dline, sline, width);
+          NXGL_MEMMOVE(dline, sline, width);
 #endif
           /* Point to the next source/dest row below the current one */
 
@@ -221,7 +221,7 @@ void NXGL_FUNCNAME(nxgl_moverectangle, NXGLIB_SUFFIX)
 #if NXGLIB_BITSPERPIXEL < 8
           nxgl_lowresmemcpy(dline, sline, width, leadmask, tailmask);
 #else
-          NXGL_MEMCPY(dline, sline, width);
+          NXGL_MEMMOVE(dline, sline, width);
 #endif
         }
     }
@@ -30,6 +30,7 @@
 #include <nuttx/config.h>
 
 #include <stdint.h>
+#include <string.h>
 
 #include <nuttx/nx/nxglib.h>
 
@@ -107,25 +108,7 @@
 #  define NXGL_ALIGNUP(x)          (((x) + NXGL_PIXELMASK) & ~NXGL_PIXELMASK)
 
 #  define NXGL_MEMSET(dest,value,width) \
-   { \
-     FAR uint8_t *_ptr = (FAR uint8_t*)(dest); \
-     int        _nby = NXGL_SCALEX(width); \
-     while (_nby--) \
-       { \
-         *_ptr++ = (value); \
-       } \
-   }
-
-#  define NXGL_MEMCPY(dest,src,width) \
-   { \
-     FAR uint8_t *_dptr = (FAR uint8_t*)(dest); \
-     FAR uint8_t *_sptr = (FAR uint8_t*)(src); \
-     int        _nby  = NXGL_SCALEX(width); \
-     while (_nby--) \
-       { \
-         *_dptr++ = *_sptr++; \
-       } \
-   }
+     memset((dest), (value), NXGL_SCALEX(width))
 
 #elif NXGLIB_BITSPERPIXEL == 24
 
@@ -141,19 +124,6 @@
        } \
    }
 
-#  define NXGL_MEMCPY(dest,src,width) \
-   { \
-     FAR uint8_t *_dptr = (FAR uint8_t*)(dest); \
-     FAR uint8_t *_sptr = (FAR uint8_t*)(src); \
-     nxgl_coord_t _npix = (width); \
-     while (_npix--) \
-       { \
-         *_dptr++ = *_sptr++; \
-         *_dptr++ = *_sptr++; \
-         *_dptr++ = *_sptr++; \
-       } \
-   }
-
 #ifdef CONFIG_NX_ANTIALIASING
 
 #  define NXGL_BLEND(dest,color1,frac) \
@@ -171,28 +141,48 @@
    }
 
 #endif /* CONFIG_NX_ANTIALIASING */
-#else /* NXGLIB_BITSPERPIXEL == 16 || NXGLIB_BITSPERPIXEL == 32 */
+#else /* NXGLIB_BITSPERPIXEL == 8, 16 or 32 */
 
-#  define NXGL_MEMSET(dest,value,width) \
+#  if NXGLIB_BITSPERPIXEL == 8
+#    define NXGL_MEMSET(dest,value,width) \
+       memset((dest), (value), (width))
+
+#  elif NXGLIB_BITSPERPIXEL == 16
+/* Fill two pixels per 32-bit store once the destination is aligned */
+
+#    define NXGL_MEMSET(dest,value,width) \
    { \
-     FAR NXGL_PIXEL_T *_ptr = (FAR NXGL_PIXEL_T*)(dest); \
-     nxgl_coord_t     _npix = (width); \
-     while (_npix--) \
+     FAR uint16_t *_ptr  = (FAR uint16_t *)(dest); \
+     FAR uint32_t *_wptr; \
+     nxgl_coord_t  _npix = (width); \
+     uint32_t      _wide = (uint16_t)(value) * 0x00010001u; \
+     if (_npix > 0 && ((uintptr_t)_ptr & 2) != 0) \
        { \
-         *_ptr++ = (value); \
+         *_ptr++ = (uint16_t)(value); \
+         _npix--; \
+       } \
+     _wptr = (FAR uint32_t *)_ptr; \
+     for (; _npix >= 2; _npix -= 2) \
+       { \
+         *_wptr++ = _wide; \
+       } \
+     if (_npix > 0) \
+       { \
+         *(FAR uint16_t *)_wptr = (uint16_t)(value); \
        } \
    }
 
-#  define NXGL_MEMCPY(dest,src,width) \
+#  else
+#    define NXGL_MEMSET(dest,value,width) \
    { \
-     FAR NXGL_PIXEL_T *_dptr = (FAR NXGL_PIXEL_T*)(dest); \
-     FAR NXGL_PIXEL_T *_sptr = (FAR NXGL_PIXEL_T*)(src); \
-     nxgl_coord_t      _npix = (width); \
+     FAR NXGL_PIXEL_T *_ptr = (FAR NXGL_PIXEL_T*)(dest); \
+     nxgl_coord_t     _npix = (width); \
      while (_npix--) \
        { \
-         *_dptr++ = *_sptr++; \
+         *_ptr++ = (value); \
        } \
    }
+#  endif
 
 #ifdef CONFIG_NX_ANTIALIASING
 
@@ -206,6 +196,17 @@
 #endif /* CONFIG_NX_ANTIALIASING */
 #endif /* NXGLIB_BITSPERPIXEL */
 
+/* Copy the bytes of a run of pixels.  These go through the C library, which
+ * may have a version optimized for the architecture.  NXGL_MEMMOVE is for
+ * the runs that may overlap, when a rectangle is moved in the same rows.
+ */
+
+#define NXGL_MEMCPY(dest,src,width) \
+  memcpy((dest), (src), NXGL_SCALEX(width))
+
+#define NXGL_MEMMOVE(dest,src,width) \
+  memmove((dest), (src), NXGL_SCALEX(width))
+
 /* Form a function name by concatenating two strings */
 
 #define _NXGL_FUNCNAME(a,b) a ## b
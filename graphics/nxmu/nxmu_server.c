@@ -30,12 +30,14 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <string.h>
+#include <time.h>
 #include <mqueue.h>
 #include <fcntl.h>
 #include <assert.h>
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/mqueue.h>
 #include <nuttx/nx/nx.h>
 
@@ -272,6 +274,10 @@ int nx_runinstance(FAR const char *mqname, FAR NX_DRIVERTYPE *dev)
   struct nxmu_state_s    nxmu;
   FAR struct nxsvrmsg_s *msg;
   char                   buffer[NX_MXSVRMSGLEN];
+#ifdef CONFIG_NX_UPDATE_COALESCE
+  struct timespec        flushtime;
+  struct timespec        now;
+#endif
   int                    nbytes;
   int                    ret;
 
@@ -297,12 +303,37 @@ int nx_runinstance(FAR const char *mqname, FAR NX_DRIVERTYPE *dev)
 
   for (; ; )
     {
-      /* Receive the next server message */
+#ifdef CONFIG_NX_UPDATE_COALESCE
+      /* Flush the display updates when the frame period is over, else wait
+       * for the next server message until then.
+       */
+
+      if (nxbe_update_pending(&nxmu.be, &flushtime))
+        {
+          clock_gettime(CLOCK_REALTIME, &now);
+          if (clock_timespec_compare(&now, &flushtime) < 0)
+            {
+              nbytes = nxmq_timedreceive(nxmu.conn.crdmq, buffer,
+                                         NX_MXSVRMSGLEN, 0, &flushtime);
+            }
+          else
+            {
+              nxbe_update_flush(&nxmu.be);
+              nbytes = nxmq_receive(nxmu.conn.crdmq, buffer,
+                                    NX_MXSVRMSGLEN, 0);
+            }
+        }
+      else
+#endif
+        {
+          /* Receive the next server message */
+
+          nbytes = nxmq_receive(nxmu.conn.crdmq, buffer, NX_MXSVRMSGLEN, 0);
+        }
 
-      nbytes = nxmq_receive(nxmu.conn.crdmq, buffer, NX_MXSVRMSGLEN, 0);
       if (nbytes < 0)
         {
-          if (nbytes != -EINTR)
+          if (nbytes != -EINTR && nbytes != -ETIMEDOUT)
             {
               gerr("ERROR: nxmq_receive() failed: %d\n", nbytes);
               ret = nbytes;
@@ -49,6 +49,22 @@
 #define BMFLAGS_NOGLYPH    (1 << 0) /* No glyph available, use space */
 #define BM_ISSPACE(bm)     (((bm)->flags & BMFLAGS_NOGLYPH) != 0)
 
+/* Font cache size.  With CONFIG_NXTERM_CACHEASCII the cache holds at least
+ * all of the printable ASCII glyphs, which are rendered when the driver is
+ * registered.
+ */
+
+#define NXTERM_ASCII_FIRST 0x20
+#define NXTERM_ASCII_LAST  0x7e
+#define NXTERM_ASCII_NCODES (NXTERM_ASCII_LAST - NXTERM_ASCII_FIRST + 1)
+
+#if defined(CONFIG_NXTERM_CACHEASCII) && \
+    CONFIG_NXTERM_CACHESIZE < NXTERM_ASCII_NCODES
+#  define NXTERM_CACHESIZE NXTERM_ASCII_NCODES
+#else
+#  define NXTERM_CACHESIZE CONFIG_NXTERM_CACHESIZE
+#endif
+
 /* Device path formats */
 
 #define NX_DEVNAME_FORMAT  "/dev/nxterm%d"
@@ -55,6 +55,9 @@ FAR struct nxterm_state_s *
   FAR const struct nx_font_s *fontset;
   char devname[NX_DEVNAME_SIZE];
   NXHANDLE hfont;
+#ifdef CONFIG_NXTERM_CACHEASCII
+  int ch;
+#endif
   int ret;
 
   DEBUGASSERT(handle && wndo && ops && (unsigned)minor < 256);
@@ -89,7 +92,7 @@ FAR struct nxterm_state_s *
 
   priv->fcache = nxf_cache_connect(wndo->fontid, wndo->fcolor[0],
                                    wndo->wcolor[0], CONFIG_NXTERM_BPP,
-                                   CONFIG_NXTERM_CACHESIZE);
+                                   NXTERM_CACHESIZE);
   if (priv->fcache == NULL)
     {
       gerr("ERROR: Failed to connect to font cache for font ID %d: %d\n",
@@ -116,6 +119,18 @@ FAR struct nxterm_state_s *
   priv->fwidth    = fontset->mxwidth;
   priv->spwidth   = fontset->spwidth;
 
+#ifdef CONFIG_NXTERM_CACHEASCII
+  /* Render the printable ASCII glyphs now so that writing text never has
+   * to render them again.  If the font cache is shared with another
+   * console, they are already there.
+   */
+
+  for (ch = NXTERM_ASCII_FIRST; ch <= NXTERM_ASCII_LAST; ch++)
+    {
+      nxf_cache_getglyph(priv->fcache, ch);
+    }
+#endif
+
   /* Set up the text cache */
 
   priv->maxchars  = CONFIG_NXTERM_MXCHARS;
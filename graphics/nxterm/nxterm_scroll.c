@@ -170,48 +170,39 @@ static inline void nxterm_movedisplay(FAR struct nxterm_state_s *priv,
 
 void nxterm_scroll(FAR struct nxterm_state_s *priv, int scrollheight)
 {
+  FAR struct nxterm_bitmap_s *bm;
   int i;
   int j;
 
-  /* Adjust the vertical position of each character */
+  /* Adjust the vertical position of each character.  The characters that
+   * are kept are compacted toward the beginning of the array in one pass.
+   */
 
-  for (i = 0; i < priv->nchars; )
+  for (i = 0, j = 0; i < priv->nchars; i++)
     {
-      FAR struct nxterm_bitmap_s *bm = &priv->bm[i];
+      bm = &priv->bm[i];
 
       /* Has any part of this character scrolled off the screen? */
 
-      if (bm->pos.y < scrollheight + CONFIG_NXTERM_LINESEPARATION)
+      if (bm->pos.y >= scrollheight + CONFIG_NXTERM_LINESEPARATION)
         {
-          /* Yes... Delete the character by moving all of the data */
+          /* No.. decrement its vertical position (moving it "up" the
+           * display by one line) and keep it.
+           */
 
-          for (j = i; j < priv->nchars - 1; j++)
+          bm->pos.y -= scrollheight;
+          if (j != i)
             {
-              memcpy(&priv->bm[j], &priv->bm[j + 1],
-                     sizeof(struct nxterm_bitmap_s));
+              memcpy(&priv->bm[j], bm, sizeof(struct nxterm_bitmap_s));
             }
 
-          /* Decrement the number of cached characters ('i' is not
-           * incremented in this case because it already points to the next
-           * character)
-           */
-
-          priv->nchars--;
+          j++;
         }
+    }
 
-      /* No.. just decrement its vertical position (moving it "up" the
-       * display by one line).
-       */
-
-      else
-        {
-          bm->pos.y -= scrollheight;
-
-          /* We are keeping this one so increment to the next character */
+  /* Decrement the number of cached characters by the number deleted */
 
-          i++;
-        }
-    }
+  priv->nchars = j;
 
   /* And move the next display position up by one line as well */
 
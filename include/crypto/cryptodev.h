@@ -366,6 +366,42 @@ struct crypt_op
   caddr_t aad;
 };
 
+/* ioctl parameter to submit a batch of operations.  The operations are
+ * run asynchronously, the buffers they point to must stay valid until
+ * their results are got by CIOCNCRYPTRETM.  POLLIN tells that results
+ * are ready.
+ */
+
+struct crypt_n_op
+{
+  struct crypt_op cop;
+  FAR void *opaque;   /* passed back with the result */
+
+  uint32_t reqid;     /* returns: id of the request */
+  int status;         /* returns: zero if queued, or a negated errno */
+};
+
+struct crypt_mop
+{
+  size_t count;       /* number of the operations */
+  FAR struct crypt_n_op *reqs;
+};
+
+/* ioctl parameter to get the results of the submitted operations */
+
+struct crypt_result
+{
+  uint32_t reqid;     /* id of the request */
+  int status;         /* result of the operation, or a negated errno */
+  FAR void *opaque;   /* as submitted */
+};
+
+struct crypt_ret
+{
+  size_t count;       /* room of results, returns: the results got */
+  FAR struct crypt_result *results;
+};
+
 /* hamc buffer, software & hardware need it */
 
 extern const uint8_t hmac_ipad_buffer[HMAC_MAX_BLOCK_LEN];
@@ -387,6 +423,8 @@ extern const uint8_t hmac_opad_buffer[HMAC_MAX_BLOCK_LEN];
 #define CIOCKEY                 104
 #define CIOCKEYRET              105
 #define CIOCASYMFEAT            106
+#define CIOCNCRYPTM             107
+#define CIOCNCRYPTRETM          108
 
 int crypto_newsession(FAR uint64_t *, FAR struct cryptoini *, int);
 int crypto_freesession(uint64_t);
@@ -43,6 +43,10 @@
 #include <syslog.h>
 #include <sys/uio.h>
 
+#ifdef CONFIG_SYSLOG_TOKENIZED_DEBUG
+#  include <nuttx/syslog/syslog_token.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -114,6 +118,14 @@
  * (Currently only if the pre-processor supports variadic macros)
  */
 
+/* The arguments are expanded once more, so that EXTRA_ARG splits into
+ * arguments of syslog_token().
+ */
+
+#if !defined(__arch_syslog) && defined(CONFIG_SYSLOG_TOKENIZED_DEBUG)
+#  define __arch_syslog(...) syslog_token(__VA_ARGS__)
+#endif
+
 #ifndef __arch_syslog
 #  define __arch_syslog syslog
 #endif
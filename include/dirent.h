@@ -30,6 +30,7 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <sys/stat.h>
 #include <stdint.h>
 #include <limits.h>
 
@@ -116,6 +117,18 @@ struct dirent
   char     d_name[NAME_MAX + 1];  /* File name */
 };
 
+/* The entry returned by the non-standard readdirplus(): the directory
+ * entry together with the attributes of the file, as stat() would return
+ * them.  The file systems that support it read both at once, instead of
+ * looking up the path of each entry again.
+ */
+
+struct direntplus
+{
+  struct dirent d_entry;          /* The directory entry */
+  struct stat   d_stat;           /* The attributes of the file */
+};
+
 typedef struct
 {
   int fd;
@@ -161,6 +174,9 @@ int        versionsort(FAR const struct dirent **a,
 
 int        dirfd(FAR DIR *dirp);
 
+ssize_t    getdents(int fd, FAR void *buf, size_t nbytes);
+int        readdirplus(FAR DIR *dirp, FAR struct direntplus *entry);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
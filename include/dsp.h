@@ -526,6 +526,25 @@ void svm3(FAR struct svm3_state_f32_s *s, FAR ab_frame_f32_t *ab);
 void svm3_current_correct(FAR struct svm3_state_f32_s *s,
                           FAR float *c0, FAR float *c1, FAR float *c2);
 
+#ifdef CONFIG_LIBDSP_BATCH
+/* Batch kernels, n frames or n controllers at once */
+
+void clarke_transform_batch(FAR const abc_frame_f32_t *abc,
+                            FAR ab_frame_f32_t *ab, size_t n);
+void inv_clarke_transform_batch(FAR const ab_frame_f32_t *ab,
+                                FAR abc_frame_f32_t *abc, size_t n);
+void park_transform_batch(FAR const phase_angle_f32_t *angle,
+                          FAR const ab_frame_f32_t *ab,
+                          FAR dq_frame_f32_t *dq, size_t n);
+void inv_park_transform_batch(FAR const phase_angle_f32_t *angle,
+                              FAR const dq_frame_f32_t *dq,
+                              FAR ab_frame_f32_t *ab, size_t n);
+void svm3_batch(FAR struct svm3_state_f32_s *s,
+                FAR const ab_frame_f32_t *v_ab, size_t n);
+void pi_controller_batch(FAR pid_controller_f32_t *pid,
+                         FAR const float *err, FAR float *out, size_t n);
+#endif
+
 /* Field Oriented Control */
 
 void foc_init(FAR struct foc_data_f32_s *foc,
@@ -57,5 +57,7 @@
 #define TCP_KEEPCNT   (__SO_PROTOCOL + 3) /* Number of keepalives before death
                                            * Argument: max retry count */
 #define TCP_MAXSEG    (__SO_PROTOCOL + 4) /* The maximum segment size */
+#define TCP_QUICKACK  (__SO_PROTOCOL + 5) /* Don't delay the ACKs
+                                           * Argument: int */
 
 #endif /* __INCLUDE_NETINET_TCP_H */
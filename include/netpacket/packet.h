@@ -31,9 +31,46 @@
 #include <stdint.h>
 
 /****************************************************************************
- * Public Types
+ * Pre-processor Definitions
  ****************************************************************************/
 
+/* Packet socket options, level SOL_PACKET */
+
+#define PACKET_RX_RING        5  /* struct tpacket_req3 of the RX ring */
+#define PACKET_STATISTICS     6  /* Get and reset struct tpacket_stats_v3 */
+#define PACKET_VERSION        10 /* Header version of the rings, TPACKET_V3 */
+#define PACKET_TX_RING        13 /* struct tpacket_req3 of the TX ring */
+
+/* Header versions, only TPACKET_V3 is supported */
+
+#define TPACKET_V1            0
+#define TPACKET_V2            1
+#define TPACKET_V3            2
+
+/* RX status of a block, owned by the kernel or the user */
+
+#define TP_STATUS_KERNEL      0
+#define TP_STATUS_USER        (1 << 0)
+#define TP_STATUS_LOSING      (1 << 2) /* Frames were dropped before it */
+#define TP_STATUS_BLK_TMO     (1 << 5) /* Retired by the timeout */
+
+/* TX status of a frame */
+
+#define TP_STATUS_AVAILABLE     0
+#define TP_STATUS_SEND_REQUEST  (1 << 0)
+#define TP_STATUS_SENDING       (1 << 1)
+#define TP_STATUS_WRONG_FORMAT  (1 << 2)
+
+#define TP_STATUS_TS_SOFTWARE (1 << 29)
+
+#define TPACKET_ALIGNMENT     16
+#define TPACKET_ALIGN(x)      (((x) + TPACKET_ALIGNMENT - 1) & \
+                               ~(TPACKET_ALIGNMENT - 1))
+
+/* Offset of the frame data in a TX ring frame */
+
+#define TPACKET3_HDRLEN       TPACKET_ALIGN(sizeof(struct tpacket3_hdr))
+
 struct sockaddr_ll
 {
   unsigned short sll_family;
@@ -45,4 +82,98 @@ struct sockaddr_ll
   unsigned char  sll_addr[8];
 };
 
+/* The rings of a packet socket, set up by PACKET_RX_RING / PACKET_TX_RING
+ * and then mapped by mmap() of the socket, the RX ring first, the TX ring
+ * after it.
+ *
+ * The RX ring is made of tp_block_nr blocks of tp_block_size bytes.  The
+ * kernel fills one block at a time with frames, each one a struct
+ * tpacket3_hdr followed by the frame at tp_mac, and hands it to the user
+ * by setting TP_STATUS_USER in block_status when it is full or
+ * tp_retire_blk_tov milliseconds after its first frame.  The user gives
+ * it back by setting TP_STATUS_KERNEL.
+ *
+ * The TX ring is made of tp_frame_nr frames of tp_frame_size bytes.  The
+ * user writes a frame at TPACKET3_HDRLEN, its length to tp_len, sets
+ * TP_STATUS_SEND_REQUEST and calls send() with no data.  The kernel sends
+ * the requested frames in order and sets them TP_STATUS_AVAILABLE again.
+ */
+
+struct tpacket_req3
+{
+  unsigned int tp_block_size;      /* Minimal size of a block */
+  unsigned int tp_block_nr;        /* Number of blocks */
+  unsigned int tp_frame_size;      /* Size of a TX frame */
+  unsigned int tp_frame_nr;        /* Total number of TX frames */
+  unsigned int tp_retire_blk_tov;  /* RX block timeout in msec */
+  unsigned int tp_sizeof_priv;     /* Size of the private area of a block */
+  unsigned int tp_feature_req_word;
+};
+
+struct tpacket_stats_v3
+{
+  unsigned int tp_packets;
+  unsigned int tp_drops;
+  unsigned int tp_freeze_q_cnt;
+};
+
+struct tpacket_bd_ts
+{
+  unsigned int ts_sec;
+  union
+  {
+    unsigned int ts_usec;
+    unsigned int ts_nsec;
+  };
+};
+
+struct tpacket_hdr_v1
+{
+  uint32_t block_status;
+  uint32_t num_pkts;
+  uint32_t offset_to_first_pkt;
+  uint32_t blk_len;
+  uint64_t seq_num;
+  struct tpacket_bd_ts ts_first_pkt;
+  struct tpacket_bd_ts ts_last_pkt;
+};
+
+union tpacket_bd_header_u
+{
+  struct tpacket_hdr_v1 bh1;
+};
+
+struct tpacket_block_desc
+{
+  uint32_t version;
+  uint32_t offset_to_priv;
+  union tpacket_bd_header_u hdr;
+};
+
+struct tpacket_hdr_variant1
+{
+  uint32_t tp_rxhash;
+  uint32_t tp_vlan_tci;
+  uint16_t tp_vlan_tpid;
+  uint16_t tp_padding;
+};
+
+struct tpacket3_hdr
+{
+  uint32_t tp_next_offset;         /* Offset of the next frame, 0 if last */
+  uint32_t tp_sec;
+  uint32_t tp_nsec;
+  uint32_t tp_snaplen;             /* Bytes of the frame in the ring */
+  uint32_t tp_len;                 /* Length of the frame */
+  uint32_t tp_status;
+  uint16_t tp_mac;                 /* Offset of the link layer header */
+  uint16_t tp_net;                 /* Offset of the network header */
+  union
+  {
+    struct tpacket_hdr_variant1 hv1;
+  };
+
+  uint8_t tp_padding[8];
+};
+
 #endif /* __INCLUDE_NETPACKET_PACKET_H */
@@ -2266,6 +2266,53 @@ int16_t up_fetchsub16(FAR volatile int16_t *addr, int16_t value);
 int8_t up_fetchsub8(FAR volatile int8_t *addr, int8_t value);
 #endif
 
+/****************************************************************************
+ * Name: up_chksum
+ *
+ * Description:
+ *   Add the 16-bit big endian words of a buffer to a ones complement sum
+ *   (as used by the Internet checksum, see RFC 1071).  A trailing odd byte
+ *   is added as the upper half of a word.
+ *
+ *   This function must be provided via the architecture-specific logic if
+ *   CONFIG_ARCH_HAVE_CHKSUM is selected.
+ *
+ * Input Parameters:
+ *   sum  - The sum so far in host byte order
+ *   data - The data to add
+ *   len  - The length of the data in bytes
+ *
+ * Returned Value:
+ *   The updated sum in host byte order.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_HAVE_CHKSUM
+uint16_t up_chksum(uint16_t sum, FAR const uint8_t *data, uint16_t len);
+#endif
+
+/****************************************************************************
+ * Name: up_memcpy_nt
+ *
+ * Description:
+ *   Copy a buffer with non-temporal stores, so that a large copy doesn't
+ *   evict the working set of the other tasks from the data cache.  The
+ *   destination is not in the cache afterwards.
+ *
+ *   This function must be provided via the architecture-specific logic if
+ *   CONFIG_ARCH_HAVE_MEMCPY_NT is selected.
+ *
+ * Input Parameters:
+ *   dst - The destination, which must not overlap the source
+ *   src - The source
+ *   len - The length of the copy in bytes
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_HAVE_MEMCPY_NT
+void up_memcpy_nt(FAR void *dst, FAR const void *src, size_t len);
+#endif
+
 /****************************************************************************
  * Name: up_cpu_idlestack
  *
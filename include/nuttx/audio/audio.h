@@ -94,6 +94,21 @@
  * AUDIOIOC_STOP - Stop Audio streaming
  *
  *   ioctl argument:  None
+ *
+ * AUDIOIOC_SETRING - Set up (or, with nperiods 0, free) the period ring
+ *   that the application maps with mmap().  Not while the stream runs.
+ *
+ *   ioctl argument:  Pointer to the audio_ring_s structure
+ *
+ * AUDIOIOC_GETRINGPTR - Get the positions in the ring
+ *
+ *   ioctl argument:  Pointer to the audio_ringptr_s structure to receive
+ *                    the positions
+ *
+ * AUDIOIOC_SETRINGPTR - Set the application position in the ring: the
+ *   bytes written for playback, or read for capture, since START.
+ *
+ *   ioctl argument:  The new position
  */
 
 #define AUDIOIOC_GETCAPS            _AUDIOIOC(1)
@@ -117,6 +132,9 @@
 #define AUDIOIOC_GETLATENCY         _AUDIOIOC(19)
 #define AUDIOIOC_FLUSH              _AUDIOIOC(20)
 #define AUDIOIOC_GETPOSITION        _AUDIOIOC(21)
+#define AUDIOIOC_SETRING            _AUDIOIOC(22)
+#define AUDIOIOC_GETRINGPTR         _AUDIOIOC(23)
+#define AUDIOIOC_SETRINGPTR         _AUDIOIOC(24)
 
 /* Audio Device Types *******************************************************/
 
@@ -187,6 +205,7 @@
 #define AUDIO_SUBFMT_MIDI_2         0x12
 #define AUDIO_SUBFMT_AMRNB          0x13
 #define AUDIO_SUBFMT_AMRWB          0x14
+#define AUDIO_SUBFMT_PCM_F32_LE     0x15
 
 /* Audio Hardware-Format Types **********************************************/
 
@@ -475,6 +494,30 @@ struct ap_buffer_s
   FAR uint8_t           *samp;      /* Offset of the first sample */
 };
 
+#ifdef CONFIG_AUDIO_RING
+/* This structure describes the period ring set up by AUDIOIOC_SETRING.
+ * The ring is nperiods * period_bytes bytes, mapped at offset 0.
+ */
+
+struct audio_ring_s
+{
+  uint8_t     type;         /* AUDIO_TYPE_OUTPUT or AUDIO_TYPE_INPUT */
+  uint16_t    nperiods;     /* Number of periods, 2 at least */
+  apb_samp_t  period_bytes; /* Size of a period */
+};
+
+/* The positions in the ring, in bytes since START.  They wrap at 2^32,
+ * and the offset in the ring is the position modulo its size.
+ */
+
+struct audio_ringptr_s
+{
+  uint32_t    hwptr;        /* End of the periods done by the device */
+  uint32_t    applptr;      /* End of the data done by the application */
+  uint32_t    xruns;        /* Periods the device did before it */
+};
+#endif
+
 /* Structure defining the messages passed to a listening audio thread
  * for dequeuing buffers and other operations.  Also used to allocate
  * and enqueue buffers via the AUDIOIOC_ALLOCBUFFER, AUDIOIOC_FREEBUFFER,
@@ -0,0 +1,78 @@
+/****************************************************************************
+ * include/nuttx/audio/audio_mixer.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_AUDIO_AUDIO_MIXER_H
+#define __INCLUDE_NUTTX_AUDIO_AUDIO_MIXER_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#ifdef CONFIG_AUDIO_MIXER
+#include <nuttx/audio/audio.h>
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: audio_mixer_initialize
+ *
+ * Description:
+ *   Register nstreams playback devices, named name0, name1, ..., whose
+ *   streams are mixed into the output of the lower half audio driver.
+ *   Each stream has its own sample rate, sample format (16, 24 or 32 bits
+ *   or float), channel count and volume.  They are converted to the
+ *   CONFIG_AUDIO_MIXER_SAMPLERATE 16 bits stereo output of the mixer,
+ *   which only runs while one of the streams is started.
+ *
+ * Input Parameters:
+ *   name     - The prefix of the names of the audio devices.
+ *   nstreams - The number of streams.
+ *   lower    - The lower half audio driver that plays the mix.
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.  The devices
+ *   registered before a failure stay usable.
+ *
+ ****************************************************************************/
+
+int audio_mixer_initialize(FAR const char *name, int nstreams,
+                           FAR struct audio_lowerhalf_s *lower);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_AUDIO_MIXER */
+#endif /* __INCLUDE_NUTTX_AUDIO_AUDIO_MIXER_H */
@@ -367,6 +367,7 @@
 #define dev_send(dev,m)           (dev)->cd_ops->co_send(dev,m)
 #define dev_txready(dev)          (dev)->cd_ops->co_txready(dev)
 #define dev_txempty(dev)          (dev)->cd_ops->co_txempty(dev)
+#define dev_sendbatch(dev,m,n)    (dev)->cd_ops->co_sendbatch(dev,m,n)
 
 /* CAN message support ******************************************************/
 
@@ -628,22 +629,14 @@ begin_packed_struct struct can_msg_s
   uint8_t          cm_data[CAN_MAXDATALEN]; /* CAN message data (0-8 byte) */
 } end_packed_struct;
 
-/* This structure defines a CAN message FIFO. */
+/* This structure defines the CAN receive FIFO.  It is shared by all of the
+ * readers of the device: each message is stored once and every reader
+ * keeps its own position in it (see struct can_reader_s).
+ */
 
 struct can_rxfifo_s
 {
-  /* Binary semaphore. Indicates whether FIFO is available for reading
-   * AND not empty. Only take this sem inside a critical section to guarantee
-   * exclusive access to both the semaphore and the head/tail FIFO indices.
-   */
-
-  sem_t         rx_sem;
-
-#ifdef CONFIG_CAN_ERRORS
-  uint8_t       rx_error;                /* Flags to indicate internal device errors */
-#endif
-  uint8_t       rx_head;                 /* Index to the head [IN] in the circular buffer */
-  uint8_t       rx_tail;                 /* Index to the tail [OUT] in the circular buffer */
+  uint8_t       rx_tail;                 /* Index to the tail [IN] in the circular buffer */
                                          /* Circular buffer of CAN messages */
   struct can_msg_s rx_buffer[CONFIG_CAN_RXFIFOSIZE];
 };
@@ -786,6 +779,17 @@ struct can_ops_s
    */
 
   CODE bool (*co_txempty)(FAR struct can_dev_s *dev);
+
+  /* Optional.  Send up to nmsgs messages at once, e.g. by filling several
+   * elements of a H/W TX FIFO and starting them together.  Returns the
+   * number of messages accepted, which may be less than nmsgs if the
+   * hardware became full, or a negated errno value.  can_txdone() must not
+   * be called from within this method.  If NULL, co_send() is called for
+   * each message.
+   */
+
+  CODE int (*co_sendbatch)(FAR struct can_dev_s *dev,
+                           FAR struct can_msg_s **msgs, int nmsgs);
 };
 
 /* This is the device structure used by the driver.  The caller of
@@ -800,7 +804,19 @@ struct can_ops_s
 struct can_reader_s
 {
   struct list_node     list;
-  struct can_rxfifo_s  fifo;             /* Describes receive FIFO */
+
+  /* Binary semaphore. Indicates whether the reader has messages to read.
+   * Only take this sem inside a critical section to guarantee exclusive
+   * access to both the semaphore and the FIFO position of the reader.
+   */
+
+  sem_t                rx_sem;
+
+#ifdef CONFIG_CAN_ERRORS
+  uint8_t              rx_error;         /* Flags to indicate internal device errors */
+#endif
+  uint8_t              rx_head;          /* Index to the head [OUT] in cd_recv */
+  uint8_t              rx_count;         /* Number of messages not read yet */
 };
 
 struct can_transv_s
@@ -814,6 +830,7 @@ struct can_dev_s
   uint8_t              cd_npendrtr;      /* Number of pending RTR messages */
   volatile uint8_t     cd_ntxwaiters;    /* Number of threads waiting to enqueue a message */
   struct list_node     cd_readers;       /* List of readers */
+  struct can_rxfifo_s  cd_recv;          /* Describes receive FIFO */
   mutex_t              cd_closelock;     /* Locks out new opens while close is in progress */
   mutex_t              cd_polllock;      /* Manages exclusive access to cd_fds[] */
   struct can_txcache_s cd_sender;        /* Describes transmit cache */
@@ -312,6 +312,21 @@ typedef int64_t sclock_t;
 typedef int32_t sclock_t;
 #endif
 
+/* The clock state the kernel publishes to the user space at every tick.
+ * The sequence count is odd while the kernel updates the other fields, the
+ * reader retries until it reads the same even count before and after.
+ */
+
+#ifdef CONFIG_CLOCK_USERSPACE
+struct clock_user_s
+{
+  volatile uint32_t seq;       /* Sequence count */
+  volatile clock_t  ticks;     /* The system timer ticks */
+  volatile time_t   base_sec;  /* The time of day at tick zero */
+  volatile long     base_nsec;
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -332,6 +347,10 @@ extern "C"
  * access to kernel global data
  */
 
+#if defined(CONFIG_CLOCK_USERSPACE) && !defined(__KERNEL__)
+EXTERN struct clock_user_s g_clock_user;
+#endif
+
 #ifdef __HAVE_KERNEL_GLOBALS
 EXTERN volatile clock_t g_system_ticks;
 
@@ -0,0 +1,232 @@
+/****************************************************************************
+ * include/nuttx/coro.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_CORO_H
+#define __INCLUDE_NUTTX_CORO_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <nuttx/compiler.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <nuttx/queue.h>
+
+#ifdef CONFIG_LIBC_CORO
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Values returned by the body of a coroutine to the scheduler */
+
+#define CORO_READY      0  /* Yielded, run again in the next round */
+#define CORO_WAITING    1  /* Parked on a file descriptor or a timer */
+#define CORO_DONE       2  /* Finished, never run again */
+
+/* The coroutines are stackless: the body is a function that the scheduler
+ * calls again each time the coroutine is resumed, and that jumps back to
+ * where it suspended itself through the switch of CORO_BEGIN().  So the
+ * local variables of the body do not survive a suspension, the state kept
+ * across one must be in the structure that embeds struct coro_s, and the
+ * macros that suspend cannot be used inside another switch statement.
+ *
+ *   static int echo(FAR struct coro_s *coro)
+ *   {
+ *     FAR struct conn_s *conn = container_of(coro, struct conn_s, coro);
+ *
+ *     CORO_BEGIN(coro);
+ *     for (; ; )
+ *       {
+ *         CORO_WAIT_FD(coro, conn->fd, EPOLLIN, -1);
+ *         conn->len = read(conn->fd, conn->buf, sizeof(conn->buf));
+ *         if (conn->len <= 0)
+ *           {
+ *             break;
+ *           }
+ *
+ *         ...
+ *       }
+ *
+ *     coro_release_fd(coro);
+ *     close(conn->fd);
+ *     CORO_END(coro);
+ *   }
+ */
+
+#define CORO_BEGIN(c) \
+  switch ((c)->line) \
+    { \
+      case 0:
+
+#define CORO_END(c) \
+    } \
+  (c)->line = 0; \
+  return CORO_DONE
+
+/* Suspend with the state st, the body continues after the macro */
+
+#define CORO_SUSPEND(c, st) \
+  do \
+    { \
+      (c)->line = __LINE__; \
+      return (st); \
+      case __LINE__:; \
+    } \
+  while (0)
+
+/* Let the other ready coroutines run */
+
+#define CORO_YIELD(c)  CORO_SUSPEND(c, CORO_READY)
+
+/* Wait for the epoll events ev on fd, or for ms milliseconds if ms is not
+ * negative.  Then (c)->revents holds the events that came, 0 on timeout.
+ */
+
+#define CORO_WAIT_FD(c, fd, ev, ms) \
+  CORO_SUSPEND(c, coro_park_fd(c, fd, ev, ms))
+
+/* Sleep for ms milliseconds */
+
+#define CORO_SLEEP(c, ms) \
+  CORO_SUSPEND(c, coro_park_fd(c, -1, 0, ms))
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+struct coro_s;
+struct coro_sched_s;
+
+typedef CODE int (*coro_entry_t)(FAR struct coro_s *coro);
+
+struct coro_s
+{
+  dq_entry_t node;                  /* In the ready or the sleeping list */
+  FAR struct coro_sched_s *sched;   /* The scheduler running it */
+  coro_entry_t entry;               /* The body */
+  FAR void *arg;                    /* Argument given to coro_start() */
+  int line;                         /* Resume point, 0 for the start */
+  int fd;                           /* Registered to epoll, -1 if none */
+  uint32_t events;                  /* Events waited, 0 if not on a fd */
+  uint32_t revents;                 /* Events that resumed it */
+  uint32_t wakeup;                  /* Time of the timeout in ms */
+  bool sleeping;                    /* In the sleeping list */
+};
+
+struct coro_sched_s
+{
+  int epfd;                         /* The epoll instance */
+  dq_queue_t ready;                 /* Coroutines to run */
+  dq_queue_t sleeping;              /* Timeouts, soonest first */
+  size_t ncoros;                    /* Coroutines not done */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: coro_sched_init
+ *
+ * Description:
+ *   Initialize a scheduler of coroutines.
+ *
+ * Returned Value:
+ *   0 on success, otherwise -1 with errno set.
+ *
+ ****************************************************************************/
+
+int coro_sched_init(FAR struct coro_sched_s *sched);
+
+/****************************************************************************
+ * Name: coro_sched_deinit
+ *
+ * Description:
+ *   Release a scheduler, once no coroutine is left in it.
+ *
+ ****************************************************************************/
+
+void coro_sched_deinit(FAR struct coro_sched_s *sched);
+
+/****************************************************************************
+ * Name: coro_start
+ *
+ * Description:
+ *   Add the coroutine coro with the body entry to the ready coroutines of
+ *   sched.  It may be called from a coroutine of sched too.
+ *
+ ****************************************************************************/
+
+void coro_start(FAR struct coro_sched_s *sched, FAR struct coro_s *coro,
+                coro_entry_t entry, FAR void *arg);
+
+/****************************************************************************
+ * Name: coro_sched_run
+ *
+ * Description:
+ *   Run the coroutines of sched in the calling thread until all of them
+ *   are done.
+ *
+ * Returned Value:
+ *   0 when all the coroutines are done, otherwise -1 with errno set.
+ *
+ ****************************************************************************/
+
+int coro_sched_run(FAR struct coro_sched_s *sched);
+
+/****************************************************************************
+ * Name: coro_release_fd
+ *
+ * Description:
+ *   A file descriptor stays registered to epoll after CORO_WAIT_FD(), so
+ *   that waiting again on it costs a single epoll_ctl().  This removes it,
+ *   it must be called before the descriptor is closed.  It is done by the
+ *   scheduler too when the coroutine is done.
+ *
+ ****************************************************************************/
+
+void coro_release_fd(FAR struct coro_s *coro);
+
+/* Used by CORO_WAIT_FD() and CORO_SLEEP() */
+
+int coro_park_fd(FAR struct coro_s *coro, int fd, uint32_t events, int ms);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_LIBC_CORO */
+#endif /* __INCLUDE_NUTTX_CORO_H */
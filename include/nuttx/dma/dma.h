@@ -29,6 +29,7 @@
 
 #include <nuttx/config.h>
 #include <stdint.h>
+#include <string.h>
 #include <sys/types.h>
 
 /****************************************************************************
@@ -153,6 +154,22 @@
     (chan)->ops->start_link(chan, callback, arg, mode, link_cfg)
 #endif
 
+/****************************************************************************
+ * Name: DMA_START_SG
+ *
+ * Description:
+ *   Start the scatter-gather DMA transfer, the segments are transferred
+ *   in order as one transfer.  Use dma_start_sg() instead, which chains
+ *   the segments in software if the controller can't.
+ *
+ * Note: callback get called when the last segment finish, with the total
+ *       length transferred.
+ *
+ ****************************************************************************/
+
+#define DMA_START_SG(chan, callback, arg, sg, nsg) \
+    (chan)->ops->start_sg(chan, callback, arg, sg, nsg)
+
 /****************************************************************************
  * Name: DMA_PAUSE
  *
@@ -194,6 +211,14 @@
 
 #define DMA_RESIDUAL(chan) (chan)->ops->residual(chan)
 
+/* The identity of a channel of a registered DMA controller, see
+ * dma_register() and dma_get_chan().
+ */
+
+#define DMA_IDENT(devno, chan)  (((devno) << 16) | (chan))
+#define DMA_IDENT_DEVNO(ident)  ((ident) >> 16)
+#define DMA_IDENT_CHAN(ident)   ((ident) & 0xffff)
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -282,6 +307,31 @@ struct dma_link_config_s
 };
 #endif
 
+/* One segment of a scatter-gather transfer */
+
+struct dma_sg_s
+{
+  uintptr_t dst;
+  uintptr_t src;
+  size_t    len;
+};
+
+/* A scatter-gather transfer started by dma_start_sg().  The fields after
+ * nsg are private to dma_start_sg(), they keep the state when the
+ * segments are chained in software.
+ */
+
+struct dma_sglist_s
+{
+  FAR const struct dma_sg_s *sg;
+  unsigned int               nsg;
+
+  dma_callback_t             callback;
+  FAR void                  *arg;
+  unsigned int               next;
+  size_t                     len;
+};
+
 /* The DMA vtable */
 
 struct dma_ops_s
@@ -295,6 +345,9 @@ struct dma_ops_s
                            dma_callback_t callback, FAR void *arg,
                            uintptr_t dst, uintptr_t src,
                            size_t len, size_t period_len);
+  CODE int (*start_sg)(FAR struct dma_chan_s *chan,
+                       dma_callback_t callback, FAR void *arg,
+                       FAR const struct dma_sg_s *sg, unsigned int nsg);
 #ifdef CONFIG_DMA_LINK
   CODE int (*start_link)(FAR struct dma_chan_s *chan,
                          dma_callback_t callback, FAR void *arg,
@@ -325,4 +378,158 @@ struct dma_dev_s
                         FAR struct dma_chan_s *chan);
 };
 
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+#ifdef CONFIG_DMA
+
+/****************************************************************************
+ * Name: dma_register
+ *
+ * Description:
+ *   Register a DMA controller, so that the clients find its channels by
+ *   DMA_IDENT(devno, chan) without knowing the controller.
+ *
+ * Input Parameters:
+ *   devno - The number of the controller, less than CONFIG_DMA_NDEVICES
+ *   dev   - The controller
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int dma_register(unsigned int devno, FAR struct dma_dev_s *dev);
+
+/****************************************************************************
+ * Name: dma_unregister
+ *
+ * Description:
+ *   Unregister a DMA controller.
+ *
+ ****************************************************************************/
+
+int dma_unregister(unsigned int devno);
+
+/****************************************************************************
+ * Name: dma_get_chan
+ *
+ * Description:
+ *   Get a channel of a registered controller by DMA_GET_CHAN().
+ *
+ * Input Parameters:
+ *   ident - DMA_IDENT(devno, chan)
+ *
+ * Returned Value:
+ *   The channel, NULL if the controller isn't registered.
+ *
+ ****************************************************************************/
+
+FAR struct dma_chan_s *dma_get_chan(unsigned int ident);
+
+/****************************************************************************
+ * Name: dma_put_chan
+ *
+ * Description:
+ *   Release a channel got by dma_get_chan().
+ *
+ ****************************************************************************/
+
+void dma_put_chan(unsigned int ident, FAR struct dma_chan_s *chan);
+
+/****************************************************************************
+ * Name: dma_start_sg
+ *
+ * Description:
+ *   Start a scatter-gather transfer.  The controller does it in one go if
+ *   it has start_sg(), otherwise the segments are started one by one
+ *   from the completion of the previous one.  The list must stay valid
+ *   until the callback is called.
+ *
+ * Input Parameters:
+ *   chan     - The channel to start
+ *   callback - The callback when the last segment finish
+ *   arg      - The argument will pass to callback
+ *   list     - The segments
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int dma_start_sg(FAR struct dma_chan_s *chan, dma_callback_t callback,
+                 FAR void *arg, FAR struct dma_sglist_s *list);
+
+#endif /* CONFIG_DMA */
+
+#ifdef CONFIG_DMA_MEMCPY
+
+/****************************************************************************
+ * Name: dma_memcpy
+ *
+ * Description:
+ *   Copy a large buffer without going through the data cache: by the DMA
+ *   channel CONFIG_DMA_MEMCPY_IDENT when it is registered and free, else
+ *   by the CPU with non-temporal stores.  The copies smaller than
+ *   CONFIG_DMA_MEMCPY_THRESHOLD are done by memcpy().
+ *
+ * Input Parameters:
+ *   dst - The destination, which must not overlap the source
+ *   src - The source
+ *   len - The length of the copy in bytes
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int dma_memcpy(FAR void *dst, FAR const void *src, size_t len);
+
+/****************************************************************************
+ * Name: dma_memcpy_async
+ *
+ * Description:
+ *   Start the copy of a buffer by the DMA channel CONFIG_DMA_MEMCPY_IDENT
+ *   and return at once.  The buffers must stay valid until the callback.
+ *
+ * Input Parameters:
+ *   dst      - The destination, which must not overlap the source
+ *   src      - The source
+ *   len      - The length of the copy in bytes
+ *   callback - Called from the DMA interrupt with the length copied or a
+ *              negated errno value
+ *   arg      - The argument of the callback
+ *
+ * Returned Value:
+ *   Zero (OK) if the copy is started; a negated errno value if nothing is
+ *   copied.
+ *
+ ****************************************************************************/
+
+int dma_memcpy_async(FAR void *dst, FAR const void *src, size_t len,
+                     dma_callback_t callback, FAR void *arg);
+
+#else
+static inline int dma_memcpy(FAR void *dst, FAR const void *src,
+                             size_t len)
+{
+  memcpy(dst, src, len);
+  return 0;
+}
+#endif
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* __INCLUDE_NUTTX_DMA_DMA_H */
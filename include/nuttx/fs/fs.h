@@ -376,6 +376,15 @@ struct mountpt_operations
   CODE int     (*chstat)(FAR struct inode *mountpt, FAR const char *relpath,
                          FAR const struct stat *buf, int flags);
   CODE int     (*syncfs)(FAR struct inode *mountpt);
+
+  /* Read the next directory entry and the attributes of the file, it may
+   * be NULL if the file system can only return them by stat().
+   */
+
+  CODE int     (*readdirplus)(FAR struct inode *mountpt,
+                              FAR struct fs_dirent_s *dir,
+                              FAR struct dirent *entry,
+                              FAR struct stat *buf);
 };
 #endif /* CONFIG_DISABLE_MOUNTPOINT */
 
@@ -476,7 +485,7 @@ struct file
 {
   int               f_oflags;   /* Open mode flags */
 #ifdef CONFIG_FS_REFCOUNT
-  int               f_refs;     /* Reference count */
+  atomic_int        f_refs;     /* Reference count */
 #endif
   off_t             f_pos;      /* File position */
   FAR struct inode *f_inode;    /* Driver or file system interface */
@@ -496,6 +505,10 @@ struct file
 #if CONFIG_FS_LOCK_BUCKET_SIZE > 0
   bool              locked; /* Filelock state: false - unlocked, true - locked */
 #endif
+
+#ifdef CONFIG_FS_NOTIFY
+  unsigned int      f_notify_gen; /* Generation found unwatched */
+#endif
 };
 
 /* This defines a two layer array of files indexed by the file descriptor.
@@ -511,6 +524,13 @@ struct filelist
   uint8_t           fl_crefs;   /* The references to filelist */
   FAR struct file **fl_files;   /* The pointer of two layer file descriptors array */
 
+  /* The row arrays replaced by files_extend().  The lookups don't take a
+   * lock, so a lookup may still read one of them; they are freed with the
+   * list.
+   */
+
+  FAR struct file **fl_retired;
+
   /* Pre-allocated files to avoid allocator access during thread creation
    * phase, For functional safety requirements, increase
    * CONFIG_NFILE_DESCRIPTORS_PER_BLOCK could also avoid allocator access
@@ -586,6 +606,9 @@ struct streamlist
   mutex_t                 sl_lock;   /* For thread safety */
   struct file_struct      sl_std[3];
   sq_queue_t              sl_queue;
+#ifdef CONFIG_STDIO_LAZY_LOCK
+  bool                    sl_threaded; /* Lock the streams */
+#endif
 };
 #endif /* CONFIG_FILE_STREAM */
 
@@ -698,6 +721,31 @@ int register_blockpartition(FAR const char *partition,
                             off_t firstsector, off_t nsectors);
 #endif
 
+/****************************************************************************
+ * Name: register_blockcache
+ *
+ * Description:
+ *   Register a block driver that caches the sectors of another block
+ *   driver, with write-back and read-ahead.  File systems are mounted on
+ *   the new driver instead of the parent.
+ *
+ * Input Parameters:
+ *   path   - The path to the cached block driver inode
+ *   mode   - The access mode of the new inode
+ *   parent - The path to the block driver to be cached
+ *   size   - The memory budget for cached sectors in bytes, or zero for
+ *            CONFIG_FS_BLOCKCACHE_SIZE
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_BLOCKCACHE
+int register_blockcache(FAR const char *path, mode_t mode,
+                        FAR const char *parent, size_t size);
+#endif
+
 /****************************************************************************
  * Name: unregister_driver
  *
@@ -1534,6 +1582,31 @@ ssize_t file_pwrite(FAR struct file *filep, FAR const void *buf,
 ssize_t file_sendfile(FAR struct file *outfile, FAR struct file *infile,
                       FAR off_t *offset, size_t count);
 
+/****************************************************************************
+ * Name: file_splice
+ *
+ * Description:
+ *   Equivalent to the standard splice function except that is accepts
+ *   struct file instances instead of file descriptors.
+ *
+ ****************************************************************************/
+
+ssize_t file_splice(FAR struct file *infile, FAR off_t *inoffset,
+                    FAR struct file *outfile, FAR off_t *outoffset,
+                    size_t len, unsigned int flags);
+
+/****************************************************************************
+ * Name: file_tee
+ *
+ * Description:
+ *   Equivalent to the standard tee function except that is accepts
+ *   struct file instances instead of file descriptors.
+ *
+ ****************************************************************************/
+
+ssize_t file_tee(FAR struct file *infile, FAR struct file *outfile,
+                 size_t len, unsigned int flags);
+
 /****************************************************************************
  * Name: file_seek
  *
@@ -29,6 +29,7 @@
 
 #include <nuttx/config.h>
 #include <sys/types.h>
+#include <stdbool.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -106,6 +107,9 @@
 #define _PINCTRLBASE    (0x4000) /* Pinctrl driver ioctl commands */
 #define _PCIBASE        (0x4100) /* Pci ioctl commands */
 #define _I3CBASE        (0x4200) /* I3C driver ioctl commands */
+#define _URINGBASE      (0x4300) /* Submission ring ioctl commands */
+#define _PERFIOCBASE    (0x4400) /* Perf event ioctl commands */
+#define _PKTGENBASE     (0x4500) /* Packet generator ioctl commands */
 #define _WLIOCBASE      (0x8b00) /* Wireless modules ioctl network commands */
 
 /* boardctl() commands share the same number space */
@@ -231,6 +235,10 @@
 #define FIOC_XIPBASE        _FIOC(0x0015) /* IN:  uinptr_t *
                                            * OUT: Current file xip base address
                                            */
+#define FIOC_READDIRPLUS    _FIOC(0x0016) /* IN:  FAR struct direntplus *
+                                           * OUT: The next directory entry
+                                           *      and its attributes
+                                           */
 
 /* NuttX file system ioctl definitions **************************************/
 
@@ -345,6 +353,14 @@
                                            *      to return sector numbers.
                                            * OUT: Data return in user-provided
                                            *      buffer. */
+#define BIOC_PREERASE   _BIOC(0x0011)     /* Tell that a run of sectors will
+                                           * be overwritten soon, so that the
+                                           * device may erase it ahead of the
+                                           * write.  The data of the sectors
+                                           * that are not written is lost.
+                                           * IN:  Pointer to a read-only
+                                           *      struct blk_preerase_s.
+                                           * OUT: None */
 
 /* NuttX MTD driver ioctl definitions ***************************************/
 
@@ -500,6 +516,28 @@
                                                * IN: None
                                                * OUT: int */
 
+#define PIPEIOC_SPLICE      _PIPEIOC(0x0007)  /* Move data between the pipe
+                                               * buffer and another file,
+                                               * used by splice()
+                                               * IN: pipe_splice_s
+                                               * OUT: Length of data */
+
+#define PIPEIOC_TEE         _PIPEIOC(0x0008)  /* Copy data from the pipe
+                                               * buffer to another pipe,
+                                               * used by tee()
+                                               * IN: pipe_splice_s
+                                               * OUT: Length of data */
+
+#define PIPEIOC_SPSC        _PIPEIOC(0x0009)  /* Set single reader/single
+                                               * writer mode
+                                               * IN: unsigned long integer
+                                               *     0=any number of
+                                               *       readers and writers
+                                               *       (default)
+                                               *     1=one reader and one
+                                               *       writer thread
+                                               * OUT: None */
+
 /* RTC driver ioctl definitions *********************************************/
 
 /* (see nuttx/include/rtc.h */
@@ -753,10 +791,39 @@
 #define _PINCTRLIOCVALID(c) (_IOC_TYPE(c)==_PINCTRLBASE)
 #define _PINCTRLIOC(nr)     _IOC(_PINCTRLBASE,nr)
 
+/* Submission ring ioctl definitions ****************************************/
+
+/* see nuttx/include/fs/uring.h */
+
+#define _URINGIOCVALID(c) (_IOC_TYPE(c)==_URINGBASE)
+#define _URINGIOC(nr)     _IOC(_URINGBASE,nr)
+
+/* Perf event ioctl definitions *********************************************/
+
+/* see include/nuttx/perf_event.h */
+
+#define _PERFIOCVALID(c)  (_IOC_TYPE(c)==_PERFIOCBASE)
+#define _PERFIOC(nr)      _IOC(_PERFIOCBASE,nr)
+
+/* Packet generator ioctl definitions ***************************************/
+
+/* see include/nuttx/net/pktgen.h */
+
+#define _PKTGENIOCVALID(c) (_IOC_TYPE(c)==_PKTGENBASE)
+#define _PKTGENIOC(nr)     _IOC(_PKTGENBASE,nr)
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
 
+/* Argument of BIOC_PREERASE */
+
+struct blk_preerase_s
+{
+  blkcnt_t startsector;    /* The first sector of the run */
+  blkcnt_t nsectors;       /* The number of sectors in the run */
+};
+
 struct pipe_peek_s
 {
   FAR void *buf;
@@ -764,6 +831,16 @@ struct pipe_peek_s
   size_t size;
 };
 
+struct file;
+struct pipe_splice_s
+{
+  FAR struct file *filep;  /* The other file */
+  FAR off_t *offset;       /* Offset in the other file, or NULL */
+  size_t len;              /* Maximum length of data */
+  unsigned int flags;      /* SPLICE_F_* */
+  bool out;                /* true: From the pipe to filep */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
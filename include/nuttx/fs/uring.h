@@ -0,0 +1,221 @@
+/****************************************************************************
+ * include/nuttx/fs/uring.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_FS_URING_H
+#define __INCLUDE_NUTTX_FS_URING_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <stdint.h>
+
+#include <nuttx/fs/ioctl.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Each open of /dev/uring is one ring.  The application owns the memory of
+ * the submission queue (SQ) and of the completion queue (CQ), so both can
+ * be accessed without a system call:
+ *
+ * - To submit, fill in sqes[sq->tail & (sq_entries - 1)], then increment
+ *   sq->tail.  URINGIOC_ENTER consumes the entries up to sq->tail and
+ *   advances sq->head.
+ * - The results are posted at cqes[cq->tail & (cq_entries - 1)].  Once
+ *   done with an entry, the application increments cq->head.
+ *
+ * Requests that cannot complete right away wait for their file to become
+ * ready and complete in a later URINGIOC_ENTER, usually the one waiting
+ * for completions.  No more requests are accepted than there is room in
+ * the CQ, so the CQ never overflows.
+ */
+
+/* Command:      URINGIOC_SETUP
+ * Description:  Attach the application's rings to the ring device
+ * Argument:     A pointer to a read-only instance of struct uring_params_s
+ * Return:       Zero (OK) on success
+ */
+
+#define URINGIOC_SETUP    _URINGIOC(0x0001)
+
+/* Command:      URINGIOC_ENTER
+ * Description:  Submit up to 'to_submit' requests from the SQ, then wait
+ *               until at least 'min_complete' completions are in the CQ
+ * Argument:     A pointer to a read-only instance of struct uring_enter_s
+ * Return:       The number of requests submitted
+ */
+
+#define URINGIOC_ENTER    _URINGIOC(0x0002)
+
+/* Command:      URINGIOC_REGFILES
+ * Description:  Register file descriptors for URING_SQE_FIXED_FILE, in
+ *               place of the ones registered before.  Zero descriptors
+ *               only unregister.
+ * Argument:     A pointer to a read-only instance of struct uring_files_s
+ * Return:       Zero (OK) on success
+ */
+
+#define URINGIOC_REGFILES _URINGIOC(0x0003)
+
+/* Command:      URINGIOC_REGBUFS
+ * Description:  Register buffers for URING_SQE_FIXED_BUF, in place of the
+ *               ones registered before.  Zero buffers only unregister.
+ * Argument:     A pointer to a read-only instance of struct uring_bufs_s
+ * Return:       Zero (OK) on success
+ */
+
+#define URINGIOC_REGBUFS  _URINGIOC(0x0004)
+
+/* Request opcodes.  The result in the completion entry is what the
+ * corresponding call returns, or a negated errno value.
+ */
+
+#define URING_OP_NOP      0 /* Nothing */
+#define URING_OP_READ     1 /* pread(), or read() if 'off' is -1 */
+#define URING_OP_WRITE    2 /* pwrite(), or write() if 'off' is -1 */
+#define URING_OP_FSYNC    3 /* fsync() */
+#define URING_OP_SEND     4 /* send() with 'msgflags' */
+#define URING_OP_RECV     5 /* recv() with 'msgflags' */
+#define URING_OP_ACCEPT   6 /* accept4() with 'msgflags' as flags, 'addr'
+                             * and 'addrlen' */
+#define URING_OP_POLL     7 /* Wait for the events in 'len', the result is
+                             * the returned events */
+
+/* Request flags */
+
+#define URING_SQE_FIXED_FILE (1 << 0) /* 'fd' indexes the registered files */
+#define URING_SQE_FIXED_BUF  (1 << 1) /* 'addr' and 'len' are within the
+                                       * registered buffer 'bufindex' */
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The head and tail of the SQ or of the CQ.  Both are free running, the
+ * entry is selected by the index modulo the number of entries.
+ */
+
+struct uring_ring_s
+{
+  volatile uint32_t head;     /* Next entry to consume */
+  volatile uint32_t tail;     /* Next entry to produce */
+};
+
+/* A submission queue entry */
+
+struct uring_sqe_s
+{
+  uint8_t opcode;             /* URING_OP_* */
+  uint8_t flags;              /* URING_SQE_* */
+  uint16_t bufindex;          /* Registered buffer with FIXED_BUF */
+  int fd;                     /* File descriptor or registered file index */
+  off_t off;                  /* File offset, -1 for the file position */
+  FAR void *addr;             /* Buffer, or address for ACCEPT */
+  FAR socklen_t *addrlen;     /* Address length for ACCEPT */
+  uint32_t len;               /* Buffer length, or events for POLL */
+  uint32_t msgflags;          /* Flags of SEND, RECV and ACCEPT */
+  uint64_t userdata;          /* Copied to the completion entry */
+};
+
+/* A completion queue entry */
+
+struct uring_cqe_s
+{
+  uint64_t userdata;          /* From the submission entry */
+  int32_t res;                /* Result of the request */
+  uint32_t flags;             /* Reserved, zero */
+};
+
+/* Argument of URINGIOC_SETUP.  The numbers of entries are powers of two. */
+
+struct uring_params_s
+{
+  uint32_t sq_entries;              /* Size of the SQ */
+  uint32_t cq_entries;              /* Size of the CQ */
+  FAR struct uring_ring_s *sq;      /* Head and tail of the SQ */
+  FAR struct uring_sqe_s *sqes;     /* sq_entries submission entries */
+  FAR struct uring_ring_s *cq;      /* Head and tail of the CQ */
+  FAR struct uring_cqe_s *cqes;     /* cq_entries completion entries */
+};
+
+/* Argument of URINGIOC_ENTER */
+
+struct uring_enter_s
+{
+  uint32_t to_submit;         /* Maximum number of requests to submit */
+  uint32_t min_complete;      /* Completions in the CQ to wait for */
+};
+
+/* Argument of URINGIOC_REGFILES */
+
+struct uring_files_s
+{
+  FAR const int *fds;         /* The file descriptors */
+  unsigned int nfds;          /* The number of file descriptors */
+};
+
+/* Argument of URINGIOC_REGBUFS */
+
+struct uring_bufs_s
+{
+  FAR const struct iovec *iov; /* The buffers */
+  unsigned int nbufs;          /* The number of buffers */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+#ifdef __KERNEL__
+/****************************************************************************
+ * Name: uring_register
+ *
+ * Description:
+ *   Register /dev/uring
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_AIO_URING
+void uring_register(void);
+#endif
+#endif /* __KERNEL__ */
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_NUTTX_FS_URING_H */
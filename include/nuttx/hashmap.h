@@ -0,0 +1,199 @@
+/****************************************************************************
+ * include/nuttx/hashmap.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_HASHMAP_H
+#define __INCLUDE_NUTTX_HASHMAP_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The number of entries in the map */
+
+#define hashmap_count(map) ((map)->count)
+
+/* Iterate over all the entries.  The map can't be changed meanwhile, the
+ * removal moves the other entries.
+ */
+
+#define hashmap_for_every(map, item, i) \
+  for ((i) = 0; (map)->slots != NULL && (i) <= (map)->mask; (i)++) \
+    if (((item) = (map)->slots[i].entry) != NULL)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* A resizable open-addressing hash map, with the Robin Hood probing.
+ *
+ * The map stores pointers to the caller's objects with their hash, in one
+ * array: a lookup compares the hashes in the array, one or two cache lines
+ * in general, and only dereferences the entries whose hash matches.  The
+ * objects need no link member and aren't allocated by the map.
+ *
+ * The map isn't locked, this is the job of its user.
+ */
+
+/* Tell whether the entry has the key */
+
+typedef CODE bool (*hashmap_match_t)(FAR const void *entry,
+                                     FAR const void *key);
+
+struct hashmap_slot_s
+{
+  uint32_t   hash;                /* The hash of the entry */
+  FAR void  *entry;               /* The entry, NULL if the slot is free */
+};
+
+struct hashmap_s
+{
+  FAR struct hashmap_slot_s *slots;
+  hashmap_match_t match;
+  uint32_t mask;                  /* The number of slots minus one */
+  uint32_t count;                 /* The number of entries */
+  uint32_t minslots;              /* Don't shrink below */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: hashmap_init
+ *
+ * Description:
+ *   Initialize an empty map.
+ *
+ * Input Parameters:
+ *   map    - The map to initialize
+ *   match  - The comparison of the entries with the keys
+ *   nslots - The initial number of slots, rounded up to a power of two.
+ *            The map doesn't shrink below it.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int hashmap_init(FAR struct hashmap_s *map, hashmap_match_t match,
+                 uint32_t nslots);
+
+/****************************************************************************
+ * Name: hashmap_destroy
+ *
+ * Description:
+ *   Free the slots of the map.  The entries are the caller's.
+ *
+ ****************************************************************************/
+
+void hashmap_destroy(FAR struct hashmap_s *map);
+
+/****************************************************************************
+ * Name: hashmap_find
+ *
+ * Description:
+ *   Find the entry with the key.
+ *
+ * Input Parameters:
+ *   map  - The map
+ *   hash - The hash of the key
+ *   key  - The key passed to the match function, not NULL
+ *
+ * Returned Value:
+ *   The entry, NULL if there's none.
+ *
+ ****************************************************************************/
+
+FAR void *hashmap_find(FAR struct hashmap_s *map, uint32_t hash,
+                       FAR const void *key);
+
+/****************************************************************************
+ * Name: hashmap_insert
+ *
+ * Description:
+ *   Add an entry.  The map grows when it is 7/8 full.  The keys aren't
+ *   checked, the caller does hashmap_find() first if they are unique.
+ *
+ * Input Parameters:
+ *   map   - The map
+ *   hash  - The hash of the key of the entry
+ *   entry - The entry, not NULL
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOMEM if the map is full and can't grow.
+ *
+ ****************************************************************************/
+
+int hashmap_insert(FAR struct hashmap_s *map, uint32_t hash,
+                   FAR void *entry);
+
+/****************************************************************************
+ * Name: hashmap_remove
+ *
+ * Description:
+ *   Remove the entry with the key.  The map shrinks when it is 1/4 full.
+ *
+ * Returned Value:
+ *   The entry removed, NULL if there's none.
+ *
+ ****************************************************************************/
+
+FAR void *hashmap_remove(FAR struct hashmap_s *map, uint32_t hash,
+                         FAR const void *key);
+
+/****************************************************************************
+ * Name: hashmap_delete
+ *
+ * Description:
+ *   Remove this very entry, for the maps with duplicate keys.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOENT if the entry isn't in the map.
+ *
+ ****************************************************************************/
+
+int hashmap_delete(FAR struct hashmap_s *map, uint32_t hash,
+                   FAR void *entry);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_NUTTX_HASHMAP_H */
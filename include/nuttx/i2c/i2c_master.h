@@ -33,6 +33,7 @@
 #include <stdint.h>
 
 #include <nuttx/fs/ioctl.h>
+#include <nuttx/queue.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -270,6 +271,24 @@ struct i2c_transfer_s
   size_t msgc;                /* Number of messages in the array. */
 };
 
+#ifdef CONFIG_I2C_ASYNC
+/* This describes a transfer queued by i2c_transfer_async().  It belongs to
+ * the I2C bus from the submission until the callback is called.
+ */
+
+struct i2c_async_s
+{
+  sq_entry_t node;            /* Used internally by the bus queue */
+  FAR struct i2c_msg_s *msgv; /* Array of I2C messages for the transfer */
+  int msgc;                   /* Number of messages in the array. */
+
+  /* Called from the work queue with the result of I2C_TRANSFER() */
+
+  CODE void (*callback)(FAR struct i2c_async_s *msg, int result);
+  FAR void *arg;              /* For use by the callback */
+};
+#endif
+
 /****************************************************************************
  * Public Functions Definitions
  ****************************************************************************/
@@ -383,6 +402,31 @@ int i2c_read(FAR struct i2c_master_s *dev,
              FAR const struct i2c_config_s *config,
              FAR uint8_t *buffer, int buflen);
 
+/****************************************************************************
+ * Name: i2c_transfer_async
+ *
+ * Description:
+ *   Queue an I2C transfer and return without waiting.  Each I2C bus has
+ *   its own queue, served in order by the low priority work queue, and the
+ *   callback of the message is called with the result when the transfer
+ *   is done.  This may be called from an interrupt handler.
+ *
+ * Input Parameters:
+ *   dev - Device-specific state data
+ *   msg - The messages and the callback, not to be modified until the
+ *         callback is called.
+ *
+ * Returned Value:
+ *   0 if the transfer is queued; -ENOSPC if there are already
+ *   CONFIG_I2C_ASYNC_NBUSES buses with a queue.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_I2C_ASYNC
+int i2c_transfer_async(FAR struct i2c_master_s *dev,
+                       FAR struct i2c_async_s *msg);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
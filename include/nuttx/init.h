@@ -32,6 +32,10 @@
 
 #include <stdint.h>
 
+#ifdef CONFIG_INITCALL
+#  include <nuttx/wqueue.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -47,10 +51,37 @@
 #define OSINIT_IDLELOOP()        (g_nx_initstate >= OSINIT_IDLELOOP)
 #define OSINIT_OS_INITIALIZING() (g_nx_initstate  < OSINIT_OSREADY)
 
+/* Levels of the initcalls.  The initcalls of a level run in parallel, and
+ * only once all those of the lower levels are done.  Those of the levels
+ * below INITCALL_LEVEL_DEFERRED are done before the first application
+ * starts, those of INITCALL_LEVEL_DEFERRED run while it starts.
+ */
+
+#define INITCALL_LEVEL_BUS       0  /* Clocks, regulators, buses */
+#define INITCALL_LEVEL_DEVICE    1  /* The devices on the buses */
+#define INITCALL_LEVEL_FS        2  /* File systems on the devices */
+#define INITCALL_LEVEL_DEFERRED  3  /* Not needed by the first application */
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
+#ifdef CONFIG_INITCALL
+/* An initcall, returning 0 on success or a negated errno value */
+
+typedef CODE int (*initcall_t)(FAR void *arg);
+
+struct initcall_s
+{
+  FAR struct initcall_s *flink;   /* In the list of the initcalls */
+  FAR const char *name;           /* For the error reports */
+  initcall_t func;                /* The initialization */
+  FAR void *arg;                  /* Its argument */
+  uint8_t level;                  /* INITCALL_LEVEL_* */
+  struct work_s work;             /* To run it on the initcall threads */
+};
+#endif
+
 /* Initialization state.  OS bring-up occurs in several phases: */
 
 enum nx_initstate_e
@@ -104,6 +135,32 @@ EXTERN volatile uint8_t g_nx_initstate;  /* See enum nx_initstate_e */
 
 void nx_start(void);
 
+/* Functions contained in nx_initcall.c *************************************/
+
+/****************************************************************************
+ * Name: nx_initcall
+ *
+ * Description:
+ *   Register the initialization func of a driver or a subsystem, to be run
+ *   with the initcalls of the same level on the initcall threads, after
+ *   board_late_initialize() has returned.  It may be called from
+ *   drivers_initialize(), board_early_initialize(), board_late_initialize()
+ *   or an initcall.  Once all the initcalls are done, func is run at once.
+ *
+ * Input Parameters:
+ *   call  - The initcall, which must stay valid until it is done
+ *   name  - The name of the initialization, for the error reports
+ *   func  - The initialization
+ *   arg   - Its argument
+ *   level - One of INITCALL_LEVEL_*
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_INITCALL
+void nx_initcall(FAR struct initcall_s *call, FAR const char *name,
+                 initcall_t func, FAR void *arg, int level);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
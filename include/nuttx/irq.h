@@ -30,6 +30,7 @@
 #include <nuttx/config.h>
 
 #ifndef __ASSEMBLY__
+#  include <sys/types.h>
 #  include <stdint.h>
 #  include <stdbool.h>
 #endif
@@ -222,6 +223,46 @@ int irq_attach_thread(int irq, xcpt_t isr, xcpt_t isrthread, FAR void *arg,
 int irq_attach_wqueue(int irq, xcpt_t isr, xcpt_t isrwork,
                       FAR void *arg, int priority);
 
+/****************************************************************************
+ * Name: irq_thread_convert
+ *
+ * Description:
+ *   Move the handler attached with irq_attach() to IRQ number 'irq' into a
+ *   thread:  the IRQ is masked in interrupt context, the thread runs the
+ *   handler, with a NULL register context, and unmasks the IRQ.
+ *
+ * Input Parameters:
+ *   irq        - Irq num
+ *   priority   - Priority of the new thread
+ *   stack_size - size (in bytes) of the stack needed
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_ARCH_NOINTC
+int irq_thread_convert(int irq, int priority, int stack_size);
+#endif
+
+/****************************************************************************
+ * Name: irq_thread_setpriority, irq_thread_setaffinity, irq_thread_pid
+ *
+ * Description:
+ *   Change the priority or the affinity of the thread of a threaded IRQ,
+ *   or return its ID (zero if the IRQ is not threaded).
+ *
+ * Returned Value:
+ *   Zero, or the ID, on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int irq_thread_setpriority(int irq, int priority);
+#ifdef CONFIG_SMP
+int irq_thread_setaffinity(int irq, FAR const cpu_set_t *cpuset);
+#endif
+pid_t irq_thread_pid(int irq);
+
 #ifdef CONFIG_IRQCHAIN
 int irqchain_detach(int irq, xcpt_t isr, FAR void *arg);
 #else
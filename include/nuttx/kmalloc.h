@@ -33,6 +33,7 @@
 #include <stdbool.h>
 #include <stdlib.h>
 
+#include <nuttx/mm/heaptag.h>
 #include <nuttx/mm/mm.h>
 #include <nuttx/userspace.h>
 
@@ -110,6 +111,53 @@ extern "C"
 
 #endif
 
+/* The sources of a subsystem are built with MM_HEAPTAG_SUBSYS defined to
+ * its tag, then the memory they allocate is accounted to it.
+ */
+
+#if defined(CONFIG_MM_HEAPTAG) && defined(MM_HEAPTAG_SUBSYS) && \
+    (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+#  undef kumm_calloc
+#  undef kumm_malloc
+#  undef kumm_zalloc
+#  undef kumm_realloc
+#  undef kumm_memalign
+
+#  define kumm_calloc(n,s) \
+     mm_heaptag_set(calloc(n,s), MM_HEAPTAG_SUBSYS)
+#  define kumm_malloc(s)         mm_heaptag_set(malloc(s), MM_HEAPTAG_SUBSYS)
+#  define kumm_zalloc(s)         mm_heaptag_set(zalloc(s), MM_HEAPTAG_SUBSYS)
+#  define kumm_realloc(p,s) \
+     mm_heaptag_set(realloc(p,s), MM_HEAPTAG_SUBSYS)
+#  define kumm_memalign(a,s) \
+     mm_heaptag_set(memalign(a,s), MM_HEAPTAG_SUBSYS)
+
+#  ifdef CONFIG_MM_KERNEL_HEAP
+#    define kmm_calloc(n,s) \
+       mm_heaptag_set(kmm_calloc(n,s), MM_HEAPTAG_SUBSYS)
+#    define kmm_malloc(s) \
+       mm_heaptag_set(kmm_malloc(s), MM_HEAPTAG_SUBSYS)
+#    define kmm_zalloc(s) \
+       mm_heaptag_set(kmm_zalloc(s), MM_HEAPTAG_SUBSYS)
+#    define kmm_realloc(p,s) \
+       mm_heaptag_set(kmm_realloc(p,s), MM_HEAPTAG_SUBSYS)
+#    define kmm_memalign(a,s) \
+       mm_heaptag_set(kmm_memalign(a,s), MM_HEAPTAG_SUBSYS)
+#  else
+#    undef kmm_calloc
+#    undef kmm_malloc
+#    undef kmm_zalloc
+#    undef kmm_realloc
+#    undef kmm_memalign
+
+#    define kmm_calloc(n,s)      kumm_calloc(n,s)
+#    define kmm_malloc(s)        kumm_malloc(s)
+#    define kmm_zalloc(s)        kumm_zalloc(s)
+#    define kmm_realloc(p,s)     kumm_realloc(p,s)
+#    define kmm_memalign(a,s)    kumm_memalign(a,s)
+#  endif
+#endif
+
 #ifdef CONFIG_MM_KERNEL_HEAP
 /****************************************************************************
  * Group memory management
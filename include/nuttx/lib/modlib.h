@@ -33,6 +33,7 @@
 #include <elf.h>
 
 #include <nuttx/addrenv.h>
+#include <nuttx/symtab.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -169,6 +170,9 @@ struct module_s
   uint16_t nsect;                      /* Number of entries in sectalloc array */
 #endif
   int dynamic;                         /* Module is a dynamic shared object */
+#ifdef CONFIG_SYMTAB_HASH
+  struct symtab_hash_s exphash;        /* Hash index of modinfo.exports */
+#endif
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MODULE)
   size_t textsize;                     /* Size of the kernel .text memory allocation */
   size_t datasize;                     /* Size of the kernel .bss/.data memory allocation */
@@ -240,6 +244,10 @@ struct mod_loadinfo_s
                               * romfs/tmps, we can try get xipbase,
                               * skip the copy.
                               */
+#ifdef CONFIG_MODLIB_TEXTCACHE
+  FAR const char *filename;  /* Path of the file, while it is loaded */
+  struct timespec filemtime; /* Time of last modification of the file */
+#endif
 
   /* Address environment.
    *
@@ -0,0 +1,75 @@
+/****************************************************************************
+ * include/nuttx/lib/vmath.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_LIB_VMATH_H
+#define __INCLUDE_NUTTX_LIB_VMATH_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <nuttx/compiler.h>
+
+#include <stddef.h>
+
+#ifdef CONFIG_LIBM_VECTOR
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/* Array versions of the float functions of math.h: y[i] = f(x[i]) for the
+ * n elements of x.  y may be x, otherwise the arrays must not overlap.
+ *
+ * With CONFIG_LIBM_VECTOR_ACCURATE they give the results of the libm
+ * functions.  With CONFIG_LIBM_VECTOR_FAST they are computed by loops the
+ * compiler vectorizes, with these bounds of the error:
+ *
+ *   vsinf(), vcosf() - 2.5 ulp for |x| <= 4096, and from 512 down 1.7 ulp,
+ *                      the libm function beyond
+ *   vexpf()          - 1.1 ulp, 0 below -103.9, +inf above 88.7
+ *   vlogf()          - 1 ulp, -inf for 0 and NaN below 0
+ *
+ * NaN gives NaN.  errno is not set.
+ */
+
+void vsinf(FAR float *y, FAR const float *x, size_t n);
+void vcosf(FAR float *y, FAR const float *x, size_t n);
+void vexpf(FAR float *y, FAR const float *x, size_t n);
+void vlogf(FAR float *y, FAR const float *x, size_t n);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_LIBM_VECTOR */
+#endif /* __INCLUDE_NUTTX_LIB_VMATH_H */
@@ -0,0 +1,149 @@
+/****************************************************************************
+ * include/nuttx/lockstat.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_LOCKSTAT_H
+#define __INCLUDE_NUTTX_LOCKSTAT_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+#ifdef CONFIG_SCHED_LOCKSTAT
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The kinds of locks, a lock class is a site and a kind */
+
+#define LOCKSTAT_MUTEX     0  /* nxmutex_t and rmutex_t */
+#define LOCKSTAT_SEM       1  /* sem_t, but the mutexes */
+#define LOCKSTAT_SPIN      2  /* spinlock_t */
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The statistics of one lock class.  The site is the caller of the
+ * function that initialized the locks, or the lock itself for the locks
+ * initialized statically and the spinlocks.  The times are in perf_gettime()
+ * units.
+ */
+
+struct lockstat_s
+{
+  FAR void     *site;         /* The lock class */
+  uint8_t       type;         /* LOCKSTAT_MUTEX, _SEM or _SPIN */
+  unsigned long acquired;     /* Number of acquisitions */
+  unsigned long contended;    /* Acquisitions that had to wait */
+  uint64_t      waittime;     /* Total wait time */
+  clock_t       waitmax;      /* Longest wait */
+  uint64_t      holdtime;     /* Total hold time */
+  clock_t       holdmax;      /* Longest hold */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: lockstat_acquire
+ *
+ * Description:
+ *   Count an acquisition of a lock of a class, after a wait of 'wait' if
+ *   it was contended.
+ *
+ ****************************************************************************/
+
+void lockstat_acquire(int type, FAR void *site, bool contended,
+                      clock_t wait);
+
+/****************************************************************************
+ * Name: lockstat_release
+ *
+ * Description:
+ *   Count the release of a lock of a class, held for 'hold'.
+ *
+ ****************************************************************************/
+
+void lockstat_release(int type, FAR void *site, clock_t hold);
+
+/****************************************************************************
+ * Name: lockstat_get
+ *
+ * Description:
+ *   Return the statistics of one lock class.
+ *
+ * Input Parameters:
+ *   index - The index of the class, from 0
+ *   stat  - The location to return the statistics in
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOENT past the last class.
+ *
+ ****************************************************************************/
+
+int lockstat_get(int index, FAR struct lockstat_s *stat);
+
+/****************************************************************************
+ * Name: lockstat_dropped
+ *
+ * Description:
+ *   Return the number of acquisitions not counted because the class table
+ *   was full.
+ *
+ ****************************************************************************/
+
+unsigned long lockstat_dropped(void);
+
+/****************************************************************************
+ * Name: lockstat_reset
+ *
+ * Description:
+ *   Forget all the lock classes.
+ *
+ ****************************************************************************/
+
+void lockstat_reset(void);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CONFIG_SCHED_LOCKSTAT */
+#endif /* __INCLUDE_NUTTX_LOCKSTAT_H */
@@ -200,6 +200,27 @@ FAR void *gran_reserve(GRAN_HANDLE handle, uintptr_t start, size_t size);
 
 FAR void *gran_alloc(GRAN_HANDLE handle, size_t size);
 
+/****************************************************************************
+ * Name: gran_memalign
+ *
+ * Description:
+ *   Allocate memory from the granule heap whose start address is aligned
+ *   to 'alignment'.  Alignments larger than the granule size need a granule
+ *   aligned heap start.
+ *
+ * Input Parameters:
+ *   handle    - The handle previously returned by gran_initialize
+ *   alignment - The required alignment in bytes, a power of two.
+ *   size      - The size of the memory region to allocate.
+ *
+ * Returned Value:
+ *   On success, a non-NULL pointer to the allocated memory is returned;
+ *   NULL is returned on failure.
+ *
+ ****************************************************************************/
+
+FAR void *gran_memalign(GRAN_HANDLE handle, size_t alignment, size_t size);
+
 /****************************************************************************
  * Name: gran_free
  *
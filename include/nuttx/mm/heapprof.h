@@ -0,0 +1,172 @@
+/****************************************************************************
+ * include/nuttx/mm/heapprof.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_MM_HEAPPROF_H
+#define __INCLUDE_NUTTX_MM_HEAPPROF_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+
+#if defined(CONFIG_MM_HEAPPROF) && \
+    (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Called by the allocator front ends.  Only one allocation every
+ * CONFIG_MM_HEAPPROF_INTERVAL bytes on average costs more than a
+ * subtraction.
+ */
+
+#define MM_HEAPPROF_ALLOC(mem, size) \
+  do \
+    { \
+      if ((mem) != NULL && \
+          (g_mm_heapprof_left -= (long)(size)) < 0) \
+        { \
+          mm_heapprof_alloc(mem, size); \
+        } \
+    } \
+  while (0)
+
+#define MM_HEAPPROF_FREE(mem) mm_heapprof_free(mem)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The samples taken at one call site */
+
+struct mm_heapprof_site_s
+{
+  FAR void     *backtrace[CONFIG_MM_HEAPPROF_DEPTH]; /* NULL terminated */
+  unsigned long nlive;                               /* The live samples */
+  size_t        live;                                /* Their bytes */
+  unsigned long nalloc;                              /* All samples taken */
+  uint64_t      alloc;                               /* Their bytes */
+};
+
+/* The totals of all sites */
+
+struct mm_heapprof_s
+{
+  unsigned long interval; /* The mean sampling interval in bytes */
+  unsigned long nsites;   /* The number of call sites seen */
+  unsigned long nlive;    /* The number of live samples */
+  size_t        live;     /* The bytes of the live samples */
+  unsigned long nalloc;   /* The number of samples ever taken */
+  uint64_t      alloc;    /* The bytes of the samples ever taken */
+  unsigned long ndropped; /* Samples lost because a table was full */
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/* The bytes still to be allocated until the next sample */
+
+EXTERN long g_mm_heapprof_left;
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_heapprof_alloc
+ *
+ * Description:
+ *   Record the backtrace of the allocation of 'mem' and pick the distance
+ *   to the next sample, so that samples are taken at the points of a
+ *   Poisson process over the allocated bytes.  Bigger allocations are
+ *   therefore more likely to be sampled.
+ *
+ ****************************************************************************/
+
+void mm_heapprof_alloc(FAR void *mem, size_t size);
+
+/****************************************************************************
+ * Name: mm_heapprof_free
+ *
+ * Description:
+ *   Drop the sample of 'mem' if it is one.  Memory that was not sampled
+ *   returns after one array lookup without taking any lock.
+ *
+ ****************************************************************************/
+
+void mm_heapprof_free(FAR void *mem);
+
+/****************************************************************************
+ * Name: mm_heapprof_info
+ *
+ * Description:
+ *   Return the totals of the heap profile.
+ *
+ ****************************************************************************/
+
+void mm_heapprof_info(FAR struct mm_heapprof_s *info);
+
+/****************************************************************************
+ * Name: mm_heapprof_site
+ *
+ * Description:
+ *   Return a snapshot of one call site.
+ *
+ * Input Parameters:
+ *   index - The index of the site, starting at zero
+ *   site  - The location to return the site in
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOENT if there is no site 'index'.
+ *
+ ****************************************************************************/
+
+int mm_heapprof_site(unsigned int index,
+                     FAR struct mm_heapprof_site_s *site);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#else /* CONFIG_MM_HEAPPROF && (CONFIG_BUILD_FLAT || __KERNEL__) */
+
+#define MM_HEAPPROF_ALLOC(mem, size)
+#define MM_HEAPPROF_FREE(mem)
+
+#endif /* CONFIG_MM_HEAPPROF && (CONFIG_BUILD_FLAT || __KERNEL__) */
+#endif /* __INCLUDE_NUTTX_MM_HEAPPROF_H */
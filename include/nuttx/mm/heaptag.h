@@ -0,0 +1,196 @@
+/****************************************************************************
+ * include/nuttx/mm/heaptag.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_MM_HEAPTAG_H
+#define __INCLUDE_NUTTX_MM_HEAPTAG_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+
+#if defined(CONFIG_MM_HEAPTAG) && \
+    (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The subsystem tags.  Memory gets MM_HEAPTAG_OTHER when it is allocated
+ * and the tag of the subsystem whose sources are built with
+ * MM_HEAPTAG_SUBSYS defined when kmm_xxx() or kumm_xxx() return it there,
+ * see include/nuttx/kmalloc.h.
+ */
+
+#define MM_HEAPTAG_OTHER             0
+#define MM_HEAPTAG_SCHED             1
+#define MM_HEAPTAG_FS                2
+#define MM_HEAPTAG_NET               3
+#define MM_HEAPTAG_DRIVERS           4
+#define MM_HEAPTAG_NTAGS             5
+
+#define MM_HEAPTAG_NAMES \
+  { "other", "sched", "fs", "net", "drivers" }
+
+/* Called by the allocator front ends */
+
+#define MM_HEAPTAG_ALLOC(mem, size) \
+  do \
+    { \
+      if ((mem) != NULL) \
+        { \
+          mm_heaptag_alloc(mem, size); \
+        } \
+    } \
+  while (0)
+
+#define MM_HEAPTAG_FREE(mem) mm_heaptag_free(mem)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The accounting of one tag or of one thread */
+
+struct mm_heaptag_s
+{
+  pid_t         pid;    /* The thread, unused for the tags */
+  unsigned long nlive;  /* The number of live allocations */
+  size_t        live;   /* Their bytes */
+  size_t        peak;   /* The highest value of live */
+  unsigned long nalloc; /* The number of allocations ever made */
+  uint64_t      alloc;  /* Their bytes */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: mm_heaptag_alloc
+ *
+ * Description:
+ *   Account the allocation of 'mem' to MM_HEAPTAG_OTHER and to the
+ *   calling thread.
+ *
+ ****************************************************************************/
+
+void mm_heaptag_alloc(FAR void *mem, size_t size);
+
+/****************************************************************************
+ * Name: mm_heaptag_free
+ *
+ * Description:
+ *   Take the freed 'mem' out of the accounting.
+ *
+ ****************************************************************************/
+
+void mm_heaptag_free(FAR void *mem);
+
+/****************************************************************************
+ * Name: mm_heaptag_set
+ *
+ * Description:
+ *   Move the accounting of 'mem' to 'tag'.
+ *
+ * Input Parameters:
+ *   mem - The memory just returned by an allocator, may be NULL
+ *   tag - One of MM_HEAPTAG_xxx
+ *
+ * Returned Value:
+ *   mem, so that the call can wrap the allocator.
+ *
+ ****************************************************************************/
+
+FAR void *mm_heaptag_set(FAR void *mem, int tag);
+
+/****************************************************************************
+ * Name: mm_heaptag_tag
+ *
+ * Description:
+ *   Return a snapshot of the accounting of one tag.
+ *
+ * Input Parameters:
+ *   tag  - One of MM_HEAPTAG_xxx
+ *   info - The location to return the accounting in
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOENT if there is no such tag.
+ *
+ ****************************************************************************/
+
+int mm_heaptag_tag(int tag, FAR struct mm_heaptag_s *info);
+
+/****************************************************************************
+ * Name: mm_heaptag_task
+ *
+ * Description:
+ *   Return a snapshot of the accounting of one thread.
+ *
+ * Input Parameters:
+ *   index - The index of the thread, starting at zero
+ *   info  - The location to return the accounting in
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EAGAIN if the slot 'index' is not in use;
+ *   -ENOENT if there is no slot 'index'.
+ *
+ ****************************************************************************/
+
+int mm_heaptag_task(unsigned int index, FAR struct mm_heaptag_s *info);
+
+/****************************************************************************
+ * Name: mm_heaptag_dropped
+ *
+ * Description:
+ *   Return the number of allocations that are not accounted because a
+ *   table was full.
+ *
+ ****************************************************************************/
+
+unsigned long mm_heaptag_dropped(void);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#else /* CONFIG_MM_HEAPTAG && (CONFIG_BUILD_FLAT || __KERNEL__) */
+
+#define MM_HEAPTAG_ALLOC(mem, size)
+#define MM_HEAPTAG_FREE(mem)
+
+#endif /* CONFIG_MM_HEAPTAG && (CONFIG_BUILD_FLAT || __KERNEL__) */
+#endif /* __INCLUDE_NUTTX_MM_HEAPTAG_H */
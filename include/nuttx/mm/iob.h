@@ -36,6 +36,10 @@
 #  include <nuttx/wqueue.h>
 #endif
 
+#ifdef CONFIG_IOB_SHARE
+#  include <nuttx/atomic.h>
+#endif
+
 #ifdef CONFIG_MM_IOB
 
 /****************************************************************************
@@ -130,6 +134,14 @@ struct iob_s
 #ifdef CONFIG_IOB_ALLOC
   iob_free_cb_t io_free;  /* Custom free callback */
   FAR uint8_t  *io_data;
+#  ifdef CONFIG_IOB_SHARE
+  /* The IOB whose payload this one references, and the number of other
+   * users of the payload of this IOB.
+   */
+
+  FAR struct iob_s *io_shared;
+  atomic_int    io_refs;
+#  endif
 #else
   uint8_t       io_data[CONFIG_IOB_BUFSIZE];
 #endif
@@ -221,6 +233,27 @@ FAR struct iob_s *iob_alloc(bool throttled);
 
 FAR struct iob_s *iob_tryalloc(bool throttled);
 
+/****************************************************************************
+ * Name: iob_alloc_batch
+ *
+ * Description:
+ *   Allocate up to 'n' I/O buffers without waiting.  This is cheaper than
+ *   calling iob_tryalloc() 'n' times because the free list is only locked
+ *   once.
+ *
+ * Input Parameters:
+ *   iobs      - Array that receives the allocated buffers
+ *   n         - The number of buffers wanted
+ *   throttled - An indication of the IOB allocation is "throttled"
+ *
+ * Returned Value:
+ *   The number of buffers returned in 'iobs'; may be anything from zero to
+ *   'n'.
+ *
+ ****************************************************************************/
+
+int iob_alloc_batch(FAR struct iob_s **iobs, int n, bool throttled);
+
 #ifdef CONFIG_IOB_ALLOC
 /****************************************************************************
  * Name: iob_alloc_dynamic
@@ -299,6 +332,21 @@ int iob_qentry_navail(void);
 
 FAR struct iob_s *iob_free(FAR struct iob_s *iob);
 
+/****************************************************************************
+ * Name: iob_free_batch
+ *
+ * Description:
+ *   Free 'n' I/O buffer chains at once.  This is the counterpart of
+ *   iob_alloc_batch(): the free list is only locked once for all of them.
+ *
+ * Input Parameters:
+ *   iobs - Array of the buffer chains to free
+ *   n    - The number of entries in 'iobs'
+ *
+ ****************************************************************************/
+
+void iob_free_batch(FAR struct iob_s **iobs, int n);
+
 /****************************************************************************
  * Name: iob_notifier_setup
  *
@@ -545,6 +593,31 @@ int iob_clone_partial(FAR struct iob_s *iob1, unsigned int len,
                       int offset1, FAR struct iob_s *iob2,
                       int offset2, bool throttled, bool block);
 
+#ifdef CONFIG_IOB_SHARE
+/****************************************************************************
+ * Name: iob_share
+ *
+ * Description:
+ *   Create a chain that references 'len' bytes of iob, starting at
+ *   'offset', without copying them.  Each buffer of the new chain points
+ *   into the payload of a buffer of iob, which is kept until both chains
+ *   are freed.  The data of both chains must not be modified after this;
+ *   trimming either chain is fine.
+ *
+ * Input Parameters:
+ *   iob    - Pointer to source iob_s
+ *   len    - Number of bytes to reference
+ *   offset - Offset of the first byte in iob
+ *
+ * Returned Value:
+ *   The new chain, or NULL if len is zero or memory is exhausted.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_share(FAR struct iob_s *iob, unsigned int len,
+                            unsigned int offset);
+#endif
+
 /****************************************************************************
  * Name: iob_concat
  *
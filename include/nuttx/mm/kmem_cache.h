@@ -0,0 +1,135 @@
+/****************************************************************************
+ * include/nuttx/mm/kmem_cache.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_MM_KMEM_CACHE_H
+#define __INCLUDE_NUTTX_MM_KMEM_CACHE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+
+#if defined(CONFIG_MM_KMEM_CACHE) && \
+    (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* A cache of equally sized kernel objects, backed by a mempool */
+
+struct kmem_cache_s;
+
+/* The constructor is called on every object handed out by the cache */
+
+typedef CODE void (*kmem_ctor_t)(FAR void *obj, FAR void *arg);
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: kmem_cache_create
+ *
+ * Description:
+ *   Create a cache of objects of 'size' bytes.  The objects are carved
+ *   from chunks of CONFIG_MM_KMEM_CACHE_EXPANDSIZE bytes that are not
+ *   shared with any other allocation, and each chunk starts at a
+ *   different offset (color) so that the objects of different chunks
+ *   spread over the data cache sets.  The cache shows up in
+ *   /proc/mempool under 'name'.
+ *
+ * Input Parameters:
+ *   name  - The name of the cache, must stay valid until it is destroyed
+ *   size  - The size of each object
+ *   align - The alignment of each object, a power of two or zero for the
+ *           default alignment
+ *   ctor  - An optional constructor called on every allocated object
+ *   arg   - The argument passed to the constructor
+ *
+ * Returned Value:
+ *   The new cache on success; NULL on failure.
+ *
+ ****************************************************************************/
+
+FAR struct kmem_cache_s *kmem_cache_create(FAR const char *name,
+                                           size_t size, size_t align,
+                                           kmem_ctor_t ctor, FAR void *arg);
+
+/****************************************************************************
+ * Name: kmem_cache_destroy
+ *
+ * Description:
+ *   Destroy a cache and release its memory.  All objects must have been
+ *   returned to the cache.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EBUSY if objects are still allocated.
+ *
+ ****************************************************************************/
+
+int kmem_cache_destroy(FAR struct kmem_cache_s *cache);
+
+/****************************************************************************
+ * Name: kmem_cache_alloc and kmem_cache_zalloc
+ *
+ * Description:
+ *   Allocate an object from the cache.  kmem_cache_zalloc() zeroes the
+ *   object before the constructor is called.
+ *
+ * Returned Value:
+ *   The object on success; NULL if there is no memory.
+ *
+ ****************************************************************************/
+
+FAR void *kmem_cache_alloc(FAR struct kmem_cache_s *cache);
+FAR void *kmem_cache_zalloc(FAR struct kmem_cache_s *cache);
+
+/****************************************************************************
+ * Name: kmem_cache_free
+ *
+ * Description:
+ *   Return an object allocated by kmem_cache_alloc() to its cache.
+ *
+ ****************************************************************************/
+
+void kmem_cache_free(FAR struct kmem_cache_s *cache, FAR void *obj);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CONFIG_MM_KMEM_CACHE && (CONFIG_BUILD_FLAT || __KERNEL__) */
+#endif /* __INCLUDE_NUTTX_MM_KMEM_CACHE_H */
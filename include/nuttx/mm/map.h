@@ -32,6 +32,9 @@
 #include <nuttx/mutex.h>
 #include <nuttx/mm/gran.h>
 
+#include <stdint.h>
+#include <sys/tree.h>
+
 /****************************************************************************
  * Forward declarations
  ****************************************************************************/
@@ -42,11 +45,15 @@ struct task_group_s;
  * Public Types
  ****************************************************************************/
 
-/* A memory mapping list item */
+/* A memory mapping.  The mappings of a task group are kept in a red-black
+ * tree sorted by address, each node holding the highest end address of
+ * its subtree, which makes it an interval tree.
+ */
 
 struct mm_map_entry_s
 {
-  FAR struct mm_map_entry_s *flink;  /* this is used as sq_entry_t */
+  RB_ENTRY(mm_map_entry_s) node;     /* In the tree of the mappings */
+  uintptr_t maxend;                  /* Highest end address of the subtree */
   FAR void *vaddr;
   size_t length;
   off_t offset;
@@ -78,8 +85,10 @@ struct mm_map_entry_s
 
 struct mm_map_s
 {
-  sq_queue_t mm_map_sq;         /* mappings list */
-  size_t map_count;             /* mappings list length */
+  /* mappings tree */
+
+  RB_HEAD(mm_map_tree_s, mm_map_entry_s) mm_map_tree;
+  size_t map_count;             /* number of mappings */
 
 #ifdef CONFIG_ARCH_VMA_MAPPING
   GRAN_HANDLE mm_map_vpages;    /* SHM virtual zone allocator */
@@ -264,7 +273,7 @@ int mm_map_add(FAR struct mm_map_s *mm, FAR struct mm_map_entry_s *entry);
  * Name: mm_map_next
  *
  * Description:
- *   Returns the next mapping in the list, following the argument.
+ *   Returns the next mapping in address order, following the argument.
  *   Can be used to iterate through all the mappings. Returns the first
  *   mapping when the argument "entry" is NULL.
  *
@@ -285,7 +294,8 @@ FAR struct mm_map_entry_s *mm_map_next(FAR struct mm_map_s *mm,
  * Name: mm_map_find
  *
  * Description:
- *   Find the first mapping matching address and length
+ *   Find the mapping, of the lowest address, that contains the range from
+ *   vaddr of the length
  *
  * Input Parameters:
  *   mm     - A pointer to mm_map_s, which describes the virtual memory area
@@ -327,4 +337,30 @@ FAR struct mm_map_entry_s *mm_map_find(FAR struct mm_map_s *mm,
 int mm_map_remove(FAR struct mm_map_s *mm,
                   FAR struct mm_map_entry_s *entry);
 
+/****************************************************************************
+ * Name: mm_map_update
+ *
+ * Description:
+ *   Change the address and the length of a mapping.  The fields of a
+ *   mapping in the tree must not be changed directly, since the tree is
+ *   sorted by them.
+ *
+ * Input Parameters:
+ *   mm      - Pointer to the tree of the mappings.  If passed mm is NULL,
+ *             only the fields of the entry are changed.
+ *   entry   - Pointer to the entry to be changed
+ *   vaddr   - New start address of the mapping
+ *   length  - New length of the mapping
+ *
+ * Returned Value:
+ *   OK:       Changed successfully
+ *   -EINTR:   The wait was interrupted by the receipt of a signal.
+ *   -ENOENT:  Memory area not found, the fields are changed anyway
+ *
+ ****************************************************************************/
+
+int mm_map_update(FAR struct mm_map_s *mm,
+                  FAR struct mm_map_entry_s *entry,
+                  FAR void *vaddr, size_t length);
+
 #endif /* __INCLUDE_NUTTX_MM_MAP_H */
@@ -93,6 +93,18 @@ struct mempool_procfs_entry_s
 };
 #endif
 
+#if CONFIG_MM_MEMPOOL_PERCPU_CACHE > 0
+/* This structure describes the free blocks cached by one CPU */
+
+struct mempool_cache_s
+{
+  FAR sq_entry_t *head;  /* The list of cached free blocks */
+  size_t          count; /* The number of blocks in the list */
+  unsigned long   nhit;  /* The number of allocations served by the cache */
+  unsigned long   nmiss; /* The number of allocations that missed the cache */
+};
+#endif
+
 /* This structure describes memory buffer pool */
 
 struct mempool_s
@@ -116,6 +128,9 @@ struct mempool_s
   size_t     nalloc;  /* The number of used block in mempool */
   spinlock_t lock;    /* The protect lock to mempool */
   sem_t      waitsem; /* The semaphore of waiter get free block */
+#if CONFIG_MM_MEMPOOL_PERCPU_CACHE > 0
+  struct mempool_cache_s cache[CONFIG_SMP_NCPUS]; /* The per-CPU free blocks */
+#endif
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMPOOL)
   struct mempool_procfs_entry_s procfs; /* The entry of procfs */
 #endif
@@ -143,6 +158,10 @@ struct mempoolinfo_s
   unsigned long aordblks; /* This is the number of used blocks */
   unsigned long sizeblks; /* This is the size of a mempool blocks */
   unsigned long nwaiter;  /* This is the number of waiter for mempool */
+#if CONFIG_MM_MEMPOOL_PERCPU_CACHE > 0
+  unsigned long nhit;     /* This is the number of per-CPU cache hits */
+  unsigned long nmiss;    /* This is the number of per-CPU cache misses */
+#endif
 };
 
 /****************************************************************************
@@ -478,6 +497,22 @@ FAR void *mempool_multiple_memalign(FAR struct mempool_multiple_s *mpool,
 void mempool_multiple_memdump(FAR struct mempool_multiple_s *mpool,
                               FAR const struct mm_memdump_s *dump);
 
+/****************************************************************************
+ * Name: mempool_multiple_histogram
+ *
+ * Description:
+ *   Print the request size histogram of a multiple mempool to the syslog,
+ *   in the format that tools/mempooltune.py expects.
+ *
+ * Input Parameters:
+ *   mpool - The handle of multiple memory pool to be used.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_HEAP_MEMPOOL_HISTOGRAM
+void mempool_multiple_histogram(FAR struct mempool_multiple_s *mpool);
+#endif
+
 /****************************************************************************
  * Name: mempool_multiple_deinit
  *
@@ -108,6 +108,17 @@
 
 #define mm_memdump_s malltask
 
+/* Attributes of the memory behind a heap registered with
+ * kmm_attr_register(), used as placement hints by kmm_malloc_attr().
+ */
+
+#define MM_ATTR_FAST        (1 << 0) /* Low latency memory, e.g. TCM/SRAM */
+#define MM_ATTR_DMA         (1 << 1) /* Reachable by the DMA masters */
+#define MM_ATTR_CACHEABLE   (1 << 2) /* Accessed through the data cache */
+#define MM_ATTR_STRICT      (1 << 7) /* Fail instead of using the kernel heap */
+
+#define MM_NODE_ANY         (-1)     /* Any memory node */
+
 #if defined(CONFIG_ARCH_ADDRENV) && defined(CONFIG_BUILD_KERNEL)
 /* In the kernel build, there are multiple user heaps; one for each task
  * group.  In this build configuration, the user heap structure lies
@@ -367,6 +378,20 @@ bool umm_heapmember(FAR void *mem);
 bool kmm_heapmember(FAR void *mem);
 #endif
 
+/* Functions contained in kmm_attr.c ****************************************/
+
+#if defined(CONFIG_MM_HEAP_ATTR) && \
+    (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+int kmm_attr_register(FAR struct mm_heap_s *heap, uint32_t attr, int node);
+FAR void *kmm_malloc_attr(uint32_t attr, int node, size_t size)
+  malloc_like1(3);
+FAR void *kmm_zalloc_attr(uint32_t attr, int node, size_t size)
+  malloc_like1(3);
+FAR void *kmm_memalign_attr(uint32_t attr, int node, size_t alignment,
+                            size_t size) malloc_like1(4);
+void kmm_free_attr(FAR void *mem);
+#endif
+
 /* Functions contained in mm_brkaddr.c **************************************/
 
 FAR void *mm_brkaddr(FAR struct mm_heap_s *heap, int region);
@@ -32,6 +32,7 @@
 #include <nuttx/fs/fs.h>
 #include <nuttx/signal.h>
 #include <nuttx/list.h>
+#include <nuttx/spinlock.h>
 
 #include <sys/types.h>
 #include <stdint.h>
@@ -108,12 +109,25 @@ struct mqueue_cmn_s
   int16_t nwaitnotempty;      /* Number tasks waiting for not empty */
 };
 
+#ifdef CONFIG_MQ_ZEROCOPY
+/* One message returned by mq_msgreceivev() */
+
+struct mq_msgvec_s
+{
+  FAR void *msg;              /* The message, release with mq_msgfree() */
+  size_t msglen;              /* The length of the message */
+  unsigned int prio;          /* The priority of the message */
+};
+#endif
+
 /* This structure defines a message queue */
 
 struct mqueue_inode_s
 {
   struct mqueue_cmn_s cmn;    /* Common prologue */
   FAR struct inode *inode;    /* Containing inode */
+  spinlock_t lock;            /* Protects msglist, nmsgs and the waiter
+                               * registration, see sched/mqueue/mqueue.h */
   struct list_node msglist;   /* Prioritized message list */
   int16_t maxmsgs;            /* Maximum number of messages in the queue */
   int16_t nmsgs;              /* Number of message in the queue */
@@ -793,6 +807,104 @@ int file_mq_setattr(FAR struct file *mq, FAR const struct mq_attr *mq_stat,
 
 int file_mq_getattr(FAR struct file *mq, FAR struct mq_attr *mq_stat);
 
+#ifdef CONFIG_MQ_ZEROCOPY
+/****************************************************************************
+ * Name: mq_msgalloc
+ *
+ * Description:
+ *   Take a message buffer from the message pool, to be filled in place and
+ *   posted with mq_msgsend() or released with mq_msgfree().  The buffer
+ *   has room for the maximum message size of the queue.
+ *
+ * Input Parameters:
+ *   mqdes - Message queue descriptor, opened for writing
+ *
+ * Returned Value:
+ *   The message buffer, or NULL with errno set on failure.
+ *
+ ****************************************************************************/
+
+FAR void *mq_msgalloc(mqd_t mqdes);
+
+/****************************************************************************
+ * Name: mq_msgsend
+ *
+ * Description:
+ *   Post a message buffer from mq_msgalloc() to the queue, without copying
+ *   it.  The buffer belongs to the queue once this succeeds, otherwise it
+ *   still belongs to the caller.  Blocks like mq_send() if the queue is
+ *   full.
+ *
+ * Input Parameters:
+ *   mqdes  - Message queue descriptor
+ *   msg    - The message buffer
+ *   msglen - The length of the message in bytes
+ *   prio   - The priority of the message
+ *
+ * Returned Value:
+ *   Zero (OK) on success, or -1 (ERROR) with errno set on failure.
+ *
+ ****************************************************************************/
+
+int mq_msgsend(mqd_t mqdes, FAR void *msg, size_t msglen,
+               unsigned int prio);
+
+/****************************************************************************
+ * Name: mq_msgreceive
+ *
+ * Description:
+ *   Receive the oldest of the highest priority messages, like mq_receive()
+ *   but without copying it.  The message must be released with
+ *   mq_msgfree().
+ *
+ * Input Parameters:
+ *   mqdes - Message queue descriptor, opened for reading
+ *   msg   - The location to return the message
+ *   prio  - If not NULL, the location to store message priority
+ *
+ * Returned Value:
+ *   The length of the message, or -1 (ERROR) with errno set on failure.
+ *
+ ****************************************************************************/
+
+ssize_t mq_msgreceive(mqd_t mqdes, FAR void **msg, FAR unsigned int *prio);
+
+/****************************************************************************
+ * Name: mq_msgreceivev
+ *
+ * Description:
+ *   Receive up to 'nvec' messages at once, in priority order.  Waits like
+ *   mq_receive() for the first message only.  Each message must be
+ *   released with mq_msgfree().
+ *
+ * Input Parameters:
+ *   mqdes - Message queue descriptor, opened for reading
+ *   vec   - The location to return the messages
+ *   nvec  - The maximum number of messages
+ *
+ * Returned Value:
+ *   The number of messages received, or -1 (ERROR) with errno set on
+ *   failure.
+ *
+ ****************************************************************************/
+
+int mq_msgreceivev(mqd_t mqdes, FAR struct mq_msgvec_s *vec, int nvec);
+
+/****************************************************************************
+ * Name: mq_msgfree
+ *
+ * Description:
+ *   Release a message from mq_msgreceive(), mq_msgreceivev() or an unsent
+ *   one from mq_msgalloc().
+ *
+ * Input Parameters:
+ *   msg - The message buffer
+ *
+ ****************************************************************************/
+
+void mq_msgfree(FAR void *msg);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
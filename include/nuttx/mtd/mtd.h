@@ -33,6 +33,11 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+#ifdef CONFIG_MTD_STATISTICS
+#  include <errno.h>
+#  include <string.h>
+#endif
+
 #include <nuttx/fs/ioctl.h>
 
 /****************************************************************************
@@ -77,15 +82,29 @@
                                              *      erased state of the MTD cell */
 #define MTDIOC_ERASESECTORS _MTDIOC(0x000c) /* IN: Pointer to mtd_erase_s structure
                                              * OUT: None */
+#define MTDIOC_GETSTATS     _MTDIOC(0x000d) /* IN:  Pointer to write-able struct
+                                             *      mtd_stats_s
+                                             * OUT: Access counters of the MTD */
+#define MTDIOC_RESETSTATS   _MTDIOC(0x000e) /* IN:  None
+                                             * OUT: None */
 
 /* Macros to hide implementation */
 
-#define MTD_ERASE(d,s,n)   ((d)->erase   ? (d)->erase(d,s,n)    : (-ENOSYS))
-#define MTD_BREAD(d,s,n,b) ((d)->bread   ? (d)->bread(d,s,n,b)  : (-ENOSYS))
-#define MTD_BWRITE(d,s,n,b)((d)->bwrite  ? (d)->bwrite(d,s,n,b) : (-ENOSYS))
-#define MTD_READ(d,s,n,b)  ((d)->read    ? (d)->read(d,s,n,b)   : (-ENOSYS))
-#define MTD_WRITE(d,s,n,b) ((d)->write   ? (d)->write(d,s,n,b)  : (-ENOSYS))
-#define MTD_IOCTL(d,c,a)   ((d)->ioctl   ? (d)->ioctl(d,c,a)    : (-ENOSYS))
+#ifdef CONFIG_MTD_STATISTICS
+#  define MTD_ERASE(d,s,n)   mtd_stats_erase(d,s,n)
+#  define MTD_BREAD(d,s,n,b) mtd_stats_bread(d,s,n,b)
+#  define MTD_BWRITE(d,s,n,b)mtd_stats_bwrite(d,s,n,b)
+#  define MTD_READ(d,s,n,b)  mtd_stats_read(d,s,n,b)
+#  define MTD_WRITE(d,s,n,b) mtd_stats_write(d,s,n,b)
+#  define MTD_IOCTL(d,c,a)   mtd_stats_ioctl(d,c,a)
+#else
+#  define MTD_ERASE(d,s,n)   ((d)->erase   ? (d)->erase(d,s,n)    : (-ENOSYS))
+#  define MTD_BREAD(d,s,n,b) ((d)->bread   ? (d)->bread(d,s,n,b)  : (-ENOSYS))
+#  define MTD_BWRITE(d,s,n,b)((d)->bwrite  ? (d)->bwrite(d,s,n,b) : (-ENOSYS))
+#  define MTD_READ(d,s,n,b)  ((d)->read    ? (d)->read(d,s,n,b)   : (-ENOSYS))
+#  define MTD_WRITE(d,s,n,b) ((d)->write   ? (d)->write(d,s,n,b)  : (-ENOSYS))
+#  define MTD_IOCTL(d,c,a)   ((d)->ioctl   ? (d)->ioctl(d,c,a)    : (-ENOSYS))
+#endif
 #define MTD_ISBAD(d,b)     ((d)->isbad   ? (d)->isbad(d,b)      : (-ENOSYS))
 #define MTD_MARKBAD(d,b)   ((d)->markbad ? (d)->markbad(d,b)    : (-ENOSYS))
 
@@ -150,6 +169,21 @@ struct mtd_erase_s
   uint32_t nblocks;     /* Number of blocks to be erased */
 };
 
+/* The access counters of an MTD device, returned by MTDIOC_GETSTATS.  Each
+ * layer (partition, read/write buffer, FTL, driver) counts the accesses
+ * made to it, so that the write amplification of a file system is the
+ * ratio of the counters of the driver to the ones of the top layer.
+ */
+
+struct mtd_stats_s
+{
+  uint64_t nerase;      /* Number of erase blocks erased */
+  uint64_t nbread;      /* Number of blocks read by bread() */
+  uint64_t nbwrite;     /* Number of blocks written by bwrite() */
+  uint64_t nread;       /* Number of bytes read by read() */
+  uint64_t nwrite;      /* Number of bytes written by write() */
+};
+
 /* This structure defines the interface to a simple memory technology device.
  * It will likely need to be extended in the future to support more complex
  * devices.
@@ -207,8 +241,118 @@ struct mtd_dev_s
   /* Name of this MTD device */
 
   FAR const char *name;
+
+#ifdef CONFIG_MTD_STATISTICS
+  /* Access counters, maintained by the MTD_xxx() macros */
+
+  struct mtd_stats_s stats;
+#endif
 };
 
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_STATISTICS
+static inline int mtd_stats_erase(FAR struct mtd_dev_s *dev,
+                                  off_t startblock, size_t nblocks)
+{
+  int ret = dev->erase ? dev->erase(dev, startblock, nblocks) : -ENOSYS;
+
+  if (ret >= 0)
+    {
+      dev->stats.nerase += nblocks;
+    }
+
+  return ret;
+}
+
+static inline ssize_t mtd_stats_bread(FAR struct mtd_dev_s *dev,
+                                      off_t startblock, size_t nblocks,
+                                      FAR uint8_t *buffer)
+{
+  ssize_t ret = dev->bread ?
+                dev->bread(dev, startblock, nblocks, buffer) : -ENOSYS;
+
+  if (ret > 0)
+    {
+      dev->stats.nbread += ret;
+    }
+
+  return ret;
+}
+
+static inline ssize_t mtd_stats_bwrite(FAR struct mtd_dev_s *dev,
+                                       off_t startblock, size_t nblocks,
+                                       FAR const uint8_t *buffer)
+{
+  ssize_t ret = dev->bwrite ?
+                dev->bwrite(dev, startblock, nblocks, buffer) : -ENOSYS;
+
+  if (ret > 0)
+    {
+      dev->stats.nbwrite += ret;
+    }
+
+  return ret;
+}
+
+static inline ssize_t mtd_stats_read(FAR struct mtd_dev_s *dev,
+                                     off_t offset, size_t nbytes,
+                                     FAR uint8_t *buffer)
+{
+  ssize_t ret = dev->read ?
+                dev->read(dev, offset, nbytes, buffer) : -ENOSYS;
+
+  if (ret > 0)
+    {
+      dev->stats.nread += ret;
+    }
+
+  return ret;
+}
+
+#ifdef CONFIG_MTD_BYTE_WRITE
+static inline ssize_t mtd_stats_write(FAR struct mtd_dev_s *dev,
+                                      off_t offset, size_t nbytes,
+                                      FAR const uint8_t *buffer)
+{
+  ssize_t ret = dev->write ?
+                dev->write(dev, offset, nbytes, buffer) : -ENOSYS;
+
+  if (ret > 0)
+    {
+      dev->stats.nwrite += ret;
+    }
+
+  return ret;
+}
+#endif
+
+static inline int mtd_stats_ioctl(FAR struct mtd_dev_s *dev, int cmd,
+                                  unsigned long arg)
+{
+  switch (cmd)
+    {
+      case MTDIOC_GETSTATS:
+        if (arg == 0)
+          {
+            return -EINVAL;
+          }
+
+        memcpy((FAR void *)arg, &dev->stats, sizeof(struct mtd_stats_s));
+        return OK;
+
+      case MTDIOC_RESETSTATS:
+        memset(&dev->stats, 0, sizeof(struct mtd_stats_s));
+        return OK;
+
+      default:
+        return dev->ioctl ? dev->ioctl(dev, cmd, arg) : -ENOSYS;
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -52,6 +52,9 @@ struct mutex_s
 #if CONFIG_LIBC_MUTEX_BACKTRACE > 0
   FAR void *backtrace[CONFIG_LIBC_MUTEX_BACKTRACE];
 #endif
+#ifdef CONFIG_SCHED_LOCKSTAT
+  clock_t acquired;
+#endif
 };
 
 typedef struct mutex_s mutex_t;
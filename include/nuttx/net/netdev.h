@@ -162,6 +162,13 @@
 #    define NETDEV_RXARP(dev)
 #  endif
 #  define NETDEV_RXDROPPED(dev)   _NETDEV_STATISTIC(dev,rx_dropped)
+#  ifdef CONFIG_NETDEV_NAPI
+#    define NETDEV_RXINTERRUPTS(dev) _NETDEV_STATISTIC(dev,rx_interrupts)
+#    define NETDEV_RXPOLLS(dev)   _NETDEV_STATISTIC(dev,rx_polls)
+#  else
+#    define NETDEV_RXINTERRUPTS(dev)
+#    define NETDEV_RXPOLLS(dev)
+#  endif
 
 #  define NETDEV_TXPACKETS(dev) \
     do { \
@@ -183,6 +190,8 @@
 #  define NETDEV_RXIPV6(dev)
 #  define NETDEV_RXARP(dev)
 #  define NETDEV_RXDROPPED(dev)
+#  define NETDEV_RXINTERRUPTS(dev)
+#  define NETDEV_RXPOLLS(dev)
 
 #  define NETDEV_TXPACKETS(dev)
 #  define NETDEV_TXDONE(dev)
@@ -216,6 +225,41 @@
      (netdev_ipv6_lookup(dev, addr, true) != NULL)
 #endif
 
+/* Offload features of a network device (d_features).
+ *
+ * NETDEV_F_RXCSUM - The hardware verifies TCP/UDP checksums.  The driver
+ *                   sets d_rxcsum for each packet that was verified.
+ * NETDEV_F_TXCSUM - The hardware fills in TCP/UDP checksums.  The stack
+ *                   leaves the checksum field of such packets zero and the
+ *                   driver prepares them with netpkt_chksum_prepare().
+ * NETDEV_F_TSO    - The hardware segments TCP packets larger than the MTU
+ *                   into d_gso_size sized segments.
+ */
+
+#define NETDEV_F_RXCSUM  (1 << 0)
+#define NETDEV_F_TXCSUM  (1 << 1)
+#define NETDEV_F_TSO     (1 << 2)
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+#  define NETDEV_RXCSUM_VALID(dev) ((dev)->d_rxcsum)
+#else
+#  define NETDEV_RXCSUM_VALID(dev) false
+#endif
+
+#ifdef CONFIG_NETDEV_CHKSUM_OFFLOAD
+#  define NETDEV_TXCSUM(dev) (((dev)->d_features & NETDEV_F_TXCSUM) != 0)
+#else
+#  define NETDEV_TXCSUM(dev) false
+#endif
+
+#ifdef CONFIG_NETDEV_GSO
+#  define NETDEV_TSO(dev)      (((dev)->d_features & NETDEV_F_TSO) != 0)
+#  define NETDEV_GSO_SIZE(dev) ((dev)->d_gso_size)
+#else
+#  define NETDEV_TSO(dev)      false
+#  define NETDEV_GSO_SIZE(dev) 0
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -244,6 +288,10 @@ struct netdev_statistics_s
 #endif
   uint32_t rx_dropped;     /* Unsupported Rx packets received */
   uint64_t rx_bytes;       /* Number of bytes received */
+#ifdef CONFIG_NETDEV_NAPI
+  uint32_t rx_interrupts;  /* Number of RX interrupts (rxready calls) */
+  uint32_t rx_polls;       /* Number of RX polls of the device */
+#endif
 
   /* Tx Status */
 
@@ -339,6 +387,24 @@ struct net_driver_s
 
   uint16_t d_pktsize;           /* Maximum packet size */
 
+#ifdef CONFIG_NETDEV_OFFLOAD
+  uint8_t d_features;           /* Offload features, see NETDEV_F_* */
+  bool d_rxcsum;                /* TCP/UDP checksum of the received
+                                 * packet was already verified */
+#endif
+
+#ifdef CONFIG_NETDEV_GSO
+  /* Generic segmentation offload.  Before polling the stack the driver
+   * sets d_gso_maxsegs to the number of packets it can take at once.  If
+   * TCP then sends a packet with more than one MSS of data it sets
+   * d_gso_size to the MSS, and the driver sends it as d_gso_size sized
+   * segments.
+   */
+
+  uint8_t d_gso_maxsegs;        /* Segments the driver can take, 0: no GSO */
+  uint16_t d_gso_size;          /* MSS of the outgoing packet, 0: no GSO */
+#endif
+
   /* Link layer address */
 
 #if defined(CONFIG_NET_ETHERNET) || defined(CONFIG_NET_6LOWPAN) || \
@@ -91,6 +91,32 @@ enum netpkt_type_e
   NETPKT_TYPENUM
 };
 
+/* The verdicts of an RX hook on a received packet */
+
+#ifdef CONFIG_NETDEV_RXHOOK
+enum netdev_rxhook_e
+{
+  NETDEV_RXHOOK_PASS,     /* Give the packet to the network stack */
+  NETDEV_RXHOOK_DROP,     /* Free the packet */
+  NETDEV_RXHOOK_REDIRECT, /* Send the packet out of another device */
+  NETDEV_RXHOOK_PKT       /* Give the packet to the packet sockets only */
+};
+
+/* An RX hook looks at each packet received by the device, from
+ * netpkt_getdata() on, before the network stack does, and returns its
+ * verdict.  With NETDEV_RXHOOK_REDIRECT it also sets *target to the device
+ * to send the packet out of; the packet may be modified then, e.g. its MAC
+ * addresses.  It is called from the RX poll of the device and must not
+ * block nor call into the network stack.
+ */
+
+struct netdev_lowerhalf_s;
+typedef CODE enum netdev_rxhook_e
+  (*netdev_rxhook_t)(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt,
+                     FAR void *arg,
+                     FAR struct netdev_lowerhalf_s **target);
+#endif
+
 /* This structure is the generic form of state structure used by lower half
  * netdev driver. This state structure is passed to the netdev driver when
  * the driver is initialized. Then, on subsequent callbacks into the lower
@@ -119,6 +145,15 @@ struct netdev_lowerhalf_s
 
   atomic_int quota[NETPKT_TYPENUM];
 
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  /* Number of RX and TX queues of a multi-queue device, 0 or 1 if it only
+   * has one.  Set before netdev_lower_register().
+   */
+
+  uint8_t rxqueues;
+  uint8_t txqueues;
+#endif
+
   /* The structure used by net stack.
    * Note: Do not change its fields unless you know what you are doing.
    *
@@ -172,6 +207,38 @@ struct netdev_ops_s
   /* reclaim - try to reclaim packets sent by netdev. */
 
   CODE void (*reclaim)(FAR struct netdev_lowerhalf_s *dev);
+
+#ifdef CONFIG_NETDEV_NAPI
+  /* rxirq - Mask (enable = false) or unmask the RX interrupt, optional.
+   *   Called from netdev_lower_rxready() to mask it, so it must be safe
+   *   to call from the interrupt handler.  If packets arrived while the
+   *   interrupt was masked, unmasking it must raise it again.
+   */
+
+  CODE void (*rxirq)(FAR struct netdev_lowerhalf_s *dev, bool enable);
+#endif
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  /* transmitq / receiveq - transmit and receive on one queue of a
+   *   multi-queue device, as transmit and receive do for a single queue.
+   *   Required when txqueues / rxqueues is above 1.  Each RX queue is only
+   *   polled by one thread, the packets of a flow always go to the same TX
+   *   queue.
+   */
+
+  CODE int (*transmitq)(FAR struct netdev_lowerhalf_s *dev,
+                        FAR netpkt_t *pkt, int queue);
+  CODE FAR netpkt_t *(*receiveq)(FAR struct netdev_lowerhalf_s *dev,
+                                 int queue);
+#endif
+
+  /* txflush - Hand the packets queued by transmit since the last call to
+   *   the hardware, optional.  Called by upper half at the end of each TX
+   *   batch, so that a driver implementing it may queue the packets in
+   *   transmit and notify the hardware only once here.
+   */
+
+  CODE void (*txflush)(FAR struct netdev_lowerhalf_s *dev);
 };
 
 /* This structure is a set of wireless handlers, leave unsupported operations
@@ -295,6 +362,25 @@ void netdev_lower_carrier_off(FAR struct netdev_lowerhalf_s *dev);
 
 void netdev_lower_rxready(FAR struct netdev_lowerhalf_s *dev);
 
+/****************************************************************************
+ * Name: netdev_lower_rxready_queue
+ *
+ * Description:
+ *   Notifies the networking layer about an RX packet is ready to read on
+ *   one queue of a multi-queue device.  The queue is polled by the work
+ *   thread of CPU (queue % CONFIG_SMP_NCPUS).
+ *
+ * Input Parameters:
+ *   dev   - The lower half device driver structure
+ *   queue - The RX queue
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+void netdev_lower_rxready_queue(FAR struct netdev_lowerhalf_s *dev,
+                                int queue);
+#endif
+
 /****************************************************************************
  * Name: netdev_lower_txdone
  *
@@ -323,6 +409,29 @@ void netdev_lower_txdone(FAR struct netdev_lowerhalf_s *dev);
 int netdev_lower_quota_load(FAR struct netdev_lowerhalf_s *dev,
                             enum netpkt_type_e type);
 
+/****************************************************************************
+ * Name: netdev_lower_rxhook
+ *
+ * Description:
+ *   Install or remove the RX hook of a device.  Only one hook may be
+ *   installed at a time.
+ *
+ * Input Parameters:
+ *   dev  - The lower half device driver structure
+ *   hook - The hook to install, NULL to remove the current one
+ *   arg  - The argument passed to the hook
+ *
+ * Returned Value:
+ *   0:Success; -EBUSY if another hook is installed, other negated errno
+ *   on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_RXHOOK
+int netdev_lower_rxhook(FAR struct netdev_lowerhalf_s *dev,
+                        netdev_rxhook_t hook, FAR void *arg);
+#endif
+
 /****************************************************************************
  * Name: netpkt_alloc
  *
@@ -510,6 +619,31 @@ bool netpkt_is_fragmented(FAR netpkt_t *pkt);
 int netpkt_to_iov(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt,
                   FAR struct iovec *iov, int iovcnt);
 
+/****************************************************************************
+ * Name: netpkt_chksum_prepare
+ *
+ * Description:
+ *   Check if the TCP/UDP checksum of an outgoing packet is to be filled in
+ *   by the hardware (see NETDEV_F_TXCSUM) and prepare the packet for it.
+ *
+ * Input Parameters:
+ *   dev    - The lower half device driver structure
+ *   pkt    - The net packet
+ *   start  - Returns the offset of the L4 header from netpkt_getdata()
+ *   offset - Returns the offset of the checksum field from 'start'
+ *
+ * Returned Value:
+ *   Zero (OK) if the hardware must complete the checksum; a negated errno
+ *   value if the packet is to be sent as is.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_CHKSUM_OFFLOAD
+int netpkt_chksum_prepare(FAR struct netdev_lowerhalf_s *dev,
+                          FAR netpkt_t *pkt, FAR unsigned int *start,
+                          FAR unsigned int *offset);
+#endif
+
 /****************************************************************************
  * Name: netpkt_tryadd_queue
  *
@@ -0,0 +1,129 @@
+/****************************************************************************
+ * include/nuttx/net/pktgen.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_NET_PKTGEN_H
+#define __INCLUDE_NUTTX_NET_PKTGEN_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <netinet/in.h>
+
+#include <nuttx/fs/ioctl.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* IOCTL commands of /dev/pktgen */
+
+#define PKTGENIOC_START     _PKTGENIOC(0x0001) /* IN:  Pointer to read-able
+                                                *      struct pktgen_config_s
+                                                * OUT: None */
+#define PKTGENIOC_STOP      _PKTGENIOC(0x0002) /* IN:  None
+                                                * OUT: None */
+#define PKTGENIOC_GETSTATS  _PKTGENIOC(0x0003) /* IN:  Pointer to write-able
+                                                *      struct pktgen_stats_s
+                                                * OUT: The counters */
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* What to generate.  The packets are IPv4/UDP frames received by the
+ * pktgen device from a peer behind it, with a payload of at least
+ * PKTGEN_MINLEN bytes holding a sequence number and a time stamp.  When
+ * dstaddr is the address of the device they are delivered to the UDP
+ * socket bound to dstport, otherwise they are forwarded (with
+ * CONFIG_NET_IPFORWARD).
+ */
+
+#define PKTGEN_MINLEN 16
+
+struct pktgen_config_s
+{
+  in_addr_t srcaddr;    /* Source address, network order */
+  in_addr_t dstaddr;    /* Destination address, network order */
+  in_port_t srcport;    /* Source UDP port, network order */
+  in_port_t dstport;    /* Destination UDP port, network order */
+  uint16_t  len;        /* UDP payload length, PKTGEN_MINLEN at least */
+  uint32_t  count;      /* Number of packets to generate, 0 without end */
+};
+
+/* The counters since the last start.  The times are in units of
+ * perf_gettime(), of frequency freq.  The latency is taken by the sink on
+ * the generated packets the stack sends back out of the device, i.e. the
+ * forwarded ones.
+ */
+
+struct pktgen_stats_s
+{
+  uint64_t rxpackets;   /* Packets generated and given to the stack */
+  uint64_t rxbytes;     /* Their bytes, Ethernet header included */
+  uint64_t txpackets;   /* Packets the stack sent to the sink */
+  uint64_t txbytes;     /* Their bytes, Ethernet header included */
+  uint64_t nlatency;    /* Number of generated packets back to the sink */
+  uint64_t latsum;      /* Sum of their latencies */
+  uint32_t latmin;      /* Smallest latency */
+  uint32_t latmax;      /* Largest latency */
+  uint64_t elapsed;     /* Time since the start, or of the run if stopped */
+  uint32_t freq;        /* Frequency of the time unit, in Hz */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: pktgen_initialize
+ *
+ * Description:
+ *   Register the pktgen network device (pg0) and its control device
+ *   /dev/pktgen.
+ *
+ * Returned Value:
+ *   OK on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_PKTGEN
+int pktgen_initialize(void);
+#endif
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_NUTTX_NET_PKTGEN_H */
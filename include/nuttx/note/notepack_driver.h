@@ -0,0 +1,94 @@
+/****************************************************************************
+ * include/nuttx/note/notepack_driver.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_NOTE_NOTEPACK_DRIVER_H
+#define __INCLUDE_NUTTX_NOTE_NOTEPACK_DRIVER_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The packed note stream, decoded by tools/notepack.py.
+ *
+ * The stream starts with a header:
+ *
+ *   "NXNP"            - Magic
+ *   u8                - NOTEPACK_VERSION
+ *   uint              - Frequency of the time stamps (perf_getfreq())
+ *
+ * It is followed by one record per note.  'uint' is an unsigned LEB128
+ * number and 'sint' a zigzag encoded signed LEB128 number:
+ *
+ *   u8                - Note type (enum note_type_e)
+ *   u8                - CPU
+ *   sint              - Time stamp minus the one of the previous record
+ *   uint              - PID
+ *   ...               - The fields of the note, in the order of the note
+ *                       structure, as uint (sint for the value of a
+ *                       counter).  Strings and data are a uint length
+ *                       followed by the bytes.
+ *
+ * The fields of note types not known to the encoder are a single data
+ * field with the bytes after the common header.
+ */
+
+#define NOTEPACK_MAGIC    "NXNP"
+#define NOTEPACK_VERSION  1
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+/****************************************************************************
+ * Name: notepack_register
+ *
+ * Description:
+ *   Register a note driver that writes the packed note stream to a file.
+ *
+ * Input Parameters:
+ *   filename - The file to write to, typically a serial port
+ *
+ * Returned Value:
+ *   Zero on success. A negated errno value is returned on a failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRIVERS_NOTEPACK
+int notepack_register(FAR const char *filename);
+#endif
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* __INCLUDE_NUTTX_NOTE_NOTEPACK_DRIVER_H */
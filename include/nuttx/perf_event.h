@@ -0,0 +1,223 @@
+/****************************************************************************
+ * include/nuttx/perf_event.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_PERF_EVENT_H
+#define __INCLUDE_NUTTX_PERF_EVENT_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <nuttx/fs/ioctl.h>
+
+#ifdef CONFIG_PERF_EVENTS
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Event types, perf_event_attr_s::type */
+
+#define PERF_TYPE_HARDWARE                0 /* config is a PERF_COUNT_HW_* */
+#define PERF_TYPE_RAW                     4 /* config is the PMU encoding */
+
+/* Generic hardware events, perf_event_attr_s::config */
+
+#define PERF_COUNT_HW_CPU_CYCLES          0
+#define PERF_COUNT_HW_INSTRUCTIONS        1
+#define PERF_COUNT_HW_CACHE_REFERENCES    2
+#define PERF_COUNT_HW_CACHE_MISSES        3
+#define PERF_COUNT_HW_BRANCH_INSTRUCTIONS 4
+#define PERF_COUNT_HW_BRANCH_MISSES       5
+#define PERF_COUNT_HW_MAX                 6
+
+/* perf_event_attr_s::flags */
+
+#define PERF_ATTR_DISABLED        (1 << 0) /* Open the event disabled */
+#define PERF_ATTR_EXCLUDE_USER    (1 << 1) /* Do not count in user mode */
+#define PERF_ATTR_EXCLUDE_KERNEL  (1 << 2) /* Do not count in kernel mode */
+
+/* perf_event_open() flags */
+
+#define PERF_FLAG_FD_CLOEXEC      (1 << 3) /* Same as O_CLOEXEC */
+
+/* ioctl() commands of the perf event file descriptors */
+
+#define PERF_EVENT_IOC_ENABLE     _PERFIOC(1) /* Arg: None */
+#define PERF_EVENT_IOC_DISABLE    _PERFIOC(2) /* Arg: None */
+#define PERF_EVENT_IOC_RESET      _PERFIOC(3) /* Arg: None, clear the count */
+#define PERF_EVENT_IOC_PERIOD     _PERFIOC(4) /* Arg: FAR uint64_t *, the
+                                               * new sample period */
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The event to count, given to perf_event_open() */
+
+struct perf_event_attr_s
+{
+  uint32_t type;          /* PERF_TYPE_* */
+  uint32_t flags;         /* PERF_ATTR_* */
+  uint64_t config;        /* The event of the type */
+  uint64_t sample_period; /* Events between two samples, zero not to
+                           * sample.  See CONFIG_PERF_EVENTS_SAMPLE.
+                           */
+};
+
+/* What read() returns for a buffer of this size, only the value is
+ * returned for a buffer of 8 bytes.  The times are in nanoseconds, running
+ * is less than enabled if the event did not always get a counter.
+ */
+
+struct perf_event_value_s
+{
+  uint64_t value;         /* The count */
+  uint64_t enabled;       /* Time enabled */
+  uint64_t running;       /* Time counted */
+};
+
+/* The performance monitoring unit driver of the architecture.  The
+ * counters are those of the CPU calling the operations, with the
+ * interrupts disabled.
+ */
+
+struct pmu_s;
+struct pmu_ops_s
+{
+  /* Return in hwevent the encoding of the event of attr, or -ENOENT if not
+   * supported.
+   */
+
+  CODE int (*event_init)(FAR struct pmu_s *pmu,
+                         FAR const struct perf_event_attr_s *attr,
+                         FAR uint64_t *hwevent);
+
+  /* Program the counter idx with hwevent, load it with value and start
+   * it.  irq asks for the overflow interrupt.
+   */
+
+  CODE void (*start)(FAR struct pmu_s *pmu, int idx, uint64_t hwevent,
+                     uint64_t value, bool irq);
+
+  /* Stop the counter idx */
+
+  CODE void (*stop)(FAR struct pmu_s *pmu, int idx);
+
+  /* Read the counter idx */
+
+  CODE uint64_t (*read)(FAR struct pmu_s *pmu, int idx);
+};
+
+struct pmu_s
+{
+  FAR const struct pmu_ops_s *ops;
+  uint8_t ncounters;      /* Number of programmable counters */
+  uint8_t width;          /* Counter width in bits */
+  bool    irq;            /* The counters interrupt on overflow */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+struct tcb_s;
+
+/****************************************************************************
+ * Name: perf_event_open
+ *
+ * Description:
+ *   Open a file descriptor counting the event of attr.  It counts the
+ *   thread pid (0 for the caller) on any CPU if cpu is -1, or every thread
+ *   on the CPU cpu if pid is -1.  read() returns the count, see
+ *   struct perf_event_value_s.
+ *
+ * Input Parameters:
+ *   attr  - The event to count
+ *   pid   - The thread to count, 0 or -1
+ *   cpu   - The CPU to count, or -1
+ *   flags - PERF_FLAG_FD_CLOEXEC or zero
+ *
+ * Returned Value:
+ *   The file descriptor on success; -1 (ERROR) with errno set on failure.
+ *
+ ****************************************************************************/
+
+int perf_event_open(FAR const struct perf_event_attr_s *attr, pid_t pid,
+                    int cpu, unsigned long flags);
+
+/****************************************************************************
+ * Name: pmu_register
+ *
+ * Description:
+ *   Register the PMU driver of the architecture, there is only one.
+ *
+ ****************************************************************************/
+
+int pmu_register(FAR struct pmu_s *pmu);
+
+/****************************************************************************
+ * Name: perf_event_overflow
+ *
+ * Description:
+ *   Called by the PMU driver from its interrupt handler, when the counter
+ *   idx of the CPU overflowed.  ip is the interrupted PC.
+ *
+ ****************************************************************************/
+
+void perf_event_overflow(int idx, uintptr_t ip);
+
+/****************************************************************************
+ * Name: perf_event_sched_in, perf_event_sched_out, perf_event_exit
+ *
+ * Description:
+ *   Load the counters of the thread switched in, save those of the thread
+ *   switched out, and detach the events of an exiting thread.  Called by
+ *   the scheduler.
+ *
+ ****************************************************************************/
+
+void perf_event_sched_in(FAR struct tcb_s *tcb);
+void perf_event_sched_out(FAR struct tcb_s *tcb);
+void perf_event_exit(FAR struct tcb_s *tcb);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_PERF_EVENTS */
+#endif /* __INCLUDE_NUTTX_PERF_EVENT_H */
@@ -166,6 +166,27 @@ void mm_pgreserve(uintptr_t start, size_t size);
 
 uintptr_t mm_pgalloc(unsigned int npages);
 
+/****************************************************************************
+ * Name: mm_pgmemalign
+ *
+ * Description:
+ *   Allocate physically contiguous page memory whose start address is
+ *   aligned to 'alignment'.  This lets the caller map the memory with
+ *   larger translation blocks where the MMU supports them.
+ *
+ * Input Parameters:
+ *   alignment - The required alignment in bytes, a power of two that is
+ *               a multiple of CONFIG_MM_PGSIZE.
+ *   npages    - The number of pages to allocate.
+ *
+ * Returned Value:
+ *   On success, a non-zero, physical address of the allocated page memory
+ *   is returned.  Zero is returned on failure.
+ *
+ ****************************************************************************/
+
+uintptr_t mm_pgmemalign(size_t alignment, unsigned int npages);
+
 /****************************************************************************
  * Name: mm_pgfree
  *
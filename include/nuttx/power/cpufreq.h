@@ -0,0 +1,157 @@
+/****************************************************************************
+ * include/nuttx/power/cpufreq.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_POWER_CPUFREQ_H
+#define __INCLUDE_NUTTX_POWER_CPUFREQ_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <nuttx/clock.h>
+
+#ifdef CONFIG_CPUFREQ
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* One operating performance point of the CPUs.  The table of the lower
+ * half is sorted by increasing frequency.
+ */
+
+struct cpufreq_opp_s
+{
+  uint32_t frequency;                /* CPU clock in kHz */
+  uint32_t voltage;                  /* Core supply in uV, 0 if fixed */
+};
+
+struct cpufreq_lowerhalf_s;
+struct cpufreq_ops_s
+{
+  /* Switch the CPUs to the given point.  Called from the work queue, so
+   * it may wait for the clock and regulator drivers.
+   */
+
+  CODE int (*set_opp)(FAR struct cpufreq_lowerhalf_s *lower,
+                      FAR const struct cpufreq_opp_s *opp);
+};
+
+struct cpufreq_lowerhalf_s
+{
+  FAR const struct cpufreq_ops_s *ops;
+  FAR const struct cpufreq_opp_s *opps;  /* OPP table of the arch */
+  size_t nopps;                          /* Number of entries in opps */
+  size_t initial;                        /* Index of the OPP at register */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: cpufreq_register
+ *
+ * Description:
+ *   Register the lower half which scales the frequency of all of the CPUs
+ *   and start the governor.
+ *
+ * Input Parameters:
+ *   lower - The lower half with its OPP table
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int cpufreq_register(FAR struct cpufreq_lowerhalf_s *lower);
+
+/****************************************************************************
+ * Name: cpufreq_set_limits
+ *
+ * Description:
+ *   Restrict the governor to the OPPs from min_khz to max_khz, e.g. to
+ *   keep a minimum frequency for a latency critical phase.  0 and
+ *   UINT32_MAX remove the limits.
+ *
+ ****************************************************************************/
+
+int cpufreq_set_limits(uint32_t min_khz, uint32_t max_khz);
+
+/****************************************************************************
+ * Name: cpufreq_get_frequency
+ *
+ * Description:
+ *   Return the current CPU frequency in kHz, 0 when nothing is registered.
+ *
+ ****************************************************************************/
+
+uint32_t cpufreq_get_frequency(void);
+
+/****************************************************************************
+ * Name: cpufreq_update_load
+ *
+ * Description:
+ *   Account ticks of CPU time to the load of cpu.  Called by the CPU load
+ *   measurement of the scheduler, from the timer interrupt or a context
+ *   switch.
+ *
+ ****************************************************************************/
+
+void cpufreq_update_load(int cpu, clock_t ticks, bool idle);
+
+/****************************************************************************
+ * Name: cpufreq_boost
+ *
+ * Description:
+ *   Go to the highest allowed OPP right away and stay there for
+ *   CONFIG_CPUFREQ_BOOST_PERIODS sampling periods.  Called by the scheduler
+ *   when a task of priority CONFIG_CPUFREQ_BOOST_PRIORITY or more becomes
+ *   ready to run.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_CPUFREQ_BOOST
+void cpufreq_boost(void);
+#endif
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_CPUFREQ */
+#endif /* __INCLUDE_NUTTX_POWER_CPUFREQ_H */
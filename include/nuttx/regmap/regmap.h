@@ -41,6 +41,15 @@
 
 struct regmap_bus_s;
 
+/* Register cache types, see regmap_config_s.cache_type. */
+
+enum regcache_type_e
+{
+  REGCACHE_NONE = 0,  /* No cache, every access goes to the bus */
+  REGCACHE_FLAT,      /* Array of all registers up to max_register */
+  REGCACHE_RBTREE     /* Tree of blocks allocated on the first access */
+};
+
 /* Single byte register read/write. */
 
 typedef CODE int (*reg_read_t)(FAR struct regmap_bus_s *bus,
@@ -100,6 +109,20 @@ struct regmap_config_s
    */
 
   bool disable_locking;
+
+#ifdef CONFIG_REGMAP_CACHE
+  /* The register cache.  A register is cached after the first read or
+   * write of it, and later reads of it do not access the bus.  The
+   * registers for which volatile_reg() returns true, e.g. status or
+   * interrupt registers changed by the device, are never cached.
+   * max_register is the highest register address, mandatory for
+   * REGCACHE_FLAT.
+   */
+
+  enum regcache_type_e cache_type;
+  unsigned int max_register;
+  CODE bool (*volatile_reg)(unsigned int reg);
+#endif
 };
 
 struct regmap_s;
@@ -312,6 +335,82 @@ int regmap_read(FAR struct regmap_s *map, unsigned int reg,
 int regmap_bulk_read(FAR struct regmap_s *map, unsigned int reg,
                      FAR void *val, unsigned int val_count);
 
+/****************************************************************************
+ * Name: regmap_update_bits
+ *
+ * Description:
+ *   Read-modify-write of a register: the bits of mask are set to those of
+ *   val.  The register is not written if its value does not change, and
+ *   with a register cache the read does not access the bus.
+ *
+ * Input Parameters:
+ *   map  - regmap handler, from regmap bus init function return.
+ *   reg  - register address to be updated.
+ *   mask - bits to update.
+ *   val  - new value of the bits.
+ *
+ * Returned Value:
+ *   Zero or positive on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int regmap_update_bits(FAR struct regmap_s *map, unsigned int reg,
+                       unsigned int mask, unsigned int val);
+
+#ifdef CONFIG_REGMAP_CACHE
+
+/****************************************************************************
+ * Name: regcache_cache_only
+ *
+ * Description:
+ *   Enable or disable the cache only mode.  In this mode the writes only
+ *   update the cache and mark the registers dirty, and the reads of
+ *   registers not cached fail with -EBUSY.  It is used while the device
+ *   is suspended, see regcache_sync().
+ *
+ * Input Parameters:
+ *   map    - regmap handler, from regmap bus init function return.
+ *   enable - true to enable the cache only mode.
+ *
+ ****************************************************************************/
+
+void regcache_cache_only(FAR struct regmap_s *map, bool enable);
+
+/****************************************************************************
+ * Name: regcache_mark_dirty
+ *
+ * Description:
+ *   Mark all the cached registers dirty, so that the next regcache_sync()
+ *   writes all of them, e.g. after the device lost its power.
+ *
+ * Input Parameters:
+ *   map - regmap handler, from regmap bus init function return.
+ *
+ ****************************************************************************/
+
+void regcache_mark_dirty(FAR struct regmap_s *map);
+
+/****************************************************************************
+ * Name: regcache_sync
+ *
+ * Description:
+ *   Write the dirty registers of the cache to the device, on resume.
+ *   Consecutive dirty registers are written by a single bulk transfer
+ *   when the bus supports it.
+ *
+ * Input Parameters:
+ *   map - regmap handler, from regmap bus init function return.
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure, the registers not
+ *   written then stay dirty.
+ *
+ ****************************************************************************/
+
+int regcache_sync(FAR struct regmap_s *map);
+
+#endif /* CONFIG_REGMAP_CACHE */
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
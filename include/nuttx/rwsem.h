@@ -27,6 +27,8 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/atomic.h>
+#include <nuttx/mutex.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/spinlock.h>
 
@@ -35,24 +37,42 @@
  ****************************************************************************/
 
 #define RWSEM_NO_HOLDER     ((pid_t)-1)
-#define RWSEM_INITIALIZER   {SEM_INITIALIZER(0), \
+#define RWSEM_INITIALIZER   {NXMUTEX_INITIALIZER, SEM_INITIALIZER(0), \
                              RWSEM_NO_HOLDER, 0, 0, 0}
 
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
 
+#ifdef CONFIG_RWSEM_PERCPU_READERS
+struct aligned_data(CONFIG_RWSEM_PERCPU_ALIGN) rwsem_percpu_s
+{
+  atomic_int count;     /* Readers counted on this CPU, the sum of them is
+                         * the reader count.
+                         */
+};
+#endif
+
 typedef struct
 {
-  sem_t   waiting;      /* Reader/writer Waiting queue */
+  mutex_t wlock;        /* Taken by the writer, so that the readers and the
+                         * writers waiting for it boost its priority.
+                         */
+  sem_t   waiting;      /* Writer waiting for the readers to leave */
   pid_t   holder;       /* The write lock holder, this lock still can be
                          * locked when the holder is same as the current
                          * task/thread.
                          */
-  int     waiter;       /* Waiter Count */
+  int     waiter;       /* Non-zero if the writer waits for the readers */
   int     writer;       /* Writer Count */
   int     reader;       /* Reader Count */
   spinlock_t protected; /* Protecting Locks for Read/Write Locked Tables */
+#ifdef CONFIG_RWSEM_PERCPU_READERS
+  atomic_int wactive;   /* Non-zero while a writer holds wlock, the readers
+                         * then take the spinlock.
+                         */
+  struct rwsem_percpu_s readers[CONFIG_SMP_NCPUS];
+#endif
 } rw_semaphore_t;
 
 /****************************************************************************
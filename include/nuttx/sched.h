@@ -123,6 +123,7 @@
 #  define TCB_FLAG_SCHED_FIFO      (0 << TCB_FLAG_POLICY_SHIFT)  /* FIFO scheding policy */
 #  define TCB_FLAG_SCHED_RR        (1 << TCB_FLAG_POLICY_SHIFT)  /* Round robin scheding policy */
 #  define TCB_FLAG_SCHED_SPORADIC  (2 << TCB_FLAG_POLICY_SHIFT)  /* Sporadic scheding policy */
+#  define TCB_FLAG_SCHED_DEADLINE  (3 << TCB_FLAG_POLICY_SHIFT)  /* Deadline scheding policy */
 #define TCB_FLAG_CPU_LOCKED        (1 << 5)                      /* Bit 5: Locked to this CPU */
 #define TCB_FLAG_SIGNAL_ACTION     (1 << 6)                      /* Bit 6: In a signal handler */
 #define TCB_FLAG_SYSCALL           (1 << 7)                      /* Bit 7: In a system call */
@@ -372,6 +373,34 @@ struct sporadic_s
 
 #endif /* CONFIG_SCHED_SPORADIC */
 
+/* struct deadline_s ********************************************************/
+
+#ifdef CONFIG_SCHED_DEADLINE
+
+/* This structure is allocated when the deadline scheduling policy is
+ * assigned to a thread.  It holds the constant bandwidth server of the
+ * thread:  the thread may run for 'runtime' ticks before its absolute
+ * deadline, after which it is throttled until the deadline and then
+ * replenished for the next period.  All times are in system ticks.
+ */
+
+struct deadline_s
+{
+  struct wdog_s timer;              /* Replenishment timer                   */
+  clock_t   runtime;                /* Reserved execution time per period    */
+  clock_t   reldeadline;            /* Deadline relative to the activation   */
+  clock_t   period;                 /* Activation period                     */
+  clock_t   absdeadline;            /* Absolute deadline of the current job  */
+  sclock_t  budget;                 /* Runtime left before the deadline      */
+  uint32_t  bandwidth;              /* runtime / period, in 2^-20 units     */
+#ifdef CONFIG_SMP
+  uint8_t   cpu;                    /* The CPU the bandwidth is reserved on  */
+#endif
+  bool      throttled;              /* Budget exhausted, waiting replenish   */
+};
+
+#endif /* CONFIG_SCHED_DEADLINE */
+
 /* struct child_status_s ****************************************************/
 
 /* This structure is used to maintain information about child tasks.
@@ -433,6 +462,31 @@ struct stackinfo_s
                                          /* from the stack.                  */
 };
 
+/* struct taskstat_s ********************************************************/
+
+/* Used to report a snapshot of the state of one thread */
+
+struct taskstat_s
+{
+  pid_t     pid;                         /* ID of the thread                */
+  pid_t     group;                       /* ID of the task of its group     */
+  uint32_t  flags;                       /* TCB_FLAG_* status flags         */
+  uint8_t   state;                       /* Current state (enum tstate_e)   */
+  uint8_t   priority;                    /* Current priority of the thread  */
+  uint8_t   init_priority;               /* Initial priority of the thread  */
+  uint8_t   cpu;                         /* CPU index if running/assigned   */
+#ifndef CONFIG_SCHED_CPULOAD_NONE
+  clock_t   ticks;                       /* Number of ticks on this thread  */
+#endif
+  size_t    stack_size;                  /* Size of the stack               */
+#ifdef CONFIG_STACK_COLORATION
+  size_t    stack_used;                  /* Stack used as from coloration   */
+#endif
+#if CONFIG_TASK_NAME_SIZE > 0
+  char      name[CONFIG_TASK_NAME_SIZE + 1]; /* Name of the thread          */
+#endif
+};
+
 /* struct task_join_s *******************************************************/
 
 /* Used to save task join information */
@@ -552,6 +606,9 @@ struct task_group_s
   FAR char **tg_envp;               /* Allocated environment strings        */
   ssize_t    tg_envpc;              /* Maximum entries of environment array */
   ssize_t    tg_envc;               /* Number of environment strings        */
+#ifdef CONFIG_SCHED_ENVIRON_SHARED
+  FAR struct env_shared_s *tg_envshared; /* Shared tg_envp, if any      */
+#endif
 #endif
 
 #ifndef CONFIG_DISABLE_POSIX_TIMERS
@@ -652,6 +709,9 @@ struct tcb_s
 #ifdef CONFIG_SCHED_SPORADIC
   FAR struct sporadic_s *sporadic;       /* Sporadic scheduling parameters  */
 #endif
+#ifdef CONFIG_SCHED_DEADLINE
+  FAR struct deadline_s *deadline;       /* Deadline scheduling parameters  */
+#endif
 
   struct wdog_s waitdog;                 /* All timed waits use this timer  */
 
@@ -718,6 +778,18 @@ struct tcb_s
   void   *crit_max_caller;               /* Caller of max critical section  */
 #endif
 
+  /* Scheduling latency support *********************************************/
+
+#ifdef CONFIG_SCHED_LATENCY
+  clock_t wakeup_time;                   /* Time when made ready-to-run     */
+#endif
+
+  /* Performance monitoring unit events *************************************/
+
+#ifdef CONFIG_PERF_EVENTS
+  sq_queue_t perf_events;                /* Events counting this thread     */
+#endif
+
   /* State save areas *******************************************************/
 
   /* The form and content of these fields are platform-specific.            */
@@ -1525,6 +1597,26 @@ int nxsched_set_affinity(pid_t pid, size_t cpusetsize,
 
 int nxsched_get_stackinfo(pid_t pid, FAR struct stackinfo_s *stackinfo);
 
+/****************************************************************************
+ * Name: nxsched_get_taskstats
+ *
+ * Description:
+ *   Report a snapshot of the state of all threads in one call, so that
+ *   monitoring tools need not open and parse the procfs files of each
+ *   thread.
+ *
+ * Input Parameters:
+ *   stats  - User-provided array to return the thread information.
+ *   nstats - The number of entries in the array.
+ *
+ * Returned Value:
+ *   The number of threads in the system, which may be more than nstats.
+ *   Only the first nstats of them are returned.
+ *
+ ****************************************************************************/
+
+ssize_t nxsched_get_taskstats(FAR struct taskstat_s *stats, size_t nstats);
+
 /****************************************************************************
  * Name: nxsched_get_stateinfo
  *
@@ -0,0 +1,152 @@
+/****************************************************************************
+ * include/nuttx/sched_callgraph.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_SCHED_CALLGRAPH_H
+#define __INCLUDE_NUTTX_SCHED_CALLGRAPH_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef CONFIG_SCHED_CALLGRAPH
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The samples taken with one call stack.  The backtrace starts with the
+ * interrupted PC and is NULL terminated if shorter than the array.
+ */
+
+struct sched_callgraph_stack_s
+{
+  FAR void     *backtrace[CONFIG_SCHED_CALLGRAPH_DEPTH];
+  unsigned long count;
+};
+
+/* The state and the totals of the profile */
+
+struct sched_callgraph_s
+{
+  bool          running;  /* Whether samples are being taken */
+  unsigned long rate;     /* The timer samples per second and CPU */
+  unsigned long nstacks;  /* The number of call stacks seen */
+  unsigned long nsamples; /* The number of samples recorded */
+  unsigned long ndropped; /* Samples lost because the table was full */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: sched_callgraph_start
+ *
+ * Description:
+ *   Start sampling the call stacks of the threads running on every CPU,
+ *   CONFIG_SCHED_CALLGRAPH_RATE times per second.
+ *
+ ****************************************************************************/
+
+void sched_callgraph_start(void);
+
+/****************************************************************************
+ * Name: sched_callgraph_stop
+ *
+ * Description:
+ *   Stop sampling.  The samples taken so far are kept.
+ *
+ ****************************************************************************/
+
+void sched_callgraph_stop(void);
+
+/****************************************************************************
+ * Name: sched_callgraph_reset
+ *
+ * Description:
+ *   Drop the samples taken so far.
+ *
+ ****************************************************************************/
+
+void sched_callgraph_reset(void);
+
+/****************************************************************************
+ * Name: sched_callgraph_sample
+ *
+ * Description:
+ *   Record the call stack of the thread interrupted on this CPU.  Called
+ *   from interrupt context, by the sampling timer or by a PMU overflow
+ *   interrupt.  Does nothing unless sampling was started.
+ *
+ ****************************************************************************/
+
+void sched_callgraph_sample(void);
+
+/****************************************************************************
+ * Name: sched_callgraph_info
+ *
+ * Description:
+ *   Return the state and the totals of the profile.
+ *
+ ****************************************************************************/
+
+void sched_callgraph_info(FAR struct sched_callgraph_s *info);
+
+/****************************************************************************
+ * Name: sched_callgraph_stack
+ *
+ * Description:
+ *   Return a snapshot of one call stack.
+ *
+ * Input Parameters:
+ *   index - The index of the stack, starting at zero
+ *   stack - The location to return the stack in
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOENT if there is no stack 'index'.
+ *
+ ****************************************************************************/
+
+int sched_callgraph_stack(unsigned int index,
+                          FAR struct sched_callgraph_stack_s *stack);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CONFIG_SCHED_CALLGRAPH */
+#endif /* __INCLUDE_NUTTX_SCHED_CALLGRAPH_H */
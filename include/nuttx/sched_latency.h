@@ -0,0 +1,147 @@
+/****************************************************************************
+ * include/nuttx/sched_latency.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_SCHED_LATENCY_H
+#define __INCLUDE_NUTTX_SCHED_LATENCY_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#ifdef CONFIG_SCHED_LATENCY
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The histograms have log buckets with four sub-buckets per power of two,
+ * as HDR histograms with two significant bits: bucket 0 holds the
+ * latencies below 128 ns, the last one those from about 1 s.
+ */
+
+#define SCHED_LATENCY_MINSHIFT  7
+#define SCHED_LATENCY_MAXSHIFT  30
+#define SCHED_LATENCY_NBUCKETS \
+  (4 * (SCHED_LATENCY_MAXSHIFT - SCHED_LATENCY_MINSHIFT) + 1)
+
+/* The histograms, by sched_latency_get() type */
+
+#define SCHED_LATENCY_CPU       0 /* Wake-up latency per CPU */
+#define SCHED_LATENCY_PRIO      1 /* Wake-up latency per priority band */
+#define SCHED_LATENCY_TEST      2 /* Timer latency of the self-test */
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* One histogram, in nanoseconds */
+
+struct sched_latency_s
+{
+  unsigned long count;                           /* Number of samples */
+  unsigned long over;                            /* Samples above the
+                                                  * threshold */
+  uint32_t      max;                             /* Worst latency */
+  uint64_t      sum;                             /* Sum of the latencies */
+  uint32_t      bucket[SCHED_LATENCY_NBUCKETS];  /* Samples per bucket */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: sched_latency_get
+ *
+ * Description:
+ *   Return a snapshot of one histogram.
+ *
+ * Input Parameters:
+ *   type    - SCHED_LATENCY_CPU, SCHED_LATENCY_PRIO or SCHED_LATENCY_TEST
+ *   index   - The CPU or the priority band, 0 for the self-test
+ *   latency - The location to return the histogram in
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOENT if there is no such histogram.
+ *
+ ****************************************************************************/
+
+int sched_latency_get(int type, int index,
+                      FAR struct sched_latency_s *latency);
+
+/****************************************************************************
+ * Name: sched_latency_bucket
+ *
+ * Description:
+ *   Return the lowest latency in nanoseconds counted by a bucket.
+ *
+ ****************************************************************************/
+
+uint32_t sched_latency_bucket(int bucket);
+
+/****************************************************************************
+ * Name: sched_latency_reset
+ *
+ * Description:
+ *   Clear all the histograms.
+ *
+ ****************************************************************************/
+
+void sched_latency_reset(void);
+
+/****************************************************************************
+ * Name: sched_latency_selftest
+ *
+ * Description:
+ *   Start a cyclictest-like kernel thread at priority
+ *   CONFIG_SCHED_LATENCY_TEST_PRIORITY.  It sleeps until absolute times
+ *   'interval' microseconds apart, 'loops' times, and records how late it
+ *   wakes up in the SCHED_LATENCY_TEST histogram.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EBUSY if a test is running, or the error of
+ *   kthread_create().
+ *
+ ****************************************************************************/
+
+int sched_latency_selftest(unsigned long loops, unsigned long interval);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CONFIG_SCHED_LATENCY */
+#endif /* __INCLUDE_NUTTX_SCHED_LATENCY_H */
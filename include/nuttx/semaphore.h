@@ -30,14 +30,40 @@
 #include <nuttx/config.h>
 
 #include <errno.h>
+#include <limits.h>
 #include <semaphore.h>
+#include <stdbool.h>
 
+#include <nuttx/atomic.h>
 #include <nuttx/clock.h>
+#include <nuttx/compiler.h>
 
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Semaphores without a priority protocol are taken and released without
+ * the critical section as long as no task has to wait or be woken up.
+ * Because of that, every update of semcount must be atomic.
+ */
+
+#define NXSEM_COUNT(s)    ((FAR atomic_short *)&(s)->semcount)
+#define NXSEM_LOCKLESS(s) (((s)->flags & SEM_PRIO_MASK) == SEM_PRIO_NONE)
+
+/* In the protected and kernel builds the semaphore lives in user memory,
+ * so the user side can take and release an uncontended count on its own.
+ * The kernel is only entered when the caller has to block, or a waiter
+ * has to be woken up.
+ */
+
+#if defined(CONFIG_SEM_USER_FASTPATH) && !defined(__KERNEL__)
+#  define nxsem_user_trywait(s) nxsem_trywait_lockless(s)
+#  define nxsem_user_post(s)    nxsem_post_lockless(s)
+#else
+#  define nxsem_user_trywait(s) false
+#  define nxsem_user_post(s)    false
+#endif
+
 /* Initializers */
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
@@ -728,5 +754,81 @@ int nxsem_setprioceiling(FAR sem_t *sem, int prioceiling,
 }
 #endif
 
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsem_trywait_lockless
+ *
+ * Description:
+ *   Take one count of a semaphore without entering the critical section.
+ *   This only succeeds if the semaphore uses no priority protocol (there
+ *   are no holders to track) and the count is positive.
+ *
+ * Returned Value:
+ *   True if a count was taken.  False if the caller has to fall back to the
+ *   locked path.
+ *
+ ****************************************************************************/
+
+static inline_function bool nxsem_trywait_lockless(FAR sem_t *sem)
+{
+  short count;
+
+  if (!NXSEM_LOCKLESS(sem))
+    {
+      return false;
+    }
+
+  count = atomic_load(NXSEM_COUNT(sem));
+  while (count > 0)
+    {
+      if (atomic_compare_exchange_weak(NXSEM_COUNT(sem), &count,
+                                       count - 1))
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: nxsem_post_lockless
+ *
+ * Description:
+ *   Release one count of a semaphore without entering the critical section.
+ *   This only succeeds if the semaphore uses no priority protocol and there
+ *   is no waiter to wake up (the count is not negative).
+ *
+ * Returned Value:
+ *   True if the count was released.  False if the caller has to fall back
+ *   to the locked path (which also reports an overflow).
+ *
+ ****************************************************************************/
+
+static inline_function bool nxsem_post_lockless(FAR sem_t *sem)
+{
+  short count;
+
+  if (!NXSEM_LOCKLESS(sem))
+    {
+      return false;
+    }
+
+  count = atomic_load(NXSEM_COUNT(sem));
+  while (count >= 0 && count < SEM_VALUE_MAX)
+    {
+      if (atomic_compare_exchange_weak(NXSEM_COUNT(sem), &count,
+                                       count + 1))
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
 #endif /* __ASSEMBLY__ */
 #endif /* __INCLUDE_NUTTX_SEMAPHORE_H */
@@ -466,4 +466,12 @@
 
 #define SNIOC_GET_EVENTS              _SNIOC(0x009E)
 
+/* Command:      SNIOC_GET_LATEST
+ * Description:  Get the latest samples of several topics at once, under
+ *               the locks of all of them.
+ * Argument:     The topics pointer, (struct sensor_latest_s *)
+ */
+
+#define SNIOC_GET_LATEST              _SNIOC(0x009F)
+
 #endif /* __INCLUDE_NUTTX_SENSORS_IOCTL_H */
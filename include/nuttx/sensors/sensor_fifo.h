@@ -0,0 +1,229 @@
+/****************************************************************************
+ * include/nuttx/sensors/sensor_fifo.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_SENSORS_SENSOR_FIFO_H
+#define __INCLUDE_NUTTX_SENSORS_SENSOR_FIFO_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <nuttx/mutex.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/sensors/sensor.h>
+
+#ifdef CONFIG_SENSORS_FIFO
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The hardware FIFO of a sensor, harvested in batches.
+ *
+ * The lower half tells the helper when the FIFO reaches its watermark by
+ * calling sensor_fifo_interrupt() from the interrupt handler, or lets the
+ * helper poll the FIFO.  The helper then reads all the frames of the FIFO
+ * with as few bus transfers as possible, gives each sample a time stamp
+ * interpolated from the measured output data rate, and pushes the whole
+ * batch with one push_event() call.
+ */
+
+struct sensor_fifo_s;
+struct sensor_fifo_ops_s
+{
+  /**************************************************************************
+   * Name: level
+   *
+   * Description:
+   *   Return the number of frames in the hardware FIFO.
+   *
+   **************************************************************************/
+
+  CODE int (*level)(FAR struct sensor_fifo_s *fifo);
+
+  /**************************************************************************
+   * Name: read
+   *
+   * Description:
+   *   Read up to count frames from the hardware FIFO into buffer.  The
+   *   frames should be read with one burst transfer, so that the SPI or
+   *   I2C controller moves them by DMA when it can.
+   *
+   * Returned Value:
+   *   The number of frames read; a negated errno value on failure.
+   *
+   **************************************************************************/
+
+  CODE int (*read)(FAR struct sensor_fifo_s *fifo, FAR uint8_t *buffer,
+                   unsigned int count);
+
+  /**************************************************************************
+   * Name: convert
+   *
+   * Description:
+   *   Convert one frame to one sensor event with the time stamp given.
+   *
+   * Returned Value:
+   *   The size of the event, zero to drop the frame.
+   *
+   **************************************************************************/
+
+  CODE size_t (*convert)(FAR struct sensor_fifo_s *fifo,
+                         FAR const uint8_t *frame, uint64_t timestamp,
+                         FAR void *event);
+};
+
+struct sensor_fifo_s
+{
+  FAR const struct sensor_fifo_ops_s *ops;
+  FAR struct sensor_lowerhalf_s *lower;  /* Lower half pushed to */
+  FAR uint8_t   *frames;                 /* The frames read */
+  FAR uint8_t   *events;                 /* The events pushed */
+  size_t         framesize;              /* Size of one frame */
+  size_t         esize;                  /* Size of one event */
+  unsigned int   nframes;                /* Frames read at once */
+  unsigned int   watermark;              /* Frames of the interrupt */
+  uint32_t       interval;               /* Nominal period, in us */
+  uint32_t       index;                  /* Frames harvested */
+  uint32_t       refindex;               /* Frame of reftime */
+  uint64_t       period;                 /* Measured period, in ns */
+  uint64_t       reftime;                /* Reference time stamp */
+  uint64_t       last;                   /* Last time stamp pushed */
+  uint64_t       irqtime;                /* Pending interrupt time */
+  bool           poll;                   /* Poll instead of interrupt */
+  mutex_t        lock;
+  struct work_s  work;
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: sensor_fifo_init
+ *
+ * Description:
+ *   Initialize the FIFO helper and allocate the buffers of one batch.
+ *
+ * Input Parameters:
+ *   fifo      - The FIFO to initialize
+ *   ops       - The operations of the hardware FIFO
+ *   lower     - The lower half the events are pushed to
+ *   framesize - The size of one hardware frame
+ *   esize     - The size of one sensor event
+ *   nframes   - Frames read at once
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int sensor_fifo_init(FAR struct sensor_fifo_s *fifo,
+                     FAR const struct sensor_fifo_ops_s *ops,
+                     FAR struct sensor_lowerhalf_s *lower,
+                     size_t framesize, size_t esize, unsigned int nframes);
+
+/****************************************************************************
+ * Name: sensor_fifo_uninit
+ *
+ * Description:
+ *   Stop the harvesting and free the buffers.
+ *
+ ****************************************************************************/
+
+void sensor_fifo_uninit(FAR struct sensor_fifo_s *fifo);
+
+/****************************************************************************
+ * Name: sensor_fifo_start
+ *
+ * Description:
+ *   Start the harvesting, or restart it after the output data rate or the
+ *   watermark change.  The lower half calls it from activate(),
+ *   set_interval() and batch() once the hardware is programmed.
+ *
+ * Input Parameters:
+ *   fifo      - The FIFO
+ *   interval  - The output data period, in us
+ *   watermark - Frames of the interrupt, or trigger the poll
+ *   poll      - Poll the FIFO every watermark frames, for the hardware
+ *               without the interrupt line
+ *
+ ****************************************************************************/
+
+void sensor_fifo_start(FAR struct sensor_fifo_s *fifo, uint32_t interval,
+                       unsigned int watermark, bool poll);
+
+/****************************************************************************
+ * Name: sensor_fifo_stop
+ *
+ * Description:
+ *   Stop the harvesting.  The frames left in the hardware FIFO are lost.
+ *
+ ****************************************************************************/
+
+void sensor_fifo_stop(FAR struct sensor_fifo_s *fifo);
+
+/****************************************************************************
+ * Name: sensor_fifo_interrupt
+ *
+ * Description:
+ *   Tell that the FIFO reached the watermark.  It is called from the
+ *   interrupt handler, which time stamps the batch.
+ *
+ ****************************************************************************/
+
+void sensor_fifo_interrupt(FAR struct sensor_fifo_s *fifo);
+
+/****************************************************************************
+ * Name: sensor_fifo_flush
+ *
+ * Description:
+ *   Harvest the FIFO now and push the flush complete event, this is the
+ *   flush() of the lower half.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int sensor_fifo_flush(FAR struct sensor_fifo_s *fifo);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_SENSORS_FIFO */
+#endif /* __INCLUDE_NUTTX_SENSORS_SENSOR_FIFO_H */
@@ -281,6 +281,15 @@ struct uart_ops_s
 
   CODE ssize_t (*sendbuf)(FAR struct uart_dev_s *dev,
                           FAR const void *buf, size_t len);
+
+#ifdef CONFIG_SERIAL_RXDMA_DIRECT
+  /* Stop the receive DMA in progress, and complete it at once with the
+   * bytes already received by uart_recvchars_done().  The receive DMA goes
+   * directly to the buffer of read() only if this method is provided.
+   */
+
+  CODE void (*dmarxstop)(FAR struct uart_dev_s *dev);
+#endif
 };
 
 /* This is the device structure used by the driver.  The caller of
@@ -339,6 +348,11 @@ struct uart_dev_s
 #ifdef CONFIG_SERIAL_RXDMA
   struct uart_dmaxfer_s dmarx;       /* Describes receive DMA transfer */
 #endif
+#ifdef CONFIG_SERIAL_RXDMA_DIRECT
+  FAR char             *rxdirect;      /* Buffer of the waiting read() */
+  size_t                rxdirectlen;   /* The size of rxdirect */
+  volatile size_t       rxdirectrecv;  /* Bytes received into rxdirect */
+#endif
 
   /* Driver interface */
 
@@ -30,6 +30,7 @@
 #include <nuttx/config.h>
 
 #include <nuttx/serial/serial.h>
+#include <nuttx/dma/dma.h>
 
 #ifdef CONFIG_16550_UART
 
@@ -349,6 +350,8 @@ struct u16550_s
 #ifdef HAVE_16550_UART_DMA
   int32_t                dmatx;
   FAR struct dma_chan_s *chantx;
+  struct dma_sg_s        dmatxsg[2];
+  struct dma_sglist_s    dmatxlist;
   int32_t                dmarx;
   FAR struct dma_chan_s *chanrx;
   FAR char              *dmarxbuf;
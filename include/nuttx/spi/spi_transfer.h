@@ -34,6 +34,7 @@
 #include <stdbool.h>
 
 #include <nuttx/fs/ioctl.h>
+#include <nuttx/queue.h>
 #include <nuttx/spi/spi.h>
 
 #ifdef CONFIG_SPI_EXCHANGE
@@ -114,6 +115,23 @@ struct spi_sequence_s
   FAR struct spi_trans_s *trans;
 };
 
+#ifdef CONFIG_SPI_ASYNC
+/* This describes a sequence queued by spi_transfer_async().  It belongs to
+ * the SPI bus from the submission until the callback is called.
+ */
+
+struct spi_async_s
+{
+  sq_entry_t node;               /* Used internally by the bus queue */
+  FAR struct spi_sequence_s *seq;
+
+  /* Called from the work queue with the result of spi_transfer() */
+
+  CODE void (*callback)(FAR struct spi_async_s *msg, int result);
+  FAR void *arg;                 /* For use by the callback */
+};
+#endif
+
 /****************************************************************************
  * Public Functions Definitions
  ****************************************************************************/
@@ -137,6 +155,32 @@ struct spi_sequence_s
 
 int spi_transfer(FAR struct spi_dev_s *spi, FAR struct spi_sequence_s *seq);
 
+/****************************************************************************
+ * Name: spi_transfer_async
+ *
+ * Description:
+ *   Queue a sequence of SPI transfers and return without waiting.  Each
+ *   SPI bus has its own queue, served in order by the low priority work
+ *   queue with spi_transfer(), and the callback of the message is called
+ *   with the result when the sequence is done.  This may be called from
+ *   an interrupt handler.
+ *
+ * Input Parameters:
+ *   spi - An instance of the SPI device to use for the transfer
+ *   msg - The sequence and the callback, not to be modified until the
+ *         callback is called.
+ *
+ * Returned Value:
+ *   Zero (OK) if the message is queued; -ENOSPC if there are already
+ *   CONFIG_SPI_ASYNC_NBUSES buses with a queue.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPI_ASYNC
+int spi_transfer_async(FAR struct spi_dev_s *spi,
+                       FAR struct spi_async_s *msg);
+#endif
+
 /****************************************************************************
  * Name: spi_register
  *
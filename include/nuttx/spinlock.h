@@ -37,7 +37,8 @@
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
 
-#if defined(CONFIG_TICKET_SPINLOCK) || defined(CONFIG_RW_SPINLOCK)
+#if defined(CONFIG_TICKET_SPINLOCK) || defined(CONFIG_QUEUED_SPINLOCK) || \
+    defined(CONFIG_RW_SPINLOCK)
 #  include <nuttx/atomic.h>
 #endif
 
@@ -50,7 +51,7 @@ extern "C"
 #define EXTERN extern
 #endif
 
-#if defined(CONFIG_RW_SPINLOCK)
+#if defined(CONFIG_RW_SPINLOCK) && !defined(CONFIG_QUEUED_SPINLOCK)
 typedef int rwlock_t;
 #  define RW_SP_UNLOCKED      0
 #  define RW_SP_READ_LOCKED   1
@@ -78,6 +79,41 @@ typedef union spinlock_u spinlock_t;
 #  define SP_UNLOCKED (union spinlock_u){{0, 0}}
 #  define SP_LOCKED (union spinlock_u){{0, 1}}
 
+#elif defined(CONFIG_QUEUED_SPINLOCK)
+
+/* Bit 0 is set while the lock is held, the upper half holds the CPU index
+ * plus one of the last waiter in the queue, see sched/irq/irq_qspinlock.c.
+ */
+
+typedef unsigned int spinlock_t;
+
+#  define SP_UNLOCKED      0u
+#  define SP_LOCKED        1u
+#  define SP_QUEUED_SHIFT  16
+#  define SP_QUEUED_MASK   0xffff0000u
+
+#  ifdef CONFIG_RW_SPINLOCK
+
+/* The queued reader-writer lock: the writer byte and its waiting bit in the
+ * low bits of cnts, the number of readers above them.  The waiters queue
+ * on 'wait', so that only the first of them spins on cnts.
+ */
+
+struct rwlock_s
+{
+  unsigned int cnts;
+  spinlock_t   wait;
+};
+
+typedef struct rwlock_s rwlock_t;
+
+#    define RW_SP_UNLOCKED   (struct rwlock_s){0, SP_UNLOCKED}
+#    define RW_SP_WLOCKED    0xffu
+#    define RW_SP_WWAITING   0x100u
+#    define RW_SP_WMASK      0x1ffu
+#    define RW_SP_RBIAS      0x200u
+#  endif
+
 #else
 
 /* The architecture specific spinlock.h header file must also provide the
@@ -124,7 +160,9 @@ typedef union spinlock_u spinlock_t;
 #endif
 
 #if !defined(__SP_UNLOCK_FUNCTION) && (defined(CONFIG_TICKET_SPINLOCK) || \
-     defined(CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS))
+     defined(CONFIG_QUEUED_SPINLOCK) || \
+     defined(CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS) || \
+     defined(CONFIG_SPINLOCK_LOCKDEP) || defined(CONFIG_SCHED_LOCKSTAT))
 #  define __SP_UNLOCK_FUNCTION 1
 #endif
 
@@ -144,6 +182,32 @@ void sched_note_spinlock_unlock(FAR volatile spinlock_t *spinlock);
 #  define sched_note_spinlock_unlock(spinlock)
 #endif
 
+#ifdef CONFIG_SPINLOCK_LOCKDEP
+void spin_lockdep_acquire(FAR volatile spinlock_t *lock, bool trylock);
+void spin_lockdep_release(FAR volatile spinlock_t *lock);
+#else
+#  define spin_lockdep_acquire(lock, trylock)
+#  define spin_lockdep_release(lock)
+#endif
+
+#ifdef CONFIG_QUEUED_SPINLOCK
+void spin_lock_queued(FAR volatile spinlock_t *lock);
+#  ifdef CONFIG_RW_SPINLOCK
+void read_lock_queued(FAR volatile rwlock_t *lock);
+void write_lock_queued(FAR volatile rwlock_t *lock);
+#  endif
+#endif
+
+#if defined(CONFIG_SPINLOCK) && defined(CONFIG_SCHED_LOCKSTAT)
+void spin_lockstat_acquire(FAR volatile spinlock_t *lock);
+void spin_lockstat_acquired(FAR volatile spinlock_t *lock);
+void spin_lockstat_release(FAR volatile spinlock_t *lock);
+#else
+#  define spin_lockstat_acquire(lock)
+#  define spin_lockstat_acquired(lock)
+#  define spin_lockstat_release(lock)
+#endif
+
 /****************************************************************************
  * Public Data Types
  ****************************************************************************/
@@ -242,17 +306,27 @@ static inline spinlock_t up_testset(FAR volatile spinlock_t *lock)
 #ifdef CONFIG_SPINLOCK
 static inline_function void spin_lock_wo_note(FAR volatile spinlock_t *lock)
 {
-#ifdef CONFIG_TICKET_SPINLOCK
+#if defined(CONFIG_QUEUED_SPINLOCK)
+  unsigned int zero = SP_UNLOCKED;
+
+  if (!atomic_compare_exchange_strong((FAR atomic_uint *)lock, &zero,
+                                      SP_LOCKED))
+    {
+      spin_lock_queued(lock);
+    }
+#elif defined(CONFIG_TICKET_SPINLOCK)
   unsigned short ticket =
     atomic_fetch_add((FAR atomic_ushort *)&lock->tickets.next, 1);
   while (atomic_load((FAR atomic_ushort *)&lock->tickets.owner) != ticket)
 #else /* CONFIG_TICKET_SPINLOCK */
   while (up_testset(lock) == SP_LOCKED)
 #endif
+#ifndef CONFIG_QUEUED_SPINLOCK
     {
       SP_DSB();
       SP_WFE();
     }
+#endif
 
   SP_DMB();
 }
@@ -287,6 +361,8 @@ static inline_function void spin_lock(FAR volatile spinlock_t *lock)
   /* Notify that we are waiting for a spinlock */
 
   sched_note_spinlock_lock(lock);
+  spin_lockdep_acquire(lock, false);
+  spin_lockstat_acquire(lock);
 
   /* Lock without trace note */
 
@@ -294,6 +370,7 @@ static inline_function void spin_lock(FAR volatile spinlock_t *lock)
 
   /* Notify that we have the spinlock */
 
+  spin_lockstat_acquired(lock);
   sched_note_spinlock_locked(lock);
 }
 #endif /* CONFIG_SPINLOCK */
@@ -324,7 +401,12 @@ static inline_function void spin_lock(FAR volatile spinlock_t *lock)
 static inline_function bool
 spin_trylock_wo_note(FAR volatile spinlock_t *lock)
 {
-#ifdef CONFIG_TICKET_SPINLOCK
+#if defined(CONFIG_QUEUED_SPINLOCK)
+  unsigned int zero = SP_UNLOCKED;
+
+  if (!atomic_compare_exchange_strong((FAR atomic_uint *)lock, &zero,
+                                      SP_LOCKED))
+#elif defined(CONFIG_TICKET_SPINLOCK)
   unsigned short ticket =
     atomic_load((FAR atomic_ushort *)&lock->tickets.next);
 
@@ -392,6 +474,7 @@ static inline_function bool spin_trylock(FAR volatile spinlock_t *lock)
     {
       /* Notify that we have the spinlock */
 
+      spin_lockdep_acquire(lock, true);
       sched_note_spinlock_locked(lock);
     }
   else
@@ -430,7 +513,9 @@ static inline_function void
 spin_unlock_wo_note(FAR volatile spinlock_t *lock)
 {
   SP_DMB();
-#ifdef CONFIG_TICKET_SPINLOCK
+#if defined(CONFIG_QUEUED_SPINLOCK)
+  atomic_fetch_and((FAR atomic_uint *)lock, ~SP_LOCKED);
+#elif defined(CONFIG_TICKET_SPINLOCK)
   atomic_fetch_add((FAR atomic_ushort *)&lock->tickets.owner, 1);
 #else
   *lock = SP_UNLOCKED;
@@ -461,6 +546,9 @@ spin_unlock_wo_note(FAR volatile spinlock_t *lock)
 #  ifdef __SP_UNLOCK_FUNCTION
 static inline_function void spin_unlock(FAR volatile spinlock_t *lock)
 {
+  spin_lockdep_release(lock);
+  spin_lockstat_release(lock);
+
   /* Unlock without trace note */
 
   spin_unlock_wo_note(lock);
@@ -489,7 +577,9 @@ static inline_function void spin_unlock(FAR volatile spinlock_t *lock)
  ****************************************************************************/
 
 /* bool spin_islocked(FAR spinlock_t lock); */
-#ifdef CONFIG_TICKET_SPINLOCK
+#if defined(CONFIG_QUEUED_SPINLOCK)
+#  define spin_is_locked(l) ((*(l) & SP_LOCKED) != 0)
+#elif defined(CONFIG_TICKET_SPINLOCK)
 #  define spin_is_locked(l) ((*l).tickets.owner != (*l).tickets.next)
 #else
 #  define spin_is_locked(l) (*(l) == SP_LOCKED)
@@ -594,6 +684,8 @@ irqstate_t spin_lock_irqsave(FAR volatile spinlock_t *lock)
   /* Notify that we are waiting for a spinlock */
 
   sched_note_spinlock_lock(lock);
+  spin_lockdep_acquire(lock, false);
+  spin_lockstat_acquire(lock);
 
   /* Lock without trace note */
 
@@ -601,6 +693,7 @@ irqstate_t spin_lock_irqsave(FAR volatile spinlock_t *lock)
 
   /* Notify that we have the spinlock */
 
+  spin_lockstat_acquired(lock);
   sched_note_spinlock_locked(lock);
 
   return flags;
@@ -753,6 +846,9 @@ static inline_function
 void spin_unlock_irqrestore(FAR volatile spinlock_t *lock,
                             irqstate_t flags)
 {
+  spin_lockdep_release(lock);
+  spin_lockstat_release(lock);
+
   /* Unlock without trace note */
 
   spin_unlock_irqrestore_wo_note(lock, flags);
@@ -811,6 +907,15 @@ void spin_unlock_irqrestore(FAR volatile spinlock_t *lock,
 
 static inline_function void read_lock(FAR volatile rwlock_t *lock)
 {
+#ifdef CONFIG_QUEUED_SPINLOCK
+  unsigned int cnts = atomic_fetch_add((FAR atomic_uint *)&lock->cnts,
+                                       RW_SP_RBIAS);
+
+  if ((cnts & RW_SP_WMASK) != 0)
+    {
+      read_lock_queued(lock);
+    }
+#else
   while (true)
     {
       int old = atomic_load((FAR atomic_int *)lock);
@@ -826,6 +931,7 @@ static inline_function void read_lock(FAR volatile rwlock_t *lock)
           break;
         }
     }
+#endif
 
   SP_DMB();
 }
@@ -856,6 +962,16 @@ static inline_function void read_lock(FAR volatile rwlock_t *lock)
 
 static inline_function bool read_trylock(FAR volatile rwlock_t *lock)
 {
+#ifdef CONFIG_QUEUED_SPINLOCK
+  unsigned int cnts = atomic_load((FAR atomic_uint *)&lock->cnts);
+
+  if ((cnts & RW_SP_WMASK) != 0 ||
+      !atomic_compare_exchange_strong((FAR atomic_uint *)&lock->cnts,
+                                      &cnts, cnts + RW_SP_RBIAS))
+    {
+      return false;
+    }
+#else
   while (true)
     {
       int old = atomic_load((FAR atomic_int *)lock);
@@ -870,6 +986,7 @@ static inline_function bool read_trylock(FAR volatile rwlock_t *lock)
           break;
         }
     }
+#endif
 
   SP_DMB();
   return true;
@@ -894,10 +1011,17 @@ static inline_function bool read_trylock(FAR volatile rwlock_t *lock)
 
 static inline_function void read_unlock(FAR volatile rwlock_t *lock)
 {
+#ifdef CONFIG_QUEUED_SPINLOCK
+  DEBUGASSERT(atomic_load((FAR atomic_uint *)&lock->cnts) >= RW_SP_RBIAS);
+
+  SP_DMB();
+  atomic_fetch_sub((FAR atomic_uint *)&lock->cnts, RW_SP_RBIAS);
+#else
   DEBUGASSERT(atomic_load((FAR atomic_int *)lock) >= RW_SP_READ_LOCKED);
 
   SP_DMB();
   atomic_fetch_sub((FAR atomic_int *)lock, 1);
+#endif
   SP_DSB();
   SP_SEV();
 }
@@ -929,6 +1053,15 @@ static inline_function void read_unlock(FAR volatile rwlock_t *lock)
 
 static inline_function void write_lock(FAR volatile rwlock_t *lock)
 {
+#ifdef CONFIG_QUEUED_SPINLOCK
+  unsigned int zero = 0;
+
+  if (!atomic_compare_exchange_strong((FAR atomic_uint *)&lock->cnts,
+                                      &zero, RW_SP_WLOCKED))
+    {
+      write_lock_queued(lock);
+    }
+#else
   int zero = RW_SP_UNLOCKED;
 
   while (!atomic_compare_exchange_strong((FAR atomic_int *)lock,
@@ -937,6 +1070,7 @@ static inline_function void write_lock(FAR volatile rwlock_t *lock)
       SP_DSB();
       SP_WFE();
     }
+#endif
 
   SP_DMB();
 }
@@ -968,10 +1102,17 @@ static inline_function void write_lock(FAR volatile rwlock_t *lock)
 
 static inline_function bool write_trylock(FAR volatile rwlock_t *lock)
 {
+#ifdef CONFIG_QUEUED_SPINLOCK
+  unsigned int zero = 0;
+
+  if (atomic_compare_exchange_strong((FAR atomic_uint *)&lock->cnts,
+                                     &zero, RW_SP_WLOCKED))
+#else
   int zero = RW_SP_UNLOCKED;
 
   if (atomic_compare_exchange_strong((FAR atomic_int *)lock,
                                      &zero, RW_SP_WRITE_LOCKED))
+#endif
     {
       SP_DMB();
       return true;
@@ -1002,10 +1143,18 @@ static inline_function void write_unlock(FAR volatile rwlock_t *lock)
 {
   /* Ensure this cpu already get write lock */
 
+#ifdef CONFIG_QUEUED_SPINLOCK
+  DEBUGASSERT((atomic_load((FAR atomic_uint *)&lock->cnts) &
+               RW_SP_WLOCKED) == RW_SP_WLOCKED);
+
+  SP_DMB();
+  atomic_fetch_sub((FAR atomic_uint *)&lock->cnts, RW_SP_WLOCKED);
+#else
   DEBUGASSERT(atomic_load((FAR atomic_int *)lock) == RW_SP_WRITE_LOCKED);
 
   SP_DMB();
   atomic_store((FAR atomic_int *)lock, RW_SP_UNLOCKED);
+#endif
   SP_DSB();
   SP_SEV();
 }
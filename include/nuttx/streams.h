@@ -32,6 +32,8 @@
 #ifdef CONFIG_LIBC_LZF
 #include <lzf.h>
 #endif
+#include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #ifndef CONFIG_DISABLE_MOUNTPOINT
 #include <nuttx/fs/fs.h>
@@ -67,6 +69,11 @@
 #define LZF_STREAM_BLOCKSIZE  ((1 << CONFIG_STREAM_LZF_BLOG) - 1)
 #endif
 
+#ifdef CONFIG_STREAM_LZ4
+#define LZ4_STREAM_BLOCKSIZE  (1 << CONFIG_STREAM_LZ4_BLOG)
+#define LZ4_STREAM_HASHSIZE   (1 << CONFIG_STREAM_LZ4_HLOG)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -288,6 +295,33 @@ struct lib_lzfoutstream_s
 };
 #endif
 
+/* LZ4 frame compressed stream pipeline */
+
+#ifdef CONFIG_STREAM_LZ4
+struct lib_lz4outstream_s
+{
+  struct lib_outstream_s      common;
+  FAR struct lib_outstream_s *backend;
+  bool                        started;
+  size_t                      offset;
+  uint16_t                    table[LZ4_STREAM_HASHSIZE];
+  unsigned char               in[LZ4_STREAM_BLOCKSIZE];
+  unsigned char               out[LZ4_STREAM_BLOCKSIZE];
+};
+
+struct lib_lz4instream_s
+{
+  struct lib_instream_s       common;
+  FAR struct lib_instream_s  *backend;
+  bool                        started;
+  uint8_t                     flags;
+  size_t                      offset;
+  size_t                      size;
+  unsigned char               in[LZ4_STREAM_BLOCKSIZE];
+  unsigned char               out[LZ4_STREAM_BLOCKSIZE];
+};
+#endif
+
 #ifndef CONFIG_DISABLE_MOUNTPOINT
 struct lib_blkoutstream_s
 {
@@ -604,6 +638,53 @@ void lib_lzfoutstream(FAR struct lib_lzfoutstream_s *stream,
                       FAR struct lib_outstream_s *backend);
 #endif
 
+/****************************************************************************
+ * Name: lib_lz4outstream
+ *
+ * Description:
+ *  LZ4 compressed pipeline stream.  The output is in the LZ4 frame format,
+ *  which "lz4 -d" decompresses.  Each flush ends the frame, the next data
+ *  starting a new one.
+ *
+ * Input Parameters:
+ *   stream  - User allocated, uninitialized instance of struct
+ *                lib_lz4outstream_s to be initialized.
+ *   backend - Stream backend port.
+ *
+ * Returned Value:
+ *   None (User allocated instance initialized).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_STREAM_LZ4
+void lib_lz4outstream(FAR struct lib_lz4outstream_s *stream,
+                      FAR struct lib_outstream_s *backend);
+#endif
+
+/****************************************************************************
+ * Name: lib_lz4instream
+ *
+ * Description:
+ *  LZ4 decompressing pipeline stream.  It reads the frames written by
+ *  lib_lz4outstream(), one after the other, or other frames of independent
+ *  blocks that decompress to LZ4_STREAM_BLOCKSIZE bytes at most.  The
+ *  checksums are skipped, not verified.
+ *
+ * Input Parameters:
+ *   stream  - User allocated, uninitialized instance of struct
+ *                lib_lz4instream_s to be initialized.
+ *   backend - Stream backend port.
+ *
+ * Returned Value:
+ *   None (User allocated instance initialized).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_STREAM_LZ4
+void lib_lz4instream(FAR struct lib_lz4instream_s *stream,
+                     FAR struct lib_instream_s *backend);
+#endif
+
 /****************************************************************************
  * Name: lib_blkoutstream_open
  *
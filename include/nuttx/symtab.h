@@ -29,6 +29,8 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -57,6 +59,26 @@ struct symtab_s
   FAR const void *sym_value; /* The value associated with the string */
 };
 
+#ifdef CONFIG_SYMTAB_HASH
+/* struct symtab_hash_s is a hash index of a symbol table, laid out like the
+ * GNU hash section of ELF: a Bloom filter that rejects most of the names
+ * not in the table, then buckets of hash values compared before the names.
+ * The table itself is not modified, so that const tables can be indexed.
+ */
+
+struct symtab_hash_s
+{
+  FAR const struct symtab_s *symtab; /* The table indexed */
+  FAR uintptr_t *bloom;              /* Bloom filter, nbloom words */
+  FAR uint32_t *buckets;             /* First entry of each bucket */
+  FAR uint32_t *chain;               /* Hashes, bit 0 ends a bucket */
+  FAR uint32_t *order;               /* Symbol of each chain entry */
+  uint32_t nbloom;                   /* Power of two */
+  uint32_t nbuckets;                 /* Power of two */
+  int nsyms;
+};
+#endif
+
 /****************************************************************************
  * Public Functions Definitions
  ****************************************************************************/
@@ -121,6 +143,51 @@ symtab_findbyvalue(FAR const struct symtab_s *symtab,
 
 void symtab_sortbyname(FAR struct symtab_s *symtab, int nsyms);
 
+#ifdef CONFIG_SYMTAB_HASH
+/****************************************************************************
+ * Name: symtab_hash_init
+ *
+ * Description:
+ *   Build the hash index of a symbol table.  If the index can't be
+ *   allocated, symtab_hash_find() still works with a linear search.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int symtab_hash_init(FAR struct symtab_hash_s *hash,
+                     FAR const struct symtab_s *symtab, int nsyms);
+
+/****************************************************************************
+ * Name: symtab_hash_uninit
+ *
+ * Description:
+ *   Free the hash index.  The symbol table is not freed.
+ *
+ ****************************************************************************/
+
+void symtab_hash_uninit(FAR struct symtab_hash_s *hash);
+
+/****************************************************************************
+ * Name: symtab_hash_find
+ *
+ * Description:
+ *   Find the symbol with the matching name through the hash index.  If the
+ *   name is in the table more than once, the first entry is returned, like
+ *   symtab_findbyname().
+ *
+ * Returned Value:
+ *   A reference to the symbol table entry if an entry with the matching
+ *   name is found; NULL is returned if the entry is not found.
+ *
+ ****************************************************************************/
+
+FAR const struct symtab_s *
+symtab_hash_find(FAR const struct symtab_hash_s *hash,
+                 FAR const char *name);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -0,0 +1,227 @@
+/****************************************************************************
+ * include/nuttx/syslog/syslog_token.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_SYSLOG_SYSLOG_TOKEN_H
+#define __INCLUDE_NUTTX_SYSLOG_SYSLOG_TOKEN_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <nuttx/compiler.h>
+#include <nuttx/macro.h>
+
+#include <assert.h>
+#include <stdint.h>
+#include <syslog.h>
+
+#ifdef CONFIG_SYSLOG_TOKENIZED
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Tokenized messages.  syslog_token() logs a message whose format is
+ * replaced by a 32-bit token at build time: the format string itself only
+ * goes to the .syslog_tokens section, which is not referenced by the code
+ * and is meant to stay out of the loaded image (see CONFIG_SYSLOG_TOKENIZED
+ * for the linker script entry).  tools/syslog_token.py rebuilds the
+ * messages from the token database in the ELF file.
+ *
+ * The message logged through the usual syslog channels is '$' followed by
+ * the base64 encoding of:
+ *
+ *   u32 (little endian) - The token
+ *   uint                - The types of the arguments, as built by
+ *                         SYSLOG_TOKEN_TYPES()
+ *   ...                 - The arguments: integers as zigzag encoded signed
+ *                         LEB128 numbers, doubles as 8 bytes in the byte
+ *                         order of the target and strings as a uint length
+ *                         followed by the characters.
+ *
+ * 'uint' is an unsigned LEB128 number.
+ */
+
+/* The token is the 65599 hash of the length and of the first
+ * SYSLOG_TOKEN_HASH_LEN characters of the format, computed by the
+ * compiler.
+ */
+
+#define SYSLOG_TOKEN_HASH_LEN 64
+
+#define SYSLOG_TOKEN_CHAR(s, i, k) \
+          + (sizeof(s) - 1 > (i) ? (uint32_t)(uint8_t)(s)[i] * (k) : 0)
+
+#define SYSLOG_TOKEN_HASH(s) \
+        ((uint32_t)(sizeof(s) - 1) \
+          SYSLOG_TOKEN_CHAR(s,  0, 0x0001003fu) \
+          SYSLOG_TOKEN_CHAR(s,  1, 0x007e0f81u) \
+          SYSLOG_TOKEN_CHAR(s,  2, 0x2e86d0bfu) \
+          SYSLOG_TOKEN_CHAR(s,  3, 0x43ec5f01u) \
+          SYSLOG_TOKEN_CHAR(s,  4, 0x162c613fu) \
+          SYSLOG_TOKEN_CHAR(s,  5, 0xd62aee81u) \
+          SYSLOG_TOKEN_CHAR(s,  6, 0xa311b1bfu) \
+          SYSLOG_TOKEN_CHAR(s,  7, 0xd319be01u) \
+          SYSLOG_TOKEN_CHAR(s,  8, 0xb156c23fu) \
+          SYSLOG_TOKEN_CHAR(s,  9, 0x6698cd81u) \
+          SYSLOG_TOKEN_CHAR(s, 10, 0x0d1b92bfu) \
+          SYSLOG_TOKEN_CHAR(s, 11, 0xcc881d01u) \
+          SYSLOG_TOKEN_CHAR(s, 12, 0x7280233fu) \
+          SYSLOG_TOKEN_CHAR(s, 13, 0x50c7ac81u) \
+          SYSLOG_TOKEN_CHAR(s, 14, 0x8da473bfu) \
+          SYSLOG_TOKEN_CHAR(s, 15, 0x4f377c01u) \
+          SYSLOG_TOKEN_CHAR(s, 16, 0xfaa8843fu) \
+          SYSLOG_TOKEN_CHAR(s, 17, 0x33b78b81u) \
+          SYSLOG_TOKEN_CHAR(s, 18, 0x45ac54bfu) \
+          SYSLOG_TOKEN_CHAR(s, 19, 0x7a27db01u) \
+          SYSLOG_TOKEN_CHAR(s, 20, 0xeacfe53fu) \
+          SYSLOG_TOKEN_CHAR(s, 21, 0xae686a81u) \
+          SYSLOG_TOKEN_CHAR(s, 22, 0x563335bfu) \
+          SYSLOG_TOKEN_CHAR(s, 23, 0x6c593a01u) \
+          SYSLOG_TOKEN_CHAR(s, 24, 0xe3f6463fu) \
+          SYSLOG_TOKEN_CHAR(s, 25, 0x5fda4981u) \
+          SYSLOG_TOKEN_CHAR(s, 26, 0xe03916bfu) \
+          SYSLOG_TOKEN_CHAR(s, 27, 0x44cb9901u) \
+          SYSLOG_TOKEN_CHAR(s, 28, 0x871ba73fu) \
+          SYSLOG_TOKEN_CHAR(s, 29, 0xe70d2881u) \
+          SYSLOG_TOKEN_CHAR(s, 30, 0x04bdf7bfu) \
+          SYSLOG_TOKEN_CHAR(s, 31, 0x227ef801u) \
+          SYSLOG_TOKEN_CHAR(s, 32, 0x7540083fu) \
+          SYSLOG_TOKEN_CHAR(s, 33, 0xe3010781u) \
+          SYSLOG_TOKEN_CHAR(s, 34, 0xe4c1d8bfu) \
+          SYSLOG_TOKEN_CHAR(s, 35, 0x24735701u) \
+          SYSLOG_TOKEN_CHAR(s, 36, 0x4f63693fu) \
+          SYSLOG_TOKEN_CHAR(s, 37, 0xf2b5e681u) \
+          SYSLOG_TOKEN_CHAR(s, 38, 0xa144b9bfu) \
+          SYSLOG_TOKEN_CHAR(s, 39, 0x69a8b601u) \
+          SYSLOG_TOKEN_CHAR(s, 40, 0xb685ca3fu) \
+          SYSLOG_TOKEN_CHAR(s, 41, 0xb52bc581u) \
+          SYSLOG_TOKEN_CHAR(s, 42, 0x5b469abfu) \
+          SYSLOG_TOKEN_CHAR(s, 43, 0x111f1501u) \
+          SYSLOG_TOKEN_CHAR(s, 44, 0x4ba72b3fu) \
+          SYSLOG_TOKEN_CHAR(s, 45, 0xc962a481u) \
+          SYSLOG_TOKEN_CHAR(s, 46, 0x33c77bbfu) \
+          SYSLOG_TOKEN_CHAR(s, 47, 0x39d67401u) \
+          SYSLOG_TOKEN_CHAR(s, 48, 0xafc78c3fu) \
+          SYSLOG_TOKEN_CHAR(s, 49, 0xce5a8381u) \
+          SYSLOG_TOKEN_CHAR(s, 50, 0x4bc75cbfu) \
+          SYSLOG_TOKEN_CHAR(s, 51, 0x02ced301u) \
+          SYSLOG_TOKEN_CHAR(s, 52, 0x83e6ed3fu) \
+          SYSLOG_TOKEN_CHAR(s, 53, 0x63136281u) \
+          SYSLOG_TOKEN_CHAR(s, 54, 0xc4463dbfu) \
+          SYSLOG_TOKEN_CHAR(s, 55, 0x8b083201u) \
+          SYSLOG_TOKEN_CHAR(s, 56, 0x69054e3fu) \
+          SYSLOG_TOKEN_CHAR(s, 57, 0x268d4181u) \
+          SYSLOG_TOKEN_CHAR(s, 58, 0xbe441ebfu) \
+          SYSLOG_TOKEN_CHAR(s, 59, 0xf1829101u) \
+          SYSLOG_TOKEN_CHAR(s, 60, 0x0022af3fu) \
+          SYSLOG_TOKEN_CHAR(s, 61, 0xb7c82081u) \
+          SYSLOG_TOKEN_CHAR(s, 62, 0x5ac0ffbfu) \
+          SYSLOG_TOKEN_CHAR(s, 63, 0x553df001u) \
+        )
+
+/* The types of the arguments: two bits per argument and the number of
+ * arguments in the highest four bits, the same layout as the tag of
+ * sched_note_printf().  Any character pointer is taken as a string.
+ */
+
+#define SYSLOG_TOKEN_INT32  0
+#define SYSLOG_TOKEN_INT64  1
+#define SYSLOG_TOKEN_DOUBLE 2
+#define SYSLOG_TOKEN_STRING 3
+
+#define SYSLOG_TOKEN_GET_TYPE(types, index) (((types) >> (index) * 2) & 0x03)
+#define SYSLOG_TOKEN_GET_COUNT(types)       (((types) >> 28) & 0x0f)
+
+#define SYSLOG_TOKEN_ARG_TYPE(arg) \
+        _Generic((arg) + 0, \
+                 float : SYSLOG_TOKEN_DOUBLE, \
+                 double : SYSLOG_TOKEN_DOUBLE, \
+                 char * : SYSLOG_TOKEN_STRING, \
+                 const char * : SYSLOG_TOKEN_STRING, \
+                 default : sizeof((arg) + 0) <= sizeof(uint32_t) ? \
+                           SYSLOG_TOKEN_INT32 : SYSLOG_TOKEN_INT64)
+
+#define SYSLOG_TOKEN_TYPE(arg, index) \
+        + ((uint32_t)SYSLOG_TOKEN_ARG_TYPE(arg) << (index) * 2)
+
+#define SYSLOG_TOKEN_TYPES(...) \
+        (((uint32_t)GET_ARG_COUNT(__VA_ARGS__) << 28) \
+         FOREACH_ARG(SYSLOG_TOKEN_TYPE, ##__VA_ARGS__))
+
+/* Messages of a priority above CONFIG_SYSLOG_TOKENIZED_LEVEL are removed
+ * at build time, arguments included.
+ */
+
+#define syslog_token(priority, fmt, ...) \
+  do \
+    { \
+      if (((priority) & 0x07) <= CONFIG_SYSLOG_TOKENIZED_LEVEL) \
+        { \
+          static const locate_data(".syslog_tokens") used_data \
+          char __fmt__[] = fmt; \
+          static_assert(GET_ARG_COUNT(__VA_ARGS__) <= 14, \
+                        "syslog_token takes up to 14 arguments"); \
+          UNUSED(__fmt__); \
+          syslog_tokenized(priority, SYSLOG_TOKEN_HASH(fmt), \
+                           SYSLOG_TOKEN_TYPES(__VA_ARGS__), \
+                           ##__VA_ARGS__); \
+        } \
+    } \
+  while (0)
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+/****************************************************************************
+ * Name: syslog_tokenized
+ *
+ * Description:
+ *   Log a tokenized message.  This is the back end of syslog_token(), it
+ *   is not meant to be called directly.
+ *
+ * Input Parameters:
+ *   priority - The priority of the message
+ *   token    - The token of the format
+ *   types    - The types of the arguments
+ *   ...      - The arguments
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void syslog_tokenized(int priority, uint32_t token, uint32_t types, ...);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CONFIG_SYSLOG_TOKENIZED */
+#endif /* __INCLUDE_NUTTX_SYSLOG_SYSLOG_TOKEN_H */
@@ -223,6 +223,10 @@ struct tls_info_s
 
   uint16_t tl_size;                    /* Actual size with alignments */
   int tl_errno;                        /* Per-thread error number */
+
+#ifdef CONFIG_SEM_USER_FASTPATH
+  pid_t tl_tid;                        /* Thread ID, for user space mutexes */
+#endif
 };
 
 /****************************************************************************
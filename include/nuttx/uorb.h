@@ -1117,6 +1117,55 @@ struct sensor_state_s
   uint64_t priv;               /* The pointer to private data of userspace user */
 };
 
+/* This structure describes one topic of SNIOC_GET_LATEST */
+
+struct sensor_topic_s
+{
+  int       fd;                /* The file descriptor of the topic */
+  uint32_t  len;               /* The size of buffer */
+  FAR void *buffer;            /* The buffer of the latest sample */
+  int32_t   result;            /* The size of the sample or a negated errno */
+  uint32_t  generation;        /* The generation of the sample */
+};
+
+/* This structure describes the topics of SNIOC_GET_LATEST, the samples
+ * aren't consumed, the generation tells if a sample was already seen.
+ */
+
+struct sensor_latest_s
+{
+  uint32_t                  ntopics;  /* The number of topics */
+  FAR struct sensor_topic_s *topics;  /* The topics */
+};
+
+/* This structure is the head of the buffer of a topic mapped by mmap()
+ * (CONFIG_SENSORS_MMAP).  It is followed by the generation of each slot,
+ * the timing buffer, and then by the samples.  Sample n (counting from
+ * zero) is in slot n % nbuffer, the publisher clears the generation of the
+ * slot, writes the sample, writes its generation and then updates count
+ * and generation here.  A subscriber reads count, the generation of the
+ * slot of the sample, the sample in place and the generation again, with
+ * acquire ordering; the sample is valid if both generations are equal and
+ * not zero.
+ */
+
+struct sensor_mmap_s
+{
+  uint32_t esize;              /* The element size of circular buffer */
+  uint32_t nbuffer;            /* The number of slots of circular buffer */
+  uint32_t count;              /* The number of samples published */
+  uint32_t generation;         /* The generation of the last sample */
+};
+
+#define SENSOR_MMAP_TIMING(map) \
+  ((FAR uint32_t *)((FAR struct sensor_mmap_s *)(map) + 1))
+#define SENSOR_MMAP_DATAOFF(nbuffer) \
+  ((sizeof(struct sensor_mmap_s) + (nbuffer) * sizeof(uint32_t) + 7) & ~7)
+#define SENSOR_MMAP_DATA(map) \
+  ((FAR uint8_t *)(map) + SENSOR_MMAP_DATAOFF((map)->nbuffer))
+#define SENSOR_MMAP_SIZE(nbuffer, esize) \
+  (SENSOR_MMAP_DATAOFF(nbuffer) + (nbuffer) * (esize))
+
 /* This structure describes the state for the sensor user */
 
 struct sensor_ustate_s
@@ -77,7 +77,8 @@
  * Public Type Definitions
  ****************************************************************************/
 
-struct mm_heap_s; /* Forward reference */
+struct mm_heap_s;    /* Forward reference */
+struct clock_user_s; /* Forward reference */
 
 /* Every user-space blob starts with a header that provides information about
  * the blob.  The form of that header is provided by struct userspace_s. An
@@ -116,6 +117,12 @@ struct userspace_s
 #ifdef CONFIG_LIBC_USRWORK
   CODE int (*work_usrstart)(void);
 #endif
+
+  /* Clock state published by the kernel */
+
+#ifdef CONFIG_CLOCK_USERSPACE
+  FAR struct clock_user_s *us_clock;
+#endif
 };
 
 /****************************************************************************
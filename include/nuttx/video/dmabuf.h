@@ -0,0 +1,202 @@
+/****************************************************************************
+ * include/nuttx/video/dmabuf.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_VIDEO_DMABUF_H
+#define __INCLUDE_NUTTX_VIDEO_DMABUF_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <poll.h>
+
+#ifdef CONFIG_VIDEO_DMABUF
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* A buffer shared by file descriptor between the video devices: the
+ * capture and m2m devices export their MMAP buffers with VIDIOC_EXPBUF and
+ * the framebuffer its buffers with FBIO_EXPBUF, and V4L2_MEMORY_DMABUF
+ * queues one of them to another device without a copy.
+ *
+ * While the buffer is queued to a device it is in use, and poll() on its
+ * file descriptor waits for POLLIN | POLLOUT, that come when no device
+ * uses it anymore.  This is the fence of the buffer.
+ */
+
+struct dmabuf_s
+{
+  FAR void          *addr;     /* Start of the buffer */
+  size_t             len;      /* Length of the buffer in bytes */
+  int                crefs;    /* File descriptors and devices holding it */
+  int                users;    /* Devices the buffer is queued to */
+  CODE void        (*release)(FAR void *arg);
+  FAR void          *arg;      /* Argument of release() */
+  FAR struct pollfd *fds[CONFIG_VIDEO_DMABUF_NPOLLWAITERS];
+};
+
+/* A memory block out of which dmabufs are exported.  It is freed once its
+ * owner and all the dmabufs exported from it have released it, so that the
+ * exporter may free or reallocate its buffers while they are still shared.
+ */
+
+struct dmabuf_pool_s
+{
+  FAR void *base;              /* Start of the memory block */
+  int       crefs;             /* Owner and exported dmabufs */
+  CODE void (*free)(FAR void *arg, FAR void *base);
+  FAR void *arg;               /* Argument of free() */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: dmabuf_export
+ *
+ * Description:
+ *   Create a dmabuf for the memory at addr and return a new file
+ *   descriptor of it.  release(arg), if not NULL, is called when the last
+ *   reference of the dmabuf goes.
+ *
+ * Input Parameters:
+ *   addr    - Start of the buffer
+ *   len     - Length of the buffer in bytes
+ *   oflags  - O_CLOEXEC, the access mode is ignored
+ *   release - Called when the dmabuf is destroyed, may be NULL
+ *   arg     - Argument of release()
+ *
+ * Returned Value:
+ *   The file descriptor is returned on success; a negated errno value is
+ *   returned on any failure.
+ *
+ ****************************************************************************/
+
+int dmabuf_export(FAR void *addr, size_t len, int oflags,
+                  CODE void (*release)(FAR void *arg), FAR void *arg);
+
+/****************************************************************************
+ * Name: dmabuf_import
+ *
+ * Description:
+ *   Take a reference of the dmabuf of a file descriptor.  The reference
+ *   stays valid after the file descriptor is closed, until
+ *   dmabuf_release().
+ *
+ * Input Parameters:
+ *   fd     - File descriptor returned by dmabuf_export()
+ *   dmabuf - Location to return the dmabuf
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   any failure, -EINVAL if fd isn't a dmabuf.
+ *
+ ****************************************************************************/
+
+int dmabuf_import(int fd, FAR struct dmabuf_s **dmabuf);
+
+/****************************************************************************
+ * Name: dmabuf_release
+ *
+ * Description:
+ *   Drop a reference taken by dmabuf_import().
+ *
+ ****************************************************************************/
+
+void dmabuf_release(FAR struct dmabuf_s *dmabuf);
+
+/****************************************************************************
+ * Name: dmabuf_begin / dmabuf_end
+ *
+ * Description:
+ *   Mark the dmabuf in use by a device when it is queued to it, and no
+ *   more when it is given back.  The fence of the dmabuf is signaled when
+ *   its last user ends.  dmabuf_end() may be called from interrupt
+ *   handlers.
+ *
+ ****************************************************************************/
+
+void dmabuf_begin(FAR struct dmabuf_s *dmabuf);
+void dmabuf_end(FAR struct dmabuf_s *dmabuf);
+
+/****************************************************************************
+ * Name: dmabuf_pool_create
+ *
+ * Description:
+ *   Make a pool of the memory block at base, owned by the caller.
+ *   free(arg, base) releases the block once the pool is released by its
+ *   owner and by all the dmabufs exported from it.
+ *
+ * Returned Value:
+ *   The pool is returned on success; NULL if it can't be allocated.
+ *
+ ****************************************************************************/
+
+FAR struct dmabuf_pool_s *
+dmabuf_pool_create(FAR void *base,
+                   CODE void (*free)(FAR void *arg, FAR void *base),
+                   FAR void *arg);
+
+/****************************************************************************
+ * Name: dmabuf_pool_export
+ *
+ * Description:
+ *   dmabuf_export() the len bytes at offset of the pool.  The dmabuf holds
+ *   a reference of the pool.
+ *
+ ****************************************************************************/
+
+int dmabuf_pool_export(FAR struct dmabuf_pool_s *pool, size_t offset,
+                       size_t len, int oflags);
+
+/****************************************************************************
+ * Name: dmabuf_pool_release
+ *
+ * Description:
+ *   Drop a reference of the pool.  The owner calls it instead of freeing
+ *   the memory block itself.
+ *
+ ****************************************************************************/
+
+void dmabuf_pool_release(FAR struct dmabuf_pool_s *pool);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_VIDEO_DMABUF */
+#endif /* __INCLUDE_NUTTX_VIDEO_DMABUF_H */
@@ -319,6 +319,31 @@
                                               /* Argument: writable struct
                                                *           fb_fix_screeninfo */
 
+/* Swap Chain ***************************************************************/
+
+#ifdef CONFIG_FB_SWAPCHAIN
+#  define FBIOGET_SWAPBUF     _FBIOC(0x001d)  /* Acquire a free buffer
+                                               * Argument: writable struct
+                                               *           fb_swapbuf_s */
+#  define FBIOPUT_SWAPBUF     _FBIOC(0x001e)  /* Queue an acquired buffer
+                                               * for display
+                                               * Argument: read/write struct
+                                               *           fb_swapbuf_s */
+#  define FBIO_RELEASEBUF     _FBIOC(0x001f)  /* Release an acquired buffer
+                                               * without displaying it
+                                               * Argument:             int */
+#  define FBIO_WAITFENCE      _FBIOC(0x0020)  /* Wait for a queued buffer to
+                                               * be displayed
+                                               * Argument:  unsigned long */
+#endif
+
+#ifdef CONFIG_VIDEO_DMABUF
+#  define FBIO_EXPBUF         _FBIOC(0x0021)  /* Export a buffer as a file
+                                               * descriptor
+                                               * Argument: read/write struct
+                                               *           fb_expbuf_s */
+#endif
+
 #define FB_TYPE_PACKED_PIXELS        0      /* Packed Pixels */
 #define FB_TYPE_PLANES               1      /* Non interleaved planes */
 #define FB_TYPE_INTERLEAVED_PLANES   2      /* Interleaved planes */
@@ -684,6 +709,35 @@ struct fb_setcursor_s
 };
 #endif
 
+#ifdef CONFIG_FB_SWAPCHAIN
+/* This structure describes one buffer of the swap chain of the selected
+ * plane or overlay.  The buffer is at yoffset = index * yres of the
+ * virtual resolution.  The fence of a queued buffer is reached when the
+ * buffer is being displayed; the buffer displayed before it is free again.
+ */
+
+struct fb_swapbuf_s
+{
+  uint8_t    index;        /* Buffer index */
+  uint32_t   yoffset;      /* Offset of the buffer in the virtual rows */
+  uint32_t   fence;        /* Fence returned by FBIOPUT_SWAPBUF */
+};
+#endif
+
+#ifdef CONFIG_VIDEO_DMABUF
+/* This structure exports the buffer index of the selected plane or overlay
+ * as a file descriptor, that V4L2_MEMORY_DMABUF queues to a capture or m2m
+ * device so that it renders straight into the framebuffer.
+ */
+
+struct fb_expbuf_s
+{
+  uint8_t    index;        /* Buffer index, as in struct fb_swapbuf_s */
+  int        flags;        /* O_CLOEXEC or 0 */
+  int        fd;           /* Exported file descriptor */
+};
+#endif
+
 union fb_paninfo_u
 {
   struct fb_planeinfo_s planeinfo;
@@ -751,6 +805,25 @@ struct fb_vtable_s
   int (*waitforvsync)(FAR struct fb_vtable_s *vtable);
 #endif
 
+#ifdef CONFIG_FB_ACCEL
+  /* The following are provided only if the video hardware has a 2D
+   * accelerator.  fillarea() fills the area of the plane with the color,
+   * in the pixel format of the plane.  copyarea() copies a source image in
+   * the pixel format of the plane, of srcstride bytes per row, to the area
+   * of the plane.  They return when the plane memory has been written.
+   * Either may be NULL, or fail with a negated errno value when the
+   * accelerator can't do it; the caller does the operation with the CPU.
+   */
+
+  int (*fillarea)(FAR struct fb_vtable_s *vtable,
+                  FAR const struct fb_planeinfo_s *pinfo,
+                  FAR const struct fb_area_s *area, uint32_t color);
+  int (*copyarea)(FAR struct fb_vtable_s *vtable,
+                  FAR const struct fb_planeinfo_s *pinfo,
+                  FAR const struct fb_area_s *area, FAR const void *src,
+                  size_t srcstride);
+#endif
+
 #ifdef CONFIG_FB_OVERLAY
   /* Get information about the video controller configuration and the
    * configuration of each overlay.
@@ -147,6 +147,10 @@ struct v4l2_ops_s
                           FAR struct v4l2_decoder_cmd *cmd);
   CODE int (*encoder_cmd)(FAR struct file *filep,
                           FAR struct v4l2_encoder_cmd *cmd);
+#ifdef CONFIG_VIDEO_DMABUF
+  CODE int (*expbuf)(FAR struct file *filep,
+                     FAR struct v4l2_exportbuffer *expbuf);
+#endif
 };
 
 /****************************************************************************
@@ -87,6 +87,10 @@ struct wdog_s
   FAR void          *picbase;    /* PIC base address */
 #endif
   clock_t            expired;    /* Timer associated with the absoulute time */
+#ifdef CONFIG_WDOG_PERCPU
+  uint8_t            cpu;        /* Pinned CPU + 1, 0: the CPU calling wd_start */
+  uint8_t            qcpu;       /* CPU whose queue holds the watchdog */
+#endif
 };
 
 /****************************************************************************
@@ -278,6 +282,32 @@ static inline int wd_start_realtime(FAR struct wdog_s *wdog,
 #endif
 }
 
+/****************************************************************************
+ * Name: wd_setcpu
+ *
+ * Description:
+ *   Pin a watchdog to a CPU.  By default a watchdog is queued on, and
+ *   expires on, the CPU that calls wd_start().  A pinned watchdog always
+ *   expires on the selected CPU instead.  The setting takes effect with the
+ *   next wd_start() and persists until changed.
+ *
+ * Input Parameters:
+ *   wdog - Watchdog ID
+ *   cpu  - The CPU to pin the watchdog to, or a negative value to expire
+ *          on the CPU that starts it.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned to
+ *   indicate the nature of any failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_PERCPU
+int wd_setcpu(FAR struct wdog_s *wdog, int cpu);
+#else
+#  define wd_setcpu(wdog, cpu) ((void)(wdog), (void)(cpu), 0)
+#endif
+
 /****************************************************************************
  * Name: wd_cancel
  *
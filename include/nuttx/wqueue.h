@@ -415,6 +415,40 @@ int work_queue_wq(FAR struct kwork_wqueue_s *wqueue,
                   FAR struct work_s *work, worker_t worker,
                   FAR void *arg, clock_t delay);
 
+/****************************************************************************
+ * Name: work_queue_slack/work_queue_slack_wq
+ *
+ * Description:
+ *   Queue work to be performed after the delay, like work_queue(), but
+ *   allow the work queue to run it up to slack ticks late.  The expiry is
+ *   rounded within the slack to a tick multiple of a large power of two,
+ *   so that the work due at close times expires together.
+ *
+ * Input Parameters:
+ *   qid    - The work queue ID (must be HPWORK or LPWORK)
+ *   wqueue - The work queue handle
+ *   work   - The work structure to queue
+ *   worker - The worker callback to be invoked.  The callback will be
+ *            invoked on the worker thread of execution.
+ *   arg    - The argument that will be passed to the worker callback when
+ *            it is invoked.
+ *   delay  - Delay (in clock ticks) from the time queue until the worker
+ *            is invoked. Zero means to perform the work immediately.
+ *   slack  - The ticks the work may be performed after the delay.
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WQUEUE_COALESCE
+int work_queue_slack(int qid, FAR struct work_s *work, worker_t worker,
+                     FAR void *arg, clock_t delay, clock_t slack);
+int work_queue_slack_wq(FAR struct kwork_wqueue_s *wqueue,
+                        FAR struct work_s *work, worker_t worker,
+                        FAR void *arg, clock_t delay, clock_t slack);
+#endif
+
 /****************************************************************************
  * Name: work_queue_pri
  *
@@ -520,7 +554,12 @@ int work_cancel_sync_wq(FAR struct kwork_wqueue_s *wqueue,
  *
  ****************************************************************************/
 
-#ifdef __KERNEL__
+#if defined(__KERNEL__) && defined(CONFIG_WQUEUE_COALESCE)
+#  define work_timeleft(work) \
+     ((work)->worker != NULL && \
+      (sclock_t)((work)->u.s.qtime - clock()) > 0 ? \
+      (sclock_t)((work)->u.s.qtime - clock()) : 0)
+#elif defined(__KERNEL__)
 #  define work_timeleft(work) wd_gettime(&((work)->u.timer))
 #else
 #  define work_timeleft(work) ((sclock_t)((work)->u.s.qtime - clock()))
@@ -122,6 +122,9 @@ struct sem_s
   uint8_t ceiling;               /* The priority ceiling owned by mutex  */
   uint8_t saved;                 /* The saved priority of thread before boost */
 #endif
+#ifdef CONFIG_SCHED_LOCKSTAT
+  FAR void *initsite;            /* Caller of the init, the lock class */
+#endif
 };
 
 typedef struct sem_s sem_t;
@@ -70,6 +70,10 @@
 
 #define MAP_UNINITIALIZED (1 << 26)     /* Bit 26: Do not clear the anonymous pages */
 
+/* The following flags are used with mremap() */
+
+#define MREMAP_MAYMOVE  0x01            /* The mapping may be moved */
+
 /* Failure return */
 
 #define MAP_FAILED      ((FAR void*)-1)
@@ -202,6 +206,8 @@ int mlockall(int flags);
 FAR void *mmap(FAR void *start, size_t length, int prot, int flags, int fd,
                off_t offset);
 int mprotect(FAR void *addr, size_t len, int prot);
+FAR void *mremap(FAR void *old_address, size_t old_size, size_t new_size,
+                 int flags);
 int msync(FAR void *addr, size_t len, int flags);
 int munlock(FAR const void *addr, size_t len);
 int munlockall(void);
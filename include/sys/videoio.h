@@ -800,6 +800,24 @@ struct v4l2_buffer
 
 typedef struct v4l2_buffer v4l2_buffer_t;
 
+/* struct v4l2_exportbuffer
+ * Parameter of ioctl(VIDIOC_EXPBUF).  The MMAP buffer index of the type is
+ * exported as a new file descriptor fd, that V4L2_MEMORY_DMABUF queues to
+ * another device.  flags may be O_CLOEXEC.
+ */
+
+struct v4l2_exportbuffer
+{
+  uint32_t             type;      /* enum #v4l2_buf_type */
+  uint32_t             index;     /* Buffer id */
+  uint32_t             plane;     /* Plane, 0 only */
+  uint32_t             flags;     /* Flags of the file descriptor */
+  int32_t              fd;        /* Driver sets the file descriptor */
+  uint32_t             reserved[11];
+};
+
+typedef struct v4l2_exportbuffer v4l2_exportbuffer_t;
+
 /* Image is a keyframe (I-frame) */
 
 #define V4L2_BUF_FLAG_KEYFRAME                  0x00000008
@@ -154,7 +154,9 @@ int               fputws(FAR const wchar_t *, FILE *);
 int               fputws_unlocked(FAR const wchar_t *, FAR FILE *);
 int               fwide(FILE *, int);
 wint_t            getwc(FAR FILE *);
+wint_t            getwc_unlocked(FAR FILE *);
 wint_t            getwchar(void);
+wint_t            getwchar_unlocked(void);
 int               mbsinit(FAR const mbstate_t *);
 size_t            mbrlen(FAR const char *, size_t, FAR mbstate_t *);
 size_t            mbrtowc(FAR wchar_t *, FAR const char *, size_t,
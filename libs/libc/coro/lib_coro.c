@@ -0,0 +1,423 @@
+/****************************************************************************
+ * libs/libc/coro/lib_coro.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+
+#include <nuttx/coro.h>
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: coro_now
+ *
+ * Description:
+ *   The monotonic time in milliseconds, wrapping around.
+ *
+ ****************************************************************************/
+
+static uint32_t coro_now(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint32_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/****************************************************************************
+ * Name: coro_add_sleeping
+ *
+ * Description:
+ *   Insert coro in the sleeping list, sorted by the time of the timeout.
+ *
+ ****************************************************************************/
+
+static void coro_add_sleeping(FAR struct coro_sched_s *sched,
+                              FAR struct coro_s *coro)
+{
+  FAR dq_entry_t *entry;
+
+  /* Most of the timeouts have the same length, so search from the tail */
+
+  for (entry = dq_tail(&sched->sleeping); entry != NULL;
+       entry = dq_prev(entry))
+    {
+      FAR struct coro_s *prev = (FAR struct coro_s *)entry;
+
+      if ((int32_t)(coro->wakeup - prev->wakeup) >= 0)
+        {
+          break;
+        }
+    }
+
+  if (entry != NULL)
+    {
+      dq_addafter(entry, &coro->node, &sched->sleeping);
+    }
+  else
+    {
+      dq_addfirst(&coro->node, &sched->sleeping);
+    }
+
+  coro->sleeping = true;
+}
+
+/****************************************************************************
+ * Name: coro_wakeup
+ *
+ * Description:
+ *   Make coro ready again, with the events revents.
+ *
+ ****************************************************************************/
+
+static void coro_wakeup(FAR struct coro_sched_s *sched,
+                        FAR struct coro_s *coro, uint32_t revents)
+{
+  if (coro->sleeping)
+    {
+      dq_rem(&coro->node, &sched->sleeping);
+      coro->sleeping = false;
+    }
+
+  coro->events  = 0;
+  coro->revents = revents;
+  dq_addlast(&coro->node, &sched->ready);
+}
+
+/****************************************************************************
+ * Name: coro_expire
+ *
+ * Description:
+ *   Wake up the coroutines whose timeout is past.
+ *
+ ****************************************************************************/
+
+static void coro_expire(FAR struct coro_sched_s *sched)
+{
+  FAR struct coro_s *coro;
+  uint32_t now = coro_now();
+
+  while ((coro = (FAR struct coro_s *)dq_peek(&sched->sleeping)) != NULL &&
+         (int32_t)(coro->wakeup - now) <= 0)
+    {
+      /* An event still armed could resume it a second time, so the fd
+       * is removed from epoll.
+       */
+
+      if (coro->events != 0)
+        {
+          coro_release_fd(coro);
+        }
+
+      coro_wakeup(sched, coro, 0);
+    }
+}
+
+/****************************************************************************
+ * Name: coro_timeout
+ *
+ * Description:
+ *   The timeout of epoll_wait(): 0 if a coroutine is ready, until the
+ *   first timeout if one is sleeping, otherwise forever.
+ *
+ ****************************************************************************/
+
+static int coro_timeout(FAR struct coro_sched_s *sched)
+{
+  FAR struct coro_s *coro;
+  int32_t delay;
+
+  if (!dq_empty(&sched->ready))
+    {
+      return 0;
+    }
+
+  coro = (FAR struct coro_s *)dq_peek(&sched->sleeping);
+  if (coro == NULL)
+    {
+      return -1;
+    }
+
+  delay = (int32_t)(coro->wakeup - coro_now());
+  return delay > 0 ? delay : 0;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: coro_sched_init
+ *
+ * Description:
+ *   Initialize a scheduler of coroutines.
+ *
+ * Returned Value:
+ *   0 on success, otherwise -1 with errno set.
+ *
+ ****************************************************************************/
+
+int coro_sched_init(FAR struct coro_sched_s *sched)
+{
+  sched->epfd = epoll_create1(EPOLL_CLOEXEC);
+  if (sched->epfd < 0)
+    {
+      return ERROR;
+    }
+
+  dq_init(&sched->ready);
+  dq_init(&sched->sleeping);
+  sched->ncoros = 0;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: coro_sched_deinit
+ *
+ * Description:
+ *   Release a scheduler, once no coroutine is left in it.
+ *
+ ****************************************************************************/
+
+void coro_sched_deinit(FAR struct coro_sched_s *sched)
+{
+  close(sched->epfd);
+  sched->epfd = -1;
+}
+
+/****************************************************************************
+ * Name: coro_start
+ *
+ * Description:
+ *   Add the coroutine coro with the body entry to the ready coroutines of
+ *   sched.  It may be called from a coroutine of sched too.
+ *
+ ****************************************************************************/
+
+void coro_start(FAR struct coro_sched_s *sched, FAR struct coro_s *coro,
+                coro_entry_t entry, FAR void *arg)
+{
+  coro->sched    = sched;
+  coro->entry    = entry;
+  coro->arg      = arg;
+  coro->line     = 0;
+  coro->fd       = -1;
+  coro->events   = 0;
+  coro->revents  = 0;
+  coro->sleeping = false;
+
+  dq_addlast(&coro->node, &sched->ready);
+  sched->ncoros++;
+}
+
+/****************************************************************************
+ * Name: coro_sched_run
+ *
+ * Description:
+ *   Run the coroutines of sched in the calling thread until all of them
+ *   are done.
+ *
+ * Returned Value:
+ *   0 when all the coroutines are done, otherwise -1 with errno set.
+ *
+ ****************************************************************************/
+
+int coro_sched_run(FAR struct coro_sched_s *sched)
+{
+  struct epoll_event events[CONFIG_LIBC_CORO_NEVENTS];
+  FAR struct coro_s *coro;
+  FAR dq_entry_t *entry;
+  size_t nready;
+  int nevents;
+  int i;
+
+  while (sched->ncoros > 0)
+    {
+      /* Run each ready coroutine once.  Those yielding go back to the
+       * tail, and they run in the next round, after epoll has been
+       * checked.
+       */
+
+      nready = 0;
+      for (entry = dq_peek(&sched->ready); entry != NULL;
+           entry = dq_next(entry))
+        {
+          nready++;
+        }
+
+      while (nready-- > 0)
+        {
+          coro = (FAR struct coro_s *)dq_remfirst(&sched->ready);
+          switch (coro->entry(coro))
+            {
+              case CORO_READY:
+                dq_addlast(&coro->node, &sched->ready);
+                break;
+
+              case CORO_WAITING:
+                break;
+
+              default:
+                coro_release_fd(coro);
+                if (coro->sleeping)
+                  {
+                    dq_rem(&coro->node, &sched->sleeping);
+                    coro->sleeping = false;
+                  }
+
+                sched->ncoros--;
+                break;
+            }
+        }
+
+      if (sched->ncoros == 0)
+        {
+          break;
+        }
+
+      nevents = epoll_wait(sched->epfd, events, CONFIG_LIBC_CORO_NEVENTS,
+                           coro_timeout(sched));
+      if (nevents < 0)
+        {
+          if (errno == EINTR)
+            {
+              continue;
+            }
+
+          return ERROR;
+        }
+
+      for (i = 0; i < nevents; i++)
+        {
+          coro = events[i].data.ptr;
+          if (coro->events != 0)
+            {
+              coro_wakeup(sched, coro, events[i].events);
+            }
+        }
+
+      coro_expire(sched);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: coro_release_fd
+ *
+ * Description:
+ *   A file descriptor stays registered to epoll after CORO_WAIT_FD(), so
+ *   that waiting again on it costs a single epoll_ctl().  This removes it,
+ *   it must be called before the descriptor is closed.  It is done by the
+ *   scheduler too when the coroutine is done.
+ *
+ ****************************************************************************/
+
+void coro_release_fd(FAR struct coro_s *coro)
+{
+  if (coro->fd >= 0)
+    {
+      epoll_ctl(coro->sched->epfd, EPOLL_CTL_DEL, coro->fd, NULL);
+      coro->fd     = -1;
+      coro->events = 0;
+    }
+}
+
+/****************************************************************************
+ * Name: coro_park_fd
+ *
+ * Description:
+ *   Park coro until the events on fd, if fd is not negative, or until ms
+ *   milliseconds have passed, if ms is not negative.
+ *
+ * Returned Value:
+ *   CORO_WAITING when parked.  CORO_READY with the revents EPOLLERR and
+ *   errno set, when fd cannot be waited for.
+ *
+ ****************************************************************************/
+
+int coro_park_fd(FAR struct coro_s *coro, int fd, uint32_t events, int ms)
+{
+  FAR struct coro_sched_s *sched = coro->sched;
+  struct epoll_event ev;
+  int ret = OK;
+
+  coro->revents = 0;
+
+  if (fd >= 0)
+    {
+      /* Events are oneshot, so that a fd is reported only to the
+       * coroutine waiting on it, and it is armed again by EPOLL_CTL_MOD.
+       */
+
+      ev.events   = events | EPOLLONESHOT;
+      ev.data.ptr = coro;
+
+      if (coro->fd != fd)
+        {
+          coro_release_fd(coro);
+          ret = epoll_ctl(sched->epfd, EPOLL_CTL_ADD, fd, &ev);
+        }
+      else
+        {
+          ret = epoll_ctl(sched->epfd, EPOLL_CTL_MOD, fd, &ev);
+          if (ret < 0 && errno == ENOENT)
+            {
+              ret = epoll_ctl(sched->epfd, EPOLL_CTL_ADD, fd, &ev);
+            }
+        }
+
+      if (ret < 0)
+        {
+          coro->fd      = -1;
+          coro->revents = EPOLLERR;
+          return CORO_READY;
+        }
+
+      coro->fd     = fd;
+      coro->events = ev.events;
+    }
+
+  if (ms >= 0)
+    {
+      coro->wakeup = coro_now() + ms;
+      coro_add_sleeping(sched, coro);
+    }
+  else if (fd < 0)
+    {
+      /* Nothing to wait for: just yield */
+
+      return CORO_READY;
+    }
+
+  return CORO_WAITING;
+}
@@ -0,0 +1,58 @@
+/****************************************************************************
+ * libs/libc/dirent/lib_getdents.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <dirent.h>
+#include <unistd.h>
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: getdents
+ *
+ * Description:
+ *   Read as many entries of the directory open as fd as fit in buf, with
+ *   one call to the file system.  Unlike Linux, the entries are an array of
+ *   the fixed size struct dirent.
+ *
+ * Input Parameters:
+ *   fd     - The descriptor of the directory, see dirfd()
+ *   buf    - The buffer of the entries
+ *   nbytes - The size of the buffer, at least sizeof(struct dirent)
+ *
+ * Returned Value:
+ *   The number of bytes read, zero at the end of the directory.  Otherwise,
+ *   -1 is returned and errno is set appropriately.
+ *
+ ****************************************************************************/
+
+ssize_t getdents(int fd, FAR void *buf, size_t nbytes)
+{
+  return read(fd, buf, nbytes);
+}
@@ -0,0 +1,93 @@
+/****************************************************************************
+ * libs/libc/dirent/lib_readdirplus.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/ioctl.h>
+#include <dirent.h>
+#include <errno.h>
+
+#include <nuttx/fs/ioctl.h>
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: readdirplus
+ *
+ * Description:
+ *   The readdirplus() function reads the next directory entry of the
+ *   directory stream dirp, like readdir(), together with the attributes of
+ *   the file, like lstat() would return them.
+ *
+ *   The file systems that keep the attributes in the directory give them
+ *   without looking up the path of the entry again, which makes listing
+ *   large directories with their attributes much faster.  Otherwise the
+ *   attributes are looked up by the path.  They are left zero if they
+ *   can't be read, so that the entry isn't lost.
+ *
+ * Input Parameters:
+ *   dirp  - An instance of type DIR created by a previous call to
+ *           opendir()
+ *   entry - The storage of the entry and its attributes
+ *
+ * Returned Value:
+ *   One if an entry was read; zero at the end of the directory.
+ *   Otherwise, -1 is returned and errno is set appropriately.
+ *
+ *   EBADF   - Invalid directory stream descriptor dir
+ *
+ ****************************************************************************/
+
+int readdirplus(FAR DIR *dirp, FAR struct direntplus *entry)
+{
+  int errcode;
+  int ret;
+
+  if (!dirp || !entry)
+    {
+      set_errno(EBADF);
+      return -1;
+    }
+
+  errcode = get_errno();
+  ret = ioctl(dirp->fd, FIOC_READDIRPLUS, (unsigned long)(uintptr_t)entry);
+  if (ret < 0)
+    {
+      if (get_errno() != ENOENT)
+        {
+          return -1;
+        }
+
+      /* The end of the directory isn't an error */
+
+      set_errno(errcode);
+      return 0;
+    }
+
+  return 1;
+}
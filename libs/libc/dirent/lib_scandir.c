@@ -30,6 +30,7 @@
 #include <dirent.h>
 #include <errno.h>
 #include <stdlib.h>
+#include <unistd.h>
 
 #include "libc.h"
 
@@ -40,6 +41,14 @@
 
 #ifndef __KERNEL__
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The entries read from the directory at once */
+
+#define SCANDIR_BATCH 8
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -77,11 +86,15 @@ int scandir(FAR const char *path, FAR struct dirent ***namelist,
             CODE int (*compar)(FAR const struct dirent **,
                                FAR const struct dirent **))
 {
+  FAR struct dirent *batch;
   FAR struct dirent *d;
   FAR struct dirent *dnew;
   FAR struct dirent **list = NULL;
   size_t listsize = 0;
   size_t cnt = 0;
+  size_t count = 0;
+  size_t next = 0;
+  ssize_t nread;
   int errsv;
   int result;
   FAR DIR *dirp;
@@ -100,14 +113,42 @@ int scandir(FAR const char *path, FAR struct dirent ***namelist,
       return -1;
     }
 
+  /* Read several entries with one call if we can, the single entry of the
+   * DIR otherwise.
+   */
+
+  batch = lib_malloc(SCANDIR_BATCH * sizeof(struct dirent));
+
   /* opendir might have set errno.  Reset to zero. */
 
   set_errno(0);
 
-  for (d = readdir(dirp); d != NULL; d = readdir(dirp))
+  for (; ; )
     {
       size_t dsize;
 
+      if (batch == NULL)
+        {
+          d = readdir(dirp);
+        }
+      else
+        {
+          if (next == count)
+            {
+              nread = read(dirp->fd, batch,
+                           SCANDIR_BATCH * sizeof(struct dirent));
+              count = nread > 0 ? nread / sizeof(struct dirent) : 0;
+              next  = 0;
+            }
+
+          d = next < count ? &batch[next++] : NULL;
+        }
+
+      if (d == NULL)
+        {
+          break;
+        }
+
       /* If the caller provided a filter function which tells scandir to skip
        * the current directory entry, do so.
        */
@@ -215,6 +256,7 @@ int scandir(FAR const char *path, FAR struct dirent ***namelist,
       result = -1;
     }
 
+  lib_free(batch);
   closedir(dirp);
 
   if (result >= 0)
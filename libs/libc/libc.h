@@ -187,6 +187,13 @@ int lib_getfullpath(int dirfd, FAR const char *path,
 
 int lib_mode2oflags(FAR const char *mode);
 
+/* Defined in lib_libfilelock.c */
+
+#ifdef CONFIG_FILE_STREAM
+bool lib_flockfile(FAR FILE *stream);
+void lib_funlockfile(FAR FILE *stream, bool locked);
+#endif
+
 /* Defined in lib_libfwrite.c */
 
 ssize_t lib_fwrite(FAR const void *ptr, size_t count, FAR FILE *stream);
@@ -245,6 +252,12 @@ bool lib_isbasedigit(int ch, int base, FAR int *value);
 
 int lib_checkbase(int base, FAR const char **pptr);
 
+/* Defined in lib_decdigits.c */
+
+uint64_t lib_decdigits(FAR const char *str, size_t len);
+bool lib_getdecimal(FAR const char **pptr, uint64_t max,
+                    FAR uint64_t *value);
+
 /* Defined in lib_parsehostfile.c */
 
 #ifdef CONFIG_NETDB_HOSTFILE
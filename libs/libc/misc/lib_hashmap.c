@@ -0,0 +1,329 @@
+/****************************************************************************
+ * libs/libc/misc/lib_hashmap.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <string.h>
+
+#include <nuttx/hashmap.h>
+#include <nuttx/lib/lib.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define HASHMAP_MINSLOTS 8
+
+/* The distance of a slot from the one of its hash */
+
+#define hashmap_dist(map, i, hash) (((i) - (hash)) & (map)->mask)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hashmap_place
+ *
+ * Description:
+ *   Put an entry in a map which has a free slot.  The entry takes the slot
+ *   of any entry closer to its own slot than the new one is, which then
+ *   goes on: the probe sequences stay short and even.
+ *
+ ****************************************************************************/
+
+static void hashmap_place(FAR struct hashmap_s *map, uint32_t hash,
+                          FAR void *entry)
+{
+  FAR struct hashmap_slot_s *slot;
+  struct hashmap_slot_s temp;
+  uint32_t dist = 0;
+  uint32_t i = hash & map->mask;
+
+  for (; ; )
+    {
+      slot = &map->slots[i];
+      if (slot->entry == NULL)
+        {
+          slot->hash  = hash;
+          slot->entry = entry;
+          map->count++;
+          return;
+        }
+
+      if (hashmap_dist(map, i, slot->hash) < dist)
+        {
+          temp  = *slot;
+          slot->hash  = hash;
+          slot->entry = entry;
+          hash  = temp.hash;
+          entry = temp.entry;
+          dist  = hashmap_dist(map, i, hash);
+        }
+
+      i = (i + 1) & map->mask;
+      dist++;
+    }
+}
+
+/****************************************************************************
+ * Name: hashmap_resize
+ ****************************************************************************/
+
+static int hashmap_resize(FAR struct hashmap_s *map, uint32_t nslots)
+{
+  FAR struct hashmap_slot_s *slots = map->slots;
+  uint32_t count;
+  uint32_t i;
+
+  map->slots = lib_zalloc(nslots * sizeof(struct hashmap_slot_s));
+  if (map->slots == NULL)
+    {
+      map->slots = slots;
+      return -ENOMEM;
+    }
+
+  if (slots != NULL)
+    {
+      count     = map->mask + 1;
+      map->mask = nslots - 1;
+      map->count = 0;
+
+      for (i = 0; i < count; i++)
+        {
+          if (slots[i].entry != NULL)
+            {
+              hashmap_place(map, slots[i].hash, slots[i].entry);
+            }
+        }
+
+      lib_free(slots);
+    }
+  else
+    {
+      map->mask = nslots - 1;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: hashmap_lookup
+ *
+ * Description:
+ *   Return the slot of the entry with the key, or the entry itself if key
+ *   is NULL.  The search stops at the first entry which is closer to its
+ *   own slot than the key would be.
+ *
+ ****************************************************************************/
+
+static FAR struct hashmap_slot_s *
+hashmap_lookup(FAR struct hashmap_s *map, uint32_t hash,
+               FAR const void *key, FAR const void *entry)
+{
+  FAR struct hashmap_slot_s *slot;
+  uint32_t dist = 0;
+  uint32_t i = hash & map->mask;
+
+  if (map->slots == NULL)
+    {
+      return NULL;
+    }
+
+  for (; ; )
+    {
+      slot = &map->slots[i];
+      if (slot->entry == NULL || hashmap_dist(map, i, slot->hash) < dist)
+        {
+          return NULL;
+        }
+
+      if (slot->hash == hash &&
+          (key != NULL ? map->match(slot->entry, key) :
+                         slot->entry == entry))
+        {
+          return slot;
+        }
+
+      i = (i + 1) & map->mask;
+      dist++;
+    }
+}
+
+/****************************************************************************
+ * Name: hashmap_erase
+ *
+ * Description:
+ *   Free a slot, and move back the entries which follow it, up to the
+ *   first one which is in its own slot.  No tombstone is left.
+ *
+ ****************************************************************************/
+
+static void hashmap_erase(FAR struct hashmap_s *map,
+                          FAR struct hashmap_slot_s *slot)
+{
+  FAR struct hashmap_slot_s *next;
+  uint32_t i = slot - map->slots;
+
+  for (; ; )
+    {
+      i    = (i + 1) & map->mask;
+      next = &map->slots[i];
+      if (next->entry == NULL || hashmap_dist(map, i, next->hash) == 0)
+        {
+          break;
+        }
+
+      *slot = *next;
+      slot  = next;
+    }
+
+  slot->entry = NULL;
+  map->count--;
+
+  /* Shrink when 1/4 full, which fails harmlessly */
+
+  if (map->mask + 1 > map->minslots && map->count < (map->mask + 1) / 4)
+    {
+      hashmap_resize(map, (map->mask + 1) / 2);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hashmap_init
+ ****************************************************************************/
+
+int hashmap_init(FAR struct hashmap_s *map, hashmap_match_t match,
+                 uint32_t nslots)
+{
+  uint32_t size = HASHMAP_MINSLOTS;
+
+  while (size < nslots && size < UINT32_MAX / 2 + 1)
+    {
+      size <<= 1;
+    }
+
+  memset(map, 0, sizeof(*map));
+  map->match    = match;
+  map->minslots = size;
+  return hashmap_resize(map, size);
+}
+
+/****************************************************************************
+ * Name: hashmap_destroy
+ ****************************************************************************/
+
+void hashmap_destroy(FAR struct hashmap_s *map)
+{
+  lib_free(map->slots);
+  map->slots = NULL;
+  map->mask  = 0;
+  map->count = 0;
+}
+
+/****************************************************************************
+ * Name: hashmap_find
+ ****************************************************************************/
+
+FAR void *hashmap_find(FAR struct hashmap_s *map, uint32_t hash,
+                       FAR const void *key)
+{
+  FAR struct hashmap_slot_s *slot;
+
+  slot = hashmap_lookup(map, hash, key, NULL);
+  return slot != NULL ? slot->entry : NULL;
+}
+
+/****************************************************************************
+ * Name: hashmap_insert
+ ****************************************************************************/
+
+int hashmap_insert(FAR struct hashmap_s *map, uint32_t hash,
+                   FAR void *entry)
+{
+  uint32_t nslots = map->mask + 1;
+
+  if (map->slots == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  /* Grow when 7/8 full, and keep one free slot at least whatever */
+
+  if (map->count + 1 > nslots - nslots / 8 &&
+      hashmap_resize(map, nslots * 2) < 0 && map->count + 1 >= nslots)
+    {
+      return -ENOMEM;
+    }
+
+  hashmap_place(map, hash, entry);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: hashmap_remove
+ ****************************************************************************/
+
+FAR void *hashmap_remove(FAR struct hashmap_s *map, uint32_t hash,
+                         FAR const void *key)
+{
+  FAR struct hashmap_slot_s *slot;
+  FAR void *entry;
+
+  slot = hashmap_lookup(map, hash, key, NULL);
+  if (slot == NULL)
+    {
+      return NULL;
+    }
+
+  entry = slot->entry;
+  hashmap_erase(map, slot);
+  return entry;
+}
+
+/****************************************************************************
+ * Name: hashmap_delete
+ ****************************************************************************/
+
+int hashmap_delete(FAR struct hashmap_s *map, uint32_t hash,
+                   FAR void *entry)
+{
+  FAR struct hashmap_slot_s *slot;
+
+  slot = hashmap_lookup(map, hash, NULL, entry);
+  if (slot == NULL)
+    {
+      return -ENOENT;
+    }
+
+  hashmap_erase(map, slot);
+  return OK;
+}
@@ -28,8 +28,10 @@
 
 #include <nuttx/sched.h>
 #include <nuttx/clock.h>
+#include <nuttx/lockstat.h>
 #include <nuttx/mutex.h>
 #include <nuttx/semaphore.h>
+#include <nuttx/tls.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -37,6 +39,17 @@
 
 #define NXMUTEX_RESET          ((pid_t)-2)
 
+/* When the mutex is taken in user space, also get the thread ID there if
+ * the TLS can be found without a system call.
+ */
+
+#if defined(CONFIG_SEM_USER_FASTPATH) && !defined(__KERNEL__) && \
+    (defined(up_tls_info) || defined(CONFIG_TLS_ALIGNED))
+#  define NXMUTEX_GETTID()     (tls_get_info()->tl_tid)
+#else
+#  define NXMUTEX_GETTID()     _SCHED_GETTID()
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -88,6 +101,114 @@ static void nxmutex_add_backtrace(FAR mutex_t *mutex)
 #  define nxmutex_add_backtrace(mutex)
 #endif
 
+/****************************************************************************
+ * Name: nxmutex_spin
+ *
+ * Description:
+ *   Spin on a contended mutex as long as its holder is running on another
+ *   CPU, as it is then likely to release the mutex sooner than it takes
+ *   to block and be woken up again.  Give up after CONFIG_LIBC_MUTEX_SPIN
+ *   rounds or as soon as the holder is not running.  The mutex is taken
+ *   with nxsem_trywait(), so priority inheritance is unaffected.
+ *
+ * Returned Value:
+ *   True if the mutex was taken.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_SMP) && CONFIG_LIBC_MUTEX_SPIN > 0 && \
+    (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+static bool nxmutex_spin(FAR mutex_t *mutex)
+{
+  FAR struct tcb_s *tcb = NULL;
+  pid_t holder = NXMUTEX_NO_HOLDER;
+  pid_t curr;
+  int count;
+
+  for (count = 0; count < CONFIG_LIBC_MUTEX_SPIN; count++)
+    {
+      if (atomic_load(NXSEM_COUNT(&mutex->sem)) > 0 &&
+          nxsem_trywait(&mutex->sem) >= 0)
+        {
+          return true;
+        }
+
+      /* Look the holder up again whenever the mutex changed hands */
+
+      curr = *(FAR volatile pid_t *)&mutex->holder;
+      if (curr != holder)
+        {
+          holder = curr;
+          tcb    = holder > 0 ? nxsched_get_tcb(holder) : NULL;
+        }
+
+      /* No holder yet means the mutex was just taken, keep spinning */
+
+      if (holder != NXMUTEX_NO_HOLDER &&
+          (tcb == NULL || tcb->task_state != TSTATE_TASK_RUNNING))
+        {
+          break;
+        }
+    }
+
+  return false;
+}
+#else
+#  define nxmutex_spin(mutex) false
+#endif
+
+/****************************************************************************
+ * Name: nxmutex_lockstat_begin
+ *
+ * Description:
+ *   Return the time the lock is asked for if the mutex is held, 0 if it
+ *   is not contended.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_SCHED_LOCKSTAT) && \
+    (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+static clock_t nxmutex_lockstat_begin(FAR mutex_t *mutex)
+{
+  return mutex->holder != NXMUTEX_NO_HOLDER ? perf_gettime() : 0;
+}
+
+/****************************************************************************
+ * Name: nxmutex_lockstat_acquire
+ *
+ * Description:
+ *   Count the acquisition of the mutex, in the class of the place it was
+ *   initialized from, or of the mutex itself if it was initialized
+ *   statically.
+ *
+ ****************************************************************************/
+
+static void nxmutex_lockstat_acquire(FAR mutex_t *mutex, clock_t start)
+{
+  FAR void *site = mutex->sem.initsite;
+
+  mutex->acquired = perf_gettime();
+  lockstat_acquire(LOCKSTAT_MUTEX, site != NULL ? site : mutex,
+                   start != 0, mutex->acquired - start);
+}
+
+/****************************************************************************
+ * Name: nxmutex_lockstat_release
+ ****************************************************************************/
+
+static void nxmutex_lockstat_release(FAR mutex_t *mutex)
+{
+  FAR void *site = mutex->sem.initsite;
+
+  lockstat_release(LOCKSTAT_MUTEX, site != NULL ? site : mutex,
+                   perf_gettime() - mutex->acquired);
+}
+#else
+#  define nxmutex_lockstat_begin(mutex)          0
+#  define nxmutex_lockstat_acquire(mutex, start) ((void)(start))
+#  define nxmutex_lockstat_release(mutex)
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -125,6 +246,9 @@ int nxmutex_init(FAR mutex_t *mutex)
   nxsem_set_protocol(&mutex->sem, SEM_TYPE_MUTEX | SEM_PRIO_INHERIT);
 #else
   nxsem_set_protocol(&mutex->sem, SEM_TYPE_MUTEX);
+#endif
+#ifdef CONFIG_SCHED_LOCKSTAT
+  mutex->sem.initsite = return_address(0);
 #endif
   return ret;
 }
@@ -177,7 +301,7 @@ int nxmutex_destroy(FAR mutex_t *mutex)
 
 bool nxmutex_is_hold(FAR mutex_t *mutex)
 {
-  return mutex->holder == _SCHED_GETTID();
+  return mutex->holder == NXMUTEX_GETTID();
 }
 
 /****************************************************************************
@@ -243,6 +367,7 @@ bool nxmutex_is_locked(FAR mutex_t *mutex)
 
 int nxmutex_lock(FAR mutex_t *mutex)
 {
+  clock_t start = nxmutex_lockstat_begin(mutex);
   int ret;
 
   DEBUGASSERT(!nxmutex_is_hold(mutex));
@@ -250,11 +375,13 @@ int nxmutex_lock(FAR mutex_t *mutex)
     {
       /* Take the semaphore (perhaps waiting) */
 
-      ret = nxsem_wait(&mutex->sem);
+      ret = nxsem_user_trywait(&mutex->sem) || nxmutex_spin(mutex) ? OK :
+            nxsem_wait(&mutex->sem);
       if (ret >= 0)
         {
-          mutex->holder = _SCHED_GETTID();
+          mutex->holder = NXMUTEX_GETTID();
           nxmutex_add_backtrace(mutex);
+          nxmutex_lockstat_acquire(mutex, start);
           break;
         }
       else if (ret != -EINTR && ret != -ECANCELED)
@@ -291,14 +418,16 @@ int nxmutex_trylock(FAR mutex_t *mutex)
 {
   int ret;
 
-  ret = nxsem_trywait(&mutex->sem);
+  ret = nxsem_user_trywait(&mutex->sem) ? OK :
+        nxsem_trywait(&mutex->sem);
   if (ret < 0)
     {
       return ret;
     }
 
-  mutex->holder = _SCHED_GETTID();
+  mutex->holder = NXMUTEX_GETTID();
   nxmutex_add_backtrace(mutex);
+  nxmutex_lockstat_acquire(mutex, 0);
 
   return ret;
 }
@@ -331,13 +460,18 @@ int nxmutex_trylock(FAR mutex_t *mutex)
 int nxmutex_clocklock(FAR mutex_t *mutex, clockid_t clockid,
                       FAR const struct timespec *abstime)
 {
+  clock_t start = nxmutex_lockstat_begin(mutex);
   int ret;
 
   /* Wait until we get the lock or until the timeout expires */
 
   do
     {
-      if (abstime)
+      if (nxsem_user_trywait(&mutex->sem) || nxmutex_spin(mutex))
+        {
+          ret = OK;
+        }
+      else if (abstime)
         {
           ret = nxsem_clockwait(&mutex->sem, clockid, abstime);
         }
@@ -350,8 +484,9 @@ int nxmutex_clocklock(FAR mutex_t *mutex, clockid_t clockid,
 
   if (ret >= 0)
     {
-      mutex->holder = _SCHED_GETTID();
+      mutex->holder = NXMUTEX_GETTID();
       nxmutex_add_backtrace(mutex);
+      nxmutex_lockstat_acquire(mutex, start);
     }
 
   return ret;
@@ -427,12 +562,13 @@ int nxmutex_unlock(FAR mutex_t *mutex)
 
   DEBUGASSERT(nxmutex_is_hold(mutex));
 
+  nxmutex_lockstat_release(mutex);
   mutex->holder = NXMUTEX_NO_HOLDER;
 
-  ret = nxsem_post(&mutex->sem);
+  ret = nxsem_user_post(&mutex->sem) ? OK : nxsem_post(&mutex->sem);
   if (ret < 0)
     {
-      mutex->holder = _SCHED_GETTID();
+      mutex->holder = NXMUTEX_GETTID();
     }
 
   return ret;
@@ -609,8 +745,14 @@ int nxmutex_setprioceiling(FAR mutex_t *mutex, int prioceiling,
 
 int nxrmutex_init(FAR rmutex_t *rmutex)
 {
+  int ret;
+
   rmutex->count = 0;
-  return nxmutex_init(&rmutex->mutex);
+  ret = nxmutex_init(&rmutex->mutex);
+#ifdef CONFIG_SCHED_LOCKSTAT
+  rmutex->mutex.sem.initsite = return_address(0);
+#endif
+  return ret;
 }
 
 /****************************************************************************
@@ -165,6 +165,75 @@ void *modlib_findglobal(FAR struct module_s *modp,
                         FAR Elf_Shdr *shdr,
                         FAR Elf_Sym *sym);
 
+/****************************************************************************
+ * Name: modlib_findexport
+ *
+ * Description:
+ *   Find a symbol exported by an installed module.  The caller holds the
+ *   registry lock.
+ *
+ * Input Parameters:
+ *   modp - The module
+ *   name - The name of the symbol
+ *
+ * Returned Value:
+ *   The symbol table entry; NULL if the module doesn't export the symbol.
+ *
+ ****************************************************************************/
+
+FAR const struct symtab_s *modlib_findexport(FAR struct module_s *modp,
+                                             FAR const char *name);
+
+/****************************************************************************
+ * Name: modlib_symtab_findbyname
+ *
+ * Description:
+ *   Find a symbol in the symbol table of the base code.  The table is
+ *   searched through a hash index kept for the last table seen when
+ *   CONFIG_SYMTAB_HASH is selected.
+ *
+ * Input Parameters:
+ *   symtab - The symbol table
+ *   name   - The name of the symbol
+ *   nsyms  - The number of symbols in the table
+ *
+ * Returned Value:
+ *   The symbol table entry; NULL if the symbol is not found.
+ *
+ ****************************************************************************/
+
+FAR const struct symtab_s *
+modlib_symtab_findbyname(FAR const struct symtab_s *symtab,
+                         FAR const char *name, int nsyms);
+
+/****************************************************************************
+ * Name: modlib_textcache_get
+ *
+ * Description:
+ *   Share the read-only sections of a position independent binary with the
+ *   other instances of the same file.  On success loadinfo->xipbase points
+ *   to the image of the sections.
+ *
+ * Returned Value:
+ *   0 (OK) is returned on success and a negated errno is returned on
+ *   failure, in which case the binary is loaded as usual.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MODLIB_TEXTCACHE
+int modlib_textcache_get(FAR struct mod_loadinfo_s *loadinfo);
+
+/****************************************************************************
+ * Name: modlib_textcache_put
+ *
+ * Description:
+ *   Release the image got by modlib_textcache_get().
+ *
+ ****************************************************************************/
+
+void modlib_textcache_put(uintptr_t xipbase);
+#endif
+
 /****************************************************************************
  * Name: modlib_loadhdrs
  *
@@ -76,6 +76,9 @@ static inline int modlib_fileinfo(FAR struct mod_loadinfo_s *loadinfo)
   loadinfo->fileuid  = buf.st_uid;
   loadinfo->filegid  = buf.st_gid;
   loadinfo->filemode = buf.st_mode;
+#ifdef CONFIG_MODLIB_TEXTCACHE
+  loadinfo->filemtime = buf.st_mtim;
+#endif
   return OK;
 }
 
@@ -106,6 +109,9 @@ int modlib_initialize(FAR const char *filename,
   /* Clear the load info structure */
 
   memset(loadinfo, 0, sizeof(struct mod_loadinfo_s));
+#ifdef CONFIG_MODLIB_TEXTCACHE
+  loadinfo->filename = filename;
+#endif
 
   /* Open the binary file for reading (only) */
 
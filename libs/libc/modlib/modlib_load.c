@@ -274,6 +274,48 @@ static int modlib_vma2lma(FAR struct mod_loadinfo_s *loadinfo,
 }
 #endif
 
+#ifdef CONFIG_MODLIB_PRELINK
+/****************************************************************************
+ * Name: modlib_verifyprelink
+ *
+ * Description:
+ *   Check that all the allocated sections of a prelinked executable lie in
+ *   the memory reserved for the prelinked binaries.
+ *
+ * Returned Value:
+ *   0 (OK) is returned on success and a negated errno is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+static int modlib_verifyprelink(FAR struct mod_loadinfo_s *loadinfo)
+{
+  uintptr_t base = CONFIG_MODLIB_PRELINK_BASE;
+  uintptr_t end = base + CONFIG_MODLIB_PRELINK_SIZE;
+  int i;
+
+  for (i = 0; i < loadinfo->ehdr.e_shnum; i++)
+    {
+      FAR Elf_Shdr *shdr = &loadinfo->shdr[i];
+
+      if ((shdr->sh_flags & SHF_ALLOC) == 0 || shdr->sh_size == 0)
+        {
+          continue;
+        }
+
+      if (shdr->sh_addr < base || shdr->sh_addr > end ||
+          shdr->sh_size > end - shdr->sh_addr)
+        {
+          berr("ERROR: Section %d at %08lx is out of the prelink region\n",
+               i, (unsigned long)shdr->sh_addr);
+          return -ENOEXEC;
+        }
+    }
+
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: modlib_set_emptysect_vma
  *
@@ -388,6 +430,16 @@ static inline int modlib_loadfile(FAR struct mod_loadinfo_s *loadinfo)
             }
 #endif
 
+#ifdef CONFIG_MODLIB_PRELINK
+          /* A prelinked executable is loaded where it was linked to */
+
+          if (loadinfo->ehdr.e_type == ET_EXEC)
+            {
+              text = (FAR uint8_t *)(uintptr_t)shdr->sh_addr;
+              pptr = &text;
+            }
+#endif
+
           if (pptr == NULL)
             {
               /* SHF_WRITE indicates that the section address space is
@@ -558,7 +610,24 @@ int modlib_load(FAR struct mod_loadinfo_s *loadinfo)
         {
           binfo("can use xipbase %zu\n", loadinfo->xipbase);
         }
+#ifdef CONFIG_MODLIB_TEXTCACHE
+      else if (modlib_textcache_get(loadinfo) >= 0)
+        {
+          binfo("share the text at %zu\n", loadinfo->xipbase);
+        }
+#endif
+    }
+
+#ifdef CONFIG_MODLIB_PRELINK
+  if (loadinfo->ehdr.e_type == ET_EXEC)
+    {
+      ret = modlib_verifyprelink(loadinfo);
+      if (ret < 0)
+        {
+          goto errout_with_buffers;
+        }
     }
+#endif
 
   /* Determine total size to allocate */
 
@@ -575,7 +644,11 @@ int modlib_load(FAR struct mod_loadinfo_s *loadinfo)
 
 #ifndef CONFIG_MODLIB_LOADTO_LMA
 
+#  ifdef CONFIG_MODLIB_PRELINK
+  if (loadinfo->ehdr.e_type == ET_REL)
+#  else
   if (loadinfo->ehdr.e_type == ET_REL || loadinfo->ehdr.e_type == ET_EXEC)
+#  endif
     {
 #  ifndef CONFIG_ARCH_USE_SEPARATED_SECTION
       if (loadinfo->xipbase != 0)
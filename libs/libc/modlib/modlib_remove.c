@@ -31,6 +31,8 @@
 #include <nuttx/lib/lib.h>
 #include <nuttx/lib/modlib.h>
 
+#include "modlib/modlib.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -140,6 +142,12 @@ int modlib_uninit(FAR struct module_s *modp)
               lib_free((FAR void *)modp->textalloc);
 #  endif
             }
+#  ifdef CONFIG_MODLIB_TEXTCACHE
+          else
+            {
+              modlib_textcache_put(modp->xipbase);
+            }
+#  endif
 
 #  if defined(CONFIG_ARCH_USE_DATA_HEAP)
           up_dataheap_free((FAR void *)modp->dataalloc);
@@ -161,6 +169,10 @@ int modlib_uninit(FAR struct module_s *modp)
 #endif
     }
 
+#ifdef CONFIG_SYMTAB_HASH
+  symtab_hash_uninit(&modp->exphash);
+#endif
+
 #if CONFIG_MODLIB_MAXDEPEND > 0
   /* Eliminate any dependencies that this module has on other modules */
 
@@ -203,9 +203,7 @@ static int modlib_symcallback(FAR struct module_s *modp, FAR void *arg)
 
   /* Check if this module exports a symbol of that name */
 
-  exportinfo->symbol = symtab_findbyname(modp->modinfo.exports,
-                                         exportinfo->name,
-                                         modp->modinfo.nexports);
+  exportinfo->symbol = modlib_findexport(modp, exportinfo->name);
 
   if (exportinfo->symbol != NULL)
     {
@@ -408,8 +406,8 @@ int modlib_symvalue(FAR struct module_s *modp,
 
         if (symbol == NULL)
           {
-            symbol = symtab_findbyname(exports, exportinfo.name,
-                                       nexports);
+            symbol = modlib_symtab_findbyname(exports, exportinfo.name,
+                                              nexports);
           }
 
         /* Was the symbol found from any exporter? */
@@ -614,6 +612,45 @@ void *modlib_findglobal(FAR struct module_s *modp,
     }
 }
 
+/****************************************************************************
+ * Name: modlib_findexport
+ *
+ * Description:
+ *   Find a symbol exported by an installed module.  The caller holds the
+ *   registry lock.
+ *
+ * Input Parameters:
+ *   modp - The module
+ *   name - The name of the symbol
+ *
+ * Returned Value:
+ *   The symbol table entry; NULL if the module doesn't export the symbol.
+ *
+ ****************************************************************************/
+
+FAR const struct symtab_s *modlib_findexport(FAR struct module_s *modp,
+                                             FAR const char *name)
+{
+#ifdef CONFIG_SYMTAB_HASH
+  /* The exports are set by modlib_insertsymtab() or by the initializer of
+   * the module, so the index is built on the first search.
+   */
+
+  if (modp->exphash.symtab != modp->modinfo.exports ||
+      modp->exphash.nsyms != modp->modinfo.nexports)
+    {
+      symtab_hash_uninit(&modp->exphash);
+      symtab_hash_init(&modp->exphash, modp->modinfo.exports,
+                       modp->modinfo.nexports);
+    }
+
+  return symtab_hash_find(&modp->exphash, name);
+#else
+  return symtab_findbyname(modp->modinfo.exports, name,
+                           modp->modinfo.nexports);
+#endif
+}
+
 /****************************************************************************
  * Name: modlib_freesymtab
  *
@@ -630,6 +667,10 @@ void modlib_freesymtab(FAR struct module_s *modp)
   FAR const struct symtab_s *symbol;
   int i;
 
+#ifdef CONFIG_SYMTAB_HASH
+  symtab_hash_uninit(&modp->exphash);
+#endif
+
   if ((symbol = modp->modinfo.exports) != NULL)
     {
       for (i = 0; i < modp->modinfo.nexports; i++)
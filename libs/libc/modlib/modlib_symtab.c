@@ -30,7 +30,8 @@
 
 #include <nuttx/symtab.h>
 #include <nuttx/lib/modlib.h>
-#include <nuttx/symtab.h>
+
+#include "modlib/modlib.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -66,6 +67,10 @@ extern int CONFIG_MODLIB_NSYMBOLS_VAR;
 static FAR const struct symtab_s *g_modlib_symtab;
 static int g_modlib_nsymbols;
 
+#ifdef CONFIG_SYMTAB_HASH
+static struct symtab_hash_s g_modlib_symhash;
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -128,5 +133,52 @@ void modlib_setsymtab(FAR const struct symtab_s *symtab, int nsymbols)
   modlib_registry_lock();
   g_modlib_symtab   = symtab;
   g_modlib_nsymbols = nsymbols;
+#ifdef CONFIG_SYMTAB_HASH
+  symtab_hash_uninit(&g_modlib_symhash);
+#endif
+  modlib_registry_unlock();
+}
+
+/****************************************************************************
+ * Name: modlib_symtab_findbyname
+ *
+ * Description:
+ *   Find a symbol in the symbol table of the base code.  The table is
+ *   searched through a hash index kept for the last table seen when
+ *   CONFIG_SYMTAB_HASH is selected.
+ *
+ * Input Parameters:
+ *   symtab - The symbol table
+ *   name   - The name of the symbol
+ *   nsyms  - The number of symbols in the table
+ *
+ * Returned Value:
+ *   The symbol table entry; NULL if the symbol is not found.
+ *
+ ****************************************************************************/
+
+FAR const struct symtab_s *
+modlib_symtab_findbyname(FAR const struct symtab_s *symtab,
+                         FAR const char *name, int nsyms)
+{
+#ifdef CONFIG_SYMTAB_HASH
+  FAR const struct symtab_s *symbol;
+
+  /* The table is the one of modlib_setsymtab() or the one of the binary
+   * loader, which rarely change.
+   */
+
+  modlib_registry_lock();
+  if (g_modlib_symhash.symtab != symtab || g_modlib_symhash.nsyms != nsyms)
+    {
+      symtab_hash_uninit(&g_modlib_symhash);
+      symtab_hash_init(&g_modlib_symhash, symtab, nsyms);
+    }
+
+  symbol = symtab_hash_find(&g_modlib_symhash, name);
   modlib_registry_unlock();
+  return symbol;
+#else
+  return symtab_findbyname(symtab, name, nsyms);
+#endif
 }
@@ -0,0 +1,282 @@
+/****************************************************************************
+ * libs/libc/modlib/modlib_textcache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <stdint.h>
+#include <string.h>
+#include <debug.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/cache.h>
+#include <nuttx/lib/lib.h>
+#include <nuttx/lib/modlib.h>
+
+#include "modlib/modlib.h"
+
+#ifdef CONFIG_MODLIB_TEXTCACHE
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The read-only sections of a position independent binary, at their
+ * offsets in the file, which the loader then uses like the image of a
+ * file in XIP memory.
+ */
+
+struct modlib_textcache_s
+{
+  FAR struct modlib_textcache_s *flink;
+  FAR char *filename;          /* The file the image was read from */
+  off_t filelen;               /* Its length and its time of modification */
+  struct timespec filemtime;
+  FAR uint8_t *image;
+  unsigned int crefs;          /* Number of binaries using the image */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Protected by the module registry lock */
+
+static FAR struct modlib_textcache_s *g_modlib_textcache;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: modlib_textcache_free
+ ****************************************************************************/
+
+static void modlib_textcache_free(FAR struct modlib_textcache_s *cache)
+{
+  if (cache->image != NULL)
+    {
+#ifdef CONFIG_ARCH_USE_TEXT_HEAP
+      up_textheap_free(cache->image);
+#else
+      lib_free(cache->image);
+#endif
+    }
+
+  lib_free(cache->filename);
+  lib_free(cache);
+}
+
+/****************************************************************************
+ * Name: modlib_textcache_shareable
+ *
+ * Description:
+ *   Check that nothing writes the read-only sections: they have no
+ *   relocations, the binary reaching its data through the GOT.  Return the
+ *   size and the alignment of the image.
+ *
+ ****************************************************************************/
+
+static bool modlib_textcache_shareable(FAR struct mod_loadinfo_s *loadinfo,
+                                       FAR size_t *size, FAR size_t *align)
+{
+  FAR Elf_Shdr *shdr;
+  FAR Elf_Shdr *dst;
+  int i;
+
+  *size  = 0;
+  *align = sizeof(uintptr_t);
+
+  for (i = 0; i < loadinfo->ehdr.e_shnum; i++)
+    {
+      shdr = &loadinfo->shdr[i];
+      if (shdr->sh_type == SHT_REL || shdr->sh_type == SHT_RELA)
+        {
+          if (shdr->sh_info >= loadinfo->ehdr.e_shnum)
+            {
+              return false;
+            }
+
+          dst = &loadinfo->shdr[shdr->sh_info];
+          if ((dst->sh_flags & SHF_ALLOC) != 0 &&
+              (dst->sh_flags & SHF_WRITE) == 0)
+            {
+              return false;
+            }
+        }
+      else if ((shdr->sh_flags & SHF_ALLOC) != 0 &&
+               (shdr->sh_flags & SHF_WRITE) == 0 &&
+               shdr->sh_type != SHT_NOBITS)
+        {
+          *size  = MAX(*size, shdr->sh_offset + shdr->sh_size);
+          *align = MAX(*align, shdr->sh_addralign);
+        }
+    }
+
+  return *size > 0 && *size <= loadinfo->filelen;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: modlib_textcache_get
+ *
+ * Description:
+ *   Share the read-only sections of a position independent binary with the
+ *   other instances of the same file.  On success loadinfo->xipbase points
+ *   to the image of the sections, read on the first load.
+ *
+ * Returned Value:
+ *   0 (OK) is returned on success and a negated errno is returned on
+ *   failure, in which case the binary is loaded as usual.
+ *
+ ****************************************************************************/
+
+int modlib_textcache_get(FAR struct mod_loadinfo_s *loadinfo)
+{
+  FAR struct modlib_textcache_s *cache;
+  FAR Elf_Shdr *shdr;
+  size_t align;
+  size_t size;
+  int ret;
+  int i;
+
+  if (loadinfo->filename == NULL || loadinfo->ehdr.e_type == ET_DYN ||
+      !modlib_textcache_shareable(loadinfo, &size, &align))
+    {
+      return -ENOTSUP;
+    }
+
+  modlib_registry_lock();
+
+  for (cache = g_modlib_textcache; cache != NULL; cache = cache->flink)
+    {
+      if (cache->filelen == loadinfo->filelen &&
+          cache->filemtime.tv_sec == loadinfo->filemtime.tv_sec &&
+          cache->filemtime.tv_nsec == loadinfo->filemtime.tv_nsec &&
+          strcmp(cache->filename, loadinfo->filename) == 0)
+        {
+          cache->crefs++;
+          loadinfo->xipbase = (uintptr_t)cache->image;
+          modlib_registry_unlock();
+          return OK;
+        }
+    }
+
+  cache = lib_zalloc(sizeof(*cache));
+  if (cache == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_lock;
+    }
+
+  cache->filename = strdup(loadinfo->filename);
+#ifdef CONFIG_ARCH_USE_TEXT_HEAP
+  cache->image    = up_textheap_memalign(align, size);
+#else
+  cache->image    = lib_memalign(align, size);
+#endif
+  if (cache->filename == NULL || cache->image == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_cache;
+    }
+
+  for (i = 0; i < loadinfo->ehdr.e_shnum; i++)
+    {
+      shdr = &loadinfo->shdr[i];
+      if ((shdr->sh_flags & SHF_ALLOC) != 0 &&
+          (shdr->sh_flags & SHF_WRITE) == 0 &&
+          shdr->sh_type != SHT_NOBITS && shdr->sh_size > 0)
+        {
+          ret = modlib_read(loadinfo, cache->image + shdr->sh_offset,
+                            shdr->sh_size, shdr->sh_offset);
+          if (ret < 0)
+            {
+              berr("ERROR: Failed to read section %d: %d\n", i, ret);
+              goto errout_with_cache;
+            }
+        }
+    }
+
+  up_coherent_dcache((uintptr_t)cache->image, size);
+
+  cache->filelen   = loadinfo->filelen;
+  cache->filemtime = loadinfo->filemtime;
+  cache->crefs     = 1;
+  cache->flink     = g_modlib_textcache;
+  g_modlib_textcache = cache;
+
+  loadinfo->xipbase = (uintptr_t)cache->image;
+  modlib_registry_unlock();
+  return OK;
+
+errout_with_cache:
+  modlib_textcache_free(cache);
+errout_with_lock:
+  modlib_registry_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: modlib_textcache_put
+ *
+ * Description:
+ *   Release the image got by modlib_textcache_get(), it is freed with its
+ *   last user.  Nothing is done if xipbase is not the one of an image, but
+ *   of a file in XIP memory.
+ *
+ ****************************************************************************/
+
+void modlib_textcache_put(uintptr_t xipbase)
+{
+  FAR struct modlib_textcache_s **pcache;
+  FAR struct modlib_textcache_s *cache;
+
+  modlib_registry_lock();
+
+  for (pcache = &g_modlib_textcache; (cache = *pcache) != NULL;
+       pcache = &cache->flink)
+    {
+      if ((uintptr_t)cache->image == xipbase)
+        {
+          if (--cache->crefs == 0)
+            {
+              *pcache = cache->flink;
+              modlib_textcache_free(cache);
+            }
+
+          break;
+        }
+    }
+
+  modlib_registry_unlock();
+}
+
+#endif /* CONFIG_MODLIB_TEXTCACHE */
@@ -107,6 +107,12 @@ int modlib_unload(FAR struct mod_loadinfo_s *loadinfo)
           lib_free((FAR void *)loadinfo->textalloc);
 #  endif
         }
+#  ifdef CONFIG_MODLIB_TEXTCACHE
+      else if (loadinfo->xipbase != 0)
+        {
+          modlib_textcache_put(loadinfo->xipbase);
+        }
+#  endif
 
       if (loadinfo->datastart != 0)
         {
@@ -127,6 +133,7 @@ int modlib_unload(FAR struct mod_loadinfo_s *loadinfo)
 
   loadinfo->textalloc = 0;
   loadinfo->datastart = 0;
+  loadinfo->xipbase   = 0;
   loadinfo->textsize  = 0;
   loadinfo->datasize  = 0;
 
@@ -3923,6 +3923,12 @@ int regcomp(regex_t *restrict preg, const char *restrict regex, int cflags)
   tnfa->num_states      = parse_ctx.position;
   tnfa->cflags          = cflags;
 
+#ifdef CONFIG_LIBC_REGEX_DFA
+  /* Without the DFA, the TNFA is matched */
+
+  tnfa->dfa = tre_dfa_new(tnfa);
+#endif
+
   tre_mem_destroy(mem);
   tre_stack_destroy(stack);
   xfree(counts);
@@ -4030,5 +4036,12 @@ void regfree(regex_t *preg)
       xfree(tnfa->minimal_tags);
     }
 
+#ifdef CONFIG_LIBC_REGEX_DFA
+  if (tnfa->dfa)
+    {
+      tre_dfa_free(tnfa->dfa);
+    }
+#endif
+
   xfree(tnfa);
 }
@@ -1225,6 +1225,21 @@ int regexec(const regex_t *restrict preg, const char *restrict string,
       nmatch = 0;
     }
 
+#ifdef CONFIG_LIBC_REGEX_DFA
+  /* Most strings don't match, the DFA tells it fast.  The TNFA is only
+   * run for the submatches of a matching string.
+   */
+
+  if (tnfa->dfa != NULL)
+    {
+      status = tre_dfa_run(tnfa, string, eflags);
+      if (status == REG_NOMATCH || (status == REG_OK && nmatch == 0))
+        {
+          return status;
+        }
+    }
+#endif
+
   if (tnfa->num_tags > 0 && nmatch > 0)
     {
       tags = xmalloc(sizeof(*tags) * tnfa->num_tags);
@@ -0,0 +1,618 @@
+/****************************************************************************
+ * libs/libc/regex/tre-dfa.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* This matcher only tells if a string matches.  It walks the same TNFA as
+ * the parallel matcher, but a set of TNFA states reached is computed once,
+ * the first time it is seen with a given character, and then kept as a DFA
+ * state.  The DFA states are cached up to CONFIG_LIBC_REGEX_DFA_STATES per
+ * regex, the cache is flushed when it is full.
+ *
+ * The characters are split in classes that no transition tells apart, so
+ * that a DFA state has one successor per class, not per character.  Only
+ * the ASCII strings are matched, a string with another character is left
+ * to the TNFA.
+ *
+ * Most patterns start with a literal string; when the DFA is back to its
+ * initial state, the next occurrence of that string is searched with
+ * strchr() instead of stepping through the characters one at a time.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <regex.h>
+
+#include <nuttx/mutex.h>
+
+#include "tre.h"
+
+#include <assert.h>
+
+#ifdef CONFIG_LIBC_REGEX_DFA
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Longest literal prefix searched for */
+
+#define TRE_DFA_PREFIX      16
+
+/* Only the ASCII characters are classified */
+
+#define TRE_DFA_NCHARS      128
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct tre_dfa_state
+{
+  /* Successor by character class, NULL if not computed yet */
+
+  struct tre_dfa_state **next;
+
+  /* The TNFA states, one bit per state ID */
+
+  uint32_t *set;
+  uint32_t hash;
+
+  bool accept;  /* The final state is in the set */
+  bool dead;    /* The set is empty */
+};
+
+struct tre_dfa
+{
+  mutex_t lock;
+  const tre_tnfa_t *tnfa;
+
+  /* The transitions leaving each TNFA state, by state ID */
+
+  tre_tnfa_transition_t **states;
+
+  /* The cached DFA states */
+
+  struct tre_dfa_state *pool;
+  int nstates;
+
+  /* The initial DFA states, at [1] when `^' matches */
+
+  struct tre_dfa_state *start[2];
+
+  /* The initial TNFA states, at [1] when `^' matches, and a work set */
+
+  uint32_t *init[2];
+  uint32_t *scratch;
+
+  int words;
+  int final_id;
+  int nclasses;
+  bool newline;
+
+  uint8_t classes[TRE_DFA_NCHARS];
+  uint8_t reps[TRE_DFA_NCHARS];
+
+  char prefix[TRE_DFA_PREFIX];
+  size_t prefixlen;
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/* Returns 1 if the transition `trans' accepts the character `c'. */
+
+static bool tre_dfa_accepts(const tre_tnfa_t *tnfa,
+                            const tre_tnfa_transition_t *trans, int c)
+{
+  int icase = tnfa->cflags & REG_ICASE;
+  tre_ctype_t *classes;
+
+  if ((tre_cint_t)c < trans->code_min || (tre_cint_t)c > trans->code_max)
+    {
+      return false;
+    }
+
+  if (trans->assertions & ASSERT_CHAR_CLASS)
+    {
+      if (icase)
+        {
+          if (!tre_isctype(tre_tolower(c), trans->u.class) &&
+              !tre_isctype(tre_toupper(c), trans->u.class))
+            {
+              return false;
+            }
+        }
+      else if (!tre_isctype(c, trans->u.class))
+        {
+          return false;
+        }
+    }
+
+  if (trans->assertions & ASSERT_CHAR_CLASS_NEG)
+    {
+      for (classes = trans->neg_classes; *classes != (tre_ctype_t)0;
+           classes++)
+        {
+          if (tre_isctype(c, *classes) ||
+              (icase && (tre_isctype(tre_tolower(c), *classes) ||
+                         tre_isctype(tre_toupper(c), *classes))))
+            {
+              return false;
+            }
+        }
+    }
+
+  return true;
+}
+
+/* Returns 1 if the DFA can match `tnfa': no back references, and no
+ *  assertions but the character classes and a leading `^'.
+ */
+
+static bool tre_dfa_supported(const tre_tnfa_t *tnfa)
+{
+  const tre_tnfa_transition_t *trans;
+  unsigned int i;
+
+  if (tnfa->have_backrefs || tnfa->have_approx)
+    {
+      return false;
+    }
+
+  for (trans = tnfa->initial; trans->state != NULL; trans++)
+    {
+      if (trans->assertions & ~ASSERT_AT_BOL)
+        {
+          return false;
+        }
+    }
+
+  for (i = 0; i < tnfa->num_transitions; i++)
+    {
+      trans = &tnfa->transitions[i];
+      if (trans->state != NULL &&
+          (trans->assertions & ~(ASSERT_CHAR_CLASS |
+                                 ASSERT_CHAR_CLASS_NEG)) != 0)
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+
+/* Splits the characters in classes: two characters are in the same class
+ *  if every transition accepts both or none.  A newline is alone when
+ *  it makes `^' match.  Returns the number of classes.
+ */
+
+static int tre_dfa_classify(const tre_tnfa_t *tnfa, bool newline,
+                            uint8_t *classes)
+{
+  const tre_tnfa_transition_t *trans;
+  uint8_t map[2][TRE_DFA_NCHARS];
+  uint8_t *class;
+  unsigned int i;
+  int nclasses;
+  int c;
+
+  for (c = 0; c < TRE_DFA_NCHARS; c++)
+    {
+      classes[c] = newline && c == '\n';
+    }
+
+  nclasses = newline ? 2 : 1;
+  for (i = 0; i < tnfa->num_transitions; i++)
+    {
+      trans = &tnfa->transitions[i];
+      if (trans->state == NULL)
+        {
+          continue;
+        }
+
+      memset(map, 0xff, sizeof(map));
+      nclasses = 0;
+      for (c = 1; c < TRE_DFA_NCHARS; c++)
+        {
+          class = &map[tre_dfa_accepts(tnfa, trans, c)][classes[c]];
+          if (*class == 0xff)
+            {
+              *class = nclasses++;
+            }
+
+          classes[c] = *class;
+        }
+    }
+
+  return nclasses;
+}
+
+/* Finds the literal string every match starts with, if any. */
+
+static void tre_dfa_find_prefix(tre_dfa_t *dfa)
+{
+  const tre_tnfa_t *tnfa = dfa->tnfa;
+  const tre_tnfa_transition_t *trans;
+  const tre_tnfa_transition_t *state;
+  int id;
+
+  dfa->prefixlen = 0;
+
+  trans = tnfa->initial;
+  if (trans[0].state == NULL || trans[1].state != NULL ||
+      trans[0].assertions != 0)
+    {
+      return;
+    }
+
+  state = trans[0].state;
+  id    = trans[0].state_id;
+  while (dfa->prefixlen < TRE_DFA_PREFIX && id != dfa->final_id &&
+         state->state != NULL)
+    {
+      /* All the transitions must accept the same ASCII character, and
+       * lead to the same state.
+       */
+
+      if (state->code_min != state->code_max || state->code_min == 0 ||
+          state->code_min >= TRE_DFA_NCHARS)
+        {
+          break;
+        }
+
+      for (trans = state; trans->state != NULL; trans++)
+        {
+          if (trans->code_min != state->code_min ||
+              trans->code_max != state->code_max ||
+              trans->state_id != state->state_id || trans->assertions)
+            {
+              return;
+            }
+        }
+
+      dfa->prefix[dfa->prefixlen++] = state->code_min;
+      id    = state->state_id;
+      state = state->state;
+    }
+}
+
+/* Returns the cached DFA state of `set', or a new one.  Returns NULL if
+ *  the cache is full.
+ */
+
+static struct tre_dfa_state *tre_dfa_intern(tre_dfa_t *dfa,
+                                            const uint32_t *set)
+{
+  struct tre_dfa_state *state;
+  uint32_t hash = 2166136261u;
+  uint32_t any = 0;
+  int i;
+
+  for (i = 0; i < dfa->words; i++)
+    {
+      hash = (hash ^ set[i]) * 16777619u;
+      any |= set[i];
+    }
+
+  for (i = 0; i < dfa->nstates; i++)
+    {
+      state = &dfa->pool[i];
+      if (state->hash == hash &&
+          memcmp(state->set, set, dfa->words * sizeof(*set)) == 0)
+        {
+          return state;
+        }
+    }
+
+  if (dfa->nstates >= CONFIG_LIBC_REGEX_DFA_STATES)
+    {
+      return NULL;
+    }
+
+  state = &dfa->pool[dfa->nstates++];
+  memcpy(state->set, set, dfa->words * sizeof(*set));
+  memset(state->next, 0, dfa->nclasses * sizeof(*state->next));
+  state->hash   = hash;
+  state->dead   = any == 0;
+  state->accept = dfa->final_id >= 0 &&
+                  (set[dfa->final_id / 32] >> (dfa->final_id % 32)) & 1;
+  return state;
+}
+
+/* Flushes the cache, only the initial DFA states are left. */
+
+static void tre_dfa_flush(tre_dfa_t *dfa)
+{
+  dfa->nstates  = 0;
+  dfa->start[0] = tre_dfa_intern(dfa, dfa->init[0]);
+  dfa->start[1] = tre_dfa_intern(dfa, dfa->init[1]);
+}
+
+/* Computes the successor of `state' by the character class `class'. */
+
+static struct tre_dfa_state *tre_dfa_step(tre_dfa_t *dfa,
+                                          struct tre_dfa_state *state,
+                                          int class)
+{
+  const tre_tnfa_transition_t *trans;
+  struct tre_dfa_state *next;
+  uint32_t *set = dfa->scratch;
+  uint32_t bits;
+  int c = dfa->reps[class];
+  int i;
+  int j;
+
+  /* The search restarts after every character, `^' matches after a
+   * newline with REG_NEWLINE.
+   */
+
+  memcpy(set, dfa->init[dfa->newline && c == '\n'],
+         dfa->words * sizeof(*set));
+
+  for (i = 0; i < dfa->words; i++)
+    {
+      for (bits = state->set[i]; bits != 0; bits &= bits - 1)
+        {
+          j = i * 32 + ffs(bits) - 1;
+          for (trans = dfa->states[j]; trans->state != NULL; trans++)
+            {
+              if (tre_dfa_accepts(dfa->tnfa, trans, c))
+                {
+                  set[trans->state_id / 32] |=
+                    UINT32_C(1) << (trans->state_id % 32);
+                }
+            }
+        }
+    }
+
+  next = tre_dfa_intern(dfa, set);
+  if (next == NULL)
+    {
+      tre_dfa_flush(dfa);
+      next = tre_dfa_intern(dfa, set);
+      DEBUGASSERT(next != NULL);
+    }
+  else
+    {
+      state->next[class] = next;
+    }
+
+  return next;
+}
+
+/* Returns the next occurrence of the literal prefix, or NULL. */
+
+static const unsigned char *tre_dfa_search(const tre_dfa_t *dfa,
+                                           const unsigned char *str)
+{
+  for (; ; )
+    {
+      str = (const unsigned char *)strchr((const char *)str,
+                                          dfa->prefix[0]);
+      if (str == NULL ||
+          strncmp((const char *)str + 1, dfa->prefix + 1,
+                  dfa->prefixlen - 1) == 0)
+        {
+          return str;
+        }
+
+      str++;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+tre_dfa_t *tre_dfa_new(const tre_tnfa_t *tnfa)
+{
+  const tre_tnfa_transition_t *trans;
+  struct tre_dfa_state **next;
+  uint8_t classes[TRE_DFA_NCHARS];
+  tre_dfa_t *dfa;
+  uint32_t *sets;
+  unsigned int i;
+  size_t size;
+  int nclasses;
+  int words;
+  int c;
+
+  if (!tre_dfa_supported(tnfa))
+    {
+      return NULL;
+    }
+
+  nclasses = tre_dfa_classify(tnfa, (tnfa->cflags & REG_NEWLINE) != 0,
+                              classes);
+
+  /* One block holds the DFA, the state table, the successors, the DFA
+   * states and the sets, in that order to keep them aligned.
+   */
+
+  words = (tnfa->num_states + 31) / 32;
+  size  = sizeof(*dfa) + tnfa->num_states * sizeof(*dfa->states) +
+          CONFIG_LIBC_REGEX_DFA_STATES *
+          (nclasses * sizeof(*next) + sizeof(*dfa->pool)) +
+          (CONFIG_LIBC_REGEX_DFA_STATES + 3) * words * sizeof(*sets);
+
+  dfa = xcalloc(1, size);
+  if (dfa == NULL)
+    {
+      return NULL;
+    }
+
+  dfa->tnfa     = tnfa;
+  dfa->words    = words;
+  dfa->nclasses = nclasses;
+  dfa->newline  = (tnfa->cflags & REG_NEWLINE) != 0;
+  dfa->final_id = -1;
+  dfa->states   = (tre_tnfa_transition_t **)(dfa + 1);
+
+  for (i = 0; i < tnfa->num_transitions; i++)
+    {
+      trans = &tnfa->transitions[i];
+      if (trans->state != NULL)
+        {
+          dfa->states[trans->state_id] = trans->state;
+        }
+    }
+
+  for (trans = tnfa->initial; trans->state != NULL; trans++)
+    {
+      dfa->states[trans->state_id] = trans->state;
+    }
+
+  for (c = 0; c < tnfa->num_states; c++)
+    {
+      if (dfa->states[c] == tnfa->final)
+        {
+          dfa->final_id = c;
+        }
+    }
+
+  memcpy(dfa->classes, classes, sizeof(classes));
+  for (c = TRE_DFA_NCHARS - 1; c > 0; c--)
+    {
+      dfa->reps[classes[c]] = c;
+    }
+
+  tre_dfa_find_prefix(dfa);
+
+  next      = (struct tre_dfa_state **)(dfa->states + tnfa->num_states);
+  dfa->pool = (struct tre_dfa_state *)
+              (next + CONFIG_LIBC_REGEX_DFA_STATES * dfa->nclasses);
+  sets      = (uint32_t *)(dfa->pool + CONFIG_LIBC_REGEX_DFA_STATES);
+
+  for (i = 0; i < CONFIG_LIBC_REGEX_DFA_STATES; i++)
+    {
+      dfa->pool[i].next = next + i * dfa->nclasses;
+      dfa->pool[i].set  = sets + i * words;
+    }
+
+  sets += CONFIG_LIBC_REGEX_DFA_STATES * words;
+  dfa->init[0] = sets;
+  dfa->init[1] = sets + words;
+  dfa->scratch = sets + words * 2;
+
+  for (trans = tnfa->initial; trans->state != NULL; trans++)
+    {
+      dfa->init[1][trans->state_id / 32] |=
+        UINT32_C(1) << (trans->state_id % 32);
+      if (trans->assertions == 0)
+        {
+          dfa->init[0][trans->state_id / 32] |=
+            UINT32_C(1) << (trans->state_id % 32);
+        }
+    }
+
+  nxmutex_init(&dfa->lock);
+  tre_dfa_flush(dfa);
+  return dfa;
+}
+
+void tre_dfa_free(tre_dfa_t *dfa)
+{
+  nxmutex_destroy(&dfa->lock);
+  xfree(dfa);
+}
+
+reg_errcode_t tre_dfa_run(const tre_tnfa_t *tnfa, const char *string,
+                          int eflags)
+{
+  tre_dfa_t *dfa = tnfa->dfa;
+  struct tre_dfa_state *state;
+  struct tre_dfa_state *next;
+  const unsigned char *str = (const unsigned char *)string;
+  reg_errcode_t ret = REG_NOMATCH;
+  int c;
+
+  /* The cache is not shared, let the TNFA match if another thread has
+   * it.
+   */
+
+  if (nxmutex_trylock(&dfa->lock) < 0)
+    {
+      return TRE_DFA_UNKNOWN;
+    }
+
+  state = dfa->start[(eflags & REG_NOTBOL) == 0];
+  for (; ; )
+    {
+      if (state->accept)
+        {
+          /* The TNFA reads up to two characters past the end of the
+           * match, and fails if they are not valid.
+           */
+
+          ret = str[0] < TRE_DFA_NCHARS &&
+                (str[0] == '\0' || str[1] < TRE_DFA_NCHARS) ?
+                REG_OK : TRE_DFA_UNKNOWN;
+          break;
+        }
+
+      if (state->dead)
+        {
+          /* Nothing can match before `^' does again */
+
+          str = dfa->newline ?
+                (const unsigned char *)strchr((const char *)str, '\n') :
+                NULL;
+        }
+      else if (state == dfa->start[0] && dfa->prefixlen > 0)
+        {
+          str = tre_dfa_search(dfa, str);
+        }
+
+      if (str == NULL || (c = *str++) == '\0')
+        {
+          break;
+        }
+
+      if (c >= TRE_DFA_NCHARS)
+        {
+          ret = TRE_DFA_UNKNOWN;
+          break;
+        }
+
+      next = state->next[dfa->classes[c]];
+      if (next == NULL)
+        {
+          next = tre_dfa_step(dfa, state, dfa->classes[c]);
+        }
+
+      state = next;
+    }
+
+  nxmutex_unlock(&dfa->lock);
+  return ret;
+}
+
+#endif /* CONFIG_LIBC_REGEX_DFA */
@@ -36,6 +36,8 @@
 #ifndef _REGEX_TRE_H
 #define _REGEX_TRE_H
 
+#include <nuttx/config.h>
+
 #include <regex.h>
 #include <wchar.h>
 #include <wctype.h>
@@ -191,6 +193,7 @@ typedef struct tre_submatch_data tre_submatch_data_t;
 /* TNFA definition. */
 
 typedef struct tnfa tre_tnfa_t;
+typedef struct tre_dfa tre_dfa_t;
 
 struct tnfa
 {
@@ -211,6 +214,9 @@ struct tnfa
   int cflags;
   int have_backrefs;
   int have_approx;
+#ifdef CONFIG_LIBC_REGEX_DFA
+  tre_dfa_t *dfa;
+#endif
 };
 
 /* from tre-mem.h: */
@@ -278,6 +284,37 @@ void *tre_mem_alloc_impl(tre_mem_t mem, int provided, void *provided_block,
 
 void tre_mem_destroy(tre_mem_t mem);
 
+/* from tre-dfa.c: */
+
+#ifdef CONFIG_LIBC_REGEX_DFA
+
+/* tre_dfa_run() can't tell, the TNFA has to be run. */
+
+#define TRE_DFA_UNKNOWN     (-2)
+
+#define tre_dfa_new         __tre_dfa_new
+#define tre_dfa_free        __tre_dfa_free
+#define tre_dfa_run         __tre_dfa_run
+
+/* Returns the DFA of `tnfa', or NULL if the TNFA has back references,
+ *  assertions other than a leading `^', or memory is out.
+ */
+
+tre_dfa_t *tre_dfa_new(const tre_tnfa_t *tnfa);
+
+/* Frees the DFA and all its states. */
+
+void tre_dfa_free(tre_dfa_t *dfa);
+
+/* Tells if `string' matches, without the submatches.  Returns REG_OK,
+ *  REG_NOMATCH, or TRE_DFA_UNKNOWN if the string isn't ASCII or the DFA
+ *  is busy with another thread.
+ */
+
+reg_errcode_t tre_dfa_run(const tre_tnfa_t *tnfa, const char *string,
+                          int eflags);
+#endif /* CONFIG_LIBC_REGEX_DFA */
+
 #define xmalloc     malloc
 #define xcalloc     calloc
 #define xfree       free
@@ -86,6 +86,12 @@ int nxsem_init(FAR sem_t *sem, int pshared, unsigned int value)
 #  else
   INITIALIZE_SEMHOLDER(&sem->holder);
 #  endif
+#endif
+
+#ifdef CONFIG_SCHED_LOCKSTAT
+  /* The semaphores are counted by the place they are initialized from */
+
+  sem->initsite = return_address(0);
 #endif
   return OK;
 }
@@ -135,5 +141,9 @@ int sem_init(FAR sem_t *sem, int pshared, unsigned int value)
       ret = ERROR;
     }
 
+#ifdef CONFIG_SCHED_LOCKSTAT
+  sem->initsite = return_address(0);
+#endif
+
   return ret;
 }
@@ -75,7 +75,9 @@ int sem_post(FAR sem_t *sem)
       return ERROR;
     }
 
-  ret = nxsem_post(sem);
+  /* Only enter the kernel if there is a waiter to wake up */
+
+  ret = nxsem_user_post(sem) ? OK : nxsem_post(sem);
   if (ret < 0)
     {
       set_errno(-ret);
@@ -65,9 +65,11 @@ int sem_trywait(FAR sem_t *sem)
       return ERROR;
     }
 
-  /* Let nxsem_trywait do the real work */
+  /* Take a free count without a system call if possible, otherwise let
+   * nxsem_trywait do the real work.
+   */
 
-  ret = nxsem_trywait(sem);
+  ret = nxsem_user_trywait(sem) ? OK : nxsem_trywait(sem);
   if (ret < 0)
     {
       set_errno(-ret);
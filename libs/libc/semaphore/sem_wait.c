@@ -81,9 +81,11 @@ int sem_wait(FAR sem_t *sem)
 #endif
     }
 
-  /* Let nxsem_wait() do the real work */
+  /* Take a free count without a system call if possible, otherwise let
+   * nxsem_wait() do the real work.
+   */
 
-  ret = nxsem_wait(sem);
+  ret = nxsem_user_trywait(sem) ? OK : nxsem_wait(sem);
   if (ret < 0)
     {
       errcode = -ret;
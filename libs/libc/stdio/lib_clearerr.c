@@ -31,6 +31,8 @@
 
 #include <nuttx/fs/fs.h>
 
+#include "libc.h"
+
 #ifdef CONFIG_FILE_STREAM
 
 /****************************************************************************
@@ -55,8 +57,10 @@ void clearerr_unlocked(FAR FILE *stream)
 
 void clearerr(FAR FILE *stream)
 {
-  flockfile(stream);
+  bool locked;
+
+  locked = lib_flockfile(stream);
   clearerr_unlocked(stream);
-  funlockfile(stream);
+  lib_funlockfile(stream, locked);
 }
 #endif /* CONFIG_FILE_STREAM */
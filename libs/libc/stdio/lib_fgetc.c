@@ -53,11 +53,12 @@ int fgetc_unlocked(FAR FILE *stream)
 
 int fgetc(FAR FILE *stream)
 {
+  bool locked;
   int ret;
 
-  flockfile(stream);
+  locked = lib_flockfile(stream);
   ret = fgetc_unlocked(stream);
-  funlockfile(stream);
+  lib_funlockfile(stream, locked);
 
   return ret;
 }
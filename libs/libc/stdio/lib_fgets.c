@@ -65,11 +65,12 @@ FAR char *fgets_unlocked(FAR char *buf, int buflen, FAR FILE *stream)
 
 FAR char *fgets(FAR char *buf, int buflen, FAR FILE *stream)
 {
+  bool locked;
   FAR char *ret;
 
-  flockfile(stream);
+  locked = lib_flockfile(stream);
   ret = fgets_unlocked(buf, buflen, stream);
-  funlockfile(stream);
+  lib_funlockfile(stream, locked);
 
   return ret;
 }
@@ -33,6 +33,8 @@
 #include <errno.h>
 #include <string.h>
 
+#include "libc.h"
+
 #ifdef CONFIG_FILE_STREAM
 
 /****************************************************************************
@@ -113,10 +115,12 @@ wint_t fgetwc_unlocked(FAR FILE *f)
 
 wint_t fgetwc(FAR FILE *f)
 {
+  bool locked;
   wint_t c;
-  flockfile(f);
+
+  locked = lib_flockfile(f);
   c = fgetwc_unlocked(f);
-  funlockfile(f);
+  lib_funlockfile(f, locked);
   return c;
 }
 
@@ -64,11 +64,12 @@ int fputc_unlocked(int c, FAR FILE *stream)
 
 int fputc(int c, FAR FILE *stream)
 {
+  bool locked;
   int ret;
 
-  flockfile(stream);
+  locked = lib_flockfile(stream);
   ret = fputc_unlocked(c, stream);
-  funlockfile(stream);
+  lib_funlockfile(stream, locked);
 
   return ret;
 }
@@ -147,11 +147,12 @@ int fputs_unlocked(FAR const IPTR char *s, FAR FILE *stream)
 
 int fputs(FAR const IPTR char *s, FAR FILE *stream)
 {
+  bool locked;
   int ret;
 
-  flockfile(stream);
+  locked = lib_flockfile(stream);
   ret = fputs_unlocked(s, stream);
-  funlockfile(stream);
+  lib_funlockfile(stream, locked);
 
   return ret;
 }
@@ -102,9 +102,12 @@ wint_t fputwc_unlocked(wchar_t c, FAR FILE *f)
 
 wint_t fputwc(wchar_t c, FAR FILE *f)
 {
-  flockfile(f);
-  wint_t wc = fputwc_unlocked(c, f);
-  funlockfile(f);
+  bool locked;
+  wint_t wc;
+
+  locked = lib_flockfile(f);
+  wc = fputwc_unlocked(c, f);
+  lib_funlockfile(f, locked);
   return wc;
 }
 
@@ -66,7 +66,6 @@ int fputws_unlocked(FAR const wchar_t *ws, FAR FILE *f)
     {
       if (lib_fwrite_unlocked(buf, l, f) < l)
         {
-          funlockfile(f);
           return -1;
         }
     }
@@ -92,10 +91,12 @@ int fputws_unlocked(FAR const wchar_t *ws, FAR FILE *f)
 
 int fputws(FAR const wchar_t *ws, FAR FILE *f)
 {
+  bool locked;
   int l;
-  flockfile(f);
+
+  locked = lib_flockfile(f);
   l = fputws_unlocked(ws, f);
-  funlockfile(f);
+  lib_funlockfile(f, locked);
   return l;
 }
 
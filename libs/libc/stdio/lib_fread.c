@@ -61,11 +61,12 @@ size_t fread_unlocked(FAR void *ptr, size_t size,
 
 size_t fread(FAR void *ptr, size_t size, size_t n_items, FAR FILE *stream)
 {
+  bool locked;
   size_t ret;
 
-  flockfile(stream);
+  locked = lib_flockfile(stream);
   ret = fread_unlocked(ptr, size, n_items, stream);
-  funlockfile(stream);
+  lib_funlockfile(stream, locked);
 
   return ret;
 }
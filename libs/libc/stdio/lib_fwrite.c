@@ -62,11 +62,12 @@ size_t fwrite_unlocked(FAR const void *ptr, size_t size, size_t n_items,
 size_t fwrite(FAR const void *ptr, size_t size, size_t n_items,
               FAR FILE *stream)
 {
+  bool locked;
   size_t ret;
 
-  flockfile(stream);
+  locked = lib_flockfile(stream);
   ret = fwrite_unlocked(ptr, size, n_items, stream);
-  funlockfile(stream);
+  lib_funlockfile(stream, locked);
 
   return ret;
 }
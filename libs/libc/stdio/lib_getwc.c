@@ -29,6 +29,7 @@
  * Included Files
  ****************************************************************************/
 
+#include <stdio.h>
 #include <wchar.h>
 
 #ifdef CONFIG_FILE_STREAM
@@ -53,9 +54,32 @@
  *
  ****************************************************************************/
 
+wint_t getwc_unlocked(FAR FILE *f)
+{
+  return fgetwc_unlocked(f);
+}
+
 wint_t getwc(FAR FILE *f)
 {
   return fgetwc(f);
 }
 
+/****************************************************************************
+ * Name: getwchar
+ *
+ * Description:
+ *   Get wide character from stdin
+ *
+ ****************************************************************************/
+
+wint_t getwchar_unlocked(void)
+{
+  return fgetwc_unlocked(stdin);
+}
+
+wint_t getwchar(void)
+{
+  return fgetwc(stdin);
+}
+
 #endif /* CONFIG_FILE_STREAM */
@@ -82,6 +82,7 @@ int lib_bsprintf(FAR struct lib_outstream_s *s, FAR const IPTR char *fmt,
         {
           len = 0;
           infmt = true;
+          prec = NULL;
           memset(fmtstr, 0, sizeof(fmtstr));
         }
 
@@ -164,6 +165,11 @@ int lib_bsprintf(FAR struct lib_outstream_s *s, FAR const IPTR char *fmt,
       else if (c == '*')
         {
           sprintf(fmtstr + len - 1, "%d", var->i);
+          if (prec != NULL)
+            {
+              prec = fmtstr + len - 1;
+            }
+
           len = strlen(fmtstr);
           offset += sizeof(var->i);
         }
@@ -194,6 +200,12 @@ int lib_bsprintf(FAR struct lib_outstream_s *s, FAR const IPTR char *fmt,
         {
           prec = fmt;
         }
+      else if (c == '%' && len > 1)
+        {
+          lib_stream_putc(s, c);
+          ret++;
+          infmt = false;
+        }
     }
 
   return ret;
@@ -171,12 +171,13 @@ ssize_t lib_fflush_unlocked(FAR FILE *stream)
 
 ssize_t lib_fflush(FAR FILE *stream)
 {
+  bool locked;
   ssize_t ret;
 
   /* Make sure that we have exclusive access to the stream */
 
-  flockfile(stream);
+  locked = lib_flockfile(stream);
   ret = lib_fflush_unlocked(stream);
-  funlockfile(stream);
+  lib_funlockfile(stream, locked);
   return ret;
 }
@@ -209,11 +209,12 @@ FAR char *lib_fgets_unlocked(FAR char *buf, size_t buflen, FILE *stream,
 FAR char *lib_fgets(FAR char *buf, size_t buflen, FILE *stream,
                     bool keepnl, bool consume)
 {
+  bool locked;
   FAR char *ret;
 
-  flockfile(stream);
+  locked = lib_flockfile(stream);
   ret = lib_fgets_unlocked(buf, buflen, stream, keepnl, consume);
-  funlockfile(stream);
+  lib_funlockfile(stream, locked);
 
   return ret;
 }
@@ -35,6 +35,8 @@
 #include <nuttx/mutex.h>
 #include <nuttx/fs/fs.h>
 
+#include "libc.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -65,3 +67,44 @@ void funlockfile(FAR struct file_struct *stream)
 {
   nxrmutex_unlock(&stream->fs_lock);
 }
+
+/****************************************************************************
+ * Name: lib_flockfile
+ *
+ * Description:
+ *   Lock the stream for one stdio function.  The lock is skipped while the
+ *   task has no other thread, see CONFIG_STDIO_LAZY_LOCK.
+ *
+ * Returned Value:
+ *   True if the stream was locked, to pass to lib_funlockfile().
+ *
+ ****************************************************************************/
+
+bool lib_flockfile(FAR FILE *stream)
+{
+#ifdef CONFIG_STDIO_LAZY_LOCK
+  if (!lib_get_streams()->sl_threaded)
+    {
+      return false;
+    }
+#endif
+
+  nxrmutex_lock(&stream->fs_lock);
+  return true;
+}
+
+/****************************************************************************
+ * Name: lib_funlockfile
+ *
+ * Description:
+ *   Unlock the stream locked by lib_flockfile().
+ *
+ ****************************************************************************/
+
+void lib_funlockfile(FAR FILE *stream, bool locked)
+{
+  if (locked)
+    {
+      nxrmutex_unlock(&stream->fs_lock);
+    }
+}
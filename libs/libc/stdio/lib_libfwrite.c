@@ -203,11 +203,12 @@ errout:
 
 ssize_t lib_fwrite(FAR const void *ptr, size_t count, FAR FILE *stream)
 {
+  bool locked;
   ssize_t ret;
 
-  flockfile(stream);
+  locked = lib_flockfile(stream);
   ret = lib_fwrite_unlocked(ptr, count, stream);
-  funlockfile(stream);
+  lib_funlockfile(stream, locked);
 
   return ret;
 }
@@ -192,6 +192,29 @@ static int vsprintf_internal(FAR struct lib_outstream_s *stream,
 
   for (; ; )
     {
+#if defined(CONFIG_LIBC_PRINTF_FAST) && !defined(CONFIG_ARCH_ROMGETC)
+      /* Copy the text up to the next conversion in one go */
+
+      pnt = fmt;
+      while (*fmt != '\0' && *fmt != '%')
+        {
+          fmt++;
+        }
+
+      size = fmt - pnt;
+      if (size > 0)
+        {
+#  ifdef CONFIG_LIBC_NUMBERED_ARGS
+          if (stream != NULL)
+            {
+              stream_puts(pnt, size, stream);
+            }
+#  else
+          stream_puts(pnt, size, stream);
+#  endif
+        }
+#endif
+
       for (; ; )
         {
           c = fmt_char(fmt);
@@ -219,6 +242,75 @@ static int vsprintf_internal(FAR struct lib_outstream_s *stream,
 #endif
         }
 
+#ifdef CONFIG_LIBC_PRINTF_FAST
+      /* The bare conversions, without flag, width, precision or length
+       * modifier, are the most common ones: skip the parsing for them.
+       */
+
+#  ifdef CONFIG_LIBC_NUMBERED_ARGS
+      if (stream != NULL)
+#  endif
+        {
+          switch (c)
+            {
+              case 'c':
+                stream_putc(va_arg(ap, int), stream);
+                continue;
+
+              case 's':
+                pnt = va_arg(ap, FAR char *);
+                if (pnt == NULL)
+                  {
+                    pnt = g_nullstring;
+                  }
+
+                size = strlen(pnt);
+                stream_puts(pnt, size, stream);
+                continue;
+
+              case 'd':
+              case 'i':
+                {
+                  int x = va_arg(ap, int);
+
+                  if (x < 0)
+                    {
+                      stream_putc('-', stream);
+                    }
+
+                  size = __ultoa_invert(x < 0 ? -(unsigned int)x : x, buf,
+                                        10) - buf;
+                  goto fast_int;
+                }
+
+              case 'u':
+                size = __ultoa_invert(va_arg(ap, unsigned int), buf, 10) -
+                       buf;
+                goto fast_int;
+
+              case 'x':
+                size = __ultoa_invert(va_arg(ap, unsigned int), buf, 16) -
+                       buf;
+                goto fast_int;
+
+              case 'X':
+                size = __ultoa_invert(va_arg(ap, unsigned int), buf,
+                                      16 | XTOA_UPPER) - buf;
+
+fast_int:
+                for (len = 0; len < size / 2; len++)
+                  {
+                    c = buf[len];
+                    buf[len] = buf[size - len - 1];
+                    buf[size - len - 1] = c;
+                  }
+
+                stream_puts(buf, size, stream);
+                continue;
+            }
+        }
+#endif
+
       flags = 0;
       width = 0;
       prec  = 0;
@@ -46,13 +46,14 @@ int puts(FAR const IPTR char *s)
 {
 #ifdef CONFIG_FILE_STREAM
   FILE *stream = stdout;
+  bool locked;
   int nwritten;
   int nput = EOF;
   int ret;
 
   /* Write the string (the next two steps must be atomic) */
 
-  flockfile(stream);
+  locked = lib_flockfile(stream);
 
   /* Write the string without its trailing '\0' */
 
@@ -82,7 +83,7 @@ int puts(FAR const IPTR char *s)
         }
     }
 
-  funlockfile(stdout);
+  lib_funlockfile(stdout, locked);
   return nput;
 #else
   size_t len = strlen(s);
@@ -32,6 +32,8 @@
 #include <wchar.h>
 #include <stdio.h>
 
+#include "libc.h"
+
 #ifdef CONFIG_FILE_STREAM
 
 /****************************************************************************
@@ -77,10 +79,12 @@ wint_t putwc_unlocked(wchar_t c, FAR FILE *f)
 
 wint_t putwc(wchar_t c, FAR FILE *f)
 {
+  bool locked;
   wint_t wc;
-  flockfile(f);
+
+  locked = lib_flockfile(f);
   wc = putwc_unlocked(c, f);
-  funlockfile(f);
+  lib_funlockfile(f, locked);
   return wc;
 }
 
@@ -37,8 +37,130 @@
  * Included Files
  ****************************************************************************/
 
+#include <limits.h>
+
 #include "lib_ultoa_invert.h"
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_LIBC_PRINTF_FAST
+static const char g_digits_lower[] = "0123456789abcdef";
+static const char g_digits_upper[] = "0123456789ABCDEF";
+
+/* The decimal numbers from 00 to 99, two digits at a time */
+
+static const char g_digits_pair[] =
+  "00010203040506070809"
+  "10111213141516171819"
+  "20212223242526272829"
+  "30313233343536373839"
+  "40414243444546474849"
+  "50515253545556575859"
+  "60616263646566676869"
+  "70717273747576777879"
+  "80818283848586878889"
+  "90919293949596979899";
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_LIBC_PRINTF_FAST
+/****************************************************************************
+ * Name: ultoa_invert_fast
+ *
+ * Description:
+ *   Convert with two decimal digits per division, and with shifts for the
+ *   power of two bases.  The division of the long long is only done while
+ *   the value doesn't fit an unsigned long.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_LIBC_LONG_LONG
+static FAR char *ultoa_invert_fast(unsigned long long val, FAR char *str,
+                                   int base)
+#else
+static FAR char *ultoa_invert_fast(unsigned long val, FAR char *str,
+                                   int base)
+#endif
+{
+  FAR const char *digits = g_digits_lower;
+  FAR const char *pair;
+  unsigned long v;
+  unsigned int shift;
+  unsigned int r;
+
+  if (base & XTOA_UPPER)
+    {
+      digits = g_digits_upper;
+      base &= ~XTOA_UPPER;
+    }
+
+  if (base == 10)
+    {
+#ifdef CONFIG_LIBC_LONG_LONG
+      while (val > ULONG_MAX)
+        {
+          r    = val % 100;
+          val /= 100;
+          pair = &g_digits_pair[r * 2];
+          *str++ = pair[1];
+          *str++ = pair[0];
+        }
+#endif
+
+      v = val;
+      while (v >= 100)
+        {
+          r  = v % 100;
+          v /= 100;
+          pair = &g_digits_pair[r * 2];
+          *str++ = pair[1];
+          *str++ = pair[0];
+        }
+
+      if (v >= 10)
+        {
+          pair = &g_digits_pair[v * 2];
+          *str++ = pair[1];
+          *str++ = pair[0];
+        }
+      else
+        {
+          *str++ = '0' + v;
+        }
+
+      return str;
+    }
+
+  shift = base == 16 ? 4 : base == 8 ? 3 : base == 2 ? 1 : 0;
+  if (shift != 0)
+    {
+      do
+        {
+          *str++ = digits[val & (base - 1)];
+          val >>= shift;
+        }
+      while (val);
+
+      return str;
+    }
+
+  do
+    {
+      r    = val % base;
+      val /= base;
+      *str++ = r <= 9 ? '0' + r : digits[10] + r - 10;
+    }
+  while (val);
+
+  return str;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -49,6 +171,9 @@ FAR char *__ultoa_invert(unsigned long long val, FAR char *str, int base)
 FAR char *__ultoa_invert(unsigned long val, FAR char *str, int base)
 #endif
 {
+#ifdef CONFIG_LIBC_PRINTF_FAST
+  return ultoa_invert_fast(val, str, base);
+#else
   int upper = 0;
 
   if (base & XTOA_UPPER)
@@ -81,4 +206,5 @@ FAR char *__ultoa_invert(unsigned long val, FAR char *str, int base)
   while (val);
 
   return str;
+#endif
 }
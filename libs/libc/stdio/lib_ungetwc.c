@@ -35,6 +35,8 @@
 #include <fcntl.h>
 #include <string.h>
 
+#include "libc.h"
+
 #ifdef CONFIG_FILE_STREAM
 
 /****************************************************************************
@@ -108,6 +110,7 @@ wint_t ungetwc_unlocked(wint_t wc, FAR FILE *f)
 
 wint_t ungetwc(wint_t wc, FAR FILE *f)
 {
+  bool locked;
   wint_t ret;
 
   /* Verify that a non-NULL stream was provided and wc is not WEOF */
@@ -117,9 +120,9 @@ wint_t ungetwc(wint_t wc, FAR FILE *f)
       return WEOF;
     }
 
-  flockfile(f);
+  locked = lib_flockfile(f);
   ret = ungetwc_unlocked(wc, f);
-  funlockfile(f);
+  lib_funlockfile(f, locked);
   return ret;
 }
 
@@ -26,12 +26,15 @@
 
 #include <nuttx/streams.h>
 
+#include "libc.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
 int vfprintf(FAR FILE *stream, FAR const IPTR char *fmt, va_list ap)
 {
+  bool locked;
   struct lib_stdoutstream_s stdoutstream;
   int  n = ERROR;
 
@@ -46,9 +49,9 @@ int vfprintf(FAR FILE *stream, FAR const IPTR char *fmt, va_list ap)
    * before being pre-empted by the next thread.
    */
 
-  flockfile(stream);
+  locked = lib_flockfile(stream);
   n = lib_vsprintf(&stdoutstream.common, fmt, ap);
-  funlockfile(stream);
+  lib_funlockfile(stream, locked);
 
   return n;
 }
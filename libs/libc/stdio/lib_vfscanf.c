@@ -26,6 +26,8 @@
 
 #include <nuttx/streams.h>
 
+#include "libc.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -36,6 +38,7 @@
 
 int vfscanf(FAR FILE *stream, FAR const IPTR char *fmt, va_list ap)
 {
+  bool locked;
   struct lib_stdinstream_s stdinstream;
   int n = ERROR;
   int lastc;
@@ -51,7 +54,7 @@ int vfscanf(FAR FILE *stream, FAR const IPTR char *fmt, va_list ap)
        * by the next thread.
        */
 
-      flockfile(stream);
+      locked = lib_flockfile(stream);
 
       n = lib_vscanf(&stdinstream.common, &lastc, fmt, ap);
 
@@ -64,7 +67,7 @@ int vfscanf(FAR FILE *stream, FAR const IPTR char *fmt, va_list ap)
           ungetc(lastc, stream);
         }
 
-      funlockfile(stream);
+      lib_funlockfile(stream, locked);
     }
 
   return n;
@@ -0,0 +1,133 @@
+/****************************************************************************
+ * libs/libc/stdlib/lib_decdigits.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+
+#include "libc.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lib_eightdigits
+ *
+ * Description:
+ *   Convert eight decimal digits with three multiplications: the digits
+ *   are combined by pairs, then by fours, then the two halves.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_ENDIAN_BIG
+static uint32_t lib_eightdigits(FAR const char *str)
+{
+  uint64_t v;
+
+  memcpy(&v, str, sizeof(v));
+  v -= 0x3030303030303030ull;
+  v  = v * 10 + (v >> 8);
+  v  = ((v & 0x000000ff000000ffull) * (100 + (1000000ull << 32)) +
+        ((v >> 16) & 0x000000ff000000ffull) * (1 + (10000ull << 32))) >> 32;
+
+  return (uint32_t)v;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lib_decdigits
+ *
+ * Description:
+ *   Convert len decimal digits, which the caller knows are all digits.
+ *   The result is exact for up to 19 digits.
+ *
+ ****************************************************************************/
+
+uint64_t lib_decdigits(FAR const char *str, size_t len)
+{
+  uint64_t value = 0;
+
+#ifndef CONFIG_ENDIAN_BIG
+  while (len >= 8)
+    {
+      value = value * 100000000 + lib_eightdigits(str);
+      str  += 8;
+      len  -= 8;
+    }
+#endif
+
+  while (len-- > 0)
+    {
+      value = value * 10 + (*str++ - '0');
+    }
+
+  return value;
+}
+
+/****************************************************************************
+ * Name: lib_getdecimal
+ *
+ * Description:
+ *   Convert the decimal digits at *pptr in one go, if they are at most 19
+ *   and their value doesn't exceed max.  Else nothing is converted, and the
+ *   caller does it digit by digit with the overflow checks.
+ *
+ * Returned Value:
+ *   True if the digits were converted and *pptr advanced past them.
+ *
+ ****************************************************************************/
+
+bool lib_getdecimal(FAR const char **pptr, uint64_t max,
+                    FAR uint64_t *value)
+{
+  FAR const char *str = *pptr;
+  size_t len = 0;
+
+  while (len < 20 && str[len] >= '0' && str[len] <= '9')
+    {
+      len++;
+    }
+
+  if (len == 0 || len == 20)
+    {
+      return false;
+    }
+
+  *value = lib_decdigits(str, len);
+  if (*value > max)
+    {
+      return false;
+    }
+
+  *pptr = str + len;
+  return true;
+}
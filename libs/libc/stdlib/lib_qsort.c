@@ -48,7 +48,14 @@
 
 #include <sys/types.h>
 #include <sys/param.h>
+#include <stdbool.h>
 #include <stdlib.h>
+#include <string.h>
+
+#ifdef CONFIG_LIBC_QSORT_PARALLEL
+#  include <nuttx/semaphore.h>
+#  include <nuttx/wqueue.h>
+#endif
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -84,14 +91,35 @@
 
 #define vecswap(a, b, n) if ((n) > 0) swapfunc(a, b, n, swaptype)
 
+#define cmp(a, b) compar(a, b, arg)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+typedef CODE int (*qsort_compar_t)(FAR const void *, FAR const void *,
+                                   FAR void *);
+
+#ifdef CONFIG_LIBC_QSORT_PARALLEL
+struct qsort_job_s
+{
+  struct work_s  work;
+  FAR char      *base;
+  size_t         nel;
+  size_t         width;
+  qsort_compar_t compar;
+  FAR void      *arg;
+  FAR sem_t     *done;
+};
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
 
 static inline void swapfunc(FAR char *a, FAR char *b, int n, int swaptype);
 static inline FAR char *med3(FAR char *a, FAR char *b, FAR char *c,
-                             CODE int (*compar)(FAR const void *,
-                             FAR const void *));
+                             qsort_compar_t compar, FAR void *arg);
 
 /****************************************************************************
  * Private Functions
@@ -110,59 +138,127 @@ static inline void swapfunc(FAR char *a, FAR char *b, int n, int swaptype)
 }
 
 static inline FAR char *med3(FAR char *a, FAR char *b, FAR char *c,
-                             CODE int (*compar)(FAR const void *,
-                             FAR const void *))
+                             qsort_compar_t compar, FAR void *arg)
 {
-  return compar(a, b) < 0 ?
-         (compar(b, c) < 0 ? b : (compar(a, c) < 0 ? c : a)) :
-         (compar(b, c) > 0 ? b : (compar(a, c) < 0 ? a : c));
+  return cmp(a, b) < 0 ?
+         (cmp(b, c) < 0 ? b : (cmp(a, c) < 0 ? c : a)) :
+         (cmp(b, c) > 0 ? b : (cmp(a, c) < 0 ? a : c));
 }
 
 /****************************************************************************
- * Public Function
+ * Name: qsort_insertion
+ *
+ * Description:
+ *   Sort by insertion.  With a limit, give up once that many elements
+ *   were moved, the partial result is still a permutation of the input.
+ *   A limit of zero means none.
+ *
+ * Returned Value:
+ *   True if sorted.
+ *
  ****************************************************************************/
 
+static bool qsort_insertion(FAR char *base, size_t nel, size_t width,
+                            int swaptype, qsort_compar_t compar,
+                            FAR void *arg, size_t limit)
+{
+  FAR char *end = base + nel * width;
+  FAR char *pm;
+  FAR char *pl;
+  size_t moves = 0;
+
+  for (pm = base + width; pm < end; pm += width)
+    {
+      for (pl = pm; pl > base && cmp(pl - width, pl) > 0; pl -= width)
+        {
+          swap(pl, pl - width);
+        }
+
+      if (limit != 0 && pl != pm)
+        {
+          moves += (pm - pl) / width;
+          if (moves > limit)
+            {
+              return false;
+            }
+        }
+    }
+
+  return true;
+}
+
 /****************************************************************************
- * Name: qsort
+ * Name: qsort_heap
  *
  * Description:
- *   The qsort() function will sort an array of 'nel' objects, the initial
- *   element of which is pointed to by 'base'. The size of each object, in
- *   bytes, is specified by the 'width" argument. If the 'nel' argument has
- *   the value zero, the comparison function pointed to by 'compar' will not
- *   be called and no rearrangement will take place.
- *
- *   The application will ensure that the comparison function pointed to by
- *   'compar' does not alter the contents of the array. The implementation
- *   may reorder elements of the array between calls to the comparison
- *   function, but will not alter the contents of any individual element.
+ *   Sort by heapsort, when the quicksort goes too deep for the input.
  *
- *   When the same objects (consisting of 'width" bytes, irrespective of
- *   their current positions in the array) are passed more than once to
- *   the comparison function, the results will be consistent with one
- *   another. That is, they will define a total ordering on the array.
+ ****************************************************************************/
+
+static void qsort_siftdown(FAR char *base, size_t root, size_t nel,
+                           size_t width, int swaptype,
+                           qsort_compar_t compar, FAR void *arg)
+{
+  size_t child;
+
+  while ((child = 2 * root + 1) < nel)
+    {
+      if (child + 1 < nel &&
+          cmp(base + child * width, base + (child + 1) * width) < 0)
+        {
+          child++;
+        }
+
+      if (cmp(base + root * width, base + child * width) >= 0)
+        {
+          break;
+        }
+
+      swap(base + root * width, base + child * width);
+      root = child;
+    }
+}
+
+static void qsort_heap(FAR char *base, size_t nel, size_t width,
+                       int swaptype, qsort_compar_t compar, FAR void *arg)
+{
+  size_t i;
+
+  for (i = nel / 2; i > 0; i--)
+    {
+      qsort_siftdown(base, i - 1, nel, width, swaptype, compar, arg);
+    }
+
+  while (nel > 1)
+    {
+      nel--;
+      swap(base, base + nel * width);
+      qsort_siftdown(base, 0, nel, width, swaptype, compar, arg);
+    }
+}
+
+/****************************************************************************
+ * Name: qsort_partition
  *
- *   The contents of the array will be sorted in ascending order according
- *   to a comparison function. The 'compar' argument is a pointer to the
- *   comparison function, which is called with two arguments that point to
- *   the elements being compared. The application will ensure that the
- *   function returns an integer less than, equal to, or greater than 0,
- *   if the first argument is considered respectively less than, equal to,
- *   or greater than the second. If two members compare as equal, their
- *   order in the sorted array is unspecified.
+ * Description:
+ *   Partition around a pseudomedian in three parts: the elements less than
+ *   the pivot are moved at the beginning, the ones greater at the end, and
+ *   the ones equal in the middle, which are sorted already.
  *
- *   (Based on description from OpenGroup.org).
+ * Input Parameters:
+ *   base - The elements, at least 7
+ *   lnel - The number of elements less than the pivot
+ *   rnel - The number of elements greater than the pivot
  *
  * Returned Value:
- *   The qsort() function will not return a value.
- *
- * Notes from the original BSD version:
- *   Qsort routine from Bentley & McIlroy's "Engineering a Sort Function".
+ *   True if no element was swapped, the input is likely sorted.
  *
  ****************************************************************************/
 
-void qsort(FAR void *base, size_t nel, size_t width,
-           CODE int(*compar)(FAR const void *, FAR const void *))
+static bool qsort_partition(FAR char *base, size_t nel, size_t width,
+                            int swaptype, qsort_compar_t compar,
+                            FAR void *arg, FAR size_t *lnel,
+                            FAR size_t *rnel)
 {
   FAR char *pa;
   FAR char *pb;
@@ -171,59 +267,38 @@ void qsort(FAR void *base, size_t nel, size_t width,
   FAR char *pl;
   FAR char *pm;
   FAR char *pn;
-  int swaptype;
-  int swap_cnt;
-  int d;
-  int r;
-
-loop:
-  SWAPINIT(base, width);
-  swap_cnt = 0;
-
-  if (nel < 7)
-    {
-      for (pm = (FAR char *)base + width;
-           pm < (FAR char *)base + nel * width;
-           pm += width)
-        {
-          for (pl = pm;
-               pl > (FAR char *)base && compar(pl - width, pl) > 0;
-               pl -= width)
-            {
-              swap(pl, pl - width);
-            }
-        }
-
-      return;
-    }
+  bool swapped = false;
+  size_t d;
+  size_t r;
+  int ret;
 
-  pm = (FAR char *)base + (nel / 2) * width;
+  pm = base + (nel / 2) * width;
   if (nel > 7)
     {
       pl = base;
-      pn = (FAR char *)base + (nel - 1) * width;
+      pn = base + (nel - 1) * width;
       if (nel > 40)
         {
           d  = (nel / 8) * width;
-          pl = med3(pl, pl + d, pl + 2 * d, compar);
-          pm = med3(pm - d, pm, pm + d, compar);
-          pn = med3(pn - 2 * d, pn - d, pn, compar);
+          pl = med3(pl, pl + d, pl + 2 * d, compar, arg);
+          pm = med3(pm - d, pm, pm + d, compar, arg);
+          pn = med3(pn - 2 * d, pn - d, pn, compar, arg);
         }
 
-      pm = med3(pl, pm, pn, compar);
+      pm = med3(pl, pm, pn, compar, arg);
     }
 
   swap(base, pm);
-  pa = pb = (FAR char *)base + width;
+  pa = pb = base + width;
 
-  pc = pd = (FAR char *)base + (nel - 1) * width;
+  pc = pd = base + (nel - 1) * width;
   for (; ; )
     {
-      while (pb <= pc && (r = compar(pb, base)) <= 0)
+      while (pb <= pc && (ret = cmp(pb, base)) <= 0)
         {
-          if (r == 0)
+          if (ret == 0)
             {
-              swap_cnt = 1;
+              swapped = true;
               swap(pa, pb);
               pa += width;
             }
@@ -231,11 +306,11 @@ loop:
           pb += width;
         }
 
-      while (pb <= pc && (r = compar(pc, base)) >= 0)
+      while (pb <= pc && (ret = cmp(pc, base)) >= 0)
         {
-          if (r == 0)
+          if (ret == 0)
             {
-              swap_cnt = 1;
+              swapped = true;
               swap(pc, pd);
               pd -= width;
             }
@@ -249,48 +324,304 @@ loop:
         }
 
       swap(pb, pc);
-      swap_cnt = 1;
-      pb      += width;
-      pc      -= width;
+      swapped = true;
+      pb     += width;
+      pc     -= width;
     }
 
-  if (swap_cnt == 0)
+  pn = base + nel * width;
+  r  = MIN(pa - base, pb - pa);
+  vecswap(base, pb - r, r);
+
+  r  = MIN(pd - pc, pn - pd - width);
+  vecswap(pb, pn - r, r);
+
+  *lnel = (pb - pa) / width;
+  *rnel = (pd - pc) / width;
+  return !swapped;
+}
+
+/****************************************************************************
+ * Name: qsort_loop
+ *
+ * Description:
+ *   The introsort: quicksort down to depth levels, then heapsort.  The
+ *   smaller part is sorted by recursion and the larger one by iteration,
+ *   so that the stack grows with log2(nel) at most.
+ *
+ ****************************************************************************/
+
+static void qsort_loop(FAR char *base, size_t nel, size_t width,
+                       qsort_compar_t compar, FAR void *arg, int depth)
+{
+  FAR char *right;
+  size_t lnel;
+  size_t rnel;
+  int swaptype;
+  bool sorted;
+
+  SWAPINIT(base, width);
+
+  while (nel >= 7)
     {
-      /* Switch to insertion sort */
+      if (depth-- == 0)
+        {
+          qsort_heap(base, nel, width, swaptype, compar, arg);
+          return;
+        }
+
+      sorted = qsort_partition(base, nel, width, swaptype, compar, arg,
+                               &lnel, &rnel);
+      right  = base + (nel - rnel) * width;
 
-      for (pm = (FAR char *)base + width;
-           pm < (FAR char *)base + nel * width;
-           pm += width)
+      /* The parts are likely in order already if the partition didn't
+       * swap anything: try the insertion sort, given up after as many
+       * moves as elements, so that it costs no more than the partition.
+       */
+
+      if (sorted &&
+          qsort_insertion(base, lnel, width, swaptype, compar, arg,
+                          lnel) &&
+          qsort_insertion(right, rnel, width, swaptype, compar, arg,
+                          rnel))
         {
-          for (pl = pm;
-               pl > (FAR char *)base && compar(pl - width, pl) > 0;
-               pl -= width)
-            {
-              swap(pl, pl - width);
-            }
+          return;
         }
 
-      return;
+      if (lnel < rnel)
+        {
+          qsort_loop(base, lnel, width, compar, arg, depth);
+          base = right;
+          nel  = rnel;
+        }
+      else
+        {
+          qsort_loop(right, rnel, width, compar, arg, depth);
+          nel  = lnel;
+        }
     }
 
-  pn = (FAR char *)base + nel * width;
-  r  = MIN(pa - (FAR char *)base, pb - pa);
-  vecswap(base, pb - r, r);
+  qsort_insertion(base, nel, width, swaptype, compar, arg, 0);
+}
 
-  r  = MIN(pd - pc, pn - pd - width);
-  vecswap(pb, pn - r, r);
+/****************************************************************************
+ * Name: qsort_depth
+ *
+ * Description:
+ *   Return the depth after which the quicksort turns to the heapsort,
+ *   twice log2(nel).
+ *
+ ****************************************************************************/
+
+static int qsort_depth(size_t nel)
+{
+  int depth = 0;
+
+  while (nel > 1)
+    {
+      nel >>= 1;
+      depth += 2;
+    }
+
+  return depth;
+}
+
+static int qsort_compar(FAR const void *a, FAR const void *b, FAR void *arg)
+{
+  FAR CODE int (**compar)(FAR const void *, FAR const void *) = arg;
+
+  return (*compar)(a, b);
+}
+
+#ifdef CONFIG_LIBC_QSORT_PARALLEL
+static void qsort_worker(FAR void *arg)
+{
+  FAR struct qsort_job_s *job = arg;
+
+  qsort_r(job->base, job->nel, job->width, job->compar, job->arg);
+  nxsem_post(job->done);
+}
+#endif
+
+/****************************************************************************
+ * Public Function
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: qsort_r
+ *
+ * Description:
+ *   The qsort_r() function is the same as qsort(), except that the
+ *   comparison function takes a third argument, arg, passed unchanged from
+ *   the caller.
+ *
+ *   The sort is an introsort: the quicksort of Bentley & McIlroy, which
+ *   handles the duplicate elements with the three-way partition, gives up
+ *   on the heapsort past 2 * log2(nel) levels so that the worst case is
+ *   O(n log n), and tries the insertion sort on the partitions that were
+ *   found in order.
+ *
+ * Returned Value:
+ *   The qsort_r() function will not return a value.
+ *
+ ****************************************************************************/
+
+void qsort_r(FAR void *base, size_t nel, size_t width,
+             CODE int (*compar)(FAR const void *, FAR const void *,
+                                FAR void *),
+             FAR void *arg)
+{
+  if (nel > 1 && width > 0)
+    {
+      qsort_loop(base, nel, width, compar, arg, qsort_depth(nel));
+    }
+}
+
+/****************************************************************************
+ * Name: qsort
+ *
+ * Description:
+ *   The qsort() function will sort an array of 'nel' objects, the initial
+ *   element of which is pointed to by 'base'. The size of each object, in
+ *   bytes, is specified by the 'width" argument. If the 'nel' argument has
+ *   the value zero, the comparison function pointed to by 'compar' will not
+ *   be called and no rearrangement will take place.
+ *
+ *   The application will ensure that the comparison function pointed to by
+ *   'compar' does not alter the contents of the array. The implementation
+ *   may reorder elements of the array between calls to the comparison
+ *   function, but will not alter the contents of any individual element.
+ *
+ *   When the same objects (consisting of 'width" bytes, irrespective of
+ *   their current positions in the array) are passed more than once to
+ *   the comparison function, the results will be consistent with one
+ *   another. That is, they will define a total ordering on the array.
+ *
+ *   The contents of the array will be sorted in ascending order according
+ *   to a comparison function. The 'compar' argument is a pointer to the
+ *   comparison function, which is called with two arguments that point to
+ *   the elements being compared. The application will ensure that the
+ *   function returns an integer less than, equal to, or greater than 0,
+ *   if the first argument is considered respectively less than, equal to,
+ *   or greater than the second. If two members compare as equal, their
+ *   order in the sorted array is unspecified.
+ *
+ *   (Based on description from OpenGroup.org).
+ *
+ * Returned Value:
+ *   The qsort() function will not return a value.
+ *
+ * Notes from the original BSD version:
+ *   Qsort routine from Bentley & McIlroy's "Engineering a Sort Function".
+ *
+ ****************************************************************************/
+
+void qsort(FAR void *base, size_t nel, size_t width,
+           CODE int(*compar)(FAR const void *, FAR const void *))
+{
+  qsort_r(base, nel, width, qsort_compar, &compar);
+}
+
+#ifdef CONFIG_LIBC_QSORT_PARALLEL
+/****************************************************************************
+ * Name: qsort_parallel
+ *
+ * Description:
+ *   The qsort_parallel() function is the same as qsort_r(), but it sorts
+ *   the large arrays on several CPUs.  The array is partitioned in up to
+ *   CONFIG_SMP_NCPUS parts of at least CONFIG_LIBC_QSORT_PARALLEL_MIN
+ *   elements, all of them but one are sorted by the low priority work
+ *   queue, and the last one by the caller, which waits for the others.
+ *
+ *   The comparison function is called from several threads at once.
+ *
+ * Returned Value:
+ *   The qsort_parallel() function will not return a value.
+ *
+ ****************************************************************************/
+
+void qsort_parallel(FAR void *base, size_t nel, size_t width,
+                    CODE int (*compar)(FAR const void *, FAR const void *,
+                                       FAR void *),
+                    FAR void *arg)
+{
+  struct qsort_job_s jobs[CONFIG_SMP_NCPUS];
+  sem_t done;
+  size_t lnel;
+  size_t rnel;
+  int swaptype;
+  int njobs = 1;
+  int queued = 0;
+  int large;
+  int i;
+
+  SWAPINIT(base, width);
+
+  jobs[0].base = base;
+  jobs[0].nel  = nel;
 
-  if ((r = pb - pa) > width)
+  /* Split the largest part until there is one for each CPU */
+
+  while (njobs < CONFIG_SMP_NCPUS)
     {
-      qsort(base, r / width, width, compar);
+      large = 0;
+      for (i = 1; i < njobs; i++)
+        {
+          if (jobs[i].nel > jobs[large].nel)
+            {
+              large = i;
+            }
+        }
+
+      if (jobs[large].nel < CONFIG_LIBC_QSORT_PARALLEL_MIN ||
+          jobs[large].nel < 7)
+        {
+          break;
+        }
+
+      qsort_partition(jobs[large].base, jobs[large].nel, width, swaptype,
+                      compar, arg, &lnel, &rnel);
+
+      jobs[njobs].base = jobs[large].base + (jobs[large].nel - rnel) *
+                         width;
+      jobs[njobs].nel  = rnel;
+      jobs[large].nel  = lnel;
+      njobs++;
     }
 
-  if ((r = pd - pc) > width)
+  nxsem_init(&done, 0, 0);
+
+  for (i = 1; i < njobs; i++)
     {
-      /* Iterate rather than recurse to save stack space */
+      jobs[i].width  = width;
+      jobs[i].compar = compar;
+      jobs[i].arg    = arg;
+      jobs[i].done   = &done;
+      memset(&jobs[i].work, 0, sizeof(jobs[i].work));
+
+      if (jobs[i].nel > 1 &&
+          work_queue(LPWORK, &jobs[i].work, qsort_worker, &jobs[i], 0) >= 0)
+        {
+          queued++;
+        }
+      else
+        {
+          qsort_r(jobs[i].base, jobs[i].nel, width, compar, arg);
+        }
+    }
+
+  qsort_r(jobs[0].base, jobs[0].nel, width, compar, arg);
 
-      base = pn - r;
-      nel = r / width;
-      goto loop;
+  /* The jobs are on the stack, wait for all of them whatever happens */
+
+  while (queued > 0)
+    {
+      if (nxsem_wait(&done) >= 0)
+        {
+          queued--;
+        }
     }
+
+  nxsem_destroy(&done);
 }
+#endif
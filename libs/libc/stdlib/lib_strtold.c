@@ -41,6 +41,8 @@
 #include <errno.h>
 #include <math.h>
 
+#include "libc.h"
+
 /****************************************************************************
  * Pre-processor definitions
  ****************************************************************************/
@@ -84,6 +86,15 @@
 #  define llong_min LONG_MIN
 #endif
 
+/* The fast path needs the operations to be rounded to their type, which
+ * the x87 doesn't do.
+ */
+
+#if defined(CONFIG_LIBC_STRTO_FAST) && defined(FLT_EVAL_METHOD) && \
+    FLT_EVAL_METHOD == 0
+#  define HAVE_FASTFLOAT
+#endif
+
 #define shgetc(f) (*(f)++)
 #define shunget(f) ((f)--)
 #define ifexist(a,b) do { if ((a) != NULL) {*(a) = (b);} } while (0)
@@ -619,6 +630,162 @@ static long_double hexfloat(FAR char *ptr,
   return scalbnx(y, 2., e2);
 }
 
+#ifdef HAVE_FASTFLOAT
+
+/****************************************************************************
+ * Name: fastfloat
+ *
+ * Description:
+ *   Convert a decimal string to a float or a double, when the significand
+ *   has at most 19 digits and the value is exact in the type, with a power
+ *   of ten that is exact too.  One multiplication or division gives then
+ *   the correctly rounded result.
+ *
+ * Input Parameters:
+ *   ptr    - A decimal string
+ *   endptr - If have ,the part that holds all but the numbers
+ *   flag   - 1: string -> float
+ *            2: string -> double
+ *   result - The value converted
+ *
+ * Returned Value:
+ *   True if converted, false to go the slow path.
+ *
+ ****************************************************************************/
+
+static bool fastfloat(FAR char *ptr, FAR char **endptr, int flag,
+                      FAR long_double *result)
+{
+  static const double p10s[] =
+    {
+      1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+      1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+  static const uint64_t u10s[] =
+    {
+      1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull,
+      10000000ull, 100000000ull, 1000000000ull, 10000000000ull,
+      100000000000ull, 1000000000000ull, 10000000000000ull,
+      100000000000000ull, 1000000000000000ull, 10000000000000000ull,
+      100000000000000000ull, 1000000000000000000ull
+    };
+
+  FAR char *f = ptr;
+  FAR char *digits;
+  uint64_t w;
+  size_t ndigit;
+  size_t n;
+  int e10 = 0;
+  int e = 0;
+  bool neg = false;
+
+  /* The integer part, without the leading zeros */
+
+  while (*f == '0')
+    {
+      f++;
+    }
+
+  digits = f;
+  while (isdigit(*f))
+    {
+      f++;
+    }
+
+  ndigit = f - digits;
+  if (ndigit > 19)
+    {
+      return false;
+    }
+
+  w = lib_decdigits(digits, ndigit);
+
+  /* The fraction, the zeros are only significant after another digit */
+
+  if (*f == '.')
+    {
+      f++;
+      if (ndigit == 0)
+        {
+          while (*f == '0')
+            {
+              f++;
+              e10--;
+            }
+        }
+
+      digits = f;
+      while (isdigit(*f))
+        {
+          f++;
+        }
+
+      n = f - digits;
+      if (ndigit + n > 19)
+        {
+          return false;
+        }
+
+      w = w * u10s[n] + lib_decdigits(digits, n);
+      ndigit += n;
+      e10 -= n;
+    }
+
+  if ((*f | 32) == 'e' && (isdigit(f[1]) || ((f[1] == '+' || f[1] == '-')
+                                            && isdigit(f[2]))))
+    {
+      f++;
+      if (*f == '+' || *f == '-')
+        {
+          neg = *f++ == '-';
+        }
+
+      while (isdigit(*f))
+        {
+          if (e < 10000)
+            {
+              e = e * 10 + *f - '0';
+            }
+
+          f++;
+        }
+
+      e10 += neg ? -e : e;
+    }
+
+  n = e10 < 0 ? -e10 : e10;
+  if (w == 0)
+    {
+      ifexist(endptr, f);
+      *result = 0.;
+      return true;
+    }
+
+  if (flag == 1 && w <= (1ull << FLT_MANT_DIG) && n <= 10)
+    {
+      float y = (float)w;
+
+      y = e10 < 0 ? y / (float)p10s[n] : y * (float)p10s[n];
+      *result = y;
+    }
+  else if (flag == 2 && w <= (1ull << DBL_MANT_DIG) && n <= 22)
+    {
+      double y = (double)w;
+
+      y = e10 < 0 ? y / p10s[n] : y * p10s[n];
+      *result = y;
+    }
+  else
+    {
+      return false;
+    }
+
+  ifexist(endptr, f);
+  return true;
+}
+#endif
+
 /****************************************************************************
  * Name: strtox
  *
@@ -719,7 +886,12 @@ static long_double strtox(FAR const char *str, FAR char **endptr, int flag)
     }
   else if (isdigit(*s) || (*s == '.' && isdigit(*(s + 1))))
     {
-      y = decfloat(s, endptr);
+#ifdef HAVE_FASTFLOAT
+      if (flag == 3 || !fastfloat(s, endptr, flag, &y))
+#endif
+        {
+          y = decfloat(s, endptr);
+        }
     }
   else
     {
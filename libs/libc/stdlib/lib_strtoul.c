@@ -60,6 +60,9 @@ unsigned long strtoul(FAR const char *nptr, FAR char **endptr, int base)
   int value = -1;
   int last_digit;
   char sign = 0;
+#ifdef CONFIG_LIBC_STRTO_FAST
+  uint64_t fast;
+#endif
 
   if (nptr)
     {
@@ -88,6 +91,18 @@ unsigned long strtoul(FAR const char *nptr, FAR char **endptr, int base)
           limit = ULONG_MAX / base;
           last_digit = ULONG_MAX % base;
 
+#ifdef CONFIG_LIBC_STRTO_FAST
+          /* Convert the decimal digits at once when they can't overflow,
+           * the loops below then stop on the first character.
+           */
+
+          if (base == 10 && lib_getdecimal(&nptr, ULONG_MAX, &fast))
+            {
+              accum = fast;
+              value = 0;
+            }
+#endif
+
           /* Accumulate each "digit" */
 
           while (lib_isbasedigit(*nptr, base, &value))
@@ -63,6 +63,9 @@ unsigned long long strtoull(FAR const char *nptr,
   int value;
   int last_digit;
   char sign = 0;
+#ifdef CONFIG_LIBC_STRTO_FAST
+  uint64_t fast;
+#endif
 
   if (nptr)
     {
@@ -92,6 +95,17 @@ unsigned long long strtoull(FAR const char *nptr,
           limit = ULLONG_MAX / base;
           last_digit = ULLONG_MAX % base;
 
+#ifdef CONFIG_LIBC_STRTO_FAST
+          /* Convert the decimal digits at once when they can't overflow,
+           * the loops below then stop on the first character.
+           */
+
+          if (base == 10 && lib_getdecimal(&nptr, ULLONG_MAX, &fast))
+            {
+              accum = fast;
+            }
+#endif
+
           /* Accumulate each "digit" */
 
           while (lib_isbasedigit(*nptr, base, &value))
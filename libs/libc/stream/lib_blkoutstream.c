@@ -37,6 +37,9 @@
 
 #ifndef CONFIG_DISABLE_MOUNTPOINT
 
+#define BLKOUTSTREAM_CACHESIZE(s) \
+  ((s)->geo.geo_sectorsize * CONFIG_STREAM_BLKOUT_CACHE_SECTORS)
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -50,12 +53,18 @@ static int blkoutstream_flush(FAR struct lib_outstream_s *self)
   FAR struct lib_blkoutstream_s *stream =
                                  (FAR struct lib_blkoutstream_s *)self;
   size_t sectorsize = stream->geo.geo_sectorsize;
+  size_t offset = self->nput % BLKOUTSTREAM_CACHESIZE(stream);
   int ret = OK;
 
-  if (self->nput % sectorsize > 0)
+  /* Write the cached sectors, the last one partially filled */
+
+  if (offset > 0)
     {
       ret = stream->inode->u.i_bops->write(stream->inode, stream->cache,
-                                           self->nput / sectorsize, 1);
+                                           (self->nput - offset) /
+                                           sectorsize,
+                                           (offset + sectorsize - 1) /
+                                           sectorsize);
     }
 
   return ret;
@@ -71,6 +80,7 @@ static int blkoutstream_puts(FAR struct lib_outstream_s *self,
   FAR struct lib_blkoutstream_s *stream =
                                  (FAR struct lib_blkoutstream_s *)self;
   size_t sectorsize = stream->geo.geo_sectorsize;
+  size_t cachesize = BLKOUTSTREAM_CACHESIZE(stream);
   FAR struct inode *inode = stream->inode;
   FAR const unsigned char *ptr = buf;
   size_t remain = len;
@@ -79,12 +89,29 @@ static int blkoutstream_puts(FAR struct lib_outstream_s *self,
   while (remain > 0)
     {
       size_t sblock = self->nput / sectorsize;
-      size_t offset = self->nput % sectorsize;
+      size_t offset = self->nput % cachesize;
+
+      if (offset == 0 && remain >= cachesize)
+        {
+          /* Write the whole cache sizes in place */
 
-      if (offset > 0)
+          size_t copyin = (remain / cachesize) * cachesize;
+
+          ret = inode->u.i_bops->write(inode, ptr, sblock,
+                                       copyin / sectorsize);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          ptr        += copyin;
+          self->nput += copyin;
+          remain     -= copyin;
+        }
+      else
         {
-          size_t copyin = offset + remain > sectorsize ?
-                          sectorsize - offset : remain;
+          size_t copyin = offset + remain > cachesize ?
+                          cachesize - offset : remain;
 
           memcpy(stream->cache + offset, ptr, copyin);
 
@@ -93,37 +120,18 @@ static int blkoutstream_puts(FAR struct lib_outstream_s *self,
           self->nput += copyin;
           remain     -= copyin;
 
-          if (offset == stream->geo.geo_sectorsize)
+          if (offset == cachesize)
             {
-              ret = inode->u.i_bops->write(inode, stream->cache, sblock, 1);
+              ret = inode->u.i_bops->write(inode, stream->cache,
+                                           (self->nput - cachesize) /
+                                           sectorsize,
+                                           cachesize / sectorsize);
               if (ret < 0)
                 {
                   return ret;
                 }
             }
         }
-      else if (remain < stream->geo.geo_sectorsize)
-        {
-          memcpy(stream->cache, ptr, remain);
-          self->nput += remain;
-          remain      = 0;
-        }
-      else if (remain >= stream->geo.geo_sectorsize)
-        {
-          size_t copyin = (remain / stream->geo.geo_sectorsize) *
-                                    stream->geo.geo_sectorsize;
-
-          ret = inode->u.i_bops->write(inode, ptr, sblock,
-                                       remain / stream->geo.geo_sectorsize);
-          if (ret < 0)
-            {
-              return ret;
-            }
-
-          ptr        += copyin;
-          self->nput += copyin;
-          remain     -= copyin;
-        }
     }
 
   return len;
@@ -221,7 +229,7 @@ int lib_blkoutstream_open(FAR struct lib_blkoutstream_s *stream,
       return -EINVAL;
     }
 
-  stream->cache = lib_malloc(stream->geo.geo_sectorsize);
+  stream->cache = lib_malloc(BLKOUTSTREAM_CACHESIZE(stream));
   if (stream->cache == NULL)
     {
       close_blockdriver(inode);
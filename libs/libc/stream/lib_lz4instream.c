@@ -0,0 +1,554 @@
+/****************************************************************************
+ * libs/libc/stream/lib_lz4instream.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <nuttx/streams.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define LZ4_FRAME_MAGIC     0x184d2204u
+#define LZ4_SKIP_MAGIC      0x184d2a50u
+#define LZ4_SKIP_MASK       0xfffffff0u
+
+/* FLG bits of the frame descriptor */
+
+#define LZ4_FLG_VERSION     0xc0
+#define LZ4_FLG_VERSION_1   0x40
+#define LZ4_FLG_B_INDEP     0x20
+#define LZ4_FLG_B_CHECKSUM  0x10
+#define LZ4_FLG_C_SIZE      0x08
+#define LZ4_FLG_C_CHECKSUM  0x04
+#define LZ4_FLG_DICTID      0x01
+
+/* Block size with the high bit set for an uncompressed block */
+
+#define LZ4_BLOCK_RAW       0x80000000u
+
+#define LZ4_MINMATCH        4
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lz4_get32
+ ****************************************************************************/
+
+static inline uint32_t lz4_get32(FAR const unsigned char *ptr)
+{
+  return ptr[0] | (ptr[1] << 8) | ((uint32_t)ptr[2] << 16) |
+         ((uint32_t)ptr[3] << 24);
+}
+
+/****************************************************************************
+ * Name: lz4_get_length
+ *
+ * Description:
+ *   Add the extra length bytes at *ip to len.  Returns -EINVAL if they go
+ *   beyond the end of the block.
+ *
+ ****************************************************************************/
+
+static int lz4_get_length(FAR const unsigned char *in, size_t inlen,
+                          FAR size_t *ip, FAR size_t *len)
+{
+  unsigned char byte;
+
+  do
+    {
+      if (*ip >= inlen)
+        {
+          return -EINVAL;
+        }
+
+      byte  = in[(*ip)++];
+      *len += byte;
+    }
+  while (byte == 255);
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: lz4_decompress
+ *
+ * Description:
+ *   Decompress the LZ4 block of inlen bytes into at most outlen bytes.
+ *   Returns the size of the output, or -EINVAL if the block is corrupted
+ *   or does not fit.
+ *
+ ****************************************************************************/
+
+static int lz4_decompress(FAR const unsigned char *in, size_t inlen,
+                          FAR unsigned char *out, size_t outlen)
+{
+  size_t ip = 0;
+  size_t op = 0;
+  size_t offset;
+  size_t lit;
+  size_t mlen;
+  unsigned char token;
+
+  for (; ; )
+    {
+      if (ip >= inlen)
+        {
+          return -EINVAL;
+        }
+
+      token = in[ip++];
+      lit   = token >> 4;
+      if (lit == 15 && lz4_get_length(in, inlen, &ip, &lit) < 0)
+        {
+          return -EINVAL;
+        }
+
+      if (lit > inlen - ip || lit > outlen - op)
+        {
+          return -EINVAL;
+        }
+
+      memcpy(out + op, in + ip, lit);
+      ip += lit;
+      op += lit;
+
+      /* The last sequence has the literals only */
+
+      if (ip == inlen)
+        {
+          return op;
+        }
+
+      if (inlen - ip < 2)
+        {
+          return -EINVAL;
+        }
+
+      offset = in[ip] | (in[ip + 1] << 8);
+      ip    += 2;
+      if (offset == 0 || offset > op)
+        {
+          return -EINVAL;
+        }
+
+      mlen = token & 15;
+      if (mlen == 15 && lz4_get_length(in, inlen, &ip, &mlen) < 0)
+        {
+          return -EINVAL;
+        }
+
+      mlen += LZ4_MINMATCH;
+      if (mlen > outlen - op)
+        {
+          return -EINVAL;
+        }
+
+      /* The match may overlap the output, when it repeats a pattern */
+
+      if (offset >= mlen)
+        {
+          memcpy(out + op, out + op - offset, mlen);
+          op += mlen;
+        }
+      else
+        {
+          for (; mlen > 0; mlen--, op++)
+            {
+              out[op] = out[op - offset];
+            }
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: lz4instream_read
+ *
+ * Description:
+ *   Read len bytes from the backend.  Returns the number of bytes read,
+ *   less than len only at the end of the backend, or a negated errno.
+ *
+ ****************************************************************************/
+
+static int lz4instream_read(FAR struct lib_lz4instream_s *stream,
+                            FAR void *buf, int len)
+{
+  FAR char *ptr = buf;
+  int total = 0;
+  int ret;
+
+  while (total < len)
+    {
+      ret = lib_stream_gets(stream->backend, ptr + total, len - total);
+      if (ret < 0)
+        {
+          return ret;
+        }
+      else if (ret == 0)
+        {
+          break;
+        }
+
+      total += ret;
+    }
+
+  return total;
+}
+
+/****************************************************************************
+ * Name: lz4instream_skip
+ ****************************************************************************/
+
+static int lz4instream_skip(FAR struct lib_lz4instream_s *stream,
+                            uint32_t len)
+{
+  int chunk;
+  int ret;
+
+  while (len > 0)
+    {
+      chunk = len > LZ4_STREAM_BLOCKSIZE ? LZ4_STREAM_BLOCKSIZE : len;
+      ret   = lz4instream_read(stream, stream->in, chunk);
+      if (ret < 0)
+        {
+          return ret;
+        }
+      else if (ret < chunk)
+        {
+          return -EINVAL;
+        }
+
+      len -= chunk;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: lz4instream_frame
+ *
+ * Description:
+ *   Read the header of the next frame, skipping the skippable frames.
+ *   Returns 1 when a frame starts, 0 at the end of the backend, or a
+ *   negated errno.
+ *
+ ****************************************************************************/
+
+static int lz4instream_frame(FAR struct lib_lz4instream_s *stream)
+{
+  unsigned char hdr[4];
+  uint32_t magic;
+  int extra;
+  int ret;
+
+  for (; ; )
+    {
+      ret = lz4instream_read(stream, hdr, 4);
+      if (ret <= 0)
+        {
+          return ret;
+        }
+      else if (ret < 4)
+        {
+          return -EINVAL;
+        }
+
+      magic = lz4_get32(hdr);
+      if ((magic & LZ4_SKIP_MASK) == LZ4_SKIP_MAGIC)
+        {
+          ret = lz4instream_read(stream, hdr, 4);
+          if (ret >= 0 && ret < 4)
+            {
+              ret = -EINVAL;
+            }
+
+          if (ret < 0 || (ret = lz4instream_skip(stream,
+                                                 lz4_get32(hdr))) < 0)
+            {
+              return ret;
+            }
+
+          continue;
+        }
+
+      if (magic != LZ4_FRAME_MAGIC)
+        {
+          return -EINVAL;
+        }
+
+      /* FLG and BD, then the optional content size and dictionary ID,
+       * then the header checksum.
+       */
+
+      ret = lz4instream_read(stream, hdr, 2);
+      if (ret >= 0 && ret < 2)
+        {
+          ret = -EINVAL;
+        }
+
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      if ((hdr[0] & LZ4_FLG_VERSION) != LZ4_FLG_VERSION_1)
+        {
+          return -EINVAL;
+        }
+
+      /* The stream keeps no history of the previous block, which linked
+       * blocks may refer to.
+       */
+
+      if ((hdr[0] & LZ4_FLG_B_INDEP) == 0)
+        {
+          return -ENOTSUP;
+        }
+
+      stream->flags = hdr[0];
+
+      extra = 1;
+      if (hdr[0] & LZ4_FLG_C_SIZE)
+        {
+          extra += 8;
+        }
+
+      if (hdr[0] & LZ4_FLG_DICTID)
+        {
+          extra += 4;
+        }
+
+      ret = lz4instream_skip(stream, extra);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      stream->started = true;
+      return 1;
+    }
+}
+
+/****************************************************************************
+ * Name: lz4instream_fill
+ *
+ * Description:
+ *   Decompress the next block into the output buffer.  Returns its size,
+ *   0 at the end of the backend, or a negated errno.
+ *
+ ****************************************************************************/
+
+static int lz4instream_fill(FAR struct lib_lz4instream_s *stream)
+{
+  unsigned char size[4];
+  uint32_t blksize;
+  int ret;
+
+  for (; ; )
+    {
+      if (!stream->started)
+        {
+          ret = lz4instream_frame(stream);
+          if (ret <= 0)
+            {
+              return ret;
+            }
+        }
+
+      ret = lz4instream_read(stream, size, 4);
+      if (ret >= 0 && ret < 4)
+        {
+          ret = -EINVAL;
+        }
+
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      /* The end mark, then the content checksum, ends the frame */
+
+      blksize = lz4_get32(size);
+      if (blksize == 0)
+        {
+          if (stream->flags & LZ4_FLG_C_CHECKSUM)
+            {
+              ret = lz4instream_skip(stream, 4);
+              if (ret < 0)
+                {
+                  return ret;
+                }
+            }
+
+          stream->started = false;
+          continue;
+        }
+
+      if ((blksize & ~LZ4_BLOCK_RAW) > LZ4_STREAM_BLOCKSIZE)
+        {
+          return -E2BIG;
+        }
+
+      ret = lz4instream_read(stream, blksize & LZ4_BLOCK_RAW ?
+                             stream->out : stream->in,
+                             blksize & ~LZ4_BLOCK_RAW);
+      if (ret >= 0 && ret < (blksize & ~LZ4_BLOCK_RAW))
+        {
+          ret = -EINVAL;
+        }
+
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      if ((blksize & LZ4_BLOCK_RAW) == 0)
+        {
+          ret = lz4_decompress(stream->in, blksize, stream->out,
+                               LZ4_STREAM_BLOCKSIZE);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+
+      stream->offset = 0;
+      stream->size   = ret;
+
+      /* The block checksum follows the data, skip it through the input
+       * buffer, which is free again.
+       */
+
+      if (stream->flags & LZ4_FLG_B_CHECKSUM)
+        {
+          ret = lz4instream_skip(stream, 4);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+
+      if (stream->size > 0)
+        {
+          return stream->size;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: lz4instream_gets
+ ****************************************************************************/
+
+static int lz4instream_gets(FAR struct lib_instream_s *self,
+                            FAR void *buf, int len)
+{
+  FAR struct lib_lz4instream_s *stream =
+                                 (FAR struct lib_lz4instream_s *)self;
+  FAR char *ptr = buf;
+  int total = 0;
+  int copyout;
+  int ret;
+
+  while (total < len)
+    {
+      if (stream->offset == stream->size)
+        {
+          ret = lz4instream_fill(stream);
+          if (ret <= 0)
+            {
+              if (total == 0)
+                {
+                  return ret;
+                }
+
+              break;
+            }
+        }
+
+      copyout = stream->size - stream->offset;
+      if (copyout > len - total)
+        {
+          copyout = len - total;
+        }
+
+      memcpy(ptr + total, stream->out + stream->offset, copyout);
+      stream->offset += copyout;
+      total          += copyout;
+    }
+
+  self->nget += total;
+  return total;
+}
+
+/****************************************************************************
+ * Name: lz4instream_getc
+ ****************************************************************************/
+
+static int lz4instream_getc(FAR struct lib_instream_s *self)
+{
+  unsigned char ch;
+
+  return lz4instream_gets(self, &ch, 1) == 1 ? ch : EOF;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lib_lz4instream
+ *
+ * Description:
+ *  LZ4 decompressing pipeline stream
+ *
+ * Input Parameters:
+ *   stream  - User allocated, uninitialized instance of struct
+ *                lib_lz4instream_s to be initialized.
+ *   backend - Stream backend port.
+ *
+ * Returned Value:
+ *   None (User allocated instance initialized).
+ *
+ ****************************************************************************/
+
+void lib_lz4instream(FAR struct lib_lz4instream_s *stream,
+                     FAR struct lib_instream_s *backend)
+{
+  if (stream == NULL || backend == NULL)
+    {
+      return;
+    }
+
+  memset(stream, 0, sizeof(*stream));
+  stream->common.getc = lz4instream_getc;
+  stream->common.gets = lz4instream_gets;
+  stream->backend     = backend;
+}
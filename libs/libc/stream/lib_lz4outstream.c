@@ -0,0 +1,374 @@
+/****************************************************************************
+ * libs/libc/stream/lib_lz4outstream.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <nuttx/streams.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Frame header: magic number, FLG with version 1 and independent blocks,
+ * BD with blocks of 64KiB at most, and the header checksum, which is the
+ * second byte of the XXH32 of FLG and BD.
+ */
+
+#define LZ4_FRAME_HDR_SIZE  7
+#define LZ4_FRAME_HDR       { 0x04, 0x22, 0x4d, 0x18, 0x60, 0x40, 0x82 }
+
+/* Block size with the high bit set for an uncompressed block */
+
+#define LZ4_BLOCK_RAW       0x80000000u
+
+/* The last match starts 12 bytes before the end of the block at least, and
+ * the last 5 bytes are literals.
+ */
+
+#define LZ4_MINMATCH        4
+#define LZ4_MFLIMIT         12
+#define LZ4_LASTLITERALS    5
+
+#define LZ4_HASH(v)         (((v) * 2654435761u) >> \
+                             (32 - CONFIG_STREAM_LZ4_HLOG))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lz4_read32
+ ****************************************************************************/
+
+static inline uint32_t lz4_read32(FAR const unsigned char *ptr)
+{
+  uint32_t value;
+
+  memcpy(&value, ptr, sizeof(value));
+  return value;
+}
+
+/****************************************************************************
+ * Name: lz4_put_length
+ ****************************************************************************/
+
+static FAR unsigned char *lz4_put_length(FAR unsigned char *op, size_t len)
+{
+  for (; len >= 255; len -= 255)
+    {
+      *op++ = 255;
+    }
+
+  *op++ = len;
+  return op;
+}
+
+/****************************************************************************
+ * Name: lz4_put_sequence
+ *
+ * Description:
+ *   Put the literals from anchor, then the match of length mlen at the
+ *   given offset, if mlen is not zero.  Returns NULL if it overflows oend.
+ *
+ ****************************************************************************/
+
+static FAR unsigned char *lz4_put_sequence(FAR unsigned char *op,
+                                           FAR unsigned char *oend,
+                                           FAR const unsigned char *anchor,
+                                           size_t lit, size_t offset,
+                                           size_t mlen)
+{
+  FAR unsigned char *token;
+
+  if (op + 1 + lit / 255 + 1 + lit + 2 + mlen / 255 + 1 > oend)
+    {
+      return NULL;
+    }
+
+  token  = op++;
+  *token = (lit >= 15 ? 15 : lit) << 4;
+  if (lit >= 15)
+    {
+      op = lz4_put_length(op, lit - 15);
+    }
+
+  memcpy(op, anchor, lit);
+  op += lit;
+
+  if (mlen > 0)
+    {
+      *op++ = offset & 0xff;
+      *op++ = offset >> 8;
+
+      mlen -= LZ4_MINMATCH;
+      if (mlen >= 15)
+        {
+          *token |= 15;
+          op = lz4_put_length(op, mlen - 15);
+        }
+      else
+        {
+          *token |= mlen;
+        }
+    }
+
+  return op;
+}
+
+/****************************************************************************
+ * Name: lz4_compress
+ *
+ * Description:
+ *   Compress the len bytes of the input buffer in an LZ4 block, by greedy
+ *   matching of a single hash probe.  Returns the size of the block, or 0
+ *   if it would not be smaller than the input.
+ *
+ ****************************************************************************/
+
+static size_t lz4_compress(FAR struct lib_lz4outstream_s *stream,
+                           size_t len)
+{
+  FAR const unsigned char *in = stream->in;
+  FAR unsigned char *op = stream->out;
+  FAR unsigned char *oend = stream->out + len;
+  size_t anchor = 0;
+  size_t ip = 0;
+  size_t ref;
+  size_t mlen;
+  uint32_t seq;
+  uint32_t hash;
+
+  /* The table holds the position plus one, 0 being no position */
+
+  memset(stream->table, 0, sizeof(stream->table));
+
+  while (ip + LZ4_MFLIMIT <= len)
+    {
+      seq  = lz4_read32(in + ip);
+      hash = LZ4_HASH(seq);
+      ref  = stream->table[hash];
+
+      stream->table[hash] = ip + 1;
+      if (ref == 0 || lz4_read32(in + ref - 1) != seq)
+        {
+          ip++;
+          continue;
+        }
+
+      /* Extend the match backward into the literals, then forward */
+
+      ref--;
+      while (ip > anchor && ref > 0 && in[ip - 1] == in[ref - 1])
+        {
+          ip--;
+          ref--;
+        }
+
+      mlen = LZ4_MINMATCH;
+      while (ip + mlen < len - LZ4_LASTLITERALS &&
+             in[ip + mlen] == in[ref + mlen])
+        {
+          mlen++;
+        }
+
+      op = lz4_put_sequence(op, oend, in + anchor, ip - anchor,
+                            ip - ref, mlen);
+      if (op == NULL)
+        {
+          return 0;
+        }
+
+      ip    += mlen;
+      anchor = ip;
+    }
+
+  op = lz4_put_sequence(op, oend, in + anchor, len - anchor, 0, 0);
+  return op != NULL ? op - stream->out : 0;
+}
+
+/****************************************************************************
+ * Name: lz4outstream_block
+ *
+ * Description:
+ *   Put the buffered input as a block, starting the frame if needed.
+ *
+ ****************************************************************************/
+
+static int lz4outstream_block(FAR struct lib_lz4outstream_s *stream)
+{
+  static const unsigned char header[LZ4_FRAME_HDR_SIZE] = LZ4_FRAME_HDR;
+  FAR const unsigned char *data;
+  unsigned char size[4];
+  uint32_t blksize;
+  int ret;
+
+  if (!stream->started)
+    {
+      ret = lib_stream_puts(stream->backend, header, sizeof(header));
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      stream->started = true;
+    }
+
+  blksize = lz4_compress(stream, stream->offset);
+  if (blksize > 0)
+    {
+      data = stream->out;
+    }
+  else
+    {
+      data    = stream->in;
+      blksize = stream->offset | LZ4_BLOCK_RAW;
+    }
+
+  size[0] = blksize & 0xff;
+  size[1] = (blksize >> 8) & 0xff;
+  size[2] = (blksize >> 16) & 0xff;
+  size[3] = blksize >> 24;
+
+  ret = lib_stream_puts(stream->backend, size, sizeof(size));
+  if (ret >= 0)
+    {
+      ret = lib_stream_puts(stream->backend, data,
+                            blksize & ~LZ4_BLOCK_RAW);
+    }
+
+  stream->offset = 0;
+  return ret < 0 ? ret : OK;
+}
+
+/****************************************************************************
+ * Name: lz4outstream_flush
+ ****************************************************************************/
+
+static int lz4outstream_flush(FAR struct lib_outstream_s *self)
+{
+  FAR struct lib_lz4outstream_s *stream =
+                                 (FAR struct lib_lz4outstream_s *)self;
+  static const unsigned char endmark[4];
+  int ret;
+
+  if (stream->offset > 0)
+    {
+      ret = lz4outstream_block(stream);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  /* End the frame, so that what is out so far can be decompressed */
+
+  if (stream->started)
+    {
+      ret = lib_stream_puts(stream->backend, endmark, sizeof(endmark));
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      stream->started = false;
+    }
+
+  return lib_stream_flush(stream->backend);
+}
+
+/****************************************************************************
+ * Name: lz4outstream_puts
+ ****************************************************************************/
+
+static int lz4outstream_puts(FAR struct lib_outstream_s *self,
+                             FAR const void *buf, int len)
+{
+  FAR struct lib_lz4outstream_s *stream =
+                                 (FAR struct lib_lz4outstream_s *)self;
+  FAR const char *ptr = buf;
+  size_t total = len;
+  size_t copyin;
+  int ret;
+
+  while (total > 0)
+    {
+      copyin = stream->offset + total > LZ4_STREAM_BLOCKSIZE ?
+               LZ4_STREAM_BLOCKSIZE - stream->offset : total;
+
+      memcpy(stream->in + stream->offset, ptr, copyin);
+
+      ptr            += copyin;
+      stream->offset += copyin;
+      self->nput     += copyin;
+      total          -= copyin;
+
+      if (stream->offset == LZ4_STREAM_BLOCKSIZE)
+        {
+          ret = lz4outstream_block(stream);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+    }
+
+  return len;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lib_lz4outstream
+ *
+ * Description:
+ *  LZ4 compressed pipeline stream
+ *
+ * Input Parameters:
+ *   stream  - User allocated, uninitialized instance of struct
+ *                lib_lz4outstream_s to be initialized.
+ *   backend - Stream backend port.
+ *
+ * Returned Value:
+ *   None (User allocated instance initialized).
+ *
+ ****************************************************************************/
+
+void lib_lz4outstream(FAR struct lib_lz4outstream_s *stream,
+                      FAR struct lib_outstream_s *backend)
+{
+  if (stream == NULL || backend == NULL)
+    {
+      return;
+    }
+
+  memset(stream, 0, sizeof(*stream));
+  stream->common.puts  = lz4outstream_puts;
+  stream->common.flush = lz4outstream_flush;
+  stream->backend      = backend;
+}
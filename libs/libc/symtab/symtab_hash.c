@@ -0,0 +1,289 @@
+/****************************************************************************
+ * libs/libc/symtab/symtab_hash.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/lib/lib.h>
+#include <nuttx/symtab.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define SYMTAB_BLOOM_BITS   (sizeof(uintptr_t) * 8)
+#define SYMTAB_BLOOM_SHIFT  6
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: symtab_hash_name
+ *
+ * Description:
+ *   The hash function of the ELF GNU hash section (DJB's).
+ *
+ ****************************************************************************/
+
+static uint32_t symtab_hash_name(FAR const char *name)
+{
+  FAR const unsigned char *ptr = (FAR const unsigned char *)name;
+  uint32_t h = 5381;
+
+  while (*ptr != '\0')
+    {
+      h = (h << 5) + h + *ptr++;
+    }
+
+  return h;
+}
+
+/****************************************************************************
+ * Name: symtab_hash_pow2
+ ****************************************************************************/
+
+static uint32_t symtab_hash_pow2(uint32_t n)
+{
+  uint32_t pow2 = 1;
+
+  while (pow2 < n)
+    {
+      pow2 <<= 1;
+    }
+
+  return pow2;
+}
+
+/****************************************************************************
+ * Name: symtab_hash_bloom
+ ****************************************************************************/
+
+static inline FAR uintptr_t *
+symtab_hash_bloom(FAR const struct symtab_hash_s *hash, uint32_t h,
+                  FAR uintptr_t *mask)
+{
+  *mask = ((uintptr_t)1 << (h % SYMTAB_BLOOM_BITS)) |
+          ((uintptr_t)1 << ((h >> SYMTAB_BLOOM_SHIFT) % SYMTAB_BLOOM_BITS));
+  return &hash->bloom[(h / SYMTAB_BLOOM_BITS) & (hash->nbloom - 1)];
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: symtab_hash_init
+ *
+ * Description:
+ *   Build the hash index of a symbol table.  If the index can't be
+ *   allocated, symtab_hash_find() still works with a linear search.
+ *
+ * Input Parameters:
+ *   hash   - The index to build
+ *   symtab - The symbol table, which must outlive the index
+ *   nsyms  - The number of symbols in the table
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int symtab_hash_init(FAR struct symtab_hash_s *hash,
+                     FAR const struct symtab_s *symtab, int nsyms)
+{
+  FAR uintptr_t *bloom;
+  uintptr_t mask;
+  uint32_t nsym;
+  uint32_t end;
+  uint32_t b;
+  uint32_t h;
+  uint32_t i;
+
+  DEBUGASSERT(hash != NULL && nsyms >= 0);
+
+  memset(hash, 0, sizeof(*hash));
+  hash->symtab = symtab;
+  hash->nsyms  = nsyms;
+  if (symtab == NULL || nsyms == 0)
+    {
+      return OK;
+    }
+
+  /* About eight bits of Bloom filter and half a bucket per symbol */
+
+  nsym           = nsyms;
+  hash->nbloom   = symtab_hash_pow2((nsym + 7) * 8 / SYMTAB_BLOOM_BITS);
+  hash->nbuckets = symtab_hash_pow2((nsym + 1) / 2);
+
+  hash->bloom = lib_zalloc(hash->nbloom * sizeof(uintptr_t) +
+                           (hash->nbuckets + 2 * nsym) * sizeof(uint32_t));
+  if (hash->bloom == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  hash->buckets = (FAR uint32_t *)(hash->bloom + hash->nbloom);
+  hash->chain   = hash->buckets + hash->nbuckets;
+  hash->order   = hash->chain + nsym;
+
+  /* Count the symbols of each bucket, keeping their hash in chain[] for
+   * now, then turn the counts into the ends of the buckets.
+   */
+
+  for (i = 0; i < nsym; i++)
+    {
+      h = symtab_hash_name(symtab[i].sym_name);
+      hash->chain[i] = h;
+      hash->buckets[h & (hash->nbuckets - 1)]++;
+
+      bloom = symtab_hash_bloom(hash, h, &mask);
+      *bloom |= mask;
+    }
+
+  for (b = 1; b < hash->nbuckets; b++)
+    {
+      hash->buckets[b] += hash->buckets[b - 1];
+    }
+
+  /* Sort the symbols by bucket, backwards so that the entries of a bucket
+   * keep the order of the table and buckets[] ends as their start.
+   */
+
+  for (i = nsym; i-- > 0; )
+    {
+      b = hash->chain[i] & (hash->nbuckets - 1);
+      hash->order[--hash->buckets[b]] = i;
+    }
+
+  for (i = 0; i < nsym; i++)
+    {
+      hash->chain[i] = symtab_hash_name(symtab[hash->order[i]].sym_name) &
+                       ~1;
+    }
+
+  /* Mark the last entry of each bucket, and the empty buckets */
+
+  for (b = 0; b < hash->nbuckets; b++)
+    {
+      end = b + 1 < hash->nbuckets ? hash->buckets[b + 1] : nsym;
+      if (end == hash->buckets[b])
+        {
+          hash->buckets[b] = UINT32_MAX;
+        }
+      else
+        {
+          hash->chain[end - 1] |= 1;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: symtab_hash_uninit
+ *
+ * Description:
+ *   Free the hash index.  The symbol table is not freed.
+ *
+ ****************************************************************************/
+
+void symtab_hash_uninit(FAR struct symtab_hash_s *hash)
+{
+  lib_free(hash->bloom);
+  memset(hash, 0, sizeof(*hash));
+}
+
+/****************************************************************************
+ * Name: symtab_hash_find
+ *
+ * Description:
+ *   Find the symbol with the matching name through the hash index.
+ *
+ * Returned Value:
+ *   A reference to the symbol table entry if an entry with the matching
+ *   name is found; NULL is returned if the entry is not found.
+ *
+ ****************************************************************************/
+
+FAR const struct symtab_s *
+symtab_hash_find(FAR const struct symtab_hash_s *hash,
+                 FAR const char *name)
+{
+  FAR const struct symtab_s *symbol;
+  FAR uintptr_t *bloom;
+  uintptr_t mask;
+  uint32_t h;
+  uint32_t i;
+
+  DEBUGASSERT(hash != NULL && name != NULL);
+
+  if (hash->bloom == NULL)
+    {
+      return symtab_findbyname(hash->symtab, name, hash->nsyms);
+    }
+
+#ifdef CONFIG_SYMTAB_DECORATED
+  if (name[0] == '_')
+    {
+      name++;
+    }
+#endif
+
+  h = symtab_hash_name(name);
+  bloom = symtab_hash_bloom(hash, h, &mask);
+  if ((*bloom & mask) != mask)
+    {
+      return NULL;
+    }
+
+  i = hash->buckets[h & (hash->nbuckets - 1)];
+  if (i == UINT32_MAX)
+    {
+      return NULL;
+    }
+
+  for (; ; i++)
+    {
+      if (((hash->chain[i] ^ h) >> 1) == 0)
+        {
+          symbol = &hash->symtab[hash->order[i]];
+          if (strcmp(name, symbol->sym_name) == 0)
+            {
+              return symbol;
+            }
+        }
+
+      if ((hash->chain[i] & 1) != 0)
+        {
+          return NULL;
+        }
+    }
+}
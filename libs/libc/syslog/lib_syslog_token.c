@@ -0,0 +1,227 @@
+/****************************************************************************
+ * libs/libc/syslog/lib_syslog_token.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <string.h>
+#include <syslog.h>
+#include <resolv.h>
+
+#include <nuttx/syslog/syslog_token.h>
+
+#include "syslog/syslog.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Room for the base64 encoding of the message and its terminator */
+
+#define SYSLOG_TOKEN_TEXTSIZE \
+  ((CONFIG_SYSLOG_TOKENIZED_BUFSIZE + 2) / 3 * 4 + 1)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct syslog_token_s
+{
+  uint8_t buffer[CONFIG_SYSLOG_TOKENIZED_BUFSIZE];
+  size_t  length;
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syslog_token_put
+ ****************************************************************************/
+
+static void syslog_token_put(FAR struct syslog_token_s *msg,
+                             FAR const void *data, size_t len)
+{
+  if (len > sizeof(msg->buffer) - msg->length)
+    {
+      len = sizeof(msg->buffer) - msg->length;
+    }
+
+  memcpy(msg->buffer + msg->length, data, len);
+  msg->length += len;
+}
+
+/****************************************************************************
+ * Name: syslog_token_uint
+ ****************************************************************************/
+
+static void syslog_token_uint(FAR struct syslog_token_s *msg,
+                              uint64_t value)
+{
+  uint8_t data[10];
+  size_t len = 0;
+
+  do
+    {
+      data[len] = value & 0x7f;
+      value >>= 7;
+      if (value != 0)
+        {
+          data[len] |= 0x80;
+        }
+
+      len++;
+    }
+  while (value != 0);
+
+  /* A truncated number would be decoded wrong, drop it whole */
+
+  if (len <= sizeof(msg->buffer) - msg->length)
+    {
+      syslog_token_put(msg, data, len);
+    }
+  else
+    {
+      msg->length = sizeof(msg->buffer);
+    }
+}
+
+/****************************************************************************
+ * Name: syslog_token_sint
+ ****************************************************************************/
+
+static void syslog_token_sint(FAR struct syslog_token_s *msg, int64_t value)
+{
+  syslog_token_uint(msg, ((uint64_t)value << 1) ^ (uint64_t)(value >> 63));
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syslog_tokenized
+ *
+ * Description:
+ *   Log a tokenized message.  This is the back end of syslog_token(), it
+ *   is not meant to be called directly.
+ *
+ * Input Parameters:
+ *   priority - The priority of the message
+ *   token    - The token of the format
+ *   types    - The types of the arguments
+ *   ...      - The arguments
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void syslog_tokenized(int priority, uint32_t token, uint32_t types, ...)
+{
+  struct syslog_token_s msg;
+  char text[SYSLOG_TOKEN_TEXTSIZE];
+  size_t count;
+  size_t i;
+  va_list ap;
+
+  /* Check if this priority is enabled before doing any work */
+
+  if ((g_syslog_mask & LOG_MASK(priority)) == 0)
+    {
+      return;
+    }
+
+  msg.buffer[0] = token;
+  msg.buffer[1] = token >> 8;
+  msg.buffer[2] = token >> 16;
+  msg.buffer[3] = token >> 24;
+  msg.length    = 4;
+
+  syslog_token_uint(&msg, types);
+
+  count = SYSLOG_TOKEN_GET_COUNT(types);
+  va_start(ap, types);
+
+  for (i = 0; i < count; i++)
+    {
+      switch (SYSLOG_TOKEN_GET_TYPE(types, i))
+        {
+          case SYSLOG_TOKEN_INT32:
+            syslog_token_sint(&msg, va_arg(ap, int32_t));
+            break;
+
+          case SYSLOG_TOKEN_INT64:
+            syslog_token_sint(&msg, va_arg(ap, int64_t));
+            break;
+
+          case SYSLOG_TOKEN_DOUBLE:
+            {
+#ifdef CONFIG_HAVE_DOUBLE
+              double value = va_arg(ap, double);
+#else
+              uint64_t value = va_arg(ap, uint64_t);
+#endif
+
+              syslog_token_put(&msg, &value, sizeof(value));
+            }
+            break;
+
+          case SYSLOG_TOKEN_STRING:
+            {
+              FAR const char *value = va_arg(ap, FAR const char *);
+              size_t room = sizeof(msg.buffer) - msg.length;
+              size_t len;
+
+              if (value == NULL)
+                {
+                  value = "(null)";
+                }
+
+              /* Long strings are cut to the room left after their
+               * length, which takes up to two bytes.
+               */
+
+              room = room > 2 ? room - 2 : 0;
+              len = strlen(value);
+              if (len > room)
+                {
+                  len = room;
+                }
+
+              syslog_token_uint(&msg, len);
+              syslog_token_put(&msg, value, len);
+            }
+            break;
+        }
+    }
+
+  va_end(ap);
+
+  b64_ntop(msg.buffer, msg.length, text, sizeof(text));
+  syslog(priority, "$%s", text);
+}
@@ -0,0 +1,120 @@
+/****************************************************************************
+ * libs/libc/time/lib_clock_gettime.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <stdbool.h>
+#include <time.h>
+
+#include <nuttx/atomic.h>
+#include <nuttx/clock.h>
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifndef __KERNEL__
+/* The clock state published by the kernel through us_clock */
+
+struct clock_user_s g_clock_user;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifndef __KERNEL__
+static bool clock_user_gettime(clockid_t clock_id, FAR struct timespec *tp)
+{
+  struct timespec base;
+  clock_t ticks;
+  uint32_t seq;
+
+  do
+    {
+      seq = g_clock_user.seq;
+      atomic_thread_fence(memory_order_acquire);
+
+      ticks        = g_clock_user.ticks;
+      base.tv_sec  = g_clock_user.base_sec;
+      base.tv_nsec = g_clock_user.base_nsec;
+
+      atomic_thread_fence(memory_order_acquire);
+    }
+  while ((seq & 1) != 0 || seq != g_clock_user.seq);
+
+  /* Nothing is published before the kernel starts the clock */
+
+  if (seq == 0)
+    {
+      return false;
+    }
+
+  clock_ticks2time(tp, ticks);
+  if (clock_id == CLOCK_REALTIME)
+    {
+      clock_timespec_add(&base, tp, tp);
+    }
+
+  return true;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: clock_gettime
+ *
+ * Description:
+ *   Get the current value of the specified time clock.  The user space
+ *   reads CLOCK_MONOTONIC, CLOCK_BOOTTIME and CLOCK_REALTIME from the
+ *   state the kernel publishes at every tick, the other clocks and the
+ *   kernel itself go to nxclock_gettime().
+ *
+ ****************************************************************************/
+
+int clock_gettime(clockid_t clock_id, FAR struct timespec *tp)
+{
+  if (tp == NULL || clock_id < 0 || clock_id > CLOCK_BOOTTIME)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+#ifndef __KERNEL__
+  if ((clock_id == CLOCK_MONOTONIC || clock_id == CLOCK_BOOTTIME ||
+       clock_id == CLOCK_REALTIME) && clock_user_gettime(clock_id, tp))
+    {
+      return OK;
+    }
+#endif
+
+  nxclock_gettime(clock_id, tp);
+  return OK;
+}
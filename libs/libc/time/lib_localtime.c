@@ -273,6 +273,19 @@ struct state_s
    */
 
   int defaulttype;
+
+  /* The cache of localsub(): the transition window of the last time
+   * converted, so that the next ones in the same window don't search the
+   * transitions, and the broken-down local midnight of its day, so that
+   * the times of the same day are converted with a few divisions.
+   */
+
+  time_t cache_start;         /* First time of the window */
+  time_t cache_end;           /* Last time of the window */
+  int cache_type;             /* Time type of the window, -1 if none */
+  int_fast32_t cache_utoff;   /* UT offset of cache_tm */
+  time_t cache_day;           /* Local midnight of cache_tm, in UT */
+  struct tm cache_tm;         /* The midnight broken down */
 };
 
 struct rule_s
@@ -1999,9 +2012,16 @@ static FAR struct tm *localsub(FAR const time_t *timep,
       return result;
     }
 
-  if (sp->timecnt == 0 || t < sp->ats[0])
+  if (sp->cache_type >= 0 && t >= sp->cache_start && t <= sp->cache_end)
+    {
+      i = sp->cache_type;
+    }
+  else if (sp->timecnt == 0 || t < sp->ats[0])
     {
       i = sp->defaulttype;
+      sp->cache_type  = i;
+      sp->cache_start = TIME_T_MIN;
+      sp->cache_end   = sp->timecnt == 0 ? TIME_T_MAX : sp->ats[0] - 1;
     }
   else
     {
@@ -2023,17 +2043,57 @@ static FAR struct tm *localsub(FAR const time_t *timep,
         }
 
       i = sp->types[lo - 1];
+      sp->cache_type  = i;
+      sp->cache_start = sp->ats[lo - 1];
+      if (lo < sp->timecnt)
+        {
+          sp->cache_end = sp->ats[lo] - 1;
+        }
+      else
+        {
+          sp->cache_end = sp->goahead ? sp->ats[lo - 1] : TIME_T_MAX;
+        }
     }
 
   ttisp = &sp->ttis[i];
 
-  /* To get (wrong) behavior that's compatible with System V Release 2.0
-   * you'd replace the statement below with
-   *    t += ttisp->tt_utoff;
-   *    timesub(&t, 0L, sp, tmp);
+  /* Without leap seconds, a time of the day of the last conversion with
+   * the same UT offset is its midnight plus the seconds elapsed.
    */
 
-  result = timesub(&t, ttisp->tt_utoff, sp, tmp);
+  if (sp->leapcnt == 0 && sp->cache_utoff == ttisp->tt_utoff &&
+      t >= sp->cache_day && t - sp->cache_day < SECSPERDAY)
+    {
+      int_fast32_t secs = t - sp->cache_day;
+
+      *tmp = sp->cache_tm;
+      tmp->tm_hour = secs / SECSPERHOUR;
+      tmp->tm_min  = secs / SECSPERMIN % MINSPERHOUR;
+      tmp->tm_sec  = secs % SECSPERMIN;
+      result = tmp;
+    }
+  else
+    {
+      /* To get (wrong) behavior that's compatible with System V Release
+       * 2.0 you'd replace the statement below with
+       *    t += ttisp->tt_utoff;
+       *    timesub(&t, 0L, sp, tmp);
+       */
+
+      result = timesub(&t, ttisp->tt_utoff, sp, tmp);
+      if (result != NULL && sp->leapcnt == 0)
+        {
+          sp->cache_tm = *result;
+          sp->cache_tm.tm_hour = 0;
+          sp->cache_tm.tm_min  = 0;
+          sp->cache_tm.tm_sec  = 0;
+          sp->cache_utoff = ttisp->tt_utoff;
+          sp->cache_day   = t - (result->tm_hour * SECSPERHOUR +
+                                 result->tm_min * SECSPERMIN +
+                                 result->tm_sec);
+        }
+    }
+
   if (result != NULL)
     {
       result->tm_isdst = ttisp->tt_isdst;
@@ -2731,6 +2791,11 @@ static time_t time1(FAR struct tm *tmp,
 
 static int zoneinit(FAR const char *name)
 {
+  /* The conversions cached were of the previous zone */
+
+  g_lcl_ptr->cache_type = -1;
+  g_lcl_ptr->cache_day  = TIME_T_MAX;
+
   if (name != NULL && name[0] == '\0')
     {
       /* User wants it fast rather than right */
@@ -0,0 +1,350 @@
+/****************************************************************************
+ * libs/libdsp/lib_batch.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <dsp.h>
+
+/* The kernels below handle the frames of several motors, or several
+ * samples, in one call.  The loops have no branches and no calls, so that
+ * the compiler vectorizes the transforms and the SVM duty cycles for the
+ * SIMD unit of the core (NEON, Helium) when it has one: the frames are
+ * loaded with the interleaving loads of the unit, and the if-else are
+ * turned into selects.  The PI controllers, each with its own structure,
+ * are not vectorized.
+ */
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* SVM sector by the signs of i, j and k, as in svm3_sector_get() */
+
+static const uint8_t g_svm3_sector[8] =
+{
+  2, 6, 2, 1, 4, 5, 3, 5
+};
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: clarke_transform_batch
+ *
+ * Description:
+ *   Clarke transform (abc frame -> ab frame) of n frames.
+ *
+ * Input Parameters:
+ *   abc - (in) pointer to the abc frames
+ *   ab  - (out) pointer to the alpha-beta frames
+ *   n   - number of frames
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void clarke_transform_batch(FAR const abc_frame_f32_t *abc,
+                            FAR ab_frame_f32_t *ab, size_t n)
+{
+  size_t i;
+
+  LIBDSP_DEBUGASSERT(abc != NULL);
+  LIBDSP_DEBUGASSERT(ab != NULL);
+
+  for (i = 0; i < n; i++)
+    {
+      float a = abc[i].a;
+      float b = abc[i].b;
+
+      ab[i].a = a;
+      ab[i].b = ONE_BY_SQRT3_F*a + TWO_BY_SQRT3_F*b;
+    }
+}
+
+/****************************************************************************
+ * Name: inv_clarke_transform_batch
+ *
+ * Description:
+ *   Inverse Clarke transform (ab frame -> abc frame) of n frames.
+ *
+ * Input Parameters:
+ *   ab  - (in) pointer to the alpha-beta frames
+ *   abc - (out) pointer to the abc frames
+ *   n   - number of frames
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void inv_clarke_transform_batch(FAR const ab_frame_f32_t *ab,
+                                FAR abc_frame_f32_t *abc, size_t n)
+{
+  size_t i;
+
+  LIBDSP_DEBUGASSERT(ab != NULL);
+  LIBDSP_DEBUGASSERT(abc != NULL);
+
+  for (i = 0; i < n; i++)
+    {
+      float a = ab[i].a;
+      float b = -0.5f*ab[i].a + SQRT3_BY_TWO_F*ab[i].b;
+
+      abc[i].a = a;
+      abc[i].b = b;
+      abc[i].c = -a - b;
+    }
+}
+
+/****************************************************************************
+ * Name: park_transform_batch
+ *
+ * Description:
+ *   Park transform (ab frame -> dq frame) of n frames, each with its own
+ *   phase angle.
+ *
+ * Input Parameters:
+ *   angle - (in) pointer to the phase angles
+ *   ab    - (in) pointer to the alpha-beta frames
+ *   dq    - (out) pointer to the direct-quadrature frames
+ *   n     - number of frames
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void park_transform_batch(FAR const phase_angle_f32_t *angle,
+                          FAR const ab_frame_f32_t *ab,
+                          FAR dq_frame_f32_t *dq, size_t n)
+{
+  size_t i;
+
+  LIBDSP_DEBUGASSERT(angle != NULL);
+  LIBDSP_DEBUGASSERT(ab != NULL);
+  LIBDSP_DEBUGASSERT(dq != NULL);
+
+  for (i = 0; i < n; i++)
+    {
+      float s = angle[i].sin;
+      float c = angle[i].cos;
+      float a = ab[i].a;
+      float b = ab[i].b;
+
+      dq[i].d = c * a + s * b;
+      dq[i].q = c * b - s * a;
+    }
+}
+
+/****************************************************************************
+ * Name: inv_park_transform_batch
+ *
+ * Description:
+ *   Inverse Park transform (dq frame -> ab frame) of n frames, each with
+ *   its own phase angle.
+ *
+ * Input Parameters:
+ *   angle - (in) pointer to the phase angles
+ *   dq    - (in) pointer to the direct-quadrature frames
+ *   ab    - (out) pointer to the alpha-beta frames
+ *   n     - number of frames
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void inv_park_transform_batch(FAR const phase_angle_f32_t *angle,
+                              FAR const dq_frame_f32_t *dq,
+                              FAR ab_frame_f32_t *ab, size_t n)
+{
+  size_t i;
+
+  LIBDSP_DEBUGASSERT(angle != NULL);
+  LIBDSP_DEBUGASSERT(dq != NULL);
+  LIBDSP_DEBUGASSERT(ab != NULL);
+
+  for (i = 0; i < n; i++)
+    {
+      float s = angle[i].sin;
+      float c = angle[i].cos;
+      float d = dq[i].d;
+      float q = dq[i].q;
+
+      ab[i].a = c * d - s * q;
+      ab[i].b = c * q + s * d;
+    }
+}
+
+/****************************************************************************
+ * Name: svm3_batch
+ *
+ * Description:
+ *   3-phase space vector modulation of n vectors.
+ *
+ *   The duty cycles are the ones of svm3(), up to the rounding, but they
+ *   are got without the switch on the sector: the SVM adds to the phase
+ *   voltages the common mode that centers them, that is
+ *
+ *     d_x = 0.5 + v_x - (max(v) + min(v)) / 2
+ *
+ *   with the phase voltages v obtained from the auxiliary frame (i,j,k)
+ *   of svm3().  The sector is still set for svm3_current_correct().
+ *
+ * Input Parameters:
+ *   s    - (out) pointer to the SVM data of each vector
+ *   v_ab - (in) pointer to the modulation voltage vectors in alpha-beta
+ *          frame, normalized to magnitude (0.0 - 1.0)
+ *   n    - number of vectors
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void svm3_batch(FAR struct svm3_state_f32_s *s,
+                FAR const ab_frame_f32_t *v_ab, size_t n)
+{
+  float i;
+  float j;
+  float k;
+  float u;
+  float v;
+  float w;
+  float max;
+  float min;
+  float cm;
+  size_t x;
+
+  LIBDSP_DEBUGASSERT(s != NULL);
+  LIBDSP_DEBUGASSERT(v_ab != NULL);
+
+  for (x = 0; x < n; x++)
+    {
+      /* Modified inverse Clarke-transformation (alpha,beta) -> (i,j,k) */
+
+      i = -0.5f*v_ab[x].b + SQRT3_BY_TWO_F*v_ab[x].a;
+      j = v_ab[x].b;
+      k = -j - i;
+
+      /* Phase voltages, the differences of which are i, j and k */
+
+      u = (i - k) * (1.0f / 3.0f);
+      v = (j - i) * (1.0f / 3.0f);
+      w = (k - j) * (1.0f / 3.0f);
+
+      max = u > v ? u : v;
+      max = max > w ? max : w;
+      min = u < v ? u : v;
+      min = min < w ? min : w;
+      cm  = 0.5f - (max + min) * 0.5f;
+
+      s[x].d_u = u + cm;
+      s[x].d_v = v + cm;
+      s[x].d_w = w + cm;
+    }
+
+  /* The sectors in a loop of their own, the bytes would keep the loop
+   * above from being vectorized.
+   */
+
+  for (x = 0; x < n; x++)
+    {
+      i = -0.5f*v_ab[x].b + SQRT3_BY_TWO_F*v_ab[x].a;
+      j = v_ab[x].b;
+      k = -j - i;
+
+      s[x].sector = g_svm3_sector[(i > 0.0f) | (j > 0.0f) << 1 |
+                                  (k > 0.0f) << 2];
+    }
+}
+
+/****************************************************************************
+ * Name: pi_controller_batch
+ *
+ * Description:
+ *   Run n PI controllers, the same way as pi_controller() does for each.
+ *
+ *   This is for the loops with several axes or several motors run from one
+ *   interrupt: the saturation and the integral reset are written as
+ *   selects, which the compiler may turn into conditional instructions.
+ *
+ * Input Parameters:
+ *   pid - (in/out) pointer to the PI controllers
+ *   err - (in) the errors of each controller
+ *   out - (out) the outputs of each controller
+ *   n   - number of controllers
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void pi_controller_batch(FAR pid_controller_f32_t *pid,
+                         FAR const float *err, FAR float *out, size_t n)
+{
+  size_t i;
+
+  LIBDSP_DEBUGASSERT(pid != NULL);
+  LIBDSP_DEBUGASSERT(err != NULL);
+  LIBDSP_DEBUGASSERT(out != NULL);
+
+  for (i = 0; i < n; i++)
+    {
+      FAR pid_controller_f32_t *p = &pid[i];
+      float e = err[i];
+      float part1;
+      float tmp;
+      float aw;
+      float y;
+      bool over;
+      bool under;
+      bool reset;
+
+      p->err     = e;
+      p->part[0] = p->KP * e;
+      part1      = p->part[1] + p->KI * (e - p->aw);
+      tmp        = p->part[0] + part1;
+
+      /* Saturate the output and reset the I part if enabled */
+
+      over  = p->pisat_en & (tmp > p->sat.max);
+      under = p->pisat_en & !over & (tmp < p->sat.min);
+      y     = over ? p->sat.max : (under ? p->sat.min : tmp);
+
+      reset = p->ireset_en & ((over & (e > 0.0f)) | (under & (e < 0.0f)));
+      part1 = reset ? 0.0f : part1;
+      aw    = reset ? 0.0f : p->aw;
+
+      p->part[1] = part1;
+      p->out     = y;
+
+      /* Anti-windup I-part decay if enabled */
+
+      p->aw  = p->aw_en ? p->KC * (tmp - y) : aw;
+      out[i] = y;
+    }
+}
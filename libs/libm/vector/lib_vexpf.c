@@ -0,0 +1,119 @@
+/****************************************************************************
+ * libs/libm/vector/lib_vexpf.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <math.h>
+#include <stdint.h>
+
+#include <nuttx/lib/vmath.h>
+
+#include "lib_vmath.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* exp(x) is 0 below VEXPF_MIN and +inf above VEXPF_MAX in float */
+
+#define VEXPF_MIN      -104.0f
+#define VEXPF_MAX       89.0f
+
+#define VEXPF_LOG2E     1.4426950216e+00f
+
+/* ln(2) = LN2_HI + LN2_LO, LN2_HI of few bits so k * LN2_HI is exact */
+
+#define VEXPF_LN2_HI    6.9314575195e-01f
+#define VEXPF_LN2_LO    1.4286067653e-06f
+
+/* exp(r) - 1 - r on [-ln(2)/2, ln(2)/2], Taylor coefficients */
+
+#define VEXPF_P2        (1.0f / 2.0f)
+#define VEXPF_P3        (1.0f / 6.0f)
+#define VEXPF_P4        (1.0f / 24.0f)
+#define VEXPF_P5        (1.0f / 120.0f)
+#define VEXPF_P6        (1.0f / 720.0f)
+#define VEXPF_P7        (1.0f / 5040.0f)
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vexpf
+ *
+ * Description:
+ *   y[i] = expf(x[i]) for the n elements of x.
+ *
+ ****************************************************************************/
+
+void vexpf(FAR float *y, FAR const float *x, size_t n)
+{
+  size_t i;
+
+  for (i = 0; i < n; i++)
+    {
+#ifdef CONFIG_LIBM_VECTOR_FAST
+      float xi = x[i];
+      float xc;
+      float k;
+      float r;
+      float p;
+      int32_t j;
+      int32_t j1;
+
+      /* x = k * ln(2) + r, then exp(x) = 2^k * exp(r).  x is clamped
+       * where the result saturates, and NaN is replaced by 0 until the
+       * end, so that k stays a small integer.
+       */
+
+      xc = xi < VEXPF_MAX ? xi : VEXPF_MAX;
+      xc = xc > VEXPF_MIN ? xc : VEXPF_MIN;
+      xc = xi == xi ? xc : 0.0f;
+
+      k = xc * VEXPF_LOG2E + VMATH_ROUND;
+      j = (int32_t)(vmath_asuint(k) - vmath_asuint(VMATH_ROUND));
+      k = k - VMATH_ROUND;
+
+      r = xc - k * VEXPF_LN2_HI;
+      r = r - k * VEXPF_LN2_LO;
+
+      p = r * r * (VEXPF_P2 + r * (VEXPF_P3 + r * (VEXPF_P4 +
+                   r * (VEXPF_P5 + r * (VEXPF_P6 + r * VEXPF_P7)))));
+      p = 1.0f + (r + p);
+
+      /* 2^k in two factors, k going from -150 to 129 */
+
+      j1 = j / 2;
+      p  = p * vmath_asfloat((uint32_t)(j1 + 127) << 23);
+      p  = p * vmath_asfloat((uint32_t)(j - j1 + 127) << 23);
+
+      y[i] = xi == xi ? p : xi;
+#else
+      y[i] = expf(x[i]);
+#endif
+    }
+}
@@ -0,0 +1,116 @@
+/****************************************************************************
+ * libs/libm/vector/lib_vlogf.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <math.h>
+#include <stdint.h>
+
+#include <nuttx/lib/vmath.h>
+
+#include "lib_vmath.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define VLOGF_LN2_HI    6.9313812256e-01f
+#define VLOGF_LN2_LO    9.0580006145e-06f
+
+/* log(1 + f) = 2s + s * R(s^2) with s = f / (2 + f), from fdlibm */
+
+#define VLOGF_LG1       0.66666662693f
+#define VLOGF_LG2       0.40000972152f
+#define VLOGF_LG3       0.28498786688f
+#define VLOGF_LG4       0.24279078841f
+
+#define VLOGF_SQRT1_2   0x3f3504f3u
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vlogf
+ *
+ * Description:
+ *   y[i] = logf(x[i]) for the n elements of x.
+ *
+ ****************************************************************************/
+
+void vlogf(FAR float *y, FAR const float *x, size_t n)
+{
+  size_t i;
+
+  for (i = 0; i < n; i++)
+    {
+#ifdef CONFIG_LIBM_VECTOR_FAST
+      float xi = x[i];
+      float xs;
+      float f;
+      float s;
+      float z;
+      float w;
+      float r;
+      float hfsq;
+      float k;
+      float v;
+      uint32_t ix;
+      int32_t e;
+      bool sub;
+
+      /* Scale the subnormals up into the normals */
+
+      sub = xi < 1.17549435e-38f;
+      xs  = sub ? xi * 33554432.0f : xi;
+      ix  = vmath_asuint(xs);
+
+      /* x = 2^k * (1 + f), with 1 + f in [sqrt(2)/2, sqrt(2)) */
+
+      ix  = ix + (0x3f800000u - VLOGF_SQRT1_2);
+      e   = (int32_t)(ix >> 23) - 0x7f - (sub ? 25 : 0);
+      ix  = (ix & 0x007fffffu) + VLOGF_SQRT1_2;
+      f   = vmath_asfloat(ix) - 1.0f;
+      k   = (float)e;
+
+      s    = f / (2.0f + f);
+      z    = s * s;
+      w    = z * z;
+      r    = z * (VLOGF_LG1 + w * VLOGF_LG3) +
+             w * (VLOGF_LG2 + w * VLOGF_LG4);
+      hfsq = 0.5f * f * f;
+      v    = s * (hfsq + r) + k * VLOGF_LN2_LO - hfsq + f + k * VLOGF_LN2_HI;
+
+      /* log(0) = -inf, log(x < 0) = NaN, log(+inf) = +inf and NaN */
+
+      v    = xi == 0.0f ? -INFINITY : v;
+      v    = xi < 0.0f ? NAN : v;
+      y[i] = xi == INFINITY || xi != xi ? xi : v;
+#else
+      y[i] = logf(x[i]);
+#endif
+    }
+}
@@ -0,0 +1,84 @@
+/****************************************************************************
+ * libs/libm/vector/lib_vmath.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __LIBS_LIBM_VECTOR_LIB_VMATH_H
+#define __LIBS_LIBM_VECTOR_LIB_VMATH_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Elements computed at once by the kernels that fix up some of them with
+ * the libm function afterwards.
+ */
+
+#define VMATH_CHUNK  32
+
+/* Adding and subtracting 1.5 * 2^23 rounds a float of magnitude below
+ * 2^22 to the nearest integer, which is then in the low bits of the sum.
+ * The kernels must not be built with -ffast-math for this to work.
+ */
+
+#define VMATH_ROUND  12582912.0f
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/* The kernels don't call memcpy() to get the bits of a float, which would
+ * stop the vectorization with -fno-builtin.
+ */
+
+static inline uint32_t vmath_asuint(float f)
+{
+  union
+  {
+    float    f;
+    uint32_t i;
+  } u;
+
+  u.f = f;
+  return u.i;
+}
+
+static inline float vmath_asfloat(uint32_t i)
+{
+  union
+  {
+    float    f;
+    uint32_t i;
+  } u;
+
+  u.i = i;
+  return u.f;
+}
+
+#endif /* __LIBS_LIBM_VECTOR_LIB_VMATH_H */
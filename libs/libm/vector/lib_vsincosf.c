@@ -0,0 +1,202 @@
+/****************************************************************************
+ * libs/libm/vector/lib_vsincosf.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <math.h>
+#include <stdint.h>
+
+#include <nuttx/lib/vmath.h>
+
+#include "lib_vmath.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Beyond this the quadrant takes more than 12 bits, and the reduction by
+ * pi/2 is not exact enough.
+ */
+
+#define VSINCOSF_LIMIT   4096.0f
+
+#define VSINCOSF_2_PI    6.3661977237e-01f
+
+/* pi/2 = PIO2_1 + ... + PIO2_5, all of them but the last of 12 bits at
+ * most, so that their product by the quadrant is exact without FMA.
+ */
+
+#define VSINCOSF_PIO2_1  1.5703125f
+#define VSINCOSF_PIO2_2  4.8387050628662109e-04f
+#define VSINCOSF_PIO2_3 -4.3713953346014023e-08f
+#define VSINCOSF_PIO2_4  2.5632829192545614e-12f
+#define VSINCOSF_PIO2_5  6.1149002528182450e-17f
+
+/* sin(r) and cos(r) on [-pi/4, pi/4], from fdlibm */
+
+#define VSINCOSF_S1     -1.6666667163e-01f
+#define VSINCOSF_S2      8.3333337680e-03f
+#define VSINCOSF_S3     -1.9841270114e-04f
+#define VSINCOSF_S4      2.7183114939e-06f
+
+#define VSINCOSF_C1      4.1666667908e-02f
+#define VSINCOSF_C2     -1.3888889225e-03f
+#define VSINCOSF_C3      2.4801587642e-05f
+#define VSINCOSF_C4     -2.7557314297e-07f
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_LIBM_VECTOR_FAST
+
+/* sin(x + q * pi/2) of the elements, q being 0 for sin and 1 for cos.
+ * They are done by chunks: the chunk is computed into a buffer by the
+ * vectorized loop, the few elements out of the range are computed again by
+ * the libm function, then the chunk is copied out, so that y may be x.
+ */
+
+static void vsincosf(FAR float *y, FAR const float *x, size_t n,
+                     uint32_t q)
+{
+  float buf[VMATH_CHUNK];
+  size_t m;
+  size_t i;
+  uint32_t out;
+
+  while (n > 0)
+    {
+      m   = n < VMATH_CHUNK ? n : VMATH_CHUNK;
+      out = 0;
+
+      for (i = 0; i < m; i++)
+        {
+          float xi = x[i];
+          float k;
+          float r;
+          float z;
+          float s;
+          float c;
+          float v;
+          uint32_t j;
+
+          /* k = round(x * 2/pi), and r = x - k * pi/2 in [-pi/4, pi/4] */
+
+          k = xi * VSINCOSF_2_PI + VMATH_ROUND;
+          j = vmath_asuint(k) + q;
+          k = k - VMATH_ROUND;
+
+          r = xi - k * VSINCOSF_PIO2_1;
+          r = r - k * VSINCOSF_PIO2_2;
+          r = r - k * VSINCOSF_PIO2_3;
+          r = r - k * VSINCOSF_PIO2_4;
+          r = r - k * VSINCOSF_PIO2_5;
+          z = r * r;
+
+          s = r + r * z * (VSINCOSF_S1 + z * (VSINCOSF_S2 +
+                           z * (VSINCOSF_S3 + z * VSINCOSF_S4)));
+          s = z != 0.0f ? s : r;
+          c = 1.0f - 0.5f * z + z * z * (VSINCOSF_C1 + z * (VSINCOSF_C2 +
+                                         z * (VSINCOSF_C3 +
+                                              z * VSINCOSF_C4)));
+
+          /* Select the function and the sign by the quadrant */
+
+          v      = (j & 1) != 0 ? c : s;
+          buf[i] = (j & 2) != 0 ? -v : v;
+          out   |= xi <= VSINCOSF_LIMIT && xi >= -VSINCOSF_LIMIT ? 0 : 1;
+        }
+
+      if (out)
+        {
+          for (i = 0; i < m; i++)
+            {
+              if (!(x[i] <= VSINCOSF_LIMIT && x[i] >= -VSINCOSF_LIMIT))
+                {
+                  buf[i] = q != 0 ? cosf(x[i]) : sinf(x[i]);
+                }
+            }
+        }
+
+      for (i = 0; i < m; i++)
+        {
+          y[i] = buf[i];
+        }
+
+      x += m;
+      y += m;
+      n -= m;
+    }
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vsinf
+ *
+ * Description:
+ *   y[i] = sinf(x[i]) for the n elements of x.
+ *
+ ****************************************************************************/
+
+void vsinf(FAR float *y, FAR const float *x, size_t n)
+{
+#ifdef CONFIG_LIBM_VECTOR_FAST
+  vsincosf(y, x, n, 0);
+#else
+  size_t i;
+
+  for (i = 0; i < n; i++)
+    {
+      y[i] = sinf(x[i]);
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: vcosf
+ *
+ * Description:
+ *   y[i] = cosf(x[i]) for the n elements of x.
+ *
+ ****************************************************************************/
+
+void vcosf(FAR float *y, FAR const float *x, size_t n)
+{
+#ifdef CONFIG_LIBM_VECTOR_FAST
+  vsincosf(y, x, n, 1);
+#else
+  size_t i;
+
+  for (i = 0; i < n; i++)
+    {
+      y[i] = cosf(x[i]);
+    }
+#endif
+}
@@ -0,0 +1,371 @@
+/****************************************************************************
+ * mm/heapprof/heapprof.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <sched.h>
+#include <string.h>
+#include <strings.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/mm/heapprof.h>
+
+#if defined(CONFIG_MM_HEAPPROF) && \
+    (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if (CONFIG_MM_HEAPPROF_NSAMPLES & (CONFIG_MM_HEAPPROF_NSAMPLES - 1)) != 0
+#  error CONFIG_MM_HEAPPROF_NSAMPLES must be a power of two
+#endif
+
+#define HEAPPROF_MASK      (CONFIG_MM_HEAPPROF_NSAMPLES - 1)
+
+/* ln(2) and the log2() correction term in Q16 */
+
+#define HEAPPROF_LN2       45426
+#define HEAPPROF_LOG2C     22713
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One live sample, kept in an open addressing table keyed by address */
+
+struct heapprof_sample_s
+{
+  FAR void *mem;  /* The sampled memory, NULL if the slot is empty */
+  size_t    size; /* The requested size */
+  uint16_t  site; /* The index of the call site */
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+long g_mm_heapprof_left = CONFIG_MM_HEAPPROF_INTERVAL;
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct mm_heapprof_site_s g_heapprof_site[CONFIG_MM_HEAPPROF_NSITES];
+static unsigned int g_heapprof_nsites;
+static struct heapprof_sample_s
+  g_heapprof_sample[CONFIG_MM_HEAPPROF_NSAMPLES];
+
+/* The number of live samples whose home slot is the index.  free() reads
+ * it without the lock to skip the memory that was never sampled.
+ */
+
+static volatile uint16_t g_heapprof_home[CONFIG_MM_HEAPPROF_NSAMPLES];
+
+static unsigned long g_heapprof_nlive;
+static unsigned long g_heapprof_ndropped;
+static uint32_t g_heapprof_seed = 0x2545f491;
+static spinlock_t g_heapprof_lock = SP_UNLOCKED;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static inline uint32_t heapprof_hash(FAR void *mem)
+{
+  uint32_t hash = (uint32_t)((uintptr_t)mem >> 3) * 2654435761u;
+
+  return (hash ^ (hash >> 16)) & HEAPPROF_MASK;
+}
+
+/****************************************************************************
+ * Name: heapprof_next
+ *
+ * Description:
+ *   Return an exponentially distributed distance to the next sample with
+ *   the mean CONFIG_MM_HEAPPROF_INTERVAL.  -ln(U) is computed from the
+ *   position of the top bit of a random number and a quadratic fit of the
+ *   fraction, which is close enough for sampling and needs no libm.
+ *   Must be called with g_heapprof_lock held.
+ *
+ ****************************************************************************/
+
+static long heapprof_next(void)
+{
+  uint32_t rand = g_heapprof_seed;
+  uint32_t frac;
+  uint64_t expo;
+  int n;
+
+  rand ^= rand << 13;
+  rand ^= rand >> 17;
+  rand ^= rand << 5;
+  g_heapprof_seed = rand;
+
+  /* rand = 2^n * (1 + x), log2(1 + x) ~= x + 0.3466 * x * (1 - x) */
+
+  n    = flsll(rand) - 1;
+  frac = rand - (1u << n);
+  frac = n >= 16 ? frac >> (n - 16) : frac << (16 - n);
+  frac += ((uint64_t)frac * (65536 - frac) * HEAPPROF_LOG2C) >> 32;
+
+  /* -ln(rand / 2^32) = (32 - log2(rand)) * ln(2), in Q32 */
+
+  expo = ((uint64_t)(32 - n) << 16) - frac;
+  expo = expo * HEAPPROF_LN2;
+
+  return (long)((expo * CONFIG_MM_HEAPPROF_INTERVAL) >> 32) + 1;
+}
+
+/****************************************************************************
+ * Name: heapprof_site
+ *
+ * Description:
+ *   Find or add the call site with the given backtrace.  Must be called
+ *   with g_heapprof_lock held.
+ *
+ ****************************************************************************/
+
+static int heapprof_site(FAR void * const *backtrace)
+{
+  unsigned int i;
+
+  for (i = 0; i < g_heapprof_nsites; i++)
+    {
+      if (memcmp(g_heapprof_site[i].backtrace, backtrace,
+                 sizeof(g_heapprof_site[i].backtrace)) == 0)
+        {
+          return i;
+        }
+    }
+
+  if (i >= CONFIG_MM_HEAPPROF_NSITES)
+    {
+      return -ENOSPC;
+    }
+
+  memcpy(g_heapprof_site[i].backtrace, backtrace,
+         sizeof(g_heapprof_site[i].backtrace));
+  g_heapprof_nsites++;
+  return i;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_heapprof_alloc
+ *
+ * Description:
+ *   Record the allocation of 'mem' and pick the distance to the next
+ *   sample.
+ *
+ ****************************************************************************/
+
+void mm_heapprof_alloc(FAR void *mem, size_t size)
+{
+  FAR void *backtrace[CONFIG_MM_HEAPPROF_DEPTH];
+  FAR struct mm_heapprof_site_s *site;
+  irqstate_t flags;
+  uint32_t slot;
+  int index;
+  int n = 0;
+
+  memset(backtrace, 0, sizeof(backtrace));
+  if (!up_interrupt_context())
+    {
+      n = sched_backtrace(_SCHED_GETTID(), backtrace,
+                          CONFIG_MM_HEAPPROF_DEPTH,
+                          CONFIG_MM_HEAPPROF_SKIP);
+    }
+
+  UNUSED(n);
+
+  flags = spin_lock_irqsave(&g_heapprof_lock);
+
+  /* Allocations racing with this one may have moved the counter further,
+   * start the next interval from here anyway.
+   */
+
+  g_mm_heapprof_left = heapprof_next();
+
+  index = heapprof_site(backtrace);
+  if (index < 0 || g_heapprof_nlive >= CONFIG_MM_HEAPPROF_NSAMPLES)
+    {
+      g_heapprof_ndropped++;
+      goto out;
+    }
+
+  slot = heapprof_hash(mem);
+  g_heapprof_home[slot]++;
+  while (g_heapprof_sample[slot].mem != NULL)
+    {
+      slot = (slot + 1) & HEAPPROF_MASK;
+    }
+
+  g_heapprof_sample[slot].mem  = mem;
+  g_heapprof_sample[slot].size = size;
+  g_heapprof_sample[slot].site = index;
+  g_heapprof_nlive++;
+
+  site          = &g_heapprof_site[index];
+  site->nlive  += 1;
+  site->live   += size;
+  site->nalloc += 1;
+  site->alloc  += size;
+
+out:
+  spin_unlock_irqrestore(&g_heapprof_lock, flags);
+}
+
+/****************************************************************************
+ * Name: mm_heapprof_free
+ *
+ * Description:
+ *   Drop the sample of 'mem' if it is one.
+ *
+ ****************************************************************************/
+
+void mm_heapprof_free(FAR void *mem)
+{
+  FAR struct mm_heapprof_site_s *site;
+  irqstate_t flags;
+  uint32_t home;
+  uint32_t slot;
+  uint32_t next;
+
+  if (mem == NULL)
+    {
+      return;
+    }
+
+  home = heapprof_hash(mem);
+  if (g_heapprof_home[home] == 0)
+    {
+      return;
+    }
+
+  flags = spin_lock_irqsave(&g_heapprof_lock);
+
+  for (slot = home; g_heapprof_sample[slot].mem != mem;
+       slot = (slot + 1) & HEAPPROF_MASK)
+    {
+      if (g_heapprof_sample[slot].mem == NULL)
+        {
+          /* Another sample with the same home slot */
+
+          goto out;
+        }
+    }
+
+  site         = &g_heapprof_site[g_heapprof_sample[slot].site];
+  site->nlive -= 1;
+  site->live  -= g_heapprof_sample[slot].size;
+  g_heapprof_home[home]--;
+  g_heapprof_nlive--;
+
+  /* Shift the following samples back so that no probe chain is cut */
+
+  for (next = (slot + 1) & HEAPPROF_MASK;
+       g_heapprof_sample[next].mem != NULL;
+       next = (next + 1) & HEAPPROF_MASK)
+    {
+      uint32_t want = heapprof_hash(g_heapprof_sample[next].mem);
+
+      if (((next - want) & HEAPPROF_MASK) >= ((next - slot) & HEAPPROF_MASK))
+        {
+          g_heapprof_sample[slot] = g_heapprof_sample[next];
+          slot = next;
+        }
+    }
+
+  g_heapprof_sample[slot].mem = NULL;
+
+out:
+  spin_unlock_irqrestore(&g_heapprof_lock, flags);
+}
+
+/****************************************************************************
+ * Name: mm_heapprof_info
+ *
+ * Description:
+ *   Return the totals of the heap profile.
+ *
+ ****************************************************************************/
+
+void mm_heapprof_info(FAR struct mm_heapprof_s *info)
+{
+  irqstate_t flags;
+  unsigned int i;
+
+  memset(info, 0, sizeof(*info));
+  info->interval = CONFIG_MM_HEAPPROF_INTERVAL;
+
+  flags = spin_lock_irqsave(&g_heapprof_lock);
+  for (i = 0; i < g_heapprof_nsites; i++)
+    {
+      info->nlive  += g_heapprof_site[i].nlive;
+      info->live   += g_heapprof_site[i].live;
+      info->nalloc += g_heapprof_site[i].nalloc;
+      info->alloc  += g_heapprof_site[i].alloc;
+    }
+
+  info->nsites   = g_heapprof_nsites;
+  info->ndropped = g_heapprof_ndropped;
+  spin_unlock_irqrestore(&g_heapprof_lock, flags);
+}
+
+/****************************************************************************
+ * Name: mm_heapprof_site
+ *
+ * Description:
+ *   Return a snapshot of one call site.
+ *
+ ****************************************************************************/
+
+int mm_heapprof_site(unsigned int index,
+                     FAR struct mm_heapprof_site_s *site)
+{
+  irqstate_t flags;
+  int ret = -ENOENT;
+
+  flags = spin_lock_irqsave(&g_heapprof_lock);
+  if (index < g_heapprof_nsites)
+    {
+      *site = g_heapprof_site[index];
+      ret = OK;
+    }
+
+  spin_unlock_irqrestore(&g_heapprof_lock, flags);
+  return ret;
+}
+
+#endif /* CONFIG_MM_HEAPPROF */
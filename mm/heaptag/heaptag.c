@@ -0,0 +1,413 @@
+/****************************************************************************
+ * mm/heaptag/heaptag.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <sched.h>
+#include <string.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/mm/heaptag.h>
+
+#if defined(CONFIG_MM_HEAPTAG) && \
+    (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if (CONFIG_MM_HEAPTAG_NBLOCKS & (CONFIG_MM_HEAPTAG_NBLOCKS - 1)) != 0
+#  error CONFIG_MM_HEAPTAG_NBLOCKS must be a power of two
+#endif
+
+#if CONFIG_MM_HEAPTAG_NTASKS > 255
+#  error CONFIG_MM_HEAPTAG_NTASKS must be less than 256
+#endif
+
+#define HEAPTAG_MASK       (CONFIG_MM_HEAPTAG_NBLOCKS - 1)
+#define HEAPTAG_NOTASK     0xff
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One live allocation, kept in an open addressing table keyed by address */
+
+struct heaptag_block_s
+{
+  FAR void *mem;  /* The allocated memory, NULL if the slot is empty */
+  size_t    size; /* The requested size */
+  uint8_t   tag;  /* The tag it is accounted to */
+  uint8_t   task; /* The index of the thread, HEAPTAG_NOTASK if none */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct mm_heaptag_s g_heaptag_tag[MM_HEAPTAG_NTAGS];
+static struct mm_heaptag_s g_heaptag_task[CONFIG_MM_HEAPTAG_NTASKS];
+static struct heaptag_block_s g_heaptag_block[CONFIG_MM_HEAPTAG_NBLOCKS];
+
+/* The number of live allocations whose home slot is the index.  free()
+ * reads it without the lock to skip the memory that is not accounted.
+ */
+
+static volatile uint16_t g_heaptag_home[CONFIG_MM_HEAPTAG_NBLOCKS];
+
+static unsigned long g_heaptag_nlive;
+static unsigned long g_heaptag_ndropped;
+static spinlock_t g_heaptag_lock = SP_UNLOCKED;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static inline uint32_t heaptag_hash(FAR void *mem)
+{
+  uint32_t hash = (uint32_t)((uintptr_t)mem >> 3) * 2654435761u;
+
+  return (hash ^ (hash >> 16)) & HEAPTAG_MASK;
+}
+
+static inline void heaptag_add(FAR struct mm_heaptag_s *info, size_t size)
+{
+  info->nlive  += 1;
+  info->live   += size;
+  info->nalloc += 1;
+  info->alloc  += size;
+
+  if (info->live > info->peak)
+    {
+      info->peak = info->live;
+    }
+}
+
+/****************************************************************************
+ * Name: heaptag_task
+ *
+ * Description:
+ *   Find the slot of the thread 'pid' or take a slot without live
+ *   allocations for it.  Must be called with g_heaptag_lock held.
+ *
+ ****************************************************************************/
+
+static int heaptag_task(pid_t pid)
+{
+  int empty = -1;
+  int i;
+
+  for (i = 0; i < CONFIG_MM_HEAPTAG_NTASKS; i++)
+    {
+      if (g_heaptag_task[i].nalloc != 0 && g_heaptag_task[i].pid == pid)
+        {
+          return i;
+        }
+      else if (empty < 0 && g_heaptag_task[i].nlive == 0)
+        {
+          empty = i;
+        }
+    }
+
+  if (empty >= 0)
+    {
+      memset(&g_heaptag_task[empty], 0, sizeof(g_heaptag_task[empty]));
+      g_heaptag_task[empty].pid = pid;
+      return empty;
+    }
+
+  return HEAPTAG_NOTASK;
+}
+
+/****************************************************************************
+ * Name: heaptag_find
+ *
+ * Description:
+ *   Return the slot of 'mem' or -ENOENT.  Must be called with
+ *   g_heaptag_lock held.
+ *
+ ****************************************************************************/
+
+static int heaptag_find(FAR void *mem)
+{
+  uint32_t slot;
+
+  for (slot = heaptag_hash(mem); g_heaptag_block[slot].mem != mem;
+       slot = (slot + 1) & HEAPTAG_MASK)
+    {
+      if (g_heaptag_block[slot].mem == NULL)
+        {
+          return -ENOENT;
+        }
+    }
+
+  return slot;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_heaptag_alloc
+ *
+ * Description:
+ *   Account the allocation of 'mem' to MM_HEAPTAG_OTHER and to the
+ *   calling thread.
+ *
+ ****************************************************************************/
+
+void mm_heaptag_alloc(FAR void *mem, size_t size)
+{
+  irqstate_t flags;
+  uint32_t slot;
+  int task;
+
+  flags = spin_lock_irqsave(&g_heaptag_lock);
+
+  if (g_heaptag_nlive >= CONFIG_MM_HEAPTAG_NBLOCKS)
+    {
+      g_heaptag_ndropped++;
+      goto out;
+    }
+
+  task = heaptag_task(_SCHED_GETTID());
+  if (task == HEAPTAG_NOTASK)
+    {
+      g_heaptag_ndropped++;
+    }
+  else
+    {
+      heaptag_add(&g_heaptag_task[task], size);
+    }
+
+  heaptag_add(&g_heaptag_tag[MM_HEAPTAG_OTHER], size);
+
+  slot = heaptag_hash(mem);
+  g_heaptag_home[slot]++;
+  while (g_heaptag_block[slot].mem != NULL)
+    {
+      slot = (slot + 1) & HEAPTAG_MASK;
+    }
+
+  g_heaptag_block[slot].mem  = mem;
+  g_heaptag_block[slot].size = size;
+  g_heaptag_block[slot].tag  = MM_HEAPTAG_OTHER;
+  g_heaptag_block[slot].task = task;
+  g_heaptag_nlive++;
+
+out:
+  spin_unlock_irqrestore(&g_heaptag_lock, flags);
+}
+
+/****************************************************************************
+ * Name: mm_heaptag_free
+ *
+ * Description:
+ *   Take the freed 'mem' out of the accounting.
+ *
+ ****************************************************************************/
+
+void mm_heaptag_free(FAR void *mem)
+{
+  FAR struct heaptag_block_s *block;
+  FAR struct mm_heaptag_s *info;
+  irqstate_t flags;
+  uint32_t home;
+  uint32_t next;
+  int slot;
+
+  if (mem == NULL)
+    {
+      return;
+    }
+
+  home = heaptag_hash(mem);
+  if (g_heaptag_home[home] == 0)
+    {
+      return;
+    }
+
+  flags = spin_lock_irqsave(&g_heaptag_lock);
+
+  slot = heaptag_find(mem);
+  if (slot < 0)
+    {
+      /* Another allocation with the same home slot */
+
+      goto out;
+    }
+
+  block        = &g_heaptag_block[slot];
+  info         = &g_heaptag_tag[block->tag];
+  info->nlive -= 1;
+  info->live  -= block->size;
+
+  if (block->task != HEAPTAG_NOTASK)
+    {
+      info         = &g_heaptag_task[block->task];
+      info->nlive -= 1;
+      info->live  -= block->size;
+    }
+
+  g_heaptag_home[home]--;
+  g_heaptag_nlive--;
+
+  /* Shift the following blocks back so that no probe chain is cut */
+
+  for (next = (slot + 1) & HEAPTAG_MASK;
+       g_heaptag_block[next].mem != NULL;
+       next = (next + 1) & HEAPTAG_MASK)
+    {
+      uint32_t want = heaptag_hash(g_heaptag_block[next].mem);
+
+      if (((next - want) & HEAPTAG_MASK) >= ((next - slot) & HEAPTAG_MASK))
+        {
+          g_heaptag_block[slot] = g_heaptag_block[next];
+          slot = next;
+        }
+    }
+
+  g_heaptag_block[slot].mem = NULL;
+
+out:
+  spin_unlock_irqrestore(&g_heaptag_lock, flags);
+}
+
+/****************************************************************************
+ * Name: mm_heaptag_set
+ *
+ * Description:
+ *   Move the accounting of 'mem' to 'tag'.  The peak of MM_HEAPTAG_OTHER
+ *   may include memory that was moved to another tag right after its
+ *   allocation.
+ *
+ ****************************************************************************/
+
+FAR void *mm_heaptag_set(FAR void *mem, int tag)
+{
+  FAR struct heaptag_block_s *block;
+  FAR struct mm_heaptag_s *info;
+  irqstate_t flags;
+  int slot;
+
+  if (mem == NULL || tag < 0 || tag >= MM_HEAPTAG_NTAGS ||
+      g_heaptag_home[heaptag_hash(mem)] == 0)
+    {
+      return mem;
+    }
+
+  flags = spin_lock_irqsave(&g_heaptag_lock);
+
+  slot = heaptag_find(mem);
+  if (slot >= 0 && g_heaptag_block[slot].tag != tag)
+    {
+      block         = &g_heaptag_block[slot];
+      info          = &g_heaptag_tag[block->tag];
+      info->nlive  -= 1;
+      info->live   -= block->size;
+      info->nalloc -= 1;
+      info->alloc  -= block->size;
+
+      heaptag_add(&g_heaptag_tag[tag], block->size);
+      block->tag = tag;
+    }
+
+  spin_unlock_irqrestore(&g_heaptag_lock, flags);
+  return mem;
+}
+
+/****************************************************************************
+ * Name: mm_heaptag_tag
+ *
+ * Description:
+ *   Return a snapshot of the accounting of one tag.
+ *
+ ****************************************************************************/
+
+int mm_heaptag_tag(int tag, FAR struct mm_heaptag_s *info)
+{
+  irqstate_t flags;
+
+  if (tag < 0 || tag >= MM_HEAPTAG_NTAGS)
+    {
+      return -ENOENT;
+    }
+
+  flags = spin_lock_irqsave(&g_heaptag_lock);
+  *info = g_heaptag_tag[tag];
+  spin_unlock_irqrestore(&g_heaptag_lock, flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mm_heaptag_task
+ *
+ * Description:
+ *   Return a snapshot of the accounting of one thread.
+ *
+ ****************************************************************************/
+
+int mm_heaptag_task(unsigned int index, FAR struct mm_heaptag_s *info)
+{
+  irqstate_t flags;
+  int ret = OK;
+
+  if (index >= CONFIG_MM_HEAPTAG_NTASKS)
+    {
+      return -ENOENT;
+    }
+
+  flags = spin_lock_irqsave(&g_heaptag_lock);
+  *info = g_heaptag_task[index];
+  spin_unlock_irqrestore(&g_heaptag_lock, flags);
+
+  if (info->nalloc == 0)
+    {
+      ret = -EAGAIN;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mm_heaptag_dropped
+ *
+ * Description:
+ *   Return the number of allocations that are not accounted because a
+ *   table was full.
+ *
+ ****************************************************************************/
+
+unsigned long mm_heaptag_dropped(void)
+{
+  return g_heaptag_ndropped;
+}
+
+#endif /* CONFIG_MM_HEAPTAG */
@@ -33,6 +33,7 @@
 
 #include <nuttx/mm/iob.h>
 #include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
 
 #ifdef CONFIG_MM_IOB
 
@@ -42,6 +43,14 @@
 
 #define ROUNDUP(x, y)            (((x) + (y) - 1) / (y) * (y))
 
+/* Number of buffers moved between a per-CPU cache and the free list at a
+ * time.
+ */
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+#  define IOB_CACHE_BATCH        ((CONFIG_IOB_PERCPU_CACHE + 1) / 2)
+#endif
+
 #if defined(CONFIG_DEBUG_FEATURES) && defined(CONFIG_IOB_DEBUG)
 #  define ioberr                 _err
 #  define iobwarn                _warn
@@ -52,6 +61,23 @@
 #  define iobinfo                _none
 #endif /* CONFIG_DEBUG_FEATURES && CONFIG_IOB_DEBUG */
 
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+/* A per-CPU cache of free I/O buffers.  The buffers in a cache are not
+ * counted by g_iob_sem; iob_navail() adds them back in.
+ */
+
+struct iob_cache_s
+{
+  spinlock_t lock;              /* Normally only taken by the owning CPU */
+  int16_t count;                /* Number of buffers in the cache */
+  FAR struct iob_s *head;       /* The cached buffers */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -84,6 +110,18 @@ extern sem_t g_throttle_sem;  /* Counts available I/O buffers when throttled */
 extern sem_t g_qentry_sem;    /* Counts free I/O buffer queue containers */
 #endif
 
+#if CONFIG_IOB_PERCPU_CACHE > 0
+/* The per-CPU caches of free I/O buffers */
+
+extern struct iob_cache_s g_iob_cache[CONFIG_SMP_NCPUS];
+
+/* The number of threads blocked in iob_alloc().  The caches are bypassed
+ * while it is non-zero so that freed buffers reach the waiters.
+ */
+
+extern volatile int g_iob_nwaiters;
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -123,6 +161,102 @@ FAR struct iob_qentry_s *iob_tryalloc_qentry(void);
 
 FAR struct iob_qentry_s *iob_free_qentry(FAR struct iob_qentry_s *iobq);
 
+/****************************************************************************
+ * Name: iob_tryalloc_list
+ *
+ * Description:
+ *   Take up to 'n' buffers from the head of the free list at once, with
+ *   the same rules and semaphore accounting as iob_tryalloc().  The buffers
+ *   are returned linked through io_flink but are otherwise not initialized.
+ *
+ * Returned Value:
+ *   The number of buffers in the list returned through 'list'.
+ *
+ ****************************************************************************/
+
+int iob_tryalloc_list(FAR struct iob_s **list, int n, bool throttled);
+
+/****************************************************************************
+ * Name: iob_free_list
+ *
+ * Description:
+ *   Return a list of 'n' buffers linked through io_flink to the free list
+ *   (or to the committed list if there are waiters).  The buffers must not
+ *   be dynamically allocated ones.
+ *
+ ****************************************************************************/
+
+void iob_free_list(FAR struct iob_s *list, int n);
+
+#ifdef CONFIG_IOB_SHARE
+/****************************************************************************
+ * Name: iob_share_release
+ *
+ * Description:
+ *   Drop one use of the payload of iob.  If it is still referenced by
+ *   another chain, iob is unlinked and kept and false is returned.
+ *   Otherwise the buffer whose payload iob references, if any, is released
+ *   too and true is returned: iob may be freed.
+ *
+ ****************************************************************************/
+
+bool iob_share_release(FAR struct iob_s *iob);
+#endif
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+/****************************************************************************
+ * Name: iob_cache_tryalloc
+ *
+ * Description:
+ *   Take up to 'n' buffers from the cache of the current CPU, refilling the
+ *   cache from the free list if it runs empty.  The buffers are returned
+ *   linked through io_flink but are otherwise not initialized.
+ *
+ * Returned Value:
+ *   The number of buffers in the list returned through 'list'.
+ *
+ ****************************************************************************/
+
+int iob_cache_tryalloc(FAR struct iob_s **list, int n, bool throttled);
+
+/****************************************************************************
+ * Name: iob_cache_free
+ *
+ * Description:
+ *   Put a list of 'n' buffers linked through io_flink in the cache of the
+ *   current CPU, spilling part of the cache to the free list if it
+ *   overflows.
+ *
+ * Returned Value:
+ *   True if the buffers were taken.  False if there are threads waiting
+ *   for a buffer; the buffers must then be returned to the free list
+ *   directly.
+ *
+ ****************************************************************************/
+
+bool iob_cache_free(FAR struct iob_s *list, int n);
+
+/****************************************************************************
+ * Name: iob_cache_drain
+ *
+ * Description:
+ *   Return the buffers of all per-CPU caches to the free list.
+ *
+ ****************************************************************************/
+
+void iob_cache_drain(void);
+
+/****************************************************************************
+ * Name: iob_cache_navail
+ *
+ * Description:
+ *   Return the number of buffers held in the per-CPU caches.
+ *
+ ****************************************************************************/
+
+int iob_cache_navail(void);
+#endif
+
 /****************************************************************************
  * Name: iob_notifier_signal
  *
@@ -117,6 +117,9 @@ static FAR struct iob_s *iob_allocwait(bool throttled, unsigned int timeout)
   FAR sem_t *sem;
   clock_t start;
   int ret = OK;
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  bool waiting = false;
+#endif
 
 #if CONFIG_IOB_THROTTLE > 0
   /* Select the semaphore count to check. */
@@ -140,6 +143,22 @@ static FAR struct iob_s *iob_allocwait(bool throttled, unsigned int timeout)
 
   start = clock_systime_ticks();
   iob   = iob_tryalloc(throttled);
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  if (iob == NULL)
+    {
+      /* There may still be free buffers in the caches of the other CPUs.
+       * Return them to the free list, and stop the caching of freed
+       * buffers until we have one.
+       */
+
+      g_iob_nwaiters++;
+      waiting = true;
+
+      iob_cache_drain();
+      iob = iob_tryalloc(throttled);
+    }
+#endif
+
   while (ret == OK && iob == NULL)
     {
       /* If not successful, then the semaphore count was less than or equal
@@ -168,6 +187,13 @@ static FAR struct iob_s *iob_allocwait(bool throttled, unsigned int timeout)
         }
     }
 
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  if (waiting)
+    {
+      g_iob_nwaiters--;
+    }
+#endif
+
   leave_critical_section(flags);
   return iob;
 }
@@ -249,15 +275,84 @@ FAR struct iob_s *iob_alloc(bool throttled)
 FAR struct iob_s *iob_tryalloc(bool throttled)
 {
   FAR struct iob_s *iob;
-  irqstate_t flags;
-#if CONFIG_IOB_THROTTLE > 0
-  FAR sem_t *sem;
+
+  if (iob_alloc_batch(&iob, 1, throttled) == 0)
+    {
+      return NULL;
+    }
+
+  return iob;
+}
+
+/****************************************************************************
+ * Name: iob_alloc_batch
+ *
+ * Description:
+ *   Allocate up to 'n' I/O buffers without waiting.  This is cheaper than
+ *   calling iob_tryalloc() 'n' times because the free list is only locked
+ *   once.
+ *
+ * Input Parameters:
+ *   iobs      - Array that receives the allocated buffers
+ *   n         - The number of buffers wanted
+ *   throttled - An indication of the IOB allocation is "throttled"
+ *
+ * Returned Value:
+ *   The number of buffers returned in 'iobs'; may be anything from zero to
+ *   'n'.
+ *
+ ****************************************************************************/
+
+int iob_alloc_batch(FAR struct iob_s **iobs, int n, bool throttled)
+{
+  FAR struct iob_s *list;
+  int count;
+  int i;
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  count = iob_cache_tryalloc(&list, n, throttled);
+#else
+  count = iob_tryalloc_list(&list, n, throttled);
 #endif
 
-#if CONFIG_IOB_THROTTLE > 0
-  /* Select the semaphore count to check. */
+  for (i = 0; i < count; i++)
+    {
+      FAR struct iob_s *iob = list;
 
-  sem = (throttled ? &g_throttle_sem : &g_iob_sem);
+      list = iob->io_flink;
+
+      /* Put the I/O buffer in a known state */
+
+      iob->io_flink  = NULL; /* Not in a chain */
+      iob->io_len    = 0;    /* Length of the data in the entry */
+      iob->io_offset = 0;    /* Offset to the beginning of data */
+      iob->io_pktlen = 0;    /* Total length of the packet */
+      iobs[i]        = iob;
+    }
+
+  return count;
+}
+
+/****************************************************************************
+ * Name: iob_tryalloc_list
+ *
+ * Description:
+ *   Take up to 'n' buffers from the head of the free list at once, with
+ *   the same rules and semaphore accounting as iob_tryalloc().  The buffers
+ *   are returned linked through io_flink but are otherwise not initialized.
+ *
+ * Returned Value:
+ *   The number of buffers in the list returned through 'list'.
+ *
+ ****************************************************************************/
+
+int iob_tryalloc_list(FAR struct iob_s **list, int n, bool throttled)
+{
+  FAR struct iob_s *last = NULL;
+  irqstate_t flags;
+  int count = 0;
+#if CONFIG_IOB_THROTTLE > 0
+  short semcount;
 #endif
 
   /* We don't know what context we are called from so we use extreme measures
@@ -266,62 +361,64 @@ FAR struct iob_s *iob_tryalloc(bool throttled)
 
   flags = enter_critical_section();
 
+  *list = g_iob_freelist;
+  while (count < n && g_iob_freelist != NULL)
+    {
 #if CONFIG_IOB_THROTTLE > 0
-  /* If there are free I/O buffers for this allocation */
+      /* Stop if there are no more free I/O buffers for this allocation */
 
-  if (sem->semcount > 0)
+      if (throttled && g_throttle_sem.semcount <= 0)
+        {
+          break;
+        }
 #endif
-    {
-      /* Take the I/O buffer from the head of the free list */
 
-      iob = g_iob_freelist;
-      if (iob != NULL)
-        {
-          /* Remove the I/O buffer from the free list and decrement the
-           * counting semaphore(s) that tracks the number of available
-           * IOBs.
-           */
+      /* Remove the I/O buffer from the free list and decrement the
+       * counting semaphore(s) that tracks the number of available IOBs.
+       */
 
-          g_iob_freelist = iob->io_flink;
+      last           = g_iob_freelist;
+      g_iob_freelist = last->io_flink;
 
-          /* Take a semaphore count.  Note that we cannot do this in
-           * in the orthodox way by calling nxsem_wait() or nxsem_trywait()
-           * because this function may be called from an interrupt
-           * handler. Fortunately we know at at least one free buffer
-           * so a simple decrement is all that is needed.
-           */
+      /* Take a semaphore count.  Note that we cannot do this in
+       * in the orthodox way by calling nxsem_wait() or nxsem_trywait()
+       * because this function may be called from an interrupt
+       * handler. Fortunately we know at at least one free buffer
+       * so a simple decrement is all that is needed.
+       */
 
-          g_iob_sem.semcount--;
-          DEBUGASSERT(g_iob_sem.semcount >= 0);
+      atomic_fetch_sub(NXSEM_COUNT(&g_iob_sem), 1);
+      DEBUGASSERT(g_iob_sem.semcount >= 0);
 
 #if CONFIG_IOB_THROTTLE > 0
-          /* The throttle semaphore is used to throttle the number of
-           * free buffers that are available.  It is used to prevent
-           * the overrunning of the free buffer list. Please note that
-           * it can only be decremented to zero, which indicates no
-           * throttled buffers are available.
-           */
+      /* The throttle semaphore is used to throttle the number of
+       * free buffers that are available.  It is used to prevent
+       * the overrunning of the free buffer list. Please note that
+       * it can only be decremented to zero, which indicates no
+       * throttled buffers are available.
+       */
 
-          if (g_throttle_sem.semcount > 0)
-            {
-              g_throttle_sem.semcount--;
-            }
+      semcount = atomic_load(NXSEM_COUNT(&g_throttle_sem));
+      while (semcount > 0 &&
+             !atomic_compare_exchange_weak(NXSEM_COUNT(&g_throttle_sem),
+                                           &semcount, semcount - 1));
 #endif
 
-          leave_critical_section(flags);
+      count++;
+    }
 
-          /* Put the I/O buffer in a known state */
+  leave_critical_section(flags);
 
-          iob->io_flink  = NULL; /* Not in a chain */
-          iob->io_len    = 0;    /* Length of the data in the entry */
-          iob->io_offset = 0;    /* Offset to the beginning of data */
-          iob->io_pktlen = 0;    /* Total length of the packet */
-          return iob;
-        }
+  if (last != NULL)
+    {
+      last->io_flink = NULL;
+    }
+  else
+    {
+      *list = NULL;
     }
 
-  leave_critical_section(flags);
-  return NULL;
+  return count;
 }
 
 #ifdef CONFIG_IOB_ALLOC
@@ -361,6 +458,10 @@ FAR struct iob_s *iob_alloc_dynamic(uint16_t size)
       iob->io_free    = iob_free_dynamic; /* Customer free callback */
       iob->io_data    = (FAR uint8_t *)ROUNDUP((uintptr_t)(iob + 1),
                                                CONFIG_IOB_ALIGNMENT);
+#ifdef CONFIG_IOB_SHARE
+      iob->io_shared  = NULL;
+      atomic_init(&iob->io_refs, 0);
+#endif
     }
 
   return iob;
@@ -406,6 +507,10 @@ FAR struct iob_s *iob_alloc_with_data(FAR void *data, uint16_t size,
       iob->io_pktlen  = 0;       /* Total length of the packet */
       iob->io_free    = free_cb; /* Customer free callback */
       iob->io_data    = data;
+#ifdef CONFIG_IOB_SHARE
+      iob->io_shared  = NULL;
+      atomic_init(&iob->io_refs, 0);
+#endif
     }
 
   return iob;
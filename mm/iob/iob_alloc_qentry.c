@@ -219,7 +219,7 @@ FAR struct iob_qentry_s *iob_tryalloc_qentry(void)
        * so a simple decrement is all that is needed.
        */
 
-      g_qentry_sem.semcount--;
+      atomic_fetch_sub(NXSEM_COUNT(&g_qentry_sem), 1);
       DEBUGASSERT(g_qentry_sem.semcount >= 0);
 
       /* Put the I/O buffer in a known state */
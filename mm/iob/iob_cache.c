@@ -0,0 +1,333 @@
+/****************************************************************************
+ * mm/iob/iob_cache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <assert.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/mm/iob.h>
+
+#include "iob.h"
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* The per-CPU caches of free I/O buffers.  Allocations and frees on a CPU
+ * normally only touch the cache of that CPU, so its lock is uncontended;
+ * g_iob_sem and the free list are only visited once per IOB_CACHE_BATCH
+ * buffers.
+ */
+
+struct iob_cache_s g_iob_cache[CONFIG_SMP_NCPUS];
+
+/* The number of threads blocked in iob_alloc() */
+
+volatile int g_iob_nwaiters;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_cache_take
+ *
+ * Description:
+ *   Detach the first 'n' buffers of a cache.  The cache must be locked and
+ *   hold at least 'n' buffers.
+ *
+ ****************************************************************************/
+
+static FAR struct iob_s *iob_cache_take(FAR struct iob_cache_s *cache,
+                                        int n)
+{
+  FAR struct iob_s *list = cache->head;
+  FAR struct iob_s *last = list;
+  int i;
+
+  DEBUGASSERT(n > 0 && n <= cache->count);
+
+  for (i = 1; i < n; i++)
+    {
+      last = last->io_flink;
+    }
+
+  cache->head    = last->io_flink;
+  cache->count  -= n;
+  last->io_flink = NULL;
+  return list;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_cache_tryalloc
+ *
+ * Description:
+ *   Take up to 'n' buffers from the cache of the current CPU, refilling the
+ *   cache from the free list if it runs empty.  The buffers are returned
+ *   linked through io_flink but are otherwise not initialized.
+ *
+ * Returned Value:
+ *   The number of buffers in the list returned through 'list'.
+ *
+ ****************************************************************************/
+
+int iob_cache_tryalloc(FAR struct iob_s **list, int n, bool throttled)
+{
+  FAR struct iob_cache_s *cache = &g_iob_cache[this_cpu()];
+  FAR struct iob_s *more;
+  FAR struct iob_s *rest;
+  FAR struct iob_s *last;
+  irqstate_t flags;
+  bool refill = true;
+  int limit = n;
+  int count = 0;
+  int nmore;
+  int ntake;
+  int i;
+
+  *list = NULL;
+
+#if CONFIG_IOB_THROTTLE > 0
+  /* A throttled allocation may only use the cached buffers as long as
+   * more than CONFIG_IOB_THROTTLE buffers are free in total.
+   */
+
+  if (throttled)
+    {
+      int navail = iob_navail(true);
+
+      if (navail < limit)
+        {
+          limit = navail;
+        }
+    }
+#endif
+
+  /* If we migrate to another CPU after reading this_cpu(), we just use the
+   * cache of the CPU that we came from.  The lock keeps this safe.
+   */
+
+  if (limit > 0)
+    {
+      flags = spin_lock_irqsave(&cache->lock);
+
+      count = cache->count < limit ? cache->count : limit;
+      if (count > 0)
+        {
+          *list = iob_cache_take(cache, count);
+        }
+
+      refill = cache->count == 0;
+      spin_unlock_irqrestore(&cache->lock, flags);
+    }
+
+  if (count >= n)
+    {
+      return count;
+    }
+
+  /* Go to the free list for the rest.  Take another batch for the cache if
+   * it ran empty, unless there are threads waiting; those buffers would
+   * then be hidden from them.
+   */
+
+  nmore = n - count;
+  if (refill && g_iob_nwaiters == 0)
+    {
+      nmore += IOB_CACHE_BATCH;
+    }
+
+  nmore = iob_tryalloc_list(&more, nmore, throttled);
+  if (nmore == 0)
+    {
+      return count;
+    }
+
+  /* Hand the first ones to the caller */
+
+  ntake = nmore < n - count ? nmore : n - count;
+  for (last = more, i = 1; i < ntake; i++)
+    {
+      last = last->io_flink;
+    }
+
+  rest           = last->io_flink;
+  last->io_flink = *list;
+  *list          = more;
+  count         += ntake;
+
+  /* And keep the remainder in the cache */
+
+  if (rest != NULL)
+    {
+      last = rest;
+      while (last->io_flink != NULL)
+        {
+          last = last->io_flink;
+        }
+
+      flags = spin_lock_irqsave(&cache->lock);
+
+      last->io_flink = cache->head;
+      cache->head    = rest;
+      cache->count  += nmore - ntake;
+
+      spin_unlock_irqrestore(&cache->lock, flags);
+    }
+
+  return count;
+}
+
+/****************************************************************************
+ * Name: iob_cache_free
+ *
+ * Description:
+ *   Put a list of 'n' buffers linked through io_flink in the cache of the
+ *   current CPU, spilling part of the cache to the free list if it
+ *   overflows.
+ *
+ * Returned Value:
+ *   True if the buffers were taken.  False if there are threads waiting
+ *   for a buffer; the buffers must then be returned to the free list
+ *   directly.
+ *
+ ****************************************************************************/
+
+bool iob_cache_free(FAR struct iob_s *list, int n)
+{
+  FAR struct iob_cache_s *cache = &g_iob_cache[this_cpu()];
+  FAR struct iob_s *spill = NULL;
+  FAR struct iob_s *last;
+  irqstate_t flags;
+  int nspill = 0;
+
+  last = list;
+  while (last->io_flink != NULL)
+    {
+      last = last->io_flink;
+    }
+
+  flags = spin_lock_irqsave(&cache->lock);
+
+  /* g_iob_nwaiters is raised before the waiter drains the caches, and the
+   * drain takes this lock; so either the waiter sees these buffers or we
+   * see the waiter.
+   */
+
+  if (g_iob_nwaiters > 0)
+    {
+      spin_unlock_irqrestore(&cache->lock, flags);
+      return false;
+    }
+
+  last->io_flink = cache->head;
+  cache->head    = list;
+  cache->count  += n;
+
+  if (cache->count > CONFIG_IOB_PERCPU_CACHE)
+    {
+      nspill = cache->count - CONFIG_IOB_PERCPU_CACHE + IOB_CACHE_BATCH;
+      spill  = iob_cache_take(cache, nspill);
+    }
+
+  spin_unlock_irqrestore(&cache->lock, flags);
+
+  if (spill != NULL)
+    {
+      iob_free_list(spill, nspill);
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: iob_cache_drain
+ *
+ * Description:
+ *   Return the buffers of all per-CPU caches to the free list.
+ *
+ ****************************************************************************/
+
+void iob_cache_drain(void)
+{
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      FAR struct iob_cache_s *cache = &g_iob_cache[cpu];
+      FAR struct iob_s *list = NULL;
+      irqstate_t flags;
+      int n;
+
+      flags = spin_lock_irqsave(&cache->lock);
+
+      n = cache->count;
+      if (n > 0)
+        {
+          list = iob_cache_take(cache, n);
+        }
+
+      spin_unlock_irqrestore(&cache->lock, flags);
+
+      if (list != NULL)
+        {
+          iob_free_list(list, n);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: iob_cache_navail
+ *
+ * Description:
+ *   Return the number of buffers held in the per-CPU caches.
+ *
+ ****************************************************************************/
+
+int iob_cache_navail(void)
+{
+  int navail = 0;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      navail += g_iob_cache[cpu].count;
+    }
+
+  return navail;
+}
+
+#endif /* CONFIG_IOB_PERCPU_CACHE > 0 */
@@ -64,71 +64,25 @@
 #define IOB_MASK      (IOB_DIVIDER - 1)
 
 /****************************************************************************
- * Public Functions
+ * Private Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: iob_free
+ * Name: iob_free_one
  *
  * Description:
- *   Free the I/O buffer at the head of a buffer chain returning it to the
- *   free list.  The link to  the next I/O buffer in the chain is return.
+ *   Return one I/O buffer to the free list, or hand it over to a thread
+ *   that is waiting for one.
  *
  ****************************************************************************/
 
-FAR struct iob_s *iob_free(FAR struct iob_s *iob)
+static void iob_free_one(FAR struct iob_s *iob)
 {
-  FAR struct iob_s *next = iob->io_flink;
   irqstate_t flags;
-#ifdef CONFIG_IOB_NOTIFIER
-  int16_t navail;
-#endif
 #if CONFIG_IOB_THROTTLE > 0
   bool committed_thottled = false;
 #endif
 
-  iobinfo("iob=%p io_pktlen=%u io_len=%u next=%p\n",
-          iob, iob->io_pktlen, iob->io_len, next);
-
-  /* Copy the data that only exists in the head of a I/O buffer chain into
-   * the next entry.
-   */
-
-  if (next != NULL)
-    {
-      /* Copy and decrement the total packet length, being careful to
-       * do nothing too crazy.
-       */
-
-      if (iob->io_pktlen > iob->io_len)
-        {
-          /* Adjust packet length and move it to the next entry */
-
-          next->io_pktlen = iob->io_pktlen - iob->io_len;
-          DEBUGASSERT(next->io_pktlen >= next->io_len);
-        }
-      else
-        {
-          /* This can only happen if the free entry isn't first entry in the
-           * chain...
-           */
-
-          next->io_pktlen = 0;
-        }
-
-      iobinfo("next=%p io_pktlen=%u io_len=%u\n",
-              next, next->io_pktlen, next->io_len);
-    }
-
-#ifdef CONFIG_IOB_ALLOC
-  if (iob->io_free != NULL)
-    {
-      iob->io_free(iob->io_data);
-      kmm_free(iob);
-      return next;
-    }
-#endif
-
   /* Free the I/O buffer by adding it to the head of the free or the
    * committed list. We don't know what context we are called from so
    * we use extreme measures to protect the free list:  We disable
@@ -202,7 +156,7 @@ FAR struct iob_s *iob_free(FAR struct iob_s *iob)
 
       if (committed_thottled)
         {
-          g_iob_sem.semcount--;
+          atomic_fetch_sub(NXSEM_COUNT(&g_iob_sem), 1);
         }
 
       leave_critical_section(flags);
@@ -218,14 +172,29 @@ FAR struct iob_s *iob_free(FAR struct iob_s *iob)
 #endif
 
   sched_unlock();
+}
+
+/****************************************************************************
+ * Name: iob_free_notify
+ *
+ * Description:
+ *   'nfreed' buffers have just been freed.  Signal the notifier if the
+ *   number of available buffers went through a multiple of IOB_DIVIDER.
+ *
+ ****************************************************************************/
 
 #ifdef CONFIG_IOB_NOTIFIER
+static void iob_free_notify(int nfreed)
+{
+  int navail;
+
   /* Check if the IOB was claimed by a thread that is blocked waiting
    * for an IOB.
    */
 
   navail = iob_navail(false);
-  if (navail > 0 && (navail & IOB_MASK) == 0)
+  if (navail > 0 &&
+      (navail & ~IOB_MASK) != ((navail - nfreed) & ~IOB_MASK))
     {
       /* Signal any threads that have requested a signal notification
        * when an IOB becomes available.
@@ -233,9 +202,237 @@ FAR struct iob_s *iob_free(FAR struct iob_s *iob)
 
       iob_notifier_signal();
     }
+}
+#else
+#  define iob_free_notify(n)
 #endif
 
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_free
+ *
+ * Description:
+ *   Free the I/O buffer at the head of a buffer chain returning it to the
+ *   free list.  The link to  the next I/O buffer in the chain is return.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_free(FAR struct iob_s *iob)
+{
+  FAR struct iob_s *next = iob->io_flink;
+
+  iobinfo("iob=%p io_pktlen=%u io_len=%u next=%p\n",
+          iob, iob->io_pktlen, iob->io_len, next);
+
+  /* Copy the data that only exists in the head of a I/O buffer chain into
+   * the next entry.
+   */
+
+  if (next != NULL)
+    {
+      /* Copy and decrement the total packet length, being careful to
+       * do nothing too crazy.
+       */
+
+      if (iob->io_pktlen > iob->io_len)
+        {
+          /* Adjust packet length and move it to the next entry */
+
+          next->io_pktlen = iob->io_pktlen - iob->io_len;
+          DEBUGASSERT(next->io_pktlen >= next->io_len);
+        }
+      else
+        {
+          /* This can only happen if the free entry isn't first entry in the
+           * chain...
+           */
+
+          next->io_pktlen = 0;
+        }
+
+      iobinfo("next=%p io_pktlen=%u io_len=%u\n",
+              next, next->io_pktlen, next->io_len);
+    }
+
+#ifdef CONFIG_IOB_SHARE
+  if (!iob_share_release(iob))
+    {
+      return next;
+    }
+#endif
+
+#ifdef CONFIG_IOB_ALLOC
+  if (iob->io_free != NULL)
+    {
+      iob->io_free(iob->io_data);
+      kmm_free(iob);
+      return next;
+    }
+#endif
+
+  iob->io_flink = NULL;
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  if (!iob_cache_free(iob, 1))
+#endif
+    {
+      iob_free_list(iob, 1);
+    }
+
+  iob_free_notify(1);
+
   /* And return the I/O buffer after the one that was freed */
 
   return next;
 }
+
+/****************************************************************************
+ * Name: iob_free_batch
+ *
+ * Description:
+ *   Free 'n' I/O buffer chains at once.  This is the counterpart of
+ *   iob_alloc_batch(): the free list is only locked once for all of them.
+ *
+ * Input Parameters:
+ *   iobs - Array of the buffer chains to free
+ *   n    - The number of entries in 'iobs'
+ *
+ ****************************************************************************/
+
+void iob_free_batch(FAR struct iob_s **iobs, int n)
+{
+  FAR struct iob_s *list = NULL;
+  int count = 0;
+  int i;
+
+  /* Collect all buffers of all chains in one list */
+
+  for (i = 0; i < n; i++)
+    {
+      FAR struct iob_s *iob = iobs[i];
+
+      while (iob != NULL)
+        {
+          FAR struct iob_s *next = iob->io_flink;
+
+#ifdef CONFIG_IOB_SHARE
+          if (!iob_share_release(iob))
+            {
+              iob = next;
+              continue;
+            }
+#endif
+
+#ifdef CONFIG_IOB_ALLOC
+          if (iob->io_free != NULL)
+            {
+              iob->io_free(iob->io_data);
+              kmm_free(iob);
+              iob = next;
+              continue;
+            }
+#endif
+
+          iob->io_flink = list;
+          list          = iob;
+          iob           = next;
+          count++;
+        }
+    }
+
+  if (list == NULL)
+    {
+      return;
+    }
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  if (!iob_cache_free(list, count))
+#endif
+    {
+      iob_free_list(list, count);
+    }
+
+  iob_free_notify(count);
+}
+
+/****************************************************************************
+ * Name: iob_free_list
+ *
+ * Description:
+ *   Return a list of 'n' buffers linked through io_flink to the free list
+ *   (or to the committed list if there are waiters).  The buffers must not
+ *   be dynamically allocated ones.
+ *
+ ****************************************************************************/
+
+void iob_free_list(FAR struct iob_s *list, int n)
+{
+  FAR struct iob_s *last = list;
+  irqstate_t flags;
+#if CONFIG_IOB_THROTTLE > 0
+  int16_t semcount;
+#endif
+
+  while (last->io_flink != NULL)
+    {
+      last = last->io_flink;
+    }
+
+  flags = enter_critical_section();
+
+  /* If nobody is waiting for a buffer the whole list can be linked into
+   * the free list and the counts bumped at once; this is what posting the
+   * semaphores 'n' times would do.
+   */
+
+#if CONFIG_IOB_THROTTLE > 0
+  if (g_iob_sem.semcount >= 0 && g_throttle_sem.semcount >= 0)
+#else
+  if (g_iob_sem.semcount >= 0)
+#endif
+    {
+      last->io_flink  = g_iob_freelist;
+      g_iob_freelist  = list;
+
+#if CONFIG_IOB_THROTTLE > 0
+      semcount = atomic_fetch_add(NXSEM_COUNT(&g_iob_sem), n) + n;
+#else
+      atomic_fetch_add(NXSEM_COUNT(&g_iob_sem), n);
+#endif
+      DEBUGASSERT(g_iob_sem.semcount <= CONFIG_IOB_NBUFFERS);
+
+#if CONFIG_IOB_THROTTLE > 0
+      /* The throttle count only moves above CONFIG_IOB_THROTTLE */
+
+      if (semcount > CONFIG_IOB_THROTTLE)
+        {
+          int16_t base = semcount - n;
+
+          if (base < CONFIG_IOB_THROTTLE)
+            {
+              base = CONFIG_IOB_THROTTLE;
+            }
+
+          atomic_fetch_add(NXSEM_COUNT(&g_throttle_sem), semcount - base);
+        }
+#endif
+
+      leave_critical_section(flags);
+      return;
+    }
+
+  leave_critical_section(flags);
+
+  /* Otherwise free them one at a time so that the waiters get them */
+
+  while (list != NULL)
+    {
+      FAR struct iob_s *next = list->io_flink;
+
+      iob_free_one(list);
+      list = next;
+    }
+}
@@ -146,6 +146,10 @@ void iob_initialize(void)
 #ifdef CONFIG_IOB_ALLOC
       iob->io_bufsize = CONFIG_IOB_BUFSIZE;
       iob->io_data    = (FAR uint8_t *)(iob + 1);
+#  ifdef CONFIG_IOB_SHARE
+      iob->io_shared  = NULL;
+      atomic_init(&iob->io_refs, 0);
+#  endif
 #endif
       g_iob_freelist  = iob;
     }
@@ -165,4 +169,11 @@ void iob_initialize(void)
       g_iob_freeqlist = iobq;
     }
 #endif
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      spin_lock_init(&g_iob_cache[i].lock);
+    }
+#endif
 }
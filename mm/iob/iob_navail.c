@@ -57,6 +57,12 @@ int iob_navail(bool throttled)
     {
       ret = navail;
 
+#if CONFIG_IOB_PERCPU_CACHE > 0
+      /* The buffers in the per-CPU caches are free too */
+
+      ret += iob_cache_navail();
+#endif
+
 #if CONFIG_IOB_THROTTLE > 0
       /* Subtract the throttle value is so requested */
 
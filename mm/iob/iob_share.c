@@ -0,0 +1,195 @@
+/****************************************************************************
+ * mm/iob/iob_share.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <debug.h>
+
+#include <nuttx/mm/iob.h>
+
+#include "iob.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_share_free
+ *
+ * Description:
+ *   Free callback of the shared buffers.  The payload belongs to the buffer
+ *   it was taken from, which is released by iob_share_release().
+ *
+ ****************************************************************************/
+
+static void iob_share_free(FAR void *data)
+{
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_share_release
+ *
+ * Description:
+ *   Drop one use of the payload of iob.  If it is still referenced by
+ *   another chain, iob is unlinked and kept and false is returned.
+ *   Otherwise the buffer whose payload iob references, if any, is released
+ *   too and true is returned: iob may be freed.
+ *
+ ****************************************************************************/
+
+bool iob_share_release(FAR struct iob_s *iob)
+{
+  FAR struct iob_s *owner;
+
+  /* io_refs counts the users besides the first one, so whoever finds it
+   * at zero is the last one.  Unlink the buffer first: once io_refs is
+   * dropped, the last user may free it at any time.
+   */
+
+  iob->io_flink = NULL;
+  if (atomic_fetch_sub(&iob->io_refs, 1) > 0)
+    {
+      return false;
+    }
+
+  atomic_store(&iob->io_refs, 0);
+
+  /* Drop the use of the payload this buffer references.  The owner is
+   * still linked in its own chain unless that was freed already, in which
+   * case this was the last use and the owner is freed now.
+   */
+
+  owner = iob->io_shared;
+  if (owner != NULL)
+    {
+      iob->io_shared = NULL;
+      if (atomic_fetch_sub(&owner->io_refs, 1) == 0)
+        {
+          atomic_store(&owner->io_refs, 0);
+          iob_free(owner);
+        }
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: iob_share
+ *
+ * Description:
+ *   Create a chain that references 'len' bytes of iob, starting at
+ *   'offset', without copying them.  Each buffer of the new chain points
+ *   into the payload of a buffer of iob, which is kept until both chains
+ *   are freed.  The data of both chains must not be modified after this;
+ *   trimming either chain is fine.
+ *
+ * Input Parameters:
+ *   iob    - Pointer to source iob_s
+ *   len    - Number of bytes to reference
+ *   offset - Offset of the first byte in iob
+ *
+ * Returned Value:
+ *   The new chain, or NULL if len is zero or memory is exhausted.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_share(FAR struct iob_s *iob, unsigned int len,
+                            unsigned int offset)
+{
+  FAR struct iob_s *head = NULL;
+  FAR struct iob_s *tail = NULL;
+  FAR struct iob_s *owner;
+  FAR struct iob_s *ref;
+  unsigned int pktlen = 0;
+  unsigned int nref;
+
+  /* Skip the I/O buffers before the offset */
+
+  while (iob != NULL && offset >= iob->io_len)
+    {
+      offset -= iob->io_len;
+      iob     = iob->io_flink;
+    }
+
+  while (iob != NULL && len > 0)
+    {
+      nref = MIN(iob->io_len - offset, len);
+      if (nref > 0)
+        {
+          /* Reference the buffer that holds the payload, so that sharing
+           * a shared chain does not build chains of references.
+           */
+
+          owner = iob->io_shared != NULL ? iob->io_shared : iob;
+
+          ref = iob_alloc_with_data(owner->io_data, owner->io_bufsize,
+                                    iob_share_free);
+          if (ref == NULL)
+            {
+              ioberr("ERROR: Failed to allocate a shared I/O buffer\n");
+              if (head != NULL)
+                {
+                  iob_free_chain(head);
+                }
+
+              return NULL;
+            }
+
+          ref->io_offset = iob->io_offset + offset;
+          ref->io_len    = nref;
+          ref->io_shared = owner;
+          atomic_fetch_add(&owner->io_refs, 1);
+
+          if (tail == NULL)
+            {
+              head = ref;
+            }
+          else
+            {
+              tail->io_flink = ref;
+            }
+
+          tail    = ref;
+          pktlen += nref;
+          len    -= nref;
+        }
+
+      offset = 0;
+      iob    = iob->io_flink;
+    }
+
+  if (head != NULL)
+    {
+      head->io_pktlen = pktlen;
+    }
+
+  return head;
+}
@@ -57,6 +57,9 @@ void iob_getstats(FAR struct iob_stats_s *stats)
   stats->ntotal = CONFIG_IOB_NBUFFERS;
 
   nxsem_get_value(&g_iob_sem, &stats->nfree);
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  stats->nfree += iob_cache_navail();
+#endif
   if (stats->nfree < 0)
     {
       stats->nwait = -stats->nfree;
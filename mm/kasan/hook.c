@@ -25,6 +25,7 @@
 #include <nuttx/mm/kasan.h>
 #include <nuttx/compiler.h>
 #include <nuttx/irq.h>
+#include <nuttx/sched.h>
 
 #include <assert.h>
 #include <debug.h>
@@ -94,6 +95,12 @@
 #  define MM_KASAN_WATCHPOINT 0
 #endif
 
+#ifdef CONFIG_MM_KASAN_SAMPLE_INTERVAL
+#  define MM_KASAN_SAMPLE_INTERVAL CONFIG_MM_KASAN_SAMPLE_INTERVAL
+#else
+#  define MM_KASAN_SAMPLE_INTERVAL 1
+#endif
+
 #define KASAN_INIT_VALUE 0xcafe
 
 /****************************************************************************
@@ -117,6 +124,11 @@ static struct kasan_watchpoint_s g_watchpoint[MM_KASAN_WATCHPOINT];
 
 static uint32_t g_region_init;
 
+#if MM_KASAN_SAMPLE_INTERVAL > 1
+static uint32_t g_sample_count[CONFIG_SMP_NCPUS];
+static uint32_t g_sample_seed[CONFIG_SMP_NCPUS];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -221,6 +233,34 @@ static void kasan_check_watchpoint(FAR const void *addr, size_t size,
 }
 #endif
 
+/* Tell if the shadow of this access is checked.  With the sampling, the
+ * accesses are skipped by random counts, of MM_KASAN_SAMPLE_INTERVAL on
+ * average, so that a loop of the same period still gets all its accesses
+ * checked in turn.  The counts are per CPU, an interrupt in between only
+ * miscounting one.
+ */
+
+#if MM_KASAN_SAMPLE_INTERVAL > 1
+static inline_function bool kasan_sample(void)
+{
+  int cpu = this_cpu();
+  uint32_t seed;
+
+  if (predict_true(g_sample_count[cpu] > 1))
+    {
+      g_sample_count[cpu]--;
+      return false;
+    }
+
+  seed = g_sample_seed[cpu] * 1103515245 + 12345;
+  g_sample_seed[cpu]  = seed;
+  g_sample_count[cpu] = 1 + (seed >> 8) % (2 * MM_KASAN_SAMPLE_INTERVAL - 1);
+  return true;
+}
+#else
+#  define kasan_sample() true
+#endif
+
 static inline void kasan_check_report(FAR const void *addr, size_t size,
                                       bool is_write,
                                       FAR void *return_address)
@@ -238,7 +278,7 @@ static inline void kasan_check_report(FAR const void *addr, size_t size,
 #endif
 
 #ifndef CONFIG_MM_KASAN_NONE
-  if (predict_false(kasan_is_poisoned(addr, size)))
+  if (kasan_sample() && predict_false(kasan_is_poisoned(addr, size)))
     {
       kasan_report(addr, size, is_write, return_address);
     }
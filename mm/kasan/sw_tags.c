@@ -68,6 +68,7 @@ struct kasan_region_s
  ****************************************************************************/
 
 static FAR struct kasan_region_s *g_region[CONFIG_MM_KASAN_REGIONS];
+static FAR struct kasan_region_s *g_region_hit;
 static int g_region_count;
 static spinlock_t g_lock;
 
@@ -78,22 +79,36 @@ static spinlock_t g_lock;
 static inline_function FAR uint8_t *
 kasan_mem_to_shadow(FAR const void *ptr, size_t size)
 {
+  FAR struct kasan_region_s *region = g_region_hit;
   uintptr_t addr;
   int i;
 
   addr = (uintptr_t)kasan_reset_tag(ptr);
 
-  for (i = 0; i < g_region_count; i++)
+  /* Most accesses are in the region of the previous one */
+
+  if (region == NULL || addr < region->begin || addr >= region->end)
     {
-      if (addr >= g_region[i]->begin && addr < g_region[i]->end)
+      for (i = 0; ; i++)
         {
-          DEBUGASSERT(addr + size <= g_region[i]->end);
-          addr -= g_region[i]->begin;
-          return &g_region[i]->shadow[addr / KASAN_SHADOW_SCALE];
+          if (i == g_region_count)
+            {
+              return NULL;
+            }
+
+          region = g_region[i];
+          if (addr >= region->begin && addr < region->end)
+            {
+              break;
+            }
         }
+
+      g_region_hit = region;
     }
 
-  return NULL;
+  DEBUGASSERT(addr + size <= region->end);
+  addr -= region->begin;
+  return &region->shadow[addr / KASAN_SHADOW_SCALE];
 }
 
 static inline_function bool
@@ -208,6 +223,11 @@ void kasan_unregister(FAR void *addr)
     {
       if (g_region[i]->begin == (uintptr_t)addr)
         {
+          if (g_region_hit == g_region[i])
+            {
+              g_region_hit = NULL;
+            }
+
           g_region_count--;
           memmove(&g_region[i], &g_region[i + 1],
                   (g_region_count - i) * sizeof(g_region[0]));
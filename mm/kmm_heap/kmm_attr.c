@@ -0,0 +1,246 @@
+/****************************************************************************
+ * mm/kmm_heap/kmm_attr.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <string.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/mm/mm.h>
+#include <nuttx/spinlock.h>
+
+#if defined(CONFIG_MM_HEAP_ATTR) && \
+    (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct kmm_attr_s
+{
+  FAR struct mm_heap_s *heap; /* The heap managing this kind of memory */
+  uint32_t attr;              /* MM_ATTR_* of the memory */
+  int node;                   /* The memory node of the memory */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Entries are only ever appended, so the lookups need no lock */
+
+static struct kmm_attr_s g_kmm_attr[CONFIG_MM_HEAP_ATTR_NHEAPS];
+static volatile int g_kmm_nattr;
+static spinlock_t g_kmm_attrlock = SP_UNLOCKED;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: kmm_attr_alloc
+ *
+ * Description:
+ *   Try the registered heaps that have all of the requested attributes and
+ *   match the node, in registration order, then fall back to the kernel
+ *   heap unless MM_ATTR_STRICT is given.
+ *
+ ****************************************************************************/
+
+static FAR void *kmm_attr_alloc(uint32_t attr, int node, size_t alignment,
+                                size_t size)
+{
+  uint32_t want = attr & ~MM_ATTR_STRICT;
+  FAR void *mem;
+  int nattr = g_kmm_nattr;
+  int i;
+
+  for (i = 0; i < nattr; i++)
+    {
+      FAR struct kmm_attr_s *entry = &g_kmm_attr[i];
+
+      if ((entry->attr & want) != want ||
+          (node != MM_NODE_ANY && entry->node != node))
+        {
+          continue;
+        }
+
+      mem = alignment > 0 ? mm_memalign(entry->heap, alignment, size) :
+                            mm_malloc(entry->heap, size);
+      if (mem != NULL)
+        {
+          return mem;
+        }
+    }
+
+  if ((attr & MM_ATTR_STRICT) != 0)
+    {
+      return NULL;
+    }
+
+  return alignment > 0 ? kmm_memalign(alignment, size) : kmm_malloc(size);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: kmm_attr_register
+ *
+ * Description:
+ *   Make a heap available to the placement aware allocators.  The heap is
+ *   typically created by up_extraheaps_init() over a TCM, SRAM or PSRAM
+ *   bank with mm_initialize().  Heaps are never unregistered.
+ *
+ * Input Parameters:
+ *   heap - The heap managing the memory
+ *   attr - The MM_ATTR_* flags that describe the memory
+ *   node - The memory node of the memory, or MM_NODE_ANY
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOSPC if CONFIG_MM_HEAP_ATTR_NHEAPS heaps are
+ *   already registered.
+ *
+ ****************************************************************************/
+
+int kmm_attr_register(FAR struct mm_heap_s *heap, uint32_t attr, int node)
+{
+  irqstate_t flags;
+  int ret = OK;
+
+  DEBUGASSERT(heap != NULL);
+
+  flags = spin_lock_irqsave(&g_kmm_attrlock);
+  if (g_kmm_nattr < CONFIG_MM_HEAP_ATTR_NHEAPS)
+    {
+      g_kmm_attr[g_kmm_nattr].heap = heap;
+      g_kmm_attr[g_kmm_nattr].attr = attr & ~MM_ATTR_STRICT;
+      g_kmm_attr[g_kmm_nattr].node = node;
+      SP_DMB();
+      g_kmm_nattr++;
+    }
+  else
+    {
+      ret = -ENOSPC;
+    }
+
+  spin_unlock_irqrestore(&g_kmm_attrlock, flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: kmm_malloc_attr
+ *
+ * Description:
+ *   Allocate kernel memory, preferably from a registered heap that has all
+ *   the attributes in 'attr' and is on 'node'.
+ *
+ * Input Parameters:
+ *   attr - The MM_ATTR_* flags wanted.  Without MM_ATTR_STRICT they are
+ *          only a hint and the kernel heap is used if no such memory is
+ *          available.
+ *   node - The memory node wanted, or MM_NODE_ANY
+ *   size - Size (in bytes) of the memory region to be allocated.
+ *
+ * Returned Value:
+ *   The address of the allocated memory (NULL on failure to allocate).
+ *   It must be released with kmm_free_attr().
+ *
+ ****************************************************************************/
+
+FAR void *kmm_malloc_attr(uint32_t attr, int node, size_t size)
+{
+  return kmm_attr_alloc(attr, node, 0, size);
+}
+
+/****************************************************************************
+ * Name: kmm_zalloc_attr
+ *
+ * Description:
+ *   Like kmm_malloc_attr(), but the memory is zeroed.
+ *
+ ****************************************************************************/
+
+FAR void *kmm_zalloc_attr(uint32_t attr, int node, size_t size)
+{
+  FAR void *mem = kmm_attr_alloc(attr, node, 0, size);
+
+  if (mem != NULL)
+    {
+      memset(mem, 0, size);
+    }
+
+  return mem;
+}
+
+/****************************************************************************
+ * Name: kmm_memalign_attr
+ *
+ * Description:
+ *   Like kmm_malloc_attr(), but the memory is aligned to 'alignment'.
+ *
+ ****************************************************************************/
+
+FAR void *kmm_memalign_attr(uint32_t attr, int node, size_t alignment,
+                            size_t size)
+{
+  return kmm_attr_alloc(attr, node, alignment, size);
+}
+
+/****************************************************************************
+ * Name: kmm_free_attr
+ *
+ * Description:
+ *   Release memory allocated by kmm_malloc_attr() and friends to whatever
+ *   heap it came from.  Plain kernel heap memory may be released this way
+ *   as well.
+ *
+ * Input Parameters:
+ *   mem - The memory to release, may be NULL
+ *
+ ****************************************************************************/
+
+void kmm_free_attr(FAR void *mem)
+{
+  int nattr = g_kmm_nattr;
+  int i;
+
+  for (i = 0; mem != NULL && i < nattr; i++)
+    {
+      if (mm_heapmember(g_kmm_attr[i].heap, mem))
+        {
+          mm_free(g_kmm_attr[i].heap, mem);
+          return;
+        }
+    }
+
+  kmm_free(mem);
+}
+
+#endif /* CONFIG_MM_HEAP_ATTR */
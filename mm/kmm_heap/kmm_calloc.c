@@ -26,6 +26,8 @@
 
 #include <nuttx/config.h>
 
+#include <nuttx/mm/heapprof.h>
+#include <nuttx/mm/heaptag.h>
 #include <nuttx/mm/mm.h>
 
 #ifdef CONFIG_MM_KERNEL_HEAP
@@ -44,7 +46,11 @@
 
 FAR void *kmm_calloc(size_t n, size_t elem_size)
 {
-  return mm_calloc(g_kmmheap, n, elem_size);
+  FAR void *mem = mm_calloc(g_kmmheap, n, elem_size);
+
+  MM_HEAPPROF_ALLOC(mem, n * elem_size);
+  MM_HEAPTAG_ALLOC(mem, n * elem_size);
+  return mem;
 }
 
 #endif /* CONFIG_MM_KERNEL_HEAP */
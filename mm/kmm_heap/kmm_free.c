@@ -29,6 +29,8 @@
 #include <assert.h>
 #include <debug.h>
 
+#include <nuttx/mm/heapprof.h>
+#include <nuttx/mm/heaptag.h>
 #include <nuttx/mm/mm.h>
 
 #ifdef CONFIG_MM_KERNEL_HEAP
@@ -55,6 +57,8 @@
 void kmm_free(FAR void *mem)
 {
   DEBUGASSERT((mem == NULL) || kmm_heapmember(mem));
+  MM_HEAPPROF_FREE(mem);
+  MM_HEAPTAG_FREE(mem);
   mm_free(g_kmmheap, mem);
 }
 
@@ -26,6 +26,8 @@
 
 #include <nuttx/config.h>
 
+#include <nuttx/mm/heapprof.h>
+#include <nuttx/mm/heaptag.h>
 #include <nuttx/mm/mm.h>
 
 #ifdef CONFIG_MM_KERNEL_HEAP
@@ -50,7 +52,11 @@
 
 FAR void *kmm_malloc(size_t size)
 {
-  return mm_malloc(g_kmmheap, size);
+  FAR void *mem = mm_malloc(g_kmmheap, size);
+
+  MM_HEAPPROF_ALLOC(mem, size);
+  MM_HEAPTAG_ALLOC(mem, size);
+  return mem;
 }
 
 #endif /* CONFIG_MM_KERNEL_HEAP */
@@ -28,6 +28,8 @@
 
 #include <stdlib.h>
 
+#include <nuttx/mm/heapprof.h>
+#include <nuttx/mm/heaptag.h>
 #include <nuttx/mm/mm.h>
 
 #ifdef CONFIG_MM_KERNEL_HEAP
@@ -53,7 +55,11 @@
 
 FAR void *kmm_memalign(size_t alignment, size_t size)
 {
-  return mm_memalign(g_kmmheap, alignment, size);
+  FAR void *mem = mm_memalign(g_kmmheap, alignment, size);
+
+  MM_HEAPPROF_ALLOC(mem, size);
+  MM_HEAPTAG_ALLOC(mem, size);
+  return mem;
 }
 
 #endif /* CONFIG_MM_KERNEL_HEAP */
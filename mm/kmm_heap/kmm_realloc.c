@@ -26,6 +26,8 @@
 
 #include <nuttx/config.h>
 
+#include <nuttx/mm/heapprof.h>
+#include <nuttx/mm/heaptag.h>
 #include <nuttx/mm/mm.h>
 
 #ifdef CONFIG_MM_KERNEL_HEAP
@@ -51,7 +53,14 @@
 
 FAR void *kmm_realloc(FAR void *oldmem, size_t newsize)
 {
-  return mm_realloc(g_kmmheap, oldmem, newsize);
+  FAR void *mem;
+
+  MM_HEAPPROF_FREE(oldmem);
+  MM_HEAPTAG_FREE(oldmem);
+  mem = mm_realloc(g_kmmheap, oldmem, newsize);
+  MM_HEAPPROF_ALLOC(mem, newsize);
+  MM_HEAPTAG_ALLOC(mem, newsize);
+  return mem;
 }
 
 #endif /* CONFIG_MM_KERNEL_HEAP */
@@ -38,20 +38,131 @@
 
 #if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define MM_MAP_END(e)  ((uintptr_t)(e)->vaddr + (e)->length)
+
+/* Keep the highest end address of each subtree up to date, see below */
+
+#undef RB_AUGMENT
+#define RB_AUGMENT(e)  mm_map_augment(e)
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void mm_map_augment(FAR struct mm_map_entry_s *entry);
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
-static bool in_range(FAR const void *start, size_t length,
-                     FAR const void *range_start, size_t range_length)
+/****************************************************************************
+ * Name: mm_map_compare
+ *
+ * Description:
+ *   The mappings are sorted by address.  Those of the same address, which
+ *   may overlap, are sorted by the address of their entry.
+ *
+ ****************************************************************************/
+
+static int mm_map_compare(FAR struct mm_map_entry_s *a,
+                          FAR struct mm_map_entry_s *b)
+{
+  if (a->vaddr != b->vaddr)
+    {
+      return (uintptr_t)a->vaddr < (uintptr_t)b->vaddr ? -1 : 1;
+    }
+
+  if (a != b)
+    {
+      return (uintptr_t)a < (uintptr_t)b ? -1 : 1;
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: RB_GENERATE_STATIC
+ ****************************************************************************/
+
+RB_GENERATE_STATIC(mm_map_tree_s, mm_map_entry_s, node, mm_map_compare)
+
+/****************************************************************************
+ * Name: mm_map_augment
+ *
+ * Description:
+ *   Compute again the highest end address of the subtree of entry, from
+ *   those of its children, and then those of its parents.  The tree calls
+ *   it for each node whose children have changed.
+ *
+ ****************************************************************************/
+
+static void mm_map_augment(FAR struct mm_map_entry_s *entry)
 {
-  FAR const char *u_start = (FAR const char *)start;
-  FAR const char *u_end = u_start + length;
-  FAR const char *r_start = (FAR const char *)range_start;
-  FAR const char *r_end = r_start + range_length;
+  FAR struct mm_map_entry_s *child;
+  uintptr_t maxend;
+
+  for (; entry != NULL; entry = RB_PARENT(entry, node))
+    {
+      maxend = MM_MAP_END(entry);
 
-  return (u_start >= r_start && u_start < r_end && /* Start is in range. */
-          u_end >= r_start && u_end <= r_end);     /* End is in range. */
+      child = RB_LEFT(entry, node);
+      if (child != NULL && child->maxend > maxend)
+        {
+          maxend = child->maxend;
+        }
+
+      child = RB_RIGHT(entry, node);
+      if (child != NULL && child->maxend > maxend)
+        {
+          maxend = child->maxend;
+        }
+
+      entry->maxend = maxend;
+    }
+}
+
+/****************************************************************************
+ * Name: mm_map_search
+ *
+ * Description:
+ *   Find in the subtree of entry the mapping, of the lowest address, that
+ *   contains the range from start to end.  The subtrees ending below end
+ *   are skipped, and so are those starting above start.
+ *
+ ****************************************************************************/
+
+static FAR struct mm_map_entry_s *
+mm_map_search(FAR struct mm_map_entry_s *entry, uintptr_t start,
+              uintptr_t end)
+{
+  FAR struct mm_map_entry_s *found;
+
+  while (entry != NULL && entry->maxend >= end)
+    {
+      found = mm_map_search(RB_LEFT(entry, node), start, end);
+      if (found != NULL)
+        {
+          return found;
+        }
+
+      if ((uintptr_t)entry->vaddr > start)
+        {
+          break;
+        }
+
+      if (start < MM_MAP_END(entry) && end <= MM_MAP_END(entry))
+        {
+          return entry;
+        }
+
+      entry = RB_RIGHT(entry, node);
+    }
+
+  return NULL;
 }
 
 /****************************************************************************
@@ -111,7 +222,7 @@ void mm_map_unlock(void)
 
 void mm_map_initialize(FAR struct mm_map_s *mm, bool kernel)
 {
-  sq_init(&mm->mm_map_sq);
+  RB_INIT(&mm->mm_map_tree);
   nxrmutex_init(&mm->mm_map_mutex);
   mm->map_count = 0;
 
@@ -146,8 +257,10 @@ void mm_map_destroy(FAR struct mm_map_s *mm)
 {
   FAR struct mm_map_entry_s *entry;
 
-  while ((entry = (FAR struct mm_map_entry_s *)sq_remfirst(&mm->mm_map_sq)))
+  while ((entry = RB_MIN(mm_map_tree_s, &mm->mm_map_tree)) != NULL)
     {
+      RB_REMOVE(mm_map_tree_s, &mm->mm_map_tree, entry);
+
       /* Pass null as group argument to indicate that actual MMU mappings
        * must not be touched. The process is being deleted and we don't
        * know in which context we are. Only kernel memory allocations
@@ -191,7 +304,7 @@ void mm_map_destroy(FAR struct mm_map_s *mm)
  * Name: mm_map_add
  *
  * Description:
- *   Add a mapping to task group's mm_map list
+ *   Add a mapping to task group's mm_map tree
  *
  ****************************************************************************/
 
@@ -205,7 +318,7 @@ int mm_map_add(FAR struct mm_map_s *mm, FAR struct mm_map_entry_s *entry)
       return -EINVAL;
     }
 
-  /* Copy the provided mapping and add to the list */
+  /* Copy the provided mapping and add to the tree */
 
   new_entry = kmm_malloc(sizeof(struct mm_map_entry_s));
   if (!new_entry)
@@ -214,6 +327,7 @@ int mm_map_add(FAR struct mm_map_s *mm, FAR struct mm_map_entry_s *entry)
     }
 
   *new_entry = *entry;
+  new_entry->maxend = MM_MAP_END(new_entry);
 
   ret = nxrmutex_lock(&mm->mm_map_mutex);
   if (ret < 0)
@@ -233,7 +347,7 @@ int mm_map_add(FAR struct mm_map_s *mm, FAR struct mm_map_entry_s *entry)
 
   mm->map_count++;
 
-  sq_addfirst((sq_entry_t *)new_entry, &mm->mm_map_sq);
+  RB_INSERT(mm_map_tree_s, &mm->mm_map_tree, new_entry);
 
   nxrmutex_unlock(&mm->mm_map_mutex);
 
@@ -244,7 +358,7 @@ int mm_map_add(FAR struct mm_map_s *mm, FAR struct mm_map_entry_s *entry)
  * Name: mm_map_next
  *
  * Description:
- *   Returns the next mapping in the list.
+ *   Returns the next mapping in address order.
  *
  ****************************************************************************/
 
@@ -257,12 +371,12 @@ FAR struct mm_map_entry_s *mm_map_next(FAR struct mm_map_s *mm,
     {
       if (entry == NULL)
         {
-          next_entry = (struct mm_map_entry_s *)sq_peek(&mm->mm_map_sq);
+          next_entry = RB_MIN(mm_map_tree_s, &mm->mm_map_tree);
         }
       else
         {
-          next_entry = (struct mm_map_entry_s *)
-            sq_next(((sq_entry_t *)entry));
+          next_entry = RB_NEXT(mm_map_tree_s, &mm->mm_map_tree,
+                               (FAR struct mm_map_entry_s *)entry);
         }
 
       nxrmutex_unlock(&mm->mm_map_mutex);
@@ -275,7 +389,8 @@ FAR struct mm_map_entry_s *mm_map_next(FAR struct mm_map_s *mm,
  * Name: mm_map_find
  *
  * Description:
- *   Find the first mapping containing the range from the task group's list
+ *   Find the mapping, of the lowest address, containing the range in the
+ *   task group's tree
  *
  ****************************************************************************/
 
@@ -287,15 +402,9 @@ FAR struct mm_map_entry_s *mm_map_find(FAR struct mm_map_s *mm,
 
   if (nxrmutex_lock(&mm->mm_map_mutex) == OK)
     {
-      found_entry = (struct mm_map_entry_s *)sq_peek(&mm->mm_map_sq);
-
-      while (found_entry && !in_range(vaddr, length,
-                                      found_entry->vaddr,
-                                      found_entry->length))
-        {
-          found_entry = (struct mm_map_entry_s *)
-            sq_next(((sq_entry_t *)found_entry));
-        }
+      found_entry = mm_map_search(RB_ROOT(&mm->mm_map_tree),
+                                  (uintptr_t)vaddr,
+                                  (uintptr_t)vaddr + length);
 
       nxrmutex_unlock(&mm->mm_map_mutex);
     }
@@ -307,15 +416,14 @@ FAR struct mm_map_entry_s *mm_map_find(FAR struct mm_map_s *mm,
  * Name: mm_map_remove
  *
  * Description:
- *   Remove a mapping from the task  group's list
+ *   Remove a mapping from the task group's tree
  *
  ****************************************************************************/
 
 int mm_map_remove(FAR struct mm_map_s *mm,
                   FAR struct mm_map_entry_s *entry)
 {
-  FAR struct mm_map_entry_s *prev_entry;
-  FAR struct mm_map_entry_s *removed_entry = NULL;
+  FAR struct mm_map_entry_s *removed_entry;
   int ret;
 
   if (!mm || !entry)
@@ -329,40 +437,15 @@ int mm_map_remove(FAR struct mm_map_s *mm,
       return ret;
     }
 
-  prev_entry = (struct mm_map_entry_s *)sq_peek(&mm->mm_map_sq);
+  /* Check that the entry is in the tree: the search by its address and
+   * its own address finds only itself.
+   */
 
-  /* Check if the list was empty */
-
-  if (!prev_entry)
+  removed_entry = RB_FIND(mm_map_tree_s, &mm->mm_map_tree, entry);
+  if (removed_entry != NULL)
     {
-      nxrmutex_unlock(&mm->mm_map_mutex);
-      return -ENOENT;
-    }
-
-  /* Check if removing the first item */
-
-  if (entry == prev_entry)
-    {
-      sq_remfirst(&mm->mm_map_sq);
+      RB_REMOVE(mm_map_tree_s, &mm->mm_map_tree, removed_entry);
       mm->map_count--;
-      removed_entry = prev_entry;
-    }
-  else
-    {
-      /* Loop through the remaining items to find the one to be removed */
-
-      while ((removed_entry = (struct mm_map_entry_s *)
-              sq_next(((sq_entry_t *)prev_entry))))
-        {
-          if (entry == removed_entry)
-            {
-              sq_remafter((sq_entry_t *)prev_entry, &mm->mm_map_sq);
-              mm->map_count--;
-              break;
-            }
-
-          prev_entry = removed_entry;
-        }
     }
 
   nxrmutex_unlock(&mm->mm_map_mutex);
@@ -378,4 +461,52 @@ int mm_map_remove(FAR struct mm_map_s *mm,
   return -ENOENT;
 }
 
+/****************************************************************************
+ * Name: mm_map_update
+ *
+ * Description:
+ *   Change the address and the length of a mapping, moving it in the tree
+ *
+ ****************************************************************************/
+
+int mm_map_update(FAR struct mm_map_s *mm,
+                  FAR struct mm_map_entry_s *entry,
+                  FAR void *vaddr, size_t length)
+{
+  FAR struct mm_map_entry_s *found_entry;
+  int ret;
+
+  if (!mm)
+    {
+      entry->vaddr  = vaddr;
+      entry->length = length;
+      return OK;
+    }
+
+  ret = nxrmutex_lock(&mm->mm_map_mutex);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  found_entry = RB_FIND(mm_map_tree_s, &mm->mm_map_tree, entry);
+  if (found_entry != NULL)
+    {
+      RB_REMOVE(mm_map_tree_s, &mm->mm_map_tree, entry);
+    }
+
+  entry->vaddr  = vaddr;
+  entry->length = length;
+  entry->maxend = MM_MAP_END(entry);
+
+  if (found_entry != NULL)
+    {
+      RB_INSERT(mm_map_tree_s, &mm->mm_map_tree, entry);
+    }
+
+  nxrmutex_unlock(&mm->mm_map_mutex);
+
+  return found_entry != NULL ? OK : -ENOENT;
+}
+
 #endif /* defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__) */
@@ -0,0 +1,277 @@
+/****************************************************************************
+ * mm/mempool/kmem_cache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <string.h>
+#include <sys/param.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/mm/kmem_cache.h>
+#include <nuttx/mm/mempool.h>
+
+#if defined(CONFIG_MM_KMEM_CACHE) && \
+    (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct kmem_cache_s
+{
+  struct mempool_s pool;     /* The pool holding the objects */
+  kmem_ctor_t      ctor;     /* Called on every allocated object */
+  FAR void        *arg;      /* The argument of the constructor */
+  size_t           align;    /* The alignment of the objects */
+  size_t           hdrsize;  /* The room for the real address of a chunk */
+  size_t           maxcolor; /* The largest offset of a chunk */
+  size_t           color;    /* The offset of the next chunk */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: kmem_cache_chunk_alloc
+ *
+ * Description:
+ *   Allocate a chunk for the pool.  The unused tail of the chunk is put in
+ *   front of it instead, a little more every time, and the real address is
+ *   kept right before the chunk for kmem_cache_chunk_free().
+ *
+ ****************************************************************************/
+
+static FAR void *kmem_cache_chunk_alloc(FAR struct mempool_s *pool,
+                                        size_t size)
+{
+  FAR struct kmem_cache_s *cache =
+    container_of(pool, struct kmem_cache_s, pool);
+  size_t color = cache->color;
+  FAR char *base;
+  FAR char *chunk;
+
+  /* Racing expansions may end up with the same color, which is harmless */
+
+  cache->color = color + cache->align > cache->maxcolor ?
+                 0 : color + cache->align;
+
+  base = kmm_memalign(cache->align, cache->hdrsize + cache->maxcolor + size);
+  if (base == NULL)
+    {
+      return NULL;
+    }
+
+  chunk = base + cache->hdrsize + color;
+  *((FAR void **)chunk - 1) = base;
+  return chunk;
+}
+
+static void kmem_cache_chunk_free(FAR struct mempool_s *pool,
+                                  FAR void *addr)
+{
+  kmm_free(*((FAR void **)addr - 1));
+}
+
+/* Called on the next free block when a block is taken from the queue, an
+ * unaligned one means that a freed object was written to.
+ */
+
+static void kmem_cache_check(FAR struct mempool_s *pool, FAR void *blk)
+{
+  FAR struct kmem_cache_s *cache =
+    container_of(pool, struct kmem_cache_s, pool);
+
+  assert(((uintptr_t)blk & (cache->align - 1)) == 0);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: kmem_cache_create
+ *
+ * Description:
+ *   Create a cache of objects of 'size' bytes.
+ *
+ * Input Parameters:
+ *   name  - The name of the cache, must stay valid until it is destroyed
+ *   size  - The size of each object
+ *   align - The alignment of each object, a power of two or zero
+ *   ctor  - An optional constructor called on every allocated object
+ *   arg   - The argument passed to the constructor
+ *
+ * Returned Value:
+ *   The new cache on success; NULL on failure.
+ *
+ ****************************************************************************/
+
+FAR struct kmem_cache_s *kmem_cache_create(FAR const char *name,
+                                           size_t size, size_t align,
+                                           kmem_ctor_t ctor, FAR void *arg)
+{
+  FAR struct kmem_cache_s *cache;
+  size_t blocksize;
+  size_t used;
+
+  if (size == 0 || (align & (align - 1)) != 0)
+    {
+      return NULL;
+    }
+
+  align = MAX(align, MEMPOOL_ALIGN);
+  cache = kmm_zalloc(sizeof(*cache));
+  if (cache == NULL)
+    {
+      return NULL;
+    }
+
+  /* The backtrace appended to each block must keep the next one aligned */
+
+  cache->pool.blocksize = ALIGN_UP(size, align);
+  while (MEMPOOL_REALBLOCKSIZE(&cache->pool) % align != 0)
+    {
+      cache->pool.blocksize += MEMPOOL_ALIGN;
+    }
+
+  blocksize = MEMPOOL_REALBLOCKSIZE(&cache->pool);
+  cache->pool.expandsize = MAX(CONFIG_MM_KMEM_CACHE_EXPANDSIZE,
+                               blocksize + sizeof(sq_entry_t));
+  cache->pool.alloc      = kmem_cache_chunk_alloc;
+  cache->pool.free       = kmem_cache_chunk_free;
+  cache->pool.check      = kmem_cache_check;
+
+  /* Same layout as mempool_allocate(): the blocks and the chunk link */
+
+  used = (cache->pool.expandsize - sizeof(sq_entry_t)) / blocksize *
+         blocksize + sizeof(sq_entry_t);
+
+  cache->ctor     = ctor;
+  cache->arg      = arg;
+  cache->align    = align;
+  cache->hdrsize  = ALIGN_UP(sizeof(FAR void *), align);
+  cache->maxcolor = ALIGN_DOWN(cache->pool.expandsize - used, align);
+
+  if (mempool_init(&cache->pool, name) < 0)
+    {
+      kmm_free(cache);
+      return NULL;
+    }
+
+  return cache;
+}
+
+/****************************************************************************
+ * Name: kmem_cache_destroy
+ *
+ * Description:
+ *   Destroy a cache and release its memory.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EBUSY if objects are still allocated.
+ *
+ ****************************************************************************/
+
+int kmem_cache_destroy(FAR struct kmem_cache_s *cache)
+{
+  int ret;
+
+  DEBUGASSERT(cache != NULL);
+
+  ret = mempool_deinit(&cache->pool);
+  if (ret >= 0)
+    {
+      kmm_free(cache);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: kmem_cache_alloc
+ *
+ * Description:
+ *   Allocate an object from the cache.
+ *
+ ****************************************************************************/
+
+FAR void *kmem_cache_alloc(FAR struct kmem_cache_s *cache)
+{
+  FAR void *obj = mempool_allocate(&cache->pool);
+
+  if (obj != NULL && cache->ctor != NULL)
+    {
+      cache->ctor(obj, cache->arg);
+    }
+
+  return obj;
+}
+
+/****************************************************************************
+ * Name: kmem_cache_zalloc
+ *
+ * Description:
+ *   Allocate a zeroed object from the cache.
+ *
+ ****************************************************************************/
+
+FAR void *kmem_cache_zalloc(FAR struct kmem_cache_s *cache)
+{
+  FAR void *obj = mempool_allocate(&cache->pool);
+
+  if (obj != NULL)
+    {
+      memset(obj, 0, cache->pool.blocksize);
+      if (cache->ctor != NULL)
+        {
+          cache->ctor(obj, cache->arg);
+        }
+    }
+
+  return obj;
+}
+
+/****************************************************************************
+ * Name: kmem_cache_free
+ *
+ * Description:
+ *   Return an object to its cache.
+ *
+ ****************************************************************************/
+
+void kmem_cache_free(FAR struct kmem_cache_s *cache, FAR void *obj)
+{
+  if (obj != NULL)
+    {
+      mempool_release(&cache->pool, obj);
+    }
+}
+
+#endif /* CONFIG_MM_KMEM_CACHE */
@@ -28,8 +28,11 @@
 #include <execinfo.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include <string.h>
 #include <syslog.h>
 
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/mm/kasan.h>
 #include <nuttx/mm/mempool.h>
@@ -40,6 +43,21 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* The per-CPU cache needs to disable the local interrupts, which is not
+ * possible from the user space copy of the mempool.
+ */
+
+#if CONFIG_MM_MEMPOOL_PERCPU_CACHE > 0 && \
+    (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+#  define MEMPOOL_PERCPU_CACHE
+#  define MEMPOOL_CACHE_BATCH ((CONFIG_MM_MEMPOOL_PERCPU_CACHE + 1) / 2)
+
+/* Pools that wake up waiters on release can't hide blocks in a cache */
+
+#  define MEMPOOL_CACHE_ENABLED(pool) \
+     (!(pool)->wait || (pool)->expandsize != 0)
+#endif
+
 #if CONFIG_MM_BACKTRACE >= 0
 #define MEMPOOL_MAGIC_FREE  0xAAAAAAAA
 #define MEMPOOL_MAGIC_ALLOC 0x55555555
@@ -98,6 +116,149 @@ static inline void mempool_add_queue(FAR struct mempool_s *pool,
     }
 }
 
+#ifdef MEMPOOL_PERCPU_CACHE
+/****************************************************************************
+ * Name: mempool_cache_drain
+ *
+ * Description:
+ *   Move up to 'nblks' blocks from a per-CPU cache back to the normal free
+ *   queue.  Must be called with the local interrupts disabled.
+ *
+ ****************************************************************************/
+
+static void mempool_cache_drain(FAR struct mempool_s *pool,
+                                FAR struct mempool_cache_s *cache,
+                                size_t nblks)
+{
+  spin_lock(&pool->lock);
+  while (nblks-- > 0 && cache->head != NULL)
+    {
+      FAR sq_entry_t *blk = cache->head;
+
+      cache->head = blk->flink;
+      cache->count--;
+      pool->nalloc--;
+      sq_addlast(blk, &pool->queue);
+    }
+
+  spin_unlock(&pool->lock);
+}
+
+/****************************************************************************
+ * Name: mempool_cache_get
+ *
+ * Description:
+ *   Take a free block from the cache of this CPU.  An empty cache is first
+ *   refilled with up to MEMPOOL_CACHE_BATCH blocks from the normal free
+ *   queue, under one acquisition of the pool lock.  The blocks in the
+ *   caches are accounted in nalloc, like the allocated ones.
+ *
+ * Returned Value:
+ *   A free block, or NULL if the normal free queue is empty as well.
+ *
+ ****************************************************************************/
+
+static FAR sq_entry_t *mempool_cache_get(FAR struct mempool_s *pool)
+{
+  FAR struct mempool_cache_s *cache;
+  FAR sq_entry_t *blk;
+  irqstate_t flags;
+
+  flags = up_irq_save();
+  cache = &pool->cache[this_cpu()];
+  if (cache->head == NULL)
+    {
+      size_t nblks;
+
+      cache->nmiss++;
+      spin_lock(&pool->lock);
+      for (nblks = 0; nblks < MEMPOOL_CACHE_BATCH; nblks++)
+        {
+          blk = mempool_remove_queue(pool, &pool->queue);
+          if (blk == NULL)
+            {
+              break;
+            }
+
+          blk->flink  = cache->head;
+          cache->head = blk;
+        }
+
+      cache->count += nblks;
+      pool->nalloc += nblks;
+      spin_unlock(&pool->lock);
+    }
+  else
+    {
+      cache->nhit++;
+    }
+
+  blk = cache->head;
+  if (blk != NULL)
+    {
+      cache->head = blk->flink;
+      cache->count--;
+    }
+
+  up_irq_restore(flags);
+  return blk;
+}
+
+/****************************************************************************
+ * Name: mempool_cache_put
+ *
+ * Description:
+ *   Keep a released block in the cache of this CPU.  A full cache is
+ *   drained by MEMPOOL_CACHE_BATCH blocks to the normal free queue.
+ *
+ ****************************************************************************/
+
+static void mempool_cache_put(FAR struct mempool_s *pool,
+                              FAR sq_entry_t *blk)
+{
+  FAR struct mempool_cache_s *cache;
+  irqstate_t flags;
+
+  flags = up_irq_save();
+  cache = &pool->cache[this_cpu()];
+  blk->flink  = cache->head;
+  cache->head = blk;
+  cache->count++;
+  kasan_poison(blk, pool->blocksize);
+
+  if (cache->count > CONFIG_MM_MEMPOOL_PERCPU_CACHE)
+    {
+      mempool_cache_drain(pool, cache, MEMPOOL_CACHE_BATCH);
+    }
+
+  up_irq_restore(flags);
+}
+
+/****************************************************************************
+ * Name: mempool_cache_count
+ *
+ * Description:
+ *   Return the number of free blocks held by all per-CPU caches.  The
+ *   result is only a snapshot, since the other CPUs keep running.
+ *
+ ****************************************************************************/
+
+static size_t mempool_cache_count(FAR struct mempool_s *pool)
+{
+  size_t count = 0;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      count += pool->cache[cpu].count;
+    }
+
+  return count;
+}
+#else
+#  define mempool_cache_count(pool) 0
+#endif
+
 #if CONFIG_MM_BACKTRACE >= 0
 static inline void mempool_add_backtrace(FAR struct mempool_s *pool,
                                          FAR struct mempool_backtrace_s *buf)
@@ -303,6 +464,10 @@ int mempool_init(FAR struct mempool_s *pool, FAR const char *name)
     }
 
   spin_initialize(&pool->lock, SP_UNLOCKED);
+#if CONFIG_MM_MEMPOOL_PERCPU_CACHE > 0
+  memset(pool->cache, 0, sizeof(pool->cache));
+#endif
+
   if (pool->wait && pool->expandsize == 0)
     {
       nxsem_init(&pool->waitsem, 0, 0);
@@ -342,6 +507,17 @@ FAR void *mempool_allocate(FAR struct mempool_s *pool)
   FAR sq_entry_t *blk;
   irqstate_t flags;
 
+#ifdef MEMPOOL_PERCPU_CACHE
+  if (MEMPOOL_CACHE_ENABLED(pool))
+    {
+      blk = mempool_cache_get(pool);
+      if (blk != NULL)
+        {
+          goto out;
+        }
+    }
+#endif
+
 retry:
   flags = spin_lock_irqsave(&pool->lock);
   blk = mempool_remove_queue(pool, &pool->queue);
@@ -395,6 +571,10 @@ retry:
 
   pool->nalloc++;
   spin_unlock_irqrestore(&pool->lock, flags);
+
+#ifdef MEMPOOL_PERCPU_CACHE
+out:
+#endif
   blk = kasan_unpoison(blk, pool->blocksize);
 #ifdef CONFIG_MM_FILL_ALLOCATIONS
   memset(blk, MM_ALLOC_MAGIC, pool->blocksize);
@@ -421,8 +601,9 @@ retry:
 
 void mempool_release(FAR struct mempool_s *pool, FAR void *blk)
 {
-  irqstate_t flags = spin_lock_irqsave(&pool->lock);
   size_t blocksize = MEMPOOL_REALBLOCKSIZE(pool);
+  FAR sq_queue_t *queue = &pool->queue;
+  irqstate_t flags;
 #if CONFIG_MM_BACKTRACE >= 0
   FAR struct mempool_backtrace_s *buf =
     (FAR struct mempool_backtrace_s *)((FAR char *)blk + pool->blocksize);
@@ -434,29 +615,27 @@ void mempool_release(FAR struct mempool_s *pool, FAR void *blk)
 
 #endif
 
-  pool->nalloc--;
-
 #ifdef CONFIG_MM_FILL_ALLOCATIONS
   memset(blk, MM_FREE_MAGIC, pool->blocksize);
 #endif
 
-  if (pool->interruptsize > blocksize)
+  if (pool->interruptsize > blocksize &&
+      (FAR char *)blk >= pool->ibase &&
+      (FAR char *)blk < pool->ibase + pool->interruptsize - blocksize)
     {
-      if ((FAR char *)blk >= pool->ibase &&
-          (FAR char *)blk < pool->ibase + pool->interruptsize - blocksize)
-        {
-          sq_addlast(blk, &pool->iqueue);
-        }
-      else
-        {
-          sq_addlast(blk, &pool->queue);
-        }
+      queue = &pool->iqueue;
     }
-  else
+#ifdef MEMPOOL_PERCPU_CACHE
+  else if (MEMPOOL_CACHE_ENABLED(pool))
     {
-      sq_addlast(blk, &pool->queue);
+      mempool_cache_put(pool, blk);
+      return;
     }
+#endif
 
+  flags = spin_lock_irqsave(&pool->lock);
+  pool->nalloc--;
+  sq_addlast(blk, queue);
   kasan_poison(blk, pool->blocksize);
   spin_unlock_irqrestore(&pool->lock, flags);
   if (pool->wait && pool->expandsize == 0)
@@ -489,17 +668,34 @@ int mempool_info(FAR struct mempool_s *pool, FAR struct mempoolinfo_s *info)
 {
   size_t blocksize = MEMPOOL_REALBLOCKSIZE(pool);
   irqstate_t flags;
+  size_t ncached;
+#ifdef MEMPOOL_PERCPU_CACHE
+  int i;
+#endif
 
   DEBUGASSERT(pool != NULL && info != NULL);
 
   flags = spin_lock_irqsave(&pool->lock);
-  info->ordblks = sq_count(&pool->queue);
+  ncached = mempool_cache_count(pool);
+  info->ordblks = sq_count(&pool->queue) + ncached;
   info->iordblks = sq_count(&pool->iqueue);
-  info->aordblks = pool->nalloc;
+  info->aordblks = pool->nalloc - ncached;
   info->arena = sq_count(&pool->equeue) * sizeof(sq_entry_t) +
     (info->aordblks + info->ordblks + info->iordblks) * blocksize;
   spin_unlock_irqrestore(&pool->lock, flags);
   info->sizeblks = blocksize;
+#if CONFIG_MM_MEMPOOL_PERCPU_CACHE > 0
+  info->nhit = 0;
+  info->nmiss = 0;
+#  ifdef MEMPOOL_PERCPU_CACHE
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      info->nhit += pool->cache[i].nhit;
+      info->nmiss += pool->cache[i].nmiss;
+    }
+#  endif
+#endif
+
   if (pool->wait && pool->expandsize == 0)
     {
       int semcount;
@@ -533,7 +729,8 @@ mempool_info_task(FAR struct mempool_s *pool,
     {
       irqstate_t flags = spin_lock_irqsave(&pool->lock);
       size_t count = sq_count(&pool->queue) +
-                     sq_count(&pool->iqueue);
+                     sq_count(&pool->iqueue) +
+                     mempool_cache_count(pool);
 
       spin_unlock_irqrestore(&pool->lock, flags);
       info.aordblks += count;
@@ -541,8 +738,10 @@ mempool_info_task(FAR struct mempool_s *pool,
     }
   else if (task->pid == PID_MM_ALLOC)
     {
-      info.aordblks += pool->nalloc;
-      info.uordblks += pool->nalloc * blocksize;
+      size_t count = pool->nalloc - mempool_cache_count(pool);
+
+      info.aordblks += count;
+      info.uordblks += count * blocksize;
     }
 #if CONFIG_MM_BACKTRACE >= 0
   else
@@ -610,6 +809,20 @@ int mempool_deinit(FAR struct mempool_s *pool)
   size_t blocksize = MEMPOOL_REALBLOCKSIZE(pool);
   FAR sq_entry_t *blk;
   size_t count = 0;
+#ifdef MEMPOOL_PERCPU_CACHE
+  irqstate_t flags;
+  int cpu;
+
+  /* Return the cached blocks first, they are accounted as allocated */
+
+  flags = up_irq_save();
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      mempool_cache_drain(pool, &pool->cache[cpu], pool->cache[cpu].count);
+    }
+
+  up_irq_restore(flags);
+#endif
 
   if (pool->nalloc != 0)
     {
@@ -93,6 +93,18 @@ struct mempool_multiple_s
   size_t                        dict_col_num_log2;
   size_t                        dict_row_num;
   FAR struct mpool_dict_s     **dict;
+
+#ifdef CONFIG_MM_HEAP_MEMPOOL_HISTOGRAM
+  /* The request size histogram, one counter for every MEMPOOL_ALIGN bytes
+   * up to the largest pool.  The counters are not atomic, so concurrent
+   * requests may occasionally be lost.
+   */
+
+  FAR unsigned long            *histogram;
+  size_t                        nhistogram;
+  unsigned long                 noversize;   /* Larger than all pools */
+  unsigned long                 nfallback;   /* No pool could serve it */
+#endif
 };
 
 /****************************************************************************
@@ -145,6 +157,33 @@ mempool_multiple_find(FAR struct mempool_multiple_s *mpool, size_t size)
   return &mpool->pools[left];
 }
 
+#ifdef CONFIG_MM_HEAP_MEMPOOL_HISTOGRAM
+static inline void
+mempool_multiple_record(FAR struct mempool_multiple_s *mpool, size_t size)
+{
+  size_t index = size > 0 ? (size - 1) / MEMPOOL_ALIGN : 0;
+
+  if (mpool == NULL)
+    {
+      return;
+    }
+
+  if (index < mpool->nhistogram)
+    {
+      mpool->histogram[index]++;
+    }
+  else
+    {
+      mpool->noversize++;
+    }
+}
+
+#  define mempool_multiple_fallback(mpool) ((mpool)->nfallback++)
+#else
+#  define mempool_multiple_record(mpool, size)
+#  define mempool_multiple_fallback(mpool)
+#endif
+
 static FAR void *
 mempool_multiple_alloc_chunk(FAR struct mempool_multiple_s *mpool,
                              size_t align, size_t size)
@@ -405,6 +444,7 @@ mempool_multiple_init(FAR const char *name,
   FAR struct mempool_s *pools;
   size_t maxpoolszie;
   size_t minpoolsize;
+  size_t nhistogram = 0;
   int ret;
   int i;
 
@@ -428,9 +468,14 @@ mempool_multiple_init(FAR const char *name,
         }
     }
 
+#ifdef CONFIG_MM_HEAP_MEMPOOL_HISTOGRAM
+  nhistogram = ALIGN_UP(maxpoolszie, MEMPOOL_ALIGN) / MEMPOOL_ALIGN;
+#endif
+
   mpool = alloc(arg, sizeof(uintptr_t),
                 sizeof(struct mempool_multiple_s) +
-                npools * sizeof(struct mempool_s));
+                npools * sizeof(struct mempool_s) +
+                nhistogram * sizeof(unsigned long));
 
   if (mpool == NULL)
     {
@@ -452,6 +497,13 @@ mempool_multiple_init(FAR const char *name,
   mpool->npools = npools;
   mpool->minpoolsize = minpoolsize;
   mpool->delta = 0;
+#ifdef CONFIG_MM_HEAP_MEMPOOL_HISTOGRAM
+  mpool->histogram = (FAR unsigned long *)(pools + npools);
+  mpool->nhistogram = nhistogram;
+  mpool->noversize = 0;
+  mpool->nfallback = 0;
+  memset(mpool->histogram, 0, nhistogram * sizeof(unsigned long));
+#endif
 
   for (i = 0; i < npools; i++)
     {
@@ -538,6 +590,7 @@ FAR void *mempool_multiple_alloc(FAR struct mempool_multiple_s *mpool,
   FAR struct mempool_s *end;
   FAR struct mempool_s *pool;
 
+  mempool_multiple_record(mpool, size);
   pool = mempool_multiple_find(mpool, size);
   if (pool == NULL)
     {
@@ -556,6 +609,7 @@ FAR void *mempool_multiple_alloc(FAR struct mempool_multiple_s *mpool,
     }
   while (++pool < end);
 
+  mempool_multiple_fallback(mpool);
   return NULL;
 }
 
@@ -704,6 +758,7 @@ FAR void *mempool_multiple_memalign(FAR struct mempool_multiple_s *mpool,
 
   DEBUGASSERT((alignment & (alignment - 1)) == 0);
 
+  mempool_multiple_record(mpool, size + alignment);
   pool = mempool_multiple_find(mpool, size + alignment);
   if (pool == NULL)
     {
@@ -721,6 +776,7 @@ FAR void *mempool_multiple_memalign(FAR struct mempool_multiple_s *mpool,
     }
   while (++pool < end);
 
+  mempool_multiple_fallback(mpool);
   return NULL;
 }
 
@@ -850,6 +906,44 @@ void mempool_multiple_memdump(FAR struct mempool_multiple_s *mpool,
     }
 }
 
+/****************************************************************************
+ * Name: mempool_multiple_histogram
+ *
+ * Description:
+ *   Print the request size histogram of a multiple mempool to the syslog.
+ *   Every non-empty bucket is printed with the largest size it covers.
+ *
+ * Input Parameters:
+ *   mpool - The handle of multiple memory pool to be used.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_HEAP_MEMPOOL_HISTOGRAM
+void mempool_multiple_histogram(FAR struct mempool_multiple_s *mpool)
+{
+  size_t i;
+
+  if (mpool == NULL)
+    {
+      return;
+    }
+
+  syslog(LOG_INFO, "Mempool histogram\n");
+  syslog(LOG_INFO, "%12s%12s\n", "Size", "Count");
+  for (i = 0; i < mpool->nhistogram; i++)
+    {
+      if (mpool->histogram[i] != 0)
+        {
+          syslog(LOG_INFO, "%12zu%12lu\n",
+                 (i + 1) * MEMPOOL_ALIGN, mpool->histogram[i]);
+        }
+    }
+
+  syslog(LOG_INFO, "%12s%12lu\n", "Oversize", mpool->noversize);
+  syslog(LOG_INFO, "%12s%12lu\n", "Fallback", mpool->nfallback);
+}
+#endif
+
 /****************************************************************************
  * Name: mempool_multiple_deinit
  *
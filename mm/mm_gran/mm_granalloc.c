@@ -40,7 +40,25 @@
  * Public Functions
  ****************************************************************************/
 
-FAR void *gran_alloc(GRAN_HANDLE handle, size_t size)
+/****************************************************************************
+ * Name: gran_memalign
+ *
+ * Description:
+ *   Allocate memory from the granule heap with the start address aligned
+ *   to 'alignment', e.g. to back a large page mapping.
+ *
+ * Input Parameters:
+ *   handle    - The handle previously returned by gran_initialize
+ *   alignment - The alignment in bytes, a power of two
+ *   size      - The size of the memory region to allocate.
+ *
+ * Returned Value:
+ *   On success, a non-NULL pointer to the allocated memory is returned;
+ *   NULL is returned on failure.
+ *
+ ****************************************************************************/
+
+FAR void *gran_memalign(GRAN_HANDLE handle, size_t alignment, size_t size)
 {
   FAR gran_t *gran = (FAR gran_t *)handle;
   size_t ngran;
@@ -61,7 +79,7 @@ FAR void *gran_alloc(GRAN_HANDLE handle, size_t size)
       return NULL;
     }
 
-  posi = gran_search(gran, ngran);
+  posi = gran_search(gran, ngran, alignment);
   if (posi >= 0)
     {
       gran_set(gran, posi, ngran);
@@ -81,4 +99,17 @@ FAR void *gran_alloc(GRAN_HANDLE handle, size_t size)
   return (FAR void *)retp;
 }
 
+/****************************************************************************
+ * Name: gran_alloc
+ *
+ * Description:
+ *   Allocate memory from the granule heap.
+ *
+ ****************************************************************************/
+
+FAR void *gran_alloc(GRAN_HANDLE handle, size_t size)
+{
+  return gran_memalign(handle, 0, size);
+}
+
 #endif /* CONFIG_GRAN */
@@ -90,6 +90,32 @@ uint32_t lsb_mask(uint32_t n)
   return (-n & n) & GATCFULL;
 }
 
+/* return the index of the lowest set bit of a non-zero cell value */
+
+static inline uint32_t cell_ctz(uint32_t v)
+{
+#ifdef CONFIG_HAVE_BUILTIN_CTZ
+  return __builtin_ctz(v);
+#else
+  return DEBRUJIN_LUT[(uint32_t)(lsb_mask(v) * DEBRUJIN_NUM) >> 27];
+#endif
+}
+
+/* return the first granule at or after i whose address is aligned */
+
+static size_t gran_alignup(const gran_t *gran, size_t i, size_t align)
+{
+  uintptr_t mem;
+
+  if (align <= (size_t)GRANSIZE(gran))
+    {
+      return i;
+    }
+
+  mem = (GRAN2MEM(gran, i) + align - 1) & ~(align - 1);
+  return MEM2GRAN(gran, mem);
+}
+
 /* set or clear a GAT cell with given bit mask */
 
 static void cell_set(gran_t *gran, uint32_t cell, uint32_t mask, bool val)
@@ -238,23 +264,56 @@ failure:
 
 /* returns granule number of free range or negative error */
 
-int gran_search(const gran_t *gran, size_t size)
+int gran_search(const gran_t *gran, size_t size, size_t align)
 {
+  size_t next;
+  size_t i;
+  uint32_t c;
+  uint32_t v;
   int ret = -EINVAL;
 
-  if (gran == NULL || gran->ngranules < size)
+  if (gran == NULL || gran->ngranules < size ||
+      (align & (align - 1)) != 0 ||
+      (align > (size_t)GRANSIZE(gran) &&
+       (gran->heapstart & GRANMASK(gran)) != 0))
     {
       return ret;
     }
 
+  /* Start at the lowest granule that may be free, and find the next free
+   * one with a single bit scan instead of trying every position.
+   */
+
   ret = -ENOMEM;
-  for (size_t i = 0; i <= gran->ngranules - size; i++)
+  i = gran_alignup(gran, gran->nfree, align);
+  while (i + size <= gran->ngranules)
     {
-      if (gran_match(gran, i, size, 0, &i))
+      c = i / GATC_BITS(gran);
+      v = ~gran->gat[c] & ~(BIT(i % GATC_BITS(gran)) - 1) & GATCFULL;
+      if (v == 0)
+        {
+          /* the rest of the cell is in use, skip it at once */
+
+          i = gran_alignup(gran, (c + 1) * GATC_BITS(gran), align);
+          continue;
+        }
+
+      next = c * GATC_BITS(gran) + cell_ctz(v);
+      if (next != i)
+        {
+          i = gran_alignup(gran, next, align);
+          continue;
+        }
+
+      if (gran_match(gran, i, size, 0, &next))
         {
           ret = i;
           break;
         }
+
+      /* The range has to start after the last used granule in it */
+
+      i = gran_alignup(gran, next + 1, align);
     }
 
   return ret;
@@ -270,6 +329,13 @@ int gran_set(gran_t *gran, size_t posi, size_t size)
   if (ret == OK)
     {
       gran_set_(gran, &rang, true);
+
+      /* Everything below posi + size is used if nothing below posi was */
+
+      if (posi <= gran->nfree && gran->nfree < posi + size)
+        {
+          gran->nfree = posi + size;
+        }
     }
 
   return ret;
@@ -285,6 +351,10 @@ int gran_clear(gran_t *gran, size_t posi, size_t size)
   if (ret == OK)
     {
       gran_set_(gran, &rang, false);
+      if (posi < gran->nfree)
+        {
+          gran->nfree = posi;
+        }
     }
 
   return ret;
@@ -132,14 +132,16 @@ bool gran_match(const gran_t *gran, size_t posi, size_t size, bool used,
  *   search for continuous range of free granules
  *
  * Input Parameters:
- *   gran - Pointer to the gran state
- *   size - Length of range
+ *   gran  - Pointer to the gran state
+ *   size  - Length of range
+ *   align - Required address alignment of the range in bytes, a power of
+ *           two.  Zero or anything up to the granule size means none.
  *
  * Return value:
  *   position of negative error number.
  ****************************************************************************/
 
-int gran_search(const gran_t *gran, size_t size);
+int gran_search(const gran_t *gran, size_t size, size_t align);
 
 /****************************************************************************
  * Name: gran_set, gran_clear
@@ -150,6 +150,21 @@ uintptr_t mm_pgalloc(unsigned int npages)
   return (uintptr_t)gran_alloc(g_pgalloc, (size_t)npages << MM_PGSHIFT);
 }
 
+/****************************************************************************
+ * Name: mm_pgmemalign
+ *
+ * Description:
+ *   Allocate a physically contiguous, aligned run of pages, e.g. to be
+ *   mapped with a single 64 KiB or 2 MiB translation entry.
+ *
+ ****************************************************************************/
+
+uintptr_t mm_pgmemalign(size_t alignment, unsigned int npages)
+{
+  return (uintptr_t)gran_memalign(g_pgalloc, alignment,
+                                  (size_t)npages << MM_PGSHIFT);
+}
+
 /****************************************************************************
  * Name: mm_pgfree
  *
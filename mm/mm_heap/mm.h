@@ -31,6 +31,7 @@
 
 #include <nuttx/mutex.h>
 #include <nuttx/sched.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/fs/procfs.h>
 #include <nuttx/lib/math32.h>
 #include <nuttx/mm/mempool.h>
@@ -108,6 +109,15 @@
 #  define MM_ADD_BACKTRACE(heap, ptr)
 #endif
 
+/* The small block cache disables interrupts, so it is not available to the
+ * user space heap of the protected and kernel builds.
+ */
+
+#if CONFIG_MM_HEAP_TCACHE_COUNT > 0 && \
+    (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+#  define MM_HEAP_TCACHE
+#endif
+
 /* All other definitions derive from these two */
 
 #define MM_MIN_CHUNK     (1 << MM_MIN_SHIFT)
@@ -217,6 +227,20 @@ struct mm_delaynode_s
   FAR struct mm_delaynode_s *flink;
 };
 
+#ifdef MM_HEAP_TCACHE
+/* The freed blocks cached by one CPU, linked through their payload like
+ * the delay list.  Bin n holds nodes of MM_MIN_CHUNK + n * MM_ALIGN bytes.
+ * The lock is only contended when another CPU drains the cache.
+ */
+
+struct mm_tcache_s
+{
+  spinlock_t lock;
+  FAR struct mm_delaynode_s *bin[CONFIG_MM_HEAP_TCACHE_NBINS];
+  uint8_t count[CONFIG_MM_HEAP_TCACHE_NBINS];
+};
+#endif
+
 /* This describes one heap (possibly with multiple regions) */
 
 struct mm_heap_s
@@ -261,6 +285,12 @@ struct mm_heap_s
   size_t mm_delaycount[CONFIG_SMP_NCPUS];
 #endif
 
+  /* Small block caches, one per CPU */
+
+#ifdef MM_HEAP_TCACHE
+  struct mm_tcache_s mm_tcache[CONFIG_SMP_NCPUS];
+#endif
+
   /* The is a multiple mempool of the heap */
 
 #ifdef CONFIG_MM_HEAP_MEMPOOL
@@ -301,6 +331,18 @@ void mm_foreach(FAR struct mm_heap_s *heap, mm_node_handler_t handler,
 
 void mm_delayfree(FAR struct mm_heap_s *heap, FAR void *mem, bool delay);
 
+/* Functions contained in mm_tcache.c ***************************************/
+
+#ifdef MM_HEAP_TCACHE
+FAR void *mm_tcache_get(FAR struct mm_heap_s *heap, size_t alignsize);
+bool mm_tcache_put(FAR struct mm_heap_s *heap, FAR void *mem);
+bool mm_tcache_flush(FAR struct mm_heap_s *heap, bool all);
+#else
+#  define mm_tcache_get(heap, alignsize) NULL
+#  define mm_tcache_put(heap, mem)       false
+#  define mm_tcache_flush(heap, all)     false
+#endif
+
 /****************************************************************************
  * Inline Functions
  ****************************************************************************/
@@ -252,5 +252,12 @@ void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
     }
 #endif
 
+  /* Keep small blocks in the cache of this CPU */
+
+  if (mm_tcache_put(heap, mem))
+    {
+      return;
+    }
+
   mm_delayfree(heap, mem, CONFIG_MM_FREE_DELAYCOUNT_MAX > 0);
 }
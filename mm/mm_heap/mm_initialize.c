@@ -271,6 +271,13 @@ FAR struct mm_heap_s *mm_initialize(FAR const char *name,
 
   nxmutex_init(&heap->mm_lock);
 
+#ifdef MM_HEAP_TCACHE
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      spin_lock_init(&heap->mm_tcache[i].lock);
+    }
+#endif
+
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMINFO)
 #  if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
   heap->mm_procfs.name = name;
@@ -144,7 +144,8 @@ void mm_mempool_dump_handle(FAR struct mempool_s *pool, FAR void *arg)
  * Name: mm_free_delaylist
  *
  * Description:
- *   force freeing the delaylist of this heap.
+ *   force freeing the delaylist of this heap, together with the small
+ *   blocks cached by this CPU.
  *
  ****************************************************************************/
 
@@ -152,6 +153,7 @@ void mm_free_delaylist(FAR struct mm_heap_s *heap)
 {
   if (heap)
     {
+       mm_tcache_flush(heap, false);
        free_delaylist(heap, true);
     }
 }
@@ -210,6 +212,17 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
 
   DEBUGASSERT(alignsize >= MM_ALIGN);
 
+  /* Small blocks may be cached by this CPU, no need for the mutex then */
+
+  ret = mm_tcache_get(heap, alignsize);
+  if (ret != NULL)
+    {
+#ifdef CONFIG_MM_FILL_ALLOCATIONS
+      memset(ret, MM_ALLOC_MAGIC, alignsize - MM_ALLOCNODE_OVERHEAD);
+#endif
+      return ret;
+    }
+
   /* We need to hold the MM mutex while we muck with the nodelist. */
 
   DEBUGVERIFY(mm_lock(heap));
@@ -351,6 +364,13 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
     }
 #endif
 
+  /* Or after returning the cached blocks of all CPUs to the heap */
+
+  else if (mm_tcache_flush(heap, true))
+    {
+      return mm_malloc(heap, size);
+    }
+
 #ifdef CONFIG_DEBUG_MM
   else if (MM_INTERNAL_HEAP(heap))
     {
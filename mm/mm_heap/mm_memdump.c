@@ -235,6 +235,9 @@ void mm_memdump(FAR struct mm_heap_s *heap,
   if (pid == PID_MM_MEMPOOL)
     {
       syslog(LOG_INFO, "Memdump mempool\n");
+#ifdef CONFIG_MM_HEAP_MEMPOOL_HISTOGRAM
+      mempool_multiple_histogram(heap->mm_mpool);
+#endif
     }
   else if (pid == PID_MM_LEAK)
     {
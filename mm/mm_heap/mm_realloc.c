@@ -193,56 +193,21 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
       size_t takeprev;
       size_t takenext;
 
-      /* Check if we can extend into the previous chunk and if the
-       * previous chunk is smaller than the next chunk.
+      /* Growing into the next chunk leaves the user data where it is, so
+       * prefer that whenever the next chunk alone is large enough.  Only
+       * take the rest from the previous chunk otherwise, which costs a copy
+       * of the whole allocation.
        */
 
-      if (nextsize > prevsize)
+      if (needed <= nextsize)
         {
-          /* Can we get everything we need from the previous chunk? */
-
-          if (needed > prevsize)
-            {
-              /* No, take the whole previous chunk and get the
-               * rest that we need from the next chunk.
-               */
-
-              takeprev = prevsize;
-              takenext = needed - prevsize;
-            }
-          else
-            {
-              /* Yes, take what we need from the previous chunk */
-
-              takeprev = needed;
-              takenext = 0;
-            }
+          takeprev = 0;
+          takenext = needed;
         }
-
-      /* Check if we can extend into the next chunk and if we still need
-       * more memory.
-       */
-
       else
         {
-          /* Can we get everything we need from the next chunk? */
-
-          if (needed > nextsize)
-            {
-              /* No, take the whole next chunk and get the rest that we
-               * need from the previous chunk.
-               */
-
-              takeprev = needed - nextsize;
-              takenext = nextsize;
-            }
-          else
-            {
-              /* Yes, take what we need from the previous chunk */
-
-              takeprev = 0;
-              takenext = needed;
-            }
+          takeprev = needed - nextsize;
+          takenext = nextsize;
         }
 
       /* Extend into the previous free chunk */
@@ -0,0 +1,269 @@
+/****************************************************************************
+ * mm/mm_heap/mm_tcache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <malloc.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/mm/mm.h>
+#include <nuttx/sched.h>
+#include <nuttx/spinlock.h>
+
+#include "mm_heap/mm.h"
+
+#ifdef MM_HEAP_TCACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Size class of a node size, may be out of range */
+
+#define MM_TCACHE_BIN(size) (((size) - MM_MIN_CHUNK) / MM_ALIGN)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_tcache_drain
+ *
+ * Description:
+ *   Empty all bins of a cache onto a list.  Called with the lock of the
+ *   cache held.
+ *
+ ****************************************************************************/
+
+static FAR struct mm_delaynode_s *
+mm_tcache_drain(FAR struct mm_tcache_s *tcache,
+                FAR struct mm_delaynode_s *list)
+{
+  int bin;
+
+  for (bin = 0; bin < CONFIG_MM_HEAP_TCACHE_NBINS; bin++)
+    {
+      while (tcache->bin[bin] != NULL)
+        {
+          FAR struct mm_delaynode_s *mem = tcache->bin[bin];
+
+          tcache->bin[bin] = mem->flink;
+          mem->flink       = list;
+          list             = mem;
+        }
+
+      tcache->count[bin] = 0;
+    }
+
+  return list;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_tcache_get
+ *
+ * Description:
+ *   Take a cached block of exactly 'alignsize' node bytes from the cache of
+ *   this CPU.  The block is still accounted as used by the heap, so only
+ *   its owner needs to be updated.
+ *
+ * Input Parameters:
+ *   heap      - The heap to allocate from
+ *   alignsize - The aligned node size, as computed by mm_malloc()
+ *
+ * Returned Value:
+ *   The payload address of the block, or NULL if there is none cached.
+ *
+ ****************************************************************************/
+
+FAR void *mm_tcache_get(FAR struct mm_heap_s *heap, size_t alignsize)
+{
+  FAR struct mm_delaynode_s *mem;
+  FAR struct mm_tcache_s *tcache;
+  size_t bin = MM_TCACHE_BIN(alignsize);
+  irqstate_t flags;
+
+  if (bin >= CONFIG_MM_HEAP_TCACHE_NBINS)
+    {
+      return NULL;
+    }
+
+  flags  = up_irq_save();
+  tcache = &heap->mm_tcache[this_cpu()];
+  spin_lock(&tcache->lock);
+  mem    = tcache->bin[bin];
+  if (mem != NULL)
+    {
+      tcache->bin[bin] = mem->flink;
+      tcache->count[bin]--;
+    }
+
+  spin_unlock(&tcache->lock);
+  up_irq_restore(flags);
+
+  if (mem != NULL)
+    {
+      FAR struct mm_allocnode_s *node = (FAR struct mm_allocnode_s *)
+        ((FAR char *)mem - MM_SIZEOF_ALLOCNODE);
+
+      DEBUGASSERT(MM_NODE_IS_ALLOC(node));
+      MM_ADD_BACKTRACE(heap, node);
+      UNUSED(node);
+    }
+
+  return mem;
+}
+
+/****************************************************************************
+ * Name: mm_tcache_put
+ *
+ * Description:
+ *   Keep a block that is being freed in the cache of this CPU, unless it is
+ *   too large or its size class is full.
+ *
+ * Input Parameters:
+ *   heap - The heap the block belongs to
+ *   mem  - The payload address of the block
+ *
+ * Returned Value:
+ *   True if the block was cached, false if it has to be freed.
+ *
+ ****************************************************************************/
+
+bool mm_tcache_put(FAR struct mm_heap_s *heap, FAR void *mem)
+{
+  FAR struct mm_allocnode_s *node;
+  FAR struct mm_tcache_s *tcache;
+  irqstate_t flags;
+  size_t bin;
+
+  node = (FAR struct mm_allocnode_s *)
+         ((FAR char *)mem - MM_SIZEOF_ALLOCNODE);
+  bin  = MM_TCACHE_BIN(MM_SIZEOF_NODE(node));
+
+  /* Sanity check against double-frees */
+
+  DEBUGASSERT(MM_NODE_IS_ALLOC(node));
+
+  if (bin >= CONFIG_MM_HEAP_TCACHE_NBINS)
+    {
+      return false;
+    }
+
+  flags  = up_irq_save();
+  tcache = &heap->mm_tcache[this_cpu()];
+  spin_lock(&tcache->lock);
+  if (tcache->count[bin] >= CONFIG_MM_HEAP_TCACHE_COUNT)
+    {
+      spin_unlock(&tcache->lock);
+      up_irq_restore(flags);
+      return false;
+    }
+
+#if CONFIG_MM_BACKTRACE >= 0
+  /* Like the blocks owned by the mempool, a cached block belongs to no
+   * task and is no leak.
+   */
+
+  node->pid = PID_MM_MEMPOOL;
+#endif
+
+  ((FAR struct mm_delaynode_s *)mem)->flink = tcache->bin[bin];
+  tcache->bin[bin] = mem;
+  tcache->count[bin]++;
+
+  spin_unlock(&tcache->lock);
+  up_irq_restore(flags);
+  return true;
+}
+
+/****************************************************************************
+ * Name: mm_tcache_flush
+ *
+ * Description:
+ *   Return the blocks cached by this CPU, or by all CPUs, to the heap.
+ *
+ * Input Parameters:
+ *   heap - The heap the blocks belong to
+ *   all  - Drain the caches of the other CPUs too, so that an allocation
+ *          that fails on one CPU can use the blocks freed on another
+ *
+ * Returned Value:
+ *   True if there was any block to return.
+ *
+ ****************************************************************************/
+
+bool mm_tcache_flush(FAR struct mm_heap_s *heap, bool all)
+{
+  FAR struct mm_delaynode_s *list = NULL;
+  FAR struct mm_tcache_s *tcache;
+  irqstate_t flags;
+  int cpu;
+
+  /* Move all bins to a local list first */
+
+  if (all)
+    {
+      for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+        {
+          tcache = &heap->mm_tcache[cpu];
+          flags  = spin_lock_irqsave(&tcache->lock);
+          list   = mm_tcache_drain(tcache, list);
+          spin_unlock_irqrestore(&tcache->lock, flags);
+        }
+    }
+  else
+    {
+      flags  = up_irq_save();
+      tcache = &heap->mm_tcache[this_cpu()];
+      spin_lock(&tcache->lock);
+      list   = mm_tcache_drain(tcache, list);
+      spin_unlock(&tcache->lock);
+      up_irq_restore(flags);
+    }
+
+  if (list == NULL)
+    {
+      return false;
+    }
+
+  while (list != NULL)
+    {
+      FAR void *mem = list;
+
+      list = list->flink;
+      mm_delayfree(heap, mem, false);
+    }
+
+  return true;
+}
+
+#endif /* MM_HEAP_TCACHE */
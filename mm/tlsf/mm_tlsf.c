@@ -54,6 +54,24 @@
 #  define MEMPOOL_NPOOLS (CONFIG_MM_HEAP_MEMPOOL_THRESHOLD / tlsf_align_size())
 #endif
 
+/* The small block cache disables interrupts, so it is not available to the
+ * user space heap of the protected and kernel builds.
+ */
+
+#if CONFIG_MM_HEAP_TCACHE_COUNT > 0 && \
+    (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+#  define MM_HEAP_TCACHE
+
+/* The smallest block tlsf hands out (block_size_min in tlsf.c), the cache
+ * size classes are one tlsf_align_size() apart from there.
+ */
+
+#  define TCACHE_MINSIZE    (3 * sizeof(FAR void *))
+#  define TCACHE_BIN(size) \
+     (((MAX(size, TCACHE_MINSIZE) + tlsf_align_size() - 1) - \
+       TCACHE_MINSIZE) / tlsf_align_size())
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -63,6 +81,16 @@ struct mm_delaynode_s
   FAR struct mm_delaynode_s *flink;
 };
 
+#ifdef MM_HEAP_TCACHE
+/* The freed blocks cached by one CPU, linked like the delay list */
+
+struct mm_tcache_s
+{
+  FAR struct mm_delaynode_s *bin[CONFIG_MM_HEAP_TCACHE_NBINS];
+  uint8_t count[CONFIG_MM_HEAP_TCACHE_NBINS];
+};
+#endif
+
 struct mm_heap_s
 {
   /* Mutually exclusive access to this data set is enforced with
@@ -109,6 +137,12 @@ struct mm_heap_s
   size_t mm_delaycount[CONFIG_SMP_NCPUS];
 #endif
 
+  /* Small block caches, one per CPU */
+
+#ifdef MM_HEAP_TCACHE
+  struct mm_tcache_s mm_tcache[CONFIG_SMP_NCPUS];
+#endif
+
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMINFO)
   struct procfs_meminfo_entry_s mm_procfs;
 #endif
@@ -371,6 +405,159 @@ static bool free_delaylist(FAR struct mm_heap_s *heap, bool force)
   return ret;
 }
 
+#ifdef MM_HEAP_TCACHE
+
+/****************************************************************************
+ * Name: tcache_get
+ *
+ * Description:
+ *   Take a cached block for a request of 'size' bytes (including the
+ *   backtrace record) from the cache of this CPU.  The block is still
+ *   accounted as used by the heap, so only its owner needs to be updated.
+ *
+ ****************************************************************************/
+
+static FAR void *tcache_get(FAR struct mm_heap_s *heap, size_t size)
+{
+  FAR struct mm_delaynode_s *mem;
+  FAR struct mm_tcache_s *tcache;
+  size_t bin = TCACHE_BIN(size);
+  irqstate_t flags;
+
+  if (bin >= CONFIG_MM_HEAP_TCACHE_NBINS)
+    {
+      return NULL;
+    }
+
+  flags  = up_irq_save();
+  tcache = &heap->mm_tcache[this_cpu()];
+  mem    = tcache->bin[bin];
+  if (mem != NULL)
+    {
+      tcache->bin[bin] = mem->flink;
+      tcache->count[bin]--;
+    }
+
+  up_irq_restore(flags);
+
+#if CONFIG_MM_BACKTRACE >= 0
+  if (mem != NULL)
+    {
+      memdump_backtrace(heap, (FAR struct memdump_backtrace_s *)
+                        ((FAR char *)mem + mm_malloc_size(heap, mem)));
+    }
+#endif
+
+  return mem;
+}
+
+/****************************************************************************
+ * Name: tcache_put
+ *
+ * Description:
+ *   Keep a block that is being freed in the cache of this CPU, unless it is
+ *   too large or its size class is full.  Return true if it was cached.
+ *
+ ****************************************************************************/
+
+static bool tcache_put(FAR struct mm_heap_s *heap, FAR void *mem)
+{
+#if CONFIG_MM_BACKTRACE >= 0
+  FAR struct memdump_backtrace_s *buf;
+#endif
+  FAR struct mm_tcache_s *tcache;
+  size_t bin = TCACHE_BIN(tlsf_block_size(mem));
+  irqstate_t flags;
+
+  if (bin >= CONFIG_MM_HEAP_TCACHE_NBINS)
+    {
+      return false;
+    }
+
+  flags  = up_irq_save();
+  tcache = &heap->mm_tcache[this_cpu()];
+  if (tcache->count[bin] >= CONFIG_MM_HEAP_TCACHE_COUNT)
+    {
+      up_irq_restore(flags);
+      return false;
+    }
+
+#if CONFIG_MM_BACKTRACE >= 0
+  /* Like the blocks owned by the mempool, a cached block belongs to no
+   * task and is no leak.
+   */
+
+  buf = (FAR struct memdump_backtrace_s *)
+        ((FAR char *)mem + mm_malloc_size(heap, mem));
+  buf->pid = PID_MM_MEMPOOL;
+#endif
+
+  ((FAR struct mm_delaynode_s *)mem)->flink = tcache->bin[bin];
+  tcache->bin[bin] = mem;
+  tcache->count[bin]++;
+
+  up_irq_restore(flags);
+  return true;
+}
+
+/****************************************************************************
+ * Name: tcache_flush
+ *
+ * Description:
+ *   Return all blocks cached by this CPU to the heap.  Return true if there
+ *   was any.
+ *
+ ****************************************************************************/
+
+static bool tcache_flush(FAR struct mm_heap_s *heap)
+{
+  FAR struct mm_delaynode_s *list = NULL;
+  FAR struct mm_tcache_s *tcache;
+  irqstate_t flags;
+  int bin;
+
+  /* Move all bins to a local list first */
+
+  flags  = up_irq_save();
+  tcache = &heap->mm_tcache[this_cpu()];
+  for (bin = 0; bin < CONFIG_MM_HEAP_TCACHE_NBINS; bin++)
+    {
+      while (tcache->bin[bin] != NULL)
+        {
+          FAR struct mm_delaynode_s *mem = tcache->bin[bin];
+
+          tcache->bin[bin] = mem->flink;
+          mem->flink       = list;
+          list             = mem;
+        }
+
+      tcache->count[bin] = 0;
+    }
+
+  up_irq_restore(flags);
+
+  if (list == NULL)
+    {
+      return false;
+    }
+
+  while (list != NULL)
+    {
+      FAR void *mem = list;
+
+      list = list->flink;
+      mm_delayfree(heap, mem, false);
+    }
+
+  return true;
+}
+
+#else
+#  define tcache_get(heap, size) NULL
+#  define tcache_put(heap, mem)  false
+#  define tcache_flush(heap)     false
+#endif
+
 #if defined(CONFIG_MM_HEAP_MEMPOOL) && CONFIG_MM_BACKTRACE >= 0
 
 /****************************************************************************
@@ -886,6 +1073,13 @@ void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
     }
 #endif
 
+  /* Keep small blocks in the cache of this CPU */
+
+  if (tcache_put(heap, mem))
+    {
+      return;
+    }
+
   mm_delayfree(heap, mem, CONFIG_MM_FREE_DELAYCOUNT_MAX > 0);
 }
 
@@ -1185,6 +1379,9 @@ void mm_memdump(FAR struct mm_heap_s *heap,
   if (pid == PID_MM_MEMPOOL)
     {
       syslog(LOG_INFO, "Memdump mempool\n");
+#ifdef CONFIG_MM_HEAP_MEMPOOL_HISTOGRAM
+      mempool_multiple_histogram(heap->mm_mpool);
+#endif
     }
   else if (pid == PID_MM_LEAK)
     {
@@ -1322,6 +1519,21 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
     }
 #endif
 
+  /* Small blocks may be cached by this CPU, no need for the mutex then */
+
+#if CONFIG_MM_BACKTRACE >= 0
+  ret = tcache_get(heap, size + sizeof(struct memdump_backtrace_s));
+#else
+  ret = tcache_get(heap, size);
+#endif
+  if (ret != NULL)
+    {
+#ifdef CONFIG_MM_FILL_ALLOCATIONS
+      memset(ret, 0xaa, mm_malloc_size(heap, ret));
+#endif
+      return ret;
+    }
+
   /* Free the delay list first */
 
   free_delaylist(heap, false);
@@ -1375,6 +1587,13 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
     }
 #endif
 
+  /* Or after returning the cached blocks of this CPU to the heap */
+
+  else if (tcache_flush(heap))
+    {
+      return mm_malloc(heap, size);
+    }
+
   return ret;
 }
 
@@ -1657,7 +1876,8 @@ FAR void *mm_zalloc(FAR struct mm_heap_s *heap, size_t size)
  * Name: mm_free_delaylist
  *
  * Description:
- *   force freeing the delaylist of this heap.
+ *   force freeing the delaylist of this heap, together with the small
+ *   blocks cached by this CPU.
  *
  ****************************************************************************/
 
@@ -1665,6 +1885,7 @@ void mm_free_delaylist(FAR struct mm_heap_s *heap)
 {
   if (heap)
     {
+       tcache_flush(heap);
        free_delaylist(heap, true);
     }
 }
@@ -28,6 +28,8 @@
 
 #include <stdlib.h>
 
+#include <nuttx/mm/heapprof.h>
+#include <nuttx/mm/heaptag.h>
 #include <nuttx/mm/mm.h>
 
 #include "umm_heap/umm_heap.h"
@@ -80,6 +82,8 @@ FAR void *calloc(size_t n, size_t elem_size)
     }
   else
     {
+      MM_HEAPPROF_ALLOC(mem, n * elem_size);
+      MM_HEAPTAG_ALLOC(mem, n * elem_size);
       mm_notify_pressure(mm_heapfree(USR_HEAP),
                          mm_heapfree_largest(USR_HEAP));
     }
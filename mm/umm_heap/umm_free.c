@@ -28,6 +28,8 @@
 
 #include <stdlib.h>
 
+#include <nuttx/mm/heapprof.h>
+#include <nuttx/mm/heaptag.h>
 #include <nuttx/mm/mm.h>
 
 #include "umm_heap/umm_heap.h"
@@ -48,5 +50,7 @@
 #undef free /* See mm/README.txt */
 void free(FAR void *mem)
 {
+  MM_HEAPPROF_FREE(mem);
+  MM_HEAPTAG_FREE(mem);
   mm_free(USR_HEAP, mem);
 }
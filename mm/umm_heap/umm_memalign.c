@@ -29,6 +29,8 @@
 #include <stdlib.h>
 #include <unistd.h>
 #include <errno.h>
+#include <nuttx/mm/heapprof.h>
+#include <nuttx/mm/heaptag.h>
 #include <nuttx/mm/mm.h>
 
 #include "umm_heap/umm_heap.h"
@@ -97,6 +99,8 @@ FAR void *memalign(size_t alignment, size_t size)
     }
   else
     {
+      MM_HEAPPROF_ALLOC(ret, size);
+      MM_HEAPTAG_ALLOC(ret, size);
       mm_notify_pressure(mm_heapfree(USR_HEAP),
                          mm_heapfree_largest(USR_HEAP));
     }
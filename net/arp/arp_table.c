@@ -73,6 +73,10 @@
 
 #define ARP_MAXAGE_TICK SEC2TICK(10 * CONFIG_NET_ARP_MAXAGE)
 
+/* The hash table has as many buckets as there are entries */
+
+#define ARP_HASH(ipaddr)  (arp_hash(ipaddr) % CONFIG_NET_ARPTAB_SIZE)
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -87,9 +91,17 @@ struct arp_table_info_s
  * Private Data
  ****************************************************************************/
 
-/* The table of known address mappings */
+/* The table of known address mappings.  The entries in use are reachable
+ * through the hash buckets in g_arphash and are kept in g_arplru in order of
+ * last use, least recently used first.  Deleted entries are kept in
+ * g_arpfree.  Entries at and above g_arpnext have never been used.
+ */
 
 static struct arp_entry_s g_arptable[CONFIG_NET_ARPTAB_SIZE];
+static FAR struct arp_entry_s *g_arphash[CONFIG_NET_ARPTAB_SIZE];
+static dq_queue_t g_arplru;
+static dq_queue_t g_arpfree;
+static unsigned int g_arpnext;
 
 static const struct ether_addr g_zero_ethaddr =
 {
@@ -149,32 +161,122 @@ static int arp_match(FAR struct net_driver_s *dev, FAR void *arg)
 }
 
 /****************************************************************************
- * Name: arp_return_old_entry
+ * Name: arp_hash
  *
  * Description:
- *   Compare and return the old ARP table entry.
+ *   Hash an IPv4 address (network order).
  *
  ****************************************************************************/
 
-static FAR struct arp_entry_s *
-arp_return_old_entry(FAR struct arp_entry_s *e1, FAR struct arp_entry_s *e2)
+static inline uint32_t arp_hash(in_addr_t ipaddr)
 {
-  if (e1->at_ipaddr == 0)
+  uint32_t hash = (uint32_t)ipaddr;
+
+  hash ^= hash >> 16;
+  hash *= 0x45d9f3b;
+  hash ^= hash >> 16;
+  return hash;
+}
+
+/****************************************************************************
+ * Name: arp_unhash
+ *
+ * Description:
+ *   Remove an entry from its hash bucket.
+ *
+ ****************************************************************************/
+
+static void arp_unhash(FAR struct arp_entry_s *tabptr)
+{
+  FAR struct arp_entry_s **link;
+
+  for (link = &g_arphash[ARP_HASH(tabptr->at_ipaddr)];
+       *link != NULL;
+       link = &(*link)->at_hnext)
     {
-      return e1;
+      if (*link == tabptr)
+        {
+          *link = tabptr->at_hnext;
+          break;
+        }
     }
-  else if (e2->at_ipaddr == 0)
+
+  tabptr->at_hnext = NULL;
+}
+
+/****************************************************************************
+ * Name: arp_release
+ *
+ * Description:
+ *   Release an entry in use: remove it from its hash bucket and from the
+ *   LRU list and put it on the free list.
+ *
+ ****************************************************************************/
+
+static void arp_release(FAR struct arp_entry_s *tabptr)
+{
+  arp_unhash(tabptr);
+  dq_rem(&tabptr->at_lru, &g_arplru);
+
+  tabptr->at_ipaddr = 0;
+  tabptr->at_dev    = NULL;
+  dq_addlast(&tabptr->at_lru, &g_arpfree);
+}
+
+/****************************************************************************
+ * Name: arp_alloc
+ *
+ * Description:
+ *   Get an entry for a new mapping: a free entry if there is one, else the
+ *   least recently used entry.  The entry is removed from the free or LRU
+ *   list; an evicted entry is still in its hash bucket and still holds
+ *   its old mapping so that the caller can report its removal.
+ *
+ ****************************************************************************/
+
+static FAR struct arp_entry_s *arp_alloc(void)
+{
+  FAR struct arp_entry_s *tabptr;
+
+  tabptr = (FAR struct arp_entry_s *)dq_remfirst(&g_arpfree);
+  if (tabptr == NULL && g_arpnext < CONFIG_NET_ARPTAB_SIZE)
     {
-      return e2;
+      tabptr = &g_arptable[g_arpnext++];
     }
-  else if ((int)(e1->at_time - e2->at_time) <= 0)
+
+  if (tabptr == NULL)
     {
-      return e1;
+      tabptr = (FAR struct arp_entry_s *)dq_remfirst(&g_arplru);
     }
-  else
+
+  return tabptr;
+}
+
+/****************************************************************************
+ * Name: arp_hashfind
+ *
+ * Description:
+ *   Find the entry for the IPv4 address and device, regardless of its age.
+ *
+ ****************************************************************************/
+
+static FAR struct arp_entry_s *arp_hashfind(in_addr_t ipaddr,
+                                            FAR struct net_driver_s *dev)
+{
+  FAR struct arp_entry_s *tabptr;
+
+  for (tabptr = g_arphash[ARP_HASH(ipaddr)];
+       tabptr != NULL;
+       tabptr = tabptr->at_hnext)
     {
-      return e2;
+      if (tabptr->at_dev == dev &&
+          net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr))
+        {
+          return tabptr;
+        }
     }
+
+  return NULL;
 }
 
 /****************************************************************************
@@ -182,6 +284,7 @@ arp_return_old_entry(FAR struct arp_entry_s *e1, FAR struct arp_entry_s *e2)
  *
  * Description:
  *   Find the ARP entry corresponding to this IP address in the ARP table.
+ *   An entry that has expired is released.
  *
  * Input Parameters:
  *   ipaddr - Refers to an IP address in network order
@@ -197,19 +300,22 @@ static FAR struct arp_entry_s *arp_lookup(in_addr_t ipaddr,
                                           FAR struct net_driver_s *dev)
 {
   FAR struct arp_entry_s *tabptr;
-  int i;
 
   /* Check if the IPv4 address is already in the ARP table. */
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  tabptr = arp_hashfind(ipaddr, dev);
+  if (tabptr != NULL)
     {
-      tabptr = &g_arptable[i];
-      if (tabptr->at_dev == dev &&
-          net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr) &&
-          clock_systime_ticks() - tabptr->at_time <= ARP_MAXAGE_TICK)
+      if (clock_systime_ticks() - tabptr->at_time <= ARP_MAXAGE_TICK)
         {
+          /* Mark it as most recently used */
+
+          dq_rem(&tabptr->at_lru, &g_arplru);
+          dq_addlast(&tabptr->at_lru, &g_arplru);
           return tabptr;
         }
+
+      arp_release(tabptr);
     }
 
   /* Not found */
@@ -276,43 +382,27 @@ static void arp_get_arpreq(FAR struct arpreq *output,
 int arp_update(FAR struct net_driver_s *dev, in_addr_t ipaddr,
                FAR const uint8_t *ethaddr)
 {
-  FAR struct arp_entry_s *tabptr = &g_arptable[0];
+  FAR struct arp_entry_s *tabptr;
+  bool found = false;
 #ifdef CONFIG_NETLINK_ROUTE
   struct arpreq arp_notify;
-  bool found = false;
   bool new_entry;
 #endif
-  int i;
 
-  /* Walk through the ARP mapping table and try to find an entry to
-   * update. If none is found, the IP -> MAC address mapping is
-   * inserted in the ARP table.
+  /* Try to find an entry to update.  If none is found, the IP -> MAC
+   * address mapping is inserted in a free entry or replaces the least
+   * recently used one.
    */
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  tabptr = arp_hashfind(ipaddr, dev);
+  if (tabptr != NULL)
     {
-      /* Check if the source IP address of the incoming packet matches
-       * the IP address in this ARP table entry.
-       */
-
-      if (g_arptable[i].at_dev == dev &&
-          g_arptable[i].at_ipaddr != 0 &&
-          net_ipv4addr_cmp(ipaddr, g_arptable[i].at_ipaddr))
-        {
-          /* An old entry found, break. */
-
-          tabptr = &g_arptable[i];
-#ifdef CONFIG_NETLINK_ROUTE
-          found = true;
-#endif
-          break;
-        }
-      else
-        {
-          /* Record the oldest entry. */
-
-          tabptr = arp_return_old_entry(tabptr, &g_arptable[i]);
-        }
+      found = true;
+      dq_rem(&tabptr->at_lru, &g_arplru);
+    }
+  else
+    {
+      tabptr = arp_alloc();
     }
 
   if (ethaddr == NULL)
@@ -328,7 +418,16 @@ int arp_update(FAR struct net_driver_s *dev, in_addr_t ipaddr,
       arp_get_arpreq(&arp_notify, tabptr);
       netlink_neigh_notify(&arp_notify, RTM_DELNEIGH, AF_INET);
     }
+#endif
+
+  /* An evicted entry is still in the bucket of its old address */
+
+  if (!found && tabptr->at_ipaddr != 0)
+    {
+      arp_unhash(tabptr);
+    }
 
+#ifdef CONFIG_NETLINK_ROUTE
   /* Need to notify when entry is not found or changes in table */
 
   new_entry = !found || memcmp(tabptr->at_ethaddr.ether_addr_octet,
@@ -344,6 +443,18 @@ int arp_update(FAR struct net_driver_s *dev, in_addr_t ipaddr,
   tabptr->at_dev = dev;
   tabptr->at_time = clock_systime_ticks();
 
+  if (!found)
+    {
+      FAR struct arp_entry_s **bucket = &g_arphash[ARP_HASH(ipaddr)];
+
+      tabptr->at_hnext = *bucket;
+      *bucket          = tabptr;
+    }
+
+  /* It is now the most recently used entry */
+
+  dq_addlast(&tabptr->at_lru, &g_arplru);
+
   /* Notify the new entry */
 
 #ifdef CONFIG_NETLINK_ROUTE
@@ -496,9 +607,9 @@ int arp_delete(in_addr_t ipaddr, FAR struct net_driver_s *dev)
       netlink_neigh_notify(&arp_notify, RTM_DELNEIGH, AF_INET);
 #endif
 
-      /* Yes.. Set the IP address to zero to "delete" it */
+      /* Yes.. Return the entry to the free list */
 
-      tabptr->at_ipaddr = 0;
+      arp_release(tabptr);
       return OK;
     }
 
@@ -521,13 +632,17 @@ int arp_delete(in_addr_t ipaddr, FAR struct net_driver_s *dev)
 
 void arp_cleanup(FAR struct net_driver_s *dev)
 {
-  int i;
+  FAR struct arp_entry_s *tabptr;
+  FAR struct arp_entry_s *next;
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  for (tabptr = (FAR struct arp_entry_s *)dq_peek(&g_arplru);
+       tabptr != NULL;
+       tabptr = next)
     {
-      if (dev == g_arptable[i].at_dev)
+      next = (FAR struct arp_entry_s *)dq_next(&tabptr->at_lru);
+      if (dev == tabptr->at_dev)
         {
-          memset(&g_arptable[i], 0, sizeof(g_arptable[i]));
+          arp_release(tabptr);
         }
     }
 }
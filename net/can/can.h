@@ -57,6 +57,11 @@
 #define can_callback_free(dev,conn,cb) \
   devif_conn_callback_free(dev, cb, &conn->sconn.list, &conn->sconn.list_tail)
 
+/* Bits of the per connection hash of the exact receive filters */
+
+#define CAN_FILTER_HASHBITS  7
+#define CAN_FILTER_HASHWORDS ((1 << CAN_FILTER_HASHBITS) / 32)
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -106,6 +111,13 @@ struct can_conn_s
 #ifdef CONFIG_NET_CANPROTO_OPTIONS
   struct can_filter filters[CONFIG_NET_CAN_RAW_FILTER_MAX];
   int32_t filter_count;
+
+  /* Hash of the keys of the exact filters, and whether there are filters
+   * that can't be hashed, see can_filter_update().
+   */
+
+  uint32_t filter_hash[CAN_FILTER_HASHWORDS];
+  bool filter_masked;
 #  ifdef CONFIG_NET_CAN_ERRORS
   can_err_mask_t err_mask;
 #  endif
@@ -386,6 +398,44 @@ int can_setsockopt(FAR struct socket *psock, int level, int option,
                    FAR const void *value, socklen_t value_len);
 #endif
 
+/****************************************************************************
+ * Name: can_filter_update
+ *
+ * Description:
+ *   Rebuild the hash of the exact filters of a connection.  It must be
+ *   called whenever the filters of the connection change.
+ *
+ * Input Parameters:
+ *   conn - A pointer to the CAN connection structure
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CANPROTO_OPTIONS
+void can_filter_update(FAR struct can_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: can_recv_filter
+ *
+ * Description:
+ *   Check a received identifier against the filters of a connection.
+ *
+ * Input Parameters:
+ *   conn - A pointer to the CAN connection structure
+ *   id   - The identifier of the received frame
+ *
+ * Returned Value:
+ *   1 if the frame passes the filters, 0 if it doesn't.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CANPROTO_OPTIONS
+int can_recv_filter(FAR struct can_conn_s *conn, canid_t id);
+#endif
+
 /****************************************************************************
  * Name: can_getsockopt
  *
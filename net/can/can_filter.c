@@ -0,0 +1,210 @@
+/****************************************************************************
+ * net/can/can_filter.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <nuttx/can.h>
+
+#include "can/can.h"
+
+#ifdef CONFIG_NET_CANPROTO_OPTIONS
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define CAN_FILTER_SFF_EXACT (CAN_EFF_FLAG | CAN_SFF_MASK)
+#define CAN_FILTER_EFF_EXACT (CAN_EFF_FLAG | CAN_EFF_MASK)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: can_filter_key
+ *
+ * Description:
+ *   Return the identifier and format bits of an identifier, which are all
+ *   an exact filter looks at.
+ *
+ ****************************************************************************/
+
+static inline canid_t can_filter_key(canid_t id)
+{
+  return (id & CAN_EFF_FLAG) != 0 ? id & CAN_FILTER_EFF_EXACT :
+                                    id & CAN_SFF_MASK;
+}
+
+/****************************************************************************
+ * Name: can_filter_bucket
+ *
+ * Description:
+ *   Hash a key into one of the bits of the filter hash.
+ *
+ ****************************************************************************/
+
+static inline uint32_t can_filter_bucket(canid_t key)
+{
+  return ((uint32_t)key * 0x9e3779b1u) >> (32 - CAN_FILTER_HASHBITS);
+}
+
+/****************************************************************************
+ * Name: can_filter_isexact
+ *
+ * Description:
+ *   An exact filter is a non inverted filter whose mask covers the frame
+ *   format and all of the identifier bits of that format.  Only a frame
+ *   with the key of the filter can match it.
+ *
+ ****************************************************************************/
+
+static inline bool can_filter_isexact(FAR const struct can_filter *filter)
+{
+  canid_t exact;
+
+  if ((filter->can_id & CAN_INV_FILTER) != 0)
+    {
+      return false;
+    }
+
+  exact = (filter->can_id & CAN_EFF_FLAG) != 0 ? CAN_FILTER_EFF_EXACT :
+                                                 CAN_FILTER_SFF_EXACT;
+  return (filter->can_mask & exact) == exact;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: can_filter_update
+ *
+ * Description:
+ *   Rebuild the hash of the exact filters of a connection.  It must be
+ *   called whenever the filters of the connection change.
+ *
+ * Input Parameters:
+ *   conn - A pointer to the CAN connection structure
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void can_filter_update(FAR struct can_conn_s *conn)
+{
+  uint32_t bucket;
+  int32_t i;
+
+  memset(conn->filter_hash, 0, sizeof(conn->filter_hash));
+  conn->filter_masked = false;
+
+  for (i = 0; i < conn->filter_count; i++)
+    {
+      if (can_filter_isexact(&conn->filters[i]))
+        {
+          bucket = can_filter_key(conn->filters[i].can_id);
+          bucket = can_filter_bucket(bucket);
+          conn->filter_hash[bucket >> 5] |= 1u << (bucket & 31);
+        }
+      else
+        {
+          conn->filter_masked = true;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: can_recv_filter
+ *
+ * Description:
+ *   Check a received identifier against the filters of a connection.
+ *
+ *   Frames are rejected without going through the filters when the
+ *   connection has only exact filters and none of them hashes to the key
+ *   of the frame, which is the common case on a busy bus.
+ *
+ * Input Parameters:
+ *   conn - A pointer to the CAN connection structure
+ *   id   - The identifier of the received frame
+ *
+ * Returned Value:
+ *   1 if the frame passes the filters, 0 if it doesn't.
+ *
+ ****************************************************************************/
+
+int can_recv_filter(FAR struct can_conn_s *conn, canid_t id)
+{
+  uint32_t bucket;
+  int32_t i;
+
+#ifdef CONFIG_NET_CAN_ERRORS
+  /* error message frame */
+
+  if ((id & CAN_ERR_FLAG) != 0)
+    {
+      return id & conn->err_mask ? 1 : 0;
+    }
+#endif
+
+  if (!conn->filter_masked)
+    {
+      bucket = can_filter_bucket(can_filter_key(id));
+      if ((conn->filter_hash[bucket >> 5] & (1u << (bucket & 31))) == 0)
+        {
+          return 0;
+        }
+    }
+
+  for (i = 0; i < conn->filter_count; i++)
+    {
+      if (conn->filters[i].can_id & CAN_INV_FILTER)
+        {
+          if ((id & conn->filters[i].can_mask) !=
+                ((conn->filters[i].can_id & ~CAN_INV_FILTER) &
+                 conn->filters[i].can_mask))
+            {
+              return 1;
+            }
+        }
+      else
+        {
+          if ((id & conn->filters[i].can_mask) ==
+                (conn->filters[i].can_id & conn->filters[i].can_mask))
+            {
+              return 1;
+            }
+        }
+    }
+
+  return 0;
+}
+
+#endif /* CONFIG_NET_CANPROTO_OPTIONS */
@@ -29,6 +29,8 @@
 
 #include <errno.h>
 #include <debug.h>
+#include <string.h>
+#include <time.h>
 
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/can.h>
@@ -189,6 +191,45 @@ static int can_input_conn(FAR struct net_driver_s *dev,
   return ret;
 }
 
+/****************************************************************************
+ * Name: can_match
+ *
+ * Description:
+ *   Return the next connection on the device after conn whose receive
+ *   filters accept the frame.  Checking the filters here rather than at
+ *   recv() time keeps the rejected frames from being cloned and queued to
+ *   every socket of the bus.
+ *
+ * Input Parameters:
+ *   dev    - The device driver structure containing the received packet
+ *   conn   - The previous connection, or NULL to start from the first one
+ *   can_id - The identifier of the received frame
+ *
+ * Returned Value:
+ *   The next matching connection, or NULL if there is none.
+ *
+ ****************************************************************************/
+
+static FAR struct can_conn_s *can_match(FAR struct net_driver_s *dev,
+                                        FAR struct can_conn_s *conn,
+                                        canid_t can_id)
+{
+  while ((conn = can_active(dev, conn)) != NULL)
+    {
+#ifdef CONFIG_NET_CANPROTO_OPTIONS
+      if (can_recv_filter(conn, can_id) == 0)
+        {
+          continue;
+        }
+#endif
+
+      break;
+    }
+
+  UNUSED(can_id);
+  return conn;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -215,12 +256,25 @@ static int can_input_conn(FAR struct net_driver_s *dev,
 
 static int can_in(FAR struct net_driver_s *dev)
 {
-  FAR struct can_conn_s *conn = can_active(dev, NULL);
+  FAR struct can_conn_s *conn;
   FAR struct can_conn_s *nextconn;
+  canid_t can_id;
+
+  memcpy(&can_id, dev->d_buf, sizeof(canid_t));
+
+  conn = can_match(dev, NULL, can_id);
+  if (conn == NULL)
+    {
+      /* Either nobody is listening on the device, or the filters of all
+       * of the listeners reject the frame, which is then simply dropped.
+       */
+
+      return can_active(dev, NULL) != NULL ? OK : can_input_conn(dev, NULL);
+    }
 
   /* Do we have second connection that can hold this packet? */
 
-  while ((nextconn = can_active(dev, conn)) != NULL)
+  while ((nextconn = can_match(dev, conn, can_id)) != NULL)
     {
       /* Yes... There are multiple listeners on the same dev.
        * We need to clone the packet and deliver it to each listener.
@@ -270,6 +324,10 @@ int can_input(FAR struct net_driver_s *dev)
   FAR uint8_t *buf;
   int ret;
 
+#if defined(CONFIG_NET_TIMESTAMP) && !defined(CONFIG_ARCH_HAVE_NETDEV_TIMESTAMP)
+  clock_gettime(CLOCK_REALTIME, &dev->d_rxtime);
+#endif
+
   if (dev->d_iob != NULL)
     {
       buf = dev->d_buf;
@@ -344,6 +344,26 @@ FAR struct devif_callback_s *
                        FAR struct devif_callback_s **list_head,
                        FAR struct devif_callback_s **list_tail);
 
+/****************************************************************************
+ * Name: devif_callback_alloc_slot
+ *
+ * Description:
+ *   Like devif_callback_alloc(), but use the callback container 'slot'
+ *   embedded in the connection if it is not in use, and take one from the
+ *   free list only if it is.  The slot must be zeroed with the connection
+ *   and must not be freed with the connection while it is in use.
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+FAR struct devif_callback_s *
+  devif_callback_alloc_slot(FAR struct net_driver_s *dev,
+                            FAR struct devif_callback_s *slot,
+                            FAR struct devif_callback_s **list_head,
+                            FAR struct devif_callback_s **list_tail);
+
 /****************************************************************************
  * Name: devif_conn_callback_free
  *
@@ -513,6 +533,27 @@ int devif_file_send(FAR struct net_driver_s *dev, FAR struct file *file,
                     unsigned int target_offset);
 #endif
 
+/****************************************************************************
+ * Name: devif_xip_send
+ *
+ * Description:
+ *   Called from socket logic in response to a xmit or poll request from the
+ *   the network interface driver.
+ *
+ *   This is identical to calling devif_send() except that the data is not
+ *   copied.  It is attached to the packet as an external I/O buffer and
+ *   must stay valid and unchanged until the packet has been sent.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SENDFILE_ZEROCOPY
+int devif_xip_send(FAR struct net_driver_s *dev, FAR const void *buf,
+                   unsigned int len, unsigned int target_offset);
+#endif
+
 /****************************************************************************
  * Name: devif_out
  *
@@ -47,6 +47,7 @@
 
 #define DEVIF_CB_DONT_FREE  (1 << 0)
 #define DEVIF_CB_PEND_FREE  (1 << 1)
+#define DEVIF_CB_EMBEDDED   (1 << 2)  /* An in use connection slot */
 
 /****************************************************************************
  * Private Data
@@ -187,10 +188,17 @@ static void devif_callback_free(FAR struct net_driver_s *dev,
             }
         }
 
-      /* If this is a preallocated or a batch allocated callback store it in
-       * the free callbacks list. Else free it.
+      /* A slot embedded in a connection is only marked unused.  If this is
+       * a preallocated or a batch allocated callback store it in the free
+       * callbacks list.  Else free it.
        */
 
+      if ((cb->free_flags & DEVIF_CB_EMBEDDED) != 0)
+        {
+          cb->free_flags = 0;
+          cb->nxtdev     = NULL;
+        }
+      else
 #if CONFIG_NET_ALLOC_DEVIF_CALLBACKS == 1
       if (cb < g_cbprealloc || cb >= (g_cbprealloc +
           CONFIG_NET_PREALLOC_DEVIF_CALLBACKS))
@@ -297,6 +305,27 @@ FAR struct devif_callback_s *
   devif_callback_alloc(FAR struct net_driver_s *dev,
                        FAR struct devif_callback_s **list_head,
                        FAR struct devif_callback_s **list_tail)
+{
+  return devif_callback_alloc_slot(dev, NULL, list_head, list_tail);
+}
+
+/****************************************************************************
+ * Name: devif_callback_alloc_slot
+ *
+ * Description:
+ *   Allocate a callback container, the connection slot 'slot' if it is
+ *   not NULL and not in use, else one from the free list.
+ *
+ * Assumptions:
+ *   This function is called with the network locked.
+ *
+ ****************************************************************************/
+
+FAR struct devif_callback_s *
+  devif_callback_alloc_slot(FAR struct net_driver_s *dev,
+                            FAR struct devif_callback_s *slot,
+                            FAR struct devif_callback_s **list_head,
+                            FAR struct devif_callback_s **list_tail)
 {
   FAR struct devif_callback_s *ret;
 #if CONFIG_NET_ALLOC_DEVIF_CALLBACKS > 0
@@ -324,6 +353,16 @@ FAR struct devif_callback_s *
       return NULL;
     }
 
+  /* The slot of the connection needs no free list */
+
+  if (slot != NULL && slot->free_flags == 0)
+    {
+      ret = slot;
+      memset(ret, 0, sizeof(struct devif_callback_s));
+      ret->free_flags = DEVIF_CB_EMBEDDED;
+      goto link;
+    }
+
   /* Allocate the callback entry from heap */
 
 #if CONFIG_NET_ALLOC_DEVIF_CALLBACKS > 0
@@ -345,54 +384,54 @@ FAR struct devif_callback_s *
   /* Check the head of the free list */
 
   ret = g_cbfreelist;
-  if (ret)
+  if (ret == NULL)
     {
-      /* Remove the next instance from the head of the free list */
+      nerr("ERROR: Failed to allocate callback\n");
+      net_unlock();
+      return NULL;
+    }
 
-      g_cbfreelist = ret->nxtconn;
-      memset(ret, 0, sizeof(struct devif_callback_s));
+  /* Remove the next instance from the head of the free list */
 
-      /* Add the newly allocated instance to the head of the device event
-       * list.
-       */
+  g_cbfreelist = ret->nxtconn;
+  memset(ret, 0, sizeof(struct devif_callback_s));
 
-      if (dev)
-        {
-          ret->nxtdev  = dev->d_devcb;
-          dev->d_devcb = ret;
-        }
+link:
 
-      /* Add the newly allocated instance to the tail of the specified list */
+  /* Add the newly allocated instance to the head of the device event
+   * list.
+   */
 
-      if (list_head && list_tail)
-        {
-          ret->nxtconn = NULL;
-          ret->prevconn = *list_tail;
+  if (dev)
+    {
+      ret->nxtdev  = dev->d_devcb;
+      dev->d_devcb = ret;
+    }
 
-          if (*list_tail)
-            {
-              /* If the list is not empty, add the item to the tail. */
+  /* Add the newly allocated instance to the tail of the specified list */
 
-              (*list_tail)->nxtconn = ret;
-            }
-          else
-            {
-              /* If the list is empty, add the first item to the list. */
+  if (list_head && list_tail)
+    {
+      ret->nxtconn = NULL;
+      ret->prevconn = *list_tail;
 
-              *list_head = ret;
-            }
+      if (*list_tail)
+        {
+          /* If the list is not empty, add the item to the tail. */
 
-          /* Update the tail pointer */
+          (*list_tail)->nxtconn = ret;
+        }
+      else
+        {
+          /* If the list is empty, add the first item to the list. */
 
-          *list_tail = ret;
+          *list_head = ret;
         }
+
+      /* Update the tail pointer */
+
+      *list_tail = ret;
     }
-#ifdef CONFIG_DEBUG_FEATURES
-  else
-    {
-      nerr("ERROR: Failed to allocate callback\n");
-    }
-#endif
 
   net_unlock();
   return ret;
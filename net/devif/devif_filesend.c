@@ -26,6 +26,7 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
 #include <string.h>
 #include <assert.h>
 #include <debug.h>
@@ -37,6 +38,27 @@
 
 #ifdef CONFIG_MM_IOB
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: devif_xip_release
+ *
+ * Description:
+ *   Called when an external I/O buffer of devif_xip_send() is freed, i.e.
+ *   when the driver is done with the packet.  The data belongs to the file
+ *   system, so there is nothing to release.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SENDFILE_ZEROCOPY
+static void devif_xip_release(FAR void *data)
+{
+  UNUSED(data);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -163,4 +185,107 @@ errout:
   return ret;
 }
 
+/****************************************************************************
+ * Name: devif_xip_send
+ *
+ * Description:
+ *   Called from socket logic in response to a xmit or poll request from the
+ *   the network interface driver.
+ *
+ *   This is identical to calling devif_send() except that the data is not
+ *   copied.  It is attached to the packet as an external I/O buffer and
+ *   must stay valid and unchanged until the packet has been sent.
+ *
+ *   Only the tail room of the I/O buffer holding the headers is filled by
+ *   copying, so that every I/O buffer but the last one stays full as
+ *   iob_update_pktlen() expects.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SENDFILE_ZEROCOPY
+int devif_xip_send(FAR struct net_driver_s *dev, FAR const void *buf,
+                   unsigned int len, unsigned int target_offset)
+{
+  FAR struct iob_s *iob;
+  unsigned int copyin;
+  int ret;
+
+  if (dev == NULL)
+    {
+      ret = -ENODEV;
+      goto errout;
+    }
+
+  if (len == 0 || len > UINT16_MAX)
+    {
+      ret = -EINVAL;
+      goto errout;
+    }
+
+#ifndef CONFIG_NET_IPFRAG
+  if (len > NETDEV_PKTSIZE(dev) - NET_LL_HDRLEN(dev) - target_offset)
+    {
+      ret = -EMSGSIZE;
+      goto errout;
+    }
+#endif
+
+  if (netdev_iob_prepare(dev, false, 0) != OK)
+    {
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  iob_update_pktlen(dev->d_iob, target_offset, false);
+
+  /* Fill the last I/O buffer of the headers */
+
+  iob = dev->d_iob;
+  while (iob->io_flink != NULL)
+    {
+      iob = iob->io_flink;
+    }
+
+  copyin = IOB_BUFSIZE(iob) - (iob->io_offset + iob->io_len);
+  if (copyin > len)
+    {
+      copyin = len;
+    }
+
+  memcpy(IOB_DATA(iob) + iob->io_len, buf, copyin);
+  iob->io_len += copyin;
+
+  /* And reference the rest where it is */
+
+  if (copyin < len)
+    {
+      iob->io_flink = iob_alloc_with_data((FAR uint8_t *)buf + copyin,
+                                          len - copyin, devif_xip_release);
+      if (iob->io_flink == NULL)
+        {
+          ret = -ENOMEM;
+          goto errout;
+        }
+
+      iob->io_flink->io_len = len - copyin;
+    }
+
+  dev->d_iob->io_pktlen = target_offset + len;
+  dev->d_sndlen = len;
+  return len;
+
+errout:
+  if (dev != NULL)
+    {
+      netdev_iob_release(dev);
+    }
+
+  nerr("ERROR: devif_xip_send error: %d\n", ret);
+  return ret;
+}
+#endif /* CONFIG_NET_SENDFILE_ZEROCOPY */
+
 #endif /* CONFIG_MM_IOB */
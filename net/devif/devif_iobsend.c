@@ -74,7 +74,10 @@ int devif_iob_send(FAR struct net_driver_s *dev, FAR struct iob_s *iob,
     }
 
 #ifndef CONFIG_NET_IPFRAG
-  if (len > NETDEV_PKTSIZE(dev) - NET_LL_HDRLEN(dev) - target_offset)
+  /* A GSO packet is cut into packets that fit by the driver */
+
+  if (len > NETDEV_PKTSIZE(dev) - NET_LL_HDRLEN(dev) - target_offset &&
+      NETDEV_GSO_SIZE(dev) == 0)
     {
       ret = -EMSGSIZE;
       goto errout;
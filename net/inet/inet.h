@@ -69,6 +69,10 @@ extern "C"
 #define EXTERN extern
 #endif
 
+/* The socket interface of the TCP and UDP sockets */
+
+EXTERN const struct sock_intf_s g_inet_sockif;
+
 /* Well-known IPv6 addresses */
 
 #ifdef CONFIG_NET_IPv6
@@ -115,10 +115,10 @@ static ssize_t    inet_sendfile(FAR struct socket *psock,
 #endif
 
 /****************************************************************************
- * Private Data
+ * Public Data
  ****************************************************************************/
 
-static const struct sock_intf_s g_inet_sockif =
+const struct sock_intf_s g_inet_sockif =
 {
   inet_setup,       /* si_setup */
   inet_sockcaps,    /* si_sockcaps */
@@ -973,6 +973,9 @@ static int inet_set_socketlevel_option(FAR struct socket *psock, int option,
 
               /* Save the receive buffer size */
 
+#ifdef CONFIG_NET_TCP_AUTOTUNE
+              tcp_autotune_lock(tcp, TCP_RCVBUF_LOCK);
+#endif
               tcp->rcv_bufs = buffersize;
             }
           else
@@ -1034,6 +1037,9 @@ static int inet_set_socketlevel_option(FAR struct socket *psock, int option,
 
               /* Save the send buffer size */
 
+#ifdef CONFIG_NET_TCP_AUTOTUNE
+              tcp_autotune_lock(tcp, TCP_SNDBUF_LOCK);
+#endif
               tcp->snd_bufs = buffersize;
             }
           else
@@ -65,6 +65,64 @@
 #define IPv6_L4HDR(ipv6, proto) \
   ((FAR void *)(net_ipv6_payload((FAR struct ipv6_hdr_s *)(ipv6), &(proto))))
 
+#ifdef CONFIG_NET_IPFILTER_INDEX
+/* Rules are indexed by protocol class: TCP, UDP, ICMP/ICMPv6 and others.
+ * The first three also hash the rules of one destination port or ICMP
+ * type.
+ */
+
+#  define IPFILTER_NCLASSES   4
+#  define IPFILTER_NHASHED    3
+#  define IPFILTER_HASH_SIZE  (1 << CONFIG_NET_IPFILTER_HASH_BITS)
+#  define IPFILTER_HASH(key)  ((key) & (IPFILTER_HASH_SIZE - 1))
+#  define IPv4_INDEX(chain)   (&g_ipv4_index[chain])
+#  define IPv6_INDEX(chain)   (&g_ipv6_index[chain])
+#else
+#  define IPv4_INDEX(chain)   NULL
+#  define IPv6_INDEX(chain)   NULL
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFILTER_INDEX
+/* A reference to a rule from the index of its chain */
+
+struct ipfilter_ref_s
+{
+  sq_entry_t node;
+  FAR const struct ipfilter_entry_s *entry;
+  uint32_t seq;                   /* Position of the rule in the chain */
+};
+
+/* The index of a chain.  A packet can only match the rules of its class
+ * that are either in the hash bucket of its port or type, or in the list
+ * of the rules that match any port or type.  Both lists are in the order
+ * of the chain, so merging them gives the candidates in that order.
+ */
+
+struct ipfilter_index_s
+{
+  uint32_t   nrules;
+  bool       broken;              /* A reference could not be allocated */
+  sq_queue_t any[IPFILTER_NCLASSES];
+  sq_queue_t hash[IPFILTER_NHASHED][IPFILTER_HASH_SIZE];
+};
+#endif
+
+/* The candidate rules of a packet, in the order of the chain */
+
+struct ipfilter_iter_s
+{
+  FAR const sq_entry_t *next;     /* Next rule of the chain */
+#ifdef CONFIG_NET_IPFILTER_INDEX
+  FAR const sq_entry_t *any;      /* Next reference to a wildcard rule */
+  FAR const sq_entry_t *hash;     /* Next reference to a hashed rule */
+  bool                  indexed;
+#endif
+};
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -76,6 +134,15 @@ static sq_queue_t g_ipv4_filters[IPFILTER_CHAIN_MAX];
 static sq_queue_t g_ipv6_filters[IPFILTER_CHAIN_MAX];
 #endif
 
+#ifdef CONFIG_NET_IPFILTER_INDEX
+#  ifdef CONFIG_NET_IPv4
+static struct ipfilter_index_s g_ipv4_index[IPFILTER_CHAIN_MAX];
+#  endif
+#  ifdef CONFIG_NET_IPv6
+static struct ipfilter_index_s g_ipv6_index[IPFILTER_CHAIN_MAX];
+#  endif
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -188,6 +255,261 @@ static bool ipfilter_match_proto(FAR const struct ipfilter_entry_s *entry,
     }
 }
 
+/****************************************************************************
+ * Name: ipfilter_class
+ *
+ * Description:
+ *   Get the protocol class of the index.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFILTER_INDEX
+static int ipfilter_class(uint8_t proto)
+{
+  switch (proto)
+    {
+      case IP_PROTO_TCP:
+        return 0;
+
+      case IP_PROTO_UDP:
+        return 1;
+
+      case IP_PROTO_ICMP:
+      case IP_PROTO_ICMP6:
+        return 2;
+
+      default:
+        return 3;
+    }
+}
+
+/****************************************************************************
+ * Name: ipfilter_index_ref
+ *
+ * Description:
+ *   Add a reference to a rule at the end of an index list.
+ *
+ * Returned Value:
+ *   true on success, false if out of memory.
+ *
+ ****************************************************************************/
+
+static bool ipfilter_index_ref(FAR sq_queue_t *queue,
+                               FAR const struct ipfilter_entry_s *entry,
+                               uint32_t seq)
+{
+  FAR struct ipfilter_ref_s *ref = kmm_malloc(sizeof(*ref));
+
+  if (ref == NULL)
+    {
+      return false;
+    }
+
+  ref->entry = entry;
+  ref->seq   = seq;
+  sq_addlast(&ref->node, queue);
+  return true;
+}
+
+/****************************************************************************
+ * Name: ipfilter_index_add
+ *
+ * Description:
+ *   Index a rule added at the end of its chain.  Rules for one protocol,
+ *   destination port or ICMP type go to the hash bucket of their class,
+ *   the others to the wildcard lists of all classes they may match.  If the
+ *   index runs out of memory, the chain is walked until it is cleared.
+ *
+ ****************************************************************************/
+
+static void ipfilter_index_add(FAR struct ipfilter_index_s *index,
+                               FAR const struct ipfilter_entry_s *entry)
+{
+  FAR sq_queue_t *queue;
+  uint32_t seq = index->nrules++;
+  bool ok = true;
+  int key = -1;
+  int cls;
+
+  if (index->broken)
+    {
+      return;
+    }
+
+  if (entry->proto == 0 || entry->inv_proto)
+    {
+      for (cls = 0; cls < IPFILTER_NCLASSES && ok; cls++)
+        {
+          ok = ipfilter_index_ref(&index->any[cls], entry, seq);
+        }
+    }
+  else
+    {
+      cls = ipfilter_class(entry->proto);
+
+      if (entry->match_tcpudp && !entry->inv_dport &&
+          entry->match.tcpudp.dports[0] == entry->match.tcpudp.dports[1])
+        {
+          key = entry->match.tcpudp.dports[0];
+        }
+      else if (entry->match_icmp && !entry->inv_icmp &&
+               entry->match.icmp.type != 0xff)
+        {
+          key = entry->match.icmp.type;
+        }
+
+      if (key >= 0 && cls < IPFILTER_NHASHED)
+        {
+          queue = &index->hash[cls][IPFILTER_HASH(key)];
+        }
+      else
+        {
+          queue = &index->any[cls];
+        }
+
+      ok = ipfilter_index_ref(queue, entry, seq);
+    }
+
+  if (!ok)
+    {
+      nwarn("WARNING: Out of memory, filter chain not indexed\n");
+      index->broken = true;
+    }
+}
+
+/****************************************************************************
+ * Name: ipfilter_index_clear
+ *
+ * Description:
+ *   Free all references of an index.
+ *
+ ****************************************************************************/
+
+static void ipfilter_index_clear(FAR struct ipfilter_index_s *index)
+{
+  int cls;
+  int i;
+
+  for (cls = 0; cls < IPFILTER_NCLASSES; cls++)
+    {
+      while (!sq_empty(&index->any[cls]))
+        {
+          kmm_free(sq_remfirst(&index->any[cls]));
+        }
+
+      for (i = 0; cls < IPFILTER_NHASHED && i < IPFILTER_HASH_SIZE; i++)
+        {
+          while (!sq_empty(&index->hash[cls][i]))
+            {
+              kmm_free(sq_remfirst(&index->hash[cls][i]));
+            }
+        }
+    }
+
+  index->nrules = 0;
+  index->broken = false;
+}
+#endif /* CONFIG_NET_IPFILTER_INDEX */
+
+/****************************************************************************
+ * Name: ipfilter_iter_init
+ *
+ * Description:
+ *   Start the walk of the rules of a chain that may match a packet.
+ *
+ * Input Parameters:
+ *   iter  - The iterator to initialize
+ *   queue - The rules of the chain
+ *   index - The index of the chain, NULL if none
+ *   l4hdr - The L4 header of the packet
+ *   proto - The L4 protocol of the packet
+ *
+ ****************************************************************************/
+
+static void ipfilter_iter_init(FAR struct ipfilter_iter_s *iter,
+                               FAR const sq_queue_t *queue,
+                               FAR const void *index,
+                               FAR const void *l4hdr, uint8_t proto)
+{
+#ifdef CONFIG_NET_IPFILTER_INDEX
+  FAR const struct ipfilter_index_s *idx = index;
+  FAR const struct icmp_hdr_s *icmp = l4hdr;
+  FAR const struct udp_hdr_s *udp = l4hdr;
+  int cls = ipfilter_class(proto);
+
+  iter->indexed = !idx->broken;
+  iter->any     = sq_peek(&idx->any[cls]);
+  iter->hash    = NULL;
+
+  /* Ports in TCP & UDP headers and types in ICMP & ICMPv6 headers have
+   * same offset.
+   */
+
+  if (cls < IPFILTER_NHASHED)
+    {
+      iter->hash = sq_peek(&idx->hash[cls][IPFILTER_HASH(
+                     cls == 2 ? icmp->type : NTOHS(udp->destport))]);
+    }
+#else
+  UNUSED(index);
+  UNUSED(l4hdr);
+  UNUSED(proto);
+#endif
+
+  iter->next = sq_peek(queue);
+}
+
+/****************************************************************************
+ * Name: ipfilter_iter_next
+ *
+ * Description:
+ *   Get the next rule that may match the packet, in the order of the
+ *   chain.  With the index, this merges the hashed and wildcard candidates
+ *   of the packet instead of walking the whole chain.
+ *
+ * Returned Value:
+ *   The next rule, NULL at the end of the chain.
+ *
+ ****************************************************************************/
+
+static FAR const struct ipfilter_entry_s *
+ipfilter_iter_next(FAR struct ipfilter_iter_s *iter)
+{
+  FAR const sq_entry_t *entry;
+
+#ifdef CONFIG_NET_IPFILTER_INDEX
+  if (iter->indexed)
+    {
+      FAR const struct ipfilter_ref_s *any =
+        (FAR const struct ipfilter_ref_s *)iter->any;
+      FAR const struct ipfilter_ref_s *hash =
+        (FAR const struct ipfilter_ref_s *)iter->hash;
+
+      if (any != NULL && (hash == NULL || any->seq < hash->seq))
+        {
+          iter->any = sq_next(&any->node);
+          return any->entry;
+        }
+
+      if (hash != NULL)
+        {
+          iter->hash = sq_next(&hash->node);
+          return hash->entry;
+        }
+
+      return NULL;
+    }
+#endif
+
+  entry = iter->next;
+  if (entry != NULL)
+    {
+      iter->next = sq_next(entry);
+    }
+
+  return (FAR const struct ipfilter_entry_s *)entry;
+}
+
 /****************************************************************************
  * Name: ipv4_filter_match / ipv6_filter_match
  *
@@ -214,8 +536,8 @@ static int ipv4_filter_match(FAR const struct net_driver_s *indev,
                              enum ipfilter_chain_e chain)
 {
   FAR const struct ipv4_filter_entry_s *filter;
-  FAR const sq_queue_t *queue = &g_ipv4_filters[chain];
-  FAR const sq_entry_t *entry;
+  FAR const struct ipfilter_entry_s *entry;
+  struct ipfilter_iter_s iter;
   FAR const void *l4hdr;
   in_addr_t ipaddr;
   bool matched;
@@ -229,9 +551,11 @@ static int ipv4_filter_match(FAR const struct net_driver_s *indev,
 
   l4hdr = IPv4_L4HDR(ipv4);
 
-  sq_for_every(queue, entry)
+  ipfilter_iter_init(&iter, &g_ipv4_filters[chain], IPv4_INDEX(chain),
+                     l4hdr, ipv4->proto);
+  while ((entry = ipfilter_iter_next(&iter)) != NULL)
     {
-      filter = (FAR struct ipv4_filter_entry_s *)entry;
+      filter = (FAR const struct ipv4_filter_entry_s *)entry;
 
       /* Match device */
 
@@ -284,8 +608,8 @@ static int ipv6_filter_match(FAR const struct net_driver_s *indev,
                              enum ipfilter_chain_e chain)
 {
   FAR const struct ipv6_filter_entry_s *filter;
-  FAR const sq_queue_t *queue = &g_ipv6_filters[chain];
-  FAR const sq_entry_t *entry;
+  FAR const struct ipfilter_entry_s *entry;
+  struct ipfilter_iter_s iter;
   FAR const void *l4hdr;
   uint8_t proto;
   bool matched;
@@ -299,9 +623,11 @@ static int ipv6_filter_match(FAR const struct net_driver_s *indev,
 
   l4hdr = IPv6_L4HDR(ipv6, proto);
 
-  sq_for_every(queue, entry)
+  ipfilter_iter_init(&iter, &g_ipv6_filters[chain], IPv6_INDEX(chain),
+                     l4hdr, proto);
+  while ((entry = ipfilter_iter_next(&iter)) != NULL)
     {
-      filter = (FAR struct ipv6_filter_entry_s *)entry;
+      filter = (FAR const struct ipv6_filter_entry_s *)entry;
 
       /* Match device */
 
@@ -411,6 +737,9 @@ void ipfilter_cfg_add(FAR struct ipfilter_entry_s *entry,
   if (family == PF_INET)
     {
       sq_addlast((FAR sq_entry_t *)entry, &g_ipv4_filters[chain]);
+#ifdef CONFIG_NET_IPFILTER_INDEX
+      ipfilter_index_add(&g_ipv4_index[chain], entry);
+#endif
     }
 #endif
 
@@ -418,6 +747,9 @@ void ipfilter_cfg_add(FAR struct ipfilter_entry_s *entry,
   if (family == PF_INET6)
     {
       sq_addlast((FAR sq_entry_t *)entry, &g_ipv6_filters[chain]);
+#ifdef CONFIG_NET_IPFILTER_INDEX
+      ipfilter_index_add(&g_ipv6_index[chain], entry);
+#endif
     }
 #endif
 }
@@ -444,6 +776,10 @@ void ipfilter_cfg_clear(sa_family_t family, enum ipfilter_chain_e chain)
   if (family == PF_INET)
     {
       FAR sq_queue_t *queue = &g_ipv4_filters[chain];
+
+#ifdef CONFIG_NET_IPFILTER_INDEX
+      ipfilter_index_clear(&g_ipv4_index[chain]);
+#endif
       while (!sq_empty(queue))
         {
           kmm_free(sq_remfirst(queue));
@@ -455,6 +791,10 @@ void ipfilter_cfg_clear(sa_family_t family, enum ipfilter_chain_e chain)
   if (family == PF_INET6)
     {
       FAR sq_queue_t *queue = &g_ipv6_filters[chain];
+
+#ifdef CONFIG_NET_IPFILTER_INDEX
+      ipfilter_index_clear(&g_ipv6_index[chain]);
+#endif
       while (!sq_empty(queue))
         {
           kmm_free(sq_remfirst(queue));
@@ -32,6 +32,10 @@
 #include <assert.h>
 #include <stdint.h>
 
+#include <netinet/in.h>
+
+struct net_driver_s;     /* Forward reference */
+
 #undef HAVE_FWDALLOC
 #ifdef CONFIG_NET_IPFORWARD
 
@@ -62,7 +66,6 @@ static_assert(CONFIG_IOB_NBUFFERS > CONFIG_NET_IPFORWARD_NSTRUCT,
 /* This is the send state structure */
 
 struct devif_callback_s; /* Forward reference */
-struct net_driver_s;     /* Forward reference */
 struct iob_s;            /* Forward reference */
 
 struct forward_s
@@ -369,4 +372,27 @@ void ipv4_dropstats(FAR struct ipv4_hdr_s *ipv4);
 #endif
 
 #endif /* CONFIG_NET_IPFORWARD */
+
+/****************************************************************************
+ * Name: ipv4_fwdcache_lookup, ipv4_fwdcache_add and ipv4_fwdcache_flush
+ *
+ * Description:
+ *   Cache of the forwarding device of the recent IPv4 destinations, so that
+ *   the packets of established flows are forwarded without a route lookup.
+ *   ipv4_fwdcache_flush() must be called whenever a route, the address or
+ *   the state of a device, or the set of devices changes.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFORWARD_CACHE
+FAR struct net_driver_s *ipv4_fwdcache_lookup(in_addr_t dest);
+void ipv4_fwdcache_add(in_addr_t dest, FAR struct net_driver_s *dev);
+void ipv4_fwdcache_flush(void);
+#else
+#  define ipv4_fwdcache_flush()
+#endif
+
 #endif /* __NET_IPFORWARD_IPFORWARD_H */
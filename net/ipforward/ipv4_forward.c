@@ -469,7 +469,25 @@ int ipv4_forward(FAR struct net_driver_s *dev, FAR struct ipv4_hdr_s *ipv4)
   destipaddr = net_ip4addr_conv32(ipv4->destipaddr);
   srcipaddr  = net_ip4addr_conv32(ipv4->srcipaddr);
 
+#ifdef CONFIG_NET_IPFORWARD_CACHE
+  /* Established flows find their device in the cache.  Broadcasts are
+   * routed by their source address and are never cached.
+   */
+
+  fwddev = ipv4_fwdcache_lookup(destipaddr);
+  if (fwddev == NULL)
+    {
+      fwddev = netdev_findby_ripv4addr(srcipaddr, destipaddr);
+      if (fwddev != NULL &&
+          !net_ipv4addr_cmp(destipaddr, INADDR_BROADCAST))
+        {
+          ipv4_fwdcache_add(destipaddr, fwddev);
+        }
+    }
+#else
   fwddev     = netdev_findby_ripv4addr(srcipaddr, destipaddr);
+#endif
+
   if (fwddev == NULL)
     {
       nwarn("WARNING: Not routable\n");
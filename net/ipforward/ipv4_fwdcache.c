@@ -0,0 +1,156 @@
+/****************************************************************************
+ * net/ipforward/ipv4_fwdcache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+
+#include <netinet/in.h>
+
+#include <nuttx/net/netdev.h>
+
+#include "ipforward/ipforward.h"
+
+#ifdef CONFIG_NET_IPFORWARD_CACHE
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One destination and the device that it was last routed to.  The entry
+ * is valid only if it was filled in the current generation.
+ */
+
+struct ipv4_fwdcache_s
+{
+  in_addr_t                fc_dest;  /* Destination address */
+  FAR struct net_driver_s *fc_dev;   /* Forwarding device */
+  uint32_t                 fc_gen;   /* Generation of the entry */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct ipv4_fwdcache_s
+g_ipv4_fwdcache[CONFIG_NET_IPFORWARD_CACHE_SIZE];
+
+/* Entries are all zero at boot, generation 0 is never current */
+
+static uint32_t g_ipv4_fwdcache_gen = 1;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static inline FAR struct ipv4_fwdcache_s *ipv4_fwdcache_entry(in_addr_t dest)
+{
+  uint32_t hash = (uint32_t)dest * 0x9e3779b1u;
+
+  return &g_ipv4_fwdcache[(hash >> 16) % CONFIG_NET_IPFORWARD_CACHE_SIZE];
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipv4_fwdcache_lookup
+ *
+ * Description:
+ *   Look up the forwarding device of a destination in the cache.
+ *
+ * Input Parameters:
+ *   dest - The destination IPv4 address, in network order
+ *
+ * Returned Value:
+ *   The forwarding device, or NULL if the destination is not cached.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+FAR struct net_driver_s *ipv4_fwdcache_lookup(in_addr_t dest)
+{
+  FAR struct ipv4_fwdcache_s *entry = ipv4_fwdcache_entry(dest);
+
+  if (entry->fc_gen == g_ipv4_fwdcache_gen && entry->fc_dest == dest)
+    {
+      return entry->fc_dev;
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: ipv4_fwdcache_add
+ *
+ * Description:
+ *   Remember the forwarding device of a destination, replacing the entry
+ *   that the destination hashes to.
+ *
+ * Input Parameters:
+ *   dest - The destination IPv4 address, in network order
+ *   dev  - The device the destination is routed to
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void ipv4_fwdcache_add(in_addr_t dest, FAR struct net_driver_s *dev)
+{
+  FAR struct ipv4_fwdcache_s *entry = ipv4_fwdcache_entry(dest);
+
+  entry->fc_dest = dest;
+  entry->fc_dev  = dev;
+  entry->fc_gen  = g_ipv4_fwdcache_gen;
+}
+
+/****************************************************************************
+ * Name: ipv4_fwdcache_flush
+ *
+ * Description:
+ *   Invalidate all of the cached destinations.  This must be called when
+ *   anything that the routing decision depends on changes: a route, the
+ *   address or the state of a device, or the set of devices.
+ *
+ ****************************************************************************/
+
+void ipv4_fwdcache_flush(void)
+{
+  if (++g_ipv4_fwdcache_gen == 0)
+    {
+      /* Wrapped around, make sure that no old entry becomes current */
+
+      memset(g_ipv4_fwdcache, 0, sizeof(g_ipv4_fwdcache));
+      g_ipv4_fwdcache_gen = 1;
+    }
+}
+
+#endif /* CONFIG_NET_IPFORWARD_CACHE */
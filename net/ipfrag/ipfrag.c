@@ -94,7 +94,15 @@ do  \
 
 /* The maximum I/O buffer occupied by fragment reassembly cache */
 
-#define REASSEMBLY_MAXOCCUPYIOB        CONFIG_IOB_NBUFFERS / 5
+#if CONFIG_NET_IPFRAG_REASS_MAXIOBS > 0
+#  define REASSEMBLY_MAXOCCUPYIOB      CONFIG_NET_IPFRAG_REASS_MAXIOBS
+#else
+#  define REASSEMBLY_MAXOCCUPYIOB      (CONFIG_IOB_NBUFFERS / 5)
+#endif
+
+/* The buckets of datagrams being reassembled */
+
+#define REASSEMBLY_HASH_SIZE           (1 << CONFIG_NET_IPFRAG_HASH_BITS)
 
 /* Deciding whether to fragment outgoing packets which target is to ourself */
 
@@ -117,13 +125,13 @@ static struct work_s g_wkfragtimeout;
 
 /* Remember the number of I/O buffers currently in reassembly cache */
 
-static uint8_t       g_bufoccupy;
+static uint32_t      g_bufoccupy;
 
-/* Queue header definition, it links all fragments of all NICs by ascending
- * ipid.
+/* Hash table of the datagrams being reassembled, by source and destination
+ * addresses, IP ID and protocol.
  */
 
-static sq_queue_t    g_assemblyhead_ipid;
+static sq_queue_t    g_assemblyhead_hash[REASSEMBLY_HASH_SIZE];
 
 /* Queue header definition, which connects all fragments of all NICs in order
  * of addition time.
@@ -135,7 +143,7 @@ static sq_queue_t    g_assemblyhead_time;
  * Public Data
  ****************************************************************************/
 
-/* Only one thread can access g_assemblyhead_ipid and g_assemblyhead_time
+/* Only one thread can access g_assemblyhead_hash and g_assemblyhead_time
  * at a time.
  */
 
@@ -151,6 +159,10 @@ static inline FAR struct ip_fraglink_s *
 ip_fragin_freelink(FAR struct ip_fraglink_s *fraglink);
 static void ip_fragin_check(FAR struct ip_fragsnode_s *fragsnode);
 static void ip_fragin_cachemonitor(FAR struct ip_fragsnode_s *curnode);
+static uint32_t ip_fragin_hash(FAR struct ip_fraglink_s *fraglink);
+static bool ip_fragin_match(FAR struct ip_fragsnode_s *node,
+                            FAR struct net_driver_s *dev,
+                            FAR struct ip_fraglink_s *fraglink);
 static inline FAR struct iob_s *
 ip_fragout_allocfragbuf(FAR struct iob_queue_s *fragq);
 
@@ -474,6 +486,116 @@ static void ip_fragin_cachemonitor(FAR struct ip_fragsnode_s *curnode)
     }
 }
 
+/****************************************************************************
+ * Name: ip_fragin_hash
+ *
+ * Description:
+ *   Hash the identity of the datagram of a fragment: the source and
+ *   destination addresses, the IP ID and, for IPv4, the protocol.
+ *
+ * Input Parameters:
+ *   fraglink - The fragment, with its IP header at the start of the I/O
+ *              buffer
+ *
+ * Returned Value:
+ *   The hash value
+ *
+ ****************************************************************************/
+
+static uint32_t ip_fragin_hash(FAR struct ip_fraglink_s *fraglink)
+{
+  FAR uint8_t *l3 = fraglink->frag->io_data + fraglink->frag->io_offset;
+  FAR const uint16_t *addr = NULL;
+  uint32_t hash = fraglink->ipid;
+  int naddr = 0;
+  int i;
+
+#ifdef CONFIG_NET_IPv4
+  if (fraglink->isipv4)
+    {
+      FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)l3;
+
+      addr  = ipv4->srcipaddr;
+      naddr = 4;
+      hash ^= (uint32_t)ipv4->proto << 16;
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  if (!fraglink->isipv4)
+    {
+      FAR struct ipv6_hdr_s *ipv6 = (FAR struct ipv6_hdr_s *)l3;
+
+      addr  = ipv6->srcipaddr;
+      naddr = 16;
+    }
+#endif
+
+  /* The destination address follows the source address in both headers */
+
+  for (i = 0; i < naddr; i++)
+    {
+      hash = (hash * 31) ^ addr[i];
+    }
+
+  return hash ^ (hash >> 16);
+}
+
+/****************************************************************************
+ * Name: ip_fragin_match
+ *
+ * Description:
+ *   Check whether a fragment belongs to the datagram of a node.
+ *
+ * Input Parameters:
+ *   node     - node of the upper-level linked list, with at least one
+ *              fragment
+ *   dev      - NIC Device instance the fragment comes from
+ *   fraglink - The new fragment
+ *
+ * Returned Value:
+ *   True if they have the same device, addresses, IP ID and protocol
+ *
+ ****************************************************************************/
+
+static bool ip_fragin_match(FAR struct ip_fragsnode_s *node,
+                            FAR struct net_driver_s *dev,
+                            FAR struct ip_fraglink_s *fraglink)
+{
+  FAR struct iob_s *frag = node->frags->frag;
+  FAR uint8_t *l3 = frag->io_data + frag->io_offset;
+  FAR uint8_t *r3 = fraglink->frag->io_data + fraglink->frag->io_offset;
+
+  if (node->dev != dev || node->ipid != fraglink->ipid ||
+      node->frags->isipv4 != fraglink->isipv4)
+    {
+      return false;
+    }
+
+#ifdef CONFIG_NET_IPv4
+  if (fraglink->isipv4)
+    {
+      FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)l3;
+      FAR struct ipv4_hdr_s *new4 = (FAR struct ipv4_hdr_s *)r3;
+
+      return ipv4->proto == new4->proto &&
+             memcmp(ipv4->srcipaddr, new4->srcipaddr, 8) == 0;
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  if (!fraglink->isipv4)
+    {
+      FAR struct ipv6_hdr_s *ipv6 = (FAR struct ipv6_hdr_s *)l3;
+      FAR struct ipv6_hdr_s *new6 = (FAR struct ipv6_hdr_s *)r3;
+
+      return memcmp(ipv6->srcipaddr, new6->srcipaddr, 32) == 0;
+    }
+#endif
+
+  return false;
+}
+
 /****************************************************************************
  * Name: ip_fragout_allocfragbuf
  *
@@ -530,7 +652,8 @@ uint32_t ip_frag_remnode(FAR struct ip_fragsnode_s *node)
   g_bufoccupy -= node->bufcnt;
   ASSERT(g_bufoccupy < CONFIG_IOB_NBUFFERS);
 
-  sq_rem((FAR sq_entry_t *)node, &g_assemblyhead_ipid);
+  sq_rem((FAR sq_entry_t *)node,
+         &g_assemblyhead_hash[node->hash & (REASSEMBLY_HASH_SIZE - 1)]);
   sq_rem((FAR sq_entry_t *)&node->flinkat, &g_assemblyhead_time);
 
   return node->bufcnt;
@@ -543,7 +666,7 @@ uint32_t ip_frag_remnode(FAR struct ip_fragsnode_s *node)
  *   Enqueue one fragment.
  *   All fragments belonging to one IP frame are organized in a linked list
  *   form, that is a ip_fragsnode_s node. All ip_fragsnode_s nodes are also
- *   organized in an upper-level linked list.
+ *   organized in an upper-level hash table.
  *
  * Input Parameters:
  *   dev         - NIC Device instance
@@ -560,33 +683,30 @@ bool ip_fragin_enqueue(FAR struct net_driver_s *dev,
 {
   FAR struct ip_fragsnode_s *node;
   FAR sq_entry_t            *entry;
-  FAR sq_entry_t            *entrylast = NULL;
+  FAR sq_queue_t            *bucket;
+  uint32_t                   hash;
   bool                       empty;
 
-  /* The linked list is ordered by IP ID value, walk through it and try to
-   * find a node that has the same IP ID value, otherwise need to create a
-   * new node and insert it into the linked list.
+  /* Look for the node of the datagram in its hash bucket, otherwise need
+   * to create a new node and insert it into the bucket.
    */
 
-  entry = sq_peek(&g_assemblyhead_ipid);
-  empty = (entry == NULL) ? true : false;
+  empty  = sq_peek(&g_assemblyhead_time) == NULL;
+  hash   = ip_fragin_hash(curfraglink);
+  bucket = &g_assemblyhead_hash[hash & (REASSEMBLY_HASH_SIZE - 1)];
 
-  while (entry != NULL)
+  for (entry = sq_peek(bucket); entry != NULL; entry = sq_next(entry))
     {
-      node = (struct ip_fragsnode_s *)entry;
-
-      if (dev == node->dev && curfraglink->ipid <= node->ipid)
+      node = (FAR struct ip_fragsnode_s *)entry;
+      if (node->hash == hash && ip_fragin_match(node, dev, curfraglink))
         {
           break;
         }
-
-      entrylast = entry;
-      entry = sq_next(entry);
     }
 
   node = (FAR struct ip_fragsnode_s *)entry;
 
-  if (node != NULL && curfraglink->ipid == node->ipid)
+  if (node != NULL)
     {
       FAR struct ip_fraglink_s *fraglink;
       FAR struct ip_fraglink_s *lastlink = NULL;
@@ -689,6 +809,7 @@ bool ip_fragin_enqueue(FAR struct net_driver_s *dev,
       node->flinkat    = NULL;
       node->dev        = dev;
       node->ipid       = curfraglink->ipid;
+      node->hash       = hash;
       node->frags      = curfraglink;
       node->tick       = clock_systime_ticks();
       node->bufcnt     = IOBUF_CNT(curfraglink->frag);
@@ -696,19 +817,9 @@ bool ip_fragin_enqueue(FAR struct net_driver_s *dev,
       node->verifyflag = 0;
       node->outgoframe = NULL;
 
-      /* Insert this new node into linked list identified by
-       * g_assemblyhead_ipid with correct position
-       */
+      /* Insert this new node into its hash bucket */
 
-      if (sq_peek(&g_assemblyhead_ipid) == NULL || entrylast == NULL)
-        {
-          sq_addfirst((FAR sq_entry_t *)node, &g_assemblyhead_ipid);
-        }
-      else
-        {
-          sq_addafter(entrylast, (FAR sq_entry_t *)node,
-                      &g_assemblyhead_ipid);
-        }
+      sq_addfirst((FAR sq_entry_t *)node, bucket);
 
       /* Add this new node to the tail of linked list identified by
        * g_assemblyhead_time
@@ -1117,13 +1228,14 @@ void ip_frag_stop(FAR struct net_driver_s *dev)
 
   nxmutex_lock(&g_ipfrag_lock);
 
-  entry = sq_peek(&g_assemblyhead_ipid);
+  entry = sq_peek(&g_assemblyhead_time);
 
   /* Drop those unassembled incoming fragments belonging to this NIC */
 
   while (entry != NULL)
     {
-      FAR struct ip_fragsnode_s *node = (FAR struct ip_fragsnode_s *)entry;
+      FAR struct ip_fragsnode_s *node = (FAR struct ip_fragsnode_s *)
+        container_of(entry, FAR struct ip_fragsnode_s, flinkat);
       entrynext = sq_next(entry);
 
       if (dev == node->dev)
@@ -1139,7 +1251,7 @@ void ip_frag_stop(FAR struct net_driver_s *dev)
             }
 
           ip_frag_remnode(node);
-          kmm_free(entry);
+          kmm_free(node);
         }
 
       entry = entrynext;
@@ -1169,16 +1281,18 @@ void ip_frag_remallfrags(void)
   FAR sq_entry_t *entry = NULL;
   FAR sq_entry_t *entrynext;
   FAR struct net_driver_s *dev;
+  int i;
 
   nxmutex_lock(&g_ipfrag_lock);
 
-  entry = sq_peek(&g_assemblyhead_ipid);
+  entry = sq_peek(&g_assemblyhead_time);
 
   /* Drop all unassembled incoming fragments */
 
   while (entry != NULL)
     {
-      FAR struct ip_fragsnode_s *node = (FAR struct ip_fragsnode_s *)entry;
+      FAR struct ip_fragsnode_s *node = (FAR struct ip_fragsnode_s *)
+        container_of(entry, FAR struct ip_fragsnode_s, flinkat);
       entrynext = sq_next(entry);
 
       if (node->frags != NULL)
@@ -1191,18 +1305,21 @@ void ip_frag_remallfrags(void)
             }
         }
 
-      /* Because nodes managed by the two queues are the same,
-       * and g_assemblyhead_ipid will be cleared after this loop ends,
-       * so only reset g_assemblyhead_time is needed after this loop ends
+      /* Because nodes managed by the queues are the same, the queues are
+       * just reset after this loop ends
        */
 
-      sq_rem(entry, &g_assemblyhead_ipid);
-      kmm_free(entry);
+      kmm_free(node);
 
       entry = entrynext;
     }
 
   sq_init(&g_assemblyhead_time);
+  for (i = 0; i < REASSEMBLY_HASH_SIZE; i++)
+    {
+      sq_init(&g_assemblyhead_hash[i]);
+    }
+
   g_bufoccupy = 0;
 
   nxmutex_unlock(&g_ipfrag_lock);
@@ -1251,6 +1368,13 @@ int32_t ip_fragout(FAR struct net_driver_s *dev)
       return OK;
     }
 
+  /* A GSO packet is segmented by the driver, not fragmented */
+
+  if (NETDEV_GSO_SIZE(dev) > 0)
+    {
+      return OK;
+    }
+
 #ifdef CONFIG_NET_6LOWPAN
   if (dev->d_lltype == NET_LL_IEEE802154 ||
       dev->d_lltype == NET_LL_PKTRADIO)
@@ -116,6 +116,10 @@ struct ip_fragsnode_s
 
   uint32_t                   ipid;
 
+  /* Hash of the addresses, IP ID and protocol, selects the bucket */
+
+  uint32_t                   hash;
+
   /* Count ticks, used by ressembly timer */
 
   clock_t                    tick;
@@ -149,7 +153,7 @@ extern "C"
 #  define EXTERN extern
 #endif
 
-/* Only one thread can access g_assemblyhead_ipid and g_assemblyhead_time
+/* Only one thread can access g_assemblyhead_hash and g_assemblyhead_time
  * at a time
  */
 
@@ -183,7 +187,7 @@ uint32_t ip_frag_remnode(FAR struct ip_fragsnode_s *node);
  *   Enqueue one fragment.
  *   All fragments belonging to one IP frame are organized in a linked list
  *   form, that is a ip_fragsnode_s node. All ip_fragsnode_s nodes are also
- *   organized in an upper-level linked list.
+ *   organized in an upper-level hash table.
  *
  * Input Parameters:
  *   dev         - NIC Device instance
@@ -46,6 +46,16 @@
 static DECLARE_HASHTABLE(g_nat44_inbound, CONFIG_NET_NAT_HASH_BITS);
 static DECLARE_HASHTABLE(g_nat44_outbound, CONFIG_NET_NAT_HASH_BITS);
 
+/* The entries from the least to the most recently used, with one list for
+ * each idle timeout, so that they are also in the order of expiration.
+ */
+
+static dq_queue_t g_nat44_lru[NAT_LRU_NLISTS];
+
+#if CONFIG_NET_NAT_MAX_ENTRIES > 0
+static unsigned int g_nat44_nentries;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -95,64 +105,14 @@ static inline uint32_t ipv4_nat_outbound_key(in_addr_t local_ip,
 
 static void ipv4_nat_entry_refresh(FAR ipv4_nat_entry_t *entry)
 {
-  entry->expire_time = nat_expire_time(entry->protocol);
-}
+  FAR dq_queue_t *lru = &g_nat44_lru[nat_lru_index(entry->protocol)];
 
-/****************************************************************************
- * Name: ipv4_nat_entry_create
- *
- * Description:
- *   Create a NAT entry and insert into entry list.
- *
- * Input Parameters:
- *   protocol      - The L4 protocol of the packet.
- *   external_ip   - The external ip of the packet.
- *   external_port - The external port of the packet.
- *   local_ip      - The local ip of the packet.
- *   local_port    - The local port of the packet.
- *   peer_ip       - The peer ip of the packet.
- *   peer_port     - The peer port of the packet.
- *
- * Returned Value:
- *   Pointer to entry on success; null on failure
- *
- ****************************************************************************/
-
-static FAR ipv4_nat_entry_t *
-ipv4_nat_entry_create(uint8_t protocol,
-                      in_addr_t external_ip, uint16_t external_port,
-                      in_addr_t local_ip, uint16_t local_port,
-                      in_addr_t peer_ip, uint16_t peer_port)
-{
-  FAR ipv4_nat_entry_t *entry = kmm_malloc(sizeof(ipv4_nat_entry_t));
-  if (entry == NULL)
-    {
-      nwarn("WARNING: Failed to allocate IPv4 NAT entry\n");
-      return NULL;
-    }
-
-  entry->protocol      = protocol;
-  entry->external_ip   = external_ip;
-  entry->external_port = external_port;
-  entry->local_ip      = local_ip;
-  entry->local_port    = local_port;
-#ifdef CONFIG_NET_NAT44_SYMMETRIC
-  entry->peer_ip       = peer_ip;
-  entry->peer_port     = peer_port;
-#endif
-
-  ipv4_nat_entry_refresh(entry);
-
-  hashtable_add(g_nat44_inbound, &entry->hash_inbound,
-                ipv4_nat_inbound_key(external_ip, external_port, protocol));
-  hashtable_add(g_nat44_outbound, &entry->hash_outbound,
-                ipv4_nat_outbound_key(local_ip, local_port, protocol));
+  entry->expire_time = nat_expire_time(entry->protocol);
 
-#ifdef CONFIG_NETLINK_NETFILTER
-  netlink_conntrack_notify(IPCTNL_MSG_CT_NEW, PF_INET, entry);
-#endif
+  /* It is now the most recently used entry of its list */
 
-  return entry;
+  dq_rem(&entry->lru, lru);
+  dq_addlast(&entry->lru, lru);
 }
 
 /****************************************************************************
@@ -182,6 +142,11 @@ static void ipv4_nat_entry_delete(FAR ipv4_nat_entry_t *entry)
                                          entry->local_port,
                                          entry->protocol));
 
+  dq_rem(&entry->lru, &g_nat44_lru[nat_lru_index(entry->protocol)]);
+#if CONFIG_NET_NAT_MAX_ENTRIES > 0
+  g_nat44_nentries--;
+#endif
+
 #ifdef CONFIG_NETLINK_NETFILTER
   netlink_conntrack_notify(IPCTNL_MSG_CT_DELETE, PF_INET, entry);
 #endif
@@ -190,48 +155,161 @@ static void ipv4_nat_entry_delete(FAR ipv4_nat_entry_t *entry)
 }
 
 /****************************************************************************
- * Name: ipv4_nat_reclaim_entry
+ * Name: ipv4_nat_expire_entry
  *
  * Description:
- *   Try reclaim all expired NAT entries.
- *   Only works after every CONFIG_NET_NAT_ENTRY_RECLAIM_SEC (low frequency).
- *
- *   Although expired entries will be automatically reclaimed when matching
- *   inbound/outbound entries, there might be some situations that entries
- *   will be kept in memory, e.g. big hashtable with only a few connections.
+ *   Delete all expired NAT entries.  They are at the heads of the LRU
+ *   lists, so this only visits them and the first live entry of each list.
  *
- * Assumptions:
- *   NAT is initialized.
+ * Input Parameters:
+ *   current_time - The current time in seconds.
  *
  ****************************************************************************/
 
-#if CONFIG_NET_NAT_ENTRY_RECLAIM_SEC > 0
-static void ipv4_nat_reclaim_entry_cb(FAR ipv4_nat_entry_t *entry,
-                                      FAR void *arg)
+static void ipv4_nat_expire_entry(int32_t current_time)
 {
-  int32_t current_time = *(FAR int32_t *)arg;
+  FAR ipv4_nat_entry_t *entry;
+  FAR dq_entry_t *node;
+  int i;
 
-  if (entry->expire_time - current_time <= 0)
+  for (i = 0; i < NAT_LRU_NLISTS; i++)
     {
-      ipv4_nat_entry_delete(entry);
+      while ((node = dq_peek(&g_nat44_lru[i])) != NULL)
+        {
+          entry = container_of(node, ipv4_nat_entry_t, lru);
+          if (entry->expire_time - current_time > 0)
+            {
+              break;
+            }
+
+          ipv4_nat_entry_delete(entry);
+        }
     }
 }
 
-static void ipv4_nat_reclaim_entry(int32_t current_time)
+/****************************************************************************
+ * Name: ipv4_nat_evict_entry
+ *
+ * Description:
+ *   Delete the least recently used NAT entry to make room for a new one,
+ *   when CONFIG_NET_NAT_MAX_ENTRIES entries are in use.
+ *
+ * Input Parameters:
+ *   current_time - The current time in seconds.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_NAT_MAX_ENTRIES > 0
+static void ipv4_nat_evict_entry(int32_t current_time)
 {
-  static int32_t next_reclaim_time = CONFIG_NET_NAT_ENTRY_RECLAIM_SEC;
+  FAR ipv4_nat_entry_t *oldest = NULL;
+  FAR ipv4_nat_entry_t *entry;
+  FAR dq_entry_t *node;
+  int32_t oldest_use = 0;
+  int32_t last_use;
+  int i;
+
+  /* The least recently used entry is the head of one of the lists */
+
+  for (i = 0; i < NAT_LRU_NLISTS; i++)
+    {
+      node = dq_peek(&g_nat44_lru[i]);
+      if (node == NULL)
+        {
+          continue;
+        }
 
-  if (next_reclaim_time - current_time <= 0)
+      /* The time of the last use is the expiration time less the timeout */
+
+      entry    = container_of(node, ipv4_nat_entry_t, lru);
+      last_use = entry->expire_time -
+                 (int32_t)(nat_expire_time(entry->protocol) - current_time);
+
+      if (oldest == NULL || last_use - oldest_use < 0)
+        {
+          oldest     = entry;
+          oldest_use = last_use;
+        }
+    }
+
+  if (oldest != NULL)
     {
-      ninfo("INFO: Reclaiming all expired NAT44 entries.\n");
-      ipv4_nat_entry_foreach(ipv4_nat_reclaim_entry_cb, &current_time);
-      next_reclaim_time = current_time + CONFIG_NET_NAT_ENTRY_RECLAIM_SEC;
+      nwarn("WARNING: NAT44 table full, evicting the oldest entry\n");
+      ipv4_nat_entry_delete(oldest);
     }
 }
-#else
-#  define ipv4_nat_reclaim_entry(t)
 #endif
 
+/****************************************************************************
+ * Name: ipv4_nat_entry_create
+ *
+ * Description:
+ *   Create a NAT entry and insert into entry list.
+ *
+ * Input Parameters:
+ *   protocol      - The L4 protocol of the packet.
+ *   external_ip   - The external ip of the packet.
+ *   external_port - The external port of the packet.
+ *   local_ip      - The local ip of the packet.
+ *   local_port    - The local port of the packet.
+ *   peer_ip       - The peer ip of the packet.
+ *   peer_port     - The peer port of the packet.
+ *
+ * Returned Value:
+ *   Pointer to entry on success; null on failure
+ *
+ ****************************************************************************/
+
+static FAR ipv4_nat_entry_t *
+ipv4_nat_entry_create(uint8_t protocol,
+                      in_addr_t external_ip, uint16_t external_port,
+                      in_addr_t local_ip, uint16_t local_port,
+                      in_addr_t peer_ip, uint16_t peer_port)
+{
+  FAR ipv4_nat_entry_t *entry;
+
+#if CONFIG_NET_NAT_MAX_ENTRIES > 0
+  if (g_nat44_nentries >= CONFIG_NET_NAT_MAX_ENTRIES)
+    {
+      ipv4_nat_evict_entry(TICK2SEC(clock_systime_ticks()));
+    }
+#endif
+
+  entry = kmm_malloc(sizeof(ipv4_nat_entry_t));
+  if (entry == NULL)
+    {
+      nwarn("WARNING: Failed to allocate IPv4 NAT entry\n");
+      return NULL;
+    }
+
+  entry->protocol      = protocol;
+  entry->external_ip   = external_ip;
+  entry->external_port = external_port;
+  entry->local_ip      = local_ip;
+  entry->local_port    = local_port;
+#ifdef CONFIG_NET_NAT44_SYMMETRIC
+  entry->peer_ip       = peer_ip;
+  entry->peer_port     = peer_port;
+#endif
+
+  entry->expire_time = nat_expire_time(protocol);
+  dq_addlast(&entry->lru, &g_nat44_lru[nat_lru_index(protocol)]);
+#if CONFIG_NET_NAT_MAX_ENTRIES > 0
+  g_nat44_nentries++;
+#endif
+
+  hashtable_add(g_nat44_inbound, &entry->hash_inbound,
+                ipv4_nat_inbound_key(external_ip, external_port, protocol));
+  hashtable_add(g_nat44_outbound, &entry->hash_outbound,
+                ipv4_nat_outbound_key(local_ip, local_port, protocol));
+
+#ifdef CONFIG_NETLINK_NETFILTER
+  netlink_conntrack_notify(IPCTNL_MSG_CT_NEW, PF_INET, entry);
+#endif
+
+  return entry;
+}
+
 /****************************************************************************
  * Name: ipv4_nat_entry_clear_cb
  *
@@ -336,7 +414,7 @@ ipv4_nat_inbound_entry_find(uint8_t protocol, in_addr_t external_ip,
 #endif
   int32_t current_time = TICK2SEC(clock_systime_ticks());
 
-  ipv4_nat_reclaim_entry(current_time);
+  ipv4_nat_expire_entry(current_time);
 
   hashtable_for_every_possible_safe(g_nat44_inbound, p, tmp,
                   ipv4_nat_inbound_key(external_ip, external_port, protocol))
@@ -412,7 +490,7 @@ ipv4_nat_outbound_entry_find(FAR struct net_driver_s *dev, uint8_t protocol,
   uint16_t external_port;
   int32_t current_time = TICK2SEC(clock_systime_ticks());
 
-  ipv4_nat_reclaim_entry(current_time);
+  ipv4_nat_expire_entry(current_time);
 
   hashtable_for_every_possible_safe(g_nat44_outbound, p, tmp,
                       ipv4_nat_outbound_key(local_ip, local_port, protocol))
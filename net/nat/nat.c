@@ -403,4 +403,35 @@ uint32_t nat_expire_time(uint8_t protocol)
   }
 }
 
+/****************************************************************************
+ * Name: nat_lru_index
+ *
+ * Description:
+ *   Get the LRU list of a protocol.  The entries of a list have the same
+ *   idle timeout, so the least recently used entry of a list is also the
+ *   first to expire.
+ *
+ * Input Parameters:
+ *   protocol - The L4 protocol of the packet.
+ *
+ * Returned Value:
+ *   The index of the list, less than NAT_LRU_NLISTS.
+ *
+ ****************************************************************************/
+
+int nat_lru_index(uint8_t protocol)
+{
+  switch (protocol)
+    {
+      case IP_PROTO_TCP:
+        return 0;
+
+      case IP_PROTO_UDP:
+        return 1;
+
+      default:
+        return 2;
+    }
+}
+
 #endif /* CONFIG_NET_NAT */
@@ -35,6 +35,7 @@
 #include <netinet/in.h>
 
 #include <nuttx/hashtable.h>
+#include <nuttx/queue.h>
 #include <nuttx/net/ip.h>
 #include <nuttx/net/netdev.h>
 
@@ -50,6 +51,12 @@
   net_chksum_adjust((FAR uint16_t *)(chksum), (FAR uint16_t *)(optr), len, \
                     (FAR uint16_t *)(nptr), len)
 
+/* The entries are kept in one LRU list per group of protocols of the same
+ * idle timeout (TCP, UDP and ICMP/ICMPv6), see nat_lru_index().
+ */
+
+#define NAT_LRU_NLISTS 3
+
 /* Getting IP & Port to manipulate from L3/L4 header. */
 
 #define MANIP_IPADDR(iphdr,manip_type) \
@@ -74,6 +81,7 @@ struct ipv4_nat_entry_s
 {
   hash_node_t hash_inbound;
   hash_node_t hash_outbound;
+  dq_entry_t  lru;           /* Node in the LRU list of the protocol. */
 
   /*  Local Network                             External Network
    *                |----------------|
@@ -106,6 +114,7 @@ struct ipv6_nat_entry_s
 {
   hash_node_t    hash_inbound;
   hash_node_t    hash_outbound;
+  dq_entry_t     lru;           /* Node in the LRU list of the protocol. */
 
   net_ipv6addr_t local_ip;      /* IP address of the local host. */
   net_ipv6addr_t external_ip;   /* External IP address. */
@@ -288,6 +297,24 @@ uint16_t nat_port_select(FAR struct net_driver_s *dev,
 
 uint32_t nat_expire_time(uint8_t protocol);
 
+/****************************************************************************
+ * Name: nat_lru_index
+ *
+ * Description:
+ *   Get the LRU list of a protocol.  The entries of a list have the same
+ *   idle timeout, so the least recently used entry of a list is also the
+ *   first to expire.
+ *
+ * Input Parameters:
+ *   protocol - The L4 protocol of the packet.
+ *
+ * Returned Value:
+ *   The index of the list, less than NAT_LRU_NLISTS.
+ *
+ ****************************************************************************/
+
+int nat_lru_index(uint8_t protocol);
+
 /****************************************************************************
  * Name: ipv4/ipv6_nat_entry_foreach
  *
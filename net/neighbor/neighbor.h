@@ -72,6 +72,49 @@ struct net_driver_s; /* Forward reference */
 
 FAR struct neighbor_entry_s *neighbor_findentry(const net_ipv6addr_t ipaddr);
 
+/****************************************************************************
+ * Name: neighbor_hashfirst / neighbor_hashnext
+ *
+ * Description:
+ *   Iterate over the entries in use of the hash bucket of 'ipaddr'.
+ *
+ ****************************************************************************/
+
+FAR struct neighbor_entry_s *neighbor_hashfirst(const net_ipv6addr_t ipaddr);
+FAR struct neighbor_entry_s *
+neighbor_hashnext(FAR struct neighbor_entry_s *neighbor);
+
+/****************************************************************************
+ * Name: neighbor_alloc
+ *
+ * Description:
+ *   Get an unused entry or evict the least recently used one.  The entry
+ *   must be filled in and then inserted with neighbor_hashadd().
+ *
+ ****************************************************************************/
+
+FAR struct neighbor_entry_s *neighbor_alloc(void);
+
+/****************************************************************************
+ * Name: neighbor_hashadd
+ *
+ * Description:
+ *   Insert an entry returned by neighbor_alloc() into the table.
+ *
+ ****************************************************************************/
+
+void neighbor_hashadd(FAR struct neighbor_entry_s *neighbor);
+
+/****************************************************************************
+ * Name: neighbor_touch
+ *
+ * Description:
+ *   Mark an entry in use as the most recently used one.
+ *
+ ****************************************************************************/
+
+void neighbor_touch(FAR struct neighbor_entry_s *neighbor);
+
 /****************************************************************************
  * Name: neighbor_add
  *
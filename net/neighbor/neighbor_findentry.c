@@ -53,12 +53,12 @@
 
 FAR struct neighbor_entry_s *neighbor_findentry(const net_ipv6addr_t ipaddr)
 {
-  int i;
+  FAR struct neighbor_entry_s *neighbor;
 
-  for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
+  for (neighbor = neighbor_hashfirst(ipaddr);
+       neighbor != NULL;
+       neighbor = neighbor_hashnext(neighbor))
     {
-      FAR struct neighbor_entry_s *neighbor = &g_neighbors[i];
-
       if (net_ipv6addr_cmp(neighbor->ne_ipaddr, ipaddr))
         {
           neighbor_dumpentry("Entry found", neighbor);
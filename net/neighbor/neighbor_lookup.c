@@ -132,6 +132,10 @@ int neighbor_lookup(FAR const net_ipv6addr_t ipaddr,
           memcpy(laddr, &neighbor->ne_addr, sizeof(*laddr));
         }
 
+      /* Keep entries that are in use away from replacement */
+
+      neighbor_touch(neighbor);
+
       /* Return success in any case meaning that a valid link layer
        * address mapping is available for the IPv6 address.
        */
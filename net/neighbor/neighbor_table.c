@@ -0,0 +1,203 @@
+/****************************************************************************
+ * net/neighbor/neighbor_table.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#include <nuttx/queue.h>
+
+#include "neighbor/neighbor.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define NEIGHBOR_NENTRIES  CONFIG_NET_IPv6_NCONF_ENTRIES
+
+/* The hash table has as many buckets as there are entries */
+
+#define NEIGHBOR_HASH(ipaddr)  (neighbor_hash(ipaddr) % NEIGHBOR_NENTRIES)
+
+/* Map a table entry to its bookkeeping and back */
+
+#define NEIGHBOR_LINK(ne)   (&g_neighbor_links[(ne) - g_neighbors])
+#define NEIGHBOR_ENTRY(nl)  (&g_neighbors[(nl) - g_neighbor_links])
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The hash and LRU bookkeeping of one entry of g_neighbors[].  It is kept
+ * apart from struct neighbor_entry_s because that structure is also
+ * reported to user space through netlink.
+ */
+
+struct neighbor_link_s
+{
+  dq_entry_t                   nl_lru;    /* LRU list link */
+  FAR struct neighbor_entry_s *nl_hnext;  /* Next entry in the bucket */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The entries in use are reachable through g_neighbor_hash and are kept in
+ * g_neighbor_lru in order of last use, least recently used first.  Entries
+ * at and above g_neighbor_next have never been used.
+ */
+
+static struct neighbor_link_s g_neighbor_links[NEIGHBOR_NENTRIES];
+static FAR struct neighbor_entry_s *g_neighbor_hash[NEIGHBOR_NENTRIES];
+static dq_queue_t g_neighbor_lru;
+static unsigned int g_neighbor_next;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: neighbor_hash
+ ****************************************************************************/
+
+static inline uint32_t neighbor_hash(const net_ipv6addr_t ipaddr)
+{
+  uint32_t hash = 0;
+  int i;
+
+  for (i = 0; i < 8; i++)
+    {
+      hash = hash * 31 + ipaddr[i];
+    }
+
+  hash ^= hash >> 16;
+  hash *= 0x45d9f3b;
+  hash ^= hash >> 16;
+  return hash;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: neighbor_hashfirst / neighbor_hashnext
+ *
+ * Description:
+ *   Iterate over the entries in use whose IPv6 address falls into the same
+ *   hash bucket as 'ipaddr'.  The caller must still compare the address.
+ *
+ ****************************************************************************/
+
+FAR struct neighbor_entry_s *neighbor_hashfirst(const net_ipv6addr_t ipaddr)
+{
+  return g_neighbor_hash[NEIGHBOR_HASH(ipaddr)];
+}
+
+FAR struct neighbor_entry_s *
+neighbor_hashnext(FAR struct neighbor_entry_s *neighbor)
+{
+  return NEIGHBOR_LINK(neighbor)->nl_hnext;
+}
+
+/****************************************************************************
+ * Name: neighbor_alloc
+ *
+ * Description:
+ *   Get an entry for a new mapping: an entry that was never used, else the
+ *   least recently used one.  An evicted entry is removed from the hash
+ *   and the LRU list but still holds its old content (ne_time != 0) so
+ *   that the caller can report its removal.  The caller must fill in the
+ *   new mapping and then call neighbor_hashadd().
+ *
+ ****************************************************************************/
+
+FAR struct neighbor_entry_s *neighbor_alloc(void)
+{
+  FAR struct neighbor_entry_s **link;
+  FAR struct neighbor_entry_s *neighbor;
+  FAR struct neighbor_link_s *nl;
+
+  if (g_neighbor_next < NEIGHBOR_NENTRIES)
+    {
+      return &g_neighbors[g_neighbor_next++];
+    }
+
+  nl       = (FAR struct neighbor_link_s *)dq_remfirst(&g_neighbor_lru);
+  neighbor = NEIGHBOR_ENTRY(nl);
+
+  for (link = &g_neighbor_hash[NEIGHBOR_HASH(neighbor->ne_ipaddr)];
+       *link != NULL;
+       link = &NEIGHBOR_LINK(*link)->nl_hnext)
+    {
+      if (*link == neighbor)
+        {
+          *link = nl->nl_hnext;
+          break;
+        }
+    }
+
+  nl->nl_hnext = NULL;
+  return neighbor;
+}
+
+/****************************************************************************
+ * Name: neighbor_hashadd
+ *
+ * Description:
+ *   Insert an entry returned by neighbor_alloc() into the hash bucket of
+ *   its (new) IPv6 address and make it the most recently used entry.
+ *
+ ****************************************************************************/
+
+void neighbor_hashadd(FAR struct neighbor_entry_s *neighbor)
+{
+  FAR struct neighbor_entry_s **bucket;
+  FAR struct neighbor_link_s *nl = NEIGHBOR_LINK(neighbor);
+
+  bucket       = &g_neighbor_hash[NEIGHBOR_HASH(neighbor->ne_ipaddr)];
+  nl->nl_hnext = *bucket;
+  *bucket      = neighbor;
+
+  dq_addlast(&nl->nl_lru, &g_neighbor_lru);
+}
+
+/****************************************************************************
+ * Name: neighbor_touch
+ *
+ * Description:
+ *   Make an entry in use the most recently used entry.
+ *
+ ****************************************************************************/
+
+void neighbor_touch(FAR struct neighbor_entry_s *neighbor)
+{
+  FAR struct neighbor_link_s *nl = NEIGHBOR_LINK(neighbor);
+
+  dq_rem(&nl->nl_lru, &g_neighbor_lru);
+  dq_addlast(&nl->nl_lru, &g_neighbor_lru);
+}
@@ -81,6 +81,7 @@
 #include "socket/socket.h"
 #include "netdev/netdev.h"
 #include "devif/devif.h"
+#include "ipforward/ipforward.h"
 #include "igmp/igmp.h"
 #include "icmpv6/icmpv6.h"
 #include "route/route.h"
@@ -884,6 +885,7 @@ static int netdev_ifr_ioctl(FAR struct socket *psock, int cmd,
 
       case SIOCSIFDSTADDR:  /* Set P-to-P address */
         ioctl_set_ipv4addr(&dev->d_draddr, &req->ifr_dstaddr);
+        ipv4_fwdcache_flush();
         break;
 
       case SIOCGIFBRDADDR:  /* Get broadcast IP address */
@@ -901,6 +903,7 @@ static int netdev_ifr_ioctl(FAR struct socket *psock, int cmd,
 
       case SIOCSIFNETMASK:  /* Set network mask */
         ioctl_set_ipv4addr(&dev->d_netmask, &req->ifr_addr);
+        ipv4_fwdcache_flush();
         break;
 #endif
 
@@ -1093,6 +1096,7 @@ static int netdev_ifr_ioctl(FAR struct socket *psock, int cmd,
               }
 
             ioctl_set_ipv4addr(&dev->d_ipaddr, &req->ifr_addr);
+            ipv4_fwdcache_flush();
             netlink_device_notify_ipaddr(dev, RTM_NEWADDR, AF_INET,
                          &dev->d_ipaddr, net_ipv4_mask2pref(dev->d_netmask));
 
@@ -1124,6 +1128,7 @@ static int netdev_ifr_ioctl(FAR struct socket *psock, int cmd,
             netlink_device_notify_ipaddr(dev, RTM_DELADDR, AF_INET,
                          &dev->d_ipaddr, net_ipv4_mask2pref(dev->d_netmask));
             dev->d_ipaddr = 0;
+            ipv4_fwdcache_flush();
           }
 #endif
 
@@ -1600,9 +1605,9 @@ static int netdev_ioctl(FAR struct socket *psock, int cmd,
 {
   int ret = -ENOTTY;
 
-  if (psock->s_sockif && psock->s_sockif->si_ioctl)
+  if (psock->s_sockif && psock_sockif(psock)->si_ioctl)
     {
-      ret = psock->s_sockif->si_ioctl(psock, cmd, arg);
+      ret = psock_sockif(psock)->si_ioctl(psock, cmd, arg);
     }
 
   if (ret != OK && ret != -ENOTTY)
@@ -1624,8 +1629,8 @@ static int netdev_ioctl(FAR struct socket *psock, int cmd,
            */
 
           DEBUGASSERT(psock->s_sockif != NULL &&
-                      psock->s_sockif->si_sockcaps != NULL);
-          sockcaps = psock->s_sockif->si_sockcaps(psock);
+                      psock_sockif(psock)->si_sockcaps != NULL);
+          sockcaps = psock_sockif(psock)->si_sockcaps(psock);
 
           if ((sockcaps & SOCKCAP_NONBLOCKING) != 0)
             {
@@ -1961,6 +1966,7 @@ int netdev_ifup(FAR struct net_driver_s *dev)
               /* Mark the interface as up */
 
               dev->d_flags |= IFF_UP;
+              ipv4_fwdcache_flush();
 
               /* Update the driver status */
 
@@ -1995,6 +2001,7 @@ int netdev_ifdown(FAR struct net_driver_s *dev)
               /* Mark the interface as down */
 
               dev->d_flags &= ~(IFF_UP | IFF_RUNNING);
+              ipv4_fwdcache_flush();
 
               /* Update the driver status */
 
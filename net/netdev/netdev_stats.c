@@ -64,6 +64,9 @@ void netdev_statistics_log(FAR void *arg)
             "(%" PRIu32 "+%" PRIu32 ")/"
 #endif
             "%" PRIu32 "(%" PRIu64 "B)"
+#ifdef CONFIG_NETDEV_NAPI
+            " IRQ%" PRIu32 ",POLL%" PRIu32
+#endif
 #ifdef CONFIG_NET_TCP
             " TCP:T%" PRIu16 ",R%" PRIu16 ",D%" PRIu16
 #endif
@@ -83,6 +86,9 @@ void netdev_statistics_log(FAR void *arg)
             , stats->rx_ipv4, stats->rx_ipv6
 #endif
             , stats->rx_packets, stats->rx_bytes
+#ifdef CONFIG_NETDEV_NAPI
+            , stats->rx_interrupts, stats->rx_polls
+#endif
 #ifdef CONFIG_NET_TCP
             , g_netstats.tcp.sent, g_netstats.tcp.recv, g_netstats.tcp.drop
 #endif
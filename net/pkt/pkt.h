@@ -30,8 +30,12 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <poll.h>
+
+#include <netpacket/packet.h>
 
 #include <nuttx/net/net.h>
+#include <nuttx/wqueue.h>
 
 #ifdef CONFIG_NET_PKT
 
@@ -50,6 +54,27 @@
  * Public Type Definitions
  ****************************************************************************/
 
+/* One mmap'ed ring of a packet socket, see <netpacket/packet.h> */
+
+#ifdef CONFIG_NET_PKT_MMAP
+struct pkt_ring_s
+{
+  FAR uint8_t *base;   /* Start of the ring in the mapping, NULL if none */
+  uint32_t size;       /* Size of a block (RX) or of a frame (TX) */
+  uint32_t nr;         /* Number of blocks (RX) or of frames (TX) */
+  uint32_t head;       /* Block being filled (RX), next frame to send (TX) */
+
+  /* RX only */
+
+  uint32_t first;      /* Offset of the first frame in a block */
+  uint32_t offset;     /* Offset of the next frame in the head block */
+  uint32_t last;       /* Offset of the last frame in the head block */
+  uint64_t seq;        /* Sequence number of the next block */
+  clock_t tov;         /* Block timeout */
+  struct work_s work;  /* Retires the head block on timeout */
+};
+#endif
+
 /* Representation of a packet socket connection */
 
 struct devif_callback_s; /* Forward reference */
@@ -70,10 +95,29 @@ struct pkt_conn_s
    *   readahead - A singly linked list of type struct iob_qentry_s
    *               where the PKT read-ahead data is retained.
    *
-   * TODO: Maybe support PACKET_MMAP for further optimize.
    */
 
   struct iob_queue_s readahead;   /* Read-ahead buffering */
+
+  /* The poll() waiters */
+
+  FAR struct pollfd *fds[CONFIG_NET_PKT_NPOLLWAITERS];
+
+#ifdef CONFIG_NET_PKT_MMAP
+  /* The mmap'ed rings.  When there is an RX ring the received frames go to
+   * it instead of the read-ahead buffer.
+   */
+
+  FAR uint8_t *ring;              /* The RX ring, then the TX ring */
+  size_t ringsize;
+  struct pkt_ring_s rx;
+  struct pkt_ring_s tx;
+  uint32_t rx_packets;            /* Frames put in the RX ring */
+  uint32_t rx_drops;              /* Frames dropped for a full RX ring */
+  uint8_t version;                /* PACKET_VERSION */
+  bool mapped;                    /* The rings are mmap'ed, keep them */
+  bool losing;                    /* Frames were dropped, flag next block */
+#endif
 };
 
 /****************************************************************************
@@ -292,6 +336,169 @@ void pkt_poll(FAR struct net_driver_s *dev, FAR struct pkt_conn_s *conn);
 ssize_t pkt_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
                     int flags);
 
+/****************************************************************************
+ * Name: pkt_pollsetup
+ *
+ * Description:
+ *   Setup to monitor events on one packet socket
+ *
+ * Input Parameters:
+ *   psock - The packet socket of interest
+ *   fds   - The structure describing the events to be monitored
+ *
+ * Returned Value:
+ *  0: Success; Negated errno on failure
+ *
+ ****************************************************************************/
+
+int pkt_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds);
+
+/****************************************************************************
+ * Name: pkt_pollteardown
+ *
+ * Description:
+ *   Teardown monitoring of events on a packet socket
+ *
+ * Input Parameters:
+ *   psock - The packet socket of interest
+ *   fds   - The structure describing the events that were monitored
+ *
+ * Returned Value:
+ *  0: Success; Negated errno on failure
+ *
+ ****************************************************************************/
+
+int pkt_pollteardown(FAR struct socket *psock, FAR struct pollfd *fds);
+
+/****************************************************************************
+ * Name: pkt_pollnotify
+ *
+ * Description:
+ *   Wake up the poll() waiters of a packet socket.
+ *
+ * Input Parameters:
+ *   conn     - The packet connection
+ *   eventset - The events which occurred
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void pkt_pollnotify(FAR struct pkt_conn_s *conn, pollevent_t eventset);
+
+#if defined(CONFIG_NET_SOCKOPTS) && defined(CONFIG_NET_PKT_MMAP)
+/****************************************************************************
+ * Name: pkt_setsockopt / pkt_getsockopt
+ *
+ * Description:
+ *   Set and get the SOL_PACKET options of a packet socket.
+ *
+ * Returned Value:
+ *   Returns zero (OK) on success.  On failure, it returns a negated errno
+ *   value, -ENOPROTOOPT for the options of the other levels.
+ *
+ ****************************************************************************/
+
+int pkt_setsockopt(FAR struct socket *psock, int level, int option,
+                   FAR const void *value, socklen_t value_len);
+int pkt_getsockopt(FAR struct socket *psock, int level, int option,
+                   FAR void *value, FAR socklen_t *value_len);
+#endif
+
+#ifdef CONFIG_NET_PKT_MMAP
+/****************************************************************************
+ * Name: pkt_ring_setup
+ *
+ * Description:
+ *   Set up, or free with tp_block_nr 0, the RX or TX ring of a packet
+ *   connection.
+ *
+ * Input Parameters:
+ *   conn - The packet connection
+ *   tx   - True for the TX ring, false for the RX ring
+ *   req  - The layout of the ring
+ *
+ * Returned Value:
+ *   Zero (OK) on success, -EBUSY if the rings are already mapped, other
+ *   negated errno values on failure.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int pkt_ring_setup(FAR struct pkt_conn_s *conn, bool tx,
+                   FAR const struct tpacket_req3 *req);
+
+/****************************************************************************
+ * Name: pkt_ring_free
+ *
+ * Description:
+ *   Free the rings of a packet connection which is closed.
+ *
+ ****************************************************************************/
+
+void pkt_ring_free(FAR struct pkt_conn_s *conn);
+
+/****************************************************************************
+ * Name: pkt_ring_mmap
+ *
+ * Description:
+ *   Map the rings of a packet socket.
+ *
+ ****************************************************************************/
+
+int pkt_ring_mmap(FAR struct socket *psock, FAR struct mm_map_entry_s *map);
+
+/****************************************************************************
+ * Name: pkt_ring_input
+ *
+ * Description:
+ *   Copy the frame received by the device into the RX ring of the
+ *   connection, or drop it if the ring is full.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void pkt_ring_input(FAR struct net_driver_s *dev,
+                    FAR struct pkt_conn_s *conn);
+
+/****************************************************************************
+ * Name: pkt_ring_send
+ *
+ * Description:
+ *   Send the frames of the TX ring of a packet socket which are marked
+ *   TP_STATUS_SEND_REQUEST, from the head of the ring on.
+ *
+ * Returned Value:
+ *   The number of bytes sent, or a negated errno value.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+ssize_t pkt_ring_send(FAR struct socket *psock,
+                      FAR struct net_driver_s *dev);
+
+/****************************************************************************
+ * Name: pkt_ring_pollevents
+ *
+ * Description:
+ *   Return POLLIN if an RX block is ready for the user and POLLOUT if the
+ *   head frame of the TX ring is available.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+pollevent_t pkt_ring_pollevents(FAR struct pkt_conn_s *conn);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -0,0 +1,133 @@
+/****************************************************************************
+ * net/pkt/pkt_getsockopt.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/socket.h>
+#include <stdint.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <netpacket/packet.h>
+
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+#include "pkt/pkt.h"
+
+#if defined(CONFIG_NET_SOCKOPTS) && defined(CONFIG_NET_PKT_MMAP)
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pkt_getsockopt
+ *
+ * Description:
+ *   pkt_getsockopt() retrieves the value for the SOL_PACKET option
+ *   specified by the 'option' argument for the socket specified by the
+ *   'psock' argument.
+ *
+ *   See <netpacket/packet.h> for the a complete list of values of packet
+ *   socket options.
+ *
+ * Input Parameters:
+ *   psock     Socket structure of socket to operate on
+ *   level     Protocol level to get the option
+ *   option    identifies the option to get
+ *   value     Points to the argument value buffer
+ *   value_len The length of the argument value buffer
+ *
+ * Returned Value:
+ *   Returns zero (OK) on success.  On failure, it returns a negated errno
+ *   value to indicate the nature of the error.  See psock_getsockopt() for
+ *   the list of possible error values.
+ *
+ ****************************************************************************/
+
+int pkt_getsockopt(FAR struct socket *psock, int level, int option,
+                   FAR void *value, FAR socklen_t *value_len)
+{
+  FAR struct pkt_conn_s *conn = psock->s_conn;
+  int ret = OK;
+
+  DEBUGASSERT(value != NULL && value_len != NULL);
+
+  if (level != SOL_PACKET)
+    {
+      return -ENOPROTOOPT;
+    }
+
+  net_lock();
+
+  switch (option)
+    {
+      case PACKET_VERSION:
+        if (*value_len < sizeof(int))
+          {
+            ret = -EINVAL;
+          }
+        else
+          {
+            *(FAR int *)value = conn->version;
+            *value_len        = sizeof(int);
+          }
+        break;
+
+      case PACKET_STATISTICS:
+        if (*value_len < sizeof(struct tpacket_stats_v3))
+          {
+            ret = -EINVAL;
+          }
+        else
+          {
+            FAR struct tpacket_stats_v3 *stats = value;
+
+            /* The counters are reset by each read, as on Linux */
+
+            stats->tp_packets      = conn->rx_packets + conn->rx_drops;
+            stats->tp_drops        = conn->rx_drops;
+            stats->tp_freeze_q_cnt = 0;
+            *value_len             = sizeof(struct tpacket_stats_v3);
+
+            conn->rx_packets = 0;
+            conn->rx_drops   = 0;
+          }
+        break;
+
+      default:
+        nerr("ERROR: Unrecognized packet option: %d\n", option);
+        ret = -ENOPROTOOPT;
+        break;
+    }
+
+  net_unlock();
+  return ret;
+}
+
+#endif /* CONFIG_NET_SOCKOPTS && CONFIG_NET_PKT_MMAP */
@@ -28,6 +28,7 @@
 #if defined(CONFIG_NET) && defined(CONFIG_NET_PKT)
 
 #include <errno.h>
+#include <time.h>
 #include <debug.h>
 
 #include <nuttx/mm/iob.h>
@@ -61,6 +62,7 @@ static uint16_t pkt_datahandler(FAR struct net_driver_s *dev,
                                 FAR struct pkt_conn_s *conn)
 {
   FAR struct iob_s *iob = iob_tryalloc(true);
+  unsigned int offset = 0;
   int ret;
 
   if (iob == NULL)
@@ -68,13 +70,27 @@ static uint16_t pkt_datahandler(FAR struct net_driver_s *dev,
       return 0;
     }
 
+#ifdef CONFIG_NET_TIMESTAMP
+  /* Store the timestamp before the packet.  This is done unconditionally
+   * so that SO_TIMESTAMP may be enabled while the packet is queued.
+   */
+
+  offset = sizeof(struct timespec);
+  ret = iob_trycopyin(iob, (FAR const uint8_t *)&dev->d_rxtime,
+                      offset, 0, true);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+#endif
+
   /* Clone an I/O buffer chain of the L2 data, use throttled IOB to avoid
    * overconsumption.
    * TODO: Optimize IOB clone after we support shared IOB.
    */
 
   ret = iob_clone_partial(dev->d_iob, dev->d_len, -NET_LL_HDRLEN(dev),
-                          iob, 0, true, false);
+                          iob, offset, true, false);
   if (ret < 0)
     {
       nerr("ERROR: Failed to clone the I/O buffer chain: %d\n", ret);
@@ -93,6 +109,7 @@ static uint16_t pkt_datahandler(FAR struct net_driver_s *dev,
   else
     {
       ninfo("Buffered %d bytes\n", dev->d_len);
+      pkt_pollnotify(conn, POLLIN);
       return dev->d_len;
     }
 
@@ -139,6 +156,24 @@ static int pkt_in(FAR struct net_driver_s *dev)
     {
       uint16_t flags;
 
+#if defined(CONFIG_NET_TIMESTAMP) && !defined(CONFIG_ARCH_HAVE_NETDEV_TIMESTAMP)
+      /* The packet doesn't go through ipv4_input() or ipv6_input(), stamp
+       * it here.
+       */
+
+      clock_gettime(CLOCK_REALTIME, &dev->d_rxtime);
+#endif
+
+#ifdef CONFIG_NET_PKT_MMAP
+      /* With an RX ring the frame goes there, and nowhere else */
+
+      if (conn->rx.base != NULL)
+        {
+          pkt_ring_input(dev, conn);
+          return OK;
+        }
+#endif
+
       /* Setup for the application callback */
 
       dev->d_appdata = dev->d_buf;
@@ -0,0 +1,166 @@
+/****************************************************************************
+ * net/pkt/pkt_netpoll.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_PKT)
+
+#include <poll.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/net.h>
+
+#include "pkt/pkt.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pkt_pollsetup
+ *
+ * Description:
+ *   Setup to monitor events on one packet socket
+ *
+ * Input Parameters:
+ *   psock - The packet socket of interest
+ *   fds   - The structure describing the events to be monitored
+ *
+ * Returned Value:
+ *  0: Success; Negated errno on failure
+ *
+ ****************************************************************************/
+
+int pkt_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
+{
+  FAR struct pkt_conn_s *conn = psock->s_conn;
+  pollevent_t eventset = 0;
+  int ret = -EBUSY;
+  int i;
+
+  net_lock();
+
+  /* Find a free slot for the waiter */
+
+  for (i = 0; i < CONFIG_NET_PKT_NPOLLWAITERS; i++)
+    {
+      if (conn->fds[i] == NULL)
+        {
+          conn->fds[i] = fds;
+          fds->priv    = &conn->fds[i];
+          ret          = OK;
+          break;
+        }
+    }
+
+  if (ret < 0)
+    {
+      goto errout_with_lock;
+    }
+
+  /* Check if any requested events are already in effect.  Frames are only
+   * sent from the user buffer, so the socket is always writable unless
+   * the TX ring is full.
+   */
+
+#ifdef CONFIG_NET_PKT_MMAP
+  if (conn->rx.base != NULL || conn->tx.base != NULL)
+    {
+      eventset = pkt_ring_pollevents(conn);
+    }
+
+  if (conn->tx.base == NULL)
+#endif
+    {
+      eventset |= POLLOUT;
+    }
+
+  if (!IOB_QEMPTY(&conn->readahead))
+    {
+      eventset |= POLLIN;
+    }
+
+  poll_notify(&fds, 1, eventset);
+
+errout_with_lock:
+  net_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pkt_pollteardown
+ *
+ * Description:
+ *   Teardown monitoring of events on a packet socket
+ *
+ * Input Parameters:
+ *   psock - The packet socket of interest
+ *   fds   - The structure describing the events that were monitored
+ *
+ * Returned Value:
+ *  0: Success; Negated errno on failure
+ *
+ ****************************************************************************/
+
+int pkt_pollteardown(FAR struct socket *psock, FAR struct pollfd *fds)
+{
+  FAR struct pollfd **slot = fds->priv;
+
+  if (slot == NULL)
+    {
+      return -EINVAL;
+    }
+
+  net_lock();
+  *slot     = NULL;
+  fds->priv = NULL;
+  net_unlock();
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pkt_pollnotify
+ *
+ * Description:
+ *   Wake up the poll() waiters of a packet socket.
+ *
+ * Input Parameters:
+ *   conn     - The packet connection
+ *   eventset - The events which occurred
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void pkt_pollnotify(FAR struct pkt_conn_s *conn, pollevent_t eventset)
+{
+  poll_notify(conn->fds, CONFIG_NET_PKT_NPOLLWAITERS, eventset);
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_PKT */
@@ -30,6 +30,7 @@
 
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/time.h>
 #include <stdint.h>
 #include <string.h>
 #include <errno.h>
@@ -46,6 +47,7 @@
 #include "devif/devif.h"
 #include "pkt/pkt.h"
 #include "socket/socket.h"
+#include "utils/utils.h"
 #include <netpacket/packet.h>
 
 /****************************************************************************
@@ -55,6 +57,8 @@
 struct pkt_recvfrom_s
 {
   FAR struct devif_callback_s *pr_cb;  /* Reference to callback instance */
+  FAR struct pkt_conn_s *pr_conn;      /* Connection of the socket */
+  FAR struct msghdr *pr_msg;           /* Receive info and buffer */
   sem_t        pr_sem;                 /* Semaphore signals recv completion */
   size_t       pr_buflen;              /* Length of receive buffer */
   FAR uint8_t *pr_buffer;              /* Pointer to receive buffer */
@@ -66,6 +70,34 @@ struct pkt_recvfrom_s
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: pkt_store_cmsg_timestamp
+ *
+ * Description:
+ *   Add the SO_TIMESTAMP control message if the option is enabled.
+ *
+ * Input Parameters:
+ *   conn      - The packet socket connection
+ *   msg       - Receive info and buffer
+ *   timestamp - The reception time of the packet
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TIMESTAMP
+static void pkt_store_cmsg_timestamp(FAR struct pkt_conn_s *conn,
+                                     FAR struct msghdr *msg,
+                                     FAR const struct timespec *timestamp)
+{
+  struct timeval tv;
+
+  if (_SO_GETOPT(conn->sconn.s_options, SO_TIMESTAMP))
+    {
+      TIMESPEC_TO_TIMEVAL(&tv, timestamp);
+      cmsg_append(msg, SOL_SOCKET, SO_TIMESTAMP, &tv, sizeof(tv));
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: pkt_add_recvlen
  *
@@ -137,6 +169,10 @@ static void pkt_recvfrom_newdata(FAR struct net_driver_s *dev,
 
   ninfo("Received %d bytes (of %d)\n", (int)recvlen, (int)dev->d_len);
 
+#ifdef CONFIG_NET_TIMESTAMP
+  pkt_store_cmsg_timestamp(pstate->pr_conn, pstate->pr_msg, &dev->d_rxtime);
+#endif
+
   /* Update the accumulated size of the data read */
 
   pkt_add_recvlen(pstate, recvlen);
@@ -229,8 +265,7 @@ static uint16_t pkt_recvfrom_eventhandler(FAR struct net_driver_s *dev,
  *
  * Input Parameters:
  *   psock    Pointer to the socket structure for the socket
- *   buf      Buffer to receive data
- *   len      Length of buffer
+ *   msg      Receive info and buffer
  *   pstate   A pointer to the state structure to be initialized
  *
  * Returned Value:
@@ -240,9 +275,8 @@ static uint16_t pkt_recvfrom_eventhandler(FAR struct net_driver_s *dev,
  *
  ****************************************************************************/
 
-static void pkt_recvfrom_initialize(FAR struct socket *psock, FAR void *buf,
-                                    size_t len, FAR struct sockaddr *infrom,
-                                    FAR socklen_t *fromlen,
+static void pkt_recvfrom_initialize(FAR struct socket *psock,
+                                    FAR struct msghdr *msg,
                                     FAR struct pkt_recvfrom_s *pstate)
 {
   /* Initialize the state structure. */
@@ -250,8 +284,10 @@ static void pkt_recvfrom_initialize(FAR struct socket *psock, FAR void *buf,
   memset(pstate, 0, sizeof(struct pkt_recvfrom_s));
   nxsem_init(&pstate->pr_sem, 0, 0); /* Doesn't really fail */
 
-  pstate->pr_buflen = len;
-  pstate->pr_buffer = buf;
+  pstate->pr_conn   = psock->s_conn;
+  pstate->pr_msg    = msg;
+  pstate->pr_buflen = msg->msg_iov->iov_len;
+  pstate->pr_buffer = msg->msg_iov->iov_base;
 }
 
 /* The only un-initialization that has to be performed is destroying the
@@ -315,7 +351,7 @@ static ssize_t pkt_recvfrom_result(int result,
  * Input Parameters:
  *   conn  -  PKT socket connection structure containing the read-
  *            ahead data.
- *   buf      target buffer.
+ *   msg      Receive info and buffer.
  *
  * Returned Value:
  *   Number of bytes copied to the user buffer
@@ -326,9 +362,13 @@ static ssize_t pkt_recvfrom_result(int result,
  ****************************************************************************/
 
 static inline ssize_t pkt_readahead(FAR struct pkt_conn_s *conn,
-                                    FAR void *buf, size_t buflen)
+                                    FAR struct msghdr *msg)
 {
   FAR struct iob_s *iob;
+#ifdef CONFIG_NET_TIMESTAMP
+  struct timespec timestamp;
+#endif
+  unsigned int offset = 0;
   ssize_t ret = -ENODATA;
 
   /* Check there is any packets already buffered in a read-ahead buffer. */
@@ -337,9 +377,20 @@ static inline ssize_t pkt_readahead(FAR struct pkt_conn_s *conn,
     {
       DEBUGASSERT(iob->io_pktlen > 0);
 
+#ifdef CONFIG_NET_TIMESTAMP
+      /* The timestamp is stored before the packet */
+
+      offset = iob_copyout((FAR uint8_t *)&timestamp, iob,
+                           sizeof(timestamp), 0);
+      DEBUGASSERT(offset == sizeof(timestamp));
+
+      pkt_store_cmsg_timestamp(conn, msg, &timestamp);
+#endif
+
       /* Copy to user */
 
-      ret = iob_copyout(buf, iob, buflen, 0);
+      ret = iob_copyout(msg->msg_iov->iov_base, iob,
+                        msg->msg_iov->iov_len, offset);
 
       ninfo("Received %zd bytes (of %u)\n", ret, iob->io_pktlen);
 
@@ -392,8 +443,6 @@ static inline ssize_t pkt_readahead(FAR struct pkt_conn_s *conn,
 ssize_t pkt_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
                     int flags)
 {
-  FAR void *buf = msg->msg_iov->iov_base;
-  size_t len = msg->msg_iov->iov_len;
   FAR struct sockaddr *from = msg->msg_name;
   FAR socklen_t *fromlen = &msg->msg_namelen;
   FAR struct pkt_conn_s *conn = psock->s_conn;
@@ -430,7 +479,7 @@ ssize_t pkt_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
 
   if (!IOB_QEMPTY(&conn->readahead))
     {
-      ret = pkt_readahead(conn, buf, len);
+      ret = pkt_readahead(conn, msg);
     }
   else if (_SS_ISNONBLOCK(conn->sconn.s_flags) ||
            (flags & MSG_DONTWAIT) != 0)
@@ -441,7 +490,7 @@ ssize_t pkt_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
     }
   else
     {
-      pkt_recvfrom_initialize(psock, buf, len, from, fromlen, &state);
+      pkt_recvfrom_initialize(psock, msg, &state);
 
       /* Get the device driver that will service this transfer */
 
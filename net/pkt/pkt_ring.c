@@ -0,0 +1,655 @@
+/****************************************************************************
+ * net/pkt/pkt_ring.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_PKT_MMAP)
+
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <debug.h>
+
+#include <netpacket/packet.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/mm/map.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
+
+#include "devif/devif.h"
+#include "netdev/netdev.h"
+#include "socket/socket.h"
+#include "pkt/pkt.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define PKT_RING_BLKHDRLEN   TPACKET_ALIGN(sizeof(struct tpacket_block_desc))
+#define PKT_RING_HDRLEN      TPACKET3_HDRLEN
+
+/* The RX block timeout if the application leaves it to the kernel, msec */
+
+#define PKT_RING_DEFAULT_TOV 8
+
+#define PKT_RING_BLOCK(r, i) \
+  ((FAR struct tpacket_block_desc *)((r)->base + (size_t)(i) * (r)->size))
+#define PKT_RING_FRAME(r, i) \
+  ((FAR struct tpacket3_hdr *)((r)->base + (size_t)(i) * (r)->size))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The state of a send of the TX ring */
+
+struct pkt_ring_send_s
+{
+  FAR struct pkt_conn_s       *conn;
+  FAR struct devif_callback_s *cb;
+  sem_t                        sem;
+  ssize_t                      sent;   /* Bytes sent so far */
+  int                          result; /* The error which stopped it */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pkt_ring_retire
+ *
+ * Description:
+ *   Hand the head block of the RX ring over to the user and move on to the
+ *   next one.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void pkt_ring_retire(FAR struct pkt_conn_s *conn, uint32_t status)
+{
+  FAR struct pkt_ring_s *r = &conn->rx;
+  FAR struct tpacket_block_desc *bd = PKT_RING_BLOCK(r, r->head);
+
+  work_cancel(LPWORK, &r->work);
+
+  if (conn->losing)
+    {
+      status       |= TP_STATUS_LOSING;
+      conn->losing  = false;
+    }
+
+  /* The frames must be visible before the block status is */
+
+  SP_DMB();
+  bd->hdr.bh1.block_status = TP_STATUS_USER | status;
+
+  r->head   = (r->head + 1) % r->nr;
+  r->offset = 0;
+  r->last   = 0;
+
+  pkt_pollnotify(conn, POLLIN);
+}
+
+/****************************************************************************
+ * Name: pkt_ring_timeout
+ *
+ * Description:
+ *   Retire the head block of the RX ring when it has held frames for the
+ *   block timeout, so that the user does not wait for it to fill up.
+ *
+ ****************************************************************************/
+
+static void pkt_ring_timeout(FAR void *arg)
+{
+  FAR struct pkt_conn_s *conn = arg;
+
+  net_lock();
+  if (conn->rx.base != NULL && conn->rx.offset != 0)
+    {
+      pkt_ring_retire(conn, TP_STATUS_BLK_TMO);
+    }
+
+  net_unlock();
+}
+
+/****************************************************************************
+ * Name: pkt_ring_open
+ *
+ * Description:
+ *   Start filling the head block of the RX ring.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void pkt_ring_open(FAR struct pkt_conn_s *conn,
+                          FAR const struct timespec *ts)
+{
+  FAR struct pkt_ring_s *r = &conn->rx;
+  FAR struct tpacket_block_desc *bd = PKT_RING_BLOCK(r, r->head);
+
+  bd->version                      = TPACKET_V3;
+  bd->offset_to_priv               = PKT_RING_BLKHDRLEN;
+  bd->hdr.bh1.num_pkts             = 0;
+  bd->hdr.bh1.offset_to_first_pkt  = r->first;
+  bd->hdr.bh1.blk_len              = r->first;
+  bd->hdr.bh1.seq_num              = r->seq++;
+  bd->hdr.bh1.ts_first_pkt.ts_sec  = ts->tv_sec;
+  bd->hdr.bh1.ts_first_pkt.ts_nsec = ts->tv_nsec;
+
+  r->offset = r->first;
+  r->last   = 0;
+
+  work_queue(LPWORK, &r->work, pkt_ring_timeout, conn, r->tov);
+}
+
+/****************************************************************************
+ * Name: pkt_ring_send_eventhandler
+ *
+ * Description:
+ *   Send the head frame of the TX ring in each poll of the device, until
+ *   there is no requested frame left.
+ *
+ ****************************************************************************/
+
+static uint16_t pkt_ring_send_eventhandler(FAR struct net_driver_s *dev,
+                                           FAR void *pvpriv, uint16_t flags)
+{
+  FAR struct pkt_ring_send_s *pstate = pvpriv;
+  FAR struct pkt_ring_s *r;
+  FAR struct tpacket3_hdr *hdr;
+  int ret;
+
+  if (pstate == NULL)
+    {
+      return flags;
+    }
+
+  /* Wait for the next poll if the device buffer is in use */
+
+  if (dev->d_sndlen > 0 || (flags & PKT_NEWDATA) != 0)
+    {
+      return flags;
+    }
+
+  r   = &pstate->conn->tx;
+  hdr = PKT_RING_FRAME(r, r->head);
+  if (hdr->tp_status == TP_STATUS_SEND_REQUEST)
+    {
+      if (hdr->tp_len > r->size - PKT_RING_HDRLEN)
+        {
+          hdr->tp_status = TP_STATUS_WRONG_FORMAT;
+          pstate->result = -EINVAL;
+          goto end_wait;
+        }
+
+      ret = devif_send(dev, (FAR uint8_t *)hdr + PKT_RING_HDRLEN,
+                       hdr->tp_len, -NET_LL_HDRLEN(dev));
+      if (ret <= 0)
+        {
+          hdr->tp_status = TP_STATUS_WRONG_FORMAT;
+          pstate->result = ret < 0 ? ret : -EMSGSIZE;
+          goto end_wait;
+        }
+
+      dev->d_len = dev->d_sndlen;
+
+      /* Make sure no ARP request overwrites this frame */
+
+      IFF_SET_NOARP(dev->d_flags);
+
+      /* The frame is copied out, the user may reuse it */
+
+      pstate->sent  += hdr->tp_len;
+      hdr->tp_status = TP_STATUS_AVAILABLE;
+      r->head        = (r->head + 1) % r->nr;
+      pkt_pollnotify(pstate->conn, POLLOUT);
+
+      /* Ask for one more poll if there is more to send */
+
+      if (PKT_RING_FRAME(r, r->head)->tp_status == TP_STATUS_SEND_REQUEST)
+        {
+          netdev_txnotify_dev(dev);
+          return flags;
+        }
+    }
+
+end_wait:
+
+  /* Don't allow any further call backs. */
+
+  pstate->cb->flags = 0;
+  pstate->cb->priv  = NULL;
+  pstate->cb->event = NULL;
+
+  nxsem_post(&pstate->sem);
+  return flags;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pkt_ring_setup
+ *
+ * Description:
+ *   Set up, or free with tp_block_nr 0, the RX or TX ring of a packet
+ *   connection.  Both rings live in one buffer, the RX ring first, so
+ *   that they are mapped together; setting up one of them resets the
+ *   other.
+ *
+ * Input Parameters:
+ *   conn - The packet connection
+ *   tx   - True for the TX ring, false for the RX ring
+ *   req  - The layout of the ring
+ *
+ * Returned Value:
+ *   Zero (OK) on success, -EBUSY if the rings are already mapped, other
+ *   negated errno values on failure.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int pkt_ring_setup(FAR struct pkt_conn_s *conn, bool tx,
+                   FAR const struct tpacket_req3 *req)
+{
+  FAR struct pkt_ring_s *r = tx ? &conn->tx : &conn->rx;
+  struct pkt_ring_s ring;
+  FAR uint8_t *mem = NULL;
+  size_t rxsize;
+  size_t txsize;
+
+  if (conn->mapped)
+    {
+      return -EBUSY;
+    }
+
+  if (conn->version != TPACKET_V3)
+    {
+      return -EINVAL;
+    }
+
+  memset(&ring, 0, sizeof(ring));
+  if (req->tp_block_nr > 0)
+    {
+      if (req->tp_block_size == 0 ||
+          req->tp_block_size % TPACKET_ALIGNMENT != 0)
+        {
+          return -EINVAL;
+        }
+
+      if (tx)
+        {
+          /* Frames do not cross the blocks, so the frames simply follow
+           * each other.
+           */
+
+          if (req->tp_frame_size < PKT_RING_HDRLEN + TPACKET_ALIGNMENT ||
+              req->tp_frame_size % TPACKET_ALIGNMENT != 0 ||
+              req->tp_block_size % req->tp_frame_size != 0 ||
+              req->tp_frame_nr != req->tp_block_size / req->tp_frame_size *
+                                  req->tp_block_nr)
+            {
+              return -EINVAL;
+            }
+
+          ring.size = req->tp_frame_size;
+          ring.nr   = req->tp_frame_nr;
+        }
+      else
+        {
+          if (req->tp_sizeof_priv > req->tp_block_size)
+            {
+              return -EINVAL;
+            }
+
+          ring.first = PKT_RING_BLKHDRLEN +
+                       TPACKET_ALIGN(req->tp_sizeof_priv);
+          if (ring.first + PKT_RING_HDRLEN + TPACKET_ALIGNMENT >
+              req->tp_block_size)
+            {
+              return -EINVAL;
+            }
+
+          ring.size = req->tp_block_size;
+          ring.nr   = req->tp_block_nr;
+          ring.tov  = MSEC2TICK(req->tp_retire_blk_tov > 0 ?
+                                req->tp_retire_blk_tov :
+                                PKT_RING_DEFAULT_TOV);
+        }
+
+      if ((uint64_t)ring.size * ring.nr > SIZE_MAX / 2)
+        {
+          return -ENOMEM;
+        }
+    }
+
+  rxsize = tx ? (size_t)conn->rx.size * conn->rx.nr :
+                (size_t)ring.size * ring.nr;
+  txsize = tx ? (size_t)ring.size * ring.nr :
+                (size_t)conn->tx.size * conn->tx.nr;
+
+  if (rxsize + txsize > 0)
+    {
+      /* The application reads and writes the rings directly */
+
+      mem = kumm_zalloc(rxsize + txsize);
+      if (mem == NULL)
+        {
+          return -ENOMEM;
+        }
+    }
+
+  /* A pending timeout finds the RX ring reset and does nothing */
+
+  work_cancel(LPWORK, &conn->rx.work);
+  if (conn->ring != NULL)
+    {
+      kumm_free(conn->ring);
+    }
+
+  *r = ring;
+
+  conn->ring      = mem;
+  conn->ringsize  = rxsize + txsize;
+  conn->rx.base   = rxsize > 0 ? mem : NULL;
+  conn->rx.head   = 0;
+  conn->rx.offset = 0;
+  conn->rx.last   = 0;
+  conn->tx.base   = txsize > 0 ? mem + rxsize : NULL;
+  conn->tx.head   = 0;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_free
+ *
+ * Description:
+ *   Free the rings of a packet connection which is closed.
+ *
+ ****************************************************************************/
+
+void pkt_ring_free(FAR struct pkt_conn_s *conn)
+{
+  work_cancel_sync(LPWORK, &conn->rx.work);
+
+  if (conn->ring != NULL)
+    {
+      kumm_free(conn->ring);
+      conn->ring    = NULL;
+      conn->rx.base = NULL;
+      conn->tx.base = NULL;
+    }
+}
+
+/****************************************************************************
+ * Name: pkt_ring_mmap
+ *
+ * Description:
+ *   Map the rings of a packet socket.  The whole buffer of the rings must
+ *   be mapped at once; the rings can not be changed from then on.
+ *
+ ****************************************************************************/
+
+int pkt_ring_mmap(FAR struct socket *psock, FAR struct mm_map_entry_s *map)
+{
+  FAR struct pkt_conn_s *conn = psock->s_conn;
+  int ret = OK;
+
+  net_lock();
+  if (conn->ring == NULL || map->offset != 0 ||
+      map->length != conn->ringsize)
+    {
+      ret = -EINVAL;
+    }
+  else
+    {
+      map->vaddr   = conn->ring;
+      conn->mapped = true;
+    }
+
+  net_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_input
+ *
+ * Description:
+ *   Copy the frame received by the device into the RX ring of the
+ *   connection, or drop it if the ring is full.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void pkt_ring_input(FAR struct net_driver_s *dev,
+                    FAR struct pkt_conn_s *conn)
+{
+  FAR struct pkt_ring_s *r = &conn->rx;
+  FAR struct tpacket_block_desc *bd;
+  FAR struct tpacket3_hdr *hdr;
+  struct timespec ts;
+  uint32_t snaplen = dev->d_len;
+  uint32_t need;
+
+#ifdef CONFIG_NET_TIMESTAMP
+  ts = dev->d_rxtime;
+#else
+  clock_gettime(CLOCK_REALTIME, &ts);
+#endif
+
+  /* Find room in the head block, in the next one if it is too full */
+
+  for (; ; )
+    {
+      bd = PKT_RING_BLOCK(r, r->head);
+      if (r->offset == 0)
+        {
+          if (bd->hdr.bh1.block_status != TP_STATUS_KERNEL)
+            {
+              /* The application has not given the block back yet */
+
+              conn->rx_drops++;
+              conn->losing = true;
+              return;
+            }
+
+          pkt_ring_open(conn, &ts);
+        }
+
+      need = TPACKET_ALIGN(PKT_RING_HDRLEN + snaplen);
+      if (r->offset + need <= r->size)
+        {
+          break;
+        }
+
+      if (r->offset == r->first)
+        {
+          /* Too big for an empty block, keep what fits */
+
+          snaplen = r->size - r->first - PKT_RING_HDRLEN;
+          need    = r->size - r->first;
+          break;
+        }
+
+      pkt_ring_retire(conn, 0);
+    }
+
+  hdr = (FAR struct tpacket3_hdr *)((FAR uint8_t *)bd + r->offset);
+  memset(hdr, 0, PKT_RING_HDRLEN);
+
+  hdr->tp_sec     = ts.tv_sec;
+  hdr->tp_nsec    = ts.tv_nsec;
+  hdr->tp_snaplen = snaplen;
+  hdr->tp_len     = dev->d_len;
+  hdr->tp_status  = TP_STATUS_USER | TP_STATUS_TS_SOFTWARE;
+  hdr->tp_mac     = PKT_RING_HDRLEN;
+  hdr->tp_net     = PKT_RING_HDRLEN + NET_LL_HDRLEN(dev);
+
+  iob_copyout((FAR uint8_t *)hdr + PKT_RING_HDRLEN, dev->d_iob, snaplen,
+              -NET_LL_HDRLEN(dev));
+
+  if (r->last != 0)
+    {
+      FAR struct tpacket3_hdr *prev =
+        (FAR struct tpacket3_hdr *)((FAR uint8_t *)bd + r->last);
+
+      prev->tp_next_offset = r->offset - r->last;
+    }
+
+  r->last    = r->offset;
+  r->offset += need;
+
+  bd->hdr.bh1.num_pkts++;
+  bd->hdr.bh1.blk_len             = r->offset;
+  bd->hdr.bh1.ts_last_pkt.ts_sec  = ts.tv_sec;
+  bd->hdr.bh1.ts_last_pkt.ts_nsec = ts.tv_nsec;
+  conn->rx_packets++;
+
+  /* Hand the block over now if not even a header fits any more */
+
+  if (r->offset + PKT_RING_HDRLEN + NET_LL_HDRLEN(dev) > r->size)
+    {
+      pkt_ring_retire(conn, 0);
+    }
+}
+
+/****************************************************************************
+ * Name: pkt_ring_send
+ *
+ * Description:
+ *   Send the frames of the TX ring of a packet socket which are marked
+ *   TP_STATUS_SEND_REQUEST, from the head of the ring on.  The frames go
+ *   out one per poll of the device, the caller is only woken up once they
+ *   all are sent.
+ *
+ * Returned Value:
+ *   The number of bytes sent, or a negated errno value.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+ssize_t pkt_ring_send(FAR struct socket *psock,
+                      FAR struct net_driver_s *dev)
+{
+  FAR struct pkt_conn_s *conn = psock->s_conn;
+  struct pkt_ring_send_s state;
+  int ret;
+
+  if (PKT_RING_FRAME(&conn->tx, conn->tx.head)->tp_status !=
+      TP_STATUS_SEND_REQUEST)
+    {
+      return 0;
+    }
+
+  memset(&state, 0, sizeof(state));
+  nxsem_init(&state.sem, 0, 0); /* Doesn't really fail */
+  state.conn = conn;
+
+  state.cb = pkt_callback_alloc(dev, conn);
+  if (state.cb == NULL)
+    {
+      nxsem_destroy(&state.sem);
+      return -EBUSY;
+    }
+
+  state.cb->flags = PKT_POLL;
+  state.cb->priv  = (FAR void *)&state;
+  state.cb->event = pkt_ring_send_eventhandler;
+
+  /* Notify the device driver that new TX data is available, then wait
+   * for the frames to be sent or an error to occur.
+   */
+
+  netdev_txnotify_dev(dev);
+  ret = net_sem_wait(&state.sem);
+
+  pkt_callback_free(dev, conn, state.cb);
+  nxsem_destroy(&state.sem);
+
+  if (state.sent > 0)
+    {
+      return state.sent;
+    }
+
+  return ret < 0 ? ret : state.result;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_pollevents
+ *
+ * Description:
+ *   Return POLLIN if an RX block is ready for the user and POLLOUT if the
+ *   head frame of the TX ring is available.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+pollevent_t pkt_ring_pollevents(FAR struct pkt_conn_s *conn)
+{
+  FAR struct pkt_ring_s *r = &conn->rx;
+  pollevent_t eventset = 0;
+
+  /* The blocks are handed over and given back in order, so the last block
+   * retired is the one to look at.
+   */
+
+  if (r->base != NULL &&
+      (PKT_RING_BLOCK(r, (r->head + r->nr - 1) % r->nr)->
+       hdr.bh1.block_status & TP_STATUS_USER) != 0)
+    {
+      eventset |= POLLIN;
+    }
+
+  r = &conn->tx;
+  if (r->base != NULL &&
+      PKT_RING_FRAME(r, r->head)->tp_status == TP_STATUS_AVAILABLE)
+    {
+      eventset |= POLLOUT;
+    }
+
+  return eventset;
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_PKT_MMAP */
@@ -228,6 +228,15 @@ ssize_t pkt_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
   state.snd_buflen    = len;            /* Number of bytes to send */
   state.snd_buffer    = buf;            /* Buffer to send from */
 
+#ifdef CONFIG_NET_PKT_MMAP
+  /* A send() without data sends the frames queued in the TX ring */
+
+  if (len == 0 && ((FAR struct pkt_conn_s *)psock->s_conn)->tx.base != NULL)
+    {
+      state.snd_sent = pkt_ring_send(psock, dev);
+    }
+  else
+#endif
   if (len > 0)
     {
       FAR struct pkt_conn_s *conn = psock->s_conn;
@@ -0,0 +1,140 @@
+/****************************************************************************
+ * net/pkt/pkt_setsockopt.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/socket.h>
+#include <stdint.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <netpacket/packet.h>
+
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+#include "pkt/pkt.h"
+
+#if defined(CONFIG_NET_SOCKOPTS) && defined(CONFIG_NET_PKT_MMAP)
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pkt_setsockopt
+ *
+ * Description:
+ *   pkt_setsockopt() sets the SOL_PACKET option specified by the 'option'
+ *   argument to the value pointed to by the 'value' argument for the
+ *   socket specified by the 'psock' argument.
+ *
+ *   See <netpacket/packet.h> for the a complete list of values of packet
+ *   socket options.
+ *
+ * Input Parameters:
+ *   psock     Socket structure of socket to operate on
+ *   level     Protocol level to set the option
+ *   option    identifies the option to set
+ *   value     Points to the argument value
+ *   value_len The length of the argument value
+ *
+ * Returned Value:
+ *   Returns zero (OK) on success.  On failure, it returns a negated errno
+ *   value to indicate the nature of the error.  See psock_setcockopt() for
+ *   the list of possible error values.
+ *
+ ****************************************************************************/
+
+int pkt_setsockopt(FAR struct socket *psock, int level, int option,
+                   FAR const void *value, socklen_t value_len)
+{
+  FAR struct pkt_conn_s *conn = psock->s_conn;
+  int ret;
+
+  DEBUGASSERT(value_len == 0 || value != NULL);
+
+  if (level != SOL_PACKET)
+    {
+      return -ENOPROTOOPT;
+    }
+
+  net_lock();
+
+  switch (option)
+    {
+      case PACKET_VERSION:
+        {
+          int version;
+
+          if (value_len < sizeof(int))
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+          version = *(FAR const int *)value;
+          if (version != TPACKET_V1 && version != TPACKET_V3)
+            {
+              ret = -EINVAL;
+            }
+          else if (conn->ring != NULL)
+            {
+              ret = -EBUSY;
+            }
+          else
+            {
+              conn->version = version;
+              ret = OK;
+            }
+        }
+        break;
+
+      case PACKET_RX_RING:
+      case PACKET_TX_RING:
+        if (value_len < sizeof(struct tpacket_req3))
+          {
+            ret = -EINVAL;
+          }
+        else
+          {
+            ret = pkt_ring_setup(conn, option == PACKET_TX_RING,
+                                 (FAR const struct tpacket_req3 *)value);
+          }
+        break;
+
+      default:
+        nerr("ERROR: Unrecognized packet option: %d\n", option);
+        ret = -ENOPROTOOPT;
+        break;
+    }
+
+  net_unlock();
+  return ret;
+}
+
+#endif /* CONFIG_NET_SOCKOPTS && CONFIG_NET_PKT_MMAP */
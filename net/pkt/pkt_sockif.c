@@ -54,6 +54,8 @@ static sockcaps_t pkt_sockcaps(FAR struct socket *psock);
 static void       pkt_addref(FAR struct socket *psock);
 static int        pkt_bind(FAR struct socket *psock,
                     FAR const struct sockaddr *addr, socklen_t addrlen);
+static int        pkt_netpoll(FAR struct socket *psock,
+                    FAR struct pollfd *fds, bool setup);
 static int        pkt_close(FAR struct socket *psock);
 
 /****************************************************************************
@@ -71,10 +73,28 @@ const struct sock_intf_s g_pkt_sockif =
   NULL,            /* si_listen */
   NULL,            /* si_connect */
   NULL,            /* si_accept */
-  NULL,            /* si_poll */
+  pkt_netpoll,     /* si_poll */
   pkt_sendmsg,     /* si_sendmsg */
   pkt_recvmsg,     /* si_recvmsg */
-  pkt_close        /* si_close */
+  pkt_close,       /* si_close */
+  NULL,            /* si_ioctl */
+  NULL,            /* si_socketpair */
+  NULL             /* si_shutdown */
+#ifdef CONFIG_NET_SOCKOPTS
+#ifdef CONFIG_NET_PKT_MMAP
+  , pkt_getsockopt /* si_getsockopt */
+  , pkt_setsockopt /* si_setsockopt */
+#else
+  , NULL           /* si_getsockopt */
+  , NULL           /* si_setsockopt */
+#endif
+#endif
+#ifdef CONFIG_NET_SENDFILE
+  , NULL           /* si_sendfile */
+#endif
+#ifdef CONFIG_NET_PKT_MMAP
+  , pkt_ring_mmap  /* si_mmap */
+#endif
 };
 
 /****************************************************************************
@@ -264,6 +284,36 @@ static int pkt_bind(FAR struct socket *psock,
     }
 }
 
+/****************************************************************************
+ * Name: pkt_netpoll
+ *
+ * Description:
+ *   The standard poll() operation redirects operations on socket descriptors
+ *   to this function.
+ *
+ * Input Parameters:
+ *   psock - An instance of the internal socket structure.
+ *   fds   - The structure describing the events to be monitored.
+ *   setup - true: Setup up the poll; false: Tear down the poll
+ *
+ * Returned Value:
+ *  0: Success; Negated errno on failure
+ *
+ ****************************************************************************/
+
+static int pkt_netpoll(FAR struct socket *psock, FAR struct pollfd *fds,
+                       bool setup)
+{
+  if (setup)
+    {
+      return pkt_pollsetup(psock, fds);
+    }
+  else
+    {
+      return pkt_pollteardown(psock, fds);
+    }
+}
+
 /****************************************************************************
  * Name: pkt_close
  *
@@ -301,6 +351,12 @@ static int pkt_close(FAR struct socket *psock)
 
               iob_free_queue(&conn->readahead);
 
+#ifdef CONFIG_NET_PKT_MMAP
+              /* And the rings */
+
+              pkt_ring_free(conn);
+#endif
+
               /* Then free the connection structure */
 
               conn->crefs = 0;          /* No more references on the connection */
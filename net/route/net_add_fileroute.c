@@ -36,6 +36,7 @@
 #include <nuttx/net/ip.h>
 
 #include "netlink/netlink.h"
+#include "ipforward/ipforward.h"
 #include "route/fileroute.h"
 #include "route/route.h"
 
@@ -89,6 +90,7 @@ int net_addroute_ipv4(in_addr_t target, in_addr_t netmask, in_addr_t router)
   net_closeroute_ipv4(&fshandle);
 
   netlink_route_notify(&route, RTM_NEWROUTE, AF_INET);
+  ipv4_fwdcache_flush();
   return nwritten >= 0 ? 0 : (int)nwritten;
 }
 #endif
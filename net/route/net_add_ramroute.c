@@ -37,6 +37,7 @@
 #include <arch/irq.h>
 
 #include "netlink/netlink.h"
+#include "ipforward/ipforward.h"
 #include "route/ramroute.h"
 #include "route/route.h"
 
@@ -63,6 +64,17 @@
 int net_addroute_ipv4(in_addr_t target, in_addr_t netmask, in_addr_t router)
 {
   FAR struct net_route_ipv4_s *route;
+#ifdef CONFIG_ROUTE_IPv4_RAMROUTE_TRIE
+  in_addr_t mask = NTOHL(netmask);
+
+  /* The trie only holds prefixes, so the netmask must be contiguous */
+
+  if ((mask | (mask - 1)) != 0xffffffff)
+    {
+      nerr("ERROR: Non-contiguous netmask\n");
+      return -EINVAL;
+    }
+#endif
 
   /* Allocate a route entry */
 
@@ -88,9 +100,13 @@ int net_addroute_ipv4(in_addr_t target, in_addr_t netmask, in_addr_t router)
 
   ramroute_ipv4_addlast((FAR struct net_route_ipv4_entry_s *)route,
                         &g_ipv4_routes);
+#ifdef CONFIG_ROUTE_IPv4_RAMROUTE_TRIE
+  ramroute_ipv4_trie_add((FAR struct net_route_ipv4_entry_s *)route);
+#endif
   net_unlock();
 
   netlink_route_notify(route, RTM_NEWROUTE, AF_INET);
+  ipv4_fwdcache_flush();
   return OK;
 }
 #endif
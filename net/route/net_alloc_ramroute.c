@@ -117,6 +117,10 @@ void net_init_ramroute(void)
     {
       ramroute_ipv4_addlast(&g_prealloc_ipv4routes[i], &g_free_ipv4routes);
     }
+
+#ifdef CONFIG_ROUTE_IPv4_RAMROUTE_TRIE
+  ramroute_ipv4_trie_init();
+#endif
 #endif
 
 #ifdef CONFIG_ROUTE_IPv6_RAMROUTE
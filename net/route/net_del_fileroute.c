@@ -39,6 +39,7 @@
 #include <nuttx/net/ip.h>
 
 #include "netlink/netlink.h"
+#include "ipforward/ipforward.h"
 #include "route/fileroute.h"
 #include "route/cacheroute.h"
 #include "route/route.h"
@@ -317,6 +318,7 @@ int net_delroute_ipv4(in_addr_t target, in_addr_t netmask)
   ret = file_truncate(&fshandle, filesize);
 
   netlink_route_notify(&match, RTM_DELROUTE, AF_INET);
+  ipv4_fwdcache_flush();
 
 errout_with_fshandle:
   net_closeroute_ipv4(&fshandle);
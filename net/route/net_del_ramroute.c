@@ -35,6 +35,7 @@
 #include <nuttx/net/ip.h>
 
 #include "netlink/netlink.h"
+#include "ipforward/ipforward.h"
 #include "route/ramroute.h"
 #include "route/route.h"
 
@@ -113,7 +114,12 @@ static int net_del_ipv4route(FAR struct net_route_ipv4_s *route,
           ramroute_ipv4_remfirst(&g_ipv4_routes);
         }
 
+#ifdef CONFIG_ROUTE_IPv4_RAMROUTE_TRIE
+      ramroute_ipv4_trie_del((FAR struct net_route_ipv4_entry_s *)route);
+#endif
+
       netlink_route_notify(route, RTM_DELROUTE, AF_INET);
+      ipv4_fwdcache_flush();
 
       /* And free the routing table entry by adding it to the free list */
 
@@ -283,7 +283,11 @@ int net_ipv4_router(in_addr_t target, FAR in_addr_t *router,
        * routing table that can forward to this address
        */
 
+#ifdef CONFIG_ROUTE_IPv4_RAMROUTE_TRIE
+      ret = net_matchroute_ipv4(target, net_ipv4_match, &match);
+#else
       ret = net_foreachroute_ipv4(net_ipv4_match, &match);
+#endif
     }
 
   /* Did we find a route? */
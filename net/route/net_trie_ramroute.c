@@ -0,0 +1,387 @@
+/****************************************************************************
+ * net/route/net_trie_ramroute.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+
+#include <nuttx/net/net.h>
+#include <nuttx/net/ip.h>
+
+#include "route/ramroute.h"
+#include "route/route.h"
+#include "utils/utils.h"
+
+#ifdef CONFIG_ROUTE_IPv4_RAMROUTE_TRIE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Each route adds at most one node of its own and one branch node */
+
+#define RAMROUTE_IPv4_NNODES (2 * CONFIG_ROUTE_MAX_IPv4_RAMROUTES)
+
+/* The mask of the first len bits and bit n of a host order address */
+
+#define RAMROUTE_IPv4_MASK(len) \
+  ((len) == 0 ? 0 : 0xffffffffu << (32 - (len)))
+#define RAMROUTE_IPv4_BIT(addr, n) \
+  (((addr) >> (31 - (n))) & 1)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A node of the path-compressed binary trie of the IPv4 routes.  Nodes
+ * with routes hold all of the routes of one prefix, in the order of the
+ * routing table.  Nodes without routes only branch, so that they always
+ * have two children.
+ */
+
+struct ramroute_ipv4_node_s
+{
+  FAR struct ramroute_ipv4_node_s *child[2];
+  FAR struct net_route_ipv4_entry_s *routes; /* Routes of the prefix */
+  uint32_t prefix;                           /* Prefix, host order */
+  uint8_t len;                               /* Prefix length */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct ramroute_ipv4_node_s g_ipv4_nodes[RAMROUTE_IPv4_NNODES];
+static FAR struct ramroute_ipv4_node_s *g_ipv4_freenodes;
+static FAR struct ramroute_ipv4_node_s *g_ipv4_trie;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ramroute_ipv4_prefix
+ *
+ * Description:
+ *   Get the prefix of a route in host order and its length.
+ *
+ ****************************************************************************/
+
+static uint32_t ramroute_ipv4_prefix(FAR struct net_route_ipv4_s *route,
+                                     FAR uint8_t *len)
+{
+  *len = net_ipv4_mask2pref(route->netmask);
+  return NTOHL(route->target) & RAMROUTE_IPv4_MASK(*len);
+}
+
+/****************************************************************************
+ * Name: ramroute_ipv4_allocnode
+ *
+ * Description:
+ *   Take a node from the free list and initialize it.  The pool has room
+ *   for the worst case of the routing table, so this does not fail.
+ *
+ ****************************************************************************/
+
+static FAR struct ramroute_ipv4_node_s *
+ramroute_ipv4_allocnode(uint32_t prefix, uint8_t len,
+                        FAR struct net_route_ipv4_entry_s *routes)
+{
+  FAR struct ramroute_ipv4_node_s *node = g_ipv4_freenodes;
+
+  DEBUGASSERT(node != NULL);
+  g_ipv4_freenodes = node->child[0];
+
+  node->child[0] = NULL;
+  node->child[1] = NULL;
+  node->routes   = routes;
+  node->prefix   = prefix;
+  node->len      = len;
+  return node;
+}
+
+/****************************************************************************
+ * Name: ramroute_ipv4_freenode
+ ****************************************************************************/
+
+static void ramroute_ipv4_freenode(FAR struct ramroute_ipv4_node_s *node)
+{
+  node->child[0]   = g_ipv4_freenodes;
+  g_ipv4_freenodes = node;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ramroute_ipv4_trie_init
+ *
+ * Description:
+ *   Initialize the trie of the IPv4 RAM routes.
+ *
+ * Assumptions:
+ *   Called early in initialization so that no special protection is needed.
+ *
+ ****************************************************************************/
+
+void ramroute_ipv4_trie_init(void)
+{
+  int i;
+
+  g_ipv4_trie      = NULL;
+  g_ipv4_freenodes = NULL;
+
+  for (i = 0; i < RAMROUTE_IPv4_NNODES; i++)
+    {
+      ramroute_ipv4_freenode(&g_ipv4_nodes[i]);
+    }
+}
+
+/****************************************************************************
+ * Name: ramroute_ipv4_trie_add
+ *
+ * Description:
+ *   Add a route of the IPv4 routing table to the trie.
+ *
+ *   The new nodes are initialized before the single store that links them
+ *   into the trie, so the trie is always consistent.
+ *
+ * Input Parameters:
+ *   entry - The routing table entry, with a contiguous netmask.
+ *
+ * Assumptions:
+ *   The caller holds the network lock.
+ *
+ ****************************************************************************/
+
+void ramroute_ipv4_trie_add(FAR struct net_route_ipv4_entry_s *entry)
+{
+  FAR struct ramroute_ipv4_node_s **pnode = &g_ipv4_trie;
+  FAR struct ramroute_ipv4_node_s *node;
+  FAR struct ramroute_ipv4_node_s *leaf;
+  FAR struct ramroute_ipv4_node_s *branch;
+  FAR struct net_route_ipv4_entry_s **proute;
+  uint32_t prefix;
+  uint32_t diff;
+  uint8_t len;
+  uint8_t common;
+
+  prefix       = ramroute_ipv4_prefix(&entry->entry, &len);
+  entry->tlink = NULL;
+  common       = 0;
+
+  while ((node = *pnode) != NULL)
+    {
+      /* Length of the prefix shared by the node and the new route */
+
+      diff   = node->prefix ^ prefix;
+      common = 0;
+
+      while (common < node->len && common < len &&
+             RAMROUTE_IPv4_BIT(diff, common) == 0)
+        {
+          common++;
+        }
+
+      if (common < node->len)
+        {
+          break;
+        }
+
+      if (node->len == len)
+        {
+          /* Same prefix: keep the routes in the order they were added */
+
+          for (proute = &node->routes; *proute != NULL;
+               proute = &(*proute)->tlink);
+
+          *proute = entry;
+          return;
+        }
+
+      pnode = &node->child[RAMROUTE_IPv4_BIT(prefix, node->len)];
+    }
+
+  leaf = ramroute_ipv4_allocnode(prefix, len, entry);
+  if (node == NULL)
+    {
+      *pnode = leaf;
+    }
+  else if (common == len)
+    {
+      /* The new prefix contains the node's */
+
+      leaf->child[RAMROUTE_IPv4_BIT(node->prefix, len)] = node;
+      *pnode = leaf;
+    }
+  else
+    {
+      /* They diverge after the common bits */
+
+      branch = ramroute_ipv4_allocnode(prefix & RAMROUTE_IPv4_MASK(common),
+                                       common, NULL);
+      branch->child[RAMROUTE_IPv4_BIT(prefix, common)] = leaf;
+      branch->child[RAMROUTE_IPv4_BIT(node->prefix, common)] = node;
+      *pnode = branch;
+    }
+}
+
+/****************************************************************************
+ * Name: ramroute_ipv4_trie_del
+ *
+ * Description:
+ *   Remove a route of the IPv4 routing table from the trie.
+ *
+ * Input Parameters:
+ *   entry - The routing table entry, previously added to the trie.
+ *
+ * Assumptions:
+ *   The caller holds the network lock.
+ *
+ ****************************************************************************/
+
+void ramroute_ipv4_trie_del(FAR struct net_route_ipv4_entry_s *entry)
+{
+  FAR struct ramroute_ipv4_node_s **pparent = NULL;
+  FAR struct ramroute_ipv4_node_s **pnode = &g_ipv4_trie;
+  FAR struct ramroute_ipv4_node_s *parent;
+  FAR struct ramroute_ipv4_node_s *node;
+  FAR struct net_route_ipv4_entry_s **proute;
+  uint32_t prefix;
+  uint8_t len;
+
+  prefix = ramroute_ipv4_prefix(&entry->entry, &len);
+
+  /* Find the node of the prefix */
+
+  while ((node = *pnode) != NULL && node->len < len)
+    {
+      pparent = pnode;
+      pnode   = &node->child[RAMROUTE_IPv4_BIT(prefix, node->len)];
+    }
+
+  if (node == NULL || node->len != len || node->prefix != prefix)
+    {
+      return;
+    }
+
+  for (proute = &node->routes; *proute != NULL && *proute != entry;
+       proute = &(*proute)->tlink);
+
+  if (*proute == NULL)
+    {
+      return;
+    }
+
+  *proute = entry->tlink;
+  if (node->routes != NULL)
+    {
+      return;
+    }
+
+  /* The node no longer has routes.  It stays only while it branches. */
+
+  if (node->child[0] != NULL && node->child[1] != NULL)
+    {
+      return;
+    }
+
+  *pnode = node->child[0] != NULL ? node->child[0] : node->child[1];
+  ramroute_ipv4_freenode(node);
+
+  /* Removing a leaf may leave its parent a branch node with one child */
+
+  if (*pnode == NULL && pparent != NULL)
+    {
+      parent = *pparent;
+      if (parent->routes == NULL)
+        {
+          *pparent = parent->child[0] != NULL ? parent->child[0] :
+                                                parent->child[1];
+          ramroute_ipv4_freenode(parent);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: net_matchroute_ipv4
+ *
+ * Description:
+ *   Visit the routes of the IPv4 RAM routing table whose prefix contains
+ *   the target address, from the shortest prefix to the longest one and in
+ *   the order of the table for the same prefix.  This takes one step for
+ *   each branch of the trie on the way to the target, instead of a visit
+ *   of each route.
+ *
+ * Input Parameters:
+ *   target  - The target IPv4 address.
+ *   handler - Will be called for each matching route.  It must not change
+ *             the routing table.
+ *   arg     - An arbitrary value that will be passed to the handler.
+ *
+ * Returned Value:
+ *   Zero (OK) returned if all matching routes were visited.  The handler
+ *   may terminate the search early with any non-zero value, which is
+ *   returned.
+ *
+ ****************************************************************************/
+
+int net_matchroute_ipv4(in_addr_t target, route_handler_ipv4_t handler,
+                        FAR void *arg)
+{
+  FAR struct ramroute_ipv4_node_s *node;
+  FAR struct net_route_ipv4_entry_s *route;
+  uint32_t addr = NTOHL(target);
+  int ret = 0;
+
+  net_lock();
+
+  node = g_ipv4_trie;
+  while (ret == 0 && node != NULL &&
+         ((addr ^ node->prefix) & RAMROUTE_IPv4_MASK(node->len)) == 0)
+    {
+      for (route = node->routes; ret == 0 && route != NULL;
+           route = route->tlink)
+        {
+          ret = handler(&route->entry, arg);
+        }
+
+      if (node->len == 32)
+        {
+          break;
+        }
+
+      node = node->child[RAMROUTE_IPv4_BIT(addr, node->len)];
+    }
+
+  net_unlock();
+  return ret;
+}
+
+#endif /* CONFIG_ROUTE_IPv4_RAMROUTE_TRIE */
@@ -68,6 +68,9 @@ struct net_route_ipv4_entry_s
 {
   struct net_route_ipv4_s entry;
   FAR struct net_route_ipv4_entry_s *flink;
+#ifdef CONFIG_ROUTE_IPv4_RAMROUTE_TRIE
+  FAR struct net_route_ipv4_entry_s *tlink; /* Next route of the prefix */
+#endif
 };
 
 /* This structure describes the head of a routing table list */
@@ -218,5 +221,29 @@ ramroute_ipv6_remafter(FAR struct net_route_ipv6_entry_s *entry,
                        FAR struct net_route_ipv6_queue_s *list);
 #endif
 
+/****************************************************************************
+ * Name: ramroute_ipv4_trie_init, ramroute_ipv4_trie_add and
+ *       ramroute_ipv4_trie_del
+ *
+ * Description:
+ *   Maintain the trie that indexes the IPv4 routing table by prefix for
+ *   net_matchroute_ipv4().  Routes are added to and removed from the trie
+ *   with the network locked, when they are added to and removed from the
+ *   list.
+ *
+ * Input Parameters:
+ *   entry - The routing table entry
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv4_RAMROUTE_TRIE
+void ramroute_ipv4_trie_init(void);
+void ramroute_ipv4_trie_add(FAR struct net_route_ipv4_entry_s *entry);
+void ramroute_ipv4_trie_del(FAR struct net_route_ipv4_entry_s *entry);
+#endif
+
 #endif /* CONFIG_ROUTE_IPv4_RAMROUTE || CONFIG_ROUTE_IPv6_RAMROUTE */
 #endif /* __NET_ROUTE_RAMROUTE_H */
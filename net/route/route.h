@@ -283,6 +283,31 @@ int net_foreachroute_ipv4(route_handler_ipv4_t handler, FAR void *arg);
 int net_foreachroute_ipv6(route_handler_ipv6_t handler, FAR void *arg);
 #endif
 
+/****************************************************************************
+ * Name: net_matchroute_ipv4
+ *
+ * Description:
+ *   Visit the routes whose prefix contains the target address, from the
+ *   shortest prefix to the longest one.  This takes one step per branch of
+ *   the routing table trie instead of a visit of each route.
+ *
+ * Input Parameters:
+ *   target  - The target IPv4 address.
+ *   handler - Will be called for each matching route.  It must not change
+ *             the routing table.
+ *   arg     - An arbitrary value that will be passed to the handler.
+ *
+ * Returned Value:
+ *   Zero (OK) returned if all matching routes were visited.  Handlers may
+ *   terminate the search early with any non-zero value.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv4_RAMROUTE_TRIE
+int net_matchroute_ipv4(in_addr_t target, route_handler_ipv4_t handler,
+                        FAR void *arg);
+#endif
+
 /****************************************************************************
  * Name: net_ipv4_dumproute and net_ipv6_dumproute
  *
@@ -142,13 +142,13 @@ int psock_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
   /* Let the address family's accept() method handle the operation */
 
   DEBUGASSERT(psock->s_sockif != NULL);
-  if (psock->s_sockif->si_accept == NULL)
+  if (psock_sockif(psock)->si_accept == NULL)
     {
       return -EOPNOTSUPP;
     }
 
   net_lock();
-  ret = psock->s_sockif->si_accept(psock, addr, addrlen, newsock, flags);
+  ret = psock_sockif(psock)->si_accept(psock, addr, addrlen, newsock, flags);
   if (ret >= 0)
     {
       /* Mark the new socket as connected. */
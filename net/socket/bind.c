@@ -98,12 +98,12 @@ int psock_bind(FAR struct socket *psock, const struct sockaddr *addr,
   /* Let the address family's connect() method handle the operation */
 
   DEBUGASSERT(psock->s_sockif != NULL);
-  if (psock->s_sockif->si_bind == NULL)
+  if (psock_sockif(psock)->si_bind == NULL)
     {
       return -EOPNOTSUPP;
     }
 
-  ret = psock->s_sockif->si_bind(psock, addr, addrlen);
+  ret = psock_sockif(psock)->si_bind(psock, addr, addrlen);
 
   /* Was the bind successful */
 
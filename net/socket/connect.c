@@ -138,12 +138,12 @@ int psock_connect(FAR struct socket *psock, FAR const struct sockaddr *addr,
   /* Let the address family's connect() method handle the operation */
 
   DEBUGASSERT(psock->s_sockif != NULL);
-  if (psock->s_sockif->si_connect == NULL)
+  if (psock_sockif(psock)->si_connect == NULL)
     {
       return -EOPNOTSUPP;
     }
 
-  ret = psock->s_sockif->si_connect(psock, addr, addrlen);
+  ret = psock_sockif(psock)->si_connect(psock, addr, addrlen);
   if (ret >= 0 && addr->sa_family != AF_UNSPEC)
     {
       FAR struct socket_conn_s *conn = psock->s_conn;
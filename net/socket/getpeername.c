@@ -101,12 +101,12 @@ int psock_getpeername(FAR struct socket *psock, FAR struct sockaddr *addr,
   /* Let the address family's send() method handle the operation */
 
   DEBUGASSERT(psock->s_sockif != NULL);
-  if (psock->s_sockif->si_getpeername == NULL)
+  if (psock_sockif(psock)->si_getpeername == NULL)
     {
       return -EOPNOTSUPP;
     }
 
-  return psock->s_sockif->si_getpeername(psock, addr, addrlen);
+  return psock_sockif(psock)->si_getpeername(psock, addr, addrlen);
 }
 
 /****************************************************************************
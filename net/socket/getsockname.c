@@ -99,12 +99,12 @@ int psock_getsockname(FAR struct socket *psock, FAR struct sockaddr *addr,
   /* Let the address family's send() method handle the operation */
 
   DEBUGASSERT(psock->s_sockif != NULL);
-  if (psock->s_sockif->si_getsockname == NULL)
+  if (psock_sockif(psock)->si_getsockname == NULL)
     {
       return -EOPNOTSUPP;
     }
 
-  return psock->s_sockif->si_getsockname(psock, addr, addrlen);
+  return psock_sockif(psock)->si_getsockname(psock, addr, addrlen);
 }
 
 /****************************************************************************
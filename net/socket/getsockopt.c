@@ -154,6 +154,7 @@ static int psock_socketlevel_option(FAR struct socket *psock, int option,
                            * periodic transmission of probes */
       case SO_OOBINLINE:  /* Leaves received out-of-band data inline */
       case SO_REUSEADDR:  /* Allow reuse of local addresses */
+      case SO_REUSEPORT:  /* Allow sharing of local address and port */
 #ifdef CONFIG_NET_TIMESTAMP
       case SO_TIMESTAMP:  /* Generates a timestamp for each incoming packet */
 #endif
@@ -280,9 +281,9 @@ int psock_getsockopt(FAR struct socket *psock, int level, int option,
 
   /* Perform the socket interface operation */
 
-  if (psock->s_sockif->si_getsockopt != NULL)
+  if (psock_sockif(psock)->si_getsockopt != NULL)
     {
-      ret = psock->s_sockif->si_getsockopt(psock, level, option,
+      ret = psock_sockif(psock)->si_getsockopt(psock, level, option,
                                            value, value_len);
     }
 
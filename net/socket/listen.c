@@ -85,12 +85,12 @@ int psock_listen(FAR struct socket *psock, int backlog)
   /* Let the address family's listen() method handle the operation */
 
   DEBUGASSERT(psock->s_sockif != NULL);
-  if (psock->s_sockif->si_listen == NULL)
+  if (psock_sockif(psock)->si_listen == NULL)
     {
       return -EOPNOTSUPP;
     }
 
-  ret = psock->s_sockif->si_listen(psock, backlog);
+  ret = psock_sockif(psock)->si_listen(psock, backlog);
   if (ret >= 0)
     {
       FAR struct socket_conn_s *conn = psock->s_conn;
@@ -99,9 +99,9 @@ int psock_close(FAR struct socket *psock)
       /* Let the address family's close() method handle the operation */
 
       DEBUGASSERT(psock->s_sockif != NULL &&
-                  psock->s_sockif->si_close != NULL);
+                  psock_sockif(psock)->si_close != NULL);
 
-      ret = psock->s_sockif->si_close(psock);
+      ret = psock_sockif(psock)->si_close(psock);
 
       /* Was the close successful */
 
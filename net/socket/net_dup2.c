@@ -81,8 +81,8 @@ int psock_dup2(FAR struct socket *psock1, FAR struct socket *psock2)
    */
 
   DEBUGASSERT(psock2->s_sockif != NULL &&
-              psock2->s_sockif->si_addref != NULL);
-  psock2->s_sockif->si_addref(psock2);
+              psock_sockif(psock2)->si_addref != NULL);
+  psock_sockif(psock2)->si_addref(psock2);
 
   net_unlock();
 
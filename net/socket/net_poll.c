@@ -62,10 +62,10 @@ int psock_poll(FAR struct socket *psock, FAR struct pollfd *fds, bool setup)
   /* Let the address family's poll() method handle the operation */
 
   DEBUGASSERT(psock->s_sockif != NULL);
-  if (psock->s_sockif->si_poll == NULL)
+  if (psock_sockif(psock)->si_poll == NULL)
     {
       return -EOPNOTSUPP;
     }
 
-  return psock->s_sockif->si_poll(psock, fds, setup);
+  return psock_sockif(psock)->si_poll(psock, fds, setup);
 }
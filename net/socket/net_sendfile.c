@@ -126,11 +126,11 @@ ssize_t psock_sendfile(FAR struct socket *psock, FAR struct file *infile,
    */
 
   DEBUGASSERT(psock->s_sockif != NULL);
-  if (psock->s_sockif->si_sendfile != NULL)
+  if (psock_sockif(psock)->si_sendfile != NULL)
     {
       /* The address family can handle the optimized file send */
 
-      ret = psock->s_sockif->si_sendfile(psock, infile, offset, count);
+      ret = psock_sockif(psock)->si_sendfile(psock, infile, offset, count);
     }
 
   return ret;
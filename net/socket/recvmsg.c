@@ -105,14 +105,14 @@ ssize_t psock_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
    */
 
   DEBUGASSERT(psock->s_sockif != NULL &&
-              psock->s_sockif->si_recvmsg != NULL);
+              psock_sockif(psock)->si_recvmsg != NULL);
 
   /* Save the original cmsg information */
 
   msg_control         = msg->msg_control;
   msg_controllen      = msg->msg_controllen;
 
-  ret = psock->s_sockif->si_recvmsg(psock, msg, flags);
+  ret = psock_sockif(psock)->si_recvmsg(psock, msg, flags);
 
   /* Recover the pointer and calculate the cmsg's true data length */
 
@@ -91,9 +91,9 @@ ssize_t psock_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
    */
 
   DEBUGASSERT(psock->s_sockif != NULL &&
-              psock->s_sockif->si_sendmsg != NULL);
+              psock_sockif(psock)->si_sendmsg != NULL);
 
-  return psock->s_sockif->si_sendmsg(psock, msg, flags);
+  return psock_sockif(psock)->si_sendmsg(psock, msg, flags);
 }
 
 /****************************************************************************
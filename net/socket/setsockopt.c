@@ -137,6 +137,7 @@ static int psock_socketlevel_option(FAR struct socket *psock, int option,
                            * periodic transmission of probes */
       case SO_OOBINLINE:  /* Leaves received out-of-band data inline */
       case SO_REUSEADDR:  /* Allow reuse of local addresses */
+      case SO_REUSEPORT:  /* Allow sharing of local address and port */
 #ifdef CONFIG_NET_TIMESTAMP
       case SO_TIMESTAMP:  /* Generates a timestamp for each incoming packet */
 #endif
@@ -311,9 +312,9 @@ int psock_setsockopt(FAR struct socket *psock, int level, int option,
 
   /* Perform the socket interface operation */
 
-  if (psock->s_sockif->si_setsockopt != NULL)
+  if (psock_sockif(psock)->si_setsockopt != NULL)
     {
-      ret = psock->s_sockif->si_setsockopt(psock, level, option,
+      ret = psock_sockif(psock)->si_setsockopt(psock, level, option,
                                            value, value_len);
     }
 
@@ -81,9 +81,9 @@ int psock_shutdown(FAR struct socket *psock, int how)
 
   /* Let the address family's shutdown() method handle the operation */
 
-  if (psock->s_sockif && psock->s_sockif->si_shutdown)
+  if (psock->s_sockif && psock_sockif(psock)->si_shutdown)
     {
-      return psock->s_sockif->si_shutdown(psock, how);
+      return psock_sockif(psock)->si_shutdown(psock, how);
     }
 
   return -EOPNOTSUPP;
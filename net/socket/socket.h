@@ -37,6 +37,10 @@
 #include <nuttx/clock.h>
 #include <nuttx/net/net.h>
 
+#ifdef CONFIG_NET_SOCKIF_DIRECT
+#  include "inet/inet.h"
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -65,10 +69,11 @@
 #define _SO_TYPE         _SO_BIT(SO_TYPE)
 #define _SO_TIMESTAMP    _SO_BIT(SO_TIMESTAMP)
 #define _SO_BINDTODEVICE _SO_BIT(SO_BINDTODEVICE)
+#define _SO_REUSEPORT    _SO_BIT(SO_REUSEPORT)
 
 /* This is the largest option value.  REVISIT: belongs in sys/socket.h */
 
-#define _SO_MAXOPT       (18)
+#define _SO_MAXOPT       (19)
 
 /* Macros to set, test, clear options */
 
@@ -122,6 +127,17 @@
 #  define _SO_SETERRNO(s,e)
 #endif /* CONFIG_NET_SOCKOPTS */
 
+/* The interface of the socket.  If the inet interface is the only one, it
+ * is the constant one, so that the link time optimization turns the calls
+ * through it into direct calls, and inlines them.
+ */
+
+#ifdef CONFIG_NET_SOCKIF_DIRECT
+#  define psock_sockif(psock) (&g_inet_sockif)
+#else
+#  define psock_sockif(psock) ((psock)->s_sockif)
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -71,7 +71,7 @@ int psock_socketpair(int domain, int type, int protocol,
       return ret;
     }
 
-  if (psocks[0]->s_sockif->si_socketpair == NULL)
+  if (psock_sockif(psocks[0])->si_socketpair == NULL)
     {
       ret = -EAFNOSUPPORT;
       goto errsock;
@@ -85,7 +85,7 @@ int psock_socketpair(int domain, int type, int protocol,
 
   /* Perform socketpair process */
 
-  ret = psocks[0]->s_sockif->si_socketpair(psocks);
+  ret = psock_sockif(psocks[0])->si_socketpair(psocks);
   if (ret == 0)
     {
       return ret;
@@ -40,6 +40,8 @@
 #include <nuttx/net/tcp.h>
 #include <nuttx/wqueue.h>
 
+#include "devif/devif.h"
+
 #ifdef CONFIG_NET_TCP
 
 /****************************************************************************
@@ -61,8 +63,13 @@
  * notifications of TCP data-related events.
  */
 
+#ifdef CONFIG_NET_TCP_CALLBACK_SLOT
+#define tcp_callback_alloc(conn) \
+  devif_callback_alloc_slot((conn)->dev, &(conn)->cbslot, &(conn)->sconn.list, &(conn)->sconn.list_tail)
+#else
 #define tcp_callback_alloc(conn) \
   devif_callback_alloc((conn)->dev, &(conn)->sconn.list, &(conn)->sconn.list_tail)
+#endif
 #define tcp_callback_free(conn,cb) \
   devif_conn_callback_free((conn)->dev, (cb), &(conn)->sconn.list, &(conn)->sconn.list_tail)
 
@@ -118,6 +125,18 @@
 
 #endif
 
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+#define TCP_QUICKACK_ON       0x80U /* Delayed ACKs are off (TCP_QUICKACK) */
+#endif
+
+#ifdef CONFIG_NET_TCP_AUTOTUNE
+/* The buffer sizes set by the application, not auto-tuned */
+
+#define TCP_RCVBUF_LOCK       0x20U /* The receive buffer size is set */
+#define TCP_SNDBUF_LOCK       0x40U /* The send buffer size is set */
+
+#endif
+
 /* The Max Range count of TCP Selective ACKs */
 
 #define TCP_SACK_RANGES_MAX   4
@@ -238,6 +257,7 @@ struct tcp_conn_s
 #ifdef CONFIG_NET_TCP_DELAYED_ACK
   uint8_t  rx_unackseg;   /* Number of un-ACKed received segments */
   uint8_t  rx_acktimer;   /* Time since last ACK sent (units: half-seconds) */
+  uint8_t  rx_quickack;   /* Number of segments left to ACK at once */
 #endif
   uint16_t lport;         /* The local TCP port, in network byte order */
   uint16_t rport;         /* The remoteTCP port, in network byte order */
@@ -256,6 +276,13 @@ struct tcp_conn_s
   uint32_t cwnd;          /* The Congestion window */
   uint32_t max_cwnd;      /* The Congestion window maximum value */
   uint32_t ssthresh;      /* The Slow start threshold */
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+  uint32_t w_max;         /* cwnd at the last congestion event */
+  uint32_t w_lastmax;     /* w_max before the last congestion event */
+  uint32_t w_est;         /* The cwnd NewReno would have in this epoch */
+  uint32_t cubic_k;       /* Time from the epoch to w_max (units: ms) */
+  clock_t  cubic_epoch;   /* Start of the window growth, 0 if none */
+#endif
 #endif
 #ifdef CONFIG_NET_TCP_WINDOW_SCALE
   uint32_t snd_wnd;       /* Sequence and acknowledgement numbers of last
@@ -275,6 +302,19 @@ struct tcp_conn_s
   int32_t  snd_bufs;      /* Maximum amount of bytes queued in send */
   sem_t    snd_sem;       /* Semaphore signals send completion */
 #endif
+#ifdef CONFIG_NET_TCP_AUTOTUNE
+#if CONFIG_NET_RECV_BUFSIZE > 0
+  uint32_t rcv_grown;     /* Bytes rcv_bufs took from the budget */
+  uint32_t rcv_rttseq;    /* rcvseq that ends the RTT measurement */
+  clock_t  rcv_rtttime;   /* Start of the RTT measurement, 0 if none */
+  clock_t  rcv_rtt;       /* RTT estimated by the receiver (ticks) */
+  uint32_t rcv_spaceseq;  /* rcvseq at the start of the last RTT */
+  clock_t  rcv_spacetime; /* Start of the last RTT, 0 if none */
+#endif
+#if CONFIG_NET_SEND_BUFSIZE > 0
+  uint32_t snd_grown;     /* Bytes snd_bufs took from the budget */
+#endif
+#endif
 #if defined(CONFIG_NET_TCP_WRITE_BUFFERS) || \
     defined(CONFIG_NET_TCP_WINDOW_SCALE)
   uint32_t tx_unacked;    /* Number bytes sent but not yet ACKed */
@@ -295,6 +335,16 @@ struct tcp_conn_s
 
   FAR struct net_driver_s *dev;
 
+#ifdef CONFIG_NET_TCP_HASH
+  /* Hash chains.  'hnext' links the active connections that share a bucket
+   * of the 4-tuple hash, 'lnext' the listeners that share a bucket of the
+   * listener hash.
+   */
+
+  FAR struct tcp_conn_s *hnext;
+  FAR struct tcp_conn_s *lnext;
+#endif
+
   /* Read-ahead buffering.
    *
    *   readahead - An IOB chain where the TCP/IP read-ahead data is retained.
@@ -386,6 +436,12 @@ struct tcp_conn_s
   FAR struct devif_callback_s *sndcb;
 #endif
 
+#ifdef CONFIG_NET_TCP_CALLBACK_SLOT
+  /* Callback container used before the free list, see tcp_callback_alloc */
+
+  struct devif_callback_s cbslot;
+#endif
+
   /* accept() is called when the TCP logic has created a connection
    *
    *   accept_private: This is private data that will be available to the
@@ -467,6 +523,53 @@ extern "C"
 
 void tcp_initialize(void);
 
+#ifdef CONFIG_NET_TCP_HASH
+
+/****************************************************************************
+ * Name: tcp_hash_insert / tcp_hash_remove
+ *
+ * Description:
+ *   Add/remove an active connection to/from the 4-tuple hash table.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+void tcp_hash_insert(FAR struct tcp_conn_s *conn);
+void tcp_hash_remove(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Name: tcp_hash_lookup
+ *
+ * Description:
+ *   Find the active connection that matches the TCP/IP header in the
+ *   device buffer.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+FAR struct tcp_conn_s *tcp_hash_lookup(FAR struct net_driver_s *dev,
+                                       FAR struct tcp_hdr_s *tcp);
+
+/****************************************************************************
+ * Name: tcp_hash_resize
+ *
+ * Description:
+ *   Re-distribute the active connections over a table of 'nbuckets'
+ *   buckets (a power of two).
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int tcp_hash_resize(unsigned int nbuckets);
+
+#endif /* CONFIG_NET_TCP_HASH */
+
 /****************************************************************************
  * Name: tcp_alloc
  *
@@ -1710,6 +1813,47 @@ int tcp_getsockopt(FAR struct socket *psock, int option,
 uint32_t tcp_get_recvwindow(FAR struct net_driver_s *dev,
                             FAR struct tcp_conn_s *conn);
 
+/****************************************************************************
+ * Name: tcp_autotune
+ *
+ * Description:
+ *   Grow the buffers of the connection after the input of a segment.
+ *
+ * Input Parameters:
+ *   conn  - The TCP connection of interest
+ *   flags - The TCP_NEWDATA and TCP_ACKDATA flags of the segment
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_AUTOTUNE
+void tcp_autotune(FAR struct tcp_conn_s *conn, uint16_t flags);
+
+/****************************************************************************
+ * Name: tcp_autotune_lock
+ *
+ * Description:
+ *   Stop the auto-tuning of some buffers of the connection, because the
+ *   application sets their size or the connection is freed, and give
+ *   their growth back to the budget.
+ *
+ * Input Parameters:
+ *   conn  - The TCP connection of interest
+ *   lock  - TCP_RCVBUF_LOCK and/or TCP_SNDBUF_LOCK
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void tcp_autotune_lock(FAR struct tcp_conn_s *conn, uint16_t lock);
+#endif
+
 /****************************************************************************
  * Name: tcp_should_send_recvwindow
  *
@@ -2307,6 +2451,26 @@ void tcp_cc_update(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp);
  ****************************************************************************/
 
 void tcp_cc_recv_ack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp);
+
+/****************************************************************************
+ * Name: tcp_cc_timeout
+ *
+ * Description:
+ *   Update the congestion control variables when the retransmission timer
+ *   expires.  The connection goes back to slow start from one segment.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_cc_timeout(FAR struct tcp_conn_s *conn);
 #endif
 
 #ifdef __cplusplus
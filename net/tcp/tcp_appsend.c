@@ -126,11 +126,21 @@ void tcp_appsend(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
        * 3. Experimentation shows that Windows and Linux behave somewhat
        *    differently; they delay the ACKs for many more segments (6 or
        *    more).  Delaying for more segments would provide less network
-       *    traffic and better performance but seems non-compliant.
+       *    traffic and better performance but seems non-compliant.  So the
+       *    ACK covers CONFIG_NET_TCP_DELAYED_ACK_SEGS segments, 2 by
+       *    default.
+       * 4. The first segments of the connection are ACKed at once, as well
+       *    as all of them with TCP_QUICKACK set.
        */
 
-      if (conn->rx_unackseg > 0 || dev->d_sndlen > 0 ||
-          result != TCP_SNDACK)
+      if (conn->rx_quickack > 0)
+        {
+          conn->rx_quickack--;
+          conn->rx_unackseg = 0;
+        }
+      else if (conn->rx_unackseg + 1 >= CONFIG_NET_TCP_DELAYED_ACK_SEGS ||
+               (conn->flags & TCP_QUICKACK_ON) != 0 ||
+               dev->d_sndlen > 0 || result != TCP_SNDACK)
         {
           /* Reset the delayed ACK state and send the ACK with this packet. */
 
@@ -138,12 +148,11 @@ void tcp_appsend(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
         }
       else
         {
-          /* This is only an ACK and there is no pending delayed ACK and
-           * no TX data is being sent.  Indicate that there is one un-ACKed
-           * segment and don't send anything now.
+          /* This is only an ACK and no TX data is being sent.  Count one
+           * more un-ACKed segment and don't send anything now.
            */
 
-          conn->rx_unackseg = 1;
+          conn->rx_unackseg++;
           return;
         }
     }
@@ -0,0 +1,289 @@
+/****************************************************************************
+ * net/tcp/tcp_autotune.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/net.h>
+#include <nuttx/spinlock.h>
+
+#include "devif/devif.h"
+#include "tcp/tcp.h"
+
+#ifdef CONFIG_NET_TCP_AUTOTUNE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The bytes all of the connections may grow their buffers by */
+
+#if CONFIG_NET_TCP_AUTOTUNE_BUDGET > 0
+#  define TCP_AUTOTUNE_BUDGET CONFIG_NET_TCP_AUTOTUNE_BUDGET
+#else
+#  define TCP_AUTOTUNE_BUDGET \
+    ((CONFIG_IOB_NBUFFERS - CONFIG_IOB_THROTTLE) * CONFIG_IOB_BUFSIZE / 2)
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The bytes of the budget taken by the connections.  The lock is needed
+ * as setsockopt() doesn't hold the network lock.
+ */
+
+static uint32_t g_tcp_autotune_used;
+static spinlock_t g_tcp_autotune_lock = SP_UNLOCKED;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_autotune_grow
+ *
+ * Description:
+ *   Grow a buffer size towards want, within max (0 if none) and what is
+ *   left of the budget.
+ *
+ * Input Parameters:
+ *   bufs  - The buffer size to grow
+ *   grown - The bytes of the budget taken by the buffer
+ *   want  - The desired buffer size
+ *   max   - The maximum buffer size
+ *
+ ****************************************************************************/
+
+static void tcp_autotune_grow(FAR int32_t *bufs, FAR uint32_t *grown,
+                              uint32_t want, uint32_t max)
+{
+  irqstate_t flags;
+  uint32_t delta;
+
+  if (max > 0 && want > max)
+    {
+      want = max;
+    }
+
+  if (want <= (uint32_t)*bufs)
+    {
+      return;
+    }
+
+  flags = spin_lock_irqsave(&g_tcp_autotune_lock);
+  delta = MIN(want - *bufs, TCP_AUTOTUNE_BUDGET - g_tcp_autotune_used);
+  g_tcp_autotune_used += delta;
+  spin_unlock_irqrestore(&g_tcp_autotune_lock, flags);
+
+  if (delta > 0)
+    {
+      *bufs  += delta;
+      *grown += delta;
+
+      ninfo("buffer grown to %" PRId32 "\n", *bufs);
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_autotune_rcv
+ *
+ * Description:
+ *   Grow the receive buffer to twice the data received in one round trip,
+ *   so that the window doesn't limit the peer even when the application
+ *   lags by a round trip.
+ *
+ *   The receiver doesn't know the RTT: it is estimated by the time the
+ *   peer takes to fill the advertised window, the lowest samples being
+ *   the most accurate.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_RECV_BUFSIZE > 0
+static void tcp_autotune_rcv(FAR struct tcp_conn_s *conn, clock_t now)
+{
+  uint32_t rcvseq = tcp_getsequence(conn->rcvseq);
+  clock_t sample;
+
+  if (conn->rcv_rtttime == 0)
+    {
+      conn->rcv_rttseq  = conn->rcv_adv;
+      conn->rcv_rtttime = now;
+    }
+  else if (TCP_SEQ_GTE(rcvseq, conn->rcv_rttseq))
+    {
+      sample = MAX(now - conn->rcv_rtttime, 1);
+      if (conn->rcv_rtt == 0 || sample < conn->rcv_rtt)
+        {
+          conn->rcv_rtt = sample;
+        }
+      else
+        {
+          conn->rcv_rtt += (sample - conn->rcv_rtt) / 8;
+        }
+
+      conn->rcv_rttseq  = conn->rcv_adv;
+      conn->rcv_rtttime = now;
+    }
+
+  if (conn->rcv_rtt == 0)
+    {
+      return;
+    }
+
+  if (conn->rcv_spacetime == 0)
+    {
+      conn->rcv_spaceseq  = rcvseq;
+      conn->rcv_spacetime = now;
+    }
+  else if (now - conn->rcv_spacetime >= conn->rcv_rtt)
+    {
+      tcp_autotune_grow(&conn->rcv_bufs, &conn->rcv_grown,
+                        2 * TCP_SEQ_SUB(rcvseq, conn->rcv_spaceseq),
+                        CONFIG_NET_MAX_RECV_BUFSIZE);
+
+      conn->rcv_spaceseq  = rcvseq;
+      conn->rcv_spacetime = now;
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_autotune_snd
+ *
+ * Description:
+ *   Grow the send buffer to twice the data the connection may have in
+ *   flight, that is what it delivers in one round trip, so that the
+ *   application can queue the next round trip while the current one is
+ *   not acknowledged.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_SEND_BUFSIZE > 0
+static void tcp_autotune_snd(FAR struct tcp_conn_s *conn)
+{
+  uint32_t wnd = conn->snd_wnd;
+
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+  wnd = MIN(wnd, conn->cwnd);
+#endif
+
+  tcp_autotune_grow(&conn->snd_bufs, &conn->snd_grown, 2 * wnd,
+                    CONFIG_NET_MAX_SEND_BUFSIZE);
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_autotune
+ *
+ * Description:
+ *   Grow the buffers of the connection after the input of a segment.
+ *
+ * Input Parameters:
+ *   conn  - The TCP connection of interest
+ *   flags - The TCP_NEWDATA and TCP_ACKDATA flags of the segment
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_autotune(FAR struct tcp_conn_s *conn, uint16_t flags)
+{
+#if CONFIG_NET_RECV_BUFSIZE > 0
+  if ((flags & TCP_NEWDATA) != 0 && (conn->flags & TCP_RCVBUF_LOCK) == 0)
+    {
+      clock_t now = clock_systime_ticks();
+
+      tcp_autotune_rcv(conn, now != 0 ? now : 1);
+    }
+#endif
+
+#if CONFIG_NET_SEND_BUFSIZE > 0
+  if ((flags & TCP_ACKDATA) != 0 && (conn->flags & TCP_SNDBUF_LOCK) == 0)
+    {
+      tcp_autotune_snd(conn);
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: tcp_autotune_lock
+ *
+ * Description:
+ *   Stop the auto-tuning of some buffers of the connection, because the
+ *   application sets their size or the connection is freed, and give
+ *   their growth back to the budget.
+ *
+ * Input Parameters:
+ *   conn  - The TCP connection of interest
+ *   lock  - TCP_RCVBUF_LOCK and/or TCP_SNDBUF_LOCK
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void tcp_autotune_lock(FAR struct tcp_conn_s *conn, uint16_t lock)
+{
+  irqstate_t flags;
+
+  conn->flags |= lock;
+
+  flags = spin_lock_irqsave(&g_tcp_autotune_lock);
+
+#if CONFIG_NET_RECV_BUFSIZE > 0
+  if ((lock & TCP_RCVBUF_LOCK) != 0)
+    {
+      g_tcp_autotune_used -= conn->rcv_grown;
+      conn->rcv_grown      = 0;
+    }
+#endif
+
+#if CONFIG_NET_SEND_BUFSIZE > 0
+  if ((lock & TCP_SNDBUF_LOCK) != 0)
+    {
+      g_tcp_autotune_used -= conn->snd_grown;
+      conn->snd_grown      = 0;
+    }
+#endif
+
+  spin_unlock_irqrestore(&g_tcp_autotune_lock, flags);
+}
+
+#endif /* CONFIG_NET_TCP_AUTOTUNE */
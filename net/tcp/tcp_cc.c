@@ -26,6 +26,8 @@
 
 #include <debug.h>
 
+#include <nuttx/clock.h>
+
 #include "tcp/tcp.h"
 
 /****************************************************************************
@@ -74,10 +76,172 @@
     } \
  } while(0)
 
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+/* CUBIC constants, RFC8312 Section 5: beta_cubic = 0.7 and
+ * C = 0.4 segments / s^3.
+ */
+
+#define CUBIC_BETA_NUM 7
+#define CUBIC_BETA_DEN 10
+#define CUBIC_C_NUM    4
+#define CUBIC_C_DEN    10
+
+/* The cubic term is held beyond this distance from K (units: ms), so that
+ * it can't overflow.  The window is far from w_max by then anyway.
+ */
+
+#define CUBIC_MAX_MS   60000
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+/****************************************************************************
+ * Name: tcp_cc_cbrt
+ *
+ * Description:
+ *   Integer cube root, rounded down.  x must be below 2^63.
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_cc_cbrt(uint64_t x)
+{
+  uint32_t lo = 0;
+  uint32_t hi = 1 << 21;
+  uint32_t mid;
+
+  while (hi - lo > 1)
+    {
+      mid = lo + (hi - lo) / 2;
+      if ((uint64_t)mid * mid * mid <= x)
+        {
+          lo = mid;
+        }
+      else
+        {
+          hi = mid;
+        }
+    }
+
+  return lo;
+}
+
+/****************************************************************************
+ * Name: tcp_cc_cubic_avoid
+ *
+ * Description:
+ *   Grow cwnd in congestion avoidance, by RFC8312 Section 4:
+ *     W_cubic(t) = C * (t - K)^3 + W_max, K = cbrt(W_max * (1 - beta) / C)
+ *   with t the time since the start of the epoch, and no less than the
+ *   window NewReno would have reached since then (the TCP-friendly region).
+ *
+ ****************************************************************************/
+
+static void tcp_cc_cubic_avoid(FAR struct tcp_conn_s *conn, uint32_t acked)
+{
+  clock_t now = clock_systime_ticks();
+  uint32_t target;
+  uint32_t increase;
+  int64_t offs;
+  int32_t t;
+
+  /* Start a new epoch on the first ACK in congestion avoidance */
+
+  if (conn->cubic_epoch == 0)
+    {
+      conn->cubic_epoch = now != 0 ? now : 1;
+      conn->w_est       = conn->cwnd;
+
+      if (conn->cwnd < conn->w_max)
+        {
+          conn->cubic_k = tcp_cc_cbrt((uint64_t)(conn->w_max - conn->cwnd) *
+                                      1000000000ull / conn->mss *
+                                      CUBIC_C_DEN / CUBIC_C_NUM);
+        }
+      else
+        {
+          conn->cubic_k = 0;
+          conn->w_max   = conn->cwnd;
+        }
+    }
+
+  t = (int32_t)(TICK2MSEC(now - conn->cubic_epoch) - conn->cubic_k);
+  t = MIN(MAX(t, -CUBIC_MAX_MS), CUBIC_MAX_MS);
+
+  offs   = (int64_t)t * t * t * CUBIC_C_NUM / CUBIC_C_DEN;
+  offs   = offs * conn->mss / 1000000000;
+  offs  += conn->w_max;
+  target = offs > UINT32_MAX ? UINT32_MAX :
+           offs < conn->mss  ? conn->mss  : (uint32_t)offs;
+
+  /* Approach the target by (target - cwnd) / cwnd per segment acked, or
+   * creep up by 1/100 segment when at the target already.
+   */
+
+  if (target > conn->cwnd)
+    {
+      increase = (uint64_t)(target - conn->cwnd) * acked / conn->cwnd;
+    }
+  else
+    {
+      increase = (uint64_t)conn->mss * acked / (100 * conn->cwnd);
+    }
+
+  CC_CWND_INC(conn->cwnd, MAX(increase, 1));
+
+  /* NewReno with the CUBIC beta grows by 3 * (1 - beta) / (1 + beta)
+   * segments per RTT, that is 9/17.
+   */
+
+  increase = (uint64_t)conn->mss * acked * 9 / 17 / conn->w_est;
+  CC_CWND_INC(conn->w_est, MAX(increase, 1));
+
+  if (conn->w_est > conn->cwnd)
+    {
+      conn->cwnd = conn->w_est;
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_cc_loss
+ *
+ * Description:
+ *   Set ssthresh on a congestion event, fast retransmit or timeout
+ *
+ ****************************************************************************/
+
+static void tcp_cc_loss(FAR struct tcp_conn_s *conn)
+{
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+  /* Fast convergence: if the window is smaller than at the previous
+   * event, other flows are getting in, and w_max is lowered further to
+   * release bandwidth to them.
+   */
+
+  if (conn->cwnd < conn->w_lastmax)
+    {
+      conn->w_lastmax = conn->cwnd;
+      conn->w_max     = (uint64_t)conn->cwnd *
+                        (CUBIC_BETA_DEN + CUBIC_BETA_NUM) /
+                        (2 * CUBIC_BETA_DEN);
+    }
+  else
+    {
+      conn->w_lastmax = conn->cwnd;
+      conn->w_max     = conn->cwnd;
+    }
+
+  conn->ssthresh    = MAX((uint64_t)conn->cwnd * CUBIC_BETA_NUM /
+                          CUBIC_BETA_DEN, 2 * conn->mss);
+  conn->cubic_epoch = 0;
+#else
+  conn->ssthresh = MAX(conn->tx_unacked / 2, 2 * conn->mss);
+#endif
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -117,6 +281,14 @@ void tcp_cc_init(FAR struct tcp_conn_s *conn)
 
   conn->ssthresh = 2 * TCP_IPV4_DEFAULT_MSS;
   conn->dupacks = 0;
+
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+  conn->w_max       = 0;
+  conn->w_lastmax   = 0;
+  conn->w_est       = 0;
+  conn->cubic_k     = 0;
+  conn->cubic_epoch = 0;
+#endif
 }
 
 /****************************************************************************
@@ -148,7 +320,7 @@ void tcp_cc_update(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp)
 
   if (conn->flags & TCP_INFT)
     {
-      conn->ssthresh = MAX(conn->tx_unacked / 2, 2 * conn->mss);
+      tcp_cc_loss(conn);
       conn->cwnd = conn->ssthresh + 3 * conn->mss;
 
       conn->flags &= ~TCP_INFT;
@@ -220,7 +392,12 @@ void tcp_cc_recv_ack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp)
               CC_CWND_INC(conn->cwnd, conn->mss);
             }
 
-          if (conn->dupacks >= TCP_FAST_RETRANSMISSION_THRESH)
+          /* The window is reduced once per window of data: the dupacks
+           * in Fast Recovery don't start a new one (RFC6582).
+           */
+
+          if (conn->dupacks >= TCP_FAST_RETRANSMISSION_THRESH &&
+              (conn->flags & TCP_INFR) == 0)
             {
               /* Do fast retransmit, but it is delayed in
                * psock_send_eventhandler. Set the TCP_INFT flag.
@@ -284,6 +461,10 @@ void tcp_cc_recv_ack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp)
             }
           else
             {
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+              tcp_cc_cubic_avoid(conn, acked);
+              ninfo("update cubic cwnd to %u\n", conn->cwnd);
+#else
               /* cong avoid (RFC 5681):
                * Grow cwnd linearly by approximately maxseg per RTT using
                * maxseg^2 / cwnd per ACK as the increment.
@@ -296,7 +477,42 @@ void tcp_cc_recv_ack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp)
               CC_CWND_INC(conn->cwnd, increase);
               conn->cwnd = MIN(conn->cwnd, conn->max_cwnd);
               ninfo("update congestion avoidance cwnd to %u\n", conn->cwnd);
+#endif
             }
         }
     }
 }
+
+/****************************************************************************
+ * Name: tcp_cc_timeout
+ *
+ * Description:
+ *   Update the congestion control variables when the retransmission timer
+ *   expires.  The connection goes back to slow start from one segment.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_cc_timeout(FAR struct tcp_conn_s *conn)
+{
+  /* If conn is TCP_INFR, it should enter to slow start */
+
+  conn->flags &= ~(TCP_INFR | TCP_INFT);
+
+  /* update the max_cwnd */
+
+  conn->max_cwnd = (conn->max_cwnd + 7 * conn->cwnd) >> 3;
+
+  /* reset cwnd and ssthresh, refers to RFC5861. */
+
+  tcp_cc_loss(conn);
+  conn->cwnd = conn->mss;
+}
@@ -523,8 +523,8 @@ static FAR struct tcp_conn_s *tcp_alloc_conn(void)
         }
 #endif
 
-      conn = kmm_zalloc(sizeof(struct tcp_conn_s) *
-                        CONFIG_NET_TCP_ALLOC_CONNS);
+      conn = net_conn_zalloc(sizeof(struct tcp_conn_s) *
+                             CONFIG_NET_TCP_ALLOC_CONNS);
       if (conn == NULL)
         {
           return conn;
@@ -800,6 +800,9 @@ FAR struct tcp_conn_s *tcp_alloc(uint8_t domain)
 
       nxsem_init(&conn->snd_sem, 0, 0);
 #endif
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+      conn->rx_quickack   = CONFIG_NET_TCP_QUICKACK_SEGS;
+#endif
 
       /* Set the default value of mss to max, this field will changed when
        * receive SYN.
@@ -923,10 +926,19 @@ void tcp_free(FAR struct tcp_conn_s *conn)
       /* Remove the connection from the active list */
 
       dq_rem(&conn->sconn.node, &g_active_tcp_connections);
+#ifdef CONFIG_NET_TCP_HASH
+      tcp_hash_remove(conn);
+#endif
     }
 
   tcp_free_rx_buffers(conn);
 
+#ifdef CONFIG_NET_TCP_AUTOTUNE
+  /* Give the growth of the buffers back to the budget */
+
+  tcp_autotune_lock(conn, TCP_RCVBUF_LOCK | TCP_SNDBUF_LOCK);
+#endif
+
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
   /* Release any write buffers attached to the connection */
 
@@ -980,7 +992,7 @@ void tcp_free(FAR struct tcp_conn_s *conn)
   if (conn < g_tcp_connections || conn >= (g_tcp_connections +
       CONFIG_NET_TCP_PREALLOC_CONNS))
     {
-      kmm_free(conn);
+      net_conn_free(conn);
     }
   else
 #endif
@@ -1006,12 +1018,17 @@ void tcp_free(FAR struct tcp_conn_s *conn)
 FAR struct tcp_conn_s *tcp_active(FAR struct net_driver_s *dev,
                                   FAR struct tcp_hdr_s *tcp)
 {
+  FAR struct tcp_conn_s *conn;
+
+#ifdef CONFIG_NET_TCP_HASH
+  conn = tcp_hash_lookup(dev, tcp);
+#else
 #ifdef CONFIG_NET_IPv6
 #ifdef CONFIG_NET_IPv4
   if (IFF_IS_IPv6(dev->d_flags))
 #endif
     {
-      return tcp_ipv6_active(dev, tcp);
+      conn = tcp_ipv6_active(dev, tcp);
     }
 #endif /* CONFIG_NET_IPv6 */
 
@@ -1020,9 +1037,12 @@ FAR struct tcp_conn_s *tcp_active(FAR struct net_driver_s *dev,
   else
 #endif
     {
-      return tcp_ipv4_active(dev, tcp);
+      conn = tcp_ipv4_active(dev, tcp);
     }
 #endif /* CONFIG_NET_IPv4 */
+#endif /* CONFIG_NET_TCP_HASH */
+
+  return conn;
 }
 
 /****************************************************************************
@@ -1179,6 +1199,9 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
 #endif
 #if CONFIG_NET_SEND_BUFSIZE > 0
       conn->snd_bufs         = listener->snd_bufs;
+#endif
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+      conn->flags           |= listener->flags & TCP_QUICKACK_ON;
 #endif
       conn->mss              = listener->mss;
 
@@ -1232,6 +1255,10 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
        */
 
       dq_addlast(&conn->sconn.node, &g_active_tcp_connections);
+#ifdef CONFIG_NET_TCP_HASH
+      tcp_hash_insert(conn);
+#endif
+
       tcp_update_retrantimer(conn, TCP_RTO);
     }
 
@@ -1543,6 +1570,9 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
   /* And, finally, put the connection structure into the active list. */
 
   dq_addlast(&conn->sconn.node, &g_active_tcp_connections);
+#ifdef CONFIG_NET_TCP_HASH
+  tcp_hash_insert(conn);
+#endif
   ret = OK;
 
 errout_with_lock:
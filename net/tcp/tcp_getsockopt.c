@@ -220,6 +220,23 @@ int tcp_getsockopt(FAR struct socket *psock, int option,
           }
         break;
 
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+      case TCP_QUICKACK: /* Don't delay the ACKs */
+        if (*value_len < sizeof(int))
+          {
+            ret                = -EINVAL;
+          }
+        else
+          {
+            FAR int *quickack  = (FAR int *)value;
+
+            *quickack          = (conn->flags & TCP_QUICKACK_ON) != 0;
+            *value_len         = sizeof(int);
+            ret                = OK;
+          }
+        break;
+#endif /* CONFIG_NET_TCP_DELAYED_ACK */
+
       case TCP_MAXSEG:   /* The maximum segment size */
         if (*value_len < sizeof(int))
           {
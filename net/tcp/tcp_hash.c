@@ -0,0 +1,429 @@
+/****************************************************************************
+ * net/tcp/tcp_hash.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/net/tcp.h>
+
+#include "inet/inet.h"
+#include "tcp/tcp.h"
+
+#ifdef CONFIG_NET_TCP_HASH
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if (CONFIG_NET_TCP_HASH_SIZE & (CONFIG_NET_TCP_HASH_SIZE - 1)) != 0
+#  error CONFIG_NET_TCP_HASH_SIZE must be a power of two
+#endif
+
+/* Grow the table once the average chain is longer than this */
+
+#define TCP_HASH_MAXLOAD  2
+
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+#  define TCP_CONN_DOMAIN(c) ((c)->domain)
+#elif defined(CONFIG_NET_IPv4)
+#  define TCP_CONN_DOMAIN(c) PF_INET
+#else
+#  define TCP_CONN_DOMAIN(c) PF_INET6
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The initial bucket array.  It is replaced with a heap allocated one when
+ * the table is resized.
+ */
+
+static FAR struct tcp_conn_s *g_tcp_hash_init[CONFIG_NET_TCP_HASH_SIZE];
+
+static FAR struct tcp_conn_s **g_tcp_hash = g_tcp_hash_init;
+static unsigned int g_tcp_hash_size = CONFIG_NET_TCP_HASH_SIZE;
+static unsigned int g_tcp_hash_count;
+
+/* The table is grown on the low priority work queue, never on the packet
+ * path.  After a failed allocation it is not tried again before the number
+ * of connections has doubled.
+ */
+
+static struct work_s g_tcp_hash_work;
+static unsigned int g_tcp_hash_backoff;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_hash_mix
+ *
+ * Description:
+ *   Mix the folded remote address with the port pair.  lport and rport are
+ *   in network order, which does not matter as long as it is consistent.
+ *
+ ****************************************************************************/
+
+static inline uint32_t tcp_hash_mix(uint32_t raddr, uint16_t lport,
+                                    uint16_t rport)
+{
+  uint32_t hash = raddr ^ (((uint32_t)lport << 16) | rport);
+
+  hash ^= hash >> 16;
+  hash *= 0x45d9f3b;
+  hash ^= hash >> 16;
+  return hash;
+}
+
+#ifdef CONFIG_NET_IPv4
+static inline uint32_t tcp_hash_ipv4(in_addr_t raddr, uint16_t lport,
+                                     uint16_t rport)
+{
+  return tcp_hash_mix((uint32_t)raddr, lport, rport);
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static inline uint32_t tcp_hash_ipv6(FAR const uint16_t *raddr,
+                                     uint16_t lport, uint16_t rport)
+{
+  uint32_t fold = 0;
+  int i;
+
+  for (i = 0; i < 8; i += 2)
+    {
+      fold ^= ((uint32_t)raddr[i] << 16) | raddr[i + 1];
+    }
+
+  return tcp_hash_mix(fold, lport, rport);
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_hash_conn
+ *
+ * Description:
+ *   Return the hash value of an active connection.
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_hash_conn(FAR struct tcp_conn_s *conn)
+{
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  if (TCP_CONN_DOMAIN(conn) == PF_INET)
+#endif
+    {
+      return tcp_hash_ipv4(conn->u.ipv4.raddr, conn->lport, conn->rport);
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  else
+#endif
+    {
+      return tcp_hash_ipv6(conn->u.ipv6.raddr, conn->lport, conn->rport);
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: tcp_hash_grow
+ *
+ * Description:
+ *   Work queue worker that doubles the number of buckets when the table is
+ *   still overloaded.
+ *
+ ****************************************************************************/
+
+static void tcp_hash_grow(FAR void *arg)
+{
+  unsigned int nbuckets;
+  unsigned int count;
+  int ret;
+
+  net_lock();
+  nbuckets = g_tcp_hash_size;
+  count    = g_tcp_hash_count;
+  net_unlock();
+
+  if (count <= nbuckets * TCP_HASH_MAXLOAD ||
+      nbuckets >= CONFIG_NET_TCP_HASH_MAXSIZE)
+    {
+      return;
+    }
+
+  ret = tcp_hash_resize(nbuckets << 1);
+  if (ret < 0)
+    {
+      nwarn("WARNING: TCP hash not resized: %d\n", ret);
+      g_tcp_hash_backoff = count << 1;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_hash_insert
+ *
+ * Description:
+ *   Add an active connection to the hash table.  The local and remote
+ *   ports and the remote address must not change while the connection is
+ *   in the table.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+void tcp_hash_insert(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_conn_s **bucket;
+
+  bucket      = &g_tcp_hash[tcp_hash_conn(conn) & (g_tcp_hash_size - 1)];
+  conn->hnext = *bucket;
+  *bucket     = conn;
+
+  if (++g_tcp_hash_count > g_tcp_hash_size * TCP_HASH_MAXLOAD &&
+      g_tcp_hash_size < CONFIG_NET_TCP_HASH_MAXSIZE &&
+      g_tcp_hash_count > g_tcp_hash_backoff &&
+      work_available(&g_tcp_hash_work))
+    {
+      /* The chains just get longer until the worker has run */
+
+      work_queue(LPWORK, &g_tcp_hash_work, tcp_hash_grow, NULL, 0);
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_hash_remove
+ *
+ * Description:
+ *   Remove a connection from the hash table (if it is there).
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+void tcp_hash_remove(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_conn_s **link;
+
+  link = &g_tcp_hash[tcp_hash_conn(conn) & (g_tcp_hash_size - 1)];
+  while (*link != NULL)
+    {
+      if (*link == conn)
+        {
+          *link       = conn->hnext;
+          conn->hnext = NULL;
+          g_tcp_hash_count--;
+          return;
+        }
+
+      link = &(*link)->hnext;
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_hash_lookup
+ *
+ * Description:
+ *   Find the active connection that matches the TCP/IP header in the
+ *   device buffer.  This is the hashed equivalent of scanning the list of
+ *   active connections.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+FAR struct tcp_conn_s *tcp_hash_lookup(FAR struct net_driver_s *dev,
+                                       FAR struct tcp_hdr_s *tcp)
+{
+  FAR struct tcp_conn_s *conn;
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (IFF_IS_IPv6(dev->d_flags))
+#endif
+    {
+      FAR struct ipv6_hdr_s *ip = IPv6BUF;
+      uint32_t hash = tcp_hash_ipv6(ip->srcipaddr, tcp->destport,
+                                    tcp->srcport);
+
+      for (conn = g_tcp_hash[hash & (g_tcp_hash_size - 1)];
+           conn != NULL; conn = conn->hnext)
+        {
+          if (conn->tcpstateflags != TCP_CLOSED &&
+              TCP_CONN_DOMAIN(conn) == PF_INET6 &&
+              tcp->destport == conn->lport &&
+              tcp->srcport  == conn->rport &&
+              (net_ipv6addr_cmp(conn->u.ipv6.laddr, g_ipv6_unspecaddr) ||
+               net_ipv6addr_cmp(ip->destipaddr, conn->u.ipv6.laddr)) &&
+              net_ipv6addr_cmp(ip->srcipaddr, conn->u.ipv6.raddr))
+            {
+              return conn;
+            }
+        }
+    }
+#endif /* CONFIG_NET_IPv6 */
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      FAR struct ipv4_hdr_s *ip = IPv4BUF;
+      in_addr_t srcipaddr  = net_ip4addr_conv32(ip->srcipaddr);
+      in_addr_t destipaddr = net_ip4addr_conv32(ip->destipaddr);
+      uint32_t hash = tcp_hash_ipv4(srcipaddr, tcp->destport,
+                                    tcp->srcport);
+
+      for (conn = g_tcp_hash[hash & (g_tcp_hash_size - 1)];
+           conn != NULL; conn = conn->hnext)
+        {
+          if (conn->tcpstateflags != TCP_CLOSED &&
+              TCP_CONN_DOMAIN(conn) == PF_INET &&
+              tcp->destport == conn->lport &&
+              tcp->srcport  == conn->rport &&
+              (net_ipv4addr_cmp(conn->u.ipv4.laddr, INADDR_ANY) ||
+               net_ipv4addr_cmp(destipaddr, conn->u.ipv4.laddr)) &&
+              net_ipv4addr_cmp(srcipaddr, conn->u.ipv4.raddr))
+            {
+              return conn;
+            }
+        }
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: tcp_hash_resize
+ *
+ * Description:
+ *   Re-distribute the active connections over a new table with 'nbuckets'
+ *   buckets.  Called from the growth worker.  It allocates from the heap
+ *   and takes the network lock, so it must not be called from the
+ *   packet path.
+ *
+ * Input Parameters:
+ *   nbuckets - The new number of buckets.  Must be a power of two.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.  The old table
+ *   remains in use on failure.
+ *
+ ****************************************************************************/
+
+int tcp_hash_resize(unsigned int nbuckets)
+{
+  FAR struct tcp_conn_s **newhash;
+  FAR struct tcp_conn_s **oldhash;
+  unsigned int oldsize;
+  unsigned int i;
+
+  if (nbuckets == 0 || (nbuckets & (nbuckets - 1)) != 0)
+    {
+      return -EINVAL;
+    }
+
+  if (nbuckets == CONFIG_NET_TCP_HASH_SIZE)
+    {
+      newhash = g_tcp_hash_init;
+    }
+  else
+    {
+      newhash = kmm_zalloc(nbuckets * sizeof(FAR struct tcp_conn_s *));
+      if (newhash == NULL)
+        {
+          return -ENOMEM;
+        }
+    }
+
+  net_lock();
+
+  oldhash = g_tcp_hash;
+  oldsize = g_tcp_hash_size;
+
+  if (newhash == oldhash)
+    {
+      net_unlock();
+      return OK;
+    }
+
+  if (newhash == g_tcp_hash_init)
+    {
+      memset(newhash, 0, sizeof(g_tcp_hash_init));
+    }
+
+  for (i = 0; i < oldsize; i++)
+    {
+      FAR struct tcp_conn_s *conn;
+
+      while ((conn = oldhash[i]) != NULL)
+        {
+          FAR struct tcp_conn_s **bucket;
+
+          oldhash[i]  = conn->hnext;
+          bucket      = &newhash[tcp_hash_conn(conn) & (nbuckets - 1)];
+          conn->hnext = *bucket;
+          *bucket     = conn;
+        }
+    }
+
+  g_tcp_hash      = newhash;
+  g_tcp_hash_size = nbuckets;
+
+  net_unlock();
+
+  if (oldhash != g_tcp_hash_init)
+    {
+      kmm_free(oldhash);
+    }
+
+  ninfo("TCP hash resized %u -> %u buckets\n", oldsize, nbuckets);
+  return OK;
+}
+
+#endif /* CONFIG_NET_TCP_HASH */
@@ -726,7 +726,7 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
 #ifdef CONFIG_NET_TCP_CHECKSUMS
   /* Start of TCP input header processing code. */
 
-  if (tcp_chksum(dev) != 0xffff)
+  if (!NETDEV_RXCSUM_VALID(dev) && tcp_chksum(dev) != 0xffff)
     {
       /* Compute and check the TCP checksum. */
 
@@ -1581,6 +1581,12 @@ found:
 
             result = tcp_callback(dev, conn, flags);
 
+#ifdef CONFIG_NET_TCP_AUTOTUNE
+            /* Grow the buffers to what the connection delivers */
+
+            tcp_autotune(conn, flags);
+#endif
+
             /* Send the response, ACKing the data or not, as appropriate */
 
             tcp_appsend(dev, conn, result);
@@ -57,13 +57,35 @@
 #include "inet/inet.h"
 #include "tcp/tcp.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_HASH
+#  if (CONFIG_NET_TCP_LISTEN_HASH_SIZE & \
+       (CONFIG_NET_TCP_LISTEN_HASH_SIZE - 1)) != 0
+#    error CONFIG_NET_TCP_LISTEN_HASH_SIZE must be a power of two
+#  endif
+
+#  define TCP_LISTEN_HASH(p) \
+     (NTOHS(p) & (CONFIG_NET_TCP_LISTEN_HASH_SIZE - 1))
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
+#ifdef CONFIG_NET_TCP_HASH
+/* The listening connections, hashed by local port number */
+
+static FAR struct tcp_conn_s *
+  g_tcp_listenhash[CONFIG_NET_TCP_LISTEN_HASH_SIZE];
+static unsigned int g_tcp_nlisteners;
+#else
 /* The tcp_listenports list all currently listening ports. */
 
 static FAR struct tcp_conn_s *tcp_listenports[CONFIG_NET_MAX_LISTENPORTS];
+#endif
 
 /****************************************************************************
  * Private Functions
@@ -89,17 +111,29 @@ FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
                                         uint16_t portno)
 #endif
 {
+#ifdef CONFIG_NET_TCP_HASH
+  FAR struct tcp_conn_s *conn;
+
+  /* Examine each listener that hashes to the same bucket */
+
+  for (conn = g_tcp_listenhash[TCP_LISTEN_HASH(portno)];
+       conn != NULL;
+       conn = conn->lnext)
+#else
   int ndx;
 
   /* Examine each connection structure in each slot of the listener list */
 
   for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
+#endif
     {
+#ifndef CONFIG_NET_TCP_HASH
       /* Is this slot assigned?  If so, does the connection have the same
        * local port number?
        */
 
       FAR struct tcp_conn_s *conn = tcp_listenports[ndx];
+#endif
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
       if (conn && conn->lport == portno && conn->domain == domain)
 #else
@@ -160,10 +194,29 @@ FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
 
 int tcp_unlisten(FAR struct tcp_conn_s *conn)
 {
+#ifdef CONFIG_NET_TCP_HASH
+  FAR struct tcp_conn_s **link;
+#else
   int ndx;
+#endif
   int ret = -EINVAL;
 
   net_lock();
+#ifdef CONFIG_NET_TCP_HASH
+  for (link = &g_tcp_listenhash[TCP_LISTEN_HASH(conn->lport)];
+       *link != NULL;
+       link = &(*link)->lnext)
+    {
+      if (*link == conn)
+        {
+          *link       = conn->lnext;
+          conn->lnext = NULL;
+          g_tcp_nlisteners--;
+          ret = OK;
+          break;
+        }
+    }
+#else
   for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
     {
       if (tcp_listenports[ndx] == conn)
@@ -173,6 +226,7 @@ int tcp_unlisten(FAR struct tcp_conn_s *conn)
           break;
         }
     }
+#endif
 
   net_unlock();
   return ret;
@@ -191,7 +245,9 @@ int tcp_unlisten(FAR struct tcp_conn_s *conn)
 
 int tcp_listen(FAR struct tcp_conn_s *conn)
 {
+#ifndef CONFIG_NET_TCP_HASH
   int ndx;
+#endif
   int ret;
 
   /* This must be done with network locked because the listener table
@@ -220,6 +276,18 @@ int tcp_listen(FAR struct tcp_conn_s *conn)
 
       ret = -ENOBUFS; /* Assume failure */
 
+#ifdef CONFIG_NET_TCP_HASH
+      if (g_tcp_nlisteners < CONFIG_NET_MAX_LISTENPORTS)
+        {
+          FAR struct tcp_conn_s **bucket =
+            &g_tcp_listenhash[TCP_LISTEN_HASH(conn->lport)];
+
+          conn->lnext = *bucket;
+          *bucket     = conn;
+          g_tcp_nlisteners++;
+          ret = OK;
+        }
+#else
       /* Search all slots until an available slot is found */
 
       for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
@@ -235,6 +303,7 @@ int tcp_listen(FAR struct tcp_conn_s *conn)
               break;
             }
         }
+#endif
     }
 
   net_unlock();
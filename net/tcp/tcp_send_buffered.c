@@ -248,6 +248,42 @@ static void retransmit_segment(FAR struct tcp_conn_s *conn,
     }
 }
 
+/****************************************************************************
+ * Name: tcp_gso_maxlen
+ *
+ * Description:
+ *   Return the largest amount of data that may go into the next packet:
+ *   one MSS, or several of them if the device does segmentation offload
+ *   and we are being polled to send.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_GSO
+static uint32_t tcp_gso_maxlen(FAR struct net_driver_s *dev,
+                               FAR struct tcp_conn_s *conn, uint16_t flags)
+{
+  uint32_t maxlen = conn->mss;
+  uint32_t limit;
+
+  if ((flags & TCP_POLL) != 0 && dev->d_gso_maxsegs > 1)
+    {
+      maxlen *= dev->d_gso_maxsegs;
+
+      /* The whole packet must still fit into d_len */
+
+      limit = UINT16_MAX - NET_LL_HDRLEN(dev) - tcpip_hdrsize(conn);
+      if (maxlen > limit)
+        {
+          maxlen = limit - limit % conn->mss;
+        }
+    }
+
+  return maxlen;
+}
+#else
+#  define tcp_gso_maxlen(dev, conn, flags) ((conn)->mss)
+#endif
+
 /****************************************************************************
  * Name: psock_lost_connection
  *
@@ -1032,9 +1068,9 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
           int ret;
 
           sndlen = TCP_WBPKTLEN(wrb) - TCP_WBSENT(wrb);
-          if (sndlen > conn->mss)
+          if (sndlen > tcp_gso_maxlen(dev, conn, flags))
             {
-              sndlen = conn->mss;
+              sndlen = tcp_gso_maxlen(dev, conn, flags);
             }
 
           remaining_snd_wnd = TCP_SEQ_SUB(snd_wnd_edge, seq);
@@ -1098,10 +1134,21 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
             }
 #endif
 
+#ifdef CONFIG_NETDEV_GSO
+          /* Tell the driver to cut a packet with more than one MSS of
+           * data into MSS sized segments.
+           */
+
+          dev->d_gso_size = sndlen > conn->mss ? conn->mss : 0;
+#endif
+
           ret = devif_iob_send(dev, TCP_WBIOB(wrb), sndlen,
                                TCP_WBSENT(wrb), tcpip_hdrsize(conn));
           if (ret <= 0)
             {
+#ifdef CONFIG_NETDEV_GSO
+              dev->d_gso_size = 0;
+#endif
               return flags;
             }
 
@@ -45,6 +45,7 @@
 #include <nuttx/sched.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/tcp.h>
@@ -75,6 +76,9 @@ struct sendfile_s
   FAR struct file   *snd_file;             /* File structure of the input file */
   sem_t              snd_sem;              /* Used to wake up the waiting thread */
   off_t              snd_foffset;          /* Input file offset */
+#ifdef CONFIG_NET_SENDFILE_ZEROCOPY
+  FAR const uint8_t *snd_xip;              /* Data at snd_foffset, or NULL */
+#endif
   size_t             snd_flen;             /* File length */
   ssize_t            snd_sent;             /* The number of bytes sent */
   uint32_t           snd_isn;              /* Initial sequence number */
@@ -96,6 +100,67 @@ struct sendfile_s
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: sendfile_xip
+ *
+ * Description:
+ *   Find the file data in memory, if the file system can tell where it is,
+ *   and limit 'count' to the end of the file.
+ *
+ * Returned Value:
+ *   The address of the data at 'offset', or NULL if the file has to be
+ *   read.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SENDFILE_ZEROCOPY
+static FAR const uint8_t *sendfile_xip(FAR struct file *infile,
+                                       off_t offset, FAR size_t *count)
+{
+  struct stat buf;
+  uintptr_t xipbase;
+
+  if (file_ioctl(infile, FIOC_XIPBASE, (unsigned long)&xipbase) < 0 ||
+      file_fstat(infile, &buf) < 0 || offset > buf.st_size)
+    {
+      return NULL;
+    }
+
+  if (*count > buf.st_size - offset)
+    {
+      *count = buf.st_size - offset;
+    }
+
+  return (FAR const uint8_t *)xipbase + offset;
+}
+#endif
+
+/****************************************************************************
+ * Name: sendfile_data
+ *
+ * Description:
+ *   Set up 'sndlen' bytes from 'pos' bytes into the transfer for sending.
+ *
+ ****************************************************************************/
+
+static int sendfile_data(FAR struct net_driver_s *dev,
+                         FAR struct sendfile_s *pstate,
+                         uint32_t sndlen, uint32_t pos)
+{
+  FAR struct tcp_conn_s *conn = pstate->snd_conn;
+
+#ifdef CONFIG_NET_SENDFILE_ZEROCOPY
+  if (pstate->snd_xip != NULL)
+    {
+      return devif_xip_send(dev, pstate->snd_xip + pos, sndlen,
+                            tcpip_hdrsize(conn));
+    }
+#endif
+
+  return devif_file_send(dev, pstate->snd_file, sndlen,
+                         pstate->snd_foffset + pos, tcpip_hdrsize(conn));
+}
+
 /****************************************************************************
  * Name: sendfile_eventhandler
  *
@@ -269,9 +334,7 @@ static uint16_t sendfile_eventhandler(FAR struct net_driver_s *dev,
        * happen until the polling cycle completes).
        */
 
-      ret = devif_file_send(dev, pstate->snd_file, sndlen,
-                            pstate->snd_foffset + pstate->snd_acked,
-                            tcpip_hdrsize(conn));
+      ret = sendfile_data(dev, pstate, sndlen, pstate->snd_acked);
       if (ret < 0)
         {
           nerr("ERROR: Failed to read from input file: %d\n", (int)ret);
@@ -340,9 +403,7 @@ static uint16_t sendfile_eventhandler(FAR struct net_driver_s *dev,
            * happen until the polling cycle completes).
            */
 
-          ret = devif_file_send(dev, pstate->snd_file, sndlen,
-                                pstate->snd_foffset + pstate->snd_sent,
-                                tcpip_hdrsize(conn));
+          ret = sendfile_data(dev, pstate, sndlen, pstate->snd_sent);
           if (ret < 0)
             {
               nerr("ERROR: Failed to read from input file: %d\n", (int)ret);
@@ -418,6 +479,9 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
 {
   FAR struct tcp_conn_s *conn;
   struct sendfile_s state;
+#ifdef CONFIG_NET_SENDFILE_ZEROCOPY
+  FAR const uint8_t *xip;
+#endif
   off_t startpos;
   int ret = OK;
 
@@ -470,6 +534,16 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
       return startpos;
     }
 
+#ifdef CONFIG_NET_SENDFILE_ZEROCOPY
+  /* Send straight from memory if the file system allows */
+
+  xip = sendfile_xip(infile, offset ? *offset : startpos, &count);
+  if (xip != NULL && count == 0)
+    {
+      return 0;
+    }
+#endif
+
   /* Initialize the state structure.  This is done with the network
    * locked because we don't want anything to happen until we are
    * ready.
@@ -486,6 +560,9 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
   state.snd_foffset = offset ? *offset : startpos; /* Input file offset */
   state.snd_flen    = count;                       /* Number of bytes to send */
   state.snd_file    = infile;                      /* File to read from */
+#ifdef CONFIG_NET_SENDFILE_ZEROCOPY
+  state.snd_xip     = xip;                         /* Or the data itself */
+#endif
 
   /* Allocate resources to receive a callback */
 
@@ -545,6 +622,15 @@ errout_locked:
 #endif
   net_unlock();
 
+#ifdef CONFIG_NET_SENDFILE_ZEROCOPY
+  /* Nothing was read, so move the file position past the data sent */
+
+  if (xip != NULL && state.snd_sent > 0)
+    {
+      file_seek(infile, state.snd_foffset + state.snd_sent, SEEK_SET);
+    }
+#endif
+
   /* Return the current file position */
 
   if (offset)
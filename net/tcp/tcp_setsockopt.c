@@ -232,6 +232,23 @@ int tcp_setsockopt(FAR struct socket *psock, int option,
           }
         break;
 
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+      case TCP_QUICKACK: /* Don't delay the ACKs */
+        if (value_len != sizeof(int))
+          {
+            ret = -EDOM;
+          }
+        else if (*(FAR int *)value != 0)
+          {
+            conn->flags |= TCP_QUICKACK_ON;
+          }
+        else
+          {
+            conn->flags &= ~TCP_QUICKACK_ON;
+          }
+        break;
+#endif /* CONFIG_NET_TCP_DELAYED_ACK */
+
       case TCP_MAXSEG: /* The maximum segment size */
         if (value_len != sizeof(int))
           {
@@ -119,6 +119,10 @@ struct udp_conn_s
   uint8_t  domain;        /* IP domain: PF_INET or PF_INET6 */
   uint8_t  crefs;         /* Reference counts on this instance */
 
+#ifdef CONFIG_NET_UDP_HASH
+  FAR struct udp_conn_s *hnext; /* Next in the local port hash bucket */
+#endif
+
 #if CONFIG_NET_RECV_BUFSIZE > 0
   int32_t  rcvbufs;       /* Maximum amount of bytes queued in recv */
 #endif
@@ -257,6 +261,37 @@ FAR struct udp_conn_s *udp_active(FAR struct net_driver_s *dev,
 
 FAR struct udp_conn_s *udp_nextconn(FAR struct udp_conn_s *conn);
 
+/****************************************************************************
+ * Name: udp_setlport
+ *
+ * Description:
+ *   Assign the local port number (network byte order) of a connection.
+ *   All changes of conn->lport must go through this function so that the
+ *   port hash stays consistent.
+ *
+ ****************************************************************************/
+
+void udp_setlport(FAR struct udp_conn_s *conn, uint16_t portno);
+
+/****************************************************************************
+ * Name: udp_reuseport_select
+ *
+ * Description:
+ *   Select the member of a SO_REUSEPORT group that receives the datagram
+ *   in the device buffer.  'conn' is the first matching connection as
+ *   returned by udp_active().
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SOCKOPTS
+FAR struct udp_conn_s *udp_reuseport_select(FAR struct net_driver_s *dev,
+                                            FAR struct udp_conn_s *conn,
+                                            FAR struct udp_hdr_s *udp);
+#endif
+
 /****************************************************************************
  * Name: udp_select_port
  *
@@ -74,6 +74,18 @@
 #include "udp/udp.h"
 #include "utils/utils.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_HASH
+#  if (CONFIG_NET_UDP_HASH_SIZE & (CONFIG_NET_UDP_HASH_SIZE - 1)) != 0
+#    error CONFIG_NET_UDP_HASH_SIZE must be a power of two
+#  endif
+
+#  define UDP_HASH(p) (NTOHS(p) & (CONFIG_NET_UDP_HASH_SIZE - 1))
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -93,10 +105,112 @@ static mutex_t g_free_lock = NXMUTEX_INITIALIZER;
 
 static dq_queue_t g_active_udp_connections;
 
+#ifdef CONFIG_NET_UDP_HASH
+/* The bound connections, hashed by local port number.  Protected by the
+ * same lock as the connection lists.
+ */
+
+static FAR struct udp_conn_s *g_udp_hash[CONFIG_NET_UDP_HASH_SIZE];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: udp_active_first / udp_active_next
+ *
+ * Description:
+ *   Iterate over the connections that may receive a datagram for the local
+ *   port 'portno'.  With CONFIG_NET_UDP_HASH only the hash bucket of the
+ *   port is visited, otherwise all active connections.
+ *
+ ****************************************************************************/
+
+static inline FAR struct udp_conn_s *
+udp_active_first(FAR struct udp_conn_s *conn, uint16_t portno)
+{
+#ifdef CONFIG_NET_UDP_HASH
+  return conn != NULL ? conn->hnext : g_udp_hash[UDP_HASH(portno)];
+#else
+  return udp_nextconn(conn);
+#endif
+}
+
+static inline FAR struct udp_conn_s *
+udp_active_next(FAR struct udp_conn_s *conn)
+{
+#ifdef CONFIG_NET_UDP_HASH
+  return conn->hnext;
+#else
+  return (FAR struct udp_conn_s *)conn->sconn.node.flink;
+#endif
+}
+
+#ifdef CONFIG_NET_UDP_HASH
+/****************************************************************************
+ * Name: udp_hash_remove
+ *
+ * Description:
+ *   Remove a connection from the port hash, if it is bound.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static void udp_hash_remove(FAR struct udp_conn_s *conn)
+{
+  FAR struct udp_conn_s **link;
+
+  if (conn->lport == 0)
+    {
+      return;
+    }
+
+  for (link = &g_udp_hash[UDP_HASH(conn->lport)];
+       *link != NULL;
+       link = &(*link)->hnext)
+    {
+      if (*link == conn)
+        {
+          *link       = conn->hnext;
+          conn->hnext = NULL;
+          break;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: udp_hash_insert
+ *
+ * Description:
+ *   Append a bound connection to its port hash bucket.  Appending keeps
+ *   the first-bound-first-matched order of the plain list.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static void udp_hash_insert(FAR struct udp_conn_s *conn)
+{
+  FAR struct udp_conn_s **link;
+
+  if (conn->lport == 0)
+    {
+      return;
+    }
+
+  for (link = &g_udp_hash[UDP_HASH(conn->lport)];
+       *link != NULL;
+       link = &(*link)->hnext);
+
+  conn->hnext = NULL;
+  *link       = conn;
+}
+#endif /* CONFIG_NET_UDP_HASH */
+
 /****************************************************************************
  * Name: udp_find_conn()
  *
@@ -109,6 +223,7 @@ static dq_queue_t g_active_udp_connections;
  *   portno - The port to use in the lookup
  *   opt    - The option from another conn to match the conflict conn
  *              SO_REUSEADDR: If both sockets have this, they never confilct.
+ *              SO_REUSEPORT: Likewise.
  *
  * Assumptions:
  *   This function must be called with the network locked.
@@ -122,6 +237,7 @@ static FAR struct udp_conn_s *udp_find_conn(uint8_t domain,
   FAR struct udp_conn_s *conn = NULL;
 #ifdef CONFIG_NET_SOCKOPTS
   bool skip_reusable = _SO_GETOPT(opt, SO_REUSEADDR);
+  bool skip_reuseport = _SO_GETOPT(opt, SO_REUSEPORT);
 #endif
 
   /* Now search each connection structure. */
@@ -137,6 +253,15 @@ static FAR struct udp_conn_s *udp_find_conn(uint8_t domain,
         {
           continue;
         }
+
+      /* The same holds for SO_REUSEPORT; such sockets share the incoming
+       * datagrams, see udp_reuseport_select().
+       */
+
+      if (skip_reuseport && _SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT))
+        {
+          continue;
+        }
 #endif
 
       /* If the port local port number assigned to the connections matches
@@ -199,7 +324,7 @@ udp_ipv4_active(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
 #endif
   FAR struct ipv4_hdr_s *ip = IPv4BUF;
 
-  conn = udp_nextconn(conn);
+  conn = udp_active_first(conn, udp->destport);
 
   while (conn)
     {
@@ -313,7 +438,7 @@ udp_ipv4_active(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
 
       /* Look at the next active connection */
 
-      conn = (FAR struct udp_conn_s *)conn->sconn.node.flink;
+      conn = udp_active_next(conn);
     }
 
   return conn;
@@ -339,7 +464,7 @@ udp_ipv6_active(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
 {
   FAR struct ipv6_hdr_s *ip = IPv6BUF;
 
-  conn = udp_nextconn(conn);
+  conn = udp_active_first(conn, udp->destport);
 
   while (conn != NULL)
     {
@@ -453,7 +578,7 @@ udp_ipv6_active(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
 
       /* Look at the next active connection */
 
-      conn = (FAR struct udp_conn_s *)conn->sconn.node.flink;
+      conn = udp_active_next(conn);
     }
 
   return conn;
@@ -486,8 +611,8 @@ static FAR struct udp_conn_s *udp_alloc_conn(void)
         }
 #endif
 
-      conn = kmm_zalloc(sizeof(struct udp_conn_s) *
-                        CONFIG_NET_UDP_ALLOC_CONNS);
+      conn = net_conn_zalloc(sizeof(struct udp_conn_s) *
+                             CONFIG_NET_UDP_ALLOC_CONNS);
       if (conn == NULL)
         {
           return conn;
@@ -685,6 +810,11 @@ void udp_free(FAR struct udp_conn_s *conn)
   DEBUGASSERT(conn->crefs == 0);
 
   nxmutex_lock(&g_free_lock);
+
+#ifdef CONFIG_NET_UDP_HASH
+  udp_hash_remove(conn);
+#endif
+
   conn->lport = 0;
 
   /* Remove the connection from the active list */
@@ -721,7 +851,7 @@ void udp_free(FAR struct udp_conn_s *conn)
   if (conn < g_udp_connections || conn >= (g_udp_connections +
       CONFIG_NET_UDP_PREALLOC_CONNS))
     {
-      kmm_free(conn);
+      net_conn_free(conn);
     }
   else
 #endif
@@ -754,7 +884,7 @@ FAR struct udp_conn_s *udp_active(FAR struct net_driver_s *dev,
   if (IFF_IS_IPv6(dev->d_flags))
 #endif
     {
-      return udp_ipv6_active(dev, conn, udp);
+      conn = udp_ipv6_active(dev, conn, udp);
     }
 #endif /* CONFIG_NET_IPv6 */
 
@@ -763,9 +893,11 @@ FAR struct udp_conn_s *udp_active(FAR struct net_driver_s *dev,
   else
 #endif
     {
-      return udp_ipv4_active(dev, conn, udp);
+      conn = udp_ipv4_active(dev, conn, udp);
     }
 #endif /* CONFIG_NET_IPv4 */
+
+  return conn;
 }
 
 /****************************************************************************
@@ -791,6 +923,129 @@ FAR struct udp_conn_s *udp_nextconn(FAR struct udp_conn_s *conn)
     }
 }
 
+/****************************************************************************
+ * Name: udp_setlport
+ *
+ * Description:
+ *   Assign the local port number (network byte order) of a connection,
+ *   keeping the port hash up to date.  A port number of zero unbinds it.
+ *
+ ****************************************************************************/
+
+void udp_setlport(FAR struct udp_conn_s *conn, uint16_t portno)
+{
+  net_lock();
+
+#ifdef CONFIG_NET_UDP_HASH
+  udp_hash_remove(conn);
+#endif
+
+  conn->lport = portno;
+
+#ifdef CONFIG_NET_UDP_HASH
+  udp_hash_insert(conn);
+#endif
+
+  net_unlock();
+}
+
+#ifdef CONFIG_NET_SOCKOPTS
+/****************************************************************************
+ * Name: udp_reuseport_select
+ *
+ * Description:
+ *   If 'conn', the first connection that matches the received datagram,
+ *   is part of a SO_REUSEPORT group, pick the member of the group that
+ *   receives it.  The choice is a hash of the source address and port, so
+ *   all datagrams of a flow go to the same socket while different flows
+ *   are spread over all members.
+ *
+ * Input Parameters:
+ *   dev  - The device with the received datagram in its buffer.
+ *   conn - The first matching connection as returned by udp_active().
+ *   udp  - The UDP header of the datagram.
+ *
+ * Returned Value:
+ *   The connection that should receive the datagram.
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+FAR struct udp_conn_s *udp_reuseport_select(FAR struct net_driver_s *dev,
+                                            FAR struct udp_conn_s *conn,
+                                            FAR struct udp_hdr_s *udp)
+{
+  FAR struct udp_conn_s *member;
+  unsigned int nmembers = 0;
+  uint32_t hash;
+
+  if (!_SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT))
+    {
+      return conn;
+    }
+
+  for (member = conn; member != NULL;
+       member = udp_active(dev, member, udp))
+    {
+      if (_SO_GETOPT(member->sconn.s_options, SO_REUSEPORT))
+        {
+          nmembers++;
+        }
+    }
+
+  if (nmembers <= 1)
+    {
+      return conn;
+    }
+
+  hash = udp->srcport;
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (IFF_IS_IPv6(dev->d_flags))
+#endif
+    {
+      FAR struct ipv6_hdr_s *ip = IPv6BUF;
+      int i;
+
+      for (i = 0; i < 8; i++)
+        {
+          hash = hash * 31 + ip->srcipaddr[i];
+        }
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      FAR struct ipv4_hdr_s *ip = IPv4BUF;
+
+      hash ^= net_ip4addr_conv32(ip->srcipaddr);
+    }
+#endif
+
+  hash ^= hash >> 16;
+  hash *= 0x45d9f3b;
+  hash ^= hash >> 16;
+  hash %= nmembers;
+
+  for (member = conn; member != NULL;
+       member = udp_active(dev, member, udp))
+    {
+      if (_SO_GETOPT(member->sconn.s_options, SO_REUSEPORT) && hash-- == 0)
+        {
+          return member;
+        }
+    }
+
+  return conn;
+}
+#endif /* CONFIG_NET_SOCKOPTS */
+
 /****************************************************************************
  * Name: udp_bind
  *
@@ -928,7 +1183,7 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
         }
       else
         {
-          conn->lport = portno;
+          udp_setlport(conn, portno);
           ret         = OK;
         }
     }
@@ -953,7 +1208,7 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
         {
           /* No.. then bind the socket to the port */
 
-          conn->lport = portno;
+          udp_setlport(conn, portno);
           ret         = OK;
         }
       else
@@ -1005,7 +1260,7 @@ int udp_connect(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
        * connection structure.
        */
 
-      conn->lport = HTONS(udp_select_port(conn->domain, &conn->u));
+      udp_setlport(conn, HTONS(udp_select_port(conn->domain, &conn->u)));
       if (!conn->lport)
         {
           nerr("ERROR: Failed to get a local port!\n");
@@ -245,7 +245,7 @@ static int udp_input(FAR struct net_driver_s *dev, unsigned int iplen)
   dev->d_appdata = IPBUF(udpiplen);
 
 #ifdef CONFIG_NET_UDP_CHECKSUMS
-  chksum = udp->udpchksum;
+  chksum = NETDEV_RXCSUM_VALID(dev) ? 0 : udp->udpchksum;
   if (chksum != 0)
     {
 #ifdef CONFIG_NET_IPv6
@@ -326,6 +326,19 @@ static int udp_input(FAR struct net_driver_s *dev, unsigned int iplen)
             }
 #endif
 
+#ifdef CONFIG_NET_SOCKOPTS
+          /* A unicast datagram is delivered to only one member of a
+           * SO_REUSEPORT group.
+           */
+
+#ifdef CONFIG_NET_BROADCAST
+          if (!udp_is_broadcast(dev))
+#endif
+            {
+              conn = udp_reuseport_select(dev, conn, udp);
+            }
+#endif
+
           /* We can deliver the packet directly to the last listener. */
 
           ret = udp_input_conn(dev, conn, udpiplen);
@@ -27,12 +27,120 @@
 #include <nuttx/config.h>
 #ifdef CONFIG_NET
 
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/mm/iob.h>
+
+#include "devif/devif.h"
 #include "utils/utils.h"
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: chksum_fold
+ *
+ * Description:
+ *   Fold a 64-bit sum of native order 32-bit words into a 16-bit sum of
+ *   big endian words.
+ *
+ ****************************************************************************/
+
+static inline uint32_t chksum_fold(uint64_t acc)
+{
+  acc = (acc >> 32) + (acc & 0xffffffff);
+  acc = (acc >> 32) + (acc & 0xffffffff);
+  acc = (acc >> 16) + (acc & 0xffff);
+  acc = (acc >> 16) + (acc & 0xffff);
+  acc = (acc >> 16) + (acc & 0xffff);
+
+#ifndef CONFIG_ENDIAN_BIG
+  acc = ((acc & 0xff) << 8) | (acc >> 8);
+#endif
+
+  return (uint32_t)acc;
+}
+
+/****************************************************************************
+ * Name: chksum_tail
+ *
+ * Description:
+ *   Add the last (up to three) bytes and the carried in sum to a folded
+ *   sum.  A trailing odd byte is the upper half of a word.
+ *
+ ****************************************************************************/
+
+static inline uint16_t chksum_tail(uint32_t acc, uint16_t sum,
+                                   FAR const uint8_t *data, uint16_t len)
+{
+  if (len >= 2)
+    {
+      acc  += ((uint16_t)data[0] << 8) + data[1];
+      data += 2;
+      len  -= 2;
+    }
+
+  if (len > 0)
+    {
+      acc += (uint16_t)data[0] << 8;
+    }
+
+  acc += sum;
+  acc  = (acc >> 16) + (acc & 0xffff);
+  acc  = (acc >> 16) + (acc & 0xffff);
+  return (uint16_t)acc;
+}
+
+/****************************************************************************
+ * Name: chksum_block
+ *
+ * Description:
+ *   Add the 16-bit big endian words of a buffer to the checksum.  This is
+ *   replaced by up_chksum() if the architecture provides it.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_NET_ARCH_CHKSUM
+#ifndef CONFIG_ARCH_HAVE_CHKSUM
+static uint16_t chksum_block(uint16_t sum, FAR const uint8_t *data,
+                             uint16_t len)
+{
+  uint64_t acc = 0;
+  uint32_t w[4];
+
+  /* Add up the data 32 bits at a time in the native byte order, which
+   * works on either byte order since ones complement addition commutes
+   * with byte swapping (RFC 1071).  memcpy() keeps the loads legal for
+   * any alignment and the compiler turns it into plain word loads where
+   * possible.
+   */
+
+  while (len >= 16)
+    {
+      memcpy(w, data, 16);
+      acc += (uint64_t)w[0] + w[1] + w[2] + w[3];
+      data += 16;
+      len  -= 16;
+    }
+
+  while (len >= 4)
+    {
+      memcpy(w, data, 4);
+      acc  += w[0];
+      data += 4;
+      len  -= 4;
+    }
+
+  return chksum_tail(chksum_fold(acc), sum, data, len);
+}
+#else
+#  define chksum_block(s, d, l) up_chksum(s, d, l)
+#endif
+
 /****************************************************************************
  * Name: checksum
  *
@@ -53,60 +161,33 @@
  *
  ****************************************************************************/
 
-#ifndef CONFIG_NET_ARCH_CHKSUM
 uint16_t checksum(uint16_t sum, FAR const uint8_t *data,
-                    uint16_t len, bool *odd)
+                  uint16_t len, FAR bool *odd)
 {
-  FAR const uint8_t *dataptr;
-  FAR const uint8_t *last_byte;
-  uint16_t t;
-
-  dataptr = data;
-  last_byte = data + len - 1;
-
-  if (*odd == true)
+  if (len == 0)
     {
-      t = dataptr[0];
-      sum += t;
-      if (sum < t)
-        {
-          sum++; /* carry */
-        }
-
-      dataptr += 1;
-    }
-
-  while (dataptr < last_byte)
-    {
-      /* At least two more bytes */
-
-      t = ((uint16_t)dataptr[0] << 8) + dataptr[1];
-      sum += t;
-      if (sum < t)
-        {
-          sum++; /* carry */
-        }
-
-      dataptr += 2;
+      return sum;
     }
 
-  *odd = false;
+  /* The first byte completes the word started by the previous call */
 
-  if (dataptr == last_byte)
+  if (*odd)
     {
-      t = (dataptr[0] << 8) + 0;
-      sum += t;
-      if (sum < t)
+      sum += data[0];
+      if (sum < data[0])
         {
           sum++; /* carry */
         }
 
-      *odd = true;
+      data++;
+      len--;
     }
 
+  *odd = (len & 1) != 0;
+
   /* Return sum in host byte order. */
 
-  return sum;
+  return chksum_block(sum, data, len);
 }
 
 /****************************************************************************
@@ -254,6 +335,29 @@ uint16_t net_chksum_iob(uint16_t sum, FAR struct iob_s *iob, uint16_t offset)
 }
 #endif /* CONFIG_MM_IOB */
 
+/****************************************************************************
+ * Name: net_chksum_offload
+ *
+ * Description:
+ *   Check if the TCP/UDP checksum of the packet in the device buffer is to
+ *   be filled in by the hardware, or by the driver after GSO segmentation.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NETDEV_CHKSUM_OFFLOAD) || defined(CONFIG_NETDEV_GSO)
+bool net_chksum_offload(FAR struct net_driver_s *dev)
+{
+  /* Every segment of a GSO packet gets its own checksum */
+
+  if (NETDEV_GSO_SIZE(dev) > 0)
+    {
+      return true;
+    }
+
+  return NETDEV_TXCSUM(dev) && dev->d_len <= devif_get_mtu(dev);
+}
+#endif
+
 /****************************************************************************
  * Name: net_chksum_adjust
  *
@@ -73,6 +73,18 @@
       (nport) = HTONS(hport); \
     } while (0)
 
+/* Allocation of the dynamically allocated connection structures, which
+ * are looked up for every packet, optionally from fast memory.
+ */
+
+#ifdef CONFIG_MM_HEAP_ATTR_CONN
+#  define net_conn_zalloc(s) kmm_zalloc_attr(MM_ATTR_FAST, MM_NODE_ANY, s)
+#  define net_conn_free(p)   kmm_free_attr(p)
+#else
+#  define net_conn_zalloc(s) kmm_zalloc(s)
+#  define net_conn_free(p)   kmm_free(p)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -357,6 +369,23 @@ void net_chksum_adjust(FAR uint16_t *chksum,
                        FAR const uint16_t *optr, ssize_t olen,
                        FAR const uint16_t *nptr, ssize_t nlen);
 
+/****************************************************************************
+ * Name: net_chksum_offload
+ *
+ * Description:
+ *   Check if the TCP/UDP checksum of the packet in the device buffer is to
+ *   be filled in by the hardware, or by the driver after GSO segmentation.
+ *   If so, the checksum field must be left zero.  Packets that will be
+ *   fragmented are always checksummed in software.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NETDEV_CHKSUM_OFFLOAD) || defined(CONFIG_NETDEV_GSO)
+bool net_chksum_offload(FAR struct net_driver_s *dev);
+#else
+#  define net_chksum_offload(dev) false
+#endif
+
 /****************************************************************************
  * Name: tcp_chksum, tcp_ipv4_chksum, and tcp_ipv6_chksum
  *
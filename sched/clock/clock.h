@@ -81,6 +81,12 @@ void clock_timer(void);
 #  define clock_timer()
 #endif
 
+#ifdef CONFIG_CLOCK_USERSPACE
+void clock_user_update(void);
+#else
+#  define clock_user_update()
+#endif
+
 /****************************************************************************
  * perf_init
  ****************************************************************************/
@@ -171,6 +171,7 @@ void nxclock_gettime(clockid_t clock_id, FAR struct timespec *tp)
  *
  ****************************************************************************/
 
+#ifndef CONFIG_CLOCK_USERSPACE
 int clock_gettime(clockid_t clock_id, FAR struct timespec *tp)
 {
   if (tp == NULL || clock_id < 0 || clock_id > CLOCK_BOOTTIME)
@@ -182,3 +183,4 @@ int clock_gettime(clockid_t clock_id, FAR struct timespec *tp)
   nxclock_gettime(clock_id, tp);
   return OK;
 }
+#endif
@@ -184,6 +184,8 @@ static void clock_inittime(FAR const struct timespec *tp)
       g_basetime.tv_nsec += NSEC_PER_SEC;
       g_basetime.tv_sec--;
     }
+
+  clock_user_update();
 #else
   clock_inittimekeeping(tp);
 #endif
@@ -230,6 +232,7 @@ void clock_initialize(void)
 #endif
 
   perf_init();
+  clock_user_update();
 
 #ifdef CONFIG_SCHED_CPULOAD_SYSCLK
   cpuload_init();
@@ -376,6 +379,7 @@ void clock_resynchronize(FAR struct timespec *rtc_diff)
 
       g_system_ticks += SEC2TICK(rtc_diff->tv_sec);
       g_system_ticks += NSEC2TICK(rtc_diff->tv_nsec);
+      clock_user_update();
     }
 
 skip:
@@ -399,5 +403,6 @@ void clock_timer(void)
   /* Increment the per-tick system counter */
 
   g_system_ticks++;
+  clock_user_update();
 }
 #endif
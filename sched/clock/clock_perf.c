@@ -95,9 +95,13 @@ clock_t perf_gettime(void)
 {
   FAR struct perf_s *perf = &g_perf;
   clock_t now = up_perf_gettime();
-  irqstate_t flags = spin_lock_irqsave(&perf->lock);
+  irqstate_t flags;
   clock_t result;
 
+  /* The spinlock instrumentation takes the time itself */
+
+  flags = spin_lock_irqsave_wo_note(&perf->lock);
+
   /* Check if overflow */
 
   if (now < perf->last)
@@ -107,7 +111,7 @@ clock_t perf_gettime(void)
 
   perf->last = now;
   result = (clock_t)now | (clock_t)perf->overflow << 32;
-  spin_unlock_irqrestore(&perf->lock, flags);
+  spin_unlock_irqrestore_wo_note(&perf->lock, flags);
   return result;
 }
 
@@ -79,6 +79,7 @@ void nxclock_settime(clockid_t clock_id, FAR const struct timespec *tp)
 
   clock_systime_timespec(&bias);
   clock_timespec_subtract(tp, &bias, &g_basetime);
+  clock_user_update();
 
   leave_critical_section(flags);
 
@@ -0,0 +1,78 @@
+/****************************************************************************
+ * sched/clock/clock_user.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <nuttx/atomic.h>
+#include <nuttx/clock.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/userspace.h>
+
+#include "clock/clock.h"
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static spinlock_t g_clock_user_lock = SP_UNLOCKED;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: clock_user_update
+ *
+ * Description:
+ *   Publish the system timer ticks and the time of day base to the user
+ *   space.  It is called at every tick and whenever the base changes.
+ *
+ ****************************************************************************/
+
+void clock_user_update(void)
+{
+  FAR struct clock_user_s *user = USERSPACE->us_clock;
+  irqstate_t flags;
+
+  if (user == NULL)
+    {
+      return;
+    }
+
+  flags = spin_lock_irqsave(&g_clock_user_lock);
+
+  user->seq++;
+  atomic_thread_fence(memory_order_release);
+
+  user->ticks     = g_system_ticks;
+  user->base_sec  = g_basetime.tv_sec;
+  user->base_nsec = g_basetime.tv_nsec;
+
+  atomic_thread_fence(memory_order_release);
+  user->seq++;
+
+  spin_unlock_irqrestore(&g_clock_user_lock, flags);
+}
@@ -65,6 +65,9 @@
 
 int env_dup(FAR struct task_group_s *group, FAR char * const *envcp)
 {
+#ifdef CONFIG_SCHED_ENVIRON_SHARED
+  FAR struct task_group_s *parent;
+#endif
   FAR char **envp = NULL;
   irqstate_t flags;
   size_t envc = 0;
@@ -83,6 +86,25 @@ int env_dup(FAR struct task_group_s *group, FAR char * const *envcp)
 
       flags = enter_critical_section();
 
+#ifdef CONFIG_SCHED_ENVIRON_SHARED
+      /* The child shares the environment of its parent until either one
+       * modifies it.
+       */
+
+      parent = this_task()->group;
+      if (parent != group && envcp == parent->tg_envp &&
+          env_share(parent) >= 0)
+        {
+          parent->tg_envshared->crefs++;
+          group->tg_envshared = parent->tg_envshared;
+          group->tg_envp      = parent->tg_envp;
+          group->tg_envc      = parent->tg_envc;
+          group->tg_envpc     = parent->tg_envpc;
+          leave_critical_section(flags);
+          return OK;
+        }
+#endif
+
       /* Count the strings */
 
       while (envcp[envc] != NULL)
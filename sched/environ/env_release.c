@@ -67,6 +67,13 @@ void env_release(FAR struct task_group_s *group)
 
   DEBUGASSERT(group != NULL);
 
+#ifdef CONFIG_SCHED_ENVIRON_SHARED
+  if (group->tg_envshared != NULL)
+    {
+      env_detach(group);
+    }
+  else
+#endif
   if (group->tg_envp)
     {
       /* Free any allocate environment strings */
@@ -116,6 +116,15 @@ int setenv(FAR const char *name, FAR const char *value, int overwrite)
   group = rtcb->group;
   DEBUGASSERT(group);
 
+  /* The environment is about to be modified, make it private */
+
+  ret = env_unshare(group);
+  if (ret < 0)
+    {
+      ret = -ret;
+      goto errout_with_lock;
+    }
+
   /* Check if the variable already exists */
 
   if (group->tg_envp && (ret = env_findvar(group, name)) >= 0)
@@ -0,0 +1,208 @@
+/****************************************************************************
+ * sched/environ/env_share.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#ifdef CONFIG_SCHED_ENVIRON_SHARED
+
+#include <stddef.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+
+#include "sched/sched.h"
+#include "environ/environ.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: env_share
+ *
+ * Description:
+ *   Turn the environment of the group into a shared one, if it is not
+ *   already, so that a child can take a reference on it.
+ *
+ * Input Parameters:
+ *   group - The task group
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure, or if the
+ *   environment is empty.
+ *
+ * Assumptions:
+ *   - Not called from an interrupt handler
+ *   - Caller has pre-emption disabled
+ *
+ ****************************************************************************/
+
+int env_share(FAR struct task_group_s *group)
+{
+  FAR struct env_shared_s *shared;
+  FAR char *ptr;
+  size_t size;
+  ssize_t i;
+
+  DEBUGASSERT(group != NULL);
+
+  if (group->tg_envshared != NULL)
+    {
+      return OK;
+    }
+
+  if (group->tg_envp == NULL || group->tg_envc == 0)
+    {
+      return -ENOENT;
+    }
+
+  /* Put the array and the strings in one allocation */
+
+  size = offsetof(struct env_shared_s, envp) +
+         (group->tg_envc + 1) * sizeof(FAR char *);
+  for (i = 0; i < group->tg_envc; i++)
+    {
+      size += strlen(group->tg_envp[i]) + 1;
+    }
+
+  shared = group_malloc(group, size);
+  if (shared == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  shared->crefs = 1;
+  ptr = (FAR char *)&shared->envp[group->tg_envc + 1];
+  for (i = 0; i < group->tg_envc; i++)
+    {
+      size = strlen(group->tg_envp[i]) + 1;
+      memcpy(ptr, group->tg_envp[i], size);
+      shared->envp[i] = ptr;
+      ptr += size;
+
+      group_free(group, group->tg_envp[i]);
+    }
+
+  shared->envp[i] = NULL;
+  group_free(group, group->tg_envp);
+
+  group->tg_envshared = shared;
+  group->tg_envp      = shared->envp;
+  group->tg_envpc     = group->tg_envc + 1;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: env_unshare
+ *
+ * Description:
+ *   Give a private copy of its shared environment to the group, which is
+ *   about to modify it.  Nothing is done if the environment is private.
+ *
+ * Input Parameters:
+ *   group - The task group
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ * Assumptions:
+ *   - Not called from an interrupt handler
+ *   - Caller has pre-emption disabled
+ *
+ ****************************************************************************/
+
+int env_unshare(FAR struct task_group_s *group)
+{
+  FAR struct env_shared_s *shared;
+  int ret;
+
+  DEBUGASSERT(group != NULL);
+
+  shared = group->tg_envshared;
+  if (shared == NULL)
+    {
+      return OK;
+    }
+
+  /* Copy it like the environment of a new task, the shared one has no
+   * room left in its array anyway.
+   */
+
+  group->tg_envshared = NULL;
+  group->tg_envp      = NULL;
+
+  ret = env_dup(group, shared->envp);
+  if (ret < 0 || group->tg_envp == NULL)
+    {
+      group->tg_envshared = shared;
+      group->tg_envp      = shared->envp;
+      group->tg_envpc     = group->tg_envc + 1;
+      return ret < 0 ? ret : -ENOMEM;
+    }
+
+  if (--shared->crefs == 0)
+    {
+      group_free(group, shared);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: env_detach
+ *
+ * Description:
+ *   Drop the reference of the group on its shared environment, the last
+ *   one frees it.
+ *
+ * Input Parameters:
+ *   group - The task group
+ *
+ ****************************************************************************/
+
+void env_detach(FAR struct task_group_s *group)
+{
+  FAR struct env_shared_s *shared;
+  irqstate_t flags;
+
+  flags  = enter_critical_section();
+  shared = group->tg_envshared;
+  if (shared != NULL && --shared->crefs == 0)
+    {
+      group_free(group, shared);
+    }
+
+  group->tg_envshared = NULL;
+  group->tg_envp      = NULL;
+  group->tg_envpc     = 0;
+  group->tg_envc      = 0;
+  leave_critical_section(flags);
+}
+
+#endif /* CONFIG_SCHED_ENVIRON_SHARED */
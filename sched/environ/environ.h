@@ -41,6 +41,27 @@
 
 #  define SCHED_ENVIRON_RESERVED (4)
 
+#ifndef CONFIG_SCHED_ENVIRON_SHARED
+#  define env_unshare(group)   (0)
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_ENVIRON_SHARED
+/* An environment shared by task groups.  It is never modified, the group
+ * which modifies its environment gets a private copy first.  The strings
+ * follow the envp[] array in the same allocation.
+ */
+
+struct env_shared_s
+{
+  int crefs;                 /* Number of groups using the environment */
+  FAR char *envp[1];         /* The environment, NULL terminated */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -149,6 +170,65 @@ ssize_t env_findvar(FAR struct task_group_s *group, FAR const char *pname);
 
 void env_removevar(FAR struct task_group_s *group, ssize_t index);
 
+#ifdef CONFIG_SCHED_ENVIRON_SHARED
+/****************************************************************************
+ * Name: env_share
+ *
+ * Description:
+ *   Turn the environment of the group into a shared one, if it is not
+ *   already, so that a child can take a reference on it.
+ *
+ * Input Parameters:
+ *   group - The task group
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure, or if the
+ *   environment is empty.
+ *
+ * Assumptions:
+ *   - Not called from an interrupt handler
+ *   - Caller has pre-emption disabled
+ *
+ ****************************************************************************/
+
+int env_share(FAR struct task_group_s *group);
+
+/****************************************************************************
+ * Name: env_unshare
+ *
+ * Description:
+ *   Give a private copy of its shared environment to the group, which is
+ *   about to modify it.  Nothing is done if the environment is private.
+ *
+ * Input Parameters:
+ *   group - The task group
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ * Assumptions:
+ *   - Not called from an interrupt handler
+ *   - Caller has pre-emption disabled
+ *
+ ****************************************************************************/
+
+int env_unshare(FAR struct task_group_s *group);
+
+/****************************************************************************
+ * Name: env_detach
+ *
+ * Description:
+ *   Drop the reference of the group on its shared environment, the last
+ *   one frees it.
+ *
+ * Input Parameters:
+ *   group - The task group
+ *
+ ****************************************************************************/
+
+void env_detach(FAR struct task_group_s *group);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -178,6 +178,15 @@ int group_initialize(FAR struct task_tcb_s *tcb, uint8_t ttype)
       return ret;
     }
 
+#ifdef CONFIG_STDIO_LAZY_LOCK
+  /* The kernel threads share one group from the start */
+
+  if (ttype == TCB_FLAG_TTYPE_KERNEL)
+    {
+      group->tg_info->ta_streamlist.sl_threaded = true;
+    }
+#endif
+
 #ifndef CONFIG_DISABLE_PTHREAD
   /* Initialize the task group join */
 
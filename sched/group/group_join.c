@@ -33,6 +33,7 @@
 
 #include <nuttx/irq.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/tls.h>
 
 #include "sched/sched.h"
 #include "group/group.h"
@@ -100,6 +101,12 @@ void group_join(FAR struct pthread_tcb_s *tcb)
 
   group = tcb->cmn.group;
 
+#ifdef CONFIG_STDIO_LAZY_LOCK
+  /* The streams are shared from now on, the stdio functions lock them */
+
+  group->tg_info->ta_streamlist.sl_threaded = true;
+#endif
+
   /* Add the member to the group */
 
   flags = spin_lock_irqsave(NULL);
@@ -42,6 +42,7 @@
 #  include <nuttx/binfmt/binfmt.h>
 #endif
 
+#include "sched/sched.h"
 #include "environ/environ.h"
 #include "signal/signal.h"
 #include "pthread/pthread.h"
@@ -250,7 +251,7 @@ void group_drop(FAR struct task_group_s *group)
 
       if (tcb->cmn.flags & TCB_FLAG_FREE_TCB)
         {
-          kmm_free(tcb);
+          nxsched_free_tcb(tcb);
         }
     }
 }
@@ -72,6 +72,33 @@ void nx_start(void);
 int nx_smp_start(void);
 #endif
 
+/****************************************************************************
+ * Name: nx_initcall_run
+ *
+ * Description:
+ *   Run the initcalls registered up to the level maxlevel, one level after
+ *   the other, and those of a level in parallel on the initcall threads.
+ *   Return when all of them are done.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_INITCALL
+void nx_initcall_run(int maxlevel);
+#endif
+
+/****************************************************************************
+ * Name: nx_initcall_finish
+ *
+ * Description:
+ *   Run all the remaining initcalls, then release the initcall threads.
+ *   The initcalls registered later are run at once by nx_initcall().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_INITCALL
+void nx_initcall_finish(void);
+#endif
+
 /****************************************************************************
  * Name: nx_idle_trampoline
  *
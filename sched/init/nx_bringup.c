@@ -322,6 +322,14 @@ static inline void nx_start_application(void)
   board_late_initialize();
 #endif
 
+#ifdef CONFIG_INITCALL
+  /* Run the initcalls that the first application may need, those of each
+   * level in parallel.
+   */
+
+  nx_initcall_run(INITCALL_LEVEL_DEFERRED - 1);
+#endif
+
 #if defined(CONFIG_BOARD_COREDUMP_SYSLOG) || \
     defined(CONFIG_BOARD_COREDUMP_BLKDEV)
   coredump_initialize();
@@ -379,6 +387,12 @@ static inline void nx_start_application(void)
 #endif
   posix_spawnattr_destroy(&attr);
   DEBUGASSERT(ret > 0);
+
+#ifdef CONFIG_INITCALL
+  /* Then the deferred ones, while the application starts */
+
+  nx_initcall_finish();
+#endif
 }
 
 /****************************************************************************
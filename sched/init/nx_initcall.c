@@ -0,0 +1,274 @@
+/****************************************************************************
+ * sched/init/nx_initcall.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/init.h>
+#include <nuttx/irq.h>
+#include <nuttx/queue.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
+
+#include "init/init.h"
+
+#ifdef CONFIG_INITCALL
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The initcalls not started yet, sorted by level */
+
+static sq_queue_t g_initcalls;
+
+/* Posted by each initcall when it is done */
+
+static sem_t g_initcall_sem = SEM_INITIALIZER(0);
+
+/* The threads running the initcalls, until all of them are done */
+
+static FAR struct kwork_wqueue_s *g_initcall_wqueue;
+
+/* All the initcalls are done, the next ones run at once */
+
+static bool g_initcall_done;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nx_initcall_call
+ ****************************************************************************/
+
+static void nx_initcall_call(FAR struct initcall_s *call)
+{
+  int ret;
+
+  sinfo("Initcall %s, level %d\n", call->name, call->level);
+
+  ret = call->func(call->arg);
+  if (ret < 0)
+    {
+      serr("ERROR: Initcall %s failed: %d\n", call->name, ret);
+    }
+}
+
+/****************************************************************************
+ * Name: nx_initcall_worker
+ ****************************************************************************/
+
+static void nx_initcall_worker(FAR void *arg)
+{
+  nx_initcall_call(arg);
+  nxsem_post(&g_initcall_sem);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nx_initcall
+ *
+ * Description:
+ *   Register the initialization func of a driver or a subsystem, to be run
+ *   with the initcalls of the same level on the initcall threads, after
+ *   board_late_initialize() has returned.  It may be called from
+ *   drivers_initialize(), board_early_initialize(), board_late_initialize()
+ *   or an initcall.  Once all the initcalls are done, func is run at once.
+ *
+ * Input Parameters:
+ *   call  - The initcall, which must stay valid until it is done
+ *   name  - The name of the initialization, for the error reports
+ *   func  - The initialization
+ *   arg   - Its argument
+ *   level - One of INITCALL_LEVEL_*
+ *
+ ****************************************************************************/
+
+void nx_initcall(FAR struct initcall_s *call, FAR const char *name,
+                 initcall_t func, FAR void *arg, int level)
+{
+  FAR sq_entry_t *prev = NULL;
+  FAR sq_entry_t *entry;
+  irqstate_t flags;
+
+  DEBUGASSERT(call != NULL && func != NULL);
+  DEBUGASSERT(level >= 0 && level <= INITCALL_LEVEL_DEFERRED);
+
+  call->name  = name;
+  call->func  = func;
+  call->arg   = arg;
+  call->level = level;
+
+  flags = enter_critical_section();
+  if (g_initcall_done)
+    {
+      leave_critical_section(flags);
+      nx_initcall_call(call);
+      return;
+    }
+
+  /* Insert it after the initcalls of the same level, so that those
+   * registered first are started first.
+   */
+
+  for (entry = sq_peek(&g_initcalls); entry != NULL; entry = sq_next(entry))
+    {
+      if (((FAR struct initcall_s *)entry)->level > level)
+        {
+          break;
+        }
+
+      prev = entry;
+    }
+
+  if (prev != NULL)
+    {
+      sq_addafter(prev, (FAR sq_entry_t *)call, &g_initcalls);
+    }
+  else
+    {
+      sq_addfirst((FAR sq_entry_t *)call, &g_initcalls);
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: nx_initcall_run
+ *
+ * Description:
+ *   Run the initcalls registered up to the level maxlevel, one level after
+ *   the other, and those of a level in parallel on the initcall threads.
+ *   Return when all of them are done.
+ *
+ ****************************************************************************/
+
+void nx_initcall_run(int maxlevel)
+{
+  FAR struct initcall_s *call;
+  irqstate_t flags;
+  int level;
+  int count;
+
+  if (g_initcall_wqueue == NULL && !sq_empty(&g_initcalls))
+    {
+      g_initcall_wqueue = work_queue_create("initcall",
+                                            CONFIG_INITCALL_PRIORITY,
+                                            CONFIG_INITCALL_STACKSIZE,
+                                            CONFIG_INITCALL_NTHREADS);
+    }
+
+  for (; ; )
+    {
+      flags = enter_critical_section();
+      call  = (FAR struct initcall_s *)sq_peek(&g_initcalls);
+      if (call == NULL || call->level > maxlevel)
+        {
+          leave_critical_section(flags);
+          break;
+        }
+
+      /* Start all the initcalls of this level.  An initcall registered by
+       * one of them, at a higher level, is found by the next round.
+       */
+
+      level = call->level;
+      count = 0;
+
+      while (call != NULL && call->level == level)
+        {
+          sq_remfirst(&g_initcalls);
+          if (g_initcall_wqueue != NULL &&
+              work_queue_wq(g_initcall_wqueue, &call->work,
+                            nx_initcall_worker, call, 0) >= 0)
+            {
+              count++;
+            }
+          else
+            {
+              /* No thread to run it, then it is run here */
+
+              leave_critical_section(flags);
+              nx_initcall_call(call);
+              flags = enter_critical_section();
+            }
+
+          call = (FAR struct initcall_s *)sq_peek(&g_initcalls);
+        }
+
+      leave_critical_section(flags);
+
+      /* And wait for them before the next level */
+
+      while (count-- > 0)
+        {
+          nxsem_wait_uninterruptible(&g_initcall_sem);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: nx_initcall_finish
+ *
+ * Description:
+ *   Run all the remaining initcalls, then release the initcall threads.
+ *   The initcalls registered later are run at once by nx_initcall().
+ *
+ ****************************************************************************/
+
+void nx_initcall_finish(void)
+{
+  irqstate_t flags;
+
+  for (; ; )
+    {
+      nx_initcall_run(INITCALL_LEVEL_DEFERRED);
+
+      flags = enter_critical_section();
+      if (sq_empty(&g_initcalls))
+        {
+          g_initcall_done = true;
+          leave_critical_section(flags);
+          break;
+        }
+
+      leave_critical_section(flags);
+    }
+
+  if (g_initcall_wqueue != NULL)
+    {
+      work_queue_free(g_initcall_wqueue);
+      g_initcall_wqueue = NULL;
+    }
+}
+
+#endif /* CONFIG_INITCALL */
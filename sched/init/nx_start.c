@@ -24,6 +24,7 @@
  * Included Files
  ****************************************************************************/
 
+#include <sys/param.h>
 #include <sys/types.h>
 #include <stdbool.h>
 #include <stdio.h>
@@ -39,6 +40,7 @@
 #include <nuttx/net/net.h>
 #include <nuttx/mm/iob.h>
 #include <nuttx/mm/kmap.h>
+#include <nuttx/mm/kmem_cache.h>
 #include <nuttx/mm/mm.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/pgalloc.h>
@@ -62,6 +64,7 @@
 #include "init/init.h"
 #include "instrument/instrument.h"
 #include "tls/tls.h"
+#include "wdog/wdog.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -71,6 +74,15 @@
 
 #define SCHED_ALL_CPUS           ((1 << CONFIG_SMP_NCPUS) - 1)
 
+/* Kernel threads use only the struct tcb_s part of a task TCB */
+
+#ifdef CONFIG_DISABLE_PTHREAD
+#  define SCHED_TCB_SIZE         sizeof(struct task_tcb_s)
+#else
+#  define SCHED_TCB_SIZE         MAX(sizeof(struct task_tcb_s), \
+                                     sizeof(struct pthread_tcb_s))
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -181,6 +193,12 @@ volatile pid_t g_lastpid;
 FAR struct tcb_s **g_pidhash;
 volatile int g_npidhash;
 
+#ifdef CONFIG_MM_KMEM_CACHE_TCB
+/* All TCBs but the ones of the IDLE tasks are allocated from this cache */
+
+FAR struct kmem_cache_s *g_tcb_cache;
+#endif
+
 /* This is a table of task lists.  This table is indexed by the task state
  * enumeration type (tstate_t) and provides a pointer to the associated
  * static task list (if there is one) as well as a set of attribute flags
@@ -395,11 +413,12 @@ static void idle_task_initialize(void)
        * enforced by the TCB_FLAG_CPU_LOCKED which overrides the affinity
        * mask.  This is essential because all tasks inherit the affinity
        * mask from their parent and, ultimately, the parent of all tasks is
-       * the IDLE task.
+       * the IDLE task.  The isolated CPUs only run the tasks bound to them.
        */
 
       tcb->affinity =
-        (cpu_set_t)(CONFIG_SMP_DEFAULT_CPUSET & SCHED_ALL_CPUS);
+        (cpu_set_t)(CONFIG_SMP_DEFAULT_CPUSET & SCHED_ALL_CPUS) &
+        ~SCHED_ISOLATED_CPUS;
 #else
       tcb->flags = TCB_FLAG_TTYPE_KERNEL;
 #endif
@@ -539,6 +558,10 @@ void nx_start(void)
 
   g_nx_initstate = OSINIT_TASKLISTS;
 
+  /* Initialize the watchdog timer queue ************************************/
+
+  wd_initialize();
+
   /* Initialize RTOS Data ***************************************************/
 
   drivers_early_initialize();
@@ -622,6 +645,13 @@ void nx_start(void)
 
   g_npidhash = i;
 
+#ifdef CONFIG_MM_KMEM_CACHE_TCB
+  /* Initialize the cache of TCBs */
+
+  g_tcb_cache = kmem_cache_create("tcb", SCHED_TCB_SIZE, 0, NULL, NULL);
+  DEBUGASSERT(g_tcb_cache);
+#endif
+
   /* IDLE Group Initialization **********************************************/
 
   idle_group_initialize();
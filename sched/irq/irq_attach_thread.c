@@ -27,11 +27,13 @@
 #include <nuttx/config.h>
 
 #include <errno.h>
+#include <sched.h>
 #include <stdio.h>
 
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
 #include <nuttx/kthread.h>
+#include <nuttx/sched.h>
 
 #include "irq/irq.h"
 #include "sched/sched.h"
@@ -59,6 +61,15 @@ struct irq_thread_info_s
 
 static pid_t g_irq_thread_pid[NR_IRQS];
 
+#ifdef CONFIG_IRQ_THREAD_BALANCE
+/* The CPU each IRQ thread is bound to plus one, zero if it is not bound to
+ * a single one, and the number of IRQ threads bound to each CPU.
+ */
+
+static uint8_t g_irq_thread_cpu[NR_IRQS];
+static uint16_t g_irq_thread_count[CONFIG_SMP_NCPUS];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -84,6 +95,65 @@ static int irq_default_handler(int irq, FAR void *regs, FAR void *arg)
   return ret;
 }
 
+#ifndef CONFIG_ARCH_NOINTC
+/* Interrupt handler of the converted interrupts: their handler runs in the
+ * thread, the IRQ is masked until it has.
+ */
+
+static int irq_masked_handler(int irq, FAR void *regs, FAR void *arg)
+{
+  up_disable_irq(irq);
+  return IRQ_WAKE_THREAD;
+}
+#endif
+
+#ifdef CONFIG_IRQ_THREAD_BALANCE
+/* Account for the IRQ thread of 'ndx' being bound to 'cpu', or to no
+ * single CPU if cpu is negative.
+ */
+
+static void irq_thread_bind(int ndx, int cpu)
+{
+  if (g_irq_thread_cpu[ndx] > 0)
+    {
+      g_irq_thread_count[g_irq_thread_cpu[ndx] - 1]--;
+    }
+
+  g_irq_thread_cpu[ndx] = cpu + 1;
+  if (cpu >= 0)
+    {
+      g_irq_thread_count[cpu]++;
+    }
+}
+
+/* Bind a new IRQ thread to the CPU with the fewest IRQ threads, leaving
+ * the isolated CPUs alone.
+ */
+
+static void irq_thread_balance(int ndx, pid_t pid)
+{
+  cpu_set_t cpuset;
+  int best = 0;
+  int cpu;
+
+  for (cpu = 1; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      if (!nxsched_cpu_isolated(cpu) &&
+          g_irq_thread_count[cpu] < g_irq_thread_count[best])
+        {
+          best = cpu;
+        }
+    }
+
+  CPU_ZERO(&cpuset);
+  CPU_SET(best, &cpuset);
+  if (nxsched_set_affinity(pid, sizeof(cpuset), &cpuset) >= 0)
+    {
+      irq_thread_bind(ndx, best);
+    }
+}
+#endif
+
 static int isr_thread_main(int argc, FAR char *argv[])
 {
   int irq = atoi(argv[1]);
@@ -113,6 +183,13 @@ static int isr_thread_main(int argc, FAR char *argv[])
         }
 
       isrthread(irq, NULL, arg);
+
+#ifndef CONFIG_ARCH_NOINTC
+      if (isr == irq_masked_handler)
+        {
+          up_enable_irq(irq);
+        }
+#endif
     }
 
   return OK;
@@ -176,6 +253,9 @@ int irq_attach_thread(int irq, xcpt_t isr, xcpt_t isrthread, FAR void *arg,
       DEBUGASSERT(g_irq_thread_pid[ndx] != 0);
       kthread_delete(g_irq_thread_pid[ndx]);
       g_irq_thread_pid[ndx] = 0;
+#ifdef CONFIG_IRQ_THREAD_BALANCE
+      irq_thread_bind(ndx, -1);
+#endif
 
       return OK;
     }
@@ -204,7 +284,200 @@ int irq_attach_thread(int irq, xcpt_t isr, xcpt_t isrthread, FAR void *arg,
 
   g_irq_thread_pid[ndx] = pid;
 
+#ifdef CONFIG_IRQ_THREAD_BALANCE
+  irq_thread_balance(ndx, pid);
+#endif
+
 #endif /* NR_IRQS */
 
   return OK;
 }
+
+/****************************************************************************
+ * Name: irq_thread_convert
+ *
+ * Description:
+ *   Move the handler attached to IRQ number 'irq' with irq_attach() into a
+ *   thread:  in interrupt context the IRQ is only masked, then the thread
+ *   runs the handler and unmasks the IRQ.  This takes a long ISR out of the
+ *   hard interrupt context without changing the driver.  The handler is
+ *   called with a NULL register context, so this is not for the handlers
+ *   that use it, or that must run before the interrupt returns.
+ *
+ * Input Parameters:
+ *   irq        - Irq num
+ *   priority   - Priority of the new thread
+ *   stack_size - size (in bytes) of the stack needed
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_ARCH_NOINTC
+int irq_thread_convert(int irq, int priority, int stack_size)
+{
+#if NR_IRQS > 0
+  irqstate_t flags;
+  xcpt_t handler;
+  FAR void *arg;
+  int ndx;
+
+  if ((unsigned)irq >= NR_IRQS)
+    {
+      return -EINVAL;
+    }
+
+  ndx = IRQ_TO_NDX(irq);
+  if (ndx < 0)
+    {
+      return ndx;
+    }
+
+  flags   = enter_critical_section();
+  handler = g_irqvector[ndx].handler;
+  arg     = g_irqvector[ndx].arg;
+  leave_critical_section(flags);
+
+  if (handler == NULL || handler == irq_unexpected_isr ||
+      g_irq_thread_pid[ndx] != 0)
+    {
+      return -EINVAL;
+    }
+
+  /* The IRQ stays disabled until the thread attached the masking handler
+   * and enabled it again.
+   */
+
+  up_disable_irq(irq);
+  return irq_attach_thread(irq, irq_masked_handler, handler, arg,
+                           priority, stack_size);
+#else
+  return -EINVAL;
+#endif
+}
+#endif
+
+/****************************************************************************
+ * Name: irq_thread_setpriority
+ *
+ * Description:
+ *   Change the priority of the thread of a threaded IRQ.
+ *
+ * Input Parameters:
+ *   irq      - Irq num
+ *   priority - The new priority of the thread
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.  -ENOENT is
+ *   returned if the IRQ has no thread.
+ *
+ ****************************************************************************/
+
+int irq_thread_setpriority(int irq, int priority)
+{
+  struct sched_param param;
+  pid_t pid;
+  int ret;
+
+  pid = irq_thread_pid(irq);
+  if (pid <= 0)
+    {
+      return pid < 0 ? pid : -ENOENT;
+    }
+
+  ret = nxsched_get_param(pid, &param);
+  if (ret >= 0)
+    {
+      param.sched_priority = priority;
+      ret = nxsched_set_param(pid, &param);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: irq_thread_setaffinity
+ *
+ * Description:
+ *   Change the CPUs the thread of a threaded IRQ may run on.  This replaces
+ *   the CPU chosen by CONFIG_IRQ_THREAD_BALANCE.
+ *
+ * Input Parameters:
+ *   irq    - Irq num
+ *   cpuset - The new affinity of the thread
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.  -ENOENT is
+ *   returned if the IRQ has no thread.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+int irq_thread_setaffinity(int irq, FAR const cpu_set_t *cpuset)
+{
+  pid_t pid;
+  int ret;
+
+  pid = irq_thread_pid(irq);
+  if (pid <= 0)
+    {
+      return pid < 0 ? pid : -ENOENT;
+    }
+
+  ret = nxsched_set_affinity(pid, sizeof(cpu_set_t), cpuset);
+
+#ifdef CONFIG_IRQ_THREAD_BALANCE
+  if (ret >= 0)
+    {
+      int cpu = -1;
+
+      if (CPU_COUNT(cpuset) == 1)
+        {
+          for (cpu = 0; !CPU_ISSET(cpu, cpuset); cpu++);
+        }
+
+      irq_thread_bind(IRQ_TO_NDX(irq), cpu);
+    }
+#endif
+
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: irq_thread_pid
+ *
+ * Description:
+ *   Return the ID of the thread of a threaded IRQ.
+ *
+ * Input Parameters:
+ *   irq - Irq num
+ *
+ * Returned Value:
+ *   The thread ID, zero if the IRQ has no thread or a negated errno value
+ *   if the IRQ is not valid.
+ *
+ ****************************************************************************/
+
+pid_t irq_thread_pid(int irq)
+{
+#if NR_IRQS > 0
+  int ndx;
+
+  if ((unsigned)irq >= NR_IRQS)
+    {
+      return -EINVAL;
+    }
+
+  ndx = IRQ_TO_NDX(irq);
+  if (ndx < 0)
+    {
+      return ndx;
+    }
+
+  return g_irq_thread_pid[ndx];
+#else
+  return -EINVAL;
+#endif
+}
@@ -0,0 +1,298 @@
+/****************************************************************************
+ * sched/irq/irq_lockdep.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/spinlock.h>
+
+#include "sched/sched.h"
+#include "irq/irq.h"
+
+#ifdef CONFIG_SPINLOCK_LOCKDEP
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The spinlocks currently held by one CPU, in acquisition order */
+
+struct lockdep_held_s
+{
+  FAR volatile spinlock_t *lock[CONFIG_SPINLOCK_LOCKDEP_DEPTH];
+  uint8_t depth;
+  uint8_t overflow;     /* Acquisitions not tracked because depth was full */
+};
+
+/* One observed ordering: 'first' was held while 'second' was taken */
+
+struct lockdep_order_s
+{
+  FAR volatile spinlock_t *first;
+  FAR volatile spinlock_t *second;
+  bool reported;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Protects everything below; only ever taken without instrumentation */
+
+static spinlock_t g_lockdep_lock = SP_UNLOCKED;
+
+static struct lockdep_held_s g_lockdep_held[CONFIG_SMP_NCPUS];
+static struct lockdep_order_s
+  g_lockdep_order[CONFIG_SPINLOCK_LOCKDEP_ORDERS];
+static unsigned int g_lockdep_norder;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lockdep_order
+ *
+ * Description:
+ *   Record that 'first' was held while 'second' was taken, and report if
+ *   the opposite order has been seen before.
+ *
+ ****************************************************************************/
+
+static void lockdep_order(FAR volatile spinlock_t *first,
+                          FAR volatile spinlock_t *second)
+{
+  FAR struct lockdep_order_s *inverse = NULL;
+  unsigned int i;
+
+  for (i = 0; i < g_lockdep_norder; i++)
+    {
+      FAR struct lockdep_order_s *order = &g_lockdep_order[i];
+
+      if (order->first == first && order->second == second)
+        {
+          return;
+        }
+
+      if (order->first == second && order->second == first)
+        {
+          inverse = order;
+        }
+    }
+
+  if (inverse != NULL)
+    {
+      if (!inverse->reported)
+        {
+          inverse->reported = true;
+          _alert("Lock order inversion: %p taken while holding %p, "
+                 "but %p was taken while holding %p before\n",
+                 second, first, first, second);
+        }
+
+      return;
+    }
+
+  if (g_lockdep_norder < CONFIG_SPINLOCK_LOCKDEP_ORDERS)
+    {
+      g_lockdep_order[g_lockdep_norder].first    = first;
+      g_lockdep_order[g_lockdep_norder].second   = second;
+      g_lockdep_order[g_lockdep_norder].reported = false;
+      g_lockdep_norder++;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spin_lockdep_acquire
+ *
+ * Description:
+ *   Called by spin_lock(), spin_lock_irqsave() and the successful
+ *   spin_trylock() before the lock is (or right after it was) taken.
+ *   Asserts if this CPU already holds the lock and records the order
+ *   against every lock it does hold.  In SMP configurations the critical
+ *   section counts as one more lock, so that a private spinlock taken both
+ *   inside and outside of enter_critical_section() is reported.
+ *
+ * Input Parameters:
+ *   lock    - The spinlock being taken.  NULL (the g_irq_spin shorthand of
+ *             spin_lock_irqsave()) is ignored.
+ *   trylock - True if the lock was taken with spin_trylock().  A trylock
+ *             cannot deadlock, so no order is recorded for it.
+ *
+ ****************************************************************************/
+
+void spin_lockdep_acquire(FAR volatile spinlock_t *lock, bool trylock)
+{
+  FAR struct lockdep_held_s *held;
+  bool recursive = false;
+  irqstate_t flags;
+  int cpu;
+  int i;
+
+  if (lock == NULL)
+    {
+      return;
+    }
+
+  flags = up_irq_save();
+  spin_lock_wo_note(&g_lockdep_lock);
+
+  cpu  = this_cpu();
+  held = &g_lockdep_held[cpu];
+
+#ifdef CONFIG_SMP
+  if (lock == &g_cpu_irqlock)
+    {
+      /* The critical section is re-entrant and may be handed over between
+       * tasks, so it is never on the held list.  Only record the order of
+       * the private locks held while entering it.
+       */
+
+      for (i = 0; i < held->depth && !trylock; i++)
+        {
+          lockdep_order(held->lock[i], lock);
+        }
+
+      spin_unlock_wo_note(&g_lockdep_lock);
+      up_irq_restore(flags);
+      return;
+    }
+#endif
+
+  for (i = 0; i < held->depth; i++)
+    {
+      if (held->lock[i] == lock)
+        {
+          recursive = true;
+        }
+      else if (!trylock)
+        {
+          lockdep_order(held->lock[i], lock);
+        }
+    }
+
+#ifdef CONFIG_SMP
+  if (!trylock && (g_cpu_irqset & (1 << cpu)) != 0)
+    {
+      lockdep_order(&g_cpu_irqlock, lock);
+    }
+#endif
+
+  if (held->depth < CONFIG_SPINLOCK_LOCKDEP_DEPTH)
+    {
+      held->lock[held->depth++] = lock;
+    }
+  else
+    {
+      held->overflow++;
+    }
+
+  spin_unlock_wo_note(&g_lockdep_lock);
+  up_irq_restore(flags);
+
+  /* Taking a non-reentrant spinlock twice on the same CPU can only
+   * deadlock.
+   */
+
+  DEBUGASSERT(!recursive);
+}
+
+/****************************************************************************
+ * Name: spin_lockdep_release
+ *
+ * Description:
+ *   Called by spin_unlock() and spin_unlock_irqrestore() before the lock is
+ *   released.  Removes the lock from the held list of this CPU, or of
+ *   another CPU if the holder migrated before disabling interrupts.
+ *   Locks that were taken without instrumentation are ignored.
+ *
+ * Input Parameters:
+ *   lock - The spinlock being released.
+ *
+ ****************************************************************************/
+
+void spin_lockdep_release(FAR volatile spinlock_t *lock)
+{
+  irqstate_t flags;
+  int cpu;
+  int n;
+  int i;
+
+#ifdef CONFIG_SMP
+  if (lock == NULL || lock == &g_cpu_irqlock)
+#else
+  if (lock == NULL)
+#endif
+    {
+      return;
+    }
+
+  flags = up_irq_save();
+  spin_lock_wo_note(&g_lockdep_lock);
+
+  cpu = this_cpu();
+  for (n = 0; n < CONFIG_SMP_NCPUS; n++)
+    {
+      FAR struct lockdep_held_s *held =
+        &g_lockdep_held[(cpu + n) % CONFIG_SMP_NCPUS];
+
+      for (i = held->depth - 1; i >= 0; i--)
+        {
+          if (held->lock[i] == lock)
+            {
+              /* Spinlocks need not be released in reverse order */
+
+              held->depth--;
+              for (; i < held->depth; i++)
+                {
+                  held->lock[i] = held->lock[i + 1];
+                }
+
+              goto out;
+            }
+        }
+
+      if (n == 0 && held->overflow > 0)
+        {
+          held->overflow--;
+          goto out;
+        }
+    }
+
+out:
+  spin_unlock_wo_note(&g_lockdep_lock);
+  up_irq_restore(flags);
+}
+
+#endif /* CONFIG_SPINLOCK_LOCKDEP */
@@ -28,6 +28,7 @@
 
 #include <sys/stat.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <fcntl.h>
 #include <string.h>
 #include <assert.h>
@@ -49,26 +50,33 @@
 
 /* Output format:
  *
- *            1111111111222222222233333333334444444444
- *   1234567890123456789012345678901234567890123456789
+ *            11111111112222222222333333333344444444445555
+ *   12345678901234567890123456789012345678901234567890123
  *
- *   IRQ HANDLER  ARGUMENT    COUNT    RATE    TIME
- *   DDD XXXXXXXX XXXXXXXX DDDDDDDDDD DDDD.DDD DDDD
+ *   IRQ HANDLER  ARGUMENT    COUNT    RATE    TIME   PID
+ *   DDD XXXXXXXX XXXXXXXX DDDDDDDDDD DDDD.DDD DDDD DDDDD
+ *
+ * PID is the thread of a threaded IRQ, zero for the others.
  *
  * NOTE:  This assumes that an address can be represented in 32-bits.  In
  * the typical configuration where CONFIG_HAVE_LONG_LONG=y, the COUNT field
  * may not be wide enough.
+ *
+ * The thread of a threaded IRQ is set up by writing one of these lines:
+ *
+ *   <irq> priority <priority>
+ *   <irq> affinity <hexadecimal CPU bit set>
  */
 
-#define HDR_FMT "IRQ HANDLER  ARGUMENT    COUNT    RATE    TIME\n"
-#define IRQ_FMT "%3u %08lx %08lx %10lu %4lu.%03lu %4lu\n"
+#define HDR_FMT "IRQ HANDLER  ARGUMENT    COUNT    RATE    TIME   PID\n"
+#define IRQ_FMT "%3u %08lx %08lx %10lu %4lu.%03lu %4lu %5d\n"
 
 /* Determines the size of an intermediate buffer that must be large enough
  * to handle the longest line generated by this logic (plus a couple of
  * bytes).
  */
 
-#define IRQ_LINELEN 50
+#define IRQ_LINELEN 56
 
 /****************************************************************************
  * Private Types
@@ -102,6 +110,8 @@ static int     irq_open(FAR struct file *filep, FAR const char *relpath,
 static int     irq_close(FAR struct file *filep);
 static ssize_t irq_read(FAR struct file *filep, FAR char *buffer,
                  size_t buflen);
+static ssize_t irq_write(FAR struct file *filep, FAR const char *buffer,
+                 size_t buflen);
 static int     irq_dup(FAR const struct file *oldp,
                  FAR struct file *newp);
 static int     irq_stat(FAR const char *relpath, FAR struct stat *buf);
@@ -120,7 +130,7 @@ const struct procfs_operations g_irq_operations =
   irq_open,       /* open */
   irq_close,      /* close */
   irq_read,       /* read */
-  NULL,           /* write */
+  irq_write,      /* write */
   NULL,           /* poll */
 
   irq_dup,        /* dup */
@@ -241,7 +251,8 @@ static int irq_callback(int irq, FAR struct irq_info_s *info,
                       (unsigned long)((uintptr_t)copy.handler),
                       (unsigned long)((uintptr_t)copy.arg),
                       count, intpart, fracpart,
-                      (unsigned long)delta.tv_nsec / 1000);
+                      (unsigned long)delta.tv_nsec / 1000,
+                      (int)irq_thread_pid(irq));
 
   copysize  = procfs_memcpy(irqfile->line, linesize, irqfile->buffer,
                             irqfile->remaining, &irqfile->offset);
@@ -275,16 +286,6 @@ static int irq_open(FAR struct file *filep, FAR const char *relpath,
 
   finfo("Open '%s'\n", relpath);
 
-  /* This PROCFS file is read-only.  Any attempt to open with write access
-   * is not permitted.
-   */
-
-  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
-    {
-      ferr("ERROR: Only O_RDONLY supported\n");
-      return -EACCES;
-    }
-
   /* Allocate a container to hold the file attributes */
 
   irqfile = kmm_zalloc(sizeof(struct irq_file_s));
@@ -367,6 +368,56 @@ static ssize_t irq_read(FAR struct file *filep, FAR char *buffer,
   return irqfile->ncopied;
 }
 
+/****************************************************************************
+ * Name: irq_write
+ *
+ * Description:
+ *   Set the priority or the affinity of the thread of a threaded IRQ.
+ *
+ ****************************************************************************/
+
+static ssize_t irq_write(FAR struct file *filep, FAR const char *buffer,
+                         size_t buflen)
+{
+  char line[IRQ_LINELEN];
+  FAR char *ptr;
+  int irq;
+  int ret;
+
+  if (buflen >= sizeof(line))
+    {
+      return -EINVAL;
+    }
+
+  memcpy(line, buffer, buflen);
+  line[buflen] = '\0';
+
+  irq = strtol(line, &ptr, 10);
+  while (*ptr == ' ')
+    {
+      ptr++;
+    }
+
+  if (strncmp(ptr, "priority ", 9) == 0)
+    {
+      ret = irq_thread_setpriority(irq, strtol(ptr + 9, NULL, 10));
+    }
+#ifdef CONFIG_SMP
+  else if (strncmp(ptr, "affinity ", 9) == 0)
+    {
+      cpu_set_t cpuset = strtoul(ptr + 9, NULL, 16);
+
+      ret = irq_thread_setaffinity(irq, &cpuset);
+    }
+#endif
+  else
+    {
+      ret = -EINVAL;
+    }
+
+  return ret < 0 ? ret : buflen;
+}
+
 /****************************************************************************
  * Name: irq_dup
  *
@@ -415,10 +466,10 @@ static int irq_dup(FAR const struct file *oldp, FAR struct file *newp)
 
 static int irq_stat(const char *relpath, struct stat *buf)
 {
-  /* "irqs" is the name for a read-only file */
+  /* "irqs" is the name for a file, only writable by the owner */
 
   memset(buf, 0, sizeof(struct stat));
-  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR | S_IWUSR;
   return OK;
 }
 
@@ -0,0 +1,238 @@
+/****************************************************************************
+ * sched/irq/irq_qspinlock.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <nuttx/spinlock.h>
+
+#include <assert.h>
+#include <sys/types.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/atomic.h>
+#include <nuttx/irq.h>
+
+#ifdef CONFIG_QUEUED_SPINLOCK
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* 64 bytes covers the usual cache line sizes */
+
+#define QSPIN_ALIGN  64
+
+#define QSPIN_TAIL(cpu) ((unsigned int)((cpu) + 1) << SP_QUEUED_SHIFT)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The MCS queue node a CPU spins on while it waits for a lock */
+
+struct qspin_node_s
+{
+  /* The tail value of the next waiter, 0 if none.  The alignment puts
+   * the node of each CPU in a cache line of its own.
+   */
+
+  unsigned int next aligned_data(QSPIN_ALIGN);
+  unsigned int head; /* Set when this waiter is the first */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* A CPU waits for one lock at a time, its interrupts are disabled while it
+ * is queued, so one node per CPU is enough.
+ */
+
+static struct qspin_node_s g_qspin_node[CONFIG_SMP_NCPUS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static inline FAR struct qspin_node_s *qspin_node(unsigned int tail)
+{
+  return &g_qspin_node[(tail >> SP_QUEUED_SHIFT) - 1];
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spin_lock_queued
+ *
+ * Description:
+ *   The slow path of spin_lock() once the lock was found taken.  The CPU
+ *   puts its node at the tail of the queue of the lock and spins on its
+ *   own node until its predecessor hands the head of the queue over.  Only
+ *   the head spins on the lock itself, so a release moves one cache line
+ *   to one CPU, instead of to every waiter as with the ticket lock.
+ *
+ * Input Parameters:
+ *   lock - A reference to the spinlock object to lock.
+ *
+ ****************************************************************************/
+
+void spin_lock_queued(FAR volatile spinlock_t *lock)
+{
+  FAR atomic_uint *word = (FAR atomic_uint *)lock;
+  FAR struct qspin_node_s *node;
+  unsigned int next;
+  unsigned int tail;
+  unsigned int old;
+  irqstate_t flags;
+
+  flags = up_irq_save();
+
+  node = &g_qspin_node[this_cpu()];
+  tail = QSPIN_TAIL(this_cpu());
+
+  atomic_store((FAR atomic_uint *)&node->next, 0);
+  atomic_store((FAR atomic_uint *)&node->head, 0);
+
+  /* Become the tail of the queue */
+
+  old = atomic_load(word);
+  while (!atomic_compare_exchange_weak(word, &old,
+                                       (old & ~SP_QUEUED_MASK) | tail));
+
+  /* Wait behind the previous tail until it makes us the head */
+
+  if ((old & SP_QUEUED_MASK) != 0)
+    {
+      atomic_store((FAR atomic_uint *)&qspin_node(old)->next, tail);
+
+      while (atomic_load((FAR atomic_uint *)&node->head) == 0)
+        {
+          SP_DSB();
+        }
+    }
+
+  /* As the head, wait for the owner to release the lock and take it */
+
+  for (; ; )
+    {
+      old = atomic_load(word);
+      if ((old & SP_LOCKED) != 0)
+        {
+          SP_DSB();
+        }
+      else if ((old & SP_QUEUED_MASK) == tail)
+        {
+          /* Nobody queued behind us, leave the queue empty */
+
+          if (atomic_compare_exchange_weak(word, &old, SP_LOCKED))
+            {
+              break;
+            }
+        }
+      else if (atomic_compare_exchange_weak(word, &old, old | SP_LOCKED))
+        {
+          /* Hand the head over once the next waiter has linked itself */
+
+          while ((next = atomic_load((FAR atomic_uint *)&node->next)) == 0)
+            {
+              SP_DSB();
+            }
+
+          atomic_store((FAR atomic_uint *)&qspin_node(next)->head, 1);
+          break;
+        }
+    }
+
+  up_irq_restore(flags);
+}
+
+#ifdef CONFIG_RW_SPINLOCK
+
+/****************************************************************************
+ * Name: read_lock_queued
+ *
+ * Description:
+ *   The slow path of read_lock() when a writer holds or waits for the
+ *   lock.  The reader queues behind the other waiters on the wait lock and
+ *   waits for the writer to release the lock, then lets the next waiter in.
+ *
+ * Input Parameters:
+ *   lock - A reference to the rwlock object to lock.
+ *
+ ****************************************************************************/
+
+void read_lock_queued(FAR volatile rwlock_t *lock)
+{
+  FAR atomic_uint *cnts = (FAR atomic_uint *)&lock->cnts;
+
+  atomic_fetch_sub(cnts, RW_SP_RBIAS);
+
+  spin_lock_wo_note(&lock->wait);
+
+  atomic_fetch_add(cnts, RW_SP_RBIAS);
+  while ((atomic_load(cnts) & RW_SP_WLOCKED) != 0)
+    {
+      SP_DSB();
+    }
+
+  spin_unlock_wo_note(&lock->wait);
+}
+
+/****************************************************************************
+ * Name: write_lock_queued
+ *
+ * Description:
+ *   The slow path of write_lock() when the lock is taken.  The writer
+ *   queues on the wait lock, then stops the new readers and waits for the
+ *   current ones to leave.
+ *
+ * Input Parameters:
+ *   lock - A reference to the rwlock object to lock.
+ *
+ ****************************************************************************/
+
+void write_lock_queued(FAR volatile rwlock_t *lock)
+{
+  FAR atomic_uint *cnts = (FAR atomic_uint *)&lock->cnts;
+  unsigned int old;
+
+  spin_lock_wo_note(&lock->wait);
+
+  atomic_fetch_or(cnts, RW_SP_WWAITING);
+
+  do
+    {
+      old = RW_SP_WWAITING;
+      SP_DSB();
+    }
+  while (!atomic_compare_exchange_weak(cnts, &old, RW_SP_WLOCKED));
+
+  spin_unlock_wo_note(&lock->wait);
+}
+
+#endif /* CONFIG_RW_SPINLOCK */
+#endif /* CONFIG_QUEUED_SPINLOCK */
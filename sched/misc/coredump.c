@@ -52,6 +52,16 @@
 #define ROUNDUP(x, y)     ((x + (y - 1)) / (y)) * (y)
 #define ROUNDDOWN(x ,y)   (((x) / (y)) * (y))
 
+/* Number of the memory segments dumped for each task */
+
+#if defined(CONFIG_COREDUMP_STACK) && defined(CONFIG_COREDUMP_TCB)
+#  define TASK_SEGS       2
+#elif defined(CONFIG_COREDUMP_STACK) || defined(CONFIG_COREDUMP_TCB)
+#  define TASK_SEGS       1
+#else
+#  define TASK_SEGS       0
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -73,7 +83,9 @@ struct elf_dumpinfo_s
 
 static uint8_t g_running_regs[XCPTCONTEXT_SIZE] aligned_data(16);
 
-#ifdef CONFIG_BOARD_COREDUMP_COMPRESSION
+#if defined(CONFIG_BOARD_COREDUMP_LZ4)
+static struct lib_lz4outstream_s  g_lz4stream;
+#elif defined(CONFIG_BOARD_COREDUMP_LZF)
 static struct lib_lzfoutstream_s  g_lzfstream;
 #endif
 
@@ -419,11 +431,32 @@ static void elf_emit_tcb_stack(FAR struct elf_dumpinfo_s *cinfo,
   elf_emit_align(cinfo);
 }
 
+/****************************************************************************
+ * Name: elf_emit_tcb_segs
+ *
+ * Description:
+ *   Fill the memory segments of a task: its stack, then its TCB
+ *
+ ****************************************************************************/
+
+static void elf_emit_tcb_segs(FAR struct elf_dumpinfo_s *cinfo,
+                              FAR struct tcb_s *tcb)
+{
+#ifdef CONFIG_COREDUMP_STACK
+  elf_emit_tcb_stack(cinfo, tcb);
+#endif
+
+#ifdef CONFIG_COREDUMP_TCB
+  elf_emit(cinfo, tcb, sizeof(struct tcb_s));
+  elf_emit_align(cinfo);
+#endif
+}
+
 /****************************************************************************
  * Name: elf_emit_stack
  *
  * Description:
- *   Fill the task stack information
+ *   Fill the memory segments of the tasks
  *
  ****************************************************************************/
 
@@ -437,13 +470,13 @@ static void elf_emit_stack(FAR struct elf_dumpinfo_s *cinfo)
         {
           if (g_pidhash[i] != NULL)
             {
-              elf_emit_tcb_stack(cinfo, g_pidhash[i]);
+              elf_emit_tcb_segs(cinfo, g_pidhash[i]);
             }
         }
     }
   else
     {
-      elf_emit_tcb_stack(cinfo, nxsched_get_tcb(cinfo->pid));
+      elf_emit_tcb_segs(cinfo, nxsched_get_tcb(cinfo->pid));
     }
 }
 
@@ -555,6 +588,36 @@ static void elf_emit_tcb_phdr(FAR struct elf_dumpinfo_s *cinfo,
   elf_emit(cinfo, phdr, sizeof(*phdr));
 }
 
+/****************************************************************************
+ * Name: elf_emit_tcb_segs_phdr
+ *
+ * Description:
+ *   Fill the program segment headers of the memory segments of a task
+ *
+ ****************************************************************************/
+
+static void elf_emit_tcb_segs_phdr(FAR struct elf_dumpinfo_s *cinfo,
+                                   FAR struct tcb_s *tcb,
+                                   FAR Elf_Phdr *phdr, off_t *offset)
+{
+#ifdef CONFIG_COREDUMP_STACK
+  elf_emit_tcb_phdr(cinfo, tcb, phdr, offset);
+#endif
+
+#ifdef CONFIG_COREDUMP_TCB
+  phdr->p_type   = PT_LOAD;
+  phdr->p_offset = ROUNDUP(*offset, ELF_PAGESIZE);
+  phdr->p_vaddr  = (uintptr_t)tcb;
+  phdr->p_paddr  = phdr->p_vaddr;
+  phdr->p_filesz = sizeof(struct tcb_s);
+  phdr->p_memsz  = phdr->p_filesz;
+  phdr->p_flags  = PF_W | PF_R;
+  *offset       += ROUNDUP(phdr->p_memsz, ELF_PAGESIZE);
+
+  elf_emit(cinfo, phdr, sizeof(*phdr));
+#endif
+}
+
 /****************************************************************************
  * Name: elf_emit_phdr
  *
@@ -567,7 +630,7 @@ static void elf_emit_phdr(FAR struct elf_dumpinfo_s *cinfo,
                           int stksegs, int memsegs)
 {
   off_t offset = cinfo->stream->nput +
-                 (stksegs + memsegs + 1) * sizeof(Elf_Phdr);
+                 (stksegs * TASK_SEGS + memsegs + 1) * sizeof(Elf_Phdr);
   Elf_Phdr phdr;
   int i;
 
@@ -587,14 +650,15 @@ static void elf_emit_phdr(FAR struct elf_dumpinfo_s *cinfo,
         {
           if (g_pidhash[i] != NULL)
             {
-              elf_emit_tcb_phdr(cinfo, g_pidhash[i], &phdr, &offset);
+              elf_emit_tcb_segs_phdr(cinfo, g_pidhash[i], &phdr,
+                                     &offset);
             }
         }
     }
   else
     {
-      elf_emit_tcb_phdr(cinfo, nxsched_get_tcb(cinfo->pid),
-                        &phdr, &offset);
+      elf_emit_tcb_segs_phdr(cinfo, nxsched_get_tcb(cinfo->pid),
+                             &phdr, &offset);
     }
 
   /* Write program headers for segments dump */
@@ -613,6 +677,27 @@ static void elf_emit_phdr(FAR struct elf_dumpinfo_s *cinfo,
     }
 }
 
+/****************************************************************************
+ * Name: coredump_compress
+ *
+ * Description:
+ *   Put the compression stream in front of the backend stream.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_BOARD_COREDUMP_COMPRESSION
+static FAR void *coredump_compress(FAR struct lib_outstream_s *backend)
+{
+#ifdef CONFIG_BOARD_COREDUMP_LZ4
+  lib_lz4outstream(&g_lz4stream, backend);
+  return &g_lz4stream;
+#else
+  lib_lzfoutstream(&g_lzfstream, backend);
+  return &g_lzfstream;
+#endif
+}
+#endif
+
 /****************************************************************************
  * Name: coredump_dump_syslog
  *
@@ -648,10 +733,9 @@ static void coredump_dump_syslog(pid_t pid)
 
 #  ifdef CONFIG_BOARD_COREDUMP_COMPRESSION
 
-  /* Initialize LZF compression stream */
+  /* Initialize compression stream */
 
-  lib_lzfoutstream(&g_lzfstream, stream);
-  stream = &g_lzfstream;
+  stream = coredump_compress(stream);
 #  endif
 
   /* Do core dump */
@@ -706,9 +790,7 @@ static void coredump_dump_blkdev(pid_t pid)
   info = (FAR struct coredump_info_s *)g_blockinfo;
 
 #ifdef CONFIG_BOARD_COREDUMP_COMPRESSION
-  lib_lzfoutstream(&g_lzfstream,
-                   (FAR struct lib_outstream_s *)&g_blockstream);
-  stream = &g_lzfstream;
+  stream = coredump_compress((FAR struct lib_outstream_s *)&g_blockstream);
 #endif
 
   ret = coredump(g_regions, stream, pid);
@@ -962,7 +1044,7 @@ int coredump(FAR const struct memory_region_s *regions,
 
   /* Fill notes section */
 
-  elf_emit_hdr(&cinfo, stksegs + memsegs + 1);
+  elf_emit_hdr(&cinfo, stksegs * TASK_SEGS + memsegs + 1);
 
   /* Fill all the program information about the process for the
    * notes.  This also sets up the file header.
@@ -978,7 +1060,7 @@ int coredump(FAR const struct memory_region_s *regions,
 
   elf_emit_align(&cinfo);
 
-  /* Dump stack */
+  /* Dump the stacks and the TCBs */
 
   elf_emit_stack(&cinfo);
 
@@ -78,6 +78,10 @@ struct list_node g_msgfree;
 
 struct list_node g_msgfreeirq;
 
+/* Protects g_msgfree and g_msgfreeirq */
+
+spinlock_t g_msgfreelock = SP_UNLOCKED;
+
 #endif
 
 /****************************************************************************
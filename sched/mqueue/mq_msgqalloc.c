@@ -88,6 +88,7 @@ int nxmq_alloc_msgq(FAR struct mq_attr *attr,
     {
       /* Initialize the new named message queue */
 
+      spin_lock_init(&msgq->lock);
       list_initialize(&msgq->msglist);
       if (attr)
         {
@@ -150,12 +150,16 @@ int mq_notify(mqd_t mqdes, FAR const struct sigevent *notification)
               goto errout;
             }
 
-          /* Yes... Assign it to the current task. */
+          /* Yes... Assign it to the current task.  The lock of the queue
+           * makes a send that does not enter the critical section see it.
+           */
 
+          spin_lock(&msgq->lock);
           memcpy(&msgq->ntevent, notification,
                  sizeof(struct sigevent));
 
           msgq->ntpid = rtcb->pid;
+          spin_unlock(&msgq->lock);
         }
     }
 
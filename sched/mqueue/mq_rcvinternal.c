@@ -121,6 +121,8 @@ static void nxmq_rcvtimeout(wdparm_t arg)
  * - Interrupts should be disabled throughout this call.  This is necessary
  *   because messages can be sent from interrupt level processing.
  * - For mq_timedreceive, setting of the timer and this wait must be atomic.
+ * - The caller holds msgq->lock.  It is released while the task is
+ *   blocked and held again on return.
  *
  ****************************************************************************/
 
@@ -164,6 +166,7 @@ int nxmq_wait_receive(FAR struct mqueue_inode_s *msgq,
                    list_remove_head(&msgq->msglist)) == NULL)
     {
       msgq->cmn.nwaitnotempty++;
+      spin_unlock(&msgq->lock);
 
       /* Initialize the 'errcode" used to communication wake-up error
        * conditions.
@@ -184,6 +187,7 @@ int nxmq_wait_receive(FAR struct mqueue_inode_s *msgq,
       /* Now, perform the context switch */
 
       up_switch_context(this_task(), rtcb);
+      spin_lock(&msgq->lock);
 
       /* When we resume at this point, either (1) the message queue
        * is no longer empty, or (2) the wait has been interrupted by
@@ -140,9 +140,8 @@ ssize_t file_mq_timedreceive_internal(FAR struct file *mq, FAR char *msg,
                                       FAR const struct timespec *abstime,
                                       sclock_t ticks)
 {
-  FAR struct mqueue_inode_s *msgq;
   FAR struct mqueue_msg_s *mqmsg;
-  irqstate_t flags;
+  struct list_node rcvlist;
   ssize_t ret = 0;
 
   DEBUGASSERT(up_interrupt_context() == false);
@@ -171,13 +170,128 @@ ssize_t file_mq_timedreceive_internal(FAR struct file *mq, FAR char *msg,
     }
 #endif
 
-  msgq = mq->f_inode->i_private;
+  list_initialize(&rcvlist);
+  ret = nxmq_do_receive(mq, &rcvlist, 1, abstime, ticks);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  mqmsg = (FAR struct mqueue_msg_s *)list_remove_head(&rcvlist);
+
+  /* Return the message to the caller */
+
+  if (prio)
+    {
+      *prio = mqmsg->priority;
+    }
+
+  memcpy(msg, mqmsg->mail, mqmsg->msglen);
+  ret = mqmsg->msglen;
+
+  /* Free the message structure */
+
+  nxmq_free_msg(mqmsg);
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nxmq_take_msgs
+ *
+ * Description:
+ *   Move the message already removed from the queue and up to nmsgs - 1
+ *   more to rcvlist, and account for them.
+ *
+ * Assumptions:
+ *   Called with msgq->lock held.
+ *
+ ****************************************************************************/
+
+static int nxmq_take_msgs(FAR struct mqueue_inode_s *msgq,
+                          FAR struct mqueue_msg_s *mqmsg,
+                          FAR struct list_node *rcvlist, int nmsgs)
+{
+  int i = 0;
+
+  do
+    {
+      list_add_tail(rcvlist, &mqmsg->node);
+      msgq->nmsgs--;
+
+      if (++i >= nmsgs)
+        {
+          break;
+        }
+
+      mqmsg = (FAR struct mqueue_msg_s *)list_remove_head(&msgq->msglist);
+    }
+  while (mqmsg != NULL);
+
+  return i;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxmq_do_receive
+ *
+ * Description:
+ *   Take up to 'nmsgs' messages from the queue under one hold of its lock.
+ *   The call waits for the first message only.
+ *
+ * Input Parameters:
+ *   mq      - Message Queue Descriptor
+ *   rcvlist - The list to append the messages to, they then belong to the
+ *             caller
+ *   nmsgs   - The maximum number of messages
+ *   abstime - the absolute time to wait until a timeout is declared.
+ *   ticks   - Ticks to wait from the start time until the semaphore is
+ *             posted.
+ *
+ * Returned Value:
+ *   The number of messages taken, at least one, or a negated errno value
+ *   on failure.
+ *
+ ****************************************************************************/
+
+int nxmq_do_receive(FAR struct file *mq, FAR struct list_node *rcvlist,
+                    int nmsgs, FAR const struct timespec *abstime,
+                    sclock_t ticks)
+{
+  FAR struct mqueue_inode_s *msgq = mq->f_inode->i_private;
+  FAR struct mqueue_msg_s *mqmsg;
+  irqstate_t flags;
+  bool wasfull;
+  int ret;
+  int i;
+
+  /* If the queue has messages, was not full and no sender waits for room,
+   * the lock of the queue is enough.
+   */
+
+  flags = spin_lock_irqsave(&msgq->lock);
+  if (msgq->nmsgs < msgq->maxmsgs && msgq->cmn.nwaitnotfull == 0)
+    {
+      mqmsg = (FAR struct mqueue_msg_s *)list_remove_head(&msgq->msglist);
+      if (mqmsg != NULL)
+        {
+          i = nxmq_take_msgs(msgq, mqmsg, rcvlist, nmsgs);
+          spin_unlock_irqrestore(&msgq->lock, flags);
+          return i;
+        }
+    }
+
+  spin_unlock_irqrestore(&msgq->lock, flags);
 
   /* Furthermore, nxmq_wait_receive() expects to have interrupts disabled
    * because messages can be sent from interrupt level.
    */
 
   flags = enter_critical_section();
+  spin_lock(&msgq->lock);
 
   /* Get the message from the message queue */
 
@@ -186,6 +300,7 @@ ssize_t file_mq_timedreceive_internal(FAR struct file *mq, FAR char *msg,
     {
       if ((mq->f_oflags & O_NONBLOCK) != 0)
         {
+          spin_unlock(&msgq->lock);
           leave_critical_section(flags);
           return -EAGAIN;
         }
@@ -195,47 +310,32 @@ ssize_t file_mq_timedreceive_internal(FAR struct file *mq, FAR char *msg,
       ret = nxmq_wait_receive(msgq, &mqmsg, abstime, ticks);
       if (ret < 0)
         {
+          spin_unlock(&msgq->lock);
           leave_critical_section(flags);
           return ret;
         }
     }
 
-  /* If we got message, then decrement the number of messages in
-   * the queue while we are still in the critical section
-   */
+  wasfull = msgq->nmsgs == msgq->maxmsgs;
+  i = nxmq_take_msgs(msgq, mqmsg, rcvlist, nmsgs);
+  spin_unlock(&msgq->lock);
 
-  if (msgq->nmsgs-- == msgq->maxmsgs)
+  if (wasfull)
     {
       nxmq_pollnotify(msgq, POLLOUT);
     }
 
-  /* Notify all threads waiting for a message in the message queue */
-
-  nxmq_notify_receive(msgq);
-
-  leave_critical_section(flags);
-
-  /* Return the message to the caller */
+  /* Wake up to one waiting sender for each message taken */
 
-  if (prio)
+  for (ret = i; ret > 0; ret--)
     {
-      *prio = mqmsg->priority;
+      nxmq_notify_receive(msgq);
     }
 
-  memcpy(msg, mqmsg->mail, mqmsg->msglen);
-  ret = mqmsg->msglen;
-
-  /* Free the message structure */
-
-  nxmq_free_msg(mqmsg);
-
-  return ret;
+  leave_critical_section(flags);
+  return i;
 }
 
-/****************************************************************************
- * Public Functions
- ****************************************************************************/
-
 /****************************************************************************
  * Name: file_mq_timedreceive
  *
@@ -105,85 +105,6 @@ static int nxmq_verify_send(FAR FAR struct file *mq, FAR const char *msg,
 }
 #endif
 
-/****************************************************************************
- * Name: nxmq_alloc_msg
- *
- * Description:
- *   The nxmq_alloc_msg function will get a free message for use by the
- *   operating system.  The message will be allocated from the g_msgfree
- *   list.
- *
- *   If the list is empty AND the message is NOT being allocated from the
- *   interrupt level, then the message will be allocated.  If a message
- *   cannot be obtained, the operating system is dead and therefore cannot
- *   continue.
- *
- *   If the list is empty AND the message IS being allocated from the
- *   interrupt level.  This function will attempt to get a message from
- *   the g_msgfreeirq list.  If this is unsuccessful, the calling interrupt
- *   handler will be notified.
- *
- * Input Parameters:
- *   None
- *
- * Returned Value:
- *   A reference to the allocated msg structure.  On a failure to allocate,
- *   this function PANICs.
- *
- ****************************************************************************/
-
-static FAR struct mqueue_msg_s *nxmq_alloc_msg(uint16_t msgsize)
-{
-  FAR struct mqueue_msg_s *mqmsg;
-  irqstate_t flags;
-
-  /* Try to get the message from the generally available free list. */
-
-  flags = spin_lock_irqsave(NULL);
-  mqmsg = (FAR struct mqueue_msg_s *)list_remove_head(&g_msgfree);
-  spin_unlock_irqrestore(NULL, flags);
-  if (mqmsg == NULL)
-    {
-      /* If we were called from an interrupt handler, then try to get the
-       * message from generally available list of messages. If this fails,
-       * then try the list of messages reserved for interrupt handlers
-       */
-
-      if (up_interrupt_context())
-        {
-          /* Try the free list reserved for interrupt handlers */
-
-          flags = spin_lock_irqsave(NULL);
-          mqmsg = (FAR struct mqueue_msg_s *)list_remove_head(&g_msgfreeirq);
-          spin_unlock_irqrestore(NULL, flags);
-        }
-
-      /* We were not called from an interrupt handler. */
-
-      else
-        {
-          /* If we cannot a message from the free list, then we will have to
-           * allocate one.
-           */
-
-          mqmsg = kmm_malloc(MQ_MSG_SIZE(msgsize));
-
-          /* Check if we allocated the message */
-
-          if (mqmsg != NULL)
-            {
-              /* Yes... remember that this message was dynamically
-               * allocated.
-               */
-
-              mqmsg->type = MQ_ALLOC_DYN;
-            }
-        }
-    }
-
-  return mqmsg;
-}
-
 /****************************************************************************
  * Name: nxmq_add_queue
  *
@@ -239,6 +160,54 @@ static void nxmq_add_queue(FAR struct mqueue_inode_s *msgq,
     }
 }
 
+/****************************************************************************
+ * Name: nxmq_send_isquiet
+ *
+ * Description:
+ *   Return true if a message can be added to the queue without blocking
+ *   and without waking, polling or notifying anyone.
+ *
+ * Assumptions:
+ *   Called with msgq->lock held.
+ *
+ ****************************************************************************/
+
+static bool nxmq_send_isquiet(FAR struct mqueue_inode_s *msgq)
+{
+#if CONFIG_FS_MQUEUE_NPOLLWAITERS > 0
+  int i;
+#endif
+
+  if (msgq->nmsgs >= msgq->maxmsgs || msgq->cmn.nwaitnotempty > 0)
+    {
+      return false;
+    }
+
+#ifndef CONFIG_DISABLE_MQUEUE_NOTIFICATION
+  if (msgq->ntpid != INVALID_PROCESS_ID)
+    {
+      return false;
+    }
+#endif
+
+#if CONFIG_FS_MQUEUE_NPOLLWAITERS > 0
+  /* Pollers only need to hear about the first message */
+
+  if (msgq->nmsgs == 0)
+    {
+      for (i = 0; i < CONFIG_FS_MQUEUE_NPOLLWAITERS; i++)
+        {
+          if (msgq->fds[i] != NULL)
+            {
+              return false;
+            }
+        }
+    }
+#endif
+
+  return true;
+}
+
 /****************************************************************************
  * Name: file_mq_timedsend_internal
  *
@@ -277,9 +246,7 @@ int file_mq_timedsend_internal(FAR struct file *mq, FAR const char *msg,
                                FAR const struct timespec *abstime,
                                sclock_t ticks)
 {
-  FAR struct mqueue_inode_s *msgq;
   FAR struct mqueue_msg_s *mqmsg;
-  irqstate_t flags;
   int ret = 0;
 
   /* Verify the input parameters */
@@ -304,8 +271,6 @@ int file_mq_timedsend_internal(FAR struct file *mq, FAR const char *msg,
     }
 #endif
 
-  msgq = mq->f_inode->i_private;
-
   /* Pre-allocate a message structure */
 
   mqmsg = nxmq_alloc_msg(msglen);
@@ -318,9 +283,146 @@ int file_mq_timedsend_internal(FAR struct file *mq, FAR const char *msg,
   mqmsg->priority = prio;
   mqmsg->msglen   = msglen;
 
+  ret = nxmq_do_send(mq, mqmsg, abstime, ticks);
+  if (ret < 0)
+    {
+      nxmq_free_msg(mqmsg);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxmq_alloc_msg
+ *
+ * Description:
+ *   The nxmq_alloc_msg function will get a free message for use by the
+ *   operating system.  The message will be allocated from the g_msgfree
+ *   list.
+ *
+ *   If the list is empty AND the message is NOT being allocated from the
+ *   interrupt level, then the message will be allocated.  If a message
+ *   cannot be obtained, the operating system is dead and therefore cannot
+ *   continue.
+ *
+ *   If the list is empty AND the message IS being allocated from the
+ *   interrupt level.  This function will attempt to get a message from
+ *   the g_msgfreeirq list.  If this is unsuccessful, the calling interrupt
+ *   handler will be notified.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   A reference to the allocated msg structure.  On a failure to allocate,
+ *   this function PANICs.
+ *
+ ****************************************************************************/
+
+FAR struct mqueue_msg_s *nxmq_alloc_msg(uint16_t msgsize)
+{
+  FAR struct mqueue_msg_s *mqmsg;
+  irqstate_t flags;
+
+  /* Try to get the message from the generally available free list. */
+
+  flags = spin_lock_irqsave(&g_msgfreelock);
+  mqmsg = (FAR struct mqueue_msg_s *)list_remove_head(&g_msgfree);
+  spin_unlock_irqrestore(&g_msgfreelock, flags);
+  if (mqmsg == NULL)
+    {
+      /* If we were called from an interrupt handler, then try to get the
+       * message from generally available list of messages. If this fails,
+       * then try the list of messages reserved for interrupt handlers
+       */
+
+      if (up_interrupt_context())
+        {
+          /* Try the free list reserved for interrupt handlers */
+
+          flags = spin_lock_irqsave(&g_msgfreelock);
+          mqmsg = (FAR struct mqueue_msg_s *)list_remove_head(&g_msgfreeirq);
+          spin_unlock_irqrestore(&g_msgfreelock, flags);
+        }
+
+      /* We were not called from an interrupt handler. */
+
+      else
+        {
+          /* If we cannot a message from the free list, then we will have to
+           * allocate one.
+           */
+
+          mqmsg = kmm_malloc(MQ_MSG_SIZE(msgsize));
+
+          /* Check if we allocated the message */
+
+          if (mqmsg != NULL)
+            {
+              /* Yes... remember that this message was dynamically
+               * allocated.
+               */
+
+              mqmsg->type = MQ_ALLOC_DYN;
+            }
+        }
+    }
+
+  return mqmsg;
+}
+
+/****************************************************************************
+ * Name: nxmq_do_send
+ *
+ * Description:
+ *   Queue a message that is already filled in, waiting for room in the
+ *   queue if necessary.
+ *
+ * Input Parameters:
+ *   mq      - Message queue descriptor
+ *   mqmsg   - The message, with its priority and length set
+ *   abstime - the absolute time to wait until a timeout is decleared
+ *   ticks   - Ticks to wait from the start time until the semaphore is
+ *             posted.
+ *
+ * Returned Value:
+ *   Zero (OK) on success, the message then belongs to the queue.  A
+ *   negated errno value on failure, the message still belongs to the
+ *   caller.
+ *
+ ****************************************************************************/
+
+int nxmq_do_send(FAR struct file *mq, FAR struct mqueue_msg_s *mqmsg,
+                 FAR const struct timespec *abstime, sclock_t ticks)
+{
+  FAR struct mqueue_inode_s *msgq = mq->f_inode->i_private;
+  irqstate_t flags;
+  bool wasempty;
+  int ret = OK;
+
+  /* If there is room and nobody has to be woken or notified, the lock of
+   * the queue is enough.
+   */
+
+  flags = spin_lock_irqsave(&msgq->lock);
+  if (nxmq_send_isquiet(msgq))
+    {
+      nxmq_add_queue(msgq, mqmsg, mqmsg->priority);
+      msgq->nmsgs++;
+      spin_unlock_irqrestore(&msgq->lock, flags);
+      return OK;
+    }
+
+  spin_unlock_irqrestore(&msgq->lock, flags);
+
   /* Disable interruption */
 
   flags = enter_critical_section();
+  spin_lock(&msgq->lock);
 
   if (msgq->nmsgs >= msgq->maxmsgs)
     {
@@ -345,11 +447,14 @@ int file_mq_timedsend_internal(FAR struct file *mq, FAR const char *msg,
 
   /* Add the message to the message queue */
 
-  nxmq_add_queue(msgq, mqmsg, prio);
+  nxmq_add_queue(msgq, mqmsg, mqmsg->priority);
 
   /* Increment the count of messages in the queue */
 
-  if (msgq->nmsgs++ == 0)
+  wasempty = msgq->nmsgs++ == 0;
+  spin_unlock(&msgq->lock);
+
+  if (wasempty)
     {
       nxmq_pollnotify(msgq, POLLIN);
     }
@@ -357,22 +462,15 @@ int file_mq_timedsend_internal(FAR struct file *mq, FAR const char *msg,
   /* Notify any tasks that are waiting for a message to become available */
 
   nxmq_notify_send(msgq);
+  leave_critical_section(flags);
+  return OK;
 
 out:
+  spin_unlock(&msgq->lock);
   leave_critical_section(flags);
-
-  if (ret < 0)
-    {
-      nxmq_free_msg(mqmsg);
-    }
-
   return ret;
 }
 
-/****************************************************************************
- * Public Functions
- ****************************************************************************/
-
 /****************************************************************************
  * Name: file_mq_timedsend
  *
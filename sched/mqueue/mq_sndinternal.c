@@ -121,6 +121,8 @@ static void nxmq_sndtimeout(wdparm_t arg)
  * Assumptions/restrictions:
  * - The caller has verified the input parameters using nxmq_verify_send().
  * - Executes within a critical section established by the caller.
+ * - The caller holds msgq->lock.  It is released while the task is
+ *   blocked and held again on return.
  *
  ****************************************************************************/
 
@@ -171,6 +173,7 @@ int nxmq_wait_send(FAR struct mqueue_inode_s *msgq,
       rtcb          = this_task();
       rtcb->waitobj = msgq;
       msgq->cmn.nwaitnotfull++;
+      spin_unlock(&msgq->lock);
 
       /* Initialize the errcode used to communication wake-up error
        * conditions.
@@ -196,6 +199,7 @@ int nxmq_wait_send(FAR struct mqueue_inode_s *msgq,
       /* Now, perform the context switch */
 
       up_switch_context(this_task(), rtcb);
+      spin_lock(&msgq->lock);
 
       /* When we resume at this point, either (1) the message queue
        * is no longer empty, or (2) the wait has been interrupted by
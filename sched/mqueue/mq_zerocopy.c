@@ -0,0 +1,331 @@
+/****************************************************************************
+ * sched/mqueue/mq_zerocopy.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stddef.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <mqueue.h>
+
+#include <nuttx/cancelpt.h>
+#include <nuttx/mqueue.h>
+
+#include "mqueue/mqueue.h"
+
+#ifdef CONFIG_MQ_ZEROCOPY
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The message structure containing a message buffer */
+
+#define MQ_MAIL2MSG(m) \
+  ((FAR struct mqueue_msg_s *)((FAR char *)(m) - \
+                               offsetof(struct mqueue_msg_s, mail)))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxmq_getmq
+ *
+ * Description:
+ *   Get the file of a message queue descriptor opened with 'oflags'.
+ *
+ ****************************************************************************/
+
+static int nxmq_getmq(mqd_t mqdes, int oflags, FAR struct file **filep)
+{
+  int ret;
+
+  ret = fs_getfilep(mqdes, filep);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (!INODE_IS_MQUEUE((*filep)->f_inode) ||
+      ((*filep)->f_oflags & oflags) == 0)
+    {
+      fs_putfilep(*filep);
+      return -EBADF;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mq_msgalloc
+ *
+ * Description:
+ *   Take a message buffer from the message pool, to be filled in place and
+ *   posted with mq_msgsend() or released with mq_msgfree().  The buffer
+ *   has room for the maximum message size of the queue.
+ *
+ * Input Parameters:
+ *   mqdes - Message queue descriptor, opened for writing
+ *
+ * Returned Value:
+ *   The message buffer, or NULL with errno set on failure.
+ *
+ ****************************************************************************/
+
+FAR void *mq_msgalloc(mqd_t mqdes)
+{
+  FAR struct mqueue_inode_s *msgq;
+  FAR struct mqueue_msg_s *mqmsg;
+  FAR struct file *filep;
+  int ret;
+
+  ret = nxmq_getmq(mqdes, O_WROK, &filep);
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      return NULL;
+    }
+
+  msgq  = filep->f_inode->i_private;
+  mqmsg = nxmq_alloc_msg(msgq->maxmsgsize);
+  fs_putfilep(filep);
+  if (mqmsg == NULL)
+    {
+      set_errno(ENOMEM);
+      return NULL;
+    }
+
+  return mqmsg->mail;
+}
+
+/****************************************************************************
+ * Name: mq_msgsend
+ *
+ * Description:
+ *   Post a message buffer from mq_msgalloc() to the queue, without copying
+ *   it.  The buffer belongs to the queue once this succeeds, otherwise it
+ *   still belongs to the caller.  Blocks like mq_send() if the queue is
+ *   full.
+ *
+ * Input Parameters:
+ *   mqdes  - Message queue descriptor
+ *   msg    - The message buffer
+ *   msglen - The length of the message in bytes
+ *   prio   - The priority of the message
+ *
+ * Returned Value:
+ *   Zero (OK) on success, or -1 (ERROR) with errno set on failure.
+ *
+ ****************************************************************************/
+
+int mq_msgsend(mqd_t mqdes, FAR void *msg, size_t msglen,
+               unsigned int prio)
+{
+  FAR struct mqueue_inode_s *msgq;
+  FAR struct mqueue_msg_s *mqmsg;
+  FAR struct file *filep;
+  int ret;
+
+  /* mq_msgsend() is a cancellation point like mq_send() */
+
+  enter_cancellation_point();
+
+  ret = nxmq_getmq(mqdes, O_WROK, &filep);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  msgq = filep->f_inode->i_private;
+  if (msg == NULL || prio >= MQ_PRIO_MAX)
+    {
+      ret = -EINVAL;
+    }
+  else if (msglen > (size_t)msgq->maxmsgsize)
+    {
+      ret = -EMSGSIZE;
+    }
+  else
+    {
+      mqmsg           = MQ_MAIL2MSG(msg);
+      mqmsg->priority = prio;
+      mqmsg->msglen   = msglen;
+      ret = nxmq_do_send(filep, mqmsg, NULL, -1);
+    }
+
+  fs_putfilep(filep);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  leave_cancellation_point();
+  return OK;
+
+errout:
+  set_errno(-ret);
+  leave_cancellation_point();
+  return ERROR;
+}
+
+/****************************************************************************
+ * Name: mq_msgreceivev
+ *
+ * Description:
+ *   Receive up to 'nvec' messages at once, in priority order.  Waits like
+ *   mq_receive() for the first message only.  Each message must be
+ *   released with mq_msgfree().
+ *
+ * Input Parameters:
+ *   mqdes - Message queue descriptor, opened for reading
+ *   vec   - The location to return the messages
+ *   nvec  - The maximum number of messages
+ *
+ * Returned Value:
+ *   The number of messages received, or -1 (ERROR) with errno set on
+ *   failure.
+ *
+ ****************************************************************************/
+
+int mq_msgreceivev(mqd_t mqdes, FAR struct mq_msgvec_s *vec, int nvec)
+{
+  FAR struct mqueue_msg_s *mqmsg;
+  FAR struct file *filep;
+  struct list_node rcvlist;
+  int ret;
+  int i;
+
+  /* mq_msgreceivev() is a cancellation point like mq_receive() */
+
+  enter_cancellation_point();
+
+  if (vec == NULL || nvec <= 0)
+    {
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  ret = nxmq_getmq(mqdes, O_RDOK, &filep);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  list_initialize(&rcvlist);
+  ret = nxmq_do_receive(filep, &rcvlist, nvec, NULL, -1);
+  fs_putfilep(filep);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  for (i = 0; i < ret; i++)
+    {
+      mqmsg = (FAR struct mqueue_msg_s *)list_remove_head(&rcvlist);
+      vec[i].msg    = mqmsg->mail;
+      vec[i].msglen = mqmsg->msglen;
+      vec[i].prio   = mqmsg->priority;
+    }
+
+  leave_cancellation_point();
+  return ret;
+
+errout:
+  set_errno(-ret);
+  leave_cancellation_point();
+  return ERROR;
+}
+
+/****************************************************************************
+ * Name: mq_msgreceive
+ *
+ * Description:
+ *   Receive the oldest of the highest priority messages, like mq_receive()
+ *   but without copying it.  The message must be released with
+ *   mq_msgfree().
+ *
+ * Input Parameters:
+ *   mqdes - Message queue descriptor, opened for reading
+ *   msg   - The location to return the message
+ *   prio  - If not NULL, the location to store message priority
+ *
+ * Returned Value:
+ *   The length of the message, or -1 (ERROR) with errno set on failure.
+ *
+ ****************************************************************************/
+
+ssize_t mq_msgreceive(mqd_t mqdes, FAR void **msg, FAR unsigned int *prio)
+{
+  struct mq_msgvec_s vec;
+  int ret;
+
+  if (msg == NULL)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  ret = mq_msgreceivev(mqdes, &vec, 1);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  *msg = vec.msg;
+  if (prio)
+    {
+      *prio = vec.prio;
+    }
+
+  return vec.msglen;
+}
+
+/****************************************************************************
+ * Name: mq_msgfree
+ *
+ * Description:
+ *   Release a message from mq_msgreceive(), mq_msgreceivev() or an unsent
+ *   one from mq_msgalloc().
+ *
+ * Input Parameters:
+ *   msg - The message buffer
+ *
+ ****************************************************************************/
+
+void mq_msgfree(FAR void *msg)
+{
+  if (msg != NULL)
+    {
+      nxmq_free_msg(MQ_MAIL2MSG(msg));
+    }
+}
+
+#endif /* CONFIG_MQ_ZEROCOPY */
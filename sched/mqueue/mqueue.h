@@ -38,6 +38,7 @@
 #include <sched.h>
 
 #include <nuttx/mqueue.h>
+#include <nuttx/spinlock.h>
 
 #if defined(CONFIG_MQ_MAXMSGSIZE) && CONFIG_MQ_MAXMSGSIZE > 0
 
@@ -101,6 +102,28 @@ EXTERN struct list_node g_msgfree;
 
 EXTERN struct list_node g_msgfreeirq;
 
+/* g_msgfreelock protects both free lists.  They are accessed from
+ * interrupt handlers, but no OS state beyond the lists themselves.
+ *
+ * The message list of each queue is protected by the lock of the queue,
+ * msgq->lock.  A send or receive that needs to wake nobody, to notify
+ * nobody and not to block only takes that lock.  Everything else enters
+ * the critical section first and takes msgq->lock inside it, never the
+ * other way around:
+ *
+ * - msglist and nmsgs are only changed with msgq->lock held.
+ * - A task that is about to block checks the queue and increments
+ *   nwaitnotempty or nwaitnotfull under msgq->lock, so a fast path send
+ *   or receive sees it and falls back to the critical section.  The
+ *   counts are decremented, and the waiter lists changed, in the
+ *   critical section only.
+ * - msgq->lock is never held across a context switch, so tasks are
+ *   blocked and woken after it is released.
+ * - The poll slots and the notification are set up under both locks.
+ */
+
+EXTERN spinlock_t g_msgfreelock;
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -135,6 +158,18 @@ int nxmq_wait_send(FAR struct mqueue_inode_s *msgq,
                    sclock_t ticks);
 void nxmq_notify_send(FAR struct mqueue_inode_s *msgq);
 
+/* mq_send.c ****************************************************************/
+
+FAR struct mqueue_msg_s *nxmq_alloc_msg(uint16_t msgsize);
+int nxmq_do_send(FAR struct file *mq, FAR struct mqueue_msg_s *mqmsg,
+                 FAR const struct timespec *abstime, sclock_t ticks);
+
+/* mq_receive.c *************************************************************/
+
+int nxmq_do_receive(FAR struct file *mq, FAR struct list_node *rcvlist,
+                    int nmsgs, FAR const struct timespec *abstime,
+                    sclock_t ticks);
+
 /* mq_recover.c *************************************************************/
 
 void nxmq_recover(FAR struct tcb_s *tcb);
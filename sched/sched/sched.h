@@ -36,6 +36,7 @@
 #include <nuttx/arch.h>
 #include <nuttx/queue.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/mm/kmem_cache.h>
 #include <nuttx/spinlock.h>
 
 /****************************************************************************
@@ -106,6 +107,47 @@
 #  define TLIST_BLOCKED(t)       __TLIST_HEAD(t)
 #endif
 
+/* CPUs isolated from the housekeeping work, which CPU0 does for them */
+
+#ifdef CONFIG_SMP_ISOLCPUS
+#  if (CONFIG_SMP_ISOLCPUS_CPUSET & 1) != 0
+#    error CPU0 cannot be isolated
+#  endif
+#  define SCHED_ISOLATED_CPUS \
+     ((cpu_set_t)(CONFIG_SMP_ISOLCPUS_CPUSET & ((1 << CONFIG_SMP_NCPUS) - 1)))
+#  define nxsched_cpu_isolated(cpu) \
+     ((SCHED_ISOLATED_CPUS & (1 << (cpu))) != 0)
+#  define nxsched_housekeeping_cpu(cpu) \
+     (nxsched_cpu_isolated(cpu) ? 0 : (cpu))
+#else
+#  define SCHED_ISOLATED_CPUS           ((cpu_set_t)0)
+#  define nxsched_cpu_isolated(cpu)     false
+#  define nxsched_housekeeping_cpu(cpu) (cpu)
+#  define nxsched_cpu_nohz(cpu)         false
+#endif
+
+/* Order of the prioritized lists:  a task goes before another one if it
+ * has a higher priority or, at the same priority, if it is a deadline
+ * thread with an earlier deadline.  Deadline threads go before the other
+ * threads of their priority.
+ */
+
+#ifdef CONFIG_SCHED_DEADLINE
+#  define nxsched_is_deadline(t) \
+    (((t)->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+#  define nxsched_deadline_before(a,b) \
+    (nxsched_is_deadline(a) && (!nxsched_is_deadline(b) || \
+     (sclock_t)((a)->deadline->absdeadline - \
+                (b)->deadline->absdeadline) < 0))
+#else
+#  define nxsched_deadline_before(a,b) false
+#endif
+
+#define nxsched_preempts(a,b) \
+  ((a)->sched_priority > (b)->sched_priority || \
+   ((a)->sched_priority == (b)->sched_priority && \
+    nxsched_deadline_before(a, b)))
+
 #ifdef CONFIG_SCHED_CRITMONITOR_MAXTIME_PANIC
 #  define CRITMONITOR_PANIC(fmt, ...) \
           do \
@@ -118,6 +160,21 @@
 #  define CRITMONITOR_PANIC(fmt, ...) _alert(fmt, ##__VA_ARGS__)
 #endif
 
+/* TCBs are touched on every context switch, keep them in fast memory if
+ * there is any.
+ */
+
+#ifdef CONFIG_MM_HEAP_ATTR_TCB
+#  define nxsched_alloc_tcb(s)   kmm_zalloc_attr(MM_ATTR_FAST, MM_NODE_ANY, s)
+#  define nxsched_free_tcb(t)    kmm_free_attr(t)
+#elif defined(CONFIG_MM_KMEM_CACHE_TCB)
+#  define nxsched_alloc_tcb(s)   kmem_cache_zalloc(g_tcb_cache)
+#  define nxsched_free_tcb(t)    kmem_cache_free(g_tcb_cache, t)
+#else
+#  define nxsched_alloc_tcb(s)   kmm_zalloc(s)
+#  define nxsched_free_tcb(t)    kmm_free(t)
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -132,6 +189,25 @@ struct tasklist_s
   uint8_t attr;          /* List attribute flags */
 };
 
+#ifdef CONFIG_SMP
+/* This is the call descriptor used by nxsched_smp_call().  Users of
+ * nxsched_smp_call_single_async() provide their own instance, initialized
+ * with nxsched_smp_call_init(), and must not queue it again before the
+ * previous call has run.
+ */
+
+struct smp_call_cookie_s;
+struct smp_call_data_s
+{
+  sq_entry_t                    node[CONFIG_SMP_NCPUS];
+  nxsched_smp_call_t            func;
+  FAR void                     *arg;
+  FAR struct smp_call_cookie_s *cookie;
+  spinlock_t                    lock;
+  volatile int                  refcount;
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -249,6 +325,12 @@ extern volatile pid_t g_lastpid;
 extern FAR struct tcb_s **g_pidhash;
 extern volatile int g_npidhash;
 
+#ifdef CONFIG_MM_KMEM_CACHE_TCB
+/* The cache of the TCBs of all types, sized for the largest one */
+
+extern FAR struct kmem_cache_s *g_tcb_cache;
+#endif
+
 /* This is a table of task lists.  This table is indexed by the task stat
  * enumeration type (tstate_t) and provides a pointer to the associated
  * static task list (if there is one) as well as a a set of attribute flags
@@ -360,6 +442,18 @@ uint32_t nxsched_process_sporadic(FAR struct tcb_s *tcb, uint32_t ticks,
 void nxsched_sporadic_lowpriority(FAR struct tcb_s *tcb);
 #endif
 
+#ifdef CONFIG_SMP_ISOLCPUS
+bool nxsched_cpu_nohz(int cpu);
+#endif
+
+#ifdef CONFIG_SCHED_DEADLINE
+int  nxsched_start_deadline(FAR struct tcb_s *tcb,
+                            FAR const struct sched_param *param);
+int  nxsched_stop_deadline(FAR struct tcb_s *tcb);
+void nxsched_wakeup_deadline(FAR struct tcb_s *tcb);
+void nxsched_process_deadline(FAR struct tcb_s *tcb, uint32_t ticks);
+#endif
+
 #ifdef CONFIG_SIG_SIGSTOP_ACTION
 void nxsched_suspend(FAR struct tcb_s *tcb);
 #endif
@@ -428,6 +522,13 @@ void nxsched_critmon_csection(FAR struct tcb_s *tcb, bool state,
                               FAR void *caller);
 #endif
 
+/* Scheduling latency measurement */
+
+#ifdef CONFIG_SCHED_LATENCY
+void nxsched_ready_latency(FAR struct tcb_s *tcb);
+void nxsched_resume_latency(FAR struct tcb_s *tcb);
+#endif
+
 /* TCB operations */
 
 bool nxsched_verify_tcb(FAR struct tcb_s *tcb);
@@ -438,6 +539,15 @@ struct tls_info_s; /* Forward declare */
 FAR struct tls_info_s *nxsched_get_tls(FAR struct tcb_s *tcb);
 FAR char **nxsched_get_stackargs(FAR struct tcb_s *tcb);
 
+#ifdef CONFIG_SMP
+/* Asynchronous cross-CPU calls with a caller-owned descriptor */
+
+void nxsched_smp_call_init(FAR struct smp_call_data_s *data,
+                           nxsched_smp_call_t func, FAR void *arg);
+int nxsched_smp_call_single_async(int cpuid,
+                                  FAR struct smp_call_data_s *data);
+#endif
+
 /****************************************************************************
  * Inline functions
  ****************************************************************************/
@@ -447,19 +557,19 @@ static inline_function bool nxsched_add_prioritized(FAR struct tcb_s *tcb,
 {
   FAR struct tcb_s *next;
   FAR struct tcb_s *prev;
-  uint8_t sched_priority = tcb->sched_priority;
   bool ret = false;
 
   /* Lets do a sanity check before we get started. */
 
-  DEBUGASSERT(sched_priority >= SCHED_PRIORITY_MIN);
+  DEBUGASSERT(tcb->sched_priority >= SCHED_PRIORITY_MIN);
 
   /* Search the list to find the location to insert the new Tcb.
-   * Each is list is maintained in descending sched_priority order.
+   * Each is list is maintained in descending sched_priority order, see
+   * nxsched_preempts().
    */
 
   for (next = (FAR struct tcb_s *)list->head;
-       (next && sched_priority <= next->sched_priority);
+       (next && !nxsched_preempts(tcb, next));
        next = next->flink);
 
   /* Add the tcb to the spot found in the list.  Check if the tcb
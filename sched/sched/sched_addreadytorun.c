@@ -27,12 +27,128 @@
 #include <nuttx/config.h>
 
 #include <stdbool.h>
+#include <limits.h>
 #include <assert.h>
 
+#include <nuttx/power/cpufreq.h>
+
 #include "irq/irq.h"
 #include "sched/queue.h"
 #include "sched/sched.h"
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_RUNQUEUE_PERCPU
+/****************************************************************************
+ * Name:  nxsched_queue_length
+ *
+ * Description:
+ *   Return the number of tasks queued on a CPU, not counting the running
+ *   task and the IDLE task.
+ *
+ ****************************************************************************/
+
+static int nxsched_queue_length(int cpu)
+{
+  FAR struct tcb_s *tcb = (FAR struct tcb_s *)g_assignedtasks[cpu].head;
+  int count = 0;
+
+  for (tcb = tcb->flink; tcb != NULL && !is_idle_task(tcb);
+       tcb = tcb->flink)
+    {
+      count++;
+    }
+
+  return count;
+}
+
+/****************************************************************************
+ * Name:  nxsched_add_queue
+ *
+ * Description:
+ *   Queue a task that is ready-to-run, but cannot run right away, on the
+ *   CPU with the fewest queued tasks among the CPUs that it may run on.
+ *   The CPU that it last ran on wins a tie.
+ *
+ * Input Parameters:
+ *   tcb - The TCB to be queued
+ *
+ * Returned Value:
+ *   false if every CPU the task may run on runs a task of lower priority,
+ *   so that the task cannot be queued without preempting one of them.
+ *
+ * Assumptions:
+ *   The caller holds the critical section.  It protects the assigned task
+ *   lists of all CPUs, there is no lock per CPU.
+ *
+ ****************************************************************************/
+
+static bool nxsched_add_queue(FAR struct tcb_s *tcb)
+{
+  int bestlen = INT_MAX;
+  int best = -1;
+  int len;
+  int i;
+
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      /* The head of the list is the running task, the task must go
+       * behind it.
+       */
+
+      if (!CPU_ISSET(i, &tcb->affinity) ||
+          nxsched_preempts(tcb, current_task(i)))
+        {
+          continue;
+        }
+
+      len = nxsched_queue_length(i);
+      if (len < bestlen || (len == bestlen && i == tcb->cpu))
+        {
+          bestlen = len;
+          best    = i;
+        }
+    }
+
+  if (best < 0)
+    {
+      return false;
+    }
+
+  nxsched_add_prioritized(tcb, list_assignedtasks(best));
+  tcb->cpu        = best;
+  tcb->task_state = TSTATE_TASK_ASSIGNED;
+  return true;
+}
+#endif /* CONFIG_SCHED_RUNQUEUE_PERCPU */
+
+/****************************************************************************
+ * Name:  nxsched_add_waiting
+ *
+ * Description:
+ *   Add a task that is ready-to-run, but cannot run right away, to a ready
+ *   queue: the queue of one CPU (CONFIG_SCHED_RUNQUEUE_PERCPU) or, if no
+ *   CPU can take it, the g_readytorun list.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+static void nxsched_add_waiting(FAR struct tcb_s *tcb)
+{
+#ifdef CONFIG_SCHED_RUNQUEUE_PERCPU
+  if (nxsched_add_queue(tcb))
+    {
+      return;
+    }
+#endif
+
+  nxsched_add_prioritized(tcb, list_readytorun());
+  tcb->task_state = TSTATE_TASK_READYTORUN;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -71,13 +187,24 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
   FAR struct tcb_s *rtcb = this_task();
   bool ret;
 
+#ifdef CONFIG_SCHED_LATENCY
+  nxsched_ready_latency(btcb);
+#endif
+
+#ifdef CONFIG_CPUFREQ_BOOST
+  if (btcb->sched_priority >= CONFIG_CPUFREQ_BOOST_PRIORITY)
+    {
+      cpufreq_boost();
+    }
+#endif
+
   /* Check if pre-emption is disabled for the current running task and if
    * the new ready-to-run task would cause the current running task to be
    * pre-empted.  NOTE that IRQs disabled implies that pre-emption is
    * also disabled.
    */
 
-  if (rtcb->lockcount > 0 && rtcb->sched_priority < btcb->sched_priority)
+  if (rtcb->lockcount > 0 && nxsched_preempts(btcb, rtcb))
     {
       /* Yes.  Preemption would occur!  Add the new ready-to-run task to the
        * g_pendingtasks task list for now.
@@ -161,6 +288,17 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
   int cpu;
   int me;
 
+#ifdef CONFIG_SCHED_LATENCY
+  nxsched_ready_latency(btcb);
+#endif
+
+#ifdef CONFIG_CPUFREQ_BOOST
+  if (btcb->sched_priority >= CONFIG_CPUFREQ_BOOST_PRIORITY)
+    {
+      cpufreq_boost();
+    }
+#endif
+
   cpu = nxsched_select_cpu(btcb->affinity);
 
   /* Get the task currently running on the CPU (may be the IDLE task) */
@@ -173,7 +311,7 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
    * required.
    */
 
-  if (rtcb->sched_priority < btcb->sched_priority)
+  if (nxsched_preempts(btcb, rtcb))
     {
       task_state = TSTATE_TASK_RUNNING;
     }
@@ -215,10 +353,8 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
        * Add the task to the ready-to-run (but not running) task list
        */
 
-      nxsched_add_prioritized(btcb, list_readytorun());
-
-      btcb->task_state = TSTATE_TASK_READYTORUN;
-      doswitch         = false;
+      nxsched_add_waiting(btcb);
+      doswitch = false;
     }
   else /* (task_state == TSTATE_TASK_RUNNING) */
     {
@@ -239,18 +375,16 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
           else
             {
               rtcb = g_delivertasks[cpu];
-              if (rtcb->sched_priority < btcb->sched_priority)
+              if (nxsched_preempts(btcb, rtcb))
                 {
                   g_delivertasks[cpu] = btcb;
                   btcb->cpu = cpu;
                   btcb->task_state = TSTATE_TASK_ASSIGNED;
-                  nxsched_add_prioritized(rtcb, &g_readytorun);
-                  rtcb->task_state = TSTATE_TASK_READYTORUN;
+                  nxsched_add_waiting(rtcb);
                 }
               else
                 {
-                  nxsched_add_prioritized(btcb, &g_readytorun);
-                  btcb->task_state = TSTATE_TASK_READYTORUN;
+                  nxsched_add_waiting(btcb);
                 }
             }
 
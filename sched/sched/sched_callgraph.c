@@ -0,0 +1,287 @@
+/****************************************************************************
+ * sched/sched/sched_callgraph.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <errno.h>
+#include <string.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/sched_callgraph.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/wdog.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_CALLGRAPH
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if (CONFIG_SCHED_CALLGRAPH_NSTACKS & \
+     (CONFIG_SCHED_CALLGRAPH_NSTACKS - 1)) != 0
+#  error CONFIG_SCHED_CALLGRAPH_NSTACKS must be a power of two
+#endif
+
+/* The hash table is kept at most half full, so that the probes are short
+ * even in interrupt context.
+ */
+
+#define CALLGRAPH_HASHSIZE  (2 * CONFIG_SCHED_CALLGRAPH_NSTACKS)
+#define CALLGRAPH_HASHMASK  (CALLGRAPH_HASHSIZE - 1)
+
+#define CALLGRAPH_TICK \
+  MAX(NSEC2TICK(NSEC_PER_SEC / CONFIG_SCHED_CALLGRAPH_RATE), 1)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct sched_callgraph_stack_s
+  g_callgraph_stack[CONFIG_SCHED_CALLGRAPH_NSTACKS];
+
+/* The index + 1 of the stacks, 0 for an empty slot */
+
+static uint16_t g_callgraph_hash[CALLGRAPH_HASHSIZE];
+
+static unsigned int g_callgraph_nstacks;
+static unsigned long g_callgraph_nsamples;
+static unsigned long g_callgraph_ndropped;
+static volatile bool g_callgraph_running;
+static struct wdog_s g_callgraph_timer;
+static spinlock_t g_callgraph_lock = SP_UNLOCKED;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint32_t callgraph_hash(FAR void * const *backtrace)
+{
+  uint32_t hash = 2166136261u;
+  int i;
+
+  for (i = 0; i < CONFIG_SCHED_CALLGRAPH_DEPTH && backtrace[i] != NULL; i++)
+    {
+      hash = (hash ^ (uint32_t)(uintptr_t)backtrace[i]) * 16777619u;
+    }
+
+  return (hash ^ (hash >> 16)) & CALLGRAPH_HASHMASK;
+}
+
+#ifdef CONFIG_SMP
+static int callgraph_sample_cpu(FAR void *arg)
+{
+  sched_callgraph_sample();
+  return OK;
+}
+#endif
+
+static void callgraph_timer(wdparm_t arg)
+{
+  if (!g_callgraph_running)
+    {
+      return;
+    }
+
+#ifdef CONFIG_SMP
+  cpu_set_t cpus = (1 << CONFIG_SMP_NCPUS) - 1;
+  CPU_CLR(this_cpu(), &cpus);
+  nxsched_smp_call(cpus, callgraph_sample_cpu, NULL, false);
+#endif
+
+  sched_callgraph_sample();
+  wd_start(&g_callgraph_timer, CALLGRAPH_TICK, callgraph_timer, 0);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_callgraph_start
+ *
+ * Description:
+ *   Start sampling the call stacks of the threads running on every CPU.
+ *
+ ****************************************************************************/
+
+void sched_callgraph_start(void)
+{
+  if (!g_callgraph_running)
+    {
+      g_callgraph_running = true;
+      wd_start(&g_callgraph_timer, CALLGRAPH_TICK, callgraph_timer, 0);
+    }
+}
+
+/****************************************************************************
+ * Name: sched_callgraph_stop
+ *
+ * Description:
+ *   Stop sampling, the samples taken so far are kept.
+ *
+ ****************************************************************************/
+
+void sched_callgraph_stop(void)
+{
+  g_callgraph_running = false;
+  wd_cancel(&g_callgraph_timer);
+}
+
+/****************************************************************************
+ * Name: sched_callgraph_reset
+ *
+ * Description:
+ *   Drop the samples taken so far.
+ *
+ ****************************************************************************/
+
+void sched_callgraph_reset(void)
+{
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&g_callgraph_lock);
+  memset(g_callgraph_hash, 0, sizeof(g_callgraph_hash));
+  g_callgraph_nstacks  = 0;
+  g_callgraph_nsamples = 0;
+  g_callgraph_ndropped = 0;
+  spin_unlock_irqrestore(&g_callgraph_lock, flags);
+}
+
+/****************************************************************************
+ * Name: sched_callgraph_sample
+ *
+ * Description:
+ *   Record the call stack of the thread interrupted on this CPU.  In
+ *   interrupt context up_backtrace() starts from the interrupted registers.
+ *
+ ****************************************************************************/
+
+void sched_callgraph_sample(void)
+{
+  FAR void *backtrace[CONFIG_SCHED_CALLGRAPH_DEPTH];
+  FAR struct sched_callgraph_stack_s *stack;
+  irqstate_t flags;
+  uint32_t slot;
+  unsigned int index;
+
+  if (!g_callgraph_running)
+    {
+      return;
+    }
+
+  memset(backtrace, 0, sizeof(backtrace));
+  if (up_backtrace(this_task(), backtrace,
+                   CONFIG_SCHED_CALLGRAPH_DEPTH, 0) <= 0)
+    {
+      backtrace[0] = (FAR void *)up_getusrpc(NULL);
+    }
+
+  slot = callgraph_hash(backtrace);
+
+  flags = spin_lock_irqsave(&g_callgraph_lock);
+
+  for (; (index = g_callgraph_hash[slot]) != 0;
+       slot = (slot + 1) & CALLGRAPH_HASHMASK)
+    {
+      stack = &g_callgraph_stack[index - 1];
+      if (memcmp(stack->backtrace, backtrace, sizeof(backtrace)) == 0)
+        {
+          break;
+        }
+    }
+
+  if (index == 0)
+    {
+      if (g_callgraph_nstacks >= CONFIG_SCHED_CALLGRAPH_NSTACKS)
+        {
+          g_callgraph_ndropped++;
+          goto out;
+        }
+
+      stack = &g_callgraph_stack[g_callgraph_nstacks++];
+      memcpy(stack->backtrace, backtrace, sizeof(backtrace));
+      stack->count = 0;
+      g_callgraph_hash[slot] = g_callgraph_nstacks;
+    }
+
+  stack->count++;
+  g_callgraph_nsamples++;
+
+out:
+  spin_unlock_irqrestore(&g_callgraph_lock, flags);
+}
+
+/****************************************************************************
+ * Name: sched_callgraph_info
+ *
+ * Description:
+ *   Return the state and the totals of the profile.
+ *
+ ****************************************************************************/
+
+void sched_callgraph_info(FAR struct sched_callgraph_s *info)
+{
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&g_callgraph_lock);
+  info->running  = g_callgraph_running;
+  info->rate     = CONFIG_SCHED_CALLGRAPH_RATE;
+  info->nstacks  = g_callgraph_nstacks;
+  info->nsamples = g_callgraph_nsamples;
+  info->ndropped = g_callgraph_ndropped;
+  spin_unlock_irqrestore(&g_callgraph_lock, flags);
+}
+
+/****************************************************************************
+ * Name: sched_callgraph_stack
+ *
+ * Description:
+ *   Return a snapshot of one call stack.
+ *
+ ****************************************************************************/
+
+int sched_callgraph_stack(unsigned int index,
+                          FAR struct sched_callgraph_stack_s *stack)
+{
+  irqstate_t flags;
+  int ret = -ENOENT;
+
+  flags = spin_lock_irqsave(&g_callgraph_lock);
+  if (index < g_callgraph_nstacks)
+    {
+      *stack = g_callgraph_stack[index];
+      ret = OK;
+    }
+
+  spin_unlock_irqrestore(&g_callgraph_lock, flags);
+  return ret;
+}
+
+#endif /* CONFIG_SCHED_CALLGRAPH */
@@ -31,6 +31,7 @@
 
 #include <nuttx/clock.h>
 #include <nuttx/irq.h>
+#include <nuttx/power/cpufreq.h>
 #include <nuttx/wdog.h>
 
 #include "sched/sched.h"
@@ -138,6 +139,14 @@ void nxsched_process_taskload_ticks(FAR struct tcb_s *tcb, clock_t ticks)
   tcb->ticks += ticks;
   g_cpuload_total += ticks;
 
+#ifdef CONFIG_CPUFREQ
+#  ifdef CONFIG_SMP
+  cpufreq_update_load(tcb->cpu, ticks, is_idle_task(tcb));
+#  else
+  cpufreq_update_load(0, ticks, is_idle_task(tcb));
+#  endif
+#endif
+
   if (g_cpuload_total > CPULOAD_TIMECONSTANT)
     {
       uint32_t total = 0;
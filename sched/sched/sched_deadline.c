@@ -0,0 +1,410 @@
+/****************************************************************************
+ * sched/sched/sched_deadline.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <sched.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+
+#include <nuttx/sched.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/wdog.h>
+#include <nuttx/clock.h>
+
+#include "clock/clock.h"
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_DEADLINE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Bandwidths are runtime / period in units of 2^-DEADLINE_BW_SHIFT */
+
+#define DEADLINE_BW_SHIFT  20
+#define DEADLINE_BW_LIMIT \
+  (((uint32_t)CONFIG_SCHED_DEADLINE_BANDWIDTH << DEADLINE_BW_SHIFT) / 100)
+
+#ifdef CONFIG_SMP
+#  define DEADLINE_CPU(dl) ((dl)->cpu)
+#else
+#  define DEADLINE_CPU(dl) 0
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The bandwidth reserved by the deadline threads of each CPU */
+
+static uint32_t g_deadline_bw[CONFIG_SMP_NCPUS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: deadline_set_priority
+ *
+ * Description:
+ *   Change the priority of a deadline thread, leaving it at its boosted
+ *   priority if priority inheritance has raised it above the new one.
+ *
+ * Input Parameters:
+ *   tcb      - TCB of the deadline thread
+ *   priority - CONFIG_SCHED_DEADLINE_PRIORITY or SCHED_PRIORITY_MIN
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void deadline_set_priority(FAR struct tcb_s *tcb, int priority)
+{
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  if (tcb->sched_priority > tcb->base_priority &&
+      tcb->sched_priority > priority)
+    {
+      tcb->base_priority = priority;
+      return;
+    }
+#endif
+
+  DEBUGVERIFY(nxsched_reprioritize(tcb, priority));
+}
+
+/****************************************************************************
+ * Name: deadline_replenish
+ *
+ * Description:
+ *   Called when the deadline of a throttled thread is reached:  give it the
+ *   runtime of its next period and the deadline of that period.
+ *
+ * Input Parameters:
+ *   arg - The TCB of the deadline thread
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from the timer interrupt handler.
+ *
+ ****************************************************************************/
+
+static void deadline_replenish(wdparm_t arg)
+{
+  FAR struct tcb_s *tcb = (FAR struct tcb_s *)arg;
+  FAR struct deadline_s *dl;
+  irqstate_t flags;
+  clock_t now;
+
+  flags = enter_critical_section();
+
+  dl = tcb->deadline;
+  DEBUGASSERT(dl != NULL && dl->throttled);
+
+  /* An overrun of more than a period starts again from now */
+
+  now = clock_systime_ticks();
+  dl->absdeadline += dl->period;
+  if ((sclock_t)(dl->absdeadline - dl->reldeadline - now) < 0)
+    {
+      dl->absdeadline = now + dl->reldeadline;
+    }
+
+  dl->budget    = dl->runtime;
+  dl->throttled = false;
+
+  /* Back to the deadline priority, where the thread is queued by its new
+   * deadline.
+   */
+
+  deadline_set_priority(tcb, CONFIG_SCHED_DEADLINE_PRIORITY);
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_start_deadline
+ *
+ * Description:
+ *   Admit a thread to the SCHED_DEADLINE policy, or change the parameters
+ *   of a deadline thread.  The bandwidth runtime / period of the thread is
+ *   reserved on its CPU if the total stays within
+ *   CONFIG_SCHED_DEADLINE_BANDWIDTH percent.  The thread starts a new job
+ *   with its full runtime; its priority is not changed here.
+ *
+ * Input Parameters:
+ *   tcb   - The TCB of the thread
+ *   param - The sched_dl_runtime, sched_dl_deadline and sched_dl_period
+ *           parameters.  A zero deadline is the period and a zero period
+ *           is the deadline.
+ *
+ * Returned Value:
+ *   Returns zero (OK) on success or a negated errno value on failure:
+ *
+ *   EINVAL The parameters are not runtime <= deadline <= period, or under
+ *          SMP the affinity of the thread is not a single CPU.
+ *   EBUSY  The bandwidth of the CPU is exhausted.
+ *   ENOMEM The deadline data could not be allocated.
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+int nxsched_start_deadline(FAR struct tcb_s *tcb,
+                           FAR const struct sched_param *param)
+{
+  FAR struct deadline_s *dl;
+  clock_t runtime;
+  clock_t reldeadline;
+  clock_t period;
+  uint32_t bandwidth;
+  uint32_t reserved;
+  int cpu = 0;
+
+  DEBUGASSERT(tcb != NULL && param != NULL);
+
+  runtime     = clock_time2ticks(&param->sched_dl_runtime);
+  reldeadline = clock_time2ticks(&param->sched_dl_deadline);
+  period      = clock_time2ticks(&param->sched_dl_period);
+
+  if (reldeadline == 0)
+    {
+      reldeadline = period;
+    }
+
+  if (period == 0)
+    {
+      period = reldeadline;
+    }
+
+  if (runtime == 0 || runtime > reldeadline || reldeadline > period)
+    {
+      return -EINVAL;
+    }
+
+#ifdef CONFIG_SMP
+  /* Deadline threads are partitioned: each one runs on a single CPU */
+
+  if (CPU_COUNT(&tcb->affinity) != 1)
+    {
+      return -EINVAL;
+    }
+
+  for (cpu = 0; !CPU_ISSET(cpu, &tcb->affinity); cpu++);
+#endif
+
+  /* Admission control, not counting the old bandwidth of the thread */
+
+  bandwidth = ((uint64_t)runtime << DEADLINE_BW_SHIFT) / period;
+  reserved  = g_deadline_bw[cpu];
+
+  dl = tcb->deadline;
+  if (dl != NULL && DEADLINE_CPU(dl) == cpu)
+    {
+      reserved -= dl->bandwidth;
+    }
+
+  if (bandwidth > DEADLINE_BW_LIMIT - reserved)
+    {
+      return -EBUSY;
+    }
+
+  if (dl == NULL)
+    {
+      dl = kmm_zalloc(sizeof(struct deadline_s));
+      if (dl == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      tcb->deadline = dl;
+    }
+  else
+    {
+      wd_cancel(&dl->timer);
+      g_deadline_bw[DEADLINE_CPU(dl)] -= dl->bandwidth;
+    }
+
+  g_deadline_bw[cpu] += bandwidth;
+
+  dl->runtime     = runtime;
+  dl->reldeadline = reldeadline;
+  dl->period      = period;
+  dl->bandwidth   = bandwidth;
+#ifdef CONFIG_SMP
+  dl->cpu         = cpu;
+#endif
+  dl->absdeadline = clock_systime_ticks() + reldeadline;
+  dl->budget      = runtime;
+  dl->throttled   = false;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxsched_stop_deadline
+ *
+ * Description:
+ *   Release the bandwidth and the data of a thread leaving the
+ *   SCHED_DEADLINE policy or exiting.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread
+ *
+ * Returned Value:
+ *   Returns zero (OK) on success or a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int nxsched_stop_deadline(FAR struct tcb_s *tcb)
+{
+  FAR struct deadline_s *dl;
+  irqstate_t flags;
+
+  DEBUGASSERT(tcb != NULL && tcb->deadline != NULL);
+
+  flags = enter_critical_section();
+
+  dl = tcb->deadline;
+  wd_cancel(&dl->timer);
+  g_deadline_bw[DEADLINE_CPU(dl)] -= dl->bandwidth;
+  tcb->deadline = NULL;
+
+  leave_critical_section(flags);
+
+  kmm_free(dl);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxsched_wakeup_deadline
+ *
+ * Description:
+ *   Apply the wakeup rule of the constant bandwidth server to a deadline
+ *   thread that becomes ready to run:  if the current deadline is past, or
+ *   the budget left would make the thread use more than its bandwidth
+ *   until that deadline, start a new job with a new deadline and the full
+ *   runtime.  Otherwise the thread continues with the current ones.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the deadline thread, in no task list
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+void nxsched_wakeup_deadline(FAR struct tcb_s *tcb)
+{
+  FAR struct deadline_s *dl = tcb->deadline;
+  sclock_t left;
+  clock_t now;
+
+  DEBUGASSERT(dl != NULL);
+
+  /* A throttled thread waits for its replenishment */
+
+  if (dl->throttled)
+    {
+      return;
+    }
+
+  now  = clock_systime_ticks();
+  left = (sclock_t)(dl->absdeadline - now);
+
+  if (left <= 0 ||
+      (uint64_t)dl->budget * dl->period > (uint64_t)left * dl->runtime)
+    {
+      dl->absdeadline = now + dl->reldeadline;
+      dl->budget      = dl->runtime;
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_process_deadline
+ *
+ * Description:
+ *   Charge the running deadline thread for the ticks it ran.  When its
+ *   runtime is exhausted the thread is throttled:  it drops to
+ *   SCHED_PRIORITY_MIN, where it only uses the idle time, until its
+ *   deadline where deadline_replenish() gives it the next period.
+ *
+ * Input Parameters:
+ *   tcb   - The TCB of the running deadline thread
+ *   ticks - The number of ticks it ran
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from the timer interrupt handler within a critical section.
+ *
+ ****************************************************************************/
+
+void nxsched_process_deadline(FAR struct tcb_s *tcb, uint32_t ticks)
+{
+  FAR struct deadline_s *dl = tcb->deadline;
+  sclock_t delay;
+
+  DEBUGASSERT(dl != NULL);
+
+  if (dl->throttled)
+    {
+      return;
+    }
+
+  dl->budget -= ticks;
+  if (dl->budget > 0)
+    {
+      return;
+    }
+
+  dl->throttled = true;
+
+  delay = (sclock_t)(dl->absdeadline - clock_systime_ticks());
+  if (delay < 1)
+    {
+      delay = 1;
+    }
+
+  wd_start(&dl->timer, delay, deadline_replenish, (wdparm_t)tcb);
+  deadline_set_priority(tcb, SCHED_PRIORITY_MIN);
+}
+
+#endif /* CONFIG_SCHED_DEADLINE */
@@ -0,0 +1,130 @@
+/****************************************************************************
+ * sched/sched/sched_get_taskstats.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <string.h>
+#include <assert.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/sched.h>
+
+#include "sched/sched.h"
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct taskstats_arg_s
+{
+  FAR struct taskstat_s *stats;  /* Array to fill */
+  size_t                 nstats; /* Number of entries in the array */
+  size_t                 count;  /* Number of threads visited */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_get_taskstat
+ *
+ * Description:
+ *   Fill the next entry of the snapshot from one TCB.  Called from
+ *   nxsched_foreach() within a critical section.
+ *
+ ****************************************************************************/
+
+static void nxsched_get_taskstat(FAR struct tcb_s *tcb, FAR void *arg)
+{
+  FAR struct taskstats_arg_s *ctx = arg;
+  FAR struct taskstat_s *stat;
+
+  if (ctx->count < ctx->nstats)
+    {
+      stat                = &ctx->stats[ctx->count];
+      stat->pid           = tcb->pid;
+      stat->group         = tcb->group != NULL ? tcb->group->tg_pid : -1;
+      stat->flags         = tcb->flags;
+      stat->state         = tcb->task_state;
+      stat->priority      = tcb->sched_priority;
+      stat->init_priority = tcb->init_priority;
+#ifdef CONFIG_SMP
+      stat->cpu           = tcb->cpu;
+#else
+      stat->cpu           = 0;
+#endif
+#ifndef CONFIG_SCHED_CPULOAD_NONE
+      stat->ticks         = tcb->ticks;
+#endif
+      stat->stack_size    = tcb->adj_stack_size;
+#ifdef CONFIG_STACK_COLORATION
+      stat->stack_used    = up_check_tcbstack(tcb);
+#endif
+#if CONFIG_TASK_NAME_SIZE > 0
+      strlcpy(stat->name, tcb->name, sizeof(stat->name));
+#endif
+    }
+
+  ctx->count++;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_get_taskstats
+ *
+ * Description:
+ *   Report a snapshot of the state of all threads in one call, so that
+ *   monitoring tools need not open and parse the procfs files of each
+ *   thread.
+ *
+ * Input Parameters:
+ *   stats  - User-provided array to return the thread information.
+ *   nstats - The number of entries in the array.
+ *
+ * Returned Value:
+ *   The number of threads in the system, which may be more than nstats.
+ *   Only the first nstats of them are returned.
+ *
+ ****************************************************************************/
+
+ssize_t nxsched_get_taskstats(FAR struct taskstat_s *stats, size_t nstats)
+{
+  struct taskstats_arg_s ctx;
+
+  DEBUGASSERT(stats != NULL || nstats == 0);
+
+  ctx.stats  = stats;
+  ctx.nstats = nstats;
+  ctx.count  = 0;
+
+  nxsched_foreach(nxsched_get_taskstat, &ctx);
+  return ctx.count;
+}
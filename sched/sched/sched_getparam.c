@@ -138,6 +138,29 @@ int nxsched_get_param(pid_t pid, FAR struct sched_param *param)
               param->sched_ss_init_budget.tv_nsec = 0;
             }
 #endif
+
+#ifdef CONFIG_SCHED_DEADLINE
+          if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+            {
+              FAR struct deadline_s *dl = tcb->deadline;
+              DEBUGASSERT(dl != NULL);
+
+              /* Return parameters associated with SCHED_DEADLINE */
+
+              clock_ticks2time(&param->sched_dl_runtime, dl->runtime);
+              clock_ticks2time(&param->sched_dl_deadline, dl->reldeadline);
+              clock_ticks2time(&param->sched_dl_period, dl->period);
+            }
+          else
+            {
+              param->sched_dl_runtime.tv_sec   = 0;
+              param->sched_dl_runtime.tv_nsec  = 0;
+              param->sched_dl_deadline.tv_sec  = 0;
+              param->sched_dl_deadline.tv_nsec = 0;
+              param->sched_dl_period.tv_sec    = 0;
+              param->sched_dl_period.tv_nsec   = 0;
+            }
+#endif
         }
 
       leave_critical_section(flags);
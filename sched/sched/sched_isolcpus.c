@@ -0,0 +1,97 @@
+/****************************************************************************
+ * sched/sched/sched_isolcpus.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <sched.h>
+
+#include <nuttx/sched.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SMP_ISOLCPUS
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_cpu_nohz
+ *
+ * Description:
+ *   Check if the timeslice of the task running on a CPU can be left alone:
+ *   the CPU is isolated and no other task of the same or a higher priority
+ *   waits to run on it, so the task would get its next timeslice anyway.
+ *
+ * Input Parameters:
+ *   cpu - The CPU to check
+ *
+ * Returned Value:
+ *   true if the task runs alone on an isolated CPU.
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+bool nxsched_cpu_nohz(int cpu)
+{
+  FAR struct tcb_s *rtcb = current_task(cpu);
+  FAR struct tcb_s *tcb;
+
+  if (!nxsched_cpu_isolated(cpu) || is_idle_task(rtcb))
+    {
+      return false;
+    }
+
+  /* The tasks assigned to the CPU follow the running one */
+
+  tcb = rtcb->flink;
+  if (tcb != NULL && !is_idle_task(tcb) &&
+      tcb->sched_priority >= rtcb->sched_priority)
+    {
+      return false;
+    }
+
+  /* And the ready-to-run list holds the tasks that may run on several
+   * CPUs, in descending priority order.
+   */
+
+  for (tcb = (FAR struct tcb_s *)list_readytorun()->head;
+       tcb != NULL && tcb->sched_priority >= rtcb->sched_priority;
+       tcb = tcb->flink)
+    {
+      if (CPU_ISSET(cpu, &tcb->affinity))
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+
+#endif /* CONFIG_SMP_ISOLCPUS */
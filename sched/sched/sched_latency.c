@@ -0,0 +1,331 @@
+/****************************************************************************
+ * sched/sched/sched_latency.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+#include <nuttx/kthread.h>
+#include <nuttx/sched_latency.h>
+#include <nuttx/signal.h>
+#include <nuttx/spinlock.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_LATENCY
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define LATENCY_BANDWIDTH \
+  ((256 + CONFIG_SCHED_LATENCY_NBANDS - 1) / CONFIG_SCHED_LATENCY_NBANDS)
+
+#define LATENCY_THRESHOLD  (CONFIG_SCHED_LATENCY_THRESHOLD_US * NSEC_PER_USEC)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct sched_latency_s g_latency_cpu[CONFIG_SMP_NCPUS];
+static struct sched_latency_s g_latency_prio[CONFIG_SCHED_LATENCY_NBANDS];
+static struct sched_latency_s g_latency_test;
+static spinlock_t g_latency_lock = SP_UNLOCKED;
+
+static unsigned long g_latency_loops;
+static unsigned long g_latency_interval;
+static volatile bool g_latency_testing;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static int latency_index(uint32_t ns)
+{
+  int shift;
+  int index;
+
+  if (ns < (1u << SCHED_LATENCY_MINSHIFT))
+    {
+      return 0;
+    }
+
+  /* The power of two, then the two bits after the leading one */
+
+  shift = flsl(ns) - 1;
+  index = 1 + 4 * (shift - SCHED_LATENCY_MINSHIFT) +
+          ((ns >> (shift - 2)) & 3);
+
+  return index < SCHED_LATENCY_NBUCKETS ? index :
+                 SCHED_LATENCY_NBUCKETS - 1;
+}
+
+static void latency_add(FAR struct sched_latency_s *latency, uint32_t ns)
+{
+  latency->count++;
+  latency->sum += ns;
+  latency->bucket[latency_index(ns)]++;
+
+  if (ns > latency->max)
+    {
+      latency->max = ns;
+    }
+
+  if (ns > LATENCY_THRESHOLD)
+    {
+      latency->over++;
+    }
+}
+
+static uint32_t latency_nsec(clock_t elapsed)
+{
+  struct timespec ts;
+
+  perf_convert(elapsed, &ts);
+  if (ts.tv_sec >= 4)
+    {
+      return UINT32_MAX;
+    }
+
+  return ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+static int latency_test(int argc, FAR char *argv[])
+{
+  struct timespec target;
+  struct timespec now;
+  struct timespec interval;
+  irqstate_t flags;
+  unsigned long i;
+  int64_t ns;
+
+  interval.tv_sec  = g_latency_interval / USEC_PER_SEC;
+  interval.tv_nsec = (g_latency_interval % USEC_PER_SEC) * NSEC_PER_USEC;
+
+  nxclock_gettime(CLOCK_MONOTONIC, &target);
+
+  for (i = 0; i < g_latency_loops && g_latency_testing; i++)
+    {
+      /* Sleep until an absolute time, so that the error does not
+       * accumulate, and record how late the thread runs again.
+       */
+
+      clock_timespec_add(&target, &interval, &target);
+
+      flags = enter_critical_section();
+      nxsig_clockwait(CLOCK_MONOTONIC, TIMER_ABSTIME, &target, NULL);
+      leave_critical_section(flags);
+
+      nxclock_gettime(CLOCK_MONOTONIC, &now);
+
+      ns = (int64_t)(now.tv_sec - target.tv_sec) * NSEC_PER_SEC +
+           now.tv_nsec - target.tv_nsec;
+      ns = ns < 0 ? 0 : ns > UINT32_MAX ? UINT32_MAX : ns;
+
+      flags = spin_lock_irqsave(&g_latency_lock);
+      latency_add(&g_latency_test, ns);
+      spin_unlock_irqrestore(&g_latency_lock, flags);
+    }
+
+  g_latency_testing = false;
+  return EXIT_SUCCESS;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_ready_latency
+ *
+ * Description:
+ *   Stamp the time a thread is made ready-to-run.  A thread moved from the
+ *   pending list keeps the first stamp, so that the time spent waiting for
+ *   the scheduler to be unlocked is counted.
+ *
+ ****************************************************************************/
+
+void nxsched_ready_latency(FAR struct tcb_s *tcb)
+{
+  if (tcb->wakeup_time == 0)
+    {
+      tcb->wakeup_time = perf_gettime();
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_resume_latency
+ *
+ * Description:
+ *   Count the time from the stamp of a thread to its resumption on this
+ *   CPU.
+ *
+ ****************************************************************************/
+
+void nxsched_resume_latency(FAR struct tcb_s *tcb)
+{
+  irqstate_t flags;
+  uint32_t ns;
+  int band;
+
+  if (tcb->wakeup_time == 0)
+    {
+      return;
+    }
+
+  ns   = latency_nsec(perf_gettime() - tcb->wakeup_time);
+  band = tcb->sched_priority / LATENCY_BANDWIDTH;
+  tcb->wakeup_time = 0;
+
+  flags = spin_lock_irqsave(&g_latency_lock);
+  latency_add(&g_latency_cpu[this_cpu()], ns);
+  latency_add(&g_latency_prio[band], ns);
+  spin_unlock_irqrestore(&g_latency_lock, flags);
+}
+
+/****************************************************************************
+ * Name: sched_latency_get
+ *
+ * Description:
+ *   Return a snapshot of one histogram.
+ *
+ ****************************************************************************/
+
+int sched_latency_get(int type, int index,
+                      FAR struct sched_latency_s *latency)
+{
+  FAR struct sched_latency_s *src;
+  irqstate_t flags;
+
+  if (type == SCHED_LATENCY_CPU && index >= 0 && index < CONFIG_SMP_NCPUS)
+    {
+      src = &g_latency_cpu[index];
+    }
+  else if (type == SCHED_LATENCY_PRIO && index >= 0 &&
+           index < CONFIG_SCHED_LATENCY_NBANDS)
+    {
+      src = &g_latency_prio[index];
+    }
+  else if (type == SCHED_LATENCY_TEST && index == 0)
+    {
+      src = &g_latency_test;
+    }
+  else
+    {
+      return -ENOENT;
+    }
+
+  flags = spin_lock_irqsave(&g_latency_lock);
+  memcpy(latency, src, sizeof(*latency));
+  spin_unlock_irqrestore(&g_latency_lock, flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: sched_latency_bucket
+ *
+ * Description:
+ *   Return the lowest latency in nanoseconds counted by a bucket.
+ *
+ ****************************************************************************/
+
+uint32_t sched_latency_bucket(int bucket)
+{
+  int shift;
+
+  if (bucket <= 0)
+    {
+      return 0;
+    }
+
+  shift = SCHED_LATENCY_MINSHIFT + (bucket - 1) / 4;
+  return (uint32_t)(4 + (bucket - 1) % 4) << (shift - 2);
+}
+
+/****************************************************************************
+ * Name: sched_latency_reset
+ *
+ * Description:
+ *   Clear all the histograms.
+ *
+ ****************************************************************************/
+
+void sched_latency_reset(void)
+{
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&g_latency_lock);
+  memset(g_latency_cpu, 0, sizeof(g_latency_cpu));
+  memset(g_latency_prio, 0, sizeof(g_latency_prio));
+  memset(&g_latency_test, 0, sizeof(g_latency_test));
+  spin_unlock_irqrestore(&g_latency_lock, flags);
+}
+
+/****************************************************************************
+ * Name: sched_latency_selftest
+ *
+ * Description:
+ *   Start a cyclictest-like kernel thread that records how late its
+ *   absolute timer sleeps wake up.
+ *
+ ****************************************************************************/
+
+int sched_latency_selftest(unsigned long loops, unsigned long interval)
+{
+  irqstate_t flags;
+  int ret;
+
+  flags = spin_lock_irqsave(&g_latency_lock);
+  if (g_latency_testing)
+    {
+      spin_unlock_irqrestore(&g_latency_lock, flags);
+      return -EBUSY;
+    }
+
+  g_latency_testing  = true;
+  g_latency_loops    = loops;
+  g_latency_interval = interval;
+  spin_unlock_irqrestore(&g_latency_lock, flags);
+
+  ret = kthread_create("latency", CONFIG_SCHED_LATENCY_TEST_PRIORITY,
+                       CONFIG_DEFAULT_TASK_STACKSIZE, latency_test, NULL);
+  if (ret < 0)
+    {
+      g_latency_testing = false;
+      return ret;
+    }
+
+  return OK;
+}
+
+#endif /* CONFIG_SCHED_LATENCY */
@@ -0,0 +1,383 @@
+/****************************************************************************
+ * sched/sched/sched_lockstat.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <string.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+#include <nuttx/lockstat.h>
+#include <nuttx/sched_note.h>
+#include <nuttx/spinlock.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_LOCKSTAT
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if (CONFIG_SCHED_LOCKSTAT_NCLASSES & \
+     (CONFIG_SCHED_LOCKSTAT_NCLASSES - 1)) != 0
+#  error CONFIG_SCHED_LOCKSTAT_NCLASSES must be a power of two
+#endif
+
+/* The hash table is kept at most half full, so that the probes are short */
+
+#define LOCKSTAT_HASHSIZE  (2 * CONFIG_SCHED_LOCKSTAT_NCLASSES)
+#define LOCKSTAT_HASHMASK  (LOCKSTAT_HASHSIZE - 1)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A spinlock being taken or held by a CPU */
+
+struct lockstat_held_s
+{
+  FAR volatile spinlock_t *lock;
+  clock_t start;                   /* When the wait, then the hold began */
+  bool contended;                  /* The lock was taken when asked for */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct lockstat_s g_lockstat[CONFIG_SCHED_LOCKSTAT_NCLASSES];
+
+/* The index + 1 of the classes, 0 for an empty slot */
+
+static uint16_t g_lockstat_hash[LOCKSTAT_HASHSIZE];
+
+static unsigned int g_lockstat_nclasses;
+static unsigned long g_lockstat_dropped;
+
+/* The statistics are updated from within the spinlock functions, so their
+ * own lock must be taken without the instrumentation.
+ */
+
+static spinlock_t g_lockstat_lock = SP_UNLOCKED;
+
+#ifdef CONFIG_SPINLOCK
+static struct lockstat_held_s
+  g_lockstat_held[CONFIG_SMP_NCPUS][CONFIG_SCHED_LOCKSTAT_DEPTH];
+static uint8_t g_lockstat_nheld[CONFIG_SMP_NCPUS];
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lockstat_class
+ *
+ * Description:
+ *   Find the class of a site, or add it.  Called with g_lockstat_lock
+ *   held.
+ *
+ ****************************************************************************/
+
+static FAR struct lockstat_s *lockstat_class(int type, FAR void *site)
+{
+  FAR struct lockstat_s *stat;
+  uint32_t hash;
+
+  hash = ((uint32_t)((uintptr_t)site >> 2) * 2654435761u + type) &
+         LOCKSTAT_HASHMASK;
+
+  while (g_lockstat_hash[hash] != 0)
+    {
+      stat = &g_lockstat[g_lockstat_hash[hash] - 1];
+      if (stat->site == site && stat->type == type)
+        {
+          return stat;
+        }
+
+      hash = (hash + 1) & LOCKSTAT_HASHMASK;
+    }
+
+  if (g_lockstat_nclasses >= CONFIG_SCHED_LOCKSTAT_NCLASSES)
+    {
+      return NULL;
+    }
+
+  stat       = &g_lockstat[g_lockstat_nclasses++];
+  stat->site = site;
+  stat->type = type;
+  g_lockstat_hash[hash] = g_lockstat_nclasses;
+  return stat;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lockstat_acquire
+ *
+ * Description:
+ *   Count an acquisition of a lock of a class, after a wait of 'wait' if
+ *   it was contended.
+ *
+ ****************************************************************************/
+
+void lockstat_acquire(int type, FAR void *site, bool contended,
+                      clock_t wait)
+{
+  FAR struct lockstat_s *stat;
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave_wo_note(&g_lockstat_lock);
+
+  stat = lockstat_class(type, site);
+  if (stat == NULL)
+    {
+      g_lockstat_dropped++;
+    }
+  else
+    {
+      stat->acquired++;
+      if (contended)
+        {
+          stat->contended++;
+          stat->waittime += wait;
+          if (wait > stat->waitmax)
+            {
+              stat->waitmax = wait;
+            }
+        }
+    }
+
+  spin_unlock_irqrestore_wo_note(&g_lockstat_lock, flags);
+
+  /* Trace the contended sleeping locks.  The spinlocks are left out, the
+   * note drivers take spinlocks themselves.
+   */
+
+  if (contended && type != LOCKSTAT_SPIN)
+    {
+      sched_note_printf(NOTE_TAG_SCHED, "lockstat %p wait %lu",
+                        site, (unsigned long)wait);
+    }
+}
+
+/****************************************************************************
+ * Name: lockstat_release
+ *
+ * Description:
+ *   Count the release of a lock of a class, held for 'hold'.
+ *
+ ****************************************************************************/
+
+void lockstat_release(int type, FAR void *site, clock_t hold)
+{
+  FAR struct lockstat_s *stat;
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave_wo_note(&g_lockstat_lock);
+
+  stat = lockstat_class(type, site);
+  if (stat != NULL)
+    {
+      stat->holdtime += hold;
+      if (hold > stat->holdmax)
+        {
+          stat->holdmax = hold;
+        }
+    }
+
+  spin_unlock_irqrestore_wo_note(&g_lockstat_lock, flags);
+}
+
+/****************************************************************************
+ * Name: lockstat_get
+ *
+ * Description:
+ *   Return the statistics of one lock class.
+ *
+ ****************************************************************************/
+
+int lockstat_get(int index, FAR struct lockstat_s *stat)
+{
+  irqstate_t flags;
+  int ret = -ENOENT;
+
+  flags = spin_lock_irqsave_wo_note(&g_lockstat_lock);
+  if (index >= 0 && index < g_lockstat_nclasses)
+    {
+      memcpy(stat, &g_lockstat[index], sizeof(*stat));
+      ret = OK;
+    }
+
+  spin_unlock_irqrestore_wo_note(&g_lockstat_lock, flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: lockstat_dropped
+ *
+ * Description:
+ *   Return the number of acquisitions not counted because the class table
+ *   was full.
+ *
+ ****************************************************************************/
+
+unsigned long lockstat_dropped(void)
+{
+  return g_lockstat_dropped;
+}
+
+/****************************************************************************
+ * Name: lockstat_reset
+ *
+ * Description:
+ *   Forget all the lock classes.
+ *
+ ****************************************************************************/
+
+void lockstat_reset(void)
+{
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave_wo_note(&g_lockstat_lock);
+  memset(g_lockstat, 0, sizeof(g_lockstat));
+  memset(g_lockstat_hash, 0, sizeof(g_lockstat_hash));
+  g_lockstat_nclasses = 0;
+  g_lockstat_dropped  = 0;
+  spin_unlock_irqrestore_wo_note(&g_lockstat_lock, flags);
+}
+
+#ifdef CONFIG_SPINLOCK
+
+/****************************************************************************
+ * Name: spin_lockstat_acquire
+ *
+ * Description:
+ *   Called by spin_lock() before waiting for a spinlock.  The spinlocks
+ *   being taken and held are stacked per CPU, those beyond
+ *   CONFIG_SCHED_LOCKSTAT_DEPTH are not counted.
+ *
+ ****************************************************************************/
+
+void spin_lockstat_acquire(FAR volatile spinlock_t *lock)
+{
+  FAR struct lockstat_held_s *held;
+  irqstate_t flags;
+  int cpu;
+
+  flags = up_irq_save();
+  cpu   = this_cpu();
+
+  if (g_lockstat_nheld[cpu] < CONFIG_SCHED_LOCKSTAT_DEPTH)
+    {
+      held            = &g_lockstat_held[cpu][g_lockstat_nheld[cpu]++];
+      held->lock      = lock;
+      held->contended = spin_is_locked(lock);
+      held->start     = perf_gettime();
+    }
+
+  up_irq_restore(flags);
+}
+
+/****************************************************************************
+ * Name: spin_lockstat_acquired
+ *
+ * Description:
+ *   Called by spin_lock() once the spinlock is taken.
+ *
+ ****************************************************************************/
+
+void spin_lockstat_acquired(FAR volatile spinlock_t *lock)
+{
+  FAR struct lockstat_held_s *held;
+  irqstate_t flags;
+  clock_t now;
+  int cpu;
+
+  flags = up_irq_save();
+  cpu   = this_cpu();
+
+  /* Any spinlock taken by an interrupt meanwhile was released again */
+
+  if (g_lockstat_nheld[cpu] > 0)
+    {
+      held = &g_lockstat_held[cpu][g_lockstat_nheld[cpu] - 1];
+      if (held->lock == lock)
+        {
+          now = perf_gettime();
+          lockstat_acquire(LOCKSTAT_SPIN, (FAR void *)lock,
+                           held->contended, now - held->start);
+          held->start = now;
+        }
+    }
+
+  up_irq_restore(flags);
+}
+
+/****************************************************************************
+ * Name: spin_lockstat_release
+ *
+ * Description:
+ *   Called by spin_unlock() to count the hold time.  The spinlocks need
+ *   not be released in the reverse order they were taken.
+ *
+ ****************************************************************************/
+
+void spin_lockstat_release(FAR volatile spinlock_t *lock)
+{
+  FAR struct lockstat_held_s *held;
+  irqstate_t flags;
+  int cpu;
+  int i;
+
+  flags = up_irq_save();
+  cpu   = this_cpu();
+  held  = g_lockstat_held[cpu];
+
+  for (i = g_lockstat_nheld[cpu] - 1; i >= 0; i--)
+    {
+      if (held[i].lock == lock)
+        {
+          lockstat_release(LOCKSTAT_SPIN, (FAR void *)lock,
+                           perf_gettime() - held[i].start);
+
+          g_lockstat_nheld[cpu]--;
+          memmove(&held[i], &held[i + 1],
+                  (g_lockstat_nheld[cpu] - i) * sizeof(*held));
+          break;
+        }
+    }
+
+  up_irq_restore(flags);
+}
+
+#endif /* CONFIG_SPINLOCK */
+#endif /* CONFIG_SCHED_LOCKSTAT */
@@ -107,7 +107,7 @@ bool nxsched_merge_pending(void)
            */
 
           for (;
-               (rtcb && ptcb->sched_priority <= rtcb->sched_priority);
+               (rtcb && !nxsched_preempts(ptcb, rtcb));
                rtcb = rtcb->flink)
             {
             }
@@ -224,7 +224,7 @@ bool nxsched_merge_pending(void)
        * end up in the g_readytorun list.
        */
 
-      while (ptcb->sched_priority > rtcb->sched_priority)
+      while (nxsched_preempts(ptcb, rtcb))
         {
           /* Remove the task from the pending task list */
 
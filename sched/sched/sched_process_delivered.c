@@ -106,7 +106,7 @@ void nxsched_process_delivered(int cpu)
 
   btcb = g_delivertasks[cpu];
 
-  for (next = tcb; btcb->sched_priority <= next->sched_priority;
+  for (next = tcb; !nxsched_preempts(btcb, next);
       next = next->flink);
 
   DEBUGASSERT(next);
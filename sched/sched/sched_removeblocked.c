@@ -74,6 +74,15 @@ void nxsched_remove_blocked(FAR struct tcb_s *btcb)
 
   btcb->waitobj = NULL;
 
+#ifdef CONFIG_SCHED_DEADLINE
+  /* A deadline thread waking up may start a new job */
+
+  if ((btcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      nxsched_wakeup_deadline(btcb);
+    }
+#endif
+
   /* Make sure the TCB's state corresponds to not being in
    * any list
    */
@@ -184,6 +184,51 @@ void nxsched_remove_running(FAR struct tcb_s *tcb)
 
   dq_rem_head((FAR dq_entry_t *)tcb, tasklist);
 
+#ifdef CONFIG_SCHED_RUNQUEUE_PERCPU
+  /* Find the highest priority task queued on the other CPUs that may run
+   * on this CPU.  It is only stolen if it is more important than the next
+   * task in our own queue, which is always true if we ran out of work.
+   */
+
+  for (int i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      FAR struct tcb_s *qtcb;
+
+      if (i == cpu)
+        {
+          continue;
+        }
+
+      for (qtcb = (FAR struct tcb_s *)g_assignedtasks[i].head;
+           !is_idle_task(qtcb); qtcb = qtcb->flink)
+        {
+          if (qtcb->task_state != TSTATE_TASK_RUNNING &&
+              CPU_ISSET(cpu, &qtcb->affinity))
+            {
+              if (rtrtcb == NULL ||
+                  nxsched_preempts(qtcb, rtrtcb))
+                {
+                  rtrtcb = qtcb;
+                }
+
+              break;
+            }
+        }
+    }
+
+  if (rtrtcb != NULL && nxsched_preempts(rtrtcb, nxttcb))
+    {
+      /* The task is neither the running task nor the IDLE task of its
+       * list, so it is in the middle of it.
+       */
+
+      dq_rem_mid(rtrtcb);
+      dq_addfirst_nonempty((FAR dq_entry_t *)rtrtcb, tasklist);
+
+      rtrtcb->cpu = cpu;
+      nxttcb = rtrtcb;
+    }
+#else
   /* Find the highest priority non-running tasks in the g_assignedtasks
    * list of other CPUs, and also non-idle tasks, place them in the
    * g_readytorun list. so as to find the task with the highest priority,
@@ -224,6 +269,7 @@ void nxsched_remove_running(FAR struct tcb_s *tcb)
             }
         }
     }
+#endif
 
   /* Which task will go at the head of the list?  It will be either the
    * next tcb in the assigned task list (nxttcb) or a TCB in the
@@ -246,7 +292,7 @@ void nxsched_remove_running(FAR struct tcb_s *tcb)
    * task from the g_readytorun list with matching affinity (rtrtcb).
    */
 
-  if (rtrtcb != NULL && rtrtcb->sched_priority >= nxttcb->sched_priority)
+  if (rtrtcb != NULL && !nxsched_preempts(nxttcb, rtrtcb))
     {
       /* The TCB rtrtcb has the higher priority and it can be run on
        * target CPU. Remove that task (rtrtcb) from the g_readytorun
@@ -30,6 +30,7 @@
 
 #include <nuttx/sched.h>
 #include <nuttx/clock.h>
+#include <nuttx/perf_event.h>
 #include <nuttx/sched_note.h>
 
 #include "irq/irq.h"
@@ -73,9 +74,15 @@ void nxsched_resume_scheduler(FAR struct tcb_s *tcb)
 #ifdef CONFIG_SCHED_CRITMONITOR
   nxsched_resume_critmon(tcb);
 #endif
+#ifdef CONFIG_SCHED_LATENCY
+  nxsched_resume_latency(tcb);
+#endif
 #ifdef CONFIG_SCHED_INSTRUMENTATION
   sched_note_resume(tcb);
 #endif
+#ifdef CONFIG_PERF_EVENTS
+  perf_event_sched_in(tcb);
+#endif
 }
 
 #endif /* CONFIG_SCHED_RESUMESCHEDULER */
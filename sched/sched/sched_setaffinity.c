@@ -68,6 +68,7 @@
  *   Zero (OK) if successful.  Otherwise, a negated errno value is returned:
  *
  *     ESRCH  The task whose ID is pid could not be found.
+ *     EBUSY  The thread uses the SCHED_DEADLINE policy.
  *
  ****************************************************************************/
 
@@ -115,6 +116,19 @@ int nxsched_set_affinity(pid_t pid, size_t cpusetsize,
       goto errout_with_csection;
     }
 
+#ifdef CONFIG_SCHED_DEADLINE
+  /* Nor the affinity of a deadline thread, its bandwidth is reserved on
+   * the CPU selected when the policy was set.
+   */
+
+  if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE &&
+      !CPU_EQUAL(mask, &tcb->affinity))
+    {
+      ret = -EBUSY;
+      goto errout_with_csection;
+    }
+#endif
+
   /* Set the new affinity mask. */
 
   tcb->affinity = *mask;
@@ -73,6 +73,7 @@
  *          current scheduling policy.
  *   EPERM  The calling task does not have appropriate privileges.
  *   ESRCH  The task whose ID is pid could not be found.
+ *   EBUSY  The new bandwidth of a SCHED_DEADLINE thread is not available.
  *
  ****************************************************************************/
 
@@ -205,6 +206,28 @@ int nxsched_set_param(pid_t pid, FAR const struct sched_param *param)
     }
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+  /* Update parameters associated with SCHED_DEADLINE.  The priority of a
+   * deadline thread is the one of the policy, sched_priority is ignored.
+   */
+
+  if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      irqstate_t flags;
+
+      flags = enter_critical_section();
+      ret = nxsched_start_deadline(tcb, param);
+      leave_critical_section(flags);
+
+      if (ret >= 0)
+        {
+          ret = nxsched_reprioritize(tcb, CONFIG_SCHED_DEADLINE_PRIORITY);
+        }
+
+      goto errout_with_lock;
+    }
+#endif
+
   /* Then perform the reprioritization */
 
   ret = nxsched_reprioritize(tcb, param->sched_priority);
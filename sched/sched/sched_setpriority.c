@@ -131,7 +131,7 @@ static FAR struct tcb_s *nxsched_nexttcb(FAR struct tcb_s *tcb)
        */
 
       if (rtrtcb != NULL &&
-          rtrtcb->sched_priority >= nxttcb->sched_priority)
+          !nxsched_preempts(nxttcb, rtrtcb))
         {
           return rtrtcb;
         }
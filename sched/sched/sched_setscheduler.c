@@ -66,13 +66,15 @@
  *   policy - Scheduling policy requested (either SCHED_FIFO or SCHED_RR)
  *   param - A structure whose member sched_priority is the new priority.
  *      The range of valid priority numbers is from SCHED_PRIORITY_MIN
- *      through SCHED_PRIORITY_MAX.
+ *      through SCHED_PRIORITY_MAX.  For SCHED_DEADLINE the priority is
+ *      ignored and the sched_dl_* members give the reservation.
  *
  * Returned Value:
  *   On success, nxsched_set_scheduler() returns OK (zero).  On error, a
  *   negated errno value is returned:
  *
  *   EINVAL The scheduling policy is not one of the recognized policies.
+ *   EBUSY  The bandwidth of a SCHED_DEADLINE thread is not available.
  *   ESRCH  The task whose ID is pid could not be found.
  *
  ****************************************************************************/
@@ -82,6 +84,7 @@ int nxsched_set_scheduler(pid_t pid, int policy,
 {
   FAR struct tcb_s *tcb;
   irqstate_t flags;
+  int priority;
   int ret;
 
   /* Check for supported scheduling policy */
@@ -93,16 +96,29 @@ int nxsched_set_scheduler(pid_t pid, int policy,
 #endif
 #ifdef CONFIG_SCHED_SPORADIC
       && policy != SCHED_SPORADIC
+#endif
+#ifdef CONFIG_SCHED_DEADLINE
+      && policy != SCHED_DEADLINE
 #endif
      )
     {
       return -EINVAL;
     }
 
-  /* Verify that the requested priority is in the valid range */
+  /* Verify that the requested priority is in the valid range.  Deadline
+   * threads all run at the priority of the policy.
+   */
+
+  priority = param->sched_priority;
+
+#ifdef CONFIG_SCHED_DEADLINE
+  if (policy == SCHED_DEADLINE)
+    {
+      priority = CONFIG_SCHED_DEADLINE_PRIORITY;
+    }
+#endif
 
-  if (param->sched_priority < SCHED_PRIORITY_MIN ||
-      param->sched_priority > SCHED_PRIORITY_MAX)
+  if (priority < SCHED_PRIORITY_MIN || priority > SCHED_PRIORITY_MAX)
     {
       return -EINVAL;
     }
@@ -131,6 +147,26 @@ int nxsched_set_scheduler(pid_t pid, int policy,
   /* Further, disable timer interrupts while we set up scheduling policy. */
 
   flags = enter_critical_section();
+
+#ifdef CONFIG_SCHED_DEADLINE
+  /* Reserve the bandwidth of a deadline thread before anything changes, or
+   * release it if the thread leaves the policy.
+   */
+
+  if (policy == SCHED_DEADLINE)
+    {
+      ret = nxsched_start_deadline(tcb, param);
+      if (ret < 0)
+        {
+          goto errout_with_irq;
+        }
+    }
+  else if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      DEBUGVERIFY(nxsched_stop_deadline(tcb));
+    }
+#endif
+
   tcb->flags &= ~TCB_FLAG_POLICY_MASK;
   switch (policy)
     {
@@ -266,17 +302,30 @@ int nxsched_set_scheduler(pid_t pid, int policy,
         }
         break;
 #endif
+
+#ifdef CONFIG_SCHED_DEADLINE
+      case SCHED_DEADLINE:
+        {
+          /* The parameters were set by nxsched_start_deadline() */
+
+          tcb->flags     |= TCB_FLAG_SCHED_DEADLINE;
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+          tcb->timeslice  = 0;
+#endif
+        }
+        break;
+#endif
     }
 
   leave_critical_section(flags);
 
   /* Set the new priority */
 
-  ret = nxsched_reprioritize(tcb, param->sched_priority);
+  ret = nxsched_reprioritize(tcb, priority);
   sched_unlock();
   return ret;
 
-#ifdef CONFIG_SCHED_SPORADIC
+#if defined(CONFIG_SCHED_SPORADIC) || defined(CONFIG_SCHED_DEADLINE)
 errout_with_irq:
   leave_critical_section(flags);
   sched_unlock();
@@ -302,13 +351,15 @@ errout_with_irq:
  *   policy - Scheduling policy requested (either SCHED_FIFO or SCHED_RR)
  *   param - A structure whose member sched_priority is the new priority.
  *      The range of valid priority numbers is from SCHED_PRIORITY_MIN
- *      through SCHED_PRIORITY_MAX.
+ *      through SCHED_PRIORITY_MAX.  For SCHED_DEADLINE the priority is
+ *      ignored and the sched_dl_* members give the reservation.
  *
  * Returned Value:
  *   On success, sched_setscheduler() returns OK (zero).  On error, ERROR
  *   (-1) is returned, and errno is set appropriately:
  *
  *   EINVAL The scheduling policy is not one of the recognized policies.
+ *   EBUSY  The bandwidth of a SCHED_DEADLINE thread is not available.
  *   ESRCH  The task whose ID is pid could not be found.
  *
  ****************************************************************************/
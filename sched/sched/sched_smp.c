@@ -27,6 +27,7 @@
 #include <nuttx/config.h>
 
 #include <assert.h>
+#include <string.h>
 #include <nuttx/arch.h>
 #include <nuttx/nuttx.h>
 #include <nuttx/queue.h>
@@ -46,16 +47,6 @@ struct smp_call_cookie_s
   int         error;
 };
 
-struct smp_call_data_s
-{
-  sq_entry_t                    node[CONFIG_SMP_NCPUS];
-  nxsched_smp_call_t            func;
-  FAR void                     *arg;
-  FAR struct smp_call_cookie_s *cookie;
-  spinlock_t                    lock;
-  volatile int                  refcount;
-};
-
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -307,3 +298,82 @@ out:
 
   return ret;
 }
+
+/****************************************************************************
+ * Name: nxsched_smp_call_init
+ *
+ * Description:
+ *   Initialize a caller-owned call descriptor for use with
+ *   nxsched_smp_call_single_async().
+ *
+ * Input Parameters:
+ *   data - Call descriptor
+ *   func - Function
+ *   arg  - Function args
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxsched_smp_call_init(FAR struct smp_call_data_s *data,
+                           nxsched_smp_call_t func, FAR void *arg)
+{
+  memset(data, 0, sizeof(*data));
+  spin_lock_init(&data->lock);
+  data->func = func;
+  data->arg  = arg;
+}
+
+/****************************************************************************
+ * Name: nxsched_smp_call_single_async
+ *
+ * Description:
+ *   Call function on single processor without waiting and without
+ *   serializing on the shared asynchronous call descriptor.  May be called
+ *   from interrupt context.
+ *
+ * Input Parameters:
+ *   cpuid - Target cpu id
+ *   data  - Call descriptor, not queued anywhere else
+ *
+ * Returned Value:
+ *   Result
+ *
+ ****************************************************************************/
+
+int nxsched_smp_call_single_async(int cpuid,
+                                  FAR struct smp_call_data_s *data)
+{
+  cpu_set_t cpuset;
+  int ret = OK;
+
+  DEBUGASSERT(cpuid >= 0 && cpuid < CONFIG_SMP_NCPUS && data != NULL);
+
+  /* Prevent reschedule on another processor */
+
+  if (!up_interrupt_context())
+    {
+      sched_lock();
+    }
+
+  if (cpuid == this_cpu())
+    {
+      ret = data->func(data->arg);
+    }
+  else
+    {
+      nxsched_smp_call_add(cpuid, data);
+
+      CPU_ZERO(&cpuset);
+      CPU_SET(cpuid, &cpuset);
+      up_send_smp_call(cpuset);
+    }
+
+  if (!up_interrupt_context())
+    {
+      sched_unlock();
+    }
+
+  return ret;
+}
@@ -32,6 +32,7 @@
 #include <nuttx/arch.h>
 #include <nuttx/sched.h>
 #include <nuttx/clock.h>
+#include <nuttx/perf_event.h>
 #include <nuttx/sched_note.h>
 
 #include "clock/clock.h"
@@ -82,9 +83,17 @@ void nxsched_suspend_scheduler(FAR struct tcb_s *tcb)
 #ifdef CONFIG_SCHED_CRITMONITOR
   nxsched_suspend_critmon(tcb);
 #endif
+#ifdef CONFIG_SCHED_LATENCY
+  /* A stamp taken while running, by a reprioritization, is not a wake-up */
+
+  tcb->wakeup_time = 0;
+#endif
 #ifdef CONFIG_SCHED_INSTRUMENTATION
   sched_note_suspend(tcb);
 #endif
+#ifdef CONFIG_PERF_EVENTS
+  perf_event_sched_out(tcb);
+#endif
 }
 
 #endif /* CONFIG_SCHED_SUSPENDSCHEDULER */
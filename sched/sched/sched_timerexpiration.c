@@ -187,9 +187,13 @@ static clock_t nxsched_cpu_scheduler(int cpu, clock_t ticks,
   clock_t ret = 0;
 
 #if CONFIG_RR_INTERVAL > 0
-  /* Check if the currently executing task uses round robin scheduling. */
+  /* Check if the currently executing task uses round robin scheduling.
+   * A task running alone on an isolated CPU keeps its timeslice, so that
+   * the interval timer is not armed for it.
+   */
 
-  if ((rtcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_RR)
+  if ((rtcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_RR &&
+      !nxsched_cpu_nohz(cpu))
     {
       /* Yes, check if the currently executing task has exceeded its
        * timeslice.
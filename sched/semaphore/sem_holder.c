@@ -32,6 +32,8 @@
 
 #include <nuttx/addrenv.h>
 #include <nuttx/arch.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/wqueue.h>
 
 #include "sched/sched.h"
 #include "semaphore/semaphore.h"
@@ -48,6 +50,17 @@
 #  define CONFIG_SEM_PREALLOCHOLDERS 0
 #endif
 
+#ifndef CONFIG_SEM_HOLDERS_EXTEND
+#  define CONFIG_SEM_HOLDERS_EXTEND 0
+#endif
+
+/* Extend the pool once fewer holders than this are left.  The remaining
+ * ones cover the holders taken until the worker has run, including the
+ * one of the heap lock taken by the worker itself.
+ */
+
+#define NXSEM_HOLDERS_LOWATER ((CONFIG_SEM_HOLDERS_EXTEND + 1) / 2)
+
 /****************************************************************************
  * Private Type Declarations
  ****************************************************************************/
@@ -66,6 +79,53 @@ static struct semholder_s g_holderalloc[CONFIG_SEM_PREALLOCHOLDERS];
 static FAR struct semholder_s *g_freeholders;
 #endif
 
+#if CONFIG_SEM_PREALLOCHOLDERS > 0 && CONFIG_SEM_HOLDERS_EXTEND > 0
+static int g_nfreeholders;
+static struct work_s g_holderwork;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsem_extendholders
+ *
+ * Description:
+ *   Work queue worker that adds CONFIG_SEM_HOLDERS_EXTEND holders from the
+ *   heap to the pool.  They are never returned to the heap.
+ *
+ ****************************************************************************/
+
+#if CONFIG_SEM_PREALLOCHOLDERS > 0 && CONFIG_SEM_HOLDERS_EXTEND > 0
+static void nxsem_extendholders(FAR void *arg)
+{
+  FAR struct semholder_s *pholder;
+  irqstate_t flags;
+  int i;
+
+  pholder = kmm_zalloc(CONFIG_SEM_HOLDERS_EXTEND *
+                       sizeof(struct semholder_s));
+  if (pholder == NULL)
+    {
+      serr("ERROR: Failed to extend the holder pool\n");
+      return;
+    }
+
+  flags = enter_critical_section();
+
+  for (i = 0; i < CONFIG_SEM_HOLDERS_EXTEND; i++)
+    {
+      pholder[i].flink = g_freeholders;
+      g_freeholders    = &pholder[i];
+    }
+
+  g_nfreeholders += CONFIG_SEM_HOLDERS_EXTEND;
+
+  leave_critical_section(flags);
+}
+#endif
+
 /****************************************************************************
  * Name: nxsem_allocholder
  ****************************************************************************/
@@ -91,6 +151,14 @@ nxsem_allocholder(FAR sem_t *sem, FAR struct tcb_s *htcb)
       g_freeholders  = pholder->flink;
       pholder->flink = sem->hhead;
       sem->hhead     = pholder;
+
+#if CONFIG_SEM_HOLDERS_EXTEND > 0
+      if (--g_nfreeholders < NXSEM_HOLDERS_LOWATER &&
+          work_available(&g_holderwork))
+        {
+          work_queue(LPWORK, &g_holderwork, nxsem_extendholders, NULL, 0);
+        }
+#endif
     }
 #else
   if (sem->holder.htcb == NULL)
@@ -162,6 +230,36 @@ nxsem_findholder(FAR sem_t *sem, FAR struct tcb_s *htcb)
   return NULL;
 }
 
+/****************************************************************************
+ * Name: nxsem_findtaskholder
+ *
+ * Description:
+ *   Find the holder of a live task through the list of semaphores held by
+ *   the task.  That list is usually much shorter than the list of holders
+ *   of a counting semaphore shared by many tasks.
+ *
+ ****************************************************************************/
+
+static FAR struct semholder_s *
+nxsem_findtaskholder(FAR sem_t *sem, FAR struct tcb_s *htcb)
+{
+#if CONFIG_SEM_PREALLOCHOLDERS > 0
+  FAR struct semholder_s *pholder;
+
+  for (pholder = htcb->holdsem; pholder != NULL; pholder = pholder->tlink)
+    {
+      if (pholder->sem == sem)
+        {
+          return pholder;
+        }
+    }
+
+  return NULL;
+#else
+  return nxsem_findholder(sem, htcb);
+#endif
+}
+
 /****************************************************************************
  * Name: nxsem_findorallocateholder
  ****************************************************************************/
@@ -169,7 +267,7 @@ nxsem_findholder(FAR sem_t *sem, FAR struct tcb_s *htcb)
 static inline FAR struct semholder_s *
 nxsem_findorallocateholder(FAR sem_t *sem, FAR struct tcb_s *htcb)
 {
-  FAR struct semholder_s *pholder = nxsem_findholder(sem, htcb);
+  FAR struct semholder_s *pholder = nxsem_findtaskholder(sem, htcb);
   if (pholder == NULL)
     {
       pholder = nxsem_allocholder(sem, htcb);
@@ -225,6 +323,9 @@ static inline void nxsem_freeholder(FAR sem_t *sem,
 
   pholder->flink = g_freeholders;
   g_freeholders  = pholder;
+#if CONFIG_SEM_HOLDERS_EXTEND > 0
+  g_nfreeholders++;
+#endif
 #endif
 }
 
@@ -550,6 +651,9 @@ void nxsem_initialize_holders(void)
     }
 
   g_holderalloc[CONFIG_SEM_PREALLOCHOLDERS - 1].flink = NULL;
+#if CONFIG_SEM_HOLDERS_EXTEND > 0
+  g_nfreeholders = CONFIG_SEM_PREALLOCHOLDERS;
+#endif
 #endif
 }
 
@@ -743,19 +847,16 @@ void nxsem_release_holder(FAR sem_t *sem)
       /* Find the container for this holder */
 
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-      for (pholder = sem->hhead; pholder != NULL; pholder = pholder->flink)
+      pholder = nxsem_findtaskholder(sem, rtcb);
+      if (pholder != NULL)
         {
           DEBUGASSERT(pholder->counts > 0);
 
-          if (pholder->htcb == rtcb)
-            {
-              /* Decrement the counts on this holder -- the holder will be
-               * freed later in nxsem_restore_baseprio.
-               */
+          /* Decrement the counts on this holder -- the holder will be
+           * freed later in nxsem_restore_baseprio.
+           */
 
-              pholder->counts--;
-              return;
-            }
+          pholder->counts--;
         }
 #else
       pholder = &sem->holder;
@@ -984,7 +1085,7 @@ void nxsem_release_all(FAR struct tcb_s *htcb)
        * that was taken by sem_wait() or sem_post().
        */
 
-      sem->semcount++;
+      atomic_fetch_add(NXSEM_COUNT(sem), 1);
     }
 }
 
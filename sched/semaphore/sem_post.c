@@ -80,6 +80,15 @@ int nxsem_post(FAR sem_t *sem)
 
   DEBUGASSERT(sem != NULL);
 
+  /* Release the count without the critical section if there are no
+   * holders to track and no waiters to wake up.
+   */
+
+  if (nxsem_post_lockless(sem))
+    {
+      return OK;
+    }
+
   /* The following operations must be performed with interrupts
    * disabled because sem_post() may be called from an interrupt
    * handler.
@@ -87,15 +96,19 @@ int nxsem_post(FAR sem_t *sem)
 
   flags = enter_critical_section();
 
-  sem_count = sem->semcount;
-
-  /* Check the maximum allowable value */
-
-  if (sem_count >= SEM_VALUE_MAX)
+  sem_count = atomic_load(NXSEM_COUNT(sem));
+  do
     {
-      leave_critical_section(flags);
-      return -EOVERFLOW;
+      /* Check the maximum allowable value */
+
+      if (sem_count >= SEM_VALUE_MAX)
+        {
+          leave_critical_section(flags);
+          return -EOVERFLOW;
+        }
     }
+  while (!atomic_compare_exchange_weak(NXSEM_COUNT(sem), &sem_count,
+                                       sem_count + 1));
 
   /* Perform the semaphore unlock operation, releasing this task as a
    * holder then also incrementing the count on the semaphore.
@@ -116,7 +129,6 @@ int nxsem_post(FAR sem_t *sem)
 
   nxsem_release_holder(sem);
   sem_count++;
-  sem->semcount = sem_count;
 
 #if defined(CONFIG_PRIORITY_INHERITANCE) || defined(CONFIG_PRIORITY_PROTECT)
   /* Don't let any unblocked tasks run until we complete any priority
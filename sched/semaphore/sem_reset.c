@@ -100,7 +100,7 @@ int nxsem_reset(FAR sem_t *sem, int16_t count)
 
   if (sem->semcount >= 0)
     {
-      sem->semcount = count;
+      atomic_store(NXSEM_COUNT(sem), count);
     }
 
   /* Allow any pending context switches to occur now */
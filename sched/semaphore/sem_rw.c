@@ -33,17 +33,156 @@
  * Private Functions
  ****************************************************************************/
 
-static inline void up_wait(FAR rw_semaphore_t *rwsem)
+/****************************************************************************
+ * Name: rwsem_readers
+ *
+ * Description:
+ *   Return the number of readers.  With the per-CPU counts, it is exact
+ *   only while wactive is set, as the readers then count themselves under
+ *   the spinlock.
+ *
+ ****************************************************************************/
+
+static inline int rwsem_readers(FAR rw_semaphore_t *rwsem)
 {
-  int i;
+#ifdef CONFIG_RWSEM_PERCPU_READERS
+  int count = 0;
+  int cpu;
 
-  for (i = 0; i < rwsem->waiter; i++)
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
     {
-      /* If there are some waiter for unlock, then post the lock wait queue.
-       */
+      count += atomic_load(&rwsem->readers[cpu].count);
+    }
+
+  return count;
+#else
+  return rwsem->reader;
+#endif
+}
+
+/****************************************************************************
+ * Name: rwsem_count
+ *
+ * Description:
+ *   Add a reader, or remove one if n is -1.  The per-CPU count of a reader
+ *   may be decremented on another CPU than it was incremented on, only
+ *   their sum is meaningful.
+ *
+ ****************************************************************************/
+
+static inline void rwsem_count(FAR rw_semaphore_t *rwsem, int n)
+{
+#ifdef CONFIG_RWSEM_PERCPU_READERS
+  atomic_fetch_add(&rwsem->readers[this_cpu()].count, n);
+#else
+  rwsem->reader += n;
+#endif
+}
+
+static inline void rwsem_set_wactive(FAR rw_semaphore_t *rwsem, int active)
+{
+#ifdef CONFIG_RWSEM_PERCPU_READERS
+  atomic_store(&rwsem->wactive, active);
+#endif
+}
+
+/****************************************************************************
+ * Name: rwsem_fast_read
+ *
+ * Description:
+ *   Count a reader on the CPU if no writer holds wlock.  The writer sets
+ *   wactive before summing the counts and the reader counts itself before
+ *   checking wactive, so at least one of them sees the other.
+ *
+ * Returned Value:
+ *   True if the read lock is taken.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_RWSEM_PERCPU_READERS
+static bool rwsem_fast_read(FAR rw_semaphore_t *rwsem);
+#else
+#  define rwsem_fast_read(rwsem) false
+#endif
+
+/****************************************************************************
+ * Name: rwsem_leave
+ *
+ * Description:
+ *   Remove a reader, and wake up the writer if it waits for the last one.
+ *
+ ****************************************************************************/
 
+static void rwsem_leave(FAR rw_semaphore_t *rwsem)
+{
+  irqstate_t flags;
+
+#ifdef CONFIG_RWSEM_PERCPU_READERS
+  rwsem_count(rwsem, -1);
+  if (atomic_load(&rwsem->wactive) == 0)
+    {
+      return;
+    }
+
+  flags = spin_lock_irqsave(&rwsem->protected);
+#else
+  flags = spin_lock_irqsave(&rwsem->protected);
+  DEBUGASSERT(rwsem->reader > 0);
+  rwsem_count(rwsem, -1);
+#endif
+
+  if (rwsem->waiter && rwsem_readers(rwsem) == 0)
+    {
+      rwsem->waiter = 0;
       nxsem_post(&rwsem->waiting);
     }
+
+  spin_unlock_irqrestore(&rwsem->protected, flags);
+}
+
+#ifdef CONFIG_RWSEM_PERCPU_READERS
+static bool rwsem_fast_read(FAR rw_semaphore_t *rwsem)
+{
+  if (atomic_load(&rwsem->wactive) != 0)
+    {
+      return false;
+    }
+
+  rwsem_count(rwsem, 1);
+  if (atomic_load(&rwsem->wactive) == 0)
+    {
+      return true;
+    }
+
+  /* A writer came in between, let it see that we left */
+
+  rwsem_leave(rwsem);
+  return false;
+}
+#endif
+
+/****************************************************************************
+ * Name: rwsem_release
+ *
+ * Description:
+ *   Drop one recursion of the write lock, and release wlock with the last
+ *   one.  Called with the spinlock held, which is released.
+ *
+ ****************************************************************************/
+
+static void rwsem_release(FAR rw_semaphore_t *rwsem, irqstate_t flags)
+{
+  if (--rwsem->writer > 0)
+    {
+      spin_unlock_irqrestore(&rwsem->protected, flags);
+      return;
+    }
+
+  rwsem->holder = RWSEM_NO_HOLDER;
+  rwsem_set_wactive(rwsem, 0);
+  spin_unlock_irqrestore(&rwsem->protected, flags);
+
+  nxmutex_unlock(&rwsem->wlock);
 }
 
 /****************************************************************************
@@ -66,7 +205,18 @@ static inline void up_wait(FAR rw_semaphore_t *rwsem)
 
 int down_read_trylock(FAR rw_semaphore_t *rwsem)
 {
-  irqstate_t flags = spin_lock_irqsave(&rwsem->protected);
+  irqstate_t flags;
+
+  /* Only this thread may set the holder to its own ID, so that it can be
+   * checked without the spinlock.
+   */
+
+  if (rwsem->holder != _SCHED_GETTID() && rwsem_fast_read(rwsem))
+    {
+      return 1;
+    }
+
+  flags = spin_lock_irqsave(&rwsem->protected);
 
   /* if the write lock is already held by oneself and since the write lock
    * can be recursively held, so, this operation can be converted to a write
@@ -89,7 +239,7 @@ int down_read_trylock(FAR rw_semaphore_t *rwsem)
    * read base +1.
    */
 
-  rwsem->reader++;
+  rwsem_count(rwsem, 1);
 
 out:
   spin_unlock_irqrestore(&rwsem->protected, flags);
@@ -110,11 +260,18 @@ out:
 
 void down_read(FAR rw_semaphore_t *rwsem)
 {
+  irqstate_t flags;
+
+  if (rwsem->holder != _SCHED_GETTID() && rwsem_fast_read(rwsem))
+    {
+      return;
+    }
+
   /* we have to check if there is a write-lock scenario, if there is then we
    * block and wait for the write-lock to be unlocked.
    */
 
-  irqstate_t flags = spin_lock_irqsave(&rwsem->protected);
+  flags = spin_lock_irqsave(&rwsem->protected);
 
   /* if the write lock is already held by oneself and since the write lock
    * can be recursively held, so, this operation can be converted to a write
@@ -129,18 +286,24 @@ void down_read(FAR rw_semaphore_t *rwsem)
 
   while (rwsem->writer > 0)
     {
-      rwsem->waiter++;
+      /* Wait on wlock, which boosts the priority of the writer holding it,
+       * and let it go at once to recheck the writer.
+       */
+
       spin_unlock_irqrestore(&rwsem->protected, flags);
-      nxsem_wait(&rwsem->waiting);
+      if (nxmutex_lock(&rwsem->wlock) >= 0)
+        {
+          nxmutex_unlock(&rwsem->wlock);
+        }
+
       flags = spin_lock_irqsave(&rwsem->protected);
-      rwsem->waiter--;
     }
 
   /* In a scenario where there is no write lock, we just need to make the
    * read base +1.
    */
 
-  rwsem->reader++;
+  rwsem_count(rwsem, 1);
 
 out:
   spin_unlock_irqrestore(&rwsem->protected, flags);
@@ -159,7 +322,7 @@ out:
 
 void up_read(FAR rw_semaphore_t *rwsem)
 {
-  irqstate_t flags = spin_lock_irqsave(&rwsem->protected);
+  irqstate_t flags;
 
   /* when releasing a read lock and holder is oneself, the read lock is a
    * write lock that has been converted, so it should be released according
@@ -168,25 +331,12 @@ void up_read(FAR rw_semaphore_t *rwsem)
 
   if (rwsem->holder == _SCHED_GETTID())
     {
-      if (--rwsem->writer <= 0)
-        {
-          rwsem->holder = RWSEM_NO_HOLDER;
-        }
-
-      goto out;
-    }
-
-  DEBUGASSERT(rwsem->reader > 0);
-
-  rwsem->reader--;
-
-  if (rwsem->waiter > 0)
-    {
-      up_wait(rwsem);
+      flags = spin_lock_irqsave(&rwsem->protected);
+      rwsem_release(rwsem, flags);
+      return;
     }
 
-out:
-  spin_unlock_irqrestore(&rwsem->protected, flags);
+  rwsem_leave(rwsem);
 }
 
 /****************************************************************************
@@ -205,12 +355,30 @@ out:
 
 int down_write_trylock(FAR rw_semaphore_t *rwsem)
 {
-  irqstate_t flags = spin_lock_irqsave(&rwsem->protected);
   pid_t tid = _SCHED_GETTID();
+  irqstate_t flags;
+
+  if (rwsem->holder == tid)
+    {
+      flags = spin_lock_irqsave(&rwsem->protected);
+      rwsem->writer++;
+      spin_unlock_irqrestore(&rwsem->protected, flags);
+      return 1;
+    }
 
-  if (rwsem->reader > 0 || (rwsem->writer > 0 && tid != rwsem->holder))
+  if (nxmutex_trylock(&rwsem->wlock) < 0)
     {
+      return 0;
+    }
+
+  flags = spin_lock_irqsave(&rwsem->protected);
+  rwsem_set_wactive(rwsem, 1);
+
+  if (rwsem_readers(rwsem) > 0)
+    {
+      rwsem_set_wactive(rwsem, 0);
       spin_unlock_irqrestore(&rwsem->protected, flags);
+      nxmutex_unlock(&rwsem->wlock);
       return 0;
     }
 
@@ -237,22 +405,47 @@ int down_write_trylock(FAR rw_semaphore_t *rwsem)
 
 void down_write(FAR rw_semaphore_t *rwsem)
 {
-  irqstate_t flags = spin_lock_irqsave(&rwsem->protected);
   pid_t tid = _SCHED_GETTID();
+  irqstate_t flags;
+
+  if (rwsem->holder == tid)
+    {
+      flags = spin_lock_irqsave(&rwsem->protected);
+      rwsem->writer++;
+      spin_unlock_irqrestore(&rwsem->protected, flags);
+      return;
+    }
+
+  /* The writers wait for each other on wlock, by priority and with
+   * priority inheritance.
+   */
+
+  while (nxmutex_lock(&rwsem->wlock) < 0);
 
-  while (rwsem->reader > 0 || (rwsem->writer > 0 && rwsem->holder != tid))
+  flags = spin_lock_irqsave(&rwsem->protected);
+  rwsem_set_wactive(rwsem, 1);
+
+#ifdef CONFIG_RWSEM_WRITER_PREFERENCE
+  /* Keep the new readers out while waiting for the current ones */
+
+  rwsem->writer++;
+  rwsem->holder = tid;
+#endif
+
+  while (rwsem_readers(rwsem) > 0)
     {
-      rwsem->waiter++;
+      rwsem->waiter = 1;
       spin_unlock_irqrestore(&rwsem->protected, flags);
       nxsem_wait(&rwsem->waiting);
       flags = spin_lock_irqsave(&rwsem->protected);
-      rwsem->waiter--;
     }
 
+#ifndef CONFIG_RWSEM_WRITER_PREFERENCE
   /* The check passes, then we just need the writer reference + 1 */
 
   rwsem->writer++;
   rwsem->holder = tid;
+#endif
 
   spin_unlock_irqrestore(&rwsem->protected, flags);
 }
@@ -275,14 +468,7 @@ void up_write(FAR rw_semaphore_t *rwsem)
   DEBUGASSERT(rwsem->writer > 0);
   DEBUGASSERT(rwsem->holder == _SCHED_GETTID());
 
-  if (--rwsem->writer <= 0)
-    {
-      rwsem->holder = RWSEM_NO_HOLDER;
-    }
-
-  up_wait(rwsem);
-
-  spin_unlock_irqrestore(&rwsem->protected, flags);
+  rwsem_release(rwsem, flags);
 }
 
 /****************************************************************************
@@ -303,14 +489,24 @@ void up_write(FAR rw_semaphore_t *rwsem)
 int init_rwsem(FAR rw_semaphore_t *rwsem)
 {
   int ret;
+#ifdef CONFIG_RWSEM_PERCPU_READERS
+  int cpu;
+#endif
 
   /* Initialize structure information */
 
   spin_lock_init(&rwsem->protected);
 
+  ret = nxmutex_init(&rwsem->wlock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
   ret = nxsem_init(&rwsem->waiting, 0, 0);
   if (ret < 0)
     {
+      nxmutex_destroy(&rwsem->wlock);
       return ret;
     }
 
@@ -319,6 +515,14 @@ int init_rwsem(FAR rw_semaphore_t *rwsem)
   rwsem->waiter = 0;
   rwsem->holder = RWSEM_NO_HOLDER;
 
+#ifdef CONFIG_RWSEM_PERCPU_READERS
+  atomic_store(&rwsem->wactive, 0);
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      atomic_store(&rwsem->readers[cpu].count, 0);
+    }
+#endif
+
   return OK;
 }
 
@@ -338,8 +542,9 @@ void destroy_rwsem(FAR rw_semaphore_t *rwsem)
 {
   /* Need to check if there is still an unlocked or waiting state */
 
-  DEBUGASSERT(rwsem->waiter == 0 && rwsem->reader == 0 &&
+  DEBUGASSERT(rwsem->waiter == 0 && rwsem_readers(rwsem) == 0 &&
               rwsem->writer == 0 && rwsem->holder == RWSEM_NO_HOLDER);
 
   nxsem_destroy(&rwsem->waiting);
+  nxmutex_destroy(&rwsem->wlock);
 }
@@ -70,6 +70,7 @@ int nxsem_trywait(FAR sem_t *sem)
 {
   FAR struct tcb_s *rtcb = this_task();
   irqstate_t flags;
+  short count;
   int ret;
 
   /* This API should not be called from the idleloop */
@@ -78,26 +79,39 @@ int nxsem_trywait(FAR sem_t *sem)
   DEBUGASSERT(!OSINIT_IDLELOOP() || !sched_idletask() ||
               up_interrupt_context());
 
+  /* Try to take the count without the critical section first */
+
+  if (nxsem_trywait_lockless(sem))
+    {
+      return OK;
+    }
+
   /* The following operations must be performed with interrupts disabled
    * because sem_post() may be called from an interrupt handler.
    */
 
   flags = enter_critical_section();
 
-  /* If the semaphore is available, give it to the requesting task */
+  /* If the semaphore is available, give it to the requesting task.  The
+   * count may still be taken concurrently by the lockless path.
+   */
+
+  count = atomic_load(NXSEM_COUNT(sem));
+  while (count > 0 &&
+         !atomic_compare_exchange_weak(NXSEM_COUNT(sem), &count, count - 1));
 
-  if (sem->semcount > 0)
+  if (count > 0)
     {
       /* It is, let the task take the semaphore */
 
       ret = nxsem_protect_wait(sem);
       if (ret < 0)
         {
+          atomic_fetch_add(NXSEM_COUNT(sem), 1);
           leave_critical_section(flags);
           return ret;
         }
 
-      sem->semcount--;
       nxsem_add_holder(sem);
       rtcb->waitobj = NULL;
       ret = OK;
@@ -33,10 +33,39 @@
 #include <nuttx/init.h>
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
+#include <nuttx/lockstat.h>
 
 #include "sched/sched.h"
 #include "semaphore/semaphore.h"
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsem_lockstat
+ *
+ * Description:
+ *   Count the acquisition of a semaphore, contended if the thread blocked
+ *   from 'start'.  The mutexes are counted by the mutex functions, which
+ *   know the hold time.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_LOCKSTAT
+static void nxsem_lockstat(FAR sem_t *sem, clock_t start)
+{
+  if ((sem->flags & SEM_TYPE_MUTEX) == 0)
+    {
+      lockstat_acquire(LOCKSTAT_SEM,
+                       sem->initsite != NULL ? sem->initsite : sem,
+                       start != 0, start != 0 ? perf_gettime() - start : 0);
+    }
+}
+#else
+#  define nxsem_lockstat(sem, start)
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -80,6 +109,16 @@ int nxsem_wait(FAR sem_t *sem)
   DEBUGASSERT(sem != NULL && up_interrupt_context() == false);
   DEBUGASSERT(!OSINIT_IDLELOOP() || !sched_idletask());
 
+  /* Take an available count without the critical section if there are no
+   * holders to track.
+   */
+
+  if (nxsem_trywait_lockless(sem))
+    {
+      nxsem_lockstat(sem, 0);
+      return OK;
+    }
+
   /* The following operations must be performed with interrupts
    * disabled because nxsem_post() may be called from an interrupt
    * handler.
@@ -87,24 +126,25 @@ int nxsem_wait(FAR sem_t *sem)
 
   flags = enter_critical_section();
 
-  /* Make sure we were supplied with a valid semaphore. */
-
-  /* Check if the lock is available */
+  /* Check if the lock is available.  The count is decremented either way,
+   * a negative count is the number of waiters.
+   */
 
-  if (sem->semcount > 0)
+  if (atomic_fetch_sub(NXSEM_COUNT(sem), 1) > 0)
     {
       /* It is, let the task take the semaphore. */
 
       ret = nxsem_protect_wait(sem);
       if (ret < 0)
         {
+          atomic_fetch_add(NXSEM_COUNT(sem), 1);
           leave_critical_section(flags);
           return ret;
         }
 
-      sem->semcount--;
       nxsem_add_holder(sem);
       rtcb->waitobj = NULL;
+      nxsem_lockstat(sem, 0);
       ret = OK;
     }
 
@@ -117,6 +157,9 @@ int nxsem_wait(FAR sem_t *sem)
 #ifdef CONFIG_PRIORITY_INHERITANCE
       uint8_t prioinherit = sem->flags & SEM_PRIO_MASK;
 #endif
+#ifdef CONFIG_SCHED_LOCKSTAT
+      clock_t start = perf_gettime();
+#endif
 
       /* First, verify that the task is not already waiting on a
        * semaphore
@@ -124,10 +167,6 @@ int nxsem_wait(FAR sem_t *sem)
 
       DEBUGASSERT(rtcb->waitobj == NULL);
 
-      /* Handle the POSIX semaphore (but don't set the owner yet) */
-
-      sem->semcount--;
-
       /* Save the waited on semaphore in the TCB */
 
       rtcb->waitobj = sem;
@@ -211,6 +250,10 @@ int nxsem_wait(FAR sem_t *sem)
        */
 
       ret = rtcb->errcode != OK ? -rtcb->errcode : OK;
+      if (ret == OK)
+        {
+          nxsem_lockstat(sem, start);
+        }
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
       if (prioinherit != 0)
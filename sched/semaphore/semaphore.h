@@ -34,6 +34,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <limits.h>
 
 /****************************************************************************
  * Public Function Prototypes
@@ -97,6 +97,34 @@ static int sig_handler(FAR void *cookie)
 }
 #endif
 
+/****************************************************************************
+ * Name: nxsig_find_pendingaction
+ *
+ * Description:
+ *   Find the signal action queued for the signal signo, and not delivered
+ *   yet.  Only the signals that are not realtime are searched for: the
+ *   realtime ones are queued each time.  Must be called within a critical
+ *   section.
+ *
+ ****************************************************************************/
+
+static FAR sigq_t *nxsig_find_pendingaction(FAR struct tcb_s *stcb,
+                                            int signo)
+{
+  FAR sigq_t *sigq;
+
+  if (SIGRTMIN <= signo && signo <= SIGRTMAX)
+    {
+      return NULL;
+    }
+
+  for (sigq = (FAR sigq_t *)stcb->sigpendactionq.head;
+       sigq != NULL && sigq->info.si_signo != signo;
+       sigq = sigq->flink);
+
+  return sigq;
+}
+
 /****************************************************************************
  * Name: nxsig_queue_action
  *
@@ -108,25 +136,39 @@ static int sig_handler(FAR void *cookie)
  *
  ****************************************************************************/
 
-static int nxsig_queue_action(FAR struct tcb_s *stcb, siginfo_t *info)
+static int nxsig_queue_action(FAR struct tcb_s *stcb,
+                              FAR sigactq_t *sigact, siginfo_t *info)
 {
-  FAR sigactq_t *sigact;
   FAR sigq_t    *sigq;
   irqstate_t     flags;
   int            ret = OK;
 
   DEBUGASSERT(stcb != NULL && stcb->group != NULL);
 
-  /* Find the group sigaction associated with this signal */
-
-  sigact = nxsig_find_action(stcb->group, info->si_signo);
-
   /* Check if a valid signal handler is available and if the signal is
    * unblocked. NOTE: There is no default action.
    */
 
   if ((sigact) && (sigact->act.sa_u._sa_sigaction))
     {
+      /* A signal that is not realtime and whose action is still queued is
+       * merged with it, the handler running once with the last siginfo.
+       * Then a fast sender costs neither an allocation nor a delivery
+       * for each signal.
+       */
+
+      flags = enter_critical_section();
+      sigq = nxsig_find_pendingaction(stcb, info->si_signo);
+      if (sigq != NULL)
+        {
+          memcpy(&sigq->info, info, sizeof(siginfo_t));
+          sigq->info.si_user = sigact->act.sa_user;
+          leave_critical_section(flags);
+          return OK;
+        }
+
+      leave_critical_section(flags);
+
       /* Allocate a new element for the signal queue. NOTE:
        * nxsig_alloc_pendingsigaction will force a system crash if it is
        * unable to allocate memory for the signal data.
@@ -209,60 +251,26 @@ static int nxsig_queue_action(FAR struct tcb_s *stcb, siginfo_t *info)
  * Name: nxsig_alloc_pendingsignal
  *
  * Description:
- *   Allocate a pending signal list entry
+ *   Allocate a pending signal list entry from the preallocated ones.  Must
+ *   be called within a critical section.
  *
  ****************************************************************************/
 
 static FAR sigpendq_t *nxsig_alloc_pendingsignal(void)
 {
   FAR sigpendq_t *sigpend;
-  irqstate_t      flags;
-
-  /* Check if we were called from an interrupt handler. */
 
-  if (up_interrupt_context())
-    {
-      /* Try to get the pending signal structure from the free list */
-
-      sigpend = (FAR sigpendq_t *)sq_remfirst(&g_sigpendingsignal);
-      if (!sigpend)
-        {
-          /* If no pending signal structure is available in the free list,
-           * then try the special list of structures reserved for
-           * interrupt handlers
-           */
-
-          sigpend = (FAR sigpendq_t *)sq_remfirst(&g_sigpendingirqsignal);
-        }
-    }
-
-  /* If we were not called from an interrupt handler, then we are
-   * free to allocate pending action structures if necessary.
-   */
+  /* Try to get the pending signal structure from the free list */
 
-  else
+  sigpend = (FAR sigpendq_t *)sq_remfirst(&g_sigpendingsignal);
+  if (!sigpend && up_interrupt_context())
     {
-      /* Try to get the pending signal structure from the free list */
-
-      flags = enter_critical_section();
-      sigpend = (FAR sigpendq_t *)sq_remfirst(&g_sigpendingsignal);
-      leave_critical_section(flags);
-
-      /* Check if we got one. */
-
-      if (!sigpend)
-        {
-          /* No... Allocate the pending signal */
-
-          sigpend = kmm_malloc(sizeof(sigpendq_t));
-
-          /* Check if we got an allocated message */
+      /* If no pending signal structure is available in the free list,
+       * then try the special list of structures reserved for interrupt
+       * handlers
+       */
 
-          if (sigpend)
-            {
-              sigpend->type = SIG_ALLOC_DYN;
-            }
-        }
+      sigpend = (FAR sigpendq_t *)sq_remfirst(&g_sigpendingirqsignal);
     }
 
   return sigpend;
@@ -272,7 +280,9 @@ static FAR sigpendq_t *nxsig_alloc_pendingsignal(void)
  * Name: nxsig_find_pendingsignal
  *
  * Description:
- *   Find a specified element in the pending signal list
+ *   Find a specified element in the pending signal list.  Pending signals
+ *   can be added from interrupt level, so this must be called within a
+ *   critical section.
  *
  ****************************************************************************/
 
@@ -280,7 +290,6 @@ static FAR sigpendq_t *
 nxsig_find_pendingsignal(FAR struct task_group_s *group, int signo)
 {
   FAR sigpendq_t *sigpend = NULL;
-  irqstate_t flags;
 
   DEBUGASSERT(group != NULL);
 
@@ -291,17 +300,12 @@ nxsig_find_pendingsignal(FAR struct task_group_s *group, int signo)
       return sigpend;
     }
 
-  /* Pending signals can be added from interrupt level. */
-
-  flags = enter_critical_section();
-
   /* Search the list for a action pending on this signal */
 
   for (sigpend = (FAR sigpendq_t *)group->tg_sigpendingq.head;
        (sigpend && sigpend->info.si_signo != signo);
        sigpend = sigpend->flink);
 
-  leave_critical_section(flags);
   return sigpend;
 }
 
@@ -339,44 +343,87 @@ static void nxsig_add_pendingsignal(FAR struct tcb_s *stcb,
 {
   FAR struct task_group_s *group;
   FAR sigpendq_t *sigpend;
+  FAR sigpendq_t *newpend = NULL;
   irqstate_t flags;
 
   DEBUGASSERT(stcb != NULL && stcb->group != NULL);
   group = stcb->group;
 
-  /* Check if the signal is already pending for the group */
-
-  sigpend = nxsig_find_pendingsignal(group, info->si_signo);
-  if (sigpend != NULL)
-    {
-      /* The signal is already pending... retain only one copy */
-
-      memcpy(&sigpend->info, info, sizeof(siginfo_t));
-    }
+  /* The search, the update and the insertion are done within a single
+   * critical section, so that a signal already pending costs only one.
+   */
 
-  /* No... There is nothing pending in the group for this signo */
+  flags = enter_critical_section();
 
-  else
+  for (; ; )
     {
-      /* Allocate a new pending signal entry */
+      /* Check if the signal is already pending for the group */
 
-      sigpend = nxsig_alloc_pendingsignal();
+      sigpend = nxsig_find_pendingsignal(group, info->si_signo);
       if (sigpend != NULL)
         {
-          /* Put the signal information into the allocated structure */
+          /* The signal is already pending... retain only one copy */
 
           memcpy(&sigpend->info, info, sizeof(siginfo_t));
+          leave_critical_section(flags);
 
-          /* Add the structure to the group pending signal list */
+          /* An entry allocated meanwhile is not needed any longer */
 
-          flags = enter_critical_section();
-          sq_addlast((FAR sq_entry_t *)sigpend, &group->tg_sigpendingq);
-          leave_critical_section(flags);
-          nxsig_dispatch_kernel_action(stcb, &sigpend->info);
+          if (newpend != NULL)
+            {
+              kmm_free(newpend);
+            }
+
+          return;
         }
+
+      /* No... There is nothing pending in the group for this signo */
+
+      if (newpend == NULL)
+        {
+          newpend = nxsig_alloc_pendingsignal();
+        }
+
+      if (newpend != NULL || up_interrupt_context())
+        {
+          break;
+        }
+
+      /* If we were not called from an interrupt handler, then we are
+       * free to allocate the entry, out of the critical section.  Then the
+       * search is done again, since the signal may have been added
+       * meanwhile.
+       */
+
+      leave_critical_section(flags);
+      newpend = kmm_malloc(sizeof(sigpendq_t));
+      if (newpend == NULL)
+        {
+          DEBUGPANIC();
+          return;
+        }
+
+      newpend->type = SIG_ALLOC_DYN;
+      flags = enter_critical_section();
     }
 
-  DEBUGASSERT(sigpend);
+  if (newpend != NULL)
+    {
+      /* Put the signal information into the allocated structure and add
+       * the structure to the group pending signal list
+       */
+
+      memcpy(&newpend->info, info, sizeof(siginfo_t));
+      sq_addlast((FAR sq_entry_t *)newpend, &group->tg_sigpendingq);
+    }
+
+  leave_critical_section(flags);
+
+  DEBUGASSERT(newpend);
+  if (newpend != NULL)
+    {
+      nxsig_dispatch_kernel_action(stcb, &newpend->info);
+    }
 }
 
 /****************************************************************************
@@ -408,6 +455,7 @@ static void nxsig_add_pendingsignal(FAR struct tcb_s *stcb,
 int nxsig_tcbdispatch(FAR struct tcb_s *stcb, siginfo_t *info)
 {
   FAR struct tcb_s *rtcb = this_task();
+  FAR sigactq_t *sigact = NULL;
   irqstate_t flags;
   int masked;
   int ret = OK;
@@ -436,6 +484,24 @@ int nxsig_tcbdispatch(FAR struct tcb_s *stcb, siginfo_t *info)
   /************************** MASKED SIGNAL ACTIONS *************************/
 
   masked = nxsig_ismember(&stcb->sigprocmask, info->si_signo);
+  if (masked == 0)
+    {
+      /* Find the group sigaction associated with this signal */
+
+      sigact = nxsig_find_action(stcb->group, info->si_signo);
+
+      /* A signal taken by a kernel handler, like those read from a
+       * signalfd, has no action to run on the thread of the task.  So it
+       * is handled like a masked signal: it is made pending, or given to
+       * the task waiting for it, without queuing any action to deliver
+       * nor interrupting what the task waits for.
+       */
+
+      if (sigact != NULL && (sigact->act.sa_flags & SA_KERNELHAND) != 0)
+        {
+          masked = 1;
+        }
+    }
 
 #ifdef CONFIG_LIB_SYSCALL
   /* Check if the signal is masked OR if the signal is received while we are
@@ -535,7 +601,7 @@ int nxsig_tcbdispatch(FAR struct tcb_s *stcb, siginfo_t *info)
     {
       /* Queue any sigaction's requested by this task. */
 
-      ret = nxsig_queue_action(stcb, info);
+      ret = nxsig_queue_action(stcb, sigact, info);
 
       /* Deliver of the signal must be performed in a critical section */
 
@@ -36,6 +36,7 @@
 #include <nuttx/sched.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/mm/mm.h>
+#include <nuttx/perf_event.h>
 
 #include "sched/sched.h"
 #include "group/group.h"
@@ -454,6 +455,25 @@ void nxtask_exithook(FAR struct tcb_s *tcb, int status)
 
   nxsig_cleanup(tcb); /* Deallocate Signal lists */
 
+#ifdef CONFIG_PERF_EVENTS
+  /* Stop the events counting this thread */
+
+  perf_event_exit(tcb);
+#endif
+
+#if CONFIG_MM_HEAP_TCACHE_COUNT > 0
+  /* Return the small blocks cached by this CPU, among them the ones freed
+   * by the exiting thread, to the heaps.
+   */
+
+#  ifdef CONFIG_MM_KERNEL_HEAP
+  mm_free_delaylist(g_kmmheap);
+#  endif
+#  ifdef CONFIG_BUILD_FLAT
+  mm_free_delaylist(USR_HEAP);
+#  endif
+#endif
+
 #ifdef CONFIG_SCHED_DUMP_LEAK
   if ((tcb->flags & TCB_FLAG_TTYPE_MASK) == TCB_FLAG_TTYPE_KERNEL)
     {
@@ -412,6 +412,15 @@ static int nxthread_setup_scheduler(FAR struct tcb_s *tcb, int priority,
   ret = nxtask_assign_pid(tcb);
   if (ret == OK)
     {
+#ifdef CONFIG_SEM_USER_FASTPATH
+      /* Let the user space mutexes get the thread ID from the TLS */
+
+      if (tcb->stack_alloc_ptr != NULL)
+        {
+          ((FAR struct tls_info_s *)tcb->stack_alloc_ptr)->tl_tid = tcb->pid;
+        }
+#endif
+
       /* Save task priority and entry point in the TCB */
 
       tcb->sched_priority = (uint8_t)priority;
@@ -60,6 +60,11 @@
 
 int wd_cancel(FAR struct wdog_s *wdog)
 {
+#ifdef CONFIG_WDOG_PERCPU
+  /* The per-CPU queues are protected by their own spinlocks */
+
+  return wd_cancel_irq(wdog);
+#else
   irqstate_t flags;
   int ret;
 
@@ -70,6 +75,7 @@ int wd_cancel(FAR struct wdog_s *wdog)
   leave_critical_section(flags);
 
   return ret;
+#endif
 }
 
 /****************************************************************************
@@ -91,7 +97,42 @@ int wd_cancel(FAR struct wdog_s *wdog)
 
 int wd_cancel_irq(FAR struct wdog_s *wdog)
 {
+#ifdef CONFIG_WDOG_PERCPU
+  irqstate_t flags;
+  int cpu;
+
+  if (wdog == NULL)
+    {
+      return -EINVAL;
+    }
+
+  flags = wd_lockqueue(wdog, &cpu);
+
+  /* Make sure that the watchdog is still active. */
+
+  if (!WDOG_ISACTIVE(wdog))
+    {
+      spin_unlock_irqrestore(&g_wdactivelock[cpu], flags);
+      return -EINVAL;
+    }
+
+  sched_note_wdog(NOTE_WDOG_CANCEL, (FAR void *)wdog->func,
+                  (FAR void *)(uintptr_t)wdog->expired);
+
+  /* Remove the watchdog from its queue and mark it inactive.  As with the
+   * timing wheel, the interval timer is not reassessed here; an early
+   * expiration just finds nothing to run.
+   */
+
+  list_delete(&wdog->node);
+  wdog->func = NULL;
+
+  spin_unlock_irqrestore(&g_wdactivelock[cpu], flags);
+  return OK;
+#else
+#  ifndef CONFIG_WDOG_TIMERWHEEL
   bool head;
+#  endif
 
   /* Make sure that the watchdog is valid and still active. */
 
@@ -103,6 +144,18 @@ int wd_cancel_irq(FAR struct wdog_s *wdog)
   sched_note_wdog(NOTE_WDOG_CANCEL, (FAR void *)wdog->func,
                   (FAR void *)(uintptr_t)wdog->expired);
 
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  /* Remove the watchdog from its wheel slot.  The interval timer is left
+   * alone: if this was the next watchdog due, the timer just fires once
+   * without anything to expire and is then reprogrammed by wd_timer().
+   */
+
+  wd_wheel_remove(wdog);
+
+  /* Mark the watchdog inactive */
+
+  wdog->func = NULL;
+#else
   /* Prohibit timer interactions with the timer queue until the
    * cancellation is complete
    */
@@ -126,6 +179,8 @@ int wd_cancel_irq(FAR struct wdog_s *wdog)
 
       nxsched_reassess_timer();
     }
+#endif
 
   return OK;
+#endif
 }
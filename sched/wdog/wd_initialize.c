@@ -27,6 +27,7 @@
 #include <nuttx/config.h>
 
 #include <nuttx/list.h>
+#include <nuttx/spinlock.h>
 
 #include "wdog/wdog.h"
 
@@ -34,13 +35,63 @@
  * Public Data
  ****************************************************************************/
 
+#if defined(CONFIG_WDOG_PERCPU)
+/* The per-CPU g_wdactivelist lists are ordered by watchdog expiration time,
+ * each one is protected by the matching g_wdactivelock.
+ */
+
+struct list_node g_wdactivelist[CONFIG_SMP_NCPUS];
+spinlock_t g_wdactivelock[CONFIG_SMP_NCPUS];
+
+/* Cross-CPU call descriptors used to run expired watchdogs on the CPU that
+ * queued them.
+ */
+
+struct smp_call_data_s g_wdsmpcall[CONFIG_SMP_NCPUS];
+
+#elif !defined(CONFIG_WDOG_TIMERWHEEL)
 /* The g_wdactivelist data structure is a singly linked list ordered by
  * watchdog expiration time. When watchdog timers expire,the functions on
  * this linked list are removed and the function is called.
  */
 
 struct list_node g_wdactivelist = LIST_INITIAL_VALUE(g_wdactivelist);
+#endif
 
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_initialize
+ *
+ * Description:
+ *   Initialize the watchdog data structures.  Called once from nx_start()
+ *   before any watchdog can be started.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_WDOG_TIMERWHEEL)
+void wd_initialize(void)
+{
+  wd_wheel_initialize();
+}
+#elif defined(CONFIG_WDOG_PERCPU)
+void wd_initialize(void)
+{
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      list_initialize(&g_wdactivelist[cpu]);
+      spin_lock_init(&g_wdactivelock[cpu]);
+      nxsched_smp_call_init(&g_wdsmpcall[cpu], wd_expiration_smpcall, NULL);
+    }
+}
+#endif
@@ -82,6 +82,12 @@
 
 #endif
 
+#ifdef CONFIG_WDOG_PERCPU
+#  define WDOG_ACTIVELIST(wdog) (&g_wdactivelist[(wdog)->qcpu])
+#else
+#  define WDOG_ACTIVELIST(wdog) (&g_wdactivelist)
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -90,10 +96,148 @@
 static unsigned int g_wdtimernested;
 #endif
 
+#ifdef CONFIG_WDOG_PERCPU
+/* Set while a cross-CPU call to run the expired watchdogs of a CPU is
+ * queued.  Protected by g_wdactivelock[] of that CPU.
+ */
+
+static bool g_wdsmppending[CONFIG_SMP_NCPUS];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_WDOG_PERCPU
+/****************************************************************************
+ * Name: wd_expiration_cpu
+ *
+ * Description:
+ *   Remove and execute the expired watchdogs queued on the given CPU.  Must
+ *   be called on that CPU.
+ *
+ * Input Parameters:
+ *   cpu   - The current CPU
+ *   ticks - current time in ticks
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void wd_expiration_cpu(int cpu, clock_t ticks)
+{
+  FAR struct list_node *list = &g_wdactivelist[cpu];
+  FAR struct wdog_s *wdog;
+  irqstate_t flags;
+  wdentry_t func;
+  wdparm_t arg;
+
+  /* The watchdog functions still run inside of the critical section, only
+   * the queue itself is protected by the per-CPU spinlock.
+   */
+
+  flags = enter_critical_section();
+
+#ifdef CONFIG_SCHED_TICKLESS
+  g_wdtimernested++;
+#endif
+
+  spin_lock(&g_wdactivelock[cpu]);
+  while (!list_is_empty(list))
+    {
+      wdog = list_first_entry(list, struct wdog_s, node);
+
+      /* Check if expected time is expired */
+
+      if (!clock_compare(wdog->expired, ticks))
+        {
+          break;
+        }
+
+      /* Remove the watchdog from the head of the list and indicate that
+       * it is no longer active.
+       */
+
+      list_delete(&wdog->node);
+
+      func = wdog->func;
+      arg  = wdog->arg;
+      wdog->func = NULL;
+
+      /* Execute the watchdog function without holding the queue lock, it
+       * may restart or cancel watchdogs.
+       */
+
+      spin_unlock(&g_wdactivelock[cpu]);
+
+      up_setpicbase(wdog->picbase);
+      CALL_FUNC(func, arg);
+
+      spin_lock(&g_wdactivelock[cpu]);
+    }
+
+  spin_unlock(&g_wdactivelock[cpu]);
+
+#ifdef CONFIG_SCHED_TICKLESS
+  g_wdtimernested--;
+#endif
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: wd_expiration
+ *
+ * Description:
+ *   Execute the expired watchdogs of the current CPU and ask the other
+ *   CPUs to do the same for their queues.
+ *
+ * Input Parameters:
+ *   ticks - current time in ticks
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void wd_expiration(clock_t ticks)
+{
+  FAR struct wdog_s *wdog;
+  irqstate_t flags;
+  int me = this_cpu();
+  bool kick;
+  int cpu;
+
+  wd_expiration_cpu(me, ticks);
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      if (cpu == me)
+        {
+          continue;
+        }
+
+      flags = spin_lock_irqsave(&g_wdactivelock[cpu]);
+
+      kick = false;
+      if (!g_wdsmppending[cpu] && !list_is_empty(&g_wdactivelist[cpu]))
+        {
+          wdog = list_first_entry(&g_wdactivelist[cpu], struct wdog_s,
+                                  node);
+          kick = clock_compare(wdog->expired, ticks);
+          g_wdsmppending[cpu] = kick;
+        }
+
+      spin_unlock_irqrestore(&g_wdactivelock[cpu], flags);
+
+      if (kick)
+        {
+          nxsched_smp_call_single_async(cpu, &g_wdsmpcall[cpu]);
+        }
+    }
+}
+#else
 /****************************************************************************
  * Name: wd_expiration
  *
@@ -114,6 +258,10 @@ static inline_function void wd_expiration(clock_t ticks)
   FAR struct wdog_s *wdog;
   irqstate_t flags;
   wdentry_t func;
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  FAR struct list_node *slot;
+  clock_t next;
+#endif
 
   flags = enter_critical_section();
 
@@ -125,6 +273,46 @@ static inline_function void wd_expiration(clock_t ticks)
   g_wdtimernested++;
 #endif
 
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  /* Visit only the ticks at which the wheel has work to do: a level 0 slot
+   * holding watchdogs or a higher level slot that needs to be cascaded.
+   */
+
+  while (wd_wheel_next(&next) && clock_compare(next, ticks))
+    {
+      g_wdwheel.base = next;
+      wd_wheel_cascade();
+
+      slot = &g_wdwheel.slot[0][next & WDOG_WHEEL_MASK];
+      while (!list_is_empty(slot))
+        {
+          wdog = list_first_entry(slot, struct wdog_s, node);
+
+          /* Remove the watchdog from the slot */
+
+          wd_wheel_remove(wdog);
+
+          /* Indicate that the watchdog is no longer active. */
+
+          func = wdog->func;
+          wdog->func = NULL;
+
+          /* Execute the watchdog function */
+
+          up_setpicbase(wdog->picbase);
+          CALL_FUNC(func, wdog->arg);
+        }
+
+      g_wdwheel.base = next + 1;
+    }
+
+  /* Nothing else is due up to 'ticks', so the base can skip ahead */
+
+  if (clock_compare(g_wdwheel.base, ticks))
+    {
+      g_wdwheel.base = ticks + 1;
+    }
+#else
   /* Process the watchdog at the head of the list as well as any
    * other watchdogs that became ready to run at this time
    */
@@ -154,6 +342,7 @@ static inline_function void wd_expiration(clock_t ticks)
       up_setpicbase(wdog->picbase);
       CALL_FUNC(func, wdog->arg);
     }
+#endif
 
 #ifdef CONFIG_SCHED_TICKLESS
   /* Decrement the nested watchdog timer count */
@@ -163,6 +352,7 @@ static inline_function void wd_expiration(clock_t ticks)
 
   leave_critical_section(flags);
 }
+#endif /* CONFIG_WDOG_PERCPU */
 
 /****************************************************************************
  * Name: wd_insert
@@ -189,11 +379,22 @@ static inline_function
 void wd_insert(FAR struct wdog_s *wdog, clock_t expired,
                wdentry_t wdentry, wdparm_t arg)
 {
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  wdog->func = wdentry;
+  up_getpicbase(&wdog->picbase);
+  wdog->arg = arg;
+  wdog->expired = expired;
+
+  /* Hash the watchdog into the slot of its expiration time */
+
+  wd_wheel_insert(wdog);
+#else
+  FAR struct list_node *list = WDOG_ACTIVELIST(wdog);
   FAR struct wdog_s *curr;
 
   /* Traverse the watchdog list */
 
-  list_for_every_entry(&g_wdactivelist, curr, struct wdog_s, node)
+  list_for_every_entry(list, curr, struct wdog_s, node)
     {
       /* Until curr->expired has not timed out relative to expired */
 
@@ -204,7 +405,7 @@ void wd_insert(FAR struct wdog_s *wdog, clock_t expired,
     }
 
   /* There are two cases:
-   * - Traverse to the end, where curr == &g_wdactivelist.
+   * - Traverse to the end, where curr == list.
    * - Find a curr such that curr->expected has not timed out
    * relative to expired.
    * In either case 1 or 2, we just insert the wdog before curr.
@@ -216,12 +417,123 @@ void wd_insert(FAR struct wdog_s *wdog, clock_t expired,
   up_getpicbase(&wdog->picbase);
   wdog->arg = arg;
   wdog->expired = expired;
+#endif
 }
 
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+#ifdef CONFIG_WDOG_PERCPU
+/****************************************************************************
+ * Name: wd_lockqueue
+ *
+ * Description:
+ *   Lock the per-CPU queue that a watchdog is queued on.  wdog->qcpu only
+ *   changes with the lock of its current queue held, so it is read again
+ *   after locking and the lookup is retried if it moved meanwhile.
+ *
+ * Input Parameters:
+ *   wdog - Watchdog ID
+ *   cpu  - Location to return the CPU whose queue was locked
+ *
+ * Returned Value:
+ *   The interrupt state to pass to spin_unlock_irqrestore() together with
+ *   g_wdactivelock[*cpu].
+ *
+ ****************************************************************************/
+
+irqstate_t wd_lockqueue(FAR struct wdog_s *wdog, FAR int *cpu)
+{
+  irqstate_t flags;
+  int qcpu;
+
+  for (; ; )
+    {
+      qcpu  = *(FAR volatile uint8_t *)&wdog->qcpu;
+      flags = spin_lock_irqsave(&g_wdactivelock[qcpu]);
+      if (qcpu == wdog->qcpu)
+        {
+          *cpu = qcpu;
+          return flags;
+        }
+
+      spin_unlock_irqrestore(&g_wdactivelock[qcpu], flags);
+    }
+}
+
+/****************************************************************************
+ * Name: wd_expiration_smpcall
+ *
+ * Description:
+ *   Cross-CPU call handler, queued through g_wdsmpcall[] by the CPU that
+ *   processes the timer when watchdogs queued on another CPU have expired.
+ *   Runs the expired watchdogs of the current CPU.
+ *
+ * Input Parameters:
+ *   arg - Not used
+ *
+ * Returned Value:
+ *   Always OK
+ *
+ ****************************************************************************/
+
+int wd_expiration_smpcall(FAR void *arg)
+{
+  irqstate_t flags;
+  int cpu = this_cpu();
+
+  UNUSED(arg);
+
+  flags = spin_lock_irqsave(&g_wdactivelock[cpu]);
+  g_wdsmppending[cpu] = false;
+  spin_unlock_irqrestore(&g_wdactivelock[cpu], flags);
+
+  wd_expiration_cpu(cpu, clock_systime_ticks());
+
+#ifdef CONFIG_SCHED_TICKLESS
+  /* The interval timer ignored this queue while the call was pending */
+
+  flags = enter_critical_section();
+  nxsched_reassess_timer();
+  leave_critical_section(flags);
+#endif
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: wd_setcpu
+ *
+ * Description:
+ *   Pin a watchdog to a CPU.  By default a watchdog is queued on, and
+ *   expires on, the CPU that calls wd_start().  A pinned watchdog always
+ *   expires on the selected CPU instead.  The setting takes effect with the
+ *   next wd_start() and persists until changed.
+ *
+ * Input Parameters:
+ *   wdog - Watchdog ID
+ *   cpu  - The CPU to pin the watchdog to, or a negative value to expire
+ *          on the CPU that starts it.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned to
+ *   indicate the nature of any failure.
+ *
+ ****************************************************************************/
+
+int wd_setcpu(FAR struct wdog_s *wdog, int cpu)
+{
+  if (wdog == NULL || cpu >= CONFIG_SMP_NCPUS)
+    {
+      return -EINVAL;
+    }
+
+  wdog->cpu = cpu < 0 ? 0 : cpu + 1;
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: wd_start_abstick
  *
@@ -263,6 +575,15 @@ int wd_start_abstick(FAR struct wdog_s *wdog, clock_t ticks,
 {
   irqstate_t flags;
   bool reassess = false;
+#if defined(CONFIG_WDOG_TIMERWHEEL) && defined(CONFIG_SCHED_TICKLESS)
+  clock_t next;
+#endif
+#ifdef CONFIG_WDOG_PERCPU
+  int first;
+  int second;
+  int qcpu;
+  int cpu;
+#endif
 
   /* Verify the wdog and setup parameters */
 
@@ -293,8 +614,121 @@ int wd_start_abstick(FAR struct wdog_s *wdog, clock_t ticks,
    * the critical section is established.
    */
 
+#ifdef CONFIG_WDOG_PERCPU
+  /* Queue it on the CPU it is pinned to or else on this CPU, unless this
+   * CPU is isolated.
+   */
+
+  cpu = wdog->cpu > 0 ? wdog->cpu - 1 :
+                        nxsched_housekeeping_cpu(this_cpu());
+
+  /* Hold the locks of both the current and the new queue, taken in index
+   * order, so that the watchdog moves from one to the other atomically.
+   * Retry if another CPU moved it before the locks were held.
+   */
+
+  for (; ; )
+    {
+      qcpu   = *(FAR volatile uint8_t *)&wdog->qcpu;
+      first  = MIN(qcpu, cpu);
+      second = MAX(qcpu, cpu);
+
+      flags = spin_lock_irqsave(&g_wdactivelock[first]);
+      if (second != first)
+        {
+          spin_lock(&g_wdactivelock[second]);
+        }
+
+      if (qcpu == wdog->qcpu)
+        {
+          break;
+        }
+
+      if (second != first)
+        {
+          spin_unlock(&g_wdactivelock[second]);
+        }
+
+      spin_unlock_irqrestore(&g_wdactivelock[first], flags);
+    }
+
+  /* Check if the watchdog has been started. If so, delete it. */
+
+  if (WDOG_ISACTIVE(wdog))
+    {
+      list_delete(&wdog->node);
+      wdog->func = NULL;
+    }
+
+  wdog->qcpu = cpu;
+  wd_insert(wdog, ticks, wdentry, arg);
+  reassess = list_is_head(&g_wdactivelist[cpu], &wdog->node);
+
+  if (second != first)
+    {
+      spin_unlock(&g_wdactivelock[second]);
+    }
+
+  spin_unlock_irqrestore(&g_wdactivelock[first], flags);
+
+#  ifdef CONFIG_SCHED_TICKLESS
+  /* The interval timer is shared by all CPUs, so reprogramming it still
+   * requires the critical section.
+   */
+
+  if (reassess && !g_wdtimernested)
+    {
+      flags = enter_critical_section();
+      nxsched_reassess_timer();
+      leave_critical_section(flags);
+    }
+#  else
+  UNUSED(reassess);
+#  endif
+#else
   flags = enter_critical_section();
-#ifdef CONFIG_SCHED_TICKLESS
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  /* Check if the watchdog has been started. If so, delete it. */
+
+  if (WDOG_ISACTIVE(wdog))
+    {
+      wd_wheel_remove(wdog);
+      wdog->func = NULL;
+    }
+
+#  ifdef CONFIG_SCHED_TICKLESS
+  /* If the wheel is idle, its base may lag far behind the current time.
+   * Catch it up so that the new watchdog lands on the lowest level
+   * possible.
+   */
+
+  if (!g_wdtimernested && !wd_wheel_next(&next))
+    {
+      next = clock_systime_ticks();
+      if (clock_compare(g_wdwheel.base, next))
+        {
+          g_wdwheel.base = next;
+        }
+    }
+
+  /* The interval timer only needs to be reassessed if the new watchdog
+   * is due before the next event already programmed.
+   */
+
+  reassess = !wd_wheel_next(&next) || clock_compare(ticks, next);
+#  endif
+
+  wd_insert(wdog, ticks, wdentry, arg);
+
+#  ifdef CONFIG_SCHED_TICKLESS
+  if (!g_wdtimernested && reassess)
+    {
+      nxsched_reassess_timer();
+    }
+#  else
+  UNUSED(reassess);
+#  endif
+#elif defined(CONFIG_SCHED_TICKLESS)
   /* We need to reassess timer if the watchdog list head has changed. */
 
   if (WDOG_ISACTIVE(wdog))
@@ -330,6 +764,7 @@ int wd_start_abstick(FAR struct wdog_s *wdog, clock_t ticks,
   wd_insert(wdog, ticks, wdentry, arg);
 #endif
   leave_critical_section(flags);
+#endif /* CONFIG_WDOG_PERCPU */
 
   sched_note_wdog(NOTE_WDOG_START, wdentry, (FAR void *)(uintptr_t)ticks);
   return OK;
@@ -417,6 +852,14 @@ clock_t wd_timer(clock_t ticks, bool noswitches)
   FAR struct wdog_s *wdog;
   irqstate_t flags;
   sclock_t ret;
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  clock_t next;
+#endif
+#ifdef CONFIG_WDOG_PERCPU
+  sclock_t delay;
+  bool found;
+  int cpu;
+#endif
 
   /* Check if the watchdog at the head of the list is ready to run */
 
@@ -425,8 +868,55 @@ clock_t wd_timer(clock_t ticks, bool noswitches)
       wd_expiration(ticks);
     }
 
+#ifdef CONFIG_WDOG_PERCPU
+  /* Return the delay for the next watchdog to expire on any CPU.  Queues
+   * with a pending cross-CPU call are skipped, their CPU reassesses the
+   * timer once it has processed them.
+   */
+
+  ret = 0;
+  found = false;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      flags = spin_lock_irqsave(&g_wdactivelock[cpu]);
+      if (!g_wdsmppending[cpu] && !list_is_empty(&g_wdactivelist[cpu]))
+        {
+          wdog = list_first_entry(&g_wdactivelist[cpu], struct wdog_s,
+                                  node);
+          delay = wdog->expired - ticks;
+          if (!found || delay < ret)
+            {
+              ret = delay;
+              found = true;
+            }
+        }
+
+      spin_unlock_irqrestore(&g_wdactivelock[cpu], flags);
+    }
+
+  if (!found)
+    {
+      return 0;
+    }
+#else
   flags = enter_critical_section();
 
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  /* Return the delay for the next wheel event.  This may be a cascade
+   * rather than a real expiration, which costs one extra wakeup per slot
+   * of the higher levels.
+   */
+
+  if (!wd_wheel_next(&next))
+    {
+      leave_critical_section(flags);
+      return 0;
+    }
+
+  UNUSED(wdog);
+  ret = next - ticks;
+#else
   /* Return the delay for the next watchdog to expire */
 
   if (list_is_empty(&g_wdactivelist))
@@ -441,8 +931,10 @@ clock_t wd_timer(clock_t ticks, bool noswitches)
 
   wdog = list_first_entry(&g_wdactivelist, struct wdog_s, node);
   ret = wdog->expired - ticks;
+#endif
 
   leave_critical_section(flags);
+#endif /* CONFIG_WDOG_PERCPU */
 
   /* Return the delay for the next watchdog to expire */
 
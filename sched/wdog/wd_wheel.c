@@ -0,0 +1,325 @@
+/****************************************************************************
+ * sched/wdog/wd_wheel.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <strings.h>
+
+#include <nuttx/list.h>
+
+#include "wdog/wdog.h"
+
+#ifdef CONFIG_WDOG_TIMERWHEEL
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Number of ticks covered by one slot of the given level */
+
+#define WDOG_WHEEL_SHIFT(l)  ((l) * WDOG_WHEEL_BITS)
+#define WDOG_WHEEL_SPAN(l)   ((clock_t)1 << WDOG_WHEEL_SHIFT(l))
+
+/* Index of the slot that contains the tick 't' on the given level */
+
+#define WDOG_WHEEL_INDEX(t, l) \
+  ((unsigned int)((t) >> WDOG_WHEEL_SHIFT(l)) & WDOG_WHEEL_MASK)
+
+/* Non-zero if 't' is the first tick of a slot on the given level */
+
+#define WDOG_WHEEL_ALIGNED(t, l) \
+  (((t) & (WDOG_WHEEL_SPAN(l) - 1)) == 0)
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* The timing wheel.  Level 0 holds the watchdogs that expire within the
+ * next WDOG_WHEEL_SLOTS ticks, one slot per tick.  Each of the higher
+ * levels covers WDOG_WHEEL_SLOTS times the range of the level below it;
+ * the watchdogs there are re-distributed ("cascaded") to the lower levels
+ * when the wheel base reaches the first tick of their slot.
+ */
+
+struct wdog_wheel_s g_wdwheel;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_initialize
+ *
+ * Description:
+ *   Initialize the timing wheel slots.  Called once from wd_initialize().
+ *
+ ****************************************************************************/
+
+void wd_wheel_initialize(void)
+{
+  int level;
+  int index;
+
+  for (level = 0; level < WDOG_WHEEL_LEVELS; level++)
+    {
+      for (index = 0; index < WDOG_WHEEL_SLOTS; index++)
+        {
+          list_initialize(&g_wdwheel.slot[level][index]);
+        }
+
+      g_wdwheel.bitmap[level] = 0;
+    }
+
+  g_wdwheel.base = 0;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_insert
+ *
+ * Description:
+ *   Add a watchdog to the slot that corresponds to wdog->expired.  A
+ *   watchdog that has already expired is placed in the slot of the current
+ *   wheel base so that it runs on the next expiration pass.
+ *
+ * Input Parameters:
+ *   wdog - The watchdog to add.  wdog->expired must be valid.
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+void wd_wheel_insert(FAR struct wdog_s *wdog)
+{
+  clock_t base = g_wdwheel.base;
+  clock_t delta = wdog->expired - base;
+  unsigned int index;
+  int level = 0;
+
+  if ((sclock_t)delta < 0)
+    {
+      delta = 0;
+    }
+
+  while (level < WDOG_WHEEL_LEVELS - 1 &&
+         delta >= WDOG_WHEEL_SPAN(level + 1))
+    {
+      level++;
+    }
+
+  if ((delta >> WDOG_WHEEL_SHIFT(level)) < WDOG_WHEEL_SLOTS)
+    {
+      index = WDOG_WHEEL_INDEX(base + delta, level);
+    }
+  else
+    {
+      /* Too far away for the top level: park it in the slot that is
+       * cascaded last and re-evaluate it then.
+       */
+
+      index = (WDOG_WHEEL_INDEX(base, level) - 1) & WDOG_WHEEL_MASK;
+    }
+
+  list_add_tail(&g_wdwheel.slot[level][index], &wdog->node);
+  g_wdwheel.bitmap[level] |= (uint32_t)1 << index;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_remove
+ *
+ * Description:
+ *   Remove a watchdog from its slot, whatever level it is on.
+ *
+ * Input Parameters:
+ *   wdog - The watchdog to remove.  Must be in the wheel.
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+void wd_wheel_remove(FAR struct wdog_s *wdog)
+{
+  FAR struct list_node *prev = wdog->node.prev;
+
+  list_delete(&wdog->node);
+
+  /* Only a slot head can be left pointing to itself.  Its position in
+   * the slot array tells which bitmap bit needs to be cleared.
+   */
+
+  if (list_is_empty(prev))
+    {
+      unsigned int pos = prev - &g_wdwheel.slot[0][0];
+
+      g_wdwheel.bitmap[pos / WDOG_WHEEL_SLOTS] &=
+        ~((uint32_t)1 << (pos % WDOG_WHEEL_SLOTS));
+    }
+}
+
+/****************************************************************************
+ * Name: wd_wheel_next
+ *
+ * Description:
+ *   Find the earliest tick, not before the wheel base, at which the wheel
+ *   needs attention: either a level 0 slot with expiring watchdogs or a
+ *   higher level slot that must be cascaded.
+ *
+ * Input Parameters:
+ *   next - Location to return the absolute tick.
+ *
+ * Returned Value:
+ *   False if the wheel is empty, true otherwise.
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+bool wd_wheel_next(FAR clock_t *next)
+{
+  clock_t base = g_wdwheel.base;
+  clock_t best = 0;
+  bool found = false;
+  int level;
+
+  for (level = 0; level < WDOG_WHEEL_LEVELS; level++)
+    {
+      uint32_t bitmap = g_wdwheel.bitmap[level];
+      unsigned int index;
+      unsigned int dist;
+      clock_t delta;
+
+      if (bitmap == 0)
+        {
+          continue;
+        }
+
+      /* Rotate the bitmap so that bit 0 is the current slot */
+
+      index = WDOG_WHEEL_INDEX(base, level);
+      if (index != 0)
+        {
+          bitmap = (bitmap >> index) |
+                   (bitmap << (WDOG_WHEEL_SLOTS - index));
+        }
+
+      /* The current slot of a higher level has already been cascaded
+       * unless the base sits exactly on its first tick; what remains there
+       * is one full revolution away.
+       */
+
+      if (level > 0 && !WDOG_WHEEL_ALIGNED(base, level))
+        {
+          bitmap &= ~(uint32_t)1;
+        }
+
+      dist = bitmap != 0 ? ffs(bitmap) - 1 : WDOG_WHEEL_SLOTS;
+
+      if (dist == 0)
+        {
+          delta = 0;
+        }
+      else
+        {
+          delta = ((((base >> WDOG_WHEEL_SHIFT(level)) + dist)) <<
+                   WDOG_WHEEL_SHIFT(level)) - base;
+        }
+
+      if (!found || delta < best)
+        {
+          best  = delta;
+          found = true;
+        }
+
+      /* Nothing on a higher level can come before the current level 0
+       * slot.
+       */
+
+      if (delta == 0)
+        {
+          break;
+        }
+    }
+
+  *next = base + best;
+  return found;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_cascade
+ *
+ * Description:
+ *   Re-distribute the watchdogs of every higher level slot that starts at
+ *   the current wheel base to the lower levels.
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+void wd_wheel_cascade(void)
+{
+  clock_t base = g_wdwheel.base;
+  int level;
+
+  for (level = 1; level < WDOG_WHEEL_LEVELS; level++)
+    {
+      FAR struct list_node *slot;
+      unsigned int index;
+
+      if (!WDOG_WHEEL_ALIGNED(base, level))
+        {
+          break;
+        }
+
+      index = WDOG_WHEEL_INDEX(base, level);
+      slot  = &g_wdwheel.slot[level][index];
+      if (list_is_empty(slot))
+        {
+          continue;
+        }
+
+      /* None of the watchdogs can land in this slot again; they either
+       * move to a lower level or, on the top level, to the previous slot.
+       */
+
+      g_wdwheel.bitmap[level] &= ~((uint32_t)1 << index);
+
+      while (!list_is_empty(slot))
+        {
+          FAR struct wdog_s *wdog =
+            list_first_entry(slot, struct wdog_s, node);
+
+          list_delete(&wdog->node);
+          wd_wheel_insert(wdog);
+        }
+    }
+}
+
+#endif /* CONFIG_WDOG_TIMERWHEEL */
@@ -37,6 +37,11 @@
 #include <nuttx/queue.h>
 #include <nuttx/wdog.h>
 #include <nuttx/list.h>
+#include <nuttx/spinlock.h>
+
+#ifdef CONFIG_WDOG_PERCPU
+#  include "sched/sched.h"
+#endif
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -46,6 +51,26 @@
 
 #define list_node wdlist_node
 
+#ifdef CONFIG_WDOG_TIMERWHEEL
+#  define WDOG_WHEEL_BITS     5
+#  define WDOG_WHEEL_SLOTS    (1 << WDOG_WHEEL_BITS)
+#  define WDOG_WHEEL_MASK     (WDOG_WHEEL_SLOTS - 1)
+#  define WDOG_WHEEL_LEVELS   CONFIG_WDOG_TIMERWHEEL_LEVELS
+#endif
+
+/****************************************************************************
+ * Public Type Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_TIMERWHEEL
+struct wdog_wheel_s
+{
+  clock_t          base;                       /* Next tick to be processed */
+  uint32_t         bitmap[WDOG_WHEEL_LEVELS];  /* Non-empty slots per level */
+  struct list_node slot[WDOG_WHEEL_LEVELS][WDOG_WHEEL_SLOTS];
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -63,12 +88,88 @@ extern "C"
  * this linked list are removed and the function is called.
  */
 
+#ifdef CONFIG_WDOG_TIMERWHEEL
+/* When the timing wheel is selected, the active watchdogs are hashed into
+ * g_wdwheel by expiration time instead of being kept in a sorted list.
+ */
+
+extern struct wdog_wheel_s g_wdwheel;
+#elif defined(CONFIG_WDOG_PERCPU)
+/* With per-CPU queues, each CPU has its own sorted list, protected by its
+ * own spinlock rather than by the global critical section.
+ */
+
+extern struct list_node g_wdactivelist[CONFIG_SMP_NCPUS];
+extern spinlock_t g_wdactivelock[CONFIG_SMP_NCPUS];
+
+/* Cross-CPU call descriptors used to run expired watchdogs on the CPU that
+ * queued them.
+ */
+
+extern struct smp_call_data_s g_wdsmpcall[CONFIG_SMP_NCPUS];
+#else
 extern struct list_node g_wdactivelist;
+#endif
 
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: wd_initialize
+ *
+ * Description:
+ *   Initialize the watchdog data structures.  Called once from nx_start()
+ *   before any watchdog can be started.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_WDOG_TIMERWHEEL) || defined(CONFIG_WDOG_PERCPU)
+void wd_initialize(void);
+#else
+#  define wd_initialize()
+#endif
+
+/****************************************************************************
+ * Name: wd_wheel_initialize, wd_wheel_insert, wd_wheel_remove,
+ *       wd_wheel_next, wd_wheel_cascade
+ *
+ * Description:
+ *   Timing wheel primitives, see sched/wdog/wd_wheel.c.  All of them must
+ *   be called from within a critical section.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_TIMERWHEEL
+void wd_wheel_initialize(void);
+void wd_wheel_insert(FAR struct wdog_s *wdog);
+void wd_wheel_remove(FAR struct wdog_s *wdog);
+bool wd_wheel_next(FAR clock_t *next);
+void wd_wheel_cascade(void);
+#endif
+
+/****************************************************************************
+ * Name: wd_lockqueue
+ *
+ * Description:
+ *   Lock the per-CPU queue that a watchdog is queued on.  wdog->qcpu only
+ *   changes with the lock of its current queue held, so it is read again
+ *   after locking and the lookup is retried if it moved meanwhile.
+ *
+ * Input Parameters:
+ *   wdog - Watchdog ID
+ *   cpu  - Location to return the CPU whose queue was locked
+ *
+ * Returned Value:
+ *   The interrupt state to pass to spin_unlock_irqrestore() together with
+ *   g_wdactivelock[*cpu].
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_PERCPU
+irqstate_t wd_lockqueue(FAR struct wdog_s *wdog, FAR int *cpu);
+#endif
+
 /****************************************************************************
  * Name: wd_timer
  *
@@ -123,6 +224,26 @@ void wd_timer(clock_t ticks);
 struct tcb_s;
 void wd_recover(FAR struct tcb_s *tcb);
 
+/****************************************************************************
+ * Name: wd_expiration_smpcall
+ *
+ * Description:
+ *   Cross-CPU call handler, queued through g_wdsmpcall[] by the CPU that
+ *   processes the timer when watchdogs queued on another CPU have expired.
+ *   Runs the expired watchdogs of the current CPU.
+ *
+ * Input Parameters:
+ *   arg - Not used
+ *
+ * Returned Value:
+ *   Always OK
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_PERCPU
+int wd_expiration_smpcall(FAR void *arg);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -42,6 +42,55 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: work_remove
+ *
+ * Description:
+ *   Remove the work from the queue it is on.  The queue is only needed if
+ *   the work is its head or its tail, otherwise the work is just unlinked.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_SCHED_WORKQUEUE_PERCPU) || defined(CONFIG_WQUEUE_COALESCE)
+static void work_remove(FAR struct kwork_wqueue_s *wqueue,
+                        FAR struct work_s *work)
+{
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  FAR struct dq_queue_s *q = &wqueue->worker[0].q;
+  int wndx;
+
+  for (wndx = 0; wndx < wqueue->nthreads; wndx++)
+    {
+      if (dq_peek(&wqueue->worker[wndx].q) == (FAR dq_entry_t *)work ||
+          dq_tail(&wqueue->worker[wndx].q) == (FAR dq_entry_t *)work)
+        {
+          q = &wqueue->worker[wndx].q;
+          break;
+        }
+    }
+#else
+  FAR struct dq_queue_s *q = &wqueue->q;
+#endif
+
+#ifdef CONFIG_WQUEUE_COALESCE
+  /* The delayed work is on the delay queue.  Its timer is left running if
+   * the work was the first to expire, it will find no work due.
+   */
+
+  if (dq_peek(&wqueue->delayq) == (FAR dq_entry_t *)work ||
+      dq_tail(&wqueue->delayq) == (FAR dq_entry_t *)work)
+    {
+      q = &wqueue->delayq;
+    }
+#endif
+
+  dq_rem((FAR dq_entry_t *)work, q);
+}
+#else
+#  define work_remove(wqueue, work) \
+     dq_rem((FAR dq_entry_t *)(work), &(wqueue)->q)
+#endif
+
 static int work_qcancel(FAR struct kwork_wqueue_s *wqueue, bool sync,
                         FAR struct work_s *work)
 {
@@ -65,14 +114,18 @@ static int work_qcancel(FAR struct kwork_wqueue_s *wqueue, bool sync,
        * marked as available (i.e., the worker field is nullified).
        */
 
+#ifdef CONFIG_WQUEUE_COALESCE
+      work_remove(wqueue, work);
+#else
       if (WDOG_ISACTIVE(&work->u.timer))
         {
           wd_cancel(&work->u.timer);
         }
       else
         {
-          dq_rem((FAR dq_entry_t *)work, &wqueue->q);
+          work_remove(wqueue, work);
         }
+#endif
 
       work->worker = NULL;
       ret = OK;
@@ -226,6 +226,15 @@ void lpwork_boostpriority(uint8_t reqprio)
 
   for (wndx = 0; wndx < CONFIG_SCHED_LPNTHREADS; wndx++)
     {
+#ifdef CONFIG_SCHED_LPWORK_DYNAMIC
+      /* Skip the slots of the worker threads not running */
+
+      if (g_lpwork.worker[wndx].pid <= 0)
+        {
+          continue;
+        }
+#endif
+
       lpwork_boostworker(g_lpwork.worker[wndx].pid, reqprio);
     }
 
@@ -270,6 +279,15 @@ void lpwork_restorepriority(uint8_t reqprio)
 
   for (wndx = 0; wndx < CONFIG_SCHED_LPNTHREADS; wndx++)
     {
+#ifdef CONFIG_SCHED_LPWORK_DYNAMIC
+      /* Skip the slots of the worker threads not running */
+
+      if (g_lpwork.worker[wndx].pid <= 0)
+        {
+          continue;
+        }
+#endif
+
       lpwork_restoreworker(g_lpwork.worker[wndx].pid, reqprio);
     }
 
@@ -36,6 +36,7 @@
 #include <nuttx/queue.h>
 #include <nuttx/wqueue.h>
 
+#include "sched/sched.h"
 #include "wqueue/wqueue.h"
 
 #ifdef CONFIG_SCHED_WORKQUEUE
@@ -44,6 +45,7 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+#ifndef CONFIG_SCHED_WORKQUEUE_PERCPU
 #define queue_work(wqueue, work) \
   do \
     { \
@@ -56,15 +58,58 @@
         } \
     } \
   while (0)
+#endif
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: queue_work
+ *
+ * Description:
+ *   Queue the work to the worker of this CPU, or of CPU0 if this CPU is
+ *   isolated.  If that worker is busy, an idle one is woken up to steal the
+ *   work.  Interrupts must be disabled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+static void queue_work(FAR struct kwork_wqueue_s *wqueue,
+                       FAR struct work_s *work)
+{
+  FAR struct kworker_s *kworker;
+  int sem_count;
+  int wndx;
+
+  wndx    = nxsched_housekeeping_cpu(up_cpu_index());
+  kworker = &wqueue->worker[wndx % wqueue->nthreads];
+  dq_addlast((FAR dq_entry_t *)work, &kworker->q);
+
+  nxsem_get_value(&kworker->sem, &sem_count);
+  if (sem_count < 0)
+    {
+      nxsem_post(&kworker->sem);
+      return;
+    }
+
+  for (wndx = 0; wndx < wqueue->nthreads; wndx++)
+    {
+      nxsem_get_value(&wqueue->worker[wndx].sem, &sem_count);
+      if (sem_count < 0)
+        {
+          nxsem_post(&wqueue->worker[wndx].sem);
+          break;
+        }
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: work_timer_expiry
  ****************************************************************************/
 
+#ifndef CONFIG_WQUEUE_COALESCE
 static void work_timer_expiry(wdparm_t arg)
 {
   FAR struct work_s *work = (FAR struct work_s *)arg;
@@ -73,6 +118,105 @@ static void work_timer_expiry(wdparm_t arg)
   queue_work(work->wq, work);
   leave_critical_section(flags);
 }
+#else
+
+/****************************************************************************
+ * Name: work_delay_expiry
+ *
+ * Description:
+ *   Queue all of the delayed work that is due, then restart the timer of
+ *   the work queue for the next delayed work.
+ *
+ ****************************************************************************/
+
+static void work_delay_expiry(wdparm_t arg)
+{
+  FAR struct kwork_wqueue_s *wqueue = (FAR struct kwork_wqueue_s *)arg;
+  FAR struct work_s *work;
+  irqstate_t flags;
+  clock_t now;
+
+  flags = enter_critical_section();
+  now   = clock_systime_ticks();
+
+  while ((work = (FAR struct work_s *)dq_peek(&wqueue->delayq)) != NULL &&
+         (sclock_t)(work->u.s.qtime - now) <= 0)
+    {
+      dq_remfirst(&wqueue->delayq);
+      queue_work(wqueue, work);
+    }
+
+  if (work != NULL)
+    {
+      wd_start(&wqueue->timer, work->u.s.qtime - now, work_delay_expiry,
+               (wdparm_t)wqueue);
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: work_delay_queue
+ *
+ * Description:
+ *   Insert the work into the delayed work of the queue, by expiry.  The
+ *   expiry is the tick within the slack that is the multiple of the
+ *   largest power of two, so that the work due at close times gets the
+ *   same expiry.  The timer is restarted if the work is the first to
+ *   expire.  Interrupts must be disabled.
+ *
+ ****************************************************************************/
+
+static void work_delay_queue(FAR struct kwork_wqueue_s *wqueue,
+                             FAR struct work_s *work, clock_t delay,
+                             clock_t slack)
+{
+  FAR dq_entry_t *curr;
+  clock_t now = clock_systime_ticks();
+  clock_t expiry = now + delay;
+  clock_t mask;
+
+  if (slack > 0)
+    {
+      /* Keep the highest bit that differs between expiry and expiry +
+       * slack, and clear all of the bits below it.
+       */
+
+      mask = expiry ^ (expiry + slack);
+      while ((mask & (mask - 1)) != 0)
+        {
+          mask &= mask - 1;
+        }
+
+      expiry = (expiry + slack) & ~(mask - 1);
+    }
+
+  work->u.s.qtime = expiry;
+
+  for (curr = dq_peek(&wqueue->delayq); curr != NULL; curr = dq_next(curr))
+    {
+      if ((sclock_t)(expiry - ((FAR struct work_s *)curr)->u.s.qtime) < 0)
+        {
+          break;
+        }
+    }
+
+  if (curr == NULL)
+    {
+      dq_addlast((FAR dq_entry_t *)work, &wqueue->delayq);
+    }
+  else
+    {
+      dq_addbefore(curr, (FAR dq_entry_t *)work, &wqueue->delayq);
+    }
+
+  if (dq_peek(&wqueue->delayq) == (FAR dq_entry_t *)work)
+    {
+      wd_start(&wqueue->timer, expiry - now, work_delay_expiry,
+               (wdparm_t)wqueue);
+    }
+}
+#endif
 
 static bool work_is_canceling(FAR struct kworker_s *kworkers, int nthreads,
                               FAR struct work_s *work)
@@ -100,11 +244,13 @@ static bool work_is_canceling(FAR struct kworker_s *kworkers, int nthreads,
  ****************************************************************************/
 
 /****************************************************************************
- * Name: work_queue/work_queue_wq
+ * Name: work_queue/work_queue_wq/work_queue_slack/work_queue_slack_wq
  *
  * Description:
  *   Queue work to be performed at a later time.  All queued work will be
  *   performed on the worker thread of execution (not the caller's).
+ *   With CONFIG_WQUEUE_COALESCE, the delayed work may be performed up to
+ *   slack ticks late, delay >> CONFIG_WQUEUE_COALESCE_SHIFT by default.
  *
  *   The work structure is allocated and must be initialized to all zero by
  *   the caller.  Otherwise, the work structure is completely managed by the
@@ -123,15 +269,30 @@ static bool work_is_canceling(FAR struct kworker_s *kworkers, int nthreads,
  *            it is invoked.
  *   delay  - Delay (in clock ticks) from the time queue until the worker
  *            is invoked. Zero means to perform the work immediately.
+ *   slack  - The ticks the work may be performed after the delay.
  *
  * Returned Value:
  *   Zero on success, a negated errno on failure
  *
  ****************************************************************************/
 
+#ifdef CONFIG_WQUEUE_COALESCE
+int work_queue_wq(FAR struct kwork_wqueue_s *wqueue,
+                  FAR struct work_s *work, worker_t worker,
+                  FAR void *arg, clock_t delay)
+{
+  return work_queue_slack_wq(wqueue, work, worker, arg, delay,
+                             delay >> CONFIG_WQUEUE_COALESCE_SHIFT);
+}
+
+int work_queue_slack_wq(FAR struct kwork_wqueue_s *wqueue,
+                        FAR struct work_s *work, worker_t worker,
+                        FAR void *arg, clock_t delay, clock_t slack)
+#else
 int work_queue_wq(FAR struct kwork_wqueue_s *wqueue,
                   FAR struct work_s *work, worker_t worker,
                   FAR void *arg, clock_t delay)
+#endif
 {
   irqstate_t flags;
   int ret = OK;
@@ -169,11 +330,18 @@ int work_queue_wq(FAR struct kwork_wqueue_s *wqueue,
 
   if (!delay)
     {
+#ifdef CONFIG_WQUEUE_COALESCE
+      work->u.s.qtime = clock_systime_ticks();
+#endif
       queue_work(wqueue, work);
     }
   else
     {
+#ifdef CONFIG_WQUEUE_COALESCE
+      work_delay_queue(wqueue, work, delay, slack);
+#else
       wd_start(&work->u.timer, delay, work_timer_expiry, (wdparm_t)work);
+#endif
     }
 
 out:
@@ -187,4 +355,13 @@ int work_queue(int qid, FAR struct work_s *work, worker_t worker,
   return work_queue_wq(work_qid2wq(qid), work, worker, arg, delay);
 }
 
+#ifdef CONFIG_WQUEUE_COALESCE
+int work_queue_slack(int qid, FAR struct work_s *work, worker_t worker,
+                     FAR void *arg, clock_t delay, clock_t slack)
+{
+  return work_queue_slack_wq(work_qid2wq(qid), work, worker, arg, delay,
+                             slack);
+}
+#endif
+
 #endif /* CONFIG_SCHED_WORKQUEUE */
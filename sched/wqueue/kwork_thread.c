@@ -74,6 +74,16 @@
 #  define CALL_WORKER(worker, arg) worker(arg)
 #endif
 
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_LPWORK_DYNAMIC
+static int work_thread_spawn(FAR const char *name, int priority,
+                             int stack_size,
+                             FAR struct kwork_wqueue_s *wqueue, int wndx);
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -108,6 +118,164 @@ struct lp_wqueue_s g_lpwork =
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: work_dequeue
+ *
+ * Description:
+ *   Take the next work of the worker, from its own queue first, then from
+ *   the queues of the other workers.  Interrupts must be disabled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+static FAR struct work_s *work_dequeue(FAR struct kwork_wqueue_s *wqueue,
+                                       FAR struct kworker_s *kworker)
+{
+  FAR struct work_s *work;
+  int self = kworker - wqueue->worker;
+  int wndx;
+  int i;
+
+  work = (FAR struct work_s *)dq_remfirst(&kworker->q);
+  for (i = 1; work == NULL && i < wqueue->nthreads; i++)
+    {
+      wndx = (self + i) % wqueue->nthreads;
+      work = (FAR struct work_s *)dq_remfirst(&wqueue->worker[wndx].q);
+    }
+
+  return work;
+}
+#else
+#  define work_dequeue(wqueue, kworker) \
+     ((FAR struct work_s *)dq_remfirst(&(wqueue)->q))
+#endif
+
+#ifdef CONFIG_SCHED_LPWORK_DYNAMIC
+/****************************************************************************
+ * Name: work_lpreserve
+ *
+ * Description:
+ *   Called by a low priority worker that takes a work.  If no other worker
+ *   waits for work, reserve a free slot for one more worker, so that the
+ *   work queued behind a work that blocks is still performed.  Interrupts
+ *   must be disabled.
+ *
+ * Returned Value:
+ *   The index of the reserved worker, -1 if there is none.
+ *
+ ****************************************************************************/
+
+static int work_lpreserve(FAR struct kwork_wqueue_s *wqueue)
+{
+  int semcount;
+  int wndx;
+
+  if (wqueue != (FAR struct kwork_wqueue_s *)&g_lpwork ||
+      g_lpwork.spawning)
+    {
+      return -1;
+    }
+
+  nxsem_get_value(&g_lpwork.sem, &semcount);
+  if (semcount < 0)
+    {
+      return -1;
+    }
+
+  for (wndx = CONFIG_SCHED_LPWORK_MINTHREADS;
+       wndx < CONFIG_SCHED_LPNTHREADS; wndx++)
+    {
+      if (g_lpwork.worker[wndx].pid == 0)
+        {
+          g_lpwork.spawning = true;
+          return wndx;
+        }
+    }
+
+  return -1;
+}
+
+/****************************************************************************
+ * Name: work_lpspawn
+ *
+ * Description:
+ *   Create the low priority worker reserved by work_lpreserve().
+ *
+ ****************************************************************************/
+
+static void work_lpspawn(int wndx)
+{
+  irqstate_t flags;
+  int pid;
+
+  pid = work_thread_spawn(LPWORKNAME, CONFIG_SCHED_LPWORKPRIORITY,
+                          CONFIG_SCHED_LPWORKSTACKSIZE,
+                          (FAR struct kwork_wqueue_s *)&g_lpwork, wndx);
+
+  flags = enter_critical_section();
+  if (pid > 0)
+    {
+      g_lpwork.worker[wndx].pid = pid;
+    }
+
+  g_lpwork.spawning = false;
+  leave_critical_section(flags);
+
+  if (pid < 0)
+    {
+      swarn("WARNING: lpwork worker %d not created: %d\n", wndx, pid);
+    }
+}
+
+/****************************************************************************
+ * Name: work_lpidle
+ *
+ * Description:
+ *   Wait for work.  The low priority workers above the minimum give up
+ *   after CONFIG_SCHED_LPWORK_IDLETIME, unless they are the last worker
+ *   waiting while others are busy.  Interrupts must be disabled.
+ *
+ * Returned Value:
+ *   True if the worker must exit.
+ *
+ ****************************************************************************/
+
+static bool work_lpidle(FAR struct kwork_wqueue_s *wqueue,
+                        FAR struct kworker_s *kworker)
+{
+  int semcount;
+  int wndx;
+
+  if (wqueue != (FAR struct kwork_wqueue_s *)&g_lpwork ||
+      kworker - wqueue->worker < CONFIG_SCHED_LPWORK_MINTHREADS)
+    {
+      nxsem_wait_uninterruptible(&wqueue->sem);
+      return false;
+    }
+
+  if (nxsem_tickwait_uninterruptible(&wqueue->sem,
+        MSEC2TICK(CONFIG_SCHED_LPWORK_IDLETIME)) != -ETIMEDOUT)
+    {
+      return false;
+    }
+
+  nxsem_get_value(&wqueue->sem, &semcount);
+  if (semcount >= 0)
+    {
+      for (wndx = 0; wndx < CONFIG_SCHED_LPNTHREADS; wndx++)
+        {
+          if (g_lpwork.worker[wndx].work != NULL)
+            {
+              return false;
+            }
+        }
+    }
+
+  kworker->pid = 0;
+  return true;
+}
+#endif
+
 /****************************************************************************
  * Name: work_thread
  *
@@ -139,6 +307,9 @@ static int work_thread(int argc, FAR char *argv[])
   irqstate_t flags;
   FAR void *arg;
   int semcount;
+#ifdef CONFIG_SCHED_LPWORK_DYNAMIC
+  int spawn;
+#endif
 
   /* Get the handle from argv */
 
@@ -160,7 +331,7 @@ static int work_thread(int argc, FAR char *argv[])
 
       /* Remove the ready-to-execute work from the list */
 
-      while ((work = (FAR struct work_s *)dq_remfirst(&wqueue->q)) != NULL)
+      while ((work = work_dequeue(wqueue, kworker)) != NULL)
         {
           if (work->worker == NULL)
             {
@@ -185,11 +356,24 @@ static int work_thread(int argc, FAR char *argv[])
 
           kworker->work = work;
 
+#ifdef CONFIG_SCHED_LPWORK_DYNAMIC
+          /* Keep a worker waiting for the work queued behind this one */
+
+          spawn = work_lpreserve(wqueue);
+#endif
+
           /* Do the work.  Re-enable interrupts while the work is being
            * performed... we don't have any idea how long this will take!
            */
 
           leave_critical_section(flags);
+#ifdef CONFIG_SCHED_LPWORK_DYNAMIC
+          if (spawn >= 0)
+            {
+              work_lpspawn(spawn);
+            }
+#endif
+
           CALL_WORKER(worker, arg);
           flags = enter_critical_section();
 
@@ -211,7 +395,17 @@ static int work_thread(int argc, FAR char *argv[])
        * posted.
        */
 
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+      nxsem_wait_uninterruptible(&kworker->sem);
+#elif defined(CONFIG_SCHED_LPWORK_DYNAMIC)
+      if (work_lpidle(wqueue, kworker))
+        {
+          leave_critical_section(flags);
+          return OK;
+        }
+#else
       nxsem_wait_uninterruptible(&wqueue->sem);
+#endif
     }
 
   leave_critical_section(flags);
@@ -220,6 +414,71 @@ static int work_thread(int argc, FAR char *argv[])
   return OK;
 }
 
+/****************************************************************************
+ * Name: work_thread_spawn
+ *
+ * Description:
+ *   Create the thread of one worker of the work queue.
+ *
+ * Input Parameters:
+ *   name       - Name of the new task
+ *   priority   - Priority of the new task
+ *   stack_size - size (in bytes) of the stack needed
+ *   wqueue     - Work queue instance
+ *   wndx       - Index of the worker
+ *
+ * Returned Value:
+ *   The process ID of the thread, a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static int work_thread_spawn(FAR const char *name, int priority,
+                             int stack_size,
+                             FAR struct kwork_wqueue_s *wqueue, int wndx)
+{
+  FAR char *argv[3];
+  char arg0[32];
+  char arg1[32];
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  cpu_set_t cpuset;
+#endif
+  int pid;
+
+  nxsem_init(&wqueue->worker[wndx].wait, 0, 0);
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  nxsem_init(&wqueue->worker[wndx].sem, 0, 0);
+  dq_init(&wqueue->worker[wndx].q);
+#endif
+
+  snprintf(arg0, sizeof(arg0), "%p", wqueue);
+  snprintf(arg1, sizeof(arg1), "%p", &wqueue->worker[wndx]);
+  argv[0] = arg0;
+  argv[1] = arg1;
+  argv[2] = NULL;
+
+  pid = kthread_create(name, priority, stack_size, work_thread, argv);
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  if (pid > 0)
+    {
+      /* Pin the worker to the CPU whose work it takes first, or let it
+       * run on all the CPUs but the isolated ones if that one is isolated.
+       */
+
+      CPU_ZERO(&cpuset);
+      CPU_SET(wndx % CONFIG_SMP_NCPUS, &cpuset);
+      if (nxsched_cpu_isolated(wndx % CONFIG_SMP_NCPUS))
+        {
+          cpuset = ((1 << CONFIG_SMP_NCPUS) - 1) & ~SCHED_ISOLATED_CPUS;
+        }
+
+      nxsched_set_affinity(pid, sizeof(cpuset), &cpuset);
+    }
+#endif
+
+  return pid;
+}
+
 /****************************************************************************
  * Name: work_thread_create
  *
@@ -242,30 +501,28 @@ static int work_thread_create(FAR const char *name, int priority,
                               int stack_size,
                               FAR struct kwork_wqueue_s *wqueue)
 {
-  FAR char *argv[3];
-  char arg0[32];
-  char arg1[32];
+  int nthreads = wqueue->nthreads;
   int wndx;
   int pid;
 
+#ifdef CONFIG_SCHED_LPWORK_DYNAMIC
+  /* The other low priority workers are created when needed */
+
+  if (wqueue == (FAR struct kwork_wqueue_s *)&g_lpwork)
+    {
+      nthreads = CONFIG_SCHED_LPWORK_MINTHREADS;
+    }
+#endif
+
   /* Don't permit any of the threads to run until we have fully initialized
    * all of them.
    */
 
   sched_lock();
 
-  for (wndx = 0; wndx < wqueue->nthreads; wndx++)
+  for (wndx = 0; wndx < nthreads; wndx++)
     {
-      nxsem_init(&wqueue->worker[wndx].wait, 0, 0);
-
-      snprintf(arg0, sizeof(arg0), "%p", wqueue);
-      snprintf(arg1, sizeof(arg1), "%p", &wqueue->worker[wndx]);
-      argv[0] = arg0;
-      argv[1] = arg1;
-      argv[2] = NULL;
-
-      pid = kthread_create(name, priority, stack_size,
-                           work_thread, argv);
+      pid = work_thread_spawn(name, priority, stack_size, wqueue, wndx);
 
       DEBUGASSERT(pid > 0);
       if (pid < 0)
@@ -331,6 +588,9 @@ FAR struct kwork_wqueue_s *work_queue_create(FAR const char *name,
   /* Initialize the work queue structure */
 
   dq_init(&wqueue->q);
+#ifdef CONFIG_WQUEUE_COALESCE
+  dq_init(&wqueue->delayq);
+#endif
   nxsem_init(&wqueue->sem, 0, 0);
   nxsem_init(&wqueue->exsem, 0, 0);
   wqueue->nthreads = nthreads;
@@ -376,11 +636,19 @@ int work_queue_free(FAR struct kwork_wqueue_s *wqueue)
 
   wqueue->exit = true;
 
+#ifdef CONFIG_WQUEUE_COALESCE
+  wd_cancel(&wqueue->timer);
+#endif
+
   /* Queue a exit work for all threads */
 
   for (wndx = 0; wndx < wqueue->nthreads; wndx++)
     {
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+      nxsem_post(&wqueue->worker[wndx].sem);
+#else
       nxsem_post(&wqueue->sem);
+#endif
     }
 
   for (wndx = 0; wndx < wqueue->nthreads; wndx++)
@@ -388,6 +656,13 @@ int work_queue_free(FAR struct kwork_wqueue_s *wqueue)
       nxsem_wait_uninterruptible(&wqueue->exsem);
     }
 
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  for (wndx = 0; wndx < wqueue->nthreads; wndx++)
+    {
+      nxsem_destroy(&wqueue->worker[wndx].sem);
+    }
+#endif
+
   nxsem_destroy(&wqueue->sem);
   nxsem_destroy(&wqueue->exsem);
   kmm_free(wqueue);
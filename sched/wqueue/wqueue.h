@@ -34,6 +34,7 @@
 
 #include <nuttx/clock.h>
 #include <nuttx/queue.h>
+#include <nuttx/wdog.h>
 #include <nuttx/wqueue.h>
 
 #ifdef CONFIG_SCHED_WORKQUEUE
@@ -58,17 +59,25 @@ struct kworker_s
   pid_t             pid;       /* The task ID of the worker thread */
   FAR struct work_s *work;     /* The work structure */
   sem_t             wait;      /* Sync waiting for worker done */
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  struct dq_queue_s q;         /* Work queued from the CPU of the worker */
+  sem_t             sem;       /* The worker waits for work on it */
+#endif
 };
 
 /* This structure defines the state of one kernel-mode work queue */
 
 struct kwork_wqueue_s
 {
-  struct dq_queue_s q;         /* The queue of pending work */
+  struct dq_queue_s q;         /* The queue of pending work, unless per-CPU */
   sem_t             sem;       /* The counting semaphore of the wqueue */
   sem_t             exsem;     /* Sync waiting for thread exit */
   uint8_t           nthreads;  /* Number of worker threads */
   bool              exit;      /* A flag to request the thread to exit */
+#ifdef CONFIG_WQUEUE_COALESCE
+  struct dq_queue_s delayq;    /* The delayed work, sorted by expiry */
+  struct wdog_s     timer;     /* Expiry timer of the first delayed work */
+#endif
   struct kworker_s  worker[0]; /* Describes a worker thread */
 };
 
@@ -84,6 +93,10 @@ struct hp_wqueue_s
   sem_t             exsem;     /* Sync waiting for thread exit */
   uint8_t           nthreads;  /* Number of worker threads */
   bool              exit;      /* A flag to request the thread to exit */
+#ifdef CONFIG_WQUEUE_COALESCE
+  struct dq_queue_s delayq;    /* The delayed work, sorted by expiry */
+  struct wdog_s     timer;     /* Expiry timer of the first delayed work */
+#endif
 
   /* Describes each thread in the high priority queue's thread pool */
 
@@ -103,10 +116,18 @@ struct lp_wqueue_s
   sem_t             exsem;     /* Sync waiting for thread exit */
   uint8_t           nthreads;  /* Number of worker threads */
   bool              exit;      /* A flag to request the thread to exit */
+#ifdef CONFIG_WQUEUE_COALESCE
+  struct dq_queue_s delayq;    /* The delayed work, sorted by expiry */
+  struct wdog_s     timer;     /* Expiry timer of the first delayed work */
+#endif
 
   /* Describes each thread in the low priority queue's thread pool */
 
   struct kworker_s  worker[CONFIG_SCHED_LPNTHREADS];
+
+#ifdef CONFIG_SCHED_LPWORK_DYNAMIC
+  bool              spawning;  /* A worker thread is being created */
+#endif
 };
 #endif
 
@@ -36,7 +36,11 @@ echo $WORKSPACE
 config=$(basename $WD)
 if [ "$BOARD" == "sim" ]; then
   target="sim"
-  mark="common or ${BOARD}"
+  if [ "$config" == "kbench" ]; then
+    mark="benchmark"
+  else
+    mark="common or ${BOARD}"
+  fi
 else
   if [ "${config:$((-2))}" == "64" ]; then
     BOARD="${BOARD}64"
@@ -0,0 +1,117 @@
+#!/usr/bin/env python3
+############################################################################
+# tools/ci/testrun/script/test_benchmark/test_benchmark.py
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed to the Apache Software Foundation (ASF) under one or more
+# contributor license agreements.  See the NOTICE file distributed with
+# this work for additional information regarding copyright ownership.  The
+# ASF licenses this file to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance with the
+# License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+# License for the specific language governing permissions and limitations
+# under the License.
+#
+############################################################################
+# encoding: utf-8
+import json
+import os
+import re
+
+import pytest
+
+pytestmark = [pytest.mark.benchmark]
+
+# The results of all the benchmarks of the run, written out as JSON into
+# the log directory at the end.  If NUTTX_BENCHMARK_BASELINE names such a
+# file of a previous run, an average slower by more than
+# NUTTX_BENCHMARK_TOLERANCE percent (default 20) fails the test.
+
+results = {}
+
+# A result line of osperf: the name, then min, max and avg in nsec
+
+osperf_line = re.compile(r"^\s*([A-Za-z][\w\- ]*?)\s+(\d+)\s+(\d+)\s+(\d+)\s*$")
+
+# The summary line of iperf
+
+iperf_line = re.compile(r"([\d.]+)\s+Mbits/sec")
+
+
+def output(p):
+    return p.process.before.decode(errors="ignore")
+
+
+def record(test, name, value):
+    results.setdefault(test, {})[name] = value
+
+    baseline = os.environ.get("NUTTX_BENCHMARK_BASELINE")
+    if baseline is None or not os.path.exists(baseline):
+        return
+
+    with open(baseline) as f:
+        base = json.load(f).get(test, {}).get(name)
+
+    if base is None:
+        return
+
+    tolerance = float(os.environ.get("NUTTX_BENCHMARK_TOLERANCE", "20"))
+    if "avg" in value:
+        assert value["avg"] <= base["avg"] * (1 + tolerance / 100), (
+            "%s %s regressed: %d > %d" % (test, name, value["avg"], base["avg"])
+        )
+    else:
+        assert value["mbps"] >= base["mbps"] * (1 - tolerance / 100), (
+            "%s %s regressed: %.2f < %.2f"
+            % (test, name, value["mbps"], base["mbps"])
+        )
+
+
+@pytest.fixture(scope="module", autouse=True)
+def write_results(p):
+    yield
+    with open(os.path.join(p.log_path, "benchmark.json"), "w") as f:
+        json.dump(results, f, indent=2, sort_keys=True)
+
+
+def test_osperf(p):
+    ret = p.sendCommand("osperf", timeout=600)
+    assert ret == 0
+
+    found = 0
+    for line in output(p).splitlines():
+        m = osperf_line.match(line)
+        if m:
+            record(
+                "osperf",
+                m.group(1).strip(),
+                {
+                    "min": int(m.group(2)),
+                    "max": int(m.group(3)),
+                    "avg": int(m.group(4)),
+                },
+            )
+            found += 1
+
+    assert found > 0
+
+
+@pytest.mark.parametrize("proto", ["tcp", "udp"])
+def test_iperf_loopback(p, proto):
+    flag = " -u" if proto == "udp" else ""
+    p.sendCommand("iperf -s%s -i 0 &" % flag)
+    ret = p.sendCommand(
+        "iperf -c 127.0.0.1%s -t 5 -i 5" % flag, "Mbits/sec", timeout=60
+    )
+    m = iperf_line.search(output(p) + "Mbits/sec")
+    p.sendCommand("iperf -a")
+    assert ret == 0
+    assert m is not None
+    record("iperf", proto, {"mbps": float(m.group(1))})
@@ -30,6 +30,8 @@ import sys
 
 import lzf
 
+LZ4_MAGIC = b"\x04\x22\x4d\x18"
+
 
 def decompress(lzffile, outfile):
     chunk_number = 1
@@ -124,15 +126,24 @@ def main():
 
     tmpfile.seek(0, 0)
 
-    lzfhdr = tmpfile.read(2)
+    lzfhdr = tmpfile.read(4)
 
-    if lzfhdr == b"ZV":
+    if lzfhdr[:2] == b"ZV":
         outfile = open(args.output, "wb")
         tmpfile.seek(0, 0)
         decompress(tmpfile, outfile)
         tmpfile.close()
         outfile.close()
         os.unlink(tmp)
+    elif lzfhdr == LZ4_MAGIC:
+        import lz4.frame
+
+        outfile = open(args.output, "wb")
+        tmpfile.seek(0, 0)
+        outfile.write(lz4.frame.decompress(tmpfile.read()))
+        tmpfile.close()
+        outfile.close()
+        os.unlink(tmp)
     else:
         tmpfile.rename(args.output)
         tmpfile.close()
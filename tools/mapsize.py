@@ -0,0 +1,163 @@
+#!/usr/bin/env python3
+# tools/mapsize.py
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed to the Apache Software Foundation (ASF) under one or more
+# contributor license agreements.  See the NOTICE file distributed with
+# this work for additional information regarding copyright ownership.  The
+# ASF licenses this file to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance with the
+# License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+# License for the specific language governing permissions and limitations
+# under the License.
+#
+import argparse
+import os
+import re
+
+program_description = """
+This program reads the map file written by GNU ld (e.g. nuttx.map, from
+"-Wl,-Map=nuttx.map", which most boards pass already) and sums the
+.text, .rodata, .data and .bss sizes per module, where the module is the
+library the object comes from, e.g. libnet.a for the network stack and
+libfs.a for the file systems.  The RAM column is .data + .bss, ROM is
+.text + .rodata + .data.
+"""
+
+# The input section lines, either on one line or with the name alone on
+# the line before the address, size and file
+
+INPUT_SECTION = re.compile(
+    r"^ (\.\S+|COMMON)?\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$"
+)
+SECTION_NAME = re.compile(r"^ (\.\S+|COMMON)\s*$")
+ARCHIVE_MEMBER = re.compile(r"^(.*\.a)\((.*)\)$")
+
+KINDS = ("text", "rodata", "data", "bss")
+
+
+def section_kind(name):
+    for prefix, kind in (
+        (".text", "text"),
+        (".rodata", "rodata"),
+        (".srodata", "rodata"),
+        (".data", "data"),
+        (".sdata", "data"),
+        (".tdata", "data"),
+        (".bss", "bss"),
+        (".sbss", "bss"),
+        (".tbss", "bss"),
+        ("COMMON", "bss"),
+    ):
+        if name == prefix or name.startswith(prefix + "."):
+            return kind
+
+    return None
+
+
+def module_name(path, byobject):
+    tmp = ARCHIVE_MEMBER.match(path)
+    if tmp is None:
+        return os.path.basename(path)
+
+    archive = os.path.basename(tmp.group(1))
+    if byobject:
+        return "%s(%s)" % (archive, tmp.group(2))
+
+    return archive
+
+
+def parse_map(file, byobject):
+    result = {}
+    inmap = False
+    name = None
+
+    for line in file:
+        line = line.rstrip("\n")
+        if line.startswith("Linker script and memory map"):
+            inmap = True
+            continue
+
+        if not inmap:
+            continue
+
+        tmp = SECTION_NAME.match(line)
+        if tmp is not None:
+            name = tmp.group(1)
+            continue
+
+        tmp = INPUT_SECTION.match(line)
+        if tmp is None:
+            name = None
+            continue
+
+        if tmp.group(1) is not None:
+            name = tmp.group(1)
+
+        kind = section_kind(name) if name is not None else None
+        size = int(tmp.group(3), 16)
+        name = None
+
+        if kind is None or size == 0 or int(tmp.group(2), 16) == 0:
+            continue
+
+        module = module_name(tmp.group(4).strip(), byobject)
+        sizes = result.setdefault(module, dict.fromkeys(KINDS, 0))
+        sizes[kind] += size
+
+    return result
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(
+        description=program_description, formatter_class=argparse.RawTextHelpFormatter
+    )
+    parser.add_argument("-f", "--file", help="map file", nargs=1, required=True)
+    parser.add_argument(
+        "-o",
+        "--object",
+        help="break the libraries down to their objects",
+        action="store_true",
+    )
+    parser.add_argument(
+        "-s",
+        "--sort",
+        help="column to sort by, default ram",
+        choices=KINDS + ("ram", "rom"),
+        default="ram",
+    )
+    parser.add_argument(
+        "-n", "--number", help="show the first N modules only", type=int, default=0
+    )
+
+    args = parser.parse_args()
+    with open(args.file[0], "r") as map_file:
+        modules = parse_map(map_file, args.object)
+
+    for sizes in modules.values():
+        sizes["ram"] = sizes["data"] + sizes["bss"]
+        sizes["rom"] = sizes["text"] + sizes["rodata"] + sizes["data"]
+
+    rows = sorted(modules.items(), key=lambda item: item[1][args.sort], reverse=True)
+    if args.number > 0:
+        rows = rows[: args.number]
+
+    columns = KINDS + ("ram", "rom")
+    width = max([len("Module")] + [len(module) for module, _ in rows])
+    print("%-*s" % (width, "Module") + "".join("%10s" % c for c in columns))
+    for module, sizes in rows:
+        print("%-*s" % (width, module) + "".join("%10d" % sizes[c] for c in columns))
+
+    total = dict.fromkeys(columns, 0)
+    for sizes in modules.values():
+        for column in columns:
+            total[column] += sizes[column]
+
+    print("%-*s" % (width, "Total") + "".join("%10d" % total[c] for c in columns))
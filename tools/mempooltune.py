@@ -0,0 +1,183 @@
+#!/usr/bin/env python3
+# tools/mempooltune.py
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed to the Apache Software Foundation (ASF) under one or more
+# contributor license agreements.  See the NOTICE file distributed with
+# this work for additional information regarding copyright ownership.  The
+# ASF licenses this file to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance with the
+# License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+# License for the specific language governing permissions and limitations
+# under the License.
+#
+import argparse
+import re
+
+program_description = """
+This program reads the mempool histograms printed by
+"echo mempool > /proc/memdump" (CONFIG_MM_HEAP_MEMPOOL_HISTOGRAM=y)
+and recommends the pool sizes that minimize the bytes wasted by
+rounding every request up to its pool size.
+The log file needs this format, once per heap:
+Mempool histogram
+        Size       Count
+          16        1234
+    Oversize           5
+    Fallback           0
+"""
+
+
+class histogram:
+    def __init__(self):
+        self.sizes = []
+        self.counts = []
+        self.oversize = 0
+        self.fallback = 0
+
+    def total(self):
+        return sum(self.counts)
+
+
+def parse_histograms(file):
+    result = []
+    current = None
+
+    for line in file:
+        if "Mempool histogram" in line:
+            current = histogram()
+            result.append(current)
+            continue
+
+        if current is None:
+            continue
+
+        tmp = re.search(r"(\d+)\s+(\d+)\s*$", line)
+        if tmp is not None:
+            current.sizes.append(int(tmp.group(1)))
+            current.counts.append(int(tmp.group(2)))
+            continue
+
+        tmp = re.search(r"(Oversize|Fallback)\s+(\d+)", line)
+        if tmp is None:
+            continue
+
+        if tmp.group(1) == "Oversize":
+            current.oversize = int(tmp.group(2))
+        else:
+            current.fallback = int(tmp.group(2))
+            current = None
+
+    return result
+
+
+def waste(hist, classes):
+    total = 0
+    for size, count in zip(hist.sizes, hist.counts):
+        for c in classes:
+            if c >= size:
+                total += (c - size) * count
+                break
+
+    return total
+
+
+def recommend(hist, npools):
+    """Split the sorted buckets into at most npools runs, each served by
+    the pool sized after its last bucket, with the least total waste.
+    """
+
+    sizes = hist.sizes
+    counts = hist.counts
+    n = len(sizes)
+    npools = min(npools, n)
+    inf = float("inf")
+
+    # prefix[i] and weighted[i] are the count and the count * size of the
+    # first i buckets, so that the waste of a run is computed in O(1).
+
+    prefix = [0] * (n + 1)
+    weighted = [0] * (n + 1)
+    for i in range(n):
+        prefix[i + 1] = prefix[i] + counts[i]
+        weighted[i + 1] = weighted[i] + counts[i] * sizes[i]
+
+    def cost(j, i):
+        return sizes[i - 1] * (prefix[i] - prefix[j]) - (weighted[i] - weighted[j])
+
+    best = [[inf] * (n + 1) for _ in range(npools + 1)]
+    split = [[0] * (n + 1) for _ in range(npools + 1)]
+    best[0][0] = 0
+    for k in range(1, npools + 1):
+        for i in range(k, n + 1):
+            for j in range(k - 1, i):
+                value = best[k - 1][j] + cost(j, i)
+                if value < best[k][i]:
+                    best[k][i] = value
+                    split[k][i] = j
+
+    classes = []
+    i = n
+    for k in range(npools, 0, -1):
+        classes.append(sizes[i - 1])
+        i = split[k][i]
+
+    classes.reverse()
+    return classes, best[npools][n]
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(
+        description=program_description, formatter_class=argparse.RawTextHelpFormatter
+    )
+    parser.add_argument("-f", "--file", help="dump file", nargs=1, required=True)
+    parser.add_argument(
+        "-n",
+        "--npools",
+        help="number of pools to recommend, default 8",
+        type=int,
+        default=8,
+    )
+    parser.add_argument(
+        "-c",
+        "--current",
+        help="current pool sizes, e.g. 16,32,64, to compare against",
+        default="",
+    )
+
+    args = parser.parse_args()
+    with open(args.file[0], "r") as dump_file:
+        hists = parse_histograms(dump_file)
+
+    if len(hists) == 0:
+        print("no mempool histogram found")
+
+    for index, hist in enumerate(hists):
+        total = hist.total()
+        print(
+            "heap %d: %d requests, %d oversize, %d fallback"
+            % (index, total, hist.oversize, hist.fallback)
+        )
+        if total == 0:
+            continue
+
+        classes, cost = recommend(hist, args.npools)
+        print("  waste %.2f bytes/request with:" % (cost / total))
+        print("  static const size_t g_poolsize[] =")
+        print("  {")
+        print("    " + ", ".join(str(c) for c in classes))
+        print("  };")
+
+        if args.current:
+            current = sorted(int(c) for c in args.current.split(","))
+            print(
+                "  waste %.2f bytes/request with the current pools"
+                % (waste(hist, current) / total)
+            )
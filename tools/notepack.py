@@ -0,0 +1,340 @@
+#!/usr/bin/env python3
+############################################################################
+# tools/notepack.py
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed to the Apache Software Foundation (ASF) under one or more
+# contributor license agreements.  See the NOTICE file distributed with
+# this work for additional information regarding copyright ownership.  The
+# ASF licenses this file to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance with the
+# License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+# License for the specific language governing permissions and limitations
+# under the License.
+#
+############################################################################
+
+"""Decode the stream of the packed note driver (CONFIG_DRIVERS_NOTEPACK).
+
+The stream is converted to the JSON trace event format, which the Perfetto
+UI (https://ui.perfetto.dev) and chrome://tracing open directly, or printed
+as text.  The format is described in include/nuttx/note/notepack_driver.h.
+
+  notepack.py capture.bin -o trace.json
+  notepack.py capture.bin --text
+"""
+
+import argparse
+import json
+import sys
+
+MAGIC = b"NXNP"
+VERSION = 1
+
+# enum note_type_e in include/nuttx/sched_note.h
+
+(
+    NOTE_START,
+    NOTE_STOP,
+    NOTE_SUSPEND,
+    NOTE_RESUME,
+    NOTE_CPU_START,
+    NOTE_CPU_STARTED,
+    NOTE_CPU_PAUSE,
+    NOTE_CPU_PAUSED,
+    NOTE_CPU_RESUME,
+    NOTE_CPU_RESUMED,
+    NOTE_PREEMPT_LOCK,
+    NOTE_PREEMPT_UNLOCK,
+    NOTE_CSECTION_ENTER,
+    NOTE_CSECTION_LEAVE,
+    NOTE_SPINLOCK_LOCK,
+    NOTE_SPINLOCK_LOCKED,
+    NOTE_SPINLOCK_UNLOCK,
+    NOTE_SPINLOCK_ABORT,
+    NOTE_SYSCALL_ENTER,
+    NOTE_SYSCALL_LEAVE,
+    NOTE_IRQ_ENTER,
+    NOTE_IRQ_LEAVE,
+    NOTE_WDOG_START,
+    NOTE_WDOG_CANCEL,
+    NOTE_WDOG_ENTER,
+    NOTE_WDOG_LEAVE,
+    NOTE_HEAP_ADD,
+    NOTE_HEAP_REMOVE,
+    NOTE_HEAP_ALLOC,
+    NOTE_HEAP_FREE,
+    NOTE_DUMP_PRINTF,
+    NOTE_DUMP_BEGIN,
+    NOTE_DUMP_END,
+    NOTE_DUMP_MARK,
+    NOTE_DUMP_COUNTER,
+) = range(35)
+
+# The fields following the common header: "u" is an unsigned number, "s" a
+# signed number and "d" data
+
+FIELDS = {
+    NOTE_START: ("priority:u", "name:d"),
+    NOTE_STOP: (),
+    NOTE_SUSPEND: ("state:u",),
+    NOTE_RESUME: ("priority:u",),
+    NOTE_CPU_START: ("target:u",),
+    NOTE_CPU_STARTED: (),
+    NOTE_CPU_PAUSE: ("target:u",),
+    NOTE_CPU_PAUSED: (),
+    NOTE_CPU_RESUME: ("target:u",),
+    NOTE_CPU_RESUMED: (),
+    NOTE_PREEMPT_LOCK: ("count:u",),
+    NOTE_PREEMPT_UNLOCK: ("count:u",),
+    NOTE_CSECTION_ENTER: ("count:u",),
+    NOTE_CSECTION_LEAVE: ("count:u",),
+    NOTE_SPINLOCK_LOCK: ("spinlock:u", "value:u"),
+    NOTE_SPINLOCK_LOCKED: ("spinlock:u", "value:u"),
+    NOTE_SPINLOCK_UNLOCK: ("spinlock:u", "value:u"),
+    NOTE_SPINLOCK_ABORT: ("spinlock:u", "value:u"),
+    NOTE_SYSCALL_LEAVE: ("nr:u", "result:u"),
+    NOTE_IRQ_ENTER: ("irq:u", "handler:u"),
+    NOTE_IRQ_LEAVE: ("irq:u", "handler:u"),
+    NOTE_WDOG_START: ("handler:u", "arg:u"),
+    NOTE_WDOG_CANCEL: ("handler:u", "arg:u"),
+    NOTE_WDOG_ENTER: ("handler:u", "arg:u"),
+    NOTE_WDOG_LEAVE: ("handler:u", "arg:u"),
+    NOTE_HEAP_ADD: ("heap:u", "mem:u", "size:u", "used:u"),
+    NOTE_HEAP_REMOVE: ("heap:u", "mem:u", "size:u", "used:u"),
+    NOTE_HEAP_ALLOC: ("heap:u", "mem:u", "size:u", "used:u"),
+    NOTE_HEAP_FREE: ("heap:u", "mem:u", "size:u", "used:u"),
+    NOTE_DUMP_PRINTF: ("ip:u", "fmt:u", "type:u", "data:d"),
+    NOTE_DUMP_BEGIN: ("ip:u", "data:d"),
+    NOTE_DUMP_END: ("ip:u", "data:d"),
+    NOTE_DUMP_MARK: ("ip:u", "data:d"),
+    NOTE_DUMP_COUNTER: ("ip:u", "value:s", "name:d"),
+}
+
+NAMES = {
+    value: name
+    for name, value in globals().items()
+    if name.startswith("NOTE_") and isinstance(value, int)
+}
+
+
+class Reader:
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def eof(self):
+        return self.pos >= len(self.data)
+
+    def byte(self):
+        value = self.data[self.pos]
+        self.pos += 1
+        return value
+
+    def uint(self):
+        value = 0
+        shift = 0
+        while True:
+            byte = self.byte()
+            value |= (byte & 0x7F) << shift
+            shift += 7
+            if byte < 0x80:
+                return value
+
+    def sint(self):
+        value = self.uint()
+        return (value >> 1) ^ -(value & 1)
+
+    def bytes(self):
+        length = self.uint()
+        value = self.data[self.pos : self.pos + length]
+        if len(value) != length:
+            raise IndexError
+        self.pos += length
+        return value
+
+
+def decode(data):
+    """Yield the header and then one dict per record."""
+
+    if data[:4] != MAGIC:
+        raise ValueError("not a packed note stream")
+
+    reader = Reader(data)
+    reader.pos = 4
+    version = reader.byte()
+    if version != VERSION:
+        raise ValueError("unsupported version %d" % version)
+
+    yield {"freq": reader.uint()}
+
+    systime = 0
+    while not reader.eof():
+        start = reader.pos
+        try:
+            note = {"type": reader.byte(), "cpu": reader.byte()}
+            systime += reader.sint()
+            note["time"] = systime
+            note["pid"] = reader.uint()
+
+            if note["type"] == NOTE_SYSCALL_ENTER:
+                note["nr"] = reader.uint()
+                note["args"] = [reader.uint() for i in range(reader.uint())]
+                yield note
+                continue
+
+            for field in FIELDS.get(note["type"], ("data:d",)):
+                name, kind = field.split(":")
+                if kind == "u":
+                    note[name] = reader.uint()
+                elif kind == "s":
+                    note[name] = reader.sint()
+                else:
+                    note[name] = reader.bytes()
+        except IndexError:
+            print("truncated record at offset %d" % start, file=sys.stderr)
+            return
+
+        yield note
+
+
+def text(name):
+    return name.split(b"\0")[0].decode(errors="replace")
+
+
+class Converter:
+    """Convert the notes to trace events.  Each CPU is a process with one
+    thread for the running tasks and one for the interrupts, so that both
+    nest properly.  Syscalls and user markers go to the thread of the
+    task.
+    """
+
+    def __init__(self, freq):
+        self.freq = freq
+        self.events = []
+        self.names = {}
+        self.running = {}
+
+    def ts(self, note):
+        return note["time"] * 1000000.0 / self.freq
+
+    def taskname(self, pid):
+        return self.names.get(pid, "pid %d" % pid)
+
+    def add(self, note, ph, name, pid, tid, **kwargs):
+        event = {"ph": ph, "name": name, "ts": self.ts(note), "pid": pid}
+        event["tid"] = tid
+        event.update(kwargs)
+        self.events.append(event)
+
+    def switch(self, note, pid):
+        cpu = note["cpu"]
+        prev = self.running.get(cpu)
+        if prev is not None:
+            self.add(note, "E", self.taskname(prev), cpu, 0)
+        self.running[cpu] = pid
+        if pid is not None:
+            self.add(note, "B", self.taskname(pid), cpu, 0)
+
+    def convert(self, note):
+        kind = note["type"]
+        cpu = note["cpu"]
+        pid = note["pid"]
+        task = 1000 + pid
+
+        if kind == NOTE_START:
+            self.names[pid] = text(note["name"]) or "pid %d" % pid
+        elif kind == NOTE_SUSPEND:
+            if self.running.get(cpu) == pid:
+                self.switch(note, None)
+        elif kind == NOTE_RESUME:
+            self.switch(note, pid)
+        elif kind == NOTE_IRQ_ENTER:
+            self.add(note, "B", "irq %d" % note["irq"], cpu, 1)
+        elif kind == NOTE_IRQ_LEAVE:
+            self.add(note, "E", "irq %d" % note["irq"], cpu, 1)
+        elif kind == NOTE_SYSCALL_ENTER:
+            args = {"args": [hex(arg) for arg in note["args"]]}
+            self.add(note, "B", "syscall %d" % note["nr"], task, pid, args=args)
+        elif kind == NOTE_SYSCALL_LEAVE:
+            args = {"result": note["result"]}
+            self.add(note, "E", "syscall %d" % note["nr"], task, pid, args=args)
+        elif kind in (NOTE_HEAP_ALLOC, NOTE_HEAP_FREE):
+            args = {"used": note["used"]}
+            self.add(note, "C", "heap %#x" % note["heap"], 0, 0, args=args)
+        elif kind in (NOTE_DUMP_BEGIN, NOTE_DUMP_END):
+            name = text(note["data"]) or "%#x" % note["ip"]
+            ph = "B" if kind == NOTE_DUMP_BEGIN else "E"
+            self.add(note, ph, name, task, pid)
+        elif kind == NOTE_DUMP_MARK:
+            self.add(note, "i", text(note["data"]), task, pid, s="t")
+        elif kind == NOTE_DUMP_COUNTER:
+            name = text(note["name"])
+            self.add(note, "C", name, task, pid, args={name: note["value"]})
+        elif kind == NOTE_DUMP_PRINTF:
+            args = {"fmt": hex(note["fmt"]), "data": note["data"].hex()}
+            self.add(note, "i", "printf %#x" % note["ip"], task, pid, s="t", args=args)
+
+    def metadata(self):
+        def name(kind, pid, tid, value):
+            event = {"ph": "M", "name": kind, "pid": pid, "tid": tid}
+            event["args"] = {"name": value}
+            return event
+
+        events = []
+        cpus = set(e["pid"] for e in self.events if e["pid"] < 1000)
+        for cpu in sorted(cpus):
+            events.append(name("process_name", cpu, 0, "CPU %d" % cpu))
+            events.append(name("thread_name", cpu, 0, "tasks"))
+            events.append(name("thread_name", cpu, 1, "irq"))
+        for pid, value in self.names.items():
+            events.append(name("process_name", 1000 + pid, pid, value))
+        return events
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("input", help="the captured stream")
+    parser.add_argument("-o", "--output", help="the JSON trace to write")
+    parser.add_argument("--text", action="store_true", help="print the notes")
+    args = parser.parse_args()
+
+    with open(args.input, "rb") as f:
+        notes = decode(f.read())
+
+    freq = next(notes)["freq"]
+    if args.text:
+        for note in notes:
+            fields = ", ".join(
+                "%s=%s" % (k, v.hex() if isinstance(v, bytes) else v)
+                for k, v in note.items()
+                if k not in ("type", "cpu", "time", "pid")
+            )
+            print(
+                "%14.6f cpu%d pid %5d %-20s %s"
+                % (note["time"] / freq, note["cpu"], note["pid"],
+                   NAMES.get(note["type"], note["type"]), fields)
+            )
+        return
+
+    converter = Converter(freq)
+    for note in notes:
+        converter.convert(note)
+
+    trace = {"traceEvents": converter.metadata() + converter.events}
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump(trace, f)
+    else:
+        json.dump(trace, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()
@@ -341,6 +341,8 @@ static const char *g_white_content_list[] =
   "WRITE3resok",
   "READ3args",
   "READ3resok",
+  "COMMIT3args",
+  "COMMIT3resok",
   "REMOVE3args",
   "REMOVE3resok",
   "RENAME3args",
@@ -617,6 +619,14 @@ static const char *g_white_content_list[] =
   "unzGetCurrentFileInfo64",
   "unzGoToNextFile",
   "unzGoToFirstFile",
+  "unzGetCurrentFileZStreamPos64",
+  "unzCloseCurrentFile",
+  "uInt",
+  "inflateInit2",
+  "inflateReset",
+  "inflatePrime",
+  "inflateSetDictionary",
+  "inflateGetDictionary",
   NULL
 };
 
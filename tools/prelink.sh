@@ -0,0 +1,53 @@
+#!/usr/bin/env bash
+############################################################################
+# tools/prelink.sh
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed to the Apache Software Foundation (ASF) under one or more
+# contributor license agreements.  See the NOTICE file distributed with
+# this work for additional information regarding copyright ownership.  The
+# ASF licenses this file to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance with the
+# License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+# License for the specific language governing permissions and limitations
+# under the License.
+#
+############################################################################
+
+# Link a relocatable module (the output of LDELFFLAGS) for a fixed address,
+# against the symbols of the firmware, so that CONFIG_MODLIB_PRELINK loads
+# it without relocating it nor looking up any symbol.  The end of the image
+# is printed, the next module can be linked from there.
+
+usage="Usage: $0 [-c <CROSSDEV>] <NUTTX> <ADDRESS> <MODULE> <OUTPUT>"
+
+CROSSDEV=
+if [ "$1" == "-c" ]; then
+  CROSSDEV=$2
+  shift 2
+fi
+
+if [ $# -ne 4 ]; then
+  echo "$usage"
+  exit 1
+fi
+
+NUTTX=$1
+ADDRESS=$2
+MODULE=$3
+OUTPUT=$4
+
+TOPDIR=$(cd "$(dirname "$0")/.." && pwd)
+
+${CROSSDEV}ld -e main -T "${TOPDIR}/libs/libc/modlib/gnu-elf.ld" \
+  -Ttext="${ADDRESS}" --just-symbols="${NUTTX}" \
+  -o "${OUTPUT}" "${MODULE}" || exit 1
+
+${CROSSDEV}nm "${OUTPUT}" | grep -E " _ebss$" | cut -d' ' -f1
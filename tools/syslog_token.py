@@ -0,0 +1,253 @@
+#!/usr/bin/env python3
+############################################################################
+# tools/syslog_token.py
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed to the Apache Software Foundation (ASF) under one or more
+# contributor license agreements.  See the NOTICE file distributed with
+# this work for additional information regarding copyright ownership.  The
+# ASF licenses this file to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance with the
+# License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+# License for the specific language governing permissions and limitations
+# under the License.
+#
+############################################################################
+
+"""Decode the tokenized syslog messages (CONFIG_SYSLOG_TOKENIZED).
+
+The format strings are read from the .syslog_tokens section of the ELF
+file, then every '$<base64>' message of the log is replaced by its text.
+The encoding is described in include/nuttx/syslog/syslog_token.h.
+
+  syslog_token.py nuttx < console.log
+  syslog_token.py nuttx console.log -o decoded.log
+  syslog_token.py nuttx --dump
+"""
+
+import argparse
+import base64
+import binascii
+import re
+import struct
+import sys
+
+from elftools.elf.elffile import ELFFile
+
+SECTION = ".syslog_tokens"
+HASH_LEN = 64
+
+INT32, INT64, DOUBLE, STRING = range(4)
+
+MESSAGE = re.compile(r"\$([A-Za-z0-9+/]+={0,2})")
+CONVERSION = re.compile(
+    r"%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d*))?"
+    r"(hh|h|ll|l|j|z|t|L)?([diouxXeEfFgGaAcspn%])"
+)
+
+
+def token_hash(fmt):
+    """The 65599 hash of SYSLOG_TOKEN_HASH()."""
+
+    value = len(fmt)
+    coef = 1
+    for c in fmt[:HASH_LEN]:
+        coef = coef * 65599 & 0xFFFFFFFF
+        value = value + c * coef & 0xFFFFFFFF
+    return value
+
+
+def load(elf):
+    """Return the token database: token to the list of formats."""
+
+    with open(elf, "rb") as f:
+        section = ELFFile(f).get_section_by_name(SECTION)
+        if section is None:
+            raise SystemExit("%s has no %s section" % (elf, SECTION))
+        data = section.data()
+
+    tokens = {}
+    for fmt in data.split(b"\0"):
+        if fmt:
+            formats = tokens.setdefault(token_hash(fmt), [])
+            if fmt not in formats:
+                formats.append(fmt)
+    return tokens
+
+
+class Reader:
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def take(self, length):
+        value = self.data[self.pos : self.pos + length]
+        if len(value) != length:
+            raise IndexError
+        self.pos += length
+        return value
+
+    def uint(self):
+        value = 0
+        shift = 0
+        while True:
+            byte = self.take(1)[0]
+            value |= (byte & 0x7F) << shift
+            shift += 7
+            if byte < 0x80:
+                return value
+
+    def sint(self):
+        value = self.uint()
+        return (value >> 1) ^ -(value & 1)
+
+
+def arguments(reader, endian):
+    """Decode the arguments as (type, value) pairs.  The arguments cut by the
+    target are missing.
+    """
+
+    types = reader.uint()
+    args = []
+    try:
+        for i in range((types >> 28) & 0x0F):
+            kind = (types >> (i * 2)) & 0x03
+            if kind in (INT32, INT64):
+                args.append((kind, reader.sint()))
+            elif kind == DOUBLE:
+                args.append((kind, struct.unpack(endian + "d", reader.take(8))[0]))
+            else:
+                length = reader.uint()
+                value = reader.data[reader.pos : reader.pos + length]
+                reader.pos += length
+                args.append((kind, value.decode(errors="replace")))
+    except IndexError:
+        pass
+    return args
+
+
+def convert(spec, kind, value):
+    """Format one argument with one printf conversion."""
+
+    flags, width, prec, length, conv = spec
+    if conv == "s":
+        if kind != STRING:
+            return "%#x" % (value & 0xFFFFFFFFFFFFFFFF)
+    elif kind == STRING:
+        return value
+    elif conv == "p":
+        return "%#x" % (value & 0xFFFFFFFFFFFFFFFF)
+    elif conv in "aA":
+        return float(value).hex()
+    elif conv in "eEfFgG":
+        value = float(value)
+    elif conv == "c":
+        value = chr(value & 0xFF)
+    else:
+        if conv in "ouxX" and value < 0:
+            value &= 0xFFFFFFFF if kind == INT32 else 0xFFFFFFFFFFFFFFFF
+        if conv in "iu":
+            conv = "d"
+
+    fmt = "%" + flags + (width or "") + ("." + prec if prec is not None else "")
+    return (fmt + conv) % value
+
+
+def format_message(fmt, args):
+    """Rebuild the text from a printf format and the decoded arguments."""
+
+    out = []
+    pos = 0
+    args = list(args)
+
+    def take():
+        return args.pop(0) if args else (INT32, 0)
+
+    for m in CONVERSION.finditer(fmt):
+        out.append(fmt[pos : m.start()])
+        pos = m.end()
+        flags, width, prec, length, conv = m.groups()
+        if conv == "%":
+            out.append("%")
+            continue
+        if conv == "n":
+            continue
+        if width == "*":
+            width = str(take()[1])
+        if prec == "*":
+            prec = str(take()[1])
+        kind, value = take()
+        out.append(convert((flags, width, prec, length, conv), kind, value))
+
+    out.append(fmt[pos:])
+    return "".join(out)
+
+
+def decode(tokens, text, endian):
+    """Return the text of one message, or None if it is not tokenized."""
+
+    try:
+        data = base64.b64decode(text, validate=True)
+    except binascii.Error:
+        return None
+    if len(data) < 5:
+        return None
+
+    reader = Reader(data)
+    token = struct.unpack("<I", reader.take(4))[0]
+    formats = tokens.get(token)
+    if not formats:
+        return "<unknown token %#010x>" % token
+
+    try:
+        args = arguments(reader, endian)
+    except IndexError:
+        args = []
+    text = format_message(formats[0].decode(errors="replace"), args)
+    if len(formats) > 1:
+        text += " <token collision %#010x>" % token
+    return text.rstrip("\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("elf", help="the ELF file of the firmware")
+    parser.add_argument("log", nargs="?", help="the log, standard input if none")
+    parser.add_argument("-o", "--output", help="the decoded log to write")
+    parser.add_argument(
+        "--big-endian", action="store_true", help="the target is big endian"
+    )
+    parser.add_argument(
+        "--dump", action="store_true", help="print the token database"
+    )
+    args = parser.parse_args()
+
+    tokens = load(args.elf)
+    if args.dump:
+        for token, formats in sorted(tokens.items()):
+            for fmt in formats:
+                print("%08x %r" % (token, fmt.decode(errors="replace")))
+        return
+
+    endian = ">" if args.big_endian else "<"
+    src = open(args.log, errors="replace") if args.log else sys.stdin
+    dst = open(args.output, "w") if args.output else sys.stdout
+
+    def replace(m):
+        text = decode(tokens, m.group(1), endian)
+        return m.group(0) if text is None else text
+
+    with src, dst:
+        for line in src:
+            dst.write(MESSAGE.sub(replace, line))
+
+
+if __name__ == "__main__":
+    main()